@@ -0,0 +1,533 @@
+#include "MicroBenchmark.h"
+#include "core/ComponentGroups.h"
+#include "core/DebugManager.h"
+#include "core/JobSystem.h"
+#include "graphics/RenderBackend.h"
+#include "graphics/RenderQueue.h"
+#include "graphics/LightweightRenderQueue.h"
+#include "graphics/components/MeshComponent.h"
+#include "graphics/components/BoundsComponent.h"
+#include "graphics/components/RenderPriorityComponent.h"
+#include "graphics/resources/MeshCache.h"
+#include "graphics/resources/OBJLoader.h"
+#include "graphics/resources/TerrainGenerator.h"
+#include "graphics/resources/TextureLoader.h"
+#include "physics/CoordinateSystem.h"
+#include "physics/FloatingOrigin.h"
+#include "physics/OrbitSystem.h"
+#include "physics/PhysXManager.h"
+#include "physics/SectorPhysicsSystem.h"
+#include "physics/components/GravityAffectedComponent.h"
+#include "physics/components/GravitySourceComponent.h"
+#include "physics/components/OrbitComponent.h"
+#include "physics/components/SectorComponent.h"
+#include "scene/Prefab.h"
+#include "scene/SceneAssetLoader.h"
+#include "scene/TransformSystem.h"
+#include "scene/components/TransformComponent.h"
+#include <DirectXCollision.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace outer_wilds {
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr uint32_t kSharedMeshCount = 4;      // 共享网格 × 共享材质 = 16 个实例化批次
+    constexpr uint32_t kSharedMaterialCount = 4;
+    constexpr float kRenderFieldExtent = 2000.0f; // 渲染实体分布在相机周围的立方体内（约 1/6 在视锥内）
+    constexpr float kSectorFieldExtent = 15000.0f;
+    constexpr uint32_t kOrbitChainDepth = 4;
+
+    std::string EscapeJson(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped.push_back('\\');
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
+    /** @brief 把高细分球体写成 OBJ（v / vt / vn / f），作为 --bench-obj 的缺省输入 */
+    bool WriteSyntheticOBJ(const std::string& path) {
+        std::error_code ec;
+        fs::create_directories(fs::path(path).parent_path(), ec);
+
+        resources::Mesh mesh;
+        resources::TerrainGenerator::CreateSphere(mesh, 1.0f, 256, 512);
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        char line[128];
+        for (const auto& v : mesh.GetVertices()) {
+            snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", v.position.x, v.position.y, v.position.z);
+            file << line;
+        }
+        for (const auto& v : mesh.GetVertices()) {
+            snprintf(line, sizeof(line), "vt %.6f %.6f\n", v.texCoord.x, v.texCoord.y);
+            file << line;
+        }
+        for (const auto& v : mesh.GetVertices()) {
+            snprintf(line, sizeof(line), "vn %.6f %.6f %.6f\n", v.normal.x, v.normal.y, v.normal.z);
+            file << line;
+        }
+        const auto& indices = mesh.GetIndices();
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const uint32_t a = indices[i] + 1, b = indices[i + 1] + 1, c = indices[i + 2] + 1;
+            snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+            file << line;
+        }
+        return file.good();
+    }
+}
+
+void MicroBenchmark::Measure(std::vector<Result>& results, const std::string& name, uint32_t items,
+                             uint32_t iterations, const std::function<void()>& setup,
+                             const std::function<void()>& body) {
+    using Clock = std::chrono::steady_clock;
+
+    // 热身一次（首次调用会分配 scratch 缓冲区、建立保留模式缓存）
+    if (setup) setup();
+    body();
+
+    std::vector<double> samples;
+    samples.reserve(iterations);
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (setup) setup();
+        const auto start = Clock::now();
+        body();
+        const auto end = Clock::now();
+        samples.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+
+    Result result;
+    result.name = name;
+    result.items = items;
+    result.iterations = iterations;
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (double ns : samples) total += ns;
+        result.minNs = samples.front();
+        result.medianNs = samples[samples.size() / 2];
+        result.meanNs = total / samples.size();
+    }
+
+    char summary[192];
+    snprintf(summary, sizeof(summary), "%-44s median %10.3f us  (%.1f ns/item)", name.c_str(),
+             result.medianNs / 1000.0, items ? result.medianNs / items : 0.0);
+    DebugManager::GetInstance().Log("MicroBench", summary);
+    results.push_back(result);
+}
+
+bool MicroBenchmark::Run(const Options& options) {
+    DebugManager::GetInstance().Log("MicroBench", "Running kernels: " + std::to_string(options.entityCount) +
+                                    " entities, " + std::to_string(options.sectorCount) + " sectors, " +
+                                    std::to_string(options.iterations) + " iterations");
+
+    // 与正常运行一致：ParallelFor 在工作线程上执行
+    JobSystem::GetInstance().Initialize();
+    // 碎片内核走真实的 actor 获取 / addActors / removeActor 路径（预制体只在 PhysX 初始化后才有碰撞体）
+    const bool physxReady = PhysXManager::GetInstance().Initialize();
+    if (!physxReady) {
+        DebugManager::GetInstance().Log("MicroBench", "PhysX unavailable; debris kernel measures the ECS path only");
+    }
+
+    std::vector<Result> results;
+    RunRenderBenchmarks(options, results);
+    RunSectorBenchmarks(options, results);
+    RunAssetBenchmarks(options, results);
+
+    if (physxReady) PhysXManager::GetInstance().Shutdown();
+    JobSystem::GetInstance().Shutdown();
+    return WriteResults(options, results);
+}
+
+void MicroBenchmark::RunRenderBenchmarks(const Options& options, std::vector<Result>& results) {
+    // WARP 设备只用于创建顶点/索引缓冲区（批次模板需要它们），不做任何绘制
+    RenderBackend backend;
+    backend.InitializeHeadless(64, 64);
+    ID3D11Device* device = backend.GetDevice();
+    if (!device) {
+        DebugManager::GetInstance().Log("MicroBench", "No D3D11 device; RenderQueue benchmarks collect empty batches");
+    }
+
+    std::vector<std::shared_ptr<resources::Mesh>> meshes;
+    for (uint32_t i = 0; i < kSharedMeshCount; i++) {
+        auto mesh = std::make_shared<resources::Mesh>();
+        resources::TerrainGenerator::CreateSphere(*mesh, 1.0f, 8 + 4 * i, 12 + 6 * i);
+        if (device) mesh->CreateGPUBuffers(device);
+        meshes.push_back(mesh);
+    }
+    std::vector<std::shared_ptr<resources::Material>> materials;
+    for (uint32_t i = 0; i < kSharedMaterialCount; i++) {
+        materials.push_back(SceneAssetLoader::CreateMaterialResource(device, ""));
+    }
+
+    // registry 必须比 queue 活得久（queue 析构时断开 registry 信号）
+    entt::registry registry;
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<float> coord(-kRenderFieldExtent, kRenderFieldExtent);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    std::uniform_int_distribution<uint32_t> sortKey(0, 0xFFFFu);
+
+    std::vector<entt::entity> entities;
+    entities.reserve(options.entityCount);
+    for (uint32_t i = 0; i < options.entityCount; i++) {
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<TransformComponent>(entity);
+        transform.position = { coord(rng), coord(rng), coord(rng) };
+        registry.emplace<components::MeshComponent>(entity, meshes[i % kSharedMeshCount],
+                                                    materials[(i / kSharedMeshCount) % kSharedMaterialCount]);
+        registry.emplace<components::BoundsComponent>(entity).SetSphere(
+            DirectX::BoundingSphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f));
+        auto& priority = registry.emplace<components::RenderPriorityComponent>(entity);
+        priority.sortKey = sortKey(rng);
+        priority.distanceToCamera = std::abs(transform.position.z);
+        entities.push_back(entity);
+    }
+
+    // 相机在原点看向 +Z（左手系），视锥剔除掉大部分实体
+    DirectX::BoundingFrustum frustum(DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, 16.0f / 9.0f, 0.1f, 10000.0f));
+    const DirectX::XMFLOAT3 cameraPos = { 0.0f, 0.0f, 0.0f };
+    const DirectX::XMFLOAT3 sunPos = { 0.0f, 0.0f, 0.0f };
+    const uint32_t count = options.entityCount;
+
+    auto moveAll = [&]() {
+        for (entt::entity entity : entities) {
+            registry.patch<TransformComponent>(entity, [&](TransformComponent& transform) {
+                transform.position.x += jitter(rng);
+            });
+        }
+    };
+
+    TransformSystem transforms;
+    Measure(results, "TransformSystem::UpdateWorldMatrices (all moving)", count, options.iterations,
+        moveAll,
+        [&]() { transforms.UpdateWorldMatrices(registry); });
+
+    RenderQueue queue;
+    Measure(results, "RenderQueue::CollectFromECS (static)", count, options.iterations,
+        [&]() { queue.Clear(); },
+        [&]() { queue.CollectFromECS(registry, cameraPos, sunPos, &frustum); });
+
+    Measure(results, "RenderQueue::CollectFromECS (all moving)", count, options.iterations,
+        [&]() {
+            queue.Clear();
+            moveAll();
+            transforms.UpdateWorldMatrices(registry);
+        },
+        [&]() { queue.CollectFromECS(registry, cameraPos, sunPos, &frustum); });
+
+    Measure(results, "RenderQueue::CollectFromECS (no culling)", count, options.iterations,
+        [&]() { queue.Clear(); },
+        [&]() { queue.CollectFromECS(registry, cameraPos, sunPos); });
+
+    // 不剔除时批次最多，排序压力最大
+    Measure(results, "RenderQueue::Sort", count, options.iterations,
+        [&]() {
+            queue.Clear();
+            queue.CollectFromECS(registry, cameraPos, sunPos);
+        },
+        [&]() { queue.Sort(); });
+    queue.ResetCache();
+
+    std::vector<entt::entity> shuffled = entities;
+    LightweightRenderQueue lightweight;
+    lightweight.Reserve(shuffled.size());
+    Measure(results, "LightweightRenderQueue::Sort", count, options.iterations,
+        [&]() {
+            std::shuffle(shuffled.begin(), shuffled.end(), rng);
+            lightweight.Clear();
+            for (entt::entity entity : shuffled) lightweight.Push(entity);
+        },
+        [&]() { lightweight.Sort(registry, true); });
+}
+
+void MicroBenchmark::RunSectorBenchmarks(const Options& options, std::vector<Result>& results) {
+    entt::registry registry;
+    std::mt19937 rng(options.seed + 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> coord(-kSectorFieldExtent, kSectorFieldExtent);
+    const auto& origin = FloatingOrigin::GetInstance();
+
+    // === 扇区：深度 kOrbitChainDepth 的 orbitParent 链，同时是重力源 ===
+    std::vector<entt::entity> sectors;
+    entt::entity parent = entt::null;
+    float parentRadius = 0.0f;
+    for (uint32_t i = 0; i < options.sectorCount; i++) {
+        if (i % kOrbitChainDepth == 0) parent = entt::null;
+        const float radius = parent == entt::null ? 20.0f + 40.0f * unit(rng) : parentRadius * 0.5f;
+        DirectX::XMFLOAT3 position = { coord(rng), coord(rng) * 0.1f, coord(rng) };
+        float orbitRadius = std::sqrt(position.x * position.x + position.z * position.z);
+        if (parent != entt::null) {
+            const auto& center = registry.get<TransformComponent>(parent).position;
+            orbitRadius = parentRadius * 4.0f + radius * 3.0f;
+            position = { center.x + orbitRadius, center.y, center.z };
+        }
+
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<TransformComponent>(entity);
+        transform.position = position;
+
+        auto& sector = registry.emplace<components::SectorComponent>(entity);
+        sector.name = "Bench " + std::to_string(i);
+        sector.planetRadius = radius;
+        sector.influenceRadius = radius * 3.0f;
+        sector.priority = static_cast<int>(i % kOrbitChainDepth) * 10;
+        sector.parentSector = parent;
+        sector.worldPosition = position;
+        sector.absolutePosition = origin.ToAbsolute(position);
+
+        auto& gravity = registry.emplace<components::GravitySourceComponent>(entity);
+        gravity.radius = radius;
+        gravity.atmosphereHeight = radius * 2.0f;
+
+        auto& orbit = registry.emplace<components::OrbitComponent>(entity);
+        orbit.orbitParent = parent;
+        orbit.orbitRadius = orbitRadius;
+        orbit.orbitPeriod = 60.0f + 600.0f * unit(rng);
+        orbit.orbitAngle = DirectX::XM_2PI * unit(rng);
+        orbit.eccentricity = 0.2f * unit(rng);
+        orbit.orbitInclination = 0.1f * unit(rng);
+        orbit.rotationEnabled = true;
+
+        sectors.push_back(entity);
+        parent = entity;
+        parentRadius = radius;
+    }
+
+    // === 受重力实体：一半在扇区内（局部坐标），其余自由飞行；约 10% 为叠加模式 ===
+    std::vector<entt::entity> bodies;
+    bodies.reserve(options.entityCount);
+    for (uint32_t i = 0; i < options.entityCount; i++) {
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<TransformComponent>(entity);
+        auto& affected = registry.emplace<components::GravityAffectedComponent>(entity);
+        if (i % 10 == 0) affected.mode = components::GravityAffectedComponent::Mode::Summed;
+
+        if (!sectors.empty() && i % 2 == 0) {
+            entt::entity sectorEntity = sectors[i % sectors.size()];
+            const auto& sector = registry.get<components::SectorComponent>(sectorEntity);
+            const float distance = sector.influenceRadius * (0.4f + 0.8f * unit(rng));
+            DirectX::XMVECTOR dir = DirectX::XMVector3Normalize(
+                DirectX::XMVectorSet(unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f, 0.0f));
+            DirectX::XMFLOAT3 local;
+            DirectX::XMStoreFloat3(&local, DirectX::XMVectorScale(dir, distance));
+            auto& inSector = registry.emplace<components::InSectorComponent>(entity);
+            inSector.sector = sectorEntity;
+            inSector.localPosition = local;
+            inSector.isInitialized = true;
+            transform.position = { sector.worldPosition.x + local.x, sector.worldPosition.y + local.y,
+                                   sector.worldPosition.z + local.z };
+        } else {
+            transform.position = { coord(rng), coord(rng) * 0.1f, coord(rng) };
+        }
+        bodies.push_back(entity);
+    }
+
+    const uint32_t count = options.entityCount;
+    SectorPhysicsSystem sectorPhysics;
+    Measure(results, "SectorPhysicsSystem::CalculateGravity", count, options.iterations,
+        nullptr,
+        [&]() { sectorPhysics.CalculateGravity(registry); });
+
+    // 每帧的扇区检测：BVH 已按本帧星球位置重建，逐实体查询（滞后阈值与运行时相同）
+    sectorPhysics.RebuildSectorIndex(registry);
+    std::vector<entt::entity> bestSectors(bodies.size(), entt::null);
+    Measure(results, "SectorPhysicsSystem::FindBestSectorForEntity", count, options.iterations,
+        nullptr,
+        [&]() {
+            for (size_t i = 0; i < bodies.size(); i++) {
+                const auto* inSector = registry.try_get<components::InSectorComponent>(bodies[i]);
+                bestSectors[i] = sectorPhysics.FindBestSectorForEntity(
+                    registry, registry.get<TransformComponent>(bodies[i]).position,
+                    inSector ? inSector->sector : entt::null, 0.92f, 1.08f);
+            }
+        });
+
+    Measure(results, "SectorPhysicsSystem::RebuildSectorIndex", options.sectorCount, options.iterations,
+        nullptr,
+        [&]() { sectorPhysics.RebuildSectorIndex(registry); });
+
+    // 求值顺序在热身时建立，计时部分只剩有效性检查和轨道求值
+    OrbitSystem orbits;
+    Measure(results, "OrbitSystem::EvaluateOrbits", options.sectorCount, options.iterations,
+        [&]() { orbits.SetSimulationTime(orbits.GetSimulationTime() + 1.0 / 60.0); },
+        [&]() { orbits.EvaluateOrbits(registry); });
+
+    // PhysX 同步路径上的位姿往返转换（局部坐标 → PxTransform → 局部坐标）
+    std::vector<DirectX::XMFLOAT3> positions(bodies.size());
+    std::vector<DirectX::XMFLOAT4> rotations(bodies.size());
+    Measure(results, "CoordinateSystem pose round-trip", count, options.iterations,
+        nullptr,
+        [&]() {
+            for (size_t i = 0; i < bodies.size(); i++) {
+                const auto& transform = registry.get<TransformComponent>(bodies[i]);
+                const physx::PxTransform pose = CoordinateSystem::WorldToPhysics(transform.position, transform.rotation);
+                CoordinateSystem::PhysicsToWorld(pose, positions[i], rotations[i]);
+            }
+        });
+
+    // 同一转换的批量版本（连续数组，原地翻转两次回到原值）
+    Measure(results, "CoordinateSystem bulk pose round-trip", count, options.iterations,
+        nullptr,
+        [&]() {
+            CoordinateSystem::WorldToPhysics(positions.data(), positions.data(), positions.size());
+            CoordinateSystem::WorldToPhysics(rotations.data(), rotations.data(), rotations.size());
+            CoordinateSystem::PhysicsToWorld(positions.data(), positions.data(), positions.size());
+            CoordinateSystem::PhysicsToWorld(rotations.data(), rotations.data(), rotations.size());
+        });
+
+    // 扇区局部 → 世界的传播（扇区已由 UpdateOrbits 公转、自转）
+    const uint32_t residents = std::max(1u, static_cast<uint32_t>(ComponentGroups::SectorResidents(registry).size()));
+    Measure(results, "SectorPhysicsSystem::SyncSectorEntities", residents, options.iterations,
+        nullptr,
+        [&]() { sectorPhysics.SyncSectorEntities(registry); });
+
+    // 碰撞后的碎片：一批预制体实例整段生成再回收（与 ImpactDebrisSystem 同类的程序生成预制体）。
+    // PhysX 已初始化时包含 actor 的池内复用、addActors 和 removeActor（扇区没有独立场景，actor 进主场景）；
+    // 池先预热，测的是稳态的复用路径而不是首次创建
+    if (!sectors.empty()) {
+        auto debrisMesh = std::make_shared<resources::Mesh>();
+        resources::TerrainGenerator::CreateSphere(*debrisMesh, 1.0f, 6, 8);
+        PrefabColliderDesc debrisCollider;
+        debrisCollider.shape = PrefabColliderDesc::Shape::Sphere;
+        debrisCollider.sphereRadius = 0.2f;
+        auto debrisPrefab = Prefab::Create(debrisMesh, SceneAssetLoader::CreateMaterialResource(nullptr, ""),
+                                           DirectX::BoundingSphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f),
+                                           DirectX::XMFLOAT3(0.2f, 0.2f, 0.2f), debrisCollider);
+        PrefabPool debrisPool(debrisPrefab);
+
+        const uint32_t fragments = std::max(1u, count / 4);
+        debrisPool.Prewarm(fragments);
+        std::vector<DirectX::XMFLOAT3> fragmentPositions(fragments);
+        std::vector<DirectX::XMFLOAT3> fragmentVelocities(fragments);
+        for (uint32_t i = 0; i < fragments; i++) {
+            fragmentPositions[i] = { unit(rng) - 0.5f, unit(rng) - 0.5f, unit(rng) - 0.5f };
+            fragmentVelocities[i] = { fragmentPositions[i].x * 20.0f, fragmentPositions[i].y * 20.0f,
+                                      fragmentPositions[i].z * 20.0f };
+        }
+        std::vector<entt::entity> spawned(fragments);
+        PrefabSpawnBatch batch;
+        batch.sector = sectors.front();
+        batch.positions = fragmentPositions.data();
+        batch.linearVelocities = fragmentVelocities.data();
+        batch.count = fragments;
+        const char* debrisKernel = debrisPrefab->HasCollider() ? "PrefabPool::Spawn + Despawn (debris, PhysX)"
+                                                               : "PrefabPool::Spawn + Despawn (debris, ECS only)";
+        Measure(results, debrisKernel, fragments, options.iterations,
+            nullptr,
+            [&]() {
+                debrisPool.Spawn(registry, batch, spawned.data());
+                debrisPool.Despawn(registry, spawned.data(), spawned.size());
+            });
+        debrisPool.Clear(registry);
+    }
+}
+
+void MicroBenchmark::RunAssetBenchmarks(const Options& options, std::vector<Result>& results) {
+    // 资源加载比每帧内核慢几个数量级，迭代次数减少
+    const uint32_t iterations = std::max(1u, std::min(options.iterations, 5u));
+
+    std::string objPath = options.objPath;
+    if (objPath.empty()) {
+        objPath = "cache/bench/sphere_256x512.obj";
+        if (!fs::exists(objPath) && !WriteSyntheticOBJ(objPath)) {
+            DebugManager::GetInstance().Log("MicroBench", "Failed to write synthetic OBJ: " + objPath);
+            objPath.clear();
+        }
+    }
+    if (!objPath.empty()) {
+        std::error_code ec;
+        const uint32_t sizeKb = static_cast<uint32_t>(fs::file_size(objPath, ec) / 1024);
+        // 解析路径需要绕过网格缓存；缓存命中路径单独测量（首次迭代前由热身写入）
+        auto& meshCache = resources::MeshCache::GetInstance();
+        const bool cacheEnabled = meshCache.IsEnabled();
+        meshCache.SetEnabled(false);
+        Measure(results, "OBJLoader::LoadFromFile (KB)", sizeKb, iterations,
+            nullptr,
+            [&]() {
+                resources::Mesh mesh;
+                resources::OBJLoader::LoadFromFile(objPath, mesh);
+            });
+        const bool parallelParsing = resources::OBJLoader::IsParallelParsing();
+        resources::OBJLoader::SetParallelParsing(false);
+        Measure(results, "OBJLoader::LoadFromFile, single-threaded parse (KB)", sizeKb, iterations,
+            nullptr,
+            [&]() {
+                resources::Mesh mesh;
+                resources::OBJLoader::LoadFromFile(objPath, mesh);
+            });
+        resources::OBJLoader::SetParallelParsing(parallelParsing);
+        meshCache.SetEnabled(true);
+        Measure(results, "OBJLoader::LoadFromFile, mesh cache hit (KB)", sizeKb, iterations,
+            nullptr,
+            [&]() {
+                resources::Mesh mesh;
+                resources::OBJLoader::LoadFromFile(objPath, mesh);
+            });
+        meshCache.SetEnabled(cacheEnabled);
+    }
+
+    if (options.texturePath.empty()) {
+        DebugManager::GetInstance().Log("MicroBench", "No --bench-texture given; skipping texture decode");
+        return;
+    }
+    std::ifstream file(options.texturePath, std::ios::binary);
+    if (!file.is_open()) {
+        DebugManager::GetInstance().Log("MicroBench", "Failed to open texture: " + options.texturePath);
+        return;
+    }
+    const std::vector<unsigned char> encoded((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<unsigned char> pixels;
+    UINT width = 0, height = 0;
+    if (!resources::TextureLoader::DecodeWIC(encoded.data(), encoded.size(), pixels, width, height)) {
+        DebugManager::GetInstance().Log("MicroBench", "Failed to decode texture: " + options.texturePath);
+        return;
+    }
+    // 以百万像素计数，ns/item 即每兆像素耗时
+    Measure(results, "TextureLoader::DecodeWIC (MPixel)", std::max(1u, (width * height) / 1000000u), iterations,
+        nullptr,
+        [&]() { resources::TextureLoader::DecodeWIC(encoded.data(), encoded.size(), pixels, width, height); });
+}
+
+bool MicroBenchmark::WriteResults(const Options& options, const std::vector<Result>& results) {
+    std::ofstream file(options.outputPath, std::ios::trunc);
+    if (!file.is_open()) {
+        DebugManager::GetInstance().Log("MicroBench", "Failed to write results: " + options.outputPath);
+        return false;
+    }
+
+    char buffer[256];
+    file << "{\n";
+    file << "  \"run\": \"" << EscapeJson(options.label) << "\",\n";
+    snprintf(buffer, sizeof(buffer), "  \"entityCount\": %u,\n  \"sectorCount\": %u,\n  \"seed\": %u,\n",
+             options.entityCount, options.sectorCount, options.seed);
+    file << buffer;
+    file << "  \"kernels\": [";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        snprintf(buffer, sizeof(buffer),
+                 "\"items\": %u, \"iterations\": %u, \"minNs\": %.0f, \"medianNs\": %.0f, \"meanNs\": %.0f, "
+                 "\"nsPerItem\": %.3f }",
+                 r.items, r.iterations, r.minNs, r.medianNs, r.meanNs, r.items ? r.medianNs / r.items : 0.0);
+        file << (i ? ",\n" : "\n") << "    { \"name\": \"" << EscapeJson(r.name) << "\", " << buffer;
+    }
+    file << (results.empty() ? "]\n" : "\n  ]\n");
+    file << "}\n";
+
+    DebugManager::GetInstance().Log("MicroBench", "Results written: " + std::to_string(results.size()) +
+                                    " kernels -> " + options.outputPath);
+    return true;
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 热点内核的微基准（独立的 OuterWildsMicroBench 可执行文件，见 bench/main.cpp）
+ *
+ * 不创建窗口和 Engine，只通过各系统的公开接口在合成 registry 上逐个测量：
+ * - TransformSystem 世界矩阵刷新、RenderQueue::CollectFromECS（静止 / 全部移动）、
+ *   RenderQueue::Sort、LightweightRenderQueue::Sort
+ * - SectorPhysicsSystem::CalculateGravity、FindBestSectorForEntity（BVH 查询 + 滞后阈值）
+ * - OrbitSystem::EvaluateOrbits（orbitParent 链）、CoordinateSystem 位姿往返转换
+ * - SectorPhysicsSystem::SyncSectorEntities、PrefabPool 碎片生成 / 回收（PhysX 可用时含 actor 复用）
+ * - OBJLoader::LoadFromFile（--bench-obj，缺省时生成高细分球体 OBJ；并行解析、单线程解析与 MeshCache 命中分别测量）
+ * - TextureLoader::DecodeWIC（--bench-texture，缺省时跳过）
+ *
+ * 每个内核先热身一次，再测 iterations 次；JSON 记录每次耗时的 min / median / mean 和每元素耗时，
+ * 用于比较不同构建对同一内核的影响（整帧数据见 BenchmarkReport）。
+ */
+class MicroBenchmark {
+public:
+    struct Options {
+        uint32_t entityCount = 10000;     // 渲染实体 / 受重力实体数量
+        uint32_t sectorCount = 64;        // 扇区（同时是重力源和轨道天体）数量
+        uint32_t iterations = 30;
+        uint32_t seed = 1;
+        std::string objPath;              // 空 = 生成 cache/bench/ 下的合成球体
+        std::string texturePath;          // 空 = 跳过纹理解码
+        std::string outputPath = "microbench.json";
+        std::string label;
+    };
+
+    /** @brief 运行全部内核并写出 JSON；任何一项写入失败返回 false */
+    static bool Run(const Options& options);
+
+private:
+    struct Result {
+        std::string name;
+        uint32_t items = 0;
+        uint32_t iterations = 0;
+        double minNs = 0.0;
+        double medianNs = 0.0;
+        double meanNs = 0.0;
+    };
+
+    /** @brief setup 不计时（重置队列、推进时间等），body 计时 */
+    static void Measure(std::vector<Result>& results, const std::string& name, uint32_t items,
+                        uint32_t iterations, const std::function<void()>& setup,
+                        const std::function<void()>& body);
+
+    static void RunRenderBenchmarks(const Options& options, std::vector<Result>& results);
+    static void RunSectorBenchmarks(const Options& options, std::vector<Result>& results);
+    static void RunAssetBenchmarks(const Options& options, std::vector<Result>& results);
+
+    static bool WriteResults(const Options& options, const std::vector<Result>& results);
+};
+
+} // namespace outer_wilds
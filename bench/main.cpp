@@ -0,0 +1,45 @@
+/**
+ * bench/main.cpp
+ *
+ * 内核微基准入口（OuterWildsMicroBench，不创建窗口，跑完即退出）
+ *
+ * OuterWildsMicroBench <out.json> [--bench-entities N] [--bench-sectors K] [--bench-iterations I]
+ *                      [--bench-obj <file>] [--bench-texture <file>] [--bench-label <text>]
+ */
+
+#include "MicroBenchmark.h"
+#include "core/DebugManager.h"
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    outer_wilds::MicroBenchmark::Options options;
+    auto parseUInt = [](const char* text) { return static_cast<uint32_t>(std::strtoul(text, nullptr, 10)); };
+
+    int i = 1;
+    if (i < argc && argv[i][0] != '-') {
+        options.outputPath = argv[i++];
+    }
+    for (; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "[MicroBench] Missing value for " << arg << std::endl;
+            return 2;
+        }
+        if (arg == "--bench-entities") options.entityCount = parseUInt(argv[++i]);
+        else if (arg == "--bench-sectors") options.sectorCount = parseUInt(argv[++i]);
+        else if (arg == "--bench-iterations") options.iterations = parseUInt(argv[++i]);
+        else if (arg == "--bench-obj") options.objPath = argv[++i];
+        else if (arg == "--bench-texture") options.texturePath = argv[++i];
+        else if (arg == "--bench-label") options.label = argv[++i];
+        else {
+            std::cerr << "[MicroBench] Unknown option " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    outer_wilds::DebugManager::GetInstance().Log("MicroBench", "Writing results to " + options.outputPath);
+    return outer_wilds::MicroBenchmark::Run(options) ? 0 : 1;
+}
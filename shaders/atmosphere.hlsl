@@ -0,0 +1,154 @@
+// Planetary Atmosphere Shader - AtmosphereRenderer 的大气外壳
+// 沿视线取 VIEW_SAMPLES 个样本，太阳透射率和多重散射来自预计算 LUT（没有嵌套的光线步进）
+// 输出预乘结果：rgb = 散射, a = 1 - 平均透射率（混合：ONE, INV_SRC_ALPHA）
+
+#define VIEW_SAMPLES 12
+#define TRANSMITTANCE_SIZE float2(256.0f, 64.0f)
+#define MULTISCATTERING_SIZE float2(32.0f, 32.0f)
+#define PI 3.14159265f
+
+cbuffer PerFrameBuffer : register(b0)
+{
+    matrix viewProjection;
+    float3 cameraPosition;
+    float time;
+    float3 sunPosition;
+    float sunIntensityScene;
+    float3 sunColor;
+    float ambientStrength;
+};
+
+// 与 AtmosphereRenderer.h 中 AtmosphereConstants 一致（世界单位）
+cbuffer AtmosphereBuffer : register(b1)
+{
+    float3 planetCenter;
+    float groundRadius;
+    float3 rayleighScattering;
+    float rayleighScaleHeight;
+    float3 ozoneAbsorption;
+    float atmosphereRadius;
+    float mieScattering;
+    float mieExtinction;
+    float mieScaleHeight;
+    float miePhaseG;
+    float shellRadius;
+    float sunIntensity;
+    float atmosphereHeight;
+    float atmospherePadding;
+};
+
+Texture2D<float4> transmittanceLut : register(t0);     // u = 天顶角余弦, v = 高度 / 大气层高度
+Texture2D<float4> multiScatteringLut : register(t1);   // u = 太阳天顶角余弦, v = 高度 / 大气层高度
+SamplerState lutSampler : register(s0);
+
+struct VS_INPUT
+{
+    float3 position : POSITION;
+};
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float3 worldPos : TEXCOORD0;
+};
+
+PS_INPUT VSMain(VS_INPUT input)
+{
+    PS_INPUT output;
+    float3 worldPos = planetCenter + input.position * shellRadius;
+    output.position = mul(float4(worldPos, 1.0f), viewProjection);
+    output.worldPos = worldPos;
+    return output;
+}
+
+// CPU 端按 texel = u * (size - 1) 存放，换算到纹素中心
+float2 LutUV(float u, float v, float2 size)
+{
+    return (saturate(float2(u, v)) * (size - 1.0f) + 0.5f) / size;
+}
+
+// 射线与球求交：返回 (近, 远) 距离，无交点时 x > y
+float2 IntersectSphere(float3 origin, float3 dir, float radius)
+{
+    float b = dot(origin, dir);
+    float c = dot(origin, origin) - radius * radius;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0f)
+    {
+        return float2(1.0f, -1.0f);
+    }
+    float root = sqrt(discriminant);
+    return float2(-b - root, -b + root);
+}
+
+float MiePhase(float cosTheta, float g)
+{
+    // Cornette-Shanks
+    float g2 = g * g;
+    float k = 3.0f / (8.0f * PI) * (1.0f - g2) / (2.0f + g2);
+    return k * (1.0f + cosTheta * cosTheta) / pow(max(1.0f + g2 - 2.0f * g * cosTheta, 1e-4f), 1.5f);
+}
+
+float4 PSMain(PS_INPUT input) : SV_TARGET
+{
+    float3 origin = cameraPosition - planetCenter;
+    float3 dir = normalize(input.worldPos - cameraPosition);
+
+    float2 atmosphereHit = IntersectSphere(origin, dir, atmosphereRadius);
+    if (atmosphereHit.x > atmosphereHit.y || atmosphereHit.y <= 0.0f)
+    {
+        return float4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+    float tStart = max(atmosphereHit.x, 0.0f);
+    float tEnd = atmosphereHit.y;
+    float2 groundHit = IntersectSphere(origin, dir, groundRadius);
+    if (groundHit.x <= groundHit.y && groundHit.x > 0.0f)
+    {
+        tEnd = min(tEnd, groundHit.x);
+    }
+
+    // 太阳方向取球心处（太阳距离远大于大气尺度）
+    float3 sunDir = normalize(sunPosition - planetCenter);
+    float cosTheta = dot(dir, sunDir);
+    float rayleighPhase = 3.0f / (16.0f * PI) * (1.0f + cosTheta * cosTheta);
+    float miePhase = MiePhase(cosTheta, miePhaseG);
+
+    float dt = (tEnd - tStart) / VIEW_SAMPLES;
+    float3 luminance = float3(0.0f, 0.0f, 0.0f);
+    float3 transmittance = float3(1.0f, 1.0f, 1.0f);
+
+    [loop]
+    for (int i = 0; i < VIEW_SAMPLES; i++)
+    {
+        float3 p = origin + dir * (tStart + (i + 0.5f) * dt);
+        float radius = length(p);
+        float height = max(radius - groundRadius, 0.0f);
+        float3 up = p / radius;
+        float muSun = dot(up, sunDir);
+        float normalizedHeight = height / atmosphereHeight;
+
+        float rayleighDensity = exp(-height / rayleighScaleHeight);
+        float mieDensity = exp(-height / mieScaleHeight);
+        float ozoneDensity = max(0.0f, 1.0f - abs(normalizedHeight - 0.25f) / 0.15f);
+        float3 rayleighScat = rayleighScattering * rayleighDensity;
+        float mieScat = mieScattering * mieDensity;
+        float3 extinction = max(rayleighScat + mieExtinction * mieDensity + ozoneAbsorption * ozoneDensity, 1e-6f);
+
+        float3 sunTransmittance = transmittanceLut.SampleLevel(lutSampler,
+            LutUV(muSun * 0.5f + 0.5f, normalizedHeight, TRANSMITTANCE_SIZE), 0).rgb;
+        float3 multiScattering = multiScatteringLut.SampleLevel(lutSampler,
+            LutUV(muSun * 0.5f + 0.5f, normalizedHeight, MULTISCATTERING_SIZE), 0).rgb;
+
+        float3 scattering = sunTransmittance * (rayleighScat * rayleighPhase + mieScat * miePhase) +
+                            multiScattering * (rayleighScat + mieScat);
+
+        // 步内解析积分（能量守恒）
+        float3 stepTransmittance = exp(-extinction * dt);
+        luminance += transmittance * scattering * (1.0f - stepTransmittance) / extinction;
+        transmittance *= stepTransmittance;
+    }
+
+    luminance *= sunIntensity * sunColor;
+    float coverage = 1.0f - dot(transmittance, float3(1.0f / 3.0f, 1.0f / 3.0f, 1.0f / 3.0f));
+    return float4(luminance, coverage);
+}
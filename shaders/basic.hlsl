@@ -26,29 +26,92 @@ struct PS_INPUT
     float3 worldPos : POSITION;
     float3 normal : NORMAL;
     float2 texcoord : TEXCOORD0;
+    float4 color : COLOR0;
 };
 
-// Vertex Shader
-PS_INPUT VSMain(VS_INPUT input)
+// 整帧逐对象数据（t5，与 RenderQueue.h 中 ObjectData 一致；world 为行主序，无需转置）
+// 下标来自 slot 1 的 OBJECT_INDEX（按 StartInstanceLocation 偏移），单个和实例化绘制共用
+struct ObjectData
+{
+    row_major float4x4 world;
+    float4 color;
+    float3 lightDir;
+    float isSphere;
+    float receiveShadows;
+    float3 padding;
+};
+StructuredBuffer<ObjectData> objectData : register(t5);
+
+PS_INPUT TransformVertex(VS_INPUT input, float4x4 worldMatrix, float4 objectColor)
 {
     PS_INPUT output;
     
     // Transform to world space
-    float4 worldPos = mul(float4(input.position, 1.0f), world);
+    float4 worldPos = mul(float4(input.position, 1.0f), worldMatrix);
     output.worldPos = worldPos.xyz;
     
     // Transform to clip space
     output.position = mul(worldPos, viewProjection);
     
     // Transform normal to world space
-    output.normal = mul(input.normal, (float3x3)world);
+    output.normal = mul(input.normal, (float3x3)worldMatrix);
     output.normal = normalize(output.normal);
     
     output.texcoord = input.texcoord;
+    output.color = objectColor;
     
     return output;
 }
 
+// Vertex Shader
+PS_INPUT VSMain(VS_INPUT input)
+{
+    return TransformVertex(input, world, color);
+}
+
+// Object-buffer Vertex Shader（逐对象数据来自 objectData，RenderQueue 默认路径）
+PS_INPUT VSMainInstanced(VS_INPUT input, uint objectIndex : OBJECT_INDEX)
+{
+    ObjectData obj = objectData[objectIndex];
+    return TransformVertex(input, obj.world, obj.color);
+}
+
+// 压缩顶点（Mesh VertexFormat::Compact，28字节）：normal/tangent 为八面体编码（R16G16_SNORM），UV 为 R16G16_UNORM
+float3 DecodeOctahedral(float2 e)
+{
+    float3 v = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-v.z);
+    v.xy += v.xy >= 0.0f ? -t : t;
+    return normalize(v);
+}
+
+struct VS_INPUT_COMPACT
+{
+    float3 position : POSITION;
+    float2 normal : NORMAL;
+    float2 texcoord : TEXCOORD0;
+};
+
+VS_INPUT ExpandCompactVertex(VS_INPUT_COMPACT input)
+{
+    VS_INPUT output;
+    output.position = input.position;
+    output.normal = DecodeOctahedral(input.normal);
+    output.texcoord = input.texcoord;
+    return output;
+}
+
+PS_INPUT VSMainCompact(VS_INPUT_COMPACT input)
+{
+    return TransformVertex(ExpandCompactVertex(input), world, color);
+}
+
+PS_INPUT VSMainCompactInstanced(VS_INPUT_COMPACT input, uint objectIndex : OBJECT_INDEX)
+{
+    ObjectData obj = objectData[objectIndex];
+    return TransformVertex(ExpandCompactVertex(input), obj.world, obj.color);
+}
+
 // Pixel Shader
 float4 PSMain(PS_INPUT input) : SV_TARGET
 {
@@ -60,7 +123,7 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
     float ambient = 0.5f;  // 增加环境光,确保背光面也可见
     
     float3 lighting = float3(ambient + diffuse, ambient + diffuse, ambient + diffuse);
-    float3 finalColor = color.rgb * lighting;
+    float3 finalColor = input.color.rgb * lighting;
     
-    return float4(finalColor, color.a);
+    return float4(finalColor, input.color.a);
 }
@@ -0,0 +1,55 @@
+// Depth pre-pass shader - 只写深度的不透明预通道
+// 只读取 POSITION（常规/压缩顶点布局中都是偏移 0 的 float3），可直接使用批次原有的输入布局。
+// 变换必须与 basic/textured 的 TransformVertex 完全一致，着色通道才能用 EQUAL 深度测试。
+
+cbuffer PerFrameBuffer : register(b0)
+{
+    matrix viewProjection;
+    float3 cameraPosition;
+    float time;
+};
+
+cbuffer PerObjectBuffer : register(b1)
+{
+    matrix world;
+    float4 color;
+};
+
+// 与 RenderQueue.h 中 ObjectData 一致
+struct ObjectData
+{
+    row_major float4x4 world;
+    float4 color;
+    float3 lightDir;
+    float isSphere;
+    float receiveShadows;
+    float3 padding;
+};
+StructuredBuffer<ObjectData> objectData : register(t5);
+
+struct VS_INPUT
+{
+    float3 position : POSITION;
+};
+
+float4 TransformPosition(VS_INPUT input, float4x4 worldMatrix)
+{
+    float4 worldPos = mul(float4(input.position, 1.0f), worldMatrix);
+    return mul(worldPos, viewProjection);
+}
+
+float4 VSMain(VS_INPUT input) : SV_POSITION
+{
+    return TransformPosition(input, world);
+}
+
+float4 VSMainInstanced(VS_INPUT input, uint objectIndex : OBJECT_INDEX) : SV_POSITION
+{
+    return TransformPosition(input, objectData[objectIndex].world);
+}
+
+// 预通道不绑定像素着色器；PSMain 只是为了满足 Shader 的加载流程
+float4 PSMain(float4 position : SV_POSITION) : SV_TARGET
+{
+    return float4(0.0f, 0.0f, 0.0f, 1.0f);
+}
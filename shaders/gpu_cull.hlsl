@@ -0,0 +1,177 @@
+// GPU-driven instance culling - GpuInstanceRenderer 的视锥 + Hi-Z 剔除与压缩
+// 每个线程一个实例：包围球通过视锥和 Hi-Z 测试后，把世界矩阵写入压缩后的 ObjectData，
+// 实例数累加到 DrawIndexedInstancedIndirect 参数（字节偏移 4 = InstanceCount）
+
+#define CULL_GROUP_SIZE 64
+
+// 与 GpuInstanceRenderer.h 中 CullConstants 一致（16 字节对齐）
+cbuffer CullConstants : register(b0)
+{
+    row_major float4x4 entityWorld;     // 实例局部空间 → 世界空间
+    row_major float4x4 view;            // 世界 → 观察空间（Hi-Z 查询）
+    float4 frustumPlanes[6];            // 世界空间 (n, d)，dot(n, p) + d >= 0 在内
+    float4 color;                       // 材质 albedo（写入 ObjectData.color）
+    float3 sunPosition;
+    float entityScale;                  // entityWorld 的最大轴缩放（包围球半径）
+    uint instanceCount;
+    uint hizLevels;                     // 0 = 本帧没有遮挡体
+    float slopeX;                       // tan(半水平视场)
+    float slopeY;                       // tan(半垂直视场)
+    float nearPlane;
+    float receiveShadows;
+    uint hizWidth;
+    uint hizHeight;
+};
+
+// 与 GpuInstanceRenderer.h 中 GPUInstance 一致（80 字节）
+struct InstanceData
+{
+    row_major float4x4 local;           // 实例 → 实体局部空间
+    float4 sphere;                      // 实体局部空间包围球（xyz = 球心, w = 半径）
+};
+StructuredBuffer<InstanceData> instances : register(t0);
+
+// OcclusionCuller 的深度金字塔（观察空间 z，mip 0 = 128x64，逐级 2x2 取最大）
+Texture2D<float> hizPyramid : register(t1);
+
+// 与 RenderQueue.h 中 ObjectData / textured.hlsl 一致（112 字节）
+struct ObjectData
+{
+    row_major float4x4 world;
+    float4 color;
+    float3 lightDir;
+    float isSphere;
+    float receiveShadows;
+    float3 padding;
+};
+RWStructuredBuffer<ObjectData> visibleObjects : register(u0);
+RWByteAddressBuffer drawArgs : register(u1);
+
+groupshared uint g_VisibleCount;
+groupshared uint g_GroupBase;
+
+bool IsInsideFrustum(float3 center, float radius)
+{
+    [unroll]
+    for (int i = 0; i < 6; i++)
+    {
+        if (dot(frustumPlanes[i].xyz, center) + frustumPlanes[i].w < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 与 OcclusionCuller::IsOccluded 相同的保守测试
+bool IsOccluded(float3 worldCenter, float radius)
+{
+    if (hizLevels == 0)
+    {
+        return false;
+    }
+
+    float3 c = mul(float4(worldCenter, 1.0f), view).xyz;
+    float nearZ = c.z - radius;
+    float farZ = c.z + radius;
+    if (nearZ <= nearPlane)
+    {
+        return false;
+    }
+
+    float minX = min((c.x - radius) / nearZ, (c.x - radius) / farZ) / slopeX;
+    float maxX = max((c.x + radius) / nearZ, (c.x + radius) / farZ) / slopeX;
+    float minY = min((c.y - radius) / nearZ, (c.y - radius) / farZ) / slopeY;
+    float maxY = max((c.y + radius) / nearZ, (c.y + radius) / farZ) / slopeY;
+    minX = max(minX, -1.0f);
+    minY = max(minY, -1.0f);
+    maxX = min(maxX, 1.0f);
+    maxY = min(maxY, 1.0f);
+    if (minX > maxX || minY > maxY)
+    {
+        return false;
+    }
+
+    int x0 = min((int)((minX * 0.5f + 0.5f) * hizWidth), (int)hizWidth - 1);
+    int x1 = min((int)((maxX * 0.5f + 0.5f) * hizWidth), (int)hizWidth - 1);
+    int y0 = min((int)((minY * 0.5f + 0.5f) * hizHeight), (int)hizHeight - 1);
+    int y1 = min((int)((maxY * 0.5f + 0.5f) * hizHeight), (int)hizHeight - 1);
+
+    // 选择矩形最多覆盖 2x2 纹素的级别
+    uint level = 0;
+    while (level + 1 < hizLevels && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+    {
+        level++;
+    }
+
+    int levelWidth = max((int)(hizWidth >> level), 1);
+    int levelHeight = max((int)(hizHeight >> level), 1);
+    int lx0 = min(x0 >> level, levelWidth - 1);
+    int lx1 = min(x1 >> level, levelWidth - 1);
+    int ly0 = min(y0 >> level, levelHeight - 1);
+    int ly1 = min(y1 >> level, levelHeight - 1);
+
+    float maxDepth = 0.0f;
+    for (int y = ly0; y <= ly1; y++)
+    {
+        for (int x = lx0; x <= lx1; x++)
+        {
+            maxDepth = max(maxDepth, hizPyramid.Load(int3(x, y, level)));
+        }
+    }
+    return nearZ > maxDepth;
+}
+
+[numthreads(CULL_GROUP_SIZE, 1, 1)]
+void CSMain(uint3 dispatchId : SV_DispatchThreadID, uint groupIndex : SV_GroupIndex)
+{
+    if (groupIndex == 0)
+    {
+        g_VisibleCount = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint index = dispatchId.x;
+    bool visible = false;
+    float4x4 world = (float4x4)0;
+    float3 worldCenter = float3(0.0f, 0.0f, 0.0f);
+    if (index < instanceCount)
+    {
+        InstanceData instance = instances[index];
+        world = mul(instance.local, entityWorld);
+        worldCenter = mul(float4(instance.sphere.xyz, 1.0f), entityWorld).xyz;
+        float radius = instance.sphere.w * entityScale;
+        visible = IsInsideFrustum(worldCenter, radius) && !IsOccluded(worldCenter, radius);
+    }
+
+    // 组内先压缩，每组只做一次全局原子加
+    uint localSlot = 0;
+    if (visible)
+    {
+        InterlockedAdd(g_VisibleCount, 1, localSlot);
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex == 0)
+    {
+        uint base = 0;
+        if (g_VisibleCount > 0)
+        {
+            drawArgs.InterlockedAdd(4, g_VisibleCount, base);
+        }
+        g_GroupBase = base;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (visible)
+    {
+        ObjectData obj;
+        obj.world = world;
+        obj.color = color;
+        obj.lightDir = normalize(sunPosition - worldCenter + float3(0.0f, 1e-6f, 0.0f));
+        obj.isSphere = 0.0f;
+        obj.receiveShadows = receiveShadows;
+        obj.padding = float3(0.0f, 0.0f, 0.0f);
+        visibleObjects[g_GroupBase + localSlot] = obj;
+    }
+}
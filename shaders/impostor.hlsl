@@ -0,0 +1,116 @@
+// Sphere impostor shader - 远处天体的球形替身
+// 每个实例一个面向相机的四边形（SV_VertexID 生成，无顶点缓冲区），像素着色器做射线-球求交
+
+cbuffer PerFrameBuffer : register(b0)
+{
+    matrix viewProjection;
+    float3 cameraPosition;
+    float time;
+    float3 sunPosition;
+    float sunIntensity;
+    float3 sunColor;
+    float ambientStrength;
+};
+
+// 与 ImpostorRenderer.h 中 GPUImpostor 一致（64 字节）
+struct ImpostorData
+{
+    float3 center;
+    float radius;
+    float4 color;
+    float3 lightDir;
+    float paletteIndex;   // 平均反照率在调色板中的列（< 0 = 无纹理）
+    float emissive;
+    float3 padding;
+};
+StructuredBuffer<ImpostorData> impostors : register(t0);
+
+// 每个反照率纹理最低 mip 的平均颜色（256x1）
+Texture2D<float4> albedoPalette : register(t1);
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float3 worldPos : TEXCOORD0;
+    nointerpolation float4 sphere : TEXCOORD1;     // xyz = 球心, w = 半径
+    nointerpolation float4 color : COLOR0;
+    nointerpolation float4 lightDirAndPalette : TEXCOORD2;
+    nointerpolation float emissive : TEXCOORD3;
+};
+
+struct PS_OUTPUT
+{
+    float4 color : SV_Target;
+    float depth : SV_Depth;
+};
+
+PS_INPUT VSMain(uint vertexId : SV_VertexID, uint instanceId : SV_InstanceID)
+{
+    ImpostorData data = impostors[instanceId];
+
+    float3 toCamera = cameraPosition - data.center;
+    float distance = max(length(toCamera), 1e-4);
+    float3 viewDir = toCamera / distance;
+
+    // 过球心、垂直视线的平面上，视锥切线圆的半径（比球半径略大，远处时趋近于球半径）
+    float tangent = sqrt(max(distance * distance - data.radius * data.radius, 1e-4));
+    float quadRadius = min(data.radius * distance / tangent, data.radius * 4.0);
+
+    float3 upHint = abs(viewDir.y) < 0.99 ? float3(0.0, 1.0, 0.0) : float3(1.0, 0.0, 0.0);
+    float3 right = normalize(cross(upHint, viewDir));
+    float3 up = cross(viewDir, right);
+
+    // 三角带顺序：(-1,-1) (1,-1) (-1,1) (1,1)
+    float2 corner = float2((vertexId & 1) ? 1.0 : -1.0, (vertexId & 2) ? 1.0 : -1.0);
+    float3 worldPos = data.center + (right * corner.x + up * corner.y) * quadRadius;
+
+    PS_INPUT output;
+    output.position = mul(float4(worldPos, 1.0), viewProjection);
+    output.worldPos = worldPos;
+    output.sphere = float4(data.center, data.radius);
+    output.color = data.color;
+    output.lightDirAndPalette = float4(data.lightDir, data.paletteIndex);
+    output.emissive = data.emissive;
+    return output;
+}
+
+PS_OUTPUT PSMain(PS_INPUT input)
+{
+    float3 rayDir = normalize(input.worldPos - cameraPosition);
+    float3 oc = cameraPosition - input.sphere.xyz;
+    float b = dot(oc, rayDir);
+    float c = dot(oc, oc) - input.sphere.w * input.sphere.w;
+    float h = b * b - c;
+    if (h < 0.0)
+    {
+        discard;
+    }
+
+    float t = max(-b - sqrt(h), 0.0);
+    float3 hitPos = cameraPosition + rayDir * t;
+    float3 normal = normalize(hitPos - input.sphere.xyz);
+
+    float4 albedo = input.color;
+    if (input.lightDirAndPalette.w >= 0.0)
+    {
+        albedo *= albedoPalette.Load(int3((int)input.lightDirAndPalette.w, 0, 0));
+    }
+
+    float3 finalColor;
+    if (input.emissive > 0.5)
+    {
+        finalColor = albedo.rgb;
+    }
+    else
+    {
+        float NdotL = saturate(dot(normal, normalize(input.lightDirAndPalette.xyz)));
+        finalColor = albedo.rgb * (sunColor * sunIntensity * NdotL + ambientStrength);
+    }
+
+    float4 clipPos = mul(float4(hitPos, 1.0), viewProjection);
+
+    PS_OUTPUT output;
+    output.color = float4(finalColor, 1.0);
+    output.depth = clipPos.z / clipPos.w;
+    return output;
+}
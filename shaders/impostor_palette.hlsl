@@ -0,0 +1,17 @@
+// Impostor palette shader - 把反照率纹理的平均颜色写入调色板的一个像素
+// 全屏三角形（SV_VertexID），视口为目标的 1x1 像素；采样最低 mip 即整张纹理的平均值
+
+Texture2D sourceTexture : register(t0);
+SamplerState sourceSampler : register(s0);
+
+float4 VSMain(uint vertexId : SV_VertexID) : SV_POSITION
+{
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    return float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+
+float4 PSMain(float4 position : SV_POSITION) : SV_Target
+{
+    // LOD 超出 mip 数时被钳制到最小的 mip
+    return float4(sourceTexture.SampleLevel(sourceSampler, float2(0.5, 0.5), 16.0).rgb, 1.0);
+}
@@ -0,0 +1,41 @@
+// Baked Starfield Skybox Shader
+// 烘焙星空天空盒 - 采样 SkyboxRenderer 由 skybox.hlsl 烘焙的立方体贴图（每像素一次采样）
+
+cbuffer SkyboxBuffer : register(b0)
+{
+    matrix viewProjection;
+    float3 cameraPosition;
+    float time;
+    float3 parallaxOffset;   // 相机移动产生的视差偏移 (cameraPos * parallaxFactor)
+    float parallaxFactor;
+};
+
+TextureCube skyCubemap : register(t0);
+SamplerState skySampler : register(s0);
+
+struct VS_INPUT
+{
+    float3 position : POSITION;
+};
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float3 texCoord : TEXCOORD0;
+};
+
+// 与 skybox.hlsl 的 VSMain 相同（视差偏移、深度 = 最远）
+PS_INPUT VSMain(VS_INPUT input)
+{
+    PS_INPUT output;
+    float3 worldPos = input.position * 1000.0f + cameraPosition - parallaxOffset;
+    output.position = mul(float4(worldPos, 1.0f), viewProjection);
+    output.position.z = output.position.w;
+    output.texCoord = input.position;
+    return output;
+}
+
+float4 PSMain(PS_INPUT input) : SV_TARGET
+{
+    return float4(skyCubemap.Sample(skySampler, normalize(input.texCoord)).rgb, 1.0f);
+}
@@ -1,5 +1,21 @@
 // PBR Textured shader with multi-texture support and dynamic sun lighting
 
+// ============================================
+// 编译期排列（resources::ShaderPermutation，RenderQueue 按材质实际拥有的纹理选择）
+// 排列编译时定义 SHADER_PERMUTATION=1，且下列宏全部定义为 0/1；
+// 预编译为 shaders/compiled/textured.PSMain.p<permutation>.cso（CMake shaders 目标）
+// 不经排列系统直接编译时：只有 albedo 贴图 + 顶点颜色
+// ============================================
+#ifndef SHADER_PERMUTATION
+#define HAS_ALBEDO_MAP 1
+#define HAS_NORMAL_MAP 0
+#define HAS_METALLIC_MAP 0
+#define HAS_ROUGHNESS_MAP 0
+#define HAS_EMISSIVE_MAP 0
+#define HAS_VERTEX_COLOR 1
+#define HAS_TEXTURE_ARRAY 0
+#endif
+
 cbuffer PerFrameBuffer : register(b0)
 {
     matrix viewProjection;
@@ -17,14 +33,25 @@ cbuffer PerObjectBuffer : register(b1)
     float4 color;
     float3 lightDir;      // CPU预计算的光照方向（从物体指向太阳）
     float isSphere;       // 是否是球体
+    float receiveShadows; // 是否采样级联阴影
+    float3 objectPadding;
 };
 
 // Multi-texture PBR maps
-Texture2D albedoTexture : register(t0);    // Diffuse/Albedo map
-Texture2D normalTexture : register(t1);    // Normal map (tangent space)
-Texture2D metallicTexture : register(t2);  // Metallic map
-Texture2D roughnessTexture : register(t3); // Roughness map
-Texture2D emissiveTexture : register(t4);  // Emissive/自发光 map
+// HAS_TEXTURE_ARRAY：材质贴图打包在 Texture2DArray 图集中（resources::TextureArrayAtlas），
+// 层下标来自 MaterialBuffer，多个材质共用同一组 SRV
+#if HAS_TEXTURE_ARRAY
+#define MATERIAL_TEXTURE Texture2DArray
+#define SAMPLE_MATERIAL(tex, slice, uv) tex.Sample(textureSampler, float3(uv, slice))
+#else
+#define MATERIAL_TEXTURE Texture2D
+#define SAMPLE_MATERIAL(tex, slice, uv) tex.Sample(textureSampler, uv)
+#endif
+MATERIAL_TEXTURE albedoTexture : register(t0);    // Diffuse/Albedo map
+MATERIAL_TEXTURE normalTexture : register(t1);    // Normal map (tangent space)
+MATERIAL_TEXTURE metallicTexture : register(t2);  // Metallic map
+MATERIAL_TEXTURE roughnessTexture : register(t3); // Roughness map
+MATERIAL_TEXTURE emissiveTexture : register(t4);  // Emissive/自发光 map
 SamplerState textureSampler : register(s0);
 
 // Material properties
@@ -33,7 +60,9 @@ cbuffer MaterialBuffer : register(b2)
     float3 emissiveColor;    // 自发光颜色
     float emissiveStrength;  // 发光强度 (0 = 无发光)
     float hasEmissiveTexture; // 是否有emissive纹理 (1.0 = 是, 0.0 = 否)
-    float3 padding2;         // Padding to 32 bytes
+    float emissiveSlice;     // 图集层下标（HAS_TEXTURE_ARRAY）
+    float2 padding2;
+    float4 textureSlices;    // 图集层下标：albedo / normal / metallic / roughness（48 字节）
 };
 
 struct VS_INPUT
@@ -54,25 +83,166 @@ struct PS_INPUT
     float3 tangent : TANGENT;
     float4 color : COLOR0;
     float3 modelPos : TEXCOORD2;  // 模型空间位置（用于计算球面法线）
+    float3 objectCenter : TEXCOORD3;  // 物体中心（世界矩阵平移部分）
+    nointerpolation float4 lightDirAndSphere : TEXCOORD4;  // xyz=CPU预计算光照方向, w=isSphere
+    nointerpolation float receiveShadows : TEXCOORD5;
 };
 
-// Vertex Shader
-PS_INPUT VSMain(VS_INPUT input)
+// 整帧逐对象数据（t5，与 RenderQueue.h 中 ObjectData 一致；world 为行主序，无需转置）
+// 下标来自 slot 1 的 OBJECT_INDEX（按 StartInstanceLocation 偏移），单个和实例化绘制共用
+struct ObjectData
+{
+    row_major float4x4 world;
+    float4 color;
+    float3 lightDir;
+    float isSphere;
+    float receiveShadows;
+    float3 padding;
+};
+StructuredBuffer<ObjectData> objectData : register(t5);
+
+// 级联阴影（ShadowRenderer 绑定；未绑定时 cascadeCount 读到 0，全部视为受光）
+cbuffer ShadowBuffer : register(b3)
+{
+    matrix cascadeMatrices[4];   // 世界 → 光源裁剪空间（缓存级联已换算到当前帧）
+    float4 cascadeEnabled;       // 每个级联是否已有有效的阴影图
+    float4 cascadeBias;          // 每个级联的深度偏移（光源 NDC）
+    float4 shadowParams;         // x = 级联数, y = 阴影图纹素大小（UV）
+};
+Texture2DArray<float> shadowMap : register(t6);
+SamplerComparisonState shadowSampler : register(s1);
+
+// 从最近的级联开始，取第一个覆盖该点的级联做 3x3 PCF；超出所有级联时视为受光
+float SampleCascadedShadow(float3 worldPos)
+{
+    int cascadeCount = (int)shadowParams.x;
+    [loop]
+    for (int i = 0; i < cascadeCount; i++)
+    {
+        if (cascadeEnabled[i] < 0.5f)
+        {
+            continue;
+        }
+        float4 lightPos = mul(float4(worldPos, 1.0f), cascadeMatrices[i]);
+        float3 ndc = lightPos.xyz / lightPos.w;
+        float2 uv = float2(ndc.x * 0.5f + 0.5f, -ndc.y * 0.5f + 0.5f);
+        if (any(uv < 0.0f) || any(uv > 1.0f) || ndc.z > 1.0f)
+        {
+            continue;
+        }
+
+        float depth = ndc.z - cascadeBias[i];
+        float lit = 0.0f;
+        [unroll]
+        for (int y = -1; y <= 1; y++)
+        {
+            [unroll]
+            for (int x = -1; x <= 1; x++)
+            {
+                lit += shadowMap.SampleCmpLevelZero(shadowSampler, float3(uv + float2(x, y) * shadowParams.y, i), depth);
+            }
+        }
+        return lit / 9.0f;
+    }
+    return 1.0f;
+}
+
+// 分簇前向光照（ClusteredLighting 绑定；未绑定时 clusterLightCount 读到 0，不做局部光照）
+cbuffer ClusterBuffer : register(b4)
+{
+    row_major float4x4 clusterView;  // 世界 → 观察空间
+    float4 clusterScreen;            // xy = 屏幕块数 / 视口尺寸, zw = 视口原点
+    float4 clusterSlices;            // x = 切片缩放, y = 切片偏移（slice = log(z) * x + y）, z = 近平面, w = 最远距离
+    uint clusterLightCount;
+    uint clusterTilesX;
+    uint clusterTilesY;
+    uint clusterSliceCount;
+};
+
+// 与 ClusteredLighting.h 中 GPULight 一致（64 字节）
+struct LocalLight
+{
+    float3 position;
+    float range;
+    float3 color;          // 已乘 intensity
+    float attenuation;
+    float3 direction;      // 聚光灯朝向
+    float spotCosOuter;
+    float spotCosInner;
+    float isSpot;
+    float2 lightPadding;
+};
+StructuredBuffer<LocalLight> localLights : register(t7);
+StructuredBuffer<uint2> lightClusters : register(t8);   // 每簇 (偏移, 数量)
+StructuredBuffer<uint> lightIndices : register(t9);
+
+// 只遍历像素所在簇的点光源 / 聚光灯（漫反射 + Blinn-Phong 高光）
+float3 ShadeLocalLights(float3 worldPos, float2 pixel, float3 normal, float3 viewDir,
+                        float3 albedo, float3 specularColor, float roughness, float metallic)
+{
+    float3 result = float3(0.0f, 0.0f, 0.0f);
+    if (clusterLightCount == 0)
+    {
+        return result;
+    }
+    float viewZ = mul(float4(worldPos, 1.0f), clusterView).z;
+    if (viewZ >= clusterSlices.w)
+    {
+        return result;
+    }
+
+    uint2 tile = (uint2)max((pixel - clusterScreen.zw) * clusterScreen.xy, 0.0f);
+    tile = min(tile, uint2(clusterTilesX - 1, clusterTilesY - 1));
+    int slice = (int)floor(log(max(viewZ, clusterSlices.z)) * clusterSlices.x + clusterSlices.y);
+    slice = clamp(slice, 0, (int)clusterSliceCount - 1);
+    uint2 cluster = lightClusters[((uint)slice * clusterTilesY + tile.y) * clusterTilesX + tile.x];
+
+    float specPower = lerp(256.0f, 4.0f, roughness);
+    [loop]
+    for (uint i = 0; i < cluster.y; i++)
+    {
+        LocalLight light = localLights[lightIndices[cluster.x + i]];
+        float3 toLight = light.position - worldPos;
+        float dist = length(toLight);
+        if (dist >= light.range)
+        {
+            continue;
+        }
+        float3 L = toLight / max(dist, 1e-4f);
+
+        // 平滑截断到 range，attenuation 控制距离衰减强度
+        float ratio = dist / light.range;
+        float window = saturate(1.0f - ratio * ratio * ratio * ratio);
+        float falloff = window * window / (1.0f + light.attenuation * dist * dist);
+        if (light.isSpot > 0.5f)
+        {
+            falloff *= smoothstep(light.spotCosOuter, light.spotCosInner, dot(-L, light.direction));
+        }
+
+        float NdotL = saturate(dot(normal, L));
+        float3 halfDir = normalize(L + viewDir);
+        float specular = pow(max(dot(normal, halfDir), 0.0f), specPower) * (1.0f - roughness);
+        result += light.color * falloff * (albedo * NdotL * (1.0f - metallic * 0.5f) + specularColor * specular * NdotL);
+    }
+    return result;
+}
+
+PS_INPUT TransformVertex(VS_INPUT input, float4x4 worldMatrix, float4 lightDirAndSphere, float receiveShadows)
 {
     PS_INPUT output;
     
     // Transform to world space
-    float4 worldPos = mul(float4(input.position, 1.0f), world);
+    float4 worldPos = mul(float4(input.position, 1.0f), worldMatrix);
     output.worldPos = worldPos.xyz;
     
     // Transform to clip space
     output.position = mul(worldPos, viewProjection);
     
     // Transform normal and tangent to world space
-    output.normal = mul(input.normal, (float3x3)world);
+    output.normal = mul(input.normal, (float3x3)worldMatrix);
     output.normal = normalize(output.normal);
     
-    output.tangent = mul(input.tangent, (float3x3)world);
+    output.tangent = mul(input.tangent, (float3x3)worldMatrix);
     output.tangent = normalize(output.tangent);
     
     output.texcoord = input.texcoord;
@@ -80,19 +250,84 @@ PS_INPUT VSMain(VS_INPUT input)
     
     // 传递模型空间位置（用于计算球面法线）
     output.modelPos = input.position;
+    output.objectCenter = worldMatrix._41_42_43;
+    output.lightDirAndSphere = lightDirAndSphere;
+    output.receiveShadows = receiveShadows;
     
     return output;
 }
 
+// Vertex Shader
+PS_INPUT VSMain(VS_INPUT input)
+{
+    return TransformVertex(input, world, float4(lightDir, isSphere), receiveShadows);
+}
+
+// Object-buffer Vertex Shader（逐对象数据来自 objectData，RenderQueue 默认路径）
+PS_INPUT VSMainInstanced(VS_INPUT input, uint objectIndex : OBJECT_INDEX)
+{
+    ObjectData obj = objectData[objectIndex];
+    return TransformVertex(input, obj.world, float4(obj.lightDir, obj.isSphere), obj.receiveShadows);
+}
+
+// 压缩顶点（Mesh VertexFormat::Compact，28字节）：normal/tangent 为八面体编码（R16G16_SNORM），UV 为 R16G16_UNORM
+float3 DecodeOctahedral(float2 e)
+{
+    float3 v = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-v.z);
+    v.xy += v.xy >= 0.0f ? -t : t;
+    return normalize(v);
+}
+
+struct VS_INPUT_COMPACT
+{
+    float3 position : POSITION;
+    float2 normal : NORMAL;
+    float2 texcoord : TEXCOORD0;
+    float2 tangent : TANGENT;
+    float4 color : COLOR0;
+};
+
+VS_INPUT ExpandCompactVertex(VS_INPUT_COMPACT input)
+{
+    VS_INPUT output;
+    output.position = input.position;
+    output.normal = DecodeOctahedral(input.normal);
+    output.texcoord = input.texcoord;
+    output.tangent = DecodeOctahedral(input.tangent);
+    output.color = input.color;
+    return output;
+}
+
+PS_INPUT VSMainCompact(VS_INPUT_COMPACT input)
+{
+    return TransformVertex(ExpandCompactVertex(input), world, float4(lightDir, isSphere), receiveShadows);
+}
+
+PS_INPUT VSMainCompactInstanced(VS_INPUT_COMPACT input, uint objectIndex : OBJECT_INDEX)
+{
+    ObjectData obj = objectData[objectIndex];
+    return TransformVertex(ExpandCompactVertex(input), obj.world, float4(obj.lightDir, obj.isSphere), obj.receiveShadows);
+}
+
 // Pixel Shader with PBR multi-texture support
 float4 PSMain(PS_INPUT input) : SV_TARGET
 {
     // Sample albedo texture (or use vertex color as fallback)
-    float4 albedo = albedoTexture.Sample(textureSampler, input.texcoord);
-    bool hasVertexColor = (input.color.r != 1.0f || input.color.g != 1.0f || input.color.b != 1.0f);
-    if (hasVertexColor && albedo.r > 0.99f && albedo.g > 0.99f && albedo.b > 0.99f) {
+#if HAS_ALBEDO_MAP
+    float4 albedo = SAMPLE_MATERIAL(albedoTexture, textureSlices.x, input.texcoord);
+    #if HAS_VERTEX_COLOR
+    // 贴图中的纯白区域使用顶点颜色（MTL 的 Kd）
+    if (albedo.r > 0.99f && albedo.g > 0.99f && albedo.b > 0.99f) {
         albedo = input.color;
     }
+    #endif
+#elif HAS_VERTEX_COLOR
+    float4 albedo = input.color;
+#else
+    // 与未绑定纹理时的采样结果一致
+    float4 albedo = float4(0.0f, 0.0f, 0.0f, 0.0f);
+#endif
     
     // 使用模型法线（新模型有正确的平滑法线）
     float3 normal = normalize(input.normal);
@@ -100,13 +335,13 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
     float3 viewDir = normalize(cameraPosition - input.worldPos);
     
     // Sample normal map (if available) and apply tangent-space normal mapping
-    float3 normalMap = normalTexture.Sample(textureSampler, input.texcoord).rgb;
-    
-    // Check if we have a valid normal map (not default [0.5, 0.5, 1.0])
-    bool hasNormalMap = (abs(normalMap.r - 0.5f) > 0.01f || abs(normalMap.g - 0.5f) > 0.01f);
-    if (hasNormalMap) {
+#if HAS_NORMAL_MAP
+    {
+        float3 normalMap = SAMPLE_MATERIAL(normalTexture, textureSlices.y, input.texcoord).rgb;
         // Convert from [0,1] to [-1,1]
         normalMap = normalMap * 2.0f - 1.0f;
+        // 烘焙后的法线贴图为 BC5（只有 RG），由 XY 重建 Z（对未压缩贴图同样成立）
+        normalMap.z = sqrt(saturate(1.0f - dot(normalMap.xy, normalMap.xy)));
         
         // Build TBN matrix for tangent-space to world-space transformation
         float3 T = normalize(input.tangent);
@@ -117,10 +352,19 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
         
         normal = normalize(mul(normalMap, TBN));
     }
-    
-    // Sample PBR maps (with fallback to default values)
-    float metallic = metallicTexture.Sample(textureSampler, input.texcoord).r;
-    float roughness = roughnessTexture.Sample(textureSampler, input.texcoord).r;
+#endif
+    
+    // Sample PBR maps (没有贴图时为 0，与未绑定纹理时的采样结果一致)
+#if HAS_METALLIC_MAP
+    float metallic = SAMPLE_MATERIAL(metallicTexture, textureSlices.z, input.texcoord).r;
+#else
+    float metallic = 0.0f;
+#endif
+#if HAS_ROUGHNESS_MAP
+    float roughness = SAMPLE_MATERIAL(roughnessTexture, textureSlices.w, input.texcoord).r;
+#else
+    float roughness = 0.0f;
+#endif
     
     // ============================================
     // 基于太阳位置的动态光照（点光源模式）
@@ -151,7 +395,7 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
     
     // === 半球光照：基于世界位置判断是否面向太阳 ===
     // 计算像素到物体中心的方向（用世界矩阵的平移部分作为物体中心）
-    float3 objectCenter = float3(world._41, world._42, world._43);
+    float3 objectCenter = input.objectCenter;
     float3 sunToCenter = objectCenter - sunPosition;  // 从太阳到物体中心
     float3 centerToPixel = input.worldPos - objectCenter;  // 从物体中心到像素
     
@@ -165,6 +409,9 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
     // 软化边缘过渡
     float softHemisphere = smoothstep(-0.1f, 0.3f, -hemisphereTest);
     
+    // 级联阴影（只遮挡太阳直射部分）
+    float shadow = input.receiveShadows > 0.5f ? SampleCascadedShadow(input.worldPos) : 1.0f;
+    
     #if DEBUG_MODE == 1
         return float4(sunPosition / 200.0f + 0.5f, 1.0f);
     #elif DEBUG_MODE == 2
@@ -176,7 +423,7 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
         float vis = NdotL * 0.5f + 0.5f;
         return float4(1.0f - vis, vis, 0.0f, 1.0f);
     #elif DEBUG_MODE == 5
-        return float4(normalize(lightDir) * 0.5f + 0.5f, 1.0f);
+        return float4(normalize(input.lightDirAndSphere.xyz) * 0.5f + 0.5f, 1.0f);
     #elif DEBUG_MODE == 6
         return float4(gpuLightDir * 0.5f + 0.5f, 1.0f);
     #elif DEBUG_MODE == 10
@@ -190,22 +437,22 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
     #if LIGHTING_MODE == 0
         // 标准 NdotL 光照
         float wrap = 0.3f;
-        diffuse = max((NdotL + wrap) / (1.0f + wrap), 0.0f);
+        diffuse = max((NdotL + wrap) / (1.0f + wrap), 0.0f) * shadow;
     #elif LIGHTING_MODE == 1
         // 半球光照：基于几何位置，不依赖法线
         // 面光半球 = 1.0，背光半球 = 环境光
-        diffuse = softHemisphere * 0.8f + 0.2f;  // 面光=1.0, 背光=0.2
+        diffuse = softHemisphere * shadow * 0.8f + 0.2f;  // 面光=1.0, 背光/阴影=0.2
     #elif LIGHTING_MODE == 2
         // Wrap 光照 + 半球混合
         float wrap = 0.5f;
         float wrapDiffuse = max((NdotL + wrap) / (1.0f + wrap), 0.0f);
-        diffuse = lerp(wrapDiffuse, softHemisphere, 0.5f);  // 50%混合
+        diffuse = lerp(wrapDiffuse, softHemisphere, 0.5f) * shadow;  // 50%混合
     #endif
     
     // Specular (simplified Blinn-Phong, modified by roughness)
     float3 halfDir = normalize(pixelLightDir + viewDir);
     float specPower = lerp(256.0f, 4.0f, roughness);  // Roughness controls spec power
-    float specular = pow(max(dot(normal, halfDir), 0.0f), specPower) * (1.0f - roughness);
+    float specular = pow(max(dot(normal, halfDir), 0.0f), specPower) * (1.0f - roughness) * shadow;
     
     // 半球模式下减弱高光（因为不依赖法线）
     #if LIGHTING_MODE == 1
@@ -228,25 +475,25 @@ float4 PSMain(PS_INPUT input) : SV_TARGET
     float3 lighting = ambient + diffuseLight * (1.0f - metallic * 0.5f);
     float3 finalColor = albedo.rgb * lighting + specularLight;
     
+    // 局部光源（座舱灯、飞船头灯、基地灯光）
+    finalColor += ShadeLocalLights(input.worldPos, input.position.xy, normal, viewDir,
+                                   albedo.rgb, specularColor, roughness, metallic);
+    
     // Emissive/自发光 - 采样emissive纹理或使用emissive颜色
-    float3 emissive = float3(0.0f, 0.0f, 0.0f);
-    if (hasEmissiveTexture > 0.5f) {
-        // 有emissive纹理时，采样纹理并乘以emissive颜色和强度
-        emissive = emissiveTexture.Sample(textureSampler, input.texcoord).rgb;
-        emissive *= emissiveColor;
-        // 自发光物体（如太阳）：直接使用emissive颜色，忽略光照计算
-        finalColor = emissive * emissiveStrength;
-    } else {
-        // 没有纹理时，检查是否有emissive颜色
-        float emissiveTotal = emissiveColor.r + emissiveColor.g + emissiveColor.b;
-        if (emissiveTotal > 0.1f && emissiveStrength > 0.1f) {
-            // 有emissive颜色，直接使用
-            finalColor = emissiveColor * emissiveStrength;
-        } else {
-            // 普通物体，使用计算的光照
-            finalColor += emissive * emissiveStrength;
-        }
+#if HAS_EMISSIVE_MAP
+    // 有emissive纹理时，采样纹理并乘以emissive颜色和强度
+    float3 emissive = SAMPLE_MATERIAL(emissiveTexture, emissiveSlice, input.texcoord).rgb;
+    emissive *= emissiveColor;
+    // 自发光物体（如太阳）：直接使用emissive颜色，忽略光照计算
+    finalColor = emissive * emissiveStrength;
+#else
+    // 没有纹理时，检查是否有emissive颜色（材质常量，整个批次一致）
+    float emissiveTotal = emissiveColor.r + emissiveColor.g + emissiveColor.b;
+    if (emissiveTotal > 0.1f && emissiveStrength > 0.1f) {
+        // 有emissive颜色，直接使用
+        finalColor = emissiveColor * emissiveStrength;
     }
+#endif
     
     return float4(finalColor, albedo.a);
 }
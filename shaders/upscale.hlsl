@@ -0,0 +1,32 @@
+// Upscale shader - 把动态分辨率场景目标的左上角子区域双线性拉伸到整个后缓冲区
+// 全屏三角形（SV_VertexID），不需要顶点缓冲区
+
+cbuffer UpscaleBuffer : register(b0)
+{
+    float2 uvScale;     // 渲染尺寸 / 目标纹理尺寸
+    float2 uvClamp;     // 最后一个有效纹素中心，防止双线性采样到子区域之外
+};
+
+Texture2D sceneTexture : register(t0);
+SamplerState linearSampler : register(s0);
+
+struct PS_INPUT
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+};
+
+PS_INPUT VSMain(uint vertexId : SV_VertexID)
+{
+    PS_INPUT output;
+    float2 uv = float2((vertexId << 1) & 2, vertexId & 2);
+    output.position = float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    output.uv = uv;
+    return output;
+}
+
+float4 PSMain(PS_INPUT input) : SV_Target
+{
+    float2 uv = min(input.uv * uvScale, uvClamp);
+    return float4(sceneTexture.SampleLevel(linearSampler, uv, 0.0).rgb, 1.0);
+}
@@ -1,6 +1,13 @@
 #include "AudioSystem.h"
-#define MINIMP3_IMPLEMENTATION
-#include <minimp3/minimp3_ex.h>
+#include "../core/FrameAllocator.h"
+#include "../core/Profiler.h"
+#include "../graphics/CameraService.h"
+#include "../physics/PhysicsEvents.h"
+#include "../physics/components/SectorComponent.h"
+#include "../scene/AssetStreamer.h"
+#include "../scene/components/TransformComponent.h"
+#include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <algorithm>
 #include <iostream>
@@ -9,6 +16,61 @@ namespace outer_wilds {
 
 static bool s_AudioDebug = false;
 
+namespace {
+
+constexpr uint32_t kMaxOutputChannels = 8;
+// 虚拟化阈值（线性增益，约 -60 dB / -54 dB）：滞后避免在阈值附近反复交还 / 借用声部
+constexpr float kVirtualizeBelow = 0.001f;
+constexpr float kRealizeAbove = 0.002f;
+constexpr WORD kWaveFormatADPCM = 0x0002;
+// 立体声音源的左右声道方位（X3DAudio：弧度，顺时针，0 为正前方）
+const float kStereoAzimuths[2] = { X3DAUDIO_PI * 1.5f, X3DAUDIO_PI * 0.5f };
+
+X3DAUDIO_VECTOR ToX3D(DirectX::FXMVECTOR v) {
+    DirectX::XMFLOAT3 f;
+    DirectX::XMStoreFloat3(&f, v);
+    return { f.x, f.y, f.z };
+}
+
+/** @brief 不定位的声音：单声道平分到左右，立体声左对左、右对右 */
+void FillDirectMatrix(uint32_t srcChannels, uint32_t dstChannels, float* matrix) {
+    std::memset(matrix, 0, sizeof(float) * srcChannels * dstChannels);
+    if (dstChannels == 1) {
+        for (uint32_t s = 0; s < srcChannels; ++s) matrix[s] = 1.0f / srcChannels;
+        return;
+    }
+    if (srcChannels == 1) {
+        matrix[0] = 0.7071f;        // [D * src + S]
+        matrix[1] = 0.7071f;
+    } else {
+        matrix[0 * srcChannels + 0] = 1.0f;
+        matrix[1 * srcChannels + 1] = 1.0f;
+    }
+}
+
+/** @brief maxDistance 之前的最后 10% 淡出到静音 */
+float MaxDistanceFade(float distance, float maxDistance) {
+    const float fadeStart = maxDistance * 0.9f;
+    if (distance <= fadeStart) return 1.0f;
+    return (std::max)(1.0f - (distance - fadeStart) / (maxDistance - fadeStart), 0.0f);
+}
+
+/** @brief 与 X3DAudio 默认距离曲线一致的估计增益（minDistance 内不衰减，之外按距离反比） */
+float DistanceGain(float distance, float minDistance, float maxDistance) {
+    const float scaler = (std::max)(minDistance, 0.01f);
+    const float gain = distance <= scaler ? 1.0f : scaler / distance;
+    return gain * MaxDistanceFade(distance, maxDistance);
+}
+
+float Distance(const DirectX::XMFLOAT3& a, const X3DAUDIO_VECTOR& b) {
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    const float dz = a.z - b.z;
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+} // namespace
+
 AudioSystem::AudioSystem() {
 }
 
@@ -22,10 +84,45 @@ bool AudioSystem::InitializeAudio() {
         return false;
     }
     
+    m_ImpactSubscription = PhysicsEventQueue::GetInstance().Subscribe(
+        PhysicsEventMask(PhysicsEvent::Type::Impact),
+        [this](entt::registry& registry, const PhysicsEvent& event) { OnImpact(registry, event); });
 
     return true;
 }
 
+void AudioSystem::OnImpact(entt::registry& registry, const PhysicsEvent& event) {
+    if (m_ImpactClip == kInvalidSoundClip) {
+        m_ImpactClip = FindClip(kImpactClipName);
+        if (m_ImpactClip == kInvalidSoundClip) return;
+    }
+
+    // 接触点在运动物体所在扇区的局部坐标（扇区地面没有 InSectorComponent）
+    const entt::entity body = (event.entity != entt::null && registry.valid(event.entity) &&
+                               registry.all_of<components::InSectorComponent>(event.entity))
+        ? event.entity : event.other;
+    if (body == entt::null || !registry.valid(body)) return;
+    const auto* inSector = registry.try_get<components::InSectorComponent>(body);
+    const auto* sector = inSector && inSector->sector != entt::null
+        ? registry.try_get<components::SectorComponent>(inSector->sector) : nullptr;
+
+    DirectX::XMFLOAT3 position;
+    if (sector) {
+        using namespace DirectX;
+        const XMVECTOR local = XMLoadFloat3(&event.position);
+        const XMVECTOR world = XMVectorAdd(XMVector3Rotate(local, XMLoadFloat4(&sector->worldRotation)),
+                                           XMLoadFloat3(&sector->worldPosition));
+        XMStoreFloat3(&position, world);
+    } else if (const auto* transform = registry.try_get<TransformComponent>(body)) {
+        position = transform->position;
+    } else {
+        return;
+    }
+
+    const float volume = (std::min)((std::max)(event.impulse / kImpactFullVolumeImpulse, 0.2f), 1.0f);
+    PlayOneShot(m_ImpactClip, position, volume);
+}
+
 bool AudioSystem::InitializeXAudio2() {
     // Initialize COM
     HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
@@ -48,31 +145,455 @@ bool AudioSystem::InitializeXAudio2() {
         return false;
     }
     
+    // 3D 音效：X3DAudio 按母带的扬声器布局计算输出矩阵
+    DWORD channelMask = 0;
+    XAUDIO2_VOICE_DETAILS details = {};
+    m_MasteringVoice->GetChannelMask(&channelMask);
+    m_MasteringVoice->GetVoiceDetails(&details);
+    m_OutputChannels = details.InputChannels;
+    
+    // 子混音总线（失败的总线直接送到母带）
+    for (size_t i = 0; i < static_cast<size_t>(AudioBus::Count); ++i) {
+        if (FAILED(m_XAudio2->CreateSubmixVoice(&m_Buses[i], details.InputChannels, details.InputSampleRate))) {
+            std::cerr << "Failed to create submix voice " << i << std::endl;
+            m_Buses[i] = nullptr;
+        }
+    }
+    
+    if (m_OutputChannels == 0 || m_OutputChannels > kMaxOutputChannels ||
+        FAILED(X3DAudioInitialize(channelMask, X3DAUDIO_SPEED_OF_SOUND, m_X3DAudio))) {
+        std::cerr << "Failed to initialize X3DAudio, positional audio disabled" << std::endl;
+    } else {
+        IXAudio2Voice* sfx = GetBusVoice(AudioBus::SFX);
+        m_SpatialReady = m_VoicePool.Initialize(m_XAudio2.Get(), sfx ? sfx : m_MasteringVoice);
+    }
+    
+    if (!m_Stream.Initialize(m_XAudio2.Get(), GetBusVoice(AudioBus::Music))) {
+        std::cerr << "Failed to start music stream" << std::endl;
+        return false;
+    }
+    
     return true;
 }
 
+void AudioSystem::DeclareAccess(SystemAccess& access) const {
+    // 音源位置 / 扇区休眠状态只读；AudioComponent 的播放状态和声部句柄由这里回写
+    // 听者取 CameraService 的上一帧渲染相机（调度期间只读）
+    access.Read<TransformComponent, components::InSectorComponent>()
+          .Write<AudioComponent>();
+}
+
+void AudioSystem::SetBusVolume(AudioBus bus, float volume) {
+    const size_t index = static_cast<size_t>(bus);
+    if (index >= static_cast<size_t>(AudioBus::Count)) return;
+    m_BusVolumes[index] = (std::max)(0.0f, (std::min)(1.0f, volume));
+    if (m_Buses[index]) {
+        m_Buses[index]->SetVolume(m_BusVolumes[index]);
+    }
+}
+
 void AudioSystem::Update(float deltaTime, entt::registry& registry) {
-    if (!m_IsPlaying || !m_SourceVoice) {
-        return;
+    if (m_IsPlaying) {
+        // 解码和切歌都在 MusicStream 的解码线程上完成，这里只同步状态
+        const int streamIndex = m_Stream.GetCurrentIndex();
+        if (!m_Playlist.empty() && streamIndex >= 0 && streamIndex != m_CurrentTrackIndex) {
+            m_CurrentTrackIndex = streamIndex;
+            std::cout << "Playing: " << m_Playlist[m_CurrentTrackIndex] << std::endl;
+        }
+        
+        if (m_Stream.IsFinished()) {
+            m_IsPlaying = false;
+        }
     }
     
-    // Check if the current track has finished
-    XAUDIO2_VOICE_STATE state;
-    m_SourceVoice->GetState(&state);
-    
-    if (state.BuffersQueued == 0) {
-        // Current track finished, play next
-        if (m_LoopPlaylist && !m_Playlist.empty()) {
-            PlayNext();
-        } else {
-            m_IsPlaying = false;
+    UpdateSpatialVoices(registry, deltaTime);
+}
+
+SoundClipId AudioSystem::ReserveClip(const std::string& path, bool& isNew) {
+    for (size_t i = 0; i < m_Clips.size(); ++i) {
+        if (m_Clips[i].path == path) {
+            isNew = false;
+            return static_cast<SoundClipId>(i + 1);
+        }
+    }
+    SoundClip clip;
+    clip.path = path;
+    clip.pending = true;
+    m_Clips.push_back(std::move(clip));
+    isNew = true;
+    return static_cast<SoundClipId>(m_Clips.size());
+}
+
+void AudioSystem::InstallBank(const std::shared_ptr<SoundBank>& bank, const std::vector<SoundClipId>& ids) {
+    m_Banks.push_back(bank);
+    for (uint32_t i = 0; i < bank->GetCount() && i < ids.size(); ++i) {
+        SoundClip& clip = m_Clips[ids[i] - 1];
+        clip.pending = false;
+        if (!bank->IsValid(i)) continue;
+        clip.format = bank->GetFormat(i);
+        clip.data = bank->GetData(i);
+        clip.bytes = bank->GetBytes(i);
+        // ADPCMWAVEFORMAT：WAVEFORMATEX 之后紧跟 wSamplesPerBlock
+        clip.samplesPerBlock = 1;
+        if (clip.format->wFormatTag == kWaveFormatADPCM && clip.format->cbSize >= sizeof(WORD)) {
+            WORD samplesPerBlock = 0;
+            std::memcpy(&samplesPerBlock, reinterpret_cast<const BYTE*>(clip.format) + sizeof(WAVEFORMATEX),
+                        sizeof(WORD));
+            clip.samplesPerBlock = (std::max)<uint32_t>(samplesPerBlock, 1);
+        }
+        clip.sampleCount = clip.bytes / clip.format->nBlockAlign * clip.samplesPerBlock;
+        clip.duration = static_cast<float>(clip.sampleCount) / clip.format->nSamplesPerSec;
+        // 第一次遇到的格式先建好声部池，触发时不再创建声部
+        if (m_SpatialReady) {
+            m_VoicePool.Reserve(*clip.format);
+        }
+    }
+}
+
+SoundClipId AudioSystem::LoadClip(const std::string& filePath) {
+    bool isNew = false;
+    const SoundClipId id = ReserveClip(filePath, isNew);
+    if (isNew) {
+        auto bank = std::make_shared<SoundBank>();
+        bank->Build({ filePath });
+        InstallBank(bank, { id });
+    }
+    const SoundClip& clip = m_Clips[id - 1];
+    return (clip.IsReady() || clip.pending) ? id : kInvalidSoundClip;
+}
+
+std::vector<SoundClipId> AudioSystem::LoadSoundBank(const std::vector<std::string>& paths) {
+    std::vector<SoundClipId> ids;
+    std::vector<std::string> newPaths;
+    std::vector<SoundClipId> newIds;
+    for (const auto& path : paths) {
+        bool isNew = false;
+        ids.push_back(ReserveClip(path, isNew));
+        if (isNew) {
+            newPaths.push_back(path);
+            newIds.push_back(ids.back());
+        }
+    }
+    if (newPaths.empty()) {
+        return ids;
+    }
+
+    // 文件 IO 和 MP3 解码在加载线程上；AudioSystem 在 AssetStreamer::Shutdown 之后才销毁
+    AssetStreamer::GetInstance().Submit([this, newPaths, newIds]() -> AssetStreamer::ApplyFn {
+        auto bank = std::make_shared<SoundBank>();
+        const uint32_t loaded = bank->Build(newPaths);
+        if (s_AudioDebug) {
+            std::cout << "Sound bank: " << loaded << "/" << newPaths.size() << " clips, "
+                      << bank->GetStorageBytes() / 1024 << " KB" << std::endl;
+        }
+        return [this, bank, newIds](entt::registry&) { InstallBank(bank, newIds); };
+    });
+    return ids;
+}
+
+uint32_t AudioSystem::LoadSoundBankFromDirectory(const std::string& directoryPath) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directoryPath, ec)) {
+        if (!entry.is_regular_file()) continue;
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (ext == ".wav" || ext == ".mp3") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    if (ec || paths.empty()) {
+        return 0;
+    }
+    std::sort(paths.begin(), paths.end());
+    LoadSoundBank(paths);
+    return static_cast<uint32_t>(paths.size());
+}
+
+SoundClipId AudioSystem::FindClip(const std::string& name) const {
+    for (size_t i = 0; i < m_Clips.size(); ++i) {
+        const std::string& path = m_Clips[i].path;
+        if (path == name || std::filesystem::path(path).stem().string() == name) {
+            return static_cast<SoundClipId>(i + 1);
+        }
+    }
+    return kInvalidSoundClip;
+}
+
+size_t AudioSystem::GetSoundBankBytes() const {
+    size_t bytes = 0;
+    for (const auto& bank : m_Banks) bytes += bank->GetStorageBytes();
+    return bytes;
+}
+
+void AudioSystem::PlayOneShot(SoundClipId clip, const DirectX::XMFLOAT3& position, float volume, uint8_t priority) {
+    if (clip == kInvalidSoundClip) return;
+    OneShot shot;
+    shot.clip = clip;
+    shot.position = position;
+    shot.volume = volume;
+    shot.priority = priority;
+    std::lock_guard<std::mutex> lock(m_OneShotMutex);
+    m_PendingOneShots.push_back(shot);
+}
+
+VoicePool::Handle AudioSystem::StartClip(const SoundClip& clip, AudioBus bus, uint8_t priority, bool looping,
+                                         bool allowEqualPriority, float startSeconds) {
+    uint64_t startSample = static_cast<uint64_t>((std::max)(startSeconds, 0.0f) * clip.format->nSamplesPerSec);
+    if (looping) {
+        startSample %= clip.sampleCount;
+    } else if (startSample >= clip.sampleCount) {
+        return VoicePool::kInvalidHandle;     // 虚拟化期间已经播完
+    }
+    startSample -= startSample % clip.samplesPerBlock;
+
+    const VoicePool::Handle handle = m_VoicePool.Acquire(*clip.format, GetBusVoice(bus), priority,
+                                                         allowEqualPriority, m_AudioFrame);
+    IXAudio2SourceVoice* voice = m_VoicePool.GetVoice(handle);
+    if (!voice) {
+        return VoicePool::kInvalidHandle;
+    }
+
+    // 直接引用 SoundBank 的存储，不复制
+    XAUDIO2_BUFFER buffer = {};
+    buffer.AudioBytes = clip.bytes;
+    buffer.pAudioData = clip.data;
+    buffer.Flags = XAUDIO2_END_OF_STREAM;
+    buffer.LoopCount = looping ? XAUDIO2_LOOP_INFINITE : 0;
+    bool submitted = true;
+    if (startSample == 0) {
+        submitted = SUCCEEDED(voice->SubmitSourceBuffer(&buffer));
+    } else {
+        XAUDIO2_BUFFER remainder = buffer;
+        remainder.PlayBegin = static_cast<UINT32>(startSample);
+        remainder.LoopCount = 0;
+        remainder.Flags = looping ? 0 : XAUDIO2_END_OF_STREAM;
+        submitted = SUCCEEDED(voice->SubmitSourceBuffer(&remainder)) &&
+                    (!looping || SUCCEEDED(voice->SubmitSourceBuffer(&buffer)));
+    }
+    if (!submitted) {
+        m_VoicePool.Release(handle);
+        return VoicePool::kInvalidHandle;
+    }
+    voice->Start(0, m_OperationSet);
+    return handle;
+}
+
+void AudioSystem::UpdateSpatialVoices(entt::registry& registry, float deltaTime) {
+    if (!m_SpatialReady) {
+        return;
+    }
+    const uint32_t frame = ++m_AudioFrame;
+    m_OperationSet++;
+
+    // === 听者：玩家刚看到的相机（CameraService 的 forward / up 已正交） ===
+    X3DAUDIO_LISTENER listener = {};
+    const CameraFrame& camera = CameraService::GetInstance().GetFrame();
+    const bool hasListener = camera.valid;
+    if (hasListener) {
+        listener.OrientFront = ToX3D(DirectX::XMLoadFloat3(&camera.forward));
+        listener.OrientTop = ToX3D(DirectX::XMLoadFloat3(&camera.up));
+        listener.Position = ToX3D(DirectX::XMLoadFloat3(&camera.position));
+    }
+
+    /** 估计的最终音量：虚拟化 / 抢占的依据 */
+    auto audibilityOf = [&](const DirectX::XMFLOAT3& position, float volume, AudioBus bus, bool spatial,
+                            float minDistance, float maxDistance) {
+        float audibility = volume * m_BusVolumes[static_cast<size_t>(bus)];
+        if (spatial && hasListener) {
+            audibility *= DistanceGain(Distance(position, listener.Position), minDistance, maxDistance);
+        }
+        return audibility;
+    };
+
+    FrameVector<Emitter> emitters;
+    uint32_t virtualCount = 0;
+
+    // === 实体音源：开始 / 重新触发 / 虚拟化 / 结束 ===
+    auto view = registry.view<AudioComponent, TransformComponent>();
+    for (auto entity : view) {
+        auto& audio = view.get<AudioComponent>(entity);
+        const SoundClip* clip = GetClip(audio.clip);
+        if (audio.isPlaying && clip && clip->pending) {
+            continue;   // SoundBank 还在加载：保持请求，载入后开始
+        }
+        if (!audio.isPlaying || !clip || !clip->IsReady()) {
+            if (audio.voice) {
+                m_VoicePool.Release(audio.voice);
+                audio.voice = VoicePool::kInvalidHandle;
+            }
+            audio.isPlaying = false;
+            audio.isVirtual = false;
+            audio.playedTrigger = audio.triggerCount;
+            continue;
+        }
+
+        const bool retrigger = audio.triggerCount != audio.playedTrigger;
+        audio.playedTrigger = audio.triggerCount;
+        if (retrigger) {
+            if (audio.voice) m_VoicePool.Release(audio.voice);
+            audio.voice = VoicePool::kInvalidHandle;
+            audio.isVirtual = false;
+        }
+        const float pitch = (std::max)(XAUDIO2_MIN_FREQ_RATIO, (std::min)(VoicePool::kMaxFrequencyRatio, audio.pitch));
+        const bool started = audio.voice || audio.isVirtual;
+        audio.playhead = started ? audio.playhead + deltaTime * pitch : 0.0f;
+
+        if (audio.voice && !m_VoicePool.IsValid(audio.voice)) {
+            // 被更高优先级的声音抢走：非循环声音就此结束，循环声音转为虚拟，之后重试
+            audio.voice = VoicePool::kInvalidHandle;
+            if (!audio.isLooping) {
+                audio.isPlaying = false;
+                continue;
+            }
+            audio.isVirtual = true;
+        }
+        if (audio.voice && m_VoicePool.IsFinished(audio.voice, frame)) {
+            m_VoicePool.Release(audio.voice);
+            audio.voice = VoicePool::kInvalidHandle;
+            audio.isPlaying = false;
+            continue;
+        }
+        if (!audio.voice && !audio.isLooping && audio.playhead >= clip->duration) {
+            audio.isPlaying = false;    // 虚拟化期间播完
+            audio.isVirtual = false;
+            continue;
+        }
+
+        // 听不见（太远 / 太小声 / 所在扇区休眠）：交还声部，只推进播放位置
+        const DirectX::XMFLOAT3& position = view.get<TransformComponent>(entity).position;
+        float audibility = audibilityOf(position, audio.volume, audio.bus, audio.spatial,
+                                        audio.minDistance, audio.maxDistance);
+        const auto* inSector = registry.try_get<components::InSectorComponent>(entity);
+        if (inSector && inSector->hibernating) {
+            audibility = 0.0f;
+        }
+        if (audibility < (audio.voice ? kVirtualizeBelow : kRealizeAbove)) {
+            if (audio.voice) {
+                m_VoicePool.Release(audio.voice);
+                audio.voice = VoicePool::kInvalidHandle;
+            }
+            audio.isVirtual = true;
+            virtualCount++;
+            continue;
+        }
+
+        if (!audio.voice) {
+            audio.voice = StartClip(*clip, audio.bus, audio.priority, audio.isLooping, !started, audio.playhead);
+            if (!audio.voice) {
+                if (!started && !audio.isLooping) {
+                    audio.isPlaying = false;    // 没抢到声部的新一次性声音直接丢弃
+                    continue;
+                }
+                audio.isVirtual = true;         // 下一帧重试
+                virtualCount++;
+                continue;
+            }
+            audio.isVirtual = false;
         }
+
+        m_VoicePool.Touch(audio.voice, frame);
+        m_VoicePool.SetAudibility(audio.voice, audibility);
+        emitters.push_back({ audio.voice, position, audio.volume, pitch, audio.minDistance, audio.maxDistance,
+                             audio.spatial });
+    }
+    m_VirtualCount = virtualCount;
+
+    // === 不属于实体的一次性音效（开始时就听不见的直接丢弃） ===
+    {
+        std::lock_guard<std::mutex> lock(m_OneShotMutex);
+        size_t waiting = 0;
+        for (auto& shot : m_PendingOneShots) {
+            const SoundClip* clip = GetClip(shot.clip);
+            if (clip && clip->pending) {
+                m_PendingOneShots[waiting++] = shot;    // SoundBank 载入后再播
+            } else if (clip && clip->IsReady() &&
+                       audibilityOf(shot.position, shot.volume, AudioBus::SFX, true, 1.0f, 500.0f) >= kRealizeAbove) {
+                shot.voice = StartClip(*clip, AudioBus::SFX, shot.priority, false, true, 0.0f);
+                if (shot.voice) m_OneShots.push_back(shot);
+            }
+        }
+        m_PendingOneShots.resize(waiting);
+    }
+    for (size_t i = 0; i < m_OneShots.size();) {
+        const OneShot& shot = m_OneShots[i];
+        if (m_VoicePool.IsFinished(shot.voice, frame)) {
+            m_VoicePool.Release(shot.voice);
+            m_OneShots[i] = m_OneShots.back();
+            m_OneShots.pop_back();
+            continue;
+        }
+        m_VoicePool.Touch(shot.voice, frame);
+        m_VoicePool.SetAudibility(shot.voice,
+                                  audibilityOf(shot.position, shot.volume, AudioBus::SFX, true, 1.0f, 500.0f));
+        emitters.push_back({ shot.voice, shot.position, shot.volume, 1.0f, 1.0f, 500.0f, true });
+        i++;
     }
+
+    // 实体被销毁或 AudioComponent 被移除后遗留的声部
+    m_VoicePool.ReleaseStale(frame);
+
+    // === 批量计算输出矩阵，放进同一个操作集提交 ===
+    const uint32_t dstChannels = m_OutputChannels;
+    FrameVector<float> matrices(emitters.size() * 2 * dstChannels);
+    X3DAUDIO_EMITTER emitter = {};
+    emitter.OrientFront = { 0.0f, 0.0f, 1.0f };
+    emitter.OrientTop = { 0.0f, 1.0f, 0.0f };
+    emitter.ChannelRadius = 1.0f;
+    emitter.DopplerScaler = 1.0f;
+    X3DAUDIO_DSP_SETTINGS dsp = {};
+    dsp.DstChannelCount = dstChannels;
+
+    for (size_t i = 0; i < emitters.size(); ++i) {
+        Emitter& source = emitters[i];
+        const uint32_t srcChannels = m_VoicePool.GetChannels(source.voice);
+        float* matrix = &matrices[i * 2 * dstChannels];
+        if (!source.spatial || !hasListener) {
+            FillDirectMatrix(srcChannels, dstChannels, matrix);
+            continue;
+        }
+
+        emitter.Position = { source.position.x, source.position.y, source.position.z };
+        emitter.ChannelCount = srcChannels;
+        emitter.pChannelAzimuths = srcChannels > 1 ? const_cast<float*>(kStereoAzimuths) : nullptr;
+        emitter.CurveDistanceScaler = (std::max)(source.minDistance, 0.01f);
+        dsp.SrcChannelCount = srcChannels;
+        dsp.pMatrixCoefficients = matrix;
+        X3DAudioCalculate(m_X3DAudio, &listener, &emitter, X3DAUDIO_CALCULATE_MATRIX, &dsp);
+        source.volume *= MaxDistanceFade(dsp.EmitterToListenerDistance, source.maxDistance);
+    }
+
+    for (size_t i = 0; i < emitters.size(); ++i) {
+        const Emitter& source = emitters[i];
+        IXAudio2SourceVoice* voice = m_VoicePool.GetVoice(source.voice);
+        const uint32_t srcChannels = m_VoicePool.GetChannels(source.voice);
+        voice->SetOutputMatrix(m_VoicePool.GetOutput(source.voice), srcChannels, dstChannels,
+                               &matrices[i * 2 * dstChannels], m_OperationSet);
+        voice->SetVolume(source.volume, m_OperationSet);
+        voice->SetFrequencyRatio(source.pitch, m_OperationSet);
+    }
+    m_XAudio2->CommitChanges(m_OperationSet);
 }
 
 void AudioSystem::Shutdown() {
+    PhysicsEventQueue::GetInstance().Unsubscribe(m_ImpactSubscription);
+    m_ImpactSubscription = PhysicsEventQueue::kInvalidSubscription;
     Stop();
-    CleanupSourceVoice();
+    m_Stream.Shutdown();
+    m_VoicePool.Shutdown();
+    m_SpatialReady = false;
+    for (auto& bus : m_Buses) {
+        if (bus) {
+            bus->DestroyVoice();
+            bus = nullptr;
+        }
+    }
+    m_OneShots.clear();
+    // 声部已全部销毁，之后才能释放它们引用的存储
+    m_Clips.clear();
+    m_Banks.clear();
+    m_ImpactClip = kInvalidSoundClip;
     
     if (m_MasteringVoice) {
         m_MasteringVoice->DestroyVoice();
@@ -82,54 +603,16 @@ void AudioSystem::Shutdown() {
     m_XAudio2.Reset();
 }
 
-bool AudioSystem::LoadMP3File(const std::string& filePath, AudioSource& outSource) {
-    mp3dec_t mp3d;
-    mp3dec_file_info_t info;
-    
-    // Decode MP3 file
-    if (mp3dec_load(&mp3d, filePath.c_str(), &info, nullptr, nullptr) != 0) {
-        std::cerr << "Failed to decode MP3 file: " << filePath << std::endl;
-        return false;
-    }
-    
-    // Convert to bytes
-    size_t dataSize = info.samples * sizeof(mp3d_sample_t);
-    outSource.audioData.resize(dataSize);
-    memcpy(outSource.audioData.data(), info.buffer, dataSize);
-    
-    // Set up wave format
-    outSource.waveFormat = {};
-    outSource.waveFormat.wFormatTag = WAVE_FORMAT_PCM;
-    outSource.waveFormat.nChannels = info.channels;
-    outSource.waveFormat.nSamplesPerSec = info.hz;
-    outSource.waveFormat.wBitsPerSample = sizeof(mp3d_sample_t) * 8;
-    outSource.waveFormat.nBlockAlign = (outSource.waveFormat.nChannels * outSource.waveFormat.wBitsPerSample) / 8;
-    outSource.waveFormat.nAvgBytesPerSec = outSource.waveFormat.nSamplesPerSec * outSource.waveFormat.nBlockAlign;
-    outSource.waveFormat.cbSize = 0;
-    
-    outSource.filePath = filePath;
-    
-    // Free minimp3 buffer
-    free(info.buffer);
-    
-    return true;
-}
-
 bool AudioSystem::LoadMP3(const std::string& filePath) {
     // Stop current playback
     Stop();
     
-    // Load the MP3 file
-    if (!LoadMP3File(filePath, m_CurrentSource)) {
-        return false;
-    }
-    
-    // Create source voice
-    if (!CreateSourceVoice(m_CurrentSource)) {
+    if (!std::filesystem::is_regular_file(filePath)) {
+        std::cerr << "MP3 file not found: " << filePath << std::endl;
         return false;
     }
     
-    // Clear playlist and add this single file
+    // Single-file playlist
     m_Playlist.clear();
     m_Playlist.push_back(filePath);
     m_CurrentTrackIndex = 0;
@@ -141,22 +624,20 @@ bool AudioSystem::PlaySingleTrack(const std::string& filePath) {
     // Stop current playback
     Stop();
 
-    // Load the MP3 file
-    if (!LoadMP3File(filePath, m_CurrentSource)) {
-        return false;
-    }
-
-    // Create source voice
-    if (!CreateSourceVoice(m_CurrentSource)) {
+    if (!std::filesystem::is_regular_file(filePath)) {
+        std::cerr << "MP3 file not found: " << filePath << std::endl;
         return false;
     }
 
     // Don't set up playlist, just play this one track
     m_Playlist.clear();
     m_CurrentTrackIndex = -1;
+    m_SingleTrack = filePath;
 
     // Start playback immediately
-    Play();
+    m_Stream.Start({ m_SingleTrack }, 0, false);
+    m_IsPlaying = true;
+    std::cout << "Playing: " << m_SingleTrack << std::endl;
 
     return true;
 }
@@ -165,7 +646,9 @@ bool AudioSystem::LoadPlaylistFromDirectory(const std::string& directoryPath) {
     namespace fs = std::filesystem;
     
     // Clear existing playlist
+    Stop();
     m_Playlist.clear();
+    m_SingleTrack.clear();
     
     try {
         // Scan directory for MP3 files
@@ -190,12 +673,8 @@ bool AudioSystem::LoadPlaylistFromDirectory(const std::string& directoryPath) {
         if(s_AudioDebug){
         std::cout << "Loaded " << m_Playlist.size() << " tracks from: " << directoryPath << std::endl;
         }
-        // Load and play the first track
+        // Start from the first track on Play()
         m_CurrentTrackIndex = 0;
-        if (!LoadMP3(m_Playlist[m_CurrentTrackIndex])) {
-            return false;
-        }
-        
         return true;
         
     } catch (const fs::filesystem_error& e) {
@@ -204,102 +683,70 @@ bool AudioSystem::LoadPlaylistFromDirectory(const std::string& directoryPath) {
     }
 }
 
-bool AudioSystem::CreateSourceVoice(const AudioSource& source) {
-    CleanupSourceVoice();
-    
-    HRESULT hr = m_XAudio2->CreateSourceVoice(&m_SourceVoice, &source.waveFormat);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create source voice" << std::endl;
-        return false;
-    }
-    
-    return true;
-}
-
-void AudioSystem::CleanupSourceVoice() {
-    if (m_SourceVoice) {
-        m_SourceVoice->Stop();
-        m_SourceVoice->FlushSourceBuffers();
-        m_SourceVoice->DestroyVoice();
-        m_SourceVoice = nullptr;
-    }
+void AudioSystem::StartPlaylist(int index) {
+    m_CurrentTrackIndex = index;
+    m_Stream.Start(m_Playlist, index, m_LoopPlaylist);
+    m_IsPlaying = true;
+    m_IsPaused = false;
+    std::cout << "Playing: " << m_Playlist[m_CurrentTrackIndex] << std::endl;
 }
 
 void AudioSystem::Play() {
-    if (!m_SourceVoice || m_CurrentSource.audioData.empty()) {
-        std::cerr << "No audio loaded" << std::endl;
-        return;
-    }
-    
     if (m_IsPlaying) {
         return; // Already playing
     }
     
-    // Submit audio buffer
-    XAUDIO2_BUFFER buffer = {};
-    buffer.AudioBytes = static_cast<UINT32>(m_CurrentSource.audioData.size());
-    buffer.pAudioData = m_CurrentSource.audioData.data();
-    buffer.Flags = XAUDIO2_END_OF_STREAM;
-    
-    HRESULT hr = m_SourceVoice->SubmitSourceBuffer(&buffer);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to submit source buffer" << std::endl;
+    if (m_IsPaused) {
+        m_Stream.Resume();
+        m_IsPaused = false;
+        m_IsPlaying = true;
         return;
     }
     
-    // Start playback
-    hr = m_SourceVoice->Start(0);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to start playback" << std::endl;
+    if (m_Playlist.empty() || m_CurrentTrackIndex < 0) {
+        std::cerr << "No audio loaded" << std::endl;
         return;
     }
     
-    m_IsPlaying = true;
-    std::cout << "Playing: " << m_CurrentSource.filePath << std::endl;
+    StartPlaylist(m_CurrentTrackIndex);
 }
 
 void AudioSystem::Pause() {
-    if (m_SourceVoice && m_IsPlaying) {
-        m_SourceVoice->Stop();
+    if (m_IsPlaying) {
+        m_Stream.Pause();
         m_IsPlaying = false;
+        m_IsPaused = true;
     }
 }
 
 void AudioSystem::Stop() {
-    if (m_SourceVoice) {
-        m_SourceVoice->Stop();
-        m_SourceVoice->FlushSourceBuffers();
-        m_IsPlaying = false;
-    }
+    m_Stream.Stop();
+    m_IsPlaying = false;
+    m_IsPaused = false;
 }
 
 void AudioSystem::SetVolume(float volume) {
     m_Volume = (std::max)(0.0f, (std::min)(1.0f, volume));
-    if (m_SourceVoice) {
-        m_SourceVoice->SetVolume(m_Volume);
-    }
+    m_Stream.SetVolume(m_Volume);
 }
 
 void AudioSystem::PlayNext() {
+    PROFILE_SCOPE("AudioSystem::PlayNext");
     if (m_Playlist.empty()) {
         return;
     }
     
-    m_CurrentTrackIndex++;
-    if (m_CurrentTrackIndex >= m_Playlist.size()) {
+    int next = m_CurrentTrackIndex + 1;
+    if (next >= static_cast<int>(m_Playlist.size())) {
         if (m_LoopPlaylist) {
-            m_CurrentTrackIndex = 0; // Loop back to first track
+            next = 0; // Loop back to first track
         } else {
-            m_IsPlaying = false;
+            Stop();
             return;
         }
     }
     
-    // Load and play the next track
-    Stop();
-    if (LoadMP3(m_Playlist[m_CurrentTrackIndex])) {
-        Play();
-    }
+    StartPlaylist(next);
 }
 
 void AudioSystem::PlayPrevious() {
@@ -307,16 +754,12 @@ void AudioSystem::PlayPrevious() {
         return;
     }
     
-    m_CurrentTrackIndex--;
-    if (m_CurrentTrackIndex < 0) {
-        m_CurrentTrackIndex = m_Playlist.size() - 1; // Wrap to last track
+    int previous = m_CurrentTrackIndex - 1;
+    if (previous < 0) {
+        previous = static_cast<int>(m_Playlist.size()) - 1; // Wrap to last track
     }
     
-    // Load and play the previous track
-    Stop();
-    if (LoadMP3(m_Playlist[m_CurrentTrackIndex])) {
-        Play();
-    }
+    StartPlaylist(previous);
 }
 
 } // namespace outer_wilds
@@ -1,27 +1,35 @@
 #pragma once
 #include "../core/ECS.h"
+#include "MusicStream.h"
+#include "SoundBank.h"
+#include "VoicePool.h"
+#include "components/AudioComponent.h"
 #include <xaudio2.h>
+#include <x3daudio.h>
+#include <DirectXMath.h>
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <wrl/client.h>
 
 namespace outer_wilds {
 
-// Audio component - marks entities that have audio
-struct AudioComponent {
-    bool isPlaying = false;
-    bool isLooping = false;
-    float volume = 1.0f;
-};
-
-// Audio source - holds decoded audio data
-struct AudioSource {
-    std::vector<BYTE> audioData;
-    WAVEFORMATEX waveFormat;
-    std::string filePath;
-};
+struct PhysicsEvent;
 
+/**
+ * 背景音乐：播放列表由 MusicStream 在解码线程上流式解码（不整首解码到内存），
+ * Update 只同步当前曲目和播放状态
+ *
+ * 3D 音效：AudioComponent（+ TransformComponent）的实体和 PlayOneShot 从 VoicePool 借用预先创建的声部，
+ * 每帧以激活相机为听者批量计算 X3DAudio 输出矩阵，放进同一个操作集一次提交。
+ * 音效数据常驻在 SoundBank 的连续存储里，触发一次音效只是一次 SubmitSourceBuffer。
+ *
+ * 混音：音乐 / 音效 / 驾驶舱 / 环境四条子混音总线再汇入母带。衰减后听不见、或所在扇区休眠的实体音源
+ * 被虚拟化（交还声部，只推进播放位置），重新听得见时从对应位置接着播放，XAudio2 实际混音的声部数因此有上限
+ *
+ * 撞击：订阅 PhysicsEventQueue 的 Impact 事件，在接触点播放名为 kImpactClipName 的音效（音量随冲量）
+ */
 class AudioSystem : public System {
 public:
     AudioSystem();
@@ -29,9 +37,10 @@ public:
 
     bool InitializeAudio();
     void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
     void Shutdown();
 
-    // Load and play MP3 file
+    // Load MP3 file as a one-track playlist (call Play() to start)
     bool LoadMP3(const std::string& filePath);
     
     // Play single MP3 file (without playlist)
@@ -49,7 +58,10 @@ public:
     // Playlist control
     void PlayNext();
     void PlayPrevious();
-    void SetLoopPlaylist(bool loop) { m_LoopPlaylist = loop; }
+    void SetLoopPlaylist(bool loop) {
+        m_LoopPlaylist = loop;
+        m_Stream.SetLoop(loop);
+    }
     
     bool IsPlaying() const { return m_IsPlaying; }
     const std::string& GetCurrentTrack() const { 
@@ -60,19 +72,115 @@ public:
         return empty;
     }
 
+    // Sound effects
+    /** @brief 同步载入一个短音效（同一路径只载入一次），失败返回 kInvalidSoundClip */
+    SoundClipId LoadClip(const std::string& filePath);
+    /**
+     * @brief 在 AssetStreamer 加载线程上把一组音效打包成一个 SoundBank（主线程调用）
+     * @return 每个路径的 id（立即可用于 AudioComponent；载入完成前的播放请求会等待）
+     */
+    std::vector<SoundClipId> LoadSoundBank(const std::vector<std::string>& paths);
+    /** @brief 目录下的全部 .wav / .mp3 作为一个 SoundBank 异步载入，返回文件数 */
+    uint32_t LoadSoundBankFromDirectory(const std::string& directoryPath);
+    /** @brief 按完整路径或文件名（不含扩展名）查找已登记的音效 */
+    SoundClipId FindClip(const std::string& name) const;
+    size_t GetSoundBankBytes() const;
+    /** @brief 在世界位置播放一次（不属于实体的撞击等；可在任意线程调用，下一次 Update 生效） */
+    void PlayOneShot(SoundClipId clip, const DirectX::XMFLOAT3& position, float volume = 1.0f,
+                     uint8_t priority = 128);
+    VoicePool::Stats GetVoiceStats() const { return m_VoicePool.GetStats(); }
+    /** @brief 上一帧正在播放但被虚拟化（听不见、不占声部）的实体音源数 */
+    uint32_t GetVirtualVoiceCount() const { return m_VirtualCount; }
+
+    // Submix buses
+    /** @brief 总线音量（0 ~ 1；音乐总线之上还有 SetVolume 的曲目音量） */
+    void SetBusVolume(AudioBus bus, float volume);
+    float GetBusVolume(AudioBus bus) const { return m_BusVolumes[static_cast<size_t>(bus)]; }
+
+    static constexpr const char* kImpactClipName = "impact";
+    static constexpr float kImpactFullVolumeImpulse = 2000.0f;  // N·s：达到此冲量时满音量
+
 private:
     bool InitializeXAudio2();
-    bool LoadMP3File(const std::string& filePath, AudioSource& outSource);
-    bool CreateSourceVoice(const AudioSource& source);
-    void CleanupSourceVoice();
+    /** @brief Impact 事件 → 在接触点（世界坐标）播放撞击音效 */
+    void OnImpact(entt::registry& registry, const PhysicsEvent& event);
+    /** @brief 从 index 开始流式播放播放列表 */
+    void StartPlaylist(int index);
+
+    /** @brief 音效条目：数据在某个 SoundBank 的连续存储里 */
+    struct SoundClip {
+        std::string path;
+        const WAVEFORMATEX* format = nullptr;
+        const BYTE* data = nullptr;
+        UINT32 bytes = 0;
+        uint32_t sampleCount = 0;       // 采样帧数
+        uint32_t samplesPerBlock = 1;   // ADPCM 只能从块边界开始播放
+        float duration = 0.0f;          // 秒
+        bool pending = false;        // SoundBank 仍在加载
+        bool IsReady() const { return data != nullptr; }
+    };
+
+    struct OneShot {
+        SoundClipId clip = kInvalidSoundClip;
+        DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+        float volume = 1.0f;
+        uint8_t priority = 128;
+        VoicePool::Handle voice = VoicePool::kInvalidHandle;
+    };
+
+    /** @brief 本帧需要定位的声部 */
+    struct Emitter {
+        VoicePool::Handle voice;
+        DirectX::XMFLOAT3 position;
+        float volume;
+        float pitch;
+        float minDistance;
+        float maxDistance;
+        bool spatial;
+    };
+
+    const SoundClip* GetClip(SoundClipId id) const {
+        return (id != kInvalidSoundClip && id <= m_Clips.size()) ? &m_Clips[id - 1] : nullptr;
+    }
+    /**
+     * @brief 借用声部并从 startSeconds 处开始提交音效（Start 放进本帧的操作集，和输出矩阵一起生效）
+     *
+     * 从中途开始的循环声音提交两个缓冲：剩余部分一次 + 整段无限循环（循环区必须在播放区之内）
+     */
+    VoicePool::Handle StartClip(const SoundClip& clip, AudioBus bus, uint8_t priority, bool looping,
+                                bool allowEqualPriority, float startSeconds);
+    /** @brief 返回 path 已有的 id，或登记一个等待载入的新条目 */
+    SoundClipId ReserveClip(const std::string& path, bool& isNew);
+    /** @brief 主线程：把载入完成的 SoundBank 接到预留的条目上 */
+    void InstallBank(const std::shared_ptr<SoundBank>& bank, const std::vector<SoundClipId>& ids);
+    void UpdateSpatialVoices(entt::registry& registry, float deltaTime);
+    IXAudio2Voice* GetBusVoice(AudioBus bus) const { return m_Buses[static_cast<size_t>(bus)]; }
     
     // XAudio2 objects
     Microsoft::WRL::ComPtr<IXAudio2> m_XAudio2;
     IXAudio2MasteringVoice* m_MasteringVoice = nullptr;
-    IXAudio2SourceVoice* m_SourceVoice = nullptr;
+    IXAudio2SubmixVoice* m_Buses[static_cast<size_t>(AudioBus::Count)] = {};
+    float m_BusVolumes[static_cast<size_t>(AudioBus::Count)] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    
+    // 3D sound effects
+    X3DAUDIO_HANDLE m_X3DAudio = {};
+    uint32_t m_OutputChannels = 0;
+    bool m_SpatialReady = false;
+    VoicePool m_VoicePool;
+    std::vector<SoundClip> m_Clips;                 // id = 下标 + 1
+    std::vector<std::shared_ptr<SoundBank>> m_Banks;
+    std::vector<OneShot> m_OneShots;                // 正在播放
+    std::vector<OneShot> m_PendingOneShots;         // PlayOneShot 排队（m_OneShotMutex）
+    std::mutex m_OneShotMutex;
+    uint32_t m_AudioFrame = 0;
+    UINT32 m_OperationSet = 0;
+    uint32_t m_VirtualCount = 0;
+    uint32_t m_ImpactSubscription = 0;
+    SoundClipId m_ImpactClip = kInvalidSoundClip;   // 按 kImpactClipName 延迟查找
     
-    // Current audio source
-    AudioSource m_CurrentSource;
+    // Streaming voice (decoder thread + buffer ring)
+    MusicStream m_Stream;
+    std::string m_SingleTrack;      // PlaySingleTrack 的曲目（不属于播放列表）
     
     // Playlist management
     std::vector<std::string> m_Playlist;
@@ -81,10 +189,8 @@ private:
     
     // Playback state
     bool m_IsPlaying = false;
+    bool m_IsPaused = false;
     float m_Volume = 1.0f;
-    
-    // Check if current track finished
-    bool m_CheckNextTrack = false;
 };
 
 } // namespace outer_wilds
@@ -0,0 +1,390 @@
+#include "MusicStream.h"
+#include "../core/MemoryTracker.h"
+#define MINIMP3_IMPLEMENTATION
+#include <minimp3/minimp3_ex.h>
+#include <cstring>
+#include <iostream>
+
+namespace outer_wilds {
+
+namespace {
+
+// 打开时不预扫描整个文件（较新的 minimp3 才有；旧版本扫描的只是帧头，代价也很小）
+#ifdef MP3D_DO_NOT_SCAN
+constexpr int kOpenFlags = MP3D_SEEK_TO_SAMPLE | MP3D_DO_NOT_SCAN;
+#else
+constexpr int kOpenFlags = MP3D_SEEK_TO_SAMPLE;
+#endif
+
+WAVEFORMATEX MakePCMFormat(int channels, int hz) {
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = static_cast<WORD>(channels);
+    format.nSamplesPerSec = static_cast<DWORD>(hz);
+    format.wBitsPerSample = sizeof(mp3d_sample_t) * 8;
+    format.nBlockAlign = static_cast<WORD>(format.nChannels * format.wBitsPerSample / 8);
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    format.cbSize = 0;
+    return format;
+}
+
+} // namespace
+
+struct MusicStream::Decoder {
+    mp3dec_ex_t dec;
+    int channels = 0;
+    int hz = 0;
+    bool open = false;
+
+    Decoder() { std::memset(&dec, 0, sizeof(dec)); }
+    ~Decoder() {
+        if (open) mp3dec_ex_close(&dec);
+    }
+
+    bool Open(const std::string& path) {
+        if (mp3dec_ex_open(&dec, path.c_str(), kOpenFlags) != 0) {
+            return false;
+        }
+        open = true;
+        channels = dec.info.channels;
+        hz = dec.info.hz;
+        return (channels == 1 || channels == 2) && hz > 0;
+    }
+
+    bool SameFormat(const WAVEFORMATEX& format) const {
+        return format.nChannels == channels && format.nSamplesPerSec == static_cast<DWORD>(hz);
+    }
+};
+
+MusicStream::~MusicStream() {
+    Shutdown();
+}
+
+bool MusicStream::Initialize(IXAudio2* xaudio, IXAudio2Voice* output) {
+    if (!xaudio || m_Running) {
+        return m_Running;
+    }
+    m_XAudio2 = xaudio;
+    m_Output = output;
+
+    {
+        // 常驻的 PCM 环形缓冲（按双声道分配，单声道只用一半）
+        OW_MEMORY_SCOPE(Audio);
+        for (auto& buffer : m_Buffers) {
+            buffer.assign(kBufferFrames * 2, 0);
+        }
+    }
+
+    m_Running = true;
+    m_Thread = std::thread(&MusicStream::DecodeThreadMain, this);
+    return true;
+}
+
+void MusicStream::Shutdown() {
+    if (!m_Thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Running = false;
+        m_Generation++;
+        if (m_Voice) {
+            m_Voice->Stop();
+            m_Voice->FlushSourceBuffers();
+        }
+    }
+    m_Wake.notify_all();
+    m_Thread.join();
+
+    if (m_Voice) {
+        m_Voice->DestroyVoice();
+        m_Voice = nullptr;
+    }
+    m_Current.reset();
+    m_Next.reset();
+    m_XAudio2 = nullptr;
+    m_Output = nullptr;
+}
+
+void MusicStream::Start(const std::vector<std::string>& tracks, int startIndex, bool loop) {
+    if (!m_Running || tracks.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Generation++;
+        m_Tracks = tracks;
+        m_StartIndex = (startIndex >= 0 && startIndex < static_cast<int>(tracks.size())) ? startIndex : 0;
+        m_Paused = false;
+        m_Draining = false;
+        if (m_Voice) {
+            // 旧缓冲在 OnBufferEnd 中归还后才会被重新填充
+            m_Voice->Stop();
+            m_Voice->FlushSourceBuffers();
+            m_Voice->Start(0);
+        }
+        // 与 m_StartIndex 一起在锁内发布：解码线程取走请求后若立即失败（置 m_Finished），不会被这里覆盖
+        m_Loop.store(loop, std::memory_order_relaxed);
+        m_CurrentIndex.store(-1, std::memory_order_release);
+        m_Finished.store(false, std::memory_order_release);
+    }
+    m_Wake.notify_all();
+}
+
+void MusicStream::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Generation++;
+        m_StartIndex = -1;
+        m_Tracks.clear();
+        m_Paused = false;
+        m_Draining = false;
+        if (m_Voice) {
+            m_Voice->Stop();
+            m_Voice->FlushSourceBuffers();
+        }
+        m_CurrentIndex.store(-1, std::memory_order_release);
+        m_Finished.store(true, std::memory_order_release);
+    }
+    m_Wake.notify_all();
+}
+
+void MusicStream::Pause() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Paused = true;
+    if (m_Voice) {
+        m_Voice->Stop();
+    }
+}
+
+void MusicStream::Resume() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Paused = false;
+    if (m_Voice) {
+        m_Voice->Start(0);
+    }
+}
+
+void MusicStream::SetVolume(float volume) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Volume = volume;
+    if (m_Voice) {
+        m_Voice->SetVolume(volume);
+    }
+}
+
+void STDMETHODCALLTYPE MusicStream::OnBufferStart(void* context) {
+    const auto buffer = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(context));
+    if (buffer < kBufferCount) {
+        m_CurrentIndex.store(m_BufferTrack[buffer].load(std::memory_order_relaxed), std::memory_order_release);
+    }
+}
+
+void STDMETHODCALLTYPE MusicStream::OnBufferEnd(void* context) {
+    const auto buffer = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(context));
+    if (buffer >= kBufferCount) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_BufferFree[buffer] = true;
+    }
+    m_Wake.notify_one();
+}
+
+bool MusicStream::AllBuffersFreeLocked() const {
+    for (bool free : m_BufferFree) {
+        if (!free) return false;
+    }
+    return true;
+}
+
+int MusicStream::FindFreeBufferLocked() const {
+    for (uint32_t i = 0; i < kBufferCount; ++i) {
+        if (m_BufferFree[i]) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+int MusicStream::NextIndex(int index, size_t count, bool loop) {
+    if (count == 0) return -1;
+    const int next = index + 1;
+    if (next < static_cast<int>(count)) return next;
+    return loop ? 0 : -1;
+}
+
+std::unique_ptr<MusicStream::Decoder> MusicStream::OpenTrack(int& index, const std::vector<std::string>& tracks,
+                                                             bool loop) {
+    // 最多把整个列表试一遍（全部打不开时不死循环）
+    for (size_t attempt = 0; attempt < tracks.size() && index >= 0; ++attempt) {
+        auto decoder = std::make_unique<Decoder>();
+        if (decoder->Open(tracks[index])) {
+            return decoder;
+        }
+        std::cerr << "Failed to open MP3 stream: " << tracks[index] << std::endl;
+        index = NextIndex(index, tracks.size(), loop);
+    }
+    index = -1;
+    return nullptr;
+}
+
+void MusicStream::PrefetchNext(const std::vector<std::string>& tracks) {
+    m_Next.reset();
+    m_NextIndex = NextIndex(m_DecodeIndex, tracks.size(), m_Loop.load(std::memory_order_relaxed));
+    if (m_NextIndex >= 0) {
+        m_Next = OpenTrack(m_NextIndex, tracks, m_Loop.load(std::memory_order_relaxed));
+    }
+}
+
+bool MusicStream::EnsureVoice(const Decoder& decoder, uint64_t generation) {
+    IXAudio2SourceVoice* oldVoice = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        if (m_Voice && decoder.SameFormat(m_VoiceFormat)) {
+            return m_Generation == generation;
+        }
+        // 格式变化：上一首的尾部播完后再换语音
+        m_Wake.wait(lock, [&] { return !m_Running || m_Generation != generation || AllBuffersFreeLocked(); });
+        if (!m_Running || m_Generation != generation) {
+            return false;
+        }
+        oldVoice = m_Voice;
+        m_Voice = nullptr;
+    }
+    if (oldVoice) {
+        oldVoice->DestroyVoice();
+    }
+
+    const WAVEFORMATEX format = MakePCMFormat(decoder.channels, decoder.hz);
+    IXAudio2SourceVoice* voice = nullptr;
+    XAUDIO2_SEND_DESCRIPTOR send = { 0, m_Output };
+    XAUDIO2_VOICE_SENDS sends = { 1, &send };
+    if (FAILED(m_XAudio2->CreateSourceVoice(&voice, &format, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this,
+                                            m_Output ? &sends : nullptr))) {
+        std::cerr << "Failed to create streaming source voice" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Voice = voice;
+    m_VoiceFormat = format;
+    m_Voice->SetVolume(m_Volume);
+    if (!m_Paused) {
+        m_Voice->Start(0);
+    }
+    return m_Generation == generation;
+}
+
+size_t MusicStream::DecodeInto(uint32_t buffer) {
+    if (!m_Current) return 0;
+    const size_t capacity = static_cast<size_t>(kBufferFrames) * m_Current->channels;
+    size_t filled = 0;
+    while (filled < capacity) {
+        const size_t read = mp3dec_ex_read(&m_Current->dec, m_Buffers[buffer].data() + filled, capacity - filled);
+        if (read == 0) break;      // 曲目结束或解码错误（都按结束处理）
+        filled += read;
+    }
+    // 只提交完整的采样帧
+    return filled - filled % m_Current->channels;
+}
+
+void MusicStream::DecodeThreadMain() {
+    OW_MEMORY_SCOPE(Audio);
+    std::vector<std::string> tracks;
+    uint64_t generation = 0;
+
+    for (;;) {
+        int buffer = -1;
+        bool restart = false;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [&] {
+                return !m_Running || m_StartIndex >= 0 || m_Generation != generation ||
+                       (m_Current && FindFreeBufferLocked() >= 0) || (m_Draining && AllBuffersFreeLocked());
+            });
+            if (!m_Running) {
+                break;
+            }
+            if (m_StartIndex >= 0) {
+                tracks.swap(m_Tracks);
+                m_Tracks.clear();
+                m_DecodeIndex = m_StartIndex;
+                m_StartIndex = -1;
+                generation = m_Generation;
+                restart = true;
+            } else if (m_Generation != generation) {
+                // Stop：丢弃解码器，等下一次 Start
+                generation = m_Generation;
+                lock.unlock();
+                m_Current.reset();
+                m_Next.reset();
+                continue;
+            } else if (m_Draining && AllBuffersFreeLocked()) {
+                m_Draining = false;
+                m_Finished.store(true, std::memory_order_release);
+                continue;
+            } else {
+                buffer = FindFreeBufferLocked();
+            }
+        }
+
+        if (restart) {
+            m_Next.reset();
+            m_Current = OpenTrack(m_DecodeIndex, tracks, m_Loop.load(std::memory_order_relaxed));
+            if (!m_Current || !EnsureVoice(*m_Current, generation)) {
+                m_Current.reset();
+                m_Finished.store(true, std::memory_order_release);
+                continue;
+            }
+            PrefetchNext(tracks);
+            continue;
+        }
+        if (buffer < 0 || !m_Current) {
+            continue;
+        }
+
+        const size_t samples = DecodeInto(static_cast<uint32_t>(buffer));
+        if (samples == 0) {
+            // 当前曲目解码完：换到预取的下一首（循环开关可能在预取之后改变）
+            const bool loop = m_Loop.load(std::memory_order_relaxed);
+            if (m_Next && !loop && m_NextIndex <= m_DecodeIndex) {
+                m_Next.reset();
+            } else if (!m_Next && loop) {
+                PrefetchNext(tracks);
+            }
+            m_Current = std::move(m_Next);
+            m_DecodeIndex = m_NextIndex;
+            if (!m_Current) {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (m_Generation == generation) m_Draining = true;
+                continue;
+            }
+            if (!EnsureVoice(*m_Current, generation)) {
+                m_Current.reset();
+                continue;
+            }
+            PrefetchNext(tracks);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Generation != generation || !m_Voice) {
+            continue;
+        }
+        m_BufferTrack[buffer].store(m_DecodeIndex, std::memory_order_relaxed);
+        XAUDIO2_BUFFER submit = {};
+        submit.AudioBytes = static_cast<UINT32>(samples * sizeof(mp3d_sample_t));
+        submit.pAudioData = reinterpret_cast<const BYTE*>(m_Buffers[buffer].data());
+        submit.pContext = reinterpret_cast<void*>(static_cast<uintptr_t>(buffer));
+        if (FAILED(m_Voice->SubmitSourceBuffer(&submit))) {
+            std::cerr << "Failed to submit streaming buffer" << std::endl;
+            continue;
+        }
+        m_BufferFree[buffer] = false;
+    }
+
+    m_Current.reset();
+    m_Next.reset();
+}
+
+} // namespace outer_wilds
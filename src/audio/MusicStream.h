@@ -0,0 +1,118 @@
+#pragma once
+#include <xaudio2.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 流式播放 MP3 播放列表的 XAudio2 语音
+ *
+ * 解码线程用 mp3dec_ex 逐帧解码到 kBufferCount 块 PCM 环形缓冲，每块播完时 OnBufferEnd
+ * 唤醒解码线程重新填充，常驻内存与曲目长度无关（环形缓冲 + 一个预取块 + 两个解码器）。
+ *
+ * 曲目切换在解码线程上完成：当前曲目开始解码时就打开下一首（映射文件、扫描帧头、解码首帧），
+ * 当前曲目解码到结尾后接着往环形缓冲里填下一首（格式相同则无缝衔接；采样率 / 声道不同时等已提交的缓冲播完再重建语音）。
+ * 主线程只发命令和读状态，切歌时没有任何解码或文件 IO。
+ *
+ * 线程：Start / Stop / Pause / Resume / SetVolume 在主线程调用；OnBufferStart / OnBufferEnd 在 XAudio2 线程上只做登记。
+ * 语音只在解码线程和 Shutdown 中销毁，且都不持有 m_Mutex（DestroyVoice 会等待回调返回）。
+ */
+class MusicStream : public IXAudio2VoiceCallback {
+public:
+    static constexpr uint32_t kBufferCount = 3;
+    static constexpr uint32_t kBufferFrames = 16384;      // 每块的采样帧数（44.1kHz 约 0.37 秒）
+
+    MusicStream() = default;
+    ~MusicStream();
+
+    MusicStream(const MusicStream&) = delete;
+    MusicStream& operator=(const MusicStream&) = delete;
+
+    /** @param output 输出目标（音乐总线）；nullptr 时直接送到母带 */
+    bool Initialize(IXAudio2* xaudio, IXAudio2Voice* output = nullptr);
+    void Shutdown();
+
+    /**
+     * @brief 从 startIndex 开始播放 tracks（替换当前播放列表；loop 时播完最后一首回到第一首）
+     */
+    void Start(const std::vector<std::string>& tracks, int startIndex, bool loop);
+    void Stop();
+    void Pause();
+    void Resume();
+    void SetVolume(float volume);
+    void SetLoop(bool loop) { m_Loop.store(loop, std::memory_order_relaxed); }
+
+    /** @brief 正在播放（或已排队等待播放）的曲目下标；没有曲目时为 -1 */
+    int GetCurrentIndex() const { return m_CurrentIndex.load(std::memory_order_acquire); }
+    /** @brief 播放列表已全部播完（非循环）或所有曲目都无法打开 */
+    bool IsFinished() const { return m_Finished.load(std::memory_order_acquire); }
+    bool IsPaused() const { return m_Paused; }
+
+    // IXAudio2VoiceCallback
+    void STDMETHODCALLTYPE OnBufferEnd(void* context) override;
+    void STDMETHODCALLTYPE OnVoiceProcessingPassStart(UINT32) override {}
+    void STDMETHODCALLTYPE OnVoiceProcessingPassEnd() override {}
+    void STDMETHODCALLTYPE OnStreamEnd() override {}
+    void STDMETHODCALLTYPE OnBufferStart(void* context) override;
+    void STDMETHODCALLTYPE OnLoopEnd(void*) override {}
+    void STDMETHODCALLTYPE OnVoiceError(void*, HRESULT) override {}
+
+private:
+    struct Decoder;
+
+    void DecodeThreadMain();
+    /** @brief 打开 index 对应的曲目（失败时依次尝试后面的曲目，index 随之更新），没有可播放的返回 nullptr */
+    static std::unique_ptr<Decoder> OpenTrack(int& index, const std::vector<std::string>& tracks, bool loop);
+    /** @brief 下一首的下标；非循环且已是最后一首时返回 -1 */
+    static int NextIndex(int index, size_t count, bool loop);
+    /** @brief 打开 m_DecodeIndex 之后的曲目 */
+    void PrefetchNext(const std::vector<std::string>& tracks);
+    /** @brief 按解码器的格式（重新）创建语音；格式不同时先等已提交的缓冲播完。generation 变化时返回 false */
+    bool EnsureVoice(const Decoder& decoder, uint64_t generation);
+    /** @brief 解码到 m_Buffers[buffer]，当前曲目读完时返回 0（不跨曲目拼接，曲目下标按缓冲登记） */
+    size_t DecodeInto(uint32_t buffer);
+    bool AllBuffersFreeLocked() const;
+    int FindFreeBufferLocked() const;
+
+    IXAudio2* m_XAudio2 = nullptr;
+    IXAudio2Voice* m_Output = nullptr;
+    IXAudio2SourceVoice* m_Voice = nullptr;
+    WAVEFORMATEX m_VoiceFormat = {};
+
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    bool m_Running = false;
+
+    // 主线程命令（m_Mutex 保护）
+    std::vector<std::string> m_Tracks;
+    int m_StartIndex = -1;
+    uint64_t m_Generation = 0;          // Start / Stop 递增，解码线程据此丢弃旧请求
+    bool m_Paused = false;
+    float m_Volume = 1.0f;
+
+    // PCM 环形缓冲（m_BufferFree 由 m_Mutex 保护）
+    std::vector<int16_t> m_Buffers[kBufferCount];
+    bool m_BufferFree[kBufferCount] = { true, true, true };
+    std::atomic<int> m_BufferTrack[kBufferCount] = {};     // 每块缓冲所属的曲目（OnBufferStart 据此更新 m_CurrentIndex）
+    bool m_Draining = false;            // 播放列表已解码完，等待最后的缓冲播完
+
+    // 解码线程私有
+    std::unique_ptr<Decoder> m_Current;
+    std::unique_ptr<Decoder> m_Next;    // 预取的下一首
+    int m_DecodeIndex = -1;
+    int m_NextIndex = -1;
+
+    std::atomic<int> m_CurrentIndex{ -1 };
+    std::atomic<bool> m_Finished{ false };
+    std::atomic<bool> m_Loop{ true };
+};
+
+} // namespace outer_wilds
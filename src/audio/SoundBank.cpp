@@ -0,0 +1,142 @@
+#include "SoundBank.h"
+#include "../core/MemoryTracker.h"
+#include "../graphics/resources/MappedFile.h"
+#include <minimp3/minimp3_ex.h>     // 实现在 MusicStream.cpp
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+
+namespace outer_wilds {
+
+namespace {
+
+constexpr size_t kDataAlignment = 16;
+constexpr WORD kWaveFormatADPCM = 0x0002;
+constexpr WORD kWaveFormatIEEEFloat = 0x0003;
+constexpr WORD kWaveFormatExtensible = 0xFFFE;
+
+/** @brief 解析结果：数据要么在映射的文件里（wav），要么在解码缓冲里（mp3） */
+struct Source {
+    std::vector<uint8_t> format;
+    std::shared_ptr<const resources::MappedFile> file;
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;
+    std::vector<uint8_t> decoded;
+};
+
+uint32_t ReadU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool LoadWav(const std::string& path, Source& out) {
+    out.file = resources::MappedFile::Open(path);
+    if (!out.file || out.file->Size() < 12) return false;
+    const uint8_t* begin = out.file->Data();
+    const uint8_t* end = begin + out.file->Size();
+    if (std::memcmp(begin, "RIFF", 4) != 0 || std::memcmp(begin + 8, "WAVE", 4) != 0) return false;
+
+    // RIFF 块：4 字节 id + 4 字节大小，数据按 2 字节对齐
+    for (const uint8_t* chunk = begin + 12; chunk + 8 <= end;) {
+        const uint32_t size = ReadU32(chunk + 4);
+        const uint8_t* body = chunk + 8;
+        if (size > static_cast<size_t>(end - body)) break;
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && size >= 16) {
+            out.format.assign(body, body + size);
+            if (out.format.size() < sizeof(WAVEFORMATEX)) out.format.resize(sizeof(WAVEFORMATEX), 0);
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            out.data = body;
+            out.bytes = size;
+        }
+        chunk = body + size + (size & 1);
+    }
+    if (out.format.empty() || !out.data) return false;
+
+    auto* format = reinterpret_cast<WAVEFORMATEX*>(out.format.data());
+    if (format->wFormatTag == WAVE_FORMAT_PCM || format->wFormatTag == kWaveFormatIEEEFloat) {
+        format->cbSize = 0;
+        out.format.resize(sizeof(WAVEFORMATEX));
+    } else if (format->wFormatTag == kWaveFormatADPCM || format->wFormatTag == kWaveFormatExtensible) {
+        if (sizeof(WAVEFORMATEX) + format->cbSize > out.format.size()) return false;
+        out.format.resize(sizeof(WAVEFORMATEX) + format->cbSize);
+    } else {
+        std::cerr << "Unsupported wav format " << format->wFormatTag << ": " << path << std::endl;
+        return false;
+    }
+    if (format->nChannels == 0 || format->nBlockAlign == 0) return false;
+    // 只提交完整的块（ADPCM 要求数据长度是 nBlockAlign 的整数倍）
+    out.bytes -= out.bytes % format->nBlockAlign;
+    return out.bytes > 0;
+}
+
+bool LoadMp3(const std::string& path, Source& out) {
+    mp3dec_t mp3d;
+    mp3dec_file_info_t info = {};
+    if (mp3dec_load(&mp3d, path.c_str(), &info, nullptr, nullptr) != 0 || !info.buffer || info.samples == 0) {
+        free(info.buffer);
+        return false;
+    }
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = static_cast<WORD>(info.channels);
+    format.nSamplesPerSec = static_cast<DWORD>(info.hz);
+    format.wBitsPerSample = sizeof(mp3d_sample_t) * 8;
+    format.nBlockAlign = static_cast<WORD>(format.nChannels * format.wBitsPerSample / 8);
+    format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+    out.format.assign(reinterpret_cast<const uint8_t*>(&format), reinterpret_cast<const uint8_t*>(&format) + sizeof(format));
+
+    const auto* samples = reinterpret_cast<const uint8_t*>(info.buffer);
+    out.decoded.assign(samples, samples + info.samples * sizeof(mp3d_sample_t));
+    free(info.buffer);
+    out.data = out.decoded.data();
+    out.bytes = out.decoded.size();
+    return true;
+}
+
+std::string LowerExtension(const std::string& path) {
+    const size_t dot = path.find_last_of('.');
+    std::string ext = dot == std::string::npos ? std::string() : path.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+} // namespace
+
+uint32_t SoundBank::Build(const std::vector<std::string>& paths) {
+    OW_MEMORY_SCOPE(Audio);
+
+    std::vector<Source> sources(paths.size());
+    m_Entries.assign(paths.size(), Entry{});
+    size_t total = 0;
+    uint32_t loaded = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        m_Entries[i].path = paths[i];
+        const std::string ext = LowerExtension(paths[i]);
+        const bool ok = ext == ".wav" ? LoadWav(paths[i], sources[i])
+                      : ext == ".mp3" ? LoadMp3(paths[i], sources[i])
+                      : false;
+        if (!ok || sources[i].bytes > UINT32_MAX) {
+            std::cerr << "Failed to load sound: " << paths[i] << std::endl;
+            sources[i] = Source{};
+            continue;
+        }
+        m_Entries[i].format = std::move(sources[i].format);
+        m_Entries[i].offset = total;
+        m_Entries[i].bytes = static_cast<uint32_t>(sources[i].bytes);
+        total += (sources[i].bytes + kDataAlignment - 1) & ~(kDataAlignment - 1);
+        loaded++;
+    }
+
+    // 一次分配，逐个拷入（wav 直接从映射视图拷贝）
+    m_Storage.reset(total ? new BYTE[total] : nullptr);
+    m_StorageBytes = total;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (m_Entries[i].bytes) {
+            std::memcpy(m_Storage.get() + m_Entries[i].offset, sources[i].data, m_Entries[i].bytes);
+        }
+    }
+    return loaded;
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,58 @@
+#pragma once
+#include <xaudio2.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 一组短音效的常驻数据，打包在一块连续内存里
+ *
+ * Build 在调用线程上（通常是 AssetStreamer 的加载线程）读取 / 解码全部文件：
+ * - .mp3：解码一次为 16 位 PCM
+ * - .wav：PCM / IEEE float / MS-ADPCM 原样保存（ADPCM 由 XAudio2 播放时解码，内存约为 PCM 的 1/4）
+ *
+ * 打包后声部直接提交 GetData 指向的内存（零拷贝），触发一次音效只是一次 SubmitSourceBuffer；
+ * 存储在 SoundBank 销毁前不会移动或释放。
+ */
+class SoundBank {
+public:
+    SoundBank() = default;
+    SoundBank(const SoundBank&) = delete;
+    SoundBank& operator=(const SoundBank&) = delete;
+
+    /**
+     * @brief 载入 paths 中的全部文件（替换已有内容）
+     * @return 成功载入的文件数；失败的条目保留位置，IsValid 返回 false
+     */
+    uint32_t Build(const std::vector<std::string>& paths);
+
+    uint32_t GetCount() const { return static_cast<uint32_t>(m_Entries.size()); }
+    bool IsValid(uint32_t index) const { return index < m_Entries.size() && m_Entries[index].bytes > 0; }
+    const std::string& GetPath(uint32_t index) const { return m_Entries[index].path; }
+    /** @brief 完整的格式（ADPCM 时包含 ADPCMWAVEFORMAT 的系数表） */
+    const WAVEFORMATEX* GetFormat(uint32_t index) const {
+        return reinterpret_cast<const WAVEFORMATEX*>(m_Entries[index].format.data());
+    }
+    const BYTE* GetData(uint32_t index) const { return m_Storage.get() + m_Entries[index].offset; }
+    uint32_t GetBytes(uint32_t index) const { return m_Entries[index].bytes; }
+
+    /** @brief 连续存储的总字节数 */
+    size_t GetStorageBytes() const { return m_StorageBytes; }
+
+private:
+    struct Entry {
+        std::string path;
+        std::vector<uint8_t> format;     // WAVEFORMATEX + cbSize 字节的扩展
+        size_t offset = 0;
+        uint32_t bytes = 0;
+    };
+
+    std::vector<Entry> m_Entries;
+    std::unique_ptr<BYTE[]> m_Storage;
+    size_t m_StorageBytes = 0;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,181 @@
+#include "VoicePool.h"
+#include <iostream>
+
+namespace outer_wilds {
+
+bool VoicePool::Initialize(IXAudio2* xaudio, IXAudio2Voice* output) {
+    m_XAudio2 = xaudio;
+    m_Output = output;
+    return m_XAudio2 != nullptr && m_Output != nullptr;
+}
+
+void VoicePool::Shutdown() {
+    for (auto& slot : m_Slots) {
+        if (slot.voice) {
+            slot.voice->DestroyVoice();
+            slot.voice = nullptr;
+        }
+    }
+    m_Slots.clear();
+    m_XAudio2 = nullptr;
+    m_Output = nullptr;
+}
+
+uint64_t VoicePool::MakeFormatKey(const WAVEFORMATEX& format) {
+    // 格式标签 / 声道 / 块大小（PCM 即位深）/ 采样率都相同的声部可以互换
+    return (static_cast<uint64_t>(format.wFormatTag) << 48) |
+           (static_cast<uint64_t>(format.nChannels & 0xFF) << 40) |
+           (static_cast<uint64_t>(format.nBlockAlign) << 24) |
+           (format.nSamplesPerSec & 0xFFFFFF);
+}
+
+bool VoicePool::Reserve(const WAVEFORMATEX& format, uint32_t count) {
+    if (!m_XAudio2) return false;
+    const uint64_t key = MakeFormatKey(format);
+    uint32_t existing = 0;
+    for (const auto& slot : m_Slots) {
+        if (slot.formatKey == key) existing++;
+    }
+
+    XAUDIO2_SEND_DESCRIPTOR send = { 0, m_Output };
+    XAUDIO2_VOICE_SENDS sends = { 1, &send };
+    for (; existing < count; ++existing) {
+        if (m_Slots.size() >= 0xFFFF) return false;
+        Slot slot;
+        if (FAILED(m_XAudio2->CreateSourceVoice(&slot.voice, &format, 0, kMaxFrequencyRatio, nullptr, &sends))) {
+            std::cerr << "Failed to create pooled source voice" << std::endl;
+            return false;
+        }
+        slot.formatKey = key;
+        slot.channels = format.nChannels;
+        slot.output = m_Output;
+        m_Slots.push_back(slot);
+    }
+    return true;
+}
+
+VoicePool::Handle VoicePool::Acquire(const WAVEFORMATEX& format, IXAudio2Voice* output, uint8_t priority,
+                                     bool allowEqualPriority, uint32_t frame) {
+    if (!output) output = m_Output;
+    const uint64_t key = MakeFormatKey(format);
+    int freeIndex = -1;
+    int victimIndex = -1;
+    bool hasFormat = false;
+    for (size_t i = 0; i < m_Slots.size(); ++i) {
+        const Slot& slot = m_Slots[i];
+        if (slot.formatKey != key) continue;
+        hasFormat = true;
+        if (!slot.active) {
+            freeIndex = static_cast<int>(i);
+            break;
+        }
+        if (victimIndex < 0) {
+            victimIndex = static_cast<int>(i);
+            continue;
+        }
+        const Slot& victim = m_Slots[victimIndex];
+        if (slot.priority != victim.priority) {
+            if (slot.priority < victim.priority) victimIndex = static_cast<int>(i);
+        } else if (slot.audibility != victim.audibility) {
+            if (slot.audibility < victim.audibility) victimIndex = static_cast<int>(i);
+        } else if (slot.startSerial < victim.startSerial) {
+            victimIndex = static_cast<int>(i);
+        }
+    }
+
+    if (!hasFormat) {
+        if (!Reserve(format)) return kInvalidHandle;
+        return Acquire(format, output, priority, allowEqualPriority, frame);
+    }
+
+    if (freeIndex < 0) {
+        const Slot& victim = m_Slots[victimIndex];
+        const bool canSteal = allowEqualPriority ? victim.priority <= priority : victim.priority < priority;
+        if (!canSteal) {
+            m_Rejected++;
+            return kInvalidHandle;
+        }
+        StopSlot(m_Slots[victimIndex]);
+        m_Steals++;
+        freeIndex = victimIndex;
+    }
+
+    Slot& slot = m_Slots[freeIndex];
+    if (slot.output != output) {
+        // 换总线：声部闲置时改输出，不重建声部
+        XAUDIO2_SEND_DESCRIPTOR send = { 0, output };
+        XAUDIO2_VOICE_SENDS sends = { 1, &send };
+        if (FAILED(slot.voice->SetOutputVoices(&sends))) {
+            return kInvalidHandle;
+        }
+        slot.output = output;
+    }
+    slot.active = true;
+    slot.audibility = 1.0f;
+    slot.priority = priority;
+    slot.startFrame = frame;
+    slot.touchFrame = frame;
+    slot.startSerial = ++m_StartSerial;
+    return MakeHandle(static_cast<uint32_t>(freeIndex), slot.generation);
+}
+
+void VoicePool::StopSlot(Slot& slot) {
+    slot.voice->Stop(0);
+    slot.voice->FlushSourceBuffers();
+    slot.active = false;
+    // 代数跳过 0，使句柄永远不等于 kInvalidHandle
+    if (++slot.generation == 0) slot.generation = 1;
+}
+
+void VoicePool::Release(Handle handle) {
+    if (Slot* slot = Find(handle)) {
+        StopSlot(*slot);
+    }
+}
+
+const VoicePool::Slot* VoicePool::Find(Handle handle) const {
+    const uint32_t index = (handle & 0xFFFF);
+    if (index == 0 || index > m_Slots.size()) return nullptr;
+    const Slot& slot = m_Slots[index - 1];
+    if (!slot.active || slot.generation != static_cast<uint16_t>(handle >> 16)) return nullptr;
+    return &slot;
+}
+
+bool VoicePool::IsFinished(Handle handle, uint32_t frame) const {
+    const Slot* slot = Find(handle);
+    if (!slot) return true;
+    if (slot->startFrame == frame) return false;
+    XAUDIO2_VOICE_STATE state;
+    slot->voice->GetState(&state, XAUDIO2_VOICE_NOSAMPLESPLAYED);
+    return state.BuffersQueued == 0;
+}
+
+void VoicePool::Touch(Handle handle, uint32_t frame) {
+    if (Slot* slot = Find(handle)) {
+        slot->touchFrame = frame;
+    }
+}
+
+uint32_t VoicePool::ReleaseStale(uint32_t frame) {
+    uint32_t released = 0;
+    for (auto& slot : m_Slots) {
+        if (slot.active && slot.touchFrame != frame) {
+            StopSlot(slot);
+            released++;
+        }
+    }
+    return released;
+}
+
+VoicePool::Stats VoicePool::GetStats() const {
+    Stats stats;
+    stats.voices = static_cast<uint32_t>(m_Slots.size());
+    for (const auto& slot : m_Slots) {
+        if (slot.active) stats.active++;
+    }
+    stats.steals = m_Steals;
+    stats.rejected = m_Rejected;
+    return stats;
+}
+
+} // namespace outer_wilds
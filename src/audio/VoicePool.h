@@ -0,0 +1,119 @@
+#pragma once
+#include <xaudio2.h>
+#include <cstdint>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 预先创建的音效源声部池（按 PCM 格式分组）
+ *
+ * 创建 / 销毁 IXAudio2SourceVoice 的代价远高于提交一次缓冲，连续触发的短音效（脚步、撞击）
+ * 都从这里借用声部：Acquire 取一个空闲声部，没有空闲时抢占优先级最低（同级中最小声、再其次最早开始）的声部；
+ * Release 停止并清空缓冲后放回池中。
+ *
+ * 句柄 = 槽位 + 代数：声部被抢占或释放后旧句柄失效（IsValid 返回 false），持有者据此得知声音已被打断。
+ *
+ * 只在 AudioSystem::Update 所在的线程上调用。
+ */
+class VoicePool {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = 0;
+    static constexpr uint32_t kVoicesPerFormat = 16;
+    static constexpr float kMaxFrequencyRatio = 4.0f;
+
+    struct Stats {
+        uint32_t voices = 0;
+        uint32_t active = 0;
+        uint32_t steals = 0;     // 累计
+        uint32_t rejected = 0;   // 累计：没有可抢占的声部
+    };
+
+    VoicePool() = default;
+    ~VoicePool() { Shutdown(); }
+
+    VoicePool(const VoicePool&) = delete;
+    VoicePool& operator=(const VoicePool&) = delete;
+
+    /** @param output 默认输出目标（母带或子混音）；Acquire 可以为每次借用指定别的输出 */
+    bool Initialize(IXAudio2* xaudio, IXAudio2Voice* output);
+    void Shutdown();
+
+    /** @brief 为 format 预先创建 count 个声部（已有该格式的池时只补足数量） */
+    bool Reserve(const WAVEFORMATEX& format, uint32_t count = kVoicesPerFormat);
+
+    /**
+     * @brief 借用一个 format 格式的声部（没有该格式的池时先 Reserve）
+     * @param output 输出目标（子混音总线）；nullptr 表示默认输出
+     * @param allowEqualPriority 是否可以抢占同优先级的声部（新触发的声音可以，持续重试的循环声音不行，避免互相抢占）
+     * @return kInvalidHandle 表示没有可用声部
+     */
+    Handle Acquire(const WAVEFORMATEX& format, IXAudio2Voice* output, uint8_t priority, bool allowEqualPriority,
+                   uint32_t frame);
+
+    /** @brief 停止并归还声部；句柄随之失效 */
+    void Release(Handle handle);
+
+    bool IsValid(Handle handle) const { return Find(handle) != nullptr; }
+    IXAudio2SourceVoice* GetVoice(Handle handle) const {
+        const Slot* slot = Find(handle);
+        return slot ? slot->voice : nullptr;
+    }
+    uint32_t GetChannels(Handle handle) const {
+        const Slot* slot = Find(handle);
+        return slot ? slot->channels : 0;
+    }
+    IXAudio2Voice* GetOutput(Handle handle) const {
+        const Slot* slot = Find(handle);
+        return slot ? slot->output : nullptr;
+    }
+
+    /** @brief 本帧的估计音量（抢占时同优先级中先抢最小声的） */
+    void SetAudibility(Handle handle, float audibility) {
+        if (Slot* slot = Find(handle)) slot->audibility = audibility;
+    }
+
+    /** @brief 提交的缓冲已全部播完（Acquire 当帧总是返回 false：刚提交的缓冲可能还未计入） */
+    bool IsFinished(Handle handle, uint32_t frame) const;
+
+    /** @brief 标记声部本帧仍被使用 */
+    void Touch(Handle handle, uint32_t frame);
+
+    /** @brief 释放本帧没有 Touch 的声部（持有它的实体已被销毁或去掉了 AudioComponent） */
+    uint32_t ReleaseStale(uint32_t frame);
+
+    Stats GetStats() const;
+
+private:
+    struct Slot {
+        IXAudio2SourceVoice* voice = nullptr;
+        IXAudio2Voice* output = nullptr;
+        uint64_t formatKey = 0;
+        uint32_t channels = 0;
+        uint16_t generation = 1;
+        uint8_t priority = 0;
+        bool active = false;
+        float audibility = 1.0f;
+        uint32_t startFrame = 0;
+        uint32_t touchFrame = 0;
+        uint64_t startSerial = 0;
+    };
+
+    static uint64_t MakeFormatKey(const WAVEFORMATEX& format);
+    static Handle MakeHandle(uint32_t index, uint16_t generation) {
+        return (static_cast<Handle>(generation) << 16) | (index + 1);
+    }
+    const Slot* Find(Handle handle) const;
+    Slot* Find(Handle handle) { return const_cast<Slot*>(static_cast<const VoicePool*>(this)->Find(handle)); }
+    void StopSlot(Slot& slot);
+
+    IXAudio2* m_XAudio2 = nullptr;
+    IXAudio2Voice* m_Output = nullptr;
+    std::vector<Slot> m_Slots;
+    uint64_t m_StartSerial = 0;
+    uint32_t m_Steals = 0;
+    uint32_t m_Rejected = 0;
+};
+
+} // namespace outer_wilds
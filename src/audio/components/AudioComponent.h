@@ -0,0 +1,56 @@
+#pragma once
+#include "../../core/ECS.h"
+#include <cstdint>
+
+namespace outer_wilds {
+
+/** @brief AudioSystem::LoadClip / LoadSoundBank / FindClip 返回的音效 id */
+using SoundClipId = uint32_t;
+constexpr SoundClipId kInvalidSoundClip = 0;
+
+/** @brief 子混音总线（各自的音量，AudioSystem::SetBusVolume） */
+enum class AudioBus : uint8_t {
+    Music,
+    SFX,
+    Cockpit,
+    Ambient,
+    Count
+};
+
+/**
+ * @brief 实体上的 3D 音源（推进器、脚步、撞击）
+ *
+ * 位置取自同一实体的 TransformComponent；AudioSystem 每帧从声部池分配 / 回收声部并批量计算定位。
+ * 非循环声音播完、或声部被更高优先级的声音抢走后，AudioSystem 把 isPlaying 清为 false。
+ *
+ * 虚拟化：听不见的音源（衰减后低于阈值，或所在扇区休眠）不占声部，只推进 playhead；
+ * 重新听得见时从 playhead 对应的位置继续播放。
+ */
+struct AudioComponent : public Component {
+    SoundClipId clip = kInvalidSoundClip;
+    float volume = 1.0f;
+    float pitch = 1.0f;             // 频率比（0.25 ~ 4）
+    float minDistance = 1.0f;       // 全音量距离（X3DAudio CurveDistanceScaler，之外按反比衰减）
+    float maxDistance = 500.0f;     // 超过后静音
+    uint8_t priority = 128;         // 声部不够时优先级低的先被抢占
+    bool isLooping = false;
+    bool isPlaying = false;         // 置 true 开始播放（已在播放时不会重新开始，见 Trigger）
+    bool spatial = true;            // false：不做定位，直接送到左右声道（驾驶舱、界面音效）
+    AudioBus bus = AudioBus::SFX;
+
+    uint32_t triggerCount = 0;      // 每次递增都从头重新播放（连续的脚步 / 撞击）
+
+    /** @brief 从头播放（正在播放时也重新开始） */
+    void Trigger() {
+        isPlaying = true;
+        ++triggerCount;
+    }
+
+    // === 运行时（AudioSystem 维护）===
+    uint32_t voice = 0;             // VoicePool 句柄，0 表示没有声部
+    uint32_t playedTrigger = 0;     // 已响应的 triggerCount
+    float playhead = 0.0f;          // 从开始播放起经过的秒数（按 pitch 缩放，虚拟化期间照常推进）
+    bool isVirtual = false;         // 正在播放但没有声部
+};
+
+} // namespace outer_wilds
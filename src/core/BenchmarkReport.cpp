@@ -0,0 +1,193 @@
+#include "BenchmarkReport.h"
+#include "DebugManager.h"
+#include "../graphics/RenderQueue.h"
+#include <windows.h>
+#include <psapi.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#pragma comment(lib, "psapi.lib")
+
+namespace outer_wilds {
+
+namespace {
+    const char* const kRenderStatNames[] = {
+        "totalBatches", "drawCalls", "shaderSwitches", "textureSwitches", "materialSwitches",
+        "instancedDrawCalls", "instancesDrawn", "commandLists", "depthPrePassDrawCalls",
+        "visibleObjects", "culledObjects", "occludedObjects",
+        "cachedRenderables", "transformUpdates", "rebuiltRenderables", "reducedLODObjects", "impostorObjects",
+    };
+
+    // 作用域名称来自字符串字面量或 typeid 名称，只需转义引号和反斜杠
+    std::string EscapeJson(const std::string& text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped.push_back('\\');
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
+    float Percentile(const std::vector<float>& sorted, uint32_t percent) {
+        if (sorted.empty()) return 0.0f;
+        return sorted[std::min(sorted.size() - 1, sorted.size() * percent / 100)];
+    }
+}
+
+static_assert(sizeof(kRenderStatNames) / sizeof(kRenderStatNames[0]) == BenchmarkReport::kRenderStatCount,
+              "RenderStats field list out of date");
+
+const char* BenchmarkReport::GetRenderStatName(int index) {
+    return index >= 0 && index < kRenderStatCount ? kRenderStatNames[index] : "?";
+}
+
+void BenchmarkReport::GatherRenderStats(const RenderStats& stats, uint32_t (&out)[kRenderStatCount]) {
+    const uint32_t values[kRenderStatCount] = {
+        stats.totalBatches, stats.drawCalls, stats.shaderSwitches, stats.textureSwitches, stats.materialSwitches,
+        stats.instancedDrawCalls, stats.instancesDrawn, stats.commandLists, stats.depthPrePassDrawCalls,
+        stats.visibleObjects, stats.culledObjects, stats.occludedObjects,
+        stats.cachedRenderables, stats.transformUpdates, stats.rebuiltRenderables, stats.reducedLODObjects,
+        stats.impostorObjects,
+    };
+    std::copy(values, values + kRenderStatCount, out);
+}
+
+void BenchmarkReport::Reset() {
+    m_SkippedFrames = 0;
+    m_FrameTimesMs.clear();
+    m_Stages.clear();
+    std::fill(std::begin(m_RenderTotals), std::end(m_RenderTotals), 0.0);
+    std::fill(std::begin(m_RenderMax), std::end(m_RenderMax), 0u);
+    m_MemoryPeaks = {};
+}
+
+void BenchmarkReport::RecordFrame(const Profiler::FrameData& profile, float frameSeconds, const RenderStats& stats) {
+    m_MemoryPeaks.Sample(MemoryTracker::GetSnapshot());
+    if (m_SkippedFrames < m_WarmupFrames) {
+        m_SkippedFrames++;
+        return;
+    }
+
+    m_FrameTimesMs.push_back(frameSeconds * 1000.0f);
+
+    // 同名作用域（多个物理步、多线程上的同一系统）在一帧内求和
+    m_FrameScratch.clear();
+    for (const auto& node : profile.nodes) {
+        if (!node.name) continue;
+        m_FrameScratch[node.name] += static_cast<double>(node.durationNs) / 1.0e6;
+    }
+    for (const auto& entry : m_FrameScratch) {
+        auto it = m_Stages.find(entry.first);
+        if (it == m_Stages.end()) {
+            Stage stage;
+            stage.firstSeen = static_cast<uint32_t>(m_Stages.size());
+            it = m_Stages.emplace(entry.first, stage).first;
+        }
+        Stage& stage = it->second;
+        stage.totalMs += entry.second;
+        stage.maxMs = std::max(stage.maxMs, entry.second);
+        stage.frames++;
+    }
+
+    uint32_t values[kRenderStatCount];
+    GatherRenderStats(stats, values);
+    for (int i = 0; i < kRenderStatCount; i++) {
+        m_RenderTotals[i] += values[i];
+        m_RenderMax[i] = std::max(m_RenderMax[i], values[i]);
+    }
+}
+
+bool BenchmarkReport::Write(const std::string& path, const std::string& label) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        DebugManager::GetInstance().Log("Benchmark", "Failed to write benchmark report: " + path);
+        return false;
+    }
+
+    const size_t frameCount = m_FrameTimesMs.size();
+    std::vector<float> sorted = m_FrameTimesMs;
+    std::sort(sorted.begin(), sorted.end());
+    double totalMs = 0.0;
+    for (float ms : sorted) totalMs += ms;
+
+    char buffer[256];
+    file << "{\n";
+    file << "  \"run\": \"" << EscapeJson(label) << "\",\n";
+    file << "  \"warmupFrames\": " << m_SkippedFrames << ",\n";
+    snprintf(buffer, sizeof(buffer),
+             "  \"frames\": { \"count\": %zu, \"avgMs\": %.4f, \"p50Ms\": %.4f, \"p99Ms\": %.4f, \"maxMs\": %.4f },\n",
+             frameCount, frameCount ? totalMs / frameCount : 0.0,
+             Percentile(sorted, 50), Percentile(sorted, 99), sorted.empty() ? 0.0f : sorted.back());
+    file << buffer;
+
+    // 按首次出现的顺序输出，大致就是帧内的调用顺序
+    std::vector<const std::pair<const std::string, Stage>*> stages;
+    stages.reserve(m_Stages.size());
+    for (const auto& entry : m_Stages) stages.push_back(&entry);
+    std::sort(stages.begin(), stages.end(), [](const auto* a, const auto* b) {
+        return a->second.firstSeen < b->second.firstSeen;
+    });
+    file << "  \"stages\": [";
+    for (size_t i = 0; i < stages.size(); i++) {
+        const Stage& stage = stages[i]->second;
+        snprintf(buffer, sizeof(buffer), "\"avgMs\": %.4f, \"maxMs\": %.4f, \"frames\": %u }",
+                 frameCount ? stage.totalMs / frameCount : 0.0, stage.maxMs, stage.frames);
+        file << (i ? ",\n" : "\n") << "    { \"name\": \"" << EscapeJson(stages[i]->first) << "\", " << buffer;
+    }
+    file << (stages.empty() ? "],\n" : "\n  ],\n");
+
+    file << "  \"renderStats\": {";
+    for (int i = 0; i < kRenderStatCount; i++) {
+        snprintf(buffer, sizeof(buffer), "%s\n    \"%s\": { \"avg\": %.2f, \"max\": %u }", i ? "," : "",
+                 kRenderStatNames[i], frameCount ? m_RenderTotals[i] / frameCount : 0.0, m_RenderMax[i]);
+        file << buffer;
+    }
+    file << "\n  },\n";
+
+    PROCESS_MEMORY_COUNTERS memory = {};
+    memory.cb = sizeof(memory);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory))) {
+        memory = {};
+    }
+    snprintf(buffer, sizeof(buffer),
+             "  \"memory\": {\n    \"peakWorkingSetBytes\": %llu, \"peakCommitBytes\": %llu, \"workingSetBytes\": %llu,\n",
+             static_cast<unsigned long long>(memory.PeakWorkingSetSize),
+             static_cast<unsigned long long>(memory.PeakPagefileUsage),
+             static_cast<unsigned long long>(memory.WorkingSetSize));
+    file << buffer;
+
+    const MemoryTracker::Snapshot current = MemoryTracker::GetSnapshot();
+    const MemoryTracker::Snapshot& peak = m_MemoryPeaks.peak;
+    file << "    \"heapTracking\": " << (MemoryTracker::IsHeapTrackingEnabled() ? "true" : "false") << ",\n";
+    file << "    \"cpu\": {";
+    for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); i++) {
+        snprintf(buffer, sizeof(buffer), "%s\n      \"%s\": { \"bytes\": %lld, \"peakBytes\": %lld, \"allocations\": %lld }",
+                 i ? "," : "", MemoryTracker::GetCategoryName(static_cast<MemoryCategory>(i)),
+                 static_cast<long long>(current.cpu[i].bytes), static_cast<long long>(peak.cpu[i].bytes),
+                 static_cast<long long>(current.cpu[i].allocations));
+        file << buffer;
+    }
+    file << "\n    },\n";
+    file << "    \"gpu\": {";
+    for (size_t i = 0; i < static_cast<size_t>(GpuMemoryKind::Count); i++) {
+        snprintf(buffer, sizeof(buffer), "%s\n      \"%s\": { \"bytes\": %lld, \"peakBytes\": %lld, \"resources\": %lld }",
+                 i ? "," : "", MemoryTracker::GetGpuKindName(static_cast<GpuMemoryKind>(i)),
+                 static_cast<long long>(current.gpu[i].bytes), static_cast<long long>(peak.gpu[i].bytes),
+                 static_cast<long long>(current.gpu[i].allocations));
+        file << buffer;
+    }
+    file << "\n    },\n";
+    snprintf(buffer, sizeof(buffer), "    \"peakCpuTrackedBytes\": %lld, \"peakGpuTrackedBytes\": %lld\n  }\n",
+             static_cast<long long>(m_MemoryPeaks.peakCpuTotal), static_cast<long long>(m_MemoryPeaks.peakGpuTotal));
+    file << buffer;
+    file << "}\n";
+
+    snprintf(buffer, sizeof(buffer), "Benchmark report written: %zu frames, avg %.3f ms, p99 %.3f ms -> ",
+             frameCount, frameCount ? totalMs / frameCount : 0.0, Percentile(sorted, 99));
+    DebugManager::GetInstance().Log("Benchmark", buffer + path);
+    return true;
+}
+
+} // namespace outer_wilds
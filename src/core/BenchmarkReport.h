@@ -0,0 +1,64 @@
+#pragma once
+#include "MemoryTracker.h"
+#include "Profiler.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+
+struct RenderStats;
+
+/**
+ * @brief 无窗口基准测试的统计与 JSON 报告
+ *
+ * Engine 在无窗口模式下每帧调用 RecordFrame（传入上一帧的 Profiler 调用树、墙钟帧时间
+ * 和 RenderQueue 统计），Write 输出：
+ * - frames：帧时间 avg / p50 / p99 / max（毫秒）
+ * - stages：按 PROFILE_SCOPE 名称累计的每帧耗时 avg / max（同名作用域在一帧内求和）
+ * - renderStats：RenderStats 各字段的 avg / max
+ * - memory：进程工作集 / 提交内存的峰值（GetProcessMemoryInfo），以及 MemoryTracker 各分类
+ *   （CPU 堆按子系统、PhysX、GPU 缓冲区 / 纹理）的结束值和逐帧采样的峰值（预热帧也参与采样）
+ *
+ * 未定义 OW_PROFILER 时 stages 为空，其余字段照常输出。
+ */
+class BenchmarkReport {
+public:
+    static constexpr int kRenderStatCount = 17;
+
+    /** @brief RenderStats 字段名（报告 / 追踪文件的键，与 GatherRenderStats 的顺序一致） */
+    static const char* GetRenderStatName(int index);
+    static void GatherRenderStats(const RenderStats& stats, uint32_t (&out)[kRenderStatCount]);
+
+    /** @brief 开始统计前跳过的帧数（加载后的首帧包含着色器编译等一次性开销） */
+    void SetWarmupFrames(uint32_t frames) { m_WarmupFrames = frames; }
+
+    void Reset();
+
+    void RecordFrame(const Profiler::FrameData& profile, float frameSeconds, const RenderStats& stats);
+
+    /** @brief 写出 JSON 报告；label 记录运行方式（帧数 / 回放文件） */
+    bool Write(const std::string& path, const std::string& label) const;
+
+    uint32_t GetRecordedFrames() const { return static_cast<uint32_t>(m_FrameTimesMs.size()); }
+
+private:
+    struct Stage {
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+        uint32_t frames = 0;        // 出现过该作用域的帧数
+        uint32_t firstSeen = 0;     // 首次出现的顺序（报告按调用顺序输出）
+    };
+
+    uint32_t m_WarmupFrames = 0;
+    uint32_t m_SkippedFrames = 0;
+    std::vector<float> m_FrameTimesMs;
+    std::unordered_map<std::string, Stage> m_Stages;
+    std::unordered_map<const char*, double> m_FrameScratch;    // 本帧按名称求和（名称指针是静态的）
+    double m_RenderTotals[kRenderStatCount] = {};
+    uint32_t m_RenderMax[kRenderStatCount] = {};
+    MemoryTracker::PeakTracker m_MemoryPeaks;
+};
+
+} // namespace outer_wilds
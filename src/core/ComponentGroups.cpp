@@ -0,0 +1,50 @@
+#include "ComponentGroups.h"
+
+namespace outer_wilds {
+
+namespace {
+    template<typename Owned, typename Get, typename Group>
+    ComponentGroups::PoolStats MakeStats(entt::registry& registry, const char* name, const Group& group) {
+        const auto& owned = registry.storage<Owned>();
+        const auto& get = registry.storage<Get>();
+
+        ComponentGroups::PoolStats stats;
+        stats.name = name;
+        stats.size = static_cast<uint32_t>(owned.size());
+        stats.capacity = static_cast<uint32_t>(owned.capacity());
+        stats.grouped = static_cast<uint32_t>(group.size());
+
+        // 按组的遍历顺序检查 get 组件的池下标是否连续
+        uint32_t adjacent = 0;
+        bool hasPrevious = false;
+        size_t previous = 0;
+        for (auto entity : group) {
+            const size_t index = get.index(entity);
+            if (hasPrevious && (index + 1 == previous || previous + 1 == index)) adjacent++;
+            previous = index;
+            hasPrevious = true;
+        }
+        stats.getLocality = stats.grouped > 1 ? static_cast<float>(adjacent) / static_cast<float>(stats.grouped - 1) : 1.0f;
+        return stats;
+    }
+}
+
+void ComponentGroups::GatherPoolStats(entt::registry& registry, std::vector<PoolStats>& out) {
+    out.clear();
+
+    const auto& transforms = registry.storage<TransformComponent>();
+    PoolStats transformStats;
+    transformStats.name = "Transform";
+    transformStats.size = static_cast<uint32_t>(transforms.size());
+    transformStats.capacity = static_cast<uint32_t>(transforms.capacity());
+    out.push_back(transformStats);
+
+    out.push_back(MakeStats<components::InSectorComponent, TransformComponent>(
+        registry, "InSector (+Transform)", SectorResidents(registry)));
+    out.push_back(MakeStats<components::GravityAffectedComponent, TransformComponent>(
+        registry, "GravityAffected (+Transform)", GravityBodies(registry)));
+    out.push_back(MakeStats<RigidBodyComponent, components::InSectorComponent>(
+        registry, "RigidBody (+InSector)", RigidBodies(registry)));
+}
+
+} // namespace outer_wilds
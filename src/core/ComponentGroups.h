@@ -0,0 +1,70 @@
+#pragma once
+#include "ECS.h"
+#include "../scene/components/TransformComponent.h"
+#include "../physics/components/SectorComponent.h"
+#include "../physics/components/GravityAffectedComponent.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include <cstdint>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 热点路径的 EnTT owning group
+ *
+ * 多组件 view 遍历最小的池，再逐个到其他池里探查；owning group 让拥有的组件在存储池前部
+ * 按同一顺序紧凑排列，遍历时直接线性访问，非拥有（get）的组件仍按实体查找。
+ *
+ * - SectorResidents：拥有 InSectorComponent，get TransformComponent
+ *   （扇区局部 → 世界坐标同步、渲染插值、扇区切换检测）
+ * - GravityBodies：拥有 GravityAffectedComponent，get TransformComponent（重力收集）
+ * - RigidBodies：拥有 RigidBodyComponent，get InSectorComponent（Kinematic 同步）
+ *
+ * TransformComponent 被所有组共用，只能作为 get 组件（同一类型只能被一个组拥有）。
+ *
+ * 约束：
+ * - Register 在主线程、调度并行系统之前调用（创建组会修改 registry）
+ * - 被拥有的组件不能再用 registry.sort 排序
+ * - 实体加入/离开组时会交换被拥有组件在池中的位置：不要跨越其他实体的 emplace/remove
+ *   保存被拥有组件的引用
+ */
+class ComponentGroups {
+public:
+    static auto SectorResidents(entt::registry& registry) {
+        return registry.group<components::InSectorComponent>(entt::get<TransformComponent>);
+    }
+
+    static auto GravityBodies(entt::registry& registry) {
+        return registry.group<components::GravityAffectedComponent>(entt::get<TransformComponent>);
+    }
+
+    static auto RigidBodies(entt::registry& registry) {
+        return registry.group<RigidBodyComponent>(entt::get<components::InSectorComponent>);
+    }
+
+    /** @brief 创建所有组（已存在时只是查找） */
+    static void Register(entt::registry& registry) {
+        (void)SectorResidents(registry);
+        (void)GravityBodies(registry);
+        (void)RigidBodies(registry);
+    }
+
+    /**
+     * @brief 组件池统计（性能面板）
+     *
+     * grouped：组内实体数（被拥有组件池前部的紧凑段长度）
+     * getLocality：组内相邻实体的 get 组件在其池中也相邻的比例（1 = 完全顺序访问，越低缓存未命中越多）
+     */
+    struct PoolStats {
+        const char* name = "";
+        uint32_t size = 0;
+        uint32_t capacity = 0;
+        uint32_t grouped = 0;
+        float getLocality = 1.0f;
+    };
+
+    /** @brief 只读统计；组必须已经 Register */
+    static void GatherPoolStats(entt::registry& registry, std::vector<PoolStats>& out);
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,217 @@
+#include "DebugManager.h"
+#include "MemoryTracker.h"
+#include <cstdio>
+
+namespace outer_wilds {
+
+namespace {
+    constexpr auto kFlushInterval = std::chrono::milliseconds(20);
+
+    const char* LevelTag(LogLevel level) {
+        switch (level) {
+            case LogLevel::Trace: return "TRACE: ";
+            case LogLevel::Debug: return "DEBUG: ";
+            case LogLevel::Warning: return "WARNING: ";
+            case LogLevel::Error: return "ERROR: ";
+            default: return "";
+        }
+    }
+}
+
+DebugManager::DebugManager()
+    : m_Cells([] { OW_MEMORY_SCOPE(Logging); return new Cell[kCapacity]; }())
+    , m_StartTime(std::chrono::steady_clock::now()) {
+    for (uint32_t i = 0; i < kCapacity; i++) {
+        m_Cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_FlushThread = std::thread(&DebugManager::FlushThreadMain, this);
+}
+
+DebugManager::~DebugManager() {
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Running = false;
+    }
+    m_WakeCondition.notify_all();
+    if (m_FlushThread.joinable()) {
+        m_FlushThread.join();
+    }
+    Flush();
+}
+
+uint16_t DebugManager::GetCategoryId(std::string_view name) {
+    // 已发布的条目不会再被修改，可以无锁查找
+    uint32_t count = m_CategoryCount.load(std::memory_order_acquire);
+    for (uint32_t i = 1; i < count; i++) {
+        if (m_Categories[i] == name) return static_cast<uint16_t>(i);
+    }
+
+    std::lock_guard<std::mutex> lock(m_CategoryMutex);
+    count = m_CategoryCount.load(std::memory_order_relaxed);
+    for (uint32_t i = 1; i < count; i++) {
+        if (m_Categories[i] == name) return static_cast<uint16_t>(i);
+    }
+    if (count >= kMaxCategories) {
+        return kNoCategory;
+    }
+    m_Categories[count] = std::string(name);
+    m_CategoryCount.store(count + 1, std::memory_order_release);
+    return static_cast<uint16_t>(count);
+}
+
+bool DebugManager::SetLogFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_FlushMutex);
+    if (m_LogFile.is_open()) {
+        m_LogFile.close();
+    }
+    if (path.empty()) {
+        return true;
+    }
+    m_LogFile.open(path, std::ios::out | std::ios::app);
+    if (!m_LogFile.is_open()) {
+        std::cerr << "[DebugManager] Failed to open log file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void DebugManager::Flush() {
+    std::lock_guard<std::mutex> lock(m_FlushMutex);
+    DrainLocked();
+}
+
+void DebugManager::ForcePrint() {
+    std::lock_guard<std::mutex> lock(m_FlushMutex);
+    DrainLocked();
+
+    if (!m_History.empty() || m_ShowFPS) {
+        std::cout << "\n=== Debug Info ===" << std::endl;
+
+        // 显示FPS
+        if (m_ShowFPS) {
+            float fps = TimeManager::GetInstance().GetFPS();
+            std::cout << "[FPS] " << static_cast<int>(fps) << " fps ("
+                      << (1000.0f / fps) << " ms/frame)" << std::endl;
+        }
+
+        // 显示其他消息
+        for (const auto& message : m_History) {
+            std::cout << message << std::endl;
+        }
+        std::cout << "==================\n" << std::endl;
+    }
+    m_History.clear();
+    m_TimeAccumulator = 0.0f;
+}
+
+void DebugManager::FlushThreadMain() {
+    std::unique_lock<std::mutex> wakeLock(m_WakeMutex);
+    while (m_Running) {
+        m_WakeCondition.wait_for(wakeLock, kFlushInterval);
+        wakeLock.unlock();
+        Flush();
+        wakeLock.lock();
+    }
+}
+
+/**
+ * @brief 取出所有已发布的记录（单消费者：调用方持有 m_FlushMutex）
+ */
+void DebugManager::DrainLocked() {
+    OW_MEMORY_SCOPE(Logging);   // 格式化缓冲和历史行
+    const LogLevel consoleLevel = m_ConsoleLevel.load(std::memory_order_relaxed);
+    bool wroteFile = false;
+
+    for (;;) {
+        Cell& cell = m_Cells[m_DequeuePos & (kCapacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != m_DequeuePos + 1) {
+            break;
+        }
+
+        const LogRecord& record = cell.record;
+        FormatRecord(record, m_FormatScratch);
+        if (record.level >= consoleLevel) {
+            (record.level >= LogLevel::Warning ? std::cerr : std::cout) << m_FormatScratch << '\n';
+        }
+        if (m_LogFile.is_open()) {
+            char timestamp[24];
+            snprintf(timestamp, sizeof(timestamp), "[%10.3f] ", static_cast<double>(record.timestampNs) * 1e-9);
+            m_LogFile << timestamp << m_FormatScratch << '\n';
+            wroteFile = true;
+        }
+
+        // 槽位交还给生产者（下一轮的序号）
+        cell.sequence.store(m_DequeuePos + kCapacity, std::memory_order_release);
+        m_DequeuePos++;
+
+        if (m_History.size() >= kHistoryLines) {
+            m_History.pop_front();
+        }
+        m_History.push_back(m_FormatScratch);
+    }
+
+    const uint64_t dropped = m_Dropped.load(std::memory_order_relaxed);
+    if (dropped != m_ReportedDropped) {
+        std::cerr << "[DebugManager] Log buffer full, dropped " << (dropped - m_ReportedDropped) << " messages" << std::endl;
+        m_ReportedDropped = dropped;
+    }
+    if (wroteFile) {
+        m_LogFile.flush();
+    }
+}
+
+/**
+ * @brief "[Category] LEVEL: message"，按顺序把 "{}" 替换为参数
+ */
+void DebugManager::FormatRecord(const LogRecord& record, std::string& out) const {
+    out.clear();
+    if (record.category != kNoCategory && record.category < kMaxCategories) {
+        out += '[';
+        out += m_Categories[record.category];
+        out += "] ";
+    }
+    out += LevelTag(record.level);
+
+    if (!record.format) {
+        out.append(record.text, record.textLength);
+        return;
+    }
+
+    uint32_t argIndex = 0;
+    char number[32];
+    for (const char* c = record.format; *c; ++c) {
+        if (c[0] != '{' || c[1] != '}' || argIndex >= record.argCount) {
+            out += *c;
+            continue;
+        }
+        ++c;
+
+        const LogArg& arg = record.args[argIndex++];
+        switch (arg.type) {
+            case LogArg::Type::Int:
+                snprintf(number, sizeof(number), "%lld", static_cast<long long>(arg.i));
+                out += number;
+                break;
+            case LogArg::Type::UInt:
+                snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(arg.u));
+                out += number;
+                break;
+            case LogArg::Type::Double:
+                snprintf(number, sizeof(number), "%g", arg.d);
+                out += number;
+                break;
+            case LogArg::Type::Bool:
+                out += arg.u ? "true" : "false";
+                break;
+            case LogArg::Type::Text:
+                out.append(record.text + arg.textOffset, arg.textLength);
+                break;
+            case LogArg::Type::Pointer:
+                snprintf(number, sizeof(number), "%p", arg.p);
+                out += number;
+                break;
+        }
+    }
+}
+
+} // namespace outer_wilds
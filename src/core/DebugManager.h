@@ -1,79 +1,314 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <deque>
 #include <iostream>
+#include <fstream>
 #include <chrono>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include "TimeManager.h"
 
+/**
+ * 编译期日志级别下限：低于该级别的 OW_LOG_* 调用整段被丢弃（0=Trace 1=Debug 2=Info 3=Warning 4=Error）
+ */
+#ifndef OW_LOG_MIN_LEVEL
+#define OW_LOG_MIN_LEVEL 1
+#endif
+
 namespace outer_wilds {
 
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+/**
+ * @brief 调试日志
+ *
+ * 日志写入固定容量的多生产者无锁环形缓冲区（Vyukov 有界队列，每个槽位一个序号原子量），
+ * 后台线程定期取出记录、格式化并写到控制台/文件，最近 kHistoryLines 条保留给 ForcePrint。
+ * 缓冲区满时丢弃新记录并计数，生产者永远不会阻塞或分配内存。
+ *
+ * 热路径使用 OW_LOG_* 宏：分类名只在首次调用时查成整数 ID，参数按值编码进记录（字符串参数拷贝到记录内），
+ * 格式化（"{}" 占位符）推迟到后台线程。格式串必须是字符串字面量（只保存指针）。
+ *
+ * @code
+ * OW_LOG_DEBUG("Mesh", "Vertex buffer created with {} vertices", m_Vertices.size());
+ * @endcode
+ *
+ * 旧接口 Log(category, message) 仍然可用（Info 级别，消息整体拷贝进记录）。
+ */
 class DebugManager {
 public:
+    static constexpr uint32_t kCapacity = 4096;          // 必须是 2 的幂
+    static constexpr uint32_t kMaxArgs = 8;
+    static constexpr uint32_t kTextSize = 320;           // 记录内字符串存储（超出截断）
+    static constexpr uint32_t kMaxCategories = 128;
+    static constexpr uint32_t kHistoryLines = 256;
+    static constexpr uint16_t kNoCategory = 0;
+
     static DebugManager& GetInstance() {
         static DebugManager instance;
         return instance;
     }
 
+    // === 旧接口（Info 级别）===
     void Log(const std::string& message) {
-        m_DebugMessages.push_back(message);
+        LogText(LogLevel::Info, kNoCategory, message);
     }
 
     void Log(const std::string& category, const std::string& message) {
-        Log("[" + category + "] " + message);
+        LogText(LogLevel::Info, GetCategoryId(category), message);
+    }
+
+    /**
+     * @brief 记录一条已格式化的消息
+     */
+    void LogText(LogLevel level, uint16_t category, std::string_view message) {
+        if (level < m_MinLevel.load(std::memory_order_relaxed)) return;
+        size_t slot;
+        if (!AcquireSlot(slot)) return;
+        LogRecord& record = RecordAt(slot);
+        InitRecord(record, level, category, nullptr);
+        AppendText(record, message);
+        PublishSlot(slot);
+    }
+
+    /**
+     * @brief 延迟格式化：参数编码进记录，"{}" 在后台线程替换
+     * @param format 字符串字面量
+     */
+    template<typename... Args>
+    void LogFormat(LogLevel level, uint16_t category, const char* format, const Args&... args) {
+        static_assert(sizeof...(Args) <= kMaxArgs, "Too many log arguments");
+        if (level < m_MinLevel.load(std::memory_order_relaxed)) return;
+        size_t slot;
+        if (!AcquireSlot(slot)) return;
+        LogRecord& record = RecordAt(slot);
+        InitRecord(record, level, category, format);
+        (EncodeArg(record, args), ...);
+        PublishSlot(slot);
     }
 
+    /**
+     * @brief 分类名 -> ID（首次出现时注册；超过 kMaxCategories 返回 kNoCategory）
+     */
+    uint16_t GetCategoryId(std::string_view name);
+
+    /**
+     * @brief 运行时级别过滤（编译期下限见 OW_LOG_MIN_LEVEL）
+     */
+    void SetMinLevel(LogLevel level) { m_MinLevel.store(level, std::memory_order_relaxed); }
+    LogLevel GetMinLevel() const { return m_MinLevel.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 控制台输出的最低级别（默认只输出 Warning 及以上，其余保留在历史/文件中）
+     */
+    void SetConsoleLevel(LogLevel level) { m_ConsoleLevel.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief 同时把所有记录追加写入 path（空字符串关闭文件输出）
+     */
+    bool SetLogFile(const std::string& path);
+
+    /**
+     * @brief 立即在调用线程上取出并输出缓冲区中的记录
+     */
+    void Flush();
+
+    uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
     void Update(float deltaTime) {
         // 定期调试输出已禁用
         // m_TimeAccumulator += deltaTime;
         // if (m_TimeAccumulator >= m_DebugInterval) {
-        //     PrintAllMessages();
-        //     m_DebugMessages.clear();
+        //     ForcePrint();
         //     m_TimeAccumulator = 0.0f;
         // }
     }
-    
+
     void SetShowFPS(bool show) { m_ShowFPS = show; }
     bool IsShowingFPS() const { return m_ShowFPS; }
 
-    void ForcePrint() {
-        PrintAllMessages();
-        m_DebugMessages.clear();
-        m_TimeAccumulator = 0.0f;
-    }
+    /**
+     * @brief 输出自上次 ForcePrint 以来的历史消息（最多 kHistoryLines 条）并清空
+     */
+    void ForcePrint();
 
     void SetDebugInterval(float interval) {
         m_DebugInterval = interval;
     }
 
 private:
-    DebugManager() = default;
-    ~DebugManager() = default;
+    struct LogArg {
+        enum class Type : uint8_t { Int, UInt, Double, Bool, Text, Pointer };
+        Type type = Type::Int;
+        uint16_t textOffset = 0;
+        uint16_t textLength = 0;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const void* p;
+        };
+    };
+
+    struct LogRecord {
+        uint64_t timestampNs;
+        const char* format;             // nullptr：text 即完整消息
+        uint16_t category;
+        LogLevel level;
+        uint8_t argCount;
+        uint16_t textLength;
+        LogArg args[kMaxArgs];
+        char text[kTextSize];
+    };
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    DebugManager();
+    ~DebugManager();
     DebugManager(const DebugManager&) = delete;
     DebugManager& operator=(const DebugManager&) = delete;
 
-    void PrintAllMessages() {
-        if (!m_DebugMessages.empty() || m_ShowFPS) {
-            std::cout << "\n=== Debug Info ===" << std::endl;
-            
-            // 显示FPS
-            if (m_ShowFPS) {
-                float fps = TimeManager::GetInstance().GetFPS();
-                std::cout << "[FPS] " << static_cast<int>(fps) << " fps (" 
-                          << (1000.0f / fps) << " ms/frame)" << std::endl;
+    // === 环形缓冲区 ===
+    bool AcquireSlot(size_t& slot) {
+        size_t pos = m_EnqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_Cells[pos & (kCapacity - 1)];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot = pos;
+                    return true;
+                }
+            } else if (diff < 0) {
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = m_EnqueuePos.load(std::memory_order_relaxed);
             }
-            
-            // 显示其他消息
-            for (const auto& message : m_DebugMessages) {
-                std::cout << message << std::endl;
-            }
-            std::cout << "==================\n" << std::endl;
         }
     }
 
-    std::vector<std::string> m_DebugMessages;
+    LogRecord& RecordAt(size_t slot) { return m_Cells[slot & (kCapacity - 1)].record; }
+
+    void PublishSlot(size_t slot) {
+        m_Cells[slot & (kCapacity - 1)].sequence.store(slot + 1, std::memory_order_release);
+    }
+
+    void InitRecord(LogRecord& record, LogLevel level, uint16_t category, const char* format) {
+        record.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_StartTime).count());
+        record.format = format;
+        record.category = category;
+        record.level = level;
+        record.argCount = 0;
+        record.textLength = 0;
+    }
+
+    static uint16_t AppendText(LogRecord& record, std::string_view text) {
+        const uint16_t offset = record.textLength;
+        const size_t space = kTextSize - offset;
+        const size_t length = text.size() < space ? text.size() : space;
+        if (length > 0) {
+            std::memcpy(record.text + offset, text.data(), length);
+        }
+        record.textLength = static_cast<uint16_t>(offset + length);
+        return offset;
+    }
+
+    template<typename T>
+    static void EncodeArg(LogRecord& record, const T& value) {
+        LogArg& arg = record.args[record.argCount++];
+        if constexpr (std::is_same_v<T, bool>) {
+            arg.type = LogArg::Type::Bool;
+            arg.u = value ? 1 : 0;
+        } else if constexpr (std::is_enum_v<T>) {
+            arg.type = LogArg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            arg.type = LogArg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<T>) {
+            arg.type = LogArg::Type::UInt;
+            arg.u = static_cast<uint64_t>(value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.type = LogArg::Type::Double;
+            arg.d = static_cast<double>(value);
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            const std::string_view text(value);
+            arg.type = LogArg::Type::Text;
+            arg.textOffset = AppendText(record, text);
+            arg.textLength = static_cast<uint16_t>(record.textLength - arg.textOffset);
+        } else {
+            static_assert(std::is_pointer_v<T>, "Unsupported log argument type");
+            arg.type = LogArg::Type::Pointer;
+            arg.p = static_cast<const void*>(value);
+        }
+    }
+
+    // === 后台输出（只在持有 m_FlushMutex 时调用）===
+    void FlushThreadMain();
+    void DrainLocked();
+    void FormatRecord(const LogRecord& record, std::string& out) const;
+
+    std::unique_ptr<Cell[]> m_Cells;
+    std::atomic<size_t> m_EnqueuePos{ 0 };
+    size_t m_DequeuePos = 0;
+    std::atomic<uint64_t> m_Dropped{ 0 };
+    std::atomic<LogLevel> m_MinLevel{ LogLevel::Trace };
+    std::atomic<LogLevel> m_ConsoleLevel{ LogLevel::Warning };
+    std::chrono::steady_clock::time_point m_StartTime;
+
+    // 分类表：只追加，m_CategoryCount 发布已写好的条目
+    std::string m_Categories[kMaxCategories];
+    std::atomic<uint32_t> m_CategoryCount{ 1 };
+    std::mutex m_CategoryMutex;
+
+    std::mutex m_FlushMutex;
+    std::ofstream m_LogFile;
+    std::deque<std::string> m_History;
+    std::string m_FormatScratch;
+    uint64_t m_ReportedDropped = 0;
+
+    std::thread m_FlushThread;
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+    bool m_Running = true;
+
     float m_TimeAccumulator = 0.0f;
     float m_DebugInterval = 2.0f; // 每2秒输出一次
     bool m_ShowFPS = false;
 };
 
-} // namespace outer_wilds
\ No newline at end of file
+} // namespace outer_wilds
+
+#define OW_LOG(level, category, ...) \
+    do { \
+        if constexpr (static_cast<int>(level) >= OW_LOG_MIN_LEVEL) { \
+            static const uint16_t owLogCategory = ::outer_wilds::DebugManager::GetInstance().GetCategoryId(category); \
+            ::outer_wilds::DebugManager::GetInstance().LogFormat(level, owLogCategory, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define OW_LOG_TRACE(category, ...) OW_LOG(::outer_wilds::LogLevel::Trace, category, __VA_ARGS__)
+#define OW_LOG_DEBUG(category, ...) OW_LOG(::outer_wilds::LogLevel::Debug, category, __VA_ARGS__)
+#define OW_LOG_INFO(category, ...) OW_LOG(::outer_wilds::LogLevel::Info, category, __VA_ARGS__)
+#define OW_LOG_WARN(category, ...) OW_LOG(::outer_wilds::LogLevel::Warning, category, __VA_ARGS__)
+#define OW_LOG_ERROR(category, ...) OW_LOG(::outer_wilds::LogLevel::Error, category, __VA_ARGS__)
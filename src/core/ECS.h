@@ -1,5 +1,8 @@
 #pragma once
 #include <entt/entt.hpp>
+#include <string>
+#include <typeinfo>
+#include <vector>
 
 namespace outer_wilds {
 
@@ -13,6 +16,78 @@ public:
     virtual ~Component() = default;
 };
 
+/**
+ * @brief 系统声明的数据访问（SystemScheduler 据此构建依赖图）
+ *
+ * 组件按类型声明读/写；非组件的共享状态（PhysX 场景、实体创建/销毁等）用命名资源表示。
+ * 两个系统只要有一方写、另一方读或写同一项，就按 AddSystem 的顺序串行，否则可以并行。
+ * 会创建/销毁实体或调用 registry.valid 的系统必须声明 kEntities；Exclusive 的系统与所有系统串行。
+ *
+ * 并行时不得访问未声明的组件类型（调度前只为声明过的类型预先创建存储池）。
+ */
+class SystemAccess {
+public:
+    static constexpr const char* kEntities = "Entities";       // create/destroy/emplace/remove/valid
+    static constexpr const char* kPhysXScene = "PhysXScene";   // PhysX actor / 角色控制器
+    static constexpr const char* kInput = "Input";             // InputManager 状态
+
+    struct Entry {
+        std::string key;
+        bool write = false;
+    };
+
+    template<typename... Ts>
+    SystemAccess& Read() {
+        (Add(std::string("c:") + typeid(Ts).name(), false, &EnsureStorage<Ts>), ...);
+        return *this;
+    }
+
+    template<typename... Ts>
+    SystemAccess& Write() {
+        (Add(std::string("c:") + typeid(Ts).name(), true, &EnsureStorage<Ts>), ...);
+        return *this;
+    }
+
+    SystemAccess& ReadResource(const char* name) { Add(std::string("r:") + name, false, nullptr); return *this; }
+    SystemAccess& WriteResource(const char* name) { Add(std::string("r:") + name, true, nullptr); return *this; }
+
+    SystemAccess& Exclusive() { m_Exclusive = true; return *this; }
+    SystemAccess& MainThread() { m_MainThread = true; return *this; }
+
+    const std::vector<Entry>& GetEntries() const { return m_Entries; }
+    bool IsExclusive() const { return m_Exclusive; }
+    bool RequiresMainThread() const { return m_MainThread; }
+
+    /**
+     * @brief 在主线程上为声明过的组件类型创建存储池（并行阶段不会再改动 registry 的池表）
+     */
+    void PrepareStorage(entt::registry& registry) const {
+        for (auto ensure : m_EnsureStorage) ensure(registry);
+    }
+
+private:
+    using EnsureStorageFn = void(*)(entt::registry&);
+
+    template<typename T>
+    static void EnsureStorage(entt::registry& registry) { (void)registry.view<T>(); }
+
+    void Add(std::string key, bool write, EnsureStorageFn ensure) {
+        for (auto& entry : m_Entries) {
+            if (entry.key == key) {
+                entry.write = entry.write || write;
+                return;
+            }
+        }
+        m_Entries.push_back({ std::move(key), write });
+        if (ensure) m_EnsureStorage.push_back(ensure);
+    }
+
+    std::vector<Entry> m_Entries;
+    std::vector<EnsureStorageFn> m_EnsureStorage;
+    bool m_Exclusive = false;
+    bool m_MainThread = false;
+};
+
 // The base System class is simplified. Initialization and Shutdown
 // can be handled by the system's constructor/destructor or dedicated
 // public methods if needed.
@@ -22,6 +97,11 @@ public:
     virtual void Update(float deltaTime, entt::registry& registry) = 0;
     virtual void Initialize() {}
     virtual void Shutdown() {}
+
+    /**
+     * @brief 声明 Update 访问的组件和资源；默认 Exclusive（与其他系统串行）
+     */
+    virtual void DeclareAccess(SystemAccess& access) const { access.Exclusive(); }
 };
 
 } // namespace outer_wilds
@@ -1,16 +1,30 @@
 #include "Engine.h"
 #include "DebugManager.h"
 #include "TimeManager.h"
+#include "Profiler.h"
+#include "FlightRecorder.h"
+#include "JobSystem.h"
+#include "FrameAllocator.h"
 #include "../graphics/RenderSystem.h"
+#include "../graphics/ShaderCompileService.h"
 #include "../physics/PhysicsSystem.h"
 #include "../physics/SectorPhysicsSystem.h"
 #include "../physics/OrbitSystem.h"
+#include "../scene/TransformSystem.h"
+#include "../scene/AssetStreamer.h"
+#include "../scene/AssetHotReloader.h"
+#include "../scene/WorldSnapshot.h"
+#include "ComponentGroups.h"
+#include "../physics/FloatingOrigin.h"
+#include "../physics/SceneQueryService.h"
+#include "../physics/PhysicsEvents.h"
 // === 【已禁用】旧物理系统 - 等待重构 ===
 // #include "../physics/GravitySystem.h"
 // #include "../physics/ApplyGravitySystem.h"
 // #include "../physics/SectorSystem.h"
 #include "../gameplay/PlayerSystem.h"
 #include "../gameplay/SpacecraftDrivingSystem.h"
+#include "../gameplay/ImpactDebrisSystem.h"
 // #include "../gameplay/PlayerAlignmentSystem.h"
 // #include "../gameplay/OrbitSystem.h"
 // #include "../gameplay/SpacecraftControlSystem.h"
@@ -19,13 +33,18 @@
 #include "../gameplay/components/SpacecraftComponent.h"
 #include "../graphics/FreeCameraSystem.h"
 #include "../graphics/CameraModeSystem.h"
+#include "../graphics/PlanetTerrainSystem.h"
 #include "../audio/AudioSystem.h"
 #include "../ui/UISystem.h"
 #include "../input/InputManager.h"
+#include "../input/InputRecorder.h"
 #include "../physics/PhysXManager.h"
 #include "../scene/SceneManager.h"
 #include "../graphics/resources/OBJLoader.h"
 #include "../graphics/resources/TerrainGenerator.h"
+#include "../graphics/resources/ResourceCache.h"
+#include "../graphics/resources/GeometryPool.h"
+#include "../graphics/resources/TextureArrayAtlas.h"
 #include <windows.h>
 #include <iostream>
 
@@ -43,6 +62,9 @@ bool Engine::Initialize(void* hwnd, int width, int height) {
     InputManager::GetInstance().Initialize(static_cast<HWND>(hwnd));
     DebugManager::GetInstance().Log("InputManager", "InputManager initialized");
 
+    // 作业系统必须先于 PhysX 初始化（PhysX 的 CPU 调度器跑在它的工作线程上）
+    JobSystem::GetInstance().Initialize();
+
     if (!PhysXManager::GetInstance().Initialize()) {
         DebugManager::GetInstance().Log("PhysXManager", "Failed to initialize PhysX!");
         return false;
@@ -51,7 +73,7 @@ bool Engine::Initialize(void* hwnd, int width, int height) {
 
     m_RenderSystem = AddSystem<RenderSystem>();
     m_RenderSystem->Initialize(m_SceneManager.get());
-    if (!m_RenderSystem->InitializeBackend(hwnd, width, height)) {
+    if (!m_RenderSystem->InitializeBackend(hwnd, width, height, m_Headless.enabled)) {
         DebugManager::GetInstance().Log("RenderSystem", "Failed to initialize RenderBackend");
         return false;
     }
@@ -69,6 +91,9 @@ bool Engine::Initialize(void* hwnd, int width, int height) {
     m_OrbitSystem = AddSystem<OrbitSystem>();
     m_OrbitSystem->Initialize(m_SceneManager->GetActiveScene());
 
+    // 变换系统（渲染前刷新缓存的世界矩阵）
+    m_TransformSystem = AddSystem<TransformSystem>();
+
     // === 【已禁用】旧物理/轨道/对齐系统 - 等待重构 ===
     // m_OrbitSystem = AddSystem<OrbitSystem>();
     // m_SectorSystem = AddSystem<SectorSystem>();
@@ -85,6 +110,12 @@ bool Engine::Initialize(void* hwnd, int width, int height) {
     // 飞船驾驶系统（6DOF 物理控制）
     m_SpacecraftDrivingSystem = AddSystem<SpacecraftDrivingSystem>();
     m_SpacecraftDrivingSystem->Initialize(m_SceneManager->GetActiveScene());
+    m_SpacecraftDrivingSystem->SetOrbitSystem(m_OrbitSystem.get());
+
+    // 撞击碎片（Impact 事件 → PrefabPool 生成，到期回收）
+    m_ImpactDebrisSystem = AddSystem<ImpactDebrisSystem>();
+    m_ImpactDebrisSystem->Initialize(m_SceneManager->GetActiveScene(),
+                                     static_cast<ID3D11Device*>(m_RenderSystem->GetBackend()->GetDevice()));
 
     // 相机模式系统（处理玩家视角/自由视角切换）
     m_CameraModeSystem = AddSystem<CameraModeSystem>();
@@ -94,6 +125,21 @@ bool Engine::Initialize(void* hwnd, int width, int height) {
     m_FreeCameraSystem = AddSystem<FreeCameraSystem>();
     m_FreeCameraSystem->Initialize(m_SceneManager->GetActiveScene());
 
+    // 星球地形系统（在相机系统之后，按本帧相机位置细分四叉树）
+    m_PlanetTerrainSystem = AddSystem<PlanetTerrainSystem>();
+    m_PlanetTerrainSystem->Initialize(static_cast<ID3D11Device*>(m_RenderSystem->GetBackend()->GetDevice()));
+
+    // 无窗口基准：没有窗口给 ImGui，也不需要声音
+    if (m_Headless.enabled) {
+        m_BenchmarkReport.Reset();
+        m_BenchmarkReport.SetWarmupFrames(m_Headless.warmupFrames);
+        m_HeadlessFrames = 0;
+        DebugManager::GetInstance().Log("Engine", "Headless benchmark mode: " +
+            (m_Headless.frameCount ? std::to_string(m_Headless.frameCount) + " frames" : std::string("until replay ends")));
+        m_Running = true;
+        return true;
+    }
+
     // 音频系统
     m_AudioSystem = AddSystem<AudioSystem>();
     if (!m_AudioSystem->InitializeAudio()) {
@@ -111,6 +157,13 @@ bool Engine::Initialize(void* hwnd, int width, int height) {
         DebugManager::GetInstance().Log("UISystem", "Failed to initialize UISystem");
     } else {
         DebugManager::GetInstance().Log("UISystem", "UISystem initialized successfully");
+        m_UISystem->SetGpuProfiler(&m_RenderSystem->GetBackend()->GetGpuProfiler());
+        m_UISystem->SetRenderStats(&m_RenderSystem->GetRenderQueue().GetStats());
+    }
+
+    // 资源热重载（无窗口基准不启用：结果要可复现）
+    if (m_HotReloadEnabled) {
+        AssetHotReloader::GetInstance().Start(d3d11Device);
     }
 
     m_Running = true;
@@ -127,11 +180,38 @@ void Engine::Run() {
 }
 
 void Engine::Shutdown() {
+    // 系统析构时会释放 actor，必须先等在途的模拟结束
+    PhysXManager::GetInstance().FinishStep();
+    // 加载线程可能还在创建资源：先停下，再释放共享资源
+    AssetHotReloader::GetInstance().Stop();
+    AssetStreamer::GetInstance().Shutdown();
+    m_GameSystems.clear();
+    m_SystemScheduler.Invalidate();
     m_Systems.clear();
+    // 共享的 Mesh 缓冲 / 材质纹理（D3D 子对象持有设备引用，设备释放后仍可 Release）
+    resources::ResourceCache::GetInstance().Clear();
+    // 纹理数组页在单例静态析构之前释放：之后仍存活的 Material 析构时 Unpack 只是空操作
+    resources::TextureArrayAtlas::GetInstance().Shutdown();
+    resources::GeometryPool::GetInstance().Shutdown();
+    InputRecorder::GetInstance().Stop();
+    if (m_Headless.enabled) {
+        const std::string label = m_Headless.frameCount ? "frames:" + std::to_string(m_HeadlessFrames) : "replay";
+        m_BenchmarkReport.Write(m_Headless.reportPath, label);
+    }
+    ShaderCompileService::GetInstance().Shutdown();
     PhysXManager::GetInstance().Shutdown();
+    JobSystem::GetInstance().Shutdown();
 }
 
 void Engine::MainLoop() {
+    // CPU 分析器帧边界：汇总上一帧的调用树（帧时间包含下面的帧延迟等待）
+    PROFILE_FRAME();
+
+    // 先等待交换链的帧延迟对象，再处理消息/输入：输入尽可能靠近本帧的呈现
+    if (m_RenderSystem && m_RenderSystem->GetBackend()) {
+        m_RenderSystem->GetBackend()->BeginFrame();
+    }
+
     MSG msg = {};
     while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
         TranslateMessage(&msg);
@@ -153,23 +233,57 @@ void Engine::MainLoop() {
         return;
     }
 
+    // 输入在帧开头统一采样（录制/回放在这里覆盖输入与确定性时间步）
     TimeManager::GetInstance().Update();
+    InputManager::GetInstance().Update();
+    InputRecorder::GetInstance().Update();
+    if (m_Headless.enabled && !UpdateHeadless()) {
+        return;
+    }
+    if (InputRecorder::GetInstance().ConsumeReplayFinished()) {
+        std::cout << "[Engine] Input replay finished, stopping..." << std::endl;
+        m_Running = false;
+        return;
+    }
     m_DeltaTime = TimeManager::GetInstance().GetDeltaTime();
 
     Update();
 }
 
+/**
+ * @brief 无窗口基准：记录上一帧的统计，达到帧数后停止
+ * @return false 表示本帧不再运行
+ */
+bool Engine::UpdateHeadless() {
+    // 此时 Profiler 的上一帧、TimeManager 的墙钟 delta 与 RenderStats 都属于同一帧
+    if (m_HeadlessFrames > 0 && m_RenderSystem) {
+        m_BenchmarkReport.RecordFrame(Profiler::GetInstance().GetLastFrame(),
+                                      TimeManager::GetInstance().GetRealDeltaTime(),
+                                      m_RenderSystem->GetRenderQueue().GetStats());
+    }
+    if (m_Headless.frameCount > 0 && m_HeadlessFrames >= m_Headless.frameCount) {
+        std::cout << "[Engine] Headless benchmark finished, stopping..." << std::endl;
+        m_Running = false;
+        return false;
+    }
+    m_HeadlessFrames++;
+    return true;
+}
+
 void Engine::Update() {
     if (!m_SceneManager || !m_SceneManager->GetActiveScene()) return;
     auto& registry = m_SceneManager->GetActiveScene()->GetRegistry();
 
+    // 热点 owning group 必须在主线程上创建（切换场景后的新 registry 在这里补建，已存在时只是查找）
+    ComponentGroups::Register(registry);
+
     // ============================================
     // 更新顺序（严格按此执行）
     // ============================================
     // 1. 轨道系统（更新星球位置）
     // 2. 输入/游戏逻辑系统
-    // 3. SectorPhysicsSystem::PrePhysicsUpdate (重力、力)
-    // 4. PhysXManager::Update (simulate + fetchResults)
+    // 3. SectorPhysicsSystem::PrePhysicsUpdate (重力、力) + SpacecraftDrivingSystem::PrePhysicsStep (飞行模型)
+    // 4. PhysXManager::Step (simulate + fetchResults；流水线模式下 fetchResults 在下一帧开头)
     // 5. SectorPhysicsSystem::PostPhysicsUpdate (坐标转换、扇区同步)
     // 6. 相机系统
     // 7. 渲染系统
@@ -178,38 +292,151 @@ void Engine::Update() {
     //   // [来源: XXXSystem] 操作描述
     // ============================================
 
-    // 1. 轨道系统：更新星球公转/自转位置（必须在其他系统之前）
-    if (m_OrbitSystem) {
-        m_OrbitSystem->Update(m_DeltaTime, registry);
+    // 0. 流水线物理：取回上一帧启动的固定步，完成它的物理后处理。
+    //    此后到本帧 BeginStep 之前是访问 PhysX 的唯一窗口
+    auto& physx = PhysXManager::GetInstance();
+    if (physx.IsSimulating()) {
+        {
+            PROFILE_SCOPE("PhysX::FetchResults");
+            physx.FinishStep();
+        }
+        if (m_SectorPhysicsSystem) {
+            PROFILE_SCOPE("PostPhysicsUpdate");
+            m_SectorPhysicsSystem->PostPhysicsUpdate(physx.GetFixedTimeStep(), registry);
+        }
     }
-    
-    // 2. 游戏逻辑系统（跳过 RenderSystem、SectorPhysicsSystem、OrbitSystem）
-    for (auto& system : m_Systems) {
-        if (system.get() == static_cast<System*>(m_RenderSystem.get())) continue;
-        if (system.get() == static_cast<System*>(m_SectorPhysicsSystem.get())) continue;
-        if (system.get() == static_cast<System*>(m_OrbitSystem.get())) continue;
-        system->Update(m_DeltaTime, registry);
+
+    //    上一帧各固定步的接触 / 触发器 / 睡眠事件：监听者（着陆、撞击音效等）在系统之前同步处理
+    PhysicsEventQueue::GetInstance().Dispatch(registry);
+
+    //    快速存档 / 读档（F5 / F9）：仍在 PhysX 访问窗口内，读档写入的位姿本帧由轨道 / 扇区系统照常传播
+    WorldSnapshot::GetInstance().Update(registry, m_OrbitSystem.get());
+
+    //    卡顿飞行记录仪：记录上一帧（调用树 / 渲染和 PhysX 统计 / 输入），尖峰帧时自动导出追踪文件
+    {
+        PROFILE_SCOPE("FlightRecorder");
+        FlightRecorder::GetInstance().RecordFrame(
+            registry, TimeManager::GetInstance().GetRealDeltaTime(),
+            m_RenderSystem ? &m_RenderSystem->GetRenderQueue().GetStats() : nullptr,
+            m_CameraModeSystem ? m_CameraModeSystem->GetCurrentMode() : CameraMode::Player);
     }
-    
-    // 3. 物理前处理：计算重力、应用力、同步 Kinematic
+
+    //    上一帧提交的批量场景查询在这里并行执行（场景只读，系统还没开始修改），
+    //    结果由各系统本帧读取
+    SceneQueryService::GetInstance().Execute();
+
+    // 1. 浮动原点：玩家走远后把原点移过去（平移所有单精度世界坐标），
+    //    然后轨道系统更新星球公转/自转位置（必须在其他系统之前）
+    //    时间加速的模式切换（可能挂起 PhysX）也在这里完成：此时没有模拟在进行
+    FloatingOrigin::GetInstance().Update(registry);
     if (m_SectorPhysicsSystem) {
-        m_SectorPhysicsSystem->PrePhysicsUpdate(m_DeltaTime, registry);
+        m_SectorPhysicsSystem->UpdateTimeWarp(registry);
+    }
+    const float timeWarp = m_SectorPhysicsSystem ? m_SectorPhysicsSystem->GetTimeWarp() : 1.0f;
+    if (m_OrbitSystem) {
+        PROFILE_SCOPE("Orbit");
+        m_OrbitSystem->Update(m_DeltaTime * timeWarp, registry);
+    }
+    // 星球位置本帧不再变化：重建扇区空间索引，远离玩家的扇区休眠
+    if (m_SectorPhysicsSystem) {
+        m_SectorPhysicsSystem->RebuildSectorIndex(registry);
+        m_SectorPhysicsSystem->UpdateHibernation(registry);
+    }
+    // 异步加载完成的模型换上真实网格（游戏系统本帧看到的是最终组件）
+    // 热重载先分派本帧稳定下来的文件变更（重新加载同样经过 AssetStreamer）
+    {
+        PROFILE_SCOPE("AssetStreamer::Apply");
+        AssetHotReloader::GetInstance().Update();
+        AssetStreamer::GetInstance().ApplyCompleted(registry);
+        // 加载线程空闲时才释放已上传网格的 CPU 数据（在途任务可能还在读顶点）
+        // 并按固定节奏回收引用计数归零的缓存条目；热重载换下模型后立即回收退役的旧网格
+        m_ResourceTrimTimer += TimeManager::GetInstance().GetRealDeltaTime();
+        const uint32_t modelReloads = AssetHotReloader::GetInstance().GetStats().modelReloads;
+        if (AssetStreamer::GetInstance().GetPendingCount() == 0) {
+            auto& cache = resources::ResourceCache::GetInstance();
+            cache.ReleaseUploadedCPUData();
+            if (m_ResourceTrimTimer >= kResourceTrimInterval || modelReloads != m_TrimmedModelReloads) {
+                m_ResourceTrimTimer = 0.0f;
+                m_TrimmedModelReloads = modelReloads;
+                PROFILE_SCOPE("ResourceCache::Trim");
+                cache.Trim();
+            }
+        }
     }
     
-    // 4. PhysX 物理模拟
-    PhysXManager::GetInstance().Update(m_DeltaTime);
+    // 2. 游戏逻辑系统（跳过 RenderSystem、SectorPhysicsSystem、OrbitSystem、TransformSystem）
+    //    按 DeclareAccess 构建依赖图，互不冲突的系统在 JobSystem 上并行
+    {
+        PROFILE_SCOPE("GameSystems");
+        m_GameSystems.clear();
+        for (auto& system : m_Systems) {
+            if (system.get() == static_cast<System*>(m_RenderSystem.get())) continue;
+            if (system.get() == static_cast<System*>(m_SectorPhysicsSystem.get())) continue;
+            if (system.get() == static_cast<System*>(m_OrbitSystem.get())) continue;
+            if (system.get() == static_cast<System*>(m_TransformSystem.get())) continue;
+            m_GameSystems.push_back(system.get());
+        }
+        m_SystemScheduler.Run(m_GameSystems, m_DeltaTime, registry);
+    }
     
-    // 5. 物理后处理：读取结果、坐标转换、扇区同步
+    // 3-5. 固定步长物理：每个到期的步都完整执行 Pre -> simulate -> Post，
+    //      渲染用的 Transform 最后按累加器剩余比例在最近两步之间插值。
+    //      流水线模式下最后一步只 simulate，与渲染重叠，fetchResults/Post 推迟到下一帧开头
+    //      （渲染的是上一个已完成步的插值状态，多一步延迟）
+    //      时间加速：低倍率按加速后的时间推进（步数仍受上限约束），轨道模式下不步进
+    const bool onRails = m_SectorPhysicsSystem && m_SectorPhysicsSystem->IsOnRails();
+    const uint32_t physicsSteps = onRails ? 0 : physx.Advance(m_DeltaTime * timeWarp);
+    const float fixedStep = physx.GetFixedTimeStep();
+    for (uint32_t step = 0; step < physicsSteps; step++) {
+        // 3. 物理前处理：计算重力、应用力、同步 Kinematic
+        if (m_SectorPhysicsSystem) {
+            PROFILE_SCOPE("PrePhysicsUpdate");
+            m_SectorPhysicsSystem->PrePhysicsUpdate(fixedStep, registry);
+        }
+        //    飞船飞行模型：推力 / 力矩按物理步长施加
+        if (m_SpacecraftDrivingSystem) {
+            PROFILE_SCOPE("SpacecraftFlight");
+            m_SpacecraftDrivingSystem->PrePhysicsStep(fixedStep, registry);
+        }
+
+        // 4. PhysX 物理模拟
+        if (physx.IsPipelined() && step + 1 == physicsSteps) {
+            PROFILE_SCOPE("PhysX::Simulate");
+            physx.BeginStep();
+            break;
+        }
+        {
+            PROFILE_SCOPE("PhysXManager::Update");
+            physx.Step();
+        }
+
+        // 5. 物理后处理：读取结果、坐标转换、扇区同步
+        if (m_SectorPhysicsSystem) {
+            PROFILE_SCOPE("PostPhysicsUpdate");
+            m_SectorPhysicsSystem->PostPhysicsUpdate(fixedStep, registry);
+        }
+    }
     if (m_SectorPhysicsSystem) {
-        m_SectorPhysicsSystem->PostPhysicsUpdate(m_DeltaTime, registry);
+        PROFILE_SCOPE("InterpolateTransforms");
+        m_SectorPhysicsSystem->InterpolateTransforms(physx.GetInterpolationAlpha(), registry);
+    }
+
+    // Transform 本帧不再变化：一次性刷新移动过的实体的世界矩阵，渲染/剔除直接读取缓存
+    if (m_TransformSystem) {
+        PROFILE_SCOPE("TransformSystem");
+        m_TransformSystem->UpdateWorldMatrices(registry);
     }
 
     DebugManager::GetInstance().Update(m_DeltaTime);
 
     // 6-7. 渲染系统最后执行
     if (m_RenderSystem) {
+        PROFILE_SCOPE("Render");
         m_RenderSystem->Update(m_DeltaTime, registry);
     }
+
+    // 本帧的作业都已完成：推进帧号，各线程的帧内临时内存在下下一帧回收
+    FrameAllocator::GetInstance().EndFrame();
 }
 
 }
@@ -1,8 +1,12 @@
 #pragma once
 #include "ECS.h"
+#include "SystemScheduler.h"
+#include "BenchmarkReport.h"
 #include "../scene/SceneManager.h"
 #include "../graphics/resources/Mesh.h"
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace outer_wilds {
@@ -12,13 +16,29 @@ class RenderSystem;
 class PhysicsSystem;
 class SectorPhysicsSystem;
 class OrbitSystem;
+class TransformSystem;
 class PlayerSystem;
 class SpacecraftDrivingSystem;
+class ImpactDebrisSystem;
 class FreeCameraSystem;
 class CameraModeSystem;
+class PlanetTerrainSystem;
 class AudioSystem;
 class UISystem;
 
+/**
+ * @brief 无窗口基准模式（Engine::Initialize 之前设置）
+ *
+ * 不创建窗口、交换链、UI 和音频；渲染系统只做收集/剔除/排序。运行 frameCount 帧，
+ * 或直到输入回放结束（frameCount = 0），Shutdown 时把统计写入 reportPath（JSON）。
+ */
+struct HeadlessSettings {
+    bool enabled = false;
+    uint32_t frameCount = 600;
+    uint32_t warmupFrames = 10;
+    std::string reportPath = "headless_report.json";
+};
+
 class Engine {
 public:
     static Engine& GetInstance() {
@@ -31,6 +51,13 @@ public:
     void Shutdown();
     void Stop() { m_Running = false; }
 
+    void SetHeadless(const HeadlessSettings& settings) { m_Headless = settings; }
+    const HeadlessSettings& GetHeadless() const { return m_Headless; }
+    bool IsHeadless() const { return m_Headless.enabled; }
+
+    /** @brief 监视 shaders/ 和 assets/ 并热重载变化的资源（默认开启，无窗口模式下忽略） */
+    void SetHotReloadEnabled(bool enabled) { m_HotReloadEnabled = enabled; }
+
     template<typename T, typename... Args>
     std::shared_ptr<T> AddSystem(Args&&... args) {
         auto system = std::make_shared<T>(std::forward<Args>(args)...);
@@ -52,22 +79,38 @@ private:
 
     void MainLoop();
     void Update();
+    bool UpdateHeadless();
 
     bool m_Running = false;
     float m_DeltaTime = 0.0f;
 
+    // ResourceCache::Trim 的节奏（墙钟秒）：回收不再被任何实体引用的网格 / 纹理
+    static constexpr float kResourceTrimInterval = 5.0f;
+    float m_ResourceTrimTimer = 0.0f;
+    uint32_t m_TrimmedModelReloads = 0;        // 上次 Trim 时热重载已替换的模型数（有新替换时立即 Trim）
+
+    HeadlessSettings m_Headless;
+    bool m_HotReloadEnabled = true;
+    BenchmarkReport m_BenchmarkReport;
+    uint32_t m_HeadlessFrames = 0;
+
     std::unique_ptr<SceneManager> m_SceneManager;
     std::vector<std::shared_ptr<System>> m_Systems;
+    std::vector<System*> m_GameSystems;        // 本帧交给调度器的系统（复用容量）
+    SystemScheduler m_SystemScheduler;
     
     // Core systems
     std::shared_ptr<RenderSystem> m_RenderSystem;
     std::shared_ptr<PhysicsSystem> m_PhysicsSystem;
     std::shared_ptr<SectorPhysicsSystem> m_SectorPhysicsSystem;
     std::shared_ptr<OrbitSystem> m_OrbitSystem;
+    std::shared_ptr<TransformSystem> m_TransformSystem;
     std::shared_ptr<PlayerSystem> m_PlayerSystem;
     std::shared_ptr<SpacecraftDrivingSystem> m_SpacecraftDrivingSystem;
+    std::shared_ptr<ImpactDebrisSystem> m_ImpactDebrisSystem;
     std::shared_ptr<FreeCameraSystem> m_FreeCameraSystem;
     std::shared_ptr<CameraModeSystem> m_CameraModeSystem;
+    std::shared_ptr<PlanetTerrainSystem> m_PlanetTerrainSystem;
     std::shared_ptr<AudioSystem> m_AudioSystem;
     std::shared_ptr<UISystem> m_UISystem;
 
@@ -0,0 +1,167 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "FileWatcher.h"
+#include "DebugManager.h"
+#include <windows.h>
+#include <algorithm>
+
+namespace outer_wilds {
+
+/**
+ * @brief 一个监视中的目录：句柄 + 重叠 IO 状态 + 通知缓冲（必须 DWORD 对齐）
+ */
+struct FileWatcher::Directory {
+    std::string root;
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    OVERLAPPED overlapped = {};
+    bool pending = false;   // 有一个挂起的 ReadDirectoryChangesW
+    alignas(DWORD) uint8_t buffer[32 * 1024];
+
+    bool Issue() {
+        constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME |
+                                        FILE_NOTIFY_CHANGE_SIZE;
+        pending = ReadDirectoryChangesW(handle, buffer, sizeof(buffer), TRUE, kNotifyFilter, nullptr,
+                                        &overlapped, nullptr) != FALSE;
+        return pending;
+    }
+};
+
+namespace {
+    std::string ToUtf8(const wchar_t* text, size_t length) {
+        const int size = WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), nullptr, 0, nullptr, nullptr);
+        std::string result(static_cast<size_t>(size), '\0');
+        WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length), result.data(), size, nullptr, nullptr);
+        std::replace(result.begin(), result.end(), '\\', '/');
+        return result;
+    }
+}
+
+bool FileWatcher::Start(const std::vector<std::string>& directories) {
+    Stop();
+
+    for (const auto& root : directories) {
+        // WaitForMultipleObjects 最多 64 个句柄（含停止事件）：只监视少数几个根目录
+        if (m_Directories.size() + 1 >= MAXIMUM_WAIT_OBJECTS) break;
+
+        HANDLE handle = CreateFileA(root.c_str(), FILE_LIST_DIRECTORY,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                    OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            DebugManager::GetInstance().Log("FileWatcher", "Directory not found, not watching: " + root);
+            continue;
+        }
+
+        auto* directory = new Directory();
+        directory->root = root;
+        directory->handle = handle;
+        directory->overlapped.hEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+        if (!directory->overlapped.hEvent || !directory->Issue()) {
+            DebugManager::GetInstance().Log("FileWatcher", "ReadDirectoryChangesW failed: " + root);
+            if (directory->overlapped.hEvent) CloseHandle(directory->overlapped.hEvent);
+            CloseHandle(handle);
+            delete directory;
+            continue;
+        }
+        m_Directories.push_back(directory);
+        DebugManager::GetInstance().Log("FileWatcher", "Watching " + root);
+    }
+    if (m_Directories.empty()) return false;
+
+    m_StopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    m_Thread = std::thread(&FileWatcher::WatchMain, this);
+    return true;
+}
+
+void FileWatcher::Stop() {
+    if (m_Thread.joinable()) {
+        SetEvent(static_cast<HANDLE>(m_StopEvent));
+        m_Thread.join();
+    }
+    for (Directory* directory : m_Directories) {
+        // 取消挂起的读取并等它结束：内核完成前不能释放缓冲
+        if (directory->pending) {
+            CancelIoEx(directory->handle, &directory->overlapped);
+            DWORD bytes = 0;
+            GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+        }
+        CloseHandle(directory->overlapped.hEvent);
+        CloseHandle(directory->handle);
+        delete directory;
+    }
+    m_Directories.clear();
+    if (m_StopEvent) {
+        CloseHandle(static_cast<HANDLE>(m_StopEvent));
+        m_StopEvent = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Pending.clear();
+}
+
+std::vector<std::string> FileWatcher::PollChanges() {
+    std::vector<std::string> settled;
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (auto it = m_Pending.begin(); it != m_Pending.end();) {
+        if (now - it->second >= kSettleTime) {
+            settled.push_back(it->first);
+            it = m_Pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return settled;
+}
+
+void FileWatcher::WatchMain() {
+    std::vector<HANDLE> events;
+    events.push_back(static_cast<HANDLE>(m_StopEvent));
+    for (Directory* directory : m_Directories) {
+        events.push_back(directory->overlapped.hEvent);
+    }
+
+    for (;;) {
+        const DWORD result = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, INFINITE);
+        if (result == WAIT_OBJECT_0 || result == WAIT_FAILED) return;
+
+        const size_t index = result - WAIT_OBJECT_0 - 1;
+        if (index >= m_Directories.size()) continue;
+        Directory* directory = m_Directories[index];
+
+        DWORD bytes = 0;
+        directory->pending = false;
+        if (!GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, FALSE)) {
+            DebugManager::GetInstance().Log("FileWatcher", "Watch failed, stopping: " + directory->root);
+            continue;
+        }
+        if (bytes == 0) {
+            // 缓冲溢出：这一批通知丢失（下次保存时再触发）
+            DebugManager::GetInstance().Log("FileWatcher", "Change buffer overflow: " + directory->root);
+        }
+
+        {
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (size_t offset = 0; bytes > 0;) {
+                const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(directory->buffer + offset);
+                if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED ||
+                    info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                    // 编辑器常见的保存方式是写临时文件再改名：以新名字记录
+                    const std::string relative = ToUtf8(info->FileName, info->FileNameLength / sizeof(wchar_t));
+                    m_Pending[directory->root + "/" + relative] = now;
+                }
+                if (info->NextEntryOffset == 0) break;
+                offset += info->NextEntryOffset;
+            }
+        }
+
+        if (!directory->Issue()) {
+            DebugManager::GetInstance().Log("FileWatcher", "ReadDirectoryChangesW failed, stopping: " + directory->root);
+        }
+    }
+}
+
+} // namespace outer_wilds
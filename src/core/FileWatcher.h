@@ -0,0 +1,52 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 目录变更监视（ReadDirectoryChangesW，递归监视子目录）
+ *
+ * 后台线程用重叠 IO 等待所有目录的通知，把变化的文件路径（"<目录>/<相对路径>"，'/' 分隔）
+ * 记进待处理表。编辑器保存一个文件通常连发多次通知（截断、写入、改时间戳），
+ * PollChanges 只交出最近 kSettleTime 内没有再变化的文件，每个文件一次。
+ */
+class FileWatcher {
+public:
+    static constexpr std::chrono::milliseconds kSettleTime{ 200 };
+
+    FileWatcher() = default;
+    ~FileWatcher() { Stop(); }
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief 开始监视（不存在的目录跳过）
+     * @return 至少有一个目录在监视中时为 true
+     */
+    bool Start(const std::vector<std::string>& directories);
+    void Stop();
+    bool IsRunning() const { return m_Thread.joinable(); }
+
+    /** @brief 取出已稳定的变更（主线程每帧调用） */
+    std::vector<std::string> PollChanges();
+
+private:
+    struct Directory;
+
+    void WatchMain();
+
+    std::vector<Directory*> m_Directories;
+    void* m_StopEvent = nullptr;
+    std::thread m_Thread;
+
+    std::mutex m_Mutex;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_Pending;
+};
+
+} // namespace outer_wilds
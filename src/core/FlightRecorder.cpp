@@ -0,0 +1,360 @@
+#include "FlightRecorder.h"
+#include "DebugManager.h"
+#include "BenchmarkReport.h"
+#include "../physics/PhysXManager.h"
+#include "../physics/components/SectorComponent.h"
+#include "../gameplay/components/PlayerComponent.h"
+#include "../scene/AssetStreamer.h"
+#include <PxPhysicsAPI.h>
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace outer_wilds {
+
+namespace {
+    // 追踪文件里 "Frame" 事件所在的伪线程（与 Profiler 的线程下标错开）
+    constexpr uint32_t kFrameTrackTid = 1000;
+
+    void WriteJsonString(std::ofstream& out, const char* text) {
+        out << '"';
+        for (const char* c = text ? text : "?"; *c; ++c) {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+        out << '"';
+    }
+
+    const char* CameraModeName(CameraMode mode) {
+        switch (mode) {
+            case CameraMode::Player:     return "Player";
+            case CameraMode::Spacecraft: return "Spacecraft";
+            case CameraMode::Free:       return "Free";
+        }
+        return "?";
+    }
+
+    void WriteKeyList(std::ofstream& out, const uint8_t (&bits)[32]) {
+        out << '[';
+        bool first = true;
+        for (int key = 0; key < 256; key++) {
+            if ((bits[key >> 3] & (1u << (key & 7))) == 0) continue;
+            if (!first) out << ',';
+            first = false;
+            out << key;
+        }
+        out << ']';
+    }
+
+    std::string MakeDumpPath(const std::string& directory, uint64_t frameIndex, float spikeMs) {
+        char stamp[32] = "unknown";
+        const std::time_t now = std::time(nullptr);
+        std::tm local = {};
+        if (localtime_s(&local, &now) == 0) {
+            std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &local);
+        }
+        char name[96];
+        snprintf(name, sizeof(name), "spike_%s_f%llu_%dms.json", stamp,
+                 static_cast<unsigned long long>(frameIndex), static_cast<int>(spikeMs));
+        return directory.empty() ? std::string(name) : directory + "/" + name;
+    }
+}
+
+void FlightRecorder::Configure(const Settings& settings) {
+    const bool resize = settings.capacityFrames != m_Settings.capacityFrames;
+    m_Settings = settings;
+    if (resize) Reset();
+}
+
+void FlightRecorder::Reset() {
+    // 槽位在导出时被移走，重新分配时各自的节点 vector 从空开始按需增长
+    m_Frames.clear();
+    m_Frames.resize((std::max)(m_Settings.capacityFrames, 2u));
+    m_Head = 0;
+    m_Count = 0;
+    m_FramesSinceReset = 0;
+    m_FramesSincePercentile = 0;
+    m_Stats.percentileMs = 0.0f;
+}
+
+void FlightRecorder::RecordFrame(entt::registry& registry, float frameSeconds, const RenderStats* renderStats,
+                                 CameraMode cameraMode) {
+    CapturePhysicsStats(m_LatestPhysics);
+    if (!m_Settings.enabled) return;
+    if (m_Frames.empty()) Reset();
+
+    FrameRecord& record = m_Frames[m_Head];
+    record.frameIndex = m_FrameIndex++;
+    record.frameMs = frameSeconds * 1000.0f;
+    record.render = renderStats ? *renderStats : RenderStats{};
+    record.physics = m_LatestPhysics;
+    InputManager::GetInstance().CaptureFrameState(record.input);
+    record.camera = cameraMode;
+
+    record.sector = entt::null;
+    auto players = registry.view<PlayerComponent, components::InSectorComponent>();
+    for (auto entity : players) {
+        record.sector = players.get<components::InSectorComponent>(entity).sector;
+        break;
+    }
+
+    const Profiler::FrameData& profile = Profiler::GetInstance().GetLastFrame();
+    record.nodes.assign(profile.nodes.begin(), profile.nodes.end());
+
+    m_Head = (m_Head + 1) % m_Frames.size();
+    m_Count = (std::min)(m_Count + 1, m_Frames.size());
+    m_FramesSinceReset++;
+
+    if (m_Triggered) {
+        if (m_PostFramesLeft > 0) m_PostFramesLeft--;
+        if (m_PostFramesLeft == 0) BeginDump(registry);
+        return;
+    }
+    if (m_Writing || m_FramesSinceReset <= m_Settings.warmupFrames) return;
+
+    if (++m_FramesSincePercentile >= kPercentileInterval || m_Stats.percentileMs <= 0.0f) {
+        UpdatePercentile();
+    }
+
+    const float frameMs = record.frameMs;
+    const char* reason = nullptr;
+    if (m_Settings.thresholdMs > 0.0f && frameMs >= m_Settings.thresholdMs) {
+        reason = "threshold";
+    } else if (m_Settings.percentile > 0.0f && m_Stats.percentileMs > 0.0f &&
+               frameMs >= (std::max)(m_Settings.minSpikeMs, m_Stats.percentileMs * m_Settings.percentileMargin)) {
+        reason = "percentile";
+    }
+    if (!reason) return;
+
+    m_Stats.triggers++;
+    m_Stats.lastSpikeMs = frameMs;
+
+    const uint64_t now = Profiler::NowNs();
+    const uint64_t cooldownNs = static_cast<uint64_t>(m_Settings.cooldownSeconds * 1e9);
+    if (m_Stats.dumps + m_Stats.failedDumps >= m_Settings.maxDumps) return;
+    if (m_LastDumpNs != 0 && now - m_LastDumpNs < cooldownNs) return;
+
+    Trigger(frameMs, reason);
+    if (m_PostFramesLeft == 0) BeginDump(registry);
+}
+
+bool FlightRecorder::RequestDump(const char* reason) {
+    if (!m_Settings.enabled || m_Triggered || m_Writing || m_Count == 0) return false;
+    // 手动导出以最近记录的一帧为触发帧；post-trigger 帧在之后的 RecordFrame 里补齐
+    Trigger(m_Frames[(m_Head + m_Frames.size() - 1) % m_Frames.size()].frameMs, reason ? reason : "manual");
+    if (m_PostFramesLeft == 0) m_PostFramesLeft = 1;
+    return true;
+}
+
+void FlightRecorder::UpdatePercentile() {
+    m_FramesSincePercentile = 0;
+    if (m_Settings.percentile <= 0.0f || m_Count == 0) return;
+
+    m_PercentileScratch.clear();
+    for (size_t i = 0; i < m_Count; i++) {
+        m_PercentileScratch.push_back(m_Frames[i].frameMs);
+    }
+    const float fraction = (std::min)(m_Settings.percentile, 100.0f) / 100.0f;
+    const size_t rank = (std::min)(m_PercentileScratch.size() - 1,
+                                   static_cast<size_t>(fraction * static_cast<float>(m_PercentileScratch.size())));
+    std::nth_element(m_PercentileScratch.begin(), m_PercentileScratch.begin() + rank, m_PercentileScratch.end());
+    m_Stats.percentileMs = m_PercentileScratch[rank];
+}
+
+void FlightRecorder::Trigger(float frameMs, const std::string& reason) {
+    m_Triggered = true;
+    m_SpikeFrameIndex = m_FrameIndex - 1;
+    m_SpikeMs = frameMs;
+    m_SpikeReason = reason;
+    // 至少保留一半的缓冲给尖峰之前的帧
+    m_PostFramesLeft = (std::min)(m_Settings.postTriggerFrames, static_cast<uint32_t>(m_Frames.size() / 2));
+}
+
+void FlightRecorder::BeginDump(entt::registry& registry) {
+    m_Triggered = false;
+    m_LastDumpNs = Profiler::NowNs();
+
+    // 环形缓冲按时间顺序整体移入导出（移动 vector，不复制调用树）
+    auto dump = std::make_shared<Dump>();
+    dump->frames.reserve(m_Count);
+    dump->sectorNames.reserve(m_Count);
+    const size_t capacity = m_Frames.size();
+    const size_t oldest = (m_Head + capacity - m_Count) % capacity;
+    for (size_t i = 0; i < m_Count; i++) {
+        dump->frames.push_back(std::move(m_Frames[(oldest + i) % capacity]));
+    }
+    m_Head = 0;
+    m_Count = 0;
+    m_FramesSinceReset = 0;
+    m_FramesSincePercentile = 0;
+    m_Stats.percentileMs = 0.0f;
+
+    // 扇区名在主线程解析（相邻帧通常在同一扇区，只在变化时查 registry）
+    entt::entity lastSector = entt::null;
+    std::string lastName = "none";
+    for (size_t i = 0; i < dump->frames.size(); i++) {
+        const FrameRecord& frame = dump->frames[i];
+        if (frame.sector != lastSector) {
+            lastSector = frame.sector;
+            const auto* sector = registry.valid(frame.sector)
+                ? registry.try_get<components::SectorComponent>(frame.sector) : nullptr;
+            lastName = sector ? sector->name : std::string(frame.sector == entt::null ? "none" : "?");
+        }
+        dump->sectorNames.push_back(lastName);
+        if (frame.frameIndex == m_SpikeFrameIndex) dump->spikeFrame = i;
+    }
+    dump->spikeMs = m_SpikeMs;
+    dump->reason = m_SpikeReason;
+    dump->path = MakeDumpPath(m_Settings.directory, m_SpikeFrameIndex, m_SpikeMs);
+
+    m_Writing = true;
+    AssetStreamer::GetInstance().Submit([this, dump]() -> AssetStreamer::ApplyFn {
+        const bool ok = WriteDump(*dump);
+        const std::string path = dump->path;
+        const size_t frames = dump->frames.size();
+        const float spikeMs = dump->spikeMs;
+        return [this, ok, path, frames, spikeMs](entt::registry&) {
+            m_Writing = false;
+            if (!ok) {
+                m_Stats.failedDumps++;
+                DebugManager::GetInstance().Log("FlightRecorder", "Failed to write trace: " + path);
+                return;
+            }
+            m_Stats.dumps++;
+            m_Stats.lastDumpPath = path;
+            DebugManager::GetInstance().Log("FlightRecorder", "Frame spike " + std::to_string(spikeMs) + " ms, wrote " +
+                                            std::to_string(frames) + " frames to " + path);
+        };
+    });
+}
+
+void FlightRecorder::CapturePhysicsStats(PhysicsStats& out) {
+    out = {};
+    auto& physx = PhysXManager::GetInstance();
+    if (physx.IsSimulating()) return;   // 模拟进行中不允许读统计
+
+    auto add = [&out](physx::PxScene* scene) {
+        if (!scene) return;
+        physx::PxSimulationStatistics stats;
+        scene->getSimulationStatistics(stats);
+        out.scenes++;
+        out.activeDynamicBodies += stats.nbActiveDynamicBodies;
+        out.activeKinematicBodies += stats.nbActiveKinematicBodies;
+        out.staticBodies += stats.nbStaticBodies;
+        out.dynamicBodies += stats.nbDynamicBodies;
+        out.kinematicBodies += stats.nbKinematicBodies;
+        out.activeConstraints += stats.nbActiveConstraints;
+        out.axisSolverConstraints += stats.nbAxisSolverConstraints;
+        out.contactPairs += stats.nbDiscreteContactPairsTotal;
+        out.newPairs += stats.nbNewPairs;
+        out.lostPairs += stats.nbLostPairs;
+        out.newTouches += stats.nbNewTouches;
+        out.lostTouches += stats.nbLostTouches;
+        out.partitions += stats.nbPartitions;
+        out.broadPhaseAdds += stats.getNbBroadPhaseAdds();
+        out.broadPhaseRemoves += stats.getNbBroadPhaseRemoves();
+    };
+
+    const auto& stepped = physx.GetSteppedScenes();
+    if (stepped.empty()) {
+        add(physx.GetScene());
+    } else {
+        for (physx::PxScene* scene : stepped) add(scene);
+    }
+}
+
+bool FlightRecorder::WriteDump(const Dump& dump) {
+    const std::filesystem::path target(dump.path);
+    std::error_code error;
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), error);
+    }
+
+    std::ofstream out(target, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out << std::fixed << std::setprecision(3);
+
+    const FrameRecord* spike = dump.frames.empty() ? nullptr : &dump.frames[dump.spikeFrame];
+    out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"reason\":";
+    WriteJsonString(out, dump.reason.c_str());
+    out << ",\"spikeMs\":" << dump.spikeMs << ",\"frames\":" << dump.frames.size();
+    if (spike) {
+        out << ",\"spikeFrame\":" << spike->frameIndex << ",\"sector\":";
+        WriteJsonString(out, dump.sectorNames[dump.spikeFrame].c_str());
+        out << ",\"camera\":\"" << CameraModeName(spike->camera) << '"';
+    }
+    out << "},\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Flight recorder\"}},\n";
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Main\"}},\n";
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << kFrameTrackTid
+        << ",\"args\":{\"name\":\"Frames\"}}";
+
+    // 帧首尾相接排布：第 i 帧从前面所有帧的墙钟时间之和开始（µs）
+    double frameStartUs = 0.0;
+    for (size_t i = 0; i < dump.frames.size(); i++) {
+        const FrameRecord& frame = dump.frames[i];
+        const double frameUs = static_cast<double>(frame.frameMs) * 1000.0;
+
+        out << ",\n{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":" << kFrameTrackTid
+            << ",\"ts\":" << frameStartUs << ",\"dur\":" << frameUs
+            << ",\"args\":{\"frame\":" << frame.frameIndex << ",\"ms\":" << frame.frameMs << ",\"sector\":";
+        WriteJsonString(out, dump.sectorNames[i].c_str());
+        out << ",\"camera\":\"" << CameraModeName(frame.camera) << "\",\"held\":";
+        WriteKeyList(out, frame.input.keys);
+        out << ",\"pressed\":";
+        WriteKeyList(out, frame.input.pressed);
+        out << ",\"mouse\":[" << frame.input.mouseDeltaX << ',' << frame.input.mouseDeltaY << "]}}";
+
+        if (i == dump.spikeFrame) {
+            out << ",\n{\"name\":\"Spike\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":" << kFrameTrackTid
+                << ",\"ts\":" << frameStartUs << ",\"args\":{\"ms\":" << frame.frameMs << ",\"reason\":";
+            WriteJsonString(out, dump.reason.c_str());
+            out << "}}";
+        }
+
+        for (const Profiler::FrameNode& node : frame.nodes) {
+            out << ",\n{\"name\":";
+            WriteJsonString(out, node.name);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << node.threadIndex
+                << ",\"ts\":" << frameStartUs + static_cast<double>(node.startNs) / 1000.0
+                << ",\"dur\":" << static_cast<double>(node.durationNs) / 1000.0 << "}";
+        }
+
+        out << ",\n{\"name\":\"FrameMs\",\"ph\":\"C\",\"pid\":1,\"ts\":" << frameStartUs
+            << ",\"args\":{\"ms\":" << frame.frameMs << "}}";
+
+        uint32_t render[BenchmarkReport::kRenderStatCount];
+        BenchmarkReport::GatherRenderStats(frame.render, render);
+        out << ",\n{\"name\":\"RenderStats\",\"ph\":\"C\",\"pid\":1,\"ts\":" << frameStartUs << ",\"args\":{";
+        for (int stat = 0; stat < BenchmarkReport::kRenderStatCount; stat++) {
+            out << (stat ? "," : "") << '"' << BenchmarkReport::GetRenderStatName(stat) << "\":" << render[stat];
+        }
+        out << "}}";
+
+        const PhysicsStats& physics = frame.physics;
+        out << ",\n{\"name\":\"PhysX\",\"ph\":\"C\",\"pid\":1,\"ts\":" << frameStartUs
+            << ",\"args\":{\"scenes\":" << physics.scenes
+            << ",\"activeDynamicBodies\":" << physics.activeDynamicBodies
+            << ",\"activeKinematicBodies\":" << physics.activeKinematicBodies
+            << ",\"activeConstraints\":" << physics.activeConstraints
+            << ",\"contactPairs\":" << physics.contactPairs
+            << ",\"newPairs\":" << physics.newPairs << ",\"lostPairs\":" << physics.lostPairs
+            << ",\"newTouches\":" << physics.newTouches << ",\"lostTouches\":" << physics.lostTouches
+            << ",\"partitions\":" << physics.partitions << "}}";
+
+        frameStartUs += frameUs;
+    }
+    out << "\n]}\n";
+    return out.good();
+}
+
+FlightRecorder::Stats FlightRecorder::GetStats() const {
+    Stats stats = m_Stats;
+    stats.recordedFrames = static_cast<uint32_t>(m_Count);
+    stats.dumpPending = m_Triggered || m_Writing;
+    return stats;
+}
+
+} // namespace outer_wilds
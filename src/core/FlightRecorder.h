@@ -0,0 +1,170 @@
+/**
+ * FlightRecorder.h
+ *
+ * 卡顿飞行记录仪：常驻的最近若干秒帧数据环形缓冲，出现尖峰帧时自动导出追踪文件
+ *
+ * - 每帧记录：墙钟帧时间、Profiler 上一帧的调用树（所有线程）、RenderStats、
+ *   PhysX 模拟统计（主场景 + 本步模拟的扇区场景求和）、输入快照，以及玩家所在扇区和相机模式
+ * - 触发：帧时间超过绝对阈值，或超过滚动百分位（默认 p99）× 余量且不低于最小尖峰时间；
+ *   触发后再记录 postTriggerFrames 帧（看清尖峰之后的恢复），然后导出整个环形缓冲
+ * - 导出：环形缓冲整体移交给 AssetStreamer 的加载线程（主线程只移动槽位、不复制调用树，并解析扇区名），
+ *   加载线程写出 Chrome trace JSON（chrome://tracing / Perfetto）：
+ *   每帧一个 "Frame" 事件（args 带扇区 / 相机 / 输入），Profiler 作用域按线程排布，
+ *   RenderStats / PhysX 统计 / 帧时间为计数器轨道，尖峰帧处一个全局瞬时事件
+ * - 开销：每帧复制一次调用树节点（槽位的 vector 复用容量，稳态不分配）和几百字节的统计，
+ *   百分位每 kPercentileInterval 帧用 nth_element 更新一次；导出后有冷却时间和每次运行的次数上限
+ *
+ * 未定义 OW_PROFILER（OW_ENABLE_PROFILER=OFF）时调用树为空，其余数据照常记录和导出。
+ * Engine::Update 在帧开头（PhysX 访问窗口内）调用 RecordFrame：此时 Profiler 的上一帧、
+ * TimeManager 的墙钟 delta 和 RenderStats 都属于同一帧。所有接口只在主线程上使用。
+ */
+
+#pragma once
+#include "Profiler.h"
+#include "../graphics/CameraMode.h"
+#include "../graphics/RenderQueue.h"
+#include "../input/InputManager.h"
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace outer_wilds {
+
+class FlightRecorder {
+public:
+    struct Settings {
+        bool enabled = true;
+        uint32_t capacityFrames = 600;      // 环形缓冲帧数（60 FPS 下约 10 秒）
+        float thresholdMs = 50.0f;          // 绝对阈值；0 = 关闭
+        float percentile = 99.0f;           // 滚动百分位触发；0 = 关闭
+        float percentileMargin = 1.5f;      // 超过百分位的倍数才算尖峰
+        float minSpikeMs = 8.0f;            // 百分位触发的下限（避免 2 ms 的帧在 1 ms 的 p99 前被当作尖峰）
+        uint32_t warmupFrames = 120;        // 启动 / 导出后积累这么多帧才开始判断（加载帧不触发）
+        uint32_t postTriggerFrames = 30;
+        float cooldownSeconds = 10.0f;      // 两次导出之间的最短间隔（墙钟）
+        uint32_t maxDumps = 20;             // 每次运行最多导出的文件数
+        std::string directory = "traces";
+    };
+
+    /** @brief 所有场景 PxSimulationStatistics 的求和（主场景 + 本步模拟的扇区场景） */
+    struct PhysicsStats {
+        uint32_t scenes = 0;
+        uint32_t activeDynamicBodies = 0;
+        uint32_t activeKinematicBodies = 0;
+        uint32_t staticBodies = 0;
+        uint32_t dynamicBodies = 0;
+        uint32_t kinematicBodies = 0;
+        uint32_t activeConstraints = 0;
+        uint32_t axisSolverConstraints = 0;
+        uint32_t contactPairs = 0;          // nbDiscreteContactPairsTotal
+        uint32_t newPairs = 0;
+        uint32_t lostPairs = 0;
+        uint32_t newTouches = 0;
+        uint32_t lostTouches = 0;
+        uint32_t partitions = 0;
+        uint32_t broadPhaseAdds = 0;
+        uint32_t broadPhaseRemoves = 0;
+    };
+
+    struct Stats {
+        uint32_t recordedFrames = 0;        // 环形缓冲中的帧数
+        float percentileMs = 0.0f;          // 最近一次更新的滚动百分位
+        float lastSpikeMs = 0.0f;
+        uint32_t triggers = 0;              // 超过阈值的帧数（含冷却期内被忽略的）
+        uint32_t dumps = 0;                 // 已写出的文件数
+        uint32_t failedDumps = 0;
+        bool dumpPending = false;           // 触发后等待 post-trigger 帧或写文件中
+        std::string lastDumpPath;
+    };
+
+    static FlightRecorder& GetInstance() {
+        static FlightRecorder instance;
+        return instance;
+    }
+
+    /** @brief 修改设置（容量变化时清空环形缓冲） */
+    void Configure(const Settings& settings);
+    const Settings& GetSettings() const { return m_Settings; }
+
+    /**
+     * @brief 记录上一帧（主线程，帧开头 PhysX 访问窗口内）
+     * @param frameSeconds 上一帧的墙钟时间（TimeManager::GetRealDeltaTime）
+     * @param renderStats 上一帧的渲染统计（可为 nullptr）
+     */
+    void RecordFrame(entt::registry& registry, float frameSeconds, const RenderStats* renderStats,
+                     CameraMode cameraMode);
+
+    /** @brief 手动导出（忽略冷却和次数上限，仍等 post-trigger 帧；已有导出挂起时返回 false） */
+    bool RequestDump(const char* reason = "manual");
+
+    Stats GetStats() const;
+
+    /**
+     * @brief 读取 PhysX 统计（模拟进行中返回全零：PhysX 不允许在 simulate 期间读统计）
+     *
+     * 只能在 PhysX 访问窗口内调用（FinishStep 之后、BeginStep 之前）
+     */
+    static void CapturePhysicsStats(PhysicsStats& out);
+
+    /** @brief 最近一次 RecordFrame 在访问窗口内取得的 PhysX 统计（记录仪关闭时也照常更新） */
+    const PhysicsStats& GetLatestPhysicsStats() const { return m_LatestPhysics; }
+
+private:
+    FlightRecorder() = default;
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    static constexpr uint32_t kPercentileInterval = 60;
+
+    struct FrameRecord {
+        uint64_t frameIndex = 0;            // 记录仪自己的帧号（Profiler 编译关闭时也连续）
+        float frameMs = 0.0f;
+        RenderStats render = {};
+        PhysicsStats physics;
+        InputFrameState input = {};
+        entt::entity sector = entt::null;   // 名称在导出时解析（扇区实体可能在之后销毁）
+        CameraMode camera = CameraMode::Player;
+        std::vector<Profiler::FrameNode> nodes;
+    };
+
+    /** @brief 交给加载线程写出的一次导出 */
+    struct Dump {
+        std::vector<FrameRecord> frames;            // 按时间顺序
+        std::vector<std::string> sectorNames;       // 与 frames 一一对应
+        size_t spikeFrame = 0;                      // 触发帧在 frames 中的下标
+        float spikeMs = 0.0f;
+        std::string reason;
+        std::string path;
+    };
+
+    void Reset();
+    void UpdatePercentile();
+    void Trigger(float frameMs, const std::string& reason);
+    void BeginDump(entt::registry& registry);
+    static bool WriteDump(const Dump& dump);
+
+    Settings m_Settings;
+    PhysicsStats m_LatestPhysics;
+    std::vector<FrameRecord> m_Frames;      // 环形缓冲（capacityFrames 个槽位）
+    size_t m_Head = 0;                      // 下一次写入的槽位
+    size_t m_Count = 0;
+    uint64_t m_FrameIndex = 0;
+    uint32_t m_FramesSinceReset = 0;
+
+    std::vector<float> m_PercentileScratch;
+    uint32_t m_FramesSincePercentile = 0;
+
+    bool m_Triggered = false;
+    bool m_Writing = false;
+    uint32_t m_PostFramesLeft = 0;
+    uint64_t m_SpikeFrameIndex = 0;
+    float m_SpikeMs = 0.0f;
+    std::string m_SpikeReason;
+    uint64_t m_LastDumpNs = 0;
+
+    Stats m_Stats;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,125 @@
+#include "FrameAllocator.h"
+#include <algorithm>
+
+namespace outer_wilds {
+
+namespace {
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+
+    // 当前块放得下就直接移动偏移
+    while (m_Current < m_Blocks.size()) {
+        Block& block = m_Blocks[m_Current];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+        const size_t start = AlignUp(base + m_Offset, alignment) - base;
+        if (start + size <= block.size) {
+            m_Used += start + size - m_Offset;
+            m_Offset = start + size;
+            return block.memory.get() + start;
+        }
+        // Reset 后保留的后续块（或者上一块剩余不够）：换到下一块
+        m_Current++;
+        m_Offset = 0;
+    }
+
+    Block block;
+    block.size = std::max(m_BlockSize, size + alignment);
+    block.memory.reset(new unsigned char[block.size]);
+    m_Capacity += block.size;
+    m_Blocks.push_back(std::move(block));
+    m_Current = m_Blocks.size() - 1;
+    m_Offset = 0;
+    return Allocate(size, alignment);
+}
+
+void FrameArena::Reset() {
+    m_Peak = std::max(m_Peak, m_Used);
+    if (m_Blocks.size() > 1) {
+        // 上一轮溢出到多个块：合并成一块，下一轮正常情况下只用一块
+        const size_t merged = std::max(m_Capacity, m_BlockSize);
+        m_Blocks.clear();
+        Block block;
+        block.size = merged;
+        block.memory.reset(new unsigned char[merged]);
+        m_Blocks.push_back(std::move(block));
+        m_Capacity = merged;
+    }
+    m_Current = 0;
+    m_Offset = 0;
+    m_Used = 0;
+}
+
+FrameAllocator::ThreadArenas& FrameAllocator::GetThreadArenas() {
+    // 线程退出时注销并释放它的 arena
+    struct Registration {
+        FrameAllocator* owner = nullptr;
+        ThreadArenas* arenas = nullptr;
+        ~Registration() {
+            if (!owner) return;
+            std::lock_guard<std::mutex> lock(owner->m_Mutex);
+            auto& threads = owner->m_Threads;
+            threads.erase(std::remove_if(threads.begin(), threads.end(),
+                                         [this](const auto& entry) { return entry.get() == arenas; }),
+                          threads.end());
+        }
+    };
+    thread_local Registration t_Registration;
+    if (!t_Registration.arenas) {
+        auto arenas = std::make_unique<ThreadArenas>();
+        t_Registration.owner = this;
+        t_Registration.arenas = arenas.get();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Threads.push_back(std::move(arenas));
+    }
+    return *t_Registration.arenas;
+}
+
+FrameArena& FrameAllocator::GetThreadArena() {
+    ThreadArenas& thread = GetThreadArenas();
+    const uint64_t frame = m_Frame.load(std::memory_order_acquire);
+    const size_t slot = static_cast<size_t>(frame & 1);
+    if (thread.frames[slot] != frame) {
+        // 本线程在新一帧的第一次分配：回收两帧之前的内存
+        thread.arenas[slot].Reset();
+        thread.frames[slot] = frame;
+        thread.lastFrame.store(frame, std::memory_order_relaxed);
+    }
+    return thread.arenas[slot];
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment) {
+    FrameArena& arena = GetThreadArena();
+    void* memory = arena.Allocate(size, alignment);
+
+    ThreadArenas& thread = GetThreadArenas();
+    thread.usedBytes.store(arena.GetUsedBytes(), std::memory_order_relaxed);
+    thread.peakBytes.store(std::max(thread.arenas[0].GetPeakBytes(), thread.arenas[1].GetPeakBytes()),
+                           std::memory_order_relaxed);
+    thread.capacity.store(thread.arenas[0].GetCapacity() + thread.arenas[1].GetCapacity(), std::memory_order_relaxed);
+    return memory;
+}
+
+FrameAllocator::Stats FrameAllocator::GetStats() const {
+    Stats stats;
+    const uint64_t frame = m_Frame.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const auto& thread : m_Threads) {
+        // 本帧还没分配过的线程，usedBytes 是之前某一帧的
+        if (thread->lastFrame.load(std::memory_order_relaxed) == frame) {
+            stats.usedBytes += thread->usedBytes.load(std::memory_order_relaxed);
+        }
+        stats.peakBytes += thread->peakBytes.load(std::memory_order_relaxed);
+        stats.capacity += thread->capacity.load(std::memory_order_relaxed);
+    }
+    stats.threads = static_cast<uint32_t>(m_Threads.size());
+    return stats;
+}
+
+} // namespace outer_wilds
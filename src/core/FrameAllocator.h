@@ -0,0 +1,173 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 线性（bump）分配器：Allocate 只移动指针，Reset 一次性回收全部
+ *
+ * 内存按块申请；一块放不下时追加新块（超过块大小的请求单独一块）。
+ * Reset 时若本轮用了多个块，合并成一块总大小的块，之后的帧不再追加。
+ * 不是线程安全的：每个线程使用自己的 FrameArena（见 FrameAllocator）。
+ */
+class FrameArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 256 * 1024;
+
+    explicit FrameArena(size_t blockSize = kDefaultBlockSize) : m_BlockSize(blockSize) {}
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    void Reset();
+
+    /** @brief 本轮（上次 Reset 之后）分配的字节数（含对齐填充） */
+    size_t GetUsedBytes() const { return m_Used; }
+    /** @brief 所有块的总大小 */
+    size_t GetCapacity() const { return m_Capacity; }
+    /** @brief 历次 Reset 之前的最大用量 */
+    size_t GetPeakBytes() const { return m_Peak > m_Used ? m_Peak : m_Used; }
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> memory;
+        size_t size = 0;
+    };
+
+    size_t m_BlockSize;
+    std::vector<Block> m_Blocks;
+    size_t m_Current = 0;       // 当前块下标
+    size_t m_Offset = 0;        // 当前块内偏移
+    size_t m_Used = 0;
+    size_t m_Capacity = 0;
+    size_t m_Peak = 0;
+};
+
+/**
+ * @brief 双缓冲的每帧分配器（每个线程一对 FrameArena）
+ *
+ * - Allocate 使用调用线程自己的 arena，无锁、无竞争；并行收集 / ParallelFor 的各个工作线程自动各用各的
+ * - 双缓冲：第 N 帧分配的内存在第 N+1 帧结束前有效（arena[N & 1]），可以把结果交给下一帧读
+ * - Engine::Update 末尾调用 EndFrame 推进帧号；每个线程在新一帧第一次分配时自己重置对应的 arena，
+ *   主线程从不触碰其他线程的 arena
+ *
+ * 只用于帧内同步完成的代码：跨帧运行的作业（TrajectoryPredictor 的积分、AssetStreamer 加载线程）
+ * 会在帧号推进后重置自己仍在使用的内存，不能使用。
+ */
+class FrameAllocator {
+public:
+    struct Stats {
+        size_t usedBytes = 0;       // 当前帧所有线程已分配
+        size_t peakBytes = 0;       // 单个 arena 一帧内的最大用量之和
+        size_t capacity = 0;        // 所有 arena 的总容量
+        uint32_t threads = 0;
+    };
+
+    static FrameAllocator& GetInstance() {
+        static FrameAllocator instance;
+        return instance;
+    }
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /** @brief 调用线程当前帧的 arena */
+    FrameArena& GetThreadArena();
+
+    /** @brief 帧结束（Engine::Update 末尾，本帧的作业都已完成） */
+    void EndFrame() { m_Frame.fetch_add(1, std::memory_order_release); }
+    uint64_t GetFrameIndex() const { return m_Frame.load(std::memory_order_acquire); }
+
+    Stats GetStats() const;
+
+private:
+    struct ThreadArenas {
+        FrameArena arenas[2];
+        uint64_t frames[2] = { ~0ull, ~0ull };      // 每个 arena 最近一次重置时的帧号
+        std::atomic<size_t> usedBytes{ 0 };         // 统计用（其他线程读取）
+        std::atomic<size_t> peakBytes{ 0 };
+        std::atomic<size_t> capacity{ 0 };
+        std::atomic<uint64_t> lastFrame{ 0 };
+    };
+
+    FrameAllocator() = default;
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    ThreadArenas& GetThreadArenas();
+
+    std::atomic<uint64_t> m_Frame{ 0 };
+    mutable std::mutex m_Mutex;                               // 保护 m_Threads 的登记
+    std::vector<std::unique_ptr<ThreadArenas>> m_Threads;     // 线程退出时注销
+};
+
+/**
+ * @brief 从 FrameAllocator 分配的 STL 分配器（deallocate 为空操作，内存随帧回收）
+ *
+ * 容器增长时旧缓冲区留在 arena 里直到帧回收：能预估大小时先 reserve。
+ */
+template <typename T>
+class FrameStlAllocator {
+public:
+    using value_type = T;
+
+    FrameStlAllocator() noexcept = default;
+    template <typename U>
+    FrameStlAllocator(const FrameStlAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(FrameAllocator::GetInstance().Allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const FrameStlAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const FrameStlAllocator<U>&) const noexcept { return false; }
+};
+
+/**
+ * @brief 绑定到指定 FrameArena 的 STL 分配器（调用方管理 arena 的生命周期和重置时机）
+ */
+template <typename T>
+class ArenaStlAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaStlAllocator(FrameArena& arena) noexcept : m_Arena(&arena) {}
+    template <typename U>
+    ArenaStlAllocator(const ArenaStlAllocator<U>& other) noexcept : m_Arena(other.GetArena()) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(m_Arena->Allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) noexcept {}
+
+    FrameArena* GetArena() const noexcept { return m_Arena; }
+
+    template <typename U>
+    bool operator==(const ArenaStlAllocator<U>& other) const noexcept { return m_Arena == other.GetArena(); }
+    template <typename U>
+    bool operator!=(const ArenaStlAllocator<U>& other) const noexcept { return m_Arena != other.GetArena(); }
+
+private:
+    FrameArena* m_Arena;
+};
+
+// 帧内临时容器
+template <typename T>
+using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+using FrameUnorderedMap = std::unordered_map<K, V, Hash, Eq, FrameStlAllocator<std::pair<const K, V>>>;
+
+template <typename K, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+using FrameUnorderedSet = std::unordered_set<K, Hash, Eq, FrameStlAllocator<K>>;
+
+} // namespace outer_wilds
@@ -0,0 +1,185 @@
+#include "JobSystem.h"
+#include "DebugManager.h"
+#include <algorithm>
+#include <chrono>
+
+namespace outer_wilds {
+
+namespace {
+    thread_local uint32_t t_ThreadIndex = 0;
+    constexpr auto kIdleWait = std::chrono::milliseconds(2);
+}
+
+uint32_t JobSystem::GetCurrentThreadIndex() {
+    return t_ThreadIndex;
+}
+
+bool JobSystem::Initialize(uint32_t workerCount) {
+    if (m_Initialized) return true;
+
+    if (workerCount == 0) {
+        const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_Queues.clear();
+    for (uint32_t i = 0; i <= workerCount; i++) {
+        m_Queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_Running = true;
+    t_ThreadIndex = 0;
+    m_Workers.reserve(workerCount);
+    for (uint32_t i = 1; i <= workerCount; i++) {
+        m_Workers.emplace_back(&JobSystem::WorkerMain, this, i);
+    }
+
+    m_Initialized = true;
+    DebugManager::GetInstance().Log("JobSystem", "Started " + std::to_string(workerCount) + " worker threads");
+    return true;
+}
+
+void JobSystem::Shutdown() {
+    if (!m_Initialized) return;
+
+    // 先把剩余作业做完，保证所有计数器归零
+    while (ExecuteOne(0)) {}
+
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Running = false;
+    }
+    m_WakeCondition.notify_all();
+    for (auto& worker : m_Workers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_Workers.clear();
+    m_Queues.clear();
+    m_Initialized = false;
+}
+
+void JobSystem::Run(std::function<void()> task, JobCounter* counter, JobCounter* dependency) {
+    if (counter) {
+        counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (!m_Initialized) {
+        // 没有工作线程：依赖在单线程下必然已先完成
+        task();
+        Complete(counter);
+        return;
+    }
+
+    if (dependency && !dependency->IsDone()) {
+        std::unique_lock<std::mutex> lock(dependency->m_Mutex);
+        // 持锁后再检查：Complete 在同一把锁下取走续作业，不会漏掉
+        if (!dependency->IsDone()) {
+            dependency->m_Continuations.push_back(std::move(task));
+            dependency->m_ContinuationCounters.push_back(counter);
+            return;
+        }
+    }
+
+    Enqueue({ std::move(task), counter });
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    const uint32_t threadIndex = t_ThreadIndex;
+    while (!counter.IsDone()) {
+        if (!ExecuteOne(threadIndex)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::ExecutePending() {
+    return m_Initialized && ExecuteOne(t_ThreadIndex);
+}
+
+void JobSystem::Enqueue(Job job) {
+    const uint32_t queueIndex = t_ThreadIndex < m_Queues.size() ? t_ThreadIndex : 0;
+    {
+        WorkQueue& queue = *m_Queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    m_QueuedJobs.fetch_add(1, std::memory_order_release);
+    m_WakeCondition.notify_one();
+}
+
+bool JobSystem::TryPop(uint32_t queueIndex, Job& job) {
+    WorkQueue& queue = *m_Queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::TrySteal(uint32_t thiefIndex, Job& job) {
+    const uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+    for (uint32_t offset = 1; offset < queueCount; offset++) {
+        WorkQueue& queue = *m_Queues[(thiefIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::ExecuteOne(uint32_t threadIndex) {
+    if (m_Queues.empty() || m_QueuedJobs.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    Job job;
+    if (!TryPop(threadIndex, job) && !TrySteal(threadIndex, job)) {
+        return false;
+    }
+    m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+    job.task();
+    Complete(job.counter);
+    return true;
+}
+
+/**
+ * @brief 递减计数器；归零时把等待它的作业放入队列
+ */
+void JobSystem::Complete(JobCounter* counter) {
+    if (!counter) return;
+    if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    std::vector<std::function<void()>> continuations;
+    std::vector<JobCounter*> continuationCounters;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        continuations.swap(counter->m_Continuations);
+        continuationCounters.swap(counter->m_ContinuationCounters);
+    }
+    for (size_t i = 0; i < continuations.size(); i++) {
+        if (m_Initialized) {
+            Enqueue({ std::move(continuations[i]), continuationCounters[i] });
+        } else {
+            continuations[i]();
+            Complete(continuationCounters[i]);
+        }
+    }
+}
+
+void JobSystem::WorkerMain(uint32_t threadIndex) {
+    t_ThreadIndex = threadIndex;
+    while (m_Running.load(std::memory_order_relaxed)) {
+        if (ExecuteOne(threadIndex)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_WakeCondition.wait_for(lock, kIdleWait, [this]() {
+            return !m_Running.load(std::memory_order_relaxed) || m_QueuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+} // namespace outer_wilds
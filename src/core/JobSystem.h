@@ -0,0 +1,172 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace outer_wilds {
+
+class JobSystem;
+
+/**
+ * @brief 作业计数器：Run 时 +1，作业完成时 -1；归零时释放依赖它的作业
+ *
+ * 可反复使用（归零后再次 Run 即重新计数）。Wait 期间调用线程会帮忙执行作业，不会空等。
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_Pending{ 0 };
+    std::mutex m_Mutex;
+    std::vector<std::function<void()>> m_Continuations;   // 等待本计数器归零的作业
+    std::vector<JobCounter*> m_ContinuationCounters;
+};
+
+/**
+ * @brief 引擎全局的工作窃取作业系统
+ *
+ * 每个线程（主线程为 0 号，工作线程 1..N）一个双端队列：本线程从尾部取（LIFO，缓存友好），
+ * 空闲线程从其他队列头部窃取（FIFO，先偷大块）。非作业线程提交的作业进入 0 号队列。
+ * 队列用各自的互斥量保护，竞争只发生在窃取时。
+ *
+ * 工作线程数默认 hardware_concurrency - 1（主线程也参与 Wait）。
+ * PhysX 任务通过 PhysXJobDispatcher 跑在同一组工作线程上。
+ *
+ * @code
+ * JobCounter counter;
+ * jobs.Run([]{ ... }, &counter);
+ * jobs.Run([]{ ... }, nullptr, &counter);   // counter 归零后才开始
+ * jobs.Wait(counter);
+ * @endcode
+ */
+class JobSystem {
+public:
+    static JobSystem& GetInstance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    /**
+     * @param workerCount 工作线程数；0 = hardware_concurrency - 1（至少 1）
+     */
+    bool Initialize(uint32_t workerCount = 0);
+    void Shutdown();
+    bool IsInitialized() const { return m_Initialized; }
+
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    /**
+     * @brief 当前线程的队列索引（0 = 主线程/非作业线程）
+     */
+    static uint32_t GetCurrentThreadIndex();
+
+    /**
+     * @brief 提交作业
+     * @param counter 可选：完成时递减
+     * @param dependency 可选：该计数器归零后才进入队列
+     *
+     * 未初始化时在调用线程上立即执行。
+     */
+    void Run(std::function<void()> task, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+    /**
+     * @brief 等待计数器归零（期间执行队列中的作业）
+     */
+    void Wait(JobCounter& counter);
+
+    /**
+     * @brief 在调用线程上执行一个排队的作业（自己的队列优先，其次窃取）
+     * @return 没有可执行的作业时返回 false
+     */
+    bool ExecutePending();
+
+    /**
+     * @brief 把 [0, count) 拆成大小为 grainSize 的块并行执行 body(begin, end)，返回时全部完成
+     */
+    template<typename Body>
+    void ParallelFor(uint32_t count, uint32_t grainSize, Body&& body) {
+        if (count == 0) return;
+        if (grainSize == 0) grainSize = 1;
+        if (!m_Initialized || count <= grainSize) {
+            body(0u, count);
+            return;
+        }
+
+        JobCounter counter;
+        for (uint32_t begin = grainSize; begin < count; begin += grainSize) {
+            const uint32_t end = (count - begin) > grainSize ? begin + grainSize : count;
+            Run([&body, begin, end]() { body(begin, end); }, &counter);
+        }
+        body(0u, grainSize);   // 第一块在调用线程上执行
+        Wait(counter);
+    }
+
+    /**
+     * @brief 并行遍历 EnTT 视图（或任何可迭代的实体集合）：fn(entity)
+     *
+     * 先把实体拷贝到连续数组再切块，遍历期间不得向视图涉及的组件存储添加/删除组件；
+     * 修改已有组件的值是安全的（每个实体只被一个线程访问）。
+     */
+    template<typename View, typename Fn>
+    void ParallelForEach(const View& view, uint32_t grainSize, Fn&& fn) {
+        using Entity = typename View::entity_type;
+        std::vector<Entity> entities;
+        entities.reserve(view.size_hint());
+        for (auto entity : view) {
+            entities.push_back(entity);
+        }
+        ParallelFor(static_cast<uint32_t>(entities.size()), grainSize,
+            [&entities, &fn](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; i++) {
+                    fn(entities[i]);
+                }
+            });
+    }
+
+private:
+    struct Job {
+        std::function<void()> task;
+        JobCounter* counter = nullptr;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    JobSystem() = default;
+    ~JobSystem() { Shutdown(); }
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void Enqueue(Job job);
+    bool TryPop(uint32_t queueIndex, Job& job);
+    bool TrySteal(uint32_t thiefIndex, Job& job);
+    bool ExecuteOne(uint32_t threadIndex);
+    void Complete(JobCounter* counter);
+    void WorkerMain(uint32_t threadIndex);
+
+    bool m_Initialized = false;
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;   // [0] = 主线程
+    std::vector<std::thread> m_Workers;
+    std::atomic<bool> m_Running{ false };
+    std::atomic<uint32_t> m_QueuedJobs{ 0 };
+
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+};
+
+} // namespace outer_wilds
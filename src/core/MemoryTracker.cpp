@@ -0,0 +1,232 @@
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace outer_wilds {
+
+namespace {
+
+constexpr size_t kCategoryCount = static_cast<size_t>(MemoryCategory::Count);
+constexpr size_t kGpuKindCount = static_cast<size_t>(GpuMemoryKind::Count);
+
+// 常量初始化：静态构造期间的 operator new 也能安全计数
+std::atomic<int64_t> g_CpuBytes[kCategoryCount] = {};
+std::atomic<int64_t> g_CpuAllocations[kCategoryCount] = {};
+std::atomic<int64_t> g_GpuBytes[kGpuKindCount] = {};
+std::atomic<int64_t> g_GpuResources[kGpuKindCount] = {};
+thread_local MemoryCategory t_Category = MemoryCategory::General;
+
+} // namespace
+
+int64_t MemoryTracker::Snapshot::TotalCpuBytes() const {
+    int64_t total = 0;
+    for (const auto& stats : cpu) total += stats.bytes;
+    return total;
+}
+
+int64_t MemoryTracker::Snapshot::TotalGpuBytes() const {
+    int64_t total = 0;
+    for (const auto& stats : gpu) total += stats.bytes;
+    return total;
+}
+
+void MemoryTracker::PeakTracker::Sample(const Snapshot& snapshot) {
+    for (size_t i = 0; i < kCategoryCount; i++) {
+        peak.cpu[i].bytes = std::max(peak.cpu[i].bytes, snapshot.cpu[i].bytes);
+        peak.cpu[i].allocations = std::max(peak.cpu[i].allocations, snapshot.cpu[i].allocations);
+    }
+    for (size_t i = 0; i < kGpuKindCount; i++) {
+        peak.gpu[i].bytes = std::max(peak.gpu[i].bytes, snapshot.gpu[i].bytes);
+        peak.gpu[i].allocations = std::max(peak.gpu[i].allocations, snapshot.gpu[i].allocations);
+    }
+    peakCpuTotal = std::max(peakCpuTotal, snapshot.TotalCpuBytes());
+    peakGpuTotal = std::max(peakGpuTotal, snapshot.TotalGpuBytes());
+}
+
+bool MemoryTracker::IsHeapTrackingEnabled() {
+#if defined(OW_MEMORY_TRACKING) && OW_MEMORY_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryTracker::RecordAlloc(MemoryCategory category, size_t bytes) {
+    const size_t index = static_cast<size_t>(category);
+    g_CpuBytes[index].fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    g_CpuAllocations[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::RecordFree(MemoryCategory category, size_t bytes) {
+    const size_t index = static_cast<size_t>(category);
+    g_CpuBytes[index].fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    g_CpuAllocations[index].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryTracker::RecordGpu(GpuMemoryKind kind, int64_t bytes) {
+    const size_t index = static_cast<size_t>(kind);
+    g_GpuBytes[index].fetch_add(bytes, std::memory_order_relaxed);
+    g_GpuResources[index].fetch_add(bytes >= 0 ? 1 : -1, std::memory_order_relaxed);
+}
+
+MemoryTracker::Snapshot MemoryTracker::GetSnapshot() {
+    Snapshot snapshot;
+    for (size_t i = 0; i < kCategoryCount; i++) {
+        snapshot.cpu[i].bytes = g_CpuBytes[i].load(std::memory_order_relaxed);
+        snapshot.cpu[i].allocations = g_CpuAllocations[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < kGpuKindCount; i++) {
+        snapshot.gpu[i].bytes = g_GpuBytes[i].load(std::memory_order_relaxed);
+        snapshot.gpu[i].allocations = g_GpuResources[i].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+const char* MemoryTracker::GetCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::General:  return "General";
+        case MemoryCategory::Meshes:   return "Meshes";
+        case MemoryCategory::Textures: return "Textures";
+        case MemoryCategory::Audio:    return "Audio";
+        case MemoryCategory::Physics:  return "Physics";
+        case MemoryCategory::UI:       return "UI";
+        case MemoryCategory::Logging:  return "Logging";
+        default:                       return "?";
+    }
+}
+
+const char* MemoryTracker::GetGpuKindName(GpuMemoryKind kind) {
+    switch (kind) {
+        case GpuMemoryKind::Buffer:  return "Buffers";
+        case GpuMemoryKind::Texture: return "Textures";
+        default:                     return "?";
+    }
+}
+
+MemoryCategory MemoryTracker::GetThreadCategory() {
+    return t_Category;
+}
+
+void MemoryTracker::SetThreadCategory(MemoryCategory category) {
+    t_Category = category;
+}
+
+} // namespace outer_wilds
+
+#if defined(OW_MEMORY_TRACKING) && OW_MEMORY_TRACKING
+
+// ============================================================
+// 全局 operator new / delete：分配前加 16 字节头（大小 + 分类），用户指针保持至少 16 字节对齐。
+// 头中的魔数用于识别不是从这里分配的指针（其他 CRT / DLL 分配后误交给这里释放时按原样 free）。
+// ============================================================
+namespace {
+
+constexpr uint32_t kHeaderMagic = 0x544D574Fu;     // "OWMT"
+constexpr size_t kBaseAlignment = 16;
+
+struct AllocHeader {
+    uint64_t size;
+    uint32_t magic;
+    uint16_t offset;        // 用户指针 - 原始指针
+    uint8_t category;
+    uint8_t overAligned;
+};
+static_assert(sizeof(AllocHeader) == kBaseAlignment, "AllocHeader must keep user pointers 16-byte aligned");
+
+void* RawAlignedAlloc(size_t size, size_t alignment) {
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = nullptr;
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+void RawAlignedFree(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+void* TrackedAlloc(size_t size, size_t alignment) noexcept {
+    const bool overAligned = alignment > kBaseAlignment;
+    const size_t offset = overAligned ? alignment : kBaseAlignment;
+    if (size > SIZE_MAX - offset) return nullptr;
+    // 64 位 Windows / Linux 的 malloc 返回 16 字节对齐的地址
+    char* raw = static_cast<char*>(overAligned ? RawAlignedAlloc(size + offset, alignment) : malloc(size + offset));
+    if (!raw) return nullptr;
+
+    const auto category = outer_wilds::MemoryTracker::GetThreadCategory();
+    AllocHeader* header = reinterpret_cast<AllocHeader*>(raw + offset) - 1;
+    header->size = size;
+    header->magic = kHeaderMagic;
+    header->offset = static_cast<uint16_t>(offset);
+    header->category = static_cast<uint8_t>(category);
+    header->overAligned = overAligned ? 1 : 0;
+    outer_wilds::MemoryTracker::RecordAlloc(category, size);
+    return raw + offset;
+}
+
+void TrackedFree(void* ptr) noexcept {
+    if (!ptr) return;
+    AllocHeader* header = static_cast<AllocHeader*>(ptr) - 1;
+    if (header->magic != kHeaderMagic) {
+        free(ptr);
+        return;
+    }
+    header->magic = 0;
+    outer_wilds::MemoryTracker::RecordFree(static_cast<outer_wilds::MemoryCategory>(header->category),
+                                           static_cast<size_t>(header->size));
+    char* raw = static_cast<char*>(ptr) - header->offset;
+    if (header->overAligned) {
+        RawAlignedFree(raw);
+    } else {
+        free(raw);
+    }
+}
+
+void* TrackedAllocOrThrow(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+    for (;;) {
+        if (void* ptr = TrackedAlloc(size, alignment)) return ptr;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) { return TrackedAllocOrThrow(size, kBaseAlignment); }
+void* operator new[](size_t size) { return TrackedAllocOrThrow(size, kBaseAlignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size ? size : 1, kBaseAlignment); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TrackedAlloc(size ? size : 1, kBaseAlignment); }
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedAllocOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedAllocOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return TrackedAlloc(size ? size : 1, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return TrackedAlloc(size ? size : 1, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { TrackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { TrackedFree(ptr); }
+
+#endif
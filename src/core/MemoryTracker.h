@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace outer_wilds {
+
+/**
+ * @brief CPU 堆内存的分类（MemoryScope 标记当前线程的分配归属）
+ */
+enum class MemoryCategory : uint8_t {
+    General,    // 未标记的分配（ECS、游戏逻辑、容器等）
+    Meshes,     // 模型导入、Mesh 的 CPU 顶点 / 索引、LOD 简化
+    Textures,   // 纹理解码 / 烘焙
+    Audio,      // 解码后的音频数据
+    Physics,    // PhysX（经 PxAllocatorCallback，不走 operator new）
+    UI,         // ImGui
+    Logging,    // 日志历史与格式化
+    Count
+};
+
+/**
+ * @brief GPU 资源的分类（按创建时的描述计算字节数）
+ */
+enum class GpuMemoryKind : uint8_t {
+    Buffer,
+    Texture,
+    Count
+};
+
+/**
+ * @brief 按子系统分类的内存统计
+ *
+ * - CPU 堆：OW_MEMORY_TRACKING 打开时替换全局 operator new / delete，每次分配带 16 字节头
+ *   （大小 + 分类），释放时按头中的分类扣除；分类取当前线程的 MemoryScope，未标记的记为 General
+ * - PhysX：PhysXManager 的 PxAllocatorCallback 直接记到 Physics
+ * - UI：ImGui 的分配函数记到 UI
+ * - GPU：GpuMemory::Track 按资源描述记录字节数，资源销毁时自动扣除
+ *
+ * 计数为 relaxed 原子量，任意线程可读；峰值由采样方（BenchmarkReport / 性能面板）自行统计。
+ */
+class MemoryTracker {
+public:
+    struct CategoryStats {
+        int64_t bytes = 0;
+        int64_t allocations = 0;    // 存活的分配数
+    };
+
+    struct Snapshot {
+        CategoryStats cpu[static_cast<size_t>(MemoryCategory::Count)];
+        CategoryStats gpu[static_cast<size_t>(GpuMemoryKind::Count)];
+
+        int64_t TotalCpuBytes() const;
+        int64_t TotalGpuBytes() const;
+    };
+
+    /**
+     * @brief 采样方各自维护的峰值（逐分类取采样到的最大值；分配路径上不维护峰值）
+     */
+    struct PeakTracker {
+        Snapshot peak;
+        int64_t peakCpuTotal = 0;
+        int64_t peakGpuTotal = 0;
+
+        void Sample(const Snapshot& snapshot);
+    };
+
+    /** @brief operator new 是否被替换（否则 CPU 分类只有 Physics / UI 有数据） */
+    static bool IsHeapTrackingEnabled();
+
+    static void RecordAlloc(MemoryCategory category, size_t bytes);
+    static void RecordFree(MemoryCategory category, size_t bytes);
+    static void RecordGpu(GpuMemoryKind kind, int64_t bytes);
+
+    static Snapshot GetSnapshot();
+
+    static const char* GetCategoryName(MemoryCategory category);
+    static const char* GetGpuKindName(GpuMemoryKind kind);
+
+    /** @brief 当前线程的分配分类（MemoryScope 设置） */
+    static MemoryCategory GetThreadCategory();
+    static void SetThreadCategory(MemoryCategory category);
+};
+
+/**
+ * @brief 作用域内当前线程的分配记到 category（可嵌套，析构时恢复）
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemoryCategory category)
+        : m_Previous(MemoryTracker::GetThreadCategory()) {
+        MemoryTracker::SetThreadCategory(category);
+    }
+    ~MemoryScope() { MemoryTracker::SetThreadCategory(m_Previous); }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryCategory m_Previous;
+};
+
+} // namespace outer_wilds
+
+#define OW_MEMORY_CONCAT_INNER(a, b) a##b
+#define OW_MEMORY_CONCAT(a, b) OW_MEMORY_CONCAT_INNER(a, b)
+#define OW_MEMORY_SCOPE(category) \
+    ::outer_wilds::MemoryScope OW_MEMORY_CONCAT(owMemoryScope, __LINE__)(::outer_wilds::MemoryCategory::category)
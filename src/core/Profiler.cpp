@@ -0,0 +1,153 @@
+#include "Profiler.h"
+#include "DebugManager.h"
+#include <algorithm>
+#include <fstream>
+
+namespace outer_wilds {
+
+namespace {
+    thread_local void* t_ThreadBuffer = nullptr;
+
+    void WriteJsonString(std::ofstream& out, const char* text) {
+        out << '"';
+        for (const char* c = text ? text : "?"; *c; ++c) {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer() {
+    if (!t_ThreadBuffer) {
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->events.reserve(256);
+        std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+        buffer->index = static_cast<uint32_t>(m_Threads.size());
+        t_ThreadBuffer = buffer.get();
+        m_Threads.push_back(std::move(buffer));
+    }
+    return *static_cast<ThreadBuffer*>(t_ThreadBuffer);
+}
+
+uint32_t Profiler::PushScope() {
+    return GetThreadBuffer().depth++;
+}
+
+void Profiler::PopScope(const char* name, uint64_t startNs, uint32_t depth) {
+    const uint64_t endNs = NowNs();
+    ThreadBuffer& buffer = GetThreadBuffer();
+    buffer.depth = depth;
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events.push_back({ name, startNs, endNs, depth });
+}
+
+void Profiler::BeginFrame() {
+    const uint64_t now = NowNs();
+
+    if (m_FrameStartNs != 0) {
+        FrameData& frame = m_LastFrame;
+        frame.frameIndex = m_FrameIndex;
+        frame.durationNs = now - m_FrameStartNs;
+        frame.nodes.clear();
+
+        std::lock_guard<std::mutex> threadsLock(m_ThreadsMutex);
+        for (auto& thread : m_Threads) {
+            m_Scratch.clear();
+            {
+                std::lock_guard<std::mutex> lock(thread->mutex);
+                m_Scratch.swap(thread->events);
+            }
+            if (m_Scratch.empty()) {
+                continue;
+            }
+
+            // 事件按结束顺序写入；按开始时间（相同时外层在前）排序即得到先序的调用树
+            std::sort(m_Scratch.begin(), m_Scratch.end(), [](const Event& a, const Event& b) {
+                if (a.startNs != b.startNs) return a.startNs < b.startNs;
+                return a.depth < b.depth;
+            });
+
+            for (const Event& event : m_Scratch) {
+                FrameNode node;
+                node.name = event.name;
+                node.startNs = event.startNs > m_FrameStartNs ? event.startNs - m_FrameStartNs : 0;
+                node.durationNs = event.endNs - event.startNs;
+                node.depth = event.depth;
+                node.threadIndex = thread->index;
+                frame.nodes.push_back(node);
+
+                if (m_CaptureFramesLeft > 0) {
+                    m_Captured.push_back({ event, thread->index });
+                }
+            }
+
+            // 把容量还给线程缓冲区，避免每帧重新分配
+            std::lock_guard<std::mutex> lock(thread->mutex);
+            if (thread->events.empty()) {
+                m_Scratch.clear();
+                m_Scratch.swap(thread->events);
+            }
+        }
+
+        if (m_CaptureFramesLeft > 0 && --m_CaptureFramesLeft == 0) {
+            WriteCapture();
+        }
+    }
+
+    m_FrameStartNs = now;
+    m_FrameIndex++;
+}
+
+void Profiler::StartCapture(uint32_t frameCount, const std::string& path) {
+    if (frameCount == 0) {
+        return;
+    }
+    m_Captured.clear();
+    m_CapturePath = path;
+    m_CaptureFramesLeft = frameCount;
+    m_CaptureStartNs = NowNs();
+    DebugManager::GetInstance().Log("Profiler", "Capturing " + std::to_string(frameCount) + " frames to " + path);
+}
+
+void Profiler::StopCapture() {
+    if (m_CaptureFramesLeft == 0) {
+        return;
+    }
+    m_CaptureFramesLeft = 0;
+    WriteCapture();
+}
+
+/**
+ * @brief 写出 Chrome trace（"X" 完整事件，时间单位微秒）
+ */
+void Profiler::WriteCapture() {
+    std::ofstream out(m_CapturePath, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        DebugManager::GetInstance().Log("Profiler", "Failed to open trace file: " + m_CapturePath);
+        m_Captured.clear();
+        return;
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const CapturedEvent& captured : m_Captured) {
+        const Event& event = captured.event;
+        const uint64_t start = event.startNs > m_CaptureStartNs ? event.startNs - m_CaptureStartNs : 0;
+
+        if (!first) out << ",\n";
+        first = false;
+        out << "{\"name\":";
+        WriteJsonString(out, event.name);
+        out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << captured.threadIndex
+            << ",\"ts\":" << static_cast<double>(start) / 1000.0
+            << ",\"dur\":" << static_cast<double>(event.endNs - event.startNs) / 1000.0 << "}";
+    }
+    out << "\n]}\n";
+
+    DebugManager::GetInstance().Log("Profiler", "Wrote " + std::to_string(m_Captured.size()) +
+        " events to " + m_CapturePath);
+    m_Captured.clear();
+}
+
+} // namespace outer_wilds
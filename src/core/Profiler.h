@@ -0,0 +1,141 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 分层 CPU 帧分析器
+ *
+ * PROFILE_SCOPE("name") 在作用域结束时把 {名称, 起止纳秒, 嵌套深度} 写入当前线程自己的缓冲区
+ * （无锁竞争：缓冲区的互斥量只在帧边界被 BeginFrame 短暂获取）。BeginFrame 收集上一帧所有线程的事件，
+ * 按线程和开始时间排成先序的调用树（GetLastFrame），捕获期间同时保存原始事件，结束后导出为
+ * Chrome trace JSON（chrome://tracing / Perfetto 可直接打开）。
+ *
+ * 名称必须具有静态存储期（字符串字面量或 typeid(...).name()），只保存指针。
+ * 编译时未定义 OW_PROFILER（CMake 选项 OW_ENABLE_PROFILER=OFF）时所有宏展开为空，没有任何开销。
+ */
+class Profiler {
+public:
+    /**
+     * @brief 调用树中的一个节点（先序排列，depth 表示嵌套层级）
+     */
+    struct FrameNode {
+        const char* name = nullptr;
+        uint64_t startNs = 0;           // 相对帧开始
+        uint64_t durationNs = 0;
+        uint32_t depth = 0;
+        uint32_t threadIndex = 0;       // 0 = 第一个记录事件的线程（主线程）
+    };
+
+    struct FrameData {
+        uint64_t frameIndex = 0;
+        uint64_t durationNs = 0;
+        std::vector<FrameNode> nodes;
+    };
+
+    static Profiler& GetInstance() {
+        static Profiler instance;
+        return instance;
+    }
+
+    /**
+     * @brief 帧边界：结束上一帧（构建调用树、写入捕获），开始新的一帧
+     */
+    void BeginFrame();
+
+    /**
+     * @brief 捕获接下来的 frameCount 帧，完成后写入 path（Chrome trace JSON）
+     */
+    void StartCapture(uint32_t frameCount, const std::string& path);
+    /**
+     * @brief 提前结束捕获并写出已捕获的帧
+     */
+    void StopCapture();
+    bool IsCapturing() const { return m_CaptureFramesLeft > 0; }
+
+    const FrameData& GetLastFrame() const { return m_LastFrame; }
+
+    static uint64_t NowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // === ProfileScope 使用 ===
+    uint32_t PushScope();
+    void PopScope(const char* name, uint64_t startNs, uint32_t depth);
+
+private:
+    struct Event {
+        const char* name;
+        uint64_t startNs;
+        uint64_t endNs;
+        uint32_t depth;
+    };
+
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<Event> events;
+        uint32_t depth = 0;
+        uint32_t index = 0;
+    };
+
+    struct CapturedEvent {
+        Event event;
+        uint32_t threadIndex;
+    };
+
+    Profiler() = default;
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    ThreadBuffer& GetThreadBuffer();
+    void WriteCapture();
+
+    std::mutex m_ThreadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_Threads;
+
+    uint64_t m_FrameIndex = 0;
+    uint64_t m_FrameStartNs = 0;
+    FrameData m_LastFrame;
+    std::vector<Event> m_Scratch;
+
+    uint32_t m_CaptureFramesLeft = 0;
+    std::string m_CapturePath;
+    std::vector<CapturedEvent> m_Captured;
+    uint64_t m_CaptureStartNs = 0;
+};
+
+/**
+ * @brief RAII 作用域计时（由 PROFILE_SCOPE 使用）
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : m_Name(name), m_Depth(Profiler::GetInstance().PushScope()), m_StartNs(Profiler::NowNs()) {}
+    ~ProfileScope() { Profiler::GetInstance().PopScope(m_Name, m_StartNs, m_Depth); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_Name;
+    uint32_t m_Depth;
+    uint64_t m_StartNs;
+};
+
+} // namespace outer_wilds
+
+#if defined(OW_PROFILER) && OW_PROFILER
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ::outer_wilds::ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_FRAME() ::outer_wilds::Profiler::GetInstance().BeginFrame()
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
@@ -0,0 +1,162 @@
+#include "SystemScheduler.h"
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <thread>
+#include <typeinfo>
+
+namespace outer_wilds {
+
+uint32_t SystemScheduler::InternKey(const std::string& key) {
+    auto it = m_KeyIds.find(key);
+    if (it != m_KeyIds.end()) return it->second;
+    const uint32_t id = static_cast<uint32_t>(m_KeyIds.size());
+    m_KeyIds.emplace(key, id);
+    return id;
+}
+
+const SystemScheduler::Declaration& SystemScheduler::GetDeclaration(System* system) {
+    auto it = m_Declarations.find(system);
+    if (it != m_Declarations.end()) return *it->second;
+
+    auto declaration = std::make_unique<Declaration>();
+    system->DeclareAccess(declaration->access);
+    for (const auto& entry : declaration->access.GetEntries()) {
+        (entry.write ? declaration->writes : declaration->reads).push_back(InternKey(entry.key));
+    }
+    std::sort(declaration->reads.begin(), declaration->reads.end());
+    std::sort(declaration->writes.begin(), declaration->writes.end());
+    declaration->exclusive = declaration->access.IsExclusive();
+    declaration->mainThread = declaration->access.RequiresMainThread();
+
+    const Declaration& result = *declaration;
+    m_Declarations.emplace(system, std::move(declaration));
+    return result;
+}
+
+bool SystemScheduler::Conflicts(const Declaration& a, const Declaration& b) {
+    if (a.exclusive || b.exclusive) return true;
+
+    auto intersects = [](const std::vector<uint32_t>& x, const std::vector<uint32_t>& y) {
+        auto i = x.begin();
+        auto j = y.begin();
+        while (i != x.end() && j != y.end()) {
+            if (*i == *j) return true;
+            if (*i < *j) ++i; else ++j;
+        }
+        return false;
+    };
+    return intersects(a.writes, b.writes) || intersects(a.writes, b.reads) || intersects(a.reads, b.writes);
+}
+
+/**
+ * @brief 后面的系统依赖前面所有与它冲突的系统（传递冗余的边不剔除，系统数很少）
+ */
+void SystemScheduler::BuildGraph(const std::vector<System*>& systems) {
+    const uint32_t count = static_cast<uint32_t>(systems.size());
+    m_Nodes.resize(count);
+    FrameVector<uint32_t> depth(count, 1);
+    m_LastDepth = count > 0 ? 1 : 0;
+
+    for (uint32_t j = 0; j < count; j++) {
+        Node& node = m_Nodes[j];
+        node.system = systems[j];
+        node.declaration = &GetDeclaration(systems[j]);
+        node.successors.clear();
+        node.predecessorCount = 0;
+    }
+
+    for (uint32_t j = 0; j < count; j++) {
+        for (uint32_t i = 0; i < j; i++) {
+            if (Conflicts(*m_Nodes[i].declaration, *m_Nodes[j].declaration)) {
+                m_Nodes[i].successors.push_back(j);
+                m_Nodes[j].predecessorCount++;
+                depth[j] = (std::max)(depth[j], depth[i] + 1);
+            }
+        }
+        m_LastDepth = (std::max)(m_LastDepth, depth[j]);
+    }
+
+    if (m_RemainingCapacity < count) {
+        m_Remaining.reset(new std::atomic<uint32_t>[count]);
+        m_RemainingCapacity = count;
+    }
+    for (uint32_t j = 0; j < count; j++) {
+        m_Remaining[j].store(m_Nodes[j].predecessorCount, std::memory_order_relaxed);
+    }
+}
+
+void SystemScheduler::Run(const std::vector<System*>& systems, float deltaTime, entt::registry& registry) {
+    if (systems.empty()) return;
+
+    m_DeltaTime = deltaTime;
+    m_Registry = &registry;
+    BuildGraph(systems);
+
+    JobSystem& jobs = JobSystem::GetInstance();
+    if (!jobs.IsInitialized()) {
+        for (System* system : systems) {
+            PROFILE_SCOPE(typeid(*system).name());
+            system->Update(deltaTime, registry);
+        }
+        return;
+    }
+
+    // 并行阶段不会有线程在 registry 的池表里插入新存储
+    for (const Node& node : m_Nodes) {
+        node.declaration->access.PrepareStorage(registry);
+    }
+
+    m_Finished.store(0, std::memory_order_relaxed);
+    m_MainThreadReady.clear();
+    for (uint32_t i = 0; i < m_Nodes.size(); i++) {
+        if (m_Nodes[i].predecessorCount == 0) {
+            Launch(i);
+        }
+    }
+
+    // 调用线程：执行主线程系统，同时帮忙执行作业
+    const uint32_t total = static_cast<uint32_t>(m_Nodes.size());
+    while (m_Finished.load(std::memory_order_acquire) < total) {
+        uint32_t mainIndex = UINT32_MAX;
+        {
+            std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+            if (!m_MainThreadReady.empty()) {
+                mainIndex = m_MainThreadReady.back();
+                m_MainThreadReady.pop_back();
+            }
+        }
+        if (mainIndex != UINT32_MAX) {
+            Execute(mainIndex);
+        } else if (!jobs.ExecutePending()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SystemScheduler::Launch(uint32_t index) {
+    if (m_Nodes[index].declaration->mainThread) {
+        std::lock_guard<std::mutex> lock(m_MainThreadMutex);
+        m_MainThreadReady.push_back(index);
+        return;
+    }
+    JobSystem::GetInstance().Run([this, index]() { Execute(index); });
+}
+
+void SystemScheduler::Execute(uint32_t index) {
+    Node& node = m_Nodes[index];
+    {
+        PROFILE_SCOPE(typeid(*node.system).name());
+        node.system->Update(m_DeltaTime, *m_Registry);
+    }
+
+    for (uint32_t successor : node.successors) {
+        if (m_Remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Launch(successor);
+        }
+    }
+    m_Finished.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,76 @@
+#pragma once
+#include "ECS.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 按 System::DeclareAccess 构建依赖图，在 JobSystem 上并行执行游戏逻辑系统
+ *
+ * 每帧按传入顺序重建 DAG：后面的系统与前面任何一个访问冲突（写-读、读-写、写-写，或任一方 Exclusive）
+ * 就依赖它，因此冲突的系统之间保持原来的串行顺序，互不相关的系统并行执行。
+ * 访问声明只在系统第一次出现时查询并缓存（键被映射为整数 ID）。
+ *
+ * RequiresMainThread 的系统只在调用线程上执行；调用线程在等待期间也会执行其他作业。
+ * JobSystem 未初始化时按顺序串行执行。
+ */
+class SystemScheduler {
+public:
+    void Run(const std::vector<System*>& systems, float deltaTime, entt::registry& registry);
+
+    /**
+     * @brief 丢弃缓存的访问声明（系统被移除或声明改变时调用）
+     */
+    void Invalidate() { m_Declarations.clear(); }
+
+    /**
+     * @brief 上一帧依赖图的关键路径长度（串行层数，1 表示全部并行）
+     */
+    uint32_t GetLastDepth() const { return m_LastDepth; }
+
+private:
+    struct Declaration {
+        std::vector<uint32_t> reads;
+        std::vector<uint32_t> writes;
+        bool exclusive = false;
+        bool mainThread = false;
+        SystemAccess access;
+    };
+
+    struct Node {
+        System* system = nullptr;
+        const Declaration* declaration = nullptr;
+        std::vector<uint32_t> successors;
+        uint32_t predecessorCount = 0;
+    };
+
+    const Declaration& GetDeclaration(System* system);
+    uint32_t InternKey(const std::string& key);
+    static bool Conflicts(const Declaration& a, const Declaration& b);
+
+    void BuildGraph(const std::vector<System*>& systems);
+    void Launch(uint32_t index);
+    void Execute(uint32_t index);
+
+    std::unordered_map<System*, std::unique_ptr<Declaration>> m_Declarations;
+    std::unordered_map<std::string, uint32_t> m_KeyIds;
+
+    std::vector<Node> m_Nodes;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_Remaining;
+    size_t m_RemainingCapacity = 0;
+    std::atomic<uint32_t> m_Finished{ 0 };
+
+    std::mutex m_MainThreadMutex;
+    std::vector<uint32_t> m_MainThreadReady;
+
+    float m_DeltaTime = 0.0f;
+    entt::registry* m_Registry = nullptr;
+    uint32_t m_LastDepth = 0;
+};
+
+} // namespace outer_wilds
@@ -14,12 +14,13 @@ public:
         auto currentTime = std::chrono::high_resolution_clock::now();
         if (m_LastTime.time_since_epoch().count() > 0) {
             std::chrono::duration<float> elapsed = currentTime - m_LastTime;
-            m_DeltaTime = elapsed.count();
+            m_RealDeltaTime = elapsed.count();
+            m_DeltaTime = m_RealDeltaTime;
             m_TotalTime += m_DeltaTime;
             
-            // 更新FPS计算
+            // 更新FPS计算（始终按墙钟时间）
             m_FrameCount++;
-            m_FpsAccumulator += m_DeltaTime;
+            m_FpsAccumulator += m_RealDeltaTime;
             if (m_FpsAccumulator >= 1.0f) {
                 m_CurrentFPS = m_FrameCount / m_FpsAccumulator;
                 m_FrameCount = 0;
@@ -30,15 +31,31 @@ public:
     }
 
     float GetDeltaTime() const { return m_DeltaTime; }
+    float GetRealDeltaTime() const { return m_RealDeltaTime; }
+
+    /**
+     * @brief 用确定的时间步替换本帧的墙钟 delta（InputRecorder 回放时在 Update 之后调用）
+     */
+    void OverrideDeltaTime(float deltaTime) {
+        m_TotalTime += deltaTime - m_DeltaTime;
+        m_DeltaTime = deltaTime;
+    }
     float GetTotalTime() const { return m_TotalTime; }
     float GetFPS() const { return m_CurrentFPS; }
 
+    // 时间加速倍率（1 = 实时）：只是请求值，由 SectorPhysicsSystem::UpdateTimeWarp 在
+    // 帧内安全的位置切换物理模式，轨道/物理使用 GetDeltaTime() * 生效倍率
+    void SetTimeWarp(float warp) { m_TimeWarp = warp < 1.0f ? 1.0f : (warp > 1000.0f ? 1000.0f : warp); }
+    float GetTimeWarp() const { return m_TimeWarp; }
+
 private:
     TimeManager() = default;
     
     std::chrono::high_resolution_clock::time_point m_LastTime;
     float m_DeltaTime = 0.0f;
+    float m_RealDeltaTime = 0.0f;
     float m_TotalTime = 0.0f;
+    float m_TimeWarp = 1.0f;
     
     // FPS计算
     int m_FrameCount = 0;
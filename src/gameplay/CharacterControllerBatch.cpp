@@ -0,0 +1,464 @@
+#include "CharacterControllerBatch.h"
+#include "components/CharacterControllerComponent.h"
+#include "components/PlayerComponent.h"
+#include "components/StandingOnComponent.h"
+#include "../physics/PhysXManager.h"
+#include "../physics/components/GravityAffectedComponent.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include "../physics/components/SectorComponent.h"
+#include "../scene/components/TransformComponent.h"
+#include "../core/FrameAllocator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace outer_wilds {
+
+using namespace components;
+using namespace DirectX;
+
+namespace {
+
+constexpr uint32_t kLanes = 4;
+
+/**
+ * 4 个控制器一组的 SoA 数据：输入在收集时填写，参考系和位移由两次 SIMD 计算写入
+ */
+struct alignas(16) MotorGroup {
+    // 输入
+    float gx[kLanes], gy[kLanes], gz[kLanes], gs[kLanes];  // 重力方向 / 强度
+    float fx[kLanes], fy[kLanes], fz[kLanes];              // 上一次的 localForward
+    float yaw[kLanes];
+    float vx[kLanes], vy[kLanes], vz[kLanes];              // 速度（计算后为新速度）
+    float forwardInput[kLanes], rightInput[kLanes];
+    float speed[kLanes], jumpForce[kLanes], airControl[kLanes];
+    float grounded[kLanes], jump[kLanes];                  // 0 / 1
+    float dt[kLanes];
+    // 输出
+    float ux[kLanes], uy[kLanes], uz[kLanes];              // localUp
+    float lfx[kLanes], lfy[kLanes], lfz[kLanes];           // localForward
+    float lrx[kLanes], lry[kLanes], lrz[kLanes];           // localRight
+    float rfx[kLanes], rfy[kLanes], rfz[kLanes];           // 偏航后的前方（角色朝向）
+    float mx[kLanes], my[kLanes], mz[kLanes];              // 本次位移
+    float degenerate[kLanes];                              // 参考系需要逐个修正
+};
+
+struct Walker {
+    entt::entity entity;
+    CharacterControllerComponent* character;
+    InSectorComponent* inSector;
+    physx::PxControllerManager* manager;
+};
+
+/**
+ * move 期间的碰撞回报：记录本次 move 脚下的 actor（地面 actor 的 userData 是扇区实体）
+ *
+ * 只在 Update 的 move 中回调，每次 move 之前 Reset。不一定在主线程：所有 move 由 PlayerSystem 的
+ * kPhysXScene 写声明串行化（调度器不会让两个写 PhysX 场景的系统并发），这是 s_GroundHitReport 不加锁的前提
+ */
+class GroundHitReport : public physx::PxUserControllerHitReport {
+public:
+    void Reset() { m_Ground = entt::null; }
+    entt::entity GetGround() const { return m_Ground; }
+
+    void onShapeHit(const physx::PxControllerShapeHit& hit) override {
+        // 法线朝向控制器 up 的接触才算"站在上面"（侧面的墙不算）
+        if (!hit.actor || !hit.controller) return;
+        if (hit.worldNormal.dot(hit.controller->getUpDirection()) < kMinGroundDot) return;
+        m_Ground = FromActorUserData(hit.actor->userData);
+    }
+    void onControllerHit(const physx::PxControllersHit&) override {}
+    void onObstacleHit(const physx::PxControllerObstacleHit&) override {}
+
+private:
+    static constexpr float kMinGroundDot = 0.5f;
+    entt::entity m_Ground = entt::null;
+};
+
+GroundHitReport s_GroundHitReport;
+
+inline XMVECTOR Load(const float* lanes) { return XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(lanes)); }
+inline void Store(float* lanes, FXMVECTOR value) { XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(lanes), value); }
+
+inline XMVECTOR Dot3(FXMVECTOR ax, FXMVECTOR ay, FXMVECTOR az, GXMVECTOR bx, HXMVECTOR by, HXMVECTOR bz) {
+    return XMVectorMultiplyAdd(az, bz, XMVectorMultiplyAdd(ay, by, XMVectorMultiply(ax, bx)));
+}
+
+/** @brief 第一次 SIMD：localUp 与切平面参考系（UpdateLocalFrame 的常规路径） */
+void ComputeFrames(MotorGroup& group) {
+    const XMVECTOR epsilon = XMVectorReplicate(1e-12f);
+
+    XMVECTOR ux = XMVectorNegate(Load(group.gx));
+    XMVECTOR uy = XMVectorNegate(Load(group.gy));
+    XMVECTOR uz = XMVectorNegate(Load(group.gz));
+    const XMVECTOR upLengthSq = Dot3(ux, uy, uz, ux, uy, uz);
+    const XMVECTOR invUp = XMVectorReciprocalSqrt(XMVectorMax(upLengthSq, epsilon));
+    ux = XMVectorMultiply(ux, invUp);
+    uy = XMVectorMultiply(uy, invUp);
+    uz = XMVectorMultiply(uz, invUp);
+
+    // 旧 forward 投影到新的切平面
+    const XMVECTOR fx = Load(group.fx);
+    const XMVECTOR fy = Load(group.fy);
+    const XMVECTOR fz = Load(group.fz);
+    const XMVECTOR oldLengthSq = Dot3(fx, fy, fz, fx, fy, fz);
+    const XMVECTOR along = Dot3(fx, fy, fz, ux, uy, uz);
+    XMVECTOR px = XMVectorNegativeMultiplySubtract(ux, along, fx);
+    XMVECTOR py = XMVectorNegativeMultiplySubtract(uy, along, fy);
+    XMVECTOR pz = XMVectorNegativeMultiplySubtract(uz, along, fz);
+    const XMVECTOR projLengthSq = Dot3(px, py, pz, px, py, pz);
+    const XMVECTOR invProj = XMVectorReciprocalSqrt(XMVectorMax(projLengthSq, epsilon));
+    px = XMVectorMultiply(px, invProj);
+    py = XMVectorMultiply(py, invProj);
+    pz = XMVectorMultiply(pz, invProj);
+
+    // right = up × forward，再由 right × up 得到正交的 forward
+    XMVECTOR rx = XMVectorNegativeMultiplySubtract(uz, py, XMVectorMultiply(uy, pz));
+    XMVECTOR ry = XMVectorNegativeMultiplySubtract(ux, pz, XMVectorMultiply(uz, px));
+    XMVECTOR rz = XMVectorNegativeMultiplySubtract(uy, px, XMVectorMultiply(ux, py));
+    const XMVECTOR invRight = XMVectorReciprocalSqrt(XMVectorMax(Dot3(rx, ry, rz, rx, ry, rz), epsilon));
+    rx = XMVectorMultiply(rx, invRight);
+    ry = XMVectorMultiply(ry, invRight);
+    rz = XMVectorMultiply(rz, invRight);
+
+    Store(group.ux, ux);
+    Store(group.uy, uy);
+    Store(group.uz, uz);
+    Store(group.lrx, rx);
+    Store(group.lry, ry);
+    Store(group.lrz, rz);
+    Store(group.lfx, XMVectorNegativeMultiplySubtract(rz, uy, XMVectorMultiply(ry, uz)));
+    Store(group.lfy, XMVectorNegativeMultiplySubtract(rx, uz, XMVectorMultiply(rz, ux)));
+    Store(group.lfz, XMVectorNegativeMultiplySubtract(ry, ux, XMVectorMultiply(rx, uy)));
+
+    // 无重力、旧 forward 无效（长度 < 0.5）、forward 与 up 平行（投影长度 < 0.001）时逐个修正
+    const XMVECTOR degenerate = XMVectorOrInt(XMVectorLessOrEqual(upLengthSq, epsilon),
+        XMVectorOrInt(XMVectorLess(oldLengthSq, XMVectorReplicate(0.25f)),
+                      XMVectorLess(projLengthSq, XMVectorReplicate(1e-6f))));
+    Store(group.degenerate, XMVectorSelect(XMVectorZero(), XMVectorSplatOne(), degenerate));
+}
+
+/** @brief 第二次 SIMD：视角偏航、速度积分（地面 / 空中 / 跳跃）与本次位移 */
+void ComputeMotion(MotorGroup& group) {
+    const XMVECTOR ux = Load(group.ux);
+    const XMVECTOR uy = Load(group.uy);
+    const XMVECTOR uz = Load(group.uz);
+    const XMVECTOR lfx = Load(group.lfx);
+    const XMVECTOR lfy = Load(group.lfy);
+    const XMVECTOR lfz = Load(group.lfz);
+    const XMVECTOR lrx = Load(group.lrx);
+    const XMVECTOR lry = Load(group.lry);
+    const XMVECTOR lrz = Load(group.lrz);
+    const XMVECTOR dt = Load(group.dt);
+
+    // 绕 localUp 偏航：forward' = f cos + r sin，right' = r cos - f sin（左手系）
+    XMVECTOR sinYaw;
+    XMVECTOR cosYaw;
+    XMVectorSinCos(&sinYaw, &cosYaw, Load(group.yaw));
+    const XMVECTOR rfx = XMVectorMultiplyAdd(lrx, sinYaw, XMVectorMultiply(lfx, cosYaw));
+    const XMVECTOR rfy = XMVectorMultiplyAdd(lry, sinYaw, XMVectorMultiply(lfy, cosYaw));
+    const XMVECTOR rfz = XMVectorMultiplyAdd(lrz, sinYaw, XMVectorMultiply(lfz, cosYaw));
+    const XMVECTOR rrx = XMVectorNegativeMultiplySubtract(lfx, sinYaw, XMVectorMultiply(lrx, cosYaw));
+    const XMVECTOR rry = XMVectorNegativeMultiplySubtract(lfy, sinYaw, XMVectorMultiply(lry, cosYaw));
+    const XMVECTOR rrz = XMVectorNegativeMultiplySubtract(lfz, sinYaw, XMVectorMultiply(lrz, cosYaw));
+    Store(group.rfx, rfx);
+    Store(group.rfy, rfy);
+    Store(group.rfz, rfz);
+
+    // 切平面上的水平位移：输入长度 > 0.01 时方向归一化，位移 = 方向 * speed * 长度 * dt
+    const XMVECTOR forwardInput = Load(group.forwardInput);
+    const XMVECTOR rightInput = Load(group.rightInput);
+    const XMVECTOR dx = XMVectorMultiplyAdd(rrx, rightInput, XMVectorMultiply(rfx, forwardInput));
+    const XMVECTOR dy = XMVectorMultiplyAdd(rry, rightInput, XMVectorMultiply(rfy, forwardInput));
+    const XMVECTOR dz = XMVectorMultiplyAdd(rrz, rightInput, XMVectorMultiply(rfz, forwardInput));
+    const XMVECTOR magnitude = XMVectorSqrt(Dot3(dx, dy, dz, dx, dy, dz));
+    const XMVECTOR normalized = XMVectorGreater(magnitude, XMVectorReplicate(0.01f));
+    XMVECTOR scale = XMVectorMultiply(Load(group.speed), dt);
+    scale = XMVectorMultiply(scale, XMVectorSelect(magnitude, XMVectorSplatOne(), normalized));
+
+    // 地面：去掉向下的速度分量并叠加跳跃；空中：积分重力，水平控制按 airControl 衰减
+    const XMVECTOR grounded = XMVectorGreater(Load(group.grounded), XMVectorReplicate(0.5f));
+    const XMVECTOR vx = Load(group.vx);
+    const XMVECTOR vy = Load(group.vy);
+    const XMVECTOR vz = Load(group.vz);
+    const XMVECTOR along = Dot3(vx, vy, vz, ux, uy, uz);
+    const XMVECTOR groundCorrection = XMVectorSubtract(
+        XMVectorMultiply(Load(group.jumpForce), Load(group.jump)), XMVectorMin(along, XMVectorZero()));
+    const XMVECTOR gravityStep = XMVectorMultiply(Load(group.gs), dt);
+    const XMVECTOR nvx = XMVectorSelect(XMVectorMultiplyAdd(Load(group.gx), gravityStep, vx),
+                                        XMVectorMultiplyAdd(ux, groundCorrection, vx), grounded);
+    const XMVECTOR nvy = XMVectorSelect(XMVectorMultiplyAdd(Load(group.gy), gravityStep, vy),
+                                        XMVectorMultiplyAdd(uy, groundCorrection, vy), grounded);
+    const XMVECTOR nvz = XMVectorSelect(XMVectorMultiplyAdd(Load(group.gz), gravityStep, vz),
+                                        XMVectorMultiplyAdd(uz, groundCorrection, vz), grounded);
+    scale = XMVectorMultiply(scale, XMVectorSelect(Load(group.airControl), XMVectorSplatOne(), grounded));
+
+    Store(group.vx, nvx);
+    Store(group.vy, nvy);
+    Store(group.vz, nvz);
+    Store(group.mx, XMVectorMultiplyAdd(nvx, dt, XMVectorMultiply(dx, scale)));
+    Store(group.my, XMVectorMultiplyAdd(nvy, dt, XMVectorMultiply(dy, scale)));
+    Store(group.mz, XMVectorMultiplyAdd(nvz, dt, XMVectorMultiply(dz, scale)));
+}
+
+} // namespace
+
+void CharacterControllerBatch::Update(float deltaTime, entt::registry& registry) {
+    m_Stats = Stats();
+    m_FrameIndex++;
+
+    // 距离按玩家位置计算；没有玩家时全部每帧更新
+    bool hasFocus = false;
+    XMFLOAT3 focus = { 0.0f, 0.0f, 0.0f };
+    {
+        auto playerView = registry.view<PlayerComponent, TransformComponent>();
+        for (auto entity : playerView) {
+            focus = playerView.get<TransformComponent>(entity).position;
+            hasFocus = true;
+            break;
+        }
+    }
+    const float fullRateSq = m_Settings.fullRateDistance * m_Settings.fullRateDistance;
+    const float halfRateSq = m_Settings.halfRateDistance * m_Settings.halfRateDistance;
+
+    // 1. 调度 + 收集
+    FrameVector<Walker> walkers;
+    FrameVector<MotorGroup> groups;
+    auto view = registry.view<CharacterControllerComponent, GravityAffectedComponent, InSectorComponent, TransformComponent>();
+    for (auto entity : view) {
+        auto& character = view.get<CharacterControllerComponent>(entity);
+        if (!character.pxController || character.suspended) continue;
+        auto& inSector = view.get<InSectorComponent>(entity);
+        if (inSector.hibernating) continue;
+        m_Stats.controllers++;
+
+        uint32_t interval = 1;
+        if (hasFocus && !registry.all_of<PlayerComponent>(entity)) {
+            const XMFLOAT3& position = view.get<TransformComponent>(entity).position;
+            const float dx = position.x - focus.x;
+            const float dy = position.y - focus.y;
+            const float dz = position.z - focus.z;
+            const float distanceSq = dx * dx + dy * dy + dz * dz;
+            interval = distanceSq < fullRateSq ? 1u : (distanceSq < halfRateSq ? 2u : (std::max)(m_Settings.farInterval, 1u));
+        }
+        character.updateInterval = static_cast<uint8_t>((std::min)(interval, 255u));
+        character.pendingTime += deltaTime;
+        // 按实体错开相位：同一距离档的控制器分摊到不同帧
+        if ((m_FrameIndex + static_cast<uint32_t>(entt::to_integral(entity))) % interval != 0) continue;
+
+        const uint32_t index = static_cast<uint32_t>(walkers.size());
+        if (index % kLanes == 0) {
+            groups.emplace_back();
+            std::memset(&groups.back(), 0, sizeof(MotorGroup));
+        }
+        MotorGroup& group = groups.back();
+        const uint32_t lane = index % kLanes;
+
+        const auto& gravity = view.get<GravityAffectedComponent>(entity);
+        group.gx[lane] = gravity.currentGravityDir.x;
+        group.gy[lane] = gravity.currentGravityDir.y;
+        group.gz[lane] = gravity.currentGravityDir.z;
+        group.gs[lane] = gravity.currentGravityStrength;
+        group.fx[lane] = character.localForward.x;
+        group.fy[lane] = character.localForward.y;
+        group.fz[lane] = character.localForward.z;
+        group.yaw[lane] = character.cameraYaw;
+        group.vx[lane] = character.velocity.x;
+        group.vy[lane] = character.velocity.y;
+        group.vz[lane] = character.velocity.z;
+        group.forwardInput[lane] = character.forwardInput;
+        group.rightInput[lane] = character.rightInput;
+        group.speed[lane] = character.wantsToRun ? character.runSpeed : character.moveSpeed;
+        group.jumpForce[lane] = character.jumpForce;
+        group.airControl[lane] = character.airControl;
+        group.grounded[lane] = character.isGrounded ? 1.0f : 0.0f;
+        group.jump[lane] = character.wantsToJump ? 1.0f : 0.0f;
+        group.dt[lane] = character.pendingTime;
+        character.pendingTime = 0.0f;
+
+        walkers.push_back({ entity, &character, &inSector,
+                            PhysXManager::GetInstance().GetControllerManager(character.pxController->getScene()) });
+    }
+    if (walkers.empty()) return;
+
+    // 2. SIMD 参考系；退化的控制器逐个修正后再算位移
+    for (MotorGroup& group : groups) {
+        ComputeFrames(group);
+    }
+    for (uint32_t i = 0; i < walkers.size(); i++) {
+        MotorGroup& group = groups[i / kLanes];
+        const uint32_t lane = i % kLanes;
+        if (group.degenerate[lane] == 0.0f) continue;
+        XMFLOAT3 up;
+        XMFLOAT3 forward = { group.fx[lane], group.fy[lane], group.fz[lane] };
+        XMFLOAT3 right;
+        UpdateLocalFrame(up, forward, right, { group.gx[lane], group.gy[lane], group.gz[lane] });
+        group.ux[lane] = up.x;       group.uy[lane] = up.y;       group.uz[lane] = up.z;
+        group.lfx[lane] = forward.x; group.lfy[lane] = forward.y; group.lfz[lane] = forward.z;
+        group.lrx[lane] = right.x;   group.lry[lane] = right.y;   group.lrz[lane] = right.z;
+    }
+    for (MotorGroup& group : groups) {
+        ComputeMotion(group);
+    }
+
+    // 3. 控制器之间的重叠：每个管理器每帧一次，在 move 之前
+    FrameVector<physx::PxControllerManager*> managers;
+    for (const Walker& walker : walkers) {
+        if (walker.manager && std::find(managers.begin(), managers.end(), walker.manager) == managers.end()) {
+            managers.push_back(walker.manager);
+        }
+    }
+    for (physx::PxControllerManager* manager : managers) {
+        if (manager->getNbControllers() > 1) {
+            manager->computeInteractions(deltaTime);
+        }
+    }
+    m_Stats.managers = static_cast<uint32_t>(managers.size());
+
+    // 4. move + 回写
+    const physx::PxControllerFilters filters;
+    for (uint32_t i = 0; i < walkers.size(); i++) {
+        const MotorGroup& group = groups[i / kLanes];
+        const uint32_t lane = i % kLanes;
+        CharacterControllerComponent& character = *walkers[i].character;
+        physx::PxController* controller = character.pxController;
+
+        character.localUp = { group.ux[lane], group.uy[lane], group.uz[lane] };
+        character.localForward = { group.lfx[lane], group.lfy[lane], group.lfz[lane] };
+        character.localRight = { group.lrx[lane], group.lry[lane], group.lrz[lane] };
+        character.velocity = { group.vx[lane], group.vy[lane], group.vz[lane] };
+
+        // [来源: PlayerSystem] up 方向决定 PxController 的坡度判定，变化时才设置
+        const physx::PxVec3 pxUp(group.ux[lane], group.uy[lane], group.uz[lane]);
+        if ((controller->getUpDirection() - pxUp).magnitudeSquared() > 1e-10f) {
+            controller->setUpDirection(pxUp);
+        }
+
+        // 跳跃在 move 之前离地（与 wasGrounded 的语义一致）
+        const bool jumped = character.isGrounded && character.wantsToJump;
+        character.wasGrounded = character.isGrounded && !jumped;
+
+        // [来源: PlayerSystem] 角色控制器移动；minDist 0.01 防止微小移动导致的穿透
+        const physx::PxVec3 displacement(group.mx[lane], group.my[lane], group.mz[lane]);
+        s_GroundHitReport.Reset();
+        const physx::PxControllerCollisionFlags collisionFlags =
+            controller->move(displacement, 0.01f, group.dt[lane], filters,
+                             walkers[i].manager ? GetObstacleContext(walkers[i].manager) : nullptr);
+        character.isGrounded = collisionFlags.isSet(physx::PxControllerCollisionFlag::eCOLLISION_DOWN);
+        m_Stats.updated++;
+
+        // 脚下的天体 / 物体：离地时清空；着地但本次没有回报（只碰到其他控制器）时保持不变
+        if (auto* standing = registry.try_get<StandingOnComponent>(walkers[i].entity)) {
+            const entt::entity ground = character.isGrounded ? s_GroundHitReport.GetGround() : entt::null;
+            if ((ground != entt::null || !character.isGrounded) && ground != standing->standingOnEntity) {
+                standing->previousStandingEntity = standing->standingOnEntity;
+                standing->standingOnEntity = ground;
+            }
+        }
+
+        const XMVECTOR up = XMVectorSet(group.ux[lane], group.uy[lane], group.uz[lane], 0.0f);
+
+        // 着陆：去掉向下的速度分量
+        if (character.isGrounded && !character.wasGrounded) {
+            XMVECTOR vel = XMLoadFloat3(&character.velocity);
+            const float velDotUp = XMVectorGetX(XMVector3Dot(vel, up));
+            if (velDotUp < 0.0f) {
+                vel = XMVectorSubtract(vel, XMVectorScale(up, velDotUp));
+                XMStoreFloat3(&character.velocity, vel);
+            }
+        }
+
+        // 只写扇区局部位姿，世界 Transform 由 SectorPhysicsSystem 换算
+        const physx::PxExtendedVec3 pxPos = controller->getPosition();
+        InSectorComponent& inSector = *walkers[i].inSector;
+        inSector.localPosition = { static_cast<float>(pxPos.x), static_cast<float>(pxPos.y), static_cast<float>(pxPos.z) };
+
+        // 角色"站立"朝向 localUp，面向视角偏航后的前方
+        XMVECTOR charForward = XMVector3Normalize(XMVectorSet(group.rfx[lane], group.rfy[lane], group.rfz[lane], 0.0f));
+        const XMVECTOR charRight = XMVector3Normalize(XMVector3Cross(up, charForward));
+        charForward = XMVector3Normalize(XMVector3Cross(charRight, up));
+        XMMATRIX rotMatrix;
+        rotMatrix.r[0] = XMVectorSetW(charRight, 0.0f);
+        rotMatrix.r[1] = XMVectorSetW(up, 0.0f);
+        rotMatrix.r[2] = XMVectorSetW(charForward, 0.0f);
+        rotMatrix.r[3] = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+        XMStoreFloat4(&inSector.localRotation, XMQuaternionRotationMatrix(rotMatrix));
+    }
+}
+
+physx::PxUserControllerHitReport* CharacterControllerBatch::GetHitReport() {
+    return &s_GroundHitReport;
+}
+
+physx::PxObstacleContext* CharacterControllerBatch::GetObstacleContext(physx::PxControllerManager* manager) {
+    if (!manager) return nullptr;
+    for (const auto& entry : m_ObstacleContexts) {
+        if (entry.first == manager) return entry.second;
+    }
+    physx::PxObstacleContext* context = manager->createObstacleContext();
+    m_ObstacleContexts.emplace_back(manager, context);
+    return context;
+}
+
+void CharacterControllerBatch::Shutdown() {
+    for (auto& entry : m_ObstacleContexts) {
+        if (entry.second) entry.second->release();
+    }
+    m_ObstacleContexts.clear();
+}
+
+void CharacterControllerBatch::UpdateLocalFrame(XMFLOAT3& localUp, XMFLOAT3& localForward,
+                                                XMFLOAT3& localRight, const XMFLOAT3& gravityDir) {
+    // localUp = -gravityDir（头顶方向，垂直于切平面）
+    XMVECTOR up = XMVector3Normalize(XMVectorNegate(XMLoadFloat3(&gravityDir)));
+    XMStoreFloat3(&localUp, up);
+
+    // 保持旧的forward方向的切向分量
+    XMVECTOR oldForward = XMLoadFloat3(&localForward);
+    float oldForwardLen = XMVectorGetX(XMVector3Length(oldForward));
+
+    // 如果旧forward无效，使用世界坐标初始化
+    if (oldForwardLen < 0.5f) {
+        // 选择与up最不平行的参考向量
+        XMVECTOR worldZ = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+        XMVECTOR worldX = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+
+        float dotZ = std::abs(XMVectorGetX(XMVector3Dot(up, worldZ)));
+        XMVECTOR reference = (dotZ < 0.9f) ? worldZ : worldX;
+
+        // right = up × reference
+        XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, reference));
+        // forward = right × up
+        XMVECTOR forward = XMVector3Normalize(XMVector3Cross(right, up));
+
+        XMStoreFloat3(&localRight, right);
+        XMStoreFloat3(&localForward, forward);
+        return;
+    }
+
+    // 将旧forward投影到新的切平面上
+    // forward' = forward - (forward · up) * up
+    float dotFwdUp = XMVectorGetX(XMVector3Dot(oldForward, up));
+    XMVECTOR projForward = XMVectorSubtract(oldForward, XMVectorScale(up, dotFwdUp));
+
+    float projLen = XMVectorGetX(XMVector3Length(projForward));
+    if (projLen < 0.001f) {
+        // forward与up平行，需要重新选择
+        XMVECTOR worldZ = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+        XMVECTOR worldX = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+        float dotZ = std::abs(XMVectorGetX(XMVector3Dot(up, worldZ)));
+        XMVECTOR reference = (dotZ < 0.9f) ? worldZ : worldX;
+        projForward = XMVectorSubtract(reference, XMVectorScale(up, XMVectorGetX(XMVector3Dot(reference, up))));
+    }
+
+    XMVECTOR forward = XMVector3Normalize(projForward);
+    // right = up × forward (确保右手坐标系)
+    XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, forward));
+    // 重新计算forward确保正交
+    forward = XMVector3Normalize(XMVector3Cross(right, up));
+
+    XMStoreFloat3(&localForward, forward);
+    XMStoreFloat3(&localRight, right);
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,87 @@
+/**
+ * CharacterControllerBatch.h
+ *
+ * 球面行走角色控制器（PxController）的批量更新：玩家和任意数量的 NPC 行走者共用一条路径
+ *
+ * 每帧：
+ * 1. 收集：按与玩家的距离分配更新间隔（近处每帧、中距离隔帧、远处每 farInterval 帧，按实体错开相位），
+ *    跳过的控制器累积时间，轮到时一次处理
+ * 2. SIMD：每 4 个控制器一组（SoA），一次算出 localUp / 切平面参考系、视角偏航后的方向、
+ *    速度积分（地面 / 空中 / 跳跃按掩码选择）和本次位移；退化情况（无重力、前方与 up 平行）逐个修正
+ * 3. 每个 PxControllerManager 调用一次 computeInteractions（控制器之间的重叠），
+ *    然后逐个 setUpDirection（有变化时）+ move，move 带上该管理器的障碍物上下文
+ * 4. 回写：着地状态、InSectorComponent 局部位置 / 姿态，以及 StandingOnComponent（脚下的 actor，
+ *    来自 move 期间的 onShapeHit；CCT 不产生模拟接触，物理事件队列里没有它的地面接触）
+ *
+ * 在 PhysX 可访问窗口内由 PlayerSystem::Update 调用，可能在工作线程上执行：与其他 PhysX 使用者
+ * （以及共用的碰撞回报）的互斥完全依赖 PlayerSystem 对 kPhysXScene 的独占写声明，放宽该声明前必须先改掉共享状态。
+ */
+
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace outer_wilds {
+
+class CharacterControllerBatch {
+public:
+    struct Settings {
+        float fullRateDistance = 60.0f;     // 此距离内每帧更新
+        float halfRateDistance = 250.0f;    // 此距离内隔帧更新
+        uint32_t farInterval = 4;           // 更远处每 N 帧更新
+    };
+
+    struct Stats {
+        uint32_t controllers = 0;           // 参与调度的控制器
+        uint32_t updated = 0;               // 本帧执行了 move 的控制器
+        uint32_t managers = 0;              // 本帧涉及的 PxControllerManager
+    };
+
+    CharacterControllerBatch() = default;
+    ~CharacterControllerBatch() { Shutdown(); }
+    CharacterControllerBatch(const CharacterControllerBatch&) = delete;
+    CharacterControllerBatch& operator=(const CharacterControllerBatch&) = delete;
+
+    /** @brief 更新所有未暂停的 CharacterControllerComponent（需要 GravityAffected / InSector / Transform） */
+    void Update(float deltaTime, entt::registry& registry);
+
+    /**
+     * @brief 控制器管理器的障碍物上下文（首次调用时创建）
+     *
+     * 每次 move 都带上它：没有 PhysX actor 的轻量障碍（盒 / 胶囊）可以加在这里，所有行走者都会绕开
+     */
+    physx::PxObstacleContext* GetObstacleContext(physx::PxControllerManager* manager);
+
+    /**
+     * @brief 所有行走者 PxController 共用的碰撞回报（创建控制器时设为 PxControllerDesc::reportCallback）
+     *
+     * 只在 move 期间记录脚下（法线朝向控制器 up）的 actor，用于更新 StandingOnComponent。
+     * 回报对象是进程内唯一的共享状态：所有 move 都在持有 kPhysXScene 写声明的 PlayerSystem 中串行执行
+     */
+    static physx::PxUserControllerHitReport* GetHitReport();
+
+    /** @brief 释放障碍物上下文（析构时也会调用；必须在 PhysXManager 释放控制器管理器之前） */
+    void Shutdown();
+
+    /**
+     * @brief 重力方向变化后更新局部参考系：localUp = -gravityDir，localForward / localRight 保持在切平面上
+     */
+    static void UpdateLocalFrame(DirectX::XMFLOAT3& localUp, DirectX::XMFLOAT3& localForward,
+                                 DirectX::XMFLOAT3& localRight, const DirectX::XMFLOAT3& gravityDir);
+
+    void SetSettings(const Settings& settings) { m_Settings = settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    Settings m_Settings;
+    Stats m_Stats;
+    uint32_t m_FrameIndex = 0;
+    std::vector<std::pair<physx::PxControllerManager*, physx::PxObstacleContext*>> m_ObstacleContexts;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,145 @@
+#include "ImpactDebrisSystem.h"
+#include "../core/DebugManager.h"
+#include "../core/Profiler.h"
+#include "../graphics/resources/TerrainGenerator.h"
+#include "../physics/PhysicsEvents.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include "../physics/components/SectorComponent.h"
+#include "../scene/SceneAssetLoader.h"
+#include "../scene/components/PrefabInstanceComponent.h"
+#include <algorithm>
+#include <cmath>
+
+namespace outer_wilds {
+
+using namespace components;
+
+ImpactDebrisSystem::~ImpactDebrisSystem() {
+    Shutdown();
+}
+
+void ImpactDebrisSystem::Initialize() {
+}
+
+void ImpactDebrisSystem::Initialize(std::shared_ptr<Scene> scene, ID3D11Device* device) {
+    m_Scene = scene;
+
+    auto mesh = std::make_shared<resources::Mesh>();
+    resources::TerrainGenerator::CreateSphere(*mesh, 1.0f, 4, 6);
+    if (device) mesh->CreateGPUBuffers(device);
+
+    PrefabColliderDesc collider;
+    collider.shape = PrefabColliderDesc::Shape::Sphere;
+    collider.sphereRadius = kFragmentRadius;
+    collider.mass = 2.0f;
+    collider.restitution = 0.3f;
+    auto prefab = Prefab::Create(mesh, SceneAssetLoader::CreateMaterialResource(device, ""),
+                                 DirectX::BoundingSphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f),
+                                 DirectX::XMFLOAT3(kFragmentRadius, kFragmentRadius, kFragmentRadius), collider);
+    if (!prefab || !prefab->HasCollider()) {
+        DebugManager::GetInstance().Log("ImpactDebris", "Debris prefab has no collider; impact debris disabled");
+        return;
+    }
+
+    m_Pool = std::make_unique<PrefabPool>(prefab);
+    m_Pool->Prewarm(kMaxLiveFragments);
+    m_ImpactSubscription = PhysicsEventQueue::GetInstance().Subscribe(
+        PhysicsEventMask(PhysicsEvent::Type::Impact),
+        [this](entt::registry& registry, const PhysicsEvent& event) { OnImpact(registry, event); });
+}
+
+void ImpactDebrisSystem::DeclareAccess(SystemAccess& access) const {
+    // Despawn 销毁实体并把 actor 移出场景
+    access.WriteResource(SystemAccess::kEntities)
+          .WriteResource(SystemAccess::kPhysXScene)
+          .MainThread();
+}
+
+void ImpactDebrisSystem::Update(float deltaTime, entt::registry& registry) {
+    if (!m_Pool || m_Bursts.empty()) return;
+    PROFILE_SCOPE("ImpactDebrisSystem::Update");
+
+    for (size_t i = 0; i < m_Bursts.size();) {
+        Burst& burst = m_Bursts[i];
+        burst.remaining -= deltaTime;
+        if (burst.remaining > 0.0f) {
+            i++;
+            continue;
+        }
+        // 碎片可能已被别处销毁：Despawn 忽略无效 / 不属于本池的实体
+        m_Pool->Despawn(registry, burst.entities.data(), burst.entities.size());
+        m_Bursts[i] = std::move(m_Bursts.back());
+        m_Bursts.pop_back();
+    }
+}
+
+void ImpactDebrisSystem::OnImpact(entt::registry& registry, const PhysicsEvent& event) {
+    if (!m_Pool) return;
+
+    // 运动的一方（扇区地面没有 InSectorComponent）；法线从 other 指向 entity
+    const bool entityMoves = event.entity != entt::null && registry.valid(event.entity) &&
+                             registry.all_of<InSectorComponent>(event.entity);
+    const entt::entity body = entityMoves ? event.entity : event.other;
+    if (body == entt::null || !registry.valid(body) || registry.all_of<PrefabInstanceComponent>(body)) return;
+    const auto* inSector = registry.try_get<InSectorComponent>(body);
+    const auto* rigidBody = registry.try_get<RigidBodyComponent>(body);
+    if (!inSector || inSector->sector == entt::null || !rigidBody) return;
+    if (event.impulse < rigidBody->mass * kMinImpactSpeed) return;
+
+    const uint32_t live = m_Pool->GetStats().live;
+    if (live + kFragmentsPerImpact > kMaxLiveFragments) return;
+
+    using namespace DirectX;
+    XMVECTOR normal = XMLoadFloat3(&event.normal);
+    if (!entityMoves) normal = XMVectorNegate(normal);
+    normal = XMVector3Normalize(normal);
+    if (XMVector3Equal(normal, XMVectorZero())) return;
+
+    // 碎片继承撞击物体的一部分速度，再沿法线半球散开
+    XMVECTOR bodyVelocity = XMVectorZero();
+    if (auto* dynamic = rigidBody->physxActor ? rigidBody->physxActor->is<physx::PxRigidDynamic>() : nullptr) {
+        const physx::PxVec3 v = dynamic->getLinearVelocity();
+        bodyVelocity = XMVectorSet(v.x, v.y, v.z, 0.0f);
+    }
+    const float speed = (std::min)(event.impulse / rigidBody->mass, 20.0f);
+
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    m_Positions.resize(kFragmentsPerImpact);
+    m_Velocities.resize(kFragmentsPerImpact);
+    m_AngularVelocities.resize(kFragmentsPerImpact);
+    const XMVECTOR contact = XMLoadFloat3(&event.position);
+    for (uint32_t i = 0; i < kFragmentsPerImpact; i++) {
+        XMVECTOR dir = XMVectorSet(unit(m_Rng), unit(m_Rng), unit(m_Rng), 0.0f);
+        dir = XMVector3Normalize(XMVectorAdd(dir, XMVectorScale(normal, 1.5f)));
+        // 起点抬离表面一个碎片半径，避免生成时就压进地面
+        XMStoreFloat3(&m_Positions[i], XMVectorAdd(contact, XMVectorScale(dir, kFragmentRadius * 2.0f)));
+        XMStoreFloat3(&m_Velocities[i], XMVectorAdd(XMVectorScale(bodyVelocity, 0.3f),
+                                                    XMVectorScale(dir, speed * (0.5f + 0.25f * (unit(m_Rng) + 1.0f)))));
+        m_AngularVelocities[i] = { unit(m_Rng) * 10.0f, unit(m_Rng) * 10.0f, unit(m_Rng) * 10.0f };
+    }
+
+    PrefabSpawnBatch batch;
+    batch.sector = inSector->sector;
+    batch.positions = m_Positions.data();
+    batch.linearVelocities = m_Velocities.data();
+    batch.angularVelocities = m_AngularVelocities.data();
+    batch.count = kFragmentsPerImpact;
+
+    Burst burst;
+    burst.entities.resize(kFragmentsPerImpact);
+    const size_t spawned = m_Pool->Spawn(registry, batch, burst.entities.data());
+    if (spawned == 0) return;
+    burst.entities.resize(spawned);
+    burst.remaining = kFragmentLifetime;
+    m_Bursts.push_back(std::move(burst));
+}
+
+void ImpactDebrisSystem::Shutdown() {
+    PhysicsEventQueue::GetInstance().Unsubscribe(m_ImpactSubscription);
+    m_ImpactSubscription = PhysicsEventQueue::kInvalidSubscription;
+    if (m_Pool && m_Scene) m_Pool->Clear(m_Scene->GetRegistry());
+    m_Pool.reset();
+    m_Bursts.clear();
+}
+
+} // namespace outer_wilds
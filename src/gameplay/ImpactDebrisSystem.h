@@ -0,0 +1,65 @@
+/**
+ * ImpactDebrisSystem.h
+ *
+ * 撞击碎片：报告撞击的物体（飞船）重撞地面时，在接触点喷出一批预制体碎片，几秒后回收
+ *
+ * - 碎片是程序生成的小球网格 + 共享球形碰撞体的 Prefab，由 PrefabPool 成批生成 / 回收（actor 复用）
+ * - 生成在 PhysicsEventQueue 的 Impact 监听者里（FinishStep 之后的 PhysX 访问窗口），
+ *   位置和速度都是撞击物体所在扇区的局部坐标；碎片自己不报告接触，不会连锁产生碎片
+ * - 回收在 Update 里：每批碎片一个剩余寿命，到期整批 Despawn
+ */
+
+#pragma once
+#include "../core/ECS.h"
+#include "../scene/Scene.h"
+#include "../scene/Prefab.h"
+#include <d3d11.h>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace outer_wilds {
+
+struct PhysicsEvent;
+
+class ImpactDebrisSystem : public System {
+public:
+    ImpactDebrisSystem() = default;
+    ~ImpactDebrisSystem() override;
+
+    void Initialize() override;
+    void Initialize(std::shared_ptr<Scene> scene, ID3D11Device* device);
+    void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
+    void Shutdown() override;
+
+    PrefabPool::Stats GetStats() const { return m_Pool ? m_Pool->GetStats() : PrefabPool::Stats{}; }
+
+private:
+    static constexpr uint32_t kFragmentsPerImpact = 12;
+    static constexpr uint32_t kMaxLiveFragments = 96;
+    static constexpr float kFragmentLifetime = 6.0f;        // 秒
+    static constexpr float kMinImpactSpeed = 4.0f;          // 冲量 / 质量（m/s）低于此值不产生碎片
+    static constexpr float kFragmentRadius = 0.15f;         // 米
+
+    struct Burst {
+        std::vector<entt::entity> entities;
+        float remaining = 0.0f;
+    };
+
+    void OnImpact(entt::registry& registry, const PhysicsEvent& event);
+
+    std::shared_ptr<Scene> m_Scene;
+    std::unique_ptr<PrefabPool> m_Pool;
+    std::vector<Burst> m_Bursts;
+    uint32_t m_ImpactSubscription = 0;
+    std::mt19937 m_Rng{ 0x0de6u };
+
+    // 生成缓冲（保留容量）
+    std::vector<DirectX::XMFLOAT3> m_Positions;
+    std::vector<DirectX::XMFLOAT3> m_Velocities;
+    std::vector<DirectX::XMFLOAT3> m_AngularVelocities;
+};
+
+} // namespace outer_wilds
@@ -11,7 +11,7 @@
 
 #include "PlayerSystem.h"
 #include "../scene/components/TransformComponent.h"
-#include "../scene/components/ChildEntityComponent.h"
+#include "../scene/components/HierarchyComponent.h"
 #include "components/PlayerComponent.h"
 #include "components/PlayerInputComponent.h"
 #include "components/CharacterControllerComponent.h"
@@ -23,6 +23,7 @@
 #include "../physics/components/GravityAffectedComponent.h"
 #include "../physics/components/RigidBodyComponent.h"
 #include "../physics/PhysXManager.h"
+#include "../physics/SceneQueryService.h"
 #include "../input/InputManager.h"
 #include "../core/DebugManager.h"
 #include <DirectXMath.h>
@@ -35,6 +36,19 @@ namespace outer_wilds {
 using namespace components;
 using namespace DirectX;
 
+namespace {
+    // 多材质模型的子网格挂在主实体的层级下，与主实体一起显示/隐藏
+    void SetChildMeshesVisible(entt::registry& registry, entt::entity parent, bool visible) {
+        const auto* node = registry.try_get<HierarchyComponent>(parent);
+        for (entt::entity child = node ? node->firstChild : entt::null; child != entt::null;) {
+            if (auto* mesh = registry.try_get<MeshComponent>(child)) {
+                mesh->isVisible = visible;
+            }
+            child = registry.get<HierarchyComponent>(child).nextSibling;
+        }
+    }
+}
+
 void PlayerSystem::Initialize() {
     std::cout << "[PlayerSystem] Initialized with surface walking support" << std::endl;
 }
@@ -44,6 +58,16 @@ void PlayerSystem::Initialize(std::shared_ptr<Scene> scene) {
     Initialize();
 }
 
+void PlayerSystem::DeclareAccess(SystemAccess& access) const {
+    // 只读输入快照（InputManager 由 Engine 在帧开头更新）；角色控制器移动写 PhysX 场景
+    access.Write<TransformComponent, PlayerComponent, PlayerInputComponent, CharacterControllerComponent,
+                 PlayerSpacecraftInteractionComponent, SpacecraftComponent, CameraComponent, MeshComponent>()
+          .Read<HierarchyComponent, FreeCameraComponent, InSectorComponent, SectorComponent,
+                GravityAffectedComponent, RigidBodyComponent>()
+          .ReadResource(SystemAccess::kInput)
+          .WriteResource(SystemAccess::kPhysXScene);
+}
+
 void PlayerSystem::Update(float deltaTime, entt::registry& registry) {
     ProcessPlayerInput(deltaTime, registry);
     UpdateSpacecraftInteraction(deltaTime, registry);
@@ -52,11 +76,12 @@ void PlayerSystem::Update(float deltaTime, entt::registry& registry) {
 }
 
 void PlayerSystem::Shutdown() {
-    // Cleanup player system
+    // 障碍物上下文属于控制器管理器，需在 PhysXManager 释放管理器之前释放
+    m_ControllerBatch.Shutdown();
 }
 
 void PlayerSystem::ProcessPlayerInput(float deltaTime, entt::registry& registry) {
-    InputManager::GetInstance().Update();
+    // InputManager 由 Engine 在帧开头更新（录制/回放在同一位置）
 
     // 如果自由相机激活，则屏蔽玩家输入，避免干涉玩家实体
     bool freeCameraActive = false;
@@ -105,7 +130,7 @@ void PlayerSystem::ProcessPlayerInput(float deltaTime, entt::registry& registry)
         character.forwardInput = playerInput.moveInput.y;   // W/S
         character.rightInput = playerInput.moveInput.x;     // A/D
         character.wantsToJump = playerInput.jumpPressed;
-        character.wantsToRun = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
+        character.wantsToRun = InputManager::GetInstance().IsKeyHeld(VK_SHIFT);
         
         // 鼠标视角旋转
         if (playerInput.mouseLookEnabled) {
@@ -119,248 +144,20 @@ void PlayerSystem::ProcessPlayerInput(float deltaTime, entt::registry& registry)
     }
 }
 
-/**
- * 更新局部坐标系（基于重力方向）
- * localUp = -gravityDir（头顶方向）
- * localForward/localRight 在切平面上，用于计算移动方向
- */
-void PlayerSystem::UpdateLocalCoordinateFrame(XMFLOAT3& localUp, XMFLOAT3& localForward, 
-                                               XMFLOAT3& localRight, const XMFLOAT3& gravityDir) {
-    // localUp = -gravityDir（头顶方向，垂直于切平面）
-    XMVECTOR up = XMVector3Normalize(XMVectorNegate(XMLoadFloat3(&gravityDir)));
-    XMStoreFloat3(&localUp, up);
-    
-    // 保持旧的forward方向的切向分量
-    XMVECTOR oldForward = XMLoadFloat3(&localForward);
-    float oldForwardLen = XMVectorGetX(XMVector3Length(oldForward));
-    
-    // 如果旧forward无效，使用世界坐标初始化
-    if (oldForwardLen < 0.5f) {
-        // 选择与up最不平行的参考向量
-        XMVECTOR worldZ = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
-        XMVECTOR worldX = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
-        
-        float dotZ = std::abs(XMVectorGetX(XMVector3Dot(up, worldZ)));
-        XMVECTOR reference = (dotZ < 0.9f) ? worldZ : worldX;
-        
-        // right = up × reference
-        XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, reference));
-        // forward = right × up
-        XMVECTOR forward = XMVector3Normalize(XMVector3Cross(right, up));
-        
-        XMStoreFloat3(&localRight, right);
-        XMStoreFloat3(&localForward, forward);
-        return;
-    }
-    
-    // 将旧forward投影到新的切平面上
-    // forward' = forward - (forward · up) * up
-    float dotFwdUp = XMVectorGetX(XMVector3Dot(oldForward, up));
-    XMVECTOR projForward = XMVectorSubtract(oldForward, XMVectorScale(up, dotFwdUp));
-    
-    float projLen = XMVectorGetX(XMVector3Length(projForward));
-    if (projLen < 0.001f) {
-        // forward与up平行，需要重新选择
-        XMVECTOR worldZ = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
-        XMVECTOR worldX = XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
-        float dotZ = std::abs(XMVectorGetX(XMVector3Dot(up, worldZ)));
-        XMVECTOR reference = (dotZ < 0.9f) ? worldZ : worldX;
-        projForward = XMVectorSubtract(reference, XMVectorScale(up, XMVectorGetX(XMVector3Dot(reference, up))));
-    }
-    
-    XMVECTOR forward = XMVector3Normalize(projForward);
-    // right = up × forward (确保右手坐标系)
-    XMVECTOR right = XMVector3Normalize(XMVector3Cross(up, forward));
-    // 重新计算forward确保正交
-    forward = XMVector3Normalize(XMVector3Cross(right, up));
-    
-    XMStoreFloat3(&localForward, forward);
-    XMStoreFloat3(&localRight, right);
-}
-
-/**
- * 地面射线检测
- */
-bool PlayerSystem::GroundRaycast(const XMFLOAT3& origin, const XMFLOAT3& dir, 
-                                  float maxDist, XMFLOAT3& hitPoint, XMFLOAT3& hitNormal) {
-    auto* pxScene = PhysXManager::GetInstance().GetScene();
-    if (!pxScene) return false;
-    
-    physx::PxVec3 pxOrigin(origin.x, origin.y, origin.z);
-    physx::PxVec3 pxDir(dir.x, dir.y, dir.z);
-    pxDir.normalize();
-    
-    physx::PxRaycastBuffer hit;
-    if (pxScene->raycast(pxOrigin, pxDir, maxDist, hit, 
-                         physx::PxHitFlag::ePOSITION | physx::PxHitFlag::eNORMAL)) {
-        hitPoint = { hit.block.position.x, hit.block.position.y, hit.block.position.z };
-        hitNormal = { hit.block.normal.x, hit.block.normal.y, hit.block.normal.z };
-        return true;
-    }
-    return false;
-}
-
 /**
  * 表面行走更新
- * 使用 PxController 的 move 方法和 setUpDirection 实现球面行走
- * - 每帧更新 upDirection 为 -gravityDir
- * - PxController 会自动处理坡度检测
+ * 所有 CharacterControllerComponent（玩家和 NPC 行走者）由 CharacterControllerBatch 批量处理：
+ * SIMD 计算参考系 / 位移，每个控制器管理器一次 computeInteractions，远处的控制器降频更新
  */
 void PlayerSystem::UpdateSurfaceWalking(float deltaTime, entt::registry& registry) {
-    auto view = registry.view<CharacterControllerComponent, GravityAffectedComponent, 
-                              InSectorComponent, TransformComponent>();
-    
-    for (auto entity : view) {
-        auto& character = view.get<CharacterControllerComponent>(entity);
-        auto& gravity = view.get<GravityAffectedComponent>(entity);
-        auto& inSector = view.get<InSectorComponent>(entity);
-        auto& transform = view.get<TransformComponent>(entity);
-
-        // 正在驾驶飞船时，不更新地面行走逻辑
-        if (auto* interaction = registry.try_get<PlayerSpacecraftInteractionComponent>(entity)) {
-            if (interaction->isPiloting) {
-                continue;
-            }
-        }
-
-        if (!character.pxController) continue;
-        
-        // Debug: 第一帧详细检查
-        static bool firstFrame = true;
-        static int frameCount = 0;
-        frameCount++;
-        
-
-        
-        // 1. 更新局部坐标系（基于重力方向）
-        UpdateLocalCoordinateFrame(character.localUp, character.localForward, 
-                                   character.localRight, gravity.currentGravityDir);
-        
-        // 2. 关键：设置 PxController 的 up 方向
-        // 这让 PhysX 知道什么是"上"，从而正确处理坡度
-        physx::PxVec3 pxUp(character.localUp.x, character.localUp.y, character.localUp.z);
-        character.pxController->setUpDirection(pxUp);
-        
-        // 3. 获取当前位置
-        physx::PxExtendedVec3 pxPos = character.pxController->getPosition();
-        XMFLOAT3 currentPos = { (float)pxPos.x, (float)pxPos.y, (float)pxPos.z };
-        
-        // 4. 计算移动方向（相对于视角yaw和局部坐标系）
-        XMVECTOR up = XMLoadFloat3(&character.localUp);
-        XMVECTOR fwd = XMLoadFloat3(&character.localForward);
-        XMVECTOR right = XMLoadFloat3(&character.localRight);
-        
-        // 绕localUp旋转forward以应用yaw
-        XMMATRIX yawRotation = XMMatrixRotationAxis(up, character.cameraYaw);
-        XMVECTOR rotatedForward = XMVector3TransformNormal(fwd, yawRotation);
-        XMVECTOR rotatedRight = XMVector3TransformNormal(right, yawRotation);
-        
-        // 5. 计算移动向量（在切平面上）
-        float speed = character.wantsToRun ? character.runSpeed : character.moveSpeed;
-        
-        XMVECTOR moveDir = XMVectorAdd(
-            XMVectorScale(rotatedForward, character.forwardInput),
-            XMVectorScale(rotatedRight, character.rightInput)
-        );
-        
-        float inputMagnitude = XMVectorGetX(XMVector3Length(moveDir));
-        if (inputMagnitude > 0.01f) {
-            moveDir = XMVector3Normalize(moveDir);
-        }
-        
-        // 水平移动量
-        XMVECTOR horizontalMove = XMVectorScale(moveDir, speed * inputMagnitude * deltaTime);
-        
-        // 6. 处理重力和跳跃
-        XMVECTOR vel = XMLoadFloat3(&character.velocity);
-        
-        // 使用上一帧的grounded状态来决定当前帧的行为
-        if (character.isGrounded) {
-            // 在地面上：重置垂直速度
-            // 将速度投影到切平面
-            float velDotUp = XMVectorGetX(XMVector3Dot(vel, up));
-            if (velDotUp < 0) {  // 只清除向下的速度
-                vel = XMVectorSubtract(vel, XMVectorScale(up, velDotUp));
-            }
-            
-            // 跳跃
-            if (character.wantsToJump) {
-                vel = XMVectorAdd(vel, XMVectorScale(up, character.jumpForce));
-                character.isGrounded = false;
-            }
-        } else {
-            // 空中：应用重力
-            float gravityAccel = gravity.currentGravityStrength;
-            XMVECTOR gravityDir = XMLoadFloat3(&gravity.currentGravityDir);
-            vel = XMVectorAdd(vel, XMVectorScale(gravityDir, gravityAccel * deltaTime));
-            
-            // 空中控制（较弱）
-            horizontalMove = XMVectorScale(horizontalMove, character.airControl);
-        }
-        
-        XMStoreFloat3(&character.velocity, vel);
-        
-        // 7. 组合移动向量（水平 + 垂直）
-        XMVECTOR verticalMove = XMVectorScale(vel, deltaTime);
-        XMVECTOR totalMove = XMVectorAdd(horizontalMove, verticalMove);
-        
-        XMFLOAT3 moveDelta;
-        XMStoreFloat3(&moveDelta, totalMove);
-        
-        // 8. 调用 PxController::move
-        // minDist 设为 0.01f 防止微小移动导致的穿透问题
-        physx::PxVec3 displacement(moveDelta.x, moveDelta.y, moveDelta.z);
-        physx::PxControllerFilters filters;
-        physx::PxControllerCollisionFlags collisionFlags = character.pxController->move(displacement, 0.01f, deltaTime, filters);
-
-        
-        // 检测碰撞标志，更新grounded状态
-        character.wasGrounded = character.isGrounded;
-        character.isGrounded = (collisionFlags & physx::PxControllerCollisionFlag::eCOLLISION_DOWN) != physx::PxControllerCollisionFlags(0);
-        
-        // Debug: 每60帧打印碰撞状态
-
-        // 如果检测到向下碰撞且在空中，清除垂直速度（着陆）
-        if (character.isGrounded && !character.wasGrounded) {
-            // 将速度投影到切平面，移除垂直分量
-            float velDotUp = XMVectorGetX(XMVector3Dot(vel, up));
-            if (velDotUp < 0) {  // 只有在下落时才清除
-                vel = XMVectorSubtract(vel, XMVectorScale(up, velDotUp));
-                XMStoreFloat3(&character.velocity, vel);
-            }
-        }
-        
-        // 9. 获取新位置并更新 InSectorComponent
-        // 【重要】只更新 inSector.localPosition，不要写 transform.position！
-        // transform.position 会由 SectorPhysicsSystem 根据 localPosition 自动计算世界坐标
-        pxPos = character.pxController->getPosition();
-        inSector.localPosition = { (float)pxPos.x, (float)pxPos.y, (float)pxPos.z };
-        
-        // 10. 计算角色旋转（使角色"站立"朝向localUp，面向前进方向）
-        // charUp = 重力反方向（脚朝向地面）
-        // charForward = 玩家视角前方（投影到切平面）
-        XMVECTOR charUp = XMVector3Normalize(up);
-        XMVECTOR charForward = XMVector3Normalize(rotatedForward);
-        
-        // 确保 forward 和 up 正交
-        XMVECTOR charRight = XMVector3Normalize(XMVector3Cross(charUp, charForward));
-        charForward = XMVector3Normalize(XMVector3Cross(charRight, charUp));
-        
-        // 构建正交旋转矩阵（列向量：X=right, Y=up, Z=forward）
-        // DirectXMath 使用行主序，所以 r[0] 是第一行
-        XMMATRIX rotMatrix;
-        rotMatrix.r[0] = XMVectorSetW(charRight, 0.0f);
-        rotMatrix.r[1] = XMVectorSetW(charUp, 0.0f);
-        rotMatrix.r[2] = XMVectorSetW(charForward, 0.0f);
-        rotMatrix.r[3] = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
-        
-        XMVECTOR quat = XMQuaternionRotationMatrix(rotMatrix);
-        
-        // 【重要】更新 inSector.localRotation 而不是 transform.rotation
-        // 因为 SectorPhysicsSystem 会用 localRotation 来计算世界 rotation
-        XMStoreFloat4(&inSector.localRotation, quat);
-
+    // 正在驾驶飞船时，不更新地面行走逻辑
+    auto pilotView = registry.view<PlayerSpacecraftInteractionComponent, CharacterControllerComponent>();
+    for (auto entity : pilotView) {
+        pilotView.get<CharacterControllerComponent>(entity).suspended =
+            pilotView.get<PlayerSpacecraftInteractionComponent>(entity).isPiloting;
     }
+
+    m_ControllerBatch.Update(deltaTime, registry);
 }
 
 void PlayerSystem::UpdatePlayerCamera(float deltaTime, entt::registry& registry) {
@@ -447,6 +244,9 @@ void PlayerSystem::UpdatePlayerCamera(float deltaTime, entt::registry& registry)
             
             // 相机up方向
             XMStoreFloat3(&camera.up, localUp);
+
+            // 后期锁存使用与 cameraYaw / cameraPitch 相同的灵敏度
+            camera.lateLatchSensitivity = InputManager::GetInstance().GetPlayerInput().mouseLookEnabled ? 0.003f : 0.0f;
         }
     }
 }
@@ -471,11 +271,10 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
     using namespace DirectX;
     
     // 按键状态
-    static bool fKeyWasPressed = false;
     static float fKeyCooldown = 0.0f;
     const float KEY_COOLDOWN_TIME = 0.5f;
     
-    bool fKeyPressed = (GetAsyncKeyState('F') & 0x8000) != 0;
+    const bool fKeyPressed = InputManager::GetInstance().IsActionPressed(InputAction::Interact);
     
     // 更新冷却时间
     if (fKeyCooldown > 0.0f) {
@@ -494,7 +293,7 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
             interaction.showInteractionPrompt = false;
             
             // 处理退出飞船（F键）
-            if (fKeyPressed && !fKeyWasPressed && fKeyCooldown <= 0.0f && interaction.currentSpacecraft != entt::null) {
+            if (fKeyPressed && fKeyCooldown <= 0.0f && interaction.currentSpacecraft != entt::null) {
                 std::cout << "[PlayerSystem] F pressed - Exiting spacecraft!" << std::endl;
                 
                 entt::entity spacecraftEntity = interaction.currentSpacecraft;
@@ -543,14 +342,7 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
                 if (auto* mesh = registry.try_get<MeshComponent>(playerEntity)) {
                     mesh->isVisible = true;
                 }
-                auto childView = registry.view<ChildEntityComponent, MeshComponent>();
-                for (auto childEntity : childView) {
-                    auto& child = childView.get<ChildEntityComponent>(childEntity);
-                    if (child.parent == playerEntity) {
-                        auto& childMesh = childView.get<MeshComponent>(childEntity);
-                        childMesh.isVisible = true;
-                    }
-                }
+                SetChildMeshesVisible(registry, playerEntity, true);
 
                 // 重置飞船状态
                 spacecraft.currentState = SpacecraftComponent::State::IDLE;
@@ -563,7 +355,6 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
                 fKeyCooldown = KEY_COOLDOWN_TIME;
             }
             
-            fKeyWasPressed = fKeyPressed;
             continue;
         }
         
@@ -576,12 +367,43 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
         interaction.distanceToNearest = FLT_MAX;
         interaction.showInteractionPrompt = false;
         
-        // 查找最近的飞船
-        auto spacecraftView = registry.view<SpacecraftComponent, TransformComponent>();
+        // 附近的 actor：上一帧提交的重叠查询（结果延迟一帧），执行后取回并提交下一次
+        auto& sceneQueries = SceneQueryService::GetInstance();
+        if (!sceneQueries.IsPending(interaction.proximityQuery)) {
+            SceneQueryService::Result proximity;
+            if (sceneQueries.GetResult(interaction.proximityQuery, proximity)) {
+                interaction.nearbyActorCount = (std::min)(proximity.touchCount,
+                                                          PlayerSpacecraftInteractionComponent::kMaxNearbyActors);
+                std::copy(proximity.touches, proximity.touches + interaction.nearbyActorCount,
+                          interaction.nearbyActors);
+            } else {
+                interaction.nearbyActorCount = 0;
+            }
+            
+            // 查询在玩家胶囊所在的场景中进行（扇区局部坐标）；飞船是动态 actor，
+            // 跳过静态的扇区地面（其 userData 是扇区实体，且总是与玩家重叠）
+            interaction.proximityQuery = SceneQueryService::kInvalidHandle;
+            auto* character = registry.try_get<CharacterControllerComponent>(playerEntity);
+            auto* playerInSector = registry.try_get<InSectorComponent>(playerEntity);
+            if (character && character->pxController && playerInSector) {
+                physx::PxRigidDynamic* playerActor = character->pxController->getActor();
+                const physx::PxVec3 center(playerInSector->localPosition.x, playerInSector->localPosition.y,
+                                           playerInSector->localPosition.z);
+                interaction.proximityQuery = sceneQueries.Overlap(
+                    playerActor->getScene(), physx::PxSphereGeometry(interaction.proximityRadius),
+                    physx::PxTransform(center), playerActor, true /*dynamicOnly*/);
+            }
+        }
         
-        for (auto scEntity : spacecraftView) {
-            auto& spacecraft = spacecraftView.get<SpacecraftComponent>(scEntity);
-            auto& scTransform = spacecraftView.get<TransformComponent>(scEntity);
+        // 在查询到的 actor 中查找最近的飞船
+        for (uint32_t i = 0; i < interaction.nearbyActorCount; i++) {
+            const entt::entity scEntity = interaction.nearbyActors[i];
+            if (!registry.valid(scEntity)) continue;
+            auto* spacecraftPtr = registry.try_get<SpacecraftComponent>(scEntity);
+            auto* scTransformPtr = registry.try_get<TransformComponent>(scEntity);
+            if (!spacecraftPtr || !scTransformPtr) continue;
+            auto& spacecraft = *spacecraftPtr;
+            auto& scTransform = *scTransformPtr;
             
             // 飞船必须是 IDLE 状态才能被登上
             if (spacecraft.currentState != SpacecraftComponent::State::IDLE) {
@@ -607,7 +429,7 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
         }
         
         // 处理交互按键（F键）
-        if (fKeyPressed && !fKeyWasPressed && fKeyCooldown <= 0.0f) {
+        if (fKeyPressed && fKeyCooldown <= 0.0f) {
             if (interaction.showInteractionPrompt && interaction.nearestSpacecraft != entt::null) {
                 std::cout << "[PlayerSystem] F pressed - Entering spacecraft!" << std::endl;
                 interaction.isPiloting = true;
@@ -621,14 +443,7 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
                  if (auto* mesh = registry.try_get<MeshComponent>(playerEntity)) {
                      mesh->isVisible = false;
                  }
-                 auto childView = registry.view<ChildEntityComponent, MeshComponent>();
-                 for (auto childEntity : childView) {
-                     auto& child = childView.get<ChildEntityComponent>(childEntity);
-                     if (child.parent == playerEntity) {
-                         auto& childMesh = childView.get<MeshComponent>(childEntity);
-                         childMesh.isVisible = false;
-                     }
-                 }
+                 SetChildMeshesVisible(registry, playerEntity, false);
                 
                 // 【关键】唤醒 PhysX actor，确保物理正常工作
                 auto* rigidBody = registry.try_get<RigidBodyComponent>(interaction.nearestSpacecraft);
@@ -643,8 +458,6 @@ void PlayerSystem::UpdateSpacecraftInteraction(float deltaTime, entt::registry&
                 fKeyCooldown = KEY_COOLDOWN_TIME;
             }
         }
-        
-        fKeyWasPressed = fKeyPressed;
     }
 }
 
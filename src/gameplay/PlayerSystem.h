@@ -1,6 +1,7 @@
 #pragma once
 #include "../core/ECS.h"
 #include "../scene/Scene.h"
+#include "CharacterControllerBatch.h"
 #include <DirectXMath.h>
 
 namespace outer_wilds {
@@ -13,24 +14,22 @@ public:
     void Initialize() override;
     void Initialize(std::shared_ptr<Scene> scene);
     void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
     void Shutdown() override;
 
+    const CharacterControllerBatch& GetControllerBatch() const { return m_ControllerBatch; }
+
 private:
     void ProcessPlayerInput(float deltaTime, entt::registry& registry);
     void UpdateSurfaceWalking(float deltaTime, entt::registry& registry);
     void UpdatePlayerCamera(float deltaTime, entt::registry& registry);
     void UpdateSpacecraftInteraction(float deltaTime, entt::registry& registry);
-    
-    // 表面行走辅助函数
-    void UpdateLocalCoordinateFrame(DirectX::XMFLOAT3& localUp, DirectX::XMFLOAT3& localForward, 
-                                     DirectX::XMFLOAT3& localRight, const DirectX::XMFLOAT3& gravityDir);
-    bool GroundRaycast(const DirectX::XMFLOAT3& origin, const DirectX::XMFLOAT3& dir, 
-                       float maxDist, DirectX::XMFLOAT3& hitPoint, DirectX::XMFLOAT3& hitNormal);
 
     entt::entity FindPlayerCamera(entt::entity playerEntity, entt::registry& registry);
     entt::entity FindCameraPlayer(entt::entity cameraEntity, entt::registry& registry);
 
     std::shared_ptr<Scene> m_Scene;
+    CharacterControllerBatch m_ControllerBatch;  // 玩家与 NPC 行走者共用的批量控制器更新
 };
 
 } // namespace outer_wilds
@@ -17,10 +17,16 @@
 #include "../scene/components/TransformComponent.h"
 #include "../physics/components/RigidBodyComponent.h"
 #include "../physics/components/SectorComponent.h"
+#include "../physics/FloatingOrigin.h"
+#include "../physics/components/OrbitComponent.h"
+#include "../physics/components/GravitySourceComponent.h"
+#include "../physics/components/GravityAffectedComponent.h"
 #include "../graphics/components/CameraComponent.h"
 #include "../graphics/components/FreeCameraComponent.h"
+#include "../graphics/CameraService.h"
 #include "../input/InputManager.h"
 #include "../core/DebugManager.h"
+#include "../core/FrameAllocator.h"
 #include <Windows.h>
 #include <cmath>
 #include <algorithm>
@@ -40,14 +46,40 @@ void SpacecraftDrivingSystem::Initialize(std::shared_ptr<Scene> scene) {
     Initialize();
 }
 
+void SpacecraftDrivingSystem::DeclareAccess(SystemAccess& access) const {
+    access.Write<SpacecraftComponent, TransformComponent, CameraComponent>()
+          .Read<RigidBodyComponent, InSectorComponent, SectorComponent, FreeCameraComponent>()
+          .Read<OrbitComponent, GravitySourceComponent, GravityAffectedComponent>()
+          .ReadResource(SystemAccess::kInput)
+          .ReadResource(SystemAccess::kPhysXScene);
+}
+
 void SpacecraftDrivingSystem::Update(float deltaTime, entt::registry& registry) {
+    // 推力和力矩在固定步中施加（PrePhysicsStep），这里只采样输入、读取状态
     ProcessSpacecraftInput(registry);
-    ApplySpacecraftForces(deltaTime, registry);
     UpdateSpacecraftState(registry);
+    UpdateTrajectoryPrediction(registry);
     UpdateSpacecraftCamera(deltaTime, registry);
 }
 
+void SpacecraftDrivingSystem::UpdateTrajectoryPrediction(entt::registry& registry) {
+    if (!m_OrbitSystem) return;
+    
+    auto view = registry.view<SpacecraftComponent, InSectorComponent>();
+    for (auto entity : view) {
+        auto& spacecraft = view.get<SpacecraftComponent>(entity);
+        if (spacecraft.currentState != SpacecraftComponent::State::PILOTED) continue;
+        // 只提交/取回作业，积分在工作线程上进行
+        m_TrajectoryPredictor.Update(registry, entity, *m_OrbitSystem, spacecraft.appliedThrust);
+        return;
+    }
+    if (m_TrajectoryPredictor.HasTrajectory()) {
+        m_TrajectoryPredictor.Clear();
+    }
+}
+
 void SpacecraftDrivingSystem::Shutdown() {
+    m_TrajectoryPredictor.Shutdown();
     DebugManager::GetInstance().Log("SpacecraftDrivingSystem", "Shutdown");
 }
 
@@ -72,34 +104,34 @@ void SpacecraftDrivingSystem::ProcessSpacecraftInput(entt::registry& registry) {
         // === 平移控制（键盘）===
         // W/S - 前后
         float forward = 0.0f;
-        if (GetAsyncKeyState('W') & 0x8000) forward += 1.0f;
-        if (GetAsyncKeyState('S') & 0x8000) forward -= 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld('W')) forward += 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld('S')) forward -= 1.0f;
         
         // A/D - 左右
         float strafe = 0.0f;
-        if (GetAsyncKeyState('D') & 0x8000) strafe += 1.0f;
-        if (GetAsyncKeyState('A') & 0x8000) strafe -= 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld('D')) strafe += 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld('A')) strafe -= 1.0f;
         
         // Shift/Ctrl - 上下
         float vertical = 0.0f;
-        if (GetAsyncKeyState(VK_SHIFT) & 0x8000) vertical += 1.0f;
-        if (GetAsyncKeyState(VK_CONTROL) & 0x8000) vertical -= 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld(VK_SHIFT)) vertical += 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld(VK_CONTROL)) vertical -= 1.0f;
         
         // === 旋转控制：键盘 + 鼠标 ===
         // 方向键左右 - 滚转（绕前向轴旋转）
         float roll = 0.0f;
-        if (GetAsyncKeyState(VK_LEFT) & 0x8000) roll += 1.0f;
-        if (GetAsyncKeyState(VK_RIGHT) & 0x8000) roll -= 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld(VK_LEFT)) roll += 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld(VK_RIGHT)) roll -= 1.0f;
         
         // 方向键上下 - 俯仰
         float pitch = 0.0f;
-        if (GetAsyncKeyState(VK_UP) & 0x8000) pitch += 1.0f;
-        if (GetAsyncKeyState(VK_DOWN) & 0x8000) pitch -= 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld(VK_UP)) pitch += 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld(VK_DOWN)) pitch -= 1.0f;
         
         // Q/E - 偏航（摆动，绕上轴旋转）
         float yaw = 0.0f;
-        if (GetAsyncKeyState('Q') & 0x8000) yaw -= 1.0f;
-        if (GetAsyncKeyState('E') & 0x8000) yaw += 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld('Q')) yaw -= 1.0f;
+        if (InputManager::GetInstance().IsKeyHeld('E')) yaw += 1.0f;
 
         // 鼠标控制俯仰/偏航（仅在开启鼠标视角时生效）
         const auto& playerInput = InputManager::GetInstance().GetPlayerInput();
@@ -168,110 +200,68 @@ void SpacecraftDrivingSystem::GetSpacecraftAxes(
     XMStoreFloat3(&up, upVec);
 }
 
-void SpacecraftDrivingSystem::ApplySpacecraftForces(float deltaTime, entt::registry& registry) {
+void SpacecraftDrivingSystem::PrePhysicsStep(float fixedStep, entt::registry& registry) {
+    (void)fixedStep;
+
+    // 1. 收集本步所有驾驶中的飞船（输入由 ProcessSpacecraftInput 每帧写入组件）
+    struct FlightBody {
+        physx::PxRigidDynamic* actor;
+        SpacecraftComponent* spacecraft;
+        physx::PxQuat rotation;          // 本步开始时的扇区局部姿态
+        physx::PxVec3 angularVelocity;
+    };
+    FrameVector<FlightBody> bodies;
+
     auto view = registry.view<SpacecraftComponent, RigidBodyComponent, InSectorComponent>();
-    
     for (auto entity : view) {
         auto& spacecraft = view.get<SpacecraftComponent>(entity);
-        auto& rigidBody = view.get<RigidBodyComponent>(entity);
-        auto& inSector = view.get<InSectorComponent>(entity);
-        
-        // 只处理 PILOTED 状态
         if (spacecraft.currentState != SpacecraftComponent::State::PILOTED) continue;
-        
-        // 需要有效的 PhysX actor
-        if (!rigidBody.physxActor) continue;
-        
-        auto* dynamicActor = rigidBody.physxActor->is<physx::PxRigidDynamic>();
+        // 休眠扇区中的 actor 禁用了模拟，不能施力
+        if (view.get<InSectorComponent>(entity).hibernating) continue;
+
+        auto& rigidBody = view.get<RigidBodyComponent>(entity);
+        auto* dynamicActor = rigidBody.physxActor ? rigidBody.physxActor->is<physx::PxRigidDynamic>() : nullptr;
         if (!dynamicActor) continue;
-        
-        // 确保飞船是动态模式（非 kinematic）
+
+        // [来源: SpacecraftDrivingSystem] 开始驾驶后的第一步切换为动态刚体（之后不再改动标志）
         if (dynamicActor->getRigidBodyFlags() & physx::PxRigidBodyFlag::eKINEMATIC) {
-            // 切换到动态模式
             dynamicActor->setRigidBodyFlag(physx::PxRigidBodyFlag::eKINEMATIC, false);
             dynamicActor->wakeUp();
         }
-        
-        // 获取飞船局部坐标轴
-        XMFLOAT3 forward, right, up;
-        GetSpacecraftAxes(inSector.localRotation, forward, right, up);
-        
-        // === 计算推力 ===
-        XMVECTOR totalForce = XMVectorZero();
-        
-        // 前后推力 (W/S)
-        if (std::abs(spacecraft.inputForward) > 0.001f) {
-            XMVECTOR fwdVec = XMLoadFloat3(&forward);
-            totalForce = XMVectorAdd(totalForce, 
-                XMVectorScale(fwdVec, spacecraft.inputForward * spacecraft.mainThrust));
-        }
-        
-        // 左右推力 (A/D)
-        if (std::abs(spacecraft.inputStrafe) > 0.001f) {
-            XMVECTOR rightVec = XMLoadFloat3(&right);
-            totalForce = XMVectorAdd(totalForce,
-                XMVectorScale(rightVec, spacecraft.inputStrafe * spacecraft.strafeThrust));
-        }
-        
-        // 上下推力 (Shift/Ctrl)
-        if (std::abs(spacecraft.inputVertical) > 0.001f) {
-            XMVECTOR upVec = XMLoadFloat3(&up);
-            totalForce = XMVectorAdd(totalForce,
-                XMVectorScale(upVec, spacecraft.inputVertical * spacecraft.verticalThrust));
-        }
-        
-        // 应用力
-        XMFLOAT3 force;
-        XMStoreFloat3(&force, totalForce);
-        if (std::abs(force.x) > 0.001f || std::abs(force.y) > 0.001f || std::abs(force.z) > 0.001f) {
-            dynamicActor->addForce(physx::PxVec3(force.x, force.y, force.z), physx::PxForceMode::eFORCE);
-        }
-        
-        // === 计算力矩 ===
-        XMVECTOR totalTorque = XMVectorZero();
-        
-        // 滚转力矩 (Q/E) - 绕 forward 轴旋转
-        if (std::abs(spacecraft.inputRoll) > 0.001f) {
-            XMVECTOR fwdVec = XMLoadFloat3(&forward);
-            totalTorque = XMVectorAdd(totalTorque,
-                XMVectorScale(fwdVec, spacecraft.inputRoll * spacecraft.rollTorque));
-        }
-        
-        // 俯仰力矩 (↑/↓) - 绕 right 轴旋转
-        if (std::abs(spacecraft.inputPitch) > 0.001f) {
-            XMVECTOR rightVec = XMLoadFloat3(&right);
-            totalTorque = XMVectorAdd(totalTorque,
-                XMVectorScale(rightVec, spacecraft.inputPitch * spacecraft.pitchTorque));
-        }
-        
-        // 偏航力矩 (←/→) - 绕 up 轴旋转
-        if (std::abs(spacecraft.inputYaw) > 0.001f) {
-            XMVECTOR upVec = XMLoadFloat3(&up);
-            totalTorque = XMVectorAdd(totalTorque,
-                XMVectorScale(upVec, spacecraft.inputYaw * spacecraft.yawTorque));
-        }
-        
-        // 应用力矩
-        XMFLOAT3 torque;
-        XMStoreFloat3(&torque, totalTorque);
-        if (std::abs(torque.x) > 0.001f || std::abs(torque.y) > 0.001f || std::abs(torque.z) > 0.001f) {
-            dynamicActor->addTorque(physx::PxVec3(torque.x, torque.y, torque.z), physx::PxForceMode::eFORCE);
+        bodies.push_back({ dynamicActor, &spacecraft, dynamicActor->getGlobalPose().q,
+                           dynamicActor->getAngularVelocity() });
+    }
+
+    // 2. 一次计算全部推力 / 力矩，按 PhysX 的累积模式施加（在本步 simulate 中积分）
+    //    飞船模型：前方 +Z、上方 +Y、右方 +X
+    const physx::PxVec3 kForward(0.0f, 0.0f, 1.0f);
+    const physx::PxVec3 kRight(1.0f, 0.0f, 0.0f);
+    const physx::PxVec3 kUp(0.0f, 1.0f, 0.0f);
+    for (const FlightBody& body : bodies) {
+        SpacecraftComponent& spacecraft = *body.spacecraft;
+        const physx::PxVec3 forward = body.rotation.rotate(kForward);
+        const physx::PxVec3 right = body.rotation.rotate(kRight);
+        const physx::PxVec3 up = body.rotation.rotate(kUp);
+
+        const physx::PxVec3 force = forward * (spacecraft.inputForward * spacecraft.mainThrust)
+                                  + right * (spacecraft.inputStrafe * spacecraft.strafeThrust)
+                                  + up * (spacecraft.inputVertical * spacecraft.verticalThrust);
+        spacecraft.appliedThrust = { force.x, force.y, force.z };
+        // [来源: SpacecraftDrivingSystem] 推力
+        if (force.magnitudeSquared() > 1e-6f) {
+            body.actor->addForce(force, physx::PxForceMode::eFORCE);
         }
-        
-        // === 调试输出 ===
-        static int frameCounter = 0;
-        frameCounter++;
-        if (frameCounter % 120 == 0) {  // 每2秒输出一次
-            physx::PxVec3 vel = dynamicActor->getLinearVelocity();
-            physx::PxVec3 angVel = dynamicActor->getAngularVelocity();
-            
-            char debugMsg[256];
-            snprintf(debugMsg, sizeof(debugMsg), 
-                "Input: F=%.1f S=%.1f V=%.1f | R=%.1f P=%.1f Y=%.1f | Vel: %.1f, %.1f, %.1f",
-                spacecraft.inputForward, spacecraft.inputStrafe, spacecraft.inputVertical,
-                spacecraft.inputRoll, spacecraft.inputPitch, spacecraft.inputYaw,
-                vel.x, vel.y, vel.z);
-            DebugManager::GetInstance().Log("Spacecraft", debugMsg);
+
+        const physx::PxVec3 torque = forward * (spacecraft.inputRoll * spacecraft.rollTorque)
+                                   + right * (spacecraft.inputPitch * spacecraft.pitchTorque)
+                                   + up * (spacecraft.inputYaw * spacecraft.yawTorque);
+        if (torque.magnitudeSquared() > 1e-6f) {
+            // [来源: SpacecraftDrivingSystem] 姿态控制力矩
+            body.actor->addTorque(torque, physx::PxForceMode::eFORCE);
+        } else if (spacecraft.attitudeHoldRate > 0.0f && body.angularVelocity.magnitudeSquared() > 1e-6f) {
+            // [来源: SpacecraftDrivingSystem] 姿态保持：没有旋转输入时按 attitudeHoldRate 衰减角速度（与惯量无关）
+            body.actor->addTorque(-body.angularVelocity * spacecraft.attitudeHoldRate,
+                                  physx::PxForceMode::eACCELERATION);
         }
     }
 }
@@ -295,6 +285,17 @@ void SpacecraftDrivingSystem::UpdateSpacecraftState(entt::registry& registry) {
         spacecraft.currentVelocity = { vel.x, vel.y, vel.z };
         spacecraft.currentSpeed = vel.magnitude();
         spacecraft.currentAngularVelocity = { angVel.x, angVel.y, angVel.z };
+
+        // === 调试输出 ===
+        if (spacecraft.currentState == SpacecraftComponent::State::PILOTED && ++m_DebugLogCounter % 120 == 0) {
+            char debugMsg[256];
+            snprintf(debugMsg, sizeof(debugMsg),
+                "Input: F=%.1f S=%.1f V=%.1f | R=%.1f P=%.1f Y=%.1f | Vel: %.1f, %.1f, %.1f",
+                spacecraft.inputForward, spacecraft.inputStrafe, spacecraft.inputVertical,
+                spacecraft.inputRoll, spacecraft.inputPitch, spacecraft.inputYaw,
+                vel.x, vel.y, vel.z);
+            DebugManager::GetInstance().Log("Spacecraft", debugMsg);
+        }
     }
 }
 
@@ -352,8 +353,9 @@ void SpacecraftDrivingSystem::UpdateSpacecraftCamera(float deltaTime, entt::regi
     targetCameraPos = XMVectorSubtract(targetCameraPos, XMVectorScale(worldForward, spacecraft.cameraDistance));
     targetCameraPos = XMVectorAdd(targetCameraPos, XMVectorScale(worldUp, spacecraft.cameraHeight));
     
-    // 相机平滑跟随
-    XMVECTOR currentPos = XMLoadFloat3(&m_CurrentCameraPos);
+    // 相机平滑跟随（浮动原点本帧平移过时，上一帧的相机位置也要跟着平移）
+    XMVECTOR currentPos = XMVectorSubtract(XMLoadFloat3(&m_CurrentCameraPos),
+                                           XMLoadFloat3(&FloatingOrigin::GetInstance().GetFrameShift()));
     if (!m_CameraInitialized) {
         // 首次初始化，直接设置到目标位置
         currentPos = targetCameraPos;
@@ -368,26 +370,28 @@ void SpacecraftDrivingSystem::UpdateSpacecraftCamera(float deltaTime, entt::regi
     // 计算相机注视点：飞船前方一点
     XMVECTOR lookTarget = XMVectorAdd(spacecraftWorldPos, XMVectorScale(worldForward, spacecraft.cameraLookAheadDistance));
     
-    // 更新相机组件
-    auto cameraView = registry.view<CameraComponent, TransformComponent>();
-    for (auto camEntity : cameraView) {
-        // 跳过自由相机模式
-        auto* freeCamera = registry.try_get<FreeCameraComponent>(camEntity);
-        if (freeCamera && freeCamera->isActive) continue;
-        
-        auto& camera = cameraView.get<CameraComponent>(camEntity);
-        auto& camTransform = cameraView.get<TransformComponent>(camEntity);
-        
-        // 设置相机位置
-        XMStoreFloat3(&camTransform.position, currentPos);
-        XMStoreFloat3(&camera.position, currentPos);
-        
-        // 设置相机目标
-        XMStoreFloat3(&camera.target, lookTarget);
-        
-        // 设置相机上方向（使用飞船的上方向）
-        XMStoreFloat3(&camera.up, worldUp);
+    // 更新活动相机（CameraModeSystem 上船时切换到玩家相机；自由相机模式下不接管）
+    auto& cameraService = CameraService::GetInstance();
+    CameraComponent* camera = cameraService.ResolveActiveCamera(registry);
+    if (!camera) return;
+    const entt::entity camEntity = cameraService.GetActiveCamera();
+    auto* freeCamera = registry.try_get<FreeCameraComponent>(camEntity);
+    if (freeCamera && freeCamera->isActive) return;
+
+    // 设置相机位置
+    if (auto* camTransform = registry.try_get<TransformComponent>(camEntity)) {
+        XMStoreFloat3(&camTransform->position, currentPos);
     }
+    XMStoreFloat3(&camera->position, currentPos);
+
+    // 设置相机目标
+    XMStoreFloat3(&camera->target, lookTarget);
+
+    // 设置相机上方向（使用飞船的上方向）
+    XMStoreFloat3(&camera->up, worldUp);
+
+    // 鼠标驱动飞船力矩而不是相机，不做后期锁存
+    camera->lateLatchSensitivity = 0.0f;
 }
 
 } // namespace outer_wilds
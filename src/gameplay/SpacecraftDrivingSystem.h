@@ -17,7 +17,9 @@
 #pragma once
 #include "../core/ECS.h"
 #include "../scene/Scene.h"
+#include "TrajectoryPredictor.h"
 #include <DirectXMath.h>
+#include <cstdint>
 #include <memory>
 
 namespace outer_wilds {
@@ -30,8 +32,21 @@ public:
     void Initialize() override;
     void Initialize(std::shared_ptr<Scene> scene);
     void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
     void Shutdown() override;
 
+    /**
+     * @brief 飞行模型（Engine 固定步循环中、SectorPhysicsSystem::PrePhysicsUpdate 之后，每个 simulate 之前调用）
+     *
+     * 一次收集所有驾驶中的飞船，按本步开始时的 actor 姿态计算推力、姿态控制 / 保持力矩，
+     * 以 PhysX 累积模式（addForce / addTorque）施加；手感与帧率无关，飞船数量增加也只多一次遍历
+     */
+    void PrePhysicsStep(float fixedStep, entt::registry& registry);
+
+    /** @brief 轨迹预测使用轨道系统的快照（Engine 创建系统后设置） */
+    void SetOrbitSystem(const OrbitSystem* orbitSystem) { m_OrbitSystem = orbitSystem; }
+    const TrajectoryPredictor& GetTrajectoryPredictor() const { return m_TrajectoryPredictor; }
+
 private:
     /**
      * 处理飞船输入
@@ -39,12 +54,6 @@ private:
      */
     void ProcessSpacecraftInput(entt::registry& registry);
     
-    /**
-     * 应用飞船力和力矩
-     * 根据输入状态，向 PhysX 刚体施加力和力矩
-     */
-    void ApplySpacecraftForces(float deltaTime, entt::registry& registry);
-    
     /**
      * 获取飞船局部坐标系方向向量
      * 从飞船的旋转四元数提取 forward, right, up 方向
@@ -67,15 +76,25 @@ private:
      * 相机在飞船后上方，平滑跟随飞船移动和旋转
      */
     void UpdateSpacecraftCamera(float deltaTime, entt::registry& registry);
+    
+    /**
+     * 驾驶中的飞船：轮询/提交轨迹预测作业（从不等待）
+     */
+    void UpdateTrajectoryPrediction(entt::registry& registry);
 
     std::shared_ptr<Scene> m_Scene;
     
     // 输入平滑参数
     float m_InputSmoothSpeed = 5.0f;  // 输入过渡速度
+    uint32_t m_DebugLogCounter = 0;
     
     // 相机平滑跟随状态
     DirectX::XMFLOAT3 m_CurrentCameraPos = { 0.0f, 0.0f, 0.0f };
     bool m_CameraInitialized = false;
+    
+    // 轨迹预测
+    const OrbitSystem* m_OrbitSystem = nullptr;
+    TrajectoryPredictor m_TrajectoryPredictor;
 };
 
 } // namespace outer_wilds
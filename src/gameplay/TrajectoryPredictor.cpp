@@ -0,0 +1,273 @@
+#include "TrajectoryPredictor.h"
+#include "components/SpacecraftComponent.h"
+#include "../scene/components/TransformComponent.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include "../physics/components/SectorComponent.h"
+#include "../physics/components/GravityAffectedComponent.h"
+#include <cfloat>
+#include <cmath>
+
+namespace outer_wilds {
+
+using namespace components;
+
+namespace {
+    DirectX::XMFLOAT3 Rotate(const DirectX::XMFLOAT3& v, const DirectX::XMFLOAT4& q) {
+        DirectX::XMFLOAT3 out;
+        DirectX::XMStoreFloat3(&out, DirectX::XMVector3Rotate(DirectX::XMLoadFloat3(&v), DirectX::XMLoadFloat4(&q)));
+        return out;
+    }
+
+    bool SameThrust(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b) {
+        constexpr float kTolerance = 1.0f;   // N
+        return std::abs(a.x - b.x) < kTolerance && std::abs(a.y - b.y) < kTolerance &&
+               std::abs(a.z - b.z) < kTolerance;
+    }
+}
+
+void TrajectoryPredictor::Update(entt::registry& registry, entt::entity spacecraft, const OrbitSystem& orbits,
+                                 const DirectX::XMFLOAT3& localThrust) {
+    // 1. 取回已完成的预测（不等待）
+    if (m_JobRunning) {
+        if (!m_Job.IsDone()) return;
+        m_JobRunning = false;
+        if (!m_DiscardPending) {
+            std::swap(m_Current, m_Pending);
+            m_HasResult = true;
+        }
+        m_DiscardPending = false;
+    }
+
+    // 2. 缓存仍然有效则不重算
+    if (!NeedsRerun(registry, spacecraft, orbits, localThrust)) return;
+    if (!CaptureInput(registry, spacecraft, orbits, localThrust)) {
+        Clear();
+        return;
+    }
+
+    m_CachedSector = registry.get<InSectorComponent>(spacecraft).sector;
+    m_CachedThrust = localThrust;
+    m_RunCount++;
+    m_JobRunning = true;
+    JobSystem::GetInstance().Run([this]() { Integrate(m_PendingInput, m_Pending); }, &m_Job);
+}
+
+void TrajectoryPredictor::Clear() {
+    m_HasResult = false;
+    m_Current.points.clear();
+    m_CachedSector = entt::null;
+    if (m_JobRunning) m_DiscardPending = true;
+}
+
+void TrajectoryPredictor::Shutdown() {
+    if (m_JobRunning) {
+        JobSystem::GetInstance().Wait(m_Job);
+        m_JobRunning = false;
+    }
+}
+
+void TrajectoryPredictor::GetPolyline(std::vector<DirectX::XMFLOAT3>& out) const {
+    out.clear();
+    if (!m_HasResult) return;
+    const auto& origin = FloatingOrigin::GetInstance();
+    out.reserve(m_Current.points.size());
+    for (const auto& point : m_Current.points) {
+        out.push_back(origin.ToRelative(point));
+    }
+}
+
+bool TrajectoryPredictor::NeedsRerun(entt::registry& registry, entt::entity spacecraft, const OrbitSystem& orbits,
+                                     const DirectX::XMFLOAT3& localThrust) const {
+    if (!m_HasResult) return true;
+    const auto* inSector = registry.try_get<InSectorComponent>(spacecraft);
+    if (!inSector || inSector->sector != m_CachedSector) return true;
+    if (!SameThrust(localThrust, m_CachedThrust)) return true;
+
+    // 预测用掉一半，或实际位置偏离预测（碰撞、姿态变化等）
+    const double elapsed = orbits.GetSimulationTime() - m_Current.startTime;
+    const double horizon = m_Current.pointInterval * static_cast<double>(m_Current.points.size());
+    if (m_Current.points.size() < 2 || elapsed < 0.0 || elapsed > horizon * 0.5) return true;
+
+    const auto* transform = registry.try_get<TransformComponent>(spacecraft);
+    if (!transform) return true;
+    const double f = elapsed / m_Current.pointInterval;
+    const size_t i = static_cast<size_t>(f);
+    if (i + 1 >= m_Current.points.size()) return true;
+    const double t = f - static_cast<double>(i);
+    const WorldPosition& a = m_Current.points[i];
+    const WorldPosition& b = m_Current.points[i + 1];
+    const WorldPosition predicted(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t);
+    const WorldPosition d = FloatingOrigin::GetInstance().ToAbsolute(transform->position) - predicted;
+    const double tolerance = m_Settings.deviationTolerance;
+    return d.x * d.x + d.y * d.y + d.z * d.z > tolerance * tolerance;
+}
+
+bool TrajectoryPredictor::CaptureInput(entt::registry& registry, entt::entity spacecraft, const OrbitSystem& orbits,
+                                       const DirectX::XMFLOAT3& localThrust) {
+    const auto* inSector = registry.try_get<InSectorComponent>(spacecraft);
+    const auto* rigidBody = registry.try_get<RigidBodyComponent>(spacecraft);
+    const auto* craft = registry.try_get<SpacecraftComponent>(spacecraft);
+    if (!inSector || !rigidBody || !craft || inSector->sector == entt::null) return false;
+    const auto* sector = registry.try_get<SectorComponent>(inSector->sector);
+    if (!sector || !rigidBody->physxActor) return false;
+    const auto* dynamicActor = rigidBody->physxActor->is<physx::PxRigidDynamic>();
+    if (!dynamicActor) return false;
+
+    Input& input = m_PendingInput;
+    input.settings = m_Settings;
+    orbits.CaptureSnapshot(registry, input.orbits);
+
+    input.sectorBody = input.orbits.Find(inSector->sector);
+    input.sectorPosition = sector->absolutePosition;
+    input.sectorRotation = sector->worldRotation;
+    input.sectorVelocity = sector->worldVelocity;
+    input.sectorInfluenceRadius = sector->influenceRadius;
+    input.sectorPlanetRadius = sector->planetRadius;
+    const auto* sectorGravity = registry.try_get<GravitySourceComponent>(inSector->sector);
+    input.sectorHasGravity = sectorGravity && sectorGravity->isActive;
+    if (input.sectorHasGravity) input.sectorGravity = *sectorGravity;
+
+    input.sources.clear();
+    auto sourceView = registry.view<GravitySourceComponent>();
+    for (auto entity : sourceView) {
+        const auto& gravity = sourceView.get<GravitySourceComponent>(entity);
+        if (!gravity.isActive) continue;
+        GravitySource source;
+        source.body = input.orbits.Find(entity);
+        if (const auto* sourceSector = registry.try_get<SectorComponent>(entity)) {
+            source.fixedPosition = sourceSector->absolutePosition;
+        } else if (const auto* transform = registry.try_get<TransformComponent>(entity)) {
+            source.fixedPosition = FloatingOrigin::GetInstance().ToAbsolute(transform->position);
+        }
+        source.gravity = gravity;
+        input.sources.push_back(source);
+    }
+
+    const physx::PxVec3 velocity = dynamicActor->getLinearVelocity();
+    const float mass = rigidBody->mass > 0.0f ? rigidBody->mass : craft->mass;
+    input.localPosition = inSector->localPosition;
+    input.localVelocity = { velocity.x, velocity.y, velocity.z };
+    input.thrustAcceleration = { localThrust.x / mass, localThrust.y / mass, localThrust.z / mass };
+    const auto* affected = registry.try_get<GravityAffectedComponent>(spacecraft);
+    input.gravityScale = (affected && affected->affectedByGravity) ? affected->gravityScale : 0.0f;
+    input.linearDamping = dynamicActor->getLinearDamping();
+    return true;
+}
+
+void TrajectoryPredictor::Integrate(const Input& input, Trajectory& out) {
+    const Settings& settings = input.settings;
+    const float dt = settings.stepTime;
+    const uint32_t stride = settings.pointStride > 0 ? settings.pointStride : 1;
+    const float damping = 1.0f / (1.0f + dt * input.linearDamping);   // 与 PhysX 的线性阻尼相同
+
+    out.points.clear();
+    out.points.reserve(settings.stepCount / stride + 2);
+    out.startTime = input.orbits.time;
+    out.pointInterval = dt * static_cast<float>(stride);
+    out.hitsSurface = false;
+
+    std::vector<WorldPosition> bodyPositions;
+    std::vector<DirectX::XMFLOAT3> bodyVelocities;
+    std::vector<DirectX::XMFLOAT4> bodyRotations;
+
+    auto sectorPose = [&](WorldPosition& position, DirectX::XMFLOAT4& rotation, DirectX::XMFLOAT3& velocity) {
+        if (input.sectorBody >= 0) {
+            position = bodyPositions[input.sectorBody];
+            rotation = bodyRotations[input.sectorBody];
+            velocity = bodyVelocities[input.sectorBody];
+        } else {
+            position = input.sectorPosition;
+            rotation = input.sectorRotation;
+            velocity = input.sectorVelocity;
+        }
+    };
+
+    // 阶段 1：扇区局部坐标
+    DirectX::XMFLOAT3 p = input.localPosition;
+    DirectX::XMFLOAT3 v = input.localVelocity;
+    const float exitRadius = input.sectorInfluenceRadius * settings.sectorExitScale;
+    uint32_t step = 0;
+    bool inSector = true;
+    WorldPosition worldP;
+    DirectX::XMFLOAT3 worldV = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 worldThrust = { 0.0f, 0.0f, 0.0f };
+
+    for (; step <= settings.stepCount; step++) {
+        const bool record = (step % stride) == 0;
+        const float distance = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        const bool leaving = distance > exitRadius;
+        if (record || leaving) {
+            input.orbits.Evaluate(input.orbits.time + step * static_cast<double>(dt),
+                                  bodyPositions, bodyVelocities, bodyRotations);
+            WorldPosition sectorPosition;
+            DirectX::XMFLOAT4 sectorRotation;
+            DirectX::XMFLOAT3 sectorVelocity;
+            sectorPose(sectorPosition, sectorRotation, sectorVelocity);
+            const WorldPosition worldPoint = sectorPosition + WorldPosition(Rotate(p, sectorRotation));
+            if (record) out.points.push_back(worldPoint);
+            if (leaving) {
+                // 与扇区切换相同：世界速度 = 旋转后的局部速度 + 扇区速度
+                const DirectX::XMFLOAT3 rotatedV = Rotate(v, sectorRotation);
+                worldP = worldPoint;
+                worldV = { rotatedV.x + sectorVelocity.x, rotatedV.y + sectorVelocity.y,
+                           rotatedV.z + sectorVelocity.z };
+                worldThrust = Rotate(input.thrustAcceleration, sectorRotation);
+                inSector = false;
+                break;
+            }
+        }
+        if (distance < input.sectorPlanetRadius) {
+            out.hitsSurface = true;
+            return;
+        }
+
+        DirectX::XMFLOAT3 a = input.thrustAcceleration;
+        if (input.sectorHasGravity && distance > 0.01f) {
+            const float g = input.sectorGravity.CalculateGravityStrength(distance) * input.gravityScale / distance;
+            a.x -= p.x * g;
+            a.y -= p.y * g;
+            a.z -= p.z * g;
+        }
+        v = { (v.x + a.x * dt) * damping, (v.y + a.y * dt) * damping, (v.z + a.z * dt) * damping };
+        p = { p.x + v.x * dt, p.y + v.y * dt, p.z + v.z * dt };
+    }
+    if (inSector) return;
+
+    // 阶段 2：世界坐标，最近的重力源
+    for (step++; step <= settings.stepCount; step++) {
+        input.orbits.Evaluate(input.orbits.time + step * static_cast<double>(dt),
+                              bodyPositions, bodyVelocities, bodyRotations);
+
+        DirectX::XMFLOAT3 a = worldThrust;
+        float nearest = FLT_MAX;
+        const GravitySource* nearestSource = nullptr;
+        WorldPosition toNearest;
+        for (const auto& source : input.sources) {
+            const WorldPosition& center = source.body >= 0 ? bodyPositions[source.body] : source.fixedPosition;
+            const WorldPosition d = center - worldP;
+            const float distance = static_cast<float>(std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z));
+            if (distance < source.gravity.radius) {
+                out.hitsSurface = true;
+                out.points.push_back(worldP);
+                return;
+            }
+            if (distance <= source.gravity.GetInfluenceRadius() && distance < nearest) {
+                nearest = distance;
+                nearestSource = &source;
+                toNearest = d;
+            }
+        }
+        if (nearestSource && nearest > 0.01f) {
+            const float g = nearestSource->gravity.CalculateGravityStrength(nearest) * input.gravityScale / nearest;
+            a.x += static_cast<float>(toNearest.x) * g;
+            a.y += static_cast<float>(toNearest.y) * g;
+            a.z += static_cast<float>(toNearest.z) * g;
+        }
+        worldV = { (worldV.x + a.x * dt) * damping, (worldV.y + a.y * dt) * damping, (worldV.z + a.z * dt) * damping };
+        worldP += WorldPosition(worldV.x * dt, worldV.y * dt, worldV.z * dt);
+
+        if ((step % stride) == 0) out.points.push_back(worldP);
+    }
+}
+
+} // namespace outer_wilds
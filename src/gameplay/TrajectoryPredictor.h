@@ -0,0 +1,128 @@
+/**
+ * TrajectoryPredictor.h
+ *
+ * 飞船轨迹预测（在 JobSystem 工作线程上积分，主线程从不等待）
+ *
+ * 使用与游戏相同的模型：
+ * - 扇区内：在扇区局部坐标中积分，重力指向扇区原点（与 CalculateGravity 的扇区内批次相同），
+ *   线性阻尼与 PhysX 相同；世界坐标由轨道解析求出的未来扇区位姿换算
+ * - 飞出扇区（超过 influenceRadius * sectorExitScale）后：在世界坐标中积分，
+ *   重力取影响范围内最近的重力源，源的位置同样按轨道推算到未来时刻
+ * - 推力按当前值保持不变（方向固定在扇区坐标系中），不积分姿态
+ *
+ * 结果缓存：只有推力、所在扇区变化，或飞船偏离预测轨迹/用掉一半预测时长时才重新计算。
+ */
+
+#pragma once
+#include "../core/JobSystem.h"
+#include "../physics/FloatingOrigin.h"
+#include "../physics/OrbitSystem.h"
+#include "../physics/components/GravitySourceComponent.h"
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace outer_wilds {
+
+class TrajectoryPredictor {
+public:
+    struct Settings {
+        uint32_t stepCount = 1800;          // 积分步数
+        float stepTime = 1.0f / 30.0f;      // 积分步长（秒）
+        uint32_t pointStride = 6;           // 每隔多少步输出一个折线点
+        float sectorExitScale = 1.08f;      // 与 SectorPhysicsSystem 的退出滞后系数一致
+        float deviationTolerance = 5.0f;    // 实际位置偏离预测超过此距离（米）时重新计算
+    };
+
+    /** @brief 一次预测的结果（双精度世界坐标） */
+    struct Trajectory {
+        std::vector<WorldPosition> points;  // points[0] = 起点，之后每 pointInterval 秒一个点
+        double startTime = 0.0;             // 起点的模拟时间（OrbitSystem::GetSimulationTime）
+        float pointInterval = 0.0f;
+        bool hitsSurface = false;           // 轨迹终止于星球表面
+    };
+
+    TrajectoryPredictor() = default;
+    ~TrajectoryPredictor() { Shutdown(); }
+    TrajectoryPredictor(const TrajectoryPredictor&) = delete;
+    TrajectoryPredictor& operator=(const TrajectoryPredictor&) = delete;
+
+    /**
+     * @brief 每帧调用（主线程）：取回已完成的结果，需要时拍摄快照并提交新的预测
+     * @param localThrust 本帧施加的推力（N，扇区局部坐标）
+     */
+    void Update(entt::registry& registry, entt::entity spacecraft, const OrbitSystem& orbits,
+                const DirectX::XMFLOAT3& localThrust);
+
+    /** @brief 丢弃结果（离开驾驶状态时调用）；进行中的作业完成后其结果也会被丢弃 */
+    void Clear();
+
+    /** @brief 等待进行中的作业（系统关闭时调用） */
+    void Shutdown();
+
+    const Trajectory& GetTrajectory() const { return m_Current; }
+    bool HasTrajectory() const { return m_HasResult; }
+
+    /** @brief 当前结果转换为相对浮动原点的折线（HUD/调试渲染使用） */
+    void GetPolyline(std::vector<DirectX::XMFLOAT3>& out) const;
+
+    Settings& GetSettings() { return m_Settings; }
+    uint32_t GetRunCount() const { return m_RunCount; }
+
+private:
+    struct GravitySource {
+        int32_t body = -1;                  // OrbitSnapshot 中的下标；-1 = 固定在 fixedPosition
+        WorldPosition fixedPosition;
+        components::GravitySourceComponent gravity;
+    };
+
+    /** @brief 工作线程的全部输入（主线程拍摄的拷贝） */
+    struct Input {
+        OrbitSnapshot orbits;
+        Settings settings;
+
+        // 当前扇区
+        int32_t sectorBody = -1;
+        WorldPosition sectorPosition;       // sectorBody < 0 时使用的固定位姿
+        DirectX::XMFLOAT4 sectorRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        DirectX::XMFLOAT3 sectorVelocity = { 0.0f, 0.0f, 0.0f };
+        float sectorInfluenceRadius = 0.0f;
+        float sectorPlanetRadius = 0.0f;
+        bool sectorHasGravity = false;
+        components::GravitySourceComponent sectorGravity;
+
+        std::vector<GravitySource> sources;
+
+        // 飞船（扇区局部 / PhysX 坐标）
+        DirectX::XMFLOAT3 localPosition = { 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 localVelocity = { 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 thrustAcceleration = { 0.0f, 0.0f, 0.0f };
+        float gravityScale = 1.0f;
+        float linearDamping = 0.0f;
+    };
+
+    bool CaptureInput(entt::registry& registry, entt::entity spacecraft, const OrbitSystem& orbits,
+                      const DirectX::XMFLOAT3& localThrust);
+    bool NeedsRerun(entt::registry& registry, entt::entity spacecraft, const OrbitSystem& orbits,
+                    const DirectX::XMFLOAT3& localThrust) const;
+    static void Integrate(const Input& input, Trajectory& out);
+
+    Settings m_Settings;
+
+    // 工作线程独占（m_JobRunning 期间主线程不访问）
+    Input m_PendingInput;
+    Trajectory m_Pending;
+    JobCounter m_Job;
+    bool m_JobRunning = false;
+    bool m_DiscardPending = false;
+
+    // 主线程
+    Trajectory m_Current;
+    bool m_HasResult = false;
+    entt::entity m_CachedSector = entt::null;
+    DirectX::XMFLOAT3 m_CachedThrust = { 0.0f, 0.0f, 0.0f };
+    uint32_t m_RunCount = 0;
+};
+
+} // namespace outer_wilds
@@ -1,6 +1,7 @@
 #pragma once
 #include <PxPhysicsAPI.h>
 #include <DirectXMath.h>
+#include <cstdint>
 
 namespace outer_wilds {
 namespace components {
@@ -48,6 +49,11 @@ struct CharacterControllerComponent {
     float cameraYaw = 0.0f;         // 水平旋转（相对于localForward）
     float cameraPitch = 0.0f;       // 垂直旋转
     DirectX::XMFLOAT3 cameraOffset = { 0.0f, 1.6f, 0.0f };  // 相机相对角色的偏移
+
+    // === 批量更新（CharacterControllerBatch）===
+    bool suspended = false;         // 暂停移动（玩家驾驶飞船时）
+    float pendingTime = 0.0f;       // 降频更新时累积的未处理时间
+    uint8_t updateInterval = 1;     // 当前更新间隔（帧），按与玩家的距离决定
 };
 
 } // namespace components
@@ -1,6 +1,8 @@
 #pragma once
 #include <DirectXMath.h>
 #include <entt/entt.hpp>
+#include <cfloat>
+#include <cstdint>
 
 namespace outer_wilds::components {
 
@@ -41,6 +43,7 @@ struct SpacecraftComponent {
     // === 阻尼参数（PhysX 设置）===
     float linearDamping = 0.3f;        // 线性阻尼
     float angularDamping = 5.0f;       // 角阻尼（更高的值使旋转更容易停止）
+    float attitudeHoldRate = 2.0f;     // 姿态保持：无旋转输入时角速度的衰减率（1/s，固定步积分；0 = 关闭）
     
     // === 质量参数 ===
     float mass = 500.0f;               // 飞船质量（kg）
@@ -80,10 +83,11 @@ struct SpacecraftComponent {
     DirectX::XMFLOAT3 currentVelocity = { 0.0f, 0.0f, 0.0f };
     float currentSpeed = 0.0f;
     DirectX::XMFLOAT3 currentAngularVelocity = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 appliedThrust = { 0.0f, 0.0f, 0.0f };  // 最近一个固定步施加的推力（N，扇区局部坐标；轨迹预测使用）
     
-    // === 接地检测 ===
-    bool isGrounded = false;
-    float groundCheckDistance = 3.0f;  // 接地检测距离
+    // === 接地检测（PhysicsEventQueue 的接触 / 睡眠事件，SectorPhysicsSystem::OnPhysicsEvent 维护）===
+    bool isGrounded = false;                    // 接触当前扇区地面并已睡眠（着陆）
+    entt::entity groundContact = entt::null;    // 正在接触的扇区地面（扇区实体）；换扇区时清除
 };
 
 /**
@@ -95,6 +99,13 @@ struct PlayerSpacecraftInteractionComponent {
     entt::entity nearestSpacecraft = entt::null;  // 最近的可交互飞船
     float distanceToNearest = FLT_MAX;            // 到最近飞船的距离
     bool showInteractionPrompt = false;           // 是否显示交互提示
+
+    // 附近 actor 的重叠查询（SceneQueryService，结果延迟一帧）
+    static constexpr uint32_t kMaxNearbyActors = 8;
+    float proximityRadius = 12.0f;                 // 查询半径（应不小于飞船的 interactionDistance）
+    uint32_t proximityQuery = 0;                   // 进行中的查询句柄
+    entt::entity nearbyActors[kMaxNearbyActors] = {};  // 最近一次查询接触到的实体
+    uint32_t nearbyActorCount = 0;
 };
 
 } // namespace outer_wilds::components
@@ -0,0 +1,468 @@
+#include "AtmosphereRenderer.h"
+#include "GpuMemory.h"
+#include "components/AtmosphereComponent.h"
+#include "resources/Shader.h"
+#include "../scene/components/TransformComponent.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+using namespace DirectX;
+
+namespace outer_wilds {
+
+namespace {
+
+constexpr float kPi = 3.14159265f;
+constexpr uint32_t kTransmittanceSteps = 40;
+constexpr uint32_t kMultiScatteringDirections = 8;     // 8 x 8 个方向
+constexpr uint32_t kMultiScatteringSteps = 20;
+constexpr float kShellScale = 1.02f;                   // 外壳网格半径 / 大气半径
+
+/**
+ * @brief 归一化单位（大气层高度 = 1）下某一高度的介质
+ */
+struct Medium {
+    XMVECTOR scattering;        // 瑞利 + 米氏散射
+    XMVECTOR extinction;        // 散射 + 米氏吸收 + 臭氧吸收
+};
+
+// 臭氧层：以 25% 高度为中心、半宽 15% 的三角分布（与地球 25 km / 15 km 同比例）
+float OzoneDensity(float h) {
+    return (std::max)(0.0f, 1.0f - std::fabs(h - 0.25f) / 0.15f);
+}
+
+/**
+ * @brief 射线 (r, mu) 到半径 radius 的球面的距离（无交点返回负数）
+ */
+float DistanceToSphere(float r, float mu, float radius, bool farSide) {
+    const float discriminant = r * r * (mu * mu - 1.0f) + radius * radius;
+    if (discriminant < 0.0f) return -1.0f;
+    const float root = std::sqrt(discriminant);
+    return farSide ? -r * mu + root : -r * mu - root;
+}
+
+/**
+ * @brief 双线性采样 CPU 端的透射率表（与着色器的 TransmittanceUV 相同的映射）
+ */
+XMVECTOR SampleTable(const std::vector<XMFLOAT4>& table, uint32_t width, uint32_t height, float u, float v) {
+    const float x = std::clamp(u, 0.0f, 1.0f) * static_cast<float>(width - 1);
+    const float y = std::clamp(v, 0.0f, 1.0f) * static_cast<float>(height - 1);
+    const uint32_t x0 = static_cast<uint32_t>(x);
+    const uint32_t y0 = static_cast<uint32_t>(y);
+    const uint32_t x1 = (std::min)(x0 + 1, width - 1);
+    const uint32_t y1 = (std::min)(y0 + 1, height - 1);
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+    const XMVECTOR top = XMVectorLerp(XMLoadFloat4(&table[y0 * width + x0]), XMLoadFloat4(&table[y0 * width + x1]), fx);
+    const XMVECTOR bottom = XMVectorLerp(XMLoadFloat4(&table[y1 * width + x0]), XMLoadFloat4(&table[y1 * width + x1]), fx);
+    return XMVectorLerp(top, bottom, fy);
+}
+
+} // namespace
+
+bool AtmosphereRenderer::LutKey::operator==(const LutKey& other) const {
+    return std::memcmp(this, &other, sizeof(LutKey)) == 0;
+}
+
+AtmosphereRenderer::~AtmosphereRenderer() {
+    Clear();
+    if (m_VertexBuffer) m_VertexBuffer->Release();
+    if (m_IndexBuffer) m_IndexBuffer->Release();
+    if (m_ConstantBuffer) m_ConstantBuffer->Release();
+}
+
+bool AtmosphereRenderer::Initialize(ID3D11Device* device) {
+    if (!device) return false;
+    m_Device = device;
+
+    m_Shader = std::make_unique<resources::Shader>();
+    if (!m_Shader->LoadFromFile(device, "atmosphere.vs", "atmosphere.ps", true)) {
+        DebugManager::GetInstance().Log("AtmosphereRenderer", "Failed to load atmosphere shader");
+        return false;
+    }
+    if (!CreateSphere(device)) {
+        DebugManager::GetInstance().Log("AtmosphereRenderer", "Failed to create shell geometry");
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.ByteWidth = sizeof(AtmosphereConstants);
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    if (FAILED(device->CreateBuffer(&cbDesc, nullptr, &m_ConstantBuffer))) {
+        DebugManager::GetInstance().Log("AtmosphereRenderer", "Failed to create constant buffer");
+        return false;
+    }
+    GpuMemory::Track(m_ConstantBuffer);
+
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    m_Sampler = stateCache.GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP);
+
+    // 预乘：color = 散射 + dst * (1 - alpha)，alpha = 1 - 平均透射率；目标 alpha 保持不变
+    D3D11_BLEND_DESC blendDesc = RenderStateCache::BlendDesc(RenderStateCache::BlendMode::Premultiplied);
+    blendDesc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ZERO;
+    blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ONE;
+    m_OutsideState.blend = stateCache.GetBlendState(blendDesc);
+    // 读取深度不写入：外壳被大气前方的几何体遮挡
+    m_OutsideState.depthStencil = stateCache.GetDepthStencilState(true, false, D3D11_COMPARISON_LESS_EQUAL);
+    m_InsideState = m_OutsideState;
+    m_OutsideState.rasterizer = stateCache.GetRasterizerState(D3D11_CULL_BACK);
+    m_InsideState.rasterizer = stateCache.GetRasterizerState(D3D11_CULL_FRONT);
+
+    m_Initialized = m_Sampler && m_OutsideState.blend && m_OutsideState.depthStencil &&
+                    m_OutsideState.rasterizer && m_InsideState.rasterizer;
+    return m_Initialized;
+}
+
+bool AtmosphereRenderer::CreateSphere(ID3D11Device* device) {
+    const int latSegments = 24;
+    const int lonSegments = 48;
+
+    std::vector<XMFLOAT3> vertices;
+    std::vector<uint32_t> indices;
+    for (int lat = 0; lat <= latSegments; lat++) {
+        const float theta = lat * XM_PI / latSegments;
+        for (int lon = 0; lon <= lonSegments; lon++) {
+            const float phi = lon * 2.0f * XM_PI / lonSegments;
+            vertices.push_back(XMFLOAT3(std::cos(phi) * std::sin(theta), std::cos(theta), std::sin(phi) * std::sin(theta)));
+        }
+    }
+    // 从外部看为顺时针（正面），与 SkyboxRenderer 的内向绕序相反
+    for (int lat = 0; lat < latSegments; lat++) {
+        for (int lon = 0; lon < lonSegments; lon++) {
+            const uint32_t first = lat * (lonSegments + 1) + lon;
+            const uint32_t second = first + lonSegments + 1;
+            indices.push_back(first);
+            indices.push_back(second);
+            indices.push_back(first + 1);
+
+            indices.push_back(second);
+            indices.push_back(second + 1);
+            indices.push_back(first + 1);
+        }
+    }
+
+    D3D11_BUFFER_DESC vbDesc = {};
+    vbDesc.ByteWidth = static_cast<UINT>(vertices.size() * sizeof(XMFLOAT3));
+    vbDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    vbDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    D3D11_SUBRESOURCE_DATA vbData = {};
+    vbData.pSysMem = vertices.data();
+    if (FAILED(device->CreateBuffer(&vbDesc, &vbData, &m_VertexBuffer))) return false;
+    GpuMemory::Track(m_VertexBuffer);
+
+    D3D11_BUFFER_DESC ibDesc = {};
+    ibDesc.ByteWidth = static_cast<UINT>(indices.size() * sizeof(uint32_t));
+    ibDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+    D3D11_SUBRESOURCE_DATA ibData = {};
+    ibData.pSysMem = indices.data();
+    if (FAILED(device->CreateBuffer(&ibDesc, &ibData, &m_IndexBuffer))) return false;
+    GpuMemory::Track(m_IndexBuffer);
+
+    m_IndexCount = static_cast<UINT>(indices.size());
+    return true;
+}
+
+AtmosphereRenderer::LutKey AtmosphereRenderer::MakeKey(const components::AtmosphereComponent& atmosphere) {
+    LutKey key;
+    const float density = (std::max)(atmosphere.densityScale, 0.0f);
+    key.groundRadius = atmosphere.planetRadius / atmosphere.atmosphereHeight;
+    key.rayleigh = XMFLOAT3(atmosphere.rayleighScattering.x * density, atmosphere.rayleighScattering.y * density,
+                            atmosphere.rayleighScattering.z * density);
+    key.rayleighScaleHeight = (std::max)(atmosphere.rayleighScaleHeight, 1e-4f);
+    key.mieScattering = atmosphere.mieScattering * density;
+    key.mieExtinction = (std::max)(atmosphere.mieExtinction, atmosphere.mieScattering) * density;
+    key.mieScaleHeight = (std::max)(atmosphere.mieScaleHeight, 1e-4f);
+    key.ozone = XMFLOAT3(atmosphere.ozoneAbsorption.x * density, atmosphere.ozoneAbsorption.y * density,
+                         atmosphere.ozoneAbsorption.z * density);
+    key.groundAlbedo = atmosphere.groundAlbedo;
+    return key;
+}
+
+bool AtmosphereRenderer::CreateLutTexture(uint32_t width, uint32_t height, const std::vector<XMFLOAT4>& texels,
+                                          ID3D11Texture2D** outTexture, ID3D11ShaderResourceView** outSRV) {
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = width;
+    desc.Height = height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    D3D11_SUBRESOURCE_DATA data = {};
+    data.pSysMem = texels.data();
+    data.SysMemPitch = width * sizeof(XMFLOAT4);
+    if (FAILED(m_Device->CreateTexture2D(&desc, &data, outTexture)) ||
+        FAILED(m_Device->CreateShaderResourceView(*outTexture, nullptr, outSRV))) {
+        return false;
+    }
+    GpuMemory::Track(*outTexture);
+    return true;
+}
+
+bool AtmosphereRenderer::BuildLuts(const LutKey& key, LutSet& set) {
+    ReleaseLuts(set);
+
+    const float groundRadius = key.groundRadius;
+    const float topRadius = groundRadius + 1.0f;
+    const XMVECTOR rayleigh = XMLoadFloat3(&key.rayleigh);
+    const XMVECTOR ozone = XMLoadFloat3(&key.ozone);
+    auto sampleMedium = [&](float h) {
+        const float rayleighDensity = std::exp(-(std::max)(h, 0.0f) / key.rayleighScaleHeight);
+        const float mieDensity = std::exp(-(std::max)(h, 0.0f) / key.mieScaleHeight);
+        Medium medium;
+        medium.scattering = rayleigh * rayleighDensity + XMVectorReplicate(key.mieScattering * mieDensity);
+        medium.extinction = rayleigh * rayleighDensity + XMVectorReplicate(key.mieExtinction * mieDensity) +
+                            ozone * OzoneDensity(h);
+        return medium;
+    };
+
+    // === 透射率：从高度 h 沿天顶角余弦 mu 到大气顶部；射线被地面挡住时为 0 ===
+    std::vector<XMFLOAT4> transmittance(kTransmittanceWidth * kTransmittanceHeight);
+    for (uint32_t y = 0; y < kTransmittanceHeight; y++) {
+        const float h = static_cast<float>(y) / static_cast<float>(kTransmittanceHeight - 1);
+        const float r = groundRadius + h;
+        for (uint32_t x = 0; x < kTransmittanceWidth; x++) {
+            const float mu = static_cast<float>(x) / static_cast<float>(kTransmittanceWidth - 1) * 2.0f - 1.0f;
+            XMVECTOR result = XMVectorZero();
+            if (!(mu < 0.0f && DistanceToSphere(r, mu, groundRadius, false) > 0.0f)) {
+                const float distance = (std::max)(DistanceToSphere(r, mu, topRadius, true), 0.0f);
+                const float ds = distance / kTransmittanceSteps;
+                XMVECTOR opticalDepth = XMVectorZero();
+                for (uint32_t i = 0; i < kTransmittanceSteps; i++) {
+                    const float t = (i + 0.5f) * ds;
+                    const float ri = std::sqrt(r * r + t * t + 2.0f * r * mu * t);
+                    opticalDepth += sampleMedium(ri - groundRadius).extinction * ds;
+                }
+                result = XMVectorExpE(-opticalDepth);
+            }
+            XMStoreFloat4(&transmittance[y * kTransmittanceWidth + x], XMVectorSetW(result, 1.0f));
+        }
+    }
+    auto sampleTransmittance = [&](float h, float mu) {
+        return SampleTable(transmittance, kTransmittanceWidth, kTransmittanceHeight, mu * 0.5f + 0.5f, h);
+    };
+
+    // === 多重散射（Hillaire 2020）：各向同性二次散射 L2 与转移系数 f_ms，Ψ = L2 / (1 - f_ms) ===
+    const float isotropicPhase = 1.0f / (4.0f * kPi);
+    const uint32_t directionCount = kMultiScatteringDirections * kMultiScatteringDirections;
+    std::vector<XMFLOAT4> multiScattering(kMultiScatteringSize * kMultiScatteringSize);
+    for (uint32_t y = 0; y < kMultiScatteringSize; y++) {
+        const float h = std::clamp(static_cast<float>(y) / static_cast<float>(kMultiScatteringSize - 1), 1e-3f, 1.0f - 1e-3f);
+        const XMVECTOR origin = XMVectorSet(0.0f, groundRadius + h, 0.0f, 0.0f);
+        for (uint32_t x = 0; x < kMultiScatteringSize; x++) {
+            const float muSun = static_cast<float>(x) / static_cast<float>(kMultiScatteringSize - 1) * 2.0f - 1.0f;
+            const XMVECTOR sunDir = XMVectorSet(std::sqrt((std::max)(0.0f, 1.0f - muSun * muSun)), muSun, 0.0f, 0.0f);
+
+            XMVECTOR secondOrder = XMVectorZero();
+            XMVECTOR transfer = XMVectorZero();
+            for (uint32_t i = 0; i < kMultiScatteringDirections; i++) {
+                const float cosTheta = 1.0f - 2.0f * (i + 0.5f) / kMultiScatteringDirections;
+                const float sinTheta = std::sqrt((std::max)(0.0f, 1.0f - cosTheta * cosTheta));
+                for (uint32_t j = 0; j < kMultiScatteringDirections; j++) {
+                    const float phi = 2.0f * kPi * (j + 0.5f) / kMultiScatteringDirections;
+                    const XMVECTOR dir = XMVectorSet(sinTheta * std::cos(phi), cosTheta, sinTheta * std::sin(phi), 0.0f);
+
+                    const float r = groundRadius + h;
+                    const float groundDistance = DistanceToSphere(r, cosTheta, groundRadius, false);
+                    const bool hitsGround = groundDistance > 0.0f;
+                    const float distance = hitsGround ? groundDistance : (std::max)(DistanceToSphere(r, cosTheta, topRadius, true), 0.0f);
+                    const float dt = distance / kMultiScatteringSteps;
+
+                    XMVECTOR viewTransmittance = XMVectorReplicate(1.0f);
+                    for (uint32_t s = 0; s < kMultiScatteringSteps; s++) {
+                        const XMVECTOR p = origin + dir * ((s + 0.5f) * dt);
+                        const float radius = XMVectorGetX(XMVector3Length(p));
+                        const float altitude = radius - groundRadius;
+                        const float muSunAtP = XMVectorGetX(XMVector3Dot(p, sunDir)) / radius;
+                        const Medium medium = sampleMedium(altitude);
+                        const XMVECTOR extinction = XMVectorMax(medium.extinction, XMVectorReplicate(1e-6f));
+                        const XMVECTOR stepTransmittance = XMVectorExpE(-extinction * dt);
+
+                        // 步内解析积分：∫ T σ dt = σ (1 - T_step) / σ_t
+                        const XMVECTOR integral = (XMVectorReplicate(1.0f) - stepTransmittance) / extinction;
+                        const XMVECTOR scattered = medium.scattering * integral;
+                        secondOrder += viewTransmittance * scattered * sampleTransmittance(altitude, muSunAtP) * isotropicPhase;
+                        transfer += viewTransmittance * scattered;
+                        viewTransmittance *= stepTransmittance;
+                    }
+
+                    if (hitsGround) {
+                        const XMVECTOR p = origin + dir * distance;
+                        const float muSunAtGround = XMVectorGetX(XMVector3Dot(XMVector3Normalize(p), sunDir));
+                        secondOrder += viewTransmittance * sampleTransmittance(0.0f, muSunAtGround) *
+                                       ((std::max)(muSunAtGround, 0.0f) * key.groundAlbedo / kPi);
+                    }
+                }
+            }
+
+            secondOrder /= static_cast<float>(directionCount);
+            transfer /= static_cast<float>(directionCount);
+            const XMVECTOR psi = secondOrder / XMVectorMax(XMVectorReplicate(1.0f) - transfer, XMVectorReplicate(1e-3f));
+            XMStoreFloat4(&multiScattering[y * kMultiScatteringSize + x], XMVectorSetW(psi, 1.0f));
+        }
+    }
+
+    if (!CreateLutTexture(kTransmittanceWidth, kTransmittanceHeight, transmittance, &set.transmittance,
+                          &set.transmittanceSRV) ||
+        !CreateLutTexture(kMultiScatteringSize, kMultiScatteringSize, multiScattering, &set.multiScattering,
+                          &set.multiScatteringSRV)) {
+        DebugManager::GetInstance().Log("AtmosphereRenderer", "Failed to create atmosphere LUT textures");
+        ReleaseLuts(set);
+        return false;
+    }
+    set.key = key;
+    m_Stats.lutBuilds++;
+    return true;
+}
+
+void AtmosphereRenderer::ReleaseLuts(LutSet& set) {
+    if (set.transmittanceSRV) set.transmittanceSRV->Release();
+    if (set.transmittance) set.transmittance->Release();
+    if (set.multiScatteringSRV) set.multiScatteringSRV->Release();
+    if (set.multiScattering) set.multiScattering->Release();
+    set.transmittanceSRV = nullptr;
+    set.transmittance = nullptr;
+    set.multiScatteringSRV = nullptr;
+    set.multiScattering = nullptr;
+}
+
+bool AtmosphereRenderer::IsDrawable(const components::AtmosphereComponent& atmosphere) {
+    return atmosphere.isVisible && atmosphere.atmosphereHeight > 0.0f && atmosphere.planetRadius > 0.0f;
+}
+
+AtmosphereRenderer::LutSet* AtmosphereRenderer::AcquireLuts(entt::entity entity,
+                                                             const components::AtmosphereComponent& atmosphere) {
+    LutSet& set = m_Luts[entity];
+    const LutKey key = MakeKey(atmosphere);
+    if (set.transmittanceSRV && set.version == atmosphere.version && set.key == key) return &set;
+    set.version = atmosphere.version;
+    return BuildLuts(key, set) ? &set : nullptr;
+}
+
+uint32_t AtmosphereRenderer::Prepare(entt::registry& registry) {
+    if (!m_Initialized) return 0;
+    const uint32_t buildsBefore = m_Stats.lutBuilds;
+    auto view = registry.view<components::AtmosphereComponent>();
+    for (auto entity : view) {
+        const auto& atmosphere = view.get<components::AtmosphereComponent>(entity);
+        if (IsDrawable(atmosphere)) AcquireLuts(entity, atmosphere);
+    }
+    return m_Stats.lutBuilds - buildsBefore;
+}
+
+void AtmosphereRenderer::Clear() {
+    for (auto& [entity, set] : m_Luts) {
+        ReleaseLuts(set);
+    }
+    m_Luts.clear();
+}
+
+void AtmosphereRenderer::Render(ID3D11DeviceContext* context, entt::registry& registry, const CameraFrame& camera) {
+    m_Stats.atmospheres = 0;
+    if (!m_Initialized || !context || !camera.valid) return;
+
+    auto view = registry.view<components::AtmosphereComponent, TransformComponent>();
+    if (view.begin() == view.end()) {
+        if (!m_Luts.empty()) Clear();
+        return;
+    }
+
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    bool pipelineBound = false;
+    const XMVECTOR cameraPosition = XMLoadFloat3(&camera.position);
+
+    for (auto entity : view) {
+        const auto& atmosphere = view.get<components::AtmosphereComponent>(entity);
+        if (!IsDrawable(atmosphere)) continue;
+
+        const auto& transform = view.get<TransformComponent>(entity);
+        const XMFLOAT3 center(transform.worldMatrix._41, transform.worldMatrix._42, transform.worldMatrix._43);
+        const float atmosphereRadius = atmosphere.planetRadius + atmosphere.atmosphereHeight;
+        const float shellRadius = atmosphereRadius * kShellScale;
+
+        // 视锥剔除（外壳包围球）
+        const XMVECTOR centerVector = XMLoadFloat3(&center);
+        bool inside = true;
+        for (int i = 0; i < 6 && inside; i++) {
+            inside = XMVectorGetX(XMPlaneDotCoord(XMLoadFloat4(&camera.planes[i]), centerVector)) >= -shellRadius;
+        }
+        if (!inside) continue;
+
+        // LUT：通常已在 Prepare 中算好；运行时新增 / 参数变化的大气在这里重新计算
+        const LutSet* luts = AcquireLuts(entity, atmosphere);
+        if (!luts) continue;
+        const LutSet& set = *luts;
+        const LutKey& key = set.key;
+
+        if (!pipelineBound) {
+            pipelineBound = true;
+            context->VSSetShader(m_Shader->GetVertexShader(), nullptr, 0);
+            context->PSSetShader(m_Shader->GetPixelShader(), nullptr, 0);
+            context->IASetInputLayout(m_Shader->GetInputLayout());
+            UINT stride = sizeof(XMFLOAT3);
+            UINT offset = 0;
+            context->IASetVertexBuffers(0, 1, &m_VertexBuffer, &stride, &offset);
+            context->IASetIndexBuffer(m_IndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+            context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            context->VSSetConstantBuffers(1, 1, &m_ConstantBuffer);
+            context->PSSetConstantBuffers(1, 1, &m_ConstantBuffer);
+            context->PSSetSamplers(0, 1, &m_Sampler);
+        }
+
+        const float height = atmosphere.atmosphereHeight;
+        const float density = (std::max)(atmosphere.densityScale, 0.0f) / height;
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        if (FAILED(context->Map(m_ConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) continue;
+        AtmosphereConstants* constants = static_cast<AtmosphereConstants*>(mapped.pData);
+        constants->center = center;
+        constants->groundRadius = atmosphere.planetRadius;
+        constants->rayleigh = XMFLOAT3(atmosphere.rayleighScattering.x * density, atmosphere.rayleighScattering.y * density,
+                                       atmosphere.rayleighScattering.z * density);
+        constants->rayleighScaleHeight = key.rayleighScaleHeight * height;
+        constants->ozone = XMFLOAT3(atmosphere.ozoneAbsorption.x * density, atmosphere.ozoneAbsorption.y * density,
+                                    atmosphere.ozoneAbsorption.z * density);
+        constants->atmosphereRadius = atmosphereRadius;
+        constants->mieScattering = atmosphere.mieScattering * density;
+        constants->mieExtinction = (std::max)(atmosphere.mieExtinction, atmosphere.mieScattering) * density;
+        constants->mieScaleHeight = key.mieScaleHeight * height;
+        constants->miePhaseG = std::clamp(atmosphere.miePhaseG, -0.99f, 0.99f);
+        constants->shellRadius = shellRadius;
+        constants->sunIntensity = atmosphere.sunIntensity;
+        constants->atmosphereHeight = height;
+        constants->padding = 0.0f;
+        context->Unmap(m_ConstantBuffer, 0);
+
+        // 相机在外壳内时画背面（正面在相机后方或被裁剪）
+        const float cameraDistance = XMVectorGetX(XMVector3Length(cameraPosition - centerVector));
+        stateCache.Apply(context, cameraDistance < shellRadius ? m_InsideState : m_OutsideState);
+
+        ID3D11ShaderResourceView* luts[2] = { set.transmittanceSRV, set.multiScatteringSRV };
+        context->PSSetShaderResources(0, 2, luts);
+        context->DrawIndexed(m_IndexCount, 0, 0);
+        m_Stats.atmospheres++;
+    }
+
+    if (pipelineBound) {
+        ID3D11ShaderResourceView* nullSRVs[2] = { nullptr, nullptr };
+        context->PSSetShaderResources(0, 2, nullSRVs);
+    }
+
+    // 已删除实体的 LUT（视锥外的大气保留，回到视野时不必重新计算）
+    for (auto it = m_Luts.begin(); it != m_Luts.end();) {
+        if (!registry.valid(it->first) || !registry.all_of<components::AtmosphereComponent>(it->first)) {
+            ReleaseLuts(it->second);
+            it = m_Luts.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace outer_wilds
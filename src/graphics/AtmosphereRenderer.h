@@ -0,0 +1,146 @@
+#pragma once
+#include "CameraService.h"
+#include "RenderStateCache.h"
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+    class Shader;
+}
+namespace components {
+    struct AtmosphereComponent;
+}
+
+/**
+ * @brief 行星大气散射（AtmosphereComponent）
+ *
+ * 每个大气在加载时（Prepare）或参数变化时于 CPU 上预计算两张 LUT（归一化到大气层高度，R32G32B32A32_FLOAT）：
+ * - 透射率 LUT（kTransmittanceWidth x kTransmittanceHeight）：u = 天顶角余弦，v = 高度
+ * - 多重散射 LUT（kMultiScatteringSize²）：u = 太阳天顶角余弦，v = 高度（Hillaire 2020 的各向同性近似）
+ *
+ * 绘制：大气外壳球体（相机在外时画正面，在内时画背面），atmosphere.hlsl 沿视线只取 kViewSamples 个样本，
+ * 太阳透射和多重散射都来自 LUT，没有嵌套的光线步进。视线终点为大气出口或地面球的解析交点，
+ * 结果以 (散射, 1 - 透射率) 预乘混合到场景上。
+ *
+ * 在不透明几何体和天空盒之后、透明物体之前绘制；依赖 RenderSystem 已绑定的 PerFrameBuffer (b0)。
+ */
+class AtmosphereRenderer {
+public:
+    static constexpr uint32_t kTransmittanceWidth = 256;
+    static constexpr uint32_t kTransmittanceHeight = 64;
+    static constexpr uint32_t kMultiScatteringSize = 32;
+    static constexpr uint32_t kViewSamples = 12;        // 与 atmosphere.hlsl 的 VIEW_SAMPLES 一致
+
+    struct Stats {
+        uint32_t atmospheres = 0;           // 本帧绘制的大气数
+        uint32_t lutBuilds = 0;             // 累计的 LUT 重新计算次数
+    };
+
+    AtmosphereRenderer() = default;
+    ~AtmosphereRenderer();
+
+    AtmosphereRenderer(const AtmosphereRenderer&) = delete;
+    AtmosphereRenderer& operator=(const AtmosphereRenderer&) = delete;
+
+    bool Initialize(ID3D11Device* device);
+
+    /**
+     * @brief 绘制视锥内的全部大气（参数变化的大气先重新计算 LUT）
+     *
+     * 自己声明深度 / 混合 / 光栅化状态（RenderStateCache），不还原。
+     */
+    void Render(ID3D11DeviceContext* context, entt::registry& registry, const CameraFrame& camera);
+
+    /**
+     * @brief 为场景中全部大气预计算 LUT（场景构建完成后调用，避免第一次进入视野的那一帧卡顿）
+     * @return 本次新计算的大气数
+     */
+    uint32_t Prepare(entt::registry& registry);
+
+    /** @brief 释放全部 LUT（切换场景时调用） */
+    void Clear();
+
+    bool IsInitialized() const { return m_Initialized; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    /**
+     * @brief 决定 LUT 内容的参数（归一化单位），逐值比较
+     */
+    struct LutKey {
+        float groundRadius = 0.0f;          // planetRadius / atmosphereHeight
+        DirectX::XMFLOAT3 rayleigh = {};
+        float rayleighScaleHeight = 0.0f;
+        float mieScattering = 0.0f;
+        float mieExtinction = 0.0f;
+        float mieScaleHeight = 0.0f;
+        DirectX::XMFLOAT3 ozone = {};
+        float groundAlbedo = 0.0f;
+
+        bool operator==(const LutKey& other) const;
+    };
+
+    struct LutSet {
+        LutKey key;
+        uint32_t version = 0;
+        ID3D11Texture2D* transmittance = nullptr;
+        ID3D11ShaderResourceView* transmittanceSRV = nullptr;
+        ID3D11Texture2D* multiScattering = nullptr;
+        ID3D11ShaderResourceView* multiScatteringSRV = nullptr;
+    };
+
+    /**
+     * @brief 与 atmosphere.hlsl 中 AtmosphereBuffer 一致（96 字节）
+     */
+    struct AtmosphereConstants {
+        DirectX::XMFLOAT3 center;
+        float groundRadius;                 // 世界单位
+        DirectX::XMFLOAT3 rayleigh;         // 世界单位的散射系数（已乘 densityScale）
+        float rayleighScaleHeight;          // 世界单位
+        DirectX::XMFLOAT3 ozone;
+        float atmosphereRadius;
+        float mieScattering;
+        float mieExtinction;
+        float mieScaleHeight;
+        float miePhaseG;
+        float shellRadius;                  // 外壳网格半径（略大于大气半径，覆盖多边形误差）
+        float sunIntensity;
+        float atmosphereHeight;
+        float padding;
+    };
+    static_assert(sizeof(AtmosphereConstants) == 96, "AtmosphereConstants must match atmosphere.hlsl");
+
+    static LutKey MakeKey(const components::AtmosphereComponent& atmosphere);
+    static bool IsDrawable(const components::AtmosphereComponent& atmosphere);
+    /** @brief 取得实体的 LUT，第一次出现或参数变化时重新计算（失败返回 nullptr） */
+    LutSet* AcquireLuts(entt::entity entity, const components::AtmosphereComponent& atmosphere);
+    bool BuildLuts(const LutKey& key, LutSet& set);
+    static void ReleaseLuts(LutSet& set);
+    bool CreateSphere(ID3D11Device* device);
+    bool CreateLutTexture(uint32_t width, uint32_t height, const std::vector<DirectX::XMFLOAT4>& texels,
+                          ID3D11Texture2D** outTexture, ID3D11ShaderResourceView** outSRV);
+
+    ID3D11Device* m_Device = nullptr;
+    bool m_Initialized = false;
+    Stats m_Stats;
+
+    std::unique_ptr<resources::Shader> m_Shader;
+    ID3D11Buffer* m_VertexBuffer = nullptr;
+    ID3D11Buffer* m_IndexBuffer = nullptr;
+    UINT m_IndexCount = 0;
+    ID3D11Buffer* m_ConstantBuffer = nullptr;
+    // 状态对象由 RenderStateCache 持有
+    ID3D11SamplerState* m_Sampler = nullptr;
+    PassState m_OutsideState;                           // 剔除背面（相机在大气外）
+    PassState m_InsideState;                            // 剔除正面（相机在大气内）
+
+    std::unordered_map<entt::entity, LutSet> m_Luts;
+};
+
+} // namespace outer_wilds
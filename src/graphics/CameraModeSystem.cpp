@@ -1,6 +1,7 @@
 #include "CameraModeSystem.h"
 #include "components/CameraComponent.h"
 #include "components/FreeCameraComponent.h"
+#include "CameraService.h"
 #include "../gameplay/components/PlayerComponent.h"
 #include "../gameplay/components/PlayerInputComponent.h"
 #include "../gameplay/components/CharacterControllerComponent.h"
@@ -25,13 +26,22 @@ void CameraModeSystem::Initialize(std::shared_ptr<Scene> scene) {
     Initialize();
 }
 
+void CameraModeSystem::DeclareAccess(SystemAccess& access) const {
+    // 首次切换到自由相机时创建相机实体
+    access.Write<TransformComponent, CameraComponent, FreeCameraComponent, PlayerInputComponent,
+                 CharacterControllerComponent, GravityAffectedComponent>()
+          .Read<PlayerComponent, PlayerSpacecraftInteractionComponent, SpacecraftComponent,
+                InSectorComponent, SectorComponent>()
+          .ReadResource(SystemAccess::kInput)
+          .WriteResource(SystemAccess::kEntities);
+}
+
 void CameraModeSystem::Update(float deltaTime, entt::registry& registry) {
     // 检测玩家飞船驾驶状态变化
     CheckSpacecraftPilotingState(registry);
     CheckModeToggle(registry);
     
-    // 注意：飞船模式的相机由 SpacecraftDrivingSystem::UpdateSpacecraftCamera 负责
-    // 这里不再调用 UpdateSpacecraftCamera，避免冲突
+    // 注意：飞船模式的相机由 SpacecraftDrivingSystem::UpdateSpacecraftCamera 负责（写活动相机）
 }
 
 // 检测玩家是否正在驾驶飞船，自动切换相机模式
@@ -87,12 +97,8 @@ void CameraModeSystem::SetCameraMode(CameraMode mode, entt::registry& registry)
 }
 
 void CameraModeSystem::CheckModeToggle(entt::registry& registry) {
-    // 检测Shift+ESC组合键
-    bool shiftPressed = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
-    bool escPressed = (GetAsyncKeyState(VK_ESCAPE) & 0x8000) != 0;
-
-    // 当两个键都按下且之前至少有一个没按下时，触发切换
-    if (shiftPressed && escPressed && (!m_ShiftWasPressed || !m_EscWasPressed)) {
+    // 检测Shift+ESC组合键：两个键都按下且至少一个是本帧新按下时触发切换
+    if (InputManager::GetInstance().IsChordPressed(VK_SHIFT, VK_ESCAPE)) {
         ToggleCameraMode(registry);
         
         // 输出调试信息
@@ -102,9 +108,6 @@ void CameraModeSystem::CheckModeToggle(entt::registry& registry) {
             "Switched to FREE camera mode"
         );
     }
-
-    m_ShiftWasPressed = shiftPressed;
-    m_EscWasPressed = escPressed;
 }
 
 void CameraModeSystem::ToggleCameraMode(entt::registry& registry) {
@@ -142,6 +145,7 @@ void CameraModeSystem::SwitchToFreeMode(entt::registry& registry) {
         freeCamera.isActive = true;
         
         freeCameraComp.isActive = true;
+        CameraService::GetInstance().SetActiveCamera(m_FreeCameraEntity);
 
         outer_wilds::DebugManager::GetInstance().Log("CameraMode", "Switched to FREE camera");
         break;
@@ -214,6 +218,7 @@ void CameraModeSystem::SwitchToPlayerMode(entt::registry& registry) {
     for (auto playerEntity : playerView) {
         auto& camera = playerView.get<CameraComponent>(playerEntity);
         camera.isActive = true;
+        CameraService::GetInstance().SetActiveCamera(playerEntity);
         
         outer_wilds::DebugManager::GetInstance().Log("CameraMode", "Switched to PLAYER camera");
         break;
@@ -289,7 +294,9 @@ void CameraModeSystem::SwitchToSpacecraftMode(entt::registry& registry, entt::en
                 DirectX::XMStoreFloat3(&camera->position, cameraPos);
                 DirectX::XMStoreFloat3(&camera->target, lookTarget);
                 DirectX::XMStoreFloat3(&camera->up, worldUp);
+                camera->lateLatchSensitivity = 0.0f;
                 camera->isActive = true;
+                CameraService::GetInstance().SetActiveCamera(playerEntity);
                 break;
             }
         }
@@ -302,77 +309,4 @@ void CameraModeSystem::ExitSpacecraftMode(entt::registry& registry) {
     SwitchToPlayerMode(registry);
 }
 
-void CameraModeSystem::UpdateSpacecraftCamera(entt::registry& registry) {
-    if (m_CurrentSpacecraft == entt::null || !registry.valid(m_CurrentSpacecraft)) {
-        SwitchToPlayerMode(registry);
-        return;
-    }
-    
-    auto* spacecraftComp = registry.try_get<SpacecraftComponent>(m_CurrentSpacecraft);
-    auto* spacecraftTransform = registry.try_get<TransformComponent>(m_CurrentSpacecraft);
-    
-    if (!spacecraftComp || !spacecraftTransform) {
-        SwitchToPlayerMode(registry);
-        return;
-    }
-    
-    // 如果飞船不再被驾驶，退出飞船视角
-    if (spacecraftComp->currentState == SpacecraftComponent::State::IDLE) {
-        SwitchToPlayerMode(registry);
-        return;
-    }
-    
-    // 更新相机位置到飞船位置
-    auto playerView = registry.view<PlayerComponent, CameraComponent>();
-    for (auto playerEntity : playerView) {
-        auto& camera = playerView.get<CameraComponent>(playerEntity);
-        
-        // 使用飞船的世界坐标（TransformComponent 已被 SectorSystem 更新为世界坐标）
-        DirectX::XMVECTOR spacecraftPos = DirectX::XMLoadFloat3(&spacecraftTransform->position);
-        
-        // 验证四元数有效性
-        const auto& rot = spacecraftTransform->rotation;
-        float quatLengthSq = rot.x * rot.x + rot.y * rot.y + rot.z * rot.z + rot.w * rot.w;
-        DirectX::XMVECTOR spacecraftRot;
-        if (quatLengthSq < 0.001f) {
-            spacecraftRot = DirectX::XMQuaternionIdentity();
-        } else {
-            spacecraftRot = DirectX::XMVector4Normalize(DirectX::XMLoadFloat4(&rot));
-        }
-        
-        DirectX::XMVECTOR cameraOffset = DirectX::XMLoadFloat3(&spacecraftComp->cameraOffset);
-        
-        // 旋转偏移
-        cameraOffset = DirectX::XMVector3Rotate(cameraOffset, spacecraftRot);
-        DirectX::XMVECTOR cameraPos = DirectX::XMVectorAdd(spacecraftPos, cameraOffset);
-        
-        DirectX::XMStoreFloat3(&camera.position, cameraPos);
-        
-        // 飞船模型被绕X轴旋转了-90度，所以：
-        // - 原来的Z轴（前）变成了-Y轴
-        // - 原来的Y轴（上）变成了Z轴
-        // 因此我们需要使用 (0, -1, 0) 作为forward，(0, 0, 1) 作为up
-        // 这样经过飞船旋转后就能得到正确的视角方向
-        DirectX::XMVECTOR forward = DirectX::XMVector3Rotate(DirectX::XMVectorSet(0, -1, 0, 0), spacecraftRot);
-        DirectX::XMVECTOR up = DirectX::XMVector3Rotate(DirectX::XMVectorSet(0, 0, 1, 0), spacecraftRot);
-        
-        // 设置相机目标点（前方一定距离）
-        DirectX::XMVECTOR targetPos = DirectX::XMVectorAdd(cameraPos, forward);
-        DirectX::XMStoreFloat3(&camera.target, targetPos);
-        DirectX::XMStoreFloat3(&camera.up, up);
-        
-        // 同步局部坐标系
-        DirectX::XMVECTOR right = DirectX::XMVector3Rotate(DirectX::XMVectorSet(1, 0, 0, 0), spacecraftRot);
-        DirectX::XMStoreFloat3(&camera.localUp, up);
-        DirectX::XMStoreFloat3(&camera.localForward, forward);
-        DirectX::XMStoreFloat3(&camera.localRight, right);
-        camera.relativeYaw = 0.0f;
-        camera.relativePitch = 0.0f;
-        
-        camera.isActive = true;
-        
-        break;
-    }
-}
-
 } // namespace outer_wilds
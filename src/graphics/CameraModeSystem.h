@@ -18,6 +18,7 @@ public:
     void Initialize() override;
     void Initialize(std::shared_ptr<Scene> scene);
     void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
     void Shutdown() override;
 
     /// <summary>
@@ -66,11 +67,6 @@ private:
     /// </summary>
     void CreateFreeCameraEntity(entt::registry& registry);
     
-    /// <summary>
-    /// 更新飞船相机位置
-    /// </summary>
-    void UpdateSpacecraftCamera(entt::registry& registry);
-    
     /// <summary>
     /// 检测玩家飞船驾驶状态，自动切换相机
     /// </summary>
@@ -80,10 +76,6 @@ private:
     CameraMode m_CurrentMode = CameraMode::Player;
     entt::entity m_FreeCameraEntity = entt::null;  // 自由相机实体的引用
     entt::entity m_CurrentSpacecraft = entt::null; // 当前驾驶的飞船
-
-    // 输入状态跟踪（防止重复切换）
-    bool m_ShiftWasPressed = false;
-    bool m_EscWasPressed = false;
 };
 
 } // namespace outer_wilds
@@ -0,0 +1,110 @@
+#include "CameraService.h"
+#include "components/CameraComponent.h"
+
+namespace outer_wilds {
+
+using namespace DirectX;
+
+components::CameraComponent* CameraService::ResolveActiveCamera(entt::registry& registry) {
+    const entt::entity active = GetActiveCamera();
+    if (active != entt::null && registry.valid(active)) {
+        auto* camera = registry.try_get<components::CameraComponent>(active);
+        if (camera && camera->isActive) {
+            return camera;
+        }
+    }
+
+    // 句柄失效：扫描一次并缓存（与原 FindActiveCamera 一致，多个激活时取最后一个）
+    components::CameraComponent* found = nullptr;
+    entt::entity foundEntity = entt::null;
+    auto view = registry.view<components::CameraComponent>();
+    for (auto entity : view) {
+        auto& camera = view.get<components::CameraComponent>(entity);
+        if (camera.isActive) {
+            found = &camera;
+            foundEntity = entity;
+        }
+    }
+    SetActiveCamera(foundEntity);
+    return found;
+}
+
+const CameraFrame& CameraService::BeginFrame(const components::CameraComponent& camera) {
+    CameraFrame& frame = m_Frame;
+    frame.valid = true;
+    frame.entity = GetActiveCamera();
+    frame.frameIndex = ++m_FrameCounter;
+
+    // 正交基：forward 由 target 决定，up 正交化（与 XMMatrixLookAtLH 的构造一致）
+    const XMVECTOR position = XMLoadFloat3(&camera.position);
+    XMVECTOR forward = XMVectorSubtract(XMLoadFloat3(&camera.target), position);
+    if (XMVectorGetX(XMVector3LengthSq(forward)) < 1e-12f) {
+        forward = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+    }
+    forward = XMVector3Normalize(forward);
+    XMVECTOR right = XMVector3Cross(XMLoadFloat3(&camera.up), forward);
+    if (XMVectorGetX(XMVector3LengthSq(right)) < 1e-12f) {
+        right = XMVector3Orthogonal(forward);
+    }
+    right = XMVector3Normalize(right);
+
+    XMStoreFloat3(&frame.position, position);
+    XMStoreFloat3(&frame.forward, forward);
+    XMStoreFloat3(&frame.right, right);
+    XMStoreFloat3(&frame.up, XMVector3Cross(forward, right));
+    frame.fovY = camera.fov * XM_PI / 180.0f;
+    frame.aspectRatio = camera.aspectRatio;
+    frame.nearPlane = camera.nearPlane;
+    frame.farPlane = camera.farPlane;
+
+    ComputeDerived(frame);
+    return frame;
+}
+
+void CameraService::ShiftOrigin(const XMFLOAT3& shift) {
+    if (!m_Frame.valid) return;
+    m_Frame.position.x -= shift.x;
+    m_Frame.position.y -= shift.y;
+    m_Frame.position.z -= shift.z;
+    ComputeDerived(m_Frame);
+}
+
+void CameraService::Reset() {
+    SetActiveCamera(entt::null);
+    m_Frame = CameraFrame();
+}
+
+void CameraService::ComputeDerived(CameraFrame& frame) {
+    const XMVECTOR position = XMLoadFloat3(&frame.position);
+    const XMMATRIX view = XMMatrixLookToLH(position, XMLoadFloat3(&frame.forward), XMLoadFloat3(&frame.up));
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(frame.fovY, frame.aspectRatio, frame.nearPlane, frame.farPlane);
+    const XMMATRIX viewProjection = XMMatrixMultiply(view, projection);
+    const XMMATRIX inverseView = XMMatrixInverse(nullptr, view);
+
+    XMStoreFloat4x4(&frame.view, view);
+    XMStoreFloat4x4(&frame.projection, projection);
+    XMStoreFloat4x4(&frame.viewProjection, viewProjection);
+    XMStoreFloat4x4(&frame.inverseView, inverseView);
+    XMStoreFloat4x4(&frame.inverseProjection, XMMatrixInverse(nullptr, projection));
+    XMStoreFloat4x4(&frame.inverseViewProjection, XMMatrixInverse(nullptr, viewProjection));
+
+    // 观察空间视锥 → 世界空间
+    BoundingFrustum::CreateFromMatrix(frame.frustum, projection);
+    frame.frustum.Transform(frame.frustum, inverseView);
+
+    // 从 viewProjection 的列提取平面（D3D 裁剪空间 0 <= z <= w）
+    const XMMATRIX columns = XMMatrixTranspose(viewProjection);
+    const XMVECTOR planes[6] = {
+        XMVectorAdd(columns.r[3], columns.r[0]),        // 左
+        XMVectorSubtract(columns.r[3], columns.r[0]),   // 右
+        XMVectorAdd(columns.r[3], columns.r[1]),        // 下
+        XMVectorSubtract(columns.r[3], columns.r[1]),   // 上
+        columns.r[2],                                   // 近
+        XMVectorSubtract(columns.r[3], columns.r[2]),   // 远
+    };
+    for (int i = 0; i < 6; i++) {
+        XMStoreFloat4(&frame.planes[i], XMPlaneNormalize(planes[i]));
+    }
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,106 @@
+/**
+ * CameraService.h
+ *
+ * 活动相机的唯一入口 + 每帧只计算一次的相机派生数据
+ *
+ * - 活动相机句柄：CameraModeSystem 切换视角时设置。句柄失效（实体销毁 / CameraComponent 被移除 /
+ *   isActive 被关闭）时退回扫描一次并缓存结果，不再每帧遍历注册表
+ * - CameraFrame：RenderSystem 在后期锁存之后调用 BeginFrame，一次算出 view / projection /
+ *   viewProjection 及其逆矩阵、世界空间视锥和 6 个平面。剔除、遮挡、LOD、天空盒、阴影共用这一份；
+ *   音频听者、地形 LOD 在下一帧的系统更新中读取（即玩家刚看到的那一帧）
+ * - 浮动原点平移时 ShiftOrigin 把缓存的数据一起平移
+ *
+ * CameraFrame 只在主线程、系统调度之外写入（RenderSystem::Update / FloatingOrigin::Rebase），
+ * 系统更新期间只读；活动句柄是原子的，CameraModeSystem 在调度中设置。
+ */
+
+#pragma once
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <entt/entt.hpp>
+#include <atomic>
+#include <cstdint>
+
+namespace outer_wilds {
+
+namespace components {
+    struct CameraComponent;
+}
+
+/**
+ * @brief 一帧的相机数据（世界空间，DirectXMath 行向量约定）
+ */
+struct CameraFrame {
+    bool valid = false;                     // 还没有渲染过任何一帧时为 false
+    entt::entity entity = entt::null;
+    uint64_t frameIndex = 0;
+
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 forward = { 0.0f, 0.0f, 1.0f };   // 单位向量
+    DirectX::XMFLOAT3 up = { 0.0f, 1.0f, 0.0f };        // 与 forward 正交
+    DirectX::XMFLOAT3 right = { 1.0f, 0.0f, 0.0f };
+    float fovY = 0.0f;                      // 弧度
+    float aspectRatio = 16.0f / 9.0f;
+    float nearPlane = 0.1f;
+    float farPlane = 1000.0f;
+
+    DirectX::XMFLOAT4X4 view;
+    DirectX::XMFLOAT4X4 projection;
+    DirectX::XMFLOAT4X4 viewProjection;
+    DirectX::XMFLOAT4X4 inverseView;
+    DirectX::XMFLOAT4X4 inverseProjection;
+    DirectX::XMFLOAT4X4 inverseViewProjection;
+
+    DirectX::BoundingFrustum frustum;       // 世界空间视锥（RenderQueue 剔除）
+    // 世界空间平面 (n, d)：dot(n, p) + d >= 0 在视锥内。顺序：左、右、下、上、近、远
+    DirectX::XMFLOAT4 planes[6];
+
+    DirectX::XMMATRIX GetView() const { return DirectX::XMLoadFloat4x4(&view); }
+    DirectX::XMMATRIX GetProjection() const { return DirectX::XMLoadFloat4x4(&projection); }
+    DirectX::XMMATRIX GetViewProjection() const { return DirectX::XMLoadFloat4x4(&viewProjection); }
+    DirectX::XMMATRIX GetInverseView() const { return DirectX::XMLoadFloat4x4(&inverseView); }
+};
+
+class CameraService {
+public:
+    static CameraService& GetInstance() {
+        static CameraService instance;
+        return instance;
+    }
+
+    /** @brief 设置活动相机（视角切换时调用；不修改 isActive） */
+    void SetActiveCamera(entt::entity entity) { m_ActiveCamera.store(entity, std::memory_order_relaxed); }
+    entt::entity GetActiveCamera() const { return m_ActiveCamera.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 取活动相机组件：句柄有效时直接返回，否则扫描 isActive 的相机并更新句柄
+     * @return 场景中没有激活的相机时返回 nullptr
+     */
+    components::CameraComponent* ResolveActiveCamera(entt::registry& registry);
+
+    /**
+     * @brief 由本帧渲染用的相机（后期锁存之后的副本）计算派生数据（RenderSystem，每帧一次）
+     */
+    const CameraFrame& BeginFrame(const components::CameraComponent& camera);
+
+    /** @brief 最近一次 BeginFrame 的结果（valid 为 false 时尚不可用） */
+    const CameraFrame& GetFrame() const { return m_Frame; }
+
+    /** @brief 浮动原点平移：缓存的位置 / 矩阵 / 视锥一起平移，下一帧读取的系统不会看到跳变 */
+    void ShiftOrigin(const DirectX::XMFLOAT3& shift);
+
+    /** @brief 场景切换时清空句柄和缓存 */
+    void Reset();
+
+private:
+    CameraService() = default;
+
+    /** @brief 由 position / forward / up 和投影参数计算矩阵、视锥和平面 */
+    static void ComputeDerived(CameraFrame& frame);
+
+    std::atomic<entt::entity> m_ActiveCamera{ entt::null };
+    CameraFrame m_Frame;
+    uint64_t m_FrameCounter = 0;
+};
+
+} // namespace outer_wilds
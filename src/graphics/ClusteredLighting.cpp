@@ -0,0 +1,273 @@
+#include "ClusteredLighting.h"
+#include "GpuMemory.h"
+#include "components/LightComponent.h"
+#include "../scene/components/TransformComponent.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+using namespace DirectX;
+
+namespace outer_wilds {
+
+namespace {
+
+constexpr float kDegToRad = 3.14159265f / 180.0f;
+
+uint16_t ClampTile(float ndc01, uint32_t tiles) {
+    const int tile = static_cast<int>(ndc01 * static_cast<float>(tiles));
+    return static_cast<uint16_t>((std::min)((std::max)(tile, 0), static_cast<int>(tiles) - 1));
+}
+
+} // namespace
+
+ClusteredLighting::~ClusteredLighting() {
+    if (m_IndexSRV) m_IndexSRV->Release();
+    if (m_IndexBuffer) m_IndexBuffer->Release();
+    if (m_ClusterSRV) m_ClusterSRV->Release();
+    if (m_ClusterBuffer) m_ClusterBuffer->Release();
+    if (m_LightSRV) m_LightSRV->Release();
+    if (m_LightBuffer) m_LightBuffer->Release();
+    if (m_ClusterCB) m_ClusterCB->Release();
+}
+
+bool ClusteredLighting::CreateDynamicStructuredBuffer(UINT stride, UINT count, ID3D11Buffer** outBuffer,
+                                                      ID3D11ShaderResourceView** outSRV) {
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.ByteWidth = stride * count;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    desc.StructureByteStride = stride;
+    if (FAILED(m_Device->CreateBuffer(&desc, nullptr, outBuffer)) ||
+        FAILED(m_Device->CreateShaderResourceView(*outBuffer, nullptr, outSRV))) {
+        return false;
+    }
+    GpuMemory::Track(*outBuffer);
+    return true;
+}
+
+bool ClusteredLighting::Initialize(ID3D11Device* device) {
+    if (!device) return false;
+    m_Device = device;
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.ByteWidth = sizeof(ClusterConstants);
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    if (FAILED(device->CreateBuffer(&cbDesc, nullptr, &m_ClusterCB))) {
+        DebugManager::GetInstance().Log("ClusteredLighting", "Failed to create cluster constant buffer");
+        return false;
+    }
+    GpuMemory::Track(m_ClusterCB);
+
+    if (!CreateDynamicStructuredBuffer(sizeof(GPULight), kMaxLights, &m_LightBuffer, &m_LightSRV) ||
+        !CreateDynamicStructuredBuffer(2 * sizeof(uint32_t), kClusterCount, &m_ClusterBuffer, &m_ClusterSRV) ||
+        !CreateDynamicStructuredBuffer(sizeof(uint32_t), kMaxLightIndices, &m_IndexBuffer, &m_IndexSRV)) {
+        DebugManager::GetInstance().Log("ClusteredLighting", "Failed to create light list buffers");
+        return false;
+    }
+
+    m_ClusterCounts.resize(2 * kClusterCount);
+    m_ClusterCursor.resize(kClusterCount);
+    m_LightIndices.reserve(kMaxLightIndices);
+    m_Initialized = true;
+    return true;
+}
+
+void ClusteredLighting::Update(ID3D11DeviceContext* context, entt::registry& registry, const CameraFrame& camera,
+                               const D3D11_VIEWPORT& viewport) {
+    m_Stats = Stats();
+    if (!m_Initialized || !context || !camera.valid) return;
+
+    const float nearPlane = (std::max)(camera.nearPlane, 1e-3f);
+    const float farPlane = (std::max)((std::min)(m_MaxDistance, camera.farPlane), nearPlane * 2.0f);
+    const float sliceScale = static_cast<float>(kSlices) / std::log(farPlane / nearPlane);
+    const float sliceBias = -std::log(nearPlane) * sliceScale;
+    const float slopeX = camera.projection._11 != 0.0f ? 1.0f / camera.projection._11 : 1.0f;
+    const float slopeY = camera.projection._22 != 0.0f ? 1.0f / camera.projection._22 : 1.0f;
+    const XMMATRIX view = XMLoadFloat4x4(&camera.view);
+    const XMVECTOR cameraPosition = XMLoadFloat3(&camera.position);
+
+    auto sliceOf = [&](float z) {
+        const int slice = static_cast<int>(std::floor(std::log(z) * sliceScale + sliceBias));
+        return static_cast<uint16_t>((std::min)((std::max)(slice, 0), static_cast<int>(kSlices) - 1));
+    };
+
+    // === 1. 收集：视锥内、分簇距离内的点光源 / 聚光灯 ===
+    m_Candidates.clear();
+    auto lights = registry.view<LightComponent, TransformComponent>();
+    for (auto entity : lights) {
+        const auto& light = lights.get<LightComponent>(entity);
+        if (light.type == LightType::Directional || light.range <= 0.0f || light.intensity <= 0.0f) continue;
+
+        const auto& transform = lights.get<TransformComponent>(entity);
+        const XMFLOAT3 position(transform.worldMatrix._41, transform.worldMatrix._42, transform.worldMatrix._43);
+        const XMVECTOR center = XMLoadFloat3(&position);
+
+        bool inside = true;
+        for (int i = 0; i < 6 && inside; i++) {
+            inside = XMVectorGetX(XMPlaneDotCoord(XMLoadFloat4(&camera.planes[i]), center)) >= -light.range;
+        }
+        if (!inside) continue;
+
+        Candidate candidate = {};
+        XMStoreFloat3(&candidate.viewCenter, XMVector3TransformCoord(center, view));
+        const float z = candidate.viewCenter.z;
+        if (z + light.range < nearPlane || z - light.range > farPlane) continue;
+        candidate.distance = XMVectorGetX(XMVector3Length(center - cameraPosition)) - light.range;
+
+        GPULight& gpu = candidate.light;
+        gpu.position = position;
+        gpu.range = light.range;
+        gpu.color = XMFLOAT3(light.color.x * light.intensity, light.color.y * light.intensity,
+                             light.color.z * light.intensity);
+        gpu.attenuation = light.attenuation;
+        // 聚光灯沿实体局部 +Z 照射（行向量约定：世界矩阵第三行）
+        XMStoreFloat3(&gpu.direction, XMVector3Normalize(XMVectorSet(transform.worldMatrix._31,
+            transform.worldMatrix._32, transform.worldMatrix._33, 0.0f)));
+        const float outer = (std::max)(light.outerConeAngle, 0.1f);
+        const float inner = (std::min)(light.innerConeAngle, outer - 0.05f);
+        gpu.spotCosOuter = std::cos(outer * kDegToRad);
+        gpu.spotCosInner = std::cos((std::max)(inner, 0.0f) * kDegToRad);
+        gpu.isSpot = light.type == LightType::Spot ? 1.0f : 0.0f;
+        m_Candidates.push_back(candidate);
+    }
+
+    if (m_Candidates.size() > kMaxLights) {
+        std::nth_element(m_Candidates.begin(), m_Candidates.begin() + kMaxLights, m_Candidates.end(),
+                         [](const Candidate& a, const Candidate& b) { return a.distance < b.distance; });
+        m_Candidates.resize(kMaxLights);
+    }
+
+    // === 2. 装箱：包围球的观察空间 AABB 投影到屏幕块，深度范围映射到指数切片 ===
+    std::fill(m_ClusterCounts.begin(), m_ClusterCounts.end(), 0u);
+    for (Candidate& candidate : m_Candidates) {
+        const XMFLOAT3& c = candidate.viewCenter;
+        const float r = candidate.light.range;
+        const float zMin = (std::max)(c.z - r, nearPlane);
+        const float zMax = (std::min)(c.z + r, farPlane);
+        candidate.minSlice = sliceOf(zMin);
+        candidate.maxSlice = sliceOf(zMax);
+
+        if (c.z - r <= nearPlane) {
+            // 包围球跨过近平面：投影无界，覆盖整个屏幕
+            candidate.minTile[0] = 0;
+            candidate.minTile[1] = 0;
+            candidate.maxTile[0] = static_cast<uint16_t>(kTilesX - 1);
+            candidate.maxTile[1] = static_cast<uint16_t>(kTilesY - 1);
+        } else {
+            const float minX = (std::min)((c.x - r) / zMin, (c.x - r) / zMax) / slopeX;
+            const float maxX = (std::max)((c.x + r) / zMin, (c.x + r) / zMax) / slopeX;
+            const float minY = (std::min)((c.y - r) / zMin, (c.y - r) / zMax) / slopeY;
+            const float maxY = (std::max)((c.y + r) / zMin, (c.y + r) / zMax) / slopeY;
+            // 屏幕块 y 向下增长（NDC y 向上）
+            candidate.minTile[0] = ClampTile(minX * 0.5f + 0.5f, kTilesX);
+            candidate.maxTile[0] = ClampTile(maxX * 0.5f + 0.5f, kTilesX);
+            candidate.minTile[1] = ClampTile(0.5f - maxY * 0.5f, kTilesY);
+            candidate.maxTile[1] = ClampTile(0.5f - minY * 0.5f, kTilesY);
+        }
+
+        for (uint32_t s = candidate.minSlice; s <= candidate.maxSlice; s++) {
+            for (uint32_t y = candidate.minTile[1]; y <= candidate.maxTile[1]; y++) {
+                for (uint32_t x = candidate.minTile[0]; x <= candidate.maxTile[0]; x++) {
+                    m_ClusterCounts[2 * ((s * kTilesY + y) * kTilesX + x) + 1]++;
+                }
+            }
+        }
+    }
+
+    // 前缀和：偏移超过下标容量的簇截断
+    uint32_t offset = 0;
+    for (uint32_t cluster = 0; cluster < kClusterCount; cluster++) {
+        uint32_t& count = m_ClusterCounts[2 * cluster + 1];
+        m_Stats.maxLightsPerCluster = (std::max)(m_Stats.maxLightsPerCluster, count);
+        if (offset + count > kMaxLightIndices) {
+            count = kMaxLightIndices - offset;
+            m_Stats.truncated = true;
+        }
+        m_ClusterCounts[2 * cluster] = offset;
+        m_ClusterCursor[cluster] = offset;
+        offset += count;
+    }
+    if (m_Stats.truncated && !m_LoggedTruncation) {
+        m_LoggedTruncation = true;
+        DebugManager::GetInstance().Log("ClusteredLighting",
+            "Light index list overflow (" + std::to_string(kMaxLightIndices) + "), some clusters truncated");
+    }
+
+    m_LightIndices.assign(offset, 0u);
+    for (uint32_t i = 0; i < m_Candidates.size(); i++) {
+        const Candidate& candidate = m_Candidates[i];
+        for (uint32_t s = candidate.minSlice; s <= candidate.maxSlice; s++) {
+            for (uint32_t y = candidate.minTile[1]; y <= candidate.maxTile[1]; y++) {
+                for (uint32_t x = candidate.minTile[0]; x <= candidate.maxTile[0]; x++) {
+                    const uint32_t cluster = (s * kTilesY + y) * kTilesX + x;
+                    const uint32_t end = m_ClusterCounts[2 * cluster] + m_ClusterCounts[2 * cluster + 1];
+                    if (m_ClusterCursor[cluster] < end) {
+                        m_LightIndices[m_ClusterCursor[cluster]++] = i;
+                    }
+                }
+            }
+        }
+    }
+
+    m_Stats.lights = static_cast<uint32_t>(m_Candidates.size());
+    m_Stats.lightIndices = offset;
+
+    // === 3. 上传 ===
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (!m_Candidates.empty() && SUCCEEDED(context->Map(m_LightBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        GPULight* out = static_cast<GPULight*>(mapped.pData);
+        for (const Candidate& candidate : m_Candidates) *out++ = candidate.light;
+        context->Unmap(m_LightBuffer, 0);
+    }
+    if (SUCCEEDED(context->Map(m_ClusterBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        memcpy(mapped.pData, m_ClusterCounts.data(), m_ClusterCounts.size() * sizeof(uint32_t));
+        context->Unmap(m_ClusterBuffer, 0);
+    }
+    if (offset > 0 && SUCCEEDED(context->Map(m_IndexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        memcpy(mapped.pData, m_LightIndices.data(), offset * sizeof(uint32_t));
+        context->Unmap(m_IndexBuffer, 0);
+    }
+
+    const float width = viewport.Width > 0.0f ? viewport.Width : 1.0f;
+    const float height = viewport.Height > 0.0f ? viewport.Height : 1.0f;
+
+    if (SUCCEEDED(context->Map(m_ClusterCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        ClusterConstants* constants = static_cast<ClusterConstants*>(mapped.pData);
+        constants->view = camera.view;
+        constants->screen = XMFLOAT4(kTilesX / width, kTilesY / height, viewport.TopLeftX, viewport.TopLeftY);
+        constants->slices = XMFLOAT4(sliceScale, sliceBias, nearPlane, farPlane);
+        constants->lightCount = m_Stats.lights;
+        constants->tilesX = kTilesX;
+        constants->tilesY = kTilesY;
+        constants->sliceCount = kSlices;
+        context->Unmap(m_ClusterCB, 0);
+    }
+}
+
+void ClusteredLighting::Bind(ID3D11DeviceContext* context) const {
+    if (!m_Initialized || !context) {
+        return;
+    }
+    ID3D11ShaderResourceView* srvs[3] = { m_LightSRV, m_ClusterSRV, m_IndexSRV };
+    context->PSSetConstantBuffers(kClusterBufferSlot, 1, &m_ClusterCB);
+    context->PSSetShaderResources(kLightSlot, 3, srvs);
+}
+
+void ClusteredLighting::Unbind(ID3D11DeviceContext* context) const {
+    if (!context) {
+        return;
+    }
+    ID3D11Buffer* nullBuffer = nullptr;
+    ID3D11ShaderResourceView* nullSRVs[3] = { nullptr, nullptr, nullptr };
+    context->PSSetConstantBuffers(kClusterBufferSlot, 1, &nullBuffer);
+    context->PSSetShaderResources(kLightSlot, 3, nullSRVs);
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,140 @@
+#pragma once
+#include "CameraService.h"
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 点光源 / 聚光灯的分簇前向光照（LightComponent，Directional 仍由太阳路径处理）
+ *
+ * 观察空间视锥按 kTilesX x kTilesY 屏幕块、kSlices 个指数深度切片划分为簇（froxel）。
+ * 每帧在 CPU 上把光源的包围球装箱到覆盖的簇，写出三个结构化缓冲区：
+ * - 光源数组（t7）
+ * - 每簇的 (偏移, 数量)（t8）
+ * - 紧凑的光源下标列表（t9）
+ * textured.hlsl 的 ShadeLocalLights 由像素位置和观察深度找到所在簇，只遍历该簇的光源，
+ * 着色开销与局部光源密度相关，与场景光源总数无关。
+ *
+ * 超过 kMaxLights 时只保留离相机最近的光源；簇下标总数超过 kMaxLightIndices 时截断并记录日志。
+ */
+class ClusteredLighting {
+public:
+    static constexpr uint32_t kTilesX = 16;
+    static constexpr uint32_t kTilesY = 9;
+    static constexpr uint32_t kSlices = 24;
+    static constexpr uint32_t kClusterCount = kTilesX * kTilesY * kSlices;
+    static constexpr uint32_t kMaxLights = 256;
+    static constexpr uint32_t kMaxLightIndices = 32768;
+
+    static constexpr UINT kClusterBufferSlot = 4;          // PS b4
+    static constexpr UINT kLightSlot = 7;                  // PS t7
+    static constexpr UINT kClusterSlot = 8;                // PS t8
+    static constexpr UINT kLightIndexSlot = 9;             // PS t9
+
+    struct Stats {
+        uint32_t lights = 0;                // 本帧装箱的光源数
+        uint32_t lightIndices = 0;          // 全部簇的下标总数
+        uint32_t maxLightsPerCluster = 0;
+        bool truncated = false;             // 下标列表是否溢出
+    };
+
+    ClusteredLighting() = default;
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    bool Initialize(ID3D11Device* device);
+
+    /**
+     * @brief 收集 LightComponent、装箱并上传（PrepareQueue 之后、Execute 之前调用）
+     *
+     * 屏幕块按场景视口划分（动态分辨率下即缩放后的渲染目标）；在 FrameGraph 中先于场景通道执行，
+     * 此时绑定的还不是场景视口，由调用方传入。
+     */
+    void Update(ID3D11DeviceContext* context, entt::registry& registry, const CameraFrame& camera,
+                const D3D11_VIEWPORT& viewport);
+
+    /**
+     * @brief 为着色通道绑定簇常量和三个结构化缓冲区
+     */
+    void Bind(ID3D11DeviceContext* context) const;
+    void Unbind(ID3D11DeviceContext* context) const;
+
+    /** @brief 最远的分簇距离（更远处不受局部光源影响） */
+    void SetMaxDistance(float distance) { m_MaxDistance = distance; }
+    float GetMaxDistance() const { return m_MaxDistance; }
+
+    bool IsInitialized() const { return m_Initialized; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    /**
+     * @brief 与 textured.hlsl 中 LocalLight 一致（64 字节）
+     */
+    struct GPULight {
+        DirectX::XMFLOAT3 position;         // 世界空间
+        float range;
+        DirectX::XMFLOAT3 color;            // 已乘 intensity
+        float attenuation;
+        DirectX::XMFLOAT3 direction;        // 聚光灯朝向（世界空间单位向量）
+        float spotCosOuter;
+        float spotCosInner;
+        float isSpot;
+        float padding[2];
+    };
+    static_assert(sizeof(GPULight) == 64, "GPULight must match LocalLight in textured.hlsl");
+
+    /**
+     * @brief 与 textured.hlsl 中 ClusterBuffer 一致（112 字节）
+     */
+    struct ClusterConstants {
+        DirectX::XMFLOAT4X4 view;           // 行主序（世界 → 观察空间）
+        DirectX::XMFLOAT4 screen;           // xy = 屏幕块数 / 视口尺寸, zw = 视口原点
+        DirectX::XMFLOAT4 slices;           // x = 切片缩放, y = 切片偏移, z = 近平面, w = 最远距离
+        uint32_t lightCount;
+        uint32_t tilesX;
+        uint32_t tilesY;
+        uint32_t sliceCount;
+    };
+    static_assert(sizeof(ClusterConstants) == 112, "ClusterConstants must match textured.hlsl");
+
+    struct Candidate {
+        GPULight light;
+        DirectX::XMFLOAT3 viewCenter;
+        float distance;                     // 到相机的距离减去半径（超过上限时的取舍依据）
+        uint16_t minTile[2];                // 覆盖的屏幕块范围（含）
+        uint16_t maxTile[2];
+        uint16_t minSlice;
+        uint16_t maxSlice;
+    };
+
+    bool CreateDynamicStructuredBuffer(UINT stride, UINT count, ID3D11Buffer** outBuffer,
+                                       ID3D11ShaderResourceView** outSRV);
+
+    ID3D11Device* m_Device = nullptr;
+    bool m_Initialized = false;
+    float m_MaxDistance = 1000.0f;
+    Stats m_Stats;
+
+    ID3D11Buffer* m_ClusterCB = nullptr;
+    ID3D11Buffer* m_LightBuffer = nullptr;
+    ID3D11ShaderResourceView* m_LightSRV = nullptr;
+    ID3D11Buffer* m_ClusterBuffer = nullptr;
+    ID3D11ShaderResourceView* m_ClusterSRV = nullptr;
+    ID3D11Buffer* m_IndexBuffer = nullptr;
+    ID3D11ShaderResourceView* m_IndexSRV = nullptr;
+
+    // 每帧复用的装箱数据
+    std::vector<Candidate> m_Candidates;
+    std::vector<uint32_t> m_ClusterCounts;                 // 每簇 (偏移, 数量) 交错存放
+    std::vector<uint32_t> m_LightIndices;
+    std::vector<uint32_t> m_ClusterCursor;
+    bool m_LoggedTruncation = false;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,184 @@
+#include "DynamicResolution.h"
+#include "GpuMemory.h"
+#include "RenderStateCache.h"
+#include "resources/Shader.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace outer_wilds {
+
+namespace {
+
+/**
+ * @brief 与 upscale.hlsl 中 UpscaleBuffer 一致
+ */
+struct UpscaleConstants {
+    float uvScale[2];
+    float uvClamp[2];
+};
+
+} // namespace
+
+DynamicResolution::~DynamicResolution() {
+    for (auto& query : m_Queries) {
+        if (query.disjoint) query.disjoint->Release();
+        if (query.begin) query.begin->Release();
+        if (query.end) query.end->Release();
+    }
+    if (m_UpscaleCB) m_UpscaleCB->Release();
+}
+
+bool DynamicResolution::Initialize(ID3D11Device* device) {
+    if (!device) return false;
+    m_Device = device;
+
+    // 只用 SV_VertexID，positionOnly 布局不会被使用
+    m_UpscaleShader = std::make_unique<resources::Shader>();
+    if (!m_UpscaleShader->LoadFromFile(device, "upscale.vs", "upscale.ps", true)) {
+        DebugManager::GetInstance().Log("DynamicResolution", "Failed to load upscale shader");
+        return false;
+    }
+
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    m_LinearSampler = stateCache.GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP);
+    if (!m_LinearSampler) {
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.ByteWidth = 16;
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    if (FAILED(device->CreateBuffer(&cbDesc, nullptr, &m_UpscaleCB))) {
+        return false;
+    }
+    GpuMemory::Track(m_UpscaleCB);
+
+    // 透明段之后执行：显式声明不混合
+    m_UpscaleState.blend = stateCache.GetBlendState(RenderStateCache::BlendMode::Opaque);
+    m_UpscaleState.depthStencil = stateCache.GetDepthStencilState(false, false, D3D11_COMPARISON_ALWAYS);
+    m_UpscaleState.rasterizer = stateCache.GetRasterizerState(D3D11_CULL_NONE);
+    if (!m_UpscaleState.blend || !m_UpscaleState.depthStencil || !m_UpscaleState.rasterizer) {
+        return false;
+    }
+
+    for (auto& query : m_Queries) {
+        D3D11_QUERY_DESC queryDesc = {};
+        queryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        if (FAILED(device->CreateQuery(&queryDesc, &query.disjoint))) {
+            return false;
+        }
+        queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+        if (FAILED(device->CreateQuery(&queryDesc, &query.begin)) ||
+            FAILED(device->CreateQuery(&queryDesc, &query.end))) {
+            return false;
+        }
+    }
+
+    m_Initialized = true;
+    DebugManager::GetInstance().Log("DynamicResolution", "Initialized");
+    return true;
+}
+
+void DynamicResolution::SetScaleRange(float minScale, float maxScale) {
+    m_MaxScale = (std::min)((std::max)(maxScale, 0.1f), 1.0f);
+    m_MinScale = (std::min)((std::max)(minScale, 0.1f), m_MaxScale);
+    m_Scale = (std::min)((std::max)(m_Scale, m_MinScale), m_MaxScale);
+}
+
+/**
+ * @brief 读取即将被复用的那一组查询（kQueryLatency 帧前发出），未完成时丢弃该样本
+ */
+void DynamicResolution::ReadTimings(ID3D11DeviceContext* context) {
+    TimingQuery& query = m_Queries[m_QueryFrame % kQueryLatency];
+    if (!query.pending) {
+        return;
+    }
+    query.pending = false;
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+    UINT64 begin = 0;
+    UINT64 end = 0;
+    if (context->GetData(query.disjoint, &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+        context->GetData(query.begin, &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+        context->GetData(query.end, &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+        return;
+    }
+    if (disjoint.Disjoint || disjoint.Frequency == 0 || end <= begin) {
+        return;  // 期间 GPU 频率变化（节能/切换电源），样本无效
+    }
+
+    const float gpuMs = static_cast<float>(static_cast<double>(end - begin) * 1000.0 / disjoint.Frequency);
+    UpdateScale(gpuMs);
+}
+
+void DynamicResolution::UpdateScale(float gpuMs) {
+    m_SmoothedMs = m_SmoothedMs > 0.0f ? m_SmoothedMs + (gpuMs - m_SmoothedMs) * kSmoothing : gpuMs;
+    if (!m_Enabled || m_SmoothedMs <= 0.0f) {
+        return;
+    }
+
+    // GPU 时间大致与像素数（边长比例的平方）成正比
+    float scale = m_Scale;
+    if (m_SmoothedMs > m_TargetMs) {
+        scale *= (std::max)(std::sqrt(m_TargetMs / m_SmoothedMs), 1.0f - kMaxStepDown);
+    } else if (m_SmoothedMs < m_TargetMs * kHeadroom) {
+        scale *= (std::min)(std::sqrt(m_TargetMs * kHeadroom / m_SmoothedMs), 1.0f + kMaxStepUp);
+    }
+    m_Scale = (std::min)((std::max)(scale, m_MinScale), m_MaxScale);
+}
+
+void DynamicResolution::BeginScene(ID3D11DeviceContext* context, uint32_t outputWidth, uint32_t outputHeight) {
+    if (!m_Initialized || !context) {
+        m_RenderWidth = outputWidth;
+        m_RenderHeight = outputHeight;
+        return;
+    }
+
+    ReadTimings(context);
+
+    const float scale = m_Enabled ? m_Scale : m_MaxScale;
+    m_RenderWidth = (std::max)(1u, (std::min)(outputWidth, static_cast<uint32_t>(std::lround(outputWidth * scale))));
+    m_RenderHeight = (std::max)(1u, (std::min)(outputHeight, static_cast<uint32_t>(std::lround(outputHeight * scale))));
+
+    TimingQuery& query = m_Queries[m_QueryFrame % kQueryLatency];
+    context->Begin(query.disjoint);
+    context->End(query.begin);
+}
+
+void DynamicResolution::Resolve(ID3D11DeviceContext* context, uint32_t targetWidth, uint32_t targetHeight) {
+    if (!m_Initialized || !context || targetWidth == 0 || targetHeight == 0) {
+        return;
+    }
+
+    UpscaleConstants constants = {};
+    constants.uvScale[0] = static_cast<float>(m_RenderWidth) / targetWidth;
+    constants.uvScale[1] = static_cast<float>(m_RenderHeight) / targetHeight;
+    constants.uvClamp[0] = (m_RenderWidth - 0.5f) / targetWidth;
+    constants.uvClamp[1] = (m_RenderHeight - 0.5f) / targetHeight;
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (SUCCEEDED(context->Map(m_UpscaleCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        memcpy(mapped.pData, &constants, sizeof(constants));
+        context->Unmap(m_UpscaleCB, 0);
+    }
+
+    RenderStateCache::GetInstance().Apply(context, m_UpscaleState);
+    context->IASetInputLayout(nullptr);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->VSSetShader(m_UpscaleShader->GetVertexShader(), nullptr, 0);
+    context->PSSetShader(m_UpscaleShader->GetPixelShader(), nullptr, 0);
+    context->PSSetConstantBuffers(0, 1, &m_UpscaleCB);
+    context->PSSetSamplers(0, 1, &m_LinearSampler);
+    context->Draw(3, 0);
+
+    TimingQuery& query = m_Queries[m_QueryFrame % kQueryLatency];
+    context->End(query.end);
+    context->End(query.disjoint);
+    query.pending = true;
+    m_QueryFrame++;
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,113 @@
+#pragma once
+#include <d3d11.h>
+#include "RenderStateCache.h"
+#include <memory>
+#include <cstdint>
+
+namespace outer_wilds {
+namespace resources {
+    class Shader;
+}
+
+/**
+ * @brief 由 GPU 帧时间驱动的动态分辨率
+ *
+ * 场景先渲染到一张与后缓冲区等大的离屏目标（FrameGraph 的瞬态纹理），但只使用左上角 renderScale 比例的子区域
+ * （缩放时不重建纹理，切换没有卡顿）；Resolve 用一次全屏三角形把子区域双线性拉伸到后缓冲区，
+ * 之后 UISystem 以原生分辨率绘制 ImGui。
+ *
+ * GPU 时间：每帧一组 TIMESTAMP_DISJOINT + 两个 TIMESTAMP 查询包住场景通道，kQueryLatency 帧环形
+ * 复用，只读取已完成的最旧一组（DONOTFLUSH），不会让 CPU 等待 GPU。
+ *
+ * 控制器：GPU 时间做指数平滑后与目标帧时间比较，超出目标时按比例快速降低分辨率，
+ * 低于目标的 kHeadroom 比例时缓慢升高；每帧步长受限，落在死区内不调整，避免来回抖动。
+ */
+class DynamicResolution {
+public:
+    static constexpr uint32_t kQueryLatency = 3;
+    static constexpr float kHeadroom = 0.85f;         // GPU 时间低于目标的该比例才升分辨率
+    static constexpr float kSmoothing = 0.1f;         // GPU 时间的指数平滑系数
+    static constexpr float kMaxStepDown = 0.1f;       // 每帧最大缩小比例
+    static constexpr float kMaxStepUp = 0.02f;        // 每帧最大放大比例
+
+    DynamicResolution() = default;
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    bool Initialize(ID3D11Device* device);
+
+    /**
+     * @brief 开始场景通道：读取 GPU 时间并更新缩放，开始计时
+     * @param outputWidth/outputHeight 后缓冲区尺寸（场景目标与之等大）
+     */
+    void BeginScene(ID3D11DeviceContext* context, uint32_t outputWidth, uint32_t outputHeight);
+
+    /**
+     * @brief 结束计时并把场景拉伸到输出
+     *
+     * 调用前 FrameGraph 已绑定输出目标（视口为整个输出）并把场景纹理绑定到 PS t0。
+     * @param targetWidth/targetHeight 场景纹理尺寸
+     */
+    void Resolve(ID3D11DeviceContext* context, uint32_t targetWidth, uint32_t targetHeight);
+
+    /**
+     * @brief 本帧场景实际渲染尺寸（视口）
+     */
+    uint32_t GetRenderWidth() const { return m_RenderWidth; }
+    uint32_t GetRenderHeight() const { return m_RenderHeight; }
+
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsEnabled() const { return m_Enabled; }
+
+    /**
+     * @brief 缩放范围（边长比例，最大值为 1.0）
+     */
+    void SetScaleRange(float minScale, float maxScale);
+    float GetMinScale() const { return m_MinScale; }
+    float GetMaxScale() const { return m_MaxScale; }
+
+    /**
+     * @brief 目标 GPU 帧时间（毫秒）
+     */
+    void SetTargetFrameTime(float milliseconds) { m_TargetMs = milliseconds > 1.0f ? milliseconds : 1.0f; }
+    float GetTargetFrameTime() const { return m_TargetMs; }
+
+    float GetRenderScale() const { return m_Scale; }
+    float GetGpuFrameTime() const { return m_SmoothedMs; }   // 平滑后的场景 GPU 时间（毫秒）
+    bool IsInitialized() const { return m_Initialized; }
+
+private:
+    struct TimingQuery {
+        ID3D11Query* disjoint = nullptr;
+        ID3D11Query* begin = nullptr;
+        ID3D11Query* end = nullptr;
+        bool pending = false;
+    };
+
+    void ReadTimings(ID3D11DeviceContext* context);
+    void UpdateScale(float gpuMs);
+
+    ID3D11Device* m_Device = nullptr;
+    bool m_Initialized = false;
+    bool m_Enabled = true;
+
+    std::unique_ptr<resources::Shader> m_UpscaleShader;
+    ID3D11SamplerState* m_LinearSampler = nullptr;          // RenderStateCache 持有
+    ID3D11Buffer* m_UpscaleCB = nullptr;
+    PassState m_UpscaleState;                               // 不混合、无深度、不剔除（RenderStateCache 持有）
+
+    TimingQuery m_Queries[kQueryLatency];
+    uint32_t m_QueryFrame = 0;
+
+    float m_Scale = 1.0f;
+    float m_MinScale = 0.5f;
+    float m_MaxScale = 1.0f;
+    float m_TargetMs = 1000.0f / 60.0f;
+    float m_SmoothedMs = 0.0f;
+    uint32_t m_RenderWidth = 0;
+    uint32_t m_RenderHeight = 0;
+};
+
+} // namespace outer_wilds
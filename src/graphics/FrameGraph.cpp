@@ -0,0 +1,463 @@
+#include "FrameGraph.h"
+#include "GpuMemory.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace outer_wilds {
+
+namespace {
+
+/**
+ * @brief 可被采样的深度目标需要 TYPELESS 纹理格式 + 分别类型化的 DSV / SRV
+ */
+bool GetDepthSrvFormats(DXGI_FORMAT depthFormat, DXGI_FORMAT& textureFormat, DXGI_FORMAT& srvFormat) {
+    switch (depthFormat) {
+        case DXGI_FORMAT_D24_UNORM_S8_UINT:
+            textureFormat = DXGI_FORMAT_R24G8_TYPELESS;
+            srvFormat = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+            return true;
+        case DXGI_FORMAT_D32_FLOAT:
+            textureFormat = DXGI_FORMAT_R32_TYPELESS;
+            srvFormat = DXGI_FORMAT_R32_FLOAT;
+            return true;
+        default:
+            return false;
+    }
+}
+
+const FrameGraphTextureDesc kEmptyDesc = {};
+
+} // namespace
+
+// ============================================
+// Builder
+// ============================================
+
+FrameGraphResource FrameGraph::Builder::Create(const char* name, const FrameGraphTextureDesc& desc) {
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    node.creator = m_Pass;
+    const FrameGraphResource resource = static_cast<FrameGraphResource>(m_Graph.m_Resources.size());
+    m_Graph.m_Resources.push_back(node);
+    m_Graph.m_Passes[m_Pass].writes.push_back(resource);
+    return resource;
+}
+
+FrameGraphResource FrameGraph::Builder::Read(FrameGraphResource resource) {
+    if (!m_Graph.IsValid(resource)) {
+        return kInvalidFrameGraphResource;
+    }
+    m_Graph.m_Passes[m_Pass].reads.push_back(resource);
+    return resource;
+}
+
+FrameGraphResource FrameGraph::Builder::ReadTexture(FrameGraphResource resource, UINT slot) {
+    if (Read(resource) == kInvalidFrameGraphResource) {
+        return kInvalidFrameGraphResource;
+    }
+    m_Graph.m_Passes[m_Pass].textures.push_back({ resource, slot });
+    return resource;
+}
+
+FrameGraphResource FrameGraph::Builder::Write(FrameGraphResource resource) {
+    if (!m_Graph.IsValid(resource)) {
+        return kInvalidFrameGraphResource;
+    }
+    PassNode& pass = m_Graph.m_Passes[m_Pass];
+    if (std::find(pass.writes.begin(), pass.writes.end(), resource) == pass.writes.end()) {
+        pass.writes.push_back(resource);
+    }
+    return resource;
+}
+
+FrameGraphResource FrameGraph::Builder::WriteColor(FrameGraphResource resource, UINT index) {
+    if (index >= kMaxColorTargets || Write(resource) == kInvalidFrameGraphResource) {
+        return kInvalidFrameGraphResource;
+    }
+    m_Graph.m_Passes[m_Pass].colorTargets[index] = resource;
+    return resource;
+}
+
+FrameGraphResource FrameGraph::Builder::WriteDepth(FrameGraphResource resource) {
+    if (Write(resource) == kInvalidFrameGraphResource) {
+        return kInvalidFrameGraphResource;
+    }
+    m_Graph.m_Passes[m_Pass].depthTarget = resource;
+    return resource;
+}
+
+void FrameGraph::Builder::SetSideEffect() {
+    m_Graph.m_Passes[m_Pass].sideEffect = true;
+}
+
+// ============================================
+// Resources
+// ============================================
+
+ID3D11RenderTargetView* FrameGraph::Resources::GetRTV(FrameGraphResource resource) const {
+    return m_Graph.IsValid(resource) ? m_Graph.m_Resources[resource].rtv : nullptr;
+}
+
+ID3D11DepthStencilView* FrameGraph::Resources::GetDSV(FrameGraphResource resource) const {
+    return m_Graph.IsValid(resource) ? m_Graph.m_Resources[resource].dsv : nullptr;
+}
+
+ID3D11ShaderResourceView* FrameGraph::Resources::GetSRV(FrameGraphResource resource) const {
+    return m_Graph.IsValid(resource) ? m_Graph.m_Resources[resource].srv : nullptr;
+}
+
+const FrameGraphTextureDesc& FrameGraph::Resources::GetDesc(FrameGraphResource resource) const {
+    return m_Graph.IsValid(resource) ? m_Graph.m_Resources[resource].desc : kEmptyDesc;
+}
+
+// ============================================
+// FrameGraph
+// ============================================
+
+FrameGraph::~FrameGraph() {
+    ReleasePool();
+}
+
+bool FrameGraph::Initialize(ID3D11Device* device) {
+    if (!device) {
+        return false;
+    }
+    if (m_Device && m_Device != device) {
+        ReleasePool();  // 设备重建：旧设备的纹理不能复用
+    }
+    m_Device = device;
+    return true;
+}
+
+void FrameGraph::Reset() {
+    m_FrameIndex++;
+    m_Passes.clear();
+    m_Resources.clear();
+    m_BoundTargets.clear();
+    m_Compiled = false;
+
+    // 闲置过久的池纹理（分辨率变化 / 通道被关闭）释放，池的大小跟随最近几帧的实际需求
+    for (size_t i = 0; i < m_Pool.size();) {
+        PooledTexture& entry = m_Pool[i];
+        entry.inUse = false;
+        if (m_FrameIndex - entry.lastUsedFrame > kPoolRetainFrames) {
+            ReleasePooledTexture(entry);
+            m_Pool[i] = m_Pool.back();
+            m_Pool.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    m_Stats.passes = 0;
+    m_Stats.culledPasses = 0;
+    m_Stats.transientResources = 0;
+    m_Stats.physicalTextures = 0;
+    UpdatePoolStats();
+}
+
+FrameGraphResource FrameGraph::Import(const char* name, const FrameGraphTextureDesc& desc,
+                                      ID3D11RenderTargetView* rtv, ID3D11DepthStencilView* dsv,
+                                      ID3D11ShaderResourceView* srv) {
+    ResourceNode node;
+    node.name = name;
+    node.desc = desc;
+    node.imported = true;
+    node.rtv = rtv;
+    node.dsv = dsv;
+    node.srv = srv;
+    m_Resources.push_back(node);
+    return static_cast<FrameGraphResource>(m_Resources.size() - 1);
+}
+
+void FrameGraph::MarkOutput(FrameGraphResource resource) {
+    if (IsValid(resource)) {
+        m_Resources[resource].output = true;
+    }
+}
+
+void FrameGraph::AddPass(const char* name, const SetupFn& setup, ExecuteFn execute) {
+    PassNode pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_Passes.push_back(std::move(pass));
+
+    Builder builder(*this, static_cast<uint32_t>(m_Passes.size() - 1));
+    if (setup) {
+        setup(builder);
+    }
+}
+
+bool FrameGraph::Compile() {
+    m_Compiled = false;
+    m_Stats.passes = static_cast<uint32_t>(m_Passes.size());
+    m_Stats.culledPasses = 0;
+    m_Stats.transientResources = 0;
+    m_Stats.physicalTextures = 0;
+
+    // 1. 剔除：反向遍历，写入了被需要资源的通道存活，存活通道的读取（以及读-改-写的目标）变为被需要
+    std::vector<bool> needed(m_Resources.size(), false);
+    for (size_t r = 0; r < m_Resources.size(); r++) {
+        needed[r] = m_Resources[r].output;
+    }
+    for (size_t i = m_Passes.size(); i-- > 0;) {
+        PassNode& pass = m_Passes[i];
+        bool alive = pass.sideEffect;
+        for (FrameGraphResource resource : pass.writes) {
+            alive = alive || needed[resource];
+        }
+        pass.culled = !alive;
+        if (!alive) {
+            m_Stats.culledPasses++;
+            continue;
+        }
+        for (FrameGraphResource resource : pass.reads) {
+            needed[resource] = true;
+        }
+        for (FrameGraphResource resource : pass.writes) {
+            needed[resource] = m_Resources[resource].creator != i;
+        }
+    }
+
+    // 2. 生命周期：只计存活通道
+    for (uint32_t i = 0; i < m_Passes.size(); i++) {
+        const PassNode& pass = m_Passes[i];
+        if (pass.culled) continue;
+        auto touch = [&](FrameGraphResource resource) {
+            ResourceNode& node = m_Resources[resource];
+            node.firstPass = (std::min)(node.firstPass, i);
+            node.lastPass = (std::max)(node.lastPass, i);
+        };
+        for (FrameGraphResource resource : pass.reads) touch(resource);
+        for (FrameGraphResource resource : pass.writes) touch(resource);
+    }
+
+    // 3. 分配：按执行顺序模拟，最后一次使用之后归还，之后的同描述资源复用同一张纹理
+    for (PooledTexture& entry : m_Pool) {
+        entry.inUse = false;
+    }
+    for (uint32_t i = 0; i < m_Passes.size(); i++) {
+        if (m_Passes[i].culled) continue;
+        for (ResourceNode& node : m_Resources) {
+            if (node.imported || node.firstPass != i) continue;
+            node.physical = AcquireTexture(node.desc);
+            if (node.physical == UINT32_MAX) {
+                DebugManager::GetInstance().Log("FrameGraph",
+                    std::string("Failed to allocate transient texture: ") + (node.name ? node.name : "?"));
+                UpdatePoolStats();
+                return false;
+            }
+            m_Stats.transientResources++;
+        }
+        for (ResourceNode& node : m_Resources) {
+            if (node.imported || node.physical == UINT32_MAX || node.lastPass != i) continue;
+            m_Pool[node.physical].inUse = false;
+        }
+    }
+
+    // 池在分配中可能增长：全部分配完成之后再取视图
+    std::vector<bool> used(m_Pool.size(), false);
+    for (ResourceNode& node : m_Resources) {
+        if (node.imported || node.physical == UINT32_MAX) continue;
+        const PooledTexture& entry = m_Pool[node.physical];
+        node.rtv = entry.rtv;
+        node.dsv = entry.dsv;
+        node.srv = entry.srv;
+        if (!used[node.physical]) {
+            used[node.physical] = true;
+            m_Stats.physicalTextures++;
+        }
+    }
+
+    UpdatePoolStats();
+    m_Compiled = true;
+    return true;
+}
+
+void FrameGraph::Execute(ID3D11DeviceContext* context) {
+    if (!m_Compiled || !context) {
+        return;
+    }
+
+    const Resources resources(*this);
+    for (const PassNode& pass : m_Passes) {
+        if (pass.culled) continue;
+
+        // 先换渲染目标再绑定 SRV：上一个通道的目标仍绑定在 OM 上时，运行时会把同一资源的 SRV 置空
+        BindTargets(context, pass);
+        for (const TextureBinding& binding : pass.textures) {
+            ID3D11ShaderResourceView* srv = m_Resources[binding.resource].srv;
+            context->PSSetShaderResources(binding.slot, 1, &srv);
+        }
+
+        if (pass.execute) {
+            pass.execute(context, resources);
+        }
+
+        // 之后的通道可能把这些纹理作为目标写入
+        ID3D11ShaderResourceView* unbound = nullptr;
+        for (const TextureBinding& binding : pass.textures) {
+            context->PSSetShaderResources(binding.slot, 1, &unbound);
+        }
+    }
+}
+
+void FrameGraph::BindTargets(ID3D11DeviceContext* context, const PassNode& pass) {
+    ID3D11RenderTargetView* rtvs[kMaxColorTargets] = {};
+    UINT colorCount = 0;
+    FrameGraphResource viewportSource = pass.depthTarget;
+    for (UINT i = 0; i < kMaxColorTargets; i++) {
+        const FrameGraphResource resource = pass.colorTargets[i];
+        if (resource == kInvalidFrameGraphResource) continue;
+        rtvs[i] = m_Resources[resource].rtv;
+        colorCount = i + 1;
+        if (viewportSource == kInvalidFrameGraphResource || i == 0) {
+            viewportSource = resource;
+        }
+    }
+
+    if (colorCount == 0 && pass.depthTarget == kInvalidFrameGraphResource) {
+        // 不声明目标的通道保留当前绑定，除非要读取其中之一
+        for (FrameGraphResource resource : pass.reads) {
+            if (std::find(m_BoundTargets.begin(), m_BoundTargets.end(), resource) != m_BoundTargets.end()) {
+                context->OMSetRenderTargets(0, nullptr, nullptr);
+                m_BoundTargets.clear();
+                break;
+            }
+        }
+        return;
+    }
+
+    ID3D11DepthStencilView* dsv =
+        pass.depthTarget != kInvalidFrameGraphResource ? m_Resources[pass.depthTarget].dsv : nullptr;
+    context->OMSetRenderTargets(colorCount, colorCount > 0 ? rtvs : nullptr, dsv);
+
+    m_BoundTargets.clear();
+    for (UINT i = 0; i < colorCount; i++) {
+        if (pass.colorTargets[i] != kInvalidFrameGraphResource) m_BoundTargets.push_back(pass.colorTargets[i]);
+    }
+    if (pass.depthTarget != kInvalidFrameGraphResource) m_BoundTargets.push_back(pass.depthTarget);
+
+    const FrameGraphTextureDesc& desc = m_Resources[viewportSource].desc;
+    D3D11_VIEWPORT viewport = {};
+    viewport.Width = static_cast<float>(desc.width);
+    viewport.Height = static_cast<float>(desc.height);
+    viewport.MaxDepth = 1.0f;
+    context->RSSetViewports(1, &viewport);
+}
+
+uint32_t FrameGraph::AcquireTexture(const FrameGraphTextureDesc& desc) {
+    for (uint32_t i = 0; i < m_Pool.size(); i++) {
+        PooledTexture& entry = m_Pool[i];
+        if (!entry.inUse && entry.desc == desc) {
+            entry.inUse = true;
+            entry.lastUsedFrame = m_FrameIndex;
+            return i;
+        }
+    }
+
+    PooledTexture entry;
+    entry.desc = desc;
+    if (!CreatePooledTexture(entry)) {
+        ReleasePooledTexture(entry);
+        return UINT32_MAX;
+    }
+    entry.inUse = true;
+    entry.lastUsedFrame = m_FrameIndex;
+    m_Pool.push_back(entry);
+    m_Stats.textureCreates++;
+    return static_cast<uint32_t>(m_Pool.size() - 1);
+}
+
+bool FrameGraph::CreatePooledTexture(PooledTexture& entry) {
+    const FrameGraphTextureDesc& desc = entry.desc;
+    if (!m_Device || desc.width == 0 || desc.height == 0) {
+        return false;
+    }
+
+    const bool depth = (desc.bindFlags & D3D11_BIND_DEPTH_STENCIL) != 0;
+    const bool sampled = (desc.bindFlags & D3D11_BIND_SHADER_RESOURCE) != 0;
+    DXGI_FORMAT textureFormat = desc.format;
+    DXGI_FORMAT srvFormat = desc.format;
+    if (depth && sampled && !GetDepthSrvFormats(desc.format, textureFormat, srvFormat)) {
+        DebugManager::GetInstance().Log("FrameGraph", "Unsupported sampled depth format");
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = desc.width;
+    textureDesc.Height = desc.height;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = 1;
+    textureDesc.Format = textureFormat;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = desc.bindFlags;
+    if (FAILED(m_Device->CreateTexture2D(&textureDesc, nullptr, &entry.texture))) {
+        return false;
+    }
+    GpuMemory::Track(entry.texture);
+
+    if ((desc.bindFlags & D3D11_BIND_RENDER_TARGET) &&
+        FAILED(m_Device->CreateRenderTargetView(entry.texture, nullptr, &entry.rtv))) {
+        return false;
+    }
+    if (depth) {
+        D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+        dsvDesc.Format = desc.format;
+        dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+        if (FAILED(m_Device->CreateDepthStencilView(entry.texture, &dsvDesc, &entry.dsv))) {
+            return false;
+        }
+    }
+    if (sampled) {
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = srvFormat;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = 1;
+        if (FAILED(m_Device->CreateShaderResourceView(entry.texture, &srvDesc, &entry.srv))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrameGraph::ReleasePooledTexture(PooledTexture& entry) {
+    if (entry.srv) { entry.srv->Release(); entry.srv = nullptr; }
+    if (entry.dsv) { entry.dsv->Release(); entry.dsv = nullptr; }
+    if (entry.rtv) { entry.rtv->Release(); entry.rtv = nullptr; }
+    if (entry.texture) { entry.texture->Release(); entry.texture = nullptr; }
+}
+
+void FrameGraph::ReleasePool() {
+    for (PooledTexture& entry : m_Pool) {
+        ReleasePooledTexture(entry);
+    }
+    m_Pool.clear();
+    // 本帧已分配的视图随池失效
+    for (ResourceNode& node : m_Resources) {
+        if (!node.imported) {
+            node.physical = UINT32_MAX;
+            node.rtv = nullptr;
+            node.dsv = nullptr;
+            node.srv = nullptr;
+        }
+    }
+    m_Compiled = false;
+    UpdatePoolStats();
+}
+
+void FrameGraph::UpdatePoolStats() {
+    m_Stats.pooledTextures = static_cast<uint32_t>(m_Pool.size());
+    m_Stats.pooledBytes = 0;
+    for (const PooledTexture& entry : m_Pool) {
+        D3D11_TEXTURE2D_DESC desc = {};
+        entry.texture->GetDesc(&desc);
+        m_Stats.pooledBytes += GpuMemory::EstimateTextureBytes(desc);
+    }
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,207 @@
+#pragma once
+#include <d3d11.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 帧图资源句柄（本帧内有效，Reset 之后失效）
+ */
+using FrameGraphResource = uint32_t;
+constexpr FrameGraphResource kInvalidFrameGraphResource = 0xFFFFFFFFu;
+
+/**
+ * @brief 瞬态纹理描述（单 mip、单层、无 MSAA）；池按整个描述匹配
+ *
+ * 深度格式（D24_UNORM_S8_UINT / D32_FLOAT）带 SHADER_RESOURCE 时纹理以对应的 TYPELESS 格式创建。
+ */
+struct FrameGraphTextureDesc {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    UINT bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+    bool operator==(const FrameGraphTextureDesc& other) const {
+        return width == other.width && height == other.height && format == other.format &&
+               bindFlags == other.bindFlags;
+    }
+};
+
+/**
+ * @brief 每帧重建的渲染通道图：声明读写 → 剔除 → 瞬态目标分配 → 按声明顺序执行
+ *
+ * 用法（每帧）：Reset → Import 外部资源（后缓冲区、跨帧缓存的阴影图 / 光源簇 / 天空盒立方体贴图）→
+ * AddPass（setup 立即调用，声明 Create / Read / Write）→ MarkOutput → Compile → Execute。
+ *
+ * - 剔除：从输出资源和带副作用的通道反向传播，结果没有被任何存活通道（或输出）使用的通道不执行。
+ *   Write 视为读-改-写，同一资源之前的写入通道随之保留；Create 的内容未定义，由创建它的通道负责清除。
+ * - 瞬态纹理：生命周期为第一个到最后一个使用它的存活通道；最后一次使用之后纹理回到池中，
+ *   同一帧内之后创建的同描述瞬态资源直接复用（D3D11 没有放置资源，别名限于相同描述）。
+ *   池跨帧保留，连续 kPoolRetainFrames 帧没有用到的纹理释放，分辨率变化后显存不会累积。
+ * - 绑定：WriteColor / WriteDepth 声明的目标由帧图在通道开始时绑定（视口为目标尺寸，通道可以缩小），
+ *   ReadTexture 声明的纹理绑定到 PS 的对应槽位并在通道结束后解除；读取上一个通道的渲染目标时先解除 OM 绑定。
+ *   混合 / 深度 / 光栅化状态仍由各通道经 RenderStateCache 声明。
+ *
+ * 只在立即上下文上执行；导入资源的视图可以为空（只用于表达通道之间的依赖）。
+ */
+class FrameGraph {
+public:
+    static constexpr uint32_t kMaxColorTargets = 4;
+    static constexpr uint32_t kPoolRetainFrames = 3;
+
+    struct Stats {
+        uint32_t passes = 0;                // 本帧声明的通道数
+        uint32_t culledPasses = 0;          // 本帧被剔除的通道数
+        uint32_t transientResources = 0;    // 本帧存活的瞬态资源数
+        uint32_t physicalTextures = 0;      // 本帧实际占用的池纹理数（别名后）
+        uint32_t pooledTextures = 0;        // 池中的纹理总数
+        uint64_t pooledBytes = 0;           // 池纹理的估算字节数
+        uint64_t textureCreates = 0;        // 累计创建的池纹理数
+    };
+
+    class Builder {
+    public:
+        /** @brief 创建瞬态纹理，本通道为第一个写入者 */
+        FrameGraphResource Create(const char* name, const FrameGraphTextureDesc& desc);
+        /** @brief 只声明依赖（通道自己绑定 / 使用该资源） */
+        FrameGraphResource Read(FrameGraphResource resource);
+        /** @brief 读取并由帧图绑定到 PS 的 t<slot> */
+        FrameGraphResource ReadTexture(FrameGraphResource resource, UINT slot);
+        /** @brief 声明修改（通道自己绑定，例如缓存的阴影图） */
+        FrameGraphResource Write(FrameGraphResource resource);
+        /** @brief 作为第 index 个渲染目标写入（帧图绑定） */
+        FrameGraphResource WriteColor(FrameGraphResource resource, UINT index = 0);
+        /** @brief 作为深度模板目标写入（帧图绑定） */
+        FrameGraphResource WriteDepth(FrameGraphResource resource);
+        /** @brief 通道有帧图看不到的结果，永不剔除 */
+        void SetSideEffect();
+
+    private:
+        friend class FrameGraph;
+        Builder(FrameGraph& graph, uint32_t pass) : m_Graph(graph), m_Pass(pass) {}
+
+        FrameGraph& m_Graph;
+        uint32_t m_Pass;
+    };
+
+    /**
+     * @brief 执行时按句柄取视图（视图所属的纹理在 Execute 期间有效）
+     */
+    class Resources {
+    public:
+        ID3D11RenderTargetView* GetRTV(FrameGraphResource resource) const;
+        ID3D11DepthStencilView* GetDSV(FrameGraphResource resource) const;
+        ID3D11ShaderResourceView* GetSRV(FrameGraphResource resource) const;
+        const FrameGraphTextureDesc& GetDesc(FrameGraphResource resource) const;
+
+    private:
+        friend class FrameGraph;
+        explicit Resources(const FrameGraph& graph) : m_Graph(graph) {}
+
+        const FrameGraph& m_Graph;
+    };
+
+    using SetupFn = std::function<void(Builder&)>;
+    using ExecuteFn = std::function<void(ID3D11DeviceContext*, const Resources&)>;
+
+    FrameGraph() = default;
+    ~FrameGraph();
+
+    FrameGraph(const FrameGraph&) = delete;
+    FrameGraph& operator=(const FrameGraph&) = delete;
+
+    bool Initialize(ID3D11Device* device);
+    bool IsInitialized() const { return m_Device != nullptr; }
+
+    /** @brief 开始新的一帧：清空通道和资源（池保留），释放闲置过久的池纹理 */
+    void Reset();
+
+    FrameGraphResource Import(const char* name, const FrameGraphTextureDesc& desc,
+                              ID3D11RenderTargetView* rtv = nullptr, ID3D11DepthStencilView* dsv = nullptr,
+                              ID3D11ShaderResourceView* srv = nullptr);
+    /** @brief 帧结束后仍被使用的资源（后缓冲区），剔除的起点 */
+    void MarkOutput(FrameGraphResource resource);
+
+    void AddPass(const char* name, const SetupFn& setup, ExecuteFn execute);
+
+    /**
+     * @brief 剔除 + 计算生命周期 + 分配瞬态纹理；瞬态纹理创建失败时返回 false（不应 Execute）
+     */
+    bool Compile();
+    void Execute(ID3D11DeviceContext* context);
+
+    /** @brief 释放池中全部纹理（设备销毁 / 调整大小之前可调用） */
+    void ReleasePool();
+
+    /** @brief 本帧通道（声明顺序）是否被剔除，供调试面板显示 */
+    uint32_t GetPassCount() const { return static_cast<uint32_t>(m_Passes.size()); }
+    const char* GetPassName(uint32_t pass) const { return m_Passes[pass].name; }
+    bool IsPassCulled(uint32_t pass) const { return m_Passes[pass].culled; }
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    struct PooledTexture {
+        FrameGraphTextureDesc desc;
+        ID3D11Texture2D* texture = nullptr;
+        ID3D11RenderTargetView* rtv = nullptr;
+        ID3D11DepthStencilView* dsv = nullptr;
+        ID3D11ShaderResourceView* srv = nullptr;
+        uint64_t lastUsedFrame = 0;
+        bool inUse = false;
+    };
+
+    struct ResourceNode {
+        const char* name = nullptr;
+        FrameGraphTextureDesc desc;
+        bool imported = false;
+        bool output = false;
+        uint32_t creator = UINT32_MAX;          // 瞬态资源的创建通道
+        uint32_t firstPass = UINT32_MAX;        // 存活通道中的生命周期
+        uint32_t lastPass = 0;
+        uint32_t physical = UINT32_MAX;         // m_Pool 下标
+        ID3D11RenderTargetView* rtv = nullptr;
+        ID3D11DepthStencilView* dsv = nullptr;
+        ID3D11ShaderResourceView* srv = nullptr;
+    };
+
+    struct TextureBinding {
+        FrameGraphResource resource;
+        UINT slot;
+    };
+
+    struct PassNode {
+        const char* name = nullptr;
+        ExecuteFn execute;
+        std::vector<FrameGraphResource> reads;
+        std::vector<FrameGraphResource> writes;     // 包括 Create / WriteColor / WriteDepth
+        std::vector<TextureBinding> textures;       // ReadTexture
+        FrameGraphResource colorTargets[kMaxColorTargets] = {
+            kInvalidFrameGraphResource, kInvalidFrameGraphResource,
+            kInvalidFrameGraphResource, kInvalidFrameGraphResource
+        };
+        FrameGraphResource depthTarget = kInvalidFrameGraphResource;
+        bool sideEffect = false;
+        bool culled = false;
+    };
+
+    bool IsValid(FrameGraphResource resource) const { return resource < m_Resources.size(); }
+    uint32_t AcquireTexture(const FrameGraphTextureDesc& desc);
+    bool CreatePooledTexture(PooledTexture& entry);
+    static void ReleasePooledTexture(PooledTexture& entry);
+    void BindTargets(ID3D11DeviceContext* context, const PassNode& pass);
+    void UpdatePoolStats();
+
+    ID3D11Device* m_Device = nullptr;
+    std::vector<PassNode> m_Passes;
+    std::vector<ResourceNode> m_Resources;
+    std::vector<PooledTexture> m_Pool;
+    std::vector<FrameGraphResource> m_BoundTargets;     // 当前 OM 上绑定的帧图资源
+    uint64_t m_FrameIndex = 0;
+    bool m_Compiled = false;
+    Stats m_Stats;
+};
+
+} // namespace outer_wilds
@@ -23,6 +23,15 @@ void FreeCameraSystem::Initialize(std::shared_ptr<Scene> scene) {
     Initialize();
 }
 
+void FreeCameraSystem::DeclareAccess(SystemAccess& access) const {
+    // HandleGlobalKeys 修改 InputManager 的鼠标锁定状态，并调用 PostQuitMessage / ShowCursor / ClipCursor
+    // 等属于窗口线程的 Win32 接口：必须在主线程上运行
+    access.Write<FreeCameraComponent, CameraComponent, TransformComponent>()
+          .Read<PlayerInputComponent>()
+          .WriteResource(SystemAccess::kInput)
+          .MainThread();
+}
+
 void FreeCameraSystem::Update(float deltaTime, entt::registry& registry) {
     // 处理全局按键（ESC+Backspace 解除鼠标锁定，Shift+ESC 退出程序）
     HandleGlobalKeys();
@@ -33,31 +42,20 @@ void FreeCameraSystem::Update(float deltaTime, entt::registry& registry) {
 }
 
 void FreeCameraSystem::HandleGlobalKeys() {
-    static bool escWasPressed = false;
-    static bool backspaceWasPressed = false;
-    static bool shiftWasPressed = false;
-    
-    bool escPressed = (GetAsyncKeyState(VK_ESCAPE) & 0x8000) != 0;
-    bool backspacePressed = (GetAsyncKeyState(VK_BACK) & 0x8000) != 0;
-    bool shiftPressed = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
+    auto& inputMgr = InputManager::GetInstance();
     
     // ESC + Backspace: 切换鼠标锁定
-    if (escPressed && backspacePressed && (!escWasPressed || !backspaceWasPressed)) {
-        auto& inputMgr = InputManager::GetInstance();
+    if (inputMgr.IsChordPressed(VK_ESCAPE, VK_BACK)) {
         bool newState = !inputMgr.IsMouseLookEnabled();
         inputMgr.SetMouseLookEnabled(newState);
         DebugManager::GetInstance().Log("FreeCam", newState ? "Mouse look ENABLED" : "Mouse look DISABLED");
     }
     
     // Shift + ESC: 退出程序（发送 WM_CLOSE）
-    if (shiftPressed && escPressed && !shiftWasPressed) {
+    if (inputMgr.IsKeyPressed(VK_SHIFT) && (inputMgr.IsKeyHeld(VK_ESCAPE) || inputMgr.IsKeyPressed(VK_ESCAPE))) {
         DebugManager::GetInstance().Log("FreeCam", "Shift+ESC: Requesting exit...");
         PostQuitMessage(0);
     }
-    
-    escWasPressed = escPressed;
-    backspaceWasPressed = backspacePressed;
-    shiftWasPressed = shiftPressed;
 }
 
 void FreeCameraSystem::Shutdown() {
@@ -123,10 +121,10 @@ void FreeCameraSystem::UpdateFreeCameraMovement(float deltaTime, entt::registry&
         // 调试输出 - 检查键盘直接状态
         static int debugFrame = 0;
         if (++debugFrame % 60 == 0) {
-            bool wPressed = (GetAsyncKeyState('W') & 0x8000) != 0;
-            bool sPressed = (GetAsyncKeyState('S') & 0x8000) != 0;
-            bool aPressed = (GetAsyncKeyState('A') & 0x8000) != 0;
-            bool dPressed = (GetAsyncKeyState('D') & 0x8000) != 0;
+            bool wPressed = InputManager::GetInstance().IsKeyHeld('W');
+            bool sPressed = InputManager::GetInstance().IsKeyHeld('S');
+            bool aPressed = InputManager::GetInstance().IsKeyHeld('A');
+            bool dPressed = InputManager::GetInstance().IsKeyHeld('D');
             
             std::stringstream ss;
             ss << "Keys: W=" << wPressed << " S=" << sPressed << " A=" << aPressed << " D=" << dPressed
@@ -166,8 +164,8 @@ void FreeCameraSystem::UpdateFreeCameraMovement(float deltaTime, entt::registry&
         movement = XMVectorAdd(movement, XMVectorScale(right, input.moveInput.x * currentSpeed * deltaTime));
 
         // Space上升，Ctrl下降（沿世界Y轴）
-        bool spacePressed = (GetAsyncKeyState(VK_SPACE) & 0x8000) != 0;
-        bool ctrlPressed = (GetAsyncKeyState(VK_CONTROL) & 0x8000) != 0;
+        bool spacePressed = InputManager::GetInstance().IsKeyHeld(VK_SPACE);
+        bool ctrlPressed = InputManager::GetInstance().IsKeyHeld(VK_CONTROL);
         
         if (spacePressed) {
             movement = XMVectorAdd(movement, XMVectorScale(worldUp, currentSpeed * deltaTime));
@@ -214,6 +212,7 @@ void FreeCameraSystem::SyncToCamera(entt::registry& registry) {
 
         // 相机上方向（世界空间Y轴）
         camera.up = {0.0f, 1.0f, 0.0f};
+        camera.lateLatchSensitivity = InputManager::GetInstance().IsMouseLookEnabled() ? freeCamera.lookSensitivity : 0.0f;
         
         // 同步yaw/pitch到CameraComponent（用于渲染系统）
         camera.yaw = freeCamera.yaw;
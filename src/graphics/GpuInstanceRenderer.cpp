@@ -0,0 +1,402 @@
+#include "GpuInstanceRenderer.h"
+#include "OcclusionCuller.h"
+#include "RenderQueue.h"
+#include "ShaderCompileService.h"
+#include "GpuMemory.h"
+#include "RenderStateCache.h"
+#include "components/GpuInstancedComponent.h"
+#include "components/BoundsComponent.h"
+#include "resources/Shader.h"
+#include "resources/Mesh.h"
+#include "resources/Material.h"
+#include "../scene/components/TransformComponent.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+using namespace DirectX;
+
+namespace outer_wilds {
+
+namespace {
+
+constexpr UINT kInstanceSlot = 0;       // CS t0
+constexpr UINT kHiZSlot = 1;            // CS t1
+constexpr UINT kObjectDataSlot = RenderQueue::kObjectDataSlot;  // VS t5
+
+// 矩阵前三行的最大长度（行向量约定下的最大轴缩放）
+float MaxAxisScale(const XMFLOAT4X4& m) {
+    const float sx = m._11 * m._11 + m._12 * m._12 + m._13 * m._13;
+    const float sy = m._21 * m._21 + m._22 * m._22 + m._23 * m._23;
+    const float sz = m._31 * m._31 + m._32 * m._32 + m._33 * m._33;
+    return std::sqrt((std::max)(sx, (std::max)(sy, sz)));
+}
+
+} // namespace
+
+GpuInstanceRenderer::~GpuInstanceRenderer() {
+    Clear();
+    if (m_IndexStream) m_IndexStream->Release();
+    if (m_HiZSRV) m_HiZSRV->Release();
+    if (m_HiZTexture) m_HiZTexture->Release();
+    if (m_CullConstants) m_CullConstants->Release();
+    if (m_CullShader) m_CullShader->Release();
+}
+
+bool GpuInstanceRenderer::Initialize(ID3D11Device* device) {
+    if (!device) return false;
+    m_Device = device;
+
+    m_CullShader = resources::Shader::LoadComputeShader(device, "gpu_cull.cs");
+    if (!m_CullShader) {
+        DebugManager::GetInstance().Log("GpuInstanceRenderer", "Failed to load gpu_cull compute shader");
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.ByteWidth = sizeof(CullConstants);
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    if (FAILED(device->CreateBuffer(&cbDesc, nullptr, &m_CullConstants))) {
+        DebugManager::GetInstance().Log("GpuInstanceRenderer", "Failed to create cull constant buffer");
+        return false;
+    }
+    GpuMemory::Track(m_CullConstants);
+
+    // Hi-Z：与 OcclusionCuller 的金字塔同尺寸的完整 mip 链
+    D3D11_TEXTURE2D_DESC hizDesc = {};
+    hizDesc.Width = OcclusionCuller::kWidth;
+    hizDesc.Height = OcclusionCuller::kHeight;
+    hizDesc.MipLevels = 0;
+    hizDesc.ArraySize = 1;
+    hizDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    hizDesc.SampleDesc.Count = 1;
+    hizDesc.Usage = D3D11_USAGE_DEFAULT;
+    hizDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    if (FAILED(device->CreateTexture2D(&hizDesc, nullptr, &m_HiZTexture)) ||
+        FAILED(device->CreateShaderResourceView(m_HiZTexture, nullptr, &m_HiZSRV))) {
+        DebugManager::GetInstance().Log("GpuInstanceRenderer", "Failed to create Hi-Z texture");
+        return false;
+    }
+    GpuMemory::Track(m_HiZTexture);
+    m_HiZTexture->GetDesc(&hizDesc);
+    m_HiZLevels = hizDesc.MipLevels;
+
+    // 与 RenderQueue 的默认采样器 / 不透明段相同的描述，缓存返回同一个状态对象
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    m_Sampler = stateCache.GetSamplerState(D3D11_FILTER_ANISOTROPIC, D3D11_TEXTURE_ADDRESS_WRAP, 16);
+    m_BlendState = stateCache.GetBlendState(RenderStateCache::BlendMode::Opaque);
+    m_DepthState = stateCache.GetDepthStencilState(true, true, D3D11_COMPARISON_LESS);
+
+    m_Initialized = true;
+    return true;
+}
+
+void GpuInstanceRenderer::ReleaseSet(InstanceSet& set) {
+    if (set.instanceSRV) set.instanceSRV->Release();
+    if (set.instanceBuffer) set.instanceBuffer->Release();
+    if (set.visibleUAV) set.visibleUAV->Release();
+    if (set.visibleSRV) set.visibleSRV->Release();
+    if (set.visibleBuffer) set.visibleBuffer->Release();
+    if (set.argsUAV) set.argsUAV->Release();
+    if (set.argsBuffer) set.argsBuffer->Release();
+    set = InstanceSet();
+}
+
+void GpuInstanceRenderer::Clear() {
+    for (auto& [entity, set] : m_Sets) {
+        ReleaseSet(set);
+    }
+    m_Sets.clear();
+    m_PendingDraws.clear();
+}
+
+bool GpuInstanceRenderer::EnsureIndexStream(uint32_t count) {
+    if (count <= m_IndexStreamCapacity && m_IndexStream) return true;
+
+    uint32_t capacity = (std::max)(m_IndexStreamCapacity, 1024u);
+    while (capacity < count) capacity *= 2;
+
+    std::vector<uint32_t> indices(capacity);
+    for (uint32_t i = 0; i < capacity; i++) indices[i] = i;
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+    desc.ByteWidth = capacity * sizeof(uint32_t);
+    desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    D3D11_SUBRESOURCE_DATA data = {};
+    data.pSysMem = indices.data();
+
+    ID3D11Buffer* buffer = nullptr;
+    if (FAILED(m_Device->CreateBuffer(&desc, &data, &buffer))) {
+        DebugManager::GetInstance().Log("GpuInstanceRenderer", "Failed to create object index stream");
+        return false;
+    }
+    GpuMemory::Track(buffer);
+    if (m_IndexStream) m_IndexStream->Release();
+    m_IndexStream = buffer;
+    m_IndexStreamCapacity = capacity;
+    return true;
+}
+
+bool GpuInstanceRenderer::UploadInstances(const components::GpuInstancedComponent& component, InstanceSet& set) {
+    ReleaseSet(set);
+
+    const uint32_t count = static_cast<uint32_t>((std::min)(component.instances.size(),
+                                                            static_cast<size_t>(kMaxInstancesPerSet)));
+    if (count < component.instances.size()) {
+        DebugManager::GetInstance().Log("GpuInstanceRenderer", "Instance count clamped to " + std::to_string(count));
+    }
+
+    // 实例包围球：mesh 包围球变换到实体局部空间（半径乘以实例的最大轴缩放）
+    const BoundingSphere meshSphere = components::BoundsComponent::SphereFromMesh(*component.mesh);
+    std::vector<GPUInstance> gpuInstances(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const XMFLOAT4X4& local = component.instances[i];
+        XMFLOAT3 center;
+        XMStoreFloat3(&center, XMVector3TransformCoord(XMLoadFloat3(&meshSphere.Center), XMLoadFloat4x4(&local)));
+        gpuInstances[i].local = local;
+        gpuInstances[i].sphere = XMFLOAT4(center.x, center.y, center.z, meshSphere.Radius * MaxAxisScale(local));
+    }
+
+    // 实例数据：只在组件变化时重建
+    D3D11_BUFFER_DESC instanceDesc = {};
+    instanceDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    instanceDesc.ByteWidth = count * sizeof(GPUInstance);
+    instanceDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    instanceDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    instanceDesc.StructureByteStride = sizeof(GPUInstance);
+    D3D11_SUBRESOURCE_DATA instanceData = {};
+    instanceData.pSysMem = gpuInstances.data();
+
+    // 可见实例：计算着色器写入（UAV），顶点着色器读取（t5）
+    D3D11_BUFFER_DESC visibleDesc = {};
+    visibleDesc.Usage = D3D11_USAGE_DEFAULT;
+    visibleDesc.ByteWidth = count * sizeof(ObjectData);
+    visibleDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
+    visibleDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    visibleDesc.StructureByteStride = sizeof(ObjectData);
+
+    // 间接绘制参数：5 个 uint，计算着色器以原始视图原子累加 InstanceCount
+    D3D11_BUFFER_DESC argsDesc = {};
+    argsDesc.Usage = D3D11_USAGE_DEFAULT;
+    argsDesc.ByteWidth = 5 * sizeof(uint32_t);
+    argsDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    argsDesc.MiscFlags = D3D11_RESOURCE_MISC_DRAWINDIRECT_ARGS | D3D11_RESOURCE_MISC_BUFFER_ALLOW_RAW_VIEWS;
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC argsUAVDesc = {};
+    argsUAVDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    argsUAVDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+    argsUAVDesc.Buffer.NumElements = 5;
+    argsUAVDesc.Buffer.Flags = D3D11_BUFFER_UAV_FLAG_RAW;
+
+    if (FAILED(m_Device->CreateBuffer(&instanceDesc, &instanceData, &set.instanceBuffer)) ||
+        FAILED(m_Device->CreateShaderResourceView(set.instanceBuffer, nullptr, &set.instanceSRV)) ||
+        FAILED(m_Device->CreateBuffer(&visibleDesc, nullptr, &set.visibleBuffer)) ||
+        FAILED(m_Device->CreateShaderResourceView(set.visibleBuffer, nullptr, &set.visibleSRV)) ||
+        FAILED(m_Device->CreateUnorderedAccessView(set.visibleBuffer, nullptr, &set.visibleUAV)) ||
+        FAILED(m_Device->CreateBuffer(&argsDesc, nullptr, &set.argsBuffer)) ||
+        FAILED(m_Device->CreateUnorderedAccessView(set.argsBuffer, &argsUAVDesc, &set.argsUAV))) {
+        DebugManager::GetInstance().Log("GpuInstanceRenderer",
+            "Failed to create buffers for " + std::to_string(count) + " instances");
+        ReleaseSet(set);
+        return false;
+    }
+    GpuMemory::Track(set.instanceBuffer);
+    GpuMemory::Track(set.visibleBuffer);
+    GpuMemory::Track(set.argsBuffer);
+
+    set.mesh = component.mesh.get();
+    set.instanceData = component.instances.data();
+    set.sourceCount = component.instances.size();
+    set.version = component.version;
+    set.instanceCount = count;
+    m_Stats.uploads++;
+    return true;
+}
+
+void GpuInstanceRenderer::UploadHiZ(ID3D11DeviceContext* context, const OcclusionCuller& occlusion) {
+    const uint32_t levels = (std::min)(occlusion.GetLevelCount(), m_HiZLevels);
+    for (uint32_t level = 0; level < levels; level++) {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        const float* depth = occlusion.GetLevelDepth(level, width, height);
+        context->UpdateSubresource(m_HiZTexture, D3D11CalcSubresource(level, 0, m_HiZLevels), nullptr,
+                                   depth, width * sizeof(float), 0);
+    }
+}
+
+void GpuInstanceRenderer::Render(ID3D11DeviceContext* context, entt::registry& registry, const CameraFrame& camera,
+                                 const OcclusionCuller* occlusion, const XMFLOAT3& sunPosition) {
+    m_Stats = Stats();
+    m_PendingDraws.clear();
+    m_FrameIndex++;
+    if (!m_Initialized || !context || !camera.valid) return;
+
+    auto view = registry.view<components::GpuInstancedComponent, TransformComponent>();
+    if (view.begin() == view.end()) {
+        if (!m_Sets.empty()) Clear();
+        return;
+    }
+
+    // === 1. Hi-Z（与 CPU 端 RenderQueue 的遮挡剔除同一份数据）===
+    const bool hiz = occlusion && occlusion->HasOccluders() &&
+                     occlusion->GetLevelCount() == m_HiZLevels;
+    if (hiz) {
+        UploadHiZ(context, *occlusion);
+    }
+
+    CullConstants constants = {};
+    constants.view = camera.view;
+    for (int i = 0; i < 6; i++) constants.frustumPlanes[i] = camera.planes[i];
+    constants.sunPosition = sunPosition;
+    constants.hizLevels = hiz ? m_HiZLevels : 0;
+    constants.slopeX = camera.projection._11 != 0.0f ? 1.0f / camera.projection._11 : 1.0f;
+    constants.slopeY = camera.projection._22 != 0.0f ? 1.0f / camera.projection._22 : 1.0f;
+    constants.nearPlane = camera.nearPlane;
+    constants.hizWidth = OcclusionCuller::kWidth;
+    constants.hizHeight = OcclusionCuller::kHeight;
+
+    context->CSSetShader(m_CullShader, nullptr, 0);
+    context->CSSetConstantBuffers(0, 1, &m_CullConstants);
+    ID3D11ShaderResourceView* hizSRV = hiz ? m_HiZSRV : nullptr;
+    context->CSSetShaderResources(kHiZSlot, 1, &hizSRV);
+
+    // === 2. 每个组件一次 Dispatch：视锥 + Hi-Z 剔除，压缩可见实例，累加 InstanceCount ===
+    for (auto entity : view) {
+        const auto& component = view.get<components::GpuInstancedComponent>(entity);
+        const auto& transform = view.get<TransformComponent>(entity);
+        if (!component.isVisible || !component.mesh || !component.mesh->vertexBuffer ||
+            !component.mesh->indexBuffer || component.instances.empty()) {
+            continue;
+        }
+
+        InstanceSet& set = m_Sets[entity];
+        set.lastFrame = m_FrameIndex;
+        if (set.mesh != component.mesh.get() || set.instanceData != component.instances.data() ||
+            set.sourceCount != component.instances.size() || set.version != component.version ||
+            !set.instanceBuffer) {
+            if (!UploadInstances(component, set)) continue;
+        }
+        if (!EnsureIndexStream(set.instanceCount)) continue;
+
+        // 参数复位：InstanceCount = 0，其余来自 mesh（GeometryPool 区间）
+        const uint32_t args[5] = {
+            component.mesh->GetIndexCount(), 0u, component.mesh->GetStartIndex(),
+            component.mesh->GetBaseVertex(), 0u
+        };
+        context->UpdateSubresource(set.argsBuffer, 0, nullptr, args, 0, 0);
+
+        constants.entityWorld = transform.worldMatrix;
+        constants.entityScale = MaxAxisScale(transform.worldMatrix);
+        constants.color = component.material ? component.material->albedo : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        constants.instanceCount = set.instanceCount;
+        constants.receiveShadows = component.receiveShadows ? 1.0f : 0.0f;
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        if (FAILED(context->Map(m_CullConstants, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) continue;
+        memcpy(mapped.pData, &constants, sizeof(CullConstants));
+        context->Unmap(m_CullConstants, 0);
+
+        ID3D11ShaderResourceView* instanceSRV = set.instanceSRV;
+        ID3D11UnorderedAccessView* uavs[2] = { set.visibleUAV, set.argsUAV };
+        context->CSSetShaderResources(kInstanceSlot, 1, &instanceSRV);
+        context->CSSetUnorderedAccessViews(0, 2, uavs, nullptr);
+        context->Dispatch((set.instanceCount + kCullGroupSize - 1) / kCullGroupSize, 1, 1);
+
+        m_PendingDraws.push_back({ &component, &set });
+        m_Stats.sets++;
+        m_Stats.instances += set.instanceCount;
+    }
+
+    // 解除计算阶段绑定：可见缓冲区随后作为 VS 的 SRV，参数缓冲区作为间接参数
+    ID3D11UnorderedAccessView* nullUAVs[2] = { nullptr, nullptr };
+    ID3D11ShaderResourceView* nullSRVs[2] = { nullptr, nullptr };
+    context->CSSetUnorderedAccessViews(0, 2, nullUAVs, nullptr);
+    context->CSSetShaderResources(0, 2, nullSRVs);
+    context->CSSetShader(nullptr, nullptr, 0);
+
+    // 已删除实体的实例组
+    for (auto it = m_Sets.begin(); it != m_Sets.end();) {
+        if (it->second.lastFrame != m_FrameIndex) {
+            ReleaseSet(it->second);
+            it = m_Sets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (m_PendingDraws.empty()) return;
+
+    // === 3. 间接绘制：textured / basic 的对象缓冲区顶点着色器，t5 = 可见实例 ===
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    stateCache.SetBlendState(context, m_BlendState);
+    stateCache.SetDepthStencilState(context, m_DepthState);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->PSSetSamplers(0, 1, &m_Sampler);
+
+    auto& shaderService = ShaderCompileService::GetInstance();
+    for (const PendingDraw& draw : m_PendingDraws) {
+        const auto& component = *draw.component;
+        const resources::Mesh& mesh = *component.mesh;
+        resources::Material* material = component.material.get();
+
+        auto* albedo = material ? static_cast<ID3D11ShaderResourceView*>(material->albedoTextureSRV) : nullptr;
+        auto* normal = material ? static_cast<ID3D11ShaderResourceView*>(material->normalTextureSRV) : nullptr;
+        auto* metallic = material ? static_cast<ID3D11ShaderResourceView*>(material->metallicTextureSRV) : nullptr;
+        auto* roughness = material ? static_cast<ID3D11ShaderResourceView*>(material->roughnessTextureSRV) : nullptr;
+        auto* emissive = material ? static_cast<ID3D11ShaderResourceView*>(material->emissiveTextureSRV) : nullptr;
+
+        // 与 RenderQueue 相同的着色器 / 排列选择
+        bool fallback = false;
+        resources::Shader* shader = nullptr;
+        if (albedo || normal || metallic || roughness) {
+            uint32_t permutation = 0;
+            if (albedo) permutation |= resources::kPermutationAlbedoMap;
+            if (normal) permutation |= resources::kPermutationNormalMap;
+            if (metallic) permutation |= resources::kPermutationMetallicMap;
+            if (roughness) permutation |= resources::kPermutationRoughnessMap;
+            if (emissive && material->isEmissive) permutation |= resources::kPermutationEmissiveMap;
+            if (mesh.HasVertexColors()) permutation |= resources::kPermutationVertexColor;
+            shader = shaderService.Acquire(m_Device, "textured.vs", "textured.ps", permutation, fallback);
+        } else {
+            shader = shaderService.Acquire(m_Device, "basic.vs", "basic.ps", fallback);
+        }
+        if (!shader) continue;
+
+        const bool compact = mesh.GetVertexFormat() == resources::VertexFormat::Compact;
+        ID3D11VertexShader* vs = compact ? shader->GetCompactInstancedVertexShader() : shader->GetInstancedVertexShader();
+        ID3D11InputLayout* layout = compact ? shader->GetCompactInstancedInputLayout() : shader->GetInstancedInputLayout();
+        if (!vs || !layout) continue;
+
+        context->VSSetShader(vs, nullptr, 0);
+        context->PSSetShader(shader->GetPixelShader(), nullptr, 0);
+        context->IASetInputLayout(layout);
+
+        ID3D11ShaderResourceView* textures[5] = { albedo, normal, metallic, roughness, emissive };
+        context->PSSetShaderResources(0, 5, textures);
+        if (material && material->UpdateGPUBuffer(context)) {
+            ID3D11Buffer* materialCB = static_cast<ID3D11Buffer*>(material->constantBuffer);
+            context->PSSetConstantBuffers(2, 1, &materialCB);
+        }
+
+        ID3D11Buffer* vertexBuffers[2] = { static_cast<ID3D11Buffer*>(mesh.vertexBuffer), m_IndexStream };
+        UINT strides[2] = { mesh.GetVertexStride(), sizeof(uint32_t) };
+        UINT offsets[2] = { 0, 0 };
+        context->IASetVertexBuffers(0, 2, vertexBuffers, strides, offsets);
+        context->IASetIndexBuffer(static_cast<ID3D11Buffer*>(mesh.indexBuffer), mesh.GetIndexFormat(), 0);
+
+        ID3D11ShaderResourceView* visibleSRV = draw.set->visibleSRV;
+        context->VSSetShaderResources(kObjectDataSlot, 1, &visibleSRV);
+        context->DrawIndexedInstancedIndirect(draw.set->argsBuffer, 0);
+    }
+
+    // RenderQueue 在 Execute 中重新绑定自己的对象缓冲区和状态缓存
+    ID3D11ShaderResourceView* nullSRV = nullptr;
+    context->VSSetShaderResources(kObjectDataSlot, 1, &nullSRV);
+}
+
+} // namespace outer_wilds
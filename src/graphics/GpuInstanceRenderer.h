@@ -0,0 +1,154 @@
+#pragma once
+#include "CameraService.h"
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+class OcclusionCuller;
+namespace components {
+    struct GpuInstancedComponent;
+}
+
+/**
+ * @brief GPU 驱动的实例渲染（GpuInstancedComponent）
+ *
+ * 每个组件一组 GPU 数据：
+ * - 实例缓冲区（StructuredBuffer<GPUInstance>，实体局部空间矩阵 + 包围球），version 变化时重新上传
+ * - 可见实例缓冲区（RWStructuredBuffer<ObjectData>，与 RenderQueue 的整帧对象缓冲区布局相同）
+ * - 间接绘制参数（DrawIndexedInstancedIndirect，InstanceCount 由计算着色器原子累加）
+ *
+ * 每帧：CPU 重置参数并写入剔除常量（实体矩阵、视锥平面、Hi-Z 参数），shaders/gpu_cull.hlsl 对每个实例
+ * 做视锥 + Hi-Z（OcclusionCuller 的金字塔上传为 mip 链，测试与 CPU 版相同）剔除，并把可见实例压缩写出。
+ * 绘制沿用 textured / basic 的 VSMainInstanced：slot 1 的 OBJECT_INDEX 为恒等下标流，t5 换成可见实例缓冲区。
+ * 可见实例数不回读，CPU 开销与实例数无关。
+ *
+ * 在不透明网格之前调用（先写深度，深度预通道会把它们当作遮挡体）；依赖 RenderSystem 已绑定的
+ * PerFrameBuffer (b0) 和阴影资源。
+ */
+class GpuInstanceRenderer {
+public:
+    static constexpr uint32_t kCullGroupSize = 64;      // 与 gpu_cull.hlsl 的 CULL_GROUP_SIZE 一致
+    static constexpr uint32_t kMaxInstancesPerSet = 65535u * kCullGroupSize;  // Dispatch 单维组数上限
+
+    struct Stats {
+        uint32_t sets = 0;                  // 本帧 Dispatch + 间接绘制的组件数
+        uint32_t instances = 0;             // 参与剔除的实例总数（可见数只在 GPU 上）
+        uint32_t uploads = 0;               // 本帧重新上传实例数据的组件数
+    };
+
+    GpuInstanceRenderer() = default;
+    ~GpuInstanceRenderer();
+
+    GpuInstanceRenderer(const GpuInstanceRenderer&) = delete;
+    GpuInstanceRenderer& operator=(const GpuInstanceRenderer&) = delete;
+
+    /**
+     * @brief 加载剔除计算着色器并创建常量缓冲区 / Hi-Z 纹理 / 状态
+     * @return 是否成功（失败时 GpuInstancedComponent 不会被绘制）
+     */
+    bool Initialize(ID3D11Device* device);
+
+    /**
+     * @brief 剔除并绘制全部 GpuInstancedComponent
+     * @param occlusion 本帧已构建的 Hi-Z（nullptr = 只做视锥剔除）
+     */
+    void Render(ID3D11DeviceContext* context, entt::registry& registry, const CameraFrame& camera,
+                const OcclusionCuller* occlusion, const DirectX::XMFLOAT3& sunPosition);
+
+    /** @brief 释放全部实例组（切换场景时调用） */
+    void Clear();
+
+    bool IsInitialized() const { return m_Initialized; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    /**
+     * @brief 与 gpu_cull.hlsl 中 InstanceData 一致（80 字节）
+     */
+    struct GPUInstance {
+        DirectX::XMFLOAT4X4 local;          // 行主序
+        DirectX::XMFLOAT4 sphere;           // 实体局部空间包围球
+    };
+    static_assert(sizeof(GPUInstance) == 80, "GPUInstance must match InstanceData in gpu_cull.hlsl");
+
+    /**
+     * @brief 与 gpu_cull.hlsl 中 CullConstants 一致（288 字节）
+     */
+    struct CullConstants {
+        DirectX::XMFLOAT4X4 entityWorld;
+        DirectX::XMFLOAT4X4 view;
+        DirectX::XMFLOAT4 frustumPlanes[6];
+        DirectX::XMFLOAT4 color;
+        DirectX::XMFLOAT3 sunPosition;
+        float entityScale;
+        uint32_t instanceCount;
+        uint32_t hizLevels;
+        float slopeX;
+        float slopeY;
+        float nearPlane;
+        float receiveShadows;
+        uint32_t hizWidth;
+        uint32_t hizHeight;
+    };
+    static_assert(sizeof(CullConstants) == 288, "CullConstants must match gpu_cull.hlsl");
+
+    struct InstanceSet {
+        // 上传时的组件内容（任一变化则重新上传）
+        const void* mesh = nullptr;
+        const void* instanceData = nullptr;
+        size_t sourceCount = 0;
+        uint32_t version = 0;
+
+        uint32_t instanceCount = 0;
+        ID3D11Buffer* instanceBuffer = nullptr;
+        ID3D11ShaderResourceView* instanceSRV = nullptr;
+        ID3D11Buffer* visibleBuffer = nullptr;
+        ID3D11ShaderResourceView* visibleSRV = nullptr;
+        ID3D11UnorderedAccessView* visibleUAV = nullptr;
+        ID3D11Buffer* argsBuffer = nullptr;
+        ID3D11UnorderedAccessView* argsUAV = nullptr;
+        uint64_t lastFrame = 0;             // 最近一次出现在 registry 中的帧
+    };
+
+    bool UploadInstances(const components::GpuInstancedComponent& component, InstanceSet& set);
+    static void ReleaseSet(InstanceSet& set);
+    bool EnsureIndexStream(uint32_t count);
+    void UploadHiZ(ID3D11DeviceContext* context, const OcclusionCuller& occlusion);
+
+    ID3D11Device* m_Device = nullptr;
+    bool m_Initialized = false;
+    Stats m_Stats;
+    uint64_t m_FrameIndex = 0;
+
+    ID3D11ComputeShader* m_CullShader = nullptr;
+    ID3D11Buffer* m_CullConstants = nullptr;
+
+    // OcclusionCuller 金字塔的 GPU 副本（R32_FLOAT，mip 链）
+    ID3D11Texture2D* m_HiZTexture = nullptr;
+    ID3D11ShaderResourceView* m_HiZSRV = nullptr;
+    uint32_t m_HiZLevels = 0;
+
+    // 恒等对象下标流（slot 1 OBJECT_INDEX = 0..capacity-1，所有实例组共用）
+    ID3D11Buffer* m_IndexStream = nullptr;
+    uint32_t m_IndexStreamCapacity = 0;
+
+    // RenderStateCache 持有；光栅化状态沿用场景通道
+    ID3D11SamplerState* m_Sampler = nullptr;
+    ID3D11BlendState* m_BlendState = nullptr;
+    ID3D11DepthStencilState* m_DepthState = nullptr;
+
+    std::unordered_map<entt::entity, InstanceSet> m_Sets;
+
+    // 本帧已 Dispatch、等待绘制的组件（复用以避免每帧分配）
+    struct PendingDraw {
+        const components::GpuInstancedComponent* component = nullptr;
+        const InstanceSet* set = nullptr;
+    };
+    std::vector<PendingDraw> m_PendingDraws;
+};
+
+} // namespace outer_wilds
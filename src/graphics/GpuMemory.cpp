@@ -0,0 +1,210 @@
+#include "GpuMemory.h"
+#include "../core/MemoryTracker.h"
+#include <algorithm>
+#include <atomic>
+
+namespace outer_wilds {
+
+namespace {
+
+// {5C3E1A7B-2F4D-4B8E-9A61-0D7F3C2B8E45}
+const GUID kGpuMemorySentinelGuid = { 0x5c3e1a7b, 0x2f4d, 0x4b8e, { 0x9a, 0x61, 0x0d, 0x7f, 0x3c, 0x2b, 0x8e, 0x45 } };
+
+/**
+ * @brief 挂在资源私有数据上的哨兵：资源销毁时 D3D 释放它，最后一次 Release 扣除记账
+ */
+class GpuMemorySentinel final : public IUnknown {
+public:
+    GpuMemorySentinel(GpuMemoryKind kind, int64_t bytes) : m_Kind(kind), m_Bytes(bytes) {
+        MemoryTracker::RecordGpu(m_Kind, m_Bytes);
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override {
+        if (!object) return E_POINTER;
+        if (riid == __uuidof(IUnknown)) {
+            *object = static_cast<IUnknown*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override {
+        return m_RefCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override {
+        const ULONG remaining = m_RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (remaining == 0) {
+            MemoryTracker::RecordGpu(m_Kind, -m_Bytes);
+            delete this;
+        }
+        return remaining;
+    }
+
+private:
+    std::atomic<ULONG> m_RefCount{ 1 };
+    GpuMemoryKind m_Kind;
+    int64_t m_Bytes;
+};
+
+void Attach(ID3D11DeviceChild* resource, GpuMemoryKind kind, uint64_t bytes) {
+    if (!resource) return;
+    UINT size = 0;
+    if (SUCCEEDED(resource->GetPrivateData(kGpuMemorySentinelGuid, &size, nullptr)) && size > 0) return;
+
+    auto* sentinel = new GpuMemorySentinel(kind, static_cast<int64_t>(bytes));
+    resource->SetPrivateDataInterface(kGpuMemorySentinelGuid, sentinel);   // 资源持有一个引用
+    sentinel->Release();
+}
+
+/** @brief 非压缩格式每像素位数；BC 格式返回 0（按块计算） */
+uint32_t BitsPerPixel(DXGI_FORMAT format) {
+    switch (format) {
+        case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        case DXGI_FORMAT_R32G32B32A32_UINT:
+        case DXGI_FORMAT_R32G32B32A32_SINT:
+            return 128;
+        case DXGI_FORMAT_R32G32B32_TYPELESS:
+        case DXGI_FORMAT_R32G32B32_FLOAT:
+        case DXGI_FORMAT_R32G32B32_UINT:
+        case DXGI_FORMAT_R32G32B32_SINT:
+            return 96;
+        case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+        case DXGI_FORMAT_R16G16B16A16_UINT:
+        case DXGI_FORMAT_R16G16B16A16_SNORM:
+        case DXGI_FORMAT_R16G16B16A16_SINT:
+        case DXGI_FORMAT_R32G32_TYPELESS:
+        case DXGI_FORMAT_R32G32_FLOAT:
+        case DXGI_FORMAT_R32G32_UINT:
+        case DXGI_FORMAT_R32G32_SINT:
+        case DXGI_FORMAT_R32G8X24_TYPELESS:
+        case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+        case DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+        case DXGI_FORMAT_X32_TYPELESS_G8X24_UINT:
+            return 64;
+        case DXGI_FORMAT_R8G8_TYPELESS:
+        case DXGI_FORMAT_R8G8_UNORM:
+        case DXGI_FORMAT_R8G8_UINT:
+        case DXGI_FORMAT_R8G8_SNORM:
+        case DXGI_FORMAT_R8G8_SINT:
+        case DXGI_FORMAT_R16_TYPELESS:
+        case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_D16_UNORM:
+        case DXGI_FORMAT_R16_UNORM:
+        case DXGI_FORMAT_R16_UINT:
+        case DXGI_FORMAT_R16_SNORM:
+        case DXGI_FORMAT_R16_SINT:
+        case DXGI_FORMAT_B5G6R5_UNORM:
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            return 16;
+        case DXGI_FORMAT_R8_TYPELESS:
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_R8_UINT:
+        case DXGI_FORMAT_R8_SNORM:
+        case DXGI_FORMAT_R8_SINT:
+        case DXGI_FORMAT_A8_UNORM:
+            return 8;
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_TYPELESS:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return 0;
+        default:
+            return 32;      // RGBA8 / BGRA8 / R10G10B10A2 / R11G11B10 / R32 / D24S8 / D32 等
+    }
+}
+
+/** @brief BC 格式每个 4x4 块的字节数；非压缩格式返回 0 */
+uint32_t BytesPerBlock(DXGI_FORMAT format) {
+    switch (format) {
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            return 8;
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_TYPELESS:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+} // namespace
+
+uint64_t GpuMemory::EstimateTextureBytes(const D3D11_TEXTURE2D_DESC& desc) {
+    const uint32_t blockBytes = BytesPerBlock(desc.Format);
+    const uint32_t bitsPerPixel = BitsPerPixel(desc.Format);
+
+    // MipLevels == 0 表示完整 mip 链
+    uint32_t mipLevels = desc.MipLevels;
+    if (mipLevels == 0) {
+        mipLevels = 1;
+        for (uint32_t size = std::max(desc.Width, desc.Height); size > 1; size >>= 1) mipLevels++;
+    }
+
+    uint64_t bytesPerSlice = 0;
+    for (uint32_t mip = 0; mip < mipLevels; mip++) {
+        const uint64_t width = std::max(1u, desc.Width >> mip);
+        const uint64_t height = std::max(1u, desc.Height >> mip);
+        if (blockBytes > 0) {
+            bytesPerSlice += ((width + 3) / 4) * ((height + 3) / 4) * blockBytes;
+        } else {
+            bytesPerSlice += width * height * bitsPerPixel / 8;
+        }
+    }
+    return bytesPerSlice * std::max(1u, desc.ArraySize) * std::max(1u, desc.SampleDesc.Count);
+}
+
+void GpuMemory::Track(ID3D11Buffer* buffer) {
+    if (!buffer) return;
+    D3D11_BUFFER_DESC desc = {};
+    buffer->GetDesc(&desc);
+    Attach(buffer, GpuMemoryKind::Buffer, desc.ByteWidth);
+}
+
+void GpuMemory::Track(ID3D11Texture2D* texture) {
+    if (!texture) return;
+    D3D11_TEXTURE2D_DESC desc = {};
+    texture->GetDesc(&desc);
+    Attach(texture, GpuMemoryKind::Texture, EstimateTextureBytes(desc));
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,26 @@
+#pragma once
+#include <d3d11.h>
+#include <cstdint>
+
+namespace outer_wilds {
+
+/**
+ * @brief GPU 资源的显存记账（MemoryTracker 的 GPU 部分）
+ *
+ * 每个 CreateBuffer / CreateTexture2D 之后调用 Track：按资源描述计算字节数
+ * （缓冲区为 ByteWidth；纹理按格式、mip 链、数组层数和 MSAA 采样数，BC 格式按 4x4 块），
+ * 并通过 SetPrivateDataInterface 挂一个哨兵对象。资源最终销毁时 D3D 释放哨兵，哨兵扣除同样的字节数，
+ * 因此不需要在各个 Release 处配对调用。
+ *
+ * 字节数是按描述估算的下限（不含驱动的对齐和填充）；同一资源重复 Track 只计一次。
+ */
+class GpuMemory {
+public:
+    static void Track(ID3D11Buffer* buffer);
+    static void Track(ID3D11Texture2D* texture);
+
+    /** @brief 纹理按描述估算的字节数（全部 mip 和数组层） */
+    static uint64_t EstimateTextureBytes(const D3D11_TEXTURE2D_DESC& desc);
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,177 @@
+#include "GpuProfiler.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+
+namespace outer_wilds {
+
+GpuProfiler::~GpuProfiler() {
+    Shutdown();
+}
+
+bool GpuProfiler::Initialize(ID3D11Device* device) {
+    if (!device) return false;
+    if (m_Initialized) return true;
+
+    for (auto& frame : m_Frames) {
+        D3D11_QUERY_DESC desc = {};
+        desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        if (FAILED(device->CreateQuery(&desc, &frame.disjoint))) {
+            DebugManager::GetInstance().Log("GpuProfiler", "Failed to create disjoint query");
+            Shutdown();
+            return false;
+        }
+        desc.Query = D3D11_QUERY_TIMESTAMP;
+        for (uint32_t i = 0; i < kMaxScopes; i++) {
+            if (FAILED(device->CreateQuery(&desc, &frame.begin[i])) ||
+                FAILED(device->CreateQuery(&desc, &frame.end[i]))) {
+                DebugManager::GetInstance().Log("GpuProfiler", "Failed to create timestamp query");
+                Shutdown();
+                return false;
+            }
+        }
+    }
+
+    m_Timings.reserve(kMaxScopes);
+    m_Initialized = true;
+    return true;
+}
+
+void GpuProfiler::Shutdown() {
+    StopCsvLog();
+    for (auto& frame : m_Frames) {
+        if (frame.disjoint) { frame.disjoint->Release(); frame.disjoint = nullptr; }
+        for (uint32_t i = 0; i < kMaxScopes; i++) {
+            if (frame.begin[i]) { frame.begin[i]->Release(); frame.begin[i] = nullptr; }
+            if (frame.end[i]) { frame.end[i]->Release(); frame.end[i] = nullptr; }
+        }
+        frame.pending = false;
+    }
+    m_Initialized = false;
+    m_FrameActive = false;
+}
+
+void GpuProfiler::BeginFrame(ID3D11DeviceContext* context) {
+    if (!m_Initialized || !m_Enabled || !context || m_FrameActive) {
+        return;
+    }
+
+    FrameQueries& frame = m_Frames[m_FrameIndex % kFrameLatency];
+    if (frame.pending) {
+        Resolve(context, frame);
+    }
+
+    frame.scopeCount = 0;
+    frame.frameIndex = m_FrameIndex;
+    context->Begin(frame.disjoint);
+    m_FrameActive = true;
+}
+
+void GpuProfiler::EndFrame(ID3D11DeviceContext* context) {
+    if (!m_FrameActive || !context) {
+        return;
+    }
+
+    FrameQueries& frame = m_Frames[m_FrameIndex % kFrameLatency];
+    context->End(frame.disjoint);
+    frame.pending = true;
+    m_FrameActive = false;
+    m_FrameIndex++;
+}
+
+uint32_t GpuProfiler::BeginScope(ID3D11DeviceContext* context, const char* name) {
+    if (!m_FrameActive || !context) {
+        return kInvalidScope;
+    }
+
+    FrameQueries& frame = m_Frames[m_FrameIndex % kFrameLatency];
+    if (frame.scopeCount >= kMaxScopes) {
+        return kInvalidScope;
+    }
+
+    const uint32_t scope = frame.scopeCount++;
+    frame.names[scope] = name;
+    context->End(frame.begin[scope]);
+    return scope;
+}
+
+void GpuProfiler::EndScope(ID3D11DeviceContext* context, uint32_t scope) {
+    if (!m_FrameActive || !context || scope == kInvalidScope) {
+        return;
+    }
+
+    FrameQueries& frame = m_Frames[m_FrameIndex % kFrameLatency];
+    if (scope < frame.scopeCount) {
+        context->End(frame.end[scope]);
+    }
+}
+
+/**
+ * @brief 读回一帧的结果（DONOTFLUSH：未就绪或时钟不连续时丢弃该帧）
+ */
+void GpuProfiler::Resolve(ID3D11DeviceContext* context, FrameQueries& frame) {
+    frame.pending = false;
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+    if (context->GetData(frame.disjoint, &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+        return;
+    }
+    if (disjoint.Disjoint || disjoint.Frequency == 0) {
+        return;
+    }
+
+    const double toMs = 1000.0 / static_cast<double>(disjoint.Frequency);
+    UINT64 frameBegin = UINT64_MAX;
+    UINT64 frameEnd = 0;
+
+    m_Timings.clear();
+    for (uint32_t i = 0; i < frame.scopeCount; i++) {
+        UINT64 begin = 0;
+        UINT64 end = 0;
+        if (context->GetData(frame.begin[i], &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(frame.end[i], &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            continue;
+        }
+        frameBegin = (std::min)(frameBegin, begin);
+        frameEnd = (std::max)(frameEnd, end);
+
+        ScopeTiming timing;
+        timing.name = frame.names[i];
+        timing.milliseconds = end > begin ? static_cast<float>((end - begin) * toMs) : 0.0f;
+
+        float& average = m_Averages[timing.name];
+        average = average > 0.0f ? average + (timing.milliseconds - average) * kAverageSmoothing : timing.milliseconds;
+        timing.averageMs = average;
+        m_Timings.push_back(timing);
+    }
+
+    m_FrameMs = frameEnd > frameBegin ? static_cast<float>((frameEnd - frameBegin) * toMs) : 0.0f;
+    m_ResolvedFrame = frame.frameIndex;
+
+    if (m_Csv.is_open()) {
+        for (const auto& timing : m_Timings) {
+            m_Csv << frame.frameIndex << ',' << timing.name << ',' << timing.milliseconds << '\n';
+        }
+        m_Csv << frame.frameIndex << ",Frame," << m_FrameMs << '\n';
+    }
+}
+
+bool GpuProfiler::StartCsvLog(const std::string& path) {
+    StopCsvLog();
+    m_Csv.open(path, std::ios::out | std::ios::trunc);
+    if (!m_Csv.is_open()) {
+        DebugManager::GetInstance().Log("GpuProfiler", "Failed to open CSV log: " + path);
+        return false;
+    }
+    m_Csv << "frame,scope,gpu_ms\n";
+    DebugManager::GetInstance().Log("GpuProfiler", "Logging GPU timings to " + path);
+    return true;
+}
+
+void GpuProfiler::StopCsvLog() {
+    if (m_Csv.is_open()) {
+        m_Csv.flush();
+        m_Csv.close();
+    }
+}
+
+} // namespace outer_wilds
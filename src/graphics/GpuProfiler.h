@@ -0,0 +1,130 @@
+#pragma once
+#include <d3d11.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 基于时间戳查询的 GPU 分段计时
+ *
+ * 每帧一个 TIMESTAMP_DISJOINT 查询包住所有命名分段，每个分段两个 TIMESTAMP 查询。
+ * 查询按 kFrameLatency 帧环形复用：BeginFrame 读取即将复用的那一帧（kFrameLatency 帧之前）的结果，
+ * GetData 使用 DONOTFLUSH，结果未就绪时丢弃该帧而不是等待，因此读回永远不会让 CPU 停顿。
+ *
+ * 分段名必须是字符串字面量（只保存指针）；分段可以嵌套。只能在立即上下文上使用。
+ *
+ * @code
+ * GPU_PROFILE_SCOPE(profiler, context, "Skybox");
+ * @endcode
+ */
+class GpuProfiler {
+public:
+    static constexpr uint32_t kFrameLatency = 4;
+    static constexpr uint32_t kMaxScopes = 32;
+    static constexpr uint32_t kInvalidScope = 0xFFFFFFFFu;
+    static constexpr float kAverageSmoothing = 0.05f;
+
+    struct ScopeTiming {
+        const char* name = nullptr;
+        float milliseconds = 0.0f;      // 最近一次读回的帧
+        float averageMs = 0.0f;         // 指数平滑
+    };
+
+    GpuProfiler() = default;
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    bool Initialize(ID3D11Device* device);
+    void Shutdown();
+
+    /**
+     * @brief 开始一帧（读回 kFrameLatency 帧之前的结果）；未初始化或禁用时为空操作
+     */
+    void BeginFrame(ID3D11DeviceContext* context);
+    void EndFrame(ID3D11DeviceContext* context);
+
+    /**
+     * @return 分段句柄；帧未开始或分段已满时返回 kInvalidScope（EndScope 忽略）
+     */
+    uint32_t BeginScope(ID3D11DeviceContext* context, const char* name);
+    void EndScope(ID3D11DeviceContext* context, uint32_t scope);
+
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsEnabled() const { return m_Enabled; }
+    bool IsInitialized() const { return m_Initialized; }
+
+    /**
+     * @brief 最近一次读回的帧的分段耗时（按开始顺序）
+     */
+    const std::vector<ScopeTiming>& GetTimings() const { return m_Timings; }
+    float GetFrameTime() const { return m_FrameMs; }   // 该帧所有顶层分段的跨度
+    uint64_t GetResolvedFrame() const { return m_ResolvedFrame; }
+
+    /**
+     * @brief 把每个读回的帧追加到 CSV（frame,scope,gpu_ms）
+     */
+    bool StartCsvLog(const std::string& path);
+    void StopCsvLog();
+    bool IsCsvLogging() const { return m_Csv.is_open(); }
+
+private:
+    struct FrameQueries {
+        ID3D11Query* disjoint = nullptr;
+        ID3D11Query* begin[kMaxScopes] = {};
+        ID3D11Query* end[kMaxScopes] = {};
+        const char* names[kMaxScopes] = {};
+        uint32_t scopeCount = 0;
+        uint64_t frameIndex = 0;
+        bool pending = false;
+    };
+
+    void Resolve(ID3D11DeviceContext* context, FrameQueries& frame);
+
+    bool m_Initialized = false;
+    bool m_Enabled = true;
+    bool m_FrameActive = false;
+    uint64_t m_FrameIndex = 0;
+    FrameQueries m_Frames[kFrameLatency];
+
+    std::vector<ScopeTiming> m_Timings;
+    std::unordered_map<std::string, float> m_Averages;
+    float m_FrameMs = 0.0f;
+    uint64_t m_ResolvedFrame = 0;
+
+    std::ofstream m_Csv;
+};
+
+/**
+ * @brief RAII 分段（profiler 为空时为空操作）
+ */
+class GpuProfileScope {
+public:
+    GpuProfileScope(GpuProfiler* profiler, ID3D11DeviceContext* context, const char* name)
+        : m_Profiler(profiler), m_Context(context) {
+        if (m_Profiler) m_Scope = m_Profiler->BeginScope(context, name);
+    }
+    ~GpuProfileScope() {
+        if (m_Profiler) m_Profiler->EndScope(m_Context, m_Scope);
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    GpuProfiler* m_Profiler;
+    ID3D11DeviceContext* m_Context;
+    uint32_t m_Scope = GpuProfiler::kInvalidScope;
+};
+
+#define GPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define GPU_PROFILE_CONCAT(a, b) GPU_PROFILE_CONCAT_INNER(a, b)
+#define GPU_PROFILE_SCOPE(profiler, context, name) \
+    ::outer_wilds::GpuProfileScope GPU_PROFILE_CONCAT(gpuProfileScope_, __LINE__)(profiler, context, name)
+
+} // namespace outer_wilds
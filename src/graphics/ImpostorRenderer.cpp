@@ -0,0 +1,210 @@
+#include "ImpostorRenderer.h"
+#include "GpuMemory.h"
+#include "RenderStateCache.h"
+#include "resources/Shader.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <cstring>
+
+namespace outer_wilds {
+
+ImpostorRenderer::~ImpostorRenderer() {
+    for (auto& [texture, index] : m_PaletteIndices) {
+        if (texture) texture->Release();
+    }
+    if (m_InstanceSRV) m_InstanceSRV->Release();
+    if (m_InstanceBuffer) m_InstanceBuffer->Release();
+    if (m_PaletteSRV) m_PaletteSRV->Release();
+    if (m_PaletteRTV) m_PaletteRTV->Release();
+    if (m_PaletteTexture) m_PaletteTexture->Release();
+}
+
+bool ImpostorRenderer::Initialize(ID3D11Device* device) {
+    if (!device) return false;
+    m_Device = device;
+
+    // 两个着色器都只用 SV_VertexID/SV_InstanceID，positionOnly 布局不会被使用
+    m_Shader = std::make_unique<resources::Shader>();
+    if (!m_Shader->LoadFromFile(device, "impostor.vs", "impostor.ps", true)) {
+        DebugManager::GetInstance().Log("ImpostorRenderer", "Failed to load impostor shader");
+        return false;
+    }
+    m_PaletteShader = std::make_unique<resources::Shader>();
+    if (!m_PaletteShader->LoadFromFile(device, "impostor_palette.vs", "impostor_palette.ps", true)) {
+        DebugManager::GetInstance().Log("ImpostorRenderer", "Failed to load impostor palette shader");
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC paletteDesc = {};
+    paletteDesc.Width = kPaletteSize;
+    paletteDesc.Height = 1;
+    paletteDesc.MipLevels = 1;
+    paletteDesc.ArraySize = 1;
+    paletteDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    paletteDesc.SampleDesc.Count = 1;
+    paletteDesc.Usage = D3D11_USAGE_DEFAULT;
+    paletteDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+    if (FAILED(device->CreateTexture2D(&paletteDesc, nullptr, &m_PaletteTexture)) ||
+        FAILED(device->CreateRenderTargetView(m_PaletteTexture, nullptr, &m_PaletteRTV)) ||
+        FAILED(device->CreateShaderResourceView(m_PaletteTexture, nullptr, &m_PaletteSRV))) {
+        DebugManager::GetInstance().Log("ImpostorRenderer", "Failed to create albedo palette");
+        return false;
+    }
+    GpuMemory::Track(m_PaletteTexture);
+
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    m_PaletteSampler = stateCache.GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP);
+
+    // 与场景一致：不混合，LESS + 写深度（像素着色器输出 SV_Depth）
+    m_BlendState = stateCache.GetBlendState(RenderStateCache::BlendMode::Opaque);
+    m_DepthState = stateCache.GetDepthStencilState(true, true, D3D11_COMPARISON_LESS);
+    if (!m_PaletteSampler || !m_BlendState || !m_DepthState) {
+        return false;
+    }
+
+    m_Initialized = true;
+    DebugManager::GetInstance().Log("ImpostorRenderer", "Initialized");
+    return true;
+}
+
+float ImpostorRenderer::ResolvePaletteIndex(ID3D11DeviceContext* context, ID3D11ShaderResourceView* texture) {
+    if (!texture) return -1.0f;
+
+    auto it = m_PaletteIndices.find(texture);
+    if (it != m_PaletteIndices.end()) {
+        return static_cast<float>(it->second);
+    }
+    if (m_PaletteIndices.size() >= kPaletteSize) {
+        return -1.0f;
+    }
+
+    const uint32_t index = static_cast<uint32_t>(m_PaletteIndices.size());
+    texture->AddRef();  // 持有引用，避免纹理释放后地址被复用导致颜色错配
+    m_PaletteIndices[texture] = index;
+
+    // 保存输出合并/视口状态
+    ID3D11RenderTargetView* prevRTV = nullptr;
+    ID3D11DepthStencilView* prevDSV = nullptr;
+    context->OMGetRenderTargets(1, &prevRTV, &prevDSV);
+    UINT viewportCount = 1;
+    D3D11_VIEWPORT prevViewport = {};
+    context->RSGetViewports(&viewportCount, &prevViewport);
+
+    D3D11_VIEWPORT viewport = {};
+    viewport.TopLeftX = static_cast<float>(index);
+    viewport.Width = 1.0f;
+    viewport.Height = 1.0f;
+    viewport.MaxDepth = 1.0f;
+
+    ID3D11ShaderResourceView* unbound = nullptr;
+    context->PSSetShaderResources(1, 1, &unbound);  // 调色板不能同时作为 SRV 和 RTV
+    context->OMSetRenderTargets(1, &m_PaletteRTV, nullptr);
+    context->RSSetViewports(1, &viewport);
+    context->IASetInputLayout(nullptr);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->VSSetShader(m_PaletteShader->GetVertexShader(), nullptr, 0);
+    context->PSSetShader(m_PaletteShader->GetPixelShader(), nullptr, 0);
+    context->PSSetShaderResources(0, 1, &texture);
+    context->PSSetSamplers(0, 1, &m_PaletteSampler);
+    context->Draw(3, 0);
+
+    context->PSSetShaderResources(0, 1, &unbound);
+    context->OMSetRenderTargets(1, &prevRTV, prevDSV);
+    if (viewportCount > 0) context->RSSetViewports(1, &prevViewport);
+    if (prevRTV) prevRTV->Release();
+    if (prevDSV) prevDSV->Release();
+
+    return static_cast<float>(index);
+}
+
+bool ImpostorRenderer::EnsureInstanceCapacity(uint32_t count) {
+    if (count <= m_InstanceCapacity && m_InstanceBuffer) {
+        return true;
+    }
+
+    if (m_InstanceSRV) { m_InstanceSRV->Release(); m_InstanceSRV = nullptr; }
+    if (m_InstanceBuffer) { m_InstanceBuffer->Release(); m_InstanceBuffer = nullptr; }
+    m_InstanceCapacity = 0;
+
+    uint32_t capacity = 16;
+    while (capacity < count) capacity *= 2;
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = capacity * sizeof(GPUImpostor);
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    desc.StructureByteStride = sizeof(GPUImpostor);
+    if (FAILED(m_Device->CreateBuffer(&desc, nullptr, &m_InstanceBuffer))) {
+        return false;
+    }
+    GpuMemory::Track(m_InstanceBuffer);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+    srvDesc.Buffer.FirstElement = 0;
+    srvDesc.Buffer.NumElements = capacity;
+    if (FAILED(m_Device->CreateShaderResourceView(m_InstanceBuffer, &srvDesc, &m_InstanceSRV))) {
+        m_InstanceBuffer->Release();
+        m_InstanceBuffer = nullptr;
+        return false;
+    }
+
+    m_InstanceCapacity = capacity;
+    return true;
+}
+
+void ImpostorRenderer::Render(ID3D11DeviceContext* context, const std::vector<ImpostorInstance>& impostors) {
+    if (!m_Initialized || !context || impostors.empty()) {
+        return;
+    }
+
+    const uint32_t count = static_cast<uint32_t>(impostors.size());
+    if (!EnsureInstanceCapacity(count)) {
+        return;
+    }
+
+    m_Instances.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        const ImpostorInstance& source = impostors[i];
+        GPUImpostor& gpu = m_Instances[i];
+        gpu.center = source.center;
+        gpu.radius = source.radius;
+        gpu.color = source.color;
+        gpu.lightDir = source.lightDir;
+        gpu.paletteIndex = ResolvePaletteIndex(context, source.albedoTexture);
+        gpu.emissive = source.emissive ? 1.0f : 0.0f;
+        gpu.padding = { 0.0f, 0.0f, 0.0f };
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(context->Map(m_InstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        return;
+    }
+    memcpy(mapped.pData, m_Instances.data(), count * sizeof(GPUImpostor));
+    context->Unmap(m_InstanceBuffer, 0);
+
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    stateCache.SetBlendState(context, m_BlendState);
+    stateCache.SetDepthStencilState(context, m_DepthState);
+
+    // 无顶点缓冲区：四边形由 SV_VertexID 生成
+    context->IASetInputLayout(nullptr);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    context->VSSetShader(m_Shader->GetVertexShader(), nullptr, 0);
+    context->PSSetShader(m_Shader->GetPixelShader(), nullptr, 0);
+    context->VSSetShaderResources(0, 1, &m_InstanceSRV);
+    context->PSSetShaderResources(1, 1, &m_PaletteSRV);
+
+    context->DrawInstanced(4, count, 0, 0);
+
+    // 还原：RenderQueue 只在纹理变化时绑定 SRV，残留的调色板会被无纹理的批次采样到
+    ID3D11ShaderResourceView* unbound = nullptr;
+    context->VSSetShaderResources(0, 1, &unbound);
+    context->PSSetShaderResources(1, 1, &unbound);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+} // namespace outer_wilds
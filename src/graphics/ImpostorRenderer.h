@@ -0,0 +1,94 @@
+#pragma once
+#include "RenderQueue.h"
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+    class Shader;
+}
+
+/**
+ * @brief 远处天体替身渲染器
+ *
+ * RenderQueue 把投影尺寸低于阈值的天体输出为 ImpostorInstance，这里用一次 DrawInstanced
+ * 绘制全部替身：顶点着色器按 SV_VertexID 生成面向相机的四边形，像素着色器做射线-球求交，
+ * 输出 Lambert 光照和求交点的深度（SV_Depth），与网格几何正确遮挡。
+ *
+ * 平均反照率：每个反照率纹理第一次出现时，把其最低 mip（整张纹理的平均颜色）渲染到
+ * 256x1 调色板的一个像素上，之后替身只用一个调色板下标，不需要逐实例绑定纹理。
+ *
+ * 依赖 RenderSystem 已绑定的 PerFrameBuffer (b0)。
+ */
+class ImpostorRenderer {
+public:
+    static constexpr uint32_t kPaletteSize = 256;
+
+    ImpostorRenderer() = default;
+    ~ImpostorRenderer();
+
+    ImpostorRenderer(const ImpostorRenderer&) = delete;
+    ImpostorRenderer& operator=(const ImpostorRenderer&) = delete;
+
+    /**
+     * @brief 加载着色器并创建调色板/状态
+     * @return 是否成功（失败时调用方应关闭 RenderQueue 的替身输出）
+     */
+    bool Initialize(ID3D11Device* device);
+
+    /**
+     * @brief 绘制本帧的所有替身（在不透明网格之前调用）
+     */
+    void Render(ID3D11DeviceContext* context, const std::vector<ImpostorInstance>& impostors);
+
+    bool IsInitialized() const { return m_Initialized; }
+
+private:
+    /**
+     * @brief 与 impostor.hlsl 中 ImpostorData 一致（64 字节）
+     */
+    struct GPUImpostor {
+        DirectX::XMFLOAT3 center;
+        float radius;
+        DirectX::XMFLOAT4 color;
+        DirectX::XMFLOAT3 lightDir;
+        float paletteIndex;
+        float emissive;
+        DirectX::XMFLOAT3 padding;
+    };
+    static_assert(sizeof(GPUImpostor) == 64, "GPUImpostor must match ImpostorData in impostor.hlsl");
+
+    /**
+     * @brief 返回纹理在调色板中的列（必要时先渲染平均颜色），-1 表示无纹理或调色板已满
+     */
+    float ResolvePaletteIndex(ID3D11DeviceContext* context, ID3D11ShaderResourceView* texture);
+    bool EnsureInstanceCapacity(uint32_t count);
+
+    ID3D11Device* m_Device = nullptr;
+    bool m_Initialized = false;
+
+    std::unique_ptr<resources::Shader> m_Shader;
+    std::unique_ptr<resources::Shader> m_PaletteShader;
+
+    // 实例数据（StructuredBuffer，VS t0）
+    ID3D11Buffer* m_InstanceBuffer = nullptr;
+    ID3D11ShaderResourceView* m_InstanceSRV = nullptr;
+    uint32_t m_InstanceCapacity = 0;
+    std::vector<GPUImpostor> m_Instances;
+
+    // 平均反照率调色板（PS t1）
+    ID3D11Texture2D* m_PaletteTexture = nullptr;
+    ID3D11RenderTargetView* m_PaletteRTV = nullptr;
+    ID3D11ShaderResourceView* m_PaletteSRV = nullptr;
+    ID3D11SamplerState* m_PaletteSampler = nullptr;        // RenderStateCache 持有
+    std::unordered_map<ID3D11ShaderResourceView*, uint32_t> m_PaletteIndices;
+
+    // RenderStateCache 持有；光栅化状态沿用场景通道
+    ID3D11BlendState* m_BlendState = nullptr;
+    ID3D11DepthStencilState* m_DepthState = nullptr;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,188 @@
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace outer_wilds {
+
+void OcclusionCuller::Begin(const XMMATRIX& view, const XMMATRIX& projection, float nearPlane) {
+    XMStoreFloat4x4(&m_View, view);
+
+    // XMMatrixPerspectiveFovLH: _11 = 1 / (aspect * tan), _22 = 1 / tan
+    XMFLOAT4X4 proj;
+    XMStoreFloat4x4(&proj, projection);
+    m_SlopeX = proj._11 != 0.0f ? 1.0f / proj._11 : 1.0f;
+    m_SlopeY = proj._22 != 0.0f ? 1.0f / proj._22 : 1.0f;
+    m_NearPlane = nearPlane;
+    m_OccluderCount = 0;
+
+    if (m_Levels.empty()) {
+        uint32_t width = kWidth;
+        uint32_t height = kHeight;
+        while (true) {
+            Level level;
+            level.width = width;
+            level.height = height;
+            level.depth.resize(static_cast<size_t>(width) * height);
+            m_Levels.push_back(std::move(level));
+            if (width == 1 && height == 1) break;
+            width = (std::max)(1u, width / 2);
+            height = (std::max)(1u, height / 2);
+        }
+        m_CornerDepth.resize(static_cast<size_t>(kWidth + 1) * (kHeight + 1));
+    }
+    std::fill(m_Levels[0].depth.begin(), m_Levels[0].depth.end(), FLT_MAX);
+}
+
+bool OcclusionCuller::ProjectSphere(const XMFLOAT3& center, float radius,
+                                    float& minX, float& minY, float& maxX, float& maxY) const {
+    const float nearZ = center.z - radius;
+    const float farZ = center.z + radius;
+    if (nearZ <= m_NearPlane) {
+        return false;
+    }
+
+    minX = (std::min)((center.x - radius) / nearZ, (center.x - radius) / farZ) / m_SlopeX;
+    maxX = (std::max)((center.x + radius) / nearZ, (center.x + radius) / farZ) / m_SlopeX;
+    minY = (std::min)((center.y - radius) / nearZ, (center.y - radius) / farZ) / m_SlopeY;
+    maxY = (std::max)((center.y + radius) / nearZ, (center.y + radius) / farZ) / m_SlopeY;
+    return true;
+}
+
+void OcclusionCuller::AddSphereOccluder(const XMFLOAT3& center, float radius) {
+    if (m_Levels.empty() || radius <= 0.0f) {
+        return;
+    }
+
+    XMFLOAT3 viewCenter;
+    XMStoreFloat3(&viewCenter, XMVector3TransformCoord(XMLoadFloat3(&center), XMLoadFloat4x4(&m_View)));
+    radius *= kOccluderRadiusScale;
+
+    // 相机在球内：整个屏幕都在"内部"，无法给出保守深度
+    const float k = viewCenter.x * viewCenter.x + viewCenter.y * viewCenter.y + viewCenter.z * viewCenter.z - radius * radius;
+    if (k <= 0.0f || viewCenter.z + radius <= m_NearPlane) {
+        return;
+    }
+
+    // 只处理球的屏幕矩形（跨过近平面时处理整个屏幕）
+    int x0 = 0, y0 = 0, x1 = static_cast<int>(kWidth) - 1, y1 = static_cast<int>(kHeight) - 1;
+    float minX, minY, maxX, maxY;
+    if (ProjectSphere(viewCenter, radius, minX, minY, maxX, maxY)) {
+        if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f) {
+            return;
+        }
+        x0 = (std::max)(x0, static_cast<int>(std::floor((minX * 0.5f + 0.5f) * kWidth)));
+        x1 = (std::min)(x1, static_cast<int>(std::floor((maxX * 0.5f + 0.5f) * kWidth)));
+        y0 = (std::max)(y0, static_cast<int>(std::floor((minY * 0.5f + 0.5f) * kHeight)));
+        y1 = (std::min)(y1, static_cast<int>(std::floor((maxY * 0.5f + 0.5f) * kHeight)));
+        if (x0 > x1 || y0 > y1) {
+            return;
+        }
+    }
+
+    // === 角点：观察空间射线 d = (ndcX * slopeX, ndcY * slopeY, 1) 与球的前交点，t 即观察空间 z ===
+    const uint32_t stride = kWidth + 1;
+    for (int y = y0; y <= y1 + 1; y++) {
+        const float dy = (static_cast<float>(y) / kHeight * 2.0f - 1.0f) * m_SlopeY;
+        for (int x = x0; x <= x1 + 1; x++) {
+            const float dx = (static_cast<float>(x) / kWidth * 2.0f - 1.0f) * m_SlopeX;
+            const float a = dx * dx + dy * dy + 1.0f;
+            const float b = dx * viewCenter.x + dy * viewCenter.y + viewCenter.z;
+            const float discriminant = b * b - a * k;
+
+            float depth = FLT_MAX;
+            if (discriminant >= 0.0f && b > 0.0f) {
+                const float t = (b - std::sqrt(discriminant)) / a;
+                if (t >= m_NearPlane) depth = t;  // 前表面被近平面裁掉的角点视为未覆盖
+            }
+            m_CornerDepth[static_cast<size_t>(y) * stride + x] = depth;
+        }
+    }
+
+    // === 像素：四角都命中才算覆盖，深度取四角最大值（未命中的 FLT_MAX 自然使其不写入）===
+    Level& base = m_Levels[0];
+    for (int y = y0; y <= y1; y++) {
+        const float* row0 = &m_CornerDepth[static_cast<size_t>(y) * stride];
+        const float* row1 = row0 + stride;
+        float* out = &base.depth[static_cast<size_t>(y) * kWidth];
+        for (int x = x0; x <= x1; x++) {
+            const float depth = (std::max)((std::max)(row0[x], row0[x + 1]), (std::max)(row1[x], row1[x + 1]));
+            out[x] = (std::min)(out[x], depth);
+        }
+    }
+
+    m_OccluderCount++;
+}
+
+void OcclusionCuller::BuildPyramid() {
+    if (m_OccluderCount == 0) {
+        return;
+    }
+
+    for (size_t l = 1; l < m_Levels.size(); l++) {
+        const Level& src = m_Levels[l - 1];
+        Level& dst = m_Levels[l];
+        for (uint32_t y = 0; y < dst.height; y++) {
+            const uint32_t sy0 = (std::min)(y * 2, src.height - 1);
+            const uint32_t sy1 = (std::min)(y * 2 + 1, src.height - 1);
+            for (uint32_t x = 0; x < dst.width; x++) {
+                const uint32_t sx0 = (std::min)(x * 2, src.width - 1);
+                const uint32_t sx1 = (std::min)(x * 2 + 1, src.width - 1);
+                dst.depth[y * dst.width + x] = (std::max)(
+                    (std::max)(src.depth[sy0 * src.width + sx0], src.depth[sy0 * src.width + sx1]),
+                    (std::max)(src.depth[sy1 * src.width + sx0], src.depth[sy1 * src.width + sx1]));
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::IsOccluded(const BoundingSphere& bounds) const {
+    if (m_OccluderCount == 0 || bounds.Radius <= 0.0f) {
+        return false;
+    }
+
+    XMFLOAT3 viewCenter;
+    XMStoreFloat3(&viewCenter, XMVector3TransformCoord(XMLoadFloat3(&bounds.Center), XMLoadFloat4x4(&m_View)));
+
+    float minX, minY, maxX, maxY;
+    if (!ProjectSphere(viewCenter, bounds.Radius, minX, minY, maxX, maxY)) {
+        return false;
+    }
+    minX = (std::max)(minX, -1.0f);
+    minY = (std::max)(minY, -1.0f);
+    maxX = (std::min)(maxX, 1.0f);
+    maxY = (std::min)(maxY, 1.0f);
+    if (minX > maxX || minY > maxY) {
+        return false;  // 屏幕外（视锥剔除负责）
+    }
+
+    int x0 = (std::min)(static_cast<int>((minX * 0.5f + 0.5f) * kWidth), static_cast<int>(kWidth) - 1);
+    int x1 = (std::min)(static_cast<int>((maxX * 0.5f + 0.5f) * kWidth), static_cast<int>(kWidth) - 1);
+    int y0 = (std::min)(static_cast<int>((minY * 0.5f + 0.5f) * kHeight), static_cast<int>(kHeight) - 1);
+    int y1 = (std::min)(static_cast<int>((maxY * 0.5f + 0.5f) * kHeight), static_cast<int>(kHeight) - 1);
+
+    // 选择矩形最多覆盖 2x2 纹素的级别
+    size_t level = 0;
+    while (level + 1 < m_Levels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        level++;
+    }
+
+    const Level& hiz = m_Levels[level];
+    const int lx0 = (std::min)(x0 >> level, static_cast<int>(hiz.width) - 1);
+    const int lx1 = (std::min)(x1 >> level, static_cast<int>(hiz.width) - 1);
+    const int ly0 = (std::min)(y0 >> level, static_cast<int>(hiz.height) - 1);
+    const int ly1 = (std::min)(y1 >> level, static_cast<int>(hiz.height) - 1);
+
+    float maxDepth = 0.0f;
+    for (int y = ly0; y <= ly1; y++) {
+        for (int x = lx0; x <= lx1; x++) {
+            maxDepth = (std::max)(maxDepth, hiz.depth[static_cast<size_t>(y) * hiz.width + x]);
+        }
+    }
+
+    return viewCenter.z - bounds.Radius > maxDepth;
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,92 @@
+#pragma once
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <vector>
+#include <cstdint>
+
+namespace outer_wilds {
+
+/**
+ * @brief CPU 层级深度（Hi-Z）遮挡剔除
+ *
+ * 星球是场景里最大的遮挡体：站在星球上时，背面的飞船、道具和其它星球几乎全部不可见。
+ * 每帧把星球球体（SectorComponent::planetRadius）光栅化到一张低分辨率的观察空间深度图，
+ * 再逐级取 2x2 最大值构建深度金字塔；RenderQueue 在输出批次前用实体包围球查询。
+ *
+ * 保守性：
+ * - 像素只有四个角都落在球内才被写入，深度取四角前表面深度的最大值（球前表面为凸，最大值在角上）
+ * - 查询按包围球的屏幕矩形选择金字塔级别，矩形内的最大深度仍在包围球最近点之前才判定为被遮挡
+ * - 相机在遮挡球内部或包围球跨过近平面时不剔除
+ *
+ * 只使用当帧的遮挡体，不依赖上一帧深度缓冲区，没有 GPU 回读延迟。
+ * Begin/AddSphereOccluder/BuildPyramid 在渲染线程调用；IsOccluded 只读，可在并行收集中调用。
+ */
+class OcclusionCuller {
+public:
+    static constexpr uint32_t kWidth = 128;
+    static constexpr uint32_t kHeight = 64;
+    static constexpr float kOccluderRadiusScale = 0.97f;  // 地形高度可能低于 planetRadius，遮挡球略微收缩
+
+    /**
+     * @brief 开始新的一帧（清空深度图）
+     * @param view 观察矩阵（LH）
+     * @param projection 投影矩阵（XMMatrixPerspectiveFovLH）
+     * @param nearPlane 近平面距离
+     */
+    void Begin(const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& projection, float nearPlane);
+
+    /**
+     * @brief 光栅化一个遮挡球（世界空间，半径会乘以 kOccluderRadiusScale）
+     */
+    void AddSphereOccluder(const DirectX::XMFLOAT3& center, float radius);
+
+    /**
+     * @brief 遮挡体添加完毕后构建深度金字塔
+     */
+    void BuildPyramid();
+
+    /**
+     * @brief 世界空间包围球是否被完全遮挡
+     */
+    bool IsOccluded(const DirectX::BoundingSphere& bounds) const;
+
+    bool HasOccluders() const { return m_OccluderCount > 0; }
+    uint32_t GetOccluderCount() const { return m_OccluderCount; }
+
+    /**
+     * @brief 金字塔级别（GpuInstanceRenderer 上传为 mip 链，在计算着色器中做同样的查询）
+     * 级别尺寸与 D3D11 完整 mip 链一致：kWidth x kHeight 逐级减半到 1x1
+     */
+    uint32_t GetLevelCount() const { return static_cast<uint32_t>(m_Levels.size()); }
+    const float* GetLevelDepth(uint32_t level, uint32_t& outWidth, uint32_t& outHeight) const {
+        const Level& l = m_Levels[level];
+        outWidth = l.width;
+        outHeight = l.height;
+        return l.depth.data();
+    }
+
+private:
+    struct Level {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> depth;   // 观察空间 z（FLT_MAX = 无遮挡）
+    };
+
+    /**
+     * @brief 观察空间球体的保守 NDC 矩形（z 在 [cz-r, cz+r] 内时 x/z 的极值在端点处取得）
+     * @return 是否可投影（整个球在近平面之前）
+     */
+    bool ProjectSphere(const DirectX::XMFLOAT3& center, float radius,
+                       float& minX, float& minY, float& maxX, float& maxY) const;
+
+    DirectX::XMFLOAT4X4 m_View;
+    float m_SlopeX = 1.0f;          // tan(半水平视场)
+    float m_SlopeY = 1.0f;          // tan(半垂直视场)
+    float m_NearPlane = 0.1f;
+    uint32_t m_OccluderCount = 0;
+
+    std::vector<Level> m_Levels;    // [0] = kWidth x kHeight
+    std::vector<float> m_CornerDepth;  // (kWidth+1) x (kHeight+1) 角点深度（光栅化临时数据）
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,376 @@
+#include "PlanetTerrainSystem.h"
+#include "components/PlanetTerrainComponent.h"
+#include "components/MeshComponent.h"
+#include "components/BoundsComponent.h"
+#include "components/CameraComponent.h"
+#include "CameraService.h"
+#include "resources/TerrainGenerator.h"
+#include "../scene/components/TransformComponent.h"
+#include "../scene/components/HierarchyComponent.h"
+#include "../scene/TransformSystem.h"
+#include "../physics/components/SectorComponent.h"
+#include "../gameplay/components/PlayerComponent.h"
+#include "../core/DebugManager.h"
+#include <d3d11.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace outer_wilds {
+
+using namespace DirectX;
+
+namespace {
+
+bool IsFutureReady(const std::future<std::shared_ptr<resources::Mesh>>& future) {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/**
+ * @brief 释放补丁的 GPU 缓冲区（Mesh 本身不负责释放，流式补丁必须手动回收）
+ */
+void ReleasePatchBuffers(resources::Mesh& mesh) {
+    mesh.ReleaseGPUBuffers();
+}
+
+} // namespace
+
+bool PlanetTerrainSystem::Initialize(ID3D11Device* device) {
+    m_Device = device;
+    return m_Device != nullptr;
+}
+
+void PlanetTerrainSystem::Shutdown() {
+    // 场景可能已经销毁，不碰补丁实体，只回收 GPU 缓冲区
+    for (auto& [entity, planet] : m_Planets) {
+        for (auto& root : planet.roots) {
+            if (root) ReleaseNodeBuffers(*root);
+        }
+    }
+    m_Orphaned.clear();
+    m_Planets.clear();
+    m_PendingPatches = 0;
+    m_VisiblePatches = 0;
+}
+
+void PlanetTerrainSystem::ReleaseNodeBuffers(TerrainNode& node) {
+    if (node.HasChildren()) {
+        for (auto& child : node.children) {
+            ReleaseNodeBuffers(*child);
+        }
+    }
+    if (node.mesh) {
+        ReleasePatchBuffers(*node.mesh);
+        node.mesh.reset();
+    }
+}
+
+std::unique_ptr<PlanetTerrainSystem::TerrainNode> PlanetTerrainSystem::CreateNode(
+    int face, int level, uint32_t x, uint32_t y, const components::PlanetTerrainComponent& terrain) const {
+    auto node = std::make_unique<TerrainNode>();
+    node->face = face;
+    node->level = level;
+    node->x = x;
+    node->y = y;
+
+    const double size = 2.0 / static_cast<double>(1u << level);
+    const double u = -1.0 + (x + 0.5) * size;
+    const double v = -1.0 + (y + 0.5) * size;
+    XMFLOAT3 dir = resources::TerrainGenerator::CubeFaceToDirection(face, u, v);
+    node->center = XMFLOAT3(dir.x * terrain.radius, dir.y * terrain.radius, dir.z * terrain.radius);
+
+    // 立方体面边长 2 对应球面约 π/2 弧长
+    node->edgeLength = terrain.radius * XM_PIDIV2 * static_cast<float>(size * 0.5);
+    return node;
+}
+
+bool PlanetTerrainSystem::IsActiveSector(entt::registry& registry, entt::entity planet,
+                                         const XMFLOAT3& cameraPosition) const {
+    const auto* sector = registry.try_get<components::SectorComponent>(planet);
+    if (!sector) {
+        return true;  // 不参与扇区管理的星球总是按相机距离细分
+    }
+
+    auto players = registry.view<PlayerComponent, components::InSectorComponent>();
+    for (auto entity : players) {
+        if (players.get<components::InSectorComponent>(entity).sector == planet) {
+            return true;
+        }
+    }
+
+    // 自由相机飞到其它星球附近时也给予完整细节
+    const auto* transform = registry.try_get<TransformComponent>(planet);
+    if (transform) {
+        XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&cameraPosition), XMLoadFloat3(&transform->position));
+        if (XMVectorGetX(XMVector3LengthSq(offset)) < sector->influenceRadius * sector->influenceRadius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PlanetTerrainSystem::DeclareAccess(SystemAccess& access) const {
+    // 补丁实体的创建/销毁
+    access.Write<TransformComponent, components::HierarchyComponent, components::BoundsComponent,
+                 components::MeshComponent, components::MultiMeshComponent, components::PlanetTerrainComponent>()
+          .Read<components::CameraComponent, components::SectorComponent, components::InSectorComponent, PlayerComponent>()
+          .WriteResource(SystemAccess::kEntities);
+}
+
+void PlanetTerrainSystem::Update(float deltaTime, entt::registry& registry) {
+    (void)deltaTime;
+    m_UploadsThisFrame = 0;
+
+    if (!m_Device) {
+        return;
+    }
+
+    // 已合并节点遗留的生成任务
+    for (size_t i = 0; i < m_Orphaned.size();) {
+        if (IsFutureReady(m_Orphaned[i])) {
+            m_Orphaned[i] = std::move(m_Orphaned.back());
+            m_Orphaned.pop_back();
+            m_PendingPatches--;
+        } else {
+            i++;
+        }
+    }
+
+    // 活动相机的当前位置（本帧模拟写入的，渲染前地形就要按它细分）
+    const components::CameraComponent* camera = CameraService::GetInstance().ResolveActiveCamera(registry);
+    if (!camera) {
+        return;
+    }
+
+    // 组件被移除或星球被销毁
+    for (auto it = m_Planets.begin(); it != m_Planets.end();) {
+        if (!registry.valid(it->first) || !registry.all_of<components::PlanetTerrainComponent>(it->first)) {
+            ReleasePlanet(it->second, registry);
+            if (it->second.baseMeshHidden && registry.valid(it->first)) {
+                if (auto* mesh = registry.try_get<components::MeshComponent>(it->first)) mesh->isVisible = true;
+                if (auto* multiMesh = registry.try_get<components::MultiMeshComponent>(it->first)) multiMesh->isVisible = true;
+            }
+            it = m_Planets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto view = registry.view<components::PlanetTerrainComponent, TransformComponent>();
+    for (auto entity : view) {
+        const auto& terrain = view.get<components::PlanetTerrainComponent>(entity);
+        const auto& transform = view.get<TransformComponent>(entity);
+
+        PlanetTerrain& planet = m_Planets[entity];
+        if (planet.roots[0] && (planet.radius != terrain.radius || planet.patchResolution != terrain.patchResolution)) {
+            ReleasePlanet(planet, registry);
+        }
+        if (!planet.roots[0]) {
+            for (int face = 0; face < 6; face++) {
+                planet.roots[face] = CreateNode(face, 0, 0, 0, terrain);
+            }
+            planet.radius = terrain.radius;
+            planet.patchResolution = terrain.patchResolution;
+        }
+
+        // 相机 → 星球模型空间
+        XMVECTOR offset = XMVectorSubtract(XMLoadFloat3(&camera->position), XMLoadFloat3(&transform.position));
+        offset = XMVector3InverseRotate(offset, XMLoadFloat4(&transform.rotation));
+        offset = XMVectorDivide(offset, XMVectorMax(XMLoadFloat3(&transform.scale), XMVectorReplicate(1e-6f)));
+
+        FrameContext context;
+        context.registry = &registry;
+        context.planet = entity;
+        context.terrain = &terrain;
+        XMStoreFloat3(&context.localCamera, offset);
+        context.maxDepth = IsActiveSector(registry, entity, camera->position) ? terrain.maxDepth
+                                                                               : terrain.inactiveMaxDepth;
+        context.maxDepth = (std::max)(0, (std::min)(context.maxDepth, kMaxQuadtreeDepth));
+
+        bool covered = true;
+        for (auto& root : planet.roots) {
+            if (!UpdateNode(*root, context)) {
+                covered = false;
+            }
+        }
+
+        if (covered && terrain.hideBaseMesh && !planet.baseMeshHidden) {
+            if (auto* mesh = registry.try_get<components::MeshComponent>(entity)) mesh->isVisible = false;
+            if (auto* multiMesh = registry.try_get<components::MultiMeshComponent>(entity)) multiMesh->isVisible = false;
+            planet.baseMeshHidden = true;
+            DebugManager::GetInstance().Log("PlanetTerrainSystem", "Terrain ready, base mesh hidden");
+        }
+    }
+}
+
+/**
+ * @brief 更新一个节点及其子树
+ * @return 该节点覆盖的区域是否已被可见补丁完整覆盖（自身或全部子节点）
+ */
+bool PlanetTerrainSystem::UpdateNode(TerrainNode& node, const FrameContext& context) {
+    entt::registry& registry = *context.registry;
+    PollPatch(node, context);
+
+    XMVECTOR toCamera = XMVectorSubtract(XMLoadFloat3(&context.localCamera), XMLoadFloat3(&node.center));
+    float distance = XMVectorGetX(XMVector3Length(toCamera));
+    bool wantSplit = node.level < context.maxDepth &&
+                     distance < node.edgeLength * context.terrain->splitDistanceFactor;
+
+    // 不需要细分且自身已就绪：合并子树
+    if (!wantSplit && node.IsReady() && node.HasChildren()) {
+        for (auto& child : node.children) {
+            ReleaseNode(*child, registry);
+            child.reset();
+        }
+    }
+
+    if (wantSplit && !node.HasChildren()) {
+        for (uint32_t i = 0; i < 4; i++) {
+            node.children[i] = CreateNode(node.face, node.level + 1, node.x * 2 + (i & 1), node.y * 2 + (i >> 1),
+                                          *context.terrain);
+        }
+    }
+
+    if (node.HasChildren()) {
+        // 近处的子节点先占用生成配额
+        std::array<TerrainNode*, 4> order = { node.children[0].get(), node.children[1].get(),
+                                              node.children[2].get(), node.children[3].get() };
+        XMVECTOR camera = XMLoadFloat3(&context.localCamera);
+        auto distanceSq = [&camera](const TerrainNode* n) {
+            return XMVectorGetX(XMVector3LengthSq(XMVectorSubtract(camera, XMLoadFloat3(&n->center))));
+        };
+        std::sort(order.begin(), order.end(),
+                  [&](const TerrainNode* a, const TerrainNode* b) { return distanceSq(a) < distanceSq(b); });
+
+        bool childrenCovered = true;
+        for (TerrainNode* child : order) {
+            if (!UpdateNode(*child, context)) {
+                childrenCovered = false;
+            }
+        }
+        if (childrenCovered) {
+            SetNodeVisible(node, registry, false);
+            return true;
+        }
+        for (auto& child : node.children) {
+            HideSubtree(*child, registry);
+        }
+    }
+
+    if (!node.IsReady()) {
+        RequestPatch(node, context);
+    }
+    SetNodeVisible(node, registry, node.IsReady());
+    return node.IsReady();
+}
+
+void PlanetTerrainSystem::RequestPatch(TerrainNode& node, const FrameContext& context) {
+    if (node.pending.valid() || node.mesh || m_PendingPatches >= kMaxPendingPatches) {
+        return;
+    }
+
+    const auto& terrain = *context.terrain;
+    resources::CubeSpherePatchDesc desc;
+    desc.face = node.face;
+    desc.size = 2.0 / static_cast<double>(1u << node.level);
+    desc.u0 = -1.0 + node.x * desc.size;
+    desc.v0 = -1.0 + node.y * desc.size;
+    desc.resolution = (std::max)(1, terrain.patchResolution);
+    desc.radius = terrain.radius;
+    desc.skirtDepth = node.edgeLength * terrain.skirtFactor;
+    desc.heightFunction = terrain.heightFunction;
+
+    node.pending = std::async(std::launch::async, [desc]() {
+        auto mesh = std::make_shared<resources::Mesh>();
+        resources::TerrainGenerator::CreateCubeSpherePatch(*mesh, desc);
+        return mesh;
+    });
+    m_PendingPatches++;
+}
+
+void PlanetTerrainSystem::PollPatch(TerrainNode& node, const FrameContext& context) {
+    if (node.pending.valid() && IsFutureReady(node.pending)) {
+        node.mesh = node.pending.get();
+        m_PendingPatches--;
+    }
+    if (!node.mesh || node.IsReady() || m_UploadsThisFrame >= kMaxUploadsPerFrame) {
+        return;
+    }
+
+    // GPU 上传与实体创建都在主线程，每帧限量
+    entt::registry& registry = *context.registry;
+    node.mesh->CreateGPUBuffers(m_Device);
+    m_UploadsThisFrame++;
+
+    std::shared_ptr<resources::Material> material = context.terrain->material;
+    if (!material) {
+        if (auto* mesh = registry.try_get<components::MeshComponent>(context.planet)) {
+            material = mesh->material;
+        } else if (auto* multiMesh = registry.try_get<components::MultiMeshComponent>(context.planet)) {
+            if (!multiMesh->materials.empty()) material = multiMesh->materials[0];
+        }
+    }
+
+    node.entity = registry.create();
+    registry.emplace<TransformComponent>(node.entity);
+    TransformSystem::Attach(registry, node.entity, context.planet);
+    registry.emplace<components::BoundsComponent>(node.entity).SetSphere(
+        components::BoundsComponent::SphereFromVertices(node.mesh->GetVertices()));
+    auto& meshComp = registry.emplace<components::MeshComponent>(node.entity, node.mesh, material);
+    meshComp.isVisible = false;
+}
+
+void PlanetTerrainSystem::SetNodeVisible(TerrainNode& node, entt::registry& registry, bool visible) {
+    if (node.entity == entt::null) {
+        return;
+    }
+    auto* mesh = registry.try_get<components::MeshComponent>(node.entity);
+    if (mesh && mesh->isVisible != visible) {
+        mesh->isVisible = visible;
+        visible ? m_VisiblePatches++ : m_VisiblePatches--;
+    }
+}
+
+void PlanetTerrainSystem::HideSubtree(TerrainNode& node, entt::registry& registry) {
+    SetNodeVisible(node, registry, false);
+    if (node.HasChildren()) {
+        for (auto& child : node.children) {
+            HideSubtree(*child, registry);
+        }
+    }
+}
+
+void PlanetTerrainSystem::ReleaseNode(TerrainNode& node, entt::registry& registry) {
+    if (node.HasChildren()) {
+        for (auto& child : node.children) {
+            ReleaseNode(*child, registry);
+            child.reset();
+        }
+    }
+    if (node.pending.valid()) {
+        m_Orphaned.push_back(std::move(node.pending));
+    }
+    if (node.entity != entt::null) {
+        // 先销毁实体：RenderQueue 在下一次收集时移除缓存批次，之后再不会访问这些缓冲区
+        if (registry.valid(node.entity)) {
+            SetNodeVisible(node, registry, false);
+            registry.destroy(node.entity);
+        }
+        node.entity = entt::null;
+    }
+    if (node.mesh) {
+        ReleasePatchBuffers(*node.mesh);
+        node.mesh.reset();
+    }
+}
+
+void PlanetTerrainSystem::ReleasePlanet(PlanetTerrain& planet, entt::registry& registry) {
+    for (auto& root : planet.roots) {
+        if (root) {
+            ReleaseNode(*root, registry);
+            root.reset();
+        }
+    }
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,101 @@
+#pragma once
+#include "../core/ECS.h"
+#include "resources/Mesh.h"
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <array>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+struct ID3D11Device;
+
+namespace outer_wilds {
+
+namespace components {
+struct PlanetTerrainComponent;
+}
+
+/**
+ * @brief 立方体球四叉树地形系统（驱动 PlanetTerrainComponent）
+ *
+ * 每帧：
+ * 1. 把相机变换到星球模型空间，按距离细分/合并 6 个面的四叉树
+ * 2. 缺失的补丁交给工作线程生成（同时在途数量受限，近处优先）
+ * 3. 已生成的补丁在主线程分帧上传 GPU 并创建子实体
+ * 4. 子补丁未全部就绪前继续显示父补丁，避免出现空洞
+ */
+class PlanetTerrainSystem : public System {
+public:
+    static constexpr size_t kMaxPendingPatches = 8;   // 同时在工作线程上生成的补丁数
+    static constexpr size_t kMaxUploadsPerFrame = 4;  // 每帧上传 GPU 的补丁数
+    static constexpr int kMaxQuadtreeDepth = 16;
+
+    void Initialize() override {}
+    bool Initialize(ID3D11Device* device);
+    void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
+    void Shutdown() override;
+
+    size_t GetVisiblePatchCount() const { return m_VisiblePatches; }
+    size_t GetPendingPatchCount() const { return m_PendingPatches; }
+
+private:
+    struct TerrainNode {
+        int face = 0;
+        int level = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        DirectX::XMFLOAT3 center = { 0.0f, 0.0f, 0.0f };  // 补丁中心（模型空间，球面上）
+        float edgeLength = 0.0f;                              // 补丁近似边长（模型空间）
+
+        entt::entity entity = entt::null;
+        std::shared_ptr<resources::Mesh> mesh;
+        std::future<std::shared_ptr<resources::Mesh>> pending;
+        std::array<std::unique_ptr<TerrainNode>, 4> children;
+
+        bool IsReady() const { return entity != entt::null; }
+        bool HasChildren() const { return children[0] != nullptr; }
+    };
+
+    struct PlanetTerrain {
+        std::array<std::unique_ptr<TerrainNode>, 6> roots;
+        float radius = 0.0f;
+        int patchResolution = 0;
+        bool baseMeshHidden = false;
+    };
+
+    struct FrameContext {
+        entt::registry* registry = nullptr;
+        entt::entity planet = entt::null;
+        const components::PlanetTerrainComponent* terrain = nullptr;
+        DirectX::XMFLOAT3 localCamera = { 0.0f, 0.0f, 0.0f };
+        int maxDepth = 0;
+    };
+
+    std::unique_ptr<TerrainNode> CreateNode(int face, int level, uint32_t x, uint32_t y,
+                                            const components::PlanetTerrainComponent& terrain) const;
+    bool UpdateNode(TerrainNode& node, const FrameContext& context);
+    void RequestPatch(TerrainNode& node, const FrameContext& context);
+    void PollPatch(TerrainNode& node, const FrameContext& context);
+    void SetNodeVisible(TerrainNode& node, entt::registry& registry, bool visible);
+    void HideSubtree(TerrainNode& node, entt::registry& registry);
+    void ReleaseNode(TerrainNode& node, entt::registry& registry);
+    /** @brief 只释放子树的补丁缓冲区（Shutdown 时 registry 可能已不存在） */
+    void ReleaseNodeBuffers(TerrainNode& node);
+    void ReleasePlanet(PlanetTerrain& planet, entt::registry& registry);
+    bool IsActiveSector(entt::registry& registry, entt::entity planet, const DirectX::XMFLOAT3& cameraPosition) const;
+
+    ID3D11Device* m_Device = nullptr;
+    std::unordered_map<entt::entity, PlanetTerrain> m_Planets;
+
+    // 合并时仍在生成的补丁：std::async 的 future 析构会阻塞，先移到这里等它自然完成
+    std::vector<std::future<std::shared_ptr<resources::Mesh>>> m_Orphaned;
+
+    size_t m_PendingPatches = 0;
+    size_t m_UploadsThisFrame = 0;
+    size_t m_VisiblePatches = 0;
+};
+
+} // namespace outer_wilds
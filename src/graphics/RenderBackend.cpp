@@ -1,37 +1,90 @@
 #include "RenderBackend.h"
+#include "GpuMemory.h"
+#include "RenderStateCache.h"
 #include "../core/DebugManager.h"
 #include <d3d11.h>
-#include <dxgi.h>
+#include <dxgi1_5.h>
 #include <DirectXMath.h>
 #include <iostream>
+#include <string>
 
 namespace outer_wilds {
 
+RenderBackend::~RenderBackend() {
+    Shutdown();
+}
+
+/**
+ * @brief 创建 flip 模型交换链（含帧延迟等待对象，支持时允许撕裂）
+ * @return 失败时返回 false，由调用方回退到 blit 模型
+ */
+bool RenderBackend::CreateFlipSwapChain(IDXGIFactory1* factory, HWND hwnd, int width, int height) {
+    ComPtr<IDXGIFactory2> factory2;
+    if (FAILED(factory->QueryInterface(__uuidof(IDXGIFactory2), reinterpret_cast<void**>(factory2.GetAddressOf())))) {
+        return false;
+    }
+
+    // 撕裂需要 DXGI 1.5（Windows 10 周年更新）和支持可变刷新率的显示路径
+    m_TearingSupported = false;
+    ComPtr<IDXGIFactory5> factory5;
+    if (SUCCEEDED(factory->QueryInterface(__uuidof(IDXGIFactory5), reinterpret_cast<void**>(factory5.GetAddressOf())))) {
+        BOOL allowTearing = FALSE;
+        if (SUCCEEDED(factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing)))) {
+            m_TearingSupported = allowTearing == TRUE;
+        }
+    }
+
+    DXGI_SWAP_CHAIN_DESC1 desc = {};
+    desc.Width = width;
+    desc.Height = height;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;                       // flip 模型不支持多重采样交换链
+    desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    desc.BufferCount = m_BufferCount;
+    desc.Scaling = DXGI_SCALING_STRETCH;
+    desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    desc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+    desc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    if (m_TearingSupported) {
+        desc.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    }
+
+    ComPtr<IDXGISwapChain1> swapChain1;
+    HRESULT hr = factory2->CreateSwapChainForHwnd(m_Device.Get(), hwnd, &desc, nullptr, nullptr, swapChain1.GetAddressOf());
+    if (FAILED(hr)) {
+        m_TearingSupported = false;
+        return false;
+    }
+
+    // 撕裂模式下 Alt+Enter 的独占全屏与 ALLOW_TEARING 冲突，由窗口自己处理全屏
+    factory2->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
+
+    swapChain1.As(&m_SwapChain);
+    if (SUCCEEDED(swapChain1.As(&m_SwapChain2))) {
+        m_SwapChain2->SetMaximumFrameLatency(m_MaxFrameLatency);
+        m_FrameLatencyWaitable = m_SwapChain2->GetFrameLatencyWaitableObject();
+    }
+
+    m_SwapChainFlags = desc.Flags;
+    m_FlipModel = true;
+    DebugManager::GetInstance().Log("RenderBackend", "Flip swap chain: " + std::to_string(m_BufferCount) +
+                                    " buffers, max latency " + std::to_string(m_MaxFrameLatency) +
+                                    (m_TearingSupported ? ", tearing supported" : ""));
+    return true;
+}
+
 bool RenderBackend::Initialize(void* hwnd, int width, int height) {
     m_Width = width;
     m_Height = height;
 
-    // Create device and swap chain
-    DXGI_SWAP_CHAIN_DESC swapChainDesc = {};
-    swapChainDesc.BufferCount = 1;
-    swapChainDesc.BufferDesc.Width = width;
-    swapChainDesc.BufferDesc.Height = height;
-    swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    swapChainDesc.BufferDesc.RefreshRate.Numerator = 60;
-    swapChainDesc.BufferDesc.RefreshRate.Denominator = 1;
-    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.OutputWindow = static_cast<HWND>(hwnd);
-    swapChainDesc.SampleDesc.Count = 1;
-    swapChainDesc.SampleDesc.Quality = 0;
-    swapChainDesc.Windowed = TRUE;
-
     D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_0;
     UINT flags = 0;
 #ifdef _DEBUG
     flags |= D3D11_CREATE_DEVICE_DEBUG;
 #endif
 
-    HRESULT hr = D3D11CreateDeviceAndSwapChain(
+    // Create device
+    HRESULT hr = D3D11CreateDevice(
         nullptr,
         D3D_DRIVER_TYPE_HARDWARE,
         nullptr,
@@ -39,18 +92,50 @@ bool RenderBackend::Initialize(void* hwnd, int width, int height) {
         &featureLevel,
         1,
         D3D11_SDK_VERSION,
-        &swapChainDesc,
-        m_SwapChain.GetAddressOf(),
         m_Device.GetAddressOf(),
         nullptr,
         m_Context.GetAddressOf()
     );
 
     if (FAILED(hr)) {
-        std::cerr << "Failed to create D3D11 device and swap chain" << std::endl;
+        std::cerr << "Failed to create D3D11 device" << std::endl;
         return false;
     }
 
+    // 从设备取得创建它的 DXGI 工厂（交换链必须由同一工厂创建）
+    ComPtr<IDXGIDevice> dxgiDevice;
+    ComPtr<IDXGIAdapter> adapter;
+    ComPtr<IDXGIFactory1> factory;
+    if (FAILED(m_Device.As(&dxgiDevice)) || FAILED(dxgiDevice->GetAdapter(&adapter)) ||
+        FAILED(adapter->GetParent(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(factory.GetAddressOf())))) {
+        std::cerr << "Failed to get DXGI factory" << std::endl;
+        return false;
+    }
+
+    // Create swap chain (flip model first, blit model fallback)
+    if (!CreateFlipSwapChain(factory.Get(), static_cast<HWND>(hwnd), width, height)) {
+        DXGI_SWAP_CHAIN_DESC swapChainDesc = {};
+        swapChainDesc.BufferCount = 1;
+        swapChainDesc.BufferDesc.Width = width;
+        swapChainDesc.BufferDesc.Height = height;
+        swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapChainDesc.BufferDesc.RefreshRate.Numerator = 60;
+        swapChainDesc.BufferDesc.RefreshRate.Denominator = 1;
+        swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapChainDesc.OutputWindow = static_cast<HWND>(hwnd);
+        swapChainDesc.SampleDesc.Count = 1;
+        swapChainDesc.SampleDesc.Quality = 0;
+        swapChainDesc.Windowed = TRUE;
+
+        m_SwapChainFlags = 0;
+        hr = factory->CreateSwapChain(m_Device.Get(), &swapChainDesc, m_SwapChain.GetAddressOf());
+        if (FAILED(hr)) {
+            std::cerr << "Failed to create swap chain" << std::endl;
+            return false;
+        }
+        DebugManager::GetInstance().Log("RenderBackend", "Flip model unavailable, using blit swap chain");
+    }
+
     // Create render target view
     ComPtr<ID3D11Texture2D> backBuffer;
     hr = m_SwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), &backBuffer);
@@ -79,6 +164,7 @@ bool RenderBackend::Initialize(void* hwnd, int width, int height) {
 
     ComPtr<ID3D11Texture2D> depthStencil;
     hr = m_Device->CreateTexture2D(&depthStencilDesc, nullptr, depthStencil.GetAddressOf());
+    GpuMemory::Track(depthStencil.Get());
     if (FAILED(hr)) {
         std::cerr << "Failed to create depth stencil texture" << std::endl;
         return false;
@@ -103,49 +189,65 @@ bool RenderBackend::Initialize(void* hwnd, int width, int height) {
     viewport.TopLeftY = 0.0f;
     m_Context->RSSetViewports(1, &viewport);
 
-    // Create rasterizer state
-    D3D11_RASTERIZER_DESC rasterizerDesc = {};
-    rasterizerDesc.FillMode = D3D11_FILL_SOLID;
-    rasterizerDesc.CullMode = D3D11_CULL_BACK;
-    rasterizerDesc.FrontCounterClockwise = FALSE;
-    rasterizerDesc.DepthBias = 0;
-    rasterizerDesc.DepthBiasClamp = 0.0f;
-    rasterizerDesc.SlopeScaledDepthBias = 0.0f;
-    rasterizerDesc.DepthClipEnable = TRUE;
-    rasterizerDesc.ScissorEnable = FALSE;
-    rasterizerDesc.MultisampleEnable = FALSE;
-    rasterizerDesc.AntialiasedLineEnable = FALSE;
-
-    hr = m_Device->CreateRasterizerState(&rasterizerDesc, &m_RasterizerState);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create rasterizer state" << std::endl;
+    // 状态对象缓存：之后所有通道的混合 / 深度 / 光栅化 / 采样器状态都从这里获取
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    stateCache.Initialize(m_Device.Get(), m_Context.Get());
+    PassState defaultState;
+    defaultState.rasterizer = stateCache.GetRasterizerState(D3D11_CULL_BACK);
+    defaultState.depthStencil = stateCache.GetDepthStencilState(true, true, D3D11_COMPARISON_LESS);
+    if (!defaultState.rasterizer || !defaultState.depthStencil) {
+        std::cerr << "Failed to create default render states" << std::endl;
         return false;
     }
+    stateCache.Apply(m_Context.Get(), defaultState);
 
-    m_Context->RSSetState(m_RasterizerState.Get());
+    if (!m_GpuProfiler.Initialize(m_Device.Get())) {
+        DebugManager::GetInstance().Log("RenderBackend", "GPU profiler unavailable");
+    }
 
-    // Create depth stencil state
-    D3D11_DEPTH_STENCIL_DESC depthStencilStateDesc = {};
-    depthStencilStateDesc.DepthEnable = TRUE;
-    depthStencilStateDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-    depthStencilStateDesc.DepthFunc = D3D11_COMPARISON_LESS;
-    depthStencilStateDesc.StencilEnable = FALSE;
+    DebugManager::GetInstance().Log("RenderBackend", "RenderBackend initialized successfully");
+    return true;
+}
 
-    hr = m_Device->CreateDepthStencilState(&depthStencilStateDesc, &m_DepthStencilState);
+bool RenderBackend::InitializeHeadless(int width, int height) {
+    m_Width = width;
+    m_Height = height;
+    m_Headless = true;
+
+    D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_0;
+    HRESULT hr = D3D11CreateDevice(
+        nullptr,
+        D3D_DRIVER_TYPE_WARP,
+        nullptr,
+        0,
+        &featureLevel,
+        1,
+        D3D11_SDK_VERSION,
+        m_Device.GetAddressOf(),
+        nullptr,
+        m_Context.GetAddressOf()
+    );
     if (FAILED(hr)) {
-        std::cerr << "Failed to create depth stencil state" << std::endl;
-        return false;
+        // 没有设备时模型加载失败，场景只剩无网格的实体，基准仍可测模拟部分
+        m_Device.Reset();
+        m_Context.Reset();
+        DebugManager::GetInstance().Log("RenderBackend", "WARP device unavailable, running headless without a device");
+        return true;
     }
 
-    m_Context->OMSetDepthStencilState(m_DepthStencilState.Get(), 0);
-
-    DebugManager::GetInstance().Log("RenderBackend", "RenderBackend initialized successfully");
+    RenderStateCache::GetInstance().Initialize(m_Device.Get(), m_Context.Get());
+    DebugManager::GetInstance().Log("RenderBackend", "Headless RenderBackend initialized (WARP device, no swap chain)");
     return true;
 }
 
 void RenderBackend::Shutdown() {
-    m_DepthStencilState.Reset();
-    m_RasterizerState.Reset();
+    if (m_FrameLatencyWaitable) {
+        CloseHandle(m_FrameLatencyWaitable);
+        m_FrameLatencyWaitable = nullptr;
+    }
+    m_GpuProfiler.Shutdown();
+    m_SwapChain2.Reset();
+    RenderStateCache::GetInstance().Shutdown();
     m_DepthStencilView.Reset();
     m_RenderTargetView.Reset();
     m_SwapChain.Reset();
@@ -154,32 +256,49 @@ void RenderBackend::Shutdown() {
 }
 
 void RenderBackend::BeginFrame() {
-    // This is now handled by RenderSystem
-    // float clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
-    // m_Context->ClearRenderTargetView(m_RenderTargetView.Get(), clearColor);
-    // m_Context->ClearDepthStencilView(m_DepthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    // 清屏由 RenderSystem 负责；这里只等待交换链允许提交新的一帧（超时 1 秒，防止设备移除时死锁）
+    if (m_FrameLatencyWaitable) {
+        WaitForSingleObjectEx(m_FrameLatencyWaitable, 1000, TRUE);
+    }
 }
 
 void RenderBackend::EndFrame() {
-    // Nothing to do here for now
+    if (m_Headless) return;
+    m_GpuProfiler.EndFrame(m_Context.Get());
 }
 
 void RenderBackend::Present() {
-    m_SwapChain->Present(1, 0);
+    if (!m_SwapChain) return;
+
+    if (m_VSync) {
+        m_SwapChain->Present(1, 0);
+    } else {
+        // ALLOW_TEARING 只能用于 sync interval 0 的窗口模式
+        m_SwapChain->Present(0, m_TearingSupported ? DXGI_PRESENT_ALLOW_TEARING : 0);
+    }
+}
+
+void RenderBackend::SetMaxFrameLatency(uint32_t frames) {
+    m_MaxFrameLatency = frames < 1 ? 1 : (frames > 16 ? 16 : frames);
+    if (m_SwapChain2) {
+        m_SwapChain2->SetMaximumFrameLatency(m_MaxFrameLatency);
+    }
 }
 
 void RenderBackend::ResizeBuffers(int width, int height) {
     if (width == m_Width && height == m_Height) return;
+    if (!m_SwapChain) return;
 
     m_Width = width;
     m_Height = height;
 
-    // Release render target view
+    // Release render target view（flip 模型要求所有后缓冲区引用先解绑释放）
+    m_Context->OMSetRenderTargets(0, nullptr, nullptr);
     m_RenderTargetView.Reset();
     m_DepthStencilView.Reset();
 
-    // Resize swap chain
-    HRESULT hr = m_SwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, 0);
+    // Resize swap chain（标志必须与创建时一致，否则等待对象/撕裂失效）
+    HRESULT hr = m_SwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, m_SwapChainFlags);
     if (FAILED(hr)) {
         std::cerr << "Failed to resize swap chain buffers" << std::endl;
         return;
@@ -213,6 +332,7 @@ void RenderBackend::ResizeBuffers(int width, int height) {
 
     ComPtr<ID3D11Texture2D> depthStencil;
     hr = m_Device->CreateTexture2D(&depthStencilDesc, nullptr, depthStencil.GetAddressOf());
+    GpuMemory::Track(depthStencil.Get());
     if (FAILED(hr)) {
         std::cerr << "Failed to create resized depth stencil texture" << std::endl;
         return;
@@ -1,42 +1,110 @@
 #pragma once
 #include <d3d11.h>
+#include <dxgi1_3.h>
 #include <wrl/client.h>
+#include "GpuProfiler.h"
 #include <memory>
+#include <cstdint>
 
 using Microsoft::WRL::ComPtr;
 
 namespace outer_wilds {
 
+/**
+ * @brief D3D11 设备与交换链
+ *
+ * 优先创建 flip 模型交换链（DXGI_SWAP_EFFECT_FLIP_DISCARD，2~3 个缓冲区）并启用帧延迟等待对象：
+ * BeginFrame 在读取输入之前阻塞到 DXGI 允许提交新的一帧，CPU 不会领先 GPU 超过 maxFrameLatency 帧，
+ * 输入到显示的延迟随之降低；flip 模型也让 DWM 直接使用我们的缓冲区，不再额外排队一帧。
+ * 关闭垂直同步且系统支持时以 DXGI_PRESENT_ALLOW_TEARING 呈现。
+ * 系统不支持 flip 模型（IDXGIFactory2 不可用或创建失败）时回退到旧的 blit 模型。
+ */
 class RenderBackend {
 public:
+    static constexpr uint32_t kDefaultBufferCount = 3;
+    static constexpr uint32_t kDefaultMaxFrameLatency = 1;
+
     RenderBackend() = default;
-    ~RenderBackend() = default;
+    ~RenderBackend();
+
+    /**
+     * @brief 交换链参数（须在 Initialize 之前设置；缓冲区数限制在 2~3）
+     */
+    void SetBufferCount(uint32_t count) { m_BufferCount = count < 2 ? 2 : (count > 3 ? 3 : count); }
+    uint32_t GetBufferCount() const { return m_BufferCount; }
 
     bool Initialize(void* hwnd, int width, int height);
+    /**
+     * @brief 无窗口模式（基准测试）：不创建交换链和后缓冲区，Present/帧延迟等待均为空操作
+     *
+     * 资源加载仍需要设备（RenderQueue 按顶点缓冲区解析批次），因此创建 WARP 软件设备，
+     * 不依赖显卡；WARP 也不可用时设备为空，只运行模拟与 CPU 侧收集。
+     */
+    bool InitializeHeadless(int width, int height);
+    bool IsHeadless() const { return m_Headless; }
     void Shutdown();
     
+    /**
+     * @brief 等待帧延迟对象（每帧读取输入之前调用一次；无等待对象时立即返回）
+     */
     void BeginFrame();
+    /**
+     * @brief 结束本帧的 GPU 计时（Present 之前调用）
+     */
     void EndFrame();
     void Present();
     
+    /**
+     * @brief GPU 分段计时（RenderSystem 每帧开始时调用 BeginFrame，EndFrame 在这里结束）
+     */
+    GpuProfiler& GetGpuProfiler() { return m_GpuProfiler; }
+    
+    /**
+     * @brief CPU 最多领先显示的帧数（1~16，运行时可改）
+     */
+    void SetMaxFrameLatency(uint32_t frames);
+    uint32_t GetMaxFrameLatency() const { return m_MaxFrameLatency; }
+    
+    /**
+     * @brief 垂直同步；关闭且支持撕裂时立即呈现
+     */
+    void SetVSync(bool enabled) { m_VSync = enabled; }
+    bool IsVSyncEnabled() const { return m_VSync; }
+    
+    bool IsFlipModel() const { return m_FlipModel; }
+    bool IsTearingSupported() const { return m_TearingSupported; }
+    
     ID3D11Device* GetDevice() { return m_Device.Get(); }
     ID3D11DeviceContext* GetContext() { return m_Context.Get(); }
     ID3D11RenderTargetView* GetRenderTargetView() { return m_RenderTargetView.Get(); }
     ID3D11DepthStencilView* GetDepthStencilView() { return m_DepthStencilView.Get(); }
     
     void ResizeBuffers(int width, int height);
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
 
 private:
+    bool CreateFlipSwapChain(IDXGIFactory1* factory, HWND hwnd, int width, int height);
+
     ComPtr<ID3D11Device> m_Device;
     ComPtr<ID3D11DeviceContext> m_Context;
     ComPtr<IDXGISwapChain> m_SwapChain;
+    ComPtr<IDXGISwapChain2> m_SwapChain2;              // 帧延迟等待对象（flip 模型时有效）
     ComPtr<ID3D11RenderTargetView> m_RenderTargetView;
     ComPtr<ID3D11DepthStencilView> m_DepthStencilView;
-    ComPtr<ID3D11RasterizerState> m_RasterizerState;
-    ComPtr<ID3D11DepthStencilState> m_DepthStencilState;
+    GpuProfiler m_GpuProfiler;
     
     int m_Width = 0;
     int m_Height = 0;
+    
+    uint32_t m_BufferCount = kDefaultBufferCount;
+    uint32_t m_MaxFrameLatency = kDefaultMaxFrameLatency;
+    UINT m_SwapChainFlags = 0;                           // ResizeBuffers 必须传入相同的标志
+    HANDLE m_FrameLatencyWaitable = nullptr;
+    bool m_FlipModel = false;
+    bool m_TearingSupported = false;
+    bool m_VSync = true;
+    bool m_Headless = false;
 };
 
 } // namespace outer_wilds
@@ -1,374 +1,1497 @@
 #include "RenderQueue.h"
 #include "components/MeshComponent.h"
+#include "components/BoundsComponent.h"
+#include "components/ImpostorComponent.h"
 #include "../scene/components/TransformComponent.h"
-#include "../scene/components/ChildEntityComponent.h"
 #include "../core/DebugManager.h"
 #include "resources/Material.h"
 #include "resources/Mesh.h"
 #include "resources/Shader.h"
+#include "resources/TextureStreamer.h"
+#include "ShaderCompileService.h"
+#include "OcclusionCuller.h"
+#include "ShadowRenderer.h"
+#include "ClusteredLighting.h"
+#include "GpuProfiler.h"
+#include "GpuMemory.h"
 #include <unordered_map>
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <thread>
 
 using namespace DirectX;
 
 namespace outer_wilds {
 
-/**
- * @brief 全局Shader缓存（避免重复加载）
- */
-static std::unordered_map<std::string, std::shared_ptr<resources::Shader>> g_ShaderCache;
 static ID3D11Device* g_CachedDevice = nullptr;
 
-static resources::Shader* GetOrLoadShader(const std::string& vsName, const std::string& psName, ID3D11Device* device) {
-    std::string key = vsName + "|" + psName;
+bool RenderBatch::CanInstanceWith(const RenderBatch& other) const {
+    if (renderPass != 0 || other.renderPass != 0) return false;
+    if (!instancedVertexShader || instancedVertexShader != other.instancedVertexShader) return false;
+    
+    if (vertexBuffer != other.vertexBuffer || indexBuffer != other.indexBuffer ||
+        indexCount != other.indexCount || vertexStride != other.vertexStride ||
+        vertexOffset != other.vertexOffset || startIndex != other.startIndex || baseVertex != other.baseVertex) {
+        return false;
+    }
     
-    if (g_ShaderCache.find(key) == g_ShaderCache.end()) {
-        auto shader = std::make_shared<resources::Shader>();
-        if (shader->LoadFromFile(device, vsName, psName)) {
-            g_ShaderCache[key] = shader;
-            DebugManager::GetInstance().Log("RenderQueue", "Cached shader: " + key);
+    if (pixelShader != other.pixelShader ||
+        albedoTexture != other.albedoTexture || normalTexture != other.normalTexture ||
+        metallicTexture != other.metallicTexture || roughnessTexture != other.roughnessTexture ||
+        emissiveTexture != other.emissiveTexture) {
+        return false;
+    }
+    
+    // MaterialBuffer(b2) 每组只绑定一次（取首个批次的材质），自发光参数和图集层下标必须一致
+    if (material == other.material) return true;
+    const bool packedA = material && material->packedIntoArrays;
+    const bool packedB = other.material && other.material->packedIntoArrays;
+    if (packedA != packedB) return false;
+    if (packedA && std::memcmp(material->textureArraySlice, other.material->textureArraySlice,
+                               sizeof(material->textureArraySlice)) != 0) {
+        return false;
+    }
+    bool emissiveA = material && material->isEmissive;
+    bool emissiveB = other.material && other.material->isEmissive;
+    if (emissiveA != emissiveB) return false;
+    if (!emissiveA) return true;
+    return material->emissiveStrength == other.material->emissiveStrength &&
+           material->emissiveColor.x == other.material->emissiveColor.x &&
+           material->emissiveColor.y == other.material->emissiveColor.y &&
+           material->emissiveColor.z == other.material->emissiveColor.z;
+}
+
+RenderQueue::~RenderQueue() {
+    DisconnectRegistry();
+    ReleaseObjectBuffers();
+    ReleaseDeferredContexts();
+    if (m_DefaultMaterialCB) m_DefaultMaterialCB->Release();
+}
+
+// ============================================================================
+// 保留模式缓存
+// ============================================================================
+
+void RenderQueue::ResetCache() {
+    DisconnectRegistry();
+    m_Renderables.clear();
+    m_RenderableIndex.clear();
+    m_PendingRebuild.clear();
+}
+
+void RenderQueue::ConnectRegistry(entt::registry& registry) {
+    ResetCache();
+    m_Registry = &registry;
+
+    // 组件变化只登记实体，真正的重建推迟到下一次 Collect（此时同一帧内后续挂载的
+    // BoundsComponent 等都已就绪）
+    registry.on_construct<components::MeshComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::MeshComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::MeshComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<components::MultiMeshComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::MultiMeshComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::MultiMeshComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<components::BoundsComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::BoundsComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::BoundsComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<components::ImpostorComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::ImpostorComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::ImpostorComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<TransformComponent>().connect<&RenderQueue::OnRenderableChanged>(*this);
+
+    // 连接之前已经存在的实体
+    for (auto entity : registry.view<components::MeshComponent>()) {
+        m_PendingRebuild.push_back(entity);
+    }
+    for (auto entity : registry.view<components::MultiMeshComponent>()) {
+        m_PendingRebuild.push_back(entity);
+    }
+}
+
+void RenderQueue::DisconnectRegistry() {
+    if (!m_Registry) {
+        return;
+    }
+
+    entt::registry& registry = *m_Registry;
+    registry.on_construct<components::MeshComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::MeshComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::MeshComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<components::MultiMeshComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::MultiMeshComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::MultiMeshComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<components::BoundsComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::BoundsComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::BoundsComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<components::ImpostorComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_update<components::ImpostorComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_destroy<components::ImpostorComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    registry.on_construct<TransformComponent>().disconnect<&RenderQueue::OnRenderableChanged>(*this);
+    m_Registry = nullptr;
+}
+
+void RenderQueue::OnRenderableChanged(entt::registry& registry, entt::entity entity) {
+    m_PendingRebuild.push_back(entity);
+}
+
+void RenderQueue::RemoveRenderable(entt::entity entity) {
+    auto it = m_RenderableIndex.find(entity);
+    if (it == m_RenderableIndex.end()) {
+        return;
+    }
+
+    // swap-and-pop，保持 m_Renderables 紧凑
+    size_t index = it->second;
+    size_t last = m_Renderables.size() - 1;
+    if (index != last) {
+        m_Renderables[index] = std::move(m_Renderables[last]);
+        m_RenderableIndex[m_Renderables[index].entity] = index;
+    }
+    m_Renderables.pop_back();
+    m_RenderableIndex.erase(it);
+}
+
+/**
+ * @brief 解析一个 mesh（LOD 0 或简化级别）的几何体句柄、顶点格式对应的着色器变体和排序ID
+ */
+bool RenderQueue::ResolveGeometry(const resources::Mesh& mesh, const resources::Shader& shader,
+                                  uint8_t renderPass, LODGeometry& out) {
+    if (!mesh.vertexBuffer) {
+        return false;
+    }
+
+    out.mesh = &mesh;
+    out.vertexBuffer = static_cast<ID3D11Buffer*>(mesh.vertexBuffer);
+    out.indexBuffer = static_cast<ID3D11Buffer*>(mesh.indexBuffer);
+    out.indexFormat = mesh.GetIndexFormat();
+    out.indexCount = mesh.GetIndexCount();
+    out.vertexStride = mesh.GetVertexStride();
+    out.startIndex = mesh.GetStartIndex();
+    out.baseVertex = static_cast<int32_t>(mesh.GetBaseVertex());
+
+    // 顶点着色器/输入布局按 Mesh 的顶点格式选择
+    if (mesh.GetVertexFormat() == resources::VertexFormat::Compact) {
+        if (!shader.SupportsCompactVertices()) {
+            return false;
+        }
+        out.vertexShader = shader.GetCompactVertexShader();
+        out.inputLayout = shader.GetCompactInputLayout();
+        out.instancedVertexShader = shader.GetCompactInstancedVertexShader();
+        out.instancedInputLayout = shader.GetCompactInstancedInputLayout();
+    } else {
+        out.vertexShader = shader.GetVertexShader();
+        out.inputLayout = shader.GetInputLayout();
+        out.instancedVertexShader = shader.GetInstancedVertexShader();
+        out.instancedInputLayout = shader.GetInstancedInputLayout();
+    }
+
+    // === 分配排序ID（跨帧稳定）===
+    // 按 VS + PS 区分：同一 HLSL 的不同像素着色器排列各占一个 ID，排序时聚在一起
+    if (out.vertexShader) {
+        const ShaderKey key{ out.vertexShader, shader.GetPixelShader() };
+        auto it = m_ShaderIDs.find(key);
+        out.shaderId = (it != m_ShaderIDs.end()) ? it->second
+                     : (m_ShaderIDs[key] = static_cast<uint8_t>(m_ShaderIDs.size()));
+    }
+    if (renderPass == 0) {
+        // 相同Mesh排在一起，便于实例化合并（GeometryPool 中的 Mesh 共用 VB，按 Mesh 区分）
+        auto it = m_MeshIDs.find(&mesh);
+        out.meshId = (it != m_MeshIDs.end()) ? it->second
+                   : (m_MeshIDs[&mesh] = static_cast<uint8_t>(m_MeshIDs.size()));
+    }
+    return true;
+}
+
+void RenderQueue::ApplyGeometry(const LODGeometry& geometry, RenderBatch& batch) {
+    batch.vertexBuffer = geometry.vertexBuffer;
+    batch.indexBuffer = geometry.indexBuffer;
+    batch.indexFormat = geometry.indexFormat;
+    batch.indexCount = geometry.indexCount;
+    batch.vertexStride = geometry.vertexStride;
+    batch.vertexOffset = 0;
+    batch.startIndex = geometry.startIndex;
+    batch.baseVertex = geometry.baseVertex;
+    batch.vertexShader = geometry.vertexShader;
+    batch.inputLayout = geometry.inputLayout;
+    batch.instancedVertexShader = geometry.instancedVertexShader;
+    batch.instancedInputLayout = geometry.instancedInputLayout;
+}
+
+/**
+ * @brief 解析单个(子)mesh的GPU资源（Shader选择、SRV提取、排序ID分配、LOD链）
+ */
+bool RenderQueue::BuildCachedBatch(const std::shared_ptr<resources::Mesh>& mesh,
+                                   const std::shared_ptr<resources::Material>& material,
+                                   const components::MeshLODChain* lodChain,
+                                   CachedBatch& out) {
+    out.mesh = mesh.get();
+    out.material = material.get();
+    out.resolved = false;
+    out.fallbackShader = false;
+    out.shaderReloadGeneration = ShaderCompileService::GetInstance().GetReloadGeneration();
+    out.lodLevels.clear();
+    out.lodChainSize = lodChain ? lodChain->GetLevelCount() : 0;
+
+    if (!mesh || !mesh->vertexBuffer) {
+        return false;
+    }
+
+    RenderBatch& batch = out.batch;
+
+    // 获取D3D设备（用于按需加载shader）
+    if (!g_CachedDevice) {
+        static_cast<ID3D11Buffer*>(mesh->vertexBuffer)->GetDevice(&g_CachedDevice);
+    }
+
+    // === Multi-Texture PBR Resource Extraction ===
+    resources::Shader* shaderToUse = nullptr;
+    ID3D11ShaderResourceView* albedoSRV = nullptr;
+    ID3D11ShaderResourceView* normalSRV = nullptr;
+    ID3D11ShaderResourceView* metallicSRV = nullptr;
+    ID3D11ShaderResourceView* roughnessSRV = nullptr;
+    ID3D11ShaderResourceView* emissiveSRV = nullptr;
+
+    if (material) {
+        // Extract all PBR textures from material
+        albedoSRV = static_cast<ID3D11ShaderResourceView*>(material->albedoTextureSRV);
+        normalSRV = static_cast<ID3D11ShaderResourceView*>(material->normalTextureSRV);
+        metallicSRV = static_cast<ID3D11ShaderResourceView*>(material->metallicTextureSRV);
+        roughnessSRV = static_cast<ID3D11ShaderResourceView*>(material->roughnessTextureSRV);
+        emissiveSRV = static_cast<ID3D11ShaderResourceView*>(material->emissiveTextureSRV);
+
+        // Backward compatibility: fallback to old shaderProgram field（只在建立缓存时探测一次）
+        if (!albedoSRV && material->shaderProgram) {
+            void* ptr = material->shaderProgram;
+            ID3D11ShaderResourceView* testSRV = static_cast<ID3D11ShaderResourceView*>(ptr);
+            IUnknown* testUnknown = nullptr;
+
+            HRESULT hr = testSRV->QueryInterface(__uuidof(ID3D11ShaderResourceView), (void**)&testUnknown);
+            if (SUCCEEDED(hr) && testUnknown) {
+                testUnknown->Release();
+                albedoSRV = testSRV;  // Old single-texture path
+            }
+        }
+    }
+
+    // 打包进 TextureArrayAtlas 的材质绑定数组 SRV（层下标在 MaterialBuffer 中）：
+    // 同一数组的材质共享纹理绑定，materialId 按数组分配，排序后相邻
+    const bool textureArray = material && material->packedIntoArrays;
+    if (textureArray) {
+        albedoSRV = static_cast<ID3D11ShaderResourceView*>(material->textureArraySRV[resources::kMaterialAlbedo]);
+        normalSRV = static_cast<ID3D11ShaderResourceView*>(material->textureArraySRV[resources::kMaterialNormal]);
+        metallicSRV = static_cast<ID3D11ShaderResourceView*>(material->textureArraySRV[resources::kMaterialMetallic]);
+        roughnessSRV = static_cast<ID3D11ShaderResourceView*>(material->textureArraySRV[resources::kMaterialRoughness]);
+        emissiveSRV = static_cast<ID3D11ShaderResourceView*>(material->textureArraySRV[resources::kMaterialEmissive]);
+    }
+
+    // Select appropriate shader based on available textures
+    // textured 按材质实际拥有的纹理选择编译期排列（没有的纹理不采样）
+    // 未编译完成的变体先用回退着色器（basic），编译完成后 IsStale 触发重建换上正式版本
+    auto& shaderService = ShaderCompileService::GetInstance();
+    out.shaderGeneration = shaderService.GetGeneration();
+    if (g_CachedDevice) {
+        bool textured = albedoSRV || normalSRV || metallicSRV || roughnessSRV;
+        if (textured) {
+            uint32_t permutation = 0;
+            if (albedoSRV) permutation |= resources::kPermutationAlbedoMap;
+            if (normalSRV) permutation |= resources::kPermutationNormalMap;
+            if (metallicSRV) permutation |= resources::kPermutationMetallicMap;
+            if (roughnessSRV) permutation |= resources::kPermutationRoughnessMap;
+            // 与 MaterialConstants::hasEmissiveTexture 一致：只有发光材质才使用自发光贴图
+            if (emissiveSRV && material->isEmissive) permutation |= resources::kPermutationEmissiveMap;
+            if (mesh->HasVertexColors()) permutation |= resources::kPermutationVertexColor;
+            if (textureArray) permutation |= resources::kPermutationTextureArray;
+            shaderToUse = shaderService.Acquire(g_CachedDevice, "textured.vs", "textured.ps", permutation,
+                                                out.fallbackShader);
         } else {
-            DebugManager::GetInstance().Log("RenderQueue", "Failed to load shader: " + key);
-            return nullptr;
+            shaderToUse = shaderService.Acquire(g_CachedDevice, "basic.vs", "basic.ps", out.fallbackShader);
         }
     }
-    
-    return g_ShaderCache[key].get();
+
+    if (!shaderToUse) {
+        return false;
+    }
+
+    batch.renderPass = (material && material->isTransparent) ? 1 : 0;
+
+    // === GPU资源（LOD 0）===
+    LODGeometry base;
+    if (!ResolveGeometry(*mesh, *shaderToUse, batch.renderPass, base)) {
+        return false;
+    }
+    ApplyGeometry(base, batch);
+    out.shaderId = base.shaderId;
+    out.meshId = base.meshId;
+
+    // === LOD 链：lodLevels[0] 为 LOD 0，之后依次为简化级别（遇到未就绪的级别即截断）===
+    if (out.lodChainSize > 0) {
+        out.lodLevels.push_back(base);
+        for (size_t i = 0; i < out.lodChainSize; i++) {
+            const auto& levelMesh = lodChain->levels[i];
+            LODGeometry level;
+            if (!levelMesh || !ResolveGeometry(*levelMesh, *shaderToUse, batch.renderPass, level)) {
+                break;
+            }
+            level.screenRadius = lodChain->screenRadii[i];
+            out.lodLevels.push_back(level);
+        }
+        if (out.lodLevels.size() < 2) {
+            out.lodLevels.clear();
+        }
+    }
+
+    // 绑定Shader和多纹理到batch
+    batch.pixelShader = shaderToUse->GetPixelShader();
+    batch.albedoTexture = albedoSRV;
+    batch.normalTexture = normalSRV;
+    batch.metallicTexture = metallicSRV;
+    batch.roughnessTexture = roughnessSRV;
+    batch.emissiveTexture = emissiveSRV;
+    batch.material = material.get();
+    batch.isSphere = true;
+
+    // === 分配排序ID（跨帧稳定）===
+    if (batch.albedoTexture) {
+        auto it = m_MaterialIDs.find(batch.albedoTexture);
+        out.materialId = (it != m_MaterialIDs.end()) ? it->second
+                       : (m_MaterialIDs[batch.albedoTexture] = static_cast<uint8_t>(m_MaterialIDs.size()));
+    }
+
+    out.resolved = true;
+    return true;
 }
 
 /**
- * @brief 从ECS收集渲染批次
+ * @brief 按投影半径选择 LOD 级别：变粗立即生效，变细需超过阈值 kLODHysteresis
  */
-void RenderQueue::CollectFromECS(entt::registry& registry, const XMFLOAT3& cameraPos,
-                                  const XMFLOAT3& sunPosition) {
-    Clear();
-    
-    // ID映射表（用于计算sortKey）
-    std::unordered_map<ID3D11VertexShader*, uint8_t> shaderIDs;
-    std::unordered_map<ID3D11ShaderResourceView*, uint8_t> materialIDs;
-    uint8_t nextShaderID = 0;
-    uint8_t nextMaterialID = 0;
-    
-    XMVECTOR camPos = XMLoadFloat3(&cameraPos);
-    
-    auto view = registry.view<components::MeshComponent, TransformComponent>();
-    
-    static int renderDebugFrame = 0;
-    renderDebugFrame++;
-    
-    for (auto entity : view) {
-        auto& meshComp = view.get<components::MeshComponent>(entity);
-        auto& transformComp = view.get<TransformComponent>(entity);
-        
-        // For child entities, use parent's transform instead
-        TransformComponent* effectiveTransform = &transformComp;
-        bool isChildEntity = false;
-        if (auto* childComp = registry.try_get<components::ChildEntityComponent>(entity)) {
-            if (childComp->parent != entt::null && registry.valid(childComp->parent)) {
-                if (auto* parentTransform = registry.try_get<TransformComponent>(childComp->parent)) {
-                    effectiveTransform = parentTransform;
-                    isChildEntity = true;
-                }
+uint8_t RenderQueue::SelectLODLevel(const CachedRenderable& entry, float screenRadius) {
+    const std::vector<LODGeometry>* levels = nullptr;
+    for (const auto& cached : entry.batches) {
+        if (!cached.lodLevels.empty()) {
+            levels = &cached.lodLevels;
+            break;
+        }
+    }
+    if (!levels) return 0;
+
+    size_t level = (std::min)(static_cast<size_t>(entry.lodLevel), levels->size() - 1);
+    while (level + 1 < levels->size() && screenRadius < (*levels)[level + 1].screenRadius) {
+        level++;
+    }
+    while (level > 0 && screenRadius > (*levels)[level].screenRadius * (1.0f + kLODHysteresis)) {
+        level--;
+    }
+    return static_cast<uint8_t>(level);
+}
+
+/**
+ * @brief 重建单个实体的批次模板（组件增删改时调用）
+ */
+void RenderQueue::RebuildRenderable(entt::registry& registry, entt::entity entity) {
+    if (!registry.valid(entity) || !registry.try_get<TransformComponent>(entity)) {
+        RemoveRenderable(entity);
+        return;
+    }
+
+    auto* meshComp = registry.try_get<components::MeshComponent>(entity);
+    auto* multiMesh = registry.try_get<components::MultiMeshComponent>(entity);
+    if (!meshComp && !multiMesh) {
+        RemoveRenderable(entity);
+        return;
+    }
+
+    m_Stats.rebuiltRenderables++;
+
+    CachedRenderable entry;
+    entry.entity = entity;
+
+    const auto* bounds = registry.try_get<components::BoundsComponent>(entity);
+    if (bounds && bounds->IsValid()) {
+        entry.localBounds = BoundingSphere(bounds->localCenter, bounds->localRadius);
+    }
+
+    if (const auto* impostor = registry.try_get<components::ImpostorComponent>(entity)) {
+        entry.hasImpostor = true;
+        entry.impostorScreenRadius = impostor->screenRadius;
+        entry.impostorRadius = impostor->radius;
+    }
+
+    if (meshComp) {
+        CachedBatch cached;
+        BuildCachedBatch(meshComp->mesh, meshComp->material, &meshComp->lod, cached);
+        entry.batches.push_back(cached);
+    }
+
+    if (multiMesh) {
+        bool hasSubBounds = bounds && bounds->subMeshBounds.size() == multiMesh->meshes.size();
+        for (size_t i = 0; i < multiMesh->meshes.size(); i++) {
+            CachedBatch cached;
+            cached.isSubMesh = true;
+            std::shared_ptr<resources::Material> material =
+                (i < multiMesh->materials.size()) ? multiMesh->materials[i] : nullptr;
+            const components::MeshLODChain* lodChain =
+                (i < multiMesh->lods.size()) ? &multiMesh->lods[i] : nullptr;
+            BuildCachedBatch(multiMesh->meshes[i], material, lodChain, cached);
+            if (hasSubBounds) {
+                cached.localBounds = bounds->subMeshBounds[i];
             }
+            entry.batches.push_back(cached);
         }
-        
-        // Debug: 打印渲染时使用的 rotation（只对前几个实体，每60帧一次）
-        
-        
-        // 跳过无效/不可见Mesh
-        if (!meshComp.mesh || !meshComp.mesh->vertexBuffer || !meshComp.isVisible) {
-            continue;
+    }
+
+    for (const auto& cached : entry.batches) {
+        entry.hasLOD = entry.hasLOD || !cached.lodLevels.empty();
+    }
+
+    auto it = m_RenderableIndex.find(entity);
+    if (it != m_RenderableIndex.end()) {
+        m_Renderables[it->second] = std::move(entry);
+    } else {
+        m_RenderableIndex[entity] = m_Renderables.size();
+        m_Renderables.push_back(std::move(entry));
+    }
+}
+
+/**
+ * @brief 检测组件内容是否被直接替换（未通过 patch/replace 触发信号）
+ */
+bool RenderQueue::IsStale(entt::registry& registry, const CachedRenderable& entry) const {
+    if (!registry.valid(entry.entity)) {
+        return true;
+    }
+
+    auto* meshComp = registry.try_get<components::MeshComponent>(entry.entity);
+    auto* multiMesh = registry.try_get<components::MultiMeshComponent>(entry.entity);
+    size_t expected = (meshComp ? 1 : 0) + (multiMesh ? multiMesh->meshes.size() : 0);
+    if (expected != entry.batches.size()) {
+        return true;
+    }
+
+    // 资源未就绪的批次：只有当VB和设备都可用时才值得重试
+    // 使用回退着色器的批次：有异步编译完成时重试
+    // 着色器热重载后：所有批次都换上新版本（旧着色器对象即将释放）
+    const uint32_t shaderGeneration = ShaderCompileService::GetInstance().GetGeneration();
+    const uint32_t reloadGeneration = ShaderCompileService::GetInstance().GetReloadGeneration();
+    auto needsRetry = [shaderGeneration, reloadGeneration](const CachedBatch& cached) {
+        return (!cached.resolved && cached.mesh && cached.mesh->vertexBuffer) ||
+               (cached.fallbackShader && cached.shaderGeneration != shaderGeneration) ||
+               cached.shaderReloadGeneration != reloadGeneration;
+    };
+
+    size_t index = 0;
+    if (meshComp) {
+        const CachedBatch& cached = entry.batches[index++];
+        if (cached.mesh != meshComp->mesh.get() || cached.material != meshComp->material.get() ||
+            cached.lodChainSize != meshComp->lod.GetLevelCount() || needsRetry(cached)) {
+            return true;
         }
-        
-        // 构建RenderBatch
-        RenderBatch batch;
-        
-        // === GPU资源 ===
-        batch.vertexBuffer = static_cast<ID3D11Buffer*>(meshComp.mesh->vertexBuffer);
-        batch.indexBuffer = static_cast<ID3D11Buffer*>(meshComp.mesh->indexBuffer);
-        batch.indexCount = meshComp.mesh->GetIndexCount();
-        batch.vertexStride = sizeof(resources::Vertex);
-        batch.vertexOffset = 0;
-        
-        // 获取D3D设备（用于按需加载shader）
-        if (!g_CachedDevice && batch.vertexBuffer) {
-            batch.vertexBuffer->GetDevice(&g_CachedDevice);
-        }
-        
-        // === Multi-Texture PBR Resource Extraction ===
-        resources::Shader* shaderToUse = nullptr;
-        ID3D11ShaderResourceView* albedoSRV = nullptr;
-        ID3D11ShaderResourceView* normalSRV = nullptr;
-        ID3D11ShaderResourceView* metallicSRV = nullptr;
-        ID3D11ShaderResourceView* roughnessSRV = nullptr;
-        ID3D11ShaderResourceView* emissiveSRV = nullptr;
-        
-        if (meshComp.material) {
-            // Extract all PBR textures from material
-            albedoSRV = static_cast<ID3D11ShaderResourceView*>(meshComp.material->albedoTextureSRV);
-            normalSRV = static_cast<ID3D11ShaderResourceView*>(meshComp.material->normalTextureSRV);
-            metallicSRV = static_cast<ID3D11ShaderResourceView*>(meshComp.material->metallicTextureSRV);
-            roughnessSRV = static_cast<ID3D11ShaderResourceView*>(meshComp.material->roughnessTextureSRV);
-            emissiveSRV = static_cast<ID3D11ShaderResourceView*>(meshComp.material->emissiveTextureSRV);
-            
-            // Backward compatibility: fallback to old shaderProgram field
-            if (!albedoSRV && meshComp.material->shaderProgram) {
-                void* ptr = meshComp.material->shaderProgram;
-                ID3D11ShaderResourceView* testSRV = static_cast<ID3D11ShaderResourceView*>(ptr);
-                IUnknown* testUnknown = nullptr;
-                
-                HRESULT hr = testSRV->QueryInterface(__uuidof(ID3D11ShaderResourceView), (void**)&testUnknown);
-                if (SUCCEEDED(hr) && testUnknown) {
-                    testUnknown->Release();
-                    albedoSRV = testSRV;  // Old single-texture path
-                }
+    }
+    if (multiMesh) {
+        for (size_t i = 0; i < multiMesh->meshes.size(); i++) {
+            const CachedBatch& cached = entry.batches[index++];
+            const resources::Material* material =
+                (i < multiMesh->materials.size()) ? multiMesh->materials[i].get() : nullptr;
+            size_t lodChainSize = (i < multiMesh->lods.size()) ? multiMesh->lods[i].GetLevelCount() : 0;
+            if (cached.mesh != multiMesh->meshes[i].get() || cached.material != material ||
+                cached.lodChainSize != lodChainSize || needsRetry(cached)) {
+                return true;
             }
-            
-            // Select appropriate shader based on available textures
-            if (g_CachedDevice) {
-                if (albedoSRV || normalSRV || metallicSRV || roughnessSRV) {
-                    shaderToUse = GetOrLoadShader("textured.vs", "textured.ps", g_CachedDevice);
-                } else {
-                    shaderToUse = GetOrLoadShader("basic.vs", "basic.ps", g_CachedDevice);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 刷新 [begin, end) 内实体的变换并输出可见批次
+ *
+ * 只读访问 registry，只写本范围内的缓存条目和传入的输出数组，可在多个线程上并发调用。
+ */
+void RenderQueue::CollectRange(entt::registry& registry, size_t begin, size_t end,
+                               const XMFLOAT3& cameraPos, const XMFLOAT3& sunPosition, bool sunMoved,
+                               const BoundingFrustum* frustum, const OcclusionCuller* occlusion,
+                               std::vector<RenderBatch>& outBatches, std::vector<ImpostorInstance>& outImpostors,
+                               RenderStats& stats) {
+    XMVECTOR camPos = XMLoadFloat3(&cameraPos);
+
+    for (size_t index = begin; index < end; index++) {
+        CachedRenderable& entry = m_Renderables[index];
+        entry.visibleScreenRadius = 0.0f;
+        // 层级子实体的 Transform 已由 TransformSystem 从父实体推导，这里只读自身的
+        const TransformComponent* transform = registry.try_get<TransformComponent>(entry.entity);
+        if (!transform) continue;
+
+        // === 只有 Transform 实际变化才刷新世界矩阵和包围球 ===
+        // 矩阵由 TransformSystem 在渲染前统一重算，这里只比较版本号
+        bool moved = !entry.hasSnapshot || transform->version != entry.lastTransformVersion;
+
+        if (moved) {
+            XMMATRIX world = transform->GetCachedWorldMatrix();
+
+            for (auto& cached : entry.batches) {
+                cached.batch.worldMatrix = world;
+                if (cached.localBounds.Radius > 0.0f) {
+                    cached.worldBounds = components::BoundsComponent::ToWorld(
+                        cached.localBounds.Center, cached.localBounds.Radius,
+                        transform->position, transform->rotation, transform->scale);
                 }
             }
-        }
-        
-        // Fallback to basic shader if no material
-        if (!shaderToUse && g_CachedDevice) {
-            shaderToUse = GetOrLoadShader("basic.vs", "basic.ps", g_CachedDevice);
-        }
-        
-        // 绑定Shader和多纹理到batch
-        if (shaderToUse) {
-            batch.vertexShader = shaderToUse->GetVertexShader();
-            batch.pixelShader = shaderToUse->GetPixelShader();
-            batch.inputLayout = shaderToUse->GetInputLayout();
-            batch.albedoTexture = albedoSRV;
-            batch.normalTexture = normalSRV;
-            batch.metallicTexture = metallicSRV;
-            batch.roughnessTexture = roughnessSRV;
-            batch.emissiveTexture = emissiveSRV;
-            batch.material = meshComp.material.get();
-            
-            // 分配Shader ID
-            if (batch.vertexShader && shaderIDs.find(batch.vertexShader) == shaderIDs.end()) {
-                shaderIDs[batch.vertexShader] = nextShaderID++;
+            if (entry.localBounds.Radius > 0.0f) {
+                entry.worldBounds = components::BoundsComponent::ToWorld(
+                    entry.localBounds.Center, entry.localBounds.Radius,
+                    transform->position, transform->rotation, transform->scale);
             }
-            
-            // 分配Material ID（基于albedo纹理）
-            if (batch.albedoTexture && materialIDs.find(batch.albedoTexture) == materialIDs.end()) {
-                materialIDs[batch.albedoTexture] = nextMaterialID++;
+
+            entry.lastTransformVersion = transform->version;
+            entry.hasSnapshot = true;
+            stats.transformUpdates++;
+        }
+
+        // === 计算光照方向（物体或太阳移动时）===
+        if (moved || sunMoved) {
+            // lightDir = normalize(sunPosition - objectPosition)
+            float dx = sunPosition.x - transform->position.x;
+            float dy = sunPosition.y - transform->position.y;
+            float dz = sunPosition.z - transform->position.z;
+            float dist = sqrtf(dx*dx + dy*dy + dz*dz);
+
+            // 无效（太阳自身）：使用默认向上方向
+            XMFLOAT3 lightDir = (dist > 1.0f) ? XMFLOAT3(dx / dist, dy / dist, dz / dist) : XMFLOAT3(0.0f, 1.0f, 0.0f);
+            for (auto& cached : entry.batches) {
+                cached.batch.lightDir = lightDir;
             }
-        } else {
-            // 没有有效shader，跳过此entity
+        }
+
+        auto* meshComp = registry.try_get<components::MeshComponent>(entry.entity);
+        auto* multiMesh = registry.try_get<components::MultiMeshComponent>(entry.entity);
+        bool meshVisible = meshComp && meshComp->isVisible;
+        bool multiVisible = multiMesh && multiMesh->isVisible;
+        if (!meshVisible && !multiVisible) continue;
+
+        // === 视锥剔除（整体）===
+        if (frustum && entry.localBounds.Radius > 0.0f && !frustum->Intersects(entry.worldBounds)) {
+            stats.culledObjects += static_cast<uint32_t>(entry.batches.size());
             continue;
         }
-        
-        // === 变换矩阵 ===
-        XMMATRIX translation = XMMatrixTranslation(
-            effectiveTransform->position.x,
-            effectiveTransform->position.y,
-            effectiveTransform->position.z
-        );
-        XMMATRIX rotation = XMMatrixRotationQuaternion(XMLoadFloat4(&effectiveTransform->rotation));
-        XMMATRIX scale = XMMatrixScaling(
-            effectiveTransform->scale.x,
-            effectiveTransform->scale.y,
-            effectiveTransform->scale.z
-        );
-        batch.worldMatrix = scale * rotation * translation;
-        
-        // === 计算光照方向 ===
-        // lightDir = normalize(sunPosition - objectPosition)
-        float dx = sunPosition.x - effectiveTransform->position.x;
-        float dy = sunPosition.y - effectiveTransform->position.y;
-        float dz = sunPosition.z - effectiveTransform->position.z;
-        float dist = sqrtf(dx*dx + dy*dy + dz*dz);
-        
-        if (dist > 1.0f) {
-            // 有效：归一化光照方向
-            batch.lightDir = { dx / dist, dy / dist, dz / dist };
-        } else {
-            // 无效（太阳自身）：使用默认向上方向
-            batch.lightDir = { 0.0f, 1.0f, 0.0f };
+
+        // === 遮挡剔除（星球背面的实体）===
+        if (occlusion && entry.localBounds.Radius > 0.0f && occlusion->IsOccluded(entry.worldBounds)) {
+            stats.occludedObjects += static_cast<uint32_t>(entry.batches.size());
+            continue;
         }
-        batch.isSphere = true;
-        
-        // === 计算深度 ===
-        XMVECTOR objPos = XMLoadFloat3(&effectiveTransform->position);
+
+        // === 计算深度（依赖相机，每帧刷新）===
+        XMVECTOR objPos = XMLoadFloat3(&transform->position);
         XMVECTOR delta = XMVectorSubtract(objPos, camPos);
         float distanceSquared = XMVectorGetX(XMVector3LengthSq(delta));
         uint16_t depth = static_cast<uint16_t>((std::min)(distanceSquared, 65535.0f));
-        
-        // === 计算排序键 ===
-        batch.renderPass = (meshComp.material && meshComp.material->isTransparent) ? 1 : 0;
-        uint8_t shaderID = batch.vertexShader ? shaderIDs[batch.vertexShader] : 0;
-        uint8_t matID = batch.albedoTexture ? materialIDs[batch.albedoTexture] : 0;
-        batch.CalculateSortKey(shaderID, matID, depth);
-        
-        m_Batches.push_back(batch);
-    }
-    
-    // === 处理 MultiMeshComponent（多材质模型） ===
-    auto multiView = registry.view<components::MultiMeshComponent, TransformComponent>();
-    for (auto entity : multiView) {
-        auto& multiMesh = multiView.get<components::MultiMeshComponent>(entity);
-        auto& transformComp = multiView.get<TransformComponent>(entity);
-        
-        if (!multiMesh.isVisible) continue;
-        
-        // 为每个子 mesh 创建 batch
-        for (size_t i = 0; i < multiMesh.meshes.size(); i++) {
-            auto& mesh = multiMesh.meshes[i];
-            auto& material = (i < multiMesh.materials.size()) ? multiMesh.materials[i] : nullptr;
-            
-            if (!mesh || !mesh->vertexBuffer) continue;
-            
-            RenderBatch batch;
-            
-            // === GPU资源 ===
-            batch.vertexBuffer = static_cast<ID3D11Buffer*>(mesh->vertexBuffer);
-            batch.indexBuffer = static_cast<ID3D11Buffer*>(mesh->indexBuffer);
-            batch.indexCount = mesh->GetIndexCount();
-            batch.vertexStride = sizeof(resources::Vertex);
-            batch.vertexOffset = 0;
-            
-            // 获取D3D设备
-            if (!g_CachedDevice && batch.vertexBuffer) {
-                batch.vertexBuffer->GetDevice(&g_CachedDevice);
+        const bool frontToBack = m_SortMode == SortMode::FrontToBack;
+        const uint8_t depthBand = frontToBack ? DepthBand(distanceSquared) : 0;
+        auto assignSortKey = [&](RenderBatch& batch, uint8_t shaderId, uint8_t materialId, uint8_t meshId) {
+            if (frontToBack) {
+                batch.CalculateFrontToBackSortKey(shaderId, materialId, depthBand, depth, meshId);
+            } else {
+                batch.CalculateSortKey(shaderId, materialId, depth, meshId);
             }
-            
-            // === 纹理和 Shader ===
-            resources::Shader* shaderToUse = nullptr;
-            ID3D11ShaderResourceView* albedoSRV = nullptr;
-            ID3D11ShaderResourceView* normalSRV = nullptr;
-            ID3D11ShaderResourceView* metallicSRV = nullptr;
-            ID3D11ShaderResourceView* roughnessSRV = nullptr;
-            ID3D11ShaderResourceView* emissiveSRV = nullptr;
-            
-            if (material) {
-                albedoSRV = static_cast<ID3D11ShaderResourceView*>(material->albedoTextureSRV);
-                normalSRV = static_cast<ID3D11ShaderResourceView*>(material->normalTextureSRV);
-                metallicSRV = static_cast<ID3D11ShaderResourceView*>(material->metallicTextureSRV);
-                roughnessSRV = static_cast<ID3D11ShaderResourceView*>(material->roughnessTextureSRV);
-                emissiveSRV = static_cast<ID3D11ShaderResourceView*>(material->emissiveTextureSRV);
-                
-                // Fallback to old shaderProgram
-                if (!albedoSRV && material->shaderProgram) {
-                    albedoSRV = static_cast<ID3D11ShaderResourceView*>(material->shaderProgram);
+        };
+
+        // === 包围球投影半径（占半个视口高度的比例），LOD 和替身共用 ===
+        float screenRadius = FLT_MAX;
+        if (entry.localBounds.Radius > 0.0f) {
+            float distance = XMVectorGetX(XMVector3Length(
+                XMVectorSubtract(XMLoadFloat3(&entry.worldBounds.Center), camPos)));
+            float slope = frustum ? frustum->TopSlope : kDefaultTopSlope;
+            screenRadius = entry.worldBounds.Radius / ((std::max)(distance, 1e-3f) * slope);
+        }
+
+        // === 替身：足够小的天体整体替换为一个实例 ===
+        if (entry.hasImpostor) {
+            if (!m_ImpostorsEnabled) {
+                entry.usingImpostor = false;
+            } else if (entry.usingImpostor) {
+                entry.usingImpostor = screenRadius <= entry.impostorScreenRadius * (1.0f + kLODHysteresis);
+            } else {
+                entry.usingImpostor = screenRadius < entry.impostorScreenRadius;
+            }
+
+            if (entry.usingImpostor) {
+                const CachedBatch* source = nullptr;
+                for (const auto& cached : entry.batches) {
+                    if (cached.resolved && (cached.isSubMesh ? multiVisible : meshVisible)) {
+                        source = &cached;
+                        break;
+                    }
                 }
-                
-                if (g_CachedDevice) {
-                    if (albedoSRV || normalSRV || metallicSRV || roughnessSRV) {
-                        shaderToUse = GetOrLoadShader("textured.vs", "textured.ps", g_CachedDevice);
-                    } else {
-                        shaderToUse = GetOrLoadShader("basic.vs", "basic.ps", g_CachedDevice);
+                if (source) {
+                    ImpostorInstance impostor;
+                    impostor.center = entry.worldBounds.Center;
+                    impostor.radius = entry.impostorRadius > 0.0f ? entry.impostorRadius : entry.worldBounds.Radius;
+                    impostor.lightDir = source->batch.lightDir;
+                    impostor.albedoTexture = source->batch.albedoTexture;
+                    if (source->batch.material && source->batch.material->packedIntoArrays) {
+                        // 调色板着色器采样 Texture2D：用材质的独立贴图而不是图集数组
+                        impostor.albedoTexture =
+                            static_cast<ID3D11ShaderResourceView*>(source->batch.material->albedoTextureSRV);
                     }
+                    if (const resources::Material* material = source->batch.material) {
+                        impostor.emissive = material->isEmissive;
+                        impostor.color = material->albedo;
+                        if (material->isEmissive) {
+                            impostor.color = XMFLOAT4(material->emissiveColor.x * material->emissiveStrength,
+                                                      material->emissiveColor.y * material->emissiveStrength,
+                                                      material->emissiveColor.z * material->emissiveStrength, 1.0f);
+                        }
+                    }
+                    outImpostors.push_back(impostor);
+                    stats.impostorObjects++;
+                    stats.visibleObjects += static_cast<uint32_t>(entry.batches.size());
+                    continue;
                 }
             }
-            
-            if (!shaderToUse && g_CachedDevice) {
-                shaderToUse = GetOrLoadShader("basic.vs", "basic.ps", g_CachedDevice);
-            }
-            
-            if (!shaderToUse) continue;
-            
-            batch.vertexShader = shaderToUse->GetVertexShader();
-            batch.pixelShader = shaderToUse->GetPixelShader();
-            batch.inputLayout = shaderToUse->GetInputLayout();
-            batch.albedoTexture = albedoSRV;
-            batch.normalTexture = normalSRV;
-            batch.metallicTexture = metallicSRV;
-            batch.roughnessTexture = roughnessSRV;
-            batch.emissiveTexture = emissiveSRV;
-            batch.material = material.get();
-            
-            // === 变换矩阵 ===
-            XMMATRIX translation = XMMatrixTranslation(
-                transformComp.position.x,
-                transformComp.position.y,
-                transformComp.position.z
-            );
-            XMMATRIX rotation = XMMatrixRotationQuaternion(XMLoadFloat4(&transformComp.rotation));
-            XMMATRIX scale = XMMatrixScaling(
-                transformComp.scale.x,
-                transformComp.scale.y,
-                transformComp.scale.z
-            );
-            batch.worldMatrix = scale * rotation * translation;
-            
-            // === 光照方向 ===
-            float dx = sunPosition.x - transformComp.position.x;
-            float dy = sunPosition.y - transformComp.position.y;
-            float dz = sunPosition.z - transformComp.position.z;
-            float dist = sqrtf(dx*dx + dy*dy + dz*dz);
-            if (dist > 1.0f) {
-                batch.lightDir = { dx / dist, dy / dist, dz / dist };
+        }
+
+        entry.visibleScreenRadius = screenRadius;
+
+        // === LOD 选择 ===
+        if (entry.hasLOD) {
+            if (m_LODEnabled && entry.localBounds.Radius > 0.0f) {
+                entry.lodLevel = SelectLODLevel(entry, screenRadius);
             } else {
-                batch.lightDir = { 0.0f, 1.0f, 0.0f };
+                entry.lodLevel = 0;
+            }
+        }
+
+        for (auto& cached : entry.batches) {
+            if (!cached.resolved) continue;
+            if (cached.isSubMesh ? !multiVisible : !meshVisible) continue;
+
+            // === 视锥剔除（子 mesh）===
+            if (frustum && cached.isSubMesh && cached.localBounds.Radius > 0.0f &&
+                !frustum->Intersects(cached.worldBounds)) {
+                stats.culledObjects++;
+                continue;
             }
-            batch.isSphere = true;
-            
-            // === 深度和排序键 ===
-            XMVECTOR objPos = XMLoadFloat3(&transformComp.position);
-            XMVECTOR delta = XMVectorSubtract(objPos, camPos);
-            float distanceSquared = XMVectorGetX(XMVector3LengthSq(delta));
-            uint16_t depth = static_cast<uint16_t>((std::min)(distanceSquared, 65535.0f));
-            
-            batch.renderPass = (material && material->isTransparent) ? 1 : 0;
-            
-            if (batch.vertexShader && shaderIDs.find(batch.vertexShader) == shaderIDs.end()) {
-                shaderIDs[batch.vertexShader] = nextShaderID++;
+            if (occlusion && cached.isSubMesh && cached.localBounds.Radius > 0.0f &&
+                occlusion->IsOccluded(cached.worldBounds)) {
+                stats.occludedObjects++;
+                continue;
             }
-            if (batch.albedoTexture && materialIDs.find(batch.albedoTexture) == materialIDs.end()) {
-                materialIDs[batch.albedoTexture] = nextMaterialID++;
+            stats.visibleObjects++;
+            cached.batch.receiveShadows = cached.isSubMesh ? multiMesh->receiveShadows : meshComp->receiveShadows;
+
+            if (!cached.lodLevels.empty()) {
+                size_t level = (std::min)(static_cast<size_t>(entry.lodLevel), cached.lodLevels.size() - 1);
+                const LODGeometry& geometry = cached.lodLevels[level];
+                RenderBatch batch = cached.batch;
+                ApplyGeometry(geometry, batch);
+                assignSortKey(batch, geometry.shaderId, cached.materialId, geometry.meshId);
+                outBatches.push_back(batch);
+                if (level > 0) stats.reducedLODObjects++;
+                continue;
             }
-            
-            uint8_t shaderID = batch.vertexShader ? shaderIDs[batch.vertexShader] : 0;
-            uint8_t matID = batch.albedoTexture ? materialIDs[batch.albedoTexture] : 0;
-            batch.CalculateSortKey(shaderID, matID, depth);
-            
-            m_Batches.push_back(batch);
+
+            assignSortKey(cached.batch, cached.shaderId, cached.materialId, cached.meshId);
+            outBatches.push_back(cached.batch);
         }
     }
-    
+}
+
+uint8_t RenderQueue::DepthBand(float distanceSquared) {
+    // 6 * log2(d^2) = 12 * log2(d)：1m → 0，1000m → 120，约 1e6m 饱和
+    float band = 6.0f * std::log2((std::max)(distanceSquared, 1.0f));
+    return static_cast<uint8_t>((std::min)(band, 255.0f));
+}
+
+/**
+ * @brief 从ECS收集渲染批次（保留模式：只刷新变化的部分）
+ */
+void RenderQueue::CollectFromECS(entt::registry& registry, const XMFLOAT3& cameraPos,
+                                  const XMFLOAT3& sunPosition, const BoundingFrustum* frustum,
+                                  const OcclusionCuller* occlusion) {
+    Clear();
+
+    if (m_Registry != &registry) {
+        ConnectRegistry(registry);
+    }
+
+    // === 1. 检测被直接替换的组件（指针比较，无资源查询）===
+    for (const auto& entry : m_Renderables) {
+        if (IsStale(registry, entry)) {
+            m_PendingRebuild.push_back(entry.entity);
+        }
+    }
+
+    // === 2. 重建待处理实体 ===
+    if (!m_PendingRebuild.empty()) {
+        std::sort(m_PendingRebuild.begin(), m_PendingRebuild.end());
+        m_PendingRebuild.erase(std::unique(m_PendingRebuild.begin(), m_PendingRebuild.end()), m_PendingRebuild.end());
+        for (auto entity : m_PendingRebuild) {
+            RebuildRenderable(registry, entity);
+        }
+        m_PendingRebuild.clear();
+    }
+    m_Stats.cachedRenderables = static_cast<uint32_t>(m_Renderables.size());
+
+    bool sunMoved = sunPosition.x != m_LastSunPosition.x ||
+                    sunPosition.y != m_LastSunPosition.y ||
+                    sunPosition.z != m_LastSunPosition.z;
+    m_LastSunPosition = sunPosition;
+
+    // === 3. 刷新变换并输出可见批次（实体数足够多时分块并行）===
+    const size_t count = m_Renderables.size();
+    if (!m_ParallelCollect || count < kParallelCollectThreshold) {
+        CollectRange(registry, 0, count, cameraPos, sunPosition, sunMoved, frustum, occlusion, m_Batches, m_Impostors, m_Stats);
+    } else {
+        // 每个块独占一段 m_Renderables，写入各自的批次数组和统计，互不共享
+        const size_t workerCount = (std::max)(1u, std::thread::hardware_concurrency());
+        const size_t chunkCount = (std::min)(workerCount * 2, (count + kParallelCollectChunk - 1) / kParallelCollectChunk);
+        const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+        m_CollectChunks.resize(chunkCount);
+        for (size_t i = 0; i < chunkCount; i++) {
+            CollectChunk& chunk = m_CollectChunks[i];
+            chunk.begin = i * chunkSize;
+            chunk.end = (std::min)(count, chunk.begin + chunkSize);
+            chunk.batches.clear();
+            chunk.impostors.clear();
+            chunk.stats = RenderStats{};
+        }
+
+        std::for_each(std::execution::par, m_CollectChunks.begin(), m_CollectChunks.end(),
+            [&](CollectChunk& chunk) {
+                CollectRange(registry, chunk.begin, chunk.end, cameraPos, sunPosition, sunMoved, frustum, occlusion,
+                             chunk.batches, chunk.impostors, chunk.stats);
+            });
+
+        // 按块顺序合并（Sort 之前，结果与串行一致）
+        size_t total = 0;
+        for (const auto& chunk : m_CollectChunks) total += chunk.batches.size();
+        m_Batches.reserve(total);
+        for (auto& chunk : m_CollectChunks) {
+            m_Batches.insert(m_Batches.end(), chunk.batches.begin(), chunk.batches.end());
+            m_Impostors.insert(m_Impostors.end(), chunk.impostors.begin(), chunk.impostors.end());
+            m_Stats.visibleObjects += chunk.stats.visibleObjects;
+            m_Stats.culledObjects += chunk.stats.culledObjects;
+            m_Stats.occludedObjects += chunk.stats.occludedObjects;
+            m_Stats.reducedLODObjects += chunk.stats.reducedLODObjects;
+            m_Stats.impostorObjects += chunk.stats.impostorObjects;
+            m_Stats.transformUpdates += chunk.stats.transformUpdates;
+        }
+    }
+
     m_Stats.totalBatches = static_cast<uint32_t>(m_Batches.size());
-    
-    // === 调试（已禁用）===
-    // static int collectCount = 0;
-    // if (collectCount++ < 5) {
-    //     DebugManager::GetInstance().Log("RenderQueue::Collect", ...);
-    // }
+}
+
+void RenderQueue::UpdateTextureStreaming() {
+    auto& streamer = resources::TextureStreamer::GetInstance();
+    if (!streamer.HasTextures()) {
+        return;
+    }
+
+    for (const auto& entry : m_Renderables) {
+        if (entry.visibleScreenRadius <= 0.0f) continue;
+        for (const auto& cached : entry.batches) {
+            if (!cached.resolved) continue;
+            const RenderBatch& batch = cached.batch;
+            streamer.Request(batch.albedoTexture, entry.visibleScreenRadius);
+            streamer.Request(batch.normalTexture, entry.visibleScreenRadius);
+            streamer.Request(batch.metallicTexture, entry.visibleScreenRadius);
+            streamer.Request(batch.roughnessTexture, entry.visibleScreenRadius);
+            streamer.Request(batch.emissiveTexture, entry.visibleScreenRadius);
+        }
+    }
+
+    // 排序 / 实例化仍按基础 SRV 进行（materialId 已在批次模板中分配），换成高分辨率级别不影响合并
+    for (auto& batch : m_Batches) {
+        batch.albedoTexture = streamer.Resolve(batch.albedoTexture);
+        batch.normalTexture = streamer.Resolve(batch.normalTexture);
+        batch.metallicTexture = streamer.Resolve(batch.metallicTexture);
+        batch.roughnessTexture = streamer.Resolve(batch.roughnessTexture);
+        batch.emissiveTexture = streamer.Resolve(batch.emissiveTexture);
+    }
+}
+
+/**
+ * @brief 收集级联投射体内的阴影投射者（只读缓存，世界矩阵已由本帧的 CollectFromECS 刷新）
+ */
+void RenderQueue::CollectShadowCasters(const BoundingOrientedBox& volume, std::vector<ShadowCaster>& out) const {
+    if (!m_Registry) {
+        return;
+    }
+    entt::registry& registry = *m_Registry;
+
+    for (const auto& entry : m_Renderables) {
+        if (!entry.hasSnapshot || entry.usingImpostor) continue;
+
+        auto* meshComp = registry.try_get<components::MeshComponent>(entry.entity);
+        auto* multiMesh = registry.try_get<components::MultiMeshComponent>(entry.entity);
+        bool meshCasts = meshComp && meshComp->isVisible && meshComp->castsShadows;
+        bool multiCasts = multiMesh && multiMesh->isVisible && multiMesh->castsShadows;
+        if (!meshCasts && !multiCasts) continue;
+
+        if (entry.localBounds.Radius > 0.0f && !volume.Intersects(entry.worldBounds)) continue;
+
+        for (const auto& cached : entry.batches) {
+            if (!cached.resolved || cached.batch.renderPass != 0) continue;
+            if (cached.isSubMesh ? !multiCasts : !meshCasts) continue;
+            if (cached.isSubMesh && cached.localBounds.Radius > 0.0f && !volume.Intersects(cached.worldBounds)) continue;
+
+            const RenderBatch& batch = cached.batch;
+            ShadowCaster caster;
+            caster.vertexBuffer = batch.vertexBuffer;
+            caster.indexBuffer = batch.indexBuffer;
+            caster.indexFormat = batch.indexFormat;
+            caster.indexCount = batch.indexCount;
+            caster.vertexStride = batch.vertexStride;
+            caster.startIndex = batch.startIndex;
+            caster.baseVertex = batch.baseVertex;
+            caster.instancedInputLayout = batch.instancedInputLayout;
+            if (!cached.lodLevels.empty()) {
+                const LODGeometry& geometry =
+                    cached.lodLevels[(std::min)(static_cast<size_t>(entry.lodLevel), cached.lodLevels.size() - 1)];
+                caster.vertexBuffer = geometry.vertexBuffer;
+                caster.indexBuffer = geometry.indexBuffer;
+                caster.indexFormat = geometry.indexFormat;
+                caster.indexCount = geometry.indexCount;
+                caster.vertexStride = geometry.vertexStride;
+                caster.startIndex = geometry.startIndex;
+                caster.baseVertex = geometry.baseVertex;
+                caster.instancedInputLayout = geometry.instancedInputLayout;
+            }
+            if (!caster.vertexBuffer || !caster.indexBuffer || !caster.instancedInputLayout) continue;
+
+            XMStoreFloat4x4(&caster.world, batch.worldMatrix);
+            out.push_back(caster);
+        }
+    }
+}
+
+/**
+ * @brief LSD 基数排序（8 位一趟，共 8 趟；所有键在某一字节上相同则跳过该趟）
+ *
+ * 排序键的 Reserved 位恒为 0、Pass 位通常也只有一两种取值，
+ * 实际大多只需 5~6 趟。每趟稳定，因此相同键保持提交顺序。
+ */
+void RenderQueue::RadixSortEntries(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) {
+    const size_t count = entries.size();
+    scratch.resize(count);
+
+    // 一次遍历统计所有 8 个字节的直方图
+    uint32_t histograms[8][256] = {};
+    for (const auto& entry : entries) {
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(entry.key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    SortEntry* src = entries.data();
+    SortEntry* dst = scratch.data();
+    for (int pass = 0; pass < 8; pass++) {
+        uint32_t* histogram = histograms[pass];
+        const uint32_t firstDigit = static_cast<uint32_t>(src[0].key >> (pass * 8)) & 0xFF;
+        if (histogram[firstDigit] == count) {
+            continue;  // 该字节所有键相同，排列不变
+        }
+
+        // 前缀和 → 每个桶的起始位置
+        uint32_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            uint32_t bucketSize = histogram[digit];
+            histogram[digit] = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            const uint32_t digit = static_cast<uint32_t>(src[i].key >> (pass * 8)) & 0xFF;
+            dst[histogram[digit]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    // 奇数趟后结果在 scratch 中
+    if (src != entries.data()) {
+        entries.swap(scratch);
+    }
+}
+
+/**
+ * @brief 排序批次：只移动 16 字节的 (key, index)，不移动 RenderBatch
+ */
+void RenderQueue::Sort() {
+    const uint32_t count = static_cast<uint32_t>(m_Batches.size());
+    m_SortEntries.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        m_SortEntries[i].key = m_Batches[i].sortKey;
+        m_SortEntries[i].index = i;
+    }
+
+    if (count < kRadixSortThreshold) {
+        // 批次很少时直方图开销（8x256）大于收益
+        std::stable_sort(m_SortEntries.begin(), m_SortEntries.end(),
+            [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+    } else {
+        RadixSortEntries(m_SortEntries, m_SortScratch);
+    }
+
+    m_SortOrder.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        m_SortOrder[i] = m_SortEntries[i].index;
+    }
+}
+
+void RenderQueue::EnsureSortOrder() {
+    if (m_SortOrder.size() == m_Batches.size()) {
+        return;
+    }
+    m_SortOrder.resize(m_Batches.size());
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_SortOrder.size()); i++) {
+        m_SortOrder[i] = i;
+    }
+}
+
+/**
+ * @brief 填充整帧逐对象数据并划分绘制组（排序后相邻且可合并的批次 → 一次实例化绘制）
+ *
+ * 对象下标 == 排序后位置，因此组内对象在结构化缓冲区中连续，
+ * StartInstanceLocation 直接取 group.firstBatch。
+ */
+void RenderQueue::BuildDrawGroups() {
+    m_DrawGroups.clear();
+    EnsureSortOrder();
+
+    const uint32_t batchCount = static_cast<uint32_t>(m_Batches.size());
+    m_ObjectData.resize(batchCount);
+    for (uint32_t k = 0; k < batchCount; k++) {
+        const RenderBatch& batch = SortedBatch(k);
+        ObjectData& obj = m_ObjectData[k];
+        XMStoreFloat4x4(&obj.world, batch.worldMatrix);  // 行主序，HLSL 中声明为 row_major
+        obj.color = batch.material ? batch.material->albedo : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        obj.lightDir = batch.lightDir;
+        obj.isSphere = batch.isSphere ? 1.0f : 0.0f;
+        obj.receiveShadows = batch.receiveShadows ? 1.0f : 0.0f;
+        obj.padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    }
+
+    uint32_t i = 0;
+    while (i < batchCount) {
+        uint32_t end = i + 1;
+        if (m_InstancingEnabled) {
+            while (end < batchCount && SortedBatch(i).CanInstanceWith(SortedBatch(end))) {
+                end++;
+            }
+        }
+
+        if (end - i >= kMinInstanceCount) {
+            DrawGroup group;
+            group.firstBatch = i;
+            group.batchCount = end - i;
+            group.instanced = true;
+            m_DrawGroups.push_back(group);
+        } else {
+            // 数量不足，逐个绘制
+            for (uint32_t k = i; k < end; k++) {
+                DrawGroup group;
+                group.firstBatch = k;
+                m_DrawGroups.push_back(group);
+            }
+        }
+        i = end;
+    }
+}
+
+/**
+ * @brief 上传整帧逐对象数据（一次Map WRITE_DISCARD）
+ */
+bool RenderQueue::UploadObjectData(ID3D11DeviceContext* context) {
+    if (m_ObjectData.empty()) {
+        return false;
+    }
+    if (!g_CachedDevice) {
+        return false;
+    }
+
+    const uint32_t required = static_cast<uint32_t>(m_ObjectData.size());
+    if (!m_ObjectBuffer || m_ObjectCapacity < required) {
+        ReleaseObjectBuffers();
+
+        // 按2倍增长，避免实体数变化时频繁重建
+        uint32_t newCapacity = (std::max)(required, (std::max)(m_ObjectCapacity * 2, 256u));
+        m_ObjectCapacity = 0;
+
+        // 结构化缓冲区（VS t5）
+        D3D11_BUFFER_DESC desc = {};
+        desc.ByteWidth = newCapacity * sizeof(ObjectData);
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        desc.StructureByteStride = sizeof(ObjectData);
+
+        if (FAILED(g_CachedDevice->CreateBuffer(&desc, nullptr, &m_ObjectBuffer))) {
+            DebugManager::GetInstance().Log("RenderQueue", "Failed to create object structured buffer");
+            ReleaseObjectBuffers();
+            return false;
+        }
+        GpuMemory::Track(m_ObjectBuffer);
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.FirstElement = 0;
+        srvDesc.Buffer.NumElements = newCapacity;
+        if (FAILED(g_CachedDevice->CreateShaderResourceView(m_ObjectBuffer, &srvDesc, &m_ObjectSRV))) {
+            DebugManager::GetInstance().Log("RenderQueue", "Failed to create object buffer SRV");
+            ReleaseObjectBuffers();
+            return false;
+        }
+
+        // 对象下标流（slot 1，逐实例 0..N-1，内容不变）：
+        // D3D11 的 SV_InstanceID 不包含 StartInstanceLocation，通过逐实例顶点属性取得全局下标
+        std::vector<uint32_t> indices(newCapacity);
+        for (uint32_t k = 0; k < newCapacity; k++) {
+            indices[k] = k;
+        }
+        D3D11_BUFFER_DESC indexDesc = {};
+        indexDesc.ByteWidth = newCapacity * sizeof(uint32_t);
+        indexDesc.Usage = D3D11_USAGE_IMMUTABLE;
+        indexDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        D3D11_SUBRESOURCE_DATA indexData = {};
+        indexData.pSysMem = indices.data();
+        if (FAILED(g_CachedDevice->CreateBuffer(&indexDesc, &indexData, &m_ObjectIndexBuffer))) {
+            DebugManager::GetInstance().Log("RenderQueue", "Failed to create object index buffer");
+            ReleaseObjectBuffers();
+            return false;
+        }
+        GpuMemory::Track(m_ObjectIndexBuffer);
+
+        m_ObjectCapacity = newCapacity;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mappedResource;
+    if (FAILED(context->Map(m_ObjectBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+        return false;
+    }
+    memcpy(mappedResource.pData, m_ObjectData.data(), m_ObjectData.size() * sizeof(ObjectData));
+    context->Unmap(m_ObjectBuffer, 0);
+    return true;
+}
+
+void RenderQueue::ReleaseObjectBuffers() {
+    if (m_ObjectSRV) {
+        m_ObjectSRV->Release();
+        m_ObjectSRV = nullptr;
+    }
+    if (m_ObjectBuffer) {
+        m_ObjectBuffer->Release();
+        m_ObjectBuffer = nullptr;
+    }
+    if (m_ObjectIndexBuffer) {
+        m_ObjectIndexBuffer->Release();
+        m_ObjectIndexBuffer = nullptr;
+    }
+}
+
+/**
+ * @brief 延迟上下文需要继承的立即上下文管线状态
+ *
+ * 延迟上下文从默认状态开始录制，RenderSystem 在立即上下文上设置的
+ * RT/视口与 PerFrame CB (b0) 需要逐个复制过去；ShadowRenderer 绑定的级联阴影资源（PS b3 / t6 / s1）和 ClusteredLighting 的簇参数 / 光源列表（PS b4 / t7-t9）同样需要继承。
+ * 混合 / 深度 / 光栅化状态不在这里复制，由 ExecuteRange 按段声明的 PassState 设置。
+ */
+struct RenderQueue::InheritedState {
+    ID3D11RenderTargetView* renderTarget = nullptr;
+    ID3D11DepthStencilView* depthStencil = nullptr;
+    D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE] = {};
+    UINT viewportCount = D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE;
+    ID3D11Buffer* vsFrameCB = nullptr;
+    ID3D11Buffer* psFrameCB = nullptr;
+    ID3D11Buffer* psShadowCB = nullptr;
+    ID3D11ShaderResourceView* psShadowMap = nullptr;
+    ID3D11SamplerState* psShadowSampler = nullptr;
+    ID3D11Buffer* psClusterCB = nullptr;
+    static constexpr UINT kClusterViewCount = ClusteredLighting::kLightIndexSlot - ClusteredLighting::kLightSlot + 1;
+    ID3D11ShaderResourceView* psClusterViews[kClusterViewCount] = {};   // 光源 / 簇 / 光源下标（t7-t9）
+
+    void Capture(ID3D11DeviceContext* context) {
+        context->OMGetRenderTargets(1, &renderTarget, &depthStencil);
+        context->RSGetViewports(&viewportCount, viewports);
+        context->VSGetConstantBuffers(0, 1, &vsFrameCB);
+        context->PSGetConstantBuffers(0, 1, &psFrameCB);
+        context->PSGetConstantBuffers(ShadowRenderer::kShadowBufferSlot, 1, &psShadowCB);
+        context->PSGetShaderResources(ShadowRenderer::kShadowMapSlot, 1, &psShadowMap);
+        context->PSGetSamplers(ShadowRenderer::kShadowSamplerSlot, 1, &psShadowSampler);
+        context->PSGetConstantBuffers(ClusteredLighting::kClusterBufferSlot, 1, &psClusterCB);
+        context->PSGetShaderResources(ClusteredLighting::kLightSlot, kClusterViewCount, psClusterViews);
+    }
+
+    void Apply(ID3D11DeviceContext* context) const {
+        context->OMSetRenderTargets(1, &renderTarget, depthStencil);
+        context->RSSetViewports(viewportCount, viewports);
+        context->VSSetConstantBuffers(0, 1, &vsFrameCB);
+        context->PSSetConstantBuffers(0, 1, &psFrameCB);
+        context->PSSetConstantBuffers(ShadowRenderer::kShadowBufferSlot, 1, &psShadowCB);
+        context->PSSetShaderResources(ShadowRenderer::kShadowMapSlot, 1, &psShadowMap);
+        context->PSSetSamplers(ShadowRenderer::kShadowSamplerSlot, 1, &psShadowSampler);
+        context->PSSetConstantBuffers(ClusteredLighting::kClusterBufferSlot, 1, &psClusterCB);
+        context->PSSetShaderResources(ClusteredLighting::kLightSlot, kClusterViewCount, psClusterViews);
+    }
+
+    ~InheritedState() {
+        // Get* 接口会 AddRef
+        if (renderTarget) renderTarget->Release();
+        if (depthStencil) depthStencil->Release();
+        if (vsFrameCB) vsFrameCB->Release();
+        if (psFrameCB) psFrameCB->Release();
+        if (psShadowCB) psShadowCB->Release();
+        if (psShadowMap) psShadowMap->Release();
+        if (psShadowSampler) psShadowSampler->Release();
+        if (psClusterCB) psClusterCB->Release();
+        for (ID3D11ShaderResourceView* view : psClusterViews) {
+            if (view) view->Release();
+        }
+    }
+};
+
+/**
+ * @brief 确保有足够的延迟上下文（按需创建，跨帧复用）
+ */
+bool RenderQueue::EnsureDeferredContexts(uint32_t count) {
+    if (!g_CachedDevice) {
+        return false;
+    }
+    while (m_DeferredContexts.size() < count) {
+        ID3D11DeviceContext* deferred = nullptr;
+        if (FAILED(g_CachedDevice->CreateDeferredContext(0, &deferred))) {
+            DebugManager::GetInstance().Log("RenderQueue", "Failed to create deferred context, falling back to immediate");
+            m_DeferredEnabled = false;
+            return false;
+        }
+        m_DeferredContexts.push_back(deferred);
+    }
+    m_CommandLists.resize(m_DeferredContexts.size(), nullptr);
+    return true;
+}
+
+void RenderQueue::ReleaseDeferredContexts() {
+    for (auto* list : m_CommandLists) {
+        if (list) list->Release();
+    }
+    m_CommandLists.clear();
+    for (auto* deferred : m_DeferredContexts) {
+        deferred->Release();
+    }
+    m_DeferredContexts.clear();
+}
+
+/**
+ * @brief 绘制资源（Sampler / 默认MaterialBuffer / 各段状态），所有上下文共用
+ */
+bool RenderQueue::EnsureDrawResources() {
+    if (m_DefaultSampler && m_DefaultMaterialCB) {
+        return true;
+    }
+    if (!g_CachedDevice) {
+        return false;
+    }
+
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    // 各向异性过滤以获得更好的纹理质量
+    m_DefaultSampler = stateCache.GetSamplerState(D3D11_FILTER_ANISOTROPIC, D3D11_TEXTURE_ADDRESS_WRAP, 16);
+    m_LessDepthState = stateCache.GetDepthStencilState(true, true, D3D11_COMPARISON_LESS);
+    m_EqualDepthState = stateCache.GetDepthStencilState(true, false, D3D11_COMPARISON_EQUAL);
+    m_TransparentDepthState = stateCache.GetDepthStencilState(true, false, D3D11_COMPARISON_LESS);
+    m_OpaqueBlendState = stateCache.GetBlendState(RenderStateCache::BlendMode::Opaque);
+    m_TransparentBlendState = stateCache.GetBlendState(RenderStateCache::BlendMode::AlphaBlend);
+
+    // === 默认MaterialBuffer (b2)，内容不会改变 ===
+    if (!m_DefaultMaterialCB) {
+        resources::MaterialConstants defaultConstants;
+        D3D11_BUFFER_DESC cbDesc = {};
+        cbDesc.ByteWidth = sizeof(resources::MaterialConstants);  // 48 bytes (must be 16-byte aligned)
+        cbDesc.Usage = D3D11_USAGE_IMMUTABLE;
+        cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        D3D11_SUBRESOURCE_DATA initData = {};
+        initData.pSysMem = &defaultConstants;
+        if (SUCCEEDED(g_CachedDevice->CreateBuffer(&cbDesc, &initData, &m_DefaultMaterialCB))) {
+            GpuMemory::Track(m_DefaultMaterialCB);
+        }
+    }
+    return m_DefaultSampler && m_DefaultMaterialCB;
+}
+
+/**
+ * @brief 按需加载深度预通道着色器（失败后关闭预通道，不再重试）
+ */
+bool RenderQueue::EnsureDepthPrePassShader() {
+    if (m_DepthShader) {
+        return true;
+    }
+    if (!g_CachedDevice) {
+        return false;
+    }
+
+    auto shader = std::make_unique<resources::Shader>();
+    if (!shader->LoadFromFile(g_CachedDevice, "depth_prepass.vs", "depth_prepass.ps")) {
+        DebugManager::GetInstance().Log("RenderQueue", "Failed to load depth pre-pass shader, pre-pass disabled");
+        m_DepthPrePassEnabled = false;
+        return false;
+    }
+    m_DepthShader = std::move(shader);
+    return true;
+}
+
+/**
+ * @brief 在立即上下文上同步材质常量缓冲区（参数变化时才 UpdateSubresource）
+ *
+ * 在录制前统一完成，延迟上下文录制时只读取已就绪的缓冲区。
+ */
+void RenderQueue::UpdateMaterialBuffers(ID3D11DeviceContext* context) {
+    const resources::Material* lastMaterial = nullptr;
+    for (const auto& batch : m_Batches) {
+        if (batch.material && batch.material != lastMaterial) {
+            batch.material->UpdateGPUBuffer(context);
+            lastMaterial = batch.material;
+        }
+    }
 }
 
 /**
  * @brief 执行绘制（带状态缓存）
  */
-void RenderQueue::Execute(ID3D11DeviceContext* context, ID3D11Buffer* perObjectCB, 
-                          const DirectX::XMFLOAT3& sunPosition) {
-    if (!context || m_Batches.empty()) {
+void RenderQueue::Execute(ID3D11DeviceContext* context, ID3D11Buffer* perObjectCB,
+                          const DirectX::XMFLOAT3& sunPosition,
+                          const std::function<void(ID3D11DeviceContext*)>& afterOpaque) {
+    if (!context) {
         return;
     }
-    
-    m_Stats.Reset();
+    if (m_Batches.empty()) {
+        if (afterOpaque) afterOpaque(context);
+        return;
+    }
+
+    m_Stats.ResetDrawCounters();
     m_Stats.totalBatches = static_cast<uint32_t>(m_Batches.size());
-    
-    // === 创建默认Sampler（静态，只创建一次）===
-    static ID3D11SamplerState* s_defaultSampler = nullptr;
-    if (!s_defaultSampler && g_CachedDevice) {
-        D3D11_SAMPLER_DESC samplerDesc = {};
-        samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;  // 使用各向异性过滤以获得更好的纹理质量
-        samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-        samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-        samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-        samplerDesc.MaxAnisotropy = 16;  // 增加各向异性过滤级别
-        samplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
-        samplerDesc.MinLOD = 0;
-        samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
-        g_CachedDevice->CreateSamplerState(&samplerDesc, &s_defaultSampler);
+
+    EnsureDrawResources();
+    UpdateMaterialBuffers(context);
+
+    // 各段声明的状态；光栅化状态沿用场景通道（背面剔除开关在 RenderSystem），从缓存读取而不是 RSGetState
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    PassState opaqueState;
+    opaqueState.blend = m_OpaqueBlendState;
+    opaqueState.depthStencil = m_LessDepthState;
+    opaqueState.rasterizer = stateCache.GetCurrent().rasterizer;
+    PassState transparentState = opaqueState;
+    transparentState.blend = m_TransparentBlendState;
+    transparentState.depthStencil = m_TransparentDepthState;
+
+    // === 划分绘制组并上传整帧逐对象数据（立即上下文，录制前完成）===
+    BuildDrawGroups();
+    bool objectBufferReady = UploadObjectData(context);
+
+    const uint32_t groupCount = static_cast<uint32_t>(m_DrawGroups.size());
+
+    // RenderPass 在排序键最高位，不透明绘制组总在前面
+    uint32_t opaqueGroups = 0;
+    while (opaqueGroups < groupCount && SortedBatch(m_DrawGroups[opaqueGroups].firstBatch).renderPass == 0) {
+        opaqueGroups++;
     }
-    
+
+    // === 深度预通道 ===
+    // 预通道与着色通道对每个批次必须走同一条变换路径（对象缓冲区/常量缓冲区），EQUAL 才能逐位匹配
+    uint32_t opaqueScope = m_GpuProfiler ? m_GpuProfiler->BeginScope(context, "Opaque") : GpuProfiler::kInvalidScope;
+    bool prePass = m_DepthPrePassEnabled && perObjectCB && m_LessDepthState && m_EqualDepthState && opaqueGroups > 0 &&
+                   EnsureDepthPrePassShader() && (!objectBufferReady || m_DepthShader->SupportsInstancing());
+    if (prePass) {
+        stateCache.Apply(context, opaqueState);
+        ExecuteDepthPrePass(context, opaqueGroups, perObjectCB, objectBufferReady, m_Stats);
+        opaqueState.depthStencil = m_EqualDepthState;
+    }
+
+    // === 不透明段：延迟上下文路径按排序顺序切分为连续区间，工作线程并行录制 ===
+    uint32_t rangeCount = 0;
+    if (m_DeferredEnabled && opaqueGroups >= kDeferredThreshold) {
+        uint32_t workers = (std::max)(1u, (std::min)(std::thread::hardware_concurrency(), kMaxDeferredContexts));
+        rangeCount = (std::min)(workers, (opaqueGroups + kDeferredRangeMin - 1) / kDeferredRangeMin);
+    }
+
+    if (rangeCount < 2 || !EnsureDeferredContexts(rangeCount)) {
+        ExecuteRange(context, 0, opaqueGroups, perObjectCB, objectBufferReady, opaqueState, m_Stats);
+    } else {
+        ExecuteDeferred(context, opaqueGroups, rangeCount, perObjectCB, objectBufferReady, opaqueState);
+    }
+    if (m_GpuProfiler) m_GpuProfiler->EndScope(context, opaqueScope);
+
+    // 不透明深度已完整：天空盒等在这里绘制（各自声明状态），被覆盖的像素由早期深度测试拒绝
+    if (afterOpaque) afterOpaque(context);
+
+    // === 透明段：必须按远到近顺序混合，始终在立即上下文上绘制 ===
+    if (opaqueGroups < groupCount) {
+        GPU_PROFILE_SCOPE(m_GpuProfiler, context, "Transparent");
+        ExecuteRange(context, opaqueGroups, groupCount, perObjectCB, objectBufferReady, transparentState, m_Stats);
+    }
+}
+
+/**
+ * @brief 把 [0, endGroup) 切分为 rangeCount 个连续区间，并行录制到延迟上下文后按顺序回放
+ */
+void RenderQueue::ExecuteDeferred(ID3D11DeviceContext* context, uint32_t endGroup, uint32_t rangeCount,
+                                  ID3D11Buffer* perObjectCB, bool objectBufferReady, const PassState& passState) {
+    InheritedState inherited;
+    inherited.Capture(context);
+
+    m_DeferredRanges.resize(rangeCount);
+    const uint32_t rangeSize = (endGroup + rangeCount - 1) / rangeCount;
+    for (uint32_t r = 0; r < rangeCount; r++) {
+        DeferredRange& range = m_DeferredRanges[r];
+        range.begin = (std::min)(endGroup, r * rangeSize);
+        range.end = (std::min)(endGroup, range.begin + rangeSize);
+        range.context = m_DeferredContexts[r];
+        range.stats.ResetDrawCounters();
+    }
+
+    std::vector<ID3D11CommandList*>& commandLists = m_CommandLists;
+    std::for_each(std::execution::par, m_DeferredRanges.begin(), m_DeferredRanges.end(),
+        [&](DeferredRange& range) {
+            size_t slot = &range - m_DeferredRanges.data();
+            inherited.Apply(range.context);
+            ExecuteRange(range.context, range.begin, range.end, perObjectCB, objectBufferReady, passState, range.stats);
+            // FALSE：录制结束后延迟上下文状态清空，下一帧重新 Apply
+            if (FAILED(range.context->FinishCommandList(FALSE, &commandLists[slot]))) {
+                commandLists[slot] = nullptr;
+            }
+        });
+
+    // === 按排序顺序在立即上下文上回放（TRUE：保留立即上下文状态供透明段和 UI 使用）===
+    for (uint32_t r = 0; r < rangeCount; r++) {
+        const DeferredRange& range = m_DeferredRanges[r];
+        if (!commandLists[r]) {
+            // 录制失败时在立即上下文上补画该区间，保证不丢物体
+            ExecuteRange(context, range.begin, range.end, perObjectCB, objectBufferReady, passState, m_Stats);
+            continue;
+        }
+        context->ExecuteCommandList(commandLists[r], TRUE);
+        commandLists[r]->Release();
+        commandLists[r] = nullptr;
+        m_Stats.commandLists++;
+
+        m_Stats.drawCalls += range.stats.drawCalls;
+        m_Stats.shaderSwitches += range.stats.shaderSwitches;
+        m_Stats.textureSwitches += range.stats.textureSwitches;
+        m_Stats.materialSwitches += range.stats.materialSwitches;
+        m_Stats.instancedDrawCalls += range.stats.instancedDrawCalls;
+        m_Stats.instancesDrawn += range.stats.instancesDrawn;
+        m_Stats.geometryBinds += range.stats.geometryBinds;
+    }
+}
+
+/**
+ * @brief 绑定批次的 VB / IB（对象缓冲区路径时 slot 1 为对象下标流），与上次绑定相同则跳过
+ *
+ * GeometryPool 中同一页的 Mesh 共用 VB / IB，区间由 DrawIndexed 的 startIndex / baseVertex 选择，
+ * 因此按 Shader / 材质排序后的相邻批次大多不需要重新绑定。
+ */
+void RenderQueue::BindGeometry(ID3D11DeviceContext* context, const RenderBatch& batch, bool useObjectBuffer,
+                               GeometryBinding& last, RenderStats& stats) const {
+    if (batch.vertexBuffer != last.vertexBuffer || batch.vertexStride != last.vertexStride ||
+        batch.vertexOffset != last.vertexOffset || useObjectBuffer != last.objectStream) {
+        UINT strides[2] = { batch.vertexStride, sizeof(uint32_t) };
+        UINT offsets[2] = { batch.vertexOffset, 0 };
+        ID3D11Buffer* buffers[2] = { batch.vertexBuffer, m_ObjectIndexBuffer };
+        context->IASetVertexBuffers(0, useObjectBuffer ? 2 : 1, buffers, strides, offsets);
+        last.vertexBuffer = batch.vertexBuffer;
+        last.vertexStride = batch.vertexStride;
+        last.vertexOffset = batch.vertexOffset;
+        last.objectStream = useObjectBuffer;
+        stats.geometryBinds++;
+    }
+    if (batch.indexBuffer != last.indexBuffer || batch.indexFormat != last.indexFormat) {
+        context->IASetIndexBuffer(batch.indexBuffer, batch.indexFormat, 0);
+        last.indexBuffer = batch.indexBuffer;
+        last.indexFormat = batch.indexFormat;
+        stats.geometryBinds++;
+    }
+}
+
+/**
+ * @brief 深度预通道：不透明绘制组只写深度（位置着色器 + 无像素着色器）
+ *
+ * 分组与 ExecuteRange 完全相同；每个批次使用自己的输入布局，预通道着色器只读取 POSITION。
+ */
+void RenderQueue::ExecuteDepthPrePass(ID3D11DeviceContext* context, uint32_t endGroup,
+                                      ID3D11Buffer* perObjectCB, bool objectBufferReady, RenderStats& stats) const {
+    ID3D11VertexShader* depthVS = m_DepthShader->GetVertexShader();
+    ID3D11VertexShader* depthInstancedVS = m_DepthShader->GetInstancedVertexShader();
+
+    if (objectBufferReady) {
+        ID3D11ShaderResourceView* objectSRV = m_ObjectSRV;
+        context->VSSetShaderResources(kObjectDataSlot, 1, &objectSRV);
+    }
+    context->PSSetShader(nullptr, nullptr, 0);
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    ID3D11VertexShader* lastVS = nullptr;
+    ID3D11InputLayout* lastLayout = nullptr;
+    GeometryBinding lastGeometry;
+    auto bindGeometry = [&](const RenderBatch& batch, bool useObjectBuffer) {
+        ID3D11VertexShader* vs = useObjectBuffer ? depthInstancedVS : depthVS;
+        ID3D11InputLayout* layout = useObjectBuffer ? batch.instancedInputLayout : batch.inputLayout;
+        if (vs != lastVS) {
+            context->VSSetShader(vs, nullptr, 0);
+            lastVS = vs;
+        }
+        if (layout != lastLayout) {
+            context->IASetInputLayout(layout);
+            lastLayout = layout;
+        }
+
+        BindGeometry(context, batch, useObjectBuffer, lastGeometry, stats);
+    };
+
+    for (uint32_t g = 0; g < endGroup; g++) {
+        const DrawGroup& group = m_DrawGroups[g];
+        const RenderBatch& first = SortedBatch(group.firstBatch);
+        if (objectBufferReady && first.instancedVertexShader && first.instancedInputLayout) {
+            bindGeometry(first, true);
+            context->DrawIndexedInstanced(first.indexCount, group.batchCount, first.startIndex, first.baseVertex,
+                                          group.firstBatch);
+            stats.depthPrePassDrawCalls++;
+            continue;
+        }
+
+        // 常量缓冲区回退路径：depth_prepass.hlsl 只读取 world（前 64 字节）
+        for (uint32_t k = group.firstBatch; k < group.firstBatch + group.batchCount; k++) {
+            const RenderBatch& batch = SortedBatch(k);
+            bindGeometry(batch, false);
+
+            D3D11_MAPPED_SUBRESOURCE mappedResource;
+            if (SUCCEEDED(context->Map(perObjectCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+                XMMATRIX world = XMMatrixTranspose(batch.worldMatrix);
+                memcpy(mappedResource.pData, &world, sizeof(XMMATRIX));
+                context->Unmap(perObjectCB, 0);
+            }
+            context->VSSetConstantBuffers(1, 1, &perObjectCB);
+
+            context->DrawIndexed(batch.indexCount, batch.startIndex, batch.baseVertex);
+            stats.depthPrePassDrawCalls++;
+        }
+    }
+}
+
+/**
+ * @brief 在给定上下文上绘制 [beginGroup, endGroup) 的绘制组（立即或延迟上下文均可）
+ */
+void RenderQueue::ExecuteRange(ID3D11DeviceContext* context, uint32_t beginGroup, uint32_t endGroup,
+                               ID3D11Buffer* perObjectCB, bool objectBufferReady,
+                               const PassState& passState, RenderStats& stats) const {
+    ID3D11SamplerState* defaultSampler = m_DefaultSampler;
+    ID3D11Buffer* defaultMaterialCB = m_DefaultMaterialCB;
+
+    // 本段的混合 / 深度 / 光栅化状态（延迟上下文从默认状态开始，总是提交）
+    RenderStateCache::GetInstance().Apply(context, passState);
+
     // === 状态缓存 ===
     ID3D11VertexShader* lastVS = nullptr;
     ID3D11PixelShader* lastPS = nullptr;
@@ -377,180 +1500,141 @@ void RenderQueue::Execute(ID3D11DeviceContext* context, ID3D11Buffer* perObjectC
     ID3D11ShaderResourceView* lastNormal = nullptr;
     ID3D11ShaderResourceView* lastMetallic = nullptr;
     ID3D11ShaderResourceView* lastRoughness = nullptr;
+    ID3D11ShaderResourceView* lastEmissive = nullptr;
+    ID3D11Buffer* lastMaterialCB = nullptr;
+    GeometryBinding lastGeometry;
     bool samplerBound = false;
-    
-    int batchIndex = 0;
-    for (const auto& batch : m_Batches) {
-        
+
+    // 整帧逐对象数据（VS t5），每个上下文绑定一次
+    if (objectBufferReady) {
+        ID3D11ShaderResourceView* objectSRV = m_ObjectSRV;
+        context->VSSetShaderResources(kObjectDataSlot, 1, &objectSRV);
+    }
+
+    // 绑定单个纹理槽（仅在切换时）
+    auto bindTexture = [context](UINT slot, ID3D11ShaderResourceView* srv, ID3D11ShaderResourceView*& last) -> bool {
+        if (srv == last) return false;
+        ID3D11ShaderResourceView* bound = srv;
+        context->PSSetShaderResources(slot, 1, &bound);
+        last = srv;
+        return true;
+    };
+
+    // 绑定Shader、纹理、MaterialBuffer和几何体（对象缓冲区/常量缓冲区回退路径共用）
+    auto bindBatchState = [&](const RenderBatch& batch, bool useObjectBuffer) {
+        ID3D11VertexShader* vs = useObjectBuffer ? batch.instancedVertexShader : batch.vertexShader;
+        ID3D11InputLayout* layout = useObjectBuffer ? batch.instancedInputLayout : batch.inputLayout;
+
         // === 绑定Shader（仅在切换时） ===
-        if (batch.vertexShader != lastVS) {
-            context->VSSetShader(batch.vertexShader, nullptr, 0);
-            lastVS = batch.vertexShader;
-            m_Stats.shaderSwitches++;
+        if (vs != lastVS) {
+            context->VSSetShader(vs, nullptr, 0);
+            lastVS = vs;
+            stats.shaderSwitches++;
         }
-        
+
         if (batch.pixelShader != lastPS) {
             context->PSSetShader(batch.pixelShader, nullptr, 0);
             lastPS = batch.pixelShader;
         }
-        
-        if (batch.inputLayout != lastLayout) {
-            context->IASetInputLayout(batch.inputLayout);
-            lastLayout = batch.inputLayout;
-        }
-        
-        // === 绑定多纹理（PBR工作流：仅在切换时绑定）===
-        // Texture slot 0: Albedo/Diffuse map
-        if (batch.albedoTexture != lastAlbedo) {
-            if (batch.albedoTexture) {
-                context->PSSetShaderResources(0, 1, &batch.albedoTexture);
-                m_Stats.textureSwitches++;
-                
-                // 绑定sampler（只需一次）
-                if (!samplerBound && s_defaultSampler) {
-                    context->PSSetSamplers(0, 1, &s_defaultSampler);
-                    samplerBound = true;
-                }
-            } else {
-                ID3D11ShaderResourceView* nullSRV = nullptr;
-                context->PSSetShaderResources(0, 1, &nullSRV);
-            }
-            lastAlbedo = batch.albedoTexture;
+
+        if (layout != lastLayout) {
+            context->IASetInputLayout(layout);
+            lastLayout = layout;
         }
-        
-        // Texture slot 1: Normal map
-        if (batch.normalTexture != lastNormal) {
-            if (batch.normalTexture) {
-                context->PSSetShaderResources(1, 1, &batch.normalTexture);
-            } else {
-                ID3D11ShaderResourceView* nullSRV = nullptr;
-                context->PSSetShaderResources(1, 1, &nullSRV);
+
+        // === 绑定多纹理（PBR工作流：t0=Albedo, t1=Normal, t2=Metallic, t3=Roughness, t4=Emissive）===
+        if (bindTexture(0, batch.albedoTexture, lastAlbedo) && batch.albedoTexture) {
+            stats.textureSwitches++;
+
+            // 绑定sampler（只需一次）
+            if (!samplerBound && defaultSampler) {
+                context->PSSetSamplers(0, 1, &defaultSampler);
+                samplerBound = true;
             }
-            lastNormal = batch.normalTexture;
         }
-        
-        // Texture slot 2: Metallic map
-        if (batch.metallicTexture != lastMetallic) {
-            if (batch.metallicTexture) {
-                context->PSSetShaderResources(2, 1, &batch.metallicTexture);
-            } else {
-                ID3D11ShaderResourceView* nullSRV = nullptr;
-                context->PSSetShaderResources(2, 1, &nullSRV);
-            }
-            lastMetallic = batch.metallicTexture;
+        bindTexture(1, batch.normalTexture, lastNormal);
+        bindTexture(2, batch.metallicTexture, lastMetallic);
+        bindTexture(3, batch.roughnessTexture, lastRoughness);
+        bindTexture(4, batch.emissiveTexture, lastEmissive);
+
+        // === 绑定MaterialBuffer (b2)（材质自己的常量缓冲区，仅在材质切换时）===
+        ID3D11Buffer* materialCB = defaultMaterialCB;
+        if (batch.material && batch.material->constantBuffer) {
+            materialCB = static_cast<ID3D11Buffer*>(batch.material->constantBuffer);
         }
-        
-        // Texture slot 3: Roughness map
-        if (batch.roughnessTexture != lastRoughness) {
-            if (batch.roughnessTexture) {
-                context->PSSetShaderResources(3, 1, &batch.roughnessTexture);
-            } else {
-                ID3D11ShaderResourceView* nullSRV = nullptr;
-                context->PSSetShaderResources(3, 1, &nullSRV);
-            }
-            lastRoughness = batch.roughnessTexture;
-        }
-        
-        // Texture slot 4: Emissive map
-        static ID3D11ShaderResourceView* lastEmissive = nullptr;
-        if (batch.emissiveTexture != lastEmissive) {
-            if (batch.emissiveTexture) {
-                context->PSSetShaderResources(4, 1, &batch.emissiveTexture);
-            } else {
-                ID3D11ShaderResourceView* nullSRV = nullptr;
-                context->PSSetShaderResources(4, 1, &nullSRV);
-            }
-            lastEmissive = batch.emissiveTexture;
-        }
-        
-        // === 更新PerObject常量缓冲区 ===
-        if (perObjectCB) {
-            // PerObjectBuffer 必须与 HLSL 完全匹配（96 字节）
-            struct PerObjectData {
-                XMMATRIX world;             // 64 bytes (offset 0)
-                XMFLOAT4 color;             // 16 bytes (offset 64)
-                XMFLOAT3 lightDir;          // 12 bytes (offset 80) - 光照方向
-                float isSphere;             // 4 bytes  (offset 92) → total 96
-            };
-            static_assert(sizeof(PerObjectData) == 96, "PerObjectData must be 96 bytes");
-            
-            PerObjectData objData;
-            objData.world = XMMatrixTranspose(batch.worldMatrix);
-            objData.color = batch.material ? batch.material->albedo : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-            objData.lightDir = batch.lightDir;  // 使用预计算的光照方向
-            objData.isSphere = batch.isSphere ? 1.0f : 0.0f;
-            
-            // 调试输出（只输出前5个batch）
-            static bool debugDone = false;
-            static int batchCount = 0;
-            
-            
-            D3D11_MAPPED_SUBRESOURCE mappedResource;
-            if (SUCCEEDED(context->Map(perObjectCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
-                memcpy(mappedResource.pData, &objData, sizeof(PerObjectData));
-                context->Unmap(perObjectCB, 0);
-            }
-            
-            // 绑定到slot 1 (shader中的register(b1))
-            context->VSSetConstantBuffers(1, 1, &perObjectCB);
-            context->PSSetConstantBuffers(1, 1, &perObjectCB);  // 也绑定到像素着色器！
-        }
-        
-        // === 更新MaterialBuffer常量缓冲区 (b2) ===
-        static ID3D11Buffer* s_materialCB = nullptr;
-        if (!s_materialCB && g_CachedDevice) {
-            D3D11_BUFFER_DESC cbDesc = {};
-            cbDesc.ByteWidth = 32;  // MaterialBuffer size (must be 16-byte aligned)
-            cbDesc.Usage = D3D11_USAGE_DYNAMIC;
-            cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-            cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-            g_CachedDevice->CreateBuffer(&cbDesc, nullptr, &s_materialCB);
-        }
-        
-        if (s_materialCB) {
-            struct MaterialBuffer {
-                XMFLOAT3 emissiveColor;
-                float emissiveStrength;
-                float hasEmissiveTexture;
-                float padding[3];  // Padding to 32 bytes
-            };
-            
-            MaterialBuffer matData;
-            if (batch.material && batch.material->isEmissive) {
-                matData.emissiveColor = batch.material->emissiveColor;
-                matData.emissiveStrength = batch.material->emissiveStrength;
-                matData.hasEmissiveTexture = batch.emissiveTexture ? 1.0f : 0.0f;
-            } else {
-                matData.emissiveColor = XMFLOAT3(0.0f, 0.0f, 0.0f);
-                matData.emissiveStrength = 0.0f;
-                matData.hasEmissiveTexture = 0.0f;
+        if (materialCB && materialCB != lastMaterialCB) {
+            context->PSSetConstantBuffers(2, 1, &materialCB);  // shader中的register(b2)
+            lastMaterialCB = materialCB;
+            stats.materialSwitches++;
+        }
+
+        // === 绑定顶点/索引缓冲区（仅在 GeometryPool 页或布局变化时）===
+        BindGeometry(context, batch, useObjectBuffer, lastGeometry, stats);
+    };
+
+    // === 设置图元拓扑（每个上下文一次）===
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    for (uint32_t g = beginGroup; g < endGroup; g++) {
+        const DrawGroup& group = m_DrawGroups[g];
+
+        // === 对象缓冲区路径：逐对象数据已在结构化缓冲区中，不需要更新任何常量缓冲区 ===
+        // 单个对象也走 DrawIndexedInstanced（实例数 1），StartInstanceLocation 即对象下标
+        const RenderBatch& first = SortedBatch(group.firstBatch);
+        if (objectBufferReady && first.instancedVertexShader && first.instancedInputLayout) {
+            bindBatchState(first, true);
+
+            context->DrawIndexedInstanced(first.indexCount, group.batchCount, first.startIndex, first.baseVertex,
+                                          group.firstBatch);
+            stats.drawCalls++;
+            if (group.instanced) {
+                stats.instancedDrawCalls++;
+                stats.instancesDrawn += group.batchCount;
             }
-            matData.padding[0] = matData.padding[1] = matData.padding[2] = 0.0f;
-            
-            D3D11_MAPPED_SUBRESOURCE mappedResource;
-            if (SUCCEEDED(context->Map(s_materialCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
-                memcpy(mappedResource.pData, &matData, sizeof(MaterialBuffer));
-                context->Unmap(s_materialCB, 0);
+            continue;
+        }
+
+        // === 回退路径：Shader 没有对象缓冲区变体时逐对象 Map PerObject 常量缓冲区 ===
+        for (uint32_t k = group.firstBatch; k < group.firstBatch + group.batchCount; k++) {
+            const RenderBatch& batch = SortedBatch(k);
+            bindBatchState(batch, false);
+
+            // === 更新PerObject常量缓冲区 ===
+            if (perObjectCB) {
+                // PerObjectBuffer 必须与 HLSL 完全匹配（112 字节）
+                struct PerObjectData {
+                    XMMATRIX world;             // 64 bytes (offset 0)
+                    XMFLOAT4 color;             // 16 bytes (offset 64)
+                    XMFLOAT3 lightDir;          // 12 bytes (offset 80) - 光照方向
+                    float isSphere;             // 4 bytes  (offset 92)
+                    float receiveShadows;       // 4 bytes  (offset 96)
+                    XMFLOAT3 padding;           // 12 bytes (offset 100) → total 112
+                };
+                static_assert(sizeof(PerObjectData) == 112, "PerObjectData must be 112 bytes");
+
+                PerObjectData objData;
+                objData.world = XMMatrixTranspose(batch.worldMatrix);
+                objData.color = batch.material ? batch.material->albedo : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+                objData.lightDir = batch.lightDir;  // 使用预计算的光照方向
+                objData.isSphere = batch.isSphere ? 1.0f : 0.0f;
+                objData.receiveShadows = batch.receiveShadows ? 1.0f : 0.0f;
+                objData.padding = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+                D3D11_MAPPED_SUBRESOURCE mappedResource;
+                if (SUCCEEDED(context->Map(perObjectCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource))) {
+                    memcpy(mappedResource.pData, &objData, sizeof(PerObjectData));
+                    context->Unmap(perObjectCB, 0);
+                }
+
+                // 绑定到slot 1 (shader中的register(b1))
+                context->VSSetConstantBuffers(1, 1, &perObjectCB);
+                context->PSSetConstantBuffers(1, 1, &perObjectCB);  // 也绑定到像素着色器！
             }
-            
-            // 绑定到slot 2 (shader中的register(b2))
-            context->PSSetConstantBuffers(2, 1, &s_materialCB);
-        }
-        
-        // === 绑定顶点/索引缓冲区 ===
-        UINT stride = batch.vertexStride;
-        UINT offset = batch.vertexOffset;
-        context->IASetVertexBuffers(0, 1, &batch.vertexBuffer, &stride, &offset);
-        context->IASetIndexBuffer(batch.indexBuffer, DXGI_FORMAT_R32_UINT, 0);
-        
-        // === 设置图元拓扑 ===
-        context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        
-        // === DrawCall ===
-        context->DrawIndexed(batch.indexCount, 0, 0);
-        m_Stats.drawCalls++;
-        
-        batchIndex++;
+
+            // === DrawCall ===
+            context->DrawIndexed(batch.indexCount, batch.startIndex, batch.baseVertex);
+            stats.drawCalls++;
+        }
     }
 }
 
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "RenderItem.h"
+#include "RenderStateCache.h"
 #include "../core/ECS.h"
 #include <vector>
+#include <memory>
+#include <unordered_map>
+#include <map>
+#include <utility>
 #include <algorithm>
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 #include <cstdint>
+#include <functional>
 
 namespace outer_wilds {
 
@@ -14,7 +21,13 @@ namespace outer_wilds {
 namespace resources {
     class Mesh;
     class Material;
+    class Shader;
 }
+namespace components {
+    struct MeshLODChain;
+}
+class OcclusionCuller;
+class GpuProfiler;
 
 /**
  * @brief 渲染批次 - 单次DrawCall所需的完整GPU数据
@@ -28,6 +41,7 @@ struct RenderBatch {
     // === GPU资源句柄 ===
     ID3D11Buffer* vertexBuffer = nullptr;
     ID3D11Buffer* indexBuffer = nullptr;
+    DXGI_FORMAT indexFormat = DXGI_FORMAT_R32_UINT;
     
     // PBR Multi-texture support
     ID3D11ShaderResourceView* albedoTexture = nullptr;
@@ -42,6 +56,10 @@ struct RenderBatch {
     ID3D11PixelShader* pixelShader = nullptr;
     ID3D11InputLayout* inputLayout = nullptr;
     
+    // 实例化变体（Shader不支持实例化时为nullptr，回退到逐对象绘制）
+    ID3D11VertexShader* instancedVertexShader = nullptr;
+    ID3D11InputLayout* instancedInputLayout = nullptr;
+    
     // === 材质数据 ===
     resources::Material* material = nullptr;  // 用于读取albedo等属性
     
@@ -49,31 +67,106 @@ struct RenderBatch {
     DirectX::XMMATRIX worldMatrix;
     DirectX::XMFLOAT3 lightDir = { 0.0f, 1.0f, 0.0f };  // 光照方向（从物体指向太阳，已归一化）
     bool isSphere = false;  // 是否是球体
+    bool receiveShadows = true;  // 采样级联阴影（MeshComponent/MultiMeshComponent::receiveShadows，每帧刷新）
     
     // === 绘制参数 ===
     uint32_t indexCount = 0;
     uint32_t vertexStride = 0;
     uint32_t vertexOffset = 0;
+    uint32_t startIndex = 0;    // GeometryPool 区间：DrawIndexed(indexCount, startIndex, baseVertex)
+    int32_t baseVertex = 0;
     
     // === 排序键 ===
-    uint64_t sortKey = 0;  // [RenderPass(8)][Shader(8)][Material(8)][Depth(16)][Reserved(24)]
+    uint64_t sortKey = 0;  // [RenderPass(8)][Shader(8)][Material(8)][Mesh(8)][Depth(16)][Reserved(16)]
     uint8_t renderPass = 0;  // 0=Opaque, 1=Transparent
     
     /**
      * @brief 计算排序键（自动调用）
+     * 
+     * Mesh ID 位于 Depth 之前：同一Mesh+材质的批次在排序后相邻，
+     * Execute 才能把它们合并成一次 DrawIndexedInstanced。
      */
-    void CalculateSortKey(uint8_t shaderId, uint8_t materialId, uint16_t depth) {
+    void CalculateSortKey(uint8_t shaderId, uint8_t materialId, uint16_t depth, uint8_t meshId = 0) {
         sortKey = (static_cast<uint64_t>(renderPass) << 56) |
                   (static_cast<uint64_t>(shaderId) << 48) |
                   (static_cast<uint64_t>(materialId) << 40) |
-                  (static_cast<uint64_t>(depth) << 24);
+                  (static_cast<uint64_t>(meshId) << 32) |
+                  (static_cast<uint64_t>(depth) << 16);
+    }
+    
+    /**
+     * @brief 近到远优先的排序键：[RenderPass(8)][DepthBand(8)][Shader(8)][Material(8)][Mesh(8)][Depth(16)][Reserved(8)]
+     * 
+     * 粗粒度的深度分段放在状态之上，段内仍按 Shader/材质/Mesh 聚合（段内仍可实例化合并）。
+     * 没有深度预通道、像素着色开销高时使用，减少被覆盖像素上的完整 PBR 着色。
+     */
+    void CalculateFrontToBackSortKey(uint8_t shaderId, uint8_t materialId, uint8_t depthBand,
+                                     uint16_t depth, uint8_t meshId = 0) {
+        sortKey = (static_cast<uint64_t>(renderPass) << 56) |
+                  (static_cast<uint64_t>(depthBand) << 48) |
+                  (static_cast<uint64_t>(shaderId) << 40) |
+                  (static_cast<uint64_t>(materialId) << 32) |
+                  (static_cast<uint64_t>(meshId) << 24) |
+                  (static_cast<uint64_t>(depth) << 8);
     }
     
+    /**
+     * @brief 两个批次能否合并为同一次实例化绘制
+     * 
+     * 要求几何体、Shader、所有纹理和自发光参数一致；透明物体需要严格排序，不参与合并。
+     */
+    bool CanInstanceWith(const RenderBatch& other) const;
+    
     bool operator<(const RenderBatch& other) const {
         return sortKey < other.sortKey;
     }
 };
 
+/**
+ * @brief 整帧逐对象数据（StructuredBuffer，VS t5，112字节）
+ * 
+ * 布局与 PerObjectBuffer 相同，但 world 为行主序（不转置，HLSL 中为 row_major）。
+ * 排序后每个批次一项，下标即排序后位置，由 slot 1 的 OBJECT_INDEX 流 + StartInstanceLocation 索引。
+ */
+struct ObjectData {
+    DirectX::XMFLOAT4X4 world;          // 64 bytes
+    DirectX::XMFLOAT4 color;            // 16 bytes
+    DirectX::XMFLOAT3 lightDir;         // 12 bytes
+    float isSphere;                     // 4 bytes → 96
+    float receiveShadows;               // 4 bytes
+    DirectX::XMFLOAT3 padding;          // 12 bytes → total 112
+};
+static_assert(sizeof(ObjectData) == 112, "ObjectData must be 112 bytes");
+
+/**
+ * @brief 阴影投射者（CollectShadowCasters 输出，ShadowRenderer 按几何体合并为实例化绘制）
+ */
+struct ShadowCaster {
+    ID3D11Buffer* vertexBuffer = nullptr;
+    ID3D11Buffer* indexBuffer = nullptr;
+    DXGI_FORMAT indexFormat = DXGI_FORMAT_R32_UINT;
+    uint32_t indexCount = 0;
+    uint32_t vertexStride = 0;
+    uint32_t startIndex = 0;
+    int32_t baseVertex = 0;
+    ID3D11InputLayout* instancedInputLayout = nullptr;  // 深度着色器只读取 POSITION，沿用批次的布局
+    DirectX::XMFLOAT4X4 world;                          // 行主序
+};
+
+/**
+ * @brief 远处天体的球形替身（CollectFromECS 输出，ImpostorRenderer 一次实例化绘制）
+ *
+ * 颜色/纹理/光照方向取自该实体首个已解析批次。
+ */
+struct ImpostorInstance {
+    DirectX::XMFLOAT3 center = { 0.0f, 0.0f, 0.0f };  // 世界空间球心
+    float radius = 0.0f;
+    DirectX::XMFLOAT4 color = { 1.0f, 1.0f, 1.0f, 1.0f };  // 材质 albedo（自发光时为发光颜色 * 强度）
+    DirectX::XMFLOAT3 lightDir = { 0.0f, 1.0f, 0.0f };
+    bool emissive = false;
+    ID3D11ShaderResourceView* albedoTexture = nullptr;     // 用于取平均颜色（可为空）
+};
+
 /**
  * @brief 渲染队列统计
  */
@@ -82,9 +175,37 @@ struct RenderStats {
     uint32_t drawCalls = 0;
     uint32_t shaderSwitches = 0;
     uint32_t textureSwitches = 0;
+    uint32_t materialSwitches = 0;     // MaterialBuffer (b2) 重新绑定次数
+    uint32_t instancedDrawCalls = 0;   // 其中通过 DrawIndexedInstanced 提交的次数
+    uint32_t instancesDrawn = 0;       // 实例化绘制覆盖的批次数
+    uint32_t commandLists = 0;         // 延迟上下文录制并回放的命令列表数（0 = 立即上下文绘制）
+    uint32_t depthPrePassDrawCalls = 0;  // 深度预通道的 DrawCall 数（不计入 drawCalls）
+    uint32_t geometryBinds = 0;        // VB / IB 重新绑定次数（GeometryPool 同页的批次不需要重新绑定）
+    
+    // 视锥剔除（CollectFromECS 阶段统计，按 mesh 计数）
+    uint32_t visibleObjects = 0;
+    uint32_t culledObjects = 0;
+    uint32_t occludedObjects = 0;      // 被遮挡剔除（OcclusionCuller）的 mesh 数
+    
+    // 保留模式缓存（CollectFromECS 阶段统计）
+    uint32_t cachedRenderables = 0;    // 缓存中的实体数
+    uint32_t transformUpdates = 0;     // 本帧重新计算世界矩阵的实体数
+    uint32_t rebuiltRenderables = 0;   // 本帧重建批次模板的实体数
+    uint32_t reducedLODObjects = 0;    // 以简化 LOD（级别 > 0）提交的 mesh 数
+    uint32_t impostorObjects = 0;      // 以替身代替网格绘制的实体数
+    
+    /**
+     * @brief 只重置绘制相关计数（Execute 调用，保留收集阶段的剔除统计）
+     */
+    void ResetDrawCounters() {
+        totalBatches = drawCalls = shaderSwitches = textureSwitches = materialSwitches = 0;
+        instancedDrawCalls = instancesDrawn = commandLists = depthPrePassDrawCalls = geometryBinds = 0;
+    }
     
     void Reset() {
-        totalBatches = drawCalls = shaderSwitches = textureSwitches = 0;
+        ResetDrawCounters();
+        visibleObjects = culledObjects = occludedObjects = 0;
+        cachedRenderables = transformUpdates = rebuiltRenderables = reducedLODObjects = impostorObjects = 0;
     }
 };
 
@@ -97,6 +218,13 @@ struct RenderStats {
  * 3. 执行（Execute）：带状态缓存的高效DrawCall
  * 4. 手动添加：支持程序化几何体（如调试球体）
  * 
+ * 保留模式（Retained）：
+ * - 批次模板（Shader/Layout/SRV/排序ID）在 MeshComponent/MultiMeshComponent 构造或更新时建立，
+ *   通过 EnTT on_construct/on_update/on_destroy 信号标记，下一次 Collect 时重建
+ * - 每帧只有 TransformComponent::version 变化（TransformSystem 重算过矩阵）的实体才刷新世界矩阵、
+ *   世界包围球和光照方向；矩阵直接拷贝 Transform 上的缓存
+ * - 深度（排序键）依赖相机，每帧刷新，开销仅为一次减法和点积
+ * 
  * 与LightweightRenderQueue的关系：
  * - LightweightRenderQueue：只存Entity ID，适合简单场景
  * - RenderQueue：存完整GPU数据，支持状态优化和手动添加
@@ -105,24 +233,56 @@ struct RenderStats {
 class RenderQueue {
 public:
     RenderQueue() = default;
-    ~RenderQueue() = default;
+    ~RenderQueue();
+    
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+    
+    /**
+     * @brief 合并为实例化绘制所需的最少批次数（低于该值走逐对象路径）
+     */
+    static constexpr uint32_t kMinInstanceCount = 2;
+    
+    /**
+     * @brief 整帧逐对象结构化缓冲区的 VS 寄存器（HLSL: register(t5)）
+     */
+    static constexpr UINT kObjectDataSlot = 5;
 
     /**
-     * @brief 清空队列
+     * @brief 清空队列（仅本帧批次，不影响保留模式缓存）
      */
     void Clear() {
         m_Batches.clear();
+        m_SortOrder.clear();
+        m_Impostors.clear();
         m_Stats.Reset();
     }
+    
+    /**
+     * @brief 丢弃保留模式缓存并断开 registry 信号（切换场景时调用）
+     */
+    void ResetCache();
 
     /**
      * @brief 从ECS收集渲染批次
      * @param registry ECS注册表
      * @param cameraPos 相机位置（用于计算深度）
      * @param sunPosition 太阳位置（用于计算光照方向）
+     * @param frustum 世界空间视锥（nullptr = 不剔除）；有 BoundsComponent 的实体在构建批次前被测试
+     * @param occlusion 本帧已构建的 Hi-Z 遮挡数据（nullptr = 不做遮挡剔除），在视锥剔除之后测试
      */
     void CollectFromECS(entt::registry& registry, const DirectX::XMFLOAT3& cameraPos, 
-                        const DirectX::XMFLOAT3& sunPosition);
+                        const DirectX::XMFLOAT3& sunPosition,
+                        const DirectX::BoundingFrustum* frustum = nullptr,
+                        const OcclusionCuller* occlusion = nullptr);
+
+    /**
+     * @brief 纹理流式加载（CollectFromECS 之后、Sort 之前，主线程）
+     *
+     * 为本帧可见实体的纹理向 TextureStreamer 报告投影尺寸，
+     * 并把输出批次中的基础 SRV 换成当前最高的常驻级别（缓存的批次模板保持基础 SRV 不变）
+     */
+    void UpdateTextureStreaming();
 
     /**
      * @brief 手动添加批次（用于程序化几何体）
@@ -143,19 +303,25 @@ public:
 
     /**
      * @brief 排序批次（减少状态切换）
+     *
+     * 只对紧凑的 (sortKey, batchIndex) 数组做 LSD 基数排序，m_Batches 本身不移动；
+     * Execute 通过 m_SortOrder 间接访问。未调用 Sort 时按提交顺序绘制。
      */
-    void Sort() {
-        std::sort(m_Batches.begin(), m_Batches.end());
-    }
+    void Sort();
 
     /**
      * @brief 执行绘制（带状态缓存）
+     *
+     * 各段声明自己的输出合并状态（RenderStateCache）：深度预通道 LESS + 写深度，不透明段 EQUAL（有预通道时）
+     * 或 LESS + 写深度，透明段 LESS + 不写深度 + SRC_ALPHA 混合。光栅化状态沿用调用方声明的场景通道状态。
      * @param context D3D11设备上下文
      * @param perObjectCB PerObject常量缓冲区
      * @param sunPosition 太阳位置（用于调试输出）
+     * @param afterOpaque 不透明段之后、透明段之前调用（天空盒：只填充没有被覆盖的像素）；队列为空时也会调用
      */
     void Execute(ID3D11DeviceContext* context, ID3D11Buffer* perObjectCB, 
-                 const DirectX::XMFLOAT3& sunPosition = {0,0,0});
+                 const DirectX::XMFLOAT3& sunPosition = {0,0,0},
+                 const std::function<void(ID3D11DeviceContext*)>& afterOpaque = {});
 
     /**
      * @brief 获取统计信息
@@ -172,9 +338,352 @@ public:
      */
     bool Empty() const { return m_Batches.empty(); }
 
+    /**
+     * @brief 启用/禁用并行收集（实体数低于 kParallelCollectThreshold 时总是串行）
+     */
+    void SetParallelCollect(bool enabled) { m_ParallelCollect = enabled; }
+    bool IsParallelCollect() const { return m_ParallelCollect; }
+    
+    static constexpr size_t kParallelCollectThreshold = 512;  // 少于该实体数时线程调度开销大于收益
+    static constexpr size_t kParallelCollectChunk = 128;      // 每块最少实体数
+    
+    /**
+     * @brief 启用/禁用 LOD 选择（禁用时总是绘制 LOD 0）
+     */
+    void SetLODEnabled(bool enabled) { m_LODEnabled = enabled; }
+    bool IsLODEnabled() const { return m_LODEnabled; }
+    
+    static constexpr float kLODHysteresis = 0.15f;  // 切回更精细级别需要超过阈值的比例，防止在阈值附近来回跳变
+    static constexpr float kDefaultTopSlope = 0.577f;  // 未传入视锥时假设 60° 垂直视场（tan 30°）
+    
+    /**
+     * @brief 启用/禁用远处天体替身（禁用时总是提交网格）
+     */
+    void SetImpostorsEnabled(bool enabled) { m_ImpostorsEnabled = enabled; }
+    bool IsImpostorsEnabled() const { return m_ImpostorsEnabled; }
+    
+    /**
+     * @brief 收集与光源空间包围盒相交的阴影投射者（在 CollectFromECS 之后调用）
+     *
+     * 复用本帧已刷新的世界矩阵/包围球；只包括 castsShadows 且可见的不透明批次，
+     * 以替身绘制的天体和没有实例化布局的批次被跳过。LOD 级别与主视图相同。
+     * @param volume 世界空间的级联投射体（ortho 盒，向光源方向延长以包含体外投射者）
+     * @param out 追加输出
+     */
+    void CollectShadowCasters(const DirectX::BoundingOrientedBox& volume, std::vector<ShadowCaster>& out) const;
+    
+    /**
+     * @brief 本帧需要以替身绘制的天体（CollectFromECS 填充）
+     */
+    const std::vector<ImpostorInstance>& GetImpostors() const { return m_Impostors; }
+    
+    /**
+     * @brief 启用/禁用实例化合并（调试对比用）
+     */
+    void SetInstancingEnabled(bool enabled) { m_InstancingEnabled = enabled; }
+    bool IsInstancingEnabled() const { return m_InstancingEnabled; }
+    
+    /**
+     * @brief 启用/禁用延迟上下文多线程录制
+     *
+     * 启用后，不透明绘制组数不少于 kDeferredThreshold 时按排序顺序切分为连续区间（透明段始终在立即上下文上），
+     * 每个区间由工作线程在各自的 ID3D11DeviceContext（延迟上下文）上录制，
+     * 再按顺序在立即上下文上 ExecuteCommandList。驱动不支持原生命令列表时由运行时模拟，
+     * 可能反而更慢，因此默认关闭。
+     */
+    void SetDeferredContextsEnabled(bool enabled) { m_DeferredEnabled = enabled; }
+    bool IsDeferredContextsEnabled() const { return m_DeferredEnabled; }
+    
+    /**
+     * @brief GPU 分段计时（Execute 中的 "Opaque"/"Transparent"，可为空）
+     */
+    void SetGpuProfiler(GpuProfiler* profiler) { m_GpuProfiler = profiler; }
+    
+    /**
+     * @brief 排序键模式
+     * - StateFirst：Shader/材质/Mesh 优先（默认，状态切换最少，实例化合并最多）
+     * - FrontToBack：粗深度分段优先、段内按状态，近处物体先画（像素开销高时减少过度绘制）
+     */
+    enum class SortMode : uint8_t {
+        StateFirst,
+        FrontToBack
+    };
+    
+    void SetSortMode(SortMode mode) { m_SortMode = mode; }
+    SortMode GetSortMode() const { return m_SortMode; }
+    
+    /**
+     * @brief 启用/禁用深度预通道
+     *
+     * 启用后 Execute 先用只写深度的顶点着色器（shaders/depth_prepass.hlsl，不绑定像素着色器）
+     * 绘制所有不透明批次，再以 EQUAL + 不写深度着色，每个像素只运行一次完整的像素着色器；
+     * 透明批次仍使用 LESS、不写深度。着色器加载失败时自动关闭。
+     */
+    void SetDepthPrePassEnabled(bool enabled) { m_DepthPrePassEnabled = enabled; }
+    bool IsDepthPrePassEnabled() const { return m_DepthPrePassEnabled; }
+    
+    static constexpr uint32_t kDeferredThreshold = 256;  // 少于该绘制组数时在立即上下文上绘制
+    static constexpr uint32_t kDeferredRangeMin = 128;   // 每个延迟上下文最少绘制组数
+    static constexpr uint32_t kMaxDeferredContexts = 8;
+
 private:
+    /**
+     * @brief 一个 LOD 级别的几何体（切换级别时覆盖到 RenderBatch 上）
+     */
+    struct LODGeometry {
+        const resources::Mesh* mesh = nullptr;
+        ID3D11Buffer* vertexBuffer = nullptr;
+        ID3D11Buffer* indexBuffer = nullptr;
+        DXGI_FORMAT indexFormat = DXGI_FORMAT_R32_UINT;
+        uint32_t indexCount = 0;
+        uint32_t vertexStride = 0;
+        uint32_t startIndex = 0;
+        int32_t baseVertex = 0;
+        ID3D11VertexShader* vertexShader = nullptr;
+        ID3D11InputLayout* inputLayout = nullptr;
+        ID3D11VertexShader* instancedVertexShader = nullptr;
+        ID3D11InputLayout* instancedInputLayout = nullptr;
+        uint8_t shaderId = 0;
+        uint8_t meshId = 0;
+        float screenRadius = 0.0f;                      // 投影半径低于该值时使用本级别（LOD 0 不使用）
+    };
+    
+    /**
+     * @brief 缓存的单个(子)mesh批次：资源句柄已解析，只有变换相关字段按需刷新
+     */
+    struct CachedBatch {
+        RenderBatch batch;
+        const resources::Mesh* mesh = nullptr;          // 用于检测组件内容被直接替换
+        const resources::Material* material = nullptr;
+        DirectX::BoundingSphere localBounds{ { 0.0f, 0.0f, 0.0f }, 0.0f };  // Radius == 0 表示无包围体
+        DirectX::BoundingSphere worldBounds{ { 0.0f, 0.0f, 0.0f }, 0.0f };
+        uint8_t shaderId = 0;
+        uint8_t materialId = 0;
+        uint8_t meshId = 0;
+        bool isSubMesh = false;                         // 来自 MultiMeshComponent
+        bool resolved = false;                          // Shader/VB 已就绪（否则等待资源后重建）
+        bool fallbackShader = false;                    // 正式着色器仍在异步编译，暂用回退着色器
+        uint32_t shaderGeneration = 0;                  // 建立批次时 ShaderCompileService 的 generation
+        uint32_t shaderReloadGeneration = 0;            // 建立批次时的着色器热重载 generation
+        std::vector<LODGeometry> lodLevels;             // [0] = LOD 0；为空表示没有 LOD 链
+        size_t lodChainSize = 0;                        // 组件中 LOD 链的级别数（检测链被替换）
+    };
+    
+    /**
+     * @brief 一个实体的缓存（MeshComponent 和/或 MultiMeshComponent）
+     */
+    struct CachedRenderable {
+        entt::entity entity = entt::null;
+        std::vector<CachedBatch> batches;
+        
+        DirectX::BoundingSphere localBounds{ { 0.0f, 0.0f, 0.0f }, 0.0f };  // 实体整体包围球（Radius == 0 表示无）
+        DirectX::BoundingSphere worldBounds{ { 0.0f, 0.0f, 0.0f }, 0.0f };
+        
+        // 上一次刷新批次矩阵/包围球时 TransformComponent::version 的值
+        uint32_t lastTransformVersion = 0;
+        bool hasSnapshot = false;
+        
+        bool hasLOD = false;                            // 至少一个批次有 LOD 链
+        uint8_t lodLevel = 0;                           // 当前 LOD 级别（整个实体共用，带滞后）
+        
+        bool hasImpostor = false;                       // 有 ImpostorComponent
+        bool usingImpostor = false;                     // 当前以替身绘制（带滞后）
+        float impostorScreenRadius = 0.0f;
+        float impostorRadius = 0.0f;                    // 世界空间半径（0 = 包围球半径）
+        
+        // 本帧以网格绘制时的投影半径（0 = 未绘制，FLT_MAX = 没有包围球），供纹理流式加载使用
+        float visibleScreenRadius = 0.0f;
+    };
+    
+    // === 保留模式缓存管理 ===
+    void ConnectRegistry(entt::registry& registry);
+    void DisconnectRegistry();
+    void OnRenderableChanged(entt::registry& registry, entt::entity entity);
+    void RebuildRenderable(entt::registry& registry, entt::entity entity);
+    void RemoveRenderable(entt::entity entity);
+    bool BuildCachedBatch(const std::shared_ptr<resources::Mesh>& mesh,
+                          const std::shared_ptr<resources::Material>& material,
+                          const components::MeshLODChain* lodChain,
+                          CachedBatch& out);
+    bool ResolveGeometry(const resources::Mesh& mesh, const resources::Shader& shader,
+                         uint8_t renderPass, LODGeometry& out);
+    static void ApplyGeometry(const LODGeometry& geometry, RenderBatch& batch);
+    static uint8_t SelectLODLevel(const CachedRenderable& entry, float screenRadius);
+    bool IsStale(entt::registry& registry, const CachedRenderable& entry) const;
+    void CollectRange(entt::registry& registry, size_t begin, size_t end,
+                      const DirectX::XMFLOAT3& cameraPos, const DirectX::XMFLOAT3& sunPosition, bool sunMoved,
+                      const DirectX::BoundingFrustum* frustum, const OcclusionCuller* occlusion,
+                      std::vector<RenderBatch>& outBatches, std::vector<ImpostorInstance>& outImpostors,
+                      RenderStats& stats);
+    
+    /**
+     * @brief 并行收集的分块输出（复用以避免每帧分配）
+     */
+    struct CollectChunk {
+        size_t begin = 0;
+        size_t end = 0;
+        std::vector<RenderBatch> batches;
+        std::vector<ImpostorInstance> impostors;
+        RenderStats stats;
+    };
+    
+    /**
+     * @brief 基数排序条目（16字节，远小于 RenderBatch）
+     */
+    struct SortEntry {
+        uint64_t key = 0;
+        uint32_t index = 0;       // m_Batches 下标
+    };
+    
+    static constexpr size_t kRadixSortThreshold = 64;  // 少于该数量时直接 std::stable_sort
+    
+    static void RadixSortEntries(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+    
+    /**
+     * @brief 确保 m_SortOrder 覆盖当前所有批次（Sort 之后又 AddBatch 时退化为提交顺序）
+     */
+    void EnsureSortOrder();
+    
+    const RenderBatch& SortedBatch(uint32_t position) const {
+        return m_Batches[m_SortOrder[position]];
+    }
+    
+    /**
+     * @brief 连续可合并批次组成的绘制组
+     */
+    struct DrawGroup {
+        uint32_t firstBatch = 0;  // 排序后位置（m_SortOrder 下标，同时是 ObjectData 下标）
+        uint32_t batchCount = 1;
+        bool instanced = false;   // 多个批次合并为一次实例化绘制
+    };
+    
+    /**
+     * @brief 填充 m_ObjectData，并将排序后的批次划分为绘制组
+     */
+    void BuildDrawGroups();
+    
+    /**
+     * @brief 上传本帧的逐对象数据（必要时扩容结构化缓冲区和下标流）
+     * @return 对象缓冲区可用（否则回退到逐对象常量缓冲区）
+     */
+    bool UploadObjectData(ID3D11DeviceContext* context);
+    void ReleaseObjectBuffers();
+    
+    /**
+     * @brief 同步本帧用到的材质常量缓冲区（立即上下文）
+     */
+    void UpdateMaterialBuffers(ID3D11DeviceContext* context);
+    
+    // 上下文上当前绑定的 VB / IB（ExecuteRange / ExecuteDepthPrePass 的状态缓存）
+    struct GeometryBinding {
+        ID3D11Buffer* vertexBuffer = nullptr;
+        ID3D11Buffer* indexBuffer = nullptr;
+        DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN;
+        uint32_t vertexStride = 0;
+        uint32_t vertexOffset = 0;
+        bool objectStream = false;      // slot 1 绑定了对象下标流
+    };
+
+    void BindGeometry(ID3D11DeviceContext* context, const RenderBatch& batch, bool useObjectBuffer,
+                      GeometryBinding& last, RenderStats& stats) const;
+
+    /**
+     * @brief 在指定上下文上绘制一段连续的绘制组（立即/延迟上下文共用）
+     */
+    void ExecuteRange(ID3D11DeviceContext* context, uint32_t beginGroup, uint32_t endGroup,
+                      ID3D11Buffer* perObjectCB, bool objectBufferReady,
+                      const PassState& passState, RenderStats& stats) const;
+    
+    /**
+     * @brief 深度预通道：只绘制 [0, endGroup) 的不透明绘制组，不绑定像素着色器
+     */
+    void ExecuteDepthPrePass(ID3D11DeviceContext* context, uint32_t endGroup,
+                             ID3D11Buffer* perObjectCB, bool objectBufferReady, RenderStats& stats) const;
+    bool EnsureDepthPrePassShader();
+    
+    /**
+     * @brief 对数深度分段（FrontToBack 排序键），每段约为距离的 1.12 倍
+     */
+    static uint8_t DepthBand(float distanceSquared);
+    
+    // === 延迟上下文 ===
+    struct InheritedState;
+    
+    struct DeferredRange {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        ID3D11DeviceContext* context = nullptr;
+        RenderStats stats;
+    };
+    
+    bool EnsureDeferredContexts(uint32_t count);
+    void ReleaseDeferredContexts();
+    void ExecuteDeferred(ID3D11DeviceContext* context, uint32_t endGroup, uint32_t rangeCount,
+                         ID3D11Buffer* perObjectCB, bool objectBufferReady, const PassState& passState);
+    
+    /**
+     * @brief 绘制资源（默认 Sampler / MaterialBuffer / 各段深度与混合状态），首次 Execute 时获取
+     */
+    bool EnsureDrawResources();
+
     std::vector<RenderBatch> m_Batches;
+    std::vector<ImpostorInstance> m_Impostors;
     RenderStats m_Stats;
+    
+    // === 排序（间接索引，复用以避免每帧分配）===
+    std::vector<SortEntry> m_SortEntries;
+    std::vector<SortEntry> m_SortScratch;
+    std::vector<uint32_t> m_SortOrder;                        // 排序后位置 → m_Batches 下标
+    
+    // === 保留模式缓存 ===
+    entt::registry* m_Registry = nullptr;                     // 已连接信号的 registry
+    std::vector<CachedRenderable> m_Renderables;
+    std::unordered_map<entt::entity, size_t> m_RenderableIndex;  // entity → m_Renderables 下标
+    std::vector<entt::entity> m_PendingRebuild;               // 信号回调只登记，Collect 时统一重建
+    DirectX::XMFLOAT3 m_LastSunPosition = { 0.0f, 0.0f, 0.0f };
+    
+    // === 并行收集 ===
+    bool m_ParallelCollect = true;
+    std::vector<CollectChunk> m_CollectChunks;
+    
+    // 排序ID（跨帧保持稳定）
+    using ShaderKey = std::pair<ID3D11VertexShader*, ID3D11PixelShader*>;
+    std::map<ShaderKey, uint8_t> m_ShaderIDs;
+    std::unordered_map<ID3D11ShaderResourceView*, uint8_t> m_MaterialIDs;
+    std::unordered_map<const resources::Mesh*, uint8_t> m_MeshIDs;   // 池中的 Mesh 共用 VB，按 Mesh 区分
+    
+    // === 实例化 / 整帧对象缓冲区 ===
+    bool m_InstancingEnabled = true;
+    bool m_LODEnabled = true;
+    bool m_ImpostorsEnabled = true;
+    SortMode m_SortMode = SortMode::StateFirst;
+    std::vector<DrawGroup> m_DrawGroups;
+    std::vector<ObjectData> m_ObjectData;
+    ID3D11Buffer* m_ObjectBuffer = nullptr;                // StructuredBuffer<ObjectData>
+    ID3D11ShaderResourceView* m_ObjectSRV = nullptr;
+    ID3D11Buffer* m_ObjectIndexBuffer = nullptr;           // 逐实例 uint 0..capacity-1
+    uint32_t m_ObjectCapacity = 0;
+    
+    // === 延迟上下文 ===
+    bool m_DeferredEnabled = false;
+    std::vector<ID3D11DeviceContext*> m_DeferredContexts;
+    std::vector<ID3D11CommandList*> m_CommandLists;
+    std::vector<DeferredRange> m_DeferredRanges;
+    
+    GpuProfiler* m_GpuProfiler = nullptr;
+    
+    // === 绘制资源（状态对象由 RenderStateCache 持有，不在这里释放）===
+    ID3D11SamplerState* m_DefaultSampler = nullptr;
+    ID3D11Buffer* m_DefaultMaterialCB = nullptr;            // 没有材质的批次（手动添加）使用，全0=不发光
+    ID3D11DepthStencilState* m_LessDepthState = nullptr;    // 深度预通道 / 无预通道的不透明段：LESS + 写深度
+    ID3D11DepthStencilState* m_EqualDepthState = nullptr;   // 预通道之后的不透明着色：EQUAL + 不写深度
+    ID3D11DepthStencilState* m_TransparentDepthState = nullptr;  // 透明段：LESS + 不写深度
+    ID3D11BlendState* m_OpaqueBlendState = nullptr;
+    ID3D11BlendState* m_TransparentBlendState = nullptr;    // SRC_ALPHA / INV_SRC_ALPHA
+    
+    // === 深度预通道 ===
+    bool m_DepthPrePassEnabled = false;
+    std::unique_ptr<resources::Shader> m_DepthShader;
 };
 
 } // namespace outer_wilds
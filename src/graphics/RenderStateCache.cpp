@@ -0,0 +1,271 @@
+#include "RenderStateCache.h"
+#include "../core/DebugManager.h"
+#include <cstring>
+
+namespace outer_wilds {
+
+namespace {
+
+uint64_t HashBytes(const void* data, size_t size) {
+    // FNV-1a 64
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// 规范化：清零填充字节后逐字段复制，使字节哈希 / memcmp 只反映有效字段
+D3D11_BLEND_DESC Canonical(const D3D11_BLEND_DESC& desc) {
+    D3D11_BLEND_DESC out;
+    std::memset(&out, 0, sizeof(out));
+    out.AlphaToCoverageEnable = desc.AlphaToCoverageEnable;
+    out.IndependentBlendEnable = desc.IndependentBlendEnable;
+    // 未启用独立混合时只有 RenderTarget[0] 生效
+    const UINT targets = desc.IndependentBlendEnable ? 8 : 1;
+    for (UINT i = 0; i < targets; i++) {
+        const D3D11_RENDER_TARGET_BLEND_DESC& src = desc.RenderTarget[i];
+        D3D11_RENDER_TARGET_BLEND_DESC& dst = out.RenderTarget[i];
+        dst.BlendEnable = src.BlendEnable;
+        dst.SrcBlend = src.SrcBlend;
+        dst.DestBlend = src.DestBlend;
+        dst.BlendOp = src.BlendOp;
+        dst.SrcBlendAlpha = src.SrcBlendAlpha;
+        dst.DestBlendAlpha = src.DestBlendAlpha;
+        dst.BlendOpAlpha = src.BlendOpAlpha;
+        dst.RenderTargetWriteMask = src.RenderTargetWriteMask;
+    }
+    return out;
+}
+
+D3D11_DEPTH_STENCIL_DESC Canonical(const D3D11_DEPTH_STENCIL_DESC& desc) {
+    D3D11_DEPTH_STENCIL_DESC out;
+    std::memset(&out, 0, sizeof(out));
+    out.DepthEnable = desc.DepthEnable;
+    out.DepthWriteMask = desc.DepthWriteMask;
+    out.DepthFunc = desc.DepthFunc;
+    out.StencilEnable = desc.StencilEnable;
+    out.StencilReadMask = desc.StencilReadMask;
+    out.StencilWriteMask = desc.StencilWriteMask;
+    out.FrontFace = desc.FrontFace;
+    out.BackFace = desc.BackFace;
+    return out;
+}
+
+// 光栅化 / 采样器描述全部为 4 字节字段，没有填充
+D3D11_RASTERIZER_DESC Canonical(const D3D11_RASTERIZER_DESC& desc) { return desc; }
+D3D11_SAMPLER_DESC Canonical(const D3D11_SAMPLER_DESC& desc) { return desc; }
+
+} // namespace
+
+bool RenderStateCache::Initialize(ID3D11Device* device, ID3D11DeviceContext* immediateContext) {
+    if (!device) {
+        return false;
+    }
+    if (m_Device && m_Device != device) {
+        Shutdown();  // 设备重建：旧设备的状态对象不能复用
+    }
+    m_Device = device;
+    m_ImmediateContext = immediateContext;
+    Invalidate();
+    return true;
+}
+
+void RenderStateCache::Shutdown() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ReleaseTable(m_BlendStates);
+    ReleaseTable(m_DepthStencilStates);
+    ReleaseTable(m_RasterizerStates);
+    ReleaseTable(m_SamplerStates);
+    m_Stats = Stats();
+    m_Current = PassState();
+    m_KnownMask = 0;
+    m_Device = nullptr;
+    m_ImmediateContext = nullptr;
+}
+
+template <typename Desc, typename State>
+void RenderStateCache::ReleaseTable(StateTable<Desc, State>& table) {
+    for (auto& [hash, entries] : table.buckets) {
+        for (auto& entry : entries) {
+            if (entry.state) entry.state->Release();
+        }
+    }
+    table.buckets.clear();
+}
+
+template <typename Desc, typename State, typename Create>
+State* RenderStateCache::Lookup(StateTable<Desc, State>& table, const Desc& desc, uint32_t& count, Create create) {
+    const Desc key = Canonical(desc);
+    const uint64_t hash = HashBytes(&key, sizeof(key));
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Device) {
+        return nullptr;
+    }
+    std::vector<typename StateTable<Desc, State>::Entry>& bucket = table.buckets[hash];
+    for (const auto& entry : bucket) {
+        if (std::memcmp(&entry.desc, &key, sizeof(key)) == 0) {
+            return entry.state;
+        }
+    }
+
+    State* state = nullptr;
+    if (FAILED(create(key, &state)) || !state) {
+        DebugManager::GetInstance().Log("RenderStateCache", "Failed to create state object");
+        return nullptr;
+    }
+    bucket.push_back({ key, state });
+    count++;
+    return state;
+}
+
+ID3D11BlendState* RenderStateCache::GetBlendState(const D3D11_BLEND_DESC& desc) {
+    return Lookup(m_BlendStates, desc, m_Stats.blendStates,
+        [this](const D3D11_BLEND_DESC& d, ID3D11BlendState** out) { return m_Device->CreateBlendState(&d, out); });
+}
+
+ID3D11DepthStencilState* RenderStateCache::GetDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc) {
+    return Lookup(m_DepthStencilStates, desc, m_Stats.depthStencilStates,
+        [this](const D3D11_DEPTH_STENCIL_DESC& d, ID3D11DepthStencilState** out) {
+            return m_Device->CreateDepthStencilState(&d, out);
+        });
+}
+
+ID3D11RasterizerState* RenderStateCache::GetRasterizerState(const D3D11_RASTERIZER_DESC& desc) {
+    return Lookup(m_RasterizerStates, desc, m_Stats.rasterizerStates,
+        [this](const D3D11_RASTERIZER_DESC& d, ID3D11RasterizerState** out) {
+            return m_Device->CreateRasterizerState(&d, out);
+        });
+}
+
+ID3D11SamplerState* RenderStateCache::GetSamplerState(const D3D11_SAMPLER_DESC& desc) {
+    return Lookup(m_SamplerStates, desc, m_Stats.samplerStates,
+        [this](const D3D11_SAMPLER_DESC& d, ID3D11SamplerState** out) { return m_Device->CreateSamplerState(&d, out); });
+}
+
+D3D11_BLEND_DESC RenderStateCache::BlendDesc(BlendMode mode) {
+    D3D11_BLEND_DESC desc = {};
+    D3D11_RENDER_TARGET_BLEND_DESC& target = desc.RenderTarget[0];
+    target.BlendEnable = mode != BlendMode::Opaque;
+    target.SrcBlend = D3D11_BLEND_ONE;
+    target.DestBlend = D3D11_BLEND_ZERO;
+    target.BlendOp = D3D11_BLEND_OP_ADD;
+    target.SrcBlendAlpha = D3D11_BLEND_ONE;
+    target.DestBlendAlpha = D3D11_BLEND_ZERO;
+    target.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    target.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+    switch (mode) {
+    case BlendMode::AlphaBlend:
+        target.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+        target.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+        target.DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+        break;
+    case BlendMode::Premultiplied:
+        target.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+        target.DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+        break;
+    case BlendMode::Additive:
+        target.DestBlend = D3D11_BLEND_ONE;
+        target.DestBlendAlpha = D3D11_BLEND_ONE;
+        break;
+    case BlendMode::Opaque:
+        break;
+    }
+    return desc;
+}
+
+D3D11_DEPTH_STENCIL_DESC RenderStateCache::DepthStencilDesc(bool depthTest, bool depthWrite,
+                                                             D3D11_COMPARISON_FUNC func) {
+    D3D11_DEPTH_STENCIL_DESC desc = {};
+    desc.DepthEnable = depthTest ? TRUE : FALSE;
+    desc.DepthWriteMask = depthWrite ? D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+    desc.DepthFunc = func;
+    desc.StencilEnable = FALSE;
+    desc.StencilReadMask = D3D11_DEFAULT_STENCIL_READ_MASK;
+    desc.StencilWriteMask = D3D11_DEFAULT_STENCIL_WRITE_MASK;
+    const D3D11_DEPTH_STENCILOP_DESC stencilOp = {
+        D3D11_STENCIL_OP_KEEP, D3D11_STENCIL_OP_KEEP, D3D11_STENCIL_OP_KEEP, D3D11_COMPARISON_ALWAYS
+    };
+    desc.FrontFace = stencilOp;
+    desc.BackFace = stencilOp;
+    return desc;
+}
+
+D3D11_RASTERIZER_DESC RenderStateCache::RasterizerDesc(D3D11_CULL_MODE cullMode, bool depthClip) {
+    D3D11_RASTERIZER_DESC desc = {};
+    desc.FillMode = D3D11_FILL_SOLID;
+    desc.CullMode = cullMode;
+    desc.FrontCounterClockwise = FALSE;
+    desc.DepthClipEnable = depthClip ? TRUE : FALSE;
+    return desc;
+}
+
+D3D11_SAMPLER_DESC RenderStateCache::SamplerDesc(D3D11_FILTER filter, D3D11_TEXTURE_ADDRESS_MODE address,
+                                                 UINT maxAnisotropy) {
+    D3D11_SAMPLER_DESC desc = {};
+    desc.Filter = filter;
+    desc.AddressU = address;
+    desc.AddressV = address;
+    desc.AddressW = address;
+    desc.MaxAnisotropy = maxAnisotropy;
+    desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+    desc.MinLOD = 0.0f;
+    desc.MaxLOD = D3D11_FLOAT32_MAX;
+    return desc;
+}
+
+void RenderStateCache::Apply(ID3D11DeviceContext* context, const PassState& state) {
+    SetBlendState(context, state.blend);
+    SetDepthStencilState(context, state.depthStencil, state.stencilRef);
+    SetRasterizerState(context, state.rasterizer);
+}
+
+void RenderStateCache::SetBlendState(ID3D11DeviceContext* context, ID3D11BlendState* state) {
+    const bool tracked = context == m_ImmediateContext;
+    if (tracked && (m_KnownMask & kKnownBlend) && m_Current.blend == state) {
+        m_Stats.redundantSkipped++;
+        return;
+    }
+    context->OMSetBlendState(state, nullptr, 0xFFFFFFFF);
+    if (tracked) {
+        m_Stats.stateSets++;
+        m_Current.blend = state;
+        m_KnownMask |= kKnownBlend;
+    }
+}
+
+void RenderStateCache::SetDepthStencilState(ID3D11DeviceContext* context, ID3D11DepthStencilState* state,
+                                            UINT stencilRef) {
+    const bool tracked = context == m_ImmediateContext;
+    if (tracked && (m_KnownMask & kKnownDepth) && m_Current.depthStencil == state &&
+        m_Current.stencilRef == stencilRef) {
+        m_Stats.redundantSkipped++;
+        return;
+    }
+    context->OMSetDepthStencilState(state, stencilRef);
+    if (tracked) {
+        m_Stats.stateSets++;
+        m_Current.depthStencil = state;
+        m_Current.stencilRef = stencilRef;
+        m_KnownMask |= kKnownDepth;
+    }
+}
+
+void RenderStateCache::SetRasterizerState(ID3D11DeviceContext* context, ID3D11RasterizerState* state) {
+    const bool tracked = context == m_ImmediateContext;
+    if (tracked && (m_KnownMask & kKnownRasterizer) && m_Current.rasterizer == state) {
+        m_Stats.redundantSkipped++;
+        return;
+    }
+    context->RSSetState(state);
+    if (tracked) {
+        m_Stats.stateSets++;
+        m_Current.rasterizer = state;
+        m_KnownMask |= kKnownRasterizer;
+    }
+}
+
+} // namespace outer_wilds
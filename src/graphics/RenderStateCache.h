@@ -0,0 +1,145 @@
+#pragma once
+#include <d3d11.h>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 一个通道声明的输出合并 / 光栅化状态
+ *
+ * 状态对象由 RenderStateCache 持有，通道只保存指针（不 AddRef / Release）。
+ * nullptr 即 D3D11 默认状态（不混合 / LESS + 写深度 / 背面剔除）。
+ */
+struct PassState {
+    ID3D11BlendState* blend = nullptr;
+    ID3D11DepthStencilState* depthStencil = nullptr;
+    UINT stencilRef = 0;
+    ID3D11RasterizerState* rasterizer = nullptr;
+};
+
+/**
+ * @brief 混合 / 深度模板 / 光栅化 / 采样器状态对象缓存 + 立即上下文的冗余设置过滤
+ *
+ * 状态对象按描述的哈希（FNV-1a，描述先规范化以清除填充字节和未使用的渲染目标）复用，
+ * 相同描述全程只创建一次，由缓存统一释放（RenderBackend::Shutdown）。
+ *
+ * 各通道在开始时用 Apply 声明自己需要的完整状态，不再用 OMGet* / RSGet* 保存并还原上一个通道的状态：
+ * 缓存记录立即上下文上最后一次设置的状态，相同的设置直接跳过。其它上下文（延迟上下文）不跟踪，总是设置。
+ * 绕过缓存直接修改状态的代码（ImGui 后端等）之后需要调用 Invalidate；RenderSystem 每帧开始时调用一次。
+ *
+ * 混合因子固定为 (1,1,1,1)，采样掩码固定为 0xFFFFFFFF。
+ */
+class RenderStateCache {
+public:
+    enum class BlendMode {
+        Opaque,             // 不混合
+        AlphaBlend,         // SRC_ALPHA / INV_SRC_ALPHA（透明批次）
+        Premultiplied,      // ONE / INV_SRC_ALPHA（预乘结果，大气散射等）
+        Additive            // ONE / ONE
+    };
+
+    struct Stats {
+        uint32_t blendStates = 0;
+        uint32_t depthStencilStates = 0;
+        uint32_t rasterizerStates = 0;
+        uint32_t samplerStates = 0;
+        uint64_t stateSets = 0;             // 立即上下文上实际提交的 OMSet* / RSSetState
+        uint64_t redundantSkipped = 0;      // 与当前状态相同而跳过的设置
+    };
+
+    static RenderStateCache& GetInstance() {
+        static RenderStateCache instance;
+        return instance;
+    }
+
+    RenderStateCache(const RenderStateCache&) = delete;
+    RenderStateCache& operator=(const RenderStateCache&) = delete;
+
+    bool Initialize(ID3D11Device* device, ID3D11DeviceContext* immediateContext);
+    /** @brief 释放全部状态对象（设备销毁之前调用） */
+    void Shutdown();
+    bool IsInitialized() const { return m_Device != nullptr; }
+
+    // === 状态对象（未初始化或创建失败时返回 nullptr）===
+    ID3D11BlendState* GetBlendState(const D3D11_BLEND_DESC& desc);
+    ID3D11BlendState* GetBlendState(BlendMode mode) { return GetBlendState(BlendDesc(mode)); }
+    ID3D11DepthStencilState* GetDepthStencilState(const D3D11_DEPTH_STENCIL_DESC& desc);
+    ID3D11DepthStencilState* GetDepthStencilState(bool depthTest, bool depthWrite,
+                                                  D3D11_COMPARISON_FUNC func = D3D11_COMPARISON_LESS) {
+        return GetDepthStencilState(DepthStencilDesc(depthTest, depthWrite, func));
+    }
+    ID3D11RasterizerState* GetRasterizerState(const D3D11_RASTERIZER_DESC& desc);
+    ID3D11RasterizerState* GetRasterizerState(D3D11_CULL_MODE cullMode, bool depthClip = true) {
+        return GetRasterizerState(RasterizerDesc(cullMode, depthClip));
+    }
+    ID3D11SamplerState* GetSamplerState(const D3D11_SAMPLER_DESC& desc);
+    ID3D11SamplerState* GetSamplerState(D3D11_FILTER filter, D3D11_TEXTURE_ADDRESS_MODE address,
+                                        UINT maxAnisotropy = 1) {
+        return GetSamplerState(SamplerDesc(filter, address, maxAnisotropy));
+    }
+
+    // === 常用描述（在此基础上修改个别字段再 Get）===
+    static D3D11_BLEND_DESC BlendDesc(BlendMode mode);
+    static D3D11_DEPTH_STENCIL_DESC DepthStencilDesc(bool depthTest, bool depthWrite, D3D11_COMPARISON_FUNC func);
+    static D3D11_RASTERIZER_DESC RasterizerDesc(D3D11_CULL_MODE cullMode, bool depthClip);
+    static D3D11_SAMPLER_DESC SamplerDesc(D3D11_FILTER filter, D3D11_TEXTURE_ADDRESS_MODE address, UINT maxAnisotropy);
+
+    // === 设置（立即上下文上过滤冗余设置）===
+    void Apply(ID3D11DeviceContext* context, const PassState& state);
+    void SetBlendState(ID3D11DeviceContext* context, ID3D11BlendState* state);
+    void SetDepthStencilState(ID3D11DeviceContext* context, ID3D11DepthStencilState* state, UINT stencilRef = 0);
+    void SetRasterizerState(ID3D11DeviceContext* context, ID3D11RasterizerState* state);
+
+    /**
+     * @brief 立即上下文上最后一次经由缓存设置的状态（不查询设备；Invalidate 之后未设置的字段为 nullptr）
+     */
+    const PassState& GetCurrent() const { return m_Current; }
+
+    /** @brief 忘记立即上下文的当前状态，下一次设置必定提交 */
+    void Invalidate() { m_KnownMask = 0; m_Current = PassState(); }
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    RenderStateCache() = default;
+    ~RenderStateCache() { Shutdown(); }
+
+    template <typename Desc, typename State>
+    struct StateTable {
+        struct Entry {
+            Desc desc;
+            State* state = nullptr;
+        };
+        std::unordered_map<uint64_t, std::vector<Entry>> buckets;
+    };
+
+    template <typename Desc, typename State, typename Create>
+    State* Lookup(StateTable<Desc, State>& table, const Desc& desc, uint32_t& count, Create create);
+
+    template <typename Desc, typename State>
+    static void ReleaseTable(StateTable<Desc, State>& table);
+
+    enum KnownBits : uint32_t {
+        kKnownBlend = 1u << 0,
+        kKnownDepth = 1u << 1,
+        kKnownRasterizer = 1u << 2
+    };
+
+    ID3D11Device* m_Device = nullptr;
+    ID3D11DeviceContext* m_ImmediateContext = nullptr;
+    std::mutex m_Mutex;     // 只保护查找 / 创建（设置只在各自的上下文线程上进行）
+
+    StateTable<D3D11_BLEND_DESC, ID3D11BlendState> m_BlendStates;
+    StateTable<D3D11_DEPTH_STENCIL_DESC, ID3D11DepthStencilState> m_DepthStencilStates;
+    StateTable<D3D11_RASTERIZER_DESC, ID3D11RasterizerState> m_RasterizerStates;
+    StateTable<D3D11_SAMPLER_DESC, ID3D11SamplerState> m_SamplerStates;
+
+    PassState m_Current;
+    uint32_t m_KnownMask = 0;
+    Stats m_Stats;
+};
+
+} // namespace outer_wilds
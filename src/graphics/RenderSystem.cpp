@@ -2,13 +2,25 @@
 #include "../scene/Scene.h"
 #include "../scene/SceneManager.h"
 #include "components/CameraComponent.h"
+#include "resources/TextureStreamer.h"
+#include "resources/GeometryPool.h"
+#include "resources/TextureArrayAtlas.h"
+#include "GpuMemory.h"
+#include "RenderStateCache.h"
 #include "../scene/components/TransformComponent.h"
+#include "../physics/components/SectorComponent.h"
 #include "../core/DebugManager.h"
 #include "../core/Engine.h"
+#include "../core/Profiler.h"
+#include "../input/InputManager.h"
+#include "../input/InputRecorder.h"
 #include "../ui/UISystem.h"
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 #include <d3d11.h>
+#include <cmath>
 #include <iostream>
+#include <string>
 
 namespace outer_wilds {
 
@@ -16,6 +28,47 @@ void RenderSystem::Initialize(SceneManager* sceneManager) {
     m_SceneManager = sceneManager;
     m_Backend = std::make_unique<RenderBackend>();
     m_SkyboxRenderer = std::make_unique<SkyboxRenderer>();
+    m_ImpostorRenderer = std::make_unique<ImpostorRenderer>();
+    m_GpuInstanceRenderer = std::make_unique<GpuInstanceRenderer>();
+    m_ShadowRenderer = std::make_unique<ShadowRenderer>();
+    m_ClusteredLighting = std::make_unique<ClusteredLighting>();
+    m_AtmosphereRenderer = std::make_unique<AtmosphereRenderer>();
+    m_DynamicResolution = std::make_unique<DynamicResolution>();
+    m_RenderQueue.SetDepthPrePassEnabled(true);
+}
+
+void RenderSystem::Shutdown() {
+    m_SkyboxRenderer.reset();
+    m_ImpostorRenderer.reset();
+    m_GpuInstanceRenderer.reset();
+    m_ShadowRenderer.reset();
+    m_ClusteredLighting.reset();
+    m_AtmosphereRenderer.reset();
+    m_DynamicResolution.reset();
+    m_SkyboxInitialized = false;
+    m_ImpostorInitAttempted = false;
+    m_GpuInstanceInitAttempted = false;
+    m_ShadowInitAttempted = false;
+    m_ClusteredLightingInitAttempted = false;
+    m_AtmosphereInitAttempted = false;
+    m_DynamicResolutionInitAttempted = false;
+}
+
+void RenderSystem::EnsureAtmosphereRenderer(ID3D11Device* device) {
+    if (!m_AtmosphereRenderer || m_AtmosphereInitAttempted || !device) return;
+    m_AtmosphereInitAttempted = true;
+    if (!m_AtmosphereRenderer->Initialize(device)) {
+        std::cout << "[RenderSystem] Atmosphere renderer unavailable, AtmosphereComponent skipped" << std::endl;
+    }
+}
+
+void RenderSystem::PrepareScene(entt::registry& registry) {
+    if (!m_Backend) return;
+    EnsureAtmosphereRenderer(static_cast<ID3D11Device*>(m_Backend->GetDevice()));
+    if (m_AtmosphereRenderer && m_AtmosphereRenderer->IsInitialized()) {
+        const uint32_t built = m_AtmosphereRenderer->Prepare(registry);
+        DebugManager::GetInstance().Log("RenderSystem", "Precomputed atmosphere LUTs: " + std::to_string(built));
+    }
 }
 
 void RenderSystem::Update(float deltaTime, entt::registry& registry) {
@@ -25,6 +78,14 @@ void RenderSystem::Update(float deltaTime, entt::registry& registry) {
     
     if (!m_Backend) return;
 
+    // 加载线程新分配的 GeometryPool 区间 / TextureArrayAtlas 层：复制到共享页（本帧任何绘制之前）。
+    // 在所有提前返回之前执行：无窗口基准（WARP 设备）和没有相机的帧也要清空队列，否则暂存缓冲无限堆积
+    auto context = static_cast<ID3D11DeviceContext*>(m_Backend->GetContext());
+    if (context) {
+        resources::GeometryPool::GetInstance().FlushUploads(context);
+        resources::TextureArrayAtlas::GetInstance().FlushCopies(context);
+    }
+
     // Get current active scene
     auto scenePtr = m_SceneManager->GetActiveScene();
     if (!scenePtr) {
@@ -32,18 +93,39 @@ void RenderSystem::Update(float deltaTime, entt::registry& registry) {
         return;
     }
 
-    // Find active camera
-    auto camera = FindActiveCamera(scenePtr->GetRegistry());
+    // 活动相机（CameraService 缓存句柄，切换视角时才重新查找）
+    auto& cameraService = CameraService::GetInstance();
+    auto camera = cameraService.ResolveActiveCamera(scenePtr->GetRegistry());
     if (!camera) {
         if (shouldDebug) DebugManager::GetInstance().Log("RenderSystem", "No active camera found");
         return;
     }
 
+    // 无窗口基准模式：只做收集/剔除/排序，不提交任何绘制
+    if (m_Backend->IsHeadless()) {
+        PrepareQueue(cameraService.BeginFrame(*camera), scenePtr->GetRegistry(), GetSunPosition(scenePtr->GetRegistry()));
+        return;
+    }
+
+    // GPU 分段计时：EndFrame 在 RenderBackend::EndFrame 中（Present 之前）
+    GpuProfiler* gpuProfiler = &m_Backend->GetGpuProfiler();
+    gpuProfiler->BeginFrame(context);
+
+    // 后期锁存：在副本上叠加最新的鼠标移动，组件本身保留模拟写入的朝向
+    components::CameraComponent latchedCamera = *camera;
+    if (ApplyLateLatch(latchedCamera)) {
+        camera = &latchedCamera;
+    }
+
+    // 本帧的矩阵 / 视锥只算一次，剔除、阴影、天空盒以及下一帧的音频 / 地形 LOD 共用
+    const CameraFrame& cameraFrame = cameraService.BeginFrame(*camera);
+
     // Render all entities
-    RenderScene(camera, scenePtr->GetRegistry(), shouldDebug);
+    RenderScene(cameraFrame, scenePtr->GetRegistry(), shouldDebug);
 
     // Render UI (after scene, before Present)
     if (auto uiSystem = Engine::GetInstance().GetUISystem()) {
+        GPU_PROFILE_SCOPE(gpuProfiler, context, "UI");
         uiSystem->Render();
     }
 
@@ -51,94 +133,76 @@ void RenderSystem::Update(float deltaTime, entt::registry& registry) {
     m_Backend->Present();
 }
 
-bool RenderSystem::InitializeBackend(void* hwnd, int width, int height) {
+bool RenderSystem::InitializeBackend(void* hwnd, int width, int height, bool headless) {
     if (!m_Backend) {
         m_Backend = std::make_unique<RenderBackend>();
     }
-    return m_Backend->Initialize(hwnd, width, height);
+    if (headless) {
+        // 没有 GPU 计时，替身/阴影渲染器不会初始化（收集阶段仍输出替身统计）
+        return m_Backend->InitializeHeadless(width, height);
+    }
+    if (!m_Backend->Initialize(hwnd, width, height)) {
+        return false;
+    }
+    m_FrameGraph.Initialize(static_cast<ID3D11Device*>(m_Backend->GetDevice()));
+
+    GpuProfiler* gpuProfiler = &m_Backend->GetGpuProfiler();
+    m_RenderQueue.SetGpuProfiler(gpuProfiler);
+    if (m_SkyboxRenderer) {
+        m_SkyboxRenderer->SetGpuProfiler(gpuProfiler);
+    }
+    return true;
 }
 
-void RenderSystem::RenderScene(components::CameraComponent* camera, entt::registry& registry, bool shouldDebug) {
-    if (!m_Backend || !camera) return;
+void RenderSystem::RenderScene(const CameraFrame& camera, entt::registry& registry, bool shouldDebug) {
+    if (!m_Backend || !camera.valid) return;
 
     auto device = static_cast<ID3D11Device*>(m_Backend->GetDevice());
     auto context = static_cast<ID3D11DeviceContext*>(m_Backend->GetContext());
     if (!device || !context) return;
 
-    // Set render targets
-    auto renderTargetView = static_cast<ID3D11RenderTargetView*>(m_Backend->GetRenderTargetView());
+    // 后缓冲区（及其深度）作为导入资源交给帧图
+    auto backBufferView = static_cast<ID3D11RenderTargetView*>(m_Backend->GetRenderTargetView());
     auto depthStencilView = static_cast<ID3D11DepthStencilView*>(m_Backend->GetDepthStencilView());
-    if (!renderTargetView || !depthStencilView) return;
+    if (!backBufferView || !depthStencilView) return;
+    const uint32_t outputWidth = static_cast<uint32_t>(m_Backend->GetWidth());
+    const uint32_t outputHeight = static_cast<uint32_t>(m_Backend->GetHeight());
     
-    context->OMSetRenderTargets(1, &renderTargetView, depthStencilView);
-
-    // Set viewport
-    D3D11_VIEWPORT viewport = {};
-    viewport.TopLeftX = 0.0f;
-    viewport.TopLeftY = 0.0f;
-    viewport.Width = 1280.0f;
-    viewport.Height = 720.0f;
-    viewport.MinDepth = 0.0f;
-    viewport.MaxDepth = 1.0f;
-    context->RSSetViewports(1, &viewport);
-
-    // Clear render targets (深空黑色背景)
-    float clearColor[4] = { 0.01f, 0.01f, 0.02f, 1.0f }; // 深空背景
-    context->ClearRenderTargetView(renderTargetView, clearColor);
-    context->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
-
-    // Setup render states
-    static ID3D11DepthStencilState* s_depthState = nullptr;
-    static ID3D11RasterizerState* s_rastState = nullptr;
-
-    if (!s_depthState) {
-        D3D11_DEPTH_STENCIL_DESC depthDesc = {};
-        depthDesc.DepthEnable = TRUE;
-        depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
-        depthDesc.DepthFunc = D3D11_COMPARISON_LESS;
-        device->CreateDepthStencilState(&depthDesc, &s_depthState);
-    }
-    if (!s_rastState) {
-        D3D11_RASTERIZER_DESC rastDesc = {};
-        rastDesc.FillMode = D3D11_FILL_SOLID;
-        rastDesc.CullMode = D3D11_CULL_NONE;  // 暂时禁用背面剔除来调试
-        rastDesc.FrontCounterClockwise = FALSE;
-        rastDesc.DepthClipEnable = TRUE;
-        device->CreateRasterizerState(&rastDesc, &s_rastState);
-    }
-
-    context->OMSetDepthStencilState(s_depthState, 0);
-    context->RSSetState(s_rastState);
-
-    // Setup camera matrices
-    DirectX::XMVECTOR eyePos = DirectX::XMLoadFloat3(&camera->position);
-    DirectX::XMVECTOR lookAt = DirectX::XMLoadFloat3(&camera->target);
-    DirectX::XMVECTOR upDir = DirectX::XMLoadFloat3(&camera->up);
-
-    DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(eyePos, lookAt, upDir);
-    DirectX::XMMATRIX projection = DirectX::XMMatrixPerspectiveFovLH(
-        camera->fov * DirectX::XM_PI / 180.0f,
-        camera->aspectRatio,
-        camera->nearPlane,
-        camera->farPlane
-    );
-    DirectX::XMMATRIX viewProjection = DirectX::XMMatrixMultiply(view, projection);
+    // 动态分辨率：场景改为渲染到帧图瞬态目标的缩放子区域，初始化失败时直接渲染到后缓冲区
+    if (m_DynamicResolution && !m_DynamicResolutionInitAttempted) {
+        m_DynamicResolutionInitAttempted = true;
+        if (!m_DynamicResolution->Initialize(device)) {
+            std::cout << "[RenderSystem] Dynamic resolution unavailable, rendering at native resolution" << std::endl;
+        }
+    }
+    uint32_t renderWidth = outputWidth;
+    uint32_t renderHeight = outputHeight;
+    const bool dynamicResolution = m_DynamicResolution && m_DynamicResolution->IsInitialized();
+    if (dynamicResolution) {
+        m_DynamicResolution->BeginScene(context, outputWidth, outputHeight);
+        renderWidth = m_DynamicResolution->GetRenderWidth();
+        renderHeight = m_DynamicResolution->GetRenderHeight();
+    }
+
+    // 场景通道状态：各通道（天空盒烘焙 / 阴影 / 替身 / 队列 / 天空盒 / 大气）自己声明状态，不再互相保存还原；
+    // RenderStateCache 复用状态对象并跳过冗余设置。UI (ImGui) 在上一帧末尾绕过了缓存，先让缓存忘记当前状态
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    stateCache.Invalidate();
+    PassState sceneState;
+    sceneState.blend = stateCache.GetBlendState(RenderStateCache::BlendMode::Opaque);
+    sceneState.depthStencil = stateCache.GetDepthStencilState(true, true, D3D11_COMPARISON_LESS);
+    sceneState.rasterizer = stateCache.GetRasterizerState(m_BackfaceCulling ? D3D11_CULL_BACK : D3D11_CULL_NONE);
+
+    // 相机矩阵（CameraService::BeginFrame 已计算）
+    const DirectX::XMMATRIX viewProjection = camera.GetViewProjection();
 
     // ============================================
-    // 1. 渲染星空天空盒（最先渲染，深度最远）
+    // 1. 星空天空盒：初始化（烘焙和绘制都是帧图通道）
     // ============================================
-    if (m_SkyboxRenderer) {
-        // 初始化天空盒（如果尚未初始化）
-        static bool skyboxInitialized = false;
-        if (!skyboxInitialized) {
-            if (m_SkyboxRenderer->Initialize(device)) {
-                skyboxInitialized = true;
-                std::cout << "[RenderSystem] Skybox initialized" << std::endl;
-            }
-        }
-        
-        if (skyboxInitialized) {
-            m_SkyboxRenderer->Render(context, viewProjection, camera->position, m_Time);
+    if (m_SkyboxRenderer && !m_SkyboxInitialized) {
+        if (m_SkyboxRenderer->Initialize(device)) {
+            m_SkyboxInitialized = true;
+            std::cout << "[RenderSystem] Skybox initialized" << std::endl;
         }
     }
 
@@ -171,14 +235,16 @@ void RenderSystem::RenderScene(components::CameraComponent* camera, entt::regist
         cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
         cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
         device->CreateBuffer(&cbDesc, nullptr, &s_perFrameCB);
+        GpuMemory::Track(s_perFrameCB);
     }
     if (!m_PerObjectCB) {
         D3D11_BUFFER_DESC cbDesc = {};
         cbDesc.Usage = D3D11_USAGE_DYNAMIC;
-        cbDesc.ByteWidth = 96;  // world(64) + color(16) + objectCenter(12) + isSphere(4) = 96
+        cbDesc.ByteWidth = 112;  // world(64) + color(16) + lightDir(12) + isSphere(4) + receiveShadows(4) + padding(12) = 112
         cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
         cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
         device->CreateBuffer(&cbDesc, nullptr, &m_PerObjectCB);
+        GpuMemory::Track(m_PerObjectCB);
     }
 
     // Update per-frame constant buffer
@@ -187,7 +253,7 @@ void RenderSystem::RenderScene(components::CameraComponent* camera, entt::regist
         if (SUCCEEDED(context->Map(s_perFrameCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
             PerFrameData* data = static_cast<PerFrameData*>(mapped.pData);
             data->viewProjection = DirectX::XMMatrixTranspose(viewProjection);
-            data->cameraPosition = camera->position;
+            data->cameraPosition = camera.position;
             data->time = m_Time;
             data->sunPosition = sunPosition;
             data->sunIntensity = 1.2f;  // 太阳光强度
@@ -196,23 +262,328 @@ void RenderSystem::RenderScene(components::CameraComponent* camera, entt::regist
             
             context->Unmap(s_perFrameCB, 0);
         }
-        context->VSSetConstantBuffers(0, 1, &s_perFrameCB);
-        context->PSSetConstantBuffers(0, 1, &s_perFrameCB);
     }
 
     // ============================================
     // 3. 渲染场景物体
     // ============================================
     
+    // 替身渲染器必须在收集之前就绪，否则被替换掉的天体会整帧消失
+    if (m_ImpostorRenderer && !m_ImpostorInitAttempted) {
+        m_ImpostorInitAttempted = true;
+        if (!m_ImpostorRenderer->Initialize(device)) {
+            m_RenderQueue.SetImpostorsEnabled(false);
+            std::cout << "[RenderSystem] Impostor renderer unavailable, distant bodies use meshes" << std::endl;
+        }
+    }
+    if (m_GpuInstanceRenderer && !m_GpuInstanceInitAttempted) {
+        m_GpuInstanceInitAttempted = true;
+        if (!m_GpuInstanceRenderer->Initialize(device)) {
+            std::cout << "[RenderSystem] GPU instance renderer unavailable, GpuInstancedComponent skipped" << std::endl;
+        }
+    }
+    if (m_ShadowRenderer && !m_ShadowInitAttempted) {
+        m_ShadowInitAttempted = true;
+        if (!m_ShadowRenderer->Initialize(device)) {
+            m_ShadowsEnabled = false;
+            std::cout << "[RenderSystem] Shadow renderer unavailable, shadows disabled" << std::endl;
+        }
+    }
+    if (m_ClusteredLighting && !m_ClusteredLightingInitAttempted) {
+        m_ClusteredLightingInitAttempted = true;
+        if (!m_ClusteredLighting->Initialize(device)) {
+            m_ClusteredLightingEnabled = false;
+            std::cout << "[RenderSystem] Clustered lighting unavailable, local lights disabled" << std::endl;
+        }
+    }
+    EnsureAtmosphereRenderer(device);
+    
+    // 1-2. 遮挡/视锥剔除、收集并排序批次
+    PrepareQueue(camera, registry, sunPosition);
+    
+    // ============================================
+    // 4. 帧图：通道声明读写，未被使用的通道剔除，场景目标从瞬态池分配
+    // ============================================
+    m_FrameGraph.Reset();
+
+    FrameGraphTextureDesc outputDesc;
+    outputDesc.width = outputWidth;
+    outputDesc.height = outputHeight;
+    outputDesc.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    outputDesc.bindFlags = D3D11_BIND_RENDER_TARGET;
+    FrameGraphTextureDesc depthDesc = outputDesc;
+    depthDesc.format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    depthDesc.bindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+    // 场景视口：动态分辨率时只用目标左上角的子区域
+    D3D11_VIEWPORT sceneViewport = {};
+    sceneViewport.Width = static_cast<float>(renderWidth);
+    sceneViewport.Height = static_cast<float>(renderHeight);
+    sceneViewport.MaxDepth = 1.0f;
+
+    const FrameGraphResource backBuffer = m_FrameGraph.Import("BackBuffer", outputDesc, backBufferView);
+    const FrameGraphResource backBufferDepth =
+        m_FrameGraph.Import("BackBufferDepth", depthDesc, nullptr, depthStencilView);
+    m_FrameGraph.MarkOutput(backBuffer);
+
+    // 跨帧缓存的结果（立方体贴图 / 阴影图 / 光源簇）由各渲染器持有，导入只表达依赖，视图为空
+    FrameGraphResource starfield = kInvalidFrameGraphResource;
+    if (m_SkyboxRenderer && m_SkyboxInitialized) {
+        starfield = m_FrameGraph.Import("StarfieldCubemap", FrameGraphTextureDesc());
+        m_FrameGraph.AddPass("SkyboxBake",
+            [&](FrameGraph::Builder& builder) { builder.Write(starfield); },
+            [&](ID3D11DeviceContext* ctx, const FrameGraph::Resources&) {
+                m_SkyboxRenderer->UpdateCubemap(ctx, m_Time);
+            });
+    }
+
+    // 级联阴影：复用本帧收集到的批次（世界矩阵/LOD），在场景通道之前更新阴影图
+    const bool shadows = m_ShadowsEnabled && m_ShadowRenderer && m_ShadowRenderer->IsInitialized();
+    FrameGraphResource shadowMap = kInvalidFrameGraphResource;
+    ShadowRenderer::View shadowView;
+    if (shadows) {
+        shadowView.view = camera.GetView();
+        shadowView.fovY = camera.fovY;
+        shadowView.aspectRatio = camera.aspectRatio;
+        shadowView.nearPlane = camera.nearPlane;
+        shadowView.cameraPosition = camera.position;
+        shadowView.sunPosition = sunPosition;
+        FindShadowReferenceFrame(registry, camera.position, shadowView);
+        shadowMap = m_FrameGraph.Import("ShadowMap", FrameGraphTextureDesc());
+        m_FrameGraph.AddPass("Shadows",
+            [&](FrameGraph::Builder& builder) { builder.Write(shadowMap); },
+            [&](ID3D11DeviceContext* ctx, const FrameGraph::Resources&) {
+                GPU_PROFILE_SCOPE(&m_Backend->GetGpuProfiler(), ctx, "Shadows");
+                m_ShadowRenderer->Render(ctx, shadowView, m_RenderQueue);
+            });
+    } else if (m_ShadowRenderer) {
+        m_ShadowRenderer->Unbind(context);
+    }
+    
+    // 局部光源装箱到观察空间簇，供 textured.ps 的 ShadeLocalLights 使用
+    const bool clusteredLighting =
+        m_ClusteredLightingEnabled && m_ClusteredLighting && m_ClusteredLighting->IsInitialized();
+    FrameGraphResource lightClusters = kInvalidFrameGraphResource;
+    if (clusteredLighting) {
+        lightClusters = m_FrameGraph.Import("LightClusters", FrameGraphTextureDesc());
+        m_FrameGraph.AddPass("ClusteredLighting",
+            [&](FrameGraph::Builder& builder) { builder.Write(lightClusters); },
+            [&](ID3D11DeviceContext* ctx, const FrameGraph::Resources&) {
+                m_ClusteredLighting->Update(ctx, registry, camera, sceneViewport);
+            });
+    } else if (m_ClusteredLighting) {
+        m_ClusteredLighting->Unbind(context);
+    }
+
+    // 场景：动态分辨率时渲染到与后缓冲区等大的瞬态目标（缩放只改视口），否则直接渲染到后缓冲区
+    FrameGraphResource sceneColor = backBuffer;
+    FrameGraphResource sceneDepth = backBufferDepth;
+    m_FrameGraph.AddPass("Scene",
+        [&](FrameGraph::Builder& builder) {
+            if (dynamicResolution) {
+                FrameGraphTextureDesc colorDesc = outputDesc;
+                colorDesc.bindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+                sceneColor = builder.Create("SceneColor", colorDesc);
+                sceneDepth = builder.Create("SceneDepth", depthDesc);
+            }
+            builder.WriteColor(sceneColor);
+            builder.WriteDepth(sceneDepth);
+            builder.Read(starfield);
+            builder.Read(shadowMap);
+            builder.Read(lightClusters);
+        },
+        [&](ID3D11DeviceContext* ctx, const FrameGraph::Resources& resources) {
+            ctx->RSSetViewports(1, &sceneViewport);
+
+            // Clear render targets (深空黑色背景)
+            const float clearColor[4] = { 0.01f, 0.01f, 0.02f, 1.0f };
+            ctx->ClearRenderTargetView(resources.GetRTV(sceneColor), clearColor);
+            ctx->ClearDepthStencilView(resources.GetDSV(sceneDepth), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+
+            // 天空盒烘焙 / 阴影会占用 b0，场景的 PerFrameBuffer 在这里绑定
+            ctx->VSSetConstantBuffers(0, 1, &s_perFrameCB);
+            ctx->PSSetConstantBuffers(0, 1, &s_perFrameCB);
+            if (shadows) {
+                m_ShadowRenderer->Bind(ctx);
+            }
+            if (clusteredLighting) {
+                m_ClusteredLighting->Bind(ctx);
+            }
+            stateCache.Apply(ctx, sceneState);
+
+            // 远处天体替身：一次实例化绘制，先于网格写入深度
+            if (m_ImpostorRenderer) {
+                m_ImpostorRenderer->Render(ctx, m_RenderQueue.GetImpostors());
+            }
+
+            // GPU 驱动实例：计算着色器剔除（复用本帧 Hi-Z）+ 间接绘制，同样先于网格写入深度
+            if (m_GpuInstanceRenderer && m_GpuInstanceRenderer->IsInitialized()) {
+                GPU_PROFILE_SCOPE(&m_Backend->GetGpuProfiler(), ctx, "GpuInstances");
+                const OcclusionCuller* occlusion =
+                    m_OcclusionCullingEnabled && m_OcclusionCuller.HasOccluders() ? &m_OcclusionCuller : nullptr;
+                m_GpuInstanceRenderer->Render(ctx, registry, camera, occlusion, sunPosition);
+            }
+
+            // 执行绘制（带状态缓存）；天空盒在不透明段之后以最远深度 LESS_EQUAL 填充剩余像素，
+            // 大气外壳随后叠加在天空盒与行星之上、透明物体之前
+            m_RenderQueue.Execute(ctx, m_PerObjectCB, sunPosition, [&](ID3D11DeviceContext* segmentContext) {
+                if (m_SkyboxRenderer && m_SkyboxInitialized) {
+                    m_SkyboxRenderer->Render(segmentContext, viewProjection, camera.position, m_Time);
+                }
+                if (m_AtmosphereRenderer && m_AtmosphereRenderer->IsInitialized()) {
+                    GPU_PROFILE_SCOPE(&m_Backend->GetGpuProfiler(), segmentContext, "Atmosphere");
+                    m_AtmosphereRenderer->Render(segmentContext, registry, camera);
+                }
+            });
+        });
+
+    // 拉伸到后缓冲区（帧图绑定后缓冲区和场景纹理 t0，之后解除 t0）
+    if (dynamicResolution) {
+        m_FrameGraph.AddPass("Resolve",
+            [&](FrameGraph::Builder& builder) {
+                builder.ReadTexture(sceneColor, 0);
+                builder.WriteColor(backBuffer);
+            },
+            [&](ID3D11DeviceContext* ctx, const FrameGraph::Resources& resources) {
+                const FrameGraphTextureDesc& sceneDesc = resources.GetDesc(sceneColor);
+                m_DynamicResolution->Resolve(ctx, sceneDesc.width, sceneDesc.height);
+            });
+    }
+
+    if (!m_FrameGraph.Compile()) {
+        return;
+    }
+    m_FrameGraph.Execute(context);
+
+    // UISystem 随后以原生分辨率绘制到后缓冲区
+    if (dynamicResolution) {
+        context->OMSetRenderTargets(1, &backBufferView, depthStencilView);
+    }
+}
+
+bool RenderSystem::ApplyLateLatch(components::CameraComponent& camera) const {
+    using namespace DirectX;
+    if (!m_LateLatchEnabled || camera.lateLatchSensitivity <= 0.0f) return false;
+    if (InputRecorder::GetInstance().GetMode() == InputRecorder::Mode::Replaying) return false;
+
+    int deltaX = 0;
+    int deltaY = 0;
+    if (!InputManager::GetInstance().PeekLateLookDelta(deltaX, deltaY) || (deltaX == 0 && deltaY == 0)) {
+        return false;
+    }
+
+    const XMVECTOR position = XMLoadFloat3(&camera.position);
+    const XMVECTOR up = XMVector3Normalize(XMLoadFloat3(&camera.up));
+    XMVECTOR forward = XMVectorSubtract(XMLoadFloat3(&camera.target), position);
+    const float distance = XMVectorGetX(XMVector3Length(forward));
+    if (distance < 1e-6f) return false;
+    forward = XMVectorScale(forward, 1.0f / distance);
+
+    // 左手系：绕 up 正向旋转使前方转向右方，绕 right 正向旋转使前方向下
+    const float yaw = static_cast<float>(deltaX) * camera.lateLatchSensitivity;
+    const float pitch = static_cast<float>(deltaY) * camera.lateLatchSensitivity;
+    forward = XMVector3Rotate(forward, XMQuaternionRotationNormal(up, yaw));
+    const XMVECTOR right = XMVector3Cross(up, forward);
+    if (XMVectorGetX(XMVector3LengthSq(right)) > 1e-8f) {
+        const XMVECTOR pitched = XMVector3Rotate(forward, XMQuaternionRotationNormal(XMVector3Normalize(right), pitch));
+        // 与模拟侧的俯仰限制一致：不越过 up 方向
+        if (std::abs(XMVectorGetX(XMVector3Dot(pitched, up))) < 0.995f) {
+            forward = pitched;
+        }
+    }
+
+    XMStoreFloat3(&camera.target, XMVectorAdd(position, XMVectorScale(forward, distance)));
+    return true;
+}
+
+void RenderSystem::PrepareQueue(const CameraFrame& camera, entt::registry& registry,
+                                const DirectX::XMFLOAT3& sunPosition) {
+    // 星球作为遮挡球光栅化到 Hi-Z，收集时剔除星球背面的实体
+    const OcclusionCuller* occlusion = nullptr;
+    if (m_OcclusionCullingEnabled) {
+        PROFILE_SCOPE("Render::Occlusion");
+        m_OcclusionCuller.Begin(camera.GetView(), camera.GetProjection(), camera.nearPlane);
+        auto sectors = registry.view<components::SectorComponent>();
+        for (auto entity : sectors) {
+            const auto& sector = sectors.get<components::SectorComponent>(entity);
+            if (!sector.isActive) continue;
+            const auto* transform = registry.try_get<TransformComponent>(entity);
+            m_OcclusionCuller.AddSphereOccluder(transform ? transform->position : sector.worldPosition,
+                                                sector.planetRadius);
+        }
+        m_OcclusionCuller.BuildPyramid();
+        if (m_OcclusionCuller.HasOccluders()) {
+            occlusion = &m_OcclusionCuller;
+        }
+    }
+    
+    // 没有深度预通道时每个被覆盖的像素都要跑完整着色，改为近到远排序
+    m_RenderQueue.SetSortMode(m_RenderQueue.IsDepthPrePassEnabled() ? RenderQueue::SortMode::StateFirst
+                                                                    : RenderQueue::SortMode::FrontToBack);
+    
     // 1. 清空并收集批次（传入 sunPosition 用于计算光照方向）
-    m_RenderQueue.Clear();
-    m_RenderQueue.CollectFromECS(registry, camera->position, sunPosition);
+    {
+        PROFILE_SCOPE("Render::Collect");
+        m_RenderQueue.Clear();
+        m_RenderQueue.CollectFromECS(registry, camera.position, sunPosition, &camera.frustum, occlusion);
+    }
     
-    // 2. 排序（优化状态切换）
-    m_RenderQueue.Sort();
+    // 可见纹理的投影尺寸 → 高分辨率 mip 的加载 / LRU 回退
+    {
+        PROFILE_SCOPE("Render::TextureStreaming");
+        auto& streamer = resources::TextureStreamer::GetInstance();
+        streamer.SetViewportHeight(static_cast<uint32_t>(m_Backend->GetHeight()));
+        m_RenderQueue.UpdateTextureStreaming();
+        streamer.Update();
+    }
     
-    // 3. 执行绘制（带状态缓存）
-    m_RenderQueue.Execute(context, m_PerObjectCB, sunPosition);
+    // 2. 排序（优化状态切换）
+    {
+        PROFILE_SCOPE("Render::Sort");
+        m_RenderQueue.Sort();
+    }
+}
+
+/**
+ * @brief 相机所在天体的参考系（influenceRadius 覆盖相机、priority 最高的扇区）
+ *
+ * 只取旋转与平移（刚体），找不到时保持单位矩阵，缓存级联退化为世界空间缓存。
+ */
+void RenderSystem::FindShadowReferenceFrame(entt::registry& registry, const DirectX::XMFLOAT3& cameraPosition,
+                                            ShadowRenderer::View& shadowView) {
+    const components::SectorComponent* best = nullptr;
+    entt::entity bestEntity = entt::null;
+
+    auto sectors = registry.view<components::SectorComponent>();
+    for (auto entity : sectors) {
+        const auto& sector = sectors.get<components::SectorComponent>(entity);
+        if (!sector.isActive) continue;
+        const auto* transform = registry.try_get<TransformComponent>(entity);
+        const DirectX::XMFLOAT3& center = transform ? transform->position : sector.worldPosition;
+        const float dx = cameraPosition.x - center.x;
+        const float dy = cameraPosition.y - center.y;
+        const float dz = cameraPosition.z - center.z;
+        if (dx * dx + dy * dy + dz * dz > sector.influenceRadius * sector.influenceRadius) continue;
+        if (!best || sector.priority > best->priority) {
+            best = &sector;
+            bestEntity = entity;
+        }
+    }
+
+    if (!best) {
+        return;
+    }
+
+    const auto* transform = registry.try_get<TransformComponent>(bestEntity);
+    if (transform) {
+        shadowView.referenceFrame =
+            DirectX::XMMatrixRotationQuaternion(DirectX::XMLoadFloat4(&transform->rotation)) *
+            DirectX::XMMatrixTranslation(transform->position.x, transform->position.y, transform->position.z);
+    } else {
+        shadowView.referenceFrame =
+            DirectX::XMMatrixTranslation(best->worldPosition.x, best->worldPosition.y, best->worldPosition.z);
+    }
+    shadowView.referenceId = static_cast<uint32_t>(bestEntity);
 }
 
 DirectX::XMFLOAT3 RenderSystem::GetSunPosition(entt::registry& registry) {
@@ -244,21 +615,4 @@ DirectX::XMFLOAT3 RenderSystem::GetSunPosition(entt::registry& registry) {
     return defaultSunPos;
 }
 
-components::CameraComponent* RenderSystem::FindActiveCamera(entt::registry& registry) {
-    components::CameraComponent* activeCamera = nullptr;
-
-    // Find any entity with an active CameraComponent
-    // 注意：不再用 TransformComponent.position 覆盖 camera.position
-    // 玩家相机由 PlayerSystem 直接设置 camera.position/target
-    // 自由相机由 FreeCameraSystem 设置
-    auto view = registry.view<components::CameraComponent>();
-    view.each([&](auto entity, auto& cam) {
-        if (cam.isActive) {
-            activeCamera = &cam;
-        }
-    });
-
-    return activeCamera;
-}
-
 } // namespace outer_wilds
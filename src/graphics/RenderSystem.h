@@ -4,6 +4,15 @@
 #include "RenderBackend.h"
 #include "RenderQueue.h"
 #include "SkyboxRenderer.h"
+#include "ImpostorRenderer.h"
+#include "GpuInstanceRenderer.h"
+#include "OcclusionCuller.h"
+#include "ShadowRenderer.h"
+#include "ClusteredLighting.h"
+#include "AtmosphereRenderer.h"
+#include "DynamicResolution.h"
+#include "FrameGraph.h"
+#include "CameraService.h"
 #include <memory>
 #include <DirectXMath.h>
 
@@ -33,8 +42,14 @@ public:
 
     void Initialize(SceneManager* sceneManager);
     void Update(float deltaTime, entt::registry& registry) override;
+    /** @brief 释放各子渲染器并清除初始化标记（之后再 Initialize 会按需重新初始化） */
+    void Shutdown() override;
 
-    bool InitializeBackend(void* hwnd, int width, int height);
+    /**
+     * @brief 创建渲染后端
+     * @param headless 无窗口基准模式（hwnd 忽略）：Update 只收集、剔除、排序，不绘制
+     */
+    bool InitializeBackend(void* hwnd, int width, int height, bool headless = false);
     RenderBackend* GetBackend() { return m_Backend.get(); }
     
     /**
@@ -60,11 +75,99 @@ public:
      * @brief 获取天空盒渲染器
      */
     SkyboxRenderer* GetSkyboxRenderer() { return m_SkyboxRenderer.get(); }
+    
+    /**
+     * @brief 获取远处天体替身渲染器
+     */
+    ImpostorRenderer* GetImpostorRenderer() { return m_ImpostorRenderer.get(); }
+    
+    /**
+     * @brief 获取 GPU 驱动实例渲染器（GpuInstancedComponent）
+     */
+    GpuInstanceRenderer* GetGpuInstanceRenderer() { return m_GpuInstanceRenderer.get(); }
+    
+    /**
+     * @brief 启用/禁用星球遮挡剔除（调试对比用）
+     */
+    void SetOcclusionCullingEnabled(bool enabled) { m_OcclusionCullingEnabled = enabled; }
+    bool IsOcclusionCullingEnabled() const { return m_OcclusionCullingEnabled; }
+    
+    /**
+     * @brief 启用/禁用深度预通道（默认启用；关闭时 RenderQueue 改用近到远排序）
+     */
+    void SetDepthPrePassEnabled(bool enabled) { m_RenderQueue.SetDepthPrePassEnabled(enabled); }
+    bool IsDepthPrePassEnabled() const { return m_RenderQueue.IsDepthPrePassEnabled(); }
+    
+    /**
+     * @brief 启用/禁用背面剔除（默认关闭：导入模型的绕序尚未统一）
+     */
+    void SetBackfaceCullingEnabled(bool enabled) { m_BackfaceCulling = enabled; }
+    bool IsBackfaceCullingEnabled() const { return m_BackfaceCulling; }
+    
+    /**
+     * @brief 启用/禁用太阳级联阴影（默认启用；初始化失败时自动关闭）
+     */
+    void SetShadowsEnabled(bool enabled) { m_ShadowsEnabled = enabled; }
+    bool IsShadowsEnabled() const { return m_ShadowsEnabled; }
+    
+    /**
+     * @brief 启用/禁用视角后期锁存（默认启用）
+     *
+     * 构建观察矩阵之前重新读取最新的鼠标移动，只旋转本帧渲染用的相机朝向；
+     * 模拟仍使用帧开头的输入快照。回放时不生效（视角完全来自录制）。
+     */
+    void SetLateLatchEnabled(bool enabled) { m_LateLatchEnabled = enabled; }
+    bool IsLateLatchEnabled() const { return m_LateLatchEnabled; }
+    
+    /**
+     * @brief 获取级联阴影渲染器（调整阴影距离/读取统计）
+     */
+    ShadowRenderer* GetShadowRenderer() { return m_ShadowRenderer.get(); }
+    
+    /**
+     * @brief 启用/禁用点光源 / 聚光灯的分簇前向光照（默认启用；初始化失败时自动关闭）
+     */
+    void SetClusteredLightingEnabled(bool enabled) { m_ClusteredLightingEnabled = enabled; }
+    bool IsClusteredLightingEnabled() const { return m_ClusteredLightingEnabled; }
+    
+    /**
+     * @brief 获取分簇光照（调整分簇距离/读取统计）
+     */
+    ClusteredLighting* GetClusteredLighting() { return m_ClusteredLighting.get(); }
+    
+    /**
+     * @brief 场景构建完成后调用：初始化大气渲染器并预计算全部大气 LUT（不在第一次渲染时卡顿）
+     */
+    void PrepareScene(entt::registry& registry);
+    
+    /**
+     * @brief 获取大气散射渲染器（读取统计 / 切换场景时 Clear 释放 LUT）
+     */
+    AtmosphereRenderer* GetAtmosphereRenderer() { return m_AtmosphereRenderer.get(); }
+    
+    /**
+     * @brief 获取动态分辨率控制器（缩放范围/目标帧时间/启用开关）
+     */
+    DynamicResolution* GetDynamicResolution() { return m_DynamicResolution.get(); }
+    
+    /**
+     * @brief 获取帧图（读取本帧通道 / 剔除 / 瞬态目标池统计）
+     */
+    const FrameGraph& GetFrameGraph() const { return m_FrameGraph; }
 
 private:
-    void RenderScene(components::CameraComponent* camera, entt::registry& registry, bool shouldDebug);
-    components::CameraComponent* FindActiveCamera(entt::registry& registry);
+    void RenderScene(const CameraFrame& camera, entt::registry& registry, bool shouldDebug);
+    /**
+     * @brief 视锥/遮挡剔除 + CollectFromECS + Sort（绘制路径与无窗口模式共用）
+     */
+    void PrepareQueue(const CameraFrame& camera, entt::registry& registry, const DirectX::XMFLOAT3& sunPosition);
+    /** @brief 后期锁存：把帧开头之后的鼠标移动叠加到相机朝向（位置不变）；无变化时返回 false */
+    bool ApplyLateLatch(components::CameraComponent& camera) const;
     DirectX::XMFLOAT3 GetSunPosition(entt::registry& registry);
+    void FindShadowReferenceFrame(entt::registry& registry, const DirectX::XMFLOAT3& cameraPosition,
+                                  ShadowRenderer::View& shadowView);
+    /** @brief 第一次调用时初始化大气渲染器（PrepareScene 或第一帧，以先到者为准） */
+    void EnsureAtmosphereRenderer(ID3D11Device* device);
 
     std::unique_ptr<RenderBackend> m_Backend;
     SceneManager* m_SceneManager = nullptr;
@@ -75,8 +178,44 @@ private:
     RenderQueue m_RenderQueue;
     ID3D11Buffer* m_PerObjectCB = nullptr;  // PerObject常量缓冲区
     
-    // 天空盒渲染器
+    // 每帧重建的通道图（瞬态渲染目标池跨帧保留）
+    FrameGraph m_FrameGraph;
+    
+    // 天空盒渲染器（初始化失败时下一帧重试）
     std::unique_ptr<SkyboxRenderer> m_SkyboxRenderer;
+    bool m_SkyboxInitialized = false;
+    
+    // 远处天体替身（初始化失败时关闭 RenderQueue 的替身输出）
+    std::unique_ptr<ImpostorRenderer> m_ImpostorRenderer;
+    bool m_ImpostorInitAttempted = false;
+    
+    // GPU 剔除 + 间接绘制的大量实例（初始化失败时这些组件不绘制）
+    std::unique_ptr<GpuInstanceRenderer> m_GpuInstanceRenderer;
+    bool m_GpuInstanceInitAttempted = false;
+    
+    // 星球球体遮挡的 Hi-Z（每帧 CPU 光栅化，收集阶段查询）
+    OcclusionCuller m_OcclusionCuller;
+    bool m_OcclusionCullingEnabled = true;
+    bool m_BackfaceCulling = false;
+    bool m_LateLatchEnabled = true;
+    
+    // 太阳级联阴影（远处级联缓存在相机所在天体的参考系中）
+    std::unique_ptr<ShadowRenderer> m_ShadowRenderer;
+    bool m_ShadowInitAttempted = false;
+    bool m_ShadowsEnabled = true;
+    
+    // LightComponent 点光源 / 聚光灯的分簇光源列表（每帧 CPU 装箱）
+    std::unique_ptr<ClusteredLighting> m_ClusteredLighting;
+    bool m_ClusteredLightingInitAttempted = false;
+    bool m_ClusteredLightingEnabled = true;
+    
+    // AtmosphereComponent 的大气散射（LUT 按行星缓存，参数变化时重算）
+    std::unique_ptr<AtmosphereRenderer> m_AtmosphereRenderer;
+    bool m_AtmosphereInitAttempted = false;
+    
+    // 动态分辨率：场景渲染到离屏目标的子区域，再拉伸到后缓冲区（UI 保持原生分辨率）
+    std::unique_ptr<DynamicResolution> m_DynamicResolution;
+    bool m_DynamicResolutionInitAttempted = false;
     
     // 太阳实体（用于动态光照）
     entt::entity m_SunEntity = entt::null;
@@ -0,0 +1,213 @@
+#include "ShaderCompileService.h"
+#include "resources/Shader.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+
+namespace outer_wilds {
+
+ShaderCompileService::~ShaderCompileService() {
+    Shutdown();
+}
+
+void ShaderCompileService::SetFallbackShader(const std::string& vsName, const std::string& psName) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_FallbackVS = vsName;
+    m_FallbackPS = psName;
+}
+
+/**
+ * @brief 回退着色器同步加载（只在第一次调用时编译，之后命中磁盘缓存/预编译字节码也很快）
+ */
+resources::Shader* ShaderCompileService::GetFallbackLocked(ID3D11Device* device) {
+    const std::string key = m_FallbackVS + "|" + m_FallbackPS;
+    auto it = m_Shaders.find(key);
+    if (it != m_Shaders.end()) {
+        return it->second.state == State::Ready ? it->second.shader.get() : nullptr;
+    }
+
+    Entry& entry = m_Shaders[key];
+    entry.device = device;
+    entry.vsName = m_FallbackVS;
+    entry.psName = m_FallbackPS;
+    auto shader = std::make_shared<resources::Shader>();
+    if (shader->LoadFromFile(device, m_FallbackVS, m_FallbackPS)) {
+        entry.shader = shader;
+        entry.state = State::Ready;
+        DebugManager::GetInstance().Log("ShaderCompileService", "Loaded fallback shader: " + key);
+        return entry.shader.get();
+    }
+
+    entry.state = State::Failed;
+    DebugManager::GetInstance().Log("ShaderCompileService", "Failed to load fallback shader: " + key);
+    return nullptr;
+}
+
+resources::Shader* ShaderCompileService::Acquire(ID3D11Device* device, const std::string& vsName,
+                                                 const std::string& psName, bool& outFallback) {
+    return Acquire(device, vsName, psName, resources::kNoPermutation, outFallback);
+}
+
+resources::Shader* ShaderCompileService::Acquire(ID3D11Device* device, const std::string& vsName,
+                                                 const std::string& psName, uint32_t permutation,
+                                                 bool& outFallback) {
+    outFallback = false;
+    if (!device) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // 排列变体："textured.vs|textured.ps#p<permutation>"
+    std::string key = vsName + "|" + psName;
+    if (permutation != resources::kNoPermutation) {
+        key += "#p" + std::to_string(permutation);
+    } else if (vsName == m_FallbackVS && psName == m_FallbackPS) {
+        return GetFallbackLocked(device);
+    }
+
+    auto it = m_Shaders.find(key);
+    if (it != m_Shaders.end()) {
+        switch (it->second.state) {
+        case State::Ready:
+            return it->second.shader.get();
+        case State::Failed:
+            // 编译失败不会再变化，永久使用回退着色器
+            return GetFallbackLocked(device);
+        case State::Pending:
+            break;
+        }
+    } else {
+        if (m_Stop) {
+            return GetFallbackLocked(device);
+        }
+
+        Entry& entry = m_Shaders[key];
+        entry.state = State::Pending;
+        entry.device = device;
+        entry.vsName = vsName;
+        entry.psName = psName;
+        entry.permutation = permutation;
+        m_Jobs.push_back({ device, key, vsName, psName, permutation });
+        if (!m_Worker.joinable()) {
+            m_Worker = std::thread(&ShaderCompileService::WorkerLoop, this);
+        }
+        m_JobAvailable.notify_one();
+        DebugManager::GetInstance().Log("ShaderCompileService", "Queued shader: " + key);
+    }
+
+    resources::Shader* fallback = GetFallbackLocked(device);
+    outFallback = fallback != nullptr;
+    return fallback;
+}
+
+void ShaderCompileService::WorkerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobAvailable.wait(lock, [this] { return m_Stop || !m_Jobs.empty(); });
+            if (m_Stop) {
+                return;
+            }
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+            m_Busy = true;
+        }
+
+        // 编译不持锁：渲染线程在此期间继续使用回退着色器
+        auto shader = std::make_shared<resources::Shader>();
+        bool loaded = shader->LoadFromFile(job.device, job.vsName, job.psName, false, job.permutation);
+
+        bool replaced = false;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            Entry& entry = m_Shaders[job.key];
+            if (loaded) {
+                // 热重载：旧版本可能还被本帧已收集的批次引用，先退役
+                if (entry.shader) {
+                    m_Retired.push_back(std::move(entry.shader));
+                    replaced = true;
+                }
+                entry.shader = shader;
+                entry.state = State::Ready;
+            } else if (!job.reload || entry.state != State::Ready) {
+                entry.state = State::Failed;
+            }
+            m_Busy = false;
+        }
+        if (replaced) {
+            m_ReloadGeneration.fetch_add(1, std::memory_order_release);
+        }
+        m_Generation.fetch_add(1, std::memory_order_release);
+        m_JobDone.notify_all();
+
+        if (job.reload && !loaded) {
+            DebugManager::GetInstance().Log("ShaderCompileService",
+                "Reload failed, keeping previous version: " + job.key);
+        } else {
+            DebugManager::GetInstance().Log("ShaderCompileService",
+                (loaded ? (job.reload ? "Reloaded shader: " : "Compiled shader: ") : "Failed to compile shader: ") + job.key);
+        }
+    }
+}
+
+uint32_t ShaderCompileService::Reload(const std::string& hlslName) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Stop) return 0;
+
+    // 上一次重载替换下来的版本：之后 RenderQueue 已按 reload generation 重建过
+    m_Retired.clear();
+
+    uint32_t queued = 0;
+    for (const auto& pair : m_Shaders) {
+        const Entry& entry = pair.second;
+        if (entry.state == State::Pending || !entry.device) continue;
+        // "textured.vs" → shaders/textured.hlsl（与 Shader::LoadFromHLSLFile 一致）
+        const std::string baseName = entry.vsName.substr(0, entry.vsName.find_last_of('.'));
+        if (!hlslName.empty() && baseName != hlslName) continue;
+
+        const bool queuedAlready = std::any_of(m_Jobs.begin(), m_Jobs.end(),
+            [&pair](const Job& job) { return job.key == pair.first; });
+        if (queuedAlready) continue;
+        m_Jobs.push_back({ entry.device, pair.first, entry.vsName, entry.psName, entry.permutation, true });
+        queued++;
+    }
+    if (queued > 0) {
+        if (!m_Worker.joinable()) {
+            m_Worker = std::thread(&ShaderCompileService::WorkerLoop, this);
+        }
+        m_JobAvailable.notify_one();
+        DebugManager::GetInstance().Log("ShaderCompileService", "Queued " + std::to_string(queued) +
+            " shader(s) for reload: " + (hlslName.empty() ? std::string("<all>") : hlslName));
+    }
+    return queued;
+}
+
+void ShaderCompileService::WaitIdle() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_JobDone.wait(lock, [this] { return m_Stop || (m_Jobs.empty() && !m_Busy); });
+}
+
+size_t ShaderCompileService::GetPendingCount() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Jobs.size() + (m_Busy ? 1 : 0);
+}
+
+void ShaderCompileService::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+        m_Jobs.clear();
+    }
+    m_JobAvailable.notify_all();
+    m_JobDone.notify_all();
+    if (m_Worker.joinable()) {
+        m_Worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Shaders.clear();
+    m_Retired.clear();
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,126 @@
+#pragma once
+#include <d3d11.h>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+
+namespace resources {
+    class Shader;
+}
+
+/**
+ * @brief 异步着色器编译服务
+ *
+ * 首次请求某个 VS/PS 组合时不在渲染线程上编译：立即返回已就绪的回退着色器
+ * （basic.vs/basic.ps），并把真正的编译放到工作线程上（ID3D11Device 的创建方法是线程安全的）。
+ * 编译完成后递增 generation，RenderQueue 据此重建使用回退着色器的批次以换上正式版本。
+ */
+class ShaderCompileService {
+public:
+    static ShaderCompileService& GetInstance() {
+        static ShaderCompileService instance;
+        return instance;
+    }
+
+    /**
+     * @brief 获取着色器：已编译则直接返回，否则排队编译并返回回退着色器
+     * @param outFallback 返回的是回退着色器且正式版本仍在编译中时为 true
+     * @return 可立即使用的着色器，回退着色器也加载失败时为 nullptr
+     */
+    resources::Shader* Acquire(ID3D11Device* device, const std::string& vsName, const std::string& psName,
+                               bool& outFallback);
+
+    /**
+     * @brief 获取像素着色器的一个排列（resources::ShaderPermutation 位组合），每个排列单独编译、单独缓存
+     */
+    resources::Shader* Acquire(ID3D11Device* device, const std::string& vsName, const std::string& psName,
+                               uint32_t permutation, bool& outFallback);
+
+    /**
+     * @brief 每完成一个异步编译（成功或失败）递增一次
+     */
+    uint32_t GetGeneration() const { return m_Generation.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 热重载重新编译成功后递增（RenderQueue 据此重建引用旧着色器的全部批次）
+     */
+    uint32_t GetReloadGeneration() const { return m_ReloadGeneration.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 热重载：重新编译来自 shaders/<hlslName>.hlsl 的全部已加载变体（空名 = 全部，用于 include 文件）
+     *
+     * 在工作线程上编译，成功后原子替换；编译失败时保留旧版本继续使用。
+     * 被替换的着色器延迟到下一次 Reload 时释放（那时引用它的批次早已重建）。
+     * @return 排队的变体数
+     */
+    uint32_t Reload(const std::string& hlslName);
+
+    /**
+     * @brief 等待队列中的编译全部完成（加载界面 / 预热用）
+     */
+    void WaitIdle();
+
+    /**
+     * @brief 停止工作线程并释放所有着色器（设备销毁前调用）
+     */
+    void Shutdown();
+
+    size_t GetPendingCount();
+
+    void SetFallbackShader(const std::string& vsName, const std::string& psName);
+
+private:
+    ShaderCompileService() = default;
+    ~ShaderCompileService();
+    ShaderCompileService(const ShaderCompileService&) = delete;
+    ShaderCompileService& operator=(const ShaderCompileService&) = delete;
+
+    enum class State { Pending, Ready, Failed };
+
+    struct Entry {
+        std::shared_ptr<resources::Shader> shader;
+        State state = State::Pending;
+        ID3D11Device* device = nullptr;
+        std::string vsName;
+        std::string psName;
+        uint32_t permutation = ~0u;     // resources::kNoPermutation
+    };
+
+    struct Job {
+        ID3D11Device* device = nullptr;
+        std::string key;
+        std::string vsName;
+        std::string psName;
+        uint32_t permutation = ~0u;
+        bool reload = false;    // 失败时保留旧版本
+    };
+
+    resources::Shader* GetFallbackLocked(ID3D11Device* device);
+    void WorkerLoop();
+
+    std::mutex m_Mutex;
+    std::condition_variable m_JobAvailable;
+    std::condition_variable m_JobDone;
+    std::deque<Job> m_Jobs;
+    std::unordered_map<std::string, Entry> m_Shaders;
+    std::thread m_Worker;
+    bool m_Stop = false;
+    bool m_Busy = false;
+    std::atomic<uint32_t> m_Generation{ 0 };
+    std::atomic<uint32_t> m_ReloadGeneration{ 0 };
+    std::vector<std::shared_ptr<resources::Shader>> m_Retired;   // 热重载替换下来的旧版本
+
+    std::string m_FallbackVS = "basic.vs";
+    std::string m_FallbackPS = "basic.ps";
+};
+
+} // namespace outer_wilds
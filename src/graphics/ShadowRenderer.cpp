@@ -0,0 +1,495 @@
+#include "ShadowRenderer.h"
+#include "GpuMemory.h"
+#include "RenderStateCache.h"
+#include "resources/Shader.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <tuple>
+
+using namespace DirectX;
+
+namespace outer_wilds {
+
+namespace {
+
+/**
+ * @brief 与 depth_prepass.hlsl 中 PerFrameBuffer 的前 80 字节一致
+ */
+struct LightFrameData {
+    XMFLOAT4X4 viewProjection;  // 转置
+    XMFLOAT3 cameraPosition;
+    float time;
+};
+static_assert(sizeof(LightFrameData) == 80, "LightFrameData must be 80 bytes");
+
+} // namespace
+
+ShadowRenderer::~ShadowRenderer() {
+    if (m_InstanceIndexBuffer) m_InstanceIndexBuffer->Release();
+    if (m_InstanceSRV) m_InstanceSRV->Release();
+    if (m_InstanceBuffer) m_InstanceBuffer->Release();
+    if (m_ShadowCB) m_ShadowCB->Release();
+    if (m_LightCB) m_LightCB->Release();
+    if (m_ShadowSRV) m_ShadowSRV->Release();
+    for (auto* dsv : m_CascadeDSV) {
+        if (dsv) dsv->Release();
+    }
+    if (m_ShadowTexture) m_ShadowTexture->Release();
+}
+
+bool ShadowRenderer::Initialize(ID3D11Device* device) {
+    if (!device) return false;
+    m_Device = device;
+
+    // 与深度预通道同一着色器：投射者只需要 POSITION + OBJECT_INDEX
+    m_DepthShader = std::make_unique<resources::Shader>();
+    if (!m_DepthShader->LoadFromFile(device, "depth_prepass.vs", "depth_prepass.ps") ||
+        !m_DepthShader->SupportsInstancing()) {
+        DebugManager::GetInstance().Log("ShadowRenderer", "Failed to load depth_prepass shader (instanced VS required)");
+        return false;
+    }
+
+    // === 阴影图：R32_TYPELESS 纹理数组，每层一个 DSV，整体一个 R32_FLOAT SRV ===
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = kResolution;
+    textureDesc.Height = kResolution;
+    textureDesc.MipLevels = 1;
+    textureDesc.ArraySize = kCascadeCount;
+    textureDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+    if (FAILED(device->CreateTexture2D(&textureDesc, nullptr, &m_ShadowTexture))) {
+        DebugManager::GetInstance().Log("ShadowRenderer", "Failed to create shadow map array");
+        return false;
+    }
+    GpuMemory::Track(m_ShadowTexture);
+
+    for (uint32_t i = 0; i < kCascadeCount; i++) {
+        D3D11_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+        dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
+        dsvDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+        dsvDesc.Texture2DArray.MipSlice = 0;
+        dsvDesc.Texture2DArray.FirstArraySlice = i;
+        dsvDesc.Texture2DArray.ArraySize = 1;
+        if (FAILED(device->CreateDepthStencilView(m_ShadowTexture, &dsvDesc, &m_CascadeDSV[i]))) {
+            DebugManager::GetInstance().Log("ShadowRenderer", "Failed to create cascade DSV");
+            return false;
+        }
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_R32_FLOAT;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    srvDesc.Texture2DArray.MostDetailedMip = 0;
+    srvDesc.Texture2DArray.MipLevels = 1;
+    srvDesc.Texture2DArray.FirstArraySlice = 0;
+    srvDesc.Texture2DArray.ArraySize = kCascadeCount;
+    if (FAILED(device->CreateShaderResourceView(m_ShadowTexture, &srvDesc, &m_ShadowSRV))) {
+        DebugManager::GetInstance().Log("ShadowRenderer", "Failed to create shadow map SRV");
+        return false;
+    }
+
+    // 比较采样器：硬件 2x2 PCF；边界外视为受光
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter = D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+    samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_BORDER;
+    samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.BorderColor[0] = 1.0f;
+    samplerDesc.BorderColor[1] = 1.0f;
+    samplerDesc.BorderColor[2] = 1.0f;
+    samplerDesc.BorderColor[3] = 1.0f;
+    samplerDesc.ComparisonFunc = D3D11_COMPARISON_LESS_EQUAL;
+    samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    m_ComparisonSampler = stateCache.GetSamplerState(samplerDesc);
+    if (!m_ComparisonSampler) {
+        return false;
+    }
+
+    // 不剔除（薄片模型和背面都要投影），斜率偏移压制自阴影条纹
+    // 光源近平面之前的投射者压到 0，不被裁掉（DepthClipEnable = FALSE）
+    D3D11_RASTERIZER_DESC rasterDesc = RenderStateCache::RasterizerDesc(D3D11_CULL_NONE, false);
+    rasterDesc.DepthBias = 0;
+    rasterDesc.SlopeScaledDepthBias = 2.0f;
+    rasterDesc.DepthBiasClamp = 0.01f;
+    m_PassState.blend = stateCache.GetBlendState(RenderStateCache::BlendMode::Opaque);
+    m_PassState.rasterizer = stateCache.GetRasterizerState(rasterDesc);
+    m_PassState.depthStencil = stateCache.GetDepthStencilState(true, true, D3D11_COMPARISON_LESS);
+    if (!m_PassState.blend || !m_PassState.rasterizer || !m_PassState.depthStencil) {
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cbDesc = {};
+    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    cbDesc.ByteWidth = sizeof(LightFrameData);
+    if (FAILED(device->CreateBuffer(&cbDesc, nullptr, &m_LightCB))) {
+        return false;
+    }
+    GpuMemory::Track(m_LightCB);
+    cbDesc.ByteWidth = sizeof(ShadowConstants);
+    if (FAILED(device->CreateBuffer(&cbDesc, nullptr, &m_ShadowCB))) {
+        return false;
+    }
+    GpuMemory::Track(m_ShadowCB);
+
+    m_Initialized = true;
+    DebugManager::GetInstance().Log("ShadowRenderer", "Initialized (" + std::to_string(kCascadeCount) + " cascades, " +
+                                    std::to_string(kResolution) + "x" + std::to_string(kResolution) + ")");
+    return true;
+}
+
+bool ShadowRenderer::EnsureInstanceCapacity(uint32_t count) {
+    if (count <= m_InstanceCapacity && m_InstanceBuffer) {
+        return true;
+    }
+
+    if (m_InstanceIndexBuffer) { m_InstanceIndexBuffer->Release(); m_InstanceIndexBuffer = nullptr; }
+    if (m_InstanceSRV) { m_InstanceSRV->Release(); m_InstanceSRV = nullptr; }
+    if (m_InstanceBuffer) { m_InstanceBuffer->Release(); m_InstanceBuffer = nullptr; }
+    m_InstanceCapacity = 0;
+
+    uint32_t capacity = 256;
+    while (capacity < count) capacity *= 2;
+
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = capacity * sizeof(ObjectData);
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    desc.StructureByteStride = sizeof(ObjectData);
+    if (FAILED(m_Device->CreateBuffer(&desc, nullptr, &m_InstanceBuffer))) {
+        return false;
+    }
+    GpuMemory::Track(m_InstanceBuffer);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+    srvDesc.Buffer.FirstElement = 0;
+    srvDesc.Buffer.NumElements = capacity;
+    if (FAILED(m_Device->CreateShaderResourceView(m_InstanceBuffer, &srvDesc, &m_InstanceSRV))) {
+        m_InstanceBuffer->Release();
+        m_InstanceBuffer = nullptr;
+        return false;
+    }
+
+    // 逐实例下标流 0..N-1（与 RenderQueue 的对象下标流相同，SV_InstanceID 不含 StartInstanceLocation）
+    std::vector<uint32_t> indices(capacity);
+    for (uint32_t k = 0; k < capacity; k++) {
+        indices[k] = k;
+    }
+    D3D11_BUFFER_DESC indexDesc = {};
+    indexDesc.ByteWidth = capacity * sizeof(uint32_t);
+    indexDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    indexDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+    D3D11_SUBRESOURCE_DATA indexData = {};
+    indexData.pSysMem = indices.data();
+    if (FAILED(m_Device->CreateBuffer(&indexDesc, &indexData, &m_InstanceIndexBuffer))) {
+        m_InstanceSRV->Release();
+        m_InstanceSRV = nullptr;
+        m_InstanceBuffer->Release();
+        m_InstanceBuffer = nullptr;
+        return false;
+    }
+    GpuMemory::Track(m_InstanceIndexBuffer);
+
+    m_InstanceCapacity = capacity;
+    return true;
+}
+
+void ShadowRenderer::Render(ID3D11DeviceContext* context, const View& view, const RenderQueue& queue) {
+    m_Stats = Stats();
+    if (!m_Initialized || !context) {
+        return;
+    }
+
+    const XMVECTOR cameraPos = XMLoadFloat3(&view.cameraPosition);
+    XMVECTOR toSun = XMVectorSubtract(XMLoadFloat3(&view.sunPosition), cameraPos);
+    if (XMVectorGetX(XMVector3LengthSq(toSun)) < 1e-8f) {
+        toSun = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+    }
+    const XMVECTOR lightDir = XMVector3Normalize(toSun);  // 指向太阳
+
+    const XMMATRIX frameNow = view.referenceFrame;
+    const XMMATRIX invFrameNow = XMMatrixInverse(nullptr, frameNow);
+    const XMVECTOR localLightDir = XMVector3Normalize(XMVector3TransformNormal(lightDir, invFrameNow));
+
+    // === 切分：对数/线性混合 ===
+    const float nearPlane = (std::max)(view.nearPlane, 0.01f);
+    const float farPlane = (std::max)(m_ShadowDistance, nearPlane * 2.0f);
+    float splits[kCascadeCount + 1];
+    for (uint32_t i = 0; i <= kCascadeCount; i++) {
+        const float t = static_cast<float>(i) / kCascadeCount;
+        const float logSplit = nearPlane * std::pow(farPlane / nearPlane, t);
+        const float linearSplit = nearPlane + (farPlane - nearPlane) * t;
+        splits[i] = kSplitLambda * logSplit + (1.0f - kSplitLambda) * linearSplit;
+    }
+
+    // 视锥切片包围球：球心在视线上，半径只取决于切片远近（与相机朝向无关，旋转时不抖动）
+    const float tanY = std::tan(view.fovY * 0.5f);
+    const float tanX = tanY * view.aspectRatio;
+    const float slopeSq = tanX * tanX + tanY * tanY;
+    const XMMATRIX invView = XMMatrixInverse(nullptr, view.view);
+    const XMVECTOR forward = XMVector3Normalize(invView.r[2]);
+
+    // === 保存 b0（渲染目标 / 视口由 FrameGraph 在之后的通道重新绑定）===
+    ID3D11Buffer* prevFrameCB = nullptr;
+    context->VSGetConstantBuffers(0, 1, &prevFrameCB);
+
+    // 阴影图不能同时作为 SRV 和 DSV
+    ID3D11ShaderResourceView* unbound = nullptr;
+    context->PSSetShaderResources(kShadowMapSlot, 1, &unbound);
+
+    D3D11_VIEWPORT viewport = {};
+    viewport.Width = static_cast<float>(kResolution);
+    viewport.Height = static_cast<float>(kResolution);
+    viewport.MaxDepth = 1.0f;
+    context->RSSetViewports(1, &viewport);
+    RenderStateCache::GetInstance().Apply(context, m_PassState);
+
+    // === 选择本帧需要重绘的缓存级联（最多一个，优先无效的，其次最旧的）===
+    int cachedRefresh = -1;
+    uint32_t refreshAge = 0;
+    const float cosThreshold = std::cos(XMConvertToRadians(kCacheAngleThreshold));
+
+    for (uint32_t i = 0; i < kCascadeCount; i++) {
+        const float sliceNear = splits[i];
+        const float sliceFar = splits[i + 1];
+        const float centerDist = (std::min)((sliceFar + sliceNear) * (1.0f + slopeSq) * 0.5f, sliceFar);
+        const float radius = std::sqrt(sliceFar * sliceFar * slopeSq + (sliceFar - centerDist) * (sliceFar - centerDist));
+        const XMVECTOR center = XMVectorAdd(cameraPos, XMVectorScale(forward, centerDist));
+
+        Cascade& cascade = m_Cascades[i];
+        if (i < kFirstCachedCascade) {
+            RenderCascade(context, i, center, radius, lightDir, view, queue);
+            continue;
+        }
+
+        cascade.age++;
+        bool refresh = !cascade.valid || cascade.referenceId != view.referenceId || cascade.age > kMaxCachedFrames;
+        if (!refresh) {
+            const float cosAngle = XMVectorGetX(XMVector3Dot(localLightDir, XMLoadFloat3(&cascade.localLightDir)));
+            const XMVECTOR localCenter = XMVector3TransformCoord(center, invFrameNow);
+            const float drift = XMVectorGetX(XMVector3Length(XMVectorSubtract(localCenter, XMLoadFloat3(&cascade.localCenter))));
+            refresh = cosAngle < cosThreshold || drift + radius > cascade.radius;
+        }
+        if (cascade.referenceId != view.referenceId) {
+            cascade.valid = false;  // 另一个天体参考系下的缓存无法换算
+        }
+        if (!refresh) continue;
+
+        const uint32_t age = cascade.valid ? cascade.age : UINT32_MAX;
+        if (cachedRefresh < 0 || age > refreshAge) {
+            cachedRefresh = static_cast<int>(i);
+            refreshAge = age;
+        }
+    }
+
+    if (cachedRefresh >= 0) {
+        const uint32_t i = static_cast<uint32_t>(cachedRefresh);
+        const float sliceNear = splits[i];
+        const float sliceFar = splits[i + 1];
+        const float centerDist = (std::min)((sliceFar + sliceNear) * (1.0f + slopeSq) * 0.5f, sliceFar);
+        const float radius = std::sqrt(sliceFar * sliceFar * slopeSq + (sliceFar - centerDist) * (sliceFar - centerDist));
+        const XMVECTOR center = XMVectorAdd(cameraPos, XMVectorScale(forward, centerDist));
+
+        // 余量让相机在缓存范围内移动一段距离而不必重绘
+        RenderCascade(context, i, center, radius * (1.0f + kCacheMargin), lightDir, view, queue);
+        Cascade& cascade = m_Cascades[i];
+        XMStoreFloat3(&cascade.localLightDir, localLightDir);
+        XMStoreFloat3(&cascade.localCenter, XMVector3TransformCoord(center, invFrameNow));
+    }
+
+    // === 还原 b0 ===
+    context->VSSetConstantBuffers(0, 1, &prevFrameCB);
+    context->VSSetShaderResources(RenderQueue::kObjectDataSlot, 1, &unbound);
+    if (prevFrameCB) prevFrameCB->Release();
+
+    // === 采样常量：缓存级联经 当前参考系⁻¹ × 渲染时参考系 换算到当前帧的世界空间 ===
+    ShadowConstants constants = {};
+    for (uint32_t i = 0; i < kCascadeCount; i++) {
+        const Cascade& cascade = m_Cascades[i];
+        XMMATRIX sampling = XMMatrixIdentity();
+        if (cascade.valid) {
+            sampling = XMLoadFloat4x4(&cascade.lightViewProjection);
+            if (i >= kFirstCachedCascade) {
+                sampling = invFrameNow * XMLoadFloat4x4(&cascade.frameAtRender) * sampling;
+            }
+        }
+        XMStoreFloat4x4(&constants.cascadeMatrices[i], XMMatrixTranspose(sampling));
+        (&constants.cascadeEnabled.x)[i] = cascade.valid ? 1.0f : 0.0f;
+        (&constants.cascadeBias.x)[i] = cascade.depthBias;
+    }
+    constants.shadowParams = XMFLOAT4(static_cast<float>(kCascadeCount), 1.0f / kResolution, 0.0f, 0.0f);
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (SUCCEEDED(context->Map(m_ShadowCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        memcpy(mapped.pData, &constants, sizeof(ShadowConstants));
+        context->Unmap(m_ShadowCB, 0);
+    }
+}
+
+void ShadowRenderer::RenderCascade(ID3D11DeviceContext* context, uint32_t index, const XMVECTOR& center, float radius,
+                                   const XMVECTOR& lightDir, const View& view, const RenderQueue& queue) {
+    Cascade& cascade = m_Cascades[index];
+
+    // === 光源矩阵：沿 -lightDir 观察，球心按纹素对齐 ===
+    const XMVECTOR up = std::fabs(XMVectorGetY(lightDir)) > 0.99f ? XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f)
+                                                                   : XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+    const XMMATRIX lightRotation = XMMatrixLookToLH(XMVectorZero(), XMVectorNegate(lightDir), up);
+
+    const float texelSize = 2.0f * radius / kResolution;
+    XMFLOAT3 lightCenter;
+    XMStoreFloat3(&lightCenter, XMVector3TransformCoord(center, lightRotation));
+    lightCenter.x = std::floor(lightCenter.x / texelSize) * texelSize;
+    lightCenter.y = std::floor(lightCenter.y / texelSize) * texelSize;
+
+    // 向太阳方向延长，包含包围球外、但影子落进级联的投射者
+    const float pullback = m_ShadowDistance;
+    const float depthRange = 2.0f * radius + pullback;
+    const XMMATRIX lightView = lightRotation *
+        XMMatrixTranslation(-lightCenter.x, -lightCenter.y, -(lightCenter.z - radius - pullback));
+    const XMMATRIX lightProjection = XMMatrixOrthographicLH(2.0f * radius, 2.0f * radius, 0.0f, depthRange);
+    const XMMATRIX lightViewProjection = lightView * lightProjection;
+
+    // === 投射者：光源空间正交盒转换回世界空间 ===
+    BoundingOrientedBox lightBox(XMFLOAT3(0.0f, 0.0f, depthRange * 0.5f),
+                                 XMFLOAT3(radius, radius, depthRange * 0.5f),
+                                 XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    BoundingOrientedBox worldBox;
+    lightBox.Transform(worldBox, XMMatrixInverse(nullptr, lightView));
+
+    m_Casters.clear();
+    queue.CollectShadowCasters(worldBox, m_Casters);
+
+    LightFrameData frame = {};
+    XMStoreFloat4x4(&frame.viewProjection, XMMatrixTranspose(lightViewProjection));
+    frame.cameraPosition = view.cameraPosition;
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (SUCCEEDED(context->Map(m_LightCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        memcpy(mapped.pData, &frame, sizeof(LightFrameData));
+        context->Unmap(m_LightCB, 0);
+    }
+    context->VSSetConstantBuffers(0, 1, &m_LightCB);
+
+    ID3D11DepthStencilView* dsv = m_CascadeDSV[index];
+    context->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH, 1.0f, 0);
+    context->OMSetRenderTargets(0, nullptr, dsv);
+    DrawCasters(context);
+
+    XMStoreFloat4x4(&cascade.lightViewProjection, lightViewProjection);
+    XMStoreFloat4x4(&cascade.frameAtRender, view.referenceFrame);
+    cascade.radius = radius;
+    cascade.depthBias = kDepthBiasTexels * texelSize / depthRange;
+    cascade.age = 0;
+    cascade.referenceId = view.referenceId;
+    cascade.valid = true;
+
+    m_Stats.cascadesRendered++;
+    m_Stats.casters += static_cast<uint32_t>(m_Casters.size());
+}
+
+void ShadowRenderer::DrawCasters(ID3D11DeviceContext* context) {
+    const uint32_t count = static_cast<uint32_t>(m_Casters.size());
+    if (count == 0 || !EnsureInstanceCapacity(count)) {
+        return;
+    }
+
+    // 按几何体排序，相同几何体连续存放为一次实例化绘制（GeometryPool 同页的 Mesh 按区间区分，并排在一起共用绑定）
+    auto geometryKey = [](const ShadowCaster& caster) {
+        return std::make_tuple(caster.vertexBuffer, caster.indexBuffer, caster.startIndex, caster.baseVertex,
+                               caster.indexCount, caster.instancedInputLayout);
+    };
+    m_CasterOrder.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        m_CasterOrder[i] = i;
+    }
+    std::sort(m_CasterOrder.begin(), m_CasterOrder.end(), [&](uint32_t a, uint32_t b) {
+        return geometryKey(m_Casters[a]) < geometryKey(m_Casters[b]);
+    });
+
+    m_InstanceData.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        ObjectData& data = m_InstanceData[i];
+        data = ObjectData{};
+        data.world = m_Casters[m_CasterOrder[i]].world;  // depth_prepass.hlsl 只读取 world
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(context->Map(m_InstanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        return;
+    }
+    memcpy(mapped.pData, m_InstanceData.data(), count * sizeof(ObjectData));
+    context->Unmap(m_InstanceBuffer, 0);
+
+    context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    context->VSSetShader(m_DepthShader->GetInstancedVertexShader(), nullptr, 0);
+    context->PSSetShader(nullptr, nullptr, 0);
+    context->VSSetShaderResources(RenderQueue::kObjectDataSlot, 1, &m_InstanceSRV);
+
+    ID3D11InputLayout* lastLayout = nullptr;
+    ID3D11Buffer* lastVertexBuffer = nullptr;
+    ID3D11Buffer* lastIndexBuffer = nullptr;
+    uint32_t lastStride = 0;
+    uint32_t runStart = 0;
+    while (runStart < count) {
+        const ShadowCaster& first = m_Casters[m_CasterOrder[runStart]];
+        uint32_t runEnd = runStart + 1;
+        while (runEnd < count && geometryKey(m_Casters[m_CasterOrder[runEnd]]) == geometryKey(first)) {
+            runEnd++;
+        }
+
+        if (first.instancedInputLayout != lastLayout) {
+            context->IASetInputLayout(first.instancedInputLayout);
+            lastLayout = first.instancedInputLayout;
+        }
+        if (first.vertexBuffer != lastVertexBuffer || first.vertexStride != lastStride) {
+            UINT strides[2] = { first.vertexStride, sizeof(uint32_t) };
+            UINT offsets[2] = { 0, 0 };
+            ID3D11Buffer* buffers[2] = { first.vertexBuffer, m_InstanceIndexBuffer };
+            context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+            lastVertexBuffer = first.vertexBuffer;
+            lastStride = first.vertexStride;
+        }
+        if (first.indexBuffer != lastIndexBuffer) {
+            // 同一缓冲的索引格式一致（GeometryPool 按格式分页）
+            context->IASetIndexBuffer(first.indexBuffer, first.indexFormat, 0);
+            lastIndexBuffer = first.indexBuffer;
+        }
+        context->DrawIndexedInstanced(first.indexCount, runEnd - runStart, first.startIndex, first.baseVertex, runStart);
+        m_Stats.drawCalls++;
+
+        runStart = runEnd;
+    }
+}
+
+void ShadowRenderer::Bind(ID3D11DeviceContext* context) const {
+    if (!m_Initialized || !context) {
+        return;
+    }
+    context->PSSetConstantBuffers(kShadowBufferSlot, 1, &m_ShadowCB);
+    context->PSSetShaderResources(kShadowMapSlot, 1, &m_ShadowSRV);
+    context->PSSetSamplers(kShadowSamplerSlot, 1, &m_ComparisonSampler);
+}
+
+void ShadowRenderer::Unbind(ID3D11DeviceContext* context) const {
+    if (!context) {
+        return;
+    }
+    ID3D11Buffer* nullBuffer = nullptr;
+    ID3D11ShaderResourceView* nullSRV = nullptr;
+    ID3D11SamplerState* nullSampler = nullptr;
+    context->PSSetConstantBuffers(kShadowBufferSlot, 1, &nullBuffer);
+    context->PSSetShaderResources(kShadowMapSlot, 1, &nullSRV);
+    context->PSSetSamplers(kShadowSamplerSlot, 1, &nullSampler);
+}
+
+} // namespace outer_wilds
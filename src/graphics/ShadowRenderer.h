@@ -0,0 +1,151 @@
+#pragma once
+#include "RenderQueue.h"
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <memory>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+    class Shader;
+}
+
+/**
+ * @brief 太阳光级联阴影（CSM）
+ *
+ * 相机到 shadowDistance 之间按对数/线性混合切分为 kCascadeCount 段，每段用包围球拟合
+ * （半径与相机朝向无关）并按纹素对齐，减少移动时的闪烁。每个级联的投射者由
+ * RenderQueue::CollectShadowCasters 用该级联的光源空间包围盒剔除，按几何体合并为实例化绘制，
+ * 使用深度预通道的着色器（depth_prepass.hlsl VSMainInstanced，无像素着色器）。
+ *
+ * 开销上限：
+ * - 近处级联（< kFirstCachedCascade）每帧重绘
+ * - 远处级联缓存在相机所在天体的局部空间（天体的自转/公转不会使缓存失效），只有
+ *   参考系内的太阳方向变化超过 kCacheAngleThreshold、相机移出缓存覆盖范围、参考天体切换
+ *   或超过 kMaxCachedFrames 帧时才重绘，且每帧最多重绘一个缓存级联
+ *
+ * 采样：textured.hlsl 的 SampleCascadedShadow（PS b3 / t6 / s1），receiveShadows 为 0 的物体跳过。
+ */
+class ShadowRenderer {
+public:
+    static constexpr uint32_t kCascadeCount = 4;
+    static constexpr uint32_t kResolution = 2048;
+    static constexpr uint32_t kFirstCachedCascade = 2;     // 该级联及更远的级联使用缓存
+    static constexpr float kCacheAngleThreshold = 0.5f;    // 度
+    static constexpr float kCacheMargin = 0.25f;           // 缓存级联的半径余量（相机可在其中移动而不重绘）
+    static constexpr uint32_t kMaxCachedFrames = 120;      // 缓存级联的最长寿命（刷新其中移动的投射者）
+    static constexpr float kSplitLambda = 0.75f;           // 对数切分比例（其余为线性）
+    static constexpr float kDepthBiasTexels = 1.5f;        // 采样时的深度偏移（以世界空间纹素大小计）
+
+    static constexpr UINT kShadowBufferSlot = 3;           // PS b3
+    static constexpr UINT kShadowMapSlot = 6;              // PS t6
+    static constexpr UINT kShadowSamplerSlot = 1;          // PS s1
+
+    /**
+     * @brief 本帧的相机与光源参数
+     */
+    struct View {
+        DirectX::XMMATRIX view = DirectX::XMMatrixIdentity();
+        float fovY = 1.0f;                                 // 弧度
+        float aspectRatio = 16.0f / 9.0f;
+        float nearPlane = 0.1f;
+        DirectX::XMFLOAT3 cameraPosition = { 0.0f, 0.0f, 0.0f };
+        DirectX::XMFLOAT3 sunPosition = { 0.0f, 0.0f, 0.0f };
+        DirectX::XMMATRIX referenceFrame = DirectX::XMMatrixIdentity();  // 相机所在天体的世界矩阵
+        uint32_t referenceId = 0xFFFFFFFFu;                // 参考天体（切换时丢弃缓存）
+    };
+
+    struct Stats {
+        uint32_t cascadesRendered = 0;
+        uint32_t casters = 0;
+        uint32_t drawCalls = 0;
+    };
+
+    ShadowRenderer() = default;
+    ~ShadowRenderer();
+
+    ShadowRenderer(const ShadowRenderer&) = delete;
+    ShadowRenderer& operator=(const ShadowRenderer&) = delete;
+
+    bool Initialize(ID3D11Device* device);
+
+    /**
+     * @brief 更新需要重绘的级联并刷新采样常量（在 RenderQueue::CollectFromECS 之后、Execute 之前调用）
+     *
+     * 保存并还原 VS b0；结束时阴影图仍绑定为 DSV，调用方（FrameGraph 的场景通道）先换渲染目标再 Bind。
+     * 光栅化/深度状态由之后的通道自己声明（RenderStateCache）。
+     */
+    void Render(ID3D11DeviceContext* context, const View& view, const RenderQueue& queue);
+
+    /**
+     * @brief 为着色通道绑定阴影图、比较采样器和级联常量
+     */
+    void Bind(ID3D11DeviceContext* context) const;
+    void Unbind(ID3D11DeviceContext* context) const;
+
+    void SetShadowDistance(float distance) { m_ShadowDistance = distance; }
+    float GetShadowDistance() const { return m_ShadowDistance; }
+
+    bool IsInitialized() const { return m_Initialized; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    /**
+     * @brief 一个级联最近一次渲染时的状态
+     */
+    struct Cascade {
+        bool valid = false;
+        DirectX::XMFLOAT4X4 lightViewProjection;          // 渲染时的世界 → 光源裁剪空间
+        DirectX::XMFLOAT4X4 frameAtRender;                // 渲染时参考天体的世界矩阵
+        DirectX::XMFLOAT3 localLightDir = { 0.0f, 1.0f, 0.0f };  // 参考系内的太阳方向
+        DirectX::XMFLOAT3 localCenter = { 0.0f, 0.0f, 0.0f };    // 参考系内的覆盖球心
+        float radius = 0.0f;                               // 覆盖半径（世界）
+        float depthBias = 0.0f;                            // 光源 NDC
+        uint32_t age = 0;
+        uint32_t referenceId = 0xFFFFFFFFu;
+    };
+
+    /**
+     * @brief 与 textured.hlsl 中 ShadowBuffer 一致
+     */
+    struct ShadowConstants {
+        DirectX::XMFLOAT4X4 cascadeMatrices[kCascadeCount];
+        DirectX::XMFLOAT4 cascadeEnabled;
+        DirectX::XMFLOAT4 cascadeBias;
+        DirectX::XMFLOAT4 shadowParams;
+    };
+
+    void RenderCascade(ID3D11DeviceContext* context, uint32_t index, const DirectX::XMVECTOR& center, float radius,
+                       const DirectX::XMVECTOR& lightDir, const View& view, const RenderQueue& queue);
+    void DrawCasters(ID3D11DeviceContext* context);
+    bool EnsureInstanceCapacity(uint32_t count);
+
+    ID3D11Device* m_Device = nullptr;
+    bool m_Initialized = false;
+    float m_ShadowDistance = 200.0f;
+
+    std::unique_ptr<resources::Shader> m_DepthShader;
+
+    ID3D11Texture2D* m_ShadowTexture = nullptr;                 // R32_TYPELESS，kCascadeCount 层
+    ID3D11DepthStencilView* m_CascadeDSV[kCascadeCount] = {};
+    ID3D11ShaderResourceView* m_ShadowSRV = nullptr;
+    ID3D11SamplerState* m_ComparisonSampler = nullptr;          // RenderStateCache 持有
+    PassState m_PassState;                                      // 斜率深度偏移、不剔除、LESS + 写深度（RenderStateCache 持有）
+    ID3D11Buffer* m_LightCB = nullptr;                          // VS b0（与 PerFrameBuffer 前 80 字节布局一致）
+    ID3D11Buffer* m_ShadowCB = nullptr;                         // PS b3
+
+    // 投射者实例数据（StructuredBuffer<ObjectData>，VS t5）与下标流（slot 1）
+    ID3D11Buffer* m_InstanceBuffer = nullptr;
+    ID3D11ShaderResourceView* m_InstanceSRV = nullptr;
+    ID3D11Buffer* m_InstanceIndexBuffer = nullptr;
+    uint32_t m_InstanceCapacity = 0;
+
+    Cascade m_Cascades[kCascadeCount];
+    std::vector<ShadowCaster> m_Casters;
+    std::vector<uint32_t> m_CasterOrder;
+    std::vector<ObjectData> m_InstanceData;
+    Stats m_Stats;
+};
+
+} // namespace outer_wilds
@@ -1,5 +1,8 @@
 #include "SkyboxRenderer.h"
 #include "resources/Shader.h"
+#include "GpuProfiler.h"
+#include "GpuMemory.h"
+#include "RenderStateCache.h"
 #include <vector>
 #include <cmath>
 #include <iostream>
@@ -10,8 +13,11 @@ SkyboxRenderer::~SkyboxRenderer() {
     if (m_VertexBuffer) m_VertexBuffer->Release();
     if (m_IndexBuffer) m_IndexBuffer->Release();
     if (m_ConstantBuffer) m_ConstantBuffer->Release();
-    if (m_DepthState) m_DepthState->Release();
-    if (m_RasterizerState) m_RasterizerState->Release();
+    for (auto* rtv : m_CubemapFaceRTV) {
+        if (rtv) rtv->Release();
+    }
+    if (m_CubemapSRV) m_CubemapSRV->Release();
+    if (m_CubemapTexture) m_CubemapTexture->Release();
 }
 
 bool SkyboxRenderer::Initialize(ID3D11Device* device) {
@@ -27,7 +33,7 @@ bool SkyboxRenderer::Initialize(ID3D11Device* device) {
         return false;
     }
 
-    if (!CreateRenderStates(device)) {
+    if (!CreateRenderStates()) {
         std::cout << "[SkyboxRenderer] Failed to create render states" << std::endl;
         return false;
     }
@@ -43,6 +49,13 @@ bool SkyboxRenderer::Initialize(ID3D11Device* device) {
         std::cout << "[SkyboxRenderer] Failed to create constant buffer" << std::endl;
         return false;
     }
+    GpuMemory::Track(m_ConstantBuffer);
+
+    // 立方体贴图模式可选：失败时退回逐像素程序化星空
+    m_CubemapReady = CreateCubemap(device);
+    if (!m_CubemapReady) {
+        std::cout << "[SkyboxRenderer] Cubemap bake unavailable, using procedural sky" << std::endl;
+    }
 
     std::cout << "[SkyboxRenderer] Initialized successfully" << std::endl;
     return true;
@@ -106,6 +119,7 @@ bool SkyboxRenderer::CreateSphere(ID3D11Device* device) {
     if (FAILED(device->CreateBuffer(&vbDesc, &vbData, &m_VertexBuffer))) {
         return false;
     }
+    GpuMemory::Track(m_VertexBuffer);
     
     // 创建索引缓冲区
     D3D11_BUFFER_DESC ibDesc = {};
@@ -119,6 +133,7 @@ bool SkyboxRenderer::CreateSphere(ID3D11Device* device) {
     if (FAILED(device->CreateBuffer(&ibDesc, &ibData, &m_IndexBuffer))) {
         return false;
     }
+    GpuMemory::Track(m_IndexBuffer);
     
     m_IndexCount = static_cast<UINT>(indices.size());
     
@@ -140,74 +155,88 @@ bool SkyboxRenderer::CreateShader(ID3D11Device* device) {
     return true;
 }
 
-bool SkyboxRenderer::CreateRenderStates(ID3D11Device* device) {
-    // 深度状态：读取深度但不写入，使用 LESS_EQUAL 确保天空盒在最远处
-    D3D11_DEPTH_STENCIL_DESC depthDesc = {};
-    depthDesc.DepthEnable = TRUE;
-    depthDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;  // 不写入深度
-    depthDesc.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;       // <= 可以通过
-    
-    if (FAILED(device->CreateDepthStencilState(&depthDesc, &m_DepthState))) {
+bool SkyboxRenderer::CreateCubemap(ID3D11Device* device) {
+    m_CubemapShader = std::make_unique<resources::Shader>();
+    if (!m_CubemapShader->LoadFromFile(device, "skybox_cube.vs", "skybox_cube.ps", true)) {
+        m_CubemapShader.reset();
         return false;
     }
-    
-    // 光栅化状态：禁用背面剔除（从内部看球体）
-    D3D11_RASTERIZER_DESC rastDesc = {};
-    rastDesc.FillMode = D3D11_FILL_SOLID;
-    rastDesc.CullMode = D3D11_CULL_NONE;  // 不剔除，从内部看
-    rastDesc.FrontCounterClockwise = FALSE;
-    rastDesc.DepthClipEnable = TRUE;
-    
-    if (FAILED(device->CreateRasterizerState(&rastDesc, &m_RasterizerState))) {
+
+    // 星星亮度超过 1，使用浮点格式；GenerateMips 避免远处采样时星点闪烁
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width = kCubemapSize;
+    textureDesc.Height = kCubemapSize;
+    textureDesc.MipLevels = 0;
+    textureDesc.ArraySize = 6;
+    textureDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Usage = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    textureDesc.MiscFlags = D3D11_RESOURCE_MISC_TEXTURECUBE | D3D11_RESOURCE_MISC_GENERATE_MIPS;
+    if (FAILED(device->CreateTexture2D(&textureDesc, nullptr, &m_CubemapTexture))) {
         return false;
     }
-    
-    return true;
-}
+    GpuMemory::Track(m_CubemapTexture);
 
-void SkyboxRenderer::Render(
-    ID3D11DeviceContext* context,
-    const DirectX::XMMATRIX& viewProjection,
-    const DirectX::XMFLOAT3& cameraPosition,
-    float time
-) {
-    if (!context || !m_VertexBuffer || !m_IndexBuffer || !m_Shader) {
-        return;
+    for (UINT face = 0; face < 6; face++) {
+        D3D11_RENDER_TARGET_VIEW_DESC rtvDesc = {};
+        rtvDesc.Format = textureDesc.Format;
+        rtvDesc.ViewDimension = D3D11_RTV_DIMENSION_TEXTURE2DARRAY;
+        rtvDesc.Texture2DArray.MipSlice = 0;
+        rtvDesc.Texture2DArray.FirstArraySlice = face;
+        rtvDesc.Texture2DArray.ArraySize = 1;
+        if (FAILED(device->CreateRenderTargetView(m_CubemapTexture, &rtvDesc, &m_CubemapFaceRTV[face]))) {
+            return false;
+        }
     }
-    
-    // 保存当前状态
-    ID3D11DepthStencilState* prevDepthState = nullptr;
-    UINT prevStencilRef = 0;
-    context->OMGetDepthStencilState(&prevDepthState, &prevStencilRef);
-    
-    ID3D11RasterizerState* prevRastState = nullptr;
-    context->RSGetState(&prevRastState);
-    
-    // 设置天空盒渲染状态
-    context->OMSetDepthStencilState(m_DepthState, 0);
-    context->RSSetState(m_RasterizerState);
-    
-    // 更新常量缓冲区
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = textureDesc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+    srvDesc.TextureCube.MipLevels = static_cast<UINT>(-1);
+    if (FAILED(device->CreateShaderResourceView(m_CubemapTexture, &srvDesc, &m_CubemapSRV))) {
+        return false;
+    }
+
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    m_CubemapSampler = stateCache.GetSamplerState(D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP);
+
+    // 烘焙时没有深度缓冲
+    m_BakeState.blend = m_PassState.blend;
+    m_BakeState.depthStencil = stateCache.GetDepthStencilState(false, false, D3D11_COMPARISON_ALWAYS);
+    m_BakeState.rasterizer = m_PassState.rasterizer;
+    return m_CubemapSampler && m_BakeState.depthStencil;
+}
+
+bool SkyboxRenderer::CreateRenderStates() {
+    RenderStateCache& stateCache = RenderStateCache::GetInstance();
+    m_PassState.blend = stateCache.GetBlendState(RenderStateCache::BlendMode::Opaque);
+    // 深度状态：读取深度但不写入，使用 LESS_EQUAL 确保天空盒在最远处
+    m_PassState.depthStencil = stateCache.GetDepthStencilState(true, false, D3D11_COMPARISON_LESS_EQUAL);
+    // 光栅化状态：禁用背面剔除（从内部看球体）
+    m_PassState.rasterizer = stateCache.GetRasterizerState(D3D11_CULL_NONE);
+    return m_PassState.blend && m_PassState.depthStencil && m_PassState.rasterizer;
+}
+
+void SkyboxRenderer::UpdateConstants(ID3D11DeviceContext* context, const DirectX::XMMATRIX& viewProjection,
+                                     const DirectX::XMFLOAT3& cameraPosition, const DirectX::XMFLOAT3& parallaxOffset,
+                                     float time) {
     D3D11_MAPPED_SUBRESOURCE mapped;
     if (SUCCEEDED(context->Map(m_ConstantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
         SkyboxCB* cb = static_cast<SkyboxCB*>(mapped.pData);
         cb->viewProjection = DirectX::XMMatrixTranspose(viewProjection);
         cb->cameraPosition = cameraPosition;
         cb->time = time;
-        
-        // 计算视差偏移
-        cb->parallaxOffset.x = cameraPosition.x * m_ParallaxFactor;
-        cb->parallaxOffset.y = cameraPosition.y * m_ParallaxFactor;
-        cb->parallaxOffset.z = cameraPosition.z * m_ParallaxFactor;
+        cb->parallaxOffset = parallaxOffset;
         cb->parallaxFactor = m_ParallaxFactor;
-        
         context->Unmap(m_ConstantBuffer, 0);
     }
-    
-    // 绑定shader
-    context->VSSetShader(m_Shader->GetVertexShader(), nullptr, 0);
-    context->PSSetShader(m_Shader->GetPixelShader(), nullptr, 0);
-    context->IASetInputLayout(m_Shader->GetInputLayout());
+}
+
+void SkyboxRenderer::DrawSphere(ID3D11DeviceContext* context, const resources::Shader& shader) {
+    context->VSSetShader(shader.GetVertexShader(), nullptr, 0);
+    context->PSSetShader(shader.GetPixelShader(), nullptr, 0);
+    context->IASetInputLayout(shader.GetInputLayout());
     
     // 绑定常量缓冲区
     context->VSSetConstantBuffers(0, 1, &m_ConstantBuffer);
@@ -220,15 +249,116 @@ void SkyboxRenderer::Render(
     context->IASetIndexBuffer(m_IndexBuffer, DXGI_FORMAT_R32_UINT, 0);
     context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     
-    // 绘制
     context->DrawIndexed(m_IndexCount, 0, 0);
+}
+
+void SkyboxRenderer::BakeFace(ID3D11DeviceContext* context, uint32_t face, float time) {
+    using namespace DirectX;
+    // D3D 立方体贴图面顺序：+X, -X, +Y, -Y, +Z, -Z
+    static const XMFLOAT3 kForward[6] = {
+        { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+        { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+    };
+    static const XMFLOAT3 kUp[6] = {
+        { 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f },
+        { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }
+    };
+
+    // 从原点看球体内侧：方向只来自顶点位置，视差偏移在采样时由球体平移体现
+    const XMMATRIX view = XMMatrixLookToLH(XMVectorZero(), XMLoadFloat3(&kForward[face]), XMLoadFloat3(&kUp[face]));
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV2, 1.0f, 1.0f, 2000.0f);
+    const XMFLOAT3 origin(0.0f, 0.0f, 0.0f);
+    UpdateConstants(context, view * projection, origin, origin, time);
+
+    const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    context->ClearRenderTargetView(m_CubemapFaceRTV[face], clearColor);
+    context->OMSetRenderTargets(1, &m_CubemapFaceRTV[face], nullptr);
+    DrawSphere(context, *m_Shader);
+}
+
+void SkyboxRenderer::UpdateCubemap(ID3D11DeviceContext* context, float time) {
+    if (!context || !m_CubemapReady || m_Mode != Mode::Cubemap || !m_Shader) {
+        return;
+    }
+    const bool refreshDue = m_CubemapRefreshInterval > 0.0f && time - m_LastBakeTime >= m_CubemapRefreshInterval;
+    if (m_CubemapBaked && !refreshDue) {
+        return;
+    }
+    GPU_PROFILE_SCOPE(m_GpuProfiler, context, "SkyboxBake");
+
+    // 渲染目标 / 视口由 FrameGraph 在之后的通道重新绑定，混合 / 深度 / 光栅化状态由之后的通道自己声明
+    D3D11_VIEWPORT viewport = {};
+    viewport.Width = static_cast<float>(kCubemapSize);
+    viewport.Height = static_cast<float>(kCubemapSize);
+    viewport.MaxDepth = 1.0f;
+    context->RSSetViewports(1, &viewport);
+    RenderStateCache::GetInstance().Apply(context, m_BakeState);
+
+    if (!m_CubemapBaked) {
+        // 启动：一次烘焙全部面
+        for (uint32_t face = 0; face < 6; face++) {
+            BakeFace(context, face, time);
+        }
+        m_CubemapBaked = true;
+        m_NextBakeFace = 0;
+        m_LastBakeTime = time;
+    } else {
+        // 低频刷新：每帧一个面，6 个面刷新完才开始下一个间隔
+        BakeFace(context, m_NextBakeFace, time);
+        m_NextBakeFace = (m_NextBakeFace + 1) % 6;
+        if (m_NextBakeFace == 0) {
+            m_LastBakeTime = time;
+        }
+    }
+
+    // 立方体贴图的面仍绑定为 RTV，先解除再生成 mip
+    context->OMSetRenderTargets(0, nullptr, nullptr);
+    context->GenerateMips(m_CubemapSRV);
+}
+
+void SkyboxRenderer::Render(
+    ID3D11DeviceContext* context,
+    const DirectX::XMMATRIX& viewProjection,
+    const DirectX::XMFLOAT3& cameraPosition,
+    float time
+) {
+    if (!context || !m_VertexBuffer || !m_IndexBuffer || !m_Shader) {
+        return;
+    }
+    GPU_PROFILE_SCOPE(m_GpuProfiler, context, "Skybox");
+    
+    // 保存 b0（在场景之后绘制：b0 是场景的 PerFrameBuffer，透明段还要用）
+    ID3D11Buffer* prevVSBuffer = nullptr;
+    ID3D11Buffer* prevPSBuffer = nullptr;
+    context->VSGetConstantBuffers(0, 1, &prevVSBuffer);
+    context->PSGetConstantBuffers(0, 1, &prevPSBuffer);
+    
+    // 设置天空盒渲染状态（不还原：之后的通道自己声明）
+    RenderStateCache::GetInstance().Apply(context, m_PassState);
+    
+    // 计算视差偏移
+    const DirectX::XMFLOAT3 parallaxOffset(cameraPosition.x * m_ParallaxFactor,
+                                           cameraPosition.y * m_ParallaxFactor,
+                                           cameraPosition.z * m_ParallaxFactor);
+    UpdateConstants(context, viewProjection, cameraPosition, parallaxOffset, time);
+    
+    const bool sampleCubemap = GetMode() == Mode::Cubemap && m_CubemapBaked && m_CubemapShader;
+    if (sampleCubemap) {
+        context->PSSetShaderResources(0, 1, &m_CubemapSRV);
+        context->PSSetSamplers(0, 1, &m_CubemapSampler);
+        DrawSphere(context, *m_CubemapShader);
+        ID3D11ShaderResourceView* nullSRV = nullptr;
+        context->PSSetShaderResources(0, 1, &nullSRV);
+    } else {
+        DrawSphere(context, *m_Shader);
+    }
     
-    // 恢复之前的状态
-    context->OMSetDepthStencilState(prevDepthState, prevStencilRef);
-    context->RSSetState(prevRastState);
+    // 恢复 b0
+    context->VSSetConstantBuffers(0, 1, &prevVSBuffer);
+    context->PSSetConstantBuffers(0, 1, &prevPSBuffer);
     
-    if (prevDepthState) prevDepthState->Release();
-    if (prevRastState) prevRastState->Release();
+    if (prevVSBuffer) prevVSBuffer->Release();
+    if (prevPSBuffer) prevPSBuffer->Release();
 }
 
 } // namespace outer_wilds
@@ -1,9 +1,11 @@
 #pragma once
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include "RenderStateCache.h"
 #include <memory>
 
 namespace outer_wilds {
+class GpuProfiler;
 namespace resources {
     class Shader;
 }
@@ -15,9 +17,20 @@ namespace resources {
  * - 程序化生成星空（无需纹理）
  * - 视差效果：相机移动时星空有极轻微的位移
  * - 银河和星星闪烁效果
+ *
+ * 在不透明几何体之后绘制（z = w，LESS_EQUAL 且不写深度），被星球覆盖的像素在早期深度测试中被拒绝。
+ * Mode::Cubemap（默认）在启动时把程序化星空烘焙到立方体贴图，之后每像素只采样一次；
+ * 闪烁按 SetCubemapRefreshInterval 低频刷新（每帧最多重新烘焙一个面）。
  */
 class SkyboxRenderer {
 public:
+    enum class Mode {
+        Procedural,     // 每像素计算程序化星空
+        Cubemap         // 采样烘焙的立方体贴图
+    };
+
+    static constexpr UINT kCubemapSize = 1024;
+
     SkyboxRenderer() = default;
     ~SkyboxRenderer();
 
@@ -29,7 +42,15 @@ public:
     bool Initialize(ID3D11Device* device);
 
     /**
-     * @brief 渲染天空盒
+     * @brief 烘焙 / 低频刷新立方体贴图（Mode::Cubemap；FrameGraph 中场景通道之前的独立通道）
+     *
+     * 首次调用烘焙全部 6 个面；之后刷新间隔到期时每次调用重新烘焙一个面。结束时解除渲染目标，
+     * 不还原之前的 RT/DSV 和视口（由之后的通道声明）。
+     */
+    void UpdateCubemap(ID3D11DeviceContext* context, float time);
+
+    /**
+     * @brief 渲染天空盒（在不透明几何体之后调用；声明自己的深度/光栅化状态，保存并还原 VS/PS b0）
      * @param context D3D11上下文
      * @param viewProjection 视图投影矩阵
      * @param cameraPosition 相机位置
@@ -48,6 +69,22 @@ public:
      */
     void SetParallaxFactor(float factor) { m_ParallaxFactor = factor; }
 
+    /**
+     * @brief 设置绘制模式（立方体贴图资源创建失败时始终为 Procedural）
+     */
+    void SetMode(Mode mode) { m_Mode = mode; }
+    Mode GetMode() const { return m_CubemapReady ? m_Mode : Mode::Procedural; }
+
+    /**
+     * @brief 立方体贴图刷新间隔（秒，0 = 只在启动时烘焙一次）
+     */
+    void SetCubemapRefreshInterval(float seconds) { m_CubemapRefreshInterval = seconds; }
+    
+    /**
+     * @brief GPU 分段计时（"Skybox"，可为空）
+     */
+    void SetGpuProfiler(GpuProfiler* profiler) { m_GpuProfiler = profiler; }
+
 private:
     // GPU资源
     ID3D11Buffer* m_VertexBuffer = nullptr;
@@ -55,15 +92,29 @@ private:
     ID3D11Buffer* m_ConstantBuffer = nullptr;
     UINT m_IndexCount = 0;
     
-    // 渲染状态
-    ID3D11DepthStencilState* m_DepthState = nullptr;
-    ID3D11RasterizerState* m_RasterizerState = nullptr;
+    // 渲染状态（RenderStateCache 持有）：LESS_EQUAL 不写深度、不剔除（从内部看球体）
+    PassState m_PassState;
+    PassState m_BakeState;                  // 烘焙立方体贴图：没有深度缓冲
     
     // Shader
     std::unique_ptr<resources::Shader> m_Shader;
+    std::unique_ptr<resources::Shader> m_CubemapShader;    // skybox_cube.hlsl
+    
+    // 烘焙的星空立方体贴图（R16G16B16A16_FLOAT，完整 mip 链）
+    ID3D11Texture2D* m_CubemapTexture = nullptr;
+    ID3D11RenderTargetView* m_CubemapFaceRTV[6] = {};
+    ID3D11ShaderResourceView* m_CubemapSRV = nullptr;
+    ID3D11SamplerState* m_CubemapSampler = nullptr;  // RenderStateCache 持有
+    bool m_CubemapReady = false;            // 资源已创建
+    bool m_CubemapBaked = false;            // 6 个面都已烘焙过
+    uint32_t m_NextBakeFace = 0;
+    float m_LastBakeTime = 0.0f;
+    float m_CubemapRefreshInterval = 2.0f;
+    Mode m_Mode = Mode::Cubemap;
     
     // 参数
     float m_ParallaxFactor = 0.0001f;  // 视差系数
+    GpuProfiler* m_GpuProfiler = nullptr;
     
     // 常量缓冲区结构
     struct SkyboxCB {
@@ -76,7 +127,12 @@ private:
     
     bool CreateSphere(ID3D11Device* device);
     bool CreateShader(ID3D11Device* device);
-    bool CreateRenderStates(ID3D11Device* device);
+    bool CreateRenderStates();
+    bool CreateCubemap(ID3D11Device* device);
+    void BakeFace(ID3D11DeviceContext* context, uint32_t face, float time);
+    void UpdateConstants(ID3D11DeviceContext* context, const DirectX::XMMATRIX& viewProjection,
+                         const DirectX::XMFLOAT3& cameraPosition, const DirectX::XMFLOAT3& parallaxOffset, float time);
+    void DrawSphere(ID3D11DeviceContext* context, const resources::Shader& shader);
 };
 
 } // namespace outer_wilds
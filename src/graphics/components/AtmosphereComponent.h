@@ -0,0 +1,39 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace outer_wilds {
+namespace components {
+
+/**
+ * @brief 行星大气（AtmosphereRenderer 用预计算 LUT 绘制散射）
+ *
+ * 散射 / 吸收系数以“每个大气层高度”为单位（大气层高度 = 1），与行星的实际尺寸无关：
+ * 默认值是地球大气（100 km）按此归一化的结果，小尺寸行星也得到相同的光学厚度。
+ * 标高同样是大气层高度的比例。
+ *
+ * 球心取实体 TransformComponent 的世界平移。修改下列参数后递增 version（或直接修改，
+ * AtmosphereRenderer 比较参数值），透射率和多重散射 LUT 只在参数变化时重新计算。
+ */
+struct AtmosphereComponent {
+    float planetRadius = 1.0f;          // 地面半径（世界单位）
+    float atmosphereHeight = 0.0f;      // 大气层厚度（世界单位，0 = 不绘制）
+
+    DirectX::XMFLOAT3 rayleighScattering = { 0.58f, 1.35f, 3.31f };
+    float rayleighScaleHeight = 0.08f;
+    float mieScattering = 0.40f;
+    float mieExtinction = 0.444f;
+    float mieScaleHeight = 0.012f;
+    float miePhaseG = 0.8f;
+    DirectX::XMFLOAT3 ozoneAbsorption = { 0.065f, 0.188f, 0.0085f };
+    float groundAlbedo = 0.3f;
+
+    float densityScale = 1.0f;          // 整体密度倍数（稀薄 / 浓厚大气）
+    float sunIntensity = 8.0f;          // 太阳照度（乘到散射结果上）
+
+    bool isVisible = true;
+    uint32_t version = 0;
+};
+
+} // namespace components
+} // namespace outer_wilds
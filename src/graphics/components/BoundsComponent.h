@@ -0,0 +1,100 @@
+#pragma once
+#include "../resources/Mesh.h"
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <vector>
+#include <cfloat>
+#include <cmath>
+
+namespace outer_wilds {
+namespace components {
+
+/**
+ * @brief 局部空间包围体组件（用于视锥剔除）
+ *
+ * - 由 SceneAssetLoader 在加载时挂载（优先复用 ModelBounds，没有时从顶点计算）
+ * - 存储模型空间的包围球，RenderQueue 每帧用 Transform 变换到世界空间再测试
+ * - MultiMeshComponent 的每个子 mesh 可额外提供 subMeshBounds（与 meshes 一一对应）
+ *
+ * 没有此组件的实体不参与剔除（始终认为可见）
+ */
+struct BoundsComponent {
+    DirectX::XMFLOAT3 localCenter = { 0.0f, 0.0f, 0.0f };
+    float localRadius = 0.0f;
+
+    // 子 mesh 包围球（仅 MultiMeshComponent 使用，可为空）
+    std::vector<DirectX::BoundingSphere> subMeshBounds;
+
+    bool IsValid() const { return localRadius > 0.0f; }
+
+    /**
+     * @brief 由 AABB 构建（ModelBounds.min/max）
+     */
+    static DirectX::BoundingSphere SphereFromMinMax(const DirectX::XMFLOAT3& min, const DirectX::XMFLOAT3& max) {
+        DirectX::BoundingSphere sphere;
+        if (min.x > max.x || min.y > max.y || min.z > max.z) {
+            sphere.Radius = 0.0f;
+            return sphere;
+        }
+        sphere.Center = { (min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f };
+        float dx = max.x - min.x;
+        float dy = max.y - min.y;
+        float dz = max.z - min.z;
+        sphere.Radius = std::sqrt(dx * dx + dy * dy + dz * dz) * 0.5f;
+        return sphere;
+    }
+
+    /**
+     * @brief 从顶点数据计算包围球（AABB 外接球）
+     */
+    static DirectX::BoundingSphere SphereFromVertices(const std::vector<resources::Vertex>& vertices) {
+        DirectX::XMFLOAT3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+        DirectX::XMFLOAT3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        for (const auto& v : vertices) {
+            if (v.position.x < min.x) min.x = v.position.x;
+            if (v.position.y < min.y) min.y = v.position.y;
+            if (v.position.z < min.z) min.z = v.position.z;
+            if (v.position.x > max.x) max.x = v.position.x;
+            if (v.position.y > max.y) max.y = v.position.y;
+            if (v.position.z > max.z) max.z = v.position.z;
+        }
+        return SphereFromMinMax(min, max);
+    }
+
+    /**
+     * @brief Mesh 的包围球（CPU 顶点已释放时使用 Mesh 缓存的 AABB，结果与 SphereFromVertices 相同）
+     */
+    static DirectX::BoundingSphere SphereFromMesh(const resources::Mesh& mesh) {
+        DirectX::XMFLOAT3 min, max;
+        mesh.GetLocalBounds(min, max);
+        return SphereFromMinMax(min, max);
+    }
+
+    void SetSphere(const DirectX::BoundingSphere& sphere) {
+        localCenter = sphere.Center;
+        localRadius = sphere.Radius;
+    }
+
+    /**
+     * @brief 将局部包围球变换到世界空间（S*R*T，半径按最大缩放分量放大）
+     */
+    static DirectX::BoundingSphere ToWorld(const DirectX::XMFLOAT3& center, float radius,
+                                           const DirectX::XMFLOAT3& position,
+                                           const DirectX::XMFLOAT4& rotation,
+                                           const DirectX::XMFLOAT3& scale) {
+        using namespace DirectX;
+        XMVECTOR c = XMVectorMultiply(XMLoadFloat3(&center), XMLoadFloat3(&scale));
+        c = XMVector3Rotate(c, XMLoadFloat4(&rotation));
+        c = XMVectorAdd(c, XMLoadFloat3(&position));
+
+        float maxScale = (std::fmax)(std::fabs(scale.x), (std::fmax)(std::fabs(scale.y), std::fabs(scale.z)));
+
+        BoundingSphere world;
+        XMStoreFloat3(&world.Center, c);
+        world.Radius = radius * maxScale;
+        return world;
+    }
+};
+
+} // namespace components
+} // namespace outer_wilds
@@ -24,6 +24,10 @@ struct CameraComponent : public Component {
     float pitch = 0.0f; // Vertical rotation (radians) - DEPRECATED for spherical gravity
     float moveSpeed = 10.0f;
     float lookSensitivity = 0.002f;
+
+    // 后期锁存（RenderSystem）：每个鼠标计数对应的视角弧度；0 表示该相机的朝向不跟随鼠标。
+    // 由控制相机的系统每帧设置（约定：鼠标右移向右转，下移向下看）
+    float lateLatchSensitivity = 0.0f;
     
     // === 球面重力相机系统：局部参考系 ===
     // 核心思想：相机旋转相对于玩家的局部坐标系，而非世界坐标系
@@ -0,0 +1,35 @@
+#pragma once
+#include "../resources/Mesh.h"
+#include "../resources/Material.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace outer_wilds {
+namespace components {
+
+/**
+ * @brief GPU 驱动的大量实例（碎石、小行星带、地表道具）
+ *
+ * 同一 mesh + material 的全部实例由 GpuInstanceRenderer 处理：实例数据只在 version 变化时上传一次，
+ * 计算着色器每帧做视锥 + Hi-Z 剔除并压缩可见实例，再用一次 DrawIndexedInstancedIndirect 绘制。
+ * 每帧 CPU 开销与实例数无关（每个组件一次 Dispatch + 一次间接绘制）。
+ *
+ * 实例矩阵在实体局部空间（行主序），实体的 TransformComponent 移动 / 旋转时整组跟随，不需要重新上传。
+ * 不进入 RenderQueue（不与普通批次排序合并），也不投射阴影。
+ */
+struct GpuInstancedComponent {
+    std::shared_ptr<resources::Mesh> mesh;
+    std::shared_ptr<resources::Material> material;
+    std::vector<DirectX::XMFLOAT4X4> instances;     // 实例 → 实体局部空间
+
+    bool isVisible = true;
+    bool receiveShadows = true;
+
+    // 修改 instances 后递增，GpuInstanceRenderer 据此重新上传
+    uint32_t version = 0;
+};
+
+} // namespace components
+} // namespace outer_wilds
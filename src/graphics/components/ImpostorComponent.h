@@ -0,0 +1,22 @@
+#pragma once
+
+namespace outer_wilds {
+namespace components {
+
+/**
+ * @brief 远处天体的替身（impostor）渲染
+ *
+ * 投影半径（占半个视口高度的比例，与 LOD 选择相同）低于 screenRadius 时，
+ * RenderQueue 不再提交该实体的网格批次，而是输出一个球形替身：
+ * 所有替身由 ImpostorRenderer 用一次实例化绘制完成（面向相机的四边形 + 像素着色器射线求交）。
+ * 颜色取自首个批次的材质/反照率纹理，光照方向取自批次的 lightDir。
+ *
+ * 由 SolarSystemBuilder 挂到太阳、行星和卫星上。
+ */
+struct ImpostorComponent {
+    float screenRadius = 0.04f;   // 约 720p 下 14 像素半径
+    float radius = 0.0f;          // 世界空间球半径（0 = 使用包围球半径）
+};
+
+} // namespace components
+} // namespace outer_wilds
@@ -1,12 +1,27 @@
 #pragma once
 #include "../resources/Mesh.h"
 #include "../resources/Material.h"
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 namespace outer_wilds {
 namespace components {
 
+/**
+ * Discrete LOD chain (generated at import by MeshSimplifier, or authored)
+ * levels[i] is LOD i+1 (LOD 0 is the component's own mesh); the renderer switches to
+ * levels[i] once the projected bounding radius (fraction of half the viewport height)
+ * drops below screenRadii[i]. screenRadii must decrease with i.
+ */
+struct MeshLODChain {
+    std::vector<std::shared_ptr<resources::Mesh>> levels;
+    std::vector<float> screenRadii;
+
+    bool IsEmpty() const { return levels.empty(); }
+    size_t GetLevelCount() const { return (std::min)(levels.size(), screenRadii.size()); }
+};
+
 /**
  * Component for mesh rendering with material support
  * Follows ECS pattern - each entity with this component represents a renderable mesh object
@@ -14,6 +29,7 @@ namespace components {
 struct MeshComponent {
     std::shared_ptr<resources::Mesh> mesh;
     std::shared_ptr<resources::Material> material;
+    MeshLODChain lod;
     
     // Runtime state
     bool isVisible = true;
@@ -32,6 +48,7 @@ struct MeshComponent {
 struct MultiMeshComponent {
     std::vector<std::shared_ptr<resources::Mesh>> meshes;
     std::vector<std::shared_ptr<resources::Material>> materials;
+    std::vector<MeshLODChain> lods;  // 与 meshes 一一对应（可为空）；所有子 mesh 按实体整体包围球选级
     
     // Runtime state
     bool isVisible = true;
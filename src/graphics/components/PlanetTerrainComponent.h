@@ -0,0 +1,41 @@
+#pragma once
+#include "../resources/Material.h"
+#include <DirectXMath.h>
+#include <functional>
+#include <memory>
+
+namespace outer_wilds {
+namespace components {
+
+/**
+ * @brief 立方体球分块 LOD 地形（由 PlanetTerrainSystem 驱动）
+ *
+ * 挂到星球实体上（需要 TransformComponent）后，星球表面被拆成 6 个立方体面上的四叉树：
+ * - 相机越近细分越深，补丁在工作线程生成、主线程分帧上传
+ * - 每个补丁是一个子实体（MeshComponent + HierarchyComponent + BoundsComponent），跟随星球变换
+ * - LOD 边界的 T 型接缝由补丁四周向球心下沉的裙边遮挡
+ * - 星球有 SectorComponent 时，只有当前扇区（玩家所在或相机位于影响半径内）细分到 maxDepth，
+ *   其余星球停在 inactiveMaxDepth
+ *
+ * 所有距离均为星球模型空间单位（与 TransformComponent.scale 相乘后为世界单位）
+ */
+struct PlanetTerrainComponent {
+    float radius = 50.0f;             // 模型空间半径
+    int patchResolution = 32;         // 每个补丁每边的格子数
+    int maxDepth = 8;                 // 当前扇区的最大四叉树深度
+    int inactiveMaxDepth = 2;         // 非当前扇区的最大深度
+    float splitDistanceFactor = 2.0f; // 相机到补丁中心距离 < 补丁边长 * 该系数时细分
+    float skirtFactor = 0.1f;         // 裙边深度 = 补丁边长 * 该系数
+
+    // 地形材质；为空时复用星球自身 MeshComponent/MultiMeshComponent 的第一个材质
+    std::shared_ptr<resources::Material> material;
+
+    // 沿单位方向的高度偏移（模型空间）；在工作线程调用，必须线程安全
+    std::function<float(const DirectX::XMFLOAT3& direction)> heightFunction;
+
+    // 6 个根补丁就绪后隐藏星球原有的网格
+    bool hideBaseMesh = true;
+};
+
+} // namespace components
+} // namespace outer_wilds
@@ -1,5 +1,7 @@
 #include "AssimpLoader.h"
 #include "TextureLoader.h"
+#include "MeshOptimizer.h"
+#include "MeshCache.h"
 #include "../../core/DebugManager.h"
 #include <algorithm>
 #include <cfloat>
@@ -14,6 +16,18 @@ bool AssimpLoader::LoadFromFile(const std::string& filePath, LoadedModel& outMod
     if (options.verbose) {
         std::cout << "[AssimpLoader] Starting load: " << filePath << std::endl;
     }
+
+    // 二进制缓存命中：跳过 Assimp 导入和网格优化
+    const uint32_t cacheOptions = (options.skipBoundsCalculation ? 1u : 0u) | (options.fastLoad ? 2u : 0u) |
+                                  (options.optimizeMeshes ? 4u : 0u);
+    const uint64_t cacheKey = MeshCache::GetInstance().HashSource(filePath, MeshCache::SourceKind::AssimpSingle, cacheOptions);
+    if (MeshCache::GetInstance().Read(cacheKey, outModel)) {
+        if (options.verbose) {
+            std::cout << "[AssimpLoader] Loaded from mesh cache: " << outModel.mesh->GetVertices().size()
+                      << " vertices" << std::endl;
+        }
+        return true;
+    }
     
     Assimp::Importer importer;
     
@@ -148,6 +162,10 @@ bool AssimpLoader::LoadFromFile(const std::string& filePath, LoadedModel& outMod
     outModel.mesh = std::make_shared<Mesh>();
     outModel.mesh->SetVertices(vertices);
     outModel.mesh->SetIndices(indices);
+    outModel.mesh->SetVertexFormat(Mesh::SelectVertexFormat(vertices));
+    if (options.optimizeMeshes) {
+        MeshOptimizer::Optimize(*outModel.mesh);
+    }
     
     // Store collision mesh if found
     if (!collisionVertices.empty()) {
@@ -168,14 +186,16 @@ bool AssimpLoader::LoadFromFile(const std::string& filePath, LoadedModel& outMod
         std::to_string(indices.size() / 3) + " triangles, " +
         std::to_string(outModel.embeddedTextures.size()) + " embedded textures, " +
         std::to_string(scene->mNumMaterials) + " materials");
-    
+
+    MeshCache::GetInstance().Write(cacheKey, outModel);
     return true;
 }
 
 bool AssimpLoader::CreateTextureFromEmbedded(
     ID3D11Device* device,
     const EmbeddedTexture& embeddedTex,
-    ID3D11ShaderResourceView** outTexture
+    ID3D11ShaderResourceView** outTexture,
+    TextureUsage usage
 ) {
     if (embeddedTex.data.empty()) {
         return false;
@@ -188,7 +208,9 @@ bool AssimpLoader::CreateTextureFromEmbedded(
             embeddedTex.data.data(),
             embeddedTex.data.size(),
             embeddedTex.formatHint,
-            outTexture
+            outTexture,
+            true,
+            usage
         );
     } else {
         // Raw RGBA data
@@ -614,8 +636,17 @@ std::vector<EmbeddedTexture> AssimpLoader::ExtractMaterialEmbeddedTextures(
 // Multi-Material Model Loading
 // ============================================================================
 
-bool AssimpLoader::LoadMultiMaterialModel(const std::string& filePath, MultiMaterialModel& outModel) {
+bool AssimpLoader::LoadMultiMaterialModel(const std::string& filePath, MultiMaterialModel& outModel,
+                                          const ModelLoadOptions& options) {
     std::cout << "[AssimpLoader] Loading multi-material model: " << filePath << std::endl;
+
+    const uint64_t cacheKey = MeshCache::GetInstance().HashSource(filePath, MeshCache::SourceKind::AssimpMulti,
+                                                                  (options.optimizeMeshes ? 4u : 0u) |
+                                                                  (options.staticMerge ? 8u : 0u));
+    if (MeshCache::GetInstance().Read(cacheKey, outModel)) {
+        std::cout << "[AssimpLoader] Loaded " << outModel.subMeshes.size() << " sub-meshes from mesh cache" << std::endl;
+        return !outModel.subMeshes.empty();
+    }
     
     Assimp::Importer importer;
     
@@ -655,7 +686,17 @@ bool AssimpLoader::LoadMultiMaterialModel(const std::string& filePath, MultiMate
     std::vector<Vertex> collisionVertices;
     std::vector<uint32_t> collisionIndices;
     
-    ProcessNodeMultiMaterial(scene->mRootNode, scene, materialMeshes, collisionVertices, collisionIndices);
+    if (options.staticMerge) {
+        // 静态合并：节点变换烘焙到模型空间，相同材质的网格拼接为一个子网格
+        const std::vector<int> remap = BuildMaterialMergeRemap(scene, modelDir);
+        const aiMatrix4x4 identity;
+        ProcessNodeMultiMaterial(scene->mRootNode, scene, materialMeshes, collisionVertices, collisionIndices,
+                                 &remap, &identity);
+        std::cout << "[AssimpLoader] Static merge: " << scene->mNumMaterials << " materials -> "
+                  << materialMeshes.size() << " sub-meshes" << std::endl;
+    } else {
+        ProcessNodeMultiMaterial(scene->mRootNode, scene, materialMeshes, collisionVertices, collisionIndices);
+    }
     
     // Apply rotation to vertices if needed
     if (needsFBXRotation) {
@@ -770,6 +811,10 @@ bool AssimpLoader::LoadMultiMaterialModel(const std::string& filePath, MultiMate
         subMesh.mesh = std::make_shared<Mesh>();
         subMesh.mesh->SetVertices(vertices);
         subMesh.mesh->SetIndices(indices);
+        subMesh.mesh->SetVertexFormat(Mesh::SelectVertexFormat(vertices));
+        if (options.optimizeMeshes) {
+            MeshOptimizer::Optimize(*subMesh.mesh);
+        }
         
         // Get material name and textures
         if (materialIndex >= 0 && materialIndex < static_cast<int>(scene->mNumMaterials)) {
@@ -849,7 +894,10 @@ bool AssimpLoader::LoadMultiMaterialModel(const std::string& filePath, MultiMate
     }
     
     std::cout << "[AssimpLoader] Loaded " << outModel.subMeshes.size() << " sub-meshes" << std::endl;
-    
+
+    if (!outModel.subMeshes.empty()) {
+        MeshCache::GetInstance().Write(cacheKey, outModel);
+    }
     return !outModel.subMeshes.empty();
 }
 
@@ -857,8 +905,43 @@ void AssimpLoader::ProcessNodeMultiMaterial(
     aiNode* node, const aiScene* scene,
     std::map<int, std::pair<std::vector<Vertex>, std::vector<uint32_t>>>& materialMeshes,
     std::vector<Vertex>& collisionVertices,
-    std::vector<uint32_t>& collisionIndices
+    std::vector<uint32_t>& collisionIndices,
+    const std::vector<int>* materialRemap,
+    const aiMatrix4x4* parentTransform
 ) {
+    // 节点的模型空间变换（仅静态合并时累积）。根节点自身的变换不烘焙：
+    // 全局坐标轴修正仍由下面的 FBX / GLB 旋转负责，避免重复旋转
+    aiMatrix4x4 nodeTransform;
+    aiMatrix3x3 normalTransform;
+    if (parentTransform) {
+        nodeTransform = node == scene->mRootNode ? *parentTransform : (*parentTransform) * node->mTransformation;
+        normalTransform = aiMatrix3x3(nodeTransform);
+        normalTransform.Inverse().Transpose();
+    }
+    
+    // 将 ProcessMesh 追加的顶点变换到模型空间；镜像变换（行列式为负）同时翻转追加三角形的绕序，
+    // 否则合并后的子网格整体被背面剔除
+    const bool mirrored = parentTransform && nodeTransform.Determinant() < 0.0f;
+    auto bakeTransform = [&](std::vector<Vertex>& vertices, size_t firstVertex,
+                             std::vector<uint32_t>& indices, size_t firstIndex) {
+        if (!parentTransform || nodeTransform.IsIdentity()) return;
+        if (mirrored) {
+            for (size_t t = firstIndex; t + 2 < indices.size(); t += 3) {
+                std::swap(indices[t + 1], indices[t + 2]);
+            }
+        }
+        const aiMatrix3x3 tangentTransform(nodeTransform);
+        for (size_t v = firstVertex; v < vertices.size(); v++) {
+            Vertex& vertex = vertices[v];
+            aiVector3D position = nodeTransform * aiVector3D(vertex.position.x, vertex.position.y, vertex.position.z);
+            aiVector3D normal = (normalTransform * aiVector3D(vertex.normal.x, vertex.normal.y, vertex.normal.z)).NormalizeSafe();
+            aiVector3D tangent = (tangentTransform * aiVector3D(vertex.tangent.x, vertex.tangent.y, vertex.tangent.z)).NormalizeSafe();
+            vertex.position = { position.x, position.y, position.z };
+            vertex.normal = { normal.x, normal.y, normal.z };
+            vertex.tangent = { tangent.x, tangent.y, tangent.z };
+        }
+    };
+    
     for (uint32_t i = 0; i < node->mNumMeshes; i++) {
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
         
@@ -867,18 +950,69 @@ void AssimpLoader::ProcessNodeMultiMaterial(
         
         if (meshName.find("collision") != std::string::npos || 
             meshName.find("collider") != std::string::npos) {
+            const size_t firstVertex = collisionVertices.size();
+            const size_t firstIndex = collisionIndices.size();
             ProcessMesh(mesh, scene, collisionVertices, collisionIndices);
+            bakeTransform(collisionVertices, firstVertex, collisionIndices, firstIndex);
         } else {
-            // Group by material index
+            // Group by material index（静态合并时按等价材质分组）
             int matIndex = mesh->mMaterialIndex;
+            if (materialRemap && matIndex >= 0 && matIndex < static_cast<int>(materialRemap->size())) {
+                matIndex = (*materialRemap)[matIndex];
+            }
             auto& [vertices, indices] = materialMeshes[matIndex];
+            const size_t firstVertex = vertices.size();
+            const size_t firstIndex = indices.size();
             ProcessMesh(mesh, scene, vertices, indices);
+            bakeTransform(vertices, firstVertex, indices, firstIndex);
         }
     }
     
     for (uint32_t i = 0; i < node->mNumChildren; i++) {
-        ProcessNodeMultiMaterial(node->mChildren[i], scene, materialMeshes, collisionVertices, collisionIndices);
+        ProcessNodeMultiMaterial(node->mChildren[i], scene, materialMeshes, collisionVertices, collisionIndices,
+                                 materialRemap, parentTransform ? &nodeTransform : nullptr);
+    }
+}
+
+std::vector<int> AssimpLoader::BuildMaterialMergeRemap(const aiScene* scene, const std::string& modelDir) {
+    // 材质签名：全部贴图引用（外部路径或 *N 内嵌索引）+ 颜色 / PBR 系数；名称不参与比较
+    auto makeSignature = [&](aiMaterial* material) {
+        std::string signature;
+        for (const auto& path : ExtractMaterialTexturePaths(material, modelDir)) {
+            signature += path;
+            signature += '|';
+        }
+        auto appendColor = [&](const char* key, unsigned int type, unsigned int index) {
+            aiColor4D color(1.0f, 1.0f, 1.0f, 1.0f);
+            if (material->Get(key, type, index, color) == AI_SUCCESS) {
+                signature += std::to_string(color.r) + "," + std::to_string(color.g) + "," +
+                             std::to_string(color.b) + "," + std::to_string(color.a);
+            }
+            signature += '|';
+        };
+        auto appendFloat = [&](const char* key, unsigned int type, unsigned int index) {
+            float value = 0.0f;
+            if (material->Get(key, type, index, value) == AI_SUCCESS) {
+                signature += std::to_string(value);
+            }
+            signature += '|';
+        };
+        appendColor(AI_MATKEY_COLOR_DIFFUSE);
+        appendColor(AI_MATKEY_BASE_COLOR);
+        appendColor(AI_MATKEY_COLOR_EMISSIVE);
+        appendFloat(AI_MATKEY_METALLIC_FACTOR);
+        appendFloat(AI_MATKEY_ROUGHNESS_FACTOR);
+        appendFloat(AI_MATKEY_OPACITY);
+        return signature;
+    };
+    
+    std::vector<int> remap(scene->mNumMaterials);
+    std::map<std::string, int> firstBySignature;
+    for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
+        auto [it, inserted] = firstBySignature.emplace(makeSignature(scene->mMaterials[i]), static_cast<int>(i));
+        remap[i] = it->second;
     }
+    return remap;
 }
 
 std::vector<std::string> AssimpLoader::ExtractMaterialTexturePaths(aiMaterial* material, const std::string& modelDir) {
@@ -1,6 +1,7 @@
 #pragma once
 #include "Mesh.h"
 #include "Material.h"
+#include "TextureCooker.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -108,6 +109,9 @@ struct ModelLoadOptions {
     bool skipBoundsCalculation = false;  // Skip bounding box calculation (for known-scale models)
     bool verbose = true;                  // Print loading messages
     bool fastLoad = false;                // Use fast loading (skip tangent/normal generation)
+    bool optimizeMeshes = true;           // Vertex cache / overdraw / vertex fetch optimization + 16-bit indices
+    bool staticMerge = false;             // Multi-material only: bake node transforms into model space and
+                                          // concatenate submeshes whose materials are identical (one mesh per material)
 };
 
 class AssimpLoader {
@@ -127,21 +131,25 @@ public:
      * Each material gets its own sub-mesh for proper texture mapping
      * @param filePath Path to model file
      * @param outModel Output multi-material model data
+     * @param options Loading options (optional, only optimizeMeshes is used)
      * @return true if successful
      */
-    static bool LoadMultiMaterialModel(const std::string& filePath, MultiMaterialModel& outModel);
+    static bool LoadMultiMaterialModel(const std::string& filePath, MultiMaterialModel& outModel,
+                                       const ModelLoadOptions& options = {});
 
     /**
      * @brief Create GPU texture from embedded texture data
      * @param device D3D11 device
      * @param embeddedTex Embedded texture data
      * @param outTexture Output shader resource view
+     * @param usage Texture role, selects the cooked BC format
      * @return true if successful
      */
     static bool CreateTextureFromEmbedded(
         ID3D11Device* device,
         const EmbeddedTexture& embeddedTex,
-        ID3D11ShaderResourceView** outTexture
+        ID3D11ShaderResourceView** outTexture,
+        TextureUsage usage = TextureUsage::Color
     );
 
 private:
@@ -158,11 +166,20 @@ private:
     /**
      * @brief Process node for multi-material model
      * Groups meshes by material index
+     * @param materialRemap Optional: material index → group index (static merge: identical materials share a group)
+     * @param parentTransform Optional: accumulated parent node transform; when set, vertices are baked into model space
      */
     static void ProcessNodeMultiMaterial(aiNode* node, const aiScene* scene,
                                          std::map<int, std::pair<std::vector<Vertex>, std::vector<uint32_t>>>& materialMeshes,
                                          std::vector<Vertex>& collisionVertices,
-                                         std::vector<uint32_t>& collisionIndices);
+                                         std::vector<uint32_t>& collisionIndices,
+                                         const std::vector<int>* materialRemap = nullptr,
+                                         const aiMatrix4x4* parentTransform = nullptr);
+    
+    /**
+     * @brief Static merge: map each material to the first material with the same texture references and factors
+     */
+    static std::vector<int> BuildMaterialMergeRemap(const aiScene* scene, const std::string& modelDir);
     
     /**
      * @brief Extract texture paths for a specific material
@@ -0,0 +1,97 @@
+#pragma once
+#include <dxgiformat.h>
+#include <cstdint>
+
+namespace outer_wilds {
+namespace resources {
+
+/**
+ * DDS 文件格式定义（TextureLoader 读取、TextureCooker 写出共用）
+ * 只覆盖本项目用到的子集：2D 纹理、可含 mip 链、legacy FourCC 或 DX10 扩展头
+ */
+namespace dds {
+
+constexpr uint32_t kDDSMagic = 0x20534444;  // "DDS "
+constexpr uint32_t kDDSFourCC = 0x00000004;
+constexpr uint32_t kDDSRGB = 0x00000040;
+constexpr uint32_t kDDSCubemap = 0x00000200;
+
+inline constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+}
+
+#pragma pack(push, 1)
+struct DDSPixelFormat {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t rBitMask;
+    uint32_t gBitMask;
+    uint32_t bBitMask;
+    uint32_t aBitMask;
+};
+
+struct DDSHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DDSPixelFormat ddspf;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+
+struct DDSHeaderDX10 {
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(DDSHeader) == 124, "DDS header must be 124 bytes");
+static_assert(sizeof(DDSHeaderDX10) == 20, "DDS DX10 header must be 20 bytes");
+
+inline DXGI_FORMAT FormatFromPixelFormat(const DDSPixelFormat& pf) {
+    if (pf.flags & kDDSFourCC) {
+        if (pf.fourCC == MakeFourCC('D', 'X', 'T', '1')) return DXGI_FORMAT_BC1_UNORM;
+        if (pf.fourCC == MakeFourCC('D', 'X', 'T', '3')) return DXGI_FORMAT_BC2_UNORM;
+        if (pf.fourCC == MakeFourCC('D', 'X', 'T', '5')) return DXGI_FORMAT_BC3_UNORM;
+        if (pf.fourCC == MakeFourCC('A', 'T', 'I', '1') || pf.fourCC == MakeFourCC('B', 'C', '4', 'U')) return DXGI_FORMAT_BC4_UNORM;
+        if (pf.fourCC == MakeFourCC('A', 'T', 'I', '2') || pf.fourCC == MakeFourCC('B', 'C', '5', 'U')) return DXGI_FORMAT_BC5_UNORM;
+        return DXGI_FORMAT_UNKNOWN;
+    }
+    if ((pf.flags & kDDSRGB) && pf.rgbBitCount == 32) {
+        if (pf.rBitMask == 0x000000FF && pf.gBitMask == 0x0000FF00 && pf.bBitMask == 0x00FF0000) return DXGI_FORMAT_R8G8B8A8_UNORM;
+        if (pf.rBitMask == 0x00FF0000 && pf.gBitMask == 0x0000FF00 && pf.bBitMask == 0x000000FF) return DXGI_FORMAT_B8G8R8A8_UNORM;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+
+constexpr uint32_t kDDSDX10FourCC = MakeFourCC('D', 'X', '1', '0');
+
+// DDSHeader.flags / caps
+constexpr uint32_t kDDSHeaderFlagsTexture = 0x00001007;  // CAPS | HEIGHT | WIDTH | PIXELFORMAT
+constexpr uint32_t kDDSHeaderFlagsMipmap = 0x00020000;
+constexpr uint32_t kDDSHeaderFlagsLinearSize = 0x00080000;
+constexpr uint32_t kDDSCapsTexture = 0x00001000;
+constexpr uint32_t kDDSCapsComplexMipmap = 0x00400008;  // COMPLEX | MIPMAP
+constexpr uint32_t kDDSDimensionTexture2D = 3;
+
+} // namespace dds
+
+} // namespace resources
+} // namespace outer_wilds
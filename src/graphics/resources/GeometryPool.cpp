@@ -0,0 +1,233 @@
+#include "GeometryPool.h"
+#include "core/DebugManager.h"
+#include "graphics/GpuMemory.h"
+#include <iterator>
+#include <string>
+
+namespace outer_wilds {
+namespace resources {
+
+namespace {
+
+// 单页容量：超过的 Mesh 使用独立缓冲
+constexpr uint32_t kVertexPageBytes = 32u * 1024u * 1024u;
+constexpr uint32_t kIndexPageBytes = 16u * 1024u * 1024u;
+
+} // namespace
+
+GeometryRange GeometryPool::AllocateVertices(ID3D11Device* device, uint32_t stride, const void* data,
+                                             uint32_t count, ID3D11Buffer** outBuffer) {
+    return Allocate(device, D3D11_BIND_VERTEX_BUFFER, stride, DXGI_FORMAT_UNKNOWN, data, count, outBuffer);
+}
+
+GeometryRange GeometryPool::AllocateIndices(ID3D11Device* device, DXGI_FORMAT format, const void* data,
+                                            uint32_t count, ID3D11Buffer** outBuffer) {
+    const uint32_t elementSize = format == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(uint32_t);
+    return Allocate(device, D3D11_BIND_INDEX_BUFFER, elementSize, format, data, count, outBuffer);
+}
+
+uint16_t GeometryPool::FindOrCreateArenaLocked(UINT bindFlags, uint32_t elementSize, DXGI_FORMAT indexFormat) {
+    for (size_t i = 0; i < m_Arenas.size(); i++) {
+        const Arena& arena = m_Arenas[i];
+        if (arena.bindFlags == bindFlags && arena.elementSize == elementSize && arena.indexFormat == indexFormat) {
+            return static_cast<uint16_t>(i);
+        }
+    }
+    Arena arena;
+    arena.bindFlags = bindFlags;
+    arena.elementSize = elementSize;
+    arena.indexFormat = indexFormat;
+    m_Arenas.push_back(std::move(arena));
+    return static_cast<uint16_t>(m_Arenas.size() - 1);
+}
+
+bool GeometryPool::TakeBlock(Page& page, uint32_t count, uint32_t& outOffset) {
+    // 首次适配：偏移最小的足够大的空闲块，剩余部分留在原位
+    for (auto it = page.freeBlocks.begin(); it != page.freeBlocks.end(); ++it) {
+        if (it->second < count) continue;
+        outOffset = it->first;
+        const uint32_t remaining = it->second - count;
+        page.freeBlocks.erase(it);
+        if (remaining > 0) {
+            page.freeBlocks.emplace(outOffset + count, remaining);
+        }
+        page.used += count;
+        return true;
+    }
+    return false;
+}
+
+GeometryRange GeometryPool::Allocate(ID3D11Device* device, UINT bindFlags, uint32_t elementSize,
+                                     DXGI_FORMAT indexFormat, const void* data, uint32_t count,
+                                     ID3D11Buffer** outBuffer) {
+    GeometryRange range;
+    *outBuffer = nullptr;
+    if (!device || !data || count == 0 || elementSize == 0) {
+        return range;
+    }
+
+    const uint32_t pageBytes = bindFlags == D3D11_BIND_VERTEX_BUFFER ? kVertexPageBytes : kIndexPageBytes;
+    const uint32_t pageCapacity = pageBytes / elementSize;
+    if (count > pageCapacity) {
+        return range;
+    }
+
+    // 上传源：STAGING 缓冲带初始数据（在调用线程创建，不持锁）
+    D3D11_BUFFER_DESC stagingDesc = {};
+    stagingDesc.ByteWidth = count * elementSize;
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    D3D11_SUBRESOURCE_DATA stagingData = {};
+    stagingData.pSysMem = data;
+    ID3D11Buffer* staging = nullptr;
+    HRESULT hr = device->CreateBuffer(&stagingDesc, &stagingData, &staging);
+    if (FAILED(hr)) {
+        DebugManager::GetInstance().Log("GeometryPool", "Failed to create staging buffer, HRESULT: " + std::to_string(hr));
+        return range;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Enabled) {
+        staging->Release();
+        return range;
+    }
+
+    const uint16_t arenaIndex = FindOrCreateArenaLocked(bindFlags, elementSize, indexFormat);
+    Arena& arena = m_Arenas[arenaIndex];
+
+    uint32_t offset = 0;
+    size_t pageIndex = 0;
+    for (; pageIndex < arena.pages.size(); pageIndex++) {
+        if (TakeBlock(arena.pages[pageIndex], count, offset)) break;
+    }
+    if (pageIndex == arena.pages.size()) {
+        // 所有页都放不下：新建一页
+        D3D11_BUFFER_DESC pageDesc = {};
+        pageDesc.ByteWidth = pageCapacity * elementSize;
+        pageDesc.Usage = D3D11_USAGE_DEFAULT;
+        pageDesc.BindFlags = bindFlags;
+        ID3D11Buffer* buffer = nullptr;
+        hr = device->CreateBuffer(&pageDesc, nullptr, &buffer);
+        if (FAILED(hr)) {
+            DebugManager::GetInstance().Log("GeometryPool", "Failed to create pool page, HRESULT: " + std::to_string(hr));
+            staging->Release();
+            return range;
+        }
+        GpuMemory::Track(buffer);
+
+        Page page;
+        page.buffer = buffer;
+        page.capacity = pageCapacity;
+        page.freeBlocks.emplace(0u, pageCapacity);
+        arena.pages.push_back(std::move(page));
+        TakeBlock(arena.pages.back(), count, offset);
+
+        DebugManager::GetInstance().Log("GeometryPool", std::string(bindFlags == D3D11_BIND_VERTEX_BUFFER ? "Vertex" : "Index") +
+            " page " + std::to_string(pageIndex) + " created (element " + std::to_string(elementSize) +
+            " bytes, " + std::to_string(pageDesc.ByteWidth / (1024 * 1024)) + " MB)");
+    }
+
+    Page& page = arena.pages[pageIndex];
+    m_PendingUploads.push_back({ staging, page.buffer, offset * elementSize });
+
+    range.arena = arenaIndex;
+    range.page = static_cast<uint16_t>(pageIndex);
+    range.offset = offset;
+    range.count = count;
+    *outBuffer = page.buffer;
+    return range;
+}
+
+void GeometryPool::Free(const GeometryRange& range) {
+    if (!range.IsValid()) return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (range.arena >= m_Arenas.size() || range.page >= m_Arenas[range.arena].pages.size()) {
+        return;  // Shutdown 之后
+    }
+    Page& page = m_Arenas[range.arena].pages[range.page];
+
+    uint32_t offset = range.offset;
+    uint32_t length = range.count;
+    // 与后一个空闲块合并
+    auto next = page.freeBlocks.lower_bound(offset);
+    if (next != page.freeBlocks.end() && next->first == offset + length) {
+        length += next->second;
+        next = page.freeBlocks.erase(next);
+    }
+    // 与前一个空闲块合并
+    if (next != page.freeBlocks.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            length += prev->second;
+            page.freeBlocks.erase(prev);
+        }
+    }
+    page.freeBlocks.emplace(offset, length);
+    page.used -= range.count;
+}
+
+uint32_t GeometryPool::FlushUploads(ID3D11DeviceContext* context) {
+    std::vector<PendingUpload> uploads;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_PendingUploads.empty()) return 0;
+        uploads.swap(m_PendingUploads);
+    }
+
+    for (const PendingUpload& upload : uploads) {
+        if (context) {
+            context->CopySubresourceRegion(upload.destination, 0, upload.destinationOffset, 0, 0,
+                                           upload.staging, 0, nullptr);
+        }
+        upload.staging->Release();
+    }
+    return static_cast<uint32_t>(uploads.size());
+}
+
+void GeometryPool::SetEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Enabled = enabled;
+}
+
+bool GeometryPool::IsEnabled() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Enabled;
+}
+
+GeometryPool::Stats GeometryPool::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats stats;
+    for (const Arena& arena : m_Arenas) {
+        const uint32_t pages = static_cast<uint32_t>(arena.pages.size());
+        if (arena.bindFlags == D3D11_BIND_VERTEX_BUFFER) {
+            stats.vertexPages += pages;
+        } else {
+            stats.indexPages += pages;
+        }
+        for (const Page& page : arena.pages) {
+            stats.reservedBytes += static_cast<uint64_t>(page.capacity) * arena.elementSize;
+            stats.allocatedBytes += static_cast<uint64_t>(page.used) * arena.elementSize;
+        }
+    }
+    stats.pendingUploads = static_cast<uint32_t>(m_PendingUploads.size());
+    return stats;
+}
+
+void GeometryPool::Shutdown() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const PendingUpload& upload : m_PendingUploads) {
+        upload.staging->Release();
+    }
+    m_PendingUploads.clear();
+    for (Arena& arena : m_Arenas) {
+        for (Page& page : arena.pages) {
+            if (page.buffer) page.buffer->Release();
+        }
+    }
+    m_Arenas.clear();
+}
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,123 @@
+/**
+ * GeometryPool.h
+ *
+ * 共享的 GPU 几何缓冲：每种顶点步长 / 索引格式一组大 VB / IB（页），Mesh 从中子分配连续区间
+ *
+ * - 每页一个空闲链表（按偏移有序，释放时与相邻空闲块合并），首次适配分配；页满时新建一页
+ * - Mesh 记录 baseVertex / startIndex，绘制使用 DrawIndexed(count, startIndex, baseVertex)；
+ *   同一页内的 Mesh 共用 VB / IB，RenderQueue 只在页变化时重新绑定
+ * - 超过单页容量的 Mesh 仍使用独立缓冲
+ *
+ * 线程：Allocate 可在加载线程调用（ID3D11Device 的创建方法线程安全）。数据先写入 STAGING 缓冲，
+ * 复制命令排队，主线程在提交任何绘制之前调用 FlushUploads（RenderSystem::Update 开头）执行。
+ */
+
+#pragma once
+#include <d3d11.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+
+/**
+ * @brief 池中的一段区间（以元素计：顶点或索引）
+ */
+struct GeometryRange {
+    static constexpr uint16_t kInvalidArena = 0xFFFF;
+
+    uint16_t arena = kInvalidArena;     // GeometryPool 内部的缓冲组
+    uint16_t page = 0;
+    uint32_t offset = 0;                // 元素偏移（baseVertex / startIndex）
+    uint32_t count = 0;
+
+    bool IsValid() const { return arena != kInvalidArena; }
+};
+
+class GeometryPool {
+public:
+    struct Stats {
+        uint32_t vertexPages = 0;
+        uint32_t indexPages = 0;
+        uint64_t reservedBytes = 0;     // 全部页的容量
+        uint64_t allocatedBytes = 0;    // 已分配给 Mesh 的字节数
+        uint32_t pendingUploads = 0;    // 等待 FlushUploads 的复制
+    };
+
+    static GeometryPool& GetInstance() {
+        static GeometryPool instance;
+        return instance;
+    }
+
+    /**
+     * @brief 分配顶点区间并排队上传 data（count * stride 字节）
+     * @param outBuffer 区间所在页的缓冲（不增加引用计数，Free 之前有效）
+     * @return 池已关闭或超过单页容量时返回无效区间，由调用方创建独立缓冲
+     */
+    GeometryRange AllocateVertices(ID3D11Device* device, uint32_t stride, const void* data, uint32_t count,
+                                   ID3D11Buffer** outBuffer);
+
+    /** @brief 分配索引区间（format 为 R16_UINT / R32_UINT） */
+    GeometryRange AllocateIndices(ID3D11Device* device, DXGI_FORMAT format, const void* data, uint32_t count,
+                                  ID3D11Buffer** outBuffer);
+
+    /** @brief 归还区间（无效区间忽略） */
+    void Free(const GeometryRange& range);
+
+    /**
+     * @brief 执行排队的复制（主线程，提交绘制之前）
+     * @return 执行的复制数
+     */
+    uint32_t FlushUploads(ID3D11DeviceContext* context);
+
+    /** @brief 关闭后新的 Mesh 使用独立缓冲（已有分配不受影响） */
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const;
+
+    Stats GetStats() const;
+
+    /** @brief 释放全部页和未执行的上传（设备销毁前，所有 Mesh 释放之后调用） */
+    void Shutdown();
+
+private:
+    GeometryPool() = default;
+    ~GeometryPool() { Shutdown(); }
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    struct Page {
+        ID3D11Buffer* buffer = nullptr;
+        uint32_t capacity = 0;                      // 元素数
+        uint32_t used = 0;
+        std::map<uint32_t, uint32_t> freeBlocks;    // 偏移 → 长度（按偏移有序，便于合并）
+    };
+
+    // 一种顶点步长或索引格式对应一组页
+    struct Arena {
+        UINT bindFlags = 0;
+        uint32_t elementSize = 0;
+        DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN;  // 顶点组为 UNKNOWN
+        std::vector<Page> pages;
+    };
+
+    struct PendingUpload {
+        ID3D11Buffer* staging = nullptr;            // 持有引用，复制后释放
+        ID3D11Buffer* destination = nullptr;
+        UINT destinationOffset = 0;                 // 字节
+    };
+
+    GeometryRange Allocate(ID3D11Device* device, UINT bindFlags, uint32_t elementSize, DXGI_FORMAT indexFormat,
+                           const void* data, uint32_t count, ID3D11Buffer** outBuffer);
+    uint16_t FindOrCreateArenaLocked(UINT bindFlags, uint32_t elementSize, DXGI_FORMAT indexFormat);
+    static bool TakeBlock(Page& page, uint32_t count, uint32_t& outOffset);
+
+    mutable std::mutex m_Mutex;
+    std::vector<Arena> m_Arenas;
+    std::vector<PendingUpload> m_PendingUploads;
+    bool m_Enabled = true;
+};
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,41 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "MappedFile.h"
+#include <windows.h>
+
+namespace outer_wilds {
+namespace resources {
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return nullptr;
+
+    // 视图持有映射对象的引用，句柄可以立即关闭
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) return nullptr;
+
+    auto mapped = std::shared_ptr<MappedFile>(new MappedFile());
+    mapped->m_View = static_cast<const uint8_t*>(view);
+    mapped->m_Size = static_cast<size_t>(size.QuadPart);
+    return mapped;
+}
+
+MappedFile::~MappedFile() {
+    if (m_View) UnmapViewOfFile(m_View);
+}
+
+} // namespace resources
+} // namespace outer_wilds
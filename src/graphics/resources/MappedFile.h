@@ -0,0 +1,39 @@
+/**
+ * MappedFile.h
+ *
+ * 只读内存映射文件（MapViewOfFile）：MeshCache 读取缓存条目、OBJLoader 解析源文件共用
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace outer_wilds {
+namespace resources {
+
+/**
+ * @brief 只读内存映射文件（视图存活期间文件内容有效）
+ */
+class MappedFile {
+public:
+    /** @brief 打开并映射整个文件；文件不存在或为空时返回 nullptr */
+    static std::shared_ptr<const MappedFile> Open(const std::string& path);
+
+    ~MappedFile();
+
+    const uint8_t* Data() const { return m_View; }
+    size_t Size() const { return m_Size; }
+
+private:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* m_View = nullptr;
+    size_t m_Size = 0;
+};
+
+} // namespace resources
+} // namespace outer_wilds
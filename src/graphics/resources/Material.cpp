@@ -0,0 +1,93 @@
+#include "Material.h"
+#include <d3d11.h>
+#include <cstring>
+#include "core/DebugManager.h"
+#include "graphics/GpuMemory.h"
+#include "TextureArrayAtlas.h"
+
+namespace outer_wilds {
+namespace resources {
+
+Material::~Material() {
+    if (packedIntoArrays) {
+        TextureArrayAtlas::GetInstance().Unpack(*this);
+    }
+    if (constantBuffer) {
+        static_cast<ID3D11Buffer*>(constantBuffer)->Release();
+        constantBuffer = nullptr;
+    }
+}
+
+MaterialConstants Material::BuildConstants() const {
+    MaterialConstants constants;
+    if (isEmissive) {
+        constants.emissiveColor = emissiveColor;
+        constants.emissiveStrength = emissiveStrength;
+        constants.hasEmissiveTexture = emissiveTextureSRV ? 1.0f : 0.0f;
+    }
+    if (packedIntoArrays) {
+        constants.textureSlices = DirectX::XMFLOAT4(static_cast<float>(textureArraySlice[kMaterialAlbedo]),
+                                                    static_cast<float>(textureArraySlice[kMaterialNormal]),
+                                                    static_cast<float>(textureArraySlice[kMaterialMetallic]),
+                                                    static_cast<float>(textureArraySlice[kMaterialRoughness]));
+        constants.emissiveSlice = static_cast<float>(textureArraySlice[kMaterialEmissive]);
+    }
+    return constants;
+}
+
+bool Material::CreateGPUBuffer(ID3D11Device* device) {
+    if (constantBuffer) {
+        return true;
+    }
+    if (!device) {
+        DebugManager::GetInstance().Log("Material", "CreateGPUBuffer failed: device null");
+        return false;
+    }
+
+    m_UploadedConstants = BuildConstants();
+
+    // DEFAULT + UpdateSubresource：参数几乎不变，不需要每帧 Map
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = sizeof(MaterialConstants);
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    desc.CPUAccessFlags = 0;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem = &m_UploadedConstants;
+
+    ID3D11Buffer* buffer = nullptr;
+    HRESULT hr = device->CreateBuffer(&desc, &initData, &buffer);
+    GpuMemory::Track(buffer);
+    if (FAILED(hr)) {
+        DebugManager::GetInstance().Log("Material", "Failed to create material constant buffer, HRESULT: " + std::to_string(hr));
+        return false;
+    }
+    constantBuffer = buffer;
+    return true;
+}
+
+bool Material::UpdateGPUBuffer(ID3D11DeviceContext* context) {
+    if (!context) {
+        return constantBuffer != nullptr;
+    }
+
+    if (!constantBuffer) {
+        // 程序化创建的材质（没有经过 SceneAssetLoader）
+        ID3D11Device* device = nullptr;
+        context->GetDevice(&device);
+        bool created = CreateGPUBuffer(device);
+        if (device) device->Release();
+        return created;
+    }
+
+    MaterialConstants current = BuildConstants();
+    if (std::memcmp(&current, &m_UploadedConstants, sizeof(MaterialConstants)) != 0) {
+        context->UpdateSubresource(static_cast<ID3D11Buffer*>(constantBuffer), 0, nullptr, &current, 0, 0);
+        m_UploadedConstants = current;
+    }
+    return true;
+}
+
+} // namespace resources
+} // namespace outer_wilds
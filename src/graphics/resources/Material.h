@@ -1,14 +1,47 @@
 #pragma once
 #include <DirectXMath.h>
+#include <cstdint>
 #include <string>
 
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+
 namespace outer_wilds {
 namespace resources {
 
+/**
+ * @brief MaterialBuffer (b2) 的 GPU 布局，必须与 HLSL 完全匹配（48 字节）
+ */
+struct MaterialConstants {
+    DirectX::XMFLOAT3 emissiveColor = { 0.0f, 0.0f, 0.0f };
+    float emissiveStrength = 0.0f;
+    float hasEmissiveTexture = 0.0f;
+    float emissiveSlice = 0.0f;                                 // Texture2DArray 层下标（HAS_TEXTURE_ARRAY）
+    float padding[2] = { 0.0f, 0.0f };
+    DirectX::XMFLOAT4 textureSlices = { 0.0f, 0.0f, 0.0f, 0.0f };  // albedo / normal / metallic / roughness 层下标
+};
+static_assert(sizeof(MaterialConstants) == 48, "MaterialConstants must be 48 bytes");
+
+/**
+ * @brief 材质贴图槽位（与 textured.hlsl 的 t0-t4 一致）
+ */
+enum MaterialTextureSlot : uint32_t {
+    kMaterialAlbedo = 0,
+    kMaterialNormal,
+    kMaterialMetallic,
+    kMaterialRoughness,
+    kMaterialEmissive,
+    kMaterialTextureSlotCount,
+};
+
 class Material {
 public:
     Material() = default;
-    ~Material() = default;
+    ~Material();
+    
+    // 持有 GPU 常量缓冲区，禁止拷贝（避免重复 Release）
+    Material(const Material&) = delete;
+    Material& operator=(const Material&) = delete;
 
     DirectX::XMFLOAT4 albedo = { 1.0f, 1.0f, 1.0f, 1.0f };
     DirectX::XMFLOAT3 emissiveColor = { 0.0f, 0.0f, 0.0f };  // Emissive/自发光颜色
@@ -33,8 +66,36 @@ public:
     void* roughnessTextureSRV = nullptr;   // ID3D11ShaderResourceView* for roughness map
     void* emissiveTextureSRV = nullptr;    // ID3D11ShaderResourceView* for emissive map
     
+    // Texture2DArray 打包（TextureArrayAtlas::Pack 填写，按 MaterialTextureSlot 排列；视图归图集所有）
+    // 上面的独立 SRV 保持不变，供冒名顶替者调色板、GPU 实例化和热重载使用
+    void* textureArraySRV[kMaterialTextureSlotCount] = {};
+    uint32_t textureArraySlice[kMaterialTextureSlotCount] = {};
+    bool packedIntoArrays = false;
+
     // Deprecated: Use specific texture SRVs above instead
     void* shaderProgram = nullptr;  // Kept for backward compatibility
+    
+    // GPU MaterialBuffer (ID3D11Buffer*, DEFAULT usage)：材质自己持有，切换材质时才重新绑定
+    void* constantBuffer = nullptr;
+    
+    /**
+     * @brief 由当前参数生成 MaterialBuffer 内容（非发光材质的自发光参数为 0，打包的材质带图集层下标）
+     */
+    MaterialConstants BuildConstants() const;
+    
+    /**
+     * @brief 创建常量缓冲区并写入当前参数（材质构建完成时调用）
+     */
+    bool CreateGPUBuffer(ID3D11Device* device);
+    
+    /**
+     * @brief 参数在创建后被修改时重新上传（未创建时按 context 的设备懒创建）
+     * @return 缓冲区可用
+     */
+    bool UpdateGPUBuffer(ID3D11DeviceContext* context);
+
+private:
+    MaterialConstants m_UploadedConstants;  // 上次上传到 GPU 的内容
 };
 
 } // namespace resources
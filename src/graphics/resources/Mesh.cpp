@@ -1,57 +1,247 @@
 #include "Mesh.h"
 #include <d3d11.h>
 #include "core/DebugManager.h"
+#include "graphics/GpuMemory.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 namespace outer_wilds {
 namespace resources {
 
+namespace {
+
+int16_t PackSnorm16(float value) {
+    value = std::clamp(value, -1.0f, 1.0f);
+    return static_cast<int16_t>(std::lround(value * 32767.0f));
+}
+
+uint16_t PackUnorm16(float value) {
+    value = std::clamp(value, 0.0f, 1.0f);
+    return static_cast<uint16_t>(std::lround(value * 65535.0f));
+}
+
+uint8_t PackUnorm8(float value) {
+    value = std::clamp(value, 0.0f, 1.0f);
+    return static_cast<uint8_t>(std::lround(value * 255.0f));
+}
+
+/**
+ * @brief 单位向量 → 八面体坐标（[-1,1]^2），与 shaders 中 DecodeOctahedral 对应
+ */
+void EncodeOctahedral(const DirectX::XMFLOAT3& v, int16_t out[2]) {
+    float length = std::fabs(v.x) + std::fabs(v.y) + std::fabs(v.z);
+    if (length <= 0.0f) {
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+    float x = v.x / length;
+    float y = v.y / length;
+    if (v.z < 0.0f) {
+        float wrappedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float wrappedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = wrappedX;
+        y = wrappedY;
+    }
+    out[0] = PackSnorm16(x);
+    out[1] = PackSnorm16(y);
+}
+
+} // namespace
+
+VertexFormat Mesh::SelectVertexFormat(const std::vector<Vertex>& vertices) {
+    // 量化误差：UNORM16 UV 约 1.5e-5，八面体 SNORM16 法线 < 0.01°，RGBA8 颜色 1/255
+    constexpr float kEpsilon = 1e-4f;
+    auto inUnitRange = [](float value) { return value >= -kEpsilon && value <= 1.0f + kEpsilon; };
+
+    for (const auto& vertex : vertices) {
+        if (!inUnitRange(vertex.texCoord.x) || !inUnitRange(vertex.texCoord.y)) {
+            return VertexFormat::Standard;  // 平铺 UV 需要完整 float
+        }
+        if (!inUnitRange(vertex.color.x) || !inUnitRange(vertex.color.y) ||
+            !inUnitRange(vertex.color.z) || !inUnitRange(vertex.color.w)) {
+            return VertexFormat::Standard;  // HDR 顶点颜色
+        }
+    }
+    return vertices.empty() ? VertexFormat::Standard : VertexFormat::Compact;
+}
+
+CompactVertex Mesh::PackVertex(const Vertex& vertex) {
+    CompactVertex packed;
+    packed.position = vertex.position;
+    EncodeOctahedral(vertex.normal, packed.normal);
+    packed.texCoord[0] = PackUnorm16(vertex.texCoord.x);
+    packed.texCoord[1] = PackUnorm16(vertex.texCoord.y);
+    EncodeOctahedral(vertex.tangent, packed.tangent);
+    packed.color[0] = PackUnorm8(vertex.color.x);
+    packed.color[1] = PackUnorm8(vertex.color.y);
+    packed.color[2] = PackUnorm8(vertex.color.z);
+    packed.color[3] = PackUnorm8(vertex.color.w);
+    return packed;
+}
+
 void Mesh::CreateGPUBuffers(ID3D11Device* device) {
     if (!device || m_Vertices.empty()) {
         DebugManager::GetInstance().Log("Mesh", "CreateGPUBuffers failed: device null or no vertices");
         return;
     }
 
-    // Create vertex buffer
-    D3D11_BUFFER_DESC vertexBufferDesc = {};
-    vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-    vertexBufferDesc.ByteWidth = static_cast<UINT>(sizeof(Vertex) * m_Vertices.size());
-    vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-    vertexBufferDesc.CPUAccessFlags = 0;
+    // Compact 布局：上传前量化（CPU 侧 m_Vertices 保持完整精度）；MeshCache 命中时数据已打包
+    std::vector<CompactVertex> compactVertices;
+    if (m_VertexFormat == VertexFormat::Compact && !m_PackedVertexData) {
+        compactVertices.reserve(m_Vertices.size());
+        for (const auto& vertex : m_Vertices) {
+            compactVertices.push_back(PackVertex(vertex));
+        }
+    }
 
-    D3D11_SUBRESOURCE_DATA vertexData = {};
-    vertexData.pSysMem = m_Vertices.data();
+    const void* vertexSource = m_PackedVertexData ? m_PackedVertexData
+        : compactVertices.empty() ? static_cast<const void*>(m_Vertices.data())
+                                  : static_cast<const void*>(compactVertices.data());
+    auto& pool = GeometryPool::GetInstance();
+    HRESULT hr = S_OK;
 
+    // Vertex buffer：共享池的一段区间，放不下时创建独立缓冲
     ID3D11Buffer* vb = nullptr;
-    HRESULT hr = device->CreateBuffer(&vertexBufferDesc, &vertexData, &vb);
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("Mesh", "Failed to create vertex buffer, HRESULT: " + std::to_string(hr));
-        return;
+    m_VertexRange = pool.AllocateVertices(device, GetVertexStride(), vertexSource,
+                                          static_cast<uint32_t>(m_Vertices.size()), &vb);
+    if (!m_VertexRange.IsValid()) {
+        D3D11_BUFFER_DESC vertexBufferDesc = {};
+        vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+        vertexBufferDesc.ByteWidth = static_cast<UINT>(GetVertexStride() * m_Vertices.size());
+        vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        vertexBufferDesc.CPUAccessFlags = 0;
+
+        D3D11_SUBRESOURCE_DATA vertexData = {};
+        vertexData.pSysMem = vertexSource;
+
+        hr = device->CreateBuffer(&vertexBufferDesc, &vertexData, &vb);
+        GpuMemory::Track(vb);
+        if (FAILED(hr)) {
+            DebugManager::GetInstance().Log("Mesh", "Failed to create vertex buffer, HRESULT: " + std::to_string(hr));
+            return;
+        }
     }
     this->vertexBuffer = vb;
-    DebugManager::GetInstance().Log("Mesh", "Vertex buffer created successfully with " + std::to_string(m_Vertices.size()) + " vertices");
+    OW_LOG_DEBUG("Mesh", "Vertex buffer created successfully with {} vertices{}{}", m_Vertices.size(),
+                 m_VertexFormat == VertexFormat::Compact ? " (compact)" : "",
+                 m_VertexRange.IsValid() ? " (pooled)" : "");
 
     // Create index buffer if indices exist
     if (!m_Indices.empty()) {
-        D3D11_BUFFER_DESC indexBufferDesc = {};
-        indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-        indexBufferDesc.ByteWidth = static_cast<UINT>(sizeof(uint32_t) * m_Indices.size());
-        indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-        indexBufferDesc.CPUAccessFlags = 0;
+        // 16 位索引（顶点数超出范围时退回 32 位）
+        std::vector<uint16_t> shortIndices;
+        if (m_IndexFormat == DXGI_FORMAT_R16_UINT && !m_PackedIndexData) {
+            if (m_Vertices.size() <= 0xFFFF) {
+                shortIndices.assign(m_Indices.begin(), m_Indices.end());
+            } else {
+                m_IndexFormat = DXGI_FORMAT_R32_UINT;
+            }
+        }
 
-        D3D11_SUBRESOURCE_DATA indexData = {};
-        indexData.pSysMem = m_Indices.data();
+        const void* indexSource = m_PackedIndexData ? m_PackedIndexData
+            : shortIndices.empty() ? static_cast<const void*>(m_Indices.data())
+                                   : static_cast<const void*>(shortIndices.data());
 
+        // 索引区间只和池中的顶点区间搭配（baseVertex 由顶点区间决定）
         ID3D11Buffer* ib = nullptr;
-        hr = device->CreateBuffer(&indexBufferDesc, &indexData, &ib);
-        if (FAILED(hr)) {
-            DebugManager::GetInstance().Log("Mesh", "Failed to create index buffer, HRESULT: " + std::to_string(hr));
-            return;
+        if (m_VertexRange.IsValid()) {
+            m_IndexRange = pool.AllocateIndices(device, m_IndexFormat, indexSource,
+                                                static_cast<uint32_t>(m_Indices.size()), &ib);
+        }
+        if (!m_IndexRange.IsValid()) {
+            D3D11_BUFFER_DESC indexBufferDesc = {};
+            indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+            indexBufferDesc.ByteWidth = m_IndexFormat == DXGI_FORMAT_R16_UINT
+                ? static_cast<UINT>(sizeof(uint16_t) * m_Indices.size())
+                : static_cast<UINT>(sizeof(uint32_t) * m_Indices.size());
+            indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+            indexBufferDesc.CPUAccessFlags = 0;
+
+            D3D11_SUBRESOURCE_DATA indexData = {};
+            indexData.pSysMem = indexSource;
+
+            hr = device->CreateBuffer(&indexBufferDesc, &indexData, &ib);
+            GpuMemory::Track(ib);
+            if (FAILED(hr)) {
+                DebugManager::GetInstance().Log("Mesh", "Failed to create index buffer, HRESULT: " + std::to_string(hr));
+                return;
+            }
         }
         this->indexBuffer = ib;
-        DebugManager::GetInstance().Log("Mesh", "Index buffer created successfully with " + std::to_string(m_Indices.size()) + " indices");
+        OW_LOG_DEBUG("Mesh", "Index buffer created successfully with {} indices", m_Indices.size());
     } else {
         DebugManager::GetInstance().Log("Mesh", "No indices provided, skipping index buffer creation");
     }
+
+    // 已上传，释放映射视图
+    ReleasePackedGPUData();
+}
+
+void Mesh::GetLocalBounds(DirectX::XMFLOAT3& outMin, DirectX::XMFLOAT3& outMax) const {
+    if (m_CPUDataReleased) {
+        outMin = m_ReleasedMin;
+        outMax = m_ReleasedMax;
+        return;
+    }
+    outMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+    outMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (const auto& v : m_Vertices) {
+        outMin.x = std::min(outMin.x, v.position.x);
+        outMin.y = std::min(outMin.y, v.position.y);
+        outMin.z = std::min(outMin.z, v.position.z);
+        outMax.x = std::max(outMax.x, v.position.x);
+        outMax.y = std::max(outMax.y, v.position.y);
+        outMax.z = std::max(outMax.z, v.position.z);
+    }
+}
+
+void Mesh::ReleaseGPUBuffers() {
+    auto& pool = GeometryPool::GetInstance();
+    if (m_VertexRange.IsValid()) {
+        pool.Free(m_VertexRange);
+        m_VertexRange = GeometryRange();
+    } else if (vertexBuffer) {
+        static_cast<ID3D11Buffer*>(vertexBuffer)->Release();
+    }
+    if (m_IndexRange.IsValid()) {
+        pool.Free(m_IndexRange);
+        m_IndexRange = GeometryRange();
+    } else if (indexBuffer) {
+        static_cast<ID3D11Buffer*>(indexBuffer)->Release();
+    }
+    vertexBuffer = nullptr;
+    indexBuffer = nullptr;
+}
+
+bool Mesh::HasVertexColors() const {
+    if (m_CPUDataReleased) {
+        return m_ReleasedHasVertexColors;
+    }
+    // 与旧着色器的判断一致：只看 RGB，alpha 不算
+    for (const auto& v : m_Vertices) {
+        if (v.color.x != 1.0f || v.color.y != 1.0f || v.color.z != 1.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Mesh::ReleaseCPUData() {
+    if (m_CPUDataReleased || !vertexBuffer) return false;
+
+    GetLocalBounds(m_ReleasedMin, m_ReleasedMax);
+    m_ReleasedHasVertexColors = HasVertexColors();
+    m_ReleasedVertexCount = static_cast<uint32_t>(m_Vertices.size());
+    m_ReleasedIndexCount = static_cast<uint32_t>(m_Indices.size());
+    m_CPUDataReleased = true;
+
+    // swap 而不是 clear：归还容量
+    std::vector<Vertex>().swap(m_Vertices);
+    std::vector<uint32_t>().swap(m_Indices);
+    ReleasePackedGPUData();
+    return true;
 }
 
 } // namespace resources
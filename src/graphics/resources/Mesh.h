@@ -2,7 +2,9 @@
 #include <DirectXMath.h>
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <d3d11.h>
+#include "GeometryPool.h"
 
 namespace outer_wilds {
 namespace resources {
@@ -15,28 +17,152 @@ struct Vertex {
     DirectX::XMFLOAT4 color = {1.0f, 1.0f, 1.0f, 1.0f};  // 顶点颜色（来自MTL的Kd）
 };
 
+/**
+ * @brief 压缩顶点（28字节，GPU专用；CPU侧仍保留完整 Vertex 供碰撞/包围盒使用）
+ * - normal/tangent: 八面体编码，R16G16_SNORM
+ * - texCoord: R16G16_UNORM（要求 UV 在 [0,1]）
+ * - color: R8G8B8A8_UNORM
+ */
+struct CompactVertex {
+    DirectX::XMFLOAT3 position;
+    int16_t normal[2];
+    uint16_t texCoord[2];
+    int16_t tangent[2];
+    uint8_t color[4];
+};
+static_assert(sizeof(CompactVertex) == 28, "CompactVertex must match the compact input layout in Shader");
+
+/**
+ * @brief GPU 顶点缓冲区的布局
+ */
+enum class VertexFormat {
+    Standard,  // Vertex（64字节，float）
+    Compact    // CompactVertex（28字节，量化）
+};
+
 class Mesh {
 public:
     Mesh() = default;
     ~Mesh() = default;
+    Mesh(const Mesh&) = default;
+    Mesh& operator=(const Mesh&) = default;
+    Mesh(Mesh&&) = default;
+    Mesh& operator=(Mesh&&) = default;
 
-    void SetVertices(const std::vector<Vertex>& vertices) { m_Vertices = vertices; }
-    void SetIndices(const std::vector<uint32_t>& indices) { m_Indices = indices; }
+    void SetVertices(const std::vector<Vertex>& vertices) { m_Vertices = vertices; OnGeometryChanged(); }
+    void SetIndices(const std::vector<uint32_t>& indices) { m_Indices = indices; OnGeometryChanged(); }
+    void SetVertices(const Vertex* vertices, size_t count) { m_Vertices.assign(vertices, vertices + count); OnGeometryChanged(); }
+    void SetIndices(const uint32_t* indices, size_t count) { m_Indices.assign(indices, indices + count); OnGeometryChanged(); }
     
+    // ReleaseCPUData 之后为空；数量和包围盒仍可通过 GetVertexCount / GetIndexCount / GetLocalBounds 取得
     const std::vector<Vertex>& GetVertices() const { return m_Vertices; }
     const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
-    uint32_t GetIndexCount() const { return static_cast<uint32_t>(m_Indices.size()); }
+    uint32_t GetIndexCount() const {
+        return m_CPUDataReleased ? m_ReleasedIndexCount : static_cast<uint32_t>(m_Indices.size());
+    }
+    uint32_t GetVertexCount() const {
+        return m_CPUDataReleased ? m_ReleasedVertexCount : static_cast<uint32_t>(m_Vertices.size());
+    }
+
+    /**
+     * @brief 模型空间 AABB（CPU 数据释放后返回释放前缓存的结果；没有顶点时 min > max）
+     */
+    void GetLocalBounds(DirectX::XMFLOAT3& outMin, DirectX::XMFLOAT3& outMax) const;
+
+    /**
+     * @brief 是否有非白色的顶点颜色（RenderQueue 据此选择 HAS_VERTEX_COLOR 排列；CPU 数据释放后返回缓存结果）
+     */
+    bool HasVertexColors() const;
+
+    /**
+     * @brief 上传后释放 CPU 侧的顶点 / 索引（ResourceCache 的 ReleaseCPUMeshData 选项）
+     *
+     * 缓存数量和包围盒后清空并归还 m_Vertices / m_Indices 的内存；之后不能再做 LOD 简化或重新上传。
+     * 物理碰撞使用 LoadedModel 中单独的 collisionVertices / collisionIndices，不受影响。
+     * @return 尚未创建 GPU 缓冲或已经释放过时返回 false
+     */
+    bool ReleaseCPUData();
+    bool HasCPUData() const { return !m_CPUDataReleased; }
     
+    // 顶点布局（在 CreateGPUBuffers 之前设置）
+    void SetVertexFormat(VertexFormat format) { m_VertexFormat = format; ReleasePackedGPUData(); }
+    VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+    uint32_t GetVertexStride() const {
+        return m_VertexFormat == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+    }
+
+    /**
+     * @brief 根据顶点数据选择布局：UV 在 [0,1] 且颜色在 [0,1] 时可无明显损失地量化
+     */
+    static VertexFormat SelectVertexFormat(const std::vector<Vertex>& vertices);
+
+    static CompactVertex PackVertex(const Vertex& vertex);
+
+    // 索引缓冲区格式：R16_UINT 要求顶点数 <= 65535（MeshOptimizer 按顶点数设置）
+    void SetIndexFormat(DXGI_FORMAT format) { m_IndexFormat = format; ReleasePackedGPUData(); }
+    DXGI_FORMAT GetIndexFormat() const { return m_IndexFormat; }
+
+    /**
+     * @brief 已按当前布局打包好的上传数据（MeshCache 的映射视图），CreateGPUBuffers 直接使用
+     * @param owner 保证数据在上传前有效（上传后释放）；修改顶点/索引/格式时自动丢弃
+     * @param indexData 可为 nullptr（按 m_Indices 转换）
+     */
+    void SetPackedGPUData(std::shared_ptr<const void> owner, const void* vertexData, const void* indexData) {
+        m_PackedOwner = std::move(owner);
+        m_PackedVertexData = vertexData;
+        m_PackedIndexData = indexData;
+    }
+    bool HasPackedGPUData() const { return m_PackedVertexData != nullptr; }
+
     // GPU resource creation
+    // 优先从 GeometryPool 子分配（vertexBuffer / indexBuffer 指向共享页，绘制时加 baseVertex / startIndex）
     void CreateGPUBuffers(ID3D11Device* device);
+
+    /**
+     * @brief 释放 GPU 缓冲：池中的区间归还 GeometryPool，独立缓冲 Release（Mesh 析构时不会自动调用）
+     */
+    void ReleaseGPUBuffers();
+
+    // DrawIndexed(indexCount, GetStartIndex(), GetBaseVertex())；独立缓冲时都为 0
+    uint32_t GetBaseVertex() const { return m_VertexRange.offset; }
+    uint32_t GetStartIndex() const { return m_IndexRange.offset; }
+    bool IsPooled() const { return m_VertexRange.IsValid(); }
     
     // GPU resource handles (to be filled by renderer)
     void* vertexBuffer = nullptr;
     void* indexBuffer = nullptr;
 
 private:
+    void OnGeometryChanged() {
+        m_CPUDataReleased = false;
+        ReleasePackedGPUData();
+    }
+
+    void ReleasePackedGPUData() {
+        m_PackedOwner.reset();
+        m_PackedVertexData = nullptr;
+        m_PackedIndexData = nullptr;
+    }
+
     std::vector<Vertex> m_Vertices;
     std::vector<uint32_t> m_Indices;
+    VertexFormat m_VertexFormat = VertexFormat::Standard;
+    DXGI_FORMAT m_IndexFormat = DXGI_FORMAT_R32_UINT;
+    std::shared_ptr<const void> m_PackedOwner;
+    const void* m_PackedVertexData = nullptr;
+    const void* m_PackedIndexData = nullptr;
+
+    // GeometryPool 中的区间（无效 = 独立缓冲或尚未上传）
+    GeometryRange m_VertexRange;
+    GeometryRange m_IndexRange;
+
+    // ReleaseCPUData 之后的缓存
+    bool m_CPUDataReleased = false;
+    uint32_t m_ReleasedVertexCount = 0;
+    uint32_t m_ReleasedIndexCount = 0;
+    DirectX::XMFLOAT3 m_ReleasedMin = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 m_ReleasedMax = { 0.0f, 0.0f, 0.0f };
+    bool m_ReleasedHasVertexColors = false;
 };
 
 } // namespace resources
@@ -0,0 +1,462 @@
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include "MeshCache.h"
+#include "AssimpLoader.h"
+#include "MappedFile.h"
+#include "../../core/DebugManager.h"
+#include "../../core/Profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+
+namespace {
+    constexpr uint32_t kMagic = 0x434D574F;  // "OWMC"
+    constexpr size_t kBlobAlignment = 16;
+
+#pragma pack(push, 1)
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t subMeshCount;
+        uint32_t flags;                   // bit 0: hasCollisionMesh
+        float bounds[13];                 // min, max, center, size, radius
+        uint32_t collisionVertexCount;
+        uint32_t collisionIndexCount;
+        uint64_t collisionVertexOffset;
+        uint64_t collisionIndexOffset;
+        uint64_t fileSize;                // 截断检测
+    };
+
+    struct SubMeshRecord {
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t vertexFormat;            // VertexFormat
+        uint32_t indexFormat;             // DXGI_FORMAT
+        int32_t materialIndex;
+        uint32_t reserved;
+        uint64_t vertexOffset;            // Vertex[]（完整精度）
+        uint64_t packedVertexOffset;      // 上传布局（Standard 时等于 vertexOffset）
+        uint64_t indexOffset;             // uint32_t[]
+        uint64_t packedIndexOffset;       // uint16_t[]（R16 时），否则等于 indexOffset
+        uint64_t metadataOffset;          // 材质名、纹理路径、内嵌纹理
+    };
+#pragma pack(pop)
+
+    void HashBytes(uint64_t& hash, const void* data, size_t size) {
+        // FNV-1a 64
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+
+    bool HashFile(uint64_t& hash, const std::string& path) {
+        auto mapped = MappedFile::Open(path);
+        if (!mapped) return false;
+        HashBytes(hash, mapped->Data(), mapped->Size());
+        return true;
+    }
+
+    // ---- 写入 ----
+
+    class BlobWriter {
+    public:
+        size_t Size() const { return m_Bytes.size(); }
+        std::vector<uint8_t>& Bytes() { return m_Bytes; }
+
+        void Align() {
+            m_Bytes.resize((m_Bytes.size() + kBlobAlignment - 1) / kBlobAlignment * kBlobAlignment, 0);
+        }
+
+        uint64_t Append(const void* data, size_t size) {
+            const uint64_t offset = m_Bytes.size();
+            if (size) {
+                m_Bytes.resize(m_Bytes.size() + size);
+                std::memcpy(m_Bytes.data() + offset, data, size);
+            }
+            return offset;
+        }
+
+        uint64_t AppendBlob(const void* data, size_t size) {
+            Align();
+            return Append(data, size);
+        }
+
+        void AppendU32(uint32_t value) { Append(&value, sizeof(value)); }
+
+        void AppendString(const std::string& text) {
+            AppendU32(static_cast<uint32_t>(text.size()));
+            Append(text.data(), text.size());
+        }
+
+    private:
+        std::vector<uint8_t> m_Bytes;
+    };
+
+    // ---- 读取 ----
+
+    class BlobReader {
+    public:
+        BlobReader(const uint8_t* data, size_t size, size_t offset) : m_Data(data), m_Size(size), m_Pos(offset) {
+            m_Ok = offset <= size;
+        }
+
+        bool Ok() const { return m_Ok; }
+
+        uint32_t ReadU32() {
+            uint32_t value = 0;
+            if (Require(sizeof(value))) {
+                std::memcpy(&value, m_Data + m_Pos, sizeof(value));
+                m_Pos += sizeof(value);
+            }
+            return value;
+        }
+
+        std::string ReadString() {
+            const uint32_t length = ReadU32();
+            if (!Require(length)) return {};
+            std::string text(reinterpret_cast<const char*>(m_Data + m_Pos), length);
+            m_Pos += length;
+            return text;
+        }
+
+        void ReadBytes(std::vector<unsigned char>& out, size_t size) {
+            if (!Require(size)) return;
+            out.assign(m_Data + m_Pos, m_Data + m_Pos + size);
+            m_Pos += size;
+        }
+
+    private:
+        bool Require(size_t size) {
+            if (!m_Ok || size > m_Size - m_Pos) m_Ok = false;
+            return m_Ok;
+        }
+
+        const uint8_t* m_Data;
+        size_t m_Size;
+        size_t m_Pos;
+        bool m_Ok;
+    };
+
+    bool InRange(const MappedFile& file, uint64_t offset, uint64_t size) {
+        return offset <= file.Size() && size <= file.Size() - offset;
+    }
+
+    void StoreBounds(const ModelBounds& bounds, float (&out)[13]) {
+        const float values[13] = {
+            bounds.min.x, bounds.min.y, bounds.min.z, bounds.max.x, bounds.max.y, bounds.max.z,
+            bounds.center.x, bounds.center.y, bounds.center.z, bounds.size.x, bounds.size.y, bounds.size.z,
+            bounds.radius,
+        };
+        std::copy(values, values + 13, out);
+    }
+
+    ModelBounds LoadBounds(const float (&values)[13]) {
+        ModelBounds bounds;
+        bounds.min = { values[0], values[1], values[2] };
+        bounds.max = { values[3], values[4], values[5] };
+        bounds.center = { values[6], values[7], values[8] };
+        bounds.size = { values[9], values[10], values[11] };
+        bounds.radius = values[12];
+        return bounds;
+    }
+
+    /**
+     * @brief 解析并校验整个文件；成功前不修改输出
+     */
+    bool ParseFile(const std::shared_ptr<const MappedFile>& file, MultiMaterialModel& outModel) {
+        if (file->Size() < sizeof(FileHeader)) return false;
+        FileHeader header;
+        std::memcpy(&header, file->Data(), sizeof(header));
+        if (header.magic != kMagic || header.version != MeshCache::kFormatVersion ||
+            header.fileSize != file->Size()) {
+            return false;
+        }
+        if (!InRange(*file, sizeof(FileHeader), static_cast<uint64_t>(header.subMeshCount) * sizeof(SubMeshRecord)) ||
+            !InRange(*file, header.collisionVertexOffset, static_cast<uint64_t>(header.collisionVertexCount) * sizeof(Vertex)) ||
+            !InRange(*file, header.collisionIndexOffset, static_cast<uint64_t>(header.collisionIndexCount) * sizeof(uint32_t))) {
+            return false;
+        }
+
+        MultiMaterialModel model;
+        model.bounds = LoadBounds(header.bounds);
+        model.hasCollisionMesh = (header.flags & 1u) != 0;
+        const Vertex* collisionVertices = reinterpret_cast<const Vertex*>(file->Data() + header.collisionVertexOffset);
+        const uint32_t* collisionIndices = reinterpret_cast<const uint32_t*>(file->Data() + header.collisionIndexOffset);
+        model.collisionVertices.assign(collisionVertices, collisionVertices + header.collisionVertexCount);
+        model.collisionIndices.assign(collisionIndices, collisionIndices + header.collisionIndexCount);
+
+        // 映射视图由每个 Mesh 的打包数据共享，最后一个上传（或销毁）的 Mesh 释放它
+        std::shared_ptr<const void> owner = file;
+        model.subMeshes.reserve(header.subMeshCount);
+        for (uint32_t i = 0; i < header.subMeshCount; i++) {
+            SubMeshRecord record;
+            std::memcpy(&record, file->Data() + sizeof(FileHeader) + i * sizeof(SubMeshRecord), sizeof(record));
+
+            const VertexFormat format = static_cast<VertexFormat>(record.vertexFormat);
+            const DXGI_FORMAT indexFormat = static_cast<DXGI_FORMAT>(record.indexFormat);
+            const uint32_t stride = format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+            const uint32_t indexSize = indexFormat == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(uint32_t);
+            if (!InRange(*file, record.vertexOffset, static_cast<uint64_t>(record.vertexCount) * sizeof(Vertex)) ||
+                !InRange(*file, record.packedVertexOffset, static_cast<uint64_t>(record.vertexCount) * stride) ||
+                !InRange(*file, record.indexOffset, static_cast<uint64_t>(record.indexCount) * sizeof(uint32_t)) ||
+                !InRange(*file, record.packedIndexOffset, static_cast<uint64_t>(record.indexCount) * indexSize)) {
+                return false;
+            }
+
+            SubMesh subMesh;
+            subMesh.materialIndex = record.materialIndex;
+            subMesh.mesh = std::make_shared<Mesh>();
+            subMesh.mesh->SetVertices(reinterpret_cast<const Vertex*>(file->Data() + record.vertexOffset), record.vertexCount);
+            subMesh.mesh->SetIndices(reinterpret_cast<const uint32_t*>(file->Data() + record.indexOffset), record.indexCount);
+            subMesh.mesh->SetVertexFormat(format);
+            subMesh.mesh->SetIndexFormat(indexFormat);
+            subMesh.mesh->SetPackedGPUData(owner, file->Data() + record.packedVertexOffset,
+                                           record.indexCount ? file->Data() + record.packedIndexOffset : nullptr);
+
+            BlobReader reader(file->Data(), file->Size(), static_cast<size_t>(record.metadataOffset));
+            subMesh.materialName = reader.ReadString();
+            const uint32_t pathCount = reader.ReadU32();
+            for (uint32_t p = 0; p < pathCount && reader.Ok(); p++) {
+                subMesh.texturePaths.push_back(reader.ReadString());
+            }
+            const uint32_t embeddedCount = reader.ReadU32();
+            for (uint32_t t = 0; t < embeddedCount && reader.Ok(); t++) {
+                EmbeddedTexture texture;
+                texture.width = reader.ReadU32();
+                texture.height = reader.ReadU32();
+                texture.isCompressed = reader.ReadU32() != 0;
+                texture.formatHint = reader.ReadString();
+                reader.ReadBytes(texture.data, reader.ReadU32());
+                subMesh.embeddedTextures.push_back(std::move(texture));
+            }
+            if (!reader.Ok()) return false;
+
+            model.subMeshes.push_back(std::move(subMesh));
+        }
+
+        outModel = std::move(model);
+        return true;
+    }
+}
+
+uint64_t MeshCache::HashSource(const std::string& sourcePath, SourceKind kind, uint32_t optionBits) const {
+    if (!m_Enabled) return 0;
+    PROFILE_SCOPE("MeshCache::HashSource");
+
+    // 路径也参与哈希：材质纹理路径按模型目录解析后写入缓存
+    uint64_t hash = 0xcbf29ce484222325ull;
+    HashBytes(hash, sourcePath.data(), sourcePath.size());
+    if (!HashFile(hash, sourcePath)) return 0;
+
+    // 同名伴随文件（model.mtl、model.bin 等）也参与哈希：修改材质或缓冲区后重新导入
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const fs::path source(sourcePath);
+    std::vector<std::string> companions;
+    for (fs::directory_iterator it(source.has_parent_path() ? source.parent_path() : fs::path("."), ec), end;
+         !ec && it != end; it.increment(ec)) {
+        const fs::path& path = it->path();
+        if (path.stem() == source.stem() && path.extension() != source.extension() && it->is_regular_file(ec)) {
+            companions.push_back(path.string());
+        }
+    }
+    std::sort(companions.begin(), companions.end());
+    for (const auto& companion : companions) {
+        HashBytes(hash, companion.data(), companion.size());
+        HashFile(hash, companion);
+    }
+
+    const uint32_t tail[3] = { static_cast<uint32_t>(kind), optionBits, kFormatVersion };
+    HashBytes(hash, tail, sizeof(tail));
+    return hash;
+}
+
+std::string MeshCache::GetCachePath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.omesh", static_cast<unsigned long long>(key));
+    return m_CacheDirectory + "/" + name;
+}
+
+bool MeshCache::Read(uint64_t key, MultiMaterialModel& outModel) {
+    if (!m_Enabled || key == 0) return false;
+    PROFILE_SCOPE("MeshCache::Read");
+
+    const std::string path = GetCachePath(key);
+    auto file = MappedFile::Open(path);
+    if (!file) return false;
+    if (!ParseFile(file, outModel)) {
+        DebugManager::GetInstance().Log("MeshCache", "Stale or corrupt cache entry, reimporting: " + path);
+        return false;
+    }
+    m_DiskHits++;
+    return true;
+}
+
+bool MeshCache::Read(uint64_t key, LoadedModel& outModel) {
+    MultiMaterialModel model;
+    if (!Read(key, model) || model.subMeshes.size() != 1) return false;
+
+    SubMesh& subMesh = model.subMeshes[0];
+    outModel.mesh = std::move(subMesh.mesh);
+    outModel.texturePaths = std::move(subMesh.texturePaths);
+    outModel.embeddedTextures = std::move(subMesh.embeddedTextures);
+    outModel.bounds = model.bounds;
+    outModel.collisionVertices = std::move(model.collisionVertices);
+    outModel.collisionIndices = std::move(model.collisionIndices);
+    outModel.hasCollisionMesh = model.hasCollisionMesh;
+    return true;
+}
+
+bool MeshCache::Read(uint64_t key, Mesh& outMesh) {
+    MultiMaterialModel model;
+    if (!Read(key, model) || model.subMeshes.size() != 1) return false;
+    outMesh = std::move(*model.subMeshes[0].mesh);
+    return true;
+}
+
+bool MeshCache::Write(uint64_t key, const MultiMaterialModel& model) {
+    if (!m_Enabled || key == 0) return false;
+    return WriteFile(key, model);
+}
+
+bool MeshCache::Write(uint64_t key, const LoadedModel& model) {
+    if (!m_Enabled || key == 0 || !model.mesh) return false;
+
+    MultiMaterialModel view;
+    SubMesh subMesh;
+    subMesh.mesh = model.mesh;
+    subMesh.texturePaths = model.texturePaths;
+    subMesh.embeddedTextures = model.embeddedTextures;
+    view.subMeshes.push_back(std::move(subMesh));
+    view.bounds = model.bounds;
+    view.collisionVertices = model.collisionVertices;
+    view.collisionIndices = model.collisionIndices;
+    view.hasCollisionMesh = model.hasCollisionMesh;
+    return WriteFile(key, view);
+}
+
+bool MeshCache::Write(uint64_t key, const Mesh& mesh) {
+    if (!m_Enabled || key == 0) return false;
+
+    MultiMaterialModel view;
+    SubMesh subMesh;
+    // 不持有所有权的别名指针：mesh 在本次调用期间有效
+    subMesh.mesh = std::shared_ptr<Mesh>(std::shared_ptr<Mesh>(), const_cast<Mesh*>(&mesh));
+    view.subMeshes.push_back(std::move(subMesh));
+    view.bounds = ModelBounds{};
+    return WriteFile(key, view);
+}
+
+bool MeshCache::WriteFile(uint64_t key, const MultiMaterialModel& model) {
+    PROFILE_SCOPE("MeshCache::Write");
+
+    FileHeader header = {};
+    header.magic = kMagic;
+    header.version = kFormatVersion;
+    header.subMeshCount = static_cast<uint32_t>(model.subMeshes.size());
+    header.flags = model.hasCollisionMesh ? 1u : 0u;
+    StoreBounds(model.bounds, header.bounds);
+    header.collisionVertexCount = static_cast<uint32_t>(model.collisionVertices.size());
+    header.collisionIndexCount = static_cast<uint32_t>(model.collisionIndices.size());
+
+    BlobWriter writer;
+    writer.Append(&header, sizeof(header));
+    std::vector<SubMeshRecord> records(model.subMeshes.size());
+    writer.Append(records.data(), records.size() * sizeof(SubMeshRecord));
+
+    header.collisionVertexOffset = writer.AppendBlob(model.collisionVertices.data(),
+                                                     model.collisionVertices.size() * sizeof(Vertex));
+    header.collisionIndexOffset = writer.AppendBlob(model.collisionIndices.data(),
+                                                    model.collisionIndices.size() * sizeof(uint32_t));
+
+    for (size_t i = 0; i < model.subMeshes.size(); i++) {
+        const SubMesh& subMesh = model.subMeshes[i];
+        SubMeshRecord& record = records[i];
+        if (!subMesh.mesh) return false;
+        const Mesh& mesh = *subMesh.mesh;
+        const auto& vertices = mesh.GetVertices();
+        const auto& indices = mesh.GetIndices();
+
+        record.vertexCount = static_cast<uint32_t>(vertices.size());
+        record.indexCount = static_cast<uint32_t>(indices.size());
+        record.vertexFormat = static_cast<uint32_t>(mesh.GetVertexFormat());
+        record.materialIndex = subMesh.materialIndex;
+        record.vertexOffset = writer.AppendBlob(vertices.data(), vertices.size() * sizeof(Vertex));
+        record.indexOffset = writer.AppendBlob(indices.data(), indices.size() * sizeof(uint32_t));
+
+        // 上传布局：与 CreateGPUBuffers 的转换规则一致
+        record.packedVertexOffset = record.vertexOffset;
+        if (mesh.GetVertexFormat() == VertexFormat::Compact) {
+            std::vector<CompactVertex> packed;
+            packed.reserve(vertices.size());
+            for (const auto& vertex : vertices) packed.push_back(Mesh::PackVertex(vertex));
+            record.packedVertexOffset = writer.AppendBlob(packed.data(), packed.size() * sizeof(CompactVertex));
+        }
+        record.indexFormat = DXGI_FORMAT_R32_UINT;
+        record.packedIndexOffset = record.indexOffset;
+        if (mesh.GetIndexFormat() == DXGI_FORMAT_R16_UINT && vertices.size() <= 0xFFFF) {
+            const std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+            record.indexFormat = DXGI_FORMAT_R16_UINT;
+            record.packedIndexOffset = writer.AppendBlob(shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+        }
+
+        writer.Align();
+        record.metadataOffset = writer.Size();
+        writer.AppendString(subMesh.materialName);
+        writer.AppendU32(static_cast<uint32_t>(subMesh.texturePaths.size()));
+        for (const auto& path : subMesh.texturePaths) writer.AppendString(path);
+        writer.AppendU32(static_cast<uint32_t>(subMesh.embeddedTextures.size()));
+        for (const auto& texture : subMesh.embeddedTextures) {
+            writer.AppendU32(texture.width);
+            writer.AppendU32(texture.height);
+            writer.AppendU32(texture.isCompressed ? 1u : 0u);
+            writer.AppendString(texture.formatHint);
+            writer.AppendU32(static_cast<uint32_t>(texture.data.size()));
+            writer.Append(texture.data.data(), texture.data.size());
+        }
+    }
+
+    header.fileSize = writer.Size();
+    std::memcpy(writer.Bytes().data(), &header, sizeof(header));
+    std::memcpy(writer.Bytes().data() + sizeof(header), records.data(), records.size() * sizeof(SubMeshRecord));
+
+    namespace fs = std::filesystem;
+    const std::string path = GetCachePath(key);
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+
+    // 先写临时文件再重命名，避免中断时留下截断的缓存
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            DebugManager::GetInstance().Log("MeshCache", "Failed to write cache file: " + tempPath);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(writer.Bytes().data()), static_cast<std::streamsize>(writer.Size()));
+        if (!file) return false;
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        // 旧条目仍被映射（同一次运行中读过）时无法替换
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    m_Writes++;
+    DebugManager::GetInstance().Log("MeshCache", "Cached " + std::to_string(model.subMeshes.size()) +
+        " sub-mesh(es) (" + std::to_string(writer.Size() / 1024) + " KB) -> " + path);
+    return true;
+}
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,99 @@
+/**
+ * MeshCache.h
+ *
+ * 导入后网格的二进制磁盘缓存（cache/meshes/<hash>.omesh）
+ *
+ * AssimpLoader / OBJLoader 首次导入时把优化后的结果写成紧凑的二进制文件：
+ * 文件头（包围盒、碰撞网格）+ 子网格表 + 对齐的顶点 / 索引数据块 + 材质引用（纹理路径、内嵌纹理）。
+ * 每个子网格同时保存完整精度的 Vertex / uint32 索引（CPU 侧：包围盒、碰撞、LOD 简化）和
+ * 上传布局的数据（CompactVertex / 16 位索引；Standard 布局与 CPU 数据共用同一块）。
+ *
+ * 之后的启动用 MapViewOfFile 映射文件：跳过 Assimp / OBJ 解析和 MeshOptimizer，
+ * Mesh::CreateGPUBuffers 直接从映射视图上传，不再逐顶点打包。
+ *
+ * 键：FNV-1a 64（源文件路径和字节 + 同名的伴随文件（.mtl / .bin）+ 加载器类型 + 影响输出的选项 + kFormatVersion）
+ *
+ * 线程安全：读写都可以在加载线程上调用；统计为原子计数。
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace outer_wilds {
+namespace resources {
+
+class Mesh;
+struct LoadedModel;
+struct MultiMaterialModel;
+
+class MeshCache {
+public:
+    /**
+     * 修改文件布局、导入流程或 MeshOptimizer 输出时递增，使旧缓存失效
+     */
+    static constexpr uint32_t kFormatVersion = 2;
+
+    /**
+     * @brief 产生缓存条目的加载路径（同一源文件在不同路径下的结果不同）
+     */
+    enum class SourceKind : uint32_t {
+        AssimpSingle,   // AssimpLoader::LoadFromFile（所有网格合并）
+        AssimpMulti,    // AssimpLoader::LoadMultiMaterialModel（按材质拆分）
+        OBJ             // OBJLoader::LoadFromFile
+    };
+
+    static MeshCache& GetInstance() {
+        static MeshCache instance;
+        return instance;
+    }
+
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsEnabled() const { return m_Enabled; }
+
+    void SetCacheDirectory(const std::string& directory) { m_CacheDirectory = directory; }
+    const std::string& GetCacheDirectory() const { return m_CacheDirectory; }
+
+    /**
+     * @brief 源文件的缓存键
+     * @param optionBits 影响导入结果的选项（各加载器自行编码）
+     * @return 0 表示缓存关闭或源文件无法读取
+     */
+    uint64_t HashSource(const std::string& sourcePath, SourceKind kind, uint32_t optionBits) const;
+
+    /** @brief 缓存文件路径（文件可能不存在） */
+    std::string GetCachePath(uint64_t key) const;
+
+    /**
+     * @brief 读取缓存条目；网格的 GPU 数据指向映射视图，直到 CreateGPUBuffers 上传后释放
+     * @return 条目不存在、版本不符或损坏时返回 false（输出保持不变）
+     */
+    bool Read(uint64_t key, LoadedModel& outModel);
+    bool Read(uint64_t key, MultiMaterialModel& outModel);
+    bool Read(uint64_t key, Mesh& outMesh);
+
+    /** @brief 写入缓存条目（先写临时文件再重命名） */
+    bool Write(uint64_t key, const LoadedModel& model);
+    bool Write(uint64_t key, const MultiMaterialModel& model);
+    bool Write(uint64_t key, const Mesh& mesh);
+
+    /** @brief 统计：磁盘缓存命中 / 本次运行中写入的条目数 */
+    uint32_t GetDiskHitCount() const { return m_DiskHits; }
+    uint32_t GetWriteCount() const { return m_Writes; }
+
+private:
+    MeshCache() = default;
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    bool WriteFile(uint64_t key, const MultiMaterialModel& model);
+
+    bool m_Enabled = true;
+    std::string m_CacheDirectory = "cache/meshes";
+    std::atomic<uint32_t> m_DiskHits{ 0 };
+    std::atomic<uint32_t> m_Writes{ 0 };
+};
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,269 @@
+#include "MeshOptimizer.h"
+#include "core/DebugManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+
+using namespace DirectX;
+
+namespace outer_wilds {
+namespace resources {
+
+namespace {
+
+constexpr uint32_t kInvalidIndex = ~0u;
+
+} // namespace
+
+void MeshOptimizer::Optimize(Mesh& mesh) {
+    std::vector<Vertex> vertices = mesh.GetVertices();
+    std::vector<uint32_t> indices = mesh.GetIndices();
+
+    if (vertices.empty() || indices.size() < 3 || indices.size() % 3 != 0) {
+        return;
+    }
+    for (uint32_t index : indices) {
+        if (index >= vertices.size()) {
+            DebugManager::GetInstance().Log("MeshOptimizer", "Skipped mesh with out-of-range indices");
+            return;
+        }
+    }
+
+    const float acmrBefore = AnalyzeACMR(indices, vertices.size());
+
+    // === 1. 顶点缓存 ===
+    std::vector<uint32_t> clusters;
+    OptimizeVertexCache(indices, vertices.size(), &clusters);
+    const float acmrCache = AnalyzeACMR(indices, vertices.size());
+
+    // === 2. 过度绘制（缓存命中率退化过多时放弃）===
+    std::vector<uint32_t> cacheOrder = indices;
+    OptimizeOverdraw(indices, vertices, clusters);
+    float acmrAfter = AnalyzeACMR(indices, vertices.size());
+    if (acmrAfter > acmrCache * kOverdrawCacheThreshold) {
+        indices.swap(cacheOrder);
+        acmrAfter = acmrCache;
+    }
+
+    // === 3. 顶点拉取 ===
+    OptimizeVertexFetch(vertices, indices);
+
+    mesh.SetVertices(vertices);
+    mesh.SetIndices(indices);
+
+    // === 4. 16 位索引 ===
+    mesh.SetIndexFormat(vertices.size() <= 0xFFFF ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT);
+
+    char message[160];
+    snprintf(message, sizeof(message), "Optimized %zu tris, %zu verts: ACMR %.3f -> %.3f (%u clusters, %s indices)",
+             indices.size() / 3, vertices.size(), acmrBefore, acmrAfter,
+             static_cast<unsigned>(clusters.size()), vertices.size() <= 0xFFFF ? "16-bit" : "32-bit");
+    DebugManager::GetInstance().Log("MeshOptimizer", message);
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount,
+                                        std::vector<uint32_t>* outClusters) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    // === 顶点 → 三角形邻接表（CSR）===
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (uint32_t index : indices) {
+        liveTriangles[index]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+    }
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjacency[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    // === Tipsify ===
+    const uint32_t cacheSize = kVertexCacheSize;
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    deadEnd.reserve(indices.size());
+
+    if (outClusters) {
+        outClusters->clear();
+        outClusters->push_back(0);
+    }
+
+    uint32_t time = cacheSize + 1;
+    size_t scanCursor = 0;
+    uint32_t fanning = indices[0];
+
+    while (fanning != kInvalidIndex) {
+        candidates.clear();
+
+        for (uint32_t a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++) {
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) continue;
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                uint32_t v = indices[triangle * 3 + corner];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time++;
+                }
+            }
+            emitted[triangle] = 1;
+        }
+
+        // 下一个扇形中心：仍在缓存中且剩余三角形能在缓存淘汰前处理完的候选里选最"老"的
+        uint32_t next = kInvalidIndex;
+        int bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (liveTriangles[v] == 0) continue;
+            int priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) {
+                priority = static_cast<int>(time - cacheTime[v]);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        if (next == kInvalidIndex) {
+            // 死胡同：先回溯最近输出过的顶点，再线性扫描
+            while (!deadEnd.empty()) {
+                uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveTriangles[v] > 0) {
+                    next = v;
+                    break;
+                }
+            }
+            while (next == kInvalidIndex && scanCursor < vertexCount) {
+                if (liveTriangles[scanCursor] > 0) {
+                    next = static_cast<uint32_t>(scanCursor);
+                }
+                scanCursor++;
+            }
+
+            // 非局部跳转处作为过度绘制优化的簇边界
+            if (next != kInvalidIndex && outClusters && outClusters->back() != output.size()) {
+                outClusters->push_back(static_cast<uint32_t>(output.size()));
+            }
+        }
+
+        fanning = next;
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                                     const std::vector<uint32_t>& clusters) {
+    if (clusters.size() < 2 || vertices.empty()) {
+        return;
+    }
+
+    XMVECTOR meshCentroid = XMVectorZero();
+    for (const auto& vertex : vertices) {
+        meshCentroid = XMVectorAdd(meshCentroid, XMLoadFloat3(&vertex.position));
+    }
+    meshCentroid = XMVectorScale(meshCentroid, 1.0f / static_cast<float>(vertices.size()));
+
+    // 簇排序键：簇中心相对网格中心的偏移在簇平均法线上的投影（越朝外越先画）
+    std::vector<float> sortKeys(clusters.size(), 0.0f);
+    for (size_t c = 0; c < clusters.size(); c++) {
+        size_t begin = clusters[c];
+        size_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : indices.size();
+
+        XMVECTOR centroid = XMVectorZero();
+        XMVECTOR normal = XMVectorZero();
+        float totalArea = 0.0f;
+
+        for (size_t i = begin; i + 2 < end; i += 3) {
+            XMVECTOR p0 = XMLoadFloat3(&vertices[indices[i]].position);
+            XMVECTOR p1 = XMLoadFloat3(&vertices[indices[i + 1]].position);
+            XMVECTOR p2 = XMLoadFloat3(&vertices[indices[i + 2]].position);
+
+            XMVECTOR faceNormal = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+            float area = XMVectorGetX(XMVector3Length(faceNormal));
+            XMVECTOR faceCentroid = XMVectorScale(XMVectorAdd(XMVectorAdd(p0, p1), p2), 1.0f / 3.0f);
+
+            centroid = XMVectorAdd(centroid, XMVectorScale(faceCentroid, area));
+            normal = XMVectorAdd(normal, faceNormal);
+            totalArea += area;
+        }
+
+        if (totalArea <= 0.0f) continue;
+        centroid = XMVectorScale(centroid, 1.0f / totalArea);
+        float normalLength = XMVectorGetX(XMVector3Length(normal));
+        if (normalLength <= 0.0f) continue;
+
+        sortKeys[c] = XMVectorGetX(XMVector3Dot(XMVectorSubtract(centroid, meshCentroid),
+                                                XMVectorScale(normal, 1.0f / normalLength)));
+    }
+
+    std::vector<uint32_t> order(clusters.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t a, uint32_t b) {
+        return sortKeys[a] > sortKeys[b];
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (uint32_t c : order) {
+        size_t begin = clusters[c];
+        size_t end = (c + 1 < clusters.size()) ? clusters[c + 1] : indices.size();
+        output.insert(output.end(), indices.begin() + begin, indices.begin() + end);
+    }
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    std::vector<uint32_t> remap(vertices.size(), kInvalidIndex);
+    std::vector<Vertex> output;
+    output.reserve(vertices.size());
+
+    for (uint32_t& index : indices) {
+        if (remap[index] == kInvalidIndex) {
+            remap[index] = static_cast<uint32_t>(output.size());
+            output.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices.swap(output);
+}
+
+float MeshOptimizer::AnalyzeACMR(const std::vector<uint32_t>& indices, size_t vertexCount, uint32_t cacheSize) {
+    if (indices.size() < 3 || vertexCount == 0) {
+        return 0.0f;
+    }
+
+    // FIFO 缓存模拟：命中条件为"最近 cacheSize 次未命中内写入过"
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    size_t misses = 0;
+    for (uint32_t index : indices) {
+        if (time - cacheTime[index] > cacheSize) {
+            cacheTime[index] = time++;
+            misses++;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,53 @@
+#pragma once
+#include "Mesh.h"
+#include <vector>
+#include <cstdint>
+
+namespace outer_wilds {
+namespace resources {
+
+/**
+ * @brief 导入期网格优化（在 CreateGPUBuffers 之前对每个 Mesh 运行）
+ *
+ * 1. 顶点缓存优化：Tipsify（Sander et al. 2007），线性时间、面向固定大小的 post-transform 缓存
+ * 2. 过度绘制优化：对 Tipsify 产生的簇按"朝外程度"排序（先画外侧簇，提前深度剔除更多像素），
+ *    若顶点缓存命中率下降超过阈值则保留纯缓存顺序
+ * 3. 顶点拉取优化：按首次引用顺序重排顶点（并丢弃未引用的顶点）
+ * 4. 顶点数 <= 65535 时使用 16 位索引
+ */
+class MeshOptimizer {
+public:
+    static constexpr uint32_t kVertexCacheSize = 16;
+    static constexpr float kOverdrawCacheThreshold = 1.05f;  // 允许的 ACMR 退化比例
+
+    /**
+     * @brief 对 Mesh 的顶点/索引执行完整优化流程
+     */
+    static void Optimize(Mesh& mesh);
+
+    /**
+     * @brief 顶点缓存优化，outClusters 返回每个簇在 indices 中的起始位置（三角形对齐）
+     */
+    static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount,
+                                    std::vector<uint32_t>* outClusters = nullptr);
+
+    /**
+     * @brief 在顶点缓存优化的簇边界上重排以减少过度绘制
+     */
+    static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<Vertex>& vertices,
+                                 const std::vector<uint32_t>& clusters);
+
+    /**
+     * @brief 按首次引用顺序重排顶点，同时改写索引
+     */
+    static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    /**
+     * @brief 平均缓存未命中率（每三角形的顶点变换次数，理想值约 0.5~0.7）
+     */
+    static float AnalyzeACMR(const std::vector<uint32_t>& indices, size_t vertexCount,
+                             uint32_t cacheSize = kVertexCacheSize);
+};
+
+} // namespace resources
+} // namespace outer_wilds
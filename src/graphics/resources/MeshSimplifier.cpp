@@ -0,0 +1,281 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include "core/DebugManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace outer_wilds {
+namespace resources {
+
+namespace {
+
+/**
+ * @brief 对称 4x4 二次误差矩阵（10 个独立分量）
+ */
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+
+    void AddPlane(double nx, double ny, double nz, double d, double weight) {
+        a00 += weight * nx * nx; a01 += weight * nx * ny; a02 += weight * nx * nz; a03 += weight * nx * d;
+        a11 += weight * ny * ny; a12 += weight * ny * nz; a13 += weight * ny * d;
+        a22 += weight * nz * nz; a23 += weight * nz * d;
+        a33 += weight * d * d;
+    }
+
+    void Add(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+        a11 += q.a11; a12 += q.a12; a13 += q.a13;
+        a22 += q.a22; a23 += q.a23;
+        a33 += q.a33;
+    }
+
+    double Evaluate(double x, double y, double z) const {
+        return a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x +
+               a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y +
+               a22 * z * z + 2.0 * a23 * z +
+               a33;
+    }
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+struct PositionKey {
+    uint32_t x, y, z;
+    bool operator==(const PositionKey& other) const { return x == other.x && y == other.y && z == other.z; }
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& key) const {
+        return (static_cast<size_t>(key.x) * 73856093u) ^ (static_cast<size_t>(key.y) * 19349663u) ^
+               (static_cast<size_t>(key.z) * 83492791u);
+    }
+};
+
+PositionKey MakePositionKey(const DirectX::XMFLOAT3& p) {
+    PositionKey key;
+    // +0.0f 把 -0.0f 归一为 0.0f
+    float x = p.x + 0.0f, y = p.y + 0.0f, z = p.z + 0.0f;
+    memcpy(&key.x, &x, sizeof(float));
+    memcpy(&key.y, &y, sizeof(float));
+    memcpy(&key.z, &z, sizeof(float));
+    return key;
+}
+
+void Cross(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b, const DirectX::XMFLOAT3& c,
+           double& nx, double& ny, double& nz) {
+    double ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+    double vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+    nx = uy * vz - uz * vy;
+    ny = uz * vx - ux * vz;
+    nz = ux * vy - uy * vx;
+}
+
+} // namespace
+
+std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<Vertex>& vertices,
+                                               const std::vector<uint32_t>& indices,
+                                               size_t targetIndexCount) {
+    std::vector<uint32_t> result = indices;
+    const size_t vertexCount = vertices.size();
+    if (indices.size() <= targetIndexCount || indices.size() % 3 != 0 || vertexCount == 0) {
+        return result;
+    }
+    for (uint32_t index : indices) {
+        if (index >= vertexCount) return result;
+    }
+
+    // === 1. 位置焊接：同一位置的多个顶点 = 属性接缝 ===
+    std::vector<uint32_t> positionGroup(vertexCount);
+    std::vector<uint32_t> groupSize;
+    {
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> groups;
+        groups.reserve(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) {
+            auto [it, inserted] = groups.emplace(MakePositionKey(vertices[v].position),
+                                                 static_cast<uint32_t>(groupSize.size()));
+            if (inserted) groupSize.push_back(0);
+            positionGroup[v] = it->second;
+            groupSize[it->second]++;
+        }
+    }
+    const size_t groupCount = groupSize.size();
+
+    // === 2. 锁定接缝和开放边界（按焊接后的边统计相邻三角形数）===
+    std::vector<uint8_t> lockedGroup(groupCount, 0);
+    for (size_t g = 0; g < groupCount; g++) {
+        lockedGroup[g] = groupSize[g] > 1 ? 1 : 0;
+    }
+    {
+        std::unordered_map<uint64_t, uint32_t> edgeCounts;
+        edgeCounts.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                uint32_t ga = positionGroup[indices[i + e]];
+                uint32_t gb = positionGroup[indices[i + (e + 1) % 3]];
+                if (ga == gb) continue;
+                uint64_t key = (static_cast<uint64_t>((std::min)(ga, gb)) << 32) | (std::max)(ga, gb);
+                edgeCounts[key]++;
+            }
+        }
+        for (const auto& [key, count] : edgeCounts) {
+            if (count != 2) {
+                lockedGroup[static_cast<uint32_t>(key >> 32)] = 1;
+                lockedGroup[static_cast<uint32_t>(key & 0xFFFFFFFFu)] = 1;
+            }
+        }
+    }
+
+    // === 3. 每个位置的二次误差（面积加权的平面方程）===
+    std::vector<Quadric> quadrics(groupCount);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const auto& p0 = vertices[indices[i]].position;
+        const auto& p1 = vertices[indices[i + 1]].position;
+        const auto& p2 = vertices[indices[i + 2]].position;
+        double nx, ny, nz;
+        Cross(p0, p1, p2, nx, ny, nz);
+        double length = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (length <= 0.0) continue;
+        nx /= length; ny /= length; nz /= length;
+        double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+        double area = length * 0.5;
+        for (int c = 0; c < 3; c++) {
+            quadrics[positionGroup[indices[i + c]]].AddPlane(nx, ny, nz, d, area);
+        }
+    }
+
+    // === 4. 分轮执行半边折叠：每轮按代价排序，互不相邻的折叠同时应用 ===
+    std::vector<uint32_t> remap(vertexCount);
+    std::iota(remap.begin(), remap.end(), 0u);
+    std::vector<uint8_t> touched(vertexCount, 0);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> candidates;
+
+    while (result.size() > targetIndexCount) {
+        // 顶点 → 三角形邻接表
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0u);
+        for (uint32_t index : result) adjacencyOffsets[index + 1]++;
+        for (size_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++) {
+                adjacency[cursor[result[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        candidates.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int e = 0; e < 3; e++) {
+                uint32_t a = result[i + e];
+                uint32_t b = result[i + (e + 1) % 3];
+                for (int dir = 0; dir < 2; dir++) {
+                    uint32_t from = dir ? b : a;
+                    uint32_t to = dir ? a : b;
+                    if (lockedGroup[positionGroup[from]]) continue;
+                    Quadric q = quadrics[positionGroup[from]];
+                    q.Add(quadrics[positionGroup[to]]);
+                    const auto& p = vertices[to].position;
+                    candidates.push_back({ from, to, q.Evaluate(p.x, p.y, p.z) });
+                }
+            }
+        }
+        if (candidates.empty()) break;
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+        const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+        size_t removed = 0;
+        size_t collapses = 0;
+        std::fill(touched.begin(), touched.end(), 0);
+
+        for (const Collapse& c : candidates) {
+            if (removed >= trianglesToRemove) break;
+            if (touched[c.from] || touched[c.to]) continue;
+
+            // 拒绝会翻转周围三角形的折叠
+            bool valid = true;
+            size_t degenerate = 0;
+            for (uint32_t a = adjacencyOffsets[c.from]; a < adjacencyOffsets[c.from + 1] && valid; a++) {
+                uint32_t t = adjacency[a];
+                uint32_t i0 = result[t * 3], i1 = result[t * 3 + 1], i2 = result[t * 3 + 2];
+                if (i0 == c.to || i1 == c.to || i2 == c.to) {
+                    degenerate++;
+                    continue;
+                }
+                double ox, oy, oz, nx, ny, nz;
+                Cross(vertices[i0].position, vertices[i1].position, vertices[i2].position, ox, oy, oz);
+                Cross(vertices[i0 == c.from ? c.to : i0].position,
+                      vertices[i1 == c.from ? c.to : i1].position,
+                      vertices[i2 == c.from ? c.to : i2].position, nx, ny, nz);
+                if (ox * nx + oy * ny + oz * nz <= 0.0) {
+                    valid = false;
+                }
+            }
+            if (!valid || degenerate == 0) continue;
+
+            remap[c.from] = c.to;
+            quadrics[positionGroup[c.to]].Add(quadrics[positionGroup[c.from]]);
+            for (uint32_t a = adjacencyOffsets[c.from]; a < adjacencyOffsets[c.from + 1]; a++) {
+                uint32_t t = adjacency[a];
+                touched[result[t * 3]] = 1;
+                touched[result[t * 3 + 1]] = 1;
+                touched[result[t * 3 + 2]] = 1;
+            }
+            removed += degenerate;
+            collapses++;
+        }
+
+        if (collapses == 0) break;
+
+        // 应用本轮折叠并移除退化三角形
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            uint32_t i0 = remap[result[i]], i1 = remap[result[i + 1]], i2 = remap[result[i + 2]];
+            if (i0 == i1 || i1 == i2 || i0 == i2) continue;
+            result[write++] = i0;
+            result[write++] = i1;
+            result[write++] = i2;
+        }
+        result.resize(write);
+    }
+
+    return result;
+}
+
+std::shared_ptr<Mesh> MeshSimplifier::GenerateLOD(const Mesh& source, float ratio) {
+    const auto& indices = source.GetIndices();
+    size_t targetIndexCount = static_cast<size_t>(static_cast<double>(indices.size() / 3) * ratio) * 3;
+
+    std::vector<uint32_t> simplified = Simplify(source.GetVertices(), indices, targetIndexCount);
+    if (simplified.empty() || simplified.size() > indices.size() * 9 / 10) {
+        return nullptr;
+    }
+
+    auto lod = std::make_shared<Mesh>();
+    lod->SetVertices(source.GetVertices());
+    lod->SetIndices(simplified);
+    lod->SetVertexFormat(source.GetVertexFormat());
+    MeshOptimizer::Optimize(*lod);  // 同时丢弃不再引用的顶点
+
+    char message[128];
+    snprintf(message, sizeof(message), "LOD %.2f: %zu -> %zu tris (target %zu)",
+             ratio, indices.size() / 3, simplified.size() / 3, targetIndexCount / 3);
+    DebugManager::GetInstance().Log("MeshSimplifier", message);
+    return lod;
+}
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,37 @@
+#pragma once
+#include "Mesh.h"
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace outer_wilds {
+namespace resources {
+
+/**
+ * @brief 网格简化（用于生成离散 LOD）
+ *
+ * 二次误差度量（Garland & Heckbert）+ 半边折叠：顶点只会折叠到已有的相邻顶点上，
+ * 因此 UV/法线/颜色等属性无需插值。位置相同但属性不同的接缝顶点以及开放边界顶点被锁定，
+ * 避免纹理接缝撕裂和轮廓收缩。
+ */
+class MeshSimplifier {
+public:
+    /**
+     * @brief 简化索引（顶点数组不变，未被引用的顶点由 MeshOptimizer 清理）
+     * @param targetIndexCount 目标索引数（无法继续折叠时可能达不到）
+     * @return 简化后的索引
+     */
+    static std::vector<uint32_t> Simplify(const std::vector<Vertex>& vertices,
+                                          const std::vector<uint32_t>& indices,
+                                          size_t targetIndexCount);
+
+    /**
+     * @brief 生成一级 LOD 网格：简化 + MeshOptimizer（继承源网格的顶点格式，不创建 GPU 缓冲区）
+     * @param ratio 目标三角形比例 (0, 1)
+     * @return 简化后的网格；削减不足 10% 时返回 nullptr（该级无意义）
+     */
+    static std::shared_ptr<Mesh> GenerateLOD(const Mesh& source, float ratio);
+};
+
+} // namespace resources
+} // namespace outer_wilds
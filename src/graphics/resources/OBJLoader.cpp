@@ -1,16 +1,221 @@
 #include "OBJLoader.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "MeshCache.h"
 #include "../../core/DebugManager.h"
-#include <fstream>
-#include <sstream>
+#include "../../core/JobSystem.h"
+#include "../../core/Profiler.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <iostream>
 #include <unordered_map>
-#include <algorithm>
 
 namespace outer_wilds {
 namespace resources {
 
-bool OBJLoader::LoadFromFile(const std::string& filename, Mesh& mesh) {
+bool OBJLoader::s_ParallelParsing = true;
+
+namespace {
+    constexpr size_t kMinChunkBytes = 1u * 1024u * 1024u;
+
+    /** @brief 面顶点的索引三元组（去重键） */
+    struct VertexKey {
+        int position;
+        int texCoord;
+        int normal;
+
+        bool operator==(const VertexKey& other) const {
+            return position == other.position && texCoord == other.texCoord && normal == other.normal;
+        }
+    };
+
+    struct VertexKeyHash {
+        size_t operator()(const VertexKey& key) const {
+            uint64_t h = static_cast<uint32_t>(key.position) * 0x9E3779B97F4A7C15ull;
+            h ^= (static_cast<uint32_t>(key.texCoord) + 0x632BE59BD9B4E019ull + (h << 6) + (h >> 2));
+            h ^= (static_cast<uint32_t>(key.normal) + 0x85157AF5ull + (h << 6) + (h >> 2));
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    /** @brief usemtl 切换：从块内第 firstFace 个三角形开始使用 name */
+    struct MaterialRun {
+        size_t firstFace;
+        std::string name;
+    };
+
+    inline bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+
+    inline const char* SkipSpaces(const char* p, const char* end) {
+        while (p < end && IsSpace(*p)) ++p;
+        return p;
+    }
+
+    /** @brief 解析一个浮点数；失败时 out 保持不变（调用方预置 0） */
+    inline bool ParseFloat(const char*& p, const char* end, float& out) {
+        p = SkipSpaces(p, end);
+        if (p < end && *p == '+') ++p;   // from_chars 不接受前导 '+'
+        const auto result = std::from_chars(p, end, out);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        return true;
+    }
+
+    inline bool ParseInt(const char*& p, const char* end, int& out) {
+        if (p < end && *p == '+') ++p;
+        const auto result = std::from_chars(p, end, out);
+        if (result.ec != std::errc()) return false;
+        p = result.ptr;
+        return true;
+    }
+
+    /** @brief 读取一个空白分隔的名字（到行尾 / 空白 / '\r' 为止） */
+    inline std::string ParseName(const char* p, const char* end) {
+        p = SkipSpaces(p, end);
+        const char* nameEnd = p;
+        while (nameEnd < end && !IsSpace(*nameEnd) && *nameEnd != '\r') ++nameEnd;
+        return std::string(p, nameEnd);
+    }
+
+    inline bool StartsWith(const char* p, const char* end, const char* keyword, size_t length) {
+        return static_cast<size_t>(end - p) > length && std::memcmp(p, keyword, length) == 0 && IsSpace(p[length]);
+    }
+
+    inline const char* FindLineEnd(const char* p, const char* end) {
+        const void* newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+        return newline ? static_cast<const char*>(newline) : end;
+    }
+
+    /**
+     * @brief 一个块的解析结果
+     *
+     * 正数面索引本身就是全局的；负数（相对）索引只能相对块内已出现的元素换算，
+     * 先换算成块内 1-based 索引并记进 relativeFixups，拼接时再加上前面各块的元素数。
+     */
+    struct OBJChunk {
+        std::vector<DirectX::XMFLOAT3> positions;
+        std::vector<DirectX::XMFLOAT3> normals;
+        std::vector<DirectX::XMFLOAT2> texCoords;
+        std::vector<int> faceIndices;                            // 每个三角形 9 个：p0 t0 n0 p1 t1 n1 p2 t2 n2
+        std::vector<std::pair<size_t, uint16_t>> relativeFixups; // (三角形序号, 9 位掩码)
+        std::vector<MaterialRun> materialRuns;
+        std::vector<std::string> materialLibraries;
+
+        size_t FaceCount() const { return faceIndices.size() / 9; }
+    };
+
+    void ParseChunk(const char* p, const char* end, OBJChunk& chunk) {
+        // 一个多边形的顶点（复用，避免每行分配）
+        std::vector<int> polygon;
+        polygon.reserve(4 * 3);
+
+        while (p < end) {
+            const char* lineEnd = FindLineEnd(p, end);
+            const char* s = SkipSpaces(p, lineEnd);
+            p = lineEnd < end ? lineEnd + 1 : end;
+            if (lineEnd - s < 2) continue;
+
+            if (s[0] == 'v') {
+                if (IsSpace(s[1])) {
+                    DirectX::XMFLOAT3 pos(0.0f, 0.0f, 0.0f);
+                    const char* q = s + 2;
+                    ParseFloat(q, lineEnd, pos.x) && ParseFloat(q, lineEnd, pos.y) && ParseFloat(q, lineEnd, pos.z);
+                    chunk.positions.push_back(pos);
+                } else if (s[1] == 'n' && lineEnd - s > 2 && IsSpace(s[2])) {
+                    DirectX::XMFLOAT3 normal(0.0f, 0.0f, 0.0f);
+                    const char* q = s + 3;
+                    ParseFloat(q, lineEnd, normal.x) && ParseFloat(q, lineEnd, normal.y) && ParseFloat(q, lineEnd, normal.z);
+                    chunk.normals.push_back(normal);
+                } else if (s[1] == 't' && lineEnd - s > 2 && IsSpace(s[2])) {
+                    DirectX::XMFLOAT2 texCoord(0.0f, 0.0f);
+                    const char* q = s + 3;
+                    ParseFloat(q, lineEnd, texCoord.x) && ParseFloat(q, lineEnd, texCoord.y);
+                    chunk.texCoords.push_back(texCoord);
+                }
+            }
+            else if (s[0] == 'f' && IsSpace(s[1])) {
+                // 顶点格式：p、p/t、p//n、p/t/n；缺省分量为 0。每个顶点压入 p t n + 相对索引位（3 位）
+                polygon.clear();
+                const char* q = s + 2;
+                while (true) {
+                    q = SkipSpaces(q, lineEnd);
+                    if (q >= lineEnd || *q == '\r') break;
+
+                    int indices[3] = { 0, 0, 0 };
+                    if (!ParseInt(q, lineEnd, indices[0])) break;
+                    for (int component = 1; component < 3 && q < lineEnd && *q == '/'; ++component) {
+                        ++q;
+                        ParseInt(q, lineEnd, indices[component]);   // "p//n" 中间为空
+                    }
+                    // 跳过无法识别的残余字符
+                    while (q < lineEnd && !IsSpace(*q) && *q != '\r') ++q;
+
+                    const size_t counts[3] = { chunk.positions.size(), chunk.texCoords.size(), chunk.normals.size() };
+                    int relativeBits = 0;
+                    for (int component = 0; component < 3; ++component) {
+                        if (indices[component] < 0) {
+                            indices[component] = static_cast<int>(counts[component]) + indices[component] + 1;
+                            relativeBits |= 1 << component;
+                        }
+                        polygon.push_back(indices[component]);
+                    }
+                    polygon.push_back(relativeBits);
+                }
+
+                // 三角化：把多边形分成三角形 (fan triangulation)
+                // 例如四边形 [0,1,2,3] -> 三角形 [0,1,2] 和 [0,2,3]
+                const size_t vertexCount = polygon.size() / 4;
+                for (size_t i = 1; i + 1 < vertexCount; ++i) {
+                    const size_t corners[3] = { 0, i, i + 1 };
+                    uint16_t relativeMask = 0;
+                    for (int corner = 0; corner < 3; ++corner) {
+                        const int* vertex = &polygon[corners[corner] * 4];
+                        chunk.faceIndices.insert(chunk.faceIndices.end(), vertex, vertex + 3);
+                        relativeMask |= static_cast<uint16_t>(vertex[3] << (corner * 3));
+                    }
+                    if (relativeMask != 0) {
+                        chunk.relativeFixups.emplace_back(chunk.FaceCount() - 1, relativeMask);
+                    }
+                }
+            }
+            else if (s[0] == 'u' && StartsWith(s, lineEnd, "usemtl", 6)) {
+                chunk.materialRuns.push_back({ chunk.FaceCount(), ParseName(s + 6, lineEnd) });
+            }
+            else if (s[0] == 'm' && StartsWith(s, lineEnd, "mtllib", 6)) {
+                chunk.materialLibraries.push_back(ParseName(s + 6, lineEnd));
+            }
+        }
+    }
+    /**
+     * @brief 把 [data, data + size) 按行边界切成 chunkCount 块（每块都从行首开始）
+     */
+    std::vector<std::pair<const char*, const char*>> SplitAtLines(const char* data, size_t size, size_t chunkCount) {
+        std::vector<std::pair<const char*, const char*>> ranges;
+        const char* end = data + size;
+        const char* begin = data;
+        for (size_t i = 1; i <= chunkCount && begin < end; ++i) {
+            const char* split = i == chunkCount ? end : data + size * i / chunkCount;
+            if (split < begin) split = begin;
+            if (split < end) {
+                split = FindLineEnd(split, end);
+                if (split < end) ++split;
+            }
+            ranges.emplace_back(begin, split);
+            begin = split;
+        }
+        return ranges;
+    }
+}
+
+bool OBJLoader::LoadFromFile(const std::string& filename, Mesh& mesh, bool optimize) {
     std::cout << "[OBJLoader] Starting load: " << filename << std::endl;
+
+    const uint64_t cacheKey = MeshCache::GetInstance().HashSource(filename, MeshCache::SourceKind::OBJ, optimize ? 1u : 0u);
+    if (MeshCache::GetInstance().Read(cacheKey, mesh)) {
+        DebugManager::GetInstance().Log("OBJLoader", "Loaded OBJ from mesh cache: " + filename);
+        return true;
+    }
     
     std::vector<DirectX::XMFLOAT3> positions;
     std::vector<DirectX::XMFLOAT3> normals;
@@ -28,31 +233,48 @@ bool OBJLoader::LoadFromFile(const std::string& filename, Mesh& mesh) {
               << texCoords.size() << " texcoords, "
               << faces.size() << " triangles" << std::endl;
 
+    PROFILE_SCOPE("OBJLoader::BuildVertices");
+
     // Convert to mesh vertices and indices
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
 
-    // Use a map to avoid duplicate vertices
-    std::unordered_map<std::string, uint32_t> vertexMap;
+    // 按索引三元组去重；唯一顶点数至少是属性数组中最长的一个，按此预留避免反复 rehash
+    const size_t expectedVertices = (std::max)({ positions.size(), normals.size(), texCoords.size() });
+    std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertexMap;
+    vertexMap.reserve(expectedVertices);
+    vertices.reserve(expectedVertices);
+    indices.reserve(faces.size() * 3);
+
+    const int positionCount = static_cast<int>(positions.size());
+    const int texCoordCount = static_cast<int>(texCoords.size());
+    const int normalCount = static_cast<int>(normals.size());
+    size_t skippedFaces = 0;
 
     for (const auto& face : faces) {
-        for (int i = 0; i < 3; ++i) {
-            std::string key = std::to_string(face.positionIndices[i]) + "/" +
-                            std::to_string(face.texCoordIndices[i]) + "/" +
-                            std::to_string(face.normalIndices[i]);
+        // 位置索引越界的三角形整个丢弃（损坏的文件不能读越界）
+        if (face.positionIndices[0] <= 0 || face.positionIndices[0] > positionCount ||
+            face.positionIndices[1] <= 0 || face.positionIndices[1] > positionCount ||
+            face.positionIndices[2] <= 0 || face.positionIndices[2] > positionCount) {
+            skippedFaces++;
+            continue;
+        }
 
-            if (vertexMap.find(key) == vertexMap.end()) {
+        for (int i = 0; i < 3; ++i) {
+            const VertexKey key{ face.positionIndices[i], face.texCoordIndices[i], face.normalIndices[i] };
+            const auto inserted = vertexMap.try_emplace(key, static_cast<uint32_t>(vertices.size()));
+            if (inserted.second) {
                 Vertex vertex;
-                vertex.position = positions[face.positionIndices[i] - 1]; // OBJ indices are 1-based
+                vertex.position = positions[key.position - 1]; // OBJ indices are 1-based
 
-                if (face.texCoordIndices[i] > 0 && face.texCoordIndices[i] <= texCoords.size()) {
-                    vertex.texCoord = texCoords[face.texCoordIndices[i] - 1];
+                if (key.texCoord > 0 && key.texCoord <= texCoordCount) {
+                    vertex.texCoord = texCoords[key.texCoord - 1];
                 } else {
                     vertex.texCoord = DirectX::XMFLOAT2(0.0f, 0.0f);
                 }
 
-                if (face.normalIndices[i] > 0 && face.normalIndices[i] <= normals.size()) {
-                    vertex.normal = normals[face.normalIndices[i] - 1];
+                if (key.normal > 0 && key.normal <= normalCount) {
+                    vertex.normal = normals[key.normal - 1];
                 } else {
                     vertex.normal = DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f);
                 }
@@ -67,20 +289,29 @@ bool OBJLoader::LoadFromFile(const std::string& filename, Mesh& mesh) {
                     1.0f
                 );
 
-                vertexMap[key] = static_cast<uint32_t>(vertices.size());
                 vertices.push_back(vertex);
             }
 
-            indices.push_back(vertexMap[key]);
+            indices.push_back(inserted.first->second);
         }
     }
 
+    if (skippedFaces > 0) {
+        DebugManager::GetInstance().Log("OBJLoader", "Skipped " + std::to_string(skippedFaces) +
+            " triangles with out-of-range position indices: " + filename);
+    }
+
     mesh.SetVertices(vertices);
     mesh.SetIndices(indices);
+    mesh.SetVertexFormat(Mesh::SelectVertexFormat(vertices));
+    if (optimize) {
+        MeshOptimizer::Optimize(mesh);
+    }
 
     DebugManager::GetInstance().Log("OBJLoader", "Loaded OBJ file: " + filename);
     DebugManager::GetInstance().Log("OBJLoader", "Vertices: " + std::to_string(vertices.size()) + ", Indices: " + std::to_string(indices.size()));
 
+    MeshCache::GetInstance().Write(cacheKey, mesh);
     return true;
 }
 
@@ -90,126 +321,126 @@ bool OBJLoader::ParseOBJFile(const std::string& filename,
                            std::vector<DirectX::XMFLOAT2>& texCoords,
                            std::vector<OBJFace>& faces,
                            std::unordered_map<std::string, DirectX::XMFLOAT3>& materials) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    PROFILE_SCOPE("OBJLoader::Parse");
+
+    auto file = MappedFile::Open(filename);
+    if (!file) {
         std::cerr << "Failed to open OBJ file: " << filename << std::endl;
         return false;
     }
+    const char* data = reinterpret_cast<const char*>(file->Data());
+    const size_t size = file->Size();
 
-    // 解析MTL文件以获取材质颜色
-    std::string mtlFile;
-    std::string currentMaterial = "default";
-    DirectX::XMFLOAT3 currentColor(1.0f, 1.0f, 1.0f);
+    // 大文件按行边界切块并行解析；每块独立累积，之后按文件顺序拼接
+    size_t chunkCount = 1;
+    auto& jobs = JobSystem::GetInstance();
+    if (s_ParallelParsing && jobs.IsInitialized() && size >= kParallelThresholdBytes) {
+        chunkCount = (std::min)(static_cast<size_t>(jobs.GetWorkerCount()) + 1, size / kMinChunkBytes);
+        chunkCount = (std::max)(chunkCount, static_cast<size_t>(1));
+    }
+    const auto ranges = SplitAtLines(data, size, chunkCount);
+    std::vector<OBJChunk> chunks(ranges.size());
+    jobs.ParallelFor(static_cast<uint32_t>(ranges.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            ParseChunk(ranges[i].first, ranges[i].second, chunks[i]);
+        }
+    });
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+    // 拼接：属性数组直接追加；面索引中的相对索引加上前面各块的元素数
+    size_t totalPositions = 0, totalNormals = 0, totalTexCoords = 0, totalFaces = 0;
+    for (const auto& chunk : chunks) {
+        totalPositions += chunk.positions.size();
+        totalNormals += chunk.normals.size();
+        totalTexCoords += chunk.texCoords.size();
+        totalFaces += chunk.FaceCount();
+    }
+    positions.reserve(positions.size() + totalPositions);
+    normals.reserve(normals.size() + totalNormals);
+    texCoords.reserve(texCoords.size() + totalTexCoords);
+    faces.reserve(faces.size() + totalFaces);
 
-        if (type == "mtllib") {
-            iss >> mtlFile;
-            // 读取MTL文件
-            std::string mtlPath = filename.substr(0, filename.find_last_of("/\\") + 1) + mtlFile;
-            ParseMTLForColors(mtlPath, materials);
-        }
-        else if (type == "usemtl") {
-            iss >> currentMaterial;
-            if (materials.find(currentMaterial) != materials.end()) {
-                currentColor = materials[currentMaterial];
-            } else {
-                currentColor = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+    std::vector<MaterialRun> runs;          // 全局三角形序号
+    std::vector<std::string> libraries;
+    for (auto& chunk : chunks) {
+        const int bases[3] = {
+            static_cast<int>(positions.size()), static_cast<int>(texCoords.size()), static_cast<int>(normals.size())
+        };
+        const size_t faceBase = faces.size();
+
+        for (const auto& fixup : chunk.relativeFixups) {
+            int* face = &chunk.faceIndices[fixup.first * 9];
+            for (int bit = 0; bit < 9; ++bit) {
+                if (fixup.second & (1u << bit)) face[bit] += bases[bit % 3];
             }
         }
-        else if (type == "v") {
-            DirectX::XMFLOAT3 pos;
-            iss >> pos.x >> pos.y >> pos.z;
-            positions.push_back(pos);
-        }
-        else if (type == "vn") {
-            DirectX::XMFLOAT3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
-            normals.push_back(normal);
+
+        const size_t faceCount = chunk.FaceCount();
+        for (size_t f = 0; f < faceCount; ++f) {
+            const int* source = &chunk.faceIndices[f * 9];
+            OBJFace face;
+            for (int corner = 0; corner < 3; ++corner) {
+                face.positionIndices[corner] = source[corner * 3 + 0];
+                face.texCoordIndices[corner] = source[corner * 3 + 1];
+                face.normalIndices[corner] = source[corner * 3 + 2];
+            }
+            faces.push_back(face);
         }
-        else if (type == "vt") {
-            DirectX::XMFLOAT2 texCoord;
-            iss >> texCoord.x >> texCoord.y;
-            texCoords.push_back(texCoord);
+
+        positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+        normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+
+        for (auto& run : chunk.materialRuns) {
+            runs.push_back({ faceBase + run.firstFace, std::move(run.name) });
         }
-        else if (type == "f") {
-            // 读取所有顶点（可能是三角形、四边形或多边形）
-            std::vector<int> posIndices, texIndices, normIndices;
-            std::string vertexStr;
-            
-            while (iss >> vertexStr) {
-                std::replace(vertexStr.begin(), vertexStr.end(), '/', ' ');
-                std::istringstream vertexIss(vertexStr);
-                
-                int posIdx = 0, texIdx = 0, normIdx = 0;
-                vertexIss >> posIdx;
-                if (vertexIss.peek() != EOF) {
-                    vertexIss >> texIdx;
-                }
-                if (vertexIss.peek() != EOF) {
-                    vertexIss >> normIdx;
-                }
-                
-                posIndices.push_back(posIdx);
-                texIndices.push_back(texIdx);
-                normIndices.push_back(normIdx);
-            }
-            
-            // 三角化：把多边形分成三角形 (fan triangulation)
-            // 例如四边形 [0,1,2,3] -> 三角形 [0,1,2] 和 [0,2,3]
-            for (size_t i = 1; i + 1 < posIndices.size(); ++i) {
-                OBJFace face = {};
-                face.materialColor = currentColor;
-                
-                // 第一个顶点总是 0
-                face.positionIndices[0] = posIndices[0];
-                face.texCoordIndices[0] = texIndices[0];
-                face.normalIndices[0] = normIndices[0];
-                
-                // 第二个顶点是 i
-                face.positionIndices[1] = posIndices[i];
-                face.texCoordIndices[1] = texIndices[i];
-                face.normalIndices[1] = normIndices[i];
-                
-                // 第三个顶点是 i+1
-                face.positionIndices[2] = posIndices[i + 1];
-                face.texCoordIndices[2] = texIndices[i + 1];
-                face.normalIndices[2] = normIndices[i + 1];
-                
-                faces.push_back(face);
+        for (auto& library : chunk.materialLibraries) {
+            if (std::find(libraries.begin(), libraries.end(), library) == libraries.end()) {
+                libraries.push_back(std::move(library));
             }
         }
     }
 
-    file.close();
+    // 解析MTL文件以获取材质颜色（全部 mtllib 读完后再按 usemtl 区间着色）
+    const std::string directory = filename.substr(0, filename.find_last_of("/\\") + 1);
+    for (const auto& library : libraries) {
+        ParseMTLForColors(directory + library, materials);
+    }
+
+    // 第一个 usemtl 之前、以及找不到的材质：白色
+    for (size_t r = 0; r < runs.size(); ++r) {
+        const auto it = materials.find(runs[r].name);
+        if (it == materials.end()) continue;
+        const size_t last = r + 1 < runs.size() ? runs[r + 1].firstFace : faces.size();
+        for (size_t f = runs[r].firstFace; f < last; ++f) {
+            faces[f].materialColor = it->second;
+        }
+    }
     return true;
 }
 
 void OBJLoader::ParseMTLForColors(const std::string& mtlPath, 
                                  std::unordered_map<std::string, DirectX::XMFLOAT3>& materials) {
-    std::ifstream file(mtlPath);
-    if (!file.is_open()) {
+    auto file = MappedFile::Open(mtlPath);
+    if (!file) {
         DebugManager::GetInstance().Log("OBJLoader", "MTL file not found: " + mtlPath);
         return;
     }
 
+    const char* p = reinterpret_cast<const char*>(file->Data());
+    const char* end = p + file->Size();
     std::string currentMtl;
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
-
-        if (type == "newmtl") {
-            iss >> currentMtl;
+    while (p < end) {
+        const char* lineEnd = FindLineEnd(p, end);
+        const char* s = SkipSpaces(p, lineEnd);
+        p = lineEnd < end ? lineEnd + 1 : end;
+
+        if (StartsWith(s, lineEnd, "newmtl", 6)) {
+            currentMtl = ParseName(s + 6, lineEnd);
         }
-        else if (type == "Kd" && !currentMtl.empty()) {
-            DirectX::XMFLOAT3 color;
-            iss >> color.x >> color.y >> color.z;
+        else if (StartsWith(s, lineEnd, "Kd", 2) && !currentMtl.empty()) {
+            DirectX::XMFLOAT3 color(0.0f, 0.0f, 0.0f);
+            const char* q = s + 2;
+            ParseFloat(q, lineEnd, color.x) && ParseFloat(q, lineEnd, color.y) && ParseFloat(q, lineEnd, color.z);
             materials[currentMtl] = color;
             DebugManager::GetInstance().Log("OBJLoader", 
                 "Material " + currentMtl + " color: (" + 
@@ -218,8 +449,7 @@ void OBJLoader::ParseMTLForColors(const std::string& mtlPath,
                 std::to_string(color.z) + ")");
         }
     }
-    file.close();
 }
 
 } // namespace resources
-} // namespace outer_wilds
\ No newline at end of file
+} // namespace outer_wilds
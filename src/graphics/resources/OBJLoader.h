@@ -1,5 +1,7 @@
 #pragma once
 #include "Mesh.h"
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -8,17 +10,30 @@
 namespace outer_wilds {
 namespace resources {
 
+/**
+ * OBJ 加载器
+ *
+ * 源文件经 MappedFile 映射后直接在视图上逐行扫描（std::from_chars 解析数字，不经过 iostream）；
+ * 大文件按行边界切块，在 JobSystem 上并行解析后按顺序拼接。
+ * 顶点按 (位置, UV, 法线) 索引三元组去重。
+ */
 class OBJLoader {
 public:
-    static bool LoadFromFile(const std::string& filename, Mesh& mesh);
+    /**
+     * @param optimize 运行 MeshOptimizer（顶点缓存/过度绘制/顶点拉取优化 + 16 位索引）
+     */
+    static bool LoadFromFile(const std::string& filename, Mesh& mesh, bool optimize = true);
 
-private:
-    struct OBJVertex {
-        DirectX::XMFLOAT3 position;
-        DirectX::XMFLOAT3 normal;
-        DirectX::XMFLOAT2 texCoord;
-    };
+    /**
+     * @brief 大文件分块并行解析（默认开启；MicroBenchmark 关闭它来对比单线程）
+     */
+    static void SetParallelParsing(bool enabled) { s_ParallelParsing = enabled; }
+    static bool IsParallelParsing() { return s_ParallelParsing; }
+
+    /** 小于该大小的文件始终单线程解析 */
+    static constexpr size_t kParallelThresholdBytes = 4u * 1024u * 1024u;
 
+private:
     struct OBJFace {
         int positionIndices[3];
         int normalIndices[3];
@@ -26,6 +41,10 @@ private:
         DirectX::XMFLOAT3 materialColor = {1.0f, 1.0f, 1.0f};  // MTL文件中的Kd颜色
     };
 
+    /**
+     * @brief 解析 OBJ：输出的面索引已是 1-based 绝对索引（负数相对索引已换算），
+     *        materialColor 按 usemtl 从 MTL 中取得
+     */
     static bool ParseOBJFile(const std::string& filename,
                            std::vector<DirectX::XMFLOAT3>& positions,
                            std::vector<DirectX::XMFLOAT3>& normals,
@@ -35,7 +54,9 @@ private:
     
     static void ParseMTLForColors(const std::string& mtlPath,
                                  std::unordered_map<std::string, DirectX::XMFLOAT3>& materials);
+
+    static bool s_ParallelParsing;
 };
 
 } // namespace resources
-} // namespace outer_wilds
\ No newline at end of file
+} // namespace outer_wilds
@@ -0,0 +1,577 @@
+#include "ResourceCache.h"
+#include "TextureLoader.h"
+#include "TextureArrayAtlas.h"
+#include "TextureStreamer.h"
+#include "../../core/DebugManager.h"
+#include "../../core/JobSystem.h"
+#include "../../core/MemoryTracker.h"
+#include <d3d11.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <unordered_set>
+
+namespace outer_wilds {
+namespace resources {
+
+namespace {
+    // shaderProgram 是 albedoTextureSRV 的旧别名，不单独计
+    void CollectTextures(const Material& material, std::unordered_set<void*>& out) {
+        void* const slots[] = {
+            material.albedoTextureSRV, material.normalTextureSRV, material.metallicTextureSRV,
+            material.roughnessTextureSRV, material.emissiveTextureSRV,
+        };
+        for (void* srv : slots) {
+            if (srv) out.insert(srv);
+        }
+    }
+
+    /** @brief 缓存键中的源文件路径（第一个 '|' 之前） */
+    std::string SourceOfKey(const std::string& key) {
+        return key.substr(0, key.find('|'));
+    }
+
+    /** @brief 可比较的路径：绝对、规范化、'/' 分隔、小写（Windows 路径不区分大小写） */
+    std::string NormalizePath(const std::string& path) {
+        std::error_code ec;
+        std::filesystem::path normalized = std::filesystem::weakly_canonical(path, ec);
+        if (ec) normalized = std::filesystem::path(path).lexically_normal();
+        std::string result = normalized.generic_string();
+        std::transform(result.begin(), result.end(), result.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return result;
+    }
+}
+
+std::string ResourceCache::MakeModelKey(const std::string& path, const ModelLoadOptions& options) {
+    std::string key = path;
+    key += options.skipBoundsCalculation ? "|nobounds" : "";
+    key += options.fastLoad ? "|fast" : "";
+    key += options.optimizeMeshes ? "|opt" : "";
+    return key;
+}
+
+std::shared_ptr<const LoadedModel> ResourceCache::AcquireModel(const std::string& key, const ModelLoadFn& load) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Models.find(key);
+        if (it != m_Models.end()) {
+            m_Hits++;
+            return it->second;
+        }
+        m_Misses++;
+    }
+
+    OW_MEMORY_SCOPE(Meshes);
+    auto model = std::make_shared<LoadedModel>();
+    if (!load(*model) || !model->mesh) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CPUReleasePending = true;
+    m_ModelLoaders.emplace(key, load);
+    return m_Models.emplace(key, std::move(model)).first->second;
+}
+
+std::shared_ptr<const MultiMaterialModel> ResourceCache::AcquireMultiMaterialModel(const std::string& key,
+                                                                                   const MultiModelLoadFn& load) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_MultiModels.find(key);
+        if (it != m_MultiModels.end()) {
+            m_Hits++;
+            return it->second;
+        }
+        m_Misses++;
+    }
+
+    OW_MEMORY_SCOPE(Meshes);
+    auto model = std::make_shared<MultiMaterialModel>();
+    if (!load(*model) || model->subMeshes.empty()) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CPUReleasePending = true;
+    m_MultiModelLoaders.emplace(key, load);
+    return m_MultiModels.emplace(key, std::move(model)).first->second;
+}
+
+std::shared_ptr<Material> ResourceCache::AcquireMaterial(const std::string& key,
+                                                         const std::function<std::shared_ptr<Material>()>& create) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Materials.find(key);
+        if (it != m_Materials.end()) {
+            m_Hits++;
+            return it->second;
+        }
+        m_Misses++;
+    }
+
+    // 工厂可能再调用 AcquireTexture，必须在锁外执行
+    std::shared_ptr<Material> material = create();
+    if (!material) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto inserted = m_Materials.emplace(key, material);
+    if (!inserted.second) {
+        // 另一个线程同时创建了同一材质
+        ReleasePrivateTextures(*material);
+    }
+    return inserted.first->second;
+}
+
+ID3D11ShaderResourceView* ResourceCache::AcquireTexture(ID3D11Device* device, const std::string& path,
+                                                        TextureUsage usage) {
+    if (!device || path.empty()) return nullptr;
+    const std::string key = path + "|" + std::to_string(static_cast<int>(usage));
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Textures.find(key);
+        if (it != m_Textures.end()) {
+            m_Hits++;
+            return it->second;
+        }
+        m_Misses++;
+    }
+
+    OW_MEMORY_SCOPE(Textures);
+    // 有烘焙缓存的纹理以流式方式加载（先只创建低分辨率 mip），否则整张加载
+    auto& streamer = TextureStreamer::GetInstance();
+    ID3D11ShaderResourceView* srv = nullptr;
+    if (!streamer.Load(device, path, usage, &srv) &&
+        !TextureLoader::LoadFromFile(device, path, &srv, true, usage)) {
+        return nullptr;
+    }
+
+    return InsertTexture(key, srv);
+}
+
+ID3D11ShaderResourceView* ResourceCache::InsertTexture(const std::string& key, ID3D11ShaderResourceView* srv) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto inserted = m_Textures.emplace(key, srv);
+    if (!inserted.second) {
+        // 另一个线程同时加载了同一纹理
+        TextureStreamer::GetInstance().Unregister(srv);
+        srv->Release();
+    }
+    return inserted.first->second;
+}
+
+std::string ResourceCache::MakeEmbeddedTextureKey(const EmbeddedTexture& texture, TextureUsage usage) {
+    // 与烘焙缓存同一个内容哈希；未压缩的 RGBA 数据再带上尺寸
+    const uint64_t hash = TextureCooker::HashSource(texture.data.data(), texture.data.size(), usage, true);
+    char key[64];
+    snprintf(key, sizeof(key), "embedded:%016llx:%ux%u|%d", static_cast<unsigned long long>(hash),
+             texture.isCompressed ? 0u : texture.width, texture.isCompressed ? 0u : texture.height,
+             static_cast<int>(usage));
+    return key;
+}
+
+ID3D11ShaderResourceView* ResourceCache::AcquireEmbeddedTexture(ID3D11Device* device, const EmbeddedTexture& texture,
+                                                                TextureUsage usage) {
+    if (!device || texture.data.empty()) return nullptr;
+    const std::string key = MakeEmbeddedTextureKey(texture, usage);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Textures.find(key);
+        if (it != m_Textures.end()) {
+            m_Hits++;
+            return it->second;
+        }
+        m_Misses++;
+    }
+
+    OW_MEMORY_SCOPE(Textures);
+    ID3D11ShaderResourceView* srv = nullptr;
+    if (!AssimpLoader::CreateTextureFromEmbedded(device, texture, &srv, usage)) {
+        return nullptr;
+    }
+    return InsertTexture(key, srv);
+}
+
+void ResourceCache::PrefetchEmbeddedTextures(
+    ID3D11Device* device, const std::vector<std::pair<const EmbeddedTexture*, TextureUsage>>& textures) {
+    if (!device) return;
+
+    // 1. 去重并筛掉已缓存的（只有压缩格式需要解码；原始 RGBA 留给 AcquireEmbeddedTexture）
+    struct Pending {
+        std::string key;
+        const EmbeddedTexture* texture = nullptr;
+        TextureUsage usage = TextureUsage::Color;
+        TextureLoader::DecodedImage image;
+        bool decoded = false;
+    };
+    std::vector<Pending> pending;
+    {
+        std::unordered_set<std::string> seen;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const auto& request : textures) {
+            if (!request.first || request.first->data.empty() || !request.first->isCompressed) continue;
+            std::string key = MakeEmbeddedTextureKey(*request.first, request.second);
+            if (m_Textures.count(key) || !seen.insert(key).second) continue;
+            Pending entry;
+            entry.key = std::move(key);
+            entry.texture = request.first;
+            entry.usage = request.second;
+            pending.push_back(std::move(entry));
+        }
+    }
+    if (pending.empty()) return;
+
+    // 2. 并行解码（WIC + 烘焙，不触碰 D3D）
+    JobSystem::GetInstance().ParallelFor(static_cast<uint32_t>(pending.size()), 1,
+        [&pending](uint32_t begin, uint32_t end) {
+            OW_MEMORY_SCOPE(Textures);     // 工作线程不继承调用线程的分类
+            for (uint32_t i = begin; i < end; i++) {
+                Pending& entry = pending[i];
+                entry.decoded = TextureLoader::DecodeImage(entry.texture->data.data(), entry.texture->data.size(),
+                                                           entry.image, true, entry.usage,
+                                                           "[embedded " + entry.texture->formatHint + "]");
+            }
+        });
+
+    // 3. 在调用线程上创建 SRV（RGBA 回退的 GenerateMips 需要立即上下文）
+    uint32_t created = 0;
+    for (Pending& entry : pending) {
+        ID3D11ShaderResourceView* srv = nullptr;
+        if (!entry.decoded || !TextureLoader::CreateFromDecoded(device, entry.image, &srv, true)) {
+            continue;
+        }
+        InsertTexture(entry.key, srv);
+        created++;
+    }
+    DebugManager::GetInstance().Log("ResourceCache", "Decoded " + std::to_string(created) + "/" +
+                                    std::to_string(pending.size()) + " embedded textures in parallel");
+}
+
+components::MeshLODChain ResourceCache::AcquireLODChain(const std::shared_ptr<Mesh>& mesh,
+                                                        const std::function<components::MeshLODChain()>& build) {
+    if (!mesh) return {};
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_LODChains.find(mesh.get());
+        // 地址可能被已释放的 Mesh 复用：确认仍是同一实例
+        if (it != m_LODChains.end() && it->second.source.lock() == mesh) {
+            m_Hits++;
+            return it->second.chain;
+        }
+        m_Misses++;
+    }
+
+    components::MeshLODChain chain;
+    {
+        OW_MEMORY_SCOPE(Meshes);
+        chain = build();
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CPUReleasePending = true;
+    LODEntry& entry = m_LODChains[mesh.get()];
+    entry.source = mesh;
+    entry.chain = chain;
+    return chain;
+}
+
+std::vector<ResourceCache::ModelReload> ResourceCache::FindModelsBySource(const std::string& path) const {
+    std::vector<ModelReload> candidates;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const auto& entry : m_ModelLoaders) {
+            if (m_Models.count(entry.first)) candidates.push_back({ entry.first, entry.second, nullptr });
+        }
+        for (const auto& entry : m_MultiModelLoaders) {
+            if (m_MultiModels.count(entry.first)) candidates.push_back({ entry.first, nullptr, entry.second });
+        }
+    }
+
+    // 路径规范化要访问文件系统，不持锁
+    const std::string source = NormalizePath(path);
+    std::vector<ModelReload> matches;
+    for (auto& candidate : candidates) {
+        if (NormalizePath(SourceOfKey(candidate.key)) == source) matches.push_back(std::move(candidate));
+    }
+    return matches;
+}
+
+std::vector<ResourceCache::TextureReload> ResourceCache::FindTexturesBySource(const std::string& path) const {
+    std::vector<std::string> keys;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const auto& entry : m_Textures) {
+            if (entry.first.compare(0, 9, "embedded:") != 0) keys.push_back(entry.first);
+        }
+    }
+
+    const std::string source = NormalizePath(path);
+    std::vector<TextureReload> matches;
+    for (const auto& key : keys) {
+        // 键：<路径>|<TextureUsage>
+        const size_t separator = key.find_last_of('|');
+        if (separator == std::string::npos) continue;
+        const std::string texturePath = key.substr(0, separator);
+        if (NormalizePath(texturePath) != source) continue;
+
+        TextureReload reload;
+        reload.key = key;
+        reload.path = texturePath;
+        reload.usage = static_cast<TextureUsage>(std::atoi(key.c_str() + separator + 1));
+        matches.push_back(std::move(reload));
+    }
+    return matches;
+}
+
+std::shared_ptr<const LoadedModel> ResourceCache::ReplaceModel(const std::string& key,
+                                                               std::shared_ptr<LoadedModel> model) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Models.find(key);
+    if (it == m_Models.end() || !model || !model->mesh) {
+        // 重新加载期间条目已被 Trim：新结果没有用处
+        if (model && model->mesh) ReleaseMeshBuffers(*model->mesh);
+        return nullptr;
+    }
+    std::shared_ptr<LoadedModel> previous = std::move(it->second);
+    it->second = std::move(model);
+    m_CPUReleasePending = true;
+    m_RetiredMeshes.push_back(previous->mesh);
+    return previous;
+}
+
+std::shared_ptr<const MultiMaterialModel> ResourceCache::ReplaceMultiMaterialModel(
+    const std::string& key, std::shared_ptr<MultiMaterialModel> model) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_MultiModels.find(key);
+    if (it == m_MultiModels.end() || !model || model->subMeshes.empty()) {
+        if (model) {
+            for (const auto& subMesh : model->subMeshes) ReleaseMeshBuffers(*subMesh.mesh);
+        }
+        return nullptr;
+    }
+    std::shared_ptr<MultiMaterialModel> previous = std::move(it->second);
+    it->second = std::move(model);
+    m_CPUReleasePending = true;
+    for (const auto& subMesh : previous->subMeshes) m_RetiredMeshes.push_back(subMesh.mesh);
+    return previous;
+}
+
+std::vector<const Material*> ResourceCache::ReplaceTexture(const std::string& key, ID3D11ShaderResourceView* srv) {
+    std::vector<const Material*> changed;
+    if (!srv) return changed;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Textures.find(key);
+    if (it == m_Textures.end()) {
+        srv->Release();
+        return changed;
+    }
+    ID3D11ShaderResourceView* previous = it->second;
+    it->second = srv;
+
+    // 共享材质原地换槽位：Material 实例不变，使用它的实体只需重建批次
+    for (const auto& entry : m_Materials) {
+        Material& material = *entry.second;
+        void** const slots[] = {
+            &material.albedoTextureSRV, &material.normalTextureSRV, &material.metallicTextureSRV,
+            &material.roughnessTextureSRV, &material.emissiveTextureSRV, &material.shaderProgram,
+        };
+        bool modified = false;
+        for (void** slot : slots) {
+            if (*slot == previous) {
+                *slot = srv;
+                modified = true;
+            }
+        }
+        if (modified) {
+            // 图集里是旧贴图的副本：退回独立贴图（重建批次后换成非数组排列）
+            TextureArrayAtlas::GetInstance().Unpack(material);
+            changed.push_back(&material);
+        }
+    }
+
+    TextureStreamer::GetInstance().Unregister(previous);
+    previous->Release();
+    return changed;
+}
+
+void ResourceCache::EnsureGPUBuffers(ID3D11Device* device, Mesh& mesh) {
+    // 加载线程可能同时拿到同一个共享 Mesh：只允许一个线程上传
+    static std::mutex s_UploadMutex;
+    std::lock_guard<std::mutex> lock(s_UploadMutex);
+    if (!mesh.vertexBuffer) {
+        mesh.CreateGPUBuffers(device);
+    }
+}
+
+uint32_t ResourceCache::ReleaseUploadedCPUData() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_ReleaseCPUMeshData || !m_CPUReleasePending) return 0;
+
+    // 尚未上传的 Mesh 保持待处理，下一次再试
+    uint32_t released = 0;
+    bool pending = false;
+    auto release = [&](Mesh& mesh) {
+        if (!mesh.HasCPUData()) return;
+        if (mesh.ReleaseCPUData()) {
+            released++;
+        } else {
+            pending = true;
+        }
+    };
+    for (auto& entry : m_Models) release(*entry.second->mesh);
+    for (auto& entry : m_MultiModels) {
+        for (auto& subMesh : entry.second->subMeshes) release(*subMesh.mesh);
+    }
+    for (auto& entry : m_LODChains) {
+        for (auto& level : entry.second.chain.levels) release(*level);
+    }
+    m_CPUReleasePending = pending;
+
+    if (released > 0) {
+        DebugManager::GetInstance().Log("ResourceCache", "Released CPU mesh data of " + std::to_string(released) +
+                                        " uploaded meshes");
+    }
+    return released;
+}
+
+void ResourceCache::ReleaseMeshBuffers(Mesh& mesh) {
+    mesh.ReleaseGPUBuffers();
+}
+
+void ResourceCache::ReleasePrivateTextures(const Material& material) const {
+    std::unordered_set<void*> textures;
+    CollectTextures(material, textures);
+    for (const auto& entry : m_Textures) {
+        textures.erase(entry.second);
+    }
+    for (void* srv : textures) {
+        static_cast<ID3D11ShaderResourceView*>(srv)->Release();
+    }
+}
+
+uint32_t ResourceCache::Trim() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    uint32_t evicted = 0;
+
+    // use_count == 1：只剩缓存自己的引用（实体的 MeshComponent 已全部销毁）
+    for (auto it = m_Models.begin(); it != m_Models.end();) {
+        if (it->second.use_count() == 1 && it->second->mesh.use_count() == 1) {
+            ReleaseMeshBuffers(*it->second->mesh);
+            m_ModelLoaders.erase(it->first);
+            it = m_Models.erase(it);
+            evicted++;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = m_MultiModels.begin(); it != m_MultiModels.end();) {
+        bool unused = it->second.use_count() == 1;
+        for (const auto& subMesh : it->second->subMeshes) {
+            unused = unused && subMesh.mesh.use_count() == 1;
+        }
+        if (unused) {
+            for (const auto& subMesh : it->second->subMeshes) ReleaseMeshBuffers(*subMesh.mesh);
+            m_MultiModelLoaders.erase(it->first);
+            it = m_MultiModels.erase(it);
+            evicted++;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = m_RetiredMeshes.begin(); it != m_RetiredMeshes.end();) {
+        if (it->use_count() == 1) {
+            ReleaseMeshBuffers(**it);
+            it = m_RetiredMeshes.erase(it);
+            evicted++;
+        } else {
+            ++it;
+        }
+    }
+
+    // LOD 链随源 Mesh 一起回收（放在模型之后：本轮刚释放的模型的链也一并回收）
+    for (auto it = m_LODChains.begin(); it != m_LODChains.end();) {
+        if (it->second.source.expired()) {
+            for (const auto& level : it->second.chain.levels) {
+                if (level.use_count() == 1) ReleaseMeshBuffers(*level);
+            }
+            it = m_LODChains.erase(it);
+            evicted++;
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto it = m_Materials.begin(); it != m_Materials.end();) {
+        if (it->second.use_count() == 1) {
+            ReleasePrivateTextures(*it->second);
+            it = m_Materials.erase(it);
+            evicted++;
+        } else {
+            ++it;
+        }
+    }
+
+    // 纹理：不再被任何缓存材质引用即释放
+    std::unordered_set<void*> referenced;
+    for (const auto& entry : m_Materials) {
+        CollectTextures(*entry.second, referenced);
+    }
+    for (auto it = m_Textures.begin(); it != m_Textures.end();) {
+        if (!referenced.count(it->second)) {
+            TextureStreamer::GetInstance().Unregister(it->second);
+            it->second->Release();
+            it = m_Textures.erase(it);
+            evicted++;
+        } else {
+            ++it;
+        }
+    }
+
+    m_Evictions += evicted;
+    if (evicted > 0) {
+        DebugManager::GetInstance().Log("ResourceCache", "Trimmed " + std::to_string(evicted) + " unused entries");
+    }
+    return evicted;
+}
+
+void ResourceCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ReleaseAll();
+}
+
+void ResourceCache::ReleaseAll() {
+    for (auto& entry : m_Models) ReleaseMeshBuffers(*entry.second->mesh);
+    for (auto& entry : m_MultiModels) {
+        for (auto& subMesh : entry.second->subMeshes) ReleaseMeshBuffers(*subMesh.mesh);
+    }
+    for (auto& mesh : m_RetiredMeshes) ReleaseMeshBuffers(*mesh);
+    for (auto& entry : m_LODChains) {
+        for (auto& level : entry.second.chain.levels) ReleaseMeshBuffers(*level);
+    }
+    for (auto& entry : m_Materials) ReleasePrivateTextures(*entry.second);
+    TextureStreamer::GetInstance().Clear();
+    for (auto& entry : m_Textures) entry.second->Release();
+
+    m_Models.clear();
+    m_MultiModels.clear();
+    m_ModelLoaders.clear();
+    m_MultiModelLoaders.clear();
+    m_RetiredMeshes.clear();
+    m_LODChains.clear();
+    m_Materials.clear();
+    m_Textures.clear();
+}
+
+ResourceCache::Stats ResourceCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats stats;
+    stats.models = static_cast<uint32_t>(m_Models.size() + m_MultiModels.size());
+    stats.materials = static_cast<uint32_t>(m_Materials.size());
+    stats.textures = static_cast<uint32_t>(m_Textures.size());
+    stats.lodChains = static_cast<uint32_t>(m_LODChains.size());
+    stats.hits = m_Hits;
+    stats.misses = m_Misses;
+    stats.evictions = m_Evictions;
+    return stats;
+}
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,209 @@
+/**
+ * ResourceCache.h
+ *
+ * 运行时共享资源缓存：同一路径 + 选项的模型只导入一次、只创建一次 GPU 缓冲，
+ * 同一纹理只创建一个 SRV，同一组纹理只创建一个 Material。
+ *
+ * - SceneAssetLoader 的所有加载入口都经过这里：SolarSystemBuilder 中共用模型/纹理的天体、
+ *   LoadModelWithRadius 的"先取包围盒再加载"两次导入都只付一次代价
+ * - 共享的 Mesh / Material 使相同资源的实体可以合并到同一实例化批次
+ * - 引用计数回收：Trim() 释放只剩缓存自己持有的条目（连同 GPU 缓冲、SRV）；Clear() 在关闭时全部释放
+ *
+ * 约定：缓存交出的 Mesh / Material 是共享的，调用方不要修改（需要私有参数时复制一份）。
+ * 线程安全：查找和插入加锁；工厂函数在锁外执行。
+ *
+ * 内存：SetReleaseCPUMeshData(true) 时，已上传的模型 Mesh 在主线程上释放 CPU 顶点 / 索引
+ * （Mesh::ReleaseCPUData；碰撞数据在 LoadedModel 中单独保存）。
+ *
+ * 热重载（AssetHotReloader）：按源文件路径找出受影响的条目，在加载线程上重新加载，
+ * 再在主线程上用 Replace* 原地替换（纹理换进共享 Material 的槽位，模型换掉缓存条目）。
+ */
+
+#pragma once
+#include "AssimpLoader.h"
+#include "Material.h"
+#include "TextureCooker.h"
+#include "../components/MeshComponent.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+
+class ResourceCache {
+public:
+    struct Stats {
+        uint32_t models = 0;
+        uint32_t materials = 0;
+        uint32_t textures = 0;
+        uint32_t lodChains = 0;
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t evictions = 0;
+    };
+
+    static ResourceCache& GetInstance() {
+        static ResourceCache instance;
+        return instance;
+    }
+
+    using ModelLoadFn = std::function<bool(LoadedModel&)>;
+    using MultiModelLoadFn = std::function<bool(MultiMaterialModel&)>;
+
+    /** @brief 热重载：一个来自已变化源文件的模型条目 */
+    struct ModelReload {
+        std::string key;
+        ModelLoadFn load;              // 单网格条目
+        MultiModelLoadFn loadMulti;    // 多材质条目
+    };
+
+    /** @brief 热重载：一个来自已变化源文件的纹理条目 */
+    struct TextureReload {
+        std::string key;
+        std::string path;
+        TextureUsage usage = TextureUsage::Color;
+    };
+
+    /**
+     * @brief 缓存键：路径 + 影响结果的选项（verbose 等纯日志选项不参与）
+     *
+     * 模型和纹理的键都以源文件路径开头、以 '|' 分隔后缀（热重载按此找回源文件）
+     */
+    static std::string MakeModelKey(const std::string& path, const ModelLoadOptions& options);
+
+    /**
+     * @brief 单网格模型（Assimp 合并网格或 OBJ）
+     * @param load 未命中时调用，返回 false 表示加载失败（不缓存）；
+     *             缓存保留一份用于热重载，必须按值捕获
+     */
+    std::shared_ptr<const LoadedModel> AcquireModel(const std::string& key, const ModelLoadFn& load);
+
+    /** @brief 多材质模型（每个材质一个子网格） */
+    std::shared_ptr<const MultiMaterialModel> AcquireMultiMaterialModel(const std::string& key,
+                                                                        const MultiModelLoadFn& load);
+
+    /**
+     * @brief 材质（键由调用方按纹理组合生成）
+     * @param create 未命中时调用；返回的 Material 直接创建的 SRV（非 AcquireTexture）归该材质所有
+     */
+    std::shared_ptr<Material> AcquireMaterial(const std::string& key,
+                                              const std::function<std::shared_ptr<Material>()>& create);
+
+    /**
+     * @brief 纹理 SRV（路径 + 用途），失败返回 nullptr；SRV 归缓存所有，调用方不要 Release
+     *
+     * 已烘焙的纹理交给 TextureStreamer：返回的是常驻的低分辨率 SRV，绘制时由 TextureStreamer::Resolve 换成高分辨率级别
+     */
+    ID3D11ShaderResourceView* AcquireTexture(ID3D11Device* device, const std::string& path, TextureUsage usage);
+
+    /**
+     * @brief 内嵌纹理 SRV（按内容哈希 + 用途去重：多个材质 / 实例共用的贴图只解码一次）；SRV 归缓存所有
+     */
+    ID3D11ShaderResourceView* AcquireEmbeddedTexture(ID3D11Device* device, const EmbeddedTexture& texture,
+                                                     TextureUsage usage);
+
+    /**
+     * @brief 一次性准备一个模型的全部内嵌纹理：未缓存的在 JobSystem 工作线程上并行解码（去重后），
+     *        解码完成后在调用线程上创建 SRV；之后的 AcquireEmbeddedTexture 直接命中
+     */
+    void PrefetchEmbeddedTextures(ID3D11Device* device,
+                                  const std::vector<std::pair<const EmbeddedTexture*, TextureUsage>>& textures);
+
+    /**
+     * @brief Mesh 的 LOD 链（按 Mesh 实例缓存，共享同一 Mesh 的实体共享同一条 LOD 链）
+     */
+    components::MeshLODChain AcquireLODChain(const std::shared_ptr<Mesh>& mesh,
+                                             const std::function<components::MeshLODChain()>& build);
+
+    /**
+     * @brief 为尚未上传的 Mesh 创建 GPU 缓冲（缓存共享的 Mesh 只上传一次；可在加载线程上调用）
+     */
+    static void EnsureGPUBuffers(ID3D11Device* device, Mesh& mesh);
+
+    /**
+     * @brief 上传后释放缓存模型（含 LOD 级别）的 CPU 顶点 / 索引；默认关闭
+     *
+     * 打开后 LOD 链只能在释放之前生成（ScenePreloader / 加载时），之后新建的实体只用 LOD 0
+     */
+    void SetReleaseCPUMeshData(bool enabled) { m_ReleaseCPUMeshData = enabled; }
+    bool IsReleaseCPUMeshDataEnabled() const { return m_ReleaseCPUMeshData; }
+
+    /**
+     * @brief 对新插入且已上传的 Mesh 执行 ReleaseCPUData（Engine::Update，AssetStreamer 没有在途任务时）
+     * @return 本次释放的 Mesh 数
+     */
+    uint32_t ReleaseUploadedCPUData();
+
+    /** @brief 热重载：源文件为 path 的模型条目（连同加载函数） */
+    std::vector<ModelReload> FindModelsBySource(const std::string& path) const;
+
+    /** @brief 热重载：源文件为 path 的纹理条目（内嵌纹理不在其中） */
+    std::vector<TextureReload> FindTexturesBySource(const std::string& path) const;
+
+    /**
+     * @brief 热重载：替换模型条目（主线程）
+     * @return 被替换的旧模型；它的 Mesh 退役，不再被引用后由 Trim 释放 GPU 缓冲
+     */
+    std::shared_ptr<const LoadedModel> ReplaceModel(const std::string& key, std::shared_ptr<LoadedModel> model);
+    std::shared_ptr<const MultiMaterialModel> ReplaceMultiMaterialModel(const std::string& key,
+                                                                        std::shared_ptr<MultiMaterialModel> model);
+
+    /**
+     * @brief 热重载：替换纹理条目并更新所有引用旧 SRV 的缓存材质（主线程，在 RenderQueue 收集之前）
+     * @return 被修改的材质（调用方让使用它们的实体重建批次）
+     */
+    std::vector<const Material*> ReplaceTexture(const std::string& key, ID3D11ShaderResourceView* srv);
+
+    /**
+     * @brief 释放只被缓存持有的条目（销毁实体 / 切换场景之后调用）
+     * @return 释放的条目数
+     */
+    uint32_t Trim();
+
+    /** @brief 释放全部条目（Engine::Shutdown；此后仍被引用的 Mesh 不再有 GPU 缓冲） */
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    ResourceCache() = default;
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    struct LODEntry {
+        std::weak_ptr<Mesh> source;
+        components::MeshLODChain chain;
+    };
+
+    static std::string MakeEmbeddedTextureKey(const EmbeddedTexture& texture, TextureUsage usage);
+    /** @brief 插入纹理表（另一个线程已插入同一键时释放 srv，返回表中的那个） */
+    ID3D11ShaderResourceView* InsertTexture(const std::string& key, ID3D11ShaderResourceView* srv);
+    static void ReleaseMeshBuffers(Mesh& mesh);
+    /** @brief 释放材质私有的 SRV（不在纹理表中的） */
+    void ReleasePrivateTextures(const Material& material) const;
+    void ReleaseAll();
+
+    mutable std::mutex m_Mutex;
+    std::unordered_map<std::string, std::shared_ptr<LoadedModel>> m_Models;
+    std::unordered_map<std::string, std::shared_ptr<MultiMaterialModel>> m_MultiModels;
+    std::unordered_map<std::string, ModelLoadFn> m_ModelLoaders;           // 热重载用
+    std::unordered_map<std::string, MultiModelLoadFn> m_MultiModelLoaders;
+    std::vector<std::shared_ptr<Mesh>> m_RetiredMeshes;                      // 热重载替换下来的 Mesh
+    std::unordered_map<std::string, std::shared_ptr<Material>> m_Materials;
+    std::unordered_map<std::string, ID3D11ShaderResourceView*> m_Textures;
+    std::unordered_map<const Mesh*, LODEntry> m_LODChains;
+    uint32_t m_Hits = 0;
+    uint32_t m_Misses = 0;
+    uint32_t m_Evictions = 0;
+    bool m_ReleaseCPUMeshData = false;
+    bool m_CPUReleasePending = false;     // 有新条目可能需要释放 CPU 数据（避免每帧遍历）
+};
+
+} // namespace resources
+} // namespace outer_wilds
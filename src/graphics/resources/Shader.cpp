@@ -1,17 +1,188 @@
 #include "Shader.h"
 #include "../../core/DebugManager.h"
+#include "../../core/Profiler.h"
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <filesystem>
+#include <cstdio>
+#include <cstring>
 
 namespace outer_wilds {
 namespace resources {
 
+// ============================================================================
+// 编译结果缓存
+// 1. 构建时预编译的 shaders/compiled/<name>.<entry>.cso（CMake shaders 目标，需比 .hlsl 新）
+//    排列变体为 <name>.<entry>.p<permutation>.cso
+// 2. 运行时编译结果的磁盘缓存 cache/shaders/<hash>.cso（按源码 + 入口 + profile + 编译选项 + 排列哈希）
+// 3. D3DCompile（结果写入 2）
+// ============================================================================
+
+static const char* kShaderCacheDirectory = "cache/shaders";
+static constexpr UINT kShaderCompileFlags = D3DCOMPILE_ENABLE_STRICTNESS;
+
+// ShaderPermutation 位 → HLSL 宏名（顺序与位一致；CMakeLists.txt 的 SHADER_PERMUTATION_DEFINES 也按此顺序）
+static const char* const kPermutationDefines[] = {
+    "HAS_ALBEDO_MAP",
+    "HAS_NORMAL_MAP",
+    "HAS_METALLIC_MAP",
+    "HAS_ROUGHNESS_MAP",
+    "HAS_EMISSIVE_MAP",
+    "HAS_VERTEX_COLOR",
+    "HAS_TEXTURE_ARRAY",
+};
+static constexpr uint32_t kPermutationBits = sizeof(kPermutationDefines) / sizeof(kPermutationDefines[0]);
+static_assert((1u << kPermutationBits) == kPermutationCount,
+              "kPermutationDefines must cover every ShaderPermutation bit");
+
+static uint64_t HashShaderSource(const std::string& hlslCode, const char* entryPoint, const char* target,
+                                 uint32_t permutation) {
+    // FNV-1a 64
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](const char* data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 0x100000001b3ull;
+        }
+    };
+    mix(hlslCode.data(), hlslCode.size());
+    mix(entryPoint, strlen(entryPoint) + 1);
+    mix(target, strlen(target) + 1);
+    mix(reinterpret_cast<const char*>(&kShaderCompileFlags), sizeof(kShaderCompileFlags));
+    mix(reinterpret_cast<const char*>(&permutation), sizeof(permutation));
+    return hash;
+}
+
+static ID3DBlob* ReadBytecodeFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    std::streamsize size = file.tellg();
+    if (size <= 0) {
+        return nullptr;
+    }
+    file.seekg(0, std::ios::beg);
+
+    ID3DBlob* blob = nullptr;
+    if (FAILED(D3DCreateBlob(static_cast<SIZE_T>(size), &blob))) {
+        return nullptr;
+    }
+    if (!file.read(static_cast<char*>(blob->GetBufferPointer()), size)) {
+        blob->Release();
+        return nullptr;
+    }
+    return blob;
+}
+
+static void WriteBytecodeFile(const std::string& path, ID3DBlob* blob) {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return;
+        }
+        file.write(static_cast<const char*>(blob->GetBufferPointer()), static_cast<std::streamsize>(blob->GetBufferSize()));
+        if (!file) {
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+ID3DBlob* Shader::LoadOrCompileStage(const std::string& hlslCode, const std::string& hlslFile,
+                                     const char* entryPoint, const char* target, uint32_t permutation) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+
+    const bool permuted = permutation != kNoPermutation;
+    const std::string permutationTag = permuted ? ".p" + std::to_string(permutation) : std::string();
+
+    // === 1. 构建时预编译字节码 ===
+    fs::path sourcePath(hlslFile);
+    fs::path precompiledPath = sourcePath.parent_path() / "compiled" /
+                               (sourcePath.stem().string() + "." + entryPoint + permutationTag + ".cso");
+    if (fs::exists(precompiledPath, ec)) {
+        // .hlsl 在构建后被修改时忽略过期的 .cso
+        auto sourceTime = fs::last_write_time(sourcePath, ec);
+        auto compiledTime = fs::last_write_time(precompiledPath, ec);
+        if (!ec && compiledTime >= sourceTime) {
+            if (ID3DBlob* blob = ReadBytecodeFile(precompiledPath.string())) {
+                OW_LOG_DEBUG("Shader", "Loaded precompiled {}", precompiledPath.string());
+                return blob;
+            }
+        }
+    }
+
+    // === 2. 运行时磁盘缓存 ===
+    char cacheName[32];
+    snprintf(cacheName, sizeof(cacheName), "%016llx.cso",
+             static_cast<unsigned long long>(HashShaderSource(hlslCode, entryPoint, target, permutation)));
+    const std::string cachePath = std::string(kShaderCacheDirectory) + "/" + cacheName;
+    if (ID3DBlob* blob = ReadBytecodeFile(cachePath)) {
+        OW_LOG_DEBUG("Shader", "Loaded cached {}:{}{}", hlslFile, entryPoint, permutationTag);
+        return blob;
+    }
+
+    // === 3. 运行时编译 ===
+    // 排列：SHADER_PERMUTATION=1 + 每个 HAS_* 宏定义为 0/1（着色器用 #if 判断）
+    D3D_SHADER_MACRO macros[kPermutationBits + 2] = {};
+    if (permuted) {
+        macros[0] = { "SHADER_PERMUTATION", "1" };
+        for (uint32_t bit = 0; bit < kPermutationBits; bit++) {
+            macros[bit + 1] = { kPermutationDefines[bit], (permutation & (1u << bit)) ? "1" : "0" };
+        }
+    }
+
+    PROFILE_SCOPE("Shader::D3DCompile");
+    ID3DBlob* blob = nullptr;
+    ID3DBlob* errorBlob = nullptr;
+    HRESULT hr = D3DCompile(
+        hlslCode.c_str(),
+        hlslCode.size(),
+        hlslFile.c_str(),
+        permuted ? macros : nullptr,
+        D3D_COMPILE_STANDARD_FILE_INCLUDE,
+        entryPoint,
+        target,
+        kShaderCompileFlags,
+        0,
+        &blob,
+        &errorBlob
+    );
+
+    if (FAILED(hr)) {
+        if (errorBlob) {
+            DebugManager::GetInstance().Log("Shader", std::string(entryPoint) + permutationTag + " compilation failed: " +
+                std::string((char*)errorBlob->GetBufferPointer()));
+            errorBlob->Release();
+        }
+        return nullptr;
+    }
+    if (errorBlob) errorBlob->Release();
+
+    WriteBytecodeFile(cachePath, blob);
+    return blob;
+}
+
 Shader::Shader() = default;
 
 Shader::~Shader() {
+    if (compactInstancedInputLayout) compactInstancedInputLayout->Release();
+    if (compactInstancedVertexShader) compactInstancedVertexShader->Release();
+    if (compactInputLayout) compactInputLayout->Release();
+    if (compactVertexShader) compactVertexShader->Release();
+    if (instancedInputLayout) instancedInputLayout->Release();
+    if (instancedVertexShader) instancedVertexShader->Release();
     if (inputLayout) inputLayout->Release();
     if (pixelShader) pixelShader->Release();
     if (vertexShader) vertexShader->Release();
@@ -22,8 +193,14 @@ bool Shader::LoadFromFile(ID3D11Device* device, const std::string& vertexPath, c
 }
 
 bool Shader::LoadFromFile(ID3D11Device* device, const std::string& vertexPath, const std::string& pixelPath, bool positionOnly) {
+    return LoadFromFile(device, vertexPath, pixelPath, positionOnly, kNoPermutation);
+}
+
+bool Shader::LoadFromFile(ID3D11Device* device, const std::string& vertexPath, const std::string& pixelPath,
+                          bool positionOnly, uint32_t permutation) {
     m_VertexPath = vertexPath;
     m_PixelPath = pixelPath;
+    m_Permutation = permutation;
 
     // ============================================
     // IMPORTANT: Shader Loading Strategy
@@ -192,16 +369,9 @@ bool Shader::LoadEmbeddedGridShader(ID3D11Device* device) {
     return true;
 }
 
-bool Shader::LoadFromHLSLFile(ID3D11Device* device, const std::string& vsPath, const std::string& psPath, bool positionOnly) {
-    // ============================================
-    // Construct HLSL file path from shader name
-    // ============================================
-    // Example: "textured.vs" → "shaders/textured.hlsl"
-    // Both vertex and pixel shaders are in the same .hlsl file
-    // ============================================
-    
-    std::string baseName = vsPath;
-    // Remove .vs or .ps extension, expect .hlsl
+bool Shader::ReadHLSLSource(const std::string& shaderName, std::string& outFile, std::string& outCode) {
+    std::string baseName = shaderName;
+    // Remove .vs / .ps / .cs extension, expect .hlsl
     size_t dotPos = baseName.find_last_of('.');
     if (dotPos != std::string::npos) {
         baseName = baseName.substr(0, dotPos);
@@ -215,13 +385,11 @@ bool Shader::LoadFromHLSLFile(ID3D11Device* device, const std::string& vsPath, c
         "C:/Users/kkakk/homework/OuterWilds/shaders/" + baseName + ".hlsl"  // 绝对路径兜底
     };
     
-    std::string hlslFile;
     std::ifstream file;
-    
     for (const auto& path : searchPaths) {
         file.open(path);
         if (file.is_open()) {
-            hlslFile = path;
+            outFile = path;
             break;
         }
     }
@@ -234,73 +402,74 @@ bool Shader::LoadFromHLSLFile(ID3D11Device* device, const std::string& vsPath, c
         return false;
     }
     
-    std::string hlslCode((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    outCode.assign((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
     file.close();
     
-    if (hlslCode.empty()) {
-        DebugManager::GetInstance().Log("Shader", "HLSL file is empty: " + hlslFile);
+    if (outCode.empty()) {
+        DebugManager::GetInstance().Log("Shader", "HLSL file is empty: " + outFile);
         return false;
     }
     
-    DebugManager::GetInstance().Log("Shader", "Loaded HLSL file: " + hlslFile + " (" + std::to_string(hlslCode.size()) + " bytes)");
+    DebugManager::GetInstance().Log("Shader", "Loaded HLSL file: " + outFile + " (" + std::to_string(outCode.size()) + " bytes)");
+    return true;
+}
+
+ID3D11ComputeShader* Shader::LoadComputeShader(ID3D11Device* device, const std::string& computePath,
+                                               const char* entryPoint) {
+    if (!device) return nullptr;
     
-    // Compile vertex shader
-    ID3DBlob* vsBlob = nullptr;
-    ID3DBlob* psBlob = nullptr;
-    ID3DBlob* errorBlob = nullptr;
+    std::string hlslFile;
+    std::string hlslCode;
+    if (!ReadHLSLSource(computePath, hlslFile, hlslCode)) {
+        return nullptr;
+    }
     
-    HRESULT hr = D3DCompile(
-        hlslCode.c_str(),
-        hlslCode.size(),
-        hlslFile.c_str(),
-        nullptr,
-        D3D_COMPILE_STANDARD_FILE_INCLUDE,
-        "VSMain",
-        "vs_5_0",
-        D3DCOMPILE_ENABLE_STRICTNESS,
-        0,
-        &vsBlob,
-        &errorBlob
-    );
+    ID3DBlob* csBlob = LoadOrCompileStage(hlslCode, hlslFile, entryPoint, "cs_5_0");
+    if (!csBlob) {
+        DebugManager::GetInstance().Log("Shader", "Failed to compile compute shader from: " + hlslFile);
+        return nullptr;
+    }
     
+    ID3D11ComputeShader* computeShader = nullptr;
+    HRESULT hr = device->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &computeShader);
+    csBlob->Release();
     if (FAILED(hr)) {
-        if (errorBlob) {
-            DebugManager::GetInstance().Log("Shader", "Vertex shader compilation failed: " + 
-                std::string((char*)errorBlob->GetBufferPointer()));
-            errorBlob->Release();
-        }
-        DebugManager::GetInstance().Log("Shader", "Failed to compile vertex shader from: " + hlslFile);
+        DebugManager::GetInstance().Log("Shader", "Failed to create compute shader, HRESULT: " + std::to_string(hr));
+        return nullptr;
+    }
+    return computeShader;
+}
+
+bool Shader::LoadFromHLSLFile(ID3D11Device* device, const std::string& vsPath, const std::string& psPath, bool positionOnly) {
+    // ============================================
+    // Construct HLSL file path from shader name
+    // ============================================
+    // Example: "textured.vs" → "shaders/textured.hlsl"
+    // Both vertex and pixel shaders are in the same .hlsl file
+    // ============================================
+    
+    std::string hlslFile;
+    std::string hlslCode;
+    if (!ReadHLSLSource(vsPath, hlslFile, hlslCode)) {
         return false;
     }
     
-    // Compile pixel shader
-    hr = D3DCompile(
-        hlslCode.c_str(),
-        hlslCode.size(),
-        hlslFile.c_str(),
-        nullptr,
-        D3D_COMPILE_STANDARD_FILE_INCLUDE,
-        "PSMain",
-        "ps_5_0",
-        D3DCOMPILE_ENABLE_STRICTNESS,
-        0,
-        &psBlob,
-        &errorBlob
-    );
+    // Compile vertex / pixel shader (precompiled .cso → disk cache → D3DCompile)
+    ID3DBlob* vsBlob = LoadOrCompileStage(hlslCode, hlslFile, "VSMain", "vs_5_0");
+    if (!vsBlob) {
+        DebugManager::GetInstance().Log("Shader", "Failed to compile vertex shader from: " + hlslFile);
+        return false;
+    }
     
-    if (FAILED(hr)) {
-        if (errorBlob) {
-            DebugManager::GetInstance().Log("Shader", "Pixel shader compilation failed: " + 
-                std::string((char*)errorBlob->GetBufferPointer()));
-            errorBlob->Release();
-        }
-        if (vsBlob) vsBlob->Release();
+    ID3DBlob* psBlob = LoadOrCompileStage(hlslCode, hlslFile, "PSMain", "ps_5_0", m_Permutation);
+    if (!psBlob) {
+        vsBlob->Release();
         DebugManager::GetInstance().Log("Shader", "Failed to compile pixel shader from: " + hlslFile);
         return false;
     }
     
     // Create shader objects
-    hr = device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &vertexShader);
+    HRESULT hr = device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &vertexShader);
     if (FAILED(hr)) {
         DebugManager::GetInstance().Log("Shader", "Failed to create vertex shader");
         vsBlob->Release();
@@ -358,10 +527,100 @@ bool Shader::LoadFromHLSLFile(ID3D11Device* device, const std::string& vsPath, c
         return false;
     }
     
+    // 可选：对象缓冲区变体（失败不影响普通路径，RenderQueue会回退到逐对象常量缓冲区）
+    if (!positionOnly && hlslCode.find("VSMainInstanced") != std::string::npos) {
+        CreateInstancedVariant(device, hlslCode, hlslFile);
+    }
+    
+    // 可选：压缩顶点布局变体（Mesh VertexFormat::Compact）
+    if (!positionOnly && hlslCode.find("VSMainCompact") != std::string::npos) {
+        CreateCompactVariants(device, hlslCode, hlslFile);
+    }
+    
     DebugManager::GetInstance().Log("Shader", "✅ Successfully loaded shader from: " + hlslFile);
     return true;
 }
 
+bool Shader::CreateVertexVariant(ID3D11Device* device, const std::string& hlslCode, const std::string& hlslFile,
+                                 const char* entryPoint, const D3D11_INPUT_ELEMENT_DESC* layoutDesc, UINT layoutCount,
+                                 ID3D11VertexShader** outShader, ID3D11InputLayout** outLayout) {
+    ID3DBlob* vsBlob = LoadOrCompileStage(hlslCode, hlslFile, entryPoint, "vs_5_0");
+    if (!vsBlob) {
+        DebugManager::GetInstance().Log("Shader", std::string(entryPoint) + " compilation failed: " + hlslFile);
+        return false;
+    }
+    
+    HRESULT hr = device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, outShader);
+    if (FAILED(hr)) {
+        DebugManager::GetInstance().Log("Shader", std::string("Failed to create vertex shader ") + entryPoint);
+        vsBlob->Release();
+        return false;
+    }
+    
+    hr = device->CreateInputLayout(
+        layoutDesc,
+        layoutCount,
+        vsBlob->GetBufferPointer(),
+        vsBlob->GetBufferSize(),
+        outLayout
+    );
+    vsBlob->Release();
+    
+    if (FAILED(hr)) {
+        DebugManager::GetInstance().Log("Shader", std::string("Failed to create input layout for ") + entryPoint);
+        (*outShader)->Release();
+        *outShader = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool Shader::CreateInstancedVariant(ID3D11Device* device, const std::string& hlslCode, const std::string& hlslFile) {
+    // slot 1 为逐实例的对象下标（uint，配合 StartInstanceLocation 索引 RenderQueue 的 ObjectData 结构化缓冲区）
+    D3D11_INPUT_ELEMENT_DESC layoutDesc[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TANGENT", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 32, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 44, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "OBJECT_INDEX", 0, DXGI_FORMAT_R32_UINT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    };
+    
+    if (!CreateVertexVariant(device, hlslCode, hlslFile, "VSMainInstanced", layoutDesc, ARRAYSIZE(layoutDesc),
+                             &instancedVertexShader, &instancedInputLayout)) {
+        return false;
+    }
+    
+    DebugManager::GetInstance().Log("Shader", "Instanced variant created for: " + hlslFile);
+    return true;
+}
+
+bool Shader::CreateCompactVariants(ID3D11Device* device, const std::string& hlslCode, const std::string& hlslFile) {
+    // 与 resources::CompactVertex 一致（28字节）：normal/tangent 为八面体编码，着色器内解码
+    D3D11_INPUT_ELEMENT_DESC layoutDesc[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R16G16_UNORM, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, 20, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 24, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+        { "OBJECT_INDEX", 0, DXGI_FORMAT_R32_UINT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+    };
+    
+    // 常量缓冲区路径不使用 OBJECT_INDEX
+    if (!CreateVertexVariant(device, hlslCode, hlslFile, "VSMainCompact", layoutDesc, ARRAYSIZE(layoutDesc) - 1,
+                             &compactVertexShader, &compactInputLayout)) {
+        return false;
+    }
+    
+    if (hlslCode.find("VSMainCompactInstanced") != std::string::npos) {
+        CreateVertexVariant(device, hlslCode, hlslFile, "VSMainCompactInstanced", layoutDesc, ARRAYSIZE(layoutDesc),
+                            &compactInstancedVertexShader, &compactInstancedInputLayout);
+    }
+    
+    DebugManager::GetInstance().Log("Shader", "Compact vertex variant created for: " + hlslFile);
+    return true;
+}
+
 void Shader::Bind(ID3D11DeviceContext* context) const {
     if (context) {
         context->IASetInputLayout(inputLayout);
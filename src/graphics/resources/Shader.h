@@ -1,10 +1,31 @@
 #pragma once
 #include <string>
+#include <cstdint>
 #include <d3d11.h>
 
 namespace outer_wilds {
 namespace resources {
 
+/**
+ * @brief 像素着色器排列位（编译期预处理宏变体，RenderQueue 按材质实际拥有的纹理选择）
+ *
+ * 每一位对应一个 HLSL 宏（取值 0/1，排列编译时全部定义，另有 SHADER_PERMUTATION=1）：
+ * 没有的纹理不再采样，也不再靠纹理内容做运行时判断。
+ */
+enum ShaderPermutation : uint32_t {
+    kPermutationAlbedoMap    = 1u << 0,    // HAS_ALBEDO_MAP
+    kPermutationNormalMap    = 1u << 1,    // HAS_NORMAL_MAP
+    kPermutationMetallicMap  = 1u << 2,    // HAS_METALLIC_MAP
+    kPermutationRoughnessMap = 1u << 3,    // HAS_ROUGHNESS_MAP
+    kPermutationEmissiveMap  = 1u << 4,    // HAS_EMISSIVE_MAP
+    kPermutationVertexColor  = 1u << 5,    // HAS_VERTEX_COLOR
+    kPermutationTextureArray = 1u << 6,    // HAS_TEXTURE_ARRAY（材质贴图来自 TextureArrayAtlas）
+    kPermutationCount        = 1u << 7,    // 排列总数（CMake shaders 目标按此预编译全部变体）
+};
+
+// 不使用排列系统（着色器按原样编译，不定义任何宏）
+static constexpr uint32_t kNoPermutation = ~0u;
+
 class Shader {
 public:
     Shader();
@@ -14,6 +35,21 @@ public:
     
     // 重载：支持简化顶点格式（仅位置，用于skybox等）
     bool LoadFromFile(ID3D11Device* device, const std::string& vertexPath, const std::string& pixelPath, bool positionOnly);
+
+    /**
+     * @brief 加载像素着色器的一个排列（ShaderPermutation 位组合；kNoPermutation = 不定义宏）
+     * 顶点着色器不受排列影响，按原样编译
+     */
+    bool LoadFromFile(ID3D11Device* device, const std::string& vertexPath, const std::string& pixelPath,
+                      bool positionOnly, uint32_t permutation);
+    uint32_t GetPermutation() const { return m_Permutation; }
+
+    /**
+     * @brief 加载计算着色器（"name.cs" → shaders/name.hlsl，与其它阶段相同的预编译 / 磁盘缓存路径）
+     * @return 着色器（调用方负责 Release），失败返回 nullptr
+     */
+    static ID3D11ComputeShader* LoadComputeShader(ID3D11Device* device, const std::string& computePath,
+                                                  const char* entryPoint = "CSMain");
     
     void Bind(ID3D11DeviceContext* context) const;
     void Unbind(ID3D11DeviceContext* context) const;
@@ -22,17 +58,57 @@ public:
     ID3D11VertexShader* GetVertexShader() const { return vertexShader; }
     ID3D11PixelShader* GetPixelShader() const { return pixelShader; }
     ID3D11InputLayout* GetInputLayout() const { return inputLayout; }
+    
+    // === 对象缓冲区/实例化变体（HLSL中存在VSMainInstanced时才会创建，逐对象数据来自结构化缓冲区） ===
+    ID3D11VertexShader* GetInstancedVertexShader() const { return instancedVertexShader; }
+    ID3D11InputLayout* GetInstancedInputLayout() const { return instancedInputLayout; }
+    bool SupportsInstancing() const { return instancedVertexShader && instancedInputLayout; }
+    
+    // === 压缩顶点布局变体（HLSL中存在VSMainCompact时才会创建，对应 Mesh VertexFormat::Compact） ===
+    ID3D11VertexShader* GetCompactVertexShader() const { return compactVertexShader; }
+    ID3D11InputLayout* GetCompactInputLayout() const { return compactInputLayout; }
+    ID3D11VertexShader* GetCompactInstancedVertexShader() const { return compactInstancedVertexShader; }
+    ID3D11InputLayout* GetCompactInstancedInputLayout() const { return compactInstancedInputLayout; }
+    bool SupportsCompactVertices() const { return compactVertexShader && compactInputLayout; }
 
 private:
     bool LoadEmbeddedGridShader(ID3D11Device* device);
+    /** @brief 按 "name.xx" 在着色器目录中查找 name.hlsl 并读取源码 */
+    static bool ReadHLSLSource(const std::string& shaderName, std::string& outFile, std::string& outCode);
     bool LoadFromHLSLFile(ID3D11Device* device, const std::string& vsPath, const std::string& psPath, bool positionOnly = false);
+    bool CreateInstancedVariant(ID3D11Device* device, const std::string& hlslCode, const std::string& hlslFile);
+    bool CreateCompactVariants(ID3D11Device* device, const std::string& hlslCode, const std::string& hlslFile);
+    bool CreateVertexVariant(ID3D11Device* device, const std::string& hlslCode, const std::string& hlslFile,
+                             const char* entryPoint, const D3D11_INPUT_ELEMENT_DESC* layoutDesc, UINT layoutCount,
+                             ID3D11VertexShader** outShader, ID3D11InputLayout** outLayout);
+
+    /**
+     * @brief 获取单个着色器阶段的字节码
+     * 依次尝试：构建时预编译的 shaders/compiled/<name>.<entry>[.p<permutation>].cso → 运行时磁盘缓存 → D3DCompile
+     * @param permutation 排列位（kNoPermutation 时不定义宏）；参与预编译文件名和缓存哈希
+     * @return 字节码（调用方负责 Release），失败返回 nullptr
+     */
+    static ID3DBlob* LoadOrCompileStage(const std::string& hlslCode, const std::string& hlslFile,
+                                        const char* entryPoint, const char* target,
+                                        uint32_t permutation = kNoPermutation);
 
     std::string m_VertexPath;
     std::string m_PixelPath;
+    uint32_t m_Permutation = kNoPermutation;
 
     ID3D11VertexShader* vertexShader = nullptr;
     ID3D11PixelShader* pixelShader = nullptr;
     ID3D11InputLayout* inputLayout = nullptr;
+    
+    // 对象缓冲区路径：slot 0 = 顶点数据, slot 1 = 逐实例对象下标（OBJECT_INDEX，索引 RenderQueue 的 ObjectData）
+    ID3D11VertexShader* instancedVertexShader = nullptr;
+    ID3D11InputLayout* instancedInputLayout = nullptr;
+    
+    // 压缩顶点布局：slot 0 = CompactVertex（28字节）
+    ID3D11VertexShader* compactVertexShader = nullptr;
+    ID3D11InputLayout* compactInputLayout = nullptr;
+    ID3D11VertexShader* compactInstancedVertexShader = nullptr;
+    ID3D11InputLayout* compactInstancedInputLayout = nullptr;
 };
 
 } // namespace resources
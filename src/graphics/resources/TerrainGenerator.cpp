@@ -1,4 +1,7 @@
 #include "TerrainGenerator.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace outer_wilds {
@@ -111,5 +114,202 @@ void TerrainGenerator::CreateHorizonSphere(Mesh& mesh, float radius, int stacks,
     mesh.SetIndices(indices);
 }
 
+void TerrainGenerator::CreateSphere(Mesh& mesh, float radius, int stacks, int slices) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    vertices.reserve(static_cast<size_t>(stacks + 1) * (slices + 1));
+    indices.reserve(static_cast<size_t>(stacks) * slices * 6);
+
+    for (int i = 0; i <= stacks; ++i) {
+        float phi = DirectX::XM_PI * i / stacks;  // 0 = 北极
+        float y = cosf(phi);
+        float r = sinf(phi);
+
+        for (int j = 0; j <= slices; ++j) {
+            float theta = 2.0f * DirectX::XM_PI * j / slices;
+
+            Vertex vertex;
+            vertex.normal = { r * cosf(theta), y, r * sinf(theta) };
+            vertex.position = { vertex.normal.x * radius, vertex.normal.y * radius, vertex.normal.z * radius };
+            vertex.texCoord = { static_cast<float>(j) / slices, static_cast<float>(i) / stacks };
+            // 切线沿 theta 增大方向
+            vertex.tangent = { -sinf(theta), 0.0f, cosf(theta) };
+            vertices.push_back(vertex);
+        }
+    }
+
+    for (int i = 0; i < stacks; ++i) {
+        for (int j = 0; j < slices; ++j) {
+            uint32_t first = i * (slices + 1) + j;
+            uint32_t second = first + slices + 1;
+
+            indices.push_back(first);
+            indices.push_back(first + 1);
+            indices.push_back(second);
+
+            indices.push_back(second);
+            indices.push_back(first + 1);
+            indices.push_back(second + 1);
+        }
+    }
+
+    mesh.SetVertices(vertices);
+    mesh.SetIndices(indices);
+}
+
+namespace {
+
+// 立方体面坐标系：point = N + u * U + v * V，且 U x V = N（保证所有面的三角形绕序一致）
+struct CubeFaceAxes {
+    double n[3];
+    double u[3];
+    double v[3];
+};
+
+constexpr CubeFaceAxes kCubeFaces[6] = {
+    { {  1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },  // +X
+    { { -1, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 } },  // -X
+    { { 0,  1, 0 }, { 0, 0, 1 }, { 1, 0, 0 } },  // +Y
+    { { 0, -1, 0 }, { 1, 0, 0 }, { 0, 0, 1 } },  // -Y
+    { { 0, 0,  1 }, { 1, 0, 0 }, { 0, 1, 0 } },  // +Z
+    { { 0, 0, -1 }, { 0, 1, 0 }, { 1, 0, 0 } },  // -Z
+};
+
+} // namespace
+
+DirectX::XMFLOAT3 TerrainGenerator::CubeFaceToDirection(int face, double u, double v) {
+    const CubeFaceAxes& axes = kCubeFaces[(std::min)((std::max)(face, 0), 5)];
+    double x = axes.n[0] + u * axes.u[0] + v * axes.v[0];
+    double y = axes.n[1] + u * axes.u[1] + v * axes.v[1];
+    double z = axes.n[2] + u * axes.u[2] + v * axes.v[2];
+    double invLength = 1.0 / std::sqrt(x * x + y * y + z * z);
+    return DirectX::XMFLOAT3(static_cast<float>(x * invLength), static_cast<float>(y * invLength),
+                             static_cast<float>(z * invLength));
+}
+
+void TerrainGenerator::CreateCubeSpherePatch(Mesh& mesh, const CubeSpherePatchDesc& desc) {
+    using namespace DirectX;
+
+    const int n = (std::max)(desc.resolution, 1);
+    const int gridStride = n + 3;  // 外扩一圈用于中心差分法线，使相邻补丁边界法线一致
+    const int vertexStride = n + 1;
+
+    std::vector<XMFLOAT3> grid(static_cast<size_t>(gridStride) * gridStride);
+    for (int j = -1; j <= n + 1; ++j) {
+        for (int i = -1; i <= n + 1; ++i) {
+            XMFLOAT3 dir = CubeFaceToDirection(desc.face, desc.u0 + desc.size * i / n,
+                                               desc.v0 + desc.size * j / n);
+            float height = desc.radius;
+            if (desc.heightFunction) {
+                height += desc.heightFunction(dir);
+            }
+            grid[(j + 1) * gridStride + (i + 1)] = XMFLOAT3(dir.x * height, dir.y * height, dir.z * height);
+        }
+    }
+    auto gridAt = [&](int i, int j) { return XMLoadFloat3(&grid[(j + 1) * gridStride + (i + 1)]); };
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    vertices.reserve(static_cast<size_t>(vertexStride) * vertexStride + 4 * vertexStride);
+    indices.reserve(static_cast<size_t>(n) * n * 6 + 4 * n * 6);
+
+    float minU = 1.0f, maxU = 0.0f;
+    for (int j = 0; j <= n; ++j) {
+        for (int i = 0; i <= n; ++i) {
+            XMVECTOR p = gridAt(i, j);
+            XMVECTOR dU = XMVectorSubtract(gridAt(i + 1, j), gridAt(i - 1, j));
+            XMVECTOR dV = XMVectorSubtract(gridAt(i, j + 1), gridAt(i, j - 1));
+            XMVECTOR dir = XMVector3Normalize(p);
+
+            Vertex vertex;
+            XMStoreFloat3(&vertex.position, p);
+            XMStoreFloat3(&vertex.normal, XMVector3Normalize(XMVector3Cross(dU, dV)));
+
+            // 等距柱状投影 UV，与星球模型的球面贴图一致
+            XMFLOAT3 d;
+            XMStoreFloat3(&d, dir);
+            vertex.texCoord.x = 0.5f + std::atan2(d.z, d.x) / XM_2PI;
+            vertex.texCoord.y = std::acos((std::max)(-1.0f, (std::min)(1.0f, d.y))) / XM_PI;
+            minU = (std::min)(minU, vertex.texCoord.x);
+            maxU = (std::max)(maxU, vertex.texCoord.x);
+
+            // 切线沿 U 增大方向（经线切向），两极退化时取 +X
+            float tangentLength = std::sqrt(d.x * d.x + d.z * d.z);
+            vertex.tangent = tangentLength > 1e-5f
+                ? XMFLOAT3(-d.z / tangentLength, 0.0f, d.x / tangentLength)
+                : XMFLOAT3(1.0f, 0.0f, 0.0f);
+
+            vertices.push_back(vertex);
+        }
+    }
+
+    // 跨越 atan2 接缝的补丁：把接缝一侧的 U 平移 1（采样器为 WRAP）
+    if (maxU - minU > 0.5f) {
+        for (auto& vertex : vertices) {
+            if (vertex.texCoord.x < 0.5f) vertex.texCoord.x += 1.0f;
+        }
+    }
+
+    for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+            uint32_t v00 = j * vertexStride + i;
+            uint32_t v10 = v00 + 1;
+            uint32_t v01 = v00 + vertexStride;
+            uint32_t v11 = v01 + 1;
+
+            indices.push_back(v00);
+            indices.push_back(v10);
+            indices.push_back(v01);
+
+            indices.push_back(v10);
+            indices.push_back(v11);
+            indices.push_back(v01);
+        }
+    }
+
+    // 裙边：沿边界环（下 → 右 → 上 → 左）把边顶点向球心下沉，遮挡相邻 LOD 之间的缝隙
+    if (desc.skirtDepth > 0.0f) {
+        std::vector<uint32_t> ring;
+        ring.reserve(4 * n + 1);
+        for (int i = 0; i < n; ++i) ring.push_back(i);                                   // j = 0
+        for (int j = 0; j < n; ++j) ring.push_back(j * vertexStride + n);                // i = n
+        for (int i = n; i > 0; --i) ring.push_back(n * vertexStride + i);                // j = n
+        for (int j = n; j > 0; --j) ring.push_back(j * vertexStride);                    // i = 0
+        ring.push_back(ring.front());
+
+        const uint32_t skirtBase = static_cast<uint32_t>(vertices.size());
+        for (size_t k = 0; k + 1 < ring.size(); ++k) {
+            Vertex skirt = vertices[ring[k]];
+            XMVECTOR p = XMLoadFloat3(&skirt.position);
+            p = XMVectorSubtract(p, XMVectorScale(XMVector3Normalize(p), desc.skirtDepth));
+            XMStoreFloat3(&skirt.position, p);
+            vertices.push_back(skirt);
+        }
+
+        const uint32_t ringCount = static_cast<uint32_t>(ring.size() - 1);
+        for (uint32_t k = 0; k < ringCount; ++k) {
+            uint32_t e0 = ring[k];
+            uint32_t e1 = ring[k + 1];
+            uint32_t s0 = skirtBase + k;
+            uint32_t s1 = skirtBase + (k + 1) % ringCount;
+
+            indices.push_back(e0);
+            indices.push_back(s0);
+            indices.push_back(e1);
+
+            indices.push_back(e1);
+            indices.push_back(s0);
+            indices.push_back(s1);
+        }
+    }
+
+    MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+
+    mesh.SetVertices(vertices);
+    mesh.SetIndices(indices);
+    mesh.SetVertexFormat(Mesh::SelectVertexFormat(vertices));
+    mesh.SetIndexFormat(vertices.size() <= 0xFFFF ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT);
+}
+
 } // namespace resources
 } // namespace outer_wilds
\ No newline at end of file
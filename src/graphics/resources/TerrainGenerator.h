@@ -1,10 +1,27 @@
 #pragma once
 #include "Mesh.h"
 #include <DirectXMath.h>
+#include <functional>
 
 namespace outer_wilds {
 namespace resources {
 
+/**
+ * @brief 立方体球补丁参数
+ * 面 face（0..5 = +X,-X,+Y,-Y,+Z,-Z）上 [u0, u0+size] x [v0, v0+size] 的区域（面坐标范围 [-1,1]），
+ * 投影到半径 radius 的球面上
+ */
+struct CubeSpherePatchDesc {
+    int face = 0;
+    double u0 = -1.0;
+    double v0 = -1.0;
+    double size = 2.0;
+    int resolution = 32;          // 每边格子数
+    float radius = 1.0f;
+    float skirtDepth = 0.0f;      // 裙边向球心下沉的深度（0 = 无裙边）
+    std::function<float(const DirectX::XMFLOAT3& direction)> heightFunction;  // 可为空
+};
+
 class TerrainGenerator {
 public:
     // Create a simple grid-based ground plane
@@ -12,6 +29,15 @@ public:
 
     // Create a simple horizon sphere (distant sky)
     static void CreateHorizonSphere(Mesh& mesh, float radius = 500.0f, int stacks = 8, int slices = 16);
+
+    // Create a full UV sphere (outward normals; procedural stress scenes, debug bodies)
+    static void CreateSphere(Mesh& mesh, float radius = 1.0f, int stacks = 16, int slices = 24);
+
+    // Create one quadtree patch of a cube-sphere planet (CPU data only, safe on worker threads)
+    static void CreateCubeSpherePatch(Mesh& mesh, const CubeSpherePatchDesc& desc);
+
+    // Map a cube face coordinate (face, u, v in [-1,1]) to a unit direction
+    static DirectX::XMFLOAT3 CubeFaceToDirection(int face, double u, double v);
 };
 
 } // namespace resources
@@ -0,0 +1,311 @@
+#include "TextureArrayAtlas.h"
+#include "Material.h"
+#include "TextureStreamer.h"
+#include "core/DebugManager.h"
+#include "graphics/GpuMemory.h"
+#include <algorithm>
+#include <string>
+
+namespace outer_wilds {
+namespace resources {
+
+bool TextureArrayAtlas::DescribeSource(ID3D11ShaderResourceView* srv, PageKey& outKey, ID3D11Texture2D** outTexture) {
+    *outTexture = nullptr;
+
+    // 流式纹理的基础 SRV 在绘制前会被 Resolve 换成更高的级别，复制进数组就固定在基础分辨率了
+    if (TextureStreamer::GetInstance().IsManaged(srv)) {
+        return false;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+    srv->GetDesc(&viewDesc);
+    if (viewDesc.ViewDimension != D3D11_SRV_DIMENSION_TEXTURE2D) {
+        return false;
+    }
+
+    ID3D11Resource* resource = nullptr;
+    srv->GetResource(&resource);
+    if (!resource) {
+        return false;
+    }
+    ID3D11Texture2D* texture = nullptr;
+    HRESULT hr = resource->QueryInterface(__uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&texture));
+    resource->Release();
+    if (FAILED(hr) || !texture) {
+        return false;
+    }
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    texture->GetDesc(&desc);
+    // 视图必须覆盖完整的 mip 链（否则数组层的采样结果与原贴图不同）
+    const bool fullChain = viewDesc.Texture2D.MostDetailedMip == 0 &&
+                           (viewDesc.Texture2D.MipLevels == static_cast<UINT>(-1) ||
+                            viewDesc.Texture2D.MipLevels == desc.MipLevels);
+    if (desc.ArraySize != 1 || desc.SampleDesc.Count != 1 || desc.Usage == D3D11_USAGE_STAGING || !fullChain ||
+        desc.Width > kMaxPackedDimension || desc.Height > kMaxPackedDimension) {
+        texture->Release();
+        return false;
+    }
+
+    outKey.width = desc.Width;
+    outKey.height = desc.Height;
+    outKey.mipLevels = desc.MipLevels;
+    outKey.format = desc.Format;
+    outKey.viewFormat = viewDesc.Format;
+    *outTexture = texture;
+    return true;
+}
+
+bool TextureArrayAtlas::CreatePageLocked(ID3D11Device* device, const PageKey& key) {
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = key.width;
+    desc.Height = key.height;
+    desc.MipLevels = key.mipLevels;
+    desc.ArraySize = 1;
+    desc.Format = key.format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    // 层数固定：D3D11 数组不能扩容，按单层字节数把整页控制在 kPageBudgetBytes 左右
+    const uint64_t sliceBytes = (std::max)(GpuMemory::EstimateTextureBytes(desc), uint64_t(1));
+    const uint32_t capacity = static_cast<uint32_t>(
+        (std::min)((std::max)(kPageBudgetBytes / sliceBytes, uint64_t(kMinPageSlices)), uint64_t(kMaxPageSlices)));
+    desc.ArraySize = capacity;
+
+    ID3D11Texture2D* texture = nullptr;
+    HRESULT hr = device->CreateTexture2D(&desc, nullptr, &texture);
+    if (FAILED(hr)) {
+        DebugManager::GetInstance().Log("TextureArrayAtlas", "Failed to create texture array, HRESULT: " + std::to_string(hr));
+        return false;
+    }
+    GpuMemory::Track(texture);
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+    viewDesc.Format = key.viewFormat;
+    viewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    viewDesc.Texture2DArray.MostDetailedMip = 0;
+    viewDesc.Texture2DArray.MipLevels = key.mipLevels;
+    viewDesc.Texture2DArray.FirstArraySlice = 0;
+    viewDesc.Texture2DArray.ArraySize = capacity;
+    ID3D11ShaderResourceView* srv = nullptr;
+    hr = device->CreateShaderResourceView(texture, &viewDesc, &srv);
+    if (FAILED(hr)) {
+        DebugManager::GetInstance().Log("TextureArrayAtlas", "Failed to create texture array SRV, HRESULT: " + std::to_string(hr));
+        texture->Release();
+        return false;
+    }
+
+    Page page;
+    page.key = key;
+    page.texture = texture;
+    page.srv = srv;
+    page.capacity = capacity;
+    page.sources.assign(capacity, nullptr);
+    page.freeSlices.reserve(capacity);
+    for (uint32_t slice = capacity; slice > 0; slice--) {
+        page.freeSlices.push_back(slice - 1);
+    }
+    m_Pages.push_back(std::move(page));
+
+    DebugManager::GetInstance().Log("TextureArrayAtlas", "Array " + std::to_string(m_Pages.size() - 1) + " created (" +
+        std::to_string(key.width) + "x" + std::to_string(key.height) + ", " + std::to_string(key.mipLevels) +
+        " mips, format " + std::to_string(key.format) + ", " + std::to_string(capacity) + " slices)");
+    return true;
+}
+
+bool TextureArrayAtlas::AllocateLocked(ID3D11Device* device, ID3D11ShaderResourceView* srv, ID3D11Texture2D* texture,
+                                       const PageKey& key, Allocation& outAllocation) {
+    size_t pageIndex = 0;
+    for (; pageIndex < m_Pages.size(); pageIndex++) {
+        if (m_Pages[pageIndex].key == key && !m_Pages[pageIndex].freeSlices.empty()) break;
+    }
+    if (pageIndex == m_Pages.size() && !CreatePageLocked(device, key)) {
+        return false;
+    }
+
+    Page& page = m_Pages[pageIndex];
+    const uint32_t slice = page.freeSlices.back();
+    page.freeSlices.pop_back();
+    page.sources[slice] = srv;
+    srv->AddRef();
+
+    texture->AddRef();
+    m_PendingCopies.push_back({ texture, page.texture, slice, key.mipLevels });
+
+    outAllocation.page = static_cast<uint32_t>(pageIndex);
+    outAllocation.slice = slice;
+    outAllocation.references = 1;
+    m_Allocations.emplace(srv, outAllocation);
+    return true;
+}
+
+void TextureArrayAtlas::ReleaseLocked(ID3D11ShaderResourceView* arraySRV, uint32_t slice) {
+    auto page = std::find_if(m_Pages.begin(), m_Pages.end(), [arraySRV](const Page& p) { return p.srv == arraySRV; });
+    if (page == m_Pages.end() || slice >= page->capacity) {
+        return;  // Shutdown 之后
+    }
+    ID3D11ShaderResourceView* source = page->sources[slice];
+    auto it = source ? m_Allocations.find(source) : m_Allocations.end();
+    if (it == m_Allocations.end()) {
+        return;
+    }
+    if (--it->second.references > 0) {
+        return;
+    }
+    m_Allocations.erase(it);
+    page->sources[slice] = nullptr;
+    page->freeSlices.push_back(slice);
+    source->Release();
+}
+
+bool TextureArrayAtlas::Pack(ID3D11Device* device, Material& material) {
+    if (material.packedIntoArrays) {
+        return true;
+    }
+    if (!device) {
+        return false;
+    }
+
+    ID3D11ShaderResourceView* const slots[kMaterialTextureSlotCount] = {
+        static_cast<ID3D11ShaderResourceView*>(material.albedoTextureSRV),
+        static_cast<ID3D11ShaderResourceView*>(material.normalTextureSRV),
+        static_cast<ID3D11ShaderResourceView*>(material.metallicTextureSRV),
+        static_cast<ID3D11ShaderResourceView*>(material.roughnessTextureSRV),
+        static_cast<ID3D11ShaderResourceView*>(material.emissiveTextureSRV),
+    };
+
+    // 1. 不持锁检查全部贴图（全有或全无）
+    PageKey keys[kMaterialTextureSlotCount];
+    ID3D11Texture2D* textures[kMaterialTextureSlotCount] = {};
+    bool eligible = false;
+    for (uint32_t i = 0; i < kMaterialTextureSlotCount; i++) {
+        if (!slots[i]) continue;
+        if (!DescribeSource(slots[i], keys[i], &textures[i])) {
+            eligible = false;
+            break;
+        }
+        eligible = true;
+    }
+
+    // 2. 分配层（已在图集中的源贴图只增加引用）；任何一层分配失败时归还已分配的层
+    void* arraySRVs[kMaterialTextureSlotCount] = {};
+    uint32_t slices[kMaterialTextureSlotCount] = {};
+    if (eligible) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (uint32_t i = 0; i < kMaterialTextureSlotCount; i++) {
+            if (!slots[i]) continue;
+            Allocation allocation;
+            auto it = m_Allocations.find(slots[i]);
+            if (it != m_Allocations.end()) {
+                it->second.references++;
+                allocation = it->second;
+            } else if (!AllocateLocked(device, slots[i], textures[i], keys[i], allocation)) {
+                eligible = false;
+                break;
+            }
+            arraySRVs[i] = m_Pages[allocation.page].srv;
+            slices[i] = allocation.slice;
+        }
+        if (!eligible) {
+            for (uint32_t i = 0; i < kMaterialTextureSlotCount; i++) {
+                if (arraySRVs[i]) ReleaseLocked(static_cast<ID3D11ShaderResourceView*>(arraySRVs[i]), slices[i]);
+            }
+        } else {
+            m_PackedMaterials++;
+        }
+    }
+
+    for (ID3D11Texture2D* texture : textures) {
+        if (texture) texture->Release();
+    }
+    if (!eligible) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < kMaterialTextureSlotCount; i++) {
+        material.textureArraySRV[i] = arraySRVs[i];
+        material.textureArraySlice[i] = slices[i];
+    }
+    material.packedIntoArrays = true;
+    return true;
+}
+
+void TextureArrayAtlas::Unpack(Material& material) {
+    if (!material.packedIntoArrays) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (uint32_t i = 0; i < kMaterialTextureSlotCount; i++) {
+            if (material.textureArraySRV[i]) {
+                ReleaseLocked(static_cast<ID3D11ShaderResourceView*>(material.textureArraySRV[i]),
+                              material.textureArraySlice[i]);
+            }
+        }
+        if (m_PackedMaterials > 0) m_PackedMaterials--;
+    }
+    for (uint32_t i = 0; i < kMaterialTextureSlotCount; i++) {
+        material.textureArraySRV[i] = nullptr;
+        material.textureArraySlice[i] = 0;
+    }
+    material.packedIntoArrays = false;
+}
+
+uint32_t TextureArrayAtlas::FlushCopies(ID3D11DeviceContext* context) {
+    std::vector<PendingCopy> copies;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_PendingCopies.empty()) return 0;
+        copies.swap(m_PendingCopies);
+    }
+
+    for (const PendingCopy& copy : copies) {
+        if (context) {
+            for (uint32_t mip = 0; mip < copy.mipLevels; mip++) {
+                context->CopySubresourceRegion(copy.destination, D3D11CalcSubresource(mip, copy.slice, copy.mipLevels),
+                                               0, 0, 0, copy.source, D3D11CalcSubresource(mip, 0, copy.mipLevels),
+                                               nullptr);
+            }
+        }
+        copy.source->Release();
+    }
+    return static_cast<uint32_t>(copies.size());
+}
+
+TextureArrayAtlas::Stats TextureArrayAtlas::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats stats;
+    stats.arrays = static_cast<uint32_t>(m_Pages.size());
+    for (const Page& page : m_Pages) {
+        stats.sliceCapacity += page.capacity;
+        stats.usedSlices += page.capacity - static_cast<uint32_t>(page.freeSlices.size());
+        D3D11_TEXTURE2D_DESC desc = {};
+        page.texture->GetDesc(&desc);
+        stats.reservedBytes += GpuMemory::EstimateTextureBytes(desc);
+    }
+    stats.packedMaterials = m_PackedMaterials;
+    stats.pendingCopies = static_cast<uint32_t>(m_PendingCopies.size());
+    return stats;
+}
+
+void TextureArrayAtlas::Shutdown() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const PendingCopy& copy : m_PendingCopies) {
+        copy.source->Release();
+    }
+    m_PendingCopies.clear();
+    for (auto& [source, allocation] : m_Allocations) {
+        source->Release();
+    }
+    m_Allocations.clear();
+    for (Page& page : m_Pages) {
+        if (page.srv) page.srv->Release();
+        if (page.texture) page.texture->Release();
+    }
+    m_Pages.clear();
+    m_PackedMaterials = 0;
+}
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,130 @@
+/**
+ * TextureArrayAtlas.h
+ *
+ * 材质贴图的 Texture2DArray 图集：尺寸 / 格式 / mip 数相同的贴图复制到同一个数组的不同层
+ *
+ * - 每种（宽, 高, mip 数, 格式）一组数组（页），页的层数按 kPageBudgetBytes 固定，满了新建一页；
+ *   同一张源贴图只占一层（材质共用的法线 / 粗糙度贴图按引用计数共享）
+ * - 打包的材质在 textureArraySRV / textureArraySlice 中记录所在数组和层，层下标写入 MaterialBuffer；
+ *   RenderQueue 绑定数组 SRV（HAS_TEXTURE_ARRAY 排列），同一数组的不同材质切换时只换 b2，不重新绑定纹理
+ * - 按材质全有或全无：任何一张贴图不适合（流式纹理、已是数组 / MSAA、超过 kMaxPackedDimension）时材质保持独立贴图
+ * - 源纹理仍由 ResourceCache 持有（独立 SRV 供冒名顶替者调色板、GPU 实例化和热重载使用），打包的贴图显存占两份
+ *
+ * 线程：Pack 可在加载线程调用。复制命令排队，主线程在提交任何绘制之前调用 FlushCopies
+ * （RenderSystem::Update 开头，与 GeometryPool::FlushUploads 一起）。
+ */
+
+#pragma once
+#include <d3d11.h>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+
+class Material;
+
+class TextureArrayAtlas {
+public:
+    static constexpr uint32_t kMaxPackedDimension = 1024;               // 更大的贴图单独绑定更划算
+    static constexpr uint64_t kPageBudgetBytes = 16ull * 1024 * 1024;   // 单页（整个数组）的目标字节数
+    static constexpr uint32_t kMinPageSlices = 2;
+    static constexpr uint32_t kMaxPageSlices = 64;
+
+    struct Stats {
+        uint32_t arrays = 0;            // 页数
+        uint32_t usedSlices = 0;
+        uint32_t sliceCapacity = 0;
+        uint32_t packedMaterials = 0;
+        uint64_t reservedBytes = 0;     // 全部页的容量
+        uint32_t pendingCopies = 0;     // 等待 FlushCopies 的层
+    };
+
+    static TextureArrayAtlas& GetInstance() {
+        static TextureArrayAtlas instance;
+        return instance;
+    }
+
+    /**
+     * @brief 把材质现有的贴图复制进图集，填写 textureArraySRV / textureArraySlice / packedIntoArrays
+     *
+     * 在 Material::CreateGPUBuffer 之前调用（常量缓冲区的初始内容包含层下标）；已打包时直接返回 true。
+     * @return false 表示材质保持独立贴图
+     */
+    bool Pack(ID3D11Device* device, Material& material);
+
+    /** @brief 归还材质占用的层（材质析构 / 贴图热重载时调用），材质回到独立贴图 */
+    void Unpack(Material& material);
+
+    /**
+     * @brief 执行排队的层复制（主线程，提交绘制之前）
+     * @return 复制的层数
+     */
+    uint32_t FlushCopies(ID3D11DeviceContext* context);
+
+    Stats GetStats() const;
+
+    /** @brief 释放全部页和未执行的复制（设备销毁前，所有材质释放之后调用） */
+    void Shutdown();
+
+private:
+    TextureArrayAtlas() = default;
+    ~TextureArrayAtlas() { Shutdown(); }
+    TextureArrayAtlas(const TextureArrayAtlas&) = delete;
+    TextureArrayAtlas& operator=(const TextureArrayAtlas&) = delete;
+
+    // D3D11 数组的每一层必须完全同构；视图格式单独比较（TYPELESS 纹理可以有不同的 SRV 格式）
+    struct PageKey {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipLevels = 0;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        DXGI_FORMAT viewFormat = DXGI_FORMAT_UNKNOWN;
+
+        bool operator==(const PageKey& other) const {
+            return width == other.width && height == other.height && mipLevels == other.mipLevels &&
+                   format == other.format && viewFormat == other.viewFormat;
+        }
+    };
+
+    struct Page {
+        PageKey key;
+        ID3D11Texture2D* texture = nullptr;
+        ID3D11ShaderResourceView* srv = nullptr;
+        uint32_t capacity = 0;
+        std::vector<uint32_t> freeSlices;                   // 栈：先用低层
+        std::vector<ID3D11ShaderResourceView*> sources;     // 层 → 源 SRV（空闲层为 nullptr）
+    };
+
+    // 源 SRV 在图集中的位置（持有源 SRV 的引用，避免释放后地址被复用导致错配）
+    struct Allocation {
+        uint32_t page = 0;
+        uint32_t slice = 0;
+        uint32_t references = 0;
+    };
+
+    struct PendingCopy {
+        ID3D11Texture2D* source = nullptr;                  // 持有引用，复制后释放
+        ID3D11Texture2D* destination = nullptr;
+        uint32_t slice = 0;
+        uint32_t mipLevels = 0;
+    };
+
+    // 源贴图的同构描述（不适合打包时返回 false）
+    static bool DescribeSource(ID3D11ShaderResourceView* srv, PageKey& outKey, ID3D11Texture2D** outTexture);
+    bool AllocateLocked(ID3D11Device* device, ID3D11ShaderResourceView* srv, ID3D11Texture2D* texture,
+                        const PageKey& key, Allocation& outAllocation);
+    bool CreatePageLocked(ID3D11Device* device, const PageKey& key);
+    void ReleaseLocked(ID3D11ShaderResourceView* arraySRV, uint32_t slice);
+
+    mutable std::mutex m_Mutex;
+    std::vector<Page> m_Pages;
+    std::unordered_map<ID3D11ShaderResourceView*, Allocation> m_Allocations;
+    std::vector<PendingCopy> m_PendingCopies;
+    uint32_t m_PackedMaterials = 0;
+};
+
+} // namespace resources
+} // namespace outer_wilds
@@ -0,0 +1,411 @@
+#include "TextureCooker.h"
+#include "TextureLoader.h"
+#include "DDSFormat.h"
+#include "../../core/DebugManager.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+namespace outer_wilds {
+namespace resources {
+
+static bool g_CookingEnabled = true;
+static std::string g_CacheDirectory = "cache/textures";
+
+void TextureCooker::SetEnabled(bool enabled) { g_CookingEnabled = enabled; }
+bool TextureCooker::IsEnabled() { return g_CookingEnabled; }
+
+void TextureCooker::SetCacheDirectory(const std::string& directory) { g_CacheDirectory = directory; }
+const std::string& TextureCooker::GetCacheDirectory() { return g_CacheDirectory; }
+
+// ============================================================================
+// 缓存
+// ============================================================================
+
+uint64_t TextureCooker::HashSource(const unsigned char* data, size_t dataSize, TextureUsage usage, bool generateMips) {
+    // FNV-1a 64
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](uint8_t byte) {
+        hash ^= byte;
+        hash *= 0x100000001b3ull;
+    };
+    for (size_t i = 0; i < dataSize; i++) {
+        mix(data[i]);
+    }
+    mix(static_cast<uint8_t>(usage));
+    mix(generateMips ? 1 : 0);
+    for (int shift = 0; shift < 32; shift += 8) {
+        mix(static_cast<uint8_t>(kCookerVersion >> shift));
+    }
+    return hash;
+}
+
+std::string TextureCooker::GetCachePath(uint64_t sourceHash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.dds", static_cast<unsigned long long>(sourceHash));
+    return g_CacheDirectory + "/" + name;
+}
+
+bool TextureCooker::ReadCached(uint64_t sourceHash, std::vector<unsigned char>& outDDS) {
+    std::ifstream file(GetCachePath(sourceHash), std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    if (size <= 0) {
+        return false;
+    }
+    file.seekg(0, std::ios::beg);
+    outDDS.resize(static_cast<size_t>(size));
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(outDDS.data()), size));
+}
+
+bool TextureCooker::WriteCached(uint64_t sourceHash, const std::vector<unsigned char>& dds) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(g_CacheDirectory, ec);
+
+    // 先写临时文件再重命名，避免中断时留下截断的缓存
+    const std::string path = GetCachePath(sourceHash);
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            DebugManager::GetInstance().Log("TextureCooker", "Failed to write cache file: " + tempPath);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(dds.data()), static_cast<std::streamsize>(dds.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// 块压缩编码（range fit：包围盒端点 + 最近调色板索引）
+// ============================================================================
+
+namespace {
+
+uint16_t To565(int r, int g, int b) {
+    return static_cast<uint16_t>(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+}
+
+void From565(uint16_t c, int& r, int& g, int& b) {
+    r = ((c >> 11) & 31) * 255 / 31;
+    g = ((c >> 5) & 63) * 255 / 63;
+    b = (c & 31) * 255 / 31;
+}
+
+/**
+ * @brief BC1 颜色块（8 字节，4 色模式）；pixels 为 16 个 RGBA
+ */
+void EncodeColorBlock(const uint8_t* pixels, uint8_t* out) {
+    int minC[3] = { 255, 255, 255 };
+    int maxC[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            minC[c] = (std::min)(minC[c], static_cast<int>(pixels[i * 4 + c]));
+            maxC[c] = (std::max)(maxC[c], static_cast<int>(pixels[i * 4 + c]));
+        }
+    }
+    // 向内收缩 1/16，减少端点量化误差
+    for (int c = 0; c < 3; c++) {
+        int inset = (maxC[c] - minC[c]) >> 4;
+        minC[c] = (std::min)(255, minC[c] + inset);
+        maxC[c] = (std::max)(0, maxC[c] - inset);
+    }
+
+    uint16_t c0 = To565(maxC[0], maxC[1], maxC[2]);
+    uint16_t c1 = To565(minC[0], minC[1], minC[2]);
+    if (c0 < c1) {
+        std::swap(c0, c1);
+    }
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        int palette[4][3];
+        From565(c0, palette[0][0], palette[0][1], palette[0][2]);
+        From565(c1, palette[1][0], palette[1][1], palette[1][2]);
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestDist = INT_MAX;
+            for (int p = 0; p < 4; p++) {
+                int dr = pixels[i * 4 + 0] - palette[p][0];
+                int dg = pixels[i * 4 + 1] - palette[p][1];
+                int db = pixels[i * 4 + 2] - palette[p][2];
+                int dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (i * 2);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(c0 & 0xFF);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1 & 0xFF);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+/**
+ * @brief BC4 单通道块（8 字节，8 值模式）；values 为 16 个 8 位值
+ */
+void EncodeChannelBlock(const uint8_t* values, uint8_t* out) {
+    int minV = 255;
+    int maxV = 0;
+    for (int i = 0; i < 16; i++) {
+        minV = (std::min)(minV, static_cast<int>(values[i]));
+        maxV = (std::max)(maxV, static_cast<int>(values[i]));
+    }
+
+    out[0] = static_cast<uint8_t>(maxV);
+    out[1] = static_cast<uint8_t>(minV);
+
+    uint64_t indices = 0;
+    if (maxV != minV) {
+        int palette[8];
+        palette[0] = maxV;
+        palette[1] = minV;
+        for (int p = 2; p < 8; p++) {
+            palette[p] = ((8 - p) * maxV + (p - 1) * minV) / 7;
+        }
+        for (int i = 0; i < 16; i++) {
+            int best = 0;
+            int bestDist = INT_MAX;
+            for (int p = 0; p < 8; p++) {
+                int dist = std::abs(values[i] - palette[p]);
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+    for (int b = 0; b < 6; b++) {
+        out[2 + b] = static_cast<uint8_t>(indices >> (b * 8));
+    }
+}
+
+/**
+ * @brief 2x2 盒式滤波生成下一级 mip（奇数尺寸时边缘夹取）
+ */
+void Downsample(const std::vector<uint8_t>& src, uint32_t srcW, uint32_t srcH,
+                std::vector<uint8_t>& dst, uint32_t dstW, uint32_t dstH, bool renormalize) {
+    dst.resize(static_cast<size_t>(dstW) * dstH * 4);
+    for (uint32_t y = 0; y < dstH; y++) {
+        uint32_t y0 = (std::min)(y * 2, srcH - 1);
+        uint32_t y1 = (std::min)(y * 2 + 1, srcH - 1);
+        for (uint32_t x = 0; x < dstW; x++) {
+            uint32_t x0 = (std::min)(x * 2, srcW - 1);
+            uint32_t x1 = (std::min)(x * 2 + 1, srcW - 1);
+            const uint8_t* p00 = &src[(static_cast<size_t>(y0) * srcW + x0) * 4];
+            const uint8_t* p01 = &src[(static_cast<size_t>(y0) * srcW + x1) * 4];
+            const uint8_t* p10 = &src[(static_cast<size_t>(y1) * srcW + x0) * 4];
+            const uint8_t* p11 = &src[(static_cast<size_t>(y1) * srcW + x1) * 4];
+            uint8_t* d = &dst[(static_cast<size_t>(y) * dstW + x) * 4];
+            for (int c = 0; c < 4; c++) {
+                d[c] = static_cast<uint8_t>((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+            }
+            if (renormalize) {
+                // 法线平均后变短，重新归一化避免远处高光发暗
+                float nx = d[0] / 127.5f - 1.0f;
+                float ny = d[1] / 127.5f - 1.0f;
+                float nz = d[2] / 127.5f - 1.0f;
+                float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+                if (len > 1e-4f) {
+                    d[0] = static_cast<uint8_t>(std::lround((nx / len + 1.0f) * 127.5f));
+                    d[1] = static_cast<uint8_t>(std::lround((ny / len + 1.0f) * 127.5f));
+                    d[2] = static_cast<uint8_t>(std::lround((nz / len + 1.0f) * 127.5f));
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+DXGI_FORMAT TextureCooker::SelectFormat(const unsigned char* pixels, uint32_t width, uint32_t height, TextureUsage usage) {
+    switch (usage) {
+        case TextureUsage::Normal:
+            return DXGI_FORMAT_BC5_UNORM;
+        case TextureUsage::Mask:
+            return DXGI_FORMAT_BC4_UNORM;
+        case TextureUsage::Color:
+        default: {
+            const size_t count = static_cast<size_t>(width) * height;
+            for (size_t i = 0; i < count; i++) {
+                if (pixels[i * 4 + 3] != 255) {
+                    return DXGI_FORMAT_BC3_UNORM;
+                }
+            }
+            return DXGI_FORMAT_BC1_UNORM;
+        }
+    }
+}
+
+void TextureCooker::EncodeSurface(const unsigned char* rgba, uint32_t width, uint32_t height,
+                                  DXGI_FORMAT format, unsigned char* outBlocks) {
+    const uint32_t blocksX = (std::max)(1u, (width + 3) / 4);
+    const uint32_t blocksY = (std::max)(1u, (height + 3) / 4);
+    const uint32_t blockBytes = TextureLoader::GetBlockBytes(format);
+
+    std::vector<uint32_t> rows(blocksY);
+    std::iota(rows.begin(), rows.end(), 0u);
+
+    // 块行之间互不依赖，并行编码
+    std::for_each(std::execution::par, rows.begin(), rows.end(), [&](uint32_t by) {
+        uint8_t block[16 * 4];
+        uint8_t channel[16];
+        for (uint32_t bx = 0; bx < blocksX; bx++) {
+            // 取 4x4 像素（小于 4 的 mip 边缘复制）
+            for (uint32_t py = 0; py < 4; py++) {
+                uint32_t y = (std::min)(by * 4 + py, height - 1);
+                for (uint32_t px = 0; px < 4; px++) {
+                    uint32_t x = (std::min)(bx * 4 + px, width - 1);
+                    std::memcpy(&block[(py * 4 + px) * 4], &rgba[(static_cast<size_t>(y) * width + x) * 4], 4);
+                }
+            }
+
+            uint8_t* out = outBlocks + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+            auto extract = [&](int c) {
+                for (int i = 0; i < 16; i++) channel[i] = block[i * 4 + c];
+            };
+
+            switch (format) {
+                case DXGI_FORMAT_BC1_UNORM:
+                    EncodeColorBlock(block, out);
+                    break;
+                case DXGI_FORMAT_BC3_UNORM:
+                    extract(3);
+                    EncodeChannelBlock(channel, out);
+                    EncodeColorBlock(block, out + 8);
+                    break;
+                case DXGI_FORMAT_BC4_UNORM:
+                    extract(0);
+                    EncodeChannelBlock(channel, out);
+                    break;
+                case DXGI_FORMAT_BC5_UNORM:
+                    extract(0);
+                    EncodeChannelBlock(channel, out);
+                    extract(1);
+                    EncodeChannelBlock(channel, out + 8);
+                    break;
+                default:
+                    break;
+            }
+        }
+    });
+}
+
+bool TextureCooker::CookRGBA(const unsigned char* pixels, uint32_t width, uint32_t height,
+                             TextureUsage usage, bool generateMips, std::vector<unsigned char>& outDDS) {
+    using namespace dds;
+
+    // D3D11 要求块压缩纹理的顶层尺寸为 4 的倍数
+    if (!pixels || width == 0 || height == 0 || (width % 4) != 0 || (height % 4) != 0) {
+        return false;
+    }
+
+    const DXGI_FORMAT format = SelectFormat(pixels, width, height, usage);
+    const uint32_t mipLevels = generateMips ? TextureLoader::CalculateMipCount(width, height) : 1;
+
+    // 计算总大小
+    size_t dataSize = 0;
+    {
+        uint32_t w = width;
+        uint32_t h = height;
+        for (uint32_t level = 0; level < mipLevels; level++) {
+            uint32_t rowPitch = 0;
+            uint32_t rowCount = 0;
+            TextureLoader::GetSurfaceInfo(format, w, h, rowPitch, rowCount);
+            dataSize += static_cast<size_t>(rowPitch) * rowCount;
+            w = (std::max)(1u, w / 2);
+            h = (std::max)(1u, h / 2);
+        }
+    }
+
+    const size_t headerSize = sizeof(uint32_t) + sizeof(DDSHeader) + sizeof(DDSHeaderDX10);
+    outDDS.assign(headerSize + dataSize, 0);
+
+    // === 文件头 ===
+    uint32_t topPitch = 0;
+    uint32_t topRows = 0;
+    TextureLoader::GetSurfaceInfo(format, width, height, topPitch, topRows);
+
+    DDSHeader header = {};
+    header.size = sizeof(DDSHeader);
+    header.flags = kDDSHeaderFlagsTexture | kDDSHeaderFlagsLinearSize | (mipLevels > 1 ? kDDSHeaderFlagsMipmap : 0);
+    header.height = height;
+    header.width = width;
+    header.pitchOrLinearSize = topPitch * topRows;
+    header.mipMapCount = mipLevels;
+    header.ddspf.size = sizeof(DDSPixelFormat);
+    header.ddspf.flags = kDDSFourCC;
+    header.ddspf.fourCC = kDDSDX10FourCC;
+    header.caps = kDDSCapsTexture | (mipLevels > 1 ? kDDSCapsComplexMipmap : 0);
+
+    DDSHeaderDX10 dx10 = {};
+    dx10.dxgiFormat = static_cast<uint32_t>(format);
+    dx10.resourceDimension = kDDSDimensionTexture2D;
+    dx10.arraySize = 1;
+
+    unsigned char* cursor = outDDS.data();
+    std::memcpy(cursor, &kDDSMagic, sizeof(uint32_t));
+    cursor += sizeof(uint32_t);
+    std::memcpy(cursor, &header, sizeof(DDSHeader));
+    cursor += sizeof(DDSHeader);
+    std::memcpy(cursor, &dx10, sizeof(DDSHeaderDX10));
+    cursor += sizeof(DDSHeaderDX10);
+
+    // === 逐级生成 mip 并编码 ===
+    std::vector<uint8_t> current(pixels, pixels + static_cast<size_t>(width) * height * 4);
+    std::vector<uint8_t> next;
+    uint32_t w = width;
+    uint32_t h = height;
+    for (uint32_t level = 0; level < mipLevels; level++) {
+        uint32_t rowPitch = 0;
+        uint32_t rowCount = 0;
+        TextureLoader::GetSurfaceInfo(format, w, h, rowPitch, rowCount);
+        EncodeSurface(current.data(), w, h, format, cursor);
+        cursor += static_cast<size_t>(rowPitch) * rowCount;
+
+        if (level + 1 < mipLevels) {
+            uint32_t nw = (std::max)(1u, w / 2);
+            uint32_t nh = (std::max)(1u, h / 2);
+            Downsample(current, w, h, next, nw, nh, usage == TextureUsage::Normal);
+            current.swap(next);
+            w = nw;
+            h = nh;
+        }
+    }
+
+    DebugManager::GetInstance().Log("TextureCooker",
+        "Cooked " + std::to_string(width) + "x" + std::to_string(height) + " texture (" +
+        std::to_string(mipLevels) + " mips, " + std::to_string(outDDS.size() / 1024) + " KB)");
+    return true;
+}
+
+} // namespace resources
+} // namespace outer_wilds
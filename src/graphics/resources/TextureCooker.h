@@ -0,0 +1,83 @@
+#pragma once
+#include <d3d11.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace outer_wilds {
+namespace resources {
+
+/**
+ * Intended use of a texture (selects the block-compressed format when cooking)
+ */
+enum class TextureUsage {
+    Color,   // Albedo / emissive: BC1 (opaque) or BC3 (with alpha)
+    Normal,  // Tangent-space normal map: BC5 (RG, shader reconstructs Z)
+    Mask     // Single-channel data sampled as .r (metallic, roughness): BC4
+};
+
+/**
+ * Texture cooker: RGBA8 → block-compressed DDS with a full mip chain
+ *
+ * - Cooked files live in a content-hashed cache directory (default: cache/textures)
+ *   keyed by FNV-1a of the source bytes + usage + mip flag + cooker version
+ * - TextureLoader probes the cache before decoding JPG/PNG through WIC; on a miss it
+ *   decodes, cooks and writes the cache so the next launch is a file read + upload
+ * - Encoders are simple range-fit BC1/BC3/BC4/BC5 (no BC7: that needs a mode search
+ *   encoder such as DirectXTex, which this project does not depend on)
+ */
+class TextureCooker {
+public:
+    /**
+     * Bump when the encoder output changes to invalidate existing cache entries
+     */
+    static constexpr uint32_t kCookerVersion = 1;
+
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    static void SetCacheDirectory(const std::string& directory);
+    static const std::string& GetCacheDirectory();
+
+    /**
+     * Content hash of the source (encoded or raw) bytes for a given usage
+     */
+    static uint64_t HashSource(const unsigned char* data, size_t dataSize, TextureUsage usage, bool generateMips);
+
+    /**
+     * Path of the cooked DDS for a source hash (file may not exist)
+     */
+    static std::string GetCachePath(uint64_t sourceHash);
+
+    /**
+     * Read a cooked DDS from the cache
+     * @return true if the file exists and was read completely
+     */
+    static bool ReadCached(uint64_t sourceHash, std::vector<unsigned char>& outDDS);
+
+    /**
+     * Cook RGBA8 pixels into an in-memory DDS file (DX10 header, BC format, mips)
+     * @param pixels RGBA8 pixel data (width * height * 4 bytes)
+     * @param outDDS Output DDS file contents
+     * @return true if successful
+     */
+    static bool CookRGBA(const unsigned char* pixels, uint32_t width, uint32_t height,
+                         TextureUsage usage, bool generateMips, std::vector<unsigned char>& outDDS);
+
+    /**
+     * Write a cooked DDS into the cache directory (creating it if needed)
+     */
+    static bool WriteCached(uint64_t sourceHash, const std::vector<unsigned char>& dds);
+
+    /**
+     * Block-compressed format chosen for the given usage and pixels
+     */
+    static DXGI_FORMAT SelectFormat(const unsigned char* pixels, uint32_t width, uint32_t height, TextureUsage usage);
+
+private:
+    static void EncodeSurface(const unsigned char* rgba, uint32_t width, uint32_t height,
+                              DXGI_FORMAT format, unsigned char* outBlocks);
+};
+
+} // namespace resources
+} // namespace outer_wilds
@@ -1,9 +1,15 @@
 #include "TextureLoader.h"
+#include "TextureCooker.h"
+#include "DDSFormat.h"
+#include "../GpuMemory.h"
 #include "../../core/DebugManager.h"
 #include <wincodec.h>
 #include <wrl/client.h>
 #include <fstream>
 #include <shlwapi.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
 
 #pragma comment(lib, "windowscodecs.lib")
 #pragma comment(lib, "shlwapi.lib")
@@ -13,10 +19,102 @@ using Microsoft::WRL::ComPtr;
 namespace outer_wilds {
 namespace resources {
 
+using namespace dds;
+
+namespace {
+    // 加载线程创建的纹理：立即上下文不是线程安全的，上传 + GenerateMips 推迟到渲染线程
+    struct DeferredMipUpload {
+        ComPtr<ID3D11Texture2D> texture;
+        ComPtr<ID3D11ShaderResourceView> srv;
+        std::vector<unsigned char> pixels;
+        UINT rowPitch = 0;
+        UINT height = 0;
+    };
+
+    thread_local bool t_DeferImmediateContextWork = false;
+    std::mutex g_DeferredMutex;
+    std::vector<DeferredMipUpload> g_DeferredUploads;
+}
+
+void TextureLoader::SetDeferImmediateContextWork(bool defer) {
+    t_DeferImmediateContextWork = defer;
+}
+
+void TextureLoader::FlushDeferredWork() {
+    std::vector<DeferredMipUpload> uploads;
+    {
+        std::lock_guard<std::mutex> lock(g_DeferredMutex);
+        uploads.swap(g_DeferredUploads);
+    }
+    for (auto& upload : uploads) {
+        ComPtr<ID3D11Device> device;
+        upload.texture->GetDevice(&device);
+        ComPtr<ID3D11DeviceContext> context;
+        device->GetImmediateContext(&context);
+        context->UpdateSubresource(upload.texture.Get(), 0, nullptr, upload.pixels.data(),
+                                   upload.rowPitch, upload.rowPitch * upload.height);
+        context->GenerateMips(upload.srv.Get());
+    }
+}
+
+uint32_t TextureLoader::CalculateMipCount(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    uint32_t size = (std::max)(width, height);
+    while (size > 1) {
+        size >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+uint32_t TextureLoader::GetBlockBytes(DXGI_FORMAT format) {
+    switch (format) {
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            return 8;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            return 16;
+        default:
+            return 0;  // 非块压缩格式
+    }
+}
+
+bool TextureLoader::GetSurfaceInfo(DXGI_FORMAT format, uint32_t width, uint32_t height,
+                                   uint32_t& outRowPitch, uint32_t& outRowCount) {
+    uint32_t blockBytes = GetBlockBytes(format);
+    if (blockBytes > 0) {
+        outRowPitch = (std::max)(1u, (width + 3) / 4) * blockBytes;
+        outRowCount = (std::max)(1u, (height + 3) / 4);
+        return true;
+    }
+    switch (format) {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            outRowPitch = width * 4;
+            outRowCount = height;
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool TextureLoader::LoadFromFile(
     ID3D11Device* device,
     const std::string& filename,
-    ID3D11ShaderResourceView** outTexture
+    ID3D11ShaderResourceView** outTexture,
+    bool generateMips,
+    TextureUsage usage
 ) {
     if (!device || !outTexture) {
         DebugManager::GetInstance().Log("TextureLoader", "Invalid parameters");
@@ -26,9 +124,9 @@ bool TextureLoader::LoadFromFile(
     // Check file extension
     std::string ext = filename.substr(filename.find_last_of('.') + 1);
     if (ext == "dds" || ext == "DDS") {
-        return LoadDDS(device, filename, outTexture);
+        return LoadDDS(device, filename, outTexture);  // DDS 使用文件中预计算的 mip
     } else {
-        return LoadWIC(device, filename, outTexture);
+        return LoadWIC(device, filename, outTexture, generateMips, usage);
     }
 }
 
@@ -37,14 +135,16 @@ bool TextureLoader::LoadFromMemory(
     const unsigned char* data,
     size_t dataSize,
     const std::string& formatHint,
-    ID3D11ShaderResourceView** outTexture
+    ID3D11ShaderResourceView** outTexture,
+    bool generateMips,
+    TextureUsage usage
 ) {
     if (!device || !data || dataSize == 0 || !outTexture) {
         DebugManager::GetInstance().Log("TextureLoader", "Invalid parameters for memory load");
         return false;
     }
 
-    return LoadWICFromMemory(device, data, dataSize, outTexture);
+    return LoadEncodedImage(device, data, dataSize, outTexture, generateMips, usage, "[memory]");
 }
 
 bool TextureLoader::CreateFromRGBA(
@@ -52,18 +152,32 @@ bool TextureLoader::CreateFromRGBA(
     const unsigned char* pixels,
     uint32_t width,
     uint32_t height,
-    ID3D11ShaderResourceView** outTexture
+    ID3D11ShaderResourceView** outTexture,
+    bool generateMips
 ) {
     if (!device || !pixels || width == 0 || height == 0 || !outTexture) {
         DebugManager::GetInstance().Log("TextureLoader", "Invalid parameters for RGBA creation");
         return false;
     }
 
+    // GPU 生成 mip 需要格式支持 MIP_AUTOGEN（R8G8B8A8_UNORM 在 FL10+ 上总是支持）
+    UINT formatSupport = 0;
+    if (generateMips) {
+        device->CheckFormatSupport(DXGI_FORMAT_R8G8B8A8_UNORM, &formatSupport);
+        if (!(formatSupport & D3D11_FORMAT_SUPPORT_MIP_AUTOGEN)) {
+            DebugManager::GetInstance().Log("TextureLoader", "MIP_AUTOGEN not supported, creating single-level texture");
+            generateMips = false;
+        }
+    }
+
+    const uint32_t mipLevels = generateMips ? CalculateMipCount(width, height) : 1;
+    const UINT stride = width * 4;
+
     // Create D3D11 texture
     D3D11_TEXTURE2D_DESC texDesc = {};
     texDesc.Width = width;
     texDesc.Height = height;
-    texDesc.MipLevels = 1;
+    texDesc.MipLevels = mipLevels;
     texDesc.ArraySize = 1;
     texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
     texDesc.SampleDesc.Count = 1;
@@ -73,14 +187,21 @@ bool TextureLoader::CreateFromRGBA(
     texDesc.CPUAccessFlags = 0;
     texDesc.MiscFlags = 0;
 
-    UINT stride = width * 4;
+    if (generateMips) {
+        // GenerateMips 要求纹理同时可作为渲染目标
+        texDesc.BindFlags |= D3D11_BIND_RENDER_TARGET;
+        texDesc.MiscFlags |= D3D11_RESOURCE_MISC_GENERATE_MIPS;
+    }
+
     D3D11_SUBRESOURCE_DATA initData = {};
     initData.pSysMem = pixels;
     initData.SysMemPitch = stride;
     initData.SysMemSlicePitch = stride * height;
 
+    // 多级纹理的初始数据需要每一级都提供，因此先创建空纹理，再单独上传第 0 级
     ComPtr<ID3D11Texture2D> texture;
-    HRESULT hr = device->CreateTexture2D(&texDesc, &initData, &texture);
+    HRESULT hr = device->CreateTexture2D(&texDesc, generateMips ? nullptr : &initData, &texture);
+    GpuMemory::Track(texture.Get());
     if (FAILED(hr)) {
         DebugManager::GetInstance().Log("TextureLoader", "Failed to create texture from RGBA");
         return false;
@@ -90,7 +211,8 @@ bool TextureLoader::CreateFromRGBA(
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.Format = texDesc.Format;
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = 1;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = mipLevels;
 
     hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, outTexture);
     if (FAILED(hr)) {
@@ -98,17 +220,117 @@ bool TextureLoader::CreateFromRGBA(
         return false;
     }
 
+    if (generateMips && t_DeferImmediateContextWork) {
+        DeferredMipUpload upload;
+        upload.texture = texture;
+        upload.srv = *outTexture;
+        upload.pixels.assign(pixels, pixels + static_cast<size_t>(stride) * height);
+        upload.rowPitch = stride;
+        upload.height = height;
+        std::lock_guard<std::mutex> lock(g_DeferredMutex);
+        g_DeferredUploads.push_back(std::move(upload));
+    } else if (generateMips) {
+        ComPtr<ID3D11DeviceContext> context;
+        device->GetImmediateContext(&context);
+        context->UpdateSubresource(texture.Get(), 0, nullptr, pixels, stride, stride * height);
+        context->GenerateMips(*outTexture);
+    }
+
     DebugManager::GetInstance().Log("TextureLoader", 
-        "Created texture from RGBA (" + std::to_string(width) + "x" + std::to_string(height) + ")");
+        "Created texture from RGBA (" + std::to_string(width) + "x" + std::to_string(height) +
+        ", " + std::to_string(mipLevels) + " mips)");
+
+    return true;
+}
+
+bool TextureLoader::LoadEncodedImage(
+    ID3D11Device* device,
+    const unsigned char* data,
+    size_t dataSize,
+    ID3D11ShaderResourceView** outTexture,
+    bool generateMips,
+    TextureUsage usage,
+    const std::string& label
+) {
+    DecodedImage image;
+    if (!DecodeImage(data, dataSize, image, generateMips, usage, label)) {
+        return false;
+    }
+    return CreateFromDecoded(device, image, outTexture, generateMips);
+}
+
+bool TextureLoader::DecodeImage(
+    const unsigned char* data,
+    size_t dataSize,
+    DecodedImage& outImage,
+    bool generateMips,
+    TextureUsage usage,
+    const std::string& label
+) {
+    if (!data || dataSize == 0) {
+        return false;
+    }
+
+    // === 1. 烘焙缓存命中：直接使用块压缩 DDS（无需解码）===
+    const bool cooking = TextureCooker::IsEnabled();
+    uint64_t sourceHash = 0;
+    if (cooking) {
+        sourceHash = TextureCooker::HashSource(data, dataSize, usage, generateMips);
+        DDSInfo info;
+        if (TextureCooker::ReadCached(sourceHash, outImage.dds) &&
+            ReadDDSInfo(outImage.dds.data(), outImage.dds.size(), info)) {
+            OW_LOG_DEBUG("TextureLoader", "Loaded cooked texture: {}", label);
+            return true;
+        }
+        outImage.dds.clear();
+    }
+
+    // === 2. WIC 解码 ===
+    std::vector<BYTE> pixels;
+    UINT width = 0;
+    UINT height = 0;
+    if (!DecodeWIC(data, dataSize, pixels, width, height)) {
+        DebugManager::GetInstance().Log("TextureLoader", "Failed to decode texture: " + label);
+        return false;
+    }
 
+    // === 3. 未命中：烘焙并写入缓存（尺寸不是 4 的倍数时不压缩）===
+    if (cooking && TextureCooker::CookRGBA(pixels.data(), width, height, usage, generateMips, outImage.dds)) {
+        TextureCooker::WriteCached(sourceHash, outImage.dds);
+        DebugManager::GetInstance().Log("TextureLoader", "Cooked texture: " + label + " -> " +
+                                        TextureCooker::GetCachePath(sourceHash));
+        return true;
+    }
+    outImage.dds.clear();
+
+    // === 4. 回退：未压缩 RGBA8 ===
+    outImage.pixels.swap(pixels);
+    outImage.width = width;
+    outImage.height = height;
     return true;
 }
 
-bool TextureLoader::LoadWICFromMemory(
-    ID3D11Device* device, 
-    const unsigned char* data, 
-    size_t dataSize, 
-    ID3D11ShaderResourceView** outTexture
+bool TextureLoader::CreateFromDecoded(
+    ID3D11Device* device,
+    const DecodedImage& image,
+    ID3D11ShaderResourceView** outTexture,
+    bool generateMips
+) {
+    if (!image.dds.empty() && CreateFromDDSMemory(device, image.dds.data(), image.dds.size(), outTexture)) {
+        return true;
+    }
+    if (image.pixels.empty()) {
+        return false;
+    }
+    return CreateFromRGBA(device, image.pixels.data(), image.width, image.height, outTexture, generateMips);
+}
+
+bool TextureLoader::DecodeWIC(
+    const unsigned char* data,
+    size_t dataSize,
+    std::vector<unsigned char>& outPixels,
+    UINT& outWidth,
+    UINT& outHeight
 ) {
     // Initialize COM
     CoInitialize(nullptr);
@@ -208,147 +430,204 @@ bool TextureLoader::LoadWICFromMemory(
         return false;
     }
 
-    // Create texture using the helper function
-    return CreateFromRGBA(device, pixels.data(), width, height, outTexture);
+    outPixels.swap(pixels);
+    outWidth = width;
+    outHeight = height;
+    return true;
 }
 
 bool TextureLoader::LoadDDS(ID3D11Device* device, const std::string& filename, ID3D11ShaderResourceView** outTexture) {
-    // DDS loading would require DirectXTex library
-    // For simplicity, we'll skip DDS support for now
-    DebugManager::GetInstance().Log("TextureLoader", "DDS format not yet implemented");
-    return false;
-}
-
-bool TextureLoader::LoadWIC(ID3D11Device* device, const std::string& filename, ID3D11ShaderResourceView** outTexture) {
-    // Convert filename to wide string
-    std::wstring wFilename(filename.begin(), filename.end());
-
-    // Initialize COM
-    CoInitialize(nullptr);
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        DebugManager::GetInstance().Log("TextureLoader", "Failed to open DDS file: " + filename);
+        return false;
+    }
+    std::streamsize fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
 
-    ComPtr<IWICImagingFactory> wicFactory;
-    HRESULT hr = CoCreateInstance(
-        CLSID_WICImagingFactory,
-        nullptr,
-        CLSCTX_INPROC_SERVER,
-        IID_PPV_ARGS(&wicFactory)
-    );
+    std::vector<unsigned char> data(static_cast<size_t>(fileSize));
+    if (fileSize <= 0 || !file.read(reinterpret_cast<char*>(data.data()), fileSize)) {
+        DebugManager::GetInstance().Log("TextureLoader", "Failed to read DDS file: " + filename);
+        return false;
+    }
 
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to create WIC factory");
+    if (!CreateFromDDSMemory(device, data.data(), data.size(), outTexture)) {
+        DebugManager::GetInstance().Log("TextureLoader", "Invalid or unsupported DDS file: " + filename);
         return false;
     }
 
-    // Load image from file
-    ComPtr<IWICBitmapDecoder> decoder;
-    hr = wicFactory->CreateDecoderFromFilename(
-        wFilename.c_str(),
-        nullptr,
-        GENERIC_READ,
-        WICDecodeMetadataCacheOnDemand,
-        &decoder
-    );
+    OW_LOG_DEBUG("TextureLoader", "Successfully loaded DDS texture: {}", filename);
+    return true;
+}
 
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to create decoder for: " + filename);
+bool TextureLoader::ReadDDSInfo(const unsigned char* data, size_t dataSize, DDSInfo& outInfo) {
+    if (!data || dataSize < sizeof(uint32_t) + sizeof(DDSHeader)) {
         return false;
     }
 
-    ComPtr<IWICBitmapFrameDecode> frame;
-    hr = decoder->GetFrame(0, &frame);
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to get frame");
+    uint32_t magic = 0;
+    std::memcpy(&magic, data, sizeof(uint32_t));
+    if (magic != kDDSMagic) {
         return false;
     }
 
-    // Convert to RGBA format
-    ComPtr<IWICFormatConverter> converter;
-    hr = wicFactory->CreateFormatConverter(&converter);
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to create format converter");
+    DDSHeader header;
+    std::memcpy(&header, data + sizeof(uint32_t), sizeof(DDSHeader));
+    if (header.size != sizeof(DDSHeader) || header.ddspf.size != sizeof(DDSPixelFormat)) {
         return false;
     }
+    if (header.caps2 & kDDSCubemap) {
+        return false;  // 立方体贴图由 SkyboxRenderer 自行处理
+    }
 
-    hr = converter->Initialize(
-        frame.Get(),
-        GUID_WICPixelFormat32bppRGBA,
-        WICBitmapDitherTypeNone,
-        nullptr,
-        0.0,
-        WICBitmapPaletteTypeCustom
-    );
-
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to initialize converter");
-        return false;
+    size_t offset = sizeof(uint32_t) + sizeof(DDSHeader);
+    DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+    if ((header.ddspf.flags & kDDSFourCC) && header.ddspf.fourCC == kDDSDX10FourCC) {
+        if (dataSize < offset + sizeof(DDSHeaderDX10)) {
+            return false;
+        }
+        DDSHeaderDX10 dx10;
+        std::memcpy(&dx10, data + offset, sizeof(DDSHeaderDX10));
+        offset += sizeof(DDSHeaderDX10);
+        if (dx10.arraySize > 1 || dx10.resourceDimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D) {
+            return false;
+        }
+        format = static_cast<DXGI_FORMAT>(dx10.dxgiFormat);
+    } else {
+        format = FormatFromPixelFormat(header.ddspf);
     }
 
-    // Get image dimensions
-    UINT width, height;
-    hr = converter->GetSize(&width, &height);
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to get image size");
+    const uint32_t mipLevels = (std::max)(1u, header.mipMapCount);
+    if (header.width == 0 || header.height == 0 || mipLevels > CalculateMipCount(header.width, header.height)) {
         return false;
     }
 
-    // Copy pixel data
-    UINT stride = width * 4;
-    UINT imageSize = stride * height;
-    std::vector<BYTE> pixels(imageSize);
+    outInfo.width = header.width;
+    outInfo.height = header.height;
+    outInfo.mipLevels = mipLevels;
+    outInfo.format = format;
+    outInfo.dataOffset = offset;
+    return true;
+}
 
-    hr = converter->CopyPixels(
-        nullptr,
-        stride,
-        imageSize,
-        pixels.data()
-    );
+uint64_t TextureLoader::CalculateTextureBytes(DXGI_FORMAT format, uint32_t width, uint32_t height,
+                                              uint32_t mipLevels, uint32_t firstMip) {
+    uint64_t bytes = 0;
+    for (uint32_t level = 0; level < mipLevels; level++) {
+        uint32_t rowPitch = 0;
+        uint32_t rowCount = 0;
+        if (level >= firstMip && GetSurfaceInfo(format, width, height, rowPitch, rowCount)) {
+            bytes += static_cast<uint64_t>(rowPitch) * rowCount;
+        }
+        width = (std::max)(1u, width / 2);
+        height = (std::max)(1u, height / 2);
+    }
+    return bytes;
+}
 
-    if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to copy pixels");
+bool TextureLoader::CreateFromDDSMemory(ID3D11Device* device, const unsigned char* data, size_t dataSize,
+                                        ID3D11ShaderResourceView** outTexture, uint32_t skipMips) {
+    DDSInfo info;
+    if (!device || !outTexture || !ReadDDSInfo(data, dataSize, info)) {
         return false;
     }
 
-    // Create D3D11 texture
+    const DXGI_FORMAT format = info.format;
+    skipMips = (std::min)(skipMips, info.mipLevels - 1);
+    // 块压缩纹理的顶层尺寸必须是 4 的倍数：跳级后不满足时少跳几级
+    if (GetBlockBytes(format) > 0) {
+        while (skipMips > 0 && (((info.width >> skipMips) % 4) != 0 || ((info.height >> skipMips) % 4) != 0)) {
+            skipMips--;
+        }
+    }
+    const uint32_t residentLevels = info.mipLevels - skipMips;
+
+    // 每一级 mip 的子资源数据直接指向文件内存（紧密排列），跳过的级别只移动偏移
+    size_t offset = info.dataOffset;
+    std::vector<D3D11_SUBRESOURCE_DATA> subresources(residentLevels);
+    uint32_t w = info.width;
+    uint32_t h = info.height;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    for (uint32_t level = 0; level < info.mipLevels; level++) {
+        uint32_t rowPitch = 0;
+        uint32_t rowCount = 0;
+        if (!GetSurfaceInfo(format, w, h, rowPitch, rowCount)) {
+            return false;  // 不支持的格式
+        }
+        size_t levelSize = static_cast<size_t>(rowPitch) * rowCount;
+        if (offset + levelSize > dataSize) {
+            return false;  // 文件被截断
+        }
+        if (level == skipMips) {
+            width = w;
+            height = h;
+        }
+        if (level >= skipMips) {
+            D3D11_SUBRESOURCE_DATA& subresource = subresources[level - skipMips];
+            subresource.pSysMem = data + offset;
+            subresource.SysMemPitch = rowPitch;
+            subresource.SysMemSlicePitch = static_cast<UINT>(levelSize);
+        }
+        offset += levelSize;
+        w = (std::max)(1u, w / 2);
+        h = (std::max)(1u, h / 2);
+    }
+
     D3D11_TEXTURE2D_DESC texDesc = {};
     texDesc.Width = width;
     texDesc.Height = height;
-    texDesc.MipLevels = 1;
+    texDesc.MipLevels = residentLevels;
     texDesc.ArraySize = 1;
-    texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texDesc.Format = format;
     texDesc.SampleDesc.Count = 1;
-    texDesc.SampleDesc.Quality = 0;
-    texDesc.Usage = D3D11_USAGE_DEFAULT;
+    texDesc.Usage = D3D11_USAGE_IMMUTABLE;
     texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-    texDesc.CPUAccessFlags = 0;
-    texDesc.MiscFlags = 0;
-
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem = pixels.data();
-    initData.SysMemPitch = stride;
-    initData.SysMemSlicePitch = imageSize;
 
     ComPtr<ID3D11Texture2D> texture;
-    hr = device->CreateTexture2D(&texDesc, &initData, &texture);
+    HRESULT hr = device->CreateTexture2D(&texDesc, subresources.data(), &texture);
+    GpuMemory::Track(texture.Get());
     if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to create texture");
+        DebugManager::GetInstance().Log("TextureLoader", "Failed to create DDS texture, HRESULT: " + std::to_string(hr));
         return false;
     }
 
-    // Create shader resource view
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-    srvDesc.Format = texDesc.Format;
+    srvDesc.Format = format;
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = 1;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = residentLevels;
 
     hr = device->CreateShaderResourceView(texture.Get(), &srvDesc, outTexture);
     if (FAILED(hr)) {
-        DebugManager::GetInstance().Log("TextureLoader", "Failed to create SRV");
+        DebugManager::GetInstance().Log("TextureLoader", "Failed to create DDS SRV");
+        return false;
+    }
+    return true;
+}
+
+bool TextureLoader::LoadWIC(ID3D11Device* device, const std::string& filename, ID3D11ShaderResourceView** outTexture,
+                            bool generateMips, TextureUsage usage) {
+    // 读取原始文件字节（同时作为烘焙缓存的内容哈希输入）
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        DebugManager::GetInstance().Log("TextureLoader", "Failed to open texture: " + filename);
         return false;
     }
+    std::streamsize fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
 
-    DebugManager::GetInstance().Log("TextureLoader", "Successfully loaded texture: " + filename + 
-                                   " (" + std::to_string(width) + "x" + std::to_string(height) + ")");
+    std::vector<unsigned char> data(static_cast<size_t>((std::max)(fileSize, std::streamsize(0))));
+    if (fileSize <= 0 || !file.read(reinterpret_cast<char*>(data.data()), fileSize)) {
+        DebugManager::GetInstance().Log("TextureLoader", "Failed to read texture: " + filename);
+        return false;
+    }
+
+    if (!LoadEncodedImage(device, data.data(), data.size(), outTexture, generateMips, usage, filename)) {
+        return false;
+    }
 
+    OW_LOG_DEBUG("TextureLoader", "Successfully loaded texture: {}", filename);
     return true;
 }
 
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <wrl/client.h>
+#include "TextureCooker.h"
 
 namespace outer_wilds {
 namespace resources {
@@ -11,6 +12,13 @@ namespace resources {
  * Texture loader utility
  * Supports common image formats: JPG, PNG, TGA, BMP, etc.
  * Enhanced for GLB embedded textures
+ *
+ * Mip chains: WIC/RGBA textures get a full mip chain generated on the GPU
+ * (GenerateMips on the immediate context); DDS files use their precomputed mips.
+ *
+ * Cooking: encoded images (JPG/PNG, file or embedded) are looked up in the
+ * TextureCooker cache first; on a miss they are decoded, cooked to BC + mips and
+ * cached, so later launches load the DDS directly.
  */
 class TextureLoader {
 public:
@@ -19,12 +27,16 @@ public:
      * @param device D3D11 device
      * @param filename Path to texture file
      * @param outTexture Output texture resource view
+     * @param generateMips Generate a full mip chain (ignored for DDS, which uses the file's mips)
+     * @param usage Texture role, selects the cooked BC format
      * @return true if successful
      */
     static bool LoadFromFile(
         ID3D11Device* device,
         const std::string& filename,
-        ID3D11ShaderResourceView** outTexture
+        ID3D11ShaderResourceView** outTexture,
+        bool generateMips = true,
+        TextureUsage usage = TextureUsage::Color
     );
 
     /**
@@ -34,6 +46,8 @@ public:
      * @param dataSize Size of image data in bytes
      * @param formatHint Format hint (e.g., "png", "jpg") - can be empty for auto-detection
      * @param outTexture Output texture resource view
+     * @param generateMips Generate a full mip chain
+     * @param usage Texture role, selects the cooked BC format
      * @return true if successful
      */
     static bool LoadFromMemory(
@@ -41,7 +55,9 @@ public:
         const unsigned char* data,
         size_t dataSize,
         const std::string& formatHint,
-        ID3D11ShaderResourceView** outTexture
+        ID3D11ShaderResourceView** outTexture,
+        bool generateMips = true,
+        TextureUsage usage = TextureUsage::Color
     );
 
     /**
@@ -51,6 +67,7 @@ public:
      * @param width Texture width
      * @param height Texture height
      * @param outTexture Output texture resource view
+     * @param generateMips Generate a full mip chain (GPU GenerateMips)
      * @return true if successful
      */
     static bool CreateFromRGBA(
@@ -58,13 +75,120 @@ public:
         const unsigned char* pixels,
         uint32_t width,
         uint32_t height,
-        ID3D11ShaderResourceView** outTexture
+        ID3D11ShaderResourceView** outTexture,
+        bool generateMips = true
     );
 
+    /**
+     * Create texture from an in-memory DDS file (2D, all mips stored in the file)
+     * Supports BC1-BC5/BC7 and 32-bit RGBA/BGRA, legacy or DX10 header
+     * @param skipMips Drop this many of the most detailed levels (texture streaming);
+     *                 clamped so at least one level remains
+     */
+    static bool CreateFromDDSMemory(
+        ID3D11Device* device,
+        const unsigned char* data,
+        size_t dataSize,
+        ID3D11ShaderResourceView** outTexture,
+        uint32_t skipMips = 0
+    );
+
+    /**
+     * Top-level description of a 2D DDS file
+     */
+    struct DDSInfo {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipLevels = 0;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        size_t dataOffset = 0;   // 第 0 级 mip 在文件中的偏移
+    };
+
+    /**
+     * Parse and validate a DDS header (same rules as CreateFromDDSMemory, no GPU work)
+     */
+    static bool ReadDDSInfo(const unsigned char* data, size_t dataSize, DDSInfo& outInfo);
+
+    /**
+     * GPU bytes of mip levels [firstMip, mipLevels) of a texture
+     */
+    static uint64_t CalculateTextureBytes(DXGI_FORMAT format, uint32_t width, uint32_t height,
+                                          uint32_t mipLevels, uint32_t firstMip = 0);
+
+    /**
+     * CPU-side result of decoding an encoded image, ready for GPU creation
+     * Either a cooked block-compressed DDS (cache hit or freshly cooked) or RGBA8 pixels
+     */
+    struct DecodedImage {
+        std::vector<unsigned char> dds;
+        std::vector<unsigned char> pixels;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        bool IsValid() const { return !dds.empty() || !pixels.empty(); }
+    };
+
+    /**
+     * Decode an encoded image (cooked cache lookup, WIC decode, cook + cache write)
+     * Touches no D3D objects: safe to run on worker threads in parallel
+     */
+    static bool DecodeImage(
+        const unsigned char* data,
+        size_t dataSize,
+        DecodedImage& outImage,
+        bool generateMips = true,
+        TextureUsage usage = TextureUsage::Color,
+        const std::string& label = "[memory]"
+    );
+
+    /**
+     * Create the SRV for a decoded image (second half of LoadFromMemory)
+     */
+    static bool CreateFromDecoded(
+        ID3D11Device* device,
+        const DecodedImage& image,
+        ID3D11ShaderResourceView** outTexture,
+        bool generateMips = true
+    );
+
+    /**
+     * Immediate-context work (level-0 upload + GenerateMips of RGBA fallback textures)
+     * Threads other than the render thread call SetDeferImmediateContextWork(true) for
+     * themselves (thread-local): the work is queued and the texture's contents are
+     * undefined until FlushDeferredWork runs on the render thread
+     */
+    static void SetDeferImmediateContextWork(bool defer);
+    static void FlushDeferredWork();
+
+    /**
+     * Number of levels in a full mip chain (down to 1x1)
+     */
+    static uint32_t CalculateMipCount(uint32_t width, uint32_t height);
+
+    /**
+     * Bytes per 4x4 block for BC formats, 0 for uncompressed formats
+     */
+    static uint32_t GetBlockBytes(DXGI_FORMAT format);
+
+    /**
+     * Row pitch and row count of one mip surface (rows are block rows for BC formats)
+     */
+    static bool GetSurfaceInfo(DXGI_FORMAT format, uint32_t width, uint32_t height,
+                               uint32_t& outRowPitch, uint32_t& outRowCount);
+
+    /**
+     * Decode an encoded image (PNG/JPG/...) to tightly packed RGBA8 via WIC, without creating a texture
+     */
+    static bool DecodeWIC(const unsigned char* data, size_t dataSize, std::vector<unsigned char>& outPixels,
+                          UINT& outWidth, UINT& outHeight);
+
 private:
     static bool LoadDDS(ID3D11Device* device, const std::string& filename, ID3D11ShaderResourceView** outTexture);
-    static bool LoadWIC(ID3D11Device* device, const std::string& filename, ID3D11ShaderResourceView** outTexture);
-    static bool LoadWICFromMemory(ID3D11Device* device, const unsigned char* data, size_t dataSize, ID3D11ShaderResourceView** outTexture);
+    static bool LoadWIC(ID3D11Device* device, const std::string& filename, ID3D11ShaderResourceView** outTexture,
+                        bool generateMips, TextureUsage usage);
+    static bool LoadEncodedImage(ID3D11Device* device, const unsigned char* data, size_t dataSize,
+                                 ID3D11ShaderResourceView** outTexture, bool generateMips, TextureUsage usage,
+                                 const std::string& label);
 };
 
 } // namespace resources
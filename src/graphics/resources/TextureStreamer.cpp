@@ -0,0 +1,329 @@
+#include "TextureStreamer.h"
+#include "TextureLoader.h"
+#include "../../scene/AssetStreamer.h"
+#include "../../core/DebugManager.h"
+#include "../../core/MemoryTracker.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+
+namespace outer_wilds {
+namespace resources {
+
+namespace {
+    bool ReadFileBytes(const std::string& path, std::vector<unsigned char>& out) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        const std::streamsize size = file.tellg();
+        if (size <= 0) return false;
+        file.seekg(0, std::ios::beg);
+        out.resize(static_cast<size_t>(size));
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), size));
+    }
+
+    bool IsDDSPath(const std::string& path) {
+        const size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos) return false;
+        std::string ext = path.substr(dot + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        return ext == "dds";
+    }
+
+    // 创建跳过 skip 级的纹理；块压缩尺寸约束可能让 TextureLoader 少跳几级，返回实际值
+    bool CreateLevel(ID3D11Device* device, const std::vector<unsigned char>& dds, uint32_t mipLevels, uint32_t skip,
+                     ComPtr<ID3D11ShaderResourceView>& outSRV, uint32_t& outSkip) {
+        if (!TextureLoader::CreateFromDDSMemory(device, dds.data(), dds.size(), outSRV.ReleaseAndGetAddressOf(), skip)) {
+            return false;
+        }
+        ComPtr<ID3D11Resource> resource;
+        outSRV->GetResource(&resource);
+        ComPtr<ID3D11Texture2D> texture;
+        if (FAILED(resource.As(&texture))) return false;
+        D3D11_TEXTURE2D_DESC desc = {};
+        texture->GetDesc(&desc);
+        outSkip = mipLevels - desc.MipLevels;
+        return true;
+    }
+}
+
+uint32_t TextureStreamer::SkipForTexels(uint32_t maxDimension, float texels, uint32_t maxSkip) {
+    if (!(texels < FLT_MAX) || texels >= static_cast<float>(maxDimension)) return 0;
+    uint32_t skip = 0;
+    // 保留第一个不小于需求的级别
+    while (skip < maxSkip && static_cast<float>(maxDimension >> (skip + 1)) >= texels) {
+        skip++;
+    }
+    return skip;
+}
+
+bool TextureStreamer::Load(ID3D11Device* device, const std::string& path, TextureUsage usage,
+                           ID3D11ShaderResourceView** outBase) {
+    if (!m_Enabled || !device || !outBase) return false;
+
+    // 流式加载的数据源：块压缩 DDS（原始 .dds 或烘焙缓存中的条目）
+    std::string ddsPath;
+    std::vector<unsigned char> dds;
+    if (IsDDSPath(path)) {
+        ddsPath = path;
+        if (!ReadFileBytes(path, dds)) return false;
+    } else {
+        if (!TextureCooker::IsEnabled()) return false;
+        std::vector<unsigned char> source;
+        if (!ReadFileBytes(path, source)) return false;
+        // 与 TextureLoader::LoadFromFile(generateMips = true) 使用同一个键
+        const uint64_t hash = TextureCooker::HashSource(source.data(), source.size(), usage, true);
+        if (!TextureCooker::ReadCached(hash, dds)) return false;   // 首次运行：TextureLoader 负责烘焙
+        ddsPath = TextureCooker::GetCachePath(hash);
+    }
+
+    TextureLoader::DDSInfo info;
+    if (!TextureLoader::ReadDDSInfo(dds.data(), dds.size(), info) || TextureLoader::GetBlockBytes(info.format) == 0) {
+        return false;
+    }
+
+    // 计算基础级别：最大边不超过 baseResolution
+    const uint32_t maxDimension = (std::max)(info.width, info.height);
+    uint32_t baseSkip = 0;
+    while (baseSkip + 1 < info.mipLevels && (maxDimension >> baseSkip) > m_BaseResolution) {
+        baseSkip++;
+    }
+
+    ComPtr<ID3D11ShaderResourceView> base;
+    uint32_t actualSkip = 0;
+    if (!CreateLevel(device, dds, info.mipLevels, baseSkip, base, actualSkip)) {
+        return false;
+    }
+    if (actualSkip == 0) {
+        // 本来就不大：整张常驻，不需要管理
+        *outBase = base.Detach();
+        return true;
+    }
+
+    Entry entry;
+    entry.ddsPath = ddsPath;
+    entry.format = info.format;
+    entry.width = info.width;
+    entry.height = info.height;
+    entry.mipLevels = info.mipLevels;
+    entry.baseSkip = actualSkip;
+    entry.residentSkip = actualSkip;
+    entry.baseBytes = TextureLoader::CalculateTextureBytes(info.format, info.width, info.height, info.mipLevels, actualSkip);
+
+    ID3D11ShaderResourceView* key = base.Detach();
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_ResidentBytes += entry.baseBytes;
+        entry.lastUsedFrame = m_Frame;
+        entry.id = ++m_NextEntryId;
+        m_Entries.emplace(key, std::move(entry));
+    }
+    OW_LOG_DEBUG("TextureStreamer", "Streaming {} ({}x{}, base mip {})", path, info.width, info.height, actualSkip);
+    *outBase = key;
+    return true;
+}
+
+void TextureStreamer::Unregister(ID3D11ShaderResourceView* base) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(base);
+    if (it == m_Entries.end()) return;
+    ReleaseStreamed(it->second);
+    m_ResidentBytes -= it->second.baseBytes;
+    if (it->second.pending) m_PendingBytes -= it->second.pendingBytes;
+    m_Entries.erase(it);   // 进行中的加载完成时找不到条目（或 id 不符），结果直接释放
+}
+
+void TextureStreamer::Request(ID3D11ShaderResourceView* texture, float screenRadius) {
+    if (!texture) return;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(texture);
+    if (it == m_Entries.end()) return;
+
+    Entry& entry = it->second;
+    const float texels = screenRadius < FLT_MAX
+        ? screenRadius * static_cast<float>(m_ViewportHeight) * kTexelsPerPixel
+        : FLT_MAX;
+    const uint32_t skip = SkipForTexels((std::max)(entry.width, entry.height), texels, entry.baseSkip);
+    entry.requestedSkip = (std::min)(entry.requestedSkip, skip);
+}
+
+ID3D11ShaderResourceView* TextureStreamer::Resolve(ID3D11ShaderResourceView* texture) const {
+    if (!texture) return nullptr;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(texture);
+    if (it == m_Entries.end() || !it->second.streamed) return texture;
+    return it->second.streamed.Get();
+}
+
+bool TextureStreamer::HasTextures() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return !m_Entries.empty();
+}
+
+bool TextureStreamer::IsManaged(ID3D11ShaderResourceView* texture) const {
+    if (!texture) return false;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Entries.find(texture) != m_Entries.end();
+}
+
+void TextureStreamer::ReleaseStreamed(Entry& entry) {
+    if (!entry.streamed) return;
+    // 立即上下文仍绑定时由 D3D 持有引用，这里直接释放是安全的
+    entry.streamed.Reset();
+    m_ResidentBytes -= entry.streamedBytes;
+    entry.streamedBytes = 0;
+    entry.residentSkip = entry.baseSkip;
+}
+
+bool TextureStreamer::EvictLeastRecentlyUsed(const Entry* keep) {
+    Entry* victim = nullptr;
+    for (auto& pair : m_Entries) {
+        Entry& entry = pair.second;
+        if (&entry == keep || !entry.streamed || entry.pending || entry.lastUsedFrame >= m_Frame) continue;
+        if (!victim || entry.lastUsedFrame < victim->lastUsedFrame) victim = &entry;
+    }
+    if (!victim) return false;
+    ReleaseStreamed(*victim);
+    m_Evictions++;
+    return true;
+}
+
+void TextureStreamer::Update() {
+    struct Upgrade {
+        ID3D11ShaderResourceView* key;
+        Entry* entry;
+        uint32_t skip;
+    };
+    std::vector<Upgrade> upgrades;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Frame++;
+
+    for (auto& pair : m_Entries) {
+        Entry& entry = pair.second;
+        const bool requested = entry.requestedSkip != UINT32_MAX;
+        const uint32_t wanted = requested ? entry.requestedSkip : entry.baseSkip;
+        entry.requestedSkip = UINT32_MAX;
+        if (requested) entry.lastUsedFrame = m_Frame;
+
+        if (entry.streamed && !entry.pending) {
+            // 长时间不可见，或已远到基础级别就够用：回退
+            const bool idle = m_Frame - entry.lastUsedFrame > kIdleFrames;
+            if (idle || (requested && wanted >= entry.baseSkip)) {
+                ReleaseStreamed(entry);
+                m_Evictions++;
+                continue;
+            }
+        }
+
+        if (requested && wanted < entry.residentSkip && !entry.pending && !entry.failed) {
+            upgrades.push_back({ pair.first, &entry, wanted });
+        }
+    }
+
+    // 需求最大的（跳级最少）优先占用预算
+    std::sort(upgrades.begin(), upgrades.end(),
+              [](const Upgrade& a, const Upgrade& b) { return a.skip < b.skip; });
+
+    for (const Upgrade& upgrade : upgrades) {
+        Entry& entry = *upgrade.entry;
+        const uint64_t bytes = TextureLoader::CalculateTextureBytes(entry.format, entry.width, entry.height,
+                                                                    entry.mipLevels, upgrade.skip);
+        // 替换时旧的高分辨率级别在新级别到达后才释放，两者短暂共存
+        while (m_ResidentBytes + m_PendingBytes + bytes > m_BudgetBytes) {
+            if (!EvictLeastRecentlyUsed(&entry)) break;
+        }
+        if (m_ResidentBytes + m_PendingBytes + bytes > m_BudgetBytes) {
+            m_BudgetRejections++;
+            continue;
+        }
+        entry.pendingBytes = bytes;
+        Schedule(upgrade.key, entry, upgrade.skip);
+    }
+}
+
+void TextureStreamer::Schedule(ID3D11ShaderResourceView* key, Entry& entry, uint32_t skip) {
+    entry.pending = true;
+    entry.pendingSkip = skip;
+    m_PendingBytes += entry.pendingBytes;
+
+    ComPtr<ID3D11Device> device;
+    key->GetDevice(&device);
+    const std::string path = entry.ddsPath;
+    const uint32_t mipLevels = entry.mipLevels;
+    const uint64_t id = entry.id;
+
+    AssetStreamer::GetInstance().Submit([device, path, mipLevels, skip, key, id]() -> AssetStreamer::ApplyFn {
+        // 加载线程：读文件 + 创建不可变纹理（不需要立即上下文）
+        OW_MEMORY_SCOPE(Textures);
+        ComPtr<ID3D11ShaderResourceView> srv;
+        std::vector<unsigned char> dds;
+        uint32_t actualSkip = skip;
+        if (!ReadFileBytes(path, dds) || !CreateLevel(device.Get(), dds, mipLevels, skip, srv, actualSkip)) {
+            DebugManager::GetInstance().Log("TextureStreamer", "Failed to stream texture: " + path);
+            srv.Reset();
+        }
+        return [key, id, actualSkip, srv](entt::registry&) {
+            TextureStreamer::GetInstance().CompleteLoad(key, id, actualSkip, srv);
+        };
+    });
+}
+
+void TextureStreamer::CompleteLoad(ID3D11ShaderResourceView* key, uint64_t id, uint32_t skip,
+                                   ComPtr<ID3D11ShaderResourceView> srv) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(key);
+    // 已注销：srv 随 ComPtr 释放。id 不符说明原纹理已释放、新纹理复用了同一个 SRV 地址
+    if (it == m_Entries.end() || it->second.id != id || !it->second.pending) return;
+
+    Entry& entry = it->second;
+    entry.pending = false;
+    m_PendingBytes -= entry.pendingBytes;
+    if (!srv) {
+        entry.failed = true;
+        return;
+    }
+
+    ReleaseStreamed(entry);
+    entry.streamed = std::move(srv);
+    entry.residentSkip = skip;
+    entry.streamedBytes = TextureLoader::CalculateTextureBytes(entry.format, entry.width, entry.height,
+                                                               entry.mipLevels, skip);
+    m_ResidentBytes += entry.streamedBytes;
+    m_StreamIns++;
+}
+
+void TextureStreamer::Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (auto& pair : m_Entries) {
+        ReleaseStreamed(pair.second);
+    }
+    m_Entries.clear();
+    m_ResidentBytes = 0;
+    m_PendingBytes = 0;
+}
+
+TextureStreamer::Stats TextureStreamer::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    Stats stats;
+    stats.streamedTextures = static_cast<uint32_t>(m_Entries.size());
+    for (const auto& pair : m_Entries) {
+        const Entry& entry = pair.second;
+        if (entry.residentSkip == 0) stats.fullResolution++;
+        if (entry.pending) stats.pendingLoads++;
+        stats.fullResidencyBytes += TextureLoader::CalculateTextureBytes(entry.format, entry.width, entry.height,
+                                                                         entry.mipLevels, 0);
+    }
+    stats.residentBytes = m_ResidentBytes;
+    stats.budgetBytes = m_BudgetBytes;
+    stats.streamIns = m_StreamIns;
+    stats.evictions = m_Evictions;
+    stats.budgetRejections = m_BudgetRejections;
+    return stats;
+}
+
+} // namespace resources
+} // namespace outer_wilds
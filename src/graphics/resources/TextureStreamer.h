@@ -0,0 +1,152 @@
+/**
+ * TextureStreamer.h
+ *
+ * 按距离 / 屏幕尺寸的纹理流式加载（块压缩 DDS，来自 TextureCooker 缓存或源 .dds 文件）
+ *
+ * - 加载时只创建低分辨率的 mip 尾部（最大边 <= baseResolution），这个"基础 SRV"常驻，
+ *   也是 Material / ResourceCache / RenderQueue 看到的纹理身份（指针稳定，排序和实例化不受影响）
+ * - RenderQueue 每帧为可见批次的纹理报告投影尺寸（Request），Update 据此在 AssetStreamer 的加载线程上
+ *   创建更高分辨率的完整纹理；绘制前 Resolve 把基础 SRV 换成当前最高的常驻级别
+ * - 显存预算：基础级别 + 高分辨率级别的总字节数不超过 budget，超出时按 LRU（最久未被请求）回退到基础级别
+ * - 长时间不可见的纹理也会回退（星系另一侧的星球不再占用 2k 纹理）
+ *
+ * 只处理经 ResourceCache::AcquireTexture 加载的文件纹理；内嵌纹理和未烘焙的源图仍整张常驻。
+ * 线程安全：Load / Unregister 可在加载线程上调用；Request / Update / Resolve 在主线程（渲染准备阶段）。
+ */
+
+#pragma once
+#include "TextureCooker.h"
+#include <d3d11.h>
+#include <wrl/client.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace outer_wilds {
+namespace resources {
+
+class TextureStreamer {
+public:
+    struct Stats {
+        uint32_t streamedTextures = 0;   // 受管理的纹理数
+        uint32_t fullResolution = 0;     // 当前以完整分辨率常驻的纹理数
+        uint32_t pendingLoads = 0;
+        uint64_t residentBytes = 0;      // 基础 + 高分辨率级别
+        uint64_t fullResidencyBytes = 0; // 全部完整常驻时的字节数（对比用）
+        uint64_t budgetBytes = 0;
+        uint32_t streamIns = 0;
+        uint32_t evictions = 0;
+        uint32_t budgetRejections = 0;   // 因预算不足而推迟的升级请求
+    };
+
+    static TextureStreamer& GetInstance() {
+        static TextureStreamer instance;
+        return instance;
+    }
+
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsEnabled() const { return m_Enabled; }
+
+    void SetBudgetBytes(uint64_t bytes) { m_BudgetBytes = bytes; }
+    uint64_t GetBudgetBytes() const { return m_BudgetBytes; }
+
+    /** @brief 常驻基础级别的最大边长（之后加载的纹理生效） */
+    void SetBaseResolution(uint32_t texels) { m_BaseResolution = texels; }
+
+    /** @brief 渲染目标高度（像素），把投影半径换算成需要的纹素数 */
+    void SetViewportHeight(uint32_t pixels) { m_ViewportHeight = pixels; }
+
+    /**
+     * @brief 以流式方式加载纹理：只创建基础级别
+     * @param outBase 基础 SRV（归调用方所有，释放前调用 Unregister）
+     * @return false 表示不适合流式加载（没有烘焙缓存、不是块压缩 DDS），调用方应走 TextureLoader
+     */
+    bool Load(ID3D11Device* device, const std::string& path, TextureUsage usage, ID3D11ShaderResourceView** outBase);
+
+    /** @brief 停止管理（同时释放高分辨率级别），基础 SRV 由调用方释放 */
+    void Unregister(ID3D11ShaderResourceView* base);
+
+    /**
+     * @brief 报告本帧某个纹理的投影尺寸
+     * @param screenRadius 包围球投影半径占半个视口高度的比例（RenderQueue 的约定；FLT_MAX = 未知，按最大需求处理）
+     */
+    void Request(ID3D11ShaderResourceView* texture, float screenRadius);
+
+    /** @brief 绘制时使用的 SRV：当前最高的常驻级别（非流式纹理原样返回） */
+    ID3D11ShaderResourceView* Resolve(ID3D11ShaderResourceView* texture) const;
+
+    bool HasTextures() const;
+
+    /** @brief 是否为流式纹理（基础级别会被 Resolve 换掉，不能复制进 TextureArrayAtlas） */
+    bool IsManaged(ID3D11ShaderResourceView* texture) const;
+
+    /**
+     * @brief 每帧一次（Request 之后）：按请求安排升级、按 LRU 和空闲时间回退
+     */
+    void Update();
+
+    /** @brief 释放全部高分辨率级别并停止管理（ResourceCache::Clear） */
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        uint64_t id = 0;                        // 注册序号：SRV 地址可能被复用，进行中的加载按它确认目标
+        std::string ddsPath;
+        DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipLevels = 0;
+        uint32_t baseSkip = 0;                  // 基础 SRV 跳过的级别数
+        uint32_t residentSkip = 0;              // 当前最高常驻级别（== baseSkip 表示只有基础级别）
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> streamed;
+        uint64_t baseBytes = 0;
+        uint64_t streamedBytes = 0;
+        uint32_t requestedSkip = UINT32_MAX;    // 本帧请求的最小跳级（UINT32_MAX = 未请求）
+        uint64_t lastUsedFrame = 0;
+        uint32_t pendingSkip = 0;
+        uint64_t pendingBytes = 0;
+        bool pending = false;
+        bool failed = false;                    // 高分辨率加载失败过：不再重试
+    };
+
+    TextureStreamer() = default;
+    ~TextureStreamer() = default;
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /** @brief 已知 maxDimension 和需要的纹素数时的跳级 */
+    static uint32_t SkipForTexels(uint32_t maxDimension, float texels, uint32_t maxSkip);
+    void ReleaseStreamed(Entry& entry);
+    void Schedule(ID3D11ShaderResourceView* key, Entry& entry, uint32_t skip);
+    void CompleteLoad(ID3D11ShaderResourceView* key, uint64_t id, uint32_t skip,
+                      Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> srv);
+    /** @brief 释放最久未使用（且本帧未请求）的高分辨率级别，返回是否释放了 */
+    bool EvictLeastRecentlyUsed(const Entry* keep);
+
+    mutable std::mutex m_Mutex;
+    std::unordered_map<ID3D11ShaderResourceView*, Entry> m_Entries;
+
+    bool m_Enabled = true;
+    uint64_t m_BudgetBytes = 256ull * 1024 * 1024;
+    uint32_t m_BaseResolution = 128;
+    uint32_t m_ViewportHeight = 1080;
+    uint64_t m_Frame = 0;
+    uint64_t m_NextEntryId = 0;
+
+    uint64_t m_ResidentBytes = 0;
+    uint64_t m_PendingBytes = 0;
+    uint32_t m_StreamIns = 0;
+    uint32_t m_Evictions = 0;
+    uint32_t m_BudgetRejections = 0;
+
+    // 可见纹理边长 ≈ 2 × 投影直径（赤道展开的贴图绕天体一周，可见半球只占一半宽度）
+    static constexpr float kTexelsPerPixel = 2.0f;
+    // 连续这么多帧未被请求的纹理回退到基础级别
+    static constexpr uint64_t kIdleFrames = 300;
+};
+
+} // namespace resources
+} // namespace outer_wilds
@@ -1,9 +1,37 @@
 #include "InputManager.h"
 #include "../core/DebugManager.h"
+#include <cstring>
 #include <iostream>
 
 namespace outer_wilds {
 
+namespace {
+
+struct DefaultBinding {
+    InputAction action;
+    int primary;
+    int secondary;
+};
+
+constexpr DefaultBinding kDefaultBindings[] = {
+    { InputAction::MoveForward,     'W',        0 },
+    { InputAction::MoveBackward,    'S',        0 },
+    { InputAction::MoveLeft,        'A',        0 },
+    { InputAction::MoveRight,       'D',        0 },
+    { InputAction::Jump,            VK_SPACE,   0 },
+    { InputAction::Sprint,          VK_SHIFT,   0 },
+    { InputAction::Crouch,          VK_CONTROL, 0 },
+    { InputAction::Interact,        'F',        0 },
+    { InputAction::ToggleMouseLook, VK_ESCAPE,  0 },
+};
+
+// HID usage（Generic Desktop 页）
+constexpr USHORT kUsagePageGeneric = 0x01;
+constexpr USHORT kUsageMouse = 0x02;
+constexpr USHORT kUsageKeyboard = 0x06;
+
+} // namespace
+
 InputManager& InputManager::GetInstance() {
     static InputManager instance;
     return instance;
@@ -11,29 +39,49 @@ InputManager& InputManager::GetInstance() {
 
 void InputManager::Initialize(HWND hwnd) {
     m_Hwnd = hwnd;
-    memset(m_CurrentKeyState, 0, sizeof(m_CurrentKeyState));
-    memset(m_PreviousKeyState, 0, sizeof(m_PreviousKeyState));
+    m_Frame = {};
+    memset(m_EventKeys, 0, sizeof(m_EventKeys));
+    memset(m_EventPressed, 0, sizeof(m_EventPressed));
+    memset(m_EventReleased, 0, sizeof(m_EventReleased));
+    m_RawDeltaX = m_RawDeltaY = 0;
+    m_HasAbsolute = false;
+
+    // 无窗口（基准模式）：不读取任何硬件输入，输入只来自回放
+    if (!m_Hwnd) {
+        m_RawInputActive = false;
+        return;
+    }
+
+    m_RawInputActive = RegisterRawInput();
+    if (!m_RawInputActive) {
+        DebugManager::GetInstance().Log("Input", "RegisterRawInputDevices failed, falling back to polling");
+    }
 
     // Get initial mouse position
     GetCursorPos(&m_CurrentMousePos);
     ScreenToClient(m_Hwnd, &m_CurrentMousePos);
     m_PreviousMousePos = m_CurrentMousePos;
-    m_LastMousePos = m_CurrentMousePos;
-    
+
     // Enable mouse look by default
     m_MouseLookEnabled = true;
     m_PlayerInput.mouseLookEnabled = true;
     SetMouseCapture(true);
+}
 
-    
+bool InputManager::RegisterRawInput() {
+    // 不带 RIDEV_NOLEGACY：ImGui 仍然需要 WM_KEYDOWN / WM_CHAR / WM_MOUSEMOVE
+    RAWINPUTDEVICE devices[2] = {};
+    devices[0].usUsagePage = kUsagePageGeneric;
+    devices[0].usUsage = kUsageMouse;
+    devices[0].hwndTarget = m_Hwnd;
+    devices[1].usUsagePage = kUsagePageGeneric;
+    devices[1].usUsage = kUsageKeyboard;
+    devices[1].hwndTarget = m_Hwnd;
+    return RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE)) != FALSE;
 }
 
 void InputManager::Update() {
-    // Update previous states
-    memcpy(m_PreviousKeyState, m_CurrentKeyState, sizeof(m_CurrentKeyState));
-    m_PreviousMousePos = m_CurrentMousePos;
-
-    // Update current states
+    // 把两帧之间累积的事件固定成本帧快照
     UpdateKeyboardState();
     UpdateMouseState();
 
@@ -41,24 +89,224 @@ void InputManager::Update() {
     UpdatePlayerInput();
 }
 
+void InputManager::HandleRawInput(LPARAM lParam) {
+    if (!m_RawInputActive) return;
+
+    RAWINPUT raw;
+    UINT size = sizeof(raw);
+    if (GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT, &raw, &size,
+                        sizeof(RAWINPUTHEADER)) == static_cast<UINT>(-1)) {
+        return;
+    }
+
+    if (raw.header.dwType == RIM_TYPEKEYBOARD) {
+        const RAWKEYBOARD& keyboard = raw.data.keyboard;
+        int key = keyboard.VKey;
+        if (key == 0 || key >= 255) return;   // 0xFF：转义序列的一部分，不是真正的按键
+
+        const bool down = (keyboard.Flags & RI_KEY_BREAK) == 0;
+        const bool extended = (keyboard.Flags & RI_KEY_E0) != 0;
+
+        // 修饰键拆成左右键，通用键 = 左右任一按下（与 GetKeyboardState 一致）
+        int generic = 0;
+        switch (key) {
+            case VK_SHIFT:   generic = VK_SHIFT;   key = keyboard.MakeCode == 0x36 ? VK_RSHIFT : VK_LSHIFT; break;
+            case VK_CONTROL: generic = VK_CONTROL; key = extended ? VK_RCONTROL : VK_LCONTROL; break;
+            case VK_MENU:    generic = VK_MENU;    key = extended ? VK_RMENU : VK_LMENU; break;
+            default: break;
+        }
+
+        SetKeyDown(key, down);
+        if (generic != 0) {
+            const int left = generic == VK_SHIFT ? VK_LSHIFT : (generic == VK_CONTROL ? VK_LCONTROL : VK_LMENU);
+            const int right = generic == VK_SHIFT ? VK_RSHIFT : (generic == VK_CONTROL ? VK_RCONTROL : VK_RMENU);
+            SetKeyDown(generic, TestBit(m_EventKeys, left) || TestBit(m_EventKeys, right));
+        }
+    } else if (raw.header.dwType == RIM_TYPEMOUSE) {
+        const RAWMOUSE& mouse = raw.data.mouse;
+        if (mouse.usFlags & MOUSE_MOVE_ABSOLUTE) {
+            // 绝对坐标归一化到 0..65535，换算成像素差
+            const bool virtualDesktop = (mouse.usFlags & MOUSE_VIRTUAL_DESKTOP) != 0;
+            const int width = GetSystemMetrics(virtualDesktop ? SM_CXVIRTUALSCREEN : SM_CXSCREEN);
+            const int height = GetSystemMetrics(virtualDesktop ? SM_CYVIRTUALSCREEN : SM_CYSCREEN);
+            const LONG x = static_cast<LONG>((static_cast<int64_t>(mouse.lLastX) * width) / 65535);
+            const LONG y = static_cast<LONG>((static_cast<int64_t>(mouse.lLastY) * height) / 65535);
+            if (m_HasAbsolute) {
+                m_RawDeltaX += x - m_LastAbsoluteX;
+                m_RawDeltaY += y - m_LastAbsoluteY;
+            }
+            m_LastAbsoluteX = x;
+            m_LastAbsoluteY = y;
+            m_HasAbsolute = true;
+        } else {
+            m_RawDeltaX += mouse.lLastX;
+            m_RawDeltaY += mouse.lLastY;
+        }
+
+        const USHORT buttons = mouse.usButtonFlags;
+        if (buttons & RI_MOUSE_LEFT_BUTTON_DOWN)   SetKeyDown(VK_LBUTTON, true);
+        if (buttons & RI_MOUSE_LEFT_BUTTON_UP)     SetKeyDown(VK_LBUTTON, false);
+        if (buttons & RI_MOUSE_RIGHT_BUTTON_DOWN)  SetKeyDown(VK_RBUTTON, true);
+        if (buttons & RI_MOUSE_RIGHT_BUTTON_UP)    SetKeyDown(VK_RBUTTON, false);
+        if (buttons & RI_MOUSE_MIDDLE_BUTTON_DOWN) SetKeyDown(VK_MBUTTON, true);
+        if (buttons & RI_MOUSE_MIDDLE_BUTTON_UP)   SetKeyDown(VK_MBUTTON, false);
+        if (buttons & RI_MOUSE_BUTTON_4_DOWN)      SetKeyDown(VK_XBUTTON1, true);
+        if (buttons & RI_MOUSE_BUTTON_4_UP)        SetKeyDown(VK_XBUTTON1, false);
+        if (buttons & RI_MOUSE_BUTTON_5_DOWN)      SetKeyDown(VK_XBUTTON2, true);
+        if (buttons & RI_MOUSE_BUTTON_5_UP)        SetKeyDown(VK_XBUTTON2, false);
+    }
+}
+
+bool InputManager::PeekLateLookDelta(int& deltaX, int& deltaY) {
+    deltaX = deltaY = 0;
+    if (!m_RawInputActive || !m_MouseLookEnabled || !m_HasFocus) return false;
+
+    // 只取 WM_INPUT，其余消息留给下一帧开头的消息循环
+    MSG msg;
+    while (PeekMessage(&msg, m_Hwnd, WM_INPUT, WM_INPUT, PM_REMOVE)) {
+        DispatchMessage(&msg);
+    }
+    deltaX = static_cast<int>(m_RawDeltaX);
+    deltaY = static_cast<int>(m_RawDeltaY);
+    return true;
+}
+
+void InputManager::SetKeyDown(int key, bool down) {
+    const uint8_t mask = static_cast<uint8_t>(1u << (key & 7));
+    uint8_t& held = m_EventKeys[key >> 3];
+    if (down) {
+        // 键盘自动重复会连续发送按下，只记录第一次
+        if (!(held & mask)) {
+            held |= mask;
+            m_EventPressed[key >> 3] |= mask;
+        }
+    } else if (held & mask) {
+        held &= static_cast<uint8_t>(~mask);
+        m_EventReleased[key >> 3] |= mask;
+    }
+}
+
+void InputManager::ReleaseAllKeys() {
+    for (int key = 0; key < 256; key++) {
+        SetKeyDown(key, false);
+    }
+}
+
+void InputManager::HandleFocusChange(bool focused) {
+    m_HasFocus = focused;
+    if (!focused) {
+        // 失去焦点后收不到松开事件：按键全部视为松开，丢弃未消费的鼠标移动
+        ReleaseAllKeys();
+        m_RawDeltaX = m_RawDeltaY = 0;
+        m_HasAbsolute = false;
+        ClipCursor(nullptr);
+    } else {
+        RefreshCursorClip();
+    }
+}
+
+void InputManager::RefreshCursorClip() {
+    if (!m_Hwnd || !m_MouseCaptured || !m_HasFocus) return;
+    RECT clientRect;
+    GetClientRect(m_Hwnd, &clientRect);
+    MapWindowPoints(m_Hwnd, nullptr, reinterpret_cast<POINT*>(&clientRect), 2);
+    ClipCursor(&clientRect);
+}
+
 void InputManager::UpdateKeyboardState() {
-    GetKeyboardState(m_CurrentKeyState);
+    if (!m_Hwnd) {
+        // 无窗口：控制台的按键不应影响基准运行
+        m_Frame = {};
+        return;
+    }
+
+    if (m_RawInputActive) {
+        memcpy(m_Frame.keys, m_EventKeys, sizeof(m_Frame.keys));
+        memcpy(m_Frame.pressed, m_EventPressed, sizeof(m_Frame.pressed));
+        memcpy(m_Frame.released, m_EventReleased, sizeof(m_Frame.released));
+        memset(m_EventPressed, 0, sizeof(m_EventPressed));
+        memset(m_EventReleased, 0, sizeof(m_EventReleased));
+        return;
+    }
+
+    // 轮询：边沿只能由两次采样的差得到
+    uint8_t previous[32];
+    memcpy(previous, m_Frame.keys, sizeof(previous));
+    BYTE keyState[256];
+    GetKeyboardState(keyState);
+    memset(m_Frame.keys, 0, sizeof(m_Frame.keys));
+    for (int key = 0; key < 256; key++) {
+        if (keyState[key] & 0x80) SetBit(m_Frame.keys, key);
+    }
+    for (int i = 0; i < 32; i++) {
+        m_Frame.pressed[i] = static_cast<uint8_t>(m_Frame.keys[i] & ~previous[i]);
+        m_Frame.released[i] = static_cast<uint8_t>(previous[i] & ~m_Frame.keys[i]);
+    }
 }
 
 void InputManager::UpdateMouseState() {
+    if (!m_Hwnd) return;
+
+    if (m_RawInputActive) {
+        m_Frame.mouseDeltaX = static_cast<int32_t>(m_RawDeltaX);
+        m_Frame.mouseDeltaY = static_cast<int32_t>(m_RawDeltaY);
+        m_RawDeltaX = m_RawDeltaY = 0;
+        return;
+    }
+
+    m_PreviousMousePos = m_CurrentMousePos;
     GetCursorPos(&m_CurrentMousePos);
     ScreenToClient(m_Hwnd, &m_CurrentMousePos);
+
+    if (m_MouseLookEnabled && m_MouseCaptured && m_HasFocus) {
+        // 轮询回退：相对窗口中心求差并把光标拉回中心（允许无限旋转）
+        RECT clientRect;
+        GetClientRect(m_Hwnd, &clientRect);
+        const int centerX = (clientRect.left + clientRect.right) / 2;
+        const int centerY = (clientRect.top + clientRect.bottom) / 2;
+        m_Frame.mouseDeltaX = m_CurrentMousePos.x - centerX;
+        m_Frame.mouseDeltaY = m_CurrentMousePos.y - centerY;
+
+        POINT centerPosScreen = { centerX, centerY };
+        ClientToScreen(m_Hwnd, &centerPosScreen);
+        SetCursorPos(centerPosScreen.x, centerPosScreen.y);
+        m_CurrentMousePos = { centerX, centerY };
+    } else {
+        m_Frame.mouseDeltaX = m_CurrentMousePos.x - m_PreviousMousePos.x;
+        m_Frame.mouseDeltaY = m_CurrentMousePos.y - m_PreviousMousePos.y;
+    }
 }
 
 void InputManager::UpdatePlayerInput() {
+    UpdateLookInput();
+    UpdateButtonInput();
+}
+
+void InputManager::UpdateLookInput() {
+    // 无窗口（基准模式）时不读鼠标，视角输入只来自回放
+    if (m_MouseLookEnabled && m_Hwnd && m_HasFocus) {
+        m_Frame.lookX = static_cast<float>(m_Frame.mouseDeltaX);
+        m_Frame.lookY = static_cast<float>(m_Frame.mouseDeltaY);
+    } else {
+        m_Frame.lookX = 0.0f;
+        m_Frame.lookY = 0.0f;
+    }
+    m_PlayerInput.lookInput.x = m_Frame.lookX;
+    m_PlayerInput.lookInput.y = m_Frame.lookY;
+
+    // Update mouse look enabled state in player input
+    m_PlayerInput.mouseLookEnabled = m_MouseLookEnabled;
+}
+
+void InputManager::UpdateButtonInput() {
     // Movement input (WASD)
     m_PlayerInput.moveInput.x = 0.0f;
     m_PlayerInput.moveInput.y = 0.0f;
 
-    if (IsKeyHeld(KEY_W)) m_PlayerInput.moveInput.y += 1.0f;
-    if (IsKeyHeld(KEY_S)) m_PlayerInput.moveInput.y -= 1.0f;
-    if (IsKeyHeld(KEY_A)) m_PlayerInput.moveInput.x -= 1.0f;
-    if (IsKeyHeld(KEY_D)) m_PlayerInput.moveInput.x += 1.0f;
+    if (IsActionHeld(InputAction::MoveForward)) m_PlayerInput.moveInput.y += 1.0f;
+    if (IsActionHeld(InputAction::MoveBackward)) m_PlayerInput.moveInput.y -= 1.0f;
+    if (IsActionHeld(InputAction::MoveLeft)) m_PlayerInput.moveInput.x -= 1.0f;
+    if (IsActionHeld(InputAction::MoveRight)) m_PlayerInput.moveInput.x += 1.0f;
 
     // Normalize movement input
     if (m_PlayerInput.moveInput.x != 0.0f || m_PlayerInput.moveInput.y != 0.0f) {
@@ -67,40 +315,61 @@ void InputManager::UpdatePlayerInput() {
         DirectX::XMStoreFloat2(&m_PlayerInput.moveInput, moveVec);
     }
 
-    // Look input (mouse movement) - calculate delta from window center for infinite rotation
-    if (m_MouseLookEnabled) {
-        RECT clientRect;
-        GetClientRect(m_Hwnd, &clientRect);
-        int centerX = (clientRect.left + clientRect.right) / 2;
-        int centerY = (clientRect.top + clientRect.bottom) / 2;
+    // Action buttons
+    m_PlayerInput.jumpPressed = IsActionPressed(InputAction::Jump);
+    m_PlayerInput.jumpHeld = IsActionHeld(InputAction::Jump);
+    m_PlayerInput.sprintHeld = IsActionHeld(InputAction::Sprint);
+    m_PlayerInput.crouchHeld = IsActionHeld(InputAction::Crouch);
+    m_PlayerInput.interactPressed = IsActionPressed(InputAction::Interact);
 
-        // Calculate delta from center
-        float mouseDeltaX = (float)(m_CurrentMousePos.x - centerX);
-        float mouseDeltaY = (float)(m_CurrentMousePos.y - centerY);
+    // ESC to toggle mouse look
+    m_PlayerInput.toggleMouseLookPressed = IsActionPressed(InputAction::ToggleMouseLook);
+}
 
-        m_PlayerInput.lookInput.x = mouseDeltaX;
-        m_PlayerInput.lookInput.y = mouseDeltaY;
+void InputManager::ApplyFrameState(const InputFrameState& state) {
+    // Update() 已生成本帧快照，这里整体替换成录制的快照
+    m_Frame = state;
 
-        // Reset mouse to center for next frame (allows infinite rotation)
-        POINT centerPosScreen = { centerX, centerY };
-        ClientToScreen(m_Hwnd, &centerPosScreen);
-        SetCursorPos(centerPosScreen.x, centerPosScreen.y);
-    } else {
-        m_PlayerInput.lookInput.x = 0.0f;
-        m_PlayerInput.lookInput.y = 0.0f;
+    UpdateButtonInput();
+    m_PlayerInput.lookInput.x = state.lookX;
+    m_PlayerInput.lookInput.y = state.lookY;
+}
+
+bool InputManager::IsChordPressed(int keyA, int keyB) const {
+    const bool downA = IsKeyHeld(keyA) || IsKeyPressed(keyA);
+    const bool downB = IsKeyHeld(keyB) || IsKeyPressed(keyB);
+    return downA && downB && (IsKeyPressed(keyA) || IsKeyPressed(keyB));
+}
+
+void InputManager::BindAction(InputAction action, int primaryKey, int secondaryKey) {
+    if (action >= InputAction::Count) return;
+    m_Bindings[static_cast<size_t>(action)][0] = primaryKey;
+    m_Bindings[static_cast<size_t>(action)][1] = secondaryKey;
+}
+
+void InputManager::ResetBindings() {
+    memset(m_Bindings, 0, sizeof(m_Bindings));
+    for (const DefaultBinding& binding : kDefaultBindings) {
+        BindAction(binding.action, binding.primary, binding.secondary);
     }
-    
-    // Update mouse look enabled state in player input
-    m_PlayerInput.mouseLookEnabled = m_MouseLookEnabled;
+}
 
-    // Action buttons
-    m_PlayerInput.jumpPressed = IsKeyPressed(KEY_SPACE);
-    m_PlayerInput.jumpHeld = IsKeyHeld(KEY_SPACE);
-    m_PlayerInput.sprintHeld = IsKeyHeld(KEY_SHIFT);
-    m_PlayerInput.crouchHeld = IsKeyHeld(VK_CONTROL);
+bool InputManager::IsActionHeld(InputAction action) const {
+    if (action >= InputAction::Count) return false;
+    const int* keys = m_Bindings[static_cast<size_t>(action)];
+    return (keys[0] && IsKeyHeld(keys[0])) || (keys[1] && IsKeyHeld(keys[1]));
+}
 
-    // ESC to toggle mouse look
-    m_PlayerInput.toggleMouseLookPressed = IsKeyPressed(KEY_ESCAPE);
+bool InputManager::IsActionPressed(InputAction action) const {
+    if (action >= InputAction::Count) return false;
+    const int* keys = m_Bindings[static_cast<size_t>(action)];
+    return (keys[0] && IsKeyPressed(keys[0])) || (keys[1] && IsKeyPressed(keys[1]));
+}
+
+bool InputManager::IsActionReleased(InputAction action) const {
+    if (action >= InputAction::Count) return false;
+    const int* keys = m_Bindings[static_cast<size_t>(action)];
+    return (keys[0] && IsKeyReleased(keys[0])) || (keys[1] && IsKeyReleased(keys[1]));
 }
 
 void InputManager::SetMouseLookEnabled(bool enabled) {
@@ -109,40 +378,30 @@ void InputManager::SetMouseLookEnabled(bool enabled) {
 }
 
 void InputManager::SetMouseCapture(bool capture) {
+    if (!m_Hwnd) return;
     if (capture && !m_MouseCaptured) {
-        // Capture mouse and hide cursor
-        SetCapture(m_Hwnd);
+        // Hide cursor; 视角输入来自 Raw Input 相对移动，光标只需限制在客户区内
         ShowCursor(FALSE);
-        
+
         // Center mouse initially
         RECT clientRect;
         GetClientRect(m_Hwnd, &clientRect);
         int centerX = (clientRect.left + clientRect.right) / 2;
         int centerY = (clientRect.top + clientRect.bottom) / 2;
-        
+
         POINT centerPosScreen = { centerX, centerY };
         ClientToScreen(m_Hwnd, &centerPosScreen);
         SetCursorPos(centerPosScreen.x, centerPosScreen.y);
-        
+        m_CurrentMousePos = { centerX, centerY };
+
         m_MouseCaptured = true;
+        RefreshCursorClip();
     } else if (!capture && m_MouseCaptured) {
         // Release mouse and show cursor
-        ReleaseCapture();
+        ClipCursor(nullptr);
         ShowCursor(TRUE);
         m_MouseCaptured = false;
     }
 }
 
-bool InputManager::IsKeyPressed(int key) const {
-    return (m_CurrentKeyState[key] & 0x80) && !(m_PreviousKeyState[key] & 0x80);
-}
-
-bool InputManager::IsKeyHeld(int key) const {
-    return (m_CurrentKeyState[key] & 0x80);
-}
-
-bool InputManager::IsKeyReleased(int key) const {
-    return !(m_CurrentKeyState[key] & 0x80) && (m_PreviousKeyState[key] & 0x80);
-}
-
-} // namespace outer_wilds
\ No newline at end of file
+} // namespace outer_wilds
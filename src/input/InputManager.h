@@ -1,10 +1,50 @@
 #pragma once
 #include <Windows.h>
 #include <DirectXMath.h>
+#include <cstdint>
 #include "../gameplay/components/PlayerInputComponent.h"
 
 namespace outer_wilds {
 
+/**
+ * @brief 一帧的输入快照（系统查询的就是它；InputRecorder 录制 / 回放也是它）
+ *
+ * pressed / released 是本帧内发生过的边沿：比一帧还短的点按也会留下 pressed（此时 keys 中已是松开）
+ */
+struct InputFrameState {
+    uint8_t keys[32];       // 256 个虚拟键的按下状态（位图）
+    uint8_t pressed[32];    // 本帧内按下过的键
+    uint8_t released[32];   // 本帧内松开过的键
+    float lookX;            // 鼠标视角输入（PlayerInputComponent::lookInput）
+    float lookY;
+    int32_t mouseDeltaX;    // 本帧累计的鼠标相对移动（Raw Input 计数，GetMouseDelta 使用）
+    int32_t mouseDeltaY;
+};
+
+/**
+ * @brief 可重新绑定的游戏动作（每个动作最多两个按键）
+ */
+enum class InputAction : uint8_t {
+    MoveForward,
+    MoveBackward,
+    MoveLeft,
+    MoveRight,
+    Jump,
+    Sprint,
+    Crouch,
+    Interact,
+    ToggleMouseLook,
+    Count
+};
+
+/**
+ * @brief 输入管理：WM_INPUT 事件驱动的键盘 / 鼠标状态，每帧生成一次快照
+ *
+ * WindowProc 把 WM_INPUT 交给 HandleRawInput：按键状态和边沿、鼠标相对移动在两帧之间累积，
+ * Update（Engine::Update 帧开头）把它们固定成本帧快照，系统只查询快照。
+ * 低帧率下不会漏掉帧间的点按；鼠标移动是硬件采样的累计值，不再每帧把光标拉回窗口中心。
+ * Raw Input 注册失败时退回 GetKeyboardState / 光标位置轮询。
+ */
 class InputManager {
 public:
     static InputManager& GetInstance();
@@ -12,6 +52,17 @@ public:
     void Initialize(HWND hwnd);
     void Update();
 
+    /** @brief WindowProc 收到 WM_INPUT 时调用（主线程） */
+    void HandleRawInput(LPARAM lParam);
+
+    /** @brief WM_SETFOCUS / WM_KILLFOCUS：失去焦点时松开所有按键并释放光标限制 */
+    void HandleFocusChange(bool focused);
+
+    /** @brief WM_SIZE / WM_MOVE：鼠标被捕获时重新把光标限制在客户区内 */
+    void RefreshCursorClip();
+
+    bool IsRawInputActive() const { return m_RawInputActive; }
+
     // Input state
     PlayerInputComponent& GetPlayerInput() { return m_PlayerInput; }
 
@@ -21,51 +72,89 @@ public:
     void SetMouseLookEnabled(bool enabled);
     bool IsMouseLookEnabled() const { return m_MouseLookEnabled; }
 
-    // Key state queries
-    bool IsKeyPressed(int key) const;
-    bool IsKeyHeld(int key) const;
-    bool IsKeyReleased(int key) const;
-    
+    // Record / replay (InputRecorder)
+    void CaptureFrameState(InputFrameState& out) const { out = m_Frame; }
+    void ApplyFrameState(const InputFrameState& state);
+
+    // Key state queries（游戏逻辑统一用这里的快照而不是 GetAsyncKeyState，回放时才能重现）
+    bool IsKeyPressed(int key) const { return TestBit(m_Frame.pressed, key); }
+    bool IsKeyHeld(int key) const { return TestBit(m_Frame.keys, key); }
+    bool IsKeyReleased(int key) const { return TestBit(m_Frame.released, key); }
+
+    /** @brief 组合键：两个键本帧都处于按下（或按下过），且至少一个是本帧新按下的 */
+    bool IsChordPressed(int keyA, int keyB) const;
+
+    // Action bindings
+    void BindAction(InputAction action, int primaryKey, int secondaryKey = 0);
+    void ResetBindings();
+    bool IsActionHeld(InputAction action) const;
+    bool IsActionPressed(InputAction action) const;
+    bool IsActionReleased(InputAction action) const;
+
+    /**
+     * @brief 后期锁存：分发队列中新到的 WM_INPUT，返回本帧快照之后累积的鼠标移动（主线程，渲染前调用）
+     *
+     * 只读不消费：这段移动仍计入下一帧快照，模拟照常使用；渲染只把它叠加到视角上。
+     * @return Raw Input 不可用、视角未启用或窗口无焦点时返回 false
+     */
+    bool PeekLateLookDelta(int& deltaX, int& deltaY);
+
     // Mouse delta for spacecraft/free camera control
     void GetMouseDelta(int& deltaX, int& deltaY) const {
-        deltaX = m_CurrentMousePos.x - m_PreviousMousePos.x;
-        deltaY = m_CurrentMousePos.y - m_PreviousMousePos.y;
+        deltaX = m_Frame.mouseDeltaX;
+        deltaY = m_Frame.mouseDeltaY;
     }
 
 private:
-    InputManager() = default;
+    InputManager() { ResetBindings(); }
     ~InputManager() = default;
 
+    static bool TestBit(const uint8_t* bits, int key) {
+        return key >= 0 && key < 256 && (bits[key >> 3] & (1u << (key & 7))) != 0;
+    }
+    static void SetBit(uint8_t* bits, int key) {
+        bits[key >> 3] |= static_cast<uint8_t>(1u << (key & 7));
+    }
+
+    bool RegisterRawInput();
+    /** @brief 事件驱动的按键变化（Raw Input 键盘 / 鼠标按键） */
+    void SetKeyDown(int key, bool down);
+    void ReleaseAllKeys();
     void UpdateKeyboardState();
     void UpdateMouseState();
     void UpdatePlayerInput();
+    void UpdateLookInput();
+    void UpdateButtonInput();
 
     // Window handle
     HWND m_Hwnd = nullptr;
+    bool m_RawInputActive = false;
+    bool m_HasFocus = true;
 
     // Input state
     PlayerInputComponent m_PlayerInput;
 
-    // Keyboard state
-    BYTE m_CurrentKeyState[256];
-    BYTE m_PreviousKeyState[256];
+    // 本帧快照
+    InputFrameState m_Frame = {};
+
+    // 两帧之间由事件累积的状态（WindowProc 与 Update 都在主线程上，不需要加锁）
+    uint8_t m_EventKeys[32] = {};
+    uint8_t m_EventPressed[32] = {};
+    uint8_t m_EventReleased[32] = {};
+    LONG m_RawDeltaX = 0;
+    LONG m_RawDeltaY = 0;
+    LONG m_LastAbsoluteX = 0;       // 绝对坐标设备（远程桌面 / 数位板）按差值换算
+    LONG m_LastAbsoluteY = 0;
+    bool m_HasAbsolute = false;
+
+    // Polling fallback（Raw Input 不可用时）
+    POINT m_CurrentMousePos = {};
+    POINT m_PreviousMousePos = {};
 
-    // Mouse state
-    POINT m_CurrentMousePos;
-    POINT m_PreviousMousePos;
-    POINT m_LastMousePos;
     bool m_MouseCaptured = false;
     bool m_MouseLookEnabled = false;
-    bool m_FirstMouseCapture = true;
-
-    // Movement keys
-    static constexpr int KEY_W = 'W';
-    static constexpr int KEY_A = 'A';
-    static constexpr int KEY_S = 'S';
-    static constexpr int KEY_D = 'D';
-    static constexpr int KEY_SPACE = VK_SPACE;
-    static constexpr int KEY_SHIFT = VK_SHIFT;
-    static constexpr int KEY_ESCAPE = VK_ESCAPE;
+
+    int m_Bindings[static_cast<size_t>(InputAction::Count)][2] = {};
 };
 
-} // namespace outer_wilds
\ No newline at end of file
+} // namespace outer_wilds
@@ -0,0 +1,159 @@
+#include "InputRecorder.h"
+#include "../core/DebugManager.h"
+#include "../core/TimeManager.h"
+#include "../physics/PhysXManager.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace outer_wilds {
+
+bool InputRecorder::StartRecording(const std::string& path) {
+    Stop();
+
+    m_File.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_File.is_open()) {
+        DebugManager::GetInstance().Log("InputRecorder", "Failed to open recording file: " + path);
+        return false;
+    }
+
+    m_Header = FileHeader();
+    m_Header.fixedTimeStep = PhysXManager::GetInstance().GetFixedTimeStep();
+    m_File.write(reinterpret_cast<const char*>(&m_Header), sizeof(m_Header));
+    m_FrameIndex = 0;
+    m_Mode = Mode::Recording;
+    DebugManager::GetInstance().Log("InputRecorder", "Recording input to " + path);
+    return true;
+}
+
+bool InputRecorder::StartReplay(const std::string& path, const std::string& reportPath) {
+    Stop();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        DebugManager::GetInstance().Log("InputRecorder", "Failed to open replay file: " + path);
+        return false;
+    }
+
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.magic != kMagic || header.version != kVersion) {
+        DebugManager::GetInstance().Log("InputRecorder", "Invalid or incompatible replay file: " + path);
+        return false;
+    }
+
+    m_Frames.resize(header.frameCount);
+    if (header.frameCount > 0 &&
+        !file.read(reinterpret_cast<char*>(m_Frames.data()), sizeof(Frame) * header.frameCount)) {
+        DebugManager::GetInstance().Log("InputRecorder", "Truncated replay file: " + path);
+        m_Frames.clear();
+        return false;
+    }
+
+    // 固定步长必须与录制时一致，否则每帧的物理步数不同
+    if (header.fixedTimeStep > 0.0f) {
+        m_SavedFixedTimeStep = PhysXManager::GetInstance().GetFixedTimeStep();
+        PhysXManager::GetInstance().SetFixedTimeStep(header.fixedTimeStep);
+    }
+
+    m_Header = header;
+    m_FrameIndex = 0;
+    m_FrameTimesMs.clear();
+    m_FrameTimesMs.reserve(header.frameCount);
+    m_ReportPath = reportPath;
+    m_ReplayFinished = false;
+    m_Mode = Mode::Replaying;
+    DebugManager::GetInstance().Log("InputRecorder",
+        "Replaying " + std::to_string(header.frameCount) + " frames from " + path);
+    return true;
+}
+
+void InputRecorder::Stop() {
+    if (m_Mode == Mode::Recording) {
+        // 补写帧数
+        m_Header.frameCount = m_FrameIndex;
+        m_File.seekp(0, std::ios::beg);
+        m_File.write(reinterpret_cast<const char*>(&m_Header), sizeof(m_Header));
+        m_File.close();
+        DebugManager::GetInstance().Log("InputRecorder",
+            "Recording stopped: " + std::to_string(m_FrameIndex) + " frames");
+    }
+    if (m_Mode == Mode::Replaying) {
+        RestoreFixedTimeStep();
+    }
+    m_Frames.clear();
+    m_Mode = Mode::Off;
+}
+
+void InputRecorder::RestoreFixedTimeStep() {
+    if (m_SavedFixedTimeStep > 0.0f) {
+        PhysXManager::GetInstance().SetFixedTimeStep(m_SavedFixedTimeStep);
+        m_SavedFixedTimeStep = 0.0f;
+    }
+}
+
+void InputRecorder::Update() {
+    auto& input = InputManager::GetInstance();
+    auto& time = TimeManager::GetInstance();
+
+    if (m_Mode == Mode::Recording) {
+        Frame frame;
+        frame.deltaTime = time.GetDeltaTime();
+        frame.timeWarp = time.GetTimeWarp();
+        input.CaptureFrameState(frame.input);
+        m_File.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+        m_FrameIndex++;
+    } else if (m_Mode == Mode::Replaying) {
+        if (m_FrameIndex >= m_Frames.size()) {
+            FinishReplay();
+            return;
+        }
+        // 墙钟帧时间（上一帧的实际耗时）只用于报告
+        if (m_FrameIndex > 0) {
+            m_FrameTimesMs.push_back(time.GetRealDeltaTime() * 1000.0f);
+        }
+        const Frame& frame = m_Frames[m_FrameIndex++];
+        time.OverrideDeltaTime(frame.deltaTime);
+        time.SetTimeWarp(frame.timeWarp);
+        input.ApplyFrameState(frame.input);
+    }
+}
+
+bool InputRecorder::ConsumeReplayFinished() {
+    const bool finished = m_ReplayFinished;
+    m_ReplayFinished = false;
+    return finished;
+}
+
+void InputRecorder::FinishReplay() {
+    RestoreFixedTimeStep();
+    m_Mode = Mode::Off;
+    m_ReplayFinished = true;
+
+    if (m_FrameTimesMs.empty()) return;
+
+    std::vector<float> sorted = m_FrameTimesMs;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (float ms : sorted) total += ms;
+    const float average = static_cast<float>(total / sorted.size());
+    const float p99 = sorted[std::min(sorted.size() - 1, sorted.size() * 99 / 100)];
+
+    char summary[160];
+    snprintf(summary, sizeof(summary), "Replay finished: %zu frames, avg %.3f ms, p99 %.3f ms, max %.3f ms",
+             sorted.size(), average, p99, sorted.back());
+    DebugManager::GetInstance().Log("InputRecorder", summary);
+
+    if (!m_ReportPath.empty()) {
+        std::ofstream report(m_ReportPath, std::ios::trunc);
+        if (!report.is_open()) {
+            DebugManager::GetInstance().Log("InputRecorder", "Failed to write replay report: " + m_ReportPath);
+            return;
+        }
+        report << "frame,ms\n";
+        for (size_t i = 0; i < m_FrameTimesMs.size(); i++) {
+            report << (i + 1) << "," << m_FrameTimesMs[i] << "\n";
+        }
+    }
+}
+
+} // namespace outer_wilds
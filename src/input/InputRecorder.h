@@ -0,0 +1,88 @@
+#pragma once
+#include "InputManager.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 输入录制 / 确定性回放（性能回归测试）
+ *
+ * 录制：每帧记录 InputManager 的按键/鼠标状态、本帧 delta 和时间加速倍率，追加写入文件。
+ * 回放：每帧用录制的状态覆盖硬件输入，并用录制的 delta 替换墙钟时间（TimeManager::OverrideDeltaTime），
+ *       固定步长也恢复为录制时的值，于是同一段飞行可以逐帧重跑；墙钟帧时间另外记录，
+ *       回放结束时输出统计并可写成 CSV，用于不同构建之间对比。
+ *
+ * Engine::MainLoop 在 TimeManager / InputManager 更新之后调用 Update。
+ * 游戏逻辑必须从 InputManager 读取按键（不能直接 GetAsyncKeyState），否则回放时不会重现。
+ */
+class InputRecorder {
+public:
+    enum class Mode { Off, Recording, Replaying };
+
+    static InputRecorder& GetInstance() {
+        static InputRecorder instance;
+        return instance;
+    }
+
+    /** @brief 开始录制（文件被覆盖） */
+    bool StartRecording(const std::string& path);
+
+    /**
+     * @brief 载入录制文件并从下一帧开始回放
+     * @param reportPath 非空时回放结束后写入每帧墙钟时间（CSV：frame,ms）
+     */
+    bool StartReplay(const std::string& path, const std::string& reportPath = "");
+
+    /** @brief 结束录制（补写帧数）或中止回放（恢复回放前的固定步长） */
+    void Stop();
+
+    /** @brief 每帧调用一次：录制当前输入，或应用下一帧录制的输入 */
+    void Update();
+
+    Mode GetMode() const { return m_Mode; }
+    uint32_t GetFrameIndex() const { return m_FrameIndex; }
+    uint32_t GetFrameCount() const { return static_cast<uint32_t>(m_Frames.size()); }
+
+    /** @brief 回放刚刚结束（读取后清除），Engine 据此停止回归测试运行 */
+    bool ConsumeReplayFinished();
+
+private:
+    InputRecorder() = default;
+    ~InputRecorder() { Stop(); }
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    static constexpr uint32_t kMagic = 0x5249574f;   // "OWIR"
+    static constexpr uint32_t kVersion = 2;   // 2：快照带按下 / 松开边沿和 Raw Input 鼠标移动
+
+    struct FileHeader {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        float fixedTimeStep = 0.0f;
+        uint32_t frameCount = 0;
+    };
+
+    struct Frame {
+        float deltaTime = 0.0f;
+        float timeWarp = 1.0f;
+        InputFrameState input = {};
+    };
+
+    void FinishReplay();
+    void RestoreFixedTimeStep();
+
+    Mode m_Mode = Mode::Off;
+    std::ofstream m_File;              // 录制中的文件
+    FileHeader m_Header;
+    std::vector<Frame> m_Frames;       // 回放数据
+    uint32_t m_FrameIndex = 0;
+    std::vector<float> m_FrameTimesMs; // 回放时的墙钟帧时间
+    std::string m_ReportPath;
+    bool m_ReplayFinished = false;
+    float m_SavedFixedTimeStep = 0.0f; // 回放覆盖前的固定步长（0 = 未覆盖）
+};
+
+} // namespace outer_wilds
@@ -10,12 +10,18 @@
 
 #include "core/Engine.h"
 #include "core/DebugManager.h"
+#include "core/FrameAllocator.h"
+#include "input/InputManager.h"
 #include "audio/AudioSystem.h"
 #include "ui/UISystem.h"
 #include "scene/Scene.h"
 #include "scene/SceneAssetLoader.h"
 #include "scene/SolarSystemConfig.h"
 #include "scene/SolarSystemBuilder.h"
+#include "scene/StressSceneBuilder.h"
+#include "scene/PreloadManifest.h"
+#include "scene/ScenePreloader.h"
+#include "scene/AssetStreamer.h"
 #include <imgui.h>
 #include <imgui_impl_win32.h>
 
@@ -32,6 +38,8 @@
 #include "gameplay/components/PlayerComponent.h"
 #include "gameplay/components/CharacterControllerComponent.h"
 #include "gameplay/components/SpacecraftComponent.h"
+#include "gameplay/components/StandingOnComponent.h"
+#include "gameplay/CharacterControllerBatch.h"
 
 // 物理组件
 #include "physics/components/GravitySourceComponent.h"
@@ -45,11 +53,15 @@
 #include "graphics/resources/Shader.h"
 #include "graphics/resources/TextureLoader.h"
 #include "graphics/resources/AssimpLoader.h"
+#include "graphics/resources/ResourceCache.h"
 #include "graphics/RenderSystem.h"
+#include "graphics/CameraService.h"
 #include "physics/PhysXManager.h"
+#include "input/InputRecorder.h"
 #include <PxPhysicsAPI.h>
 
 #include <Windows.h>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <DbgHelp.h>
@@ -93,10 +105,24 @@ void CreateDebugConsole() {
 }
 
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
-    if (ImGui_ImplWin32_WndProcHandler(hwnd, uMsg, wParam, lParam))
+    // 没有可见 UI 时 UISystem 跳过 ImGui 帧，消息也不再排进 ImGui 的输入队列
+    auto uiSystem = outer_wilds::Engine::GetInstance().GetUISystem();
+    if ((!uiSystem || uiSystem->AcceptsImGuiInput()) && ImGui_ImplWin32_WndProcHandler(hwnd, uMsg, wParam, lParam))
         return true;
     
     switch (uMsg) {
+        case WM_INPUT:
+            // 按键 / 鼠标事件在两帧之间累积，InputManager::Update 时固定成本帧快照
+            outer_wilds::InputManager::GetInstance().HandleRawInput(lParam);
+            break;
+        case WM_SETFOCUS:
+        case WM_KILLFOCUS:
+            outer_wilds::InputManager::GetInstance().HandleFocusChange(uMsg == WM_SETFOCUS);
+            break;
+        case WM_SIZE:
+        case WM_MOVE:
+            outer_wilds::InputManager::GetInstance().RefreshCursorClip();
+            break;
         case WM_DESTROY:
             PostQuitMessage(0);
             return 0;
@@ -141,23 +167,75 @@ int main(int argc, char* argv[]) {
     const int WINDOW_WIDTH = 1280;
     const int WINDOW_HEIGHT = 720;
 
-    HINSTANCE hInstance = GetModuleHandle(NULL);
-    HWND hwnd = CreateAppWindow(hInstance, WINDOW_WIDTH, WINDOW_HEIGHT);
-    if (hwnd == NULL) {
-        outer_wilds::DebugManager::GetInstance().Log("Main", "Failed to create window.");
-        return 0;
+    // 输入录制 / 回放（性能回归）：--record <file> | --replay <file> [--replay-report <file.csv>]
+    // 无窗口基准：--headless [--frames N] [--report <file.json>]（与 --replay 同时使用时跑完回放为止）
+    std::string recordPath;
+    std::string replayPath;
+    std::string replayReportPath;
+    outer_wilds::HeadlessSettings headless;
+    bool framesSpecified = false;
+    // 程序化压力场景：--stress-sectors K --stress-bodies N --stress-asteroids M --stress-depth D [--stress-seed S]
+    outer_wilds::StressSceneConfig stress;
+    bool stressEnabled = false;
+    auto parseCount = [&](const char* text) { stressEnabled = true; return static_cast<uint32_t>(std::strtoul(text, nullptr, 10)); };
+    // 资源热重载（监视 shaders/ 和 assets/）：--no-hot-reload 关闭
+    bool hotReload = true;
+    // 网格上传后释放 CPU 顶点 / 索引（省内存，之后不能再生成 LOD）：--release-mesh-cpu
+    bool releaseMeshCPU = false;
+    // 每个扇区独立 PxScene（扇区多时只模拟有人 / 有活动刚体的场景）：--per-sector-scenes
+    bool perSectorScenes = false;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--headless") headless.enabled = true;
+        else if (arg == "--no-hot-reload") hotReload = false;
+        else if (arg == "--release-mesh-cpu") releaseMeshCPU = true;
+        else if (arg == "--per-sector-scenes") perSectorScenes = true;
+        else if (i + 1 >= argc) break;
+        else if (arg == "--record") recordPath = argv[++i];
+        else if (arg == "--replay") replayPath = argv[++i];
+        else if (arg == "--replay-report") replayReportPath = argv[++i];
+        else if (arg == "--frames") { headless.frameCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)); framesSpecified = true; }
+        else if (arg == "--report") headless.reportPath = argv[++i];
+        else if (arg == "--stress-sectors") stress.sectorCount = parseCount(argv[++i]);
+        else if (arg == "--stress-bodies") stress.bodiesPerSector = parseCount(argv[++i]);
+        else if (arg == "--stress-asteroids") stress.asteroidCount = parseCount(argv[++i]);
+        else if (arg == "--stress-depth") stress.orbitChainDepth = parseCount(argv[++i]);
+        else if (arg == "--stress-seed") stress.seed = parseCount(argv[++i]);
+    }
+    if (headless.enabled && !replayPath.empty() && !framesSpecified) {
+        headless.frameCount = 0;
     }
 
-    ShowWindow(hwnd, SW_SHOW);
-    UpdateWindow(hwnd);
-    SetForegroundWindow(hwnd);
+    HWND hwnd = NULL;
+    if (!headless.enabled) {
+        HINSTANCE hInstance = GetModuleHandle(NULL);
+        hwnd = CreateAppWindow(hInstance, WINDOW_WIDTH, WINDOW_HEIGHT);
+        if (hwnd == NULL) {
+            outer_wilds::DebugManager::GetInstance().Log("Main", "Failed to create window.");
+            return 0;
+        }
+
+        ShowWindow(hwnd, SW_SHOW);
+        UpdateWindow(hwnd);
+        SetForegroundWindow(hwnd);
+    }
+    if (!recordPath.empty() || !replayPath.empty()) {
+        outer_wilds::PhysicsSettings physicsSettings = outer_wilds::PhysXManager::GetInstance().GetSettings();
+        physicsSettings.enhancedDeterminism = true;
+        outer_wilds::PhysXManager::GetInstance().SetSettings(physicsSettings);
+    }
+    // 必须在 Engine::Initialize 和搭建场景之前设置
+    outer_wilds::PhysXManager::GetInstance().SetPerSectorScenes(perSectorScenes);
 
     // Initialize engine
     outer_wilds::Engine& engine = outer_wilds::Engine::GetInstance();
+    engine.SetHeadless(headless);
+    engine.SetHotReloadEnabled(hotReload);
+    outer_wilds::resources::ResourceCache::GetInstance().SetReleaseCPUMeshData(releaseMeshCPU);
     
     if (engine.Initialize(hwnd, WINDOW_WIDTH, WINDOW_HEIGHT)) {
         outer_wilds::DebugManager::GetInstance().Log("Main", "Engine initialized successfully");
-        outer_wilds::DebugManager::GetInstance().SetShowFPS(true);
+        outer_wilds::DebugManager::GetInstance().SetShowFPS(!headless.enabled);
         
         auto scene = engine.GetSceneManager()->GetActiveScene();
         auto& physxManager = outer_wilds::PhysXManager::GetInstance();
@@ -166,6 +244,107 @@ int main(int argc, char* argv[]) {
         auto* renderBackend = engine.GetRenderSystem()->GetBackend();
         auto* device = renderBackend->GetDevice();
         
+        // ========================================
+        // 启动欢迎界面流程：先显示欢迎界面，预加载清单中的资源在加载线程上并行获取，
+        // 欢迎界面显示进度；随后一次构建场景（资源全部命中 ResourceCache）
+        // ========================================
+        bool shouldExit = false;
+        auto pumpWelcomeFrame = [&]() {
+            if (auto* backend = engine.GetRenderSystem() ? engine.GetRenderSystem()->GetBackend() : nullptr) {
+                backend->BeginFrame();
+            }
+            MSG msg = {};
+            while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+                TranslateMessage(&msg);
+                DispatchMessage(&msg);
+                if (msg.message == WM_QUIT) {
+                    shouldExit = true;
+                    engine.Stop();
+                    break;
+                }
+            }
+            
+            outer_wilds::TimeManager::GetInstance().Update();
+            outer_wilds::InputManager::GetInstance().Update();
+            float deltaTime = outer_wilds::TimeManager::GetInstance().GetDeltaTime();
+            
+            auto& registry = scene->GetRegistry();
+            // 欢迎图片等异步加载的结果（欢迎界面不经过 Engine::Update）
+            outer_wilds::AssetStreamer::GetInstance().ApplyCompleted(registry);
+            if (auto uiSys = engine.GetUISystem()) {
+                uiSys->Update(deltaTime, registry);
+            }
+            if (auto audioSys = engine.GetAudioSystem()) {
+                audioSys->Update(deltaTime, registry);
+            }
+            
+            // 渲染
+            if (auto renderSystem = engine.GetRenderSystem()) {
+                auto renderBackend = renderSystem->GetBackend();
+                if (renderBackend) {
+                    auto context = static_cast<ID3D11DeviceContext*>(renderBackend->GetContext());
+                    auto renderTargetView = static_cast<ID3D11RenderTargetView*>(renderBackend->GetRenderTargetView());
+                    auto depthStencilView = static_cast<ID3D11DepthStencilView*>(renderBackend->GetDepthStencilView());
+                    
+                    if (context && renderTargetView && depthStencilView) {
+                        context->OMSetRenderTargets(1, &renderTargetView, depthStencilView);
+                        float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+                        context->ClearRenderTargetView(renderTargetView, clearColor);
+                        context->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+                    }
+                }
+                
+                if (auto uiSystem = engine.GetUISystem()) {
+                    uiSystem->Render();
+                }
+                
+                if (renderBackend) {
+                    renderBackend->EndFrame();
+                    renderBackend->Present();
+                }
+            }
+            // 欢迎界面不经过 Engine::Update：同样推进帧内临时内存
+            outer_wilds::FrameAllocator::GetInstance().EndFrame();
+        };
+        
+        if (auto uiSystem = engine.GetUISystem()) {
+            uiSystem->ShowWelcomeScreenWithKeyWait("C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\ui\\kkstudio1.jpg");
+        }
+        
+        if (auto audioSystem = engine.GetAudioSystem()) {
+            audioSystem->PlaySingleTrack("C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\Outer Wilds (Original Soundtrack)\\02 - Outer Wilds.mp3");
+            // 短音效在加载线程上打包成 SoundBank（与场景预加载一起进行）
+            audioSystem->LoadSoundBankFromDirectory("C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\sfx");
+        }
+        
+        {
+            outer_wilds::PreloadManifest manifest;
+            auto& preloader = outer_wilds::ScenePreloader::GetInstance();
+            if (manifest.Load(outer_wilds::PreloadManifest::kDefaultPath) && preloader.Start(device, manifest) > 0) {
+                auto& registry = scene->GetRegistry();
+                while (!preloader.IsComplete() && !shouldExit) {
+                    outer_wilds::AssetStreamer::GetInstance().ApplyCompleted(registry);
+                    if (auto uiSystem = engine.GetUISystem()) {
+                        uiSystem->SetLoadingProgress(preloader.GetProgress(),
+                            "Loading assets " + std::to_string(preloader.GetCompletedRequests()) + " / " +
+                            std::to_string(preloader.GetTotalRequests()));
+                        pumpWelcomeFrame();
+                    } else {
+                        Sleep(1);   // 无窗口模式：只等待加载线程
+                    }
+                }
+            }
+        }
+        if (shouldExit) {
+            engine.Shutdown();
+            return 0;
+        }
+        if (auto uiSystem = engine.GetUISystem()) {
+            uiSystem->SetLoadingProgress(1.0f, "Building scene");
+            pumpWelcomeFrame();
+        }
+        outer_wilds::PreloadManifest::BeginRecording();
+        
         // ========================================
         // 【微缩太阳系场景】
         // 使用 SolarSystemBuilder 创建完整太阳系
@@ -185,11 +364,19 @@ int main(int argc, char* argv[]) {
             scene->GetRegistry(), scene, device, ASSETS_BASE
         );
         
+        // 压力场景与手工太阳系共存（扇区在海王星轨道之外）
+        if (stressEnabled && stress.IsEnabled()) {
+            outer_wilds::StressSceneBuilder::Build(scene->GetRegistry(), device, stress);
+        }
+        
         // 设置太阳实体给渲染系统（用于动态光照）
         if (solarSystem.sun != entt::null) {
             engine.GetRenderSystem()->SetSunEntity(solarSystem.sun);
         }
         
+        // 大气 LUT 在加载期间算好（而不是第一次进入视野的那一帧）
+        engine.GetRenderSystem()->PrepareScene(scene->GetRegistry());
+        
         // 获取地球实体（用于玩家出生点）
         auto planetEntity = solarSystem.earth;
         const float PLANET_RADIUS = outer_wilds::SolarSystemConfig::EARTH_RADIUS;  // 现在是 64m
@@ -220,7 +407,9 @@ int main(int argc, char* argv[]) {
             "C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\models\\human\\extracted\\models\\SK_SciFiTrooperManV3.fbx",
             "",  // 贴图和模型在同一目录
             DirectX::XMFLOAT3(0.0f, PLAYER_LOCAL_HEIGHT, 0.0f),  // 局部坐标
-            DirectX::XMFLOAT3(0.01f, 0.01f, 0.01f)  // FBX 模型通常需要缩小
+            DirectX::XMFLOAT3(0.01f, 0.01f, 0.01f),  // FBX 模型通常需要缩小
+            false,  // staticMerge：蒙皮角色保留节点层级
+            true    // packTextureArrays：各部件的同尺寸贴图共用纹理数组
         );
         
         std::cout << "[Main] Player entity ID: " << static_cast<uint32_t>(playerEntity) << std::endl;
@@ -265,6 +454,7 @@ int main(int argc, char* argv[]) {
             // CameraComponent（玩家第一人称相机）
             auto& playerCamera = scene->GetRegistry().emplace<outer_wilds::components::CameraComponent>(playerEntity);
             playerCamera.isActive = true;  // 玩家相机初始激活
+            outer_wilds::CameraService::GetInstance().SetActiveCamera(playerEntity);
             playerCamera.fov = 60.0f;      // 降低FOV，让脚下地面更容易看到
             playerCamera.aspectRatio = 16.0f / 9.0f;
             playerCamera.nearPlane = 0.1f;
@@ -309,6 +499,9 @@ int main(int argc, char* argv[]) {
             controllerDesc.upDirection = physx::PxVec3(0.0f, 1.0f, 0.0f);  // 初始up方向
             controllerDesc.climbingMode = physx::PxCapsuleClimbingMode::eCONSTRAINED;
             controllerDesc.nonWalkableMode = physx::PxControllerNonWalkableMode::ePREVENT_CLIMBING_AND_FORCE_SLIDING;  // 滑落不可行走坡度
+            // 脚下的天体由 move 期间的碰撞回报写入 StandingOnComponent
+            controllerDesc.reportCallback = outer_wilds::CharacterControllerBatch::GetHitReport();
+            scene->GetRegistry().emplace<outer_wilds::components::StandingOnComponent>(playerEntity);
             
             auto* controllerManager = physxManager.GetControllerManager();
             character.pxController = controllerManager->createController(controllerDesc);
@@ -367,15 +560,17 @@ int main(int argc, char* argv[]) {
         spacecraftLoadOptions.skipBoundsCalculation = true;  // 飞船使用固定scale，无需计算包围盒
         spacecraftLoadOptions.fastLoad = true;               // 【快速加载】跳过切线/法线生成
         spacecraftLoadOptions.verbose = true;
+        spacecraftLoadOptions.packTextureArrays = true;      // 内嵌贴图打包进共享纹理数组
         
-        auto spacecraftEntity = outer_wilds::SceneAssetLoader::LoadModelAsEntityWithOptions(
+        // 【异步】飞船模型在加载线程上导入，实体先以占位网格出现；碰撞体使用固定尺寸，不依赖网格
+        auto spacecraftEntity = outer_wilds::SceneAssetLoader::LoadModelAsEntityAsync(
             scene->GetRegistry(), scene, device,
             "C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\models\\spacecraft\\base_basic_pbr.fbx",
             "C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\models\\spacecraft\\texture_diffuse_00.png",
             DirectX::XMFLOAT3(SPACECRAFT_LOCAL_X_OFFSET, SPACECRAFT_LOCAL_HEIGHT, 0.0f),  // 局部坐标
             DirectX::XMFLOAT3(SPACECRAFT_SCALE, SPACECRAFT_SCALE, SPACECRAFT_SCALE),
             spacecraftLoadOptions
-        );
+        ).entity;
         
         if (spacecraftEntity != entt::null) {
             // InSectorComponent（标记属于星球扇区）
@@ -491,10 +686,20 @@ int main(int argc, char* argv[]) {
             spacecraftActor->setMaxLinearVelocity(500.0f);  // 更高最大速度
             spacecraftActor->setMaxAngularVelocity(3.0f);   // 限制最大角速度（防止旋转太快）
             spacecraftActor->setSolverIterationCounts(8, 4);
+            // 高速飞行时防止穿透星球表面（场景的 CCD 由 PhysicsSettings::spacecraftCCD 开启）
+            if (outer_wilds::PhysXManager::GetInstance().GetSettings().spacecraftCCD) {
+                spacecraftActor->setRigidBodyFlag(physx::PxRigidBodyFlag::eENABLE_CCD, true);
+            }
             
             // 降低睡眠阈值，让飞船在有重力时不会轻易睡眠
             spacecraftActor->setSleepThreshold(0.05f);
             
+            spacecraftActor->userData = outer_wilds::ToActorUserData(spacecraftEntity);
+            // 着陆 / 离地（SectorPhysicsSystem）和撞击音效（AudioSystem）由接触事件驱动；
+            // 撞击阈值约 3 倍地表重力下的静止接触力
+            outer_wilds::EnableContactReports(*spacecraftActor,
+                outer_wilds::kReportContacts | outer_wilds::kReportImpacts | outer_wilds::kReportSleep,
+                rigidBody.mass * 30.0f);
             pxScene->addActor(*spacecraftActor);
             spacecraftActor->wakeUp();
             rigidBody.physxActor = spacecraftActor;
@@ -510,68 +715,15 @@ int main(int argc, char* argv[]) {
         
         // 太阳系已通过 SolarSystemBuilder 创建
 
-        // ========================================
-        // 启动欢迎界面流程
-        // ========================================
+        // 清单记录完毕：写给下次启动
+        outer_wilds::PreloadManifest::EndRecording().Save(outer_wilds::PreloadManifest::kDefaultPath);
         if (auto uiSystem = engine.GetUISystem()) {
-            uiSystem->ShowWelcomeScreenWithKeyWait("C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\ui\\kkstudio1.jpg");
-        }
-        
-        if (auto audioSystem = engine.GetAudioSystem()) {
-            audioSystem->PlaySingleTrack("C:\\Users\\kkakk\\homework\\OuterWilds\\assets\\Outer Wilds (Original Soundtrack)\\02 - Outer Wilds.mp3");
+            uiSystem->FinishLoading();
         }
         
         // 欢迎界面循环
-        bool shouldExit = false;
         while (engine.GetUISystem() && engine.GetUISystem()->IsWelcomeScreenVisible() && !shouldExit) {
-            MSG msg = {};
-            while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
-                TranslateMessage(&msg);
-                DispatchMessage(&msg);
-                if (msg.message == WM_QUIT) {
-                    shouldExit = true;
-                    engine.Stop();
-                    break;
-                }
-            }
-            
-            outer_wilds::TimeManager::GetInstance().Update();
-            float deltaTime = outer_wilds::TimeManager::GetInstance().GetDeltaTime();
-            
-            auto& registry = scene->GetRegistry();
-            if (auto uiSys = engine.GetUISystem()) {
-                uiSys->Update(deltaTime, registry);
-            }
-            if (auto audioSys = engine.GetAudioSystem()) {
-                audioSys->Update(deltaTime, registry);
-            }
-            
-            // 渲染
-            if (auto renderSystem = engine.GetRenderSystem()) {
-                auto renderBackend = renderSystem->GetBackend();
-                if (renderBackend) {
-                    auto context = static_cast<ID3D11DeviceContext*>(renderBackend->GetContext());
-                    auto renderTargetView = static_cast<ID3D11RenderTargetView*>(renderBackend->GetRenderTargetView());
-                    auto depthStencilView = static_cast<ID3D11DepthStencilView*>(renderBackend->GetDepthStencilView());
-                    
-                    if (context && renderTargetView && depthStencilView) {
-                        context->OMSetRenderTargets(1, &renderTargetView, depthStencilView);
-                        float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-                        context->ClearRenderTargetView(renderTargetView, clearColor);
-                        context->ClearDepthStencilView(depthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
-                    }
-                }
-                
-                if (auto uiSystem = engine.GetUISystem()) {
-                    uiSystem->Render();
-                }
-                
-                if (renderBackend) {
-                    renderBackend->EndFrame();
-                    renderBackend->Present();
-                }
-            }
-            
+            pumpWelcomeFrame();
             if (engine.GetUISystem() && engine.GetUISystem()->WasKeyPressed()) {
                 break;
             }
@@ -593,6 +745,11 @@ int main(int argc, char* argv[]) {
         
         // 主游戏循环
         outer_wilds::DebugManager::GetInstance().Log("Main", "Entering main game loop");
+        if (!replayPath.empty()) {
+            outer_wilds::InputRecorder::GetInstance().StartReplay(replayPath, replayReportPath);
+        } else if (!recordPath.empty()) {
+            outer_wilds::InputRecorder::GetInstance().StartRecording(recordPath);
+        }
         
         try {
             engine.Run();
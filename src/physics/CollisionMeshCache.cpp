@@ -0,0 +1,215 @@
+#include "CollisionMeshCache.h"
+#include "PhysXManager.h"
+#include "../core/DebugManager.h"
+#include "../core/Profiler.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace outer_wilds {
+
+namespace {
+    bool ReadFile(const std::string& path, std::vector<uint8_t>& out) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) return false;
+        std::streamsize size = file.tellg();
+        if (size <= 0) return false;
+        file.seekg(0, std::ios::beg);
+        out.resize(static_cast<size_t>(size));
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), size));
+    }
+
+    bool WriteFile(const std::string& path, const physx::PxDefaultMemoryOutputStream& stream) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::create_directories(fs::path(path).parent_path(), ec);
+
+        // 先写临时文件再重命名，避免中断时留下截断的缓存
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                DebugManager::GetInstance().Log("CollisionMeshCache", "Failed to write cache file: " + tempPath);
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(stream.getData()), static_cast<std::streamsize>(stream.getSize()));
+            if (!file) return false;
+        }
+        fs::rename(tempPath, path, ec);
+        if (ec) {
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+}
+
+physx::PxCookingParams CollisionMeshCache::MakeCookingParams(const physx::PxTolerancesScale& scale) {
+    // 默认参数（BVH34 中间结构）；修改这里时递增 kCookerVersion
+    return physx::PxCookingParams(scale);
+}
+
+uint64_t CollisionMeshCache::HashSource(const Source& source, Kind kind) const {
+    // FNV-1a 64
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    };
+
+    const uint8_t* positions = static_cast<const uint8_t*>(source.positions);
+    for (uint32_t i = 0; i < source.vertexCount; i++) {
+        mix(positions + static_cast<size_t>(i) * source.positionStride, sizeof(physx::PxVec3));
+    }
+    if (kind == Kind::Triangle) {
+        mix(source.indices, static_cast<size_t>(source.triangleCount) * 3 * sizeof(uint32_t));
+    }
+
+    const physx::PxTolerancesScale& scale = PhysXManager::GetInstance().GetPhysics()->getTolerancesScale();
+    const uint32_t version[2] = { PX_PHYSICS_VERSION, kCookerVersion };
+    mix(&kind, sizeof(kind));
+    mix(&scale.length, sizeof(scale.length));
+    mix(&scale.speed, sizeof(scale.speed));
+    mix(version, sizeof(version));
+    return hash;
+}
+
+std::string CollisionMeshCache::GetCachePath(uint64_t hash, Kind kind) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.%s", static_cast<unsigned long long>(hash),
+             kind == Kind::Triangle ? "tmesh" : "cmesh");
+    return m_CacheDirectory + "/" + name;
+}
+
+physx::PxTriangleMesh* CollisionMeshCache::AcquireTriangleMesh(const std::string& debugName, const Source& source) {
+    physx::PxPhysics* physics = PhysXManager::GetInstance().GetPhysics();
+    if (!physics || !source.positions || source.vertexCount == 0 || !source.indices || source.triangleCount == 0) {
+        return nullptr;
+    }
+    PROFILE_SCOPE("CollisionMeshCache::Triangle");
+
+    const uint64_t hash = HashSource(source, Kind::Triangle);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_TriangleMeshes.find(hash);
+        if (it != m_TriangleMeshes.end()) return it->second;
+    }
+
+    // === 1. 磁盘缓存 ===
+    const std::string path = GetCachePath(hash, Kind::Triangle);
+    physx::PxTriangleMesh* mesh = nullptr;
+    std::vector<uint8_t> bytes;
+    if (ReadFile(path, bytes)) {
+        physx::PxDefaultMemoryInputData input(bytes.data(), static_cast<uint32_t>(bytes.size()));
+        mesh = physics->createTriangleMesh(input);
+        if (mesh) {
+            m_DiskHits++;
+        } else {
+            DebugManager::GetInstance().Log("CollisionMeshCache", "Stale cache entry, recooking: " + path);
+        }
+    }
+
+    // === 2. 烹饪（结果写入 1） ===
+    if (!mesh) {
+        physx::PxTriangleMeshDesc desc;
+        desc.points.count = source.vertexCount;
+        desc.points.stride = source.positionStride;
+        desc.points.data = source.positions;
+        desc.triangles.count = source.triangleCount;
+        desc.triangles.stride = 3 * sizeof(uint32_t);
+        desc.triangles.data = source.indices;
+
+        physx::PxDefaultMemoryOutputStream output;
+        physx::PxTriangleMeshCookingResult::Enum result;
+        if (!PxCookTriangleMesh(MakeCookingParams(physics->getTolerancesScale()), desc, output, &result)) {
+            DebugManager::GetInstance().Log("CollisionMeshCache", "Triangle mesh cooking failed: " + debugName);
+            return nullptr;
+        }
+        physx::PxDefaultMemoryInputData input(output.getData(), output.getSize());
+        mesh = physics->createTriangleMesh(input);
+        if (!mesh) return nullptr;
+        m_Cooks++;
+        WriteFile(path, output);
+        DebugManager::GetInstance().Log("CollisionMeshCache", "Cooked triangle mesh " + debugName + " (" +
+            std::to_string(source.triangleCount) + " triangles)");
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto inserted = m_TriangleMeshes.emplace(hash, mesh);
+    if (!inserted.second) {
+        // 另一个线程同时创建了同一网格
+        mesh->release();
+    }
+    return inserted.first->second;
+}
+
+physx::PxConvexMesh* CollisionMeshCache::AcquireConvexMesh(const std::string& debugName, const Source& source) {
+    physx::PxPhysics* physics = PhysXManager::GetInstance().GetPhysics();
+    if (!physics || !source.positions || source.vertexCount == 0) {
+        return nullptr;
+    }
+    PROFILE_SCOPE("CollisionMeshCache::Convex");
+
+    const uint64_t hash = HashSource(source, Kind::Convex);
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_ConvexMeshes.find(hash);
+        if (it != m_ConvexMeshes.end()) return it->second;
+    }
+
+    const std::string path = GetCachePath(hash, Kind::Convex);
+    physx::PxConvexMesh* mesh = nullptr;
+    std::vector<uint8_t> bytes;
+    if (ReadFile(path, bytes)) {
+        physx::PxDefaultMemoryInputData input(bytes.data(), static_cast<uint32_t>(bytes.size()));
+        mesh = physics->createConvexMesh(input);
+        if (mesh) {
+            m_DiskHits++;
+        } else {
+            DebugManager::GetInstance().Log("CollisionMeshCache", "Stale cache entry, recooking: " + path);
+        }
+    }
+
+    if (!mesh) {
+        physx::PxConvexMeshDesc desc;
+        desc.points.count = source.vertexCount;
+        desc.points.stride = source.positionStride;
+        desc.points.data = source.positions;
+        desc.flags = physx::PxConvexFlag::eCOMPUTE_CONVEX | physx::PxConvexFlag::eSHIFT_VERTICES;
+
+        physx::PxDefaultMemoryOutputStream output;
+        physx::PxConvexMeshCookingResult::Enum result;
+        if (!PxCookConvexMesh(MakeCookingParams(physics->getTolerancesScale()), desc, output, &result)) {
+            DebugManager::GetInstance().Log("CollisionMeshCache", "Convex mesh cooking failed: " + debugName);
+            return nullptr;
+        }
+        physx::PxDefaultMemoryInputData input(output.getData(), output.getSize());
+        mesh = physics->createConvexMesh(input);
+        if (!mesh) return nullptr;
+        m_Cooks++;
+        WriteFile(path, output);
+        DebugManager::GetInstance().Log("CollisionMeshCache", "Cooked convex mesh " + debugName + " (" +
+            std::to_string(source.vertexCount) + " points)");
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto inserted = m_ConvexMeshes.emplace(hash, mesh);
+    if (!inserted.second) {
+        mesh->release();
+    }
+    return inserted.first->second;
+}
+
+void CollisionMeshCache::Release() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (auto& entry : m_TriangleMeshes) entry.second->release();
+    for (auto& entry : m_ConvexMeshes) entry.second->release();
+    m_TriangleMeshes.clear();
+    m_ConvexMeshes.clear();
+}
+
+} // namespace outer_wilds
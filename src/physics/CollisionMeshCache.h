@@ -0,0 +1,88 @@
+/**
+ * CollisionMeshCache.h
+ *
+ * 烹饪（cook）后的碰撞网格磁盘缓存
+ *
+ * 三角网格 / 凸包的烹饪结果按源数据哈希写入 cache/collision/<hash>.tmesh|.cmesh
+ * （FNV-1a：顶点位置 + 索引 + 烹饪参数 + PX_PHYSICS_VERSION + kCookerVersion），
+ * 之后的启动直接用 PxPhysics::createTriangleMesh / createConvexMesh 从文件流创建，跳过烹饪。
+ * 同一次运行中相同源数据只创建一次（共享同一个 PxTriangleMesh / PxConvexMesh）。
+ *
+ * 线程安全：Acquire 可以在加载线程上调用（PxPhysics 的创建方法是线程安全的）。
+ */
+
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace outer_wilds {
+
+class CollisionMeshCache {
+public:
+    /**
+     * 修改烹饪参数或输入约定时递增，使旧缓存失效
+     */
+    static constexpr uint32_t kCookerVersion = 1;
+
+    /**
+     * @brief 烹饪的源数据（通常直接指向 resources::Mesh 的顶点/索引数组）
+     */
+    struct Source {
+        const void* positions = nullptr;    // 第一个顶点的 position（float3）
+        uint32_t positionStride = sizeof(physx::PxVec3);  // 相邻顶点的字节跨度（Vertex 为 sizeof(Vertex)）
+        uint32_t vertexCount = 0;
+        const uint32_t* indices = nullptr;  // 三角形索引（凸包忽略）
+        uint32_t triangleCount = 0;
+    };
+
+    static CollisionMeshCache& GetInstance() {
+        static CollisionMeshCache instance;
+        return instance;
+    }
+
+    /**
+     * @brief 获取三角网格（静态碰撞体：星球地表、扇区地面）
+     * @param debugName 仅用于日志
+     * @return 失败时返回 nullptr；返回的网格归缓存所有，创建 shape 后 PhysX 自行持有引用
+     */
+    physx::PxTriangleMesh* AcquireTriangleMesh(const std::string& debugName, const Source& source);
+
+    /**
+     * @brief 获取凸包（动态刚体：飞船等），顶点数超过 255 时由 PhysX 简化
+     */
+    physx::PxConvexMesh* AcquireConvexMesh(const std::string& debugName, const Source& source);
+
+    /** @brief 释放缓存持有的引用（PhysXManager::Shutdown 在释放 PxPhysics 之前调用） */
+    void Release();
+
+    void SetCacheDirectory(const std::string& directory) { m_CacheDirectory = directory; }
+    const std::string& GetCacheDirectory() const { return m_CacheDirectory; }
+
+    /** @brief 统计：磁盘缓存命中 / 本次运行中烹饪的网格数 */
+    uint32_t GetDiskHitCount() const { return m_DiskHits; }
+    uint32_t GetCookCount() const { return m_Cooks; }
+
+private:
+    CollisionMeshCache() = default;
+    CollisionMeshCache(const CollisionMeshCache&) = delete;
+    CollisionMeshCache& operator=(const CollisionMeshCache&) = delete;
+
+    enum class Kind : uint8_t { Triangle, Convex };
+
+    uint64_t HashSource(const Source& source, Kind kind) const;
+    std::string GetCachePath(uint64_t hash, Kind kind) const;
+    static physx::PxCookingParams MakeCookingParams(const physx::PxTolerancesScale& scale);
+
+    std::mutex m_Mutex;
+    std::unordered_map<uint64_t, physx::PxTriangleMesh*> m_TriangleMeshes;
+    std::unordered_map<uint64_t, physx::PxConvexMesh*> m_ConvexMeshes;
+    std::string m_CacheDirectory = "cache/collision";
+    std::atomic<uint32_t> m_DiskHits{ 0 };
+    std::atomic<uint32_t> m_Cooks{ 0 };
+};
+
+} // namespace outer_wilds
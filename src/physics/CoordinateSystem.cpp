@@ -0,0 +1,75 @@
+#include "CoordinateSystem.h"
+
+using namespace DirectX;
+
+namespace outer_wilds {
+
+namespace {
+    // 与 SectorPhysicsSystem::LocalToWorld 的无旋转判定一致
+    constexpr float kIdentityRotationEpsilon = 0.001f;
+
+    inline XMVECTOR LoadFloats(const float* p) {
+        return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(p));
+    }
+
+    inline void StoreFloats(float* p, FXMVECTOR value) {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(p), value);
+    }
+}
+
+void CoordinateSystem::PhysicsToWorld(const XMFLOAT3* physicsPositions, XMFLOAT3* worldPositions, size_t count) {
+    // 4 个位置 = 12 个 float：x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3，每个寄存器乘对应位置的符号
+    const XMVECTOR signs0 = XMVectorSet(1.0f, 1.0f, -1.0f, 1.0f);
+    const XMVECTOR signs1 = XMVectorSet(1.0f, -1.0f, 1.0f, 1.0f);
+    const XMVECTOR signs2 = XMVectorSet(-1.0f, 1.0f, 1.0f, -1.0f);
+
+    const float* src = &physicsPositions[0].x;
+    float* dst = &worldPositions[0].x;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, src += 12, dst += 12) {
+        const XMVECTOR a = LoadFloats(src);
+        const XMVECTOR b = LoadFloats(src + 4);
+        const XMVECTOR c = LoadFloats(src + 8);
+        StoreFloats(dst, XMVectorMultiply(a, signs0));
+        StoreFloats(dst + 4, XMVectorMultiply(b, signs1));
+        StoreFloats(dst + 8, XMVectorMultiply(c, signs2));
+    }
+    for (; i < count; i++) {
+        worldPositions[i] = PhysicsToWorld(physicsPositions[i]);
+    }
+}
+
+void CoordinateSystem::PhysicsToWorld(const XMFLOAT4* physicsRotations, XMFLOAT4* worldRotations, size_t count) {
+    const XMVECTOR signs = XMVectorSet(1.0f, 1.0f, -1.0f, 1.0f);
+    for (size_t i = 0; i < count; i++) {
+        XMStoreFloat4(&worldRotations[i], XMVectorMultiply(XMLoadFloat4(&physicsRotations[i]), signs));
+    }
+}
+
+void CoordinateSystem::SectorLocalToWorld(const XMFLOAT3& sectorPosition, const XMFLOAT4& sectorRotation,
+                                          const XMFLOAT3* localPositions, const XMFLOAT4* localRotations,
+                                          XMFLOAT3* worldPositions, XMFLOAT4* worldRotations, size_t count) {
+    const XMVECTOR sectorQ = XMLoadFloat4(&sectorRotation);
+    const XMVECTOR translation = XMLoadFloat3(&sectorPosition);
+    const float rotationDelta = XMVectorGetX(XMVector4Length(XMVectorSubtract(sectorQ, XMQuaternionIdentity())));
+
+    if (rotationDelta < kIdentityRotationEpsilon) {
+        for (size_t i = 0; i < count; i++) {
+            XMStoreFloat3(&worldPositions[i], XMVectorAdd(XMLoadFloat3(&localPositions[i]), translation));
+        }
+    } else {
+        // 旋转 + 平移合成一个仿射矩阵：每个位置 3 次乘加（四元数旋转每个约两次四元数乘法）
+        XMMATRIX transform = XMMatrixRotationQuaternion(sectorQ);
+        transform.r[3] = XMVectorSetW(translation, 1.0f);
+        for (size_t i = 0; i < count; i++) {
+            XMStoreFloat3(&worldPositions[i], XMVector3Transform(XMLoadFloat3(&localPositions[i]), transform));
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const XMVECTOR combined = XMQuaternionMultiply(XMLoadFloat4(&localRotations[i]), sectorQ);
+        XMStoreFloat4(&worldRotations[i], XMQuaternionNormalize(combined));
+    }
+}
+
+} // namespace outer_wilds
@@ -1,6 +1,7 @@
 #pragma once
 #include <DirectXMath.h>
 #include <PxPhysicsAPI.h>
+#include <cstddef>
 
 namespace outer_wilds {
 
@@ -18,7 +19,7 @@ namespace outer_wilds {
  * - 旋转: Z 和 W 分量符号变化（四元数转换）
  * 
  * 使用约定：
- * - "World" 坐标 = DirectX 左手系（用于渲染）
+ * - "World" 坐标 = DirectX 左手系（用于渲染），单精度、相对浮动原点（见 FloatingOrigin.h）
  * - "Physics" 坐标 = PhysX 右手系（用于物理模拟）
  * - "Sector Local" 坐标 = 使用 Physics 坐标系（因为物理在这里运行）
  */
@@ -174,6 +175,44 @@ public:
             WorldToPhysics(worldRotation)
         );
     }
+    
+    // ============================================
+    // 批量转换（连续数组，DirectXMath SIMD；输出可以就是输入数组）
+    // ============================================
+    
+    /**
+     * PhysX 位置 / 向量 → DirectX，count 个（Z 翻转，每次 4 个位置 = 3 个 SIMD 寄存器）
+     */
+    static void PhysicsToWorld(const DirectX::XMFLOAT3* physicsPositions, DirectX::XMFLOAT3* worldPositions,
+                               size_t count);
+    
+    /**
+     * PhysX 四元数 → DirectX 四元数，count 个
+     */
+    static void PhysicsToWorld(const DirectX::XMFLOAT4* physicsRotations, DirectX::XMFLOAT4* worldRotations,
+                               size_t count);
+    
+    /** DirectX → PhysX（Z 翻转是自身的逆） */
+    static void WorldToPhysics(const DirectX::XMFLOAT3* worldPositions, DirectX::XMFLOAT3* physicsPositions,
+                               size_t count) {
+        PhysicsToWorld(worldPositions, physicsPositions, count);
+    }
+    static void WorldToPhysics(const DirectX::XMFLOAT4* worldRotations, DirectX::XMFLOAT4* physicsRotations,
+                               size_t count) {
+        PhysicsToWorld(worldRotations, physicsRotations, count);
+    }
+    
+    /**
+     * 同一扇区的局部位姿 → 世界位姿，count 个：
+     *   位置 = 扇区位置 + R(扇区旋转) * 局部位置，旋转 = normalize(扇区旋转 * 局部旋转)
+     *
+     * 扇区的旋转矩阵只构建一次；扇区没有旋转时只做平移。
+     * 与 SectorPhysicsSystem::LocalToWorld / CombineRotations 逐个计算的结果一致（扇区局部坐标不翻转 Z）。
+     */
+    static void SectorLocalToWorld(const DirectX::XMFLOAT3& sectorPosition, const DirectX::XMFLOAT4& sectorRotation,
+                                   const DirectX::XMFLOAT3* localPositions, const DirectX::XMFLOAT4* localRotations,
+                                   DirectX::XMFLOAT3* worldPositions, DirectX::XMFLOAT4* worldRotations,
+                                   size_t count);
 };
 
 } // namespace outer_wilds
@@ -0,0 +1,87 @@
+#include "FloatingOrigin.h"
+#include "components/SectorComponent.h"
+#include "../scene/components/TransformComponent.h"
+#include "../gameplay/components/PlayerComponent.h"
+#include "../gameplay/components/SpacecraftComponent.h"
+#include "../graphics/components/CameraComponent.h"
+#include "../graphics/components/FreeCameraComponent.h"
+#include "../graphics/CameraService.h"
+#include "../core/DebugManager.h"
+#include <string>
+
+namespace outer_wilds {
+
+using namespace components;
+
+namespace {
+    void Subtract(DirectX::XMFLOAT3& v, const DirectX::XMFLOAT3& shift) {
+        v.x -= shift.x;
+        v.y -= shift.y;
+        v.z -= shift.z;
+    }
+}
+
+bool FloatingOrigin::Update(entt::registry& registry) {
+    m_FrameShift = { 0.0f, 0.0f, 0.0f };
+
+    // 关注点：驾驶中的飞船优先，否则玩家
+    const TransformComponent* focus = nullptr;
+    auto spacecraftView = registry.view<SpacecraftComponent, TransformComponent>();
+    for (auto entity : spacecraftView) {
+        if (spacecraftView.get<SpacecraftComponent>(entity).currentState == SpacecraftComponent::State::PILOTED) {
+            focus = &spacecraftView.get<TransformComponent>(entity);
+            break;
+        }
+    }
+    if (!focus) {
+        auto playerView = registry.view<PlayerComponent, TransformComponent>();
+        for (auto entity : playerView) {
+            focus = &playerView.get<TransformComponent>(entity);
+            break;
+        }
+    }
+    if (!focus) return false;
+
+    const DirectX::XMFLOAT3& p = focus->position;
+    if (p.x * p.x + p.y * p.y + p.z * p.z <= m_RebaseDistance * m_RebaseDistance) return false;
+
+    Rebase(registry, ToAbsolute(p));
+    return true;
+}
+
+void FloatingOrigin::Rebase(entt::registry& registry, const WorldPosition& newOrigin) {
+    const DirectX::XMFLOAT3 shift = (newOrigin - m_Origin).ToFloat3();
+    m_Origin = newOrigin;
+    m_FrameShift = shift;
+    m_RebaseCount++;
+
+    // 单精度世界坐标整体平移（扇区内实体本帧稍后还会由局部坐标重新计算）
+    for (auto entity : registry.view<TransformComponent>()) {
+        Subtract(registry.get<TransformComponent>(entity).position, shift);
+    }
+    for (auto entity : registry.view<CameraComponent>()) {
+        auto& camera = registry.get<CameraComponent>(entity);
+        Subtract(camera.position, shift);
+        Subtract(camera.target, shift);
+    }
+    for (auto entity : registry.view<FreeCameraComponent>()) {
+        Subtract(registry.get<FreeCameraComponent>(entity).position, shift);
+    }
+    // 上一帧的相机数据（音频听者 / 地形 LOD 在本帧系统更新中读取）
+    CameraService::GetInstance().ShiftOrigin(shift);
+    for (auto entity : registry.view<InSectorComponent>()) {
+        Subtract(registry.get<InSectorComponent>(entity).lastSectorQueryPosition, shift);
+    }
+
+    // 扇区：由双精度位置重新换算（没有轨道的扇区之后不会再被 OrbitSystem 刷新）
+    for (auto entity : registry.view<SectorComponent>()) {
+        auto& sector = registry.get<SectorComponent>(entity);
+        sector.worldPosition = ToRelative(sector.absolutePosition);
+    }
+
+    DebugManager::GetInstance().Log("FloatingOrigin",
+        "Rebased to (" + std::to_string(m_Origin.x) + ", " + std::to_string(m_Origin.y) + ", " +
+        std::to_string(m_Origin.z) + ")");
+}
+
+} // namespace outer_wilds
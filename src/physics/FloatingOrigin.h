@@ -0,0 +1,89 @@
+/**
+ * FloatingOrigin.h
+ *
+ * 双精度世界坐标 + 浮动原点
+ *
+ * 坐标约定：
+ * - "Absolute" 坐标 = 双精度世界坐标（WorldPosition），扇区/轨道的权威位置
+ * - TransformComponent::position、SectorComponent::worldPosition = 相对浮动原点的单精度坐标
+ *   （渲染、相机、游戏逻辑都在这个空间里，原点始终跟随玩家，数值保持很小）
+ * - PhysX 仍然使用扇区局部坐标（InSectorComponent::localPosition），不受原点影响
+ *
+ * 玩家离原点超过 rebaseDistance 时，原点移到玩家处：所有单精度世界坐标整体平移，
+ * 扇区的单精度位置由双精度位置重新换算。太阳系因此可以放大而不会抖动。
+ */
+
+#pragma once
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+
+namespace outer_wilds {
+
+/**
+ * @brief 双精度世界坐标（DirectX 左手系）
+ */
+struct WorldPosition {
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+
+    WorldPosition() = default;
+    WorldPosition(double px, double py, double pz) : x(px), y(py), z(pz) {}
+    explicit WorldPosition(const DirectX::XMFLOAT3& v) : x(v.x), y(v.y), z(v.z) {}
+
+    WorldPosition operator+(const WorldPosition& o) const { return { x + o.x, y + o.y, z + o.z }; }
+    WorldPosition operator-(const WorldPosition& o) const { return { x - o.x, y - o.y, z - o.z }; }
+    WorldPosition& operator+=(const WorldPosition& o) { x += o.x; y += o.y; z += o.z; return *this; }
+
+    DirectX::XMFLOAT3 ToFloat3() const {
+        return { static_cast<float>(x), static_cast<float>(y), static_cast<float>(z) };
+    }
+};
+
+class FloatingOrigin {
+public:
+    static FloatingOrigin& GetInstance() {
+        static FloatingOrigin instance;
+        return instance;
+    }
+
+    const WorldPosition& GetOrigin() const { return m_Origin; }
+
+    /** @brief 双精度世界坐标 → 相对原点的单精度坐标（先在双精度下相减） */
+    DirectX::XMFLOAT3 ToRelative(const WorldPosition& absolute) const {
+        return (absolute - m_Origin).ToFloat3();
+    }
+
+    /** @brief 相对原点的单精度坐标 → 双精度世界坐标 */
+    WorldPosition ToAbsolute(const DirectX::XMFLOAT3& relative) const {
+        return m_Origin + WorldPosition(relative);
+    }
+
+    /**
+     * @brief 每帧在 OrbitSystem 之前调用：玩家离原点太远时平移原点
+     *
+     * 平移所有 TransformComponent / 相机组件的单精度坐标，并由 SectorComponent::absolutePosition
+     * 刷新每个扇区的 worldPosition。返回本帧是否发生了平移。
+     */
+    bool Update(entt::registry& registry);
+
+    /** @brief 本帧原点平移量（单精度坐标都减去了它）；没有平移时为 0。缓存世界坐标的系统用它修正 */
+    const DirectX::XMFLOAT3& GetFrameShift() const { return m_FrameShift; }
+
+    void SetRebaseDistance(float distance) { m_RebaseDistance = distance; }
+    float GetRebaseDistance() const { return m_RebaseDistance; }
+    uint32_t GetRebaseCount() const { return m_RebaseCount; }
+
+private:
+    FloatingOrigin() = default;
+
+    void Rebase(entt::registry& registry, const WorldPosition& newOrigin);
+
+    WorldPosition m_Origin;
+    DirectX::XMFLOAT3 m_FrameShift = { 0.0f, 0.0f, 0.0f };
+    float m_RebaseDistance = 2000.0f;
+    uint32_t m_RebaseCount = 0;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,425 @@
+#include "GravityKernel.h"
+#include "../core/FrameAllocator.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace outer_wilds {
+
+namespace {
+    constexpr float kMinDirectionDistance = 0.01f;
+
+    inline XMVECTOR Load4(const std::vector<float>& v, uint32_t i) {
+        return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&v[i]));
+    }
+
+    inline void Store4(std::vector<float>& v, uint32_t i, FXMVECTOR value) {
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&v[i]), value);
+    }
+
+    /**
+     * @brief GravitySourceComponent::CalculateGravityStrength 的 4 路版本
+     */
+    inline XMVECTOR GravityStrength(FXMVECTOR distance, FXMVECTOR radius, FXMVECTOR influence,
+                                    GXMVECTOR surfaceGravity, HXMVECTOR realistic) {
+        const XMVECTOR zero = XMVectorZero();
+        const XMVECTOR one = XMVectorSplatOne();
+
+        // 真实衰减：g / (d/r)^2，d/r 下限 0.01
+        XMVECTOR normalized = XMVectorMax(XMVectorDivide(distance, radius), XMVectorReplicate(0.01f));
+        XMVECTOR realisticStrength = XMVectorDivide(surfaceGravity, XMVectorMultiply(normalized, normalized));
+
+        // 简化：1.5r 以内恒定，之后线性衰减到影响边界
+        XMVECTOR nearSurface = XMVectorMultiply(radius, XMVectorReplicate(1.5f));
+        XMVECTOR t = XMVectorDivide(XMVectorSubtract(distance, nearSurface), XMVectorSubtract(influence, nearSurface));
+        t = XMVectorMin(t, one);
+        XMVECTOR simpleStrength = XMVectorSelect(XMVectorMultiply(surfaceGravity, XMVectorSubtract(one, t)),
+                                                 surfaceGravity, XMVectorLess(distance, nearSurface));
+
+        XMVECTOR strength = XMVectorSelect(simpleStrength, realisticStrength,
+                                           XMVectorGreater(realistic, XMVectorReplicate(0.5f)));
+        return XMVectorSelect(strength, zero, XMVectorGreater(distance, influence));
+    }
+
+    inline float GravityStrength(float distance, float radius, float influence, float surfaceGravity, bool realistic) {
+        if (distance > influence) return 0.0f;
+        if (realistic) {
+            float normalized = distance / radius;
+            if (normalized < 0.01f) normalized = 0.01f;
+            return surfaceGravity / (normalized * normalized);
+        }
+        if (distance < radius * 1.5f) return surfaceGravity;
+        float t = (distance - radius * 1.5f) / (influence - radius * 1.5f);
+        t = (t > 1.0f) ? 1.0f : t;
+        return surfaceGravity * (1.0f - t);
+    }
+
+    constexpr uint32_t kMaxOctreeDepth = 16;
+    constexpr float kMinNodeSize = 1e-3f;
+}
+
+void GravitySourceSoA::Clear() {
+    x.clear(); y.clear(); z.clear();
+    radius.clear(); influenceRadius.clear(); surfaceGravity.clear(); realistic.clear();
+}
+
+void GravitySourceSoA::Push(float px, float py, float pz, float r, float influence, float g, bool useRealistic) {
+    x.push_back(px); y.push_back(py); z.push_back(pz);
+    radius.push_back(r);
+    influenceRadius.push_back(influence);
+    surfaceGravity.push_back(g);
+    realistic.push_back(useRealistic ? 1.0f : 0.0f);
+}
+
+void GravityBatchSoA::Clear() {
+    x.clear(); y.clear(); z.clear();
+    radius.clear(); influenceRadius.clear(); surfaceGravity.clear(); realistic.clear();
+    m_Count = 0;
+}
+
+void GravityBatchSoA::Push(float px, float py, float pz) {
+    x.push_back(px); y.push_back(py); z.push_back(pz);
+    m_Count++;
+}
+
+void GravityBatchSoA::PushWithSource(float px, float py, float pz, float r, float influence, float g, bool useRealistic) {
+    Push(px, py, pz);
+    radius.push_back(r);
+    influenceRadius.push_back(influence);
+    surfaceGravity.push_back(g);
+    realistic.push_back(useRealistic ? 1.0f : 0.0f);
+}
+
+void GravityBatchSoA::Finalize() {
+    const size_t padded = (static_cast<size_t>(m_Count) + 3) & ~static_cast<size_t>(3);
+    x.resize(padded, 0.0f);
+    y.resize(padded, 0.0f);
+    z.resize(padded, 0.0f);
+    if (!radius.empty()) {
+        // 补齐的通道用无害参数，避免产生 NaN
+        radius.resize(padded, 1.0f);
+        influenceRadius.resize(padded, 1.0f);
+        surfaceGravity.resize(padded, 0.0f);
+        realistic.resize(padded, 0.0f);
+    }
+    dirX.resize(padded);
+    dirY.resize(padded);
+    dirZ.resize(padded);
+    strength.resize(padded);
+    distance.resize(padded);
+    sourceIndex.resize(padded);
+}
+
+void EvaluateSectorGravity(GravityBatchSoA& batch) {
+    const uint32_t count = static_cast<uint32_t>(batch.x.size());
+    const XMVECTOR minDistance = XMVectorReplicate(kMinDirectionDistance);
+    const XMVECTOR zero = XMVectorZero();
+
+    for (uint32_t i = 0; i < count; i += 4) {
+        XMVECTOR px = Load4(batch.x, i);
+        XMVECTOR py = Load4(batch.y, i);
+        XMVECTOR pz = Load4(batch.z, i);
+
+        XMVECTOR distSq = XMVectorMultiplyAdd(px, px, XMVectorMultiplyAdd(py, py, XMVectorMultiply(pz, pz)));
+        XMVECTOR dist = XMVectorSqrt(distSq);
+        XMVECTOR valid = XMVectorGreater(dist, minDistance);
+        XMVECTOR scale = XMVectorSelect(zero, XMVectorNegate(XMVectorReciprocal(dist)), valid);
+
+        Store4(batch.dirX, i, XMVectorMultiply(px, scale));
+        Store4(batch.dirY, i, XMVectorMultiply(py, scale));
+        Store4(batch.dirZ, i, XMVectorMultiply(pz, scale));
+        Store4(batch.distance, i, dist);
+        Store4(batch.strength, i, GravityStrength(dist, Load4(batch.radius, i), Load4(batch.influenceRadius, i),
+                                                  Load4(batch.surfaceGravity, i), Load4(batch.realistic, i)));
+    }
+}
+
+void EvaluateNearestSourceGravity(GravityBatchSoA& batch, const GravitySourceSoA& sources) {
+    const uint32_t count = static_cast<uint32_t>(batch.x.size());
+    const uint32_t sourceCount = sources.Size();
+    const XMVECTOR minDistance = XMVectorReplicate(kMinDirectionDistance);
+    const XMVECTOR zero = XMVectorZero();
+
+    for (uint32_t i = 0; i < count; i += 4) {
+        XMVECTOR px = Load4(batch.x, i);
+        XMVECTOR py = Load4(batch.y, i);
+        XMVECTOR pz = Load4(batch.z, i);
+
+        XMVECTOR bestDistSq = XMVectorReplicate(FLT_MAX);
+        XMVECTOR bestDx = zero, bestDy = zero, bestDz = zero;
+        XMVECTOR bestIndex = XMVectorReplicate(-1.0f);
+        XMVECTOR bestRadius = XMVectorSplatOne();
+        XMVECTOR bestInfluence = XMVectorSplatOne();
+        XMVECTOR bestGravity = zero;
+        XMVECTOR bestRealistic = zero;
+
+        // 严格小于：距离相同时保留先出现的源（与原标量循环一致）
+        for (uint32_t s = 0; s < sourceCount; s++) {
+            XMVECTOR dx = XMVectorSubtract(px, XMVectorReplicate(sources.x[s]));
+            XMVECTOR dy = XMVectorSubtract(py, XMVectorReplicate(sources.y[s]));
+            XMVECTOR dz = XMVectorSubtract(pz, XMVectorReplicate(sources.z[s]));
+            XMVECTOR distSq = XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dz, dz)));
+
+            const float influence = sources.influenceRadius[s];
+            XMVECTOR closer = XMVectorAndInt(XMVectorLess(distSq, bestDistSq),
+                                             XMVectorLess(distSq, XMVectorReplicate(influence * influence)));
+
+            bestDistSq = XMVectorSelect(bestDistSq, distSq, closer);
+            bestDx = XMVectorSelect(bestDx, dx, closer);
+            bestDy = XMVectorSelect(bestDy, dy, closer);
+            bestDz = XMVectorSelect(bestDz, dz, closer);
+            bestIndex = XMVectorSelect(bestIndex, XMVectorReplicate(static_cast<float>(s)), closer);
+            bestRadius = XMVectorSelect(bestRadius, XMVectorReplicate(sources.radius[s]), closer);
+            bestInfluence = XMVectorSelect(bestInfluence, XMVectorReplicate(influence), closer);
+            bestGravity = XMVectorSelect(bestGravity, XMVectorReplicate(sources.surfaceGravity[s]), closer);
+            bestRealistic = XMVectorSelect(bestRealistic, XMVectorReplicate(sources.realistic[s]), closer);
+        }
+
+        XMVECTOR dist = XMVectorSqrt(bestDistSq);
+        XMVECTOR valid = XMVectorGreater(dist, minDistance);
+        XMVECTOR scale = XMVectorSelect(zero, XMVectorNegate(XMVectorReciprocal(dist)), valid);
+
+        Store4(batch.dirX, i, XMVectorMultiply(bestDx, scale));
+        Store4(batch.dirY, i, XMVectorMultiply(bestDy, scale));
+        Store4(batch.dirZ, i, XMVectorMultiply(bestDz, scale));
+        Store4(batch.distance, i, dist);
+        Store4(batch.strength, i, GravityStrength(dist, bestRadius, bestInfluence, bestGravity, bestRealistic));
+
+        XMFLOAT4 index;
+        XMStoreFloat4(&index, bestIndex);
+        batch.sourceIndex[i + 0] = static_cast<int32_t>(index.x);
+        batch.sourceIndex[i + 1] = static_cast<int32_t>(index.y);
+        batch.sourceIndex[i + 2] = static_cast<int32_t>(index.z);
+        batch.sourceIndex[i + 3] = static_cast<int32_t>(index.w);
+    }
+}
+
+void EvaluateSummedGravity(GravityBatchSoA& batch, const GravitySourceSoA& sources) {
+    const uint32_t count = static_cast<uint32_t>(batch.x.size());
+    const uint32_t sourceCount = sources.Size();
+    const XMVECTOR minDistance = XMVectorReplicate(kMinDirectionDistance);
+    const XMVECTOR minMagnitude = XMVectorReplicate(1e-6f);
+    const XMVECTOR zero = XMVectorZero();
+
+    for (uint32_t i = 0; i < count; i += 4) {
+        XMVECTOR px = Load4(batch.x, i);
+        XMVECTOR py = Load4(batch.y, i);
+        XMVECTOR pz = Load4(batch.z, i);
+
+        XMVECTOR ax = zero, ay = zero, az = zero;
+        XMVECTOR bestStrength = zero;
+        XMVECTOR bestIndex = XMVectorReplicate(-1.0f);
+
+        for (uint32_t s = 0; s < sourceCount; s++) {
+            XMVECTOR dx = XMVectorSubtract(px, XMVectorReplicate(sources.x[s]));
+            XMVECTOR dy = XMVectorSubtract(py, XMVectorReplicate(sources.y[s]));
+            XMVECTOR dz = XMVectorSubtract(pz, XMVectorReplicate(sources.z[s]));
+            XMVECTOR dist = XMVectorSqrt(XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dz, dz))));
+            XMVECTOR valid = XMVectorGreater(dist, minDistance);
+
+            XMVECTOR strength = GravityStrength(dist, XMVectorReplicate(sources.radius[s]),
+                                                XMVectorReplicate(sources.influenceRadius[s]),
+                                                XMVectorReplicate(sources.surfaceGravity[s]),
+                                                XMVectorReplicate(sources.realistic[s]));
+            strength = XMVectorSelect(zero, strength, valid);
+
+            // 指向源：-d / |d| * strength
+            XMVECTOR scale = XMVectorSelect(zero, XMVectorNegate(XMVectorMultiply(strength, XMVectorReciprocal(dist))), valid);
+            ax = XMVectorMultiplyAdd(dx, scale, ax);
+            ay = XMVectorMultiplyAdd(dy, scale, ay);
+            az = XMVectorMultiplyAdd(dz, scale, az);
+
+            XMVECTOR stronger = XMVectorGreater(strength, bestStrength);
+            bestStrength = XMVectorSelect(bestStrength, strength, stronger);
+            bestIndex = XMVectorSelect(bestIndex, XMVectorReplicate(static_cast<float>(s)), stronger);
+        }
+
+        XMVECTOR magnitude = XMVectorSqrt(XMVectorMultiplyAdd(ax, ax, XMVectorMultiplyAdd(ay, ay, XMVectorMultiply(az, az))));
+        XMVECTOR scale = XMVectorSelect(zero, XMVectorReciprocal(magnitude), XMVectorGreater(magnitude, minMagnitude));
+
+        Store4(batch.dirX, i, XMVectorMultiply(ax, scale));
+        Store4(batch.dirY, i, XMVectorMultiply(ay, scale));
+        Store4(batch.dirZ, i, XMVectorMultiply(az, scale));
+        Store4(batch.strength, i, magnitude);
+        Store4(batch.distance, i, magnitude);
+
+        XMFLOAT4 index;
+        XMStoreFloat4(&index, bestIndex);
+        batch.sourceIndex[i + 0] = static_cast<int32_t>(index.x);
+        batch.sourceIndex[i + 1] = static_cast<int32_t>(index.y);
+        batch.sourceIndex[i + 2] = static_cast<int32_t>(index.z);
+        batch.sourceIndex[i + 3] = static_cast<int32_t>(index.w);
+    }
+}
+
+void GravityOctree::Build(const GravitySourceSoA& sources, uint32_t leafSize) {
+    m_Nodes.clear();
+    m_LeafSize = leafSize > 0 ? leafSize : 1;
+
+    const uint32_t count = sources.Size();
+    m_Indices.resize(count);
+    for (uint32_t i = 0; i < count; i++) m_Indices[i] = i;
+    if (count == 0) return;
+
+    m_Nodes.reserve(count / m_LeafSize * 2 + 1);
+    BuildNode(sources, 0, count, 0);
+}
+
+uint32_t GravityOctree::BuildNode(const GravitySourceSoA& sources, uint32_t begin, uint32_t end, uint32_t depth) {
+    const uint32_t nodeIndex = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.emplace_back();
+
+    // 包围盒、等效质量和 μ 加权中心
+    float minX = FLT_MAX, minY = FLT_MAX, minZ = FLT_MAX;
+    float maxX = -FLT_MAX, maxY = -FLT_MAX, maxZ = -FLT_MAX;
+    float mu = 0.0f, cx = 0.0f, cy = 0.0f, cz = 0.0f;
+    float strongestMu = -1.0f;
+    int32_t strongest = -1;
+    for (uint32_t k = begin; k < end; k++) {
+        const uint32_t s = m_Indices[k];
+        const float sx = sources.x[s], sy = sources.y[s], sz = sources.z[s];
+        minX = (std::min)(minX, sx); maxX = (std::max)(maxX, sx);
+        minY = (std::min)(minY, sy); maxY = (std::max)(maxY, sy);
+        minZ = (std::min)(minZ, sz); maxZ = (std::max)(maxZ, sz);
+
+        const float sourceMu = sources.surfaceGravity[s] * sources.radius[s] * sources.radius[s];
+        mu += sourceMu;
+        cx += sx * sourceMu; cy += sy * sourceMu; cz += sz * sourceMu;
+        if (sourceMu > strongestMu) {
+            strongestMu = sourceMu;
+            strongest = static_cast<int32_t>(s);
+        }
+    }
+    if (mu > 0.0f) {
+        cx /= mu; cy /= mu; cz /= mu;
+    } else {
+        cx = (minX + maxX) * 0.5f; cy = (minY + maxY) * 0.5f; cz = (minZ + maxZ) * 0.5f;
+    }
+
+    float influenceExtent = 0.0f;
+    for (uint32_t k = begin; k < end; k++) {
+        const uint32_t s = m_Indices[k];
+        const float dx = sources.x[s] - cx, dy = sources.y[s] - cy, dz = sources.z[s] - cz;
+        influenceExtent = (std::max)(influenceExtent, std::sqrt(dx * dx + dy * dy + dz * dz) + sources.influenceRadius[s]);
+    }
+
+    const float size = (std::max)(maxX - minX, (std::max)(maxY - minY, maxZ - minZ));
+    {
+        Node& node = m_Nodes[nodeIndex];
+        node.cx = cx; node.cy = cy; node.cz = cz;
+        node.mu = mu;
+        node.size = size;
+        node.influenceExtent = influenceExtent;
+        node.strongestSource = strongest;
+        node.firstIndex = begin;
+        node.indexCount = end - begin;
+    }
+
+    if (end - begin <= m_LeafSize || depth >= kMaxOctreeDepth || size < kMinNodeSize) {
+        return nodeIndex;
+    }
+
+    // 按包围盒中心分到 8 个卦限（计数排序，保持 m_Indices 连续）
+    const float midX = (minX + maxX) * 0.5f, midY = (minY + maxY) * 0.5f, midZ = (minZ + maxZ) * 0.5f;
+    auto octantOf = [&](uint32_t s) {
+        return (sources.x[s] >= midX ? 1u : 0u) | (sources.y[s] >= midY ? 2u : 0u) | (sources.z[s] >= midZ ? 4u : 0u);
+    };
+
+    uint32_t octantCount[8] = {};
+    for (uint32_t k = begin; k < end; k++) octantCount[octantOf(m_Indices[k])]++;
+
+    uint32_t octantStart[9] = {};
+    for (uint32_t o = 0; o < 8; o++) octantStart[o + 1] = octantStart[o] + octantCount[o];
+
+    FrameVector<uint32_t> sorted(end - begin);     // 每帧重建：临时数组走帧内 arena
+    uint32_t cursor[8];
+    for (uint32_t o = 0; o < 8; o++) cursor[o] = octantStart[o];
+    for (uint32_t k = begin; k < end; k++) {
+        const uint32_t s = m_Indices[k];
+        sorted[cursor[octantOf(s)]++] = s;
+    }
+    std::copy(sorted.begin(), sorted.end(), m_Indices.begin() + begin);
+
+    uint32_t children[8];
+    uint32_t childCount = 0;
+    for (uint32_t o = 0; o < 8; o++) {
+        if (octantCount[o] == 0) continue;
+        children[childCount++] = BuildNode(sources, begin + octantStart[o], begin + octantStart[o + 1], depth + 1);
+    }
+
+    Node& node = m_Nodes[nodeIndex];   // 递归可能让 m_Nodes 重新分配，最后再写回
+    std::copy(children, children + childCount, node.children);
+    node.childCount = childCount;
+    return nodeIndex;
+}
+
+void GravityOctree::Evaluate(GravityBatchSoA& batch, const GravitySourceSoA& sources, float theta,
+                             uint32_t begin, uint32_t end) const {
+    const float thetaSq = theta * theta;
+    uint32_t stack[8 * kMaxOctreeDepth + 8];
+
+    for (uint32_t i = begin; i < end; i++) {
+        const float px = batch.x[i], py = batch.y[i], pz = batch.z[i];
+        float ax = 0.0f, ay = 0.0f, az = 0.0f;
+        float bestStrength = 0.0f;
+        int32_t bestIndex = -1;
+
+        auto accumulate = [&](float dx, float dy, float dz, float dist, float strength, int32_t source) {
+            const float scale = -strength / dist;
+            ax += dx * scale; ay += dy * scale; az += dz * scale;
+            if (strength > bestStrength) {
+                bestStrength = strength;
+                bestIndex = source;
+            }
+        };
+
+        uint32_t top = 0;
+        if (!m_Nodes.empty()) stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = m_Nodes[stack[--top]];
+            const float dx = px - node.cx, dy = py - node.cy, dz = pz - node.cz;
+            const float distSq = dx * dx + dy * dy + dz * dz;
+
+            // 节点内没有任何源的影响范围覆盖到这里：整棵子树贡献为 0
+            if (distSq > node.influenceExtent * node.influenceExtent) continue;
+
+            if (node.childCount == 0) {
+                for (uint32_t k = node.firstIndex; k < node.firstIndex + node.indexCount; k++) {
+                    const uint32_t s = m_Indices[k];
+                    const float sx = px - sources.x[s], sy = py - sources.y[s], sz = pz - sources.z[s];
+                    const float dist = std::sqrt(sx * sx + sy * sy + sz * sz);
+                    if (dist <= kMinDirectionDistance) continue;
+                    const float strength = GravityStrength(dist, sources.radius[s], sources.influenceRadius[s],
+                                                           sources.surfaceGravity[s], sources.realistic[s] > 0.5f);
+                    if (strength > 0.0f) accumulate(sx, sy, sz, dist, strength, static_cast<int32_t>(s));
+                }
+                continue;
+            }
+
+            // 开角判据：size / d < theta，合并为一个 μ/d² 点源
+            if (node.size * node.size < thetaSq * distSq) {
+                const float dist = std::sqrt(distSq);
+                accumulate(dx, dy, dz, dist, node.mu / distSq, node.strongestSource);
+                continue;
+            }
+
+            for (uint32_t c = 0; c < node.childCount; c++) {
+                stack[top++] = node.children[c];
+            }
+        }
+
+        const float magnitude = std::sqrt(ax * ax + ay * ay + az * az);
+        const float scale = magnitude > 1e-6f ? 1.0f / magnitude : 0.0f;
+        batch.dirX[i] = ax * scale;
+        batch.dirY[i] = ay * scale;
+        batch.dirZ[i] = az * scale;
+        batch.strength[i] = magnitude;
+        batch.distance[i] = magnitude;
+        batch.sourceIndex[i] = bestIndex;
+    }
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,127 @@
+/**
+ * GravityKernel.h
+ *
+ * 批量重力计算内核（SoA 输入，DirectXMath SIMD 每次处理 4 个实体）
+ *
+ * SectorPhysicsSystem::CalculateGravity 先把实体/重力源收集到连续数组，
+ * 调用这里的内核，再把结果写回 GravityAffectedComponent。
+ * 强度公式与 GravitySourceComponent::CalculateGravityStrength 一致。
+ */
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 重力源参数（SoA）；只收集 isActive 的源
+ */
+struct GravitySourceSoA {
+    std::vector<float> x, y, z;
+    std::vector<float> radius;
+    std::vector<float> influenceRadius;
+    std::vector<float> surfaceGravity;
+    std::vector<float> realistic;       // 1 = useRealisticGravity
+
+    void Clear();
+    void Push(float px, float py, float pz, float r, float influence, float g, bool useRealistic);
+    uint32_t Size() const { return static_cast<uint32_t>(x.size()); }
+};
+
+/**
+ * @brief 批量计算的实体输入/输出（SoA），长度按 4 的倍数补齐
+ *
+ * 扇区内的实体：位置是扇区局部坐标，重力指向原点，源参数是所在扇区的（sourceIndex 无意义）
+ * 扇区外的实体：位置是世界坐标，内核在 GravitySourceSoA 中找影响范围内最近的源
+ */
+struct GravityBatchSoA {
+    // 输入
+    std::vector<float> x, y, z;
+    std::vector<float> radius, influenceRadius, surfaceGravity, realistic;   // 仅扇区内批次使用
+
+    // 输出
+    std::vector<float> dirX, dirY, dirZ;
+    std::vector<float> strength;
+    std::vector<float> distance;
+    std::vector<int32_t> sourceIndex;   // 最近源下标，-1 = 范围内没有源（仅扇区外批次）
+
+    void Clear();
+    void Push(float px, float py, float pz);
+    void PushWithSource(float px, float py, float pz, float r, float influence, float g, bool useRealistic);
+    uint32_t Size() const { return m_Count; }
+
+    /**
+     * @brief 补齐到 4 的倍数并分配输出数组（内核调用前由调用方执行）
+     */
+    void Finalize();
+
+private:
+    uint32_t m_Count = 0;
+};
+
+/**
+ * @brief 扇区内批次：指向原点的重力
+ *
+ * distance <= 0.01 时 dir 输出为 0（调用方保留原方向）
+ */
+void EvaluateSectorGravity(GravityBatchSoA& batch);
+
+/**
+ * @brief 扇区外批次：影响范围内最近的重力源
+ *
+ * 范围内没有源时 sourceIndex = -1，dir/strength 无效
+ */
+void EvaluateNearestSourceGravity(GravityBatchSoA& batch, const GravitySourceSoA& sources);
+
+/**
+ * @brief 叠加模式（精确）：所有源的贡献按向量相加，4 路 SIMD
+ *
+ * 输出 dir = 合加速度方向，strength = 合加速度大小，sourceIndex = 贡献最大的源（-1 = 没有贡献）。
+ * 单个源的强度模型与 CalculateGravityStrength 相同。
+ */
+void EvaluateSummedGravity(GravityBatchSoA& batch, const GravitySourceSoA& sources);
+
+/**
+ * @brief 重力源八叉树（Barnes–Hut）
+ *
+ * 节点保存等效质量 μ = g·r²（真实衰减模式下 g·(r/d)² = μ/d²，因此远处的节点可以合并为一个点源）
+ * 和节点内所有源影响范围的包围半径：实体在包围半径之外时整棵子树贡献为 0（精确剪枝）。
+ * 简化衰减模式的源在被合并时也按 μ/d² 近似。
+ */
+class GravityOctree {
+public:
+    void Build(const GravitySourceSoA& sources, uint32_t leafSize = 4);
+
+    /**
+     * @brief 计算 batch 中 [begin, end) 的实体（输出同 EvaluateSummedGravity）
+     *
+     * size / distance < theta 的节点按单个点源计算；theta = 0 退化为精确求和。
+     * 不同区间可以在多个线程上同时计算。
+     */
+    void Evaluate(GravityBatchSoA& batch, const GravitySourceSoA& sources, float theta,
+                  uint32_t begin, uint32_t end) const;
+
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_Nodes.size()); }
+
+private:
+    struct Node {
+        float cx = 0.0f, cy = 0.0f, cz = 0.0f;   // μ 加权中心
+        float mu = 0.0f;
+        float size = 0.0f;                        // AABB 最大边长
+        float influenceExtent = 0.0f;             // 从中心起，节点内任一源影响范围的最远距离
+        int32_t strongestSource = -1;             // μ 最大的源
+        uint32_t children[8] = {};
+        uint32_t childCount = 0;                  // 0 = 叶子
+        uint32_t firstIndex = 0;                  // 叶子：m_Indices 中的源区间
+        uint32_t indexCount = 0;
+    };
+
+    uint32_t BuildNode(const GravitySourceSoA& sources, uint32_t begin, uint32_t end, uint32_t depth);
+
+    std::vector<Node> m_Nodes;
+    std::vector<uint32_t> m_Indices;
+    uint32_t m_LeafSize = 4;
+};
+
+} // namespace outer_wilds
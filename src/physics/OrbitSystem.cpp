@@ -5,10 +5,12 @@
  */
 
 #include "OrbitSystem.h"
+#include "FloatingOrigin.h"
 #include "components/OrbitComponent.h"
 #include "components/SectorComponent.h"
 #include "../scene/components/TransformComponent.h"
 #include "../core/DebugManager.h"
+#include <algorithm>
 #include <cmath>
 
 namespace outer_wilds {
@@ -25,88 +27,292 @@ void OrbitSystem::Initialize(std::shared_ptr<Scene> scene) {
 }
 
 void OrbitSystem::Update(float deltaTime, entt::registry& registry) {
-    UpdateOrbits(deltaTime, registry);
-    UpdateRotations(deltaTime, registry);
+    m_SimulationTime += deltaTime;
+    EvaluateOrbits(registry);
+    UpdateRotations(registry);
+}
+
+void OrbitSystem::EvaluateOrbits(entt::registry& registry) {
+    if (!IsEvaluationOrderValid(registry)) {
+        RebuildEvaluationOrder(registry);
+    }
+    UpdateOrbits(registry);
 }
 
 void OrbitSystem::Shutdown() {
     DebugManager::GetInstance().Log("OrbitSystem", "Shutdown");
 }
 
-void OrbitSystem::UpdateOrbits(float deltaTime, entt::registry& registry) {
-    auto view = registry.view<OrbitComponent>();
+namespace {
+    struct Double3 {
+        double x, y, z;
+    };
+
+    double Dot(const Double3& a, const Double3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    Double3 Cross(const Double3& a, const Double3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    // 开普勒方程 E - e·sinE = M（牛顿迭代，e < 1）
+    double SolveEccentricAnomaly(double meanAnomaly, double e) {
+        double E = (e < 0.8) ? meanAnomaly : DirectX::XM_PI;
+        for (int i = 0; i < 16; i++) {
+            const double f = E - e * std::sin(E) - meanAnomaly;
+            const double step = f / (1.0 - e * std::cos(E));
+            E -= step;
+            if (std::abs(step) < 1e-12) break;
+        }
+        return E;
+    }
+
+    // 轨道平面 → 世界：近心点幅角（绕 Y）→ 倾角（绕 X）→ 把 Y 轴转到 orbitNormal
+    struct OrbitFrame {
+        double cosW, sinW;
+        double cosI, sinI;
+        bool rotateNormal;
+        Double3 axis;
+        double cosN, sinN;
+
+        explicit OrbitFrame(const OrbitComponent& orbit) {
+            cosW = std::cos(static_cast<double>(orbit.argumentOfPeriapsis));
+            sinW = std::sin(static_cast<double>(orbit.argumentOfPeriapsis));
+            cosI = std::cos(static_cast<double>(orbit.orbitInclination));
+            sinI = std::sin(static_cast<double>(orbit.orbitInclination));
+
+            Double3 n = { orbit.orbitNormal.x, orbit.orbitNormal.y, orbit.orbitNormal.z };
+            const double len = std::sqrt(Dot(n, n));
+            if (len > 0.0) n = { n.x / len, n.y / len, n.z / len };
+            cosN = std::clamp(n.y, -1.0, 1.0);   // dot(Y, n)
+            rotateNormal = len > 0.0 && std::abs(cosN) < 0.999;
+            axis = { 0.0, 0.0, 0.0 };
+            sinN = 0.0;
+            if (rotateNormal) {
+                axis = Cross({ 0.0, 1.0, 0.0 }, n);
+                const double axisLen = std::sqrt(Dot(axis, axis));
+                axis = { axis.x / axisLen, axis.y / axisLen, axis.z / axisLen };
+                sinN = std::sqrt(1.0 - cosN * cosN);
+            }
+        }
+
+        // (x, z) 是轨道平面（XZ）内的向量
+        Double3 Apply(double x, double z) const {
+            const double px = x * cosW - z * sinW;
+            const double pz = x * sinW + z * cosW;
+            Double3 v = { px, pz * sinI, pz * cosI };
+            if (rotateNormal) {
+                // Rodrigues 旋转
+                const Double3 kxv = Cross(axis, v);
+                const double kdv = Dot(axis, v);
+                v = { v.x * cosN + kxv.x * sinN + axis.x * kdv * (1.0 - cosN),
+                      v.y * cosN + kxv.y * sinN + axis.y * kdv * (1.0 - cosN),
+                      v.z * cosN + kxv.z * sinN + axis.z * kdv * (1.0 - cosN) };
+            }
+            return v;
+        }
+    };
+}
+
+void OrbitSystem::EvaluateKepler(const OrbitComponent& orbit, double time,
+                                 WorldPosition& offset, DirectX::XMFLOAT3& velocity) {
+    if (!orbit.orbitEnabled || orbit.orbitPeriod <= 0.0f) {
+        offset = WorldPosition();
+        velocity = { 0.0f, 0.0f, 0.0f };
+        return;
+    }
     
-    for (auto entity : view) {
-        auto& orbit = view.get<OrbitComponent>(entity);
-        
-        if (!orbit.orbitEnabled) continue;
-        if (orbit.orbitPeriod <= 0.0f) continue;
-        
-        // 更新轨道角度
-        float angularVelocity = orbit.GetOrbitalAngularVelocity();
-        orbit.orbitAngle += angularVelocity * deltaTime;
+    // 开普勒轨道：M = M0 + n·t，解出偏近点角 E
+    //   平面内位置 (a(cosE - e), b·sinE)，速度 = dE/dt · (-a·sinE, b·cosE)，dE/dt = n / (1 - e·cosE)
+    const double a = orbit.orbitRadius;
+    const double e = std::clamp(static_cast<double>(orbit.eccentricity), 0.0, 0.99);
+    const double b = a * std::sqrt(1.0 - e * e);
+    const double n = DirectX::XM_2PI / static_cast<double>(orbit.orbitPeriod);
+    const double meanAnomaly = std::fmod(orbit.orbitAngle + n * time, 2.0 * DirectX::XM_PI);
+    const double E = SolveEccentricAnomaly(meanAnomaly, e);
+    const double cosE = std::cos(E);
+    const double sinE = std::sin(E);
+    const double dE = n / (1.0 - e * cosE);
+    
+    const OrbitFrame frame(orbit);
+    const Double3 p = frame.Apply(a * (cosE - e), b * sinE);
+    const Double3 v = frame.Apply(-a * sinE * dE, b * cosE * dE);
+    offset = WorldPosition(p.x, p.y, p.z);
+    velocity = { static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z) };
+}
+
+DirectX::XMFLOAT4 OrbitSystem::EvaluateSpin(const OrbitComponent& orbit, double time) {
+    DirectX::XMFLOAT4 rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    if (!orbit.rotationEnabled || orbit.rotationPeriod <= 0.0f) return rotation;
+    
+    // 自转角度同样是模拟时间的函数（双精度取模后再转单精度）
+    const double omega = DirectX::XM_2PI / static_cast<double>(orbit.rotationPeriod);
+    const float angle = static_cast<float>(std::fmod(orbit.rotationAngle + omega * time, 2.0 * DirectX::XM_PI));
+    
+    DirectX::XMVECTOR axis = DirectX::XMLoadFloat3(&orbit.rotationAxis);
+    axis = DirectX::XMVector3Normalize(axis);
+    DirectX::XMStoreFloat4(&rotation, DirectX::XMQuaternionRotationAxis(axis, angle));
+    return rotation;
+}
+
+void OrbitSystem::CaptureSnapshot(entt::registry& registry, OrbitSnapshot& snapshot) const {
+    snapshot.bodies.clear();
+    snapshot.time = m_SimulationTime;
+    for (const auto& entry : m_EvaluationOrder) {
+        if (!registry.valid(entry.entity)) continue;
+        const auto* orbit = registry.try_get<OrbitComponent>(entry.entity);
+        if (!orbit) continue;
         
-        // 保持角度在 [0, 2π) 范围
-        while (orbit.orbitAngle >= DirectX::XM_2PI) {
-            orbit.orbitAngle -= DirectX::XM_2PI;
+        OrbitSnapshot::Body body;
+        body.entity = entry.entity;
+        body.orbit = *orbit;
+        body.parent = snapshot.Find(orbit->orbitParent);   // 父天体在前，已经加入
+        if (body.parent < 0 && orbit->orbitParent != entt::null && registry.valid(orbit->orbitParent)) {
+            // 父实体没有轨道：以它当前的位置为固定中心
+            if (const auto* parentSector = registry.try_get<SectorComponent>(orbit->orbitParent)) {
+                body.orbit.orbitCenter = parentSector->absolutePosition;
+            }
         }
-        while (orbit.orbitAngle < 0.0f) {
-            orbit.orbitAngle += DirectX::XM_2PI;
+        if (!orbit->orbitEnabled || orbit->orbitPeriod <= 0.0f) {
+            body.orbit.orbitCenter = orbit->absolutePosition;   // 不公转：固定在当前位置
+            body.parent = -1;
         }
-        
-        // 获取轨道中心（如果有父实体，使用父实体位置）
-        DirectX::XMFLOAT3 center = orbit.orbitCenter;
-        if (orbit.orbitParent != entt::null && registry.valid(orbit.orbitParent)) {
-            auto* parentTransform = registry.try_get<TransformComponent>(orbit.orbitParent);
-            if (parentTransform) {
-                center = parentTransform->position;
+        snapshot.bodies.push_back(body);
+    }
+}
+
+int32_t OrbitSnapshot::Find(entt::entity entity) const {
+    if (entity == entt::null) return -1;
+    for (size_t i = 0; i < bodies.size(); i++) {
+        if (bodies[i].entity == entity) return static_cast<int32_t>(i);
+    }
+    return -1;
+}
+
+void OrbitSnapshot::Evaluate(double atTime, std::vector<WorldPosition>& positions,
+                             std::vector<DirectX::XMFLOAT3>& velocities,
+                             std::vector<DirectX::XMFLOAT4>& rotations) const {
+    positions.resize(bodies.size());
+    velocities.resize(bodies.size());
+    rotations.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); i++) {
+        const Body& body = bodies[i];
+        WorldPosition offset;
+        DirectX::XMFLOAT3 velocity;
+        OrbitSystem::EvaluateKepler(body.orbit, atTime, offset, velocity);
+        if (body.parent >= 0) {
+            positions[i] = positions[body.parent] + offset;
+            const DirectX::XMFLOAT3& parentVelocity = velocities[body.parent];
+            velocities[i] = { parentVelocity.x + velocity.x, parentVelocity.y + velocity.y,
+                              parentVelocity.z + velocity.z };
+        } else {
+            positions[i] = body.orbit.orbitCenter + offset;
+            velocities[i] = velocity;
+        }
+        rotations[i] = OrbitSystem::EvaluateSpin(body.orbit, atTime);
+    }
+}
+
+bool OrbitSystem::IsEvaluationOrderValid(entt::registry& registry) const {
+    if (registry.view<OrbitComponent>().size() != m_EvaluationOrder.size()) return false;
+    for (const auto& entry : m_EvaluationOrder) {
+        if (!registry.valid(entry.entity)) return false;
+        const auto* orbit = registry.try_get<OrbitComponent>(entry.entity);
+        if (!orbit || orbit->orbitParent != entry.parent) return false;
+    }
+    return true;
+}
+
+void OrbitSystem::RebuildEvaluationOrder(entt::registry& registry) {
+    // 深度 = orbitParent 链上同样有 OrbitComponent 的祖先数；父的深度总是更小
+    std::vector<std::pair<uint32_t, OrderEntry>> sorted;
+    auto view = registry.view<OrbitComponent>();
+    for (auto entity : view) {
+        const auto& orbit = view.get<OrbitComponent>(entity);
+        uint32_t depth = 0;
+        entt::entity ancestor = orbit.orbitParent;
+        while (ancestor != entt::null && registry.valid(ancestor)) {
+            const auto* ancestorOrbit = registry.try_get<OrbitComponent>(ancestor);
+            if (!ancestorOrbit) break;
+            if (++depth > view.size()) {
+                DebugManager::GetInstance().Log("OrbitSystem", "Cycle in orbitParent hierarchy");
+                break;
             }
+            ancestor = ancestorOrbit->orbitParent;
         }
+        sorted.push_back({ depth, { entity, orbit.orbitParent } });
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    m_EvaluationOrder.clear();
+    m_EvaluationOrder.reserve(sorted.size());
+    for (const auto& item : sorted) {
+        m_EvaluationOrder.push_back(item.second);
+    }
+}
+
+void OrbitSystem::UpdateOrbits(entt::registry& registry) {
+    const auto& origin = FloatingOrigin::GetInstance();
+    
+    for (const auto& entry : m_EvaluationOrder) {
+        auto& orbit = registry.get<OrbitComponent>(entry.entity);
+        auto* sector = registry.try_get<SectorComponent>(entry.entity);
+        auto* transform = registry.try_get<TransformComponent>(entry.entity);
         
-        // 计算新的轨道位置
-        DirectX::XMFLOAT3 newPosition = CalculateOrbitPosition(
-            center,
-            orbit.orbitRadius,
-            orbit.orbitAngle,
-            orbit.orbitNormal,
-            orbit.orbitInclination
-        );
+        // 不公转的天体（太阳）保持原位，只记录位置供子天体使用
+        if (!orbit.orbitEnabled || orbit.orbitPeriod <= 0.0f) {
+            if (sector) {
+                orbit.absolutePosition = sector->absolutePosition;
+                orbit.worldVelocity = sector->worldVelocity;
+            } else if (transform) {
+                orbit.absolutePosition = origin.ToAbsolute(transform->position);
+                orbit.worldVelocity = { 0.0f, 0.0f, 0.0f };
+            }
+            continue;
+        }
         
-        // 计算轨道速度（切向速度 = 角速度 × 轨道半径）
-        // 速度方向垂直于位置向量，在轨道平面内
-        DirectX::XMFLOAT3 orbitVelocity = { 0.0f, 0.0f, 0.0f };
-        if (orbit.orbitEnabled && orbit.orbitPeriod > 0.0f) {
-            // 轨道线速度大小 = 2πr / T = 角速度 × 半径
-            float linearSpeed = angularVelocity * orbit.orbitRadius;
-            // 速度方向：垂直于径向，在轨道平面内
-            // 径向 = (pos - center) 的归一化
-            float dx = newPosition.x - center.x;
-            float dz = newPosition.z - center.z;
-            float r = std::sqrt(dx*dx + dz*dz);
-            if (r > 0.001f) {
-                // 切向 = 垂直于径向，逆时针方向（默认轨道方向）
-                orbitVelocity.x = -dz / r * linearSpeed;
-                orbitVelocity.y = 0.0f;  // 假设水平轨道
-                orbitVelocity.z = dx / r * linearSpeed;
+        // 获取轨道中心（如果有父实体，使用父实体位置）——双精度世界坐标
+        // 父天体按顺序已在本帧求值，不会落后一帧
+        WorldPosition center = orbit.orbitCenter;
+        DirectX::XMFLOAT3 centerVelocity = { 0.0f, 0.0f, 0.0f };
+        if (orbit.orbitParent != entt::null && registry.valid(orbit.orbitParent)) {
+            if (auto* parentOrbit = registry.try_get<OrbitComponent>(orbit.orbitParent)) {
+                center = parentOrbit->absolutePosition;
+                centerVelocity = parentOrbit->worldVelocity;
+            } else if (auto* parentSector = registry.try_get<SectorComponent>(orbit.orbitParent)) {
+                center = parentSector->absolutePosition;
+                centerVelocity = parentSector->worldVelocity;
+            } else if (auto* parentTransform = registry.try_get<TransformComponent>(orbit.orbitParent)) {
+                center = origin.ToAbsolute(parentTransform->position);
             }
         }
         
+        WorldPosition offset;
+        DirectX::XMFLOAT3 velocity;
+        EvaluateKepler(orbit, m_SimulationTime, offset, velocity);
+        
+        orbit.absolutePosition = center + offset;
+        orbit.worldVelocity = {
+            centerVelocity.x + velocity.x,
+            centerVelocity.y + velocity.y,
+            centerVelocity.z + velocity.z
+        };
+        const DirectX::XMFLOAT3 newPosition = origin.ToRelative(orbit.absolutePosition);
+        
         // 更新 SectorComponent（如果存在）
-        auto* sector = registry.try_get<SectorComponent>(entity);
         if (sector) {
+            sector->absolutePosition = orbit.absolutePosition;
             sector->worldPosition = newPosition;
-            sector->worldVelocity = orbitVelocity;  // 更新扇区速度
+            sector->worldVelocity = orbit.worldVelocity;  // 更新扇区速度
         }
         
         // 更新 TransformComponent（如果存在）
-        auto* transform = registry.try_get<TransformComponent>(entity);
         if (transform) {
             transform->position = newPosition;
         }
     }
 }
 
-void OrbitSystem::UpdateRotations(float deltaTime, entt::registry& registry) {
+void OrbitSystem::UpdateRotations(entt::registry& registry) {
     auto view = registry.view<OrbitComponent>();
     
     for (auto entity : view) {
@@ -115,93 +321,20 @@ void OrbitSystem::UpdateRotations(float deltaTime, entt::registry& registry) {
         if (!orbit.rotationEnabled) continue;
         if (orbit.rotationPeriod <= 0.0f) continue;
         
-        // 更新自转角度
-        float angularVelocity = orbit.GetRotationAngularVelocity();
-        orbit.rotationAngle += angularVelocity * deltaTime;
-        
-        // 保持角度在 [0, 2π) 范围
-        while (orbit.rotationAngle >= DirectX::XM_2PI) {
-            orbit.rotationAngle -= DirectX::XM_2PI;
-        }
+        const DirectX::XMFLOAT4 rotation = EvaluateSpin(orbit, m_SimulationTime);
         
         // 更新 SectorComponent 的旋转（如果存在）
         auto* sector = registry.try_get<SectorComponent>(entity);
         if (sector) {
-            // 围绕自转轴旋转
-            DirectX::XMVECTOR axis = DirectX::XMLoadFloat3(&orbit.rotationAxis);
-            axis = DirectX::XMVector3Normalize(axis);
-            DirectX::XMVECTOR rotQuat = DirectX::XMQuaternionRotationAxis(axis, orbit.rotationAngle);
-            DirectX::XMStoreFloat4(&sector->worldRotation, rotQuat);
+            sector->worldRotation = rotation;
         }
         
         // 更新 TransformComponent（如果存在）
         auto* transform = registry.try_get<TransformComponent>(entity);
         if (transform) {
-            DirectX::XMVECTOR axis = DirectX::XMLoadFloat3(&orbit.rotationAxis);
-            axis = DirectX::XMVector3Normalize(axis);
-            DirectX::XMVECTOR rotQuat = DirectX::XMQuaternionRotationAxis(axis, orbit.rotationAngle);
-            DirectX::XMStoreFloat4(&transform->rotation, rotQuat);
+            transform->rotation = rotation;
         }
     }
 }
 
-DirectX::XMFLOAT3 OrbitSystem::CalculateOrbitPosition(
-    const DirectX::XMFLOAT3& center,
-    float radius,
-    float angle,
-    const DirectX::XMFLOAT3& normal,
-    float inclination
-) {
-    // 基本圆形轨道（在XZ平面上）
-    float x = radius * std::cos(angle);
-    float z = radius * std::sin(angle);
-    float y = 0.0f;
-    
-    // 如果有倾角，应用倾斜
-    if (std::abs(inclination) > 0.001f) {
-        // 先在XZ平面计算，然后绕X轴旋转倾角
-        float cosInc = std::cos(inclination);
-        float sinInc = std::sin(inclination);
-        float newY = z * sinInc;
-        float newZ = z * cosInc;
-        y = newY;
-        z = newZ;
-    }
-    
-    // 如果轨道平面法线不是Y轴，需要旋转整个轨道平面
-    DirectX::XMFLOAT3 defaultUp = { 0.0f, 1.0f, 0.0f };
-    DirectX::XMVECTOR defaultUpVec = DirectX::XMLoadFloat3(&defaultUp);
-    DirectX::XMVECTOR normalVec = DirectX::XMLoadFloat3(&normal);
-    normalVec = DirectX::XMVector3Normalize(normalVec);
-    
-    // 检查是否需要旋转（法线不是Y轴）
-    DirectX::XMVECTOR dot = DirectX::XMVector3Dot(defaultUpVec, normalVec);
-    float dotValue;
-    DirectX::XMStoreFloat(&dotValue, dot);
-    
-    if (std::abs(dotValue) < 0.999f) {
-        // 计算从Y轴到目标法线的旋转四元数
-        DirectX::XMVECTOR rotAxis = DirectX::XMVector3Cross(defaultUpVec, normalVec);
-        rotAxis = DirectX::XMVector3Normalize(rotAxis);
-        float rotAngle = std::acos(std::clamp(dotValue, -1.0f, 1.0f));
-        DirectX::XMVECTOR rotQuat = DirectX::XMQuaternionRotationAxis(rotAxis, rotAngle);
-        
-        // 旋转轨道位置
-        DirectX::XMFLOAT3 pos = { x, y, z };
-        DirectX::XMVECTOR posVec = DirectX::XMLoadFloat3(&pos);
-        posVec = DirectX::XMVector3Rotate(posVec, rotQuat);
-        DirectX::XMStoreFloat3(&pos, posVec);
-        x = pos.x;
-        y = pos.y;
-        z = pos.z;
-    }
-    
-    // 加上轨道中心
-    return {
-        center.x + x,
-        center.y + y,
-        center.z + z
-    };
-}
-
 } // namespace outer_wilds
@@ -4,19 +4,43 @@
  * 轨道系统 - 计算天体的公转和自转
  * 
  * 职责：
- * - 更新每个有 OrbitComponent 的实体的轨道位置
- * - 更新 SectorComponent.worldPosition（扇区世界坐标）
+ * - 按模拟时间解析求出每个有 OrbitComponent 的实体的开普勒轨道位置/速度
+ *   （父天体先于子天体求值，顺序缓存到层级变化为止）
+ * - 更新 SectorComponent.absolutePosition（双精度）和 worldPosition（相对浮动原点）
  * - 更新 TransformComponent（渲染坐标）
  */
 
 #pragma once
 #include "../core/ECS.h"
 #include "../scene/Scene.h"
+#include "components/OrbitComponent.h"
 #include <DirectXMath.h>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace outer_wilds {
 
+/**
+ * @brief 轨道层级的只读拷贝，可在任意线程上求任意时刻的天体位置（轨迹预测等）
+ */
+struct OrbitSnapshot {
+    struct Body {
+        entt::entity entity = entt::null;
+        int32_t parent = -1;                 // bodies 中的下标；-1 = 以 orbit.orbitCenter 为中心
+        components::OrbitComponent orbit;    // 不公转的天体 orbitCenter = 拍摄时的位置
+    };
+    std::vector<Body> bodies;                // 父天体在前
+    double time = 0.0;                       // 拍摄时的模拟时间
+
+    int32_t Find(entt::entity entity) const;
+
+    /** @brief 求 atTime 时每个天体的世界位置/速度/自转（下标与 bodies 相同） */
+    void Evaluate(double atTime, std::vector<WorldPosition>& positions,
+                  std::vector<DirectX::XMFLOAT3>& velocities,
+                  std::vector<DirectX::XMFLOAT4>& rotations) const;
+};
+
 class OrbitSystem : public System {
 public:
     OrbitSystem() = default;
@@ -27,22 +51,41 @@ public:
     void Update(float deltaTime, entt::registry& registry) override;
     void Shutdown() override;
 
+    /** @brief 模拟时间（秒）。轨道位置是它的纯函数，可以任意设置（时间加速/跳转） */
+    double GetSimulationTime() const { return m_SimulationTime; }
+    void SetSimulationTime(double time) { m_SimulationTime = time; }
+
+    /** @brief 按求值顺序拷贝所有轨道（主线程调用） */
+    void CaptureSnapshot(entt::registry& registry, OrbitSnapshot& snapshot) const;
+
+    /** @brief 相对轨道中心的开普勒位置/速度（纯函数，线程安全） */
+    static void EvaluateKepler(const components::OrbitComponent& orbit, double time,
+                               WorldPosition& offset, DirectX::XMFLOAT3& velocity);
+    static DirectX::XMFLOAT4 EvaluateSpin(const components::OrbitComponent& orbit, double time);
+
+    /** @brief 按当前模拟时间求值全部轨道位置（层级变化时重建求值顺序；不推进时间、不算自转） */
+    void EvaluateOrbits(entt::registry& registry);
+
 private:
-    // 计算轨道位置
-    void UpdateOrbits(float deltaTime, entt::registry& registry);
+
+    struct OrderEntry {
+        entt::entity entity;
+        entt::entity parent;   // 构建顺序时的 orbitParent，用于检测层级变化
+    };
+
+    // 计算轨道位置（按 m_EvaluationOrder，父天体在前）
+    void UpdateOrbits(entt::registry& registry);
     
     // 计算自转
-    void UpdateRotations(float deltaTime, entt::registry& registry);
+    void UpdateRotations(entt::registry& registry);
     
-    // 计算轨道上的位置
-    DirectX::XMFLOAT3 CalculateOrbitPosition(
-        const DirectX::XMFLOAT3& center,
-        float radius,
-        float angle,
-        const DirectX::XMFLOAT3& normal,
-        float inclination
-    );
+    // 拓扑排序：按 orbitParent 链的深度排序
+    void RebuildEvaluationOrder(entt::registry& registry);
+    bool IsEvaluationOrderValid(entt::registry& registry) const;
 
+    double m_SimulationTime = 0.0;
+    std::vector<OrderEntry> m_EvaluationOrder;
+    
     std::shared_ptr<Scene> m_Scene;
 };
 
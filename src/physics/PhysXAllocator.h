@@ -0,0 +1,60 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <cstdint>
+#include <cstdlib>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#include "../core/MemoryTracker.h"
+
+namespace outer_wilds {
+
+/**
+ * @brief 记账的 PxAllocatorCallback（取代 PxDefaultAllocator）
+ *
+ * PhysX 要求返回 16 字节对齐的内存；每次分配前放一个 16 字节头记录大小，
+ * 释放时从 MemoryCategory::Physics 中扣除。PhysX 的分配不经过 operator new，
+ * 因此不受 OW_MEMORY_TRACKING 影响，始终计数。
+ */
+class PhysXAllocator : public physx::PxAllocatorCallback {
+public:
+    void* allocate(size_t size, const char* typeName, const char* filename, int line) override {
+        (void)typeName;
+        (void)filename;
+        (void)line;
+        char* raw = static_cast<char*>(AlignedAlloc(size + kHeaderSize));
+        if (!raw) return nullptr;
+        *reinterpret_cast<uint64_t*>(raw) = size;
+        MemoryTracker::RecordAlloc(MemoryCategory::Physics, size);
+        return raw + kHeaderSize;
+    }
+
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+        char* raw = static_cast<char*>(ptr) - kHeaderSize;
+        MemoryTracker::RecordFree(MemoryCategory::Physics, static_cast<size_t>(*reinterpret_cast<uint64_t*>(raw)));
+        AlignedFree(raw);
+    }
+
+private:
+    static constexpr size_t kHeaderSize = 16;
+
+    static void* AlignedAlloc(size_t size) {
+#ifdef _WIN32
+        return _aligned_malloc(size, 16);
+#else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, 16, size) == 0 ? ptr : nullptr;
+#endif
+    }
+
+    static void AlignedFree(void* ptr) {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,33 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include "../core/JobSystem.h"
+
+namespace outer_wilds {
+
+/**
+ * @brief 把 PhysX 任务提交到引擎 JobSystem 的 PxCpuDispatcher
+ *
+ * 取代 PxDefaultCpuDispatcherCreate(2) 的独立线程池，物理任务与其他作业共享同一组工作线程。
+ * PhysX 在 fetchResults(true) 中阻塞等待自己的任务，因此这里的任务只能由工作线程执行，
+ * 要求 JobSystem 至少有一个工作线程。
+ */
+class PhysXJobDispatcher : public physx::PxCpuDispatcher {
+public:
+    explicit PhysXJobDispatcher(JobSystem& jobs) : m_Jobs(jobs) {}
+
+    void submitTask(physx::PxBaseTask& task) override {
+        m_Jobs.Run([&task]() {
+            task.run();
+            task.release();
+        });
+    }
+
+    uint32_t getWorkerCount() const override {
+        return m_Jobs.GetWorkerCount();
+    }
+
+private:
+    JobSystem& m_Jobs;
+};
+
+} // namespace outer_wilds
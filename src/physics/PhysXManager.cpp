@@ -5,16 +5,65 @@
  * 
  * 【重要】这是唯一可以调用 PhysX simulate/fetchResults 的地方
  * 任何系统要修改 PhysX Actor 状态，必须：
- *   1. 在 simulate() 之前完成
+ *   1. 在 simulate() 之前完成（流水线模式下 simulate 到下一帧开头的 fetchResults 之间禁止访问 PhysX）
  *   2. 在代码中声明 "// [来源: XXXSystem]"
  */
 
 #include "PhysXManager.h"
+#include "CollisionMeshCache.h"
+#include "PhysicsEvents.h"
 #include "../core/DebugManager.h"
+#include "../core/JobSystem.h"
 #include <iostream>
+#include <thread>
 
 namespace outer_wilds {
 
+namespace {
+    constexpr float kInitialBroadPhaseHalfExtent = 2048.0f;
+
+    /**
+     * @brief PxDefaultSimulationFilterShader + 按 filterData.word2（PhysicsReportFlags）请求接触上报
+     *
+     * 触发器对由默认着色器处理（总是上报进入 / 离开）
+     */
+    physx::PxFilterFlags ReportingSimulationFilterShader(
+        physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0,
+        physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1,
+        physx::PxPairFlags& pairFlags, const void* constantBlock, physx::PxU32 constantBlockSize) {
+        const physx::PxFilterFlags flags = physx::PxDefaultSimulationFilterShader(
+            attributes0, filterData0, attributes1, filterData1, pairFlags, constantBlock, constantBlockSize);
+        if (flags & (physx::PxFilterFlag::eKILL | physx::PxFilterFlag::eSUPPRESS)) return flags;
+        if (physx::PxFilterObjectIsTrigger(attributes0) || physx::PxFilterObjectIsTrigger(attributes1)) return flags;
+
+        const physx::PxU32 report = filterData0.word2 | filterData1.word2;
+        if (report & kReportContacts) {
+            pairFlags |= physx::PxPairFlag::eNOTIFY_TOUCH_FOUND | physx::PxPairFlag::eNOTIFY_TOUCH_LOST |
+                         physx::PxPairFlag::eNOTIFY_CONTACT_POINTS;
+        }
+        if (report & kReportImpacts) {
+            pairFlags |= physx::PxPairFlag::eNOTIFY_THRESHOLD_FORCE_FOUND | physx::PxPairFlag::eNOTIFY_CONTACT_POINTS;
+        }
+        return flags;
+    }
+
+    /**
+     * @brief ReportingSimulationFilterShader + CCD 接触（actor 没有 eENABLE_CCD 时 PhysX 忽略该标志）
+     */
+    physx::PxFilterFlags CCDSimulationFilterShader(
+        physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0,
+        physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1,
+        physx::PxPairFlags& pairFlags, const void* constantBlock, physx::PxU32 constantBlockSize) {
+        const physx::PxFilterFlags flags = ReportingSimulationFilterShader(
+            attributes0, filterData0, attributes1, filterData1, pairFlags, constantBlock, constantBlockSize);
+        if (!(flags & (physx::PxFilterFlag::eKILL | physx::PxFilterFlag::eSUPPRESS)) &&
+            !physx::PxFilterObjectIsTrigger(attributes0) && !physx::PxFilterObjectIsTrigger(attributes1)) {
+            pairFlags |= physx::PxPairFlag::eDETECT_CCD_CONTACT;
+        }
+        return flags;
+    }
+}
+
 bool PhysXManager::Initialize() {
     // Create foundation
     m_Foundation = PxCreateFoundation(PX_PHYSICS_VERSION, m_Allocator, m_ErrorCallback);
@@ -39,20 +88,45 @@ bool PhysXManager::Initialize() {
         return false;
     }
 
+    // PhysX 任务默认跑在引擎 JobSystem 的工作线程上；指定了线程数或作业系统不可用时使用独立线程池
+    JobSystem& jobs = JobSystem::GetInstance();
+    if (m_Settings.dispatcherThreads == 0 && jobs.IsInitialized() && jobs.GetWorkerCount() > 0) {
+        m_JobDispatcher = std::make_unique<PhysXJobDispatcher>(jobs);
+    } else {
+        uint32_t threads = m_Settings.dispatcherThreads;
+        if (threads == 0) {
+            const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            threads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+        m_Dispatcher = physx::PxDefaultCpuDispatcherCreate(threads);
+        DebugManager::GetInstance().Log("PhysXManager", "CPU dispatcher threads: " + std::to_string(threads));
+    }
+
+    // GPU 刚体：需要 CUDA 上下文，创建失败时退回 CPU
+    if (m_Settings.gpuRigidBodies) {
+#if PX_SUPPORT_GPU_PHYSX
+        physx::PxCudaContextManagerDesc cudaDesc;
+        m_CudaContextManager = PxCreateCudaContextManager(*m_Foundation, cudaDesc, PxGetProfilerCallback());
+        if (m_CudaContextManager && !m_CudaContextManager->contextIsValid()) {
+            m_CudaContextManager->release();
+            m_CudaContextManager = nullptr;
+        }
+#endif
+        DebugManager::GetInstance().Log("PhysXManager", m_CudaContextManager
+            ? "GPU rigid bodies enabled" : "GPU rigid bodies requested but no CUDA context, using CPU");
+    }
+
     // Create scene
-    physx::PxSceneDesc sceneDesc(m_Physics->getTolerancesScale());
-    sceneDesc.gravity = physx::PxVec3(0.0f, 0.0f, 0.0f);  // 全局重力由 GravitySystem 控制
-    
-    m_Dispatcher = physx::PxDefaultCpuDispatcherCreate(2);
-    sceneDesc.cpuDispatcher = m_Dispatcher;
-    sceneDesc.filterShader = physx::PxDefaultSimulationFilterShader;
-    
+    physx::PxSceneDesc sceneDesc = CreateSceneDesc();
     m_Scene = m_Physics->createScene(sceneDesc);
     if (!m_Scene) {
         std::cerr << "createScene failed!" << std::endl;
         return false;
     }
 
+    // MBP：扇区切换之前的初始区域（之后由 SectorPhysicsSystem 按激活扇区重设）
+    SetBroadPhaseRegions(m_Scene, kInitialBroadPhaseHalfExtent);
+
     // Create default material
     m_DefaultMaterial = m_Physics->createMaterial(0.5f, 0.5f, 0.6f);
 
@@ -67,20 +141,178 @@ bool PhysXManager::Initialize() {
     return true;
 }
 
+physx::PxSceneDesc PhysXManager::CreateSceneDesc() const {
+    physx::PxSceneDesc sceneDesc(m_Physics->getTolerancesScale());
+    sceneDesc.gravity = physx::PxVec3(0.0f, 0.0f, 0.0f);  // 全局重力由 GravitySystem 控制
+    if (m_JobDispatcher) {
+        sceneDesc.cpuDispatcher = m_JobDispatcher.get();
+    } else {
+        sceneDesc.cpuDispatcher = m_Dispatcher;
+    }
+    sceneDesc.filterShader = m_Settings.spacecraftCCD ? CCDSimulationFilterShader
+                                                      : ReportingSimulationFilterShader;
+    // 接触 / 触发器 / 睡眠事件写入 PhysicsEventQueue（回调无状态，所有场景共用）
+    sceneDesc.simulationEventCallback = &m_EventCallback;
+    // 只回读本步位姿有变化的 actor（睡眠/静态物体零开销）
+    sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS;
+
+    switch (m_Settings.broadPhase) {
+    case PhysicsSettings::BroadPhase::ABP:  sceneDesc.broadPhaseType = physx::PxBroadPhaseType::eABP; break;
+    case PhysicsSettings::BroadPhase::MBP:  sceneDesc.broadPhaseType = physx::PxBroadPhaseType::eMBP; break;
+    case PhysicsSettings::BroadPhase::PABP: sceneDesc.broadPhaseType = physx::PxBroadPhaseType::ePABP; break;
+    }
+    sceneDesc.solverType = m_Settings.solver == PhysicsSettings::Solver::TGS
+        ? physx::PxSolverType::eTGS : physx::PxSolverType::ePGS;
+
+    if (m_Settings.enhancedDeterminism) {
+        sceneDesc.flags |= physx::PxSceneFlag::eENABLE_ENHANCED_DETERMINISM;
+    }
+
+    // CCD 只对设置了 eENABLE_CCD 的 actor（飞船）生效
+    if (m_Settings.spacecraftCCD) {
+        sceneDesc.flags |= physx::PxSceneFlag::eENABLE_CCD;
+    }
+
+    if (m_CudaContextManager) {
+        sceneDesc.cudaContextManager = m_CudaContextManager;
+        sceneDesc.flags |= physx::PxSceneFlag::eENABLE_GPU_DYNAMICS;
+        sceneDesc.broadPhaseType = physx::PxBroadPhaseType::eGPU;
+    }
+    return sceneDesc;
+}
+
+physx::PxScene* PhysXManager::CreateSectorScene() {
+    if (!m_Physics) return nullptr;
+
+    physx::PxSceneDesc sceneDesc = CreateSceneDesc();
+    physx::PxScene* scene = m_Physics->createScene(sceneDesc);
+    if (!scene) {
+        std::cerr << "createScene (sector) failed!" << std::endl;
+        return nullptr;
+    }
+
+    SectorScene entry;
+    entry.scene = scene;
+    entry.controllerManager = PxCreateControllerManager(*scene);
+    m_SectorScenes.push_back(entry);
+    return scene;
+}
+
+void PhysXManager::SetBroadPhaseRegions(physx::PxScene* scene, float halfExtent) {
+    if (!scene || m_CudaContextManager || m_Settings.broadPhase != PhysicsSettings::BroadPhase::MBP) return;
+
+    // 替换旧区域（扇区切换后原点附近的范围随之改变）
+    std::vector<physx::PxU32>& handles = m_BroadPhaseRegions[scene];
+    for (physx::PxU32 handle : handles) {
+        scene->removeBroadPhaseRegion(handle);
+    }
+    handles.clear();
+
+    const uint32_t subdivisions = m_Settings.mbpSubdivisions > 0 ? m_Settings.mbpSubdivisions : 1;
+    std::vector<physx::PxBounds3> regions(subdivisions * subdivisions);
+    const physx::PxBounds3 bounds(physx::PxVec3(-halfExtent), physx::PxVec3(halfExtent));
+    const physx::PxU32 count = physx::PxBroadPhaseExt::createRegionsFromWorldBounds(
+        regions.data(), bounds, subdivisions, 1);
+    for (physx::PxU32 i = 0; i < count; i++) {
+        physx::PxBroadPhaseRegion region;
+        region.mBounds = regions[i];
+        region.mUserData = nullptr;
+        const physx::PxU32 handle = scene->addBroadPhaseRegion(region, true);   // 把已有的对象放入新区域
+        if (handle != 0xffffffff) handles.push_back(handle);
+    }
+}
+
+void PhysXManager::ScheduleSectorScene(physx::PxScene* scene, float stepTime) {
+    for (auto& entry : m_SectorScenes) {
+        if (entry.scene == scene) {
+            entry.scheduledStep = stepTime;
+            return;
+        }
+    }
+}
+
+bool PhysXManager::IsSceneScheduled(const physx::PxScene* scene) const {
+    if (scene == m_Scene) return true;
+    for (const auto& entry : m_SectorScenes) {
+        if (entry.scene == scene) return entry.scheduledStep > 0.0f;
+    }
+    return false;
+}
+
+physx::PxControllerManager* PhysXManager::GetControllerManager(const physx::PxScene* scene) {
+    if (scene == m_Scene) return m_ControllerManager;
+    for (const auto& entry : m_SectorScenes) {
+        if (entry.scene == scene) return entry.controllerManager;
+    }
+    return nullptr;
+}
+
 void PhysXManager::Update(float deltaTime) {
-    if (!m_Scene || deltaTime <= 0.0f) return;
-    
-    // 固定时间步
-    const float fixedStep = 1.0f / 60.0f;
-    const int maxSubSteps = 4;
-    float dt = (std::min)(deltaTime, fixedStep * maxSubSteps);
-    
-    // 模拟
-    m_Scene->simulate(dt);
-    m_Scene->fetchResults(true);
+    const uint32_t steps = Advance(deltaTime);
+    for (uint32_t i = 0; i < steps; i++) {
+        Step();
+    }
+}
+
+uint32_t PhysXManager::Advance(float deltaTime) {
+    if (!m_Scene || deltaTime <= 0.0f) return 0;
+
+    m_Accumulator += deltaTime;
+    uint32_t steps = static_cast<uint32_t>(m_Accumulator / m_FixedTimeStep);
+    if (steps > m_MaxSubSteps) {
+        // 掉帧时放慢物理而不是陷入越算越慢的循环：丢弃追不上的时间
+        steps = m_MaxSubSteps;
+        m_Accumulator = m_FixedTimeStep * static_cast<float>(steps);
+    }
+    m_Accumulator -= m_FixedTimeStep * static_cast<float>(steps);
+    if (m_Accumulator < 0.0f) m_Accumulator = 0.0f;
+    return steps;
+}
+
+void PhysXManager::Step() {
+    BeginStep();
+    FinishStep();
+}
+
+void PhysXManager::BeginStep() {
+    if (!m_Scene) return;
+    FinishStep();
+
+    // 所有场景先全部 simulate 再统一 fetchResults，各场景的任务在共享调度器上并行执行
+    m_SteppedScenes.clear();
+    m_Scene->simulate(m_FixedTimeStep);
+    m_SteppedScenes.push_back(m_Scene);
+    for (auto& entry : m_SectorScenes) {
+        if (entry.scheduledStep <= 0.0f) continue;
+        entry.scene->simulate(entry.scheduledStep);
+        m_SteppedScenes.push_back(entry.scene);
+        entry.scheduledStep = 0.0f;
+    }
+    m_SimulationInFlight = true;
+}
+
+bool PhysXManager::FinishStep() {
+    if (!m_SimulationInFlight) return false;
+    for (physx::PxScene* scene : m_SteppedScenes) {
+        scene->fetchResults(true);
+    }
+    m_SimulationInFlight = false;
+    return true;
 }
 
 void PhysXManager::Shutdown() {
+    if (m_Scene) {
+        FinishStep();
+    }
+
+    for (auto& entry : m_SectorScenes) {
+        if (entry.controllerManager) entry.controllerManager->release();
+        if (entry.scene) entry.scene->release();
+    }
+    m_SectorScenes.clear();
+    m_SteppedScenes.clear();
+    m_BroadPhaseRegions.clear();
+
     if (m_ControllerManager) {
         m_ControllerManager->release();
         m_ControllerManager = nullptr;
@@ -95,6 +327,15 @@ void PhysXManager::Shutdown() {
         m_Dispatcher->release();
         m_Dispatcher = nullptr;
     }
+    m_JobDispatcher.reset();
+
+    if (m_CudaContextManager) {
+        m_CudaContextManager->release();
+        m_CudaContextManager = nullptr;
+    }
+
+    // 场景释放后 shape 不再引用网格，缓存持有的最后一个引用在这里释放
+    CollisionMeshCache::GetInstance().Release();
 
     if (m_DefaultMaterial) {
         m_DefaultMaterial->release();
@@ -5,6 +5,10 @@
 #include <vector>
 #include <string>
 #include <limits>
+#include <unordered_map>
+#include "PhysXAllocator.h"
+#include "PhysXJobDispatcher.h"
+#include "PhysicsEvents.h"
 #if defined(_WIN32)
 #include <intrin.h>
 #endif
@@ -33,6 +37,22 @@ public:
     }
 };
 
+/**
+ * @brief PhysX 场景配置（PhysXManager::Initialize 之前通过 SetSettings 设置）
+ */
+struct PhysicsSettings {
+    enum class BroadPhase { ABP, MBP, PABP };
+    enum class Solver { PGS, TGS };
+
+    BroadPhase broadPhase = BroadPhase::PABP;   // PhysX 5 默认；MBP 需要区域，见 SetBroadPhaseRegions
+    Solver solver = Solver::PGS;
+    uint32_t dispatcherThreads = 0;             // 0 = 跑在 JobSystem 工作线程上；>0 = 独立线程池的线程数
+    bool spacecraftCCD = true;                  // 只对飞船开启 CCD（场景开启 eENABLE_CCD，actor 按需设置标志）
+    bool gpuRigidBodies = false;                // 有可用的 CUDA 上下文时启用 GPU 刚体与 GPU 宽相位
+    uint32_t mbpSubdivisions = 4;               // MBP：每个区域包围盒在水平面上切成 N x N 个区域
+    bool enhancedDeterminism = false;           // 结果与线程调度无关（输入回放 / 性能回归运行）
+};
+
 class PhysXManager {
 public:
     static PhysXManager& GetInstance() {
@@ -40,9 +60,98 @@ public:
         return instance;
     }
 
+    /** @brief 必须在 Initialize 之前调用 */
+    void SetSettings(const PhysicsSettings& settings) { m_Settings = settings; }
+    const PhysicsSettings& GetSettings() const { return m_Settings; }
+
     bool Initialize();
     void Shutdown();
+    /**
+     * @brief 推进累加器并执行所有到期的固定步（不含 Pre/PostPhysicsUpdate，Engine 使用 Advance + Step）
+     */
     void Update(float deltaTime);
+
+    /**
+     * @brief 固定步长累加器：累加帧时间，返回本帧应执行的步数（最多 maxSubSteps，超出的时间丢弃）
+     */
+    uint32_t Advance(float deltaTime);
+
+    /**
+     * @brief 执行一个固定步（simulate + fetchResults）
+     */
+    void Step();
+
+    /**
+     * @brief 流水线模式：只启动一个固定步的 simulate，结果留到下一帧开头由 FinishStep 取回
+     *
+     * simulate 与 fetchResults 之间 PhysX 工作线程在跑模拟，主线程继续渲染。这段时间内
+     * 不得读写任何 PhysX actor / 角色控制器 / 场景查询（PhysX 会缓冲部分写入，但 CCT move、
+     * 场景查询和读位姿都不安全）。Engine 保证：FinishStep 在帧开头、任何系统之前调用，
+     * 之后到下一次 BeginStep 之间才是可以访问 PhysX 的窗口。
+     */
+    void BeginStep();
+
+    /**
+     * @brief 等待在途的模拟完成并取回结果
+     * @return 有在途模拟并已取回时返回 true
+     */
+    bool FinishStep();
+
+    bool IsSimulating() const { return m_SimulationInFlight; }
+
+    /**
+     * @brief 每个扇区独立 PxScene 模式（必须在搭建场景之前设置）
+     *
+     * 开启后 SectorPhysicsSystem 为每个 SectorComponent 创建自己的场景和 CCT 管理器，
+     * 地面碰撞体常开，actor 跟随所在扇区换场景；不再切换碰撞形状标志。
+     * 主场景（GetScene）继续模拟不属于任何扇区的 actor。
+     */
+    void SetPerSectorScenes(bool enabled) { m_PerSectorScenes = enabled; }
+    bool IsPerSectorScenes() const { return m_PerSectorScenes; }
+
+    /**
+     * @brief 创建一个扇区场景（与主场景同样的调度器、过滤器和标志）及其 CCT 管理器
+     */
+    physx::PxScene* CreateSectorScene();
+
+    /**
+     * @brief 安排扇区场景在下一个固定步模拟 stepTime 秒；0 = 本步冻结
+     *
+     * 每步 BeginStep 之后清零，SectorPhysicsSystem::PrePhysicsUpdate 每步重新安排。
+     */
+    void ScheduleSectorScene(physx::PxScene* scene, float stepTime);
+    bool IsSceneScheduled(const physx::PxScene* scene) const;
+
+    /**
+     * @brief 最近一次取回结果的场景（主场景 + 本步模拟的扇区场景），用于活跃 actor 回读
+     */
+    const std::vector<physx::PxScene*>& GetSteppedScenes() const { return m_SteppedScenes; }
+
+    physx::PxControllerManager* GetControllerManager(const physx::PxScene* scene);
+
+    /**
+     * @brief MBP 宽相位：把场景的区域设为以原点（扇区中心）为中心、半边长 halfExtent 的包围盒，
+     *        切成 mbpSubdivisions^2 个区域；其他宽相位类型下无操作
+     *
+     * PhysX 坐标是扇区局部坐标，扇区切换 / 创建扇区场景时由 SectorPhysicsSystem 调用。
+     */
+    void SetBroadPhaseRegions(physx::PxScene* scene, float halfExtent);
+
+    /** @brief GPU 刚体是否实际启用（请求了且 CUDA 上下文有效） */
+    bool IsGpuEnabled() const { return m_CudaContextManager != nullptr; }
+
+    void SetPipelined(bool enabled) { m_Pipelined = enabled; }
+    bool IsPipelined() const { return m_Pipelined; }
+
+    /**
+     * @brief 渲染插值系数：累加器中剩余时间 / 步长，范围 [0, 1)
+     */
+    float GetInterpolationAlpha() const { return m_FixedTimeStep > 0.0f ? m_Accumulator / m_FixedTimeStep : 0.0f; }
+
+    void SetFixedTimeStep(float seconds) { m_FixedTimeStep = seconds > 1e-4f ? seconds : 1e-4f; }
+    float GetFixedTimeStep() const { return m_FixedTimeStep; }
+    void SetMaxSubSteps(uint32_t steps) { m_MaxSubSteps = steps > 0 ? steps : 1; }
+    uint32_t GetMaxSubSteps() const { return m_MaxSubSteps; }
     
     // 崩溃时转储场景状态
     void DumpSceneState(const char* context);
@@ -58,15 +167,40 @@ private:
     PhysXManager(const PhysXManager&) = delete;
     PhysXManager& operator=(const PhysXManager&) = delete;
 
-    physx::PxDefaultAllocator m_Allocator;
+    PhysXAllocator m_Allocator;                 // 记到 MemoryCategory::Physics
     CustomErrorCallback m_ErrorCallback;
+    mutable PhysicsEventCallback m_EventCallback;   // CreateSceneDesc（const）取地址
     physx::PxFoundation* m_Foundation = nullptr;
     physx::PxPhysics* m_Physics = nullptr;
-    physx::PxDefaultCpuDispatcher* m_Dispatcher = nullptr;
+    PhysicsSettings m_Settings;
+    physx::PxDefaultCpuDispatcher* m_Dispatcher = nullptr;          // JobSystem 不可用或指定了 dispatcherThreads 时使用
+    physx::PxCudaContextManager* m_CudaContextManager = nullptr;
+    std::unique_ptr<PhysXJobDispatcher> m_JobDispatcher;
     physx::PxScene* m_Scene = nullptr;
     physx::PxMaterial* m_DefaultMaterial = nullptr;
     physx::PxPvd* m_Pvd = nullptr;
     physx::PxControllerManager* m_ControllerManager = nullptr;
+
+    // 固定步长
+    float m_FixedTimeStep = 1.0f / 60.0f;
+    uint32_t m_MaxSubSteps = 4;
+    float m_Accumulator = 0.0f;
+
+    // 流水线模式（最后一个固定步与渲染重叠）
+    bool m_Pipelined = true;
+    bool m_SimulationInFlight = false;
+
+    // 扇区独立场景
+    struct SectorScene {
+        physx::PxScene* scene = nullptr;
+        physx::PxControllerManager* controllerManager = nullptr;
+        float scheduledStep = 0.0f;
+    };
+    physx::PxSceneDesc CreateSceneDesc() const;
+    bool m_PerSectorScenes = false;
+    std::vector<SectorScene> m_SectorScenes;
+    std::vector<physx::PxScene*> m_SteppedScenes;
+    std::unordered_map<physx::PxScene*, std::vector<physx::PxU32>> m_BroadPhaseRegions;   // MBP 区域句柄
 };
 
 } // namespace outer_wilds
@@ -0,0 +1,215 @@
+#include "PhysicsEvents.h"
+#include "components/RigidBodyComponent.h"
+#include "../core/Profiler.h"
+#include <algorithm>
+
+namespace outer_wilds {
+
+namespace {
+    constexpr physx::PxU32 kMaxContactPointsPerPair = 16;
+
+    // 已删除 / 移除的 actor 不能解引用（PxContactPairHeader 的说明）
+    entt::entity ContactActorEntity(const physx::PxContactPairHeader& header, physx::PxU32 index) {
+        const physx::PxContactPairHeaderFlag::Enum removed = index == 0
+            ? physx::PxContactPairHeaderFlag::eREMOVED_ACTOR_0
+            : physx::PxContactPairHeaderFlag::eREMOVED_ACTOR_1;
+        if (header.flags & removed) return entt::null;
+        return header.actors[index] ? FromActorUserData(header.actors[index]->userData) : entt::null;
+    }
+
+    /**
+     * @brief 接触点平均位置 / 法线与冲量之和（形状对已删除时没有接触点）
+     */
+    void ExtractContacts(const physx::PxContactPair& pair, PhysicsEvent& event) {
+        if (pair.contactCount == 0 ||
+            (pair.flags & (physx::PxContactPairFlag::eREMOVED_SHAPE_0 | physx::PxContactPairFlag::eREMOVED_SHAPE_1))) {
+            return;
+        }
+        physx::PxContactPairPoint points[kMaxContactPointsPerPair];
+        const physx::PxU32 count = pair.extractContacts(points, kMaxContactPointsPerPair);
+        if (count == 0) return;
+
+        physx::PxVec3 position(0.0f), normal(0.0f);
+        float impulse = 0.0f;
+        for (physx::PxU32 i = 0; i < count; i++) {
+            position += points[i].position;
+            normal += points[i].normal;
+            impulse += points[i].impulse.magnitude();
+        }
+        position *= 1.0f / static_cast<float>(count);
+        const float normalLength = normal.magnitude();
+        if (normalLength > 1e-6f) normal *= 1.0f / normalLength;
+
+        event.position = { position.x, position.y, position.z };
+        event.normal = { normal.x, normal.y, normal.z };
+        event.impulse = impulse;
+    }
+}
+
+// ============================================
+// PhysicsEventQueue
+// ============================================
+
+PhysicsEventQueue::PhysicsEventQueue() {
+    m_Buffers[0].resize(kMaxEventsPerFrame);
+    m_Buffers[1].resize(kMaxEventsPerFrame);
+}
+
+void PhysicsEventQueue::Push(const PhysicsEvent& event) {
+    const uint32_t index = m_WriteCount.fetch_add(1, std::memory_order_relaxed);
+    if (index < kMaxEventsPerFrame) {
+        m_Buffers[m_WriteBuffer][index] = event;
+    }
+}
+
+uint32_t PhysicsEventQueue::Subscribe(uint32_t typeMask, Listener listener) {
+    Subscription subscription;
+    subscription.id = m_NextSubscription++;
+    subscription.typeMask = typeMask;
+    subscription.listener = std::move(listener);
+    m_Subscriptions.push_back(std::move(subscription));
+    return m_Subscriptions.back().id;
+}
+
+void PhysicsEventQueue::Unsubscribe(uint32_t id) {
+    if (id == kInvalidSubscription) return;
+    m_Subscriptions.erase(std::remove_if(m_Subscriptions.begin(), m_Subscriptions.end(),
+                                         [id](const Subscription& s) { return s.id == id; }),
+                          m_Subscriptions.end());
+}
+
+void PhysicsEventQueue::Dispatch(entt::registry& registry) {
+    PROFILE_SCOPE("PhysicsEventQueue::Dispatch");
+
+    // 模拟没有在进行，回调不会并发写入：直接交换缓冲
+    const uint32_t written = m_WriteCount.exchange(0, std::memory_order_acquire);
+    m_ReadCount = (std::min)(written, kMaxEventsPerFrame);
+    std::swap(m_WriteBuffer, m_ReadBuffer);
+
+    m_Stats.frameEvents = m_ReadCount;
+    m_Stats.frameDropped = written - m_ReadCount;
+    m_Stats.totalEvents += m_ReadCount;
+    m_Stats.totalDropped += m_Stats.frameDropped;
+
+    if (m_ReadCount == 0 || m_Subscriptions.empty()) return;
+
+    const PhysicsEvent* events = m_Buffers[m_ReadBuffer].data();
+    for (const Subscription& subscription : m_Subscriptions) {
+        for (uint32_t i = 0; i < m_ReadCount; i++) {
+            if (subscription.typeMask & PhysicsEventMask(events[i].type)) {
+                subscription.listener(registry, events[i]);
+            }
+        }
+    }
+}
+
+void PhysicsEventQueue::Clear() {
+    m_WriteCount.store(0, std::memory_order_relaxed);
+    m_ReadCount = 0;
+}
+
+PhysicsEventQueue::Stats PhysicsEventQueue::GetStats() const {
+    Stats stats = m_Stats;
+    stats.listeners = static_cast<uint32_t>(m_Subscriptions.size());
+    return stats;
+}
+
+// ============================================
+// PhysicsEventCallback（fetchResults 内调用）
+// ============================================
+
+void PhysicsEventCallback::onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs,
+                                     physx::PxU32 nbPairs) {
+    auto& queue = PhysicsEventQueue::GetInstance();
+    const entt::entity entity0 = ContactActorEntity(pairHeader, 0);
+    const entt::entity entity1 = ContactActorEntity(pairHeader, 1);
+    if (entity0 == entt::null && entity1 == entt::null) return;
+
+    for (physx::PxU32 i = 0; i < nbPairs; i++) {
+        const physx::PxContactPair& pair = pairs[i];
+        PhysicsEvent event;
+        event.entity = entity0;
+        event.other = entity1;
+
+        if (pair.events & (physx::PxPairFlag::eNOTIFY_TOUCH_FOUND | physx::PxPairFlag::eNOTIFY_THRESHOLD_FORCE_FOUND)) {
+            ExtractContacts(pair, event);
+        }
+        if (pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_FOUND) {
+            event.type = PhysicsEvent::Type::ContactBegin;
+            queue.Push(event);
+        }
+        if (pair.events & physx::PxPairFlag::eNOTIFY_THRESHOLD_FORCE_FOUND) {
+            event.type = PhysicsEvent::Type::Impact;
+            queue.Push(event);
+        }
+        if (pair.events & physx::PxPairFlag::eNOTIFY_TOUCH_LOST) {
+            event.type = PhysicsEvent::Type::ContactEnd;
+            queue.Push(event);
+        }
+    }
+}
+
+void PhysicsEventCallback::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count) {
+    auto& queue = PhysicsEventQueue::GetInstance();
+    for (physx::PxU32 i = 0; i < count; i++) {
+        const physx::PxTriggerPair& pair = pairs[i];
+        if (pair.flags & (physx::PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER |
+                          physx::PxTriggerPairFlag::eREMOVED_SHAPE_OTHER)) {
+            continue;
+        }
+
+        PhysicsEvent event;
+        event.type = pair.status == physx::PxPairFlag::eNOTIFY_TOUCH_FOUND
+            ? PhysicsEvent::Type::TriggerEnter : PhysicsEvent::Type::TriggerExit;
+        event.entity = pair.triggerActor ? FromActorUserData(pair.triggerActor->userData) : entt::null;
+        event.other = pair.otherActor ? FromActorUserData(pair.otherActor->userData) : entt::null;
+        queue.Push(event);
+    }
+}
+
+void PhysicsEventCallback::onWake(physx::PxActor** actors, physx::PxU32 count) {
+    auto& queue = PhysicsEventQueue::GetInstance();
+    for (physx::PxU32 i = 0; i < count; i++) {
+        PhysicsEvent event;
+        event.type = PhysicsEvent::Type::Wake;
+        event.entity = FromActorUserData(actors[i]->userData);
+        if (event.entity != entt::null) queue.Push(event);
+    }
+}
+
+void PhysicsEventCallback::onSleep(physx::PxActor** actors, physx::PxU32 count) {
+    auto& queue = PhysicsEventQueue::GetInstance();
+    for (physx::PxU32 i = 0; i < count; i++) {
+        PhysicsEvent event;
+        event.type = PhysicsEvent::Type::Sleep;
+        event.entity = FromActorUserData(actors[i]->userData);
+        if (event.entity != entt::null) queue.Push(event);
+    }
+}
+
+void EnableContactReports(physx::PxRigidActor& actor, uint32_t flags, float impactForceThreshold) {
+    const uint32_t shapeFlags = flags & (kReportContacts | kReportImpacts);
+    if (shapeFlags) {
+        physx::PxShape* shapes[8];
+        const physx::PxU32 shapeCount = actor.getNbShapes();
+        for (physx::PxU32 start = 0; start < shapeCount; start += 8) {
+            const physx::PxU32 count = actor.getShapes(shapes, 8, start);
+            for (physx::PxU32 i = 0; i < count; i++) {
+                physx::PxFilterData filterData = shapes[i]->getSimulationFilterData();
+                filterData.word2 |= shapeFlags;
+                shapes[i]->setSimulationFilterData(filterData);
+            }
+        }
+    }
+
+    if (auto* dynamicActor = actor.is<physx::PxRigidDynamic>()) {
+        if (flags & kReportImpacts) {
+            dynamicActor->setContactReportThreshold(impactForceThreshold);
+        }
+    }
+    if (flags & kReportSleep) {
+        actor.setActorFlag(physx::PxActorFlag::eSEND_SLEEP_NOTIFIES, true);
+    }
+}
+
+} // namespace outer_wilds
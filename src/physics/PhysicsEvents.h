@@ -0,0 +1,154 @@
+/**
+ * PhysicsEvents.h
+ *
+ * PhysX 模拟事件（接触 / 触发器 / 唤醒 / 睡眠）→ 每帧事件队列 → ECS 监听者
+ *
+ * - PhysicsEventCallback 装在每个场景上（PhysXManager::CreateSceneDesc），在 fetchResults 内把事件写进
+ *   PhysicsEventQueue 预先分配的缓冲（原子下标，不加锁、不分配；写满后丢弃并计数）
+ * - 只有打了上报标志的形状产生接触事件：EnableContactReports 把标志写进形状的 filterData.word2，
+ *   PhysXManager 的过滤着色器据此请求 eNOTIFY_TOUCH_* / eNOTIFY_THRESHOLD_FORCE_FOUND。
+ *   撞击（Impact）只在接触力超过 actor 的 contactReportThreshold 时由 PhysX 上报
+ * - Engine 在帧开头（取回上一帧的模拟之后、任何系统之前）调用 Dispatch：交换缓冲，在主线程上按订阅的
+ *   类型依次通知监听者；之后本帧的事件通过 GetFrameEvents 只读可用（并行系统也可以读）
+ *
+ * 坐标：position / normal 是扇区局部坐标（与 PhysX 一致）。实体来自 actor->userData（ToActorUserData），
+ * 没有设置 userData 或已从场景移除的 actor 为 entt::null。
+ * 非流水线模式下固定步在帧末执行，事件在下一帧开头派发（延迟一帧，与流水线模式一致）。
+ */
+
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <entt/entt.hpp>
+#include <DirectXMath.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 形状的上报标志（写在 PxFilterData::word2；PxDefaultSimulationFilterShader 只用 word0 / word1）
+ *
+ * 一对形状中任意一个带标志即上报。kReportSleep 是 actor 标志（eSEND_SLEEP_NOTIFIES），不写进形状。
+ */
+enum PhysicsReportFlags : uint32_t {
+    kReportContacts = 1u << 0,      // ContactBegin / ContactEnd
+    kReportImpacts  = 1u << 1,      // 接触力超过 contactReportThreshold 时的 Impact（带冲量）
+    kReportSleep    = 1u << 2,      // Wake / Sleep
+};
+
+struct PhysicsEvent {
+    enum class Type : uint8_t { ContactBegin, ContactEnd, Impact, TriggerEnter, TriggerExit, Wake, Sleep, Count };
+
+    Type type = Type::ContactBegin;
+    entt::entity entity = entt::null;   // 接触：actor0；触发器：触发器所属实体；唤醒 / 睡眠：该实体
+    entt::entity other = entt::null;    // 接触：actor1；触发器：进入 / 离开的实体
+    DirectX::XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };   // 接触点平均值（没有接触点时为 0）
+    DirectX::XMFLOAT3 normal = { 0.0f, 0.0f, 0.0f };     // 接触法线平均值，从 other 指向 entity
+    float impulse = 0.0f;               // 本步接触冲量之和（N·s）
+
+    bool Involves(entt::entity e) const { return entity == e || other == e; }
+    /** @brief 接触的另一方（self 不参与时返回 entt::null） */
+    entt::entity OtherThan(entt::entity self) const {
+        return entity == self ? other : (other == self ? entity : entt::null);
+    }
+};
+
+constexpr uint32_t PhysicsEventMask(PhysicsEvent::Type type) { return 1u << static_cast<uint32_t>(type); }
+constexpr uint32_t kAllPhysicsEvents = (1u << static_cast<uint32_t>(PhysicsEvent::Type::Count)) - 1;
+
+class PhysicsEventQueue {
+public:
+    static constexpr uint32_t kMaxEventsPerFrame = 4096;
+    static constexpr uint32_t kInvalidSubscription = 0;
+
+    using Listener = std::function<void(entt::registry&, const PhysicsEvent&)>;
+
+    struct Stats {
+        uint32_t frameEvents = 0;       // 上一次 Dispatch 的事件数
+        uint32_t frameDropped = 0;      // 上一次 Dispatch 时缓冲已满丢弃的事件数
+        uint64_t totalEvents = 0;
+        uint64_t totalDropped = 0;
+        uint32_t listeners = 0;
+    };
+
+    static PhysicsEventQueue& GetInstance() {
+        static PhysicsEventQueue instance;
+        return instance;
+    }
+
+    /**
+     * @brief 写入一个事件（模拟回调内调用，可多线程并发）；缓冲已满时丢弃
+     */
+    void Push(const PhysicsEvent& event);
+
+    /**
+     * @brief 订阅 typeMask（PhysicsEventMask 的组合）中的事件；在主线程、Dispatch 之外调用
+     * @return 订阅 id（Unsubscribe 用）
+     */
+    uint32_t Subscribe(uint32_t typeMask, Listener listener);
+    void Unsubscribe(uint32_t id);
+
+    /**
+     * @brief 交换缓冲并通知监听者（Engine 调用；主线程，模拟没有在进行）
+     *
+     * 监听者可以修改 registry 和 PhysX actor（此时访问 PhysX 安全），但不应订阅 / 退订。
+     */
+    void Dispatch(entt::registry& registry);
+
+    /** @brief 最近一次 Dispatch 派发的事件（下一次 Dispatch 之前有效） */
+    const PhysicsEvent* GetFrameEvents() const { return m_Buffers[m_ReadBuffer].data(); }
+    uint32_t GetFrameEventCount() const { return m_ReadCount; }
+
+    /** @brief 丢弃未派发的事件（场景重建 / 关闭时） */
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    PhysicsEventQueue();
+    PhysicsEventQueue(const PhysicsEventQueue&) = delete;
+    PhysicsEventQueue& operator=(const PhysicsEventQueue&) = delete;
+
+    struct Subscription {
+        uint32_t id = kInvalidSubscription;
+        uint32_t typeMask = 0;
+        Listener listener;
+    };
+
+    std::vector<PhysicsEvent> m_Buffers[2];     // 各 kMaxEventsPerFrame，构造时分配
+    uint32_t m_WriteBuffer = 0;
+    uint32_t m_ReadBuffer = 1;
+    std::atomic<uint32_t> m_WriteCount{ 0 };   // 可能超过容量：超出部分即丢弃数
+    uint32_t m_ReadCount = 0;
+
+    std::vector<Subscription> m_Subscriptions;
+    uint32_t m_NextSubscription = 1;
+
+    Stats m_Stats;
+};
+
+/**
+ * @brief 装在场景上的 PxSimulationEventCallback：把 PhysX 回调翻译成 PhysicsEvent 写入队列
+ */
+class PhysicsEventCallback : public physx::PxSimulationEventCallback {
+public:
+    void onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs,
+                   physx::PxU32 nbPairs) override;
+    void onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count) override;
+    void onWake(physx::PxActor** actors, physx::PxU32 count) override;
+    void onSleep(physx::PxActor** actors, physx::PxU32 count) override;
+    void onConstraintBreak(physx::PxConstraintInfo*, physx::PxU32) override {}
+    void onAdvance(const physx::PxRigidBody* const*, const physx::PxTransform*, physx::PxU32) override {}
+};
+
+/**
+ * @brief 给 actor 的全部形状打上报标志（flags 为 PhysicsReportFlags 的组合）
+ *
+ * kReportImpacts 同时把动态刚体的 contactReportThreshold 设为 impactForceThreshold（N）；
+ * kReportSleep 设置 eSEND_SLEEP_NOTIFIES。应在 actor 加入场景之前调用：已经存在的接触对不会重新过滤。
+ */
+void EnableContactReports(physx::PxRigidActor& actor, uint32_t flags, float impactForceThreshold = 0.0f);
+
+} // namespace outer_wilds
@@ -30,6 +30,11 @@ void PhysicsSystem::Initialize(std::shared_ptr<Scene> scene) {
     Initialize();
 }
 
+void PhysicsSystem::DeclareAccess(SystemAccess& access) const {
+    access.Write<TransformComponent, RigidBodyComponent>()
+          .WriteResource(SystemAccess::kPhysXScene);
+}
+
 void PhysicsSystem::Update(float deltaTime, entt::registry& registry) {
     // 在 PhysX simulate 之前同步 Kinematic 物体
     SyncTransformsToPhysics(registry);
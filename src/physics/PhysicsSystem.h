@@ -15,6 +15,7 @@ public:
     void Initialize() override;
     void Initialize(std::shared_ptr<Scene> scene);
     void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
     void Shutdown() override;
     
     void SetGravity(const DirectX::XMFLOAT3& gravity);
@@ -0,0 +1,164 @@
+#include "SceneQueryService.h"
+#include "components/RigidBodyComponent.h"
+#include "../core/JobSystem.h"
+#include "../core/Profiler.h"
+
+namespace outer_wilds {
+
+namespace {
+    // 忽略发起者自己的 actor
+    class IgnoreActorFilter : public physx::PxQueryFilterCallback {
+    public:
+        IgnoreActorFilter(const physx::PxRigidActor* ignore, physx::PxQueryHitType::Enum hitType)
+            : m_Ignore(ignore), m_HitType(hitType) {}
+
+        physx::PxQueryHitType::Enum preFilter(const physx::PxFilterData&, const physx::PxShape*,
+                                              const physx::PxRigidActor* actor, physx::PxHitFlags&) override {
+            return actor == m_Ignore ? physx::PxQueryHitType::eNONE : m_HitType;
+        }
+
+        physx::PxQueryHitType::Enum postFilter(const physx::PxFilterData&, const physx::PxQueryHit&,
+                                               const physx::PxShape*, const physx::PxRigidActor*) override {
+            return m_HitType;
+        }
+
+    private:
+        const physx::PxRigidActor* m_Ignore;
+        physx::PxQueryHitType::Enum m_HitType;
+    };
+
+    constexpr uint32_t kQueryGrainSize = 16;
+}
+
+SceneQueryService::Handle SceneQueryService::Raycast(physx::PxScene* scene, const physx::PxVec3& origin,
+                                                     const physx::PxVec3& unitDir, float maxDistance,
+                                                     const physx::PxRigidActor* ignore) {
+    Request request;
+    request.type = Type::Raycast;
+    request.scene = scene;
+    request.pose = physx::PxTransform(origin);
+    request.direction = unitDir;
+    request.distance = maxDistance;
+    request.ignore = ignore;
+    return Submit(request);
+}
+
+SceneQueryService::Handle SceneQueryService::Sweep(physx::PxScene* scene, const physx::PxGeometry& geometry,
+                                                   const physx::PxTransform& pose, const physx::PxVec3& unitDir,
+                                                   float maxDistance, const physx::PxRigidActor* ignore) {
+    Request request;
+    request.type = Type::Sweep;
+    request.scene = scene;
+    request.geometry.storeAny(geometry);
+    request.pose = pose;
+    request.direction = unitDir;
+    request.distance = maxDistance;
+    request.ignore = ignore;
+    return Submit(request);
+}
+
+SceneQueryService::Handle SceneQueryService::Overlap(physx::PxScene* scene, const physx::PxGeometry& geometry,
+                                                     const physx::PxTransform& pose,
+                                                     const physx::PxRigidActor* ignore, bool dynamicOnly) {
+    Request request;
+    request.type = Type::Overlap;
+    request.scene = scene;
+    request.geometry.storeAny(geometry);
+    request.pose = pose;
+    request.ignore = ignore;
+    request.dynamicOnly = dynamicOnly;
+    return Submit(request);
+}
+
+SceneQueryService::Handle SceneQueryService::Submit(const Request& request) {
+    if (!request.scene) return kInvalidHandle;
+    std::lock_guard<std::mutex> lock(m_SubmitMutex);
+    m_Submitted.push_back(request);
+    return m_NextHandle++;
+}
+
+bool SceneQueryService::GetResult(Handle handle, Result& out) const {
+    if (handle == kInvalidHandle || handle < m_ResultBase) return false;
+    const Handle index = handle - m_ResultBase;
+    if (index >= m_Results.size()) return false;
+    out = m_Results[index];
+    return true;
+}
+
+void SceneQueryService::Execute() {
+    PROFILE_SCOPE("SceneQueries");
+    {
+        std::lock_guard<std::mutex> lock(m_SubmitMutex);
+        m_Executing.swap(m_Submitted);
+        m_Submitted.clear();
+        m_ResultBase = m_SubmittedBase;
+        m_SubmittedBase = m_NextHandle;
+    }
+
+    m_Results.assign(m_Executing.size(), Result());
+    // 场景在这里是只读的：查询可以在多个线程上同时执行
+    JobSystem::GetInstance().ParallelFor(static_cast<uint32_t>(m_Executing.size()), kQueryGrainSize,
+        [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                Run(m_Executing[i], m_Results[i]);
+            }
+        });
+}
+
+void SceneQueryService::Run(const Request& request, Result& result) {
+    const physx::PxHitFlags hitFlags = physx::PxHitFlag::ePOSITION | physx::PxHitFlag::eNORMAL;
+
+    switch (request.type) {
+    case Type::Raycast: {
+        IgnoreActorFilter filter(request.ignore, physx::PxQueryHitType::eBLOCK);
+        const physx::PxQueryFilterData filterData(physx::PxQueryFlag::eSTATIC | physx::PxQueryFlag::eDYNAMIC |
+                                                  physx::PxQueryFlag::ePREFILTER);
+        physx::PxRaycastBuffer hit;
+        if (request.scene->raycast(request.pose.p, request.direction, request.distance, hit, hitFlags,
+                                   filterData, request.ignore ? &filter : nullptr) && hit.hasBlock) {
+            result.hit = true;
+            result.position = hit.block.position;
+            result.normal = hit.block.normal;
+            result.distance = hit.block.distance;
+            result.entity = hit.block.actor ? FromActorUserData(hit.block.actor->userData) : entt::null;
+        }
+        break;
+    }
+    case Type::Sweep: {
+        IgnoreActorFilter filter(request.ignore, physx::PxQueryHitType::eBLOCK);
+        const physx::PxQueryFilterData filterData(physx::PxQueryFlag::eSTATIC | physx::PxQueryFlag::eDYNAMIC |
+                                                  physx::PxQueryFlag::ePREFILTER);
+        physx::PxSweepBuffer hit;
+        if (request.scene->sweep(request.geometry.any(), request.pose, request.direction, request.distance, hit,
+                                 hitFlags, filterData, request.ignore ? &filter : nullptr) && hit.hasBlock) {
+            result.hit = true;
+            result.position = hit.block.position;
+            result.normal = hit.block.normal;
+            result.distance = hit.block.distance;
+            result.entity = hit.block.actor ? FromActorUserData(hit.block.actor->userData) : entt::null;
+        }
+        break;
+    }
+    case Type::Overlap: {
+        // 所有命中都作为 touch 收集
+        IgnoreActorFilter filter(request.ignore, physx::PxQueryHitType::eTOUCH);
+        physx::PxQueryFlags flags = physx::PxQueryFlag::eDYNAMIC | physx::PxQueryFlag::ePREFILTER |
+                                    physx::PxQueryFlag::eNO_BLOCK;
+        if (!request.dynamicOnly) flags |= physx::PxQueryFlag::eSTATIC;
+        const physx::PxQueryFilterData filterData(flags);
+        physx::PxOverlapHit touches[kMaxOverlapTouches];
+        physx::PxOverlapBuffer hit(touches, kMaxOverlapTouches);
+        request.scene->overlap(request.geometry.any(), request.pose, hit, filterData, &filter);
+        result.touchCount = hit.getNbTouches();
+        result.hit = result.touchCount > 0;
+        for (uint32_t i = 0; i < result.touchCount; i++) {
+            const physx::PxRigidActor* actor = hit.getTouch(i).actor;
+            result.touches[i] = actor ? FromActorUserData(actor->userData) : entt::null;
+        }
+        if (result.hit) result.entity = result.touches[0];
+        break;
+    }
+    }
+}
+
+} // namespace outer_wilds
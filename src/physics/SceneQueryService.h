@@ -0,0 +1,103 @@
+/**
+ * SceneQueryService.h
+ *
+ * 批量场景查询（射线 / 扫掠 / 重叠）
+ *
+ * 各系统在自己的 Update 中提交查询并保存返回的句柄；Engine 在每帧开头、fetchResults 之后
+ * （没有 simulate 在进行、也还没有系统修改场景）调用 Execute，把上一帧提交的所有查询
+ * 在 JobSystem 上并行执行。结果在下一次 Execute 之前一直可以用句柄读取，
+ * 即提交后的下一帧由消费方取回（延迟一帧）。
+ *
+ * 坐标与 PhysX 一致：扇区局部坐标，scene 为查询所在的场景（扇区独立场景模式下为扇区的场景）。
+ */
+
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace outer_wilds {
+
+class SceneQueryService {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = 0;
+    static constexpr uint32_t kMaxOverlapTouches = 8;
+
+    struct Result {
+        bool hit = false;
+        physx::PxVec3 position = physx::PxVec3(0.0f);   // 射线/扫掠的命中点
+        physx::PxVec3 normal = physx::PxVec3(0.0f);
+        float distance = 0.0f;
+        entt::entity entity = entt::null;                // 最近命中 actor 的实体（userData，见 ToActorUserData；扇区地面为扇区实体）
+        // 重叠查询：所有接触到的实体（最多 kMaxOverlapTouches 个）
+        uint32_t touchCount = 0;
+        entt::entity touches[kMaxOverlapTouches] = {};
+    };
+
+    static SceneQueryService& GetInstance() {
+        static SceneQueryService instance;
+        return instance;
+    }
+
+    /** @brief 提交射线（可在任意系统线程调用）。ignore 不参与命中（通常是发起者自己的 actor） */
+    Handle Raycast(physx::PxScene* scene, const physx::PxVec3& origin, const physx::PxVec3& unitDir,
+                   float maxDistance, const physx::PxRigidActor* ignore = nullptr);
+
+    /** @brief 提交扫掠（球/胶囊/盒） */
+    Handle Sweep(physx::PxScene* scene, const physx::PxGeometry& geometry, const physx::PxTransform& pose,
+                 const physx::PxVec3& unitDir, float maxDistance, const physx::PxRigidActor* ignore = nullptr);
+
+    /**
+     * @brief 提交重叠：收集所有接触的 actor
+     * @param dynamicOnly 只收集动态 actor（静态的扇区地面总是与地表附近的查询重叠，会占掉 touch 名额）
+     */
+    Handle Overlap(physx::PxScene* scene, const physx::PxGeometry& geometry, const physx::PxTransform& pose,
+                   const physx::PxRigidActor* ignore = nullptr, bool dynamicOnly = false);
+
+    /**
+     * @brief 读取上一次 Execute 的结果
+     * @return 句柄不属于上一批（太旧或尚未执行）时返回 false
+     */
+    bool GetResult(Handle handle, Result& out) const;
+
+    /** @brief 句柄已提交但还没有执行（结果要到下一次 Execute 之后才可读） */
+    bool IsPending(Handle handle) const { return handle != kInvalidHandle && handle >= m_SubmittedBase; }
+
+    /** @brief 执行所有已提交的查询（Engine 调用；场景必须可读且没有并发修改） */
+    void Execute();
+
+    uint32_t GetLastBatchSize() const { return static_cast<uint32_t>(m_Results.size()); }
+
+private:
+    SceneQueryService() = default;
+
+    enum class Type : uint8_t { Raycast, Sweep, Overlap };
+
+    struct Request {
+        Type type = Type::Raycast;
+        physx::PxScene* scene = nullptr;
+        physx::PxGeometryHolder geometry;
+        physx::PxTransform pose = physx::PxTransform(physx::PxIdentity);   // 射线：p = 起点
+        physx::PxVec3 direction = physx::PxVec3(0.0f);
+        float distance = 0.0f;
+        const physx::PxRigidActor* ignore = nullptr;
+        bool dynamicOnly = false;                                           // 重叠：跳过静态 actor
+    };
+
+    Handle Submit(const Request& request);
+    static void Run(const Request& request, Result& result);
+
+    std::mutex m_SubmitMutex;
+    std::vector<Request> m_Submitted;
+    Handle m_NextHandle = 1;
+    Handle m_SubmittedBase = 1;   // m_Submitted[0] 的句柄
+
+    std::vector<Request> m_Executing;
+    std::vector<Result> m_Results;
+    Handle m_ResultBase = 1;      // m_Results[0] 的句柄
+};
+
+} // namespace outer_wilds
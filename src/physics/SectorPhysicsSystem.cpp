@@ -6,19 +6,46 @@
 
 #include "SectorPhysicsSystem.h"
 #include "PhysXManager.h"
+#include "CoordinateSystem.h"
+#include "GravityKernel.h"
+#include "PhysicsEvents.h"
 #include "components/SectorComponent.h"
 #include "components/RigidBodyComponent.h"
 #include "components/GravitySourceComponent.h"
 #include "components/GravityAffectedComponent.h"
 #include "../scene/components/TransformComponent.h"
 #include "../gameplay/components/SpacecraftComponent.h"
+#include "../gameplay/components/CharacterControllerComponent.h"
+#include "../gameplay/components/PlayerComponent.h"
+#include "../gameplay/CharacterControllerBatch.h"
+#include "../core/ComponentGroups.h"
 #include "../core/DebugManager.h"
+#include "../core/JobSystem.h"
+#include "../core/Profiler.h"
+#include "../core/TimeManager.h"
+#include <algorithm>
+#include <cfloat>
 #include <cmath>
 
 namespace outer_wilds {
 
 using namespace components;
 
+namespace {
+    // 滞后系数：进入新扇区需要深入一定距离，退出当前扇区需要超出边界
+    constexpr float kEnterHysteresis = 0.92f;  // 进入阈值：需要深入到 influenceRadius * 0.92
+    constexpr float kExitHysteresis = 1.08f;   // 退出阈值：需要超出 influenceRadius * 1.08
+
+    // 扇区查询的时间相关性
+    constexpr float kSectorRequeryFraction = 0.05f;   // 移动超过当前扇区 influenceRadius 的 5% 才重新查询
+    constexpr float kSectorRequeryInterval = 0.25f;   // 其他扇区也在公转：最长 0.25 秒强制查询一次
+}
+
+SectorPhysicsSystem::~SectorPhysicsSystem() {
+    // Engine 销毁系统时不调用 Shutdown：监听者捕获了 this
+    PhysicsEventQueue::GetInstance().Unsubscribe(m_PhysicsEventSubscription);
+}
+
 void SectorPhysicsSystem::Initialize() {
     DebugManager::GetInstance().Log("SectorPhysicsSystem", "Initialized");
 }
@@ -26,6 +53,12 @@ void SectorPhysicsSystem::Initialize() {
 void SectorPhysicsSystem::Initialize(std::shared_ptr<Scene> scene) {
     m_Scene = scene;
     Initialize();
+    
+    // 着陆 / 离地由接触事件驱动（替代每帧向下射线）
+    m_PhysicsEventSubscription = PhysicsEventQueue::GetInstance().Subscribe(
+        PhysicsEventMask(PhysicsEvent::Type::ContactBegin) | PhysicsEventMask(PhysicsEvent::Type::ContactEnd) |
+        PhysicsEventMask(PhysicsEvent::Type::Sleep),
+        [this](entt::registry& registry, const PhysicsEvent& event) { OnPhysicsEvent(registry, event); });
 }
 
 void SectorPhysicsSystem::Update(float deltaTime, entt::registry& registry) {
@@ -34,6 +67,8 @@ void SectorPhysicsSystem::Update(float deltaTime, entt::registry& registry) {
 }
 
 void SectorPhysicsSystem::Shutdown() {
+    PhysicsEventQueue::GetInstance().Unsubscribe(m_PhysicsEventSubscription);
+    m_PhysicsEventSubscription = PhysicsEventQueue::kInvalidSubscription;
     DebugManager::GetInstance().Log("SectorPhysicsSystem", "Shutdown");
 }
 
@@ -42,7 +77,12 @@ void SectorPhysicsSystem::PrePhysicsUpdate(float deltaTime, entt::registry& regi
     CheckAndSwitchSectors(registry);
     
     // 1. 扇区碰撞体切换：必须在 simulate 之前执行！
-    UpdateSectorCollisions(registry);
+    //    扇区独立场景模式下改为：actor 换到所在扇区的场景，并安排本步模拟哪些场景
+    if (PhysXManager::GetInstance().IsPerSectorScenes()) {
+        UpdateSectorScenes(registry);
+    } else {
+        UpdateSectorCollisions(registry);
+    }
     
     // 2. 计算重力方向和强度
     CalculateGravity(registry);
@@ -82,77 +122,147 @@ void SectorPhysicsSystem::PostPhysicsUpdate(float deltaTime, entt::registry& reg
 }
 
 void SectorPhysicsSystem::CalculateGravity(entt::registry& registry) {
-    // 获取所有重力源
-    auto gravitySourceView = registry.view<GravitySourceComponent, TransformComponent>();
-    
-    // 获取所有受重力影响的实体
-    auto affectedView = registry.view<GravityAffectedComponent, TransformComponent>();
-    
+    // 1. 收集：扇区内实体（局部坐标，指向原点）、扇区外实体（世界坐标，找最近源）、
+    //    叠加模式实体（世界坐标，所有源求和）分成三批 SoA
+    m_SectorGravityBatch.Clear();
+    m_FreeGravityBatch.Clear();
+    m_SummedGravityBatch.Clear();
+    m_SectorGravityTargets.clear();
+    m_FreeGravityTargets.clear();
+    m_SummedGravityTargets.clear();
+
+    // owning group：GravityAffected 紧凑遍历，Transform 按实体查找
+    auto affectedView = ComponentGroups::GravityBodies(registry);
     for (auto entity : affectedView) {
         auto& affected = affectedView.get<GravityAffectedComponent>(entity);
-        auto& transform = affectedView.get<TransformComponent>(entity);
-        
         if (!affected.affectedByGravity) continue;
-        
-        // 获取实体位置（优先使用 InSectorComponent 的局部坐标）
-        DirectX::XMFLOAT3 entityPos = transform.position;
+
         auto* inSector = registry.try_get<InSectorComponent>(entity);
-        if (inSector && inSector->sector != entt::null) {
-            // 在扇区内：使用局部坐标计算到扇区中心（原点）的距离
-            entityPos = inSector->localPosition;
-            
-            // 重力指向原点
-            float dist = std::sqrt(entityPos.x * entityPos.x + 
-                                   entityPos.y * entityPos.y + 
-                                   entityPos.z * entityPos.z);
-            
-            if (dist > 0.01f) {
-                affected.currentGravityDir = {
-                    -entityPos.x / dist,
-                    -entityPos.y / dist,
-                    -entityPos.z / dist
-                };
+        if (inSector && inSector->hibernating) continue;
+        if (affected.mode == GravityAffectedComponent::Mode::Summed) {
+            // 世界坐标求和；扇区内的实体结果再转回扇区局部坐标系
+            DirectX::XMFLOAT3 worldPos = affectedView.get<TransformComponent>(entity).position;
+            entt::entity frameSector = entt::null;
+            if (inSector && inSector->sector != entt::null) {
+                if (auto* sector = registry.try_get<SectorComponent>(inSector->sector)) {
+                    worldPos = LocalToWorld(inSector->localPosition, sector->worldPosition, sector->worldRotation);
+                    frameSector = inSector->sector;
+                }
             }
-            
-            // 获取扇区对应的重力源
+            m_SummedGravityBatch.Push(worldPos.x, worldPos.y, worldPos.z);
+            m_SummedGravityTargets.push_back({ entity, frameSector });
+        } else if (inSector && inSector->sector != entt::null) {
+            const DirectX::XMFLOAT3& p = inSector->localPosition;
             auto* sectorGravity = registry.try_get<GravitySourceComponent>(inSector->sector);
-            if (sectorGravity && sectorGravity->isActive) {
-                affected.currentGravityStrength = sectorGravity->CalculateGravityStrength(dist);
-                affected.currentGravitySource = inSector->sector;
+            const bool hasSource = sectorGravity && sectorGravity->isActive;
+            if (hasSource) {
+                m_SectorGravityBatch.PushWithSource(p.x, p.y, p.z, sectorGravity->radius,
+                                                    sectorGravity->GetInfluenceRadius(),
+                                                    sectorGravity->surfaceGravity,
+                                                    sectorGravity->useRealisticGravity);
+            } else {
+                m_SectorGravityBatch.PushWithSource(p.x, p.y, p.z, 1.0f, 1.0f, 0.0f, false);
             }
+            m_SectorGravityTargets.push_back({ entity, hasSource ? inSector->sector : entt::null });
         } else {
-            // 不在扇区内：查找最近的重力源
-            float nearestDist = FLT_MAX;
-            entt::entity nearestSource = entt::null;
-            
-            for (auto sourceEntity : gravitySourceView) {
-                auto& source = gravitySourceView.get<GravitySourceComponent>(sourceEntity);
-                auto& sourceTransform = gravitySourceView.get<TransformComponent>(sourceEntity);
-                
-                if (!source.isActive) continue;
-                
-                float dx = entityPos.x - sourceTransform.position.x;
-                float dy = entityPos.y - sourceTransform.position.y;
-                float dz = entityPos.z - sourceTransform.position.z;
-                float dist = std::sqrt(dx*dx + dy*dy + dz*dz);
-                
-                if (dist < nearestDist && dist < source.GetInfluenceRadius()) {
-                    nearestDist = dist;
-                    nearestSource = sourceEntity;
-                    
-                    if (dist > 0.01f) {
-                        affected.currentGravityDir = { -dx/dist, -dy/dist, -dz/dist };
-                    }
-                    affected.currentGravityStrength = source.CalculateGravityStrength(dist);
-                }
-            }
-            affected.currentGravitySource = nearestSource;
+            const DirectX::XMFLOAT3& p = affectedView.get<TransformComponent>(entity).position;
+            m_FreeGravityBatch.Push(p.x, p.y, p.z);
+            m_FreeGravityTargets.push_back({ entity, entt::null });
+        }
+    }
+
+    // 2. 计算（4 路 SIMD）
+    if (!m_SectorGravityTargets.empty()) {
+        m_SectorGravityBatch.Finalize();
+        EvaluateSectorGravity(m_SectorGravityBatch);
+    }
+
+    if (!m_FreeGravityTargets.empty() || !m_SummedGravityTargets.empty()) {
+        m_GravitySources.Clear();
+        m_GravitySourceEntities.clear();
+        auto gravitySourceView = registry.view<GravitySourceComponent, TransformComponent>();
+        for (auto sourceEntity : gravitySourceView) {
+            auto& source = gravitySourceView.get<GravitySourceComponent>(sourceEntity);
+            if (!source.isActive) continue;
+            const DirectX::XMFLOAT3& p = gravitySourceView.get<TransformComponent>(sourceEntity).position;
+            m_GravitySources.Push(p.x, p.y, p.z, source.radius, source.GetInfluenceRadius(),
+                                  source.surfaceGravity, source.useRealisticGravity);
+            m_GravitySourceEntities.push_back(sourceEntity);
+        }
+    }
+
+    if (!m_FreeGravityTargets.empty()) {
+        m_FreeGravityBatch.Finalize();
+        EvaluateNearestSourceGravity(m_FreeGravityBatch, m_GravitySources);
+    }
+
+    if (!m_SummedGravityTargets.empty()) {
+        m_SummedGravityBatch.Finalize();
+        if (m_GravitySources.Size() >= m_BarnesHutThreshold) {
+            // 源很多时用八叉树近似，实体分块在 JobSystem 上并行
+            PROFILE_SCOPE("GravityBarnesHut");
+            m_GravityOctree.Build(m_GravitySources);
+            JobSystem::GetInstance().ParallelFor(m_SummedGravityBatch.Size(), 256,
+                [this](uint32_t begin, uint32_t end) {
+                    m_GravityOctree.Evaluate(m_SummedGravityBatch, m_GravitySources, m_BarnesHutTheta, begin, end);
+                });
+        } else {
+            EvaluateSummedGravity(m_SummedGravityBatch, m_GravitySources);
         }
     }
+
+    // 3. 写回：距离 <= 0.01 时保留原方向；没有有效源时保留原强度
+    for (size_t i = 0; i < m_SectorGravityTargets.size(); i++) {
+        const GravityTarget& target = m_SectorGravityTargets[i];
+        auto& affected = registry.get<GravityAffectedComponent>(target.entity);
+        if (m_SectorGravityBatch.distance[i] > 0.01f) {
+            affected.currentGravityDir = { m_SectorGravityBatch.dirX[i], m_SectorGravityBatch.dirY[i],
+                                           m_SectorGravityBatch.dirZ[i] };
+        }
+        if (target.source != entt::null) {
+            affected.currentGravityStrength = m_SectorGravityBatch.strength[i];
+            affected.currentGravitySource = target.source;
+        }
+    }
+
+    for (size_t i = 0; i < m_FreeGravityTargets.size(); i++) {
+        auto& affected = registry.get<GravityAffectedComponent>(m_FreeGravityTargets[i].entity);
+        const int32_t sourceIndex = m_FreeGravityBatch.sourceIndex[i];
+        if (sourceIndex < 0) {
+            affected.currentGravitySource = entt::null;
+            continue;
+        }
+        if (m_FreeGravityBatch.distance[i] > 0.01f) {
+            affected.currentGravityDir = { m_FreeGravityBatch.dirX[i], m_FreeGravityBatch.dirY[i],
+                                           m_FreeGravityBatch.dirZ[i] };
+        }
+        affected.currentGravityStrength = m_FreeGravityBatch.strength[i];
+        affected.currentGravitySource = m_GravitySourceEntities[sourceIndex];
+    }
+
+    for (size_t i = 0; i < m_SummedGravityTargets.size(); i++) {
+        const GravityTarget& target = m_SummedGravityTargets[i];
+        auto& affected = registry.get<GravityAffectedComponent>(target.entity);
+        const int32_t sourceIndex = m_SummedGravityBatch.sourceIndex[i];
+        affected.currentGravityStrength = m_SummedGravityBatch.strength[i];
+        affected.currentGravitySource = sourceIndex >= 0 ? m_GravitySourceEntities[sourceIndex] : entt::null;
+        if (affected.currentGravityStrength <= 1e-6f) continue;
+
+        DirectX::XMVECTOR dir = DirectX::XMVectorSet(m_SummedGravityBatch.dirX[i], m_SummedGravityBatch.dirY[i],
+                                                     m_SummedGravityBatch.dirZ[i], 0.0f);
+        if (target.source != entt::null) {
+            // PhysX actor 在扇区局部坐标系中，力的方向也要转过去
+            auto& sector = registry.get<SectorComponent>(target.source);
+            dir = DirectX::XMVector3InverseRotate(dir, DirectX::XMLoadFloat4(&sector.worldRotation));
+        }
+        DirectX::XMStoreFloat3(&affected.currentGravityDir, dir);
+    }
 }
 
 void SectorPhysicsSystem::ApplyGravityForces(entt::registry& registry) {
     auto view = registry.view<GravityAffectedComponent, RigidBodyComponent>();
+    auto& physxManager = PhysXManager::GetInstance();
+    const bool perSectorScenes = physxManager.IsPerSectorScenes();
     
     for (auto entity : view) {
         auto& affected = view.get<GravityAffectedComponent>(entity);
@@ -165,6 +275,12 @@ void SectorPhysicsSystem::ApplyGravityForces(entt::registry& registry) {
         auto* dynamicActor = rigidBody.physxActor->is<physx::PxRigidDynamic>();
         if (!dynamicActor) continue;
         
+        // 休眠扇区的刚体禁用了模拟，不能加力
+        if (dynamicActor->getActorFlags() & physx::PxActorFlag::eDISABLE_SIMULATION) continue;
+        
+        // 本步不模拟的场景不加力（力会一直累积到下一次 simulate）
+        if (perSectorScenes && !physxManager.IsSceneScheduled(dynamicActor->getScene())) continue;
+        
         // 计算重力力 = 质量 * 重力加速度 * 方向
         float mass = rigidBody.mass;
         float strength = affected.currentGravityStrength * affected.gravityScale;
@@ -194,7 +310,7 @@ void SectorPhysicsSystem::ApplyGravityForces(entt::registry& registry) {
 }
 
 void SectorPhysicsSystem::SyncKinematicToPhysX(entt::registry& registry) {
-    auto view = registry.view<RigidBodyComponent, InSectorComponent>();
+    auto view = ComponentGroups::RigidBodies(registry);
     
     for (auto entity : view) {
         auto& rigidBody = view.get<RigidBodyComponent>(entity);
@@ -203,6 +319,7 @@ void SectorPhysicsSystem::SyncKinematicToPhysX(entt::registry& registry) {
         if (!rigidBody.isKinematic) continue;
         if (!rigidBody.physxActor) continue;
         if (!inSector.needsSync) continue;
+        if (inSector.hibernating) continue;   // 唤醒后再同步
         
         // [来源: SectorPhysicsSystem] 同步 Kinematic 到 PhysX
         physx::PxTransform pose(
@@ -216,34 +333,47 @@ void SectorPhysicsSystem::SyncKinematicToPhysX(entt::registry& registry) {
 }
 
 void SectorPhysicsSystem::SyncDynamicFromPhysX(entt::registry& registry) {
-    auto view = registry.view<RigidBodyComponent, InSectorComponent, TransformComponent>();
-    
-    for (auto entity : view) {
-        auto& rigidBody = view.get<RigidBodyComponent>(entity);
-        auto& inSector = view.get<InSectorComponent>(entity);
-        auto& transform = view.get<TransformComponent>(entity);
-        
-        if (rigidBody.isKinematic) continue;
-        if (!rigidBody.physxActor) continue;
-        
-        // 读取 PhysX 位置（局部坐标）
-        physx::PxTransform pose = rigidBody.physxActor->getGlobalPose();
-        inSector.localPosition = { pose.p.x, pose.p.y, pose.p.z };
-        inSector.localRotation = { pose.q.x, pose.q.y, pose.q.z, pose.q.w };
-        
-        // 转换到世界坐标
-        if (inSector.sector != entt::null) {
-            auto* sector = registry.try_get<SectorComponent>(inSector.sector);
-            if (sector) {
-                transform.position = LocalToWorld(inSector.localPosition, 
-                                                   sector->worldPosition, 
-                                                   sector->worldRotation);
-                // 组合旋转：实体局部旋转 + 扇区世界旋转
-                transform.rotation = CombineRotations(inSector.localRotation, sector->worldRotation);
-            }
+    // 只处理本步位姿发生变化的 actor（eENABLE_ACTIVE_ACTORS），睡眠的刚体不产生任何开销
+    m_AwakeScratch.clear();
+    for (physx::PxScene* scene : PhysXManager::GetInstance().GetSteppedScenes()) {
+        physx::PxU32 activeCount = 0;
+        physx::PxActor** activeActors = scene->getActiveActors(activeCount);
+        for (physx::PxU32 i = 0; i < activeCount; i++) {
+            entt::entity entity = FromActorUserData(activeActors[i]->userData);
+            if (entity == entt::null || !registry.valid(entity)) continue;
+
+            auto* rigidBody = registry.try_get<RigidBodyComponent>(entity);
+            auto* inSector = registry.try_get<InSectorComponent>(entity);
+            auto* transform = registry.try_get<TransformComponent>(entity);
+            if (!rigidBody || !inSector || !transform) continue;
+            if (rigidBody->isKinematic || rigidBody->physxActor != activeActors[i]) continue;
+
+            auto* dynamicActor = activeActors[i]->is<physx::PxRigidDynamic>();
+            if (!dynamicActor) continue;
+
+            // 读取 PhysX 位置（局部坐标）；上一步的位姿留给渲染插值
+            physx::PxTransform pose = dynamicActor->getGlobalPose();
+            DirectX::XMFLOAT3 newPosition = { pose.p.x, pose.p.y, pose.p.z };
+            DirectX::XMFLOAT4 newRotation = { pose.q.x, pose.q.y, pose.q.z, pose.q.w };
+            inSector->previousLocalPosition = inSector->interpolatePose ? inSector->localPosition : newPosition;
+            inSector->previousLocalRotation = inSector->interpolatePose ? inSector->localRotation : newRotation;
+            inSector->interpolatePose = true;
+            inSector->localPosition = newPosition;
+            inSector->localRotation = newRotation;
+            m_AwakeScratch.push_back(entity);
         }
     }
-    
+
+    // 上一步还在动、这一步睡着了的刚体：位姿不再变化，停止插值，否则会在两步之间来回抖
+    std::sort(m_AwakeScratch.begin(), m_AwakeScratch.end());
+    for (entt::entity entity : m_AwakeEntities) {
+        if (std::binary_search(m_AwakeScratch.begin(), m_AwakeScratch.end(), entity)) continue;
+        if (auto* inSector = registry.try_get<InSectorComponent>(entity)) {
+            inSector->interpolatePose = false;
+        }
+    }
+    m_AwakeEntities.swap(m_AwakeScratch);
+
     // 同步所有扇区内实体的世界坐标
     SyncSectorEntities(registry);
 }
@@ -251,35 +381,90 @@ void SectorPhysicsSystem::SyncDynamicFromPhysX(entt::registry& registry) {
 void SectorPhysicsSystem::SyncSectorEntities(entt::registry& registry) {
     // 对于所有在扇区内的实体，更新它们的世界坐标
     // 这确保当扇区（星球）移动时，扇区内的所有实体跟随移动
-    auto view = registry.view<InSectorComponent, TransformComponent>();
-    
-    static int syncDebugFrame = 0;
-    syncDebugFrame++;
-    
-    // Debug: 第一帧详细输出
-    static bool firstSyncFrame = true;
-    
+    // 休眠扇区由 InterpolateTransforms 低频更新
+    PropagateSectorTransforms(registry, false, 0.0f, false);
+}
+
+void SectorPhysicsSystem::InterpolateTransforms(float alpha, entt::registry& registry) {
+    // 与 SyncSectorEntities 相同，但每帧都执行（没有物理步的帧里扇区仍在公转）
+    PropagateSectorTransforms(registry, true, alpha, m_SyncHibernatedThisFrame);
+}
+
+void SectorPhysicsSystem::PropagateSectorTransforms(entt::registry& registry, bool interpolate, float alpha,
+                                                    bool includeHibernated) {
+    using namespace DirectX;
+    auto view = ComponentGroups::SectorResidents(registry);
+    constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    // 1. 收集居民并按扇区计数：SectorComponent 每个扇区只查一次（按实体下标直接映射到槽位）
+    m_PropagationSectors.clear();
+    m_PropagationResidents.clear();
     for (auto entity : view) {
-        auto& inSector = view.get<InSectorComponent>(entity);
-        auto& transform = view.get<TransformComponent>(entity);
-        
+        const auto& inSector = view.get<InSectorComponent>(entity);
         if (inSector.sector == entt::null) continue;
-        
-        auto* sector = registry.try_get<SectorComponent>(inSector.sector);
-        if (!sector) continue;
-        
-       
-        // 使用扇区的世界位置和旋转来计算实体的世界坐标
-        transform.position = LocalToWorld(inSector.localPosition, 
-                                           sector->worldPosition, 
-                                           sector->worldRotation);
-        transform.rotation = CombineRotations(inSector.localRotation, sector->worldRotation);
-        
-        
-    
+        if (inSector.hibernating && !includeHibernated) continue;
+
+        const auto sectorIndex = static_cast<size_t>(entt::to_entity(inSector.sector));
+        if (sectorIndex >= m_PropagationSectorSlots.size()) {
+            m_PropagationSectorSlots.resize(sectorIndex + 1, kNoSlot);
+        }
+        uint32_t& slot = m_PropagationSectorSlots[sectorIndex];
+        if (slot == kNoSlot) {
+            const auto* sector = registry.try_get<SectorComponent>(inSector.sector);
+            if (!sector) continue;
+            slot = static_cast<uint32_t>(m_PropagationSectors.size());
+            m_PropagationSectors.push_back({ inSector.sector, sector->worldPosition, sector->worldRotation, 0, 0 });
+        } else if (m_PropagationSectors[slot].entity != inSector.sector) {
+            continue;   // 引用了已销毁扇区（下标被新实体复用、版本不同）
+        }
+        m_PropagationSectors[slot].count++;
+        m_PropagationResidents.push_back({ &inSector, &view.get<TransformComponent>(entity), slot });
+    }
+
+    // 2. 按扇区连续放置局部位姿（插值在这里完成），记录写回目标；槽位映射复位供下次使用
+    uint32_t offset = 0;
+    for (auto& sector : m_PropagationSectors) {
+        m_PropagationSectorSlots[static_cast<size_t>(entt::to_entity(sector.entity))] = kNoSlot;
+        sector.begin = offset;
+        offset += sector.count;
+        sector.count = 0;
+    }
+    m_PropagationTargets.resize(offset);
+    m_PropagationPositions.resize(offset);
+    m_PropagationRotations.resize(offset);
+
+    for (const auto& resident : m_PropagationResidents) {
+        auto& sector = m_PropagationSectors[resident.sector];
+        const uint32_t index = sector.begin + sector.count++;
+        const InSectorComponent& inSector = *resident.inSector;
+        if (interpolate && inSector.interpolatePose) {
+            XMStoreFloat3(&m_PropagationPositions[index],
+                          XMVectorLerp(XMLoadFloat3(&inSector.previousLocalPosition),
+                                       XMLoadFloat3(&inSector.localPosition), alpha));
+            XMStoreFloat4(&m_PropagationRotations[index],
+                          XMQuaternionSlerp(XMLoadFloat4(&inSector.previousLocalRotation),
+                                            XMLoadFloat4(&inSector.localRotation), alpha));
+        } else {
+            m_PropagationPositions[index] = inSector.localPosition;
+            m_PropagationRotations[index] = inSector.localRotation;
+        }
+        m_PropagationTargets[index] = resident.transform;
+    }
+
+    // 3. 每个扇区一次批量变换（原地：局部 → 世界）
+    for (const auto& sector : m_PropagationSectors) {
+        CoordinateSystem::SectorLocalToWorld(sector.position, sector.rotation,
+                                             &m_PropagationPositions[sector.begin],
+                                             &m_PropagationRotations[sector.begin],
+                                             &m_PropagationPositions[sector.begin],
+                                             &m_PropagationRotations[sector.begin], sector.count);
+    }
+
+    // 4. 写回 TransformComponent
+    for (uint32_t i = 0; i < offset; i++) {
+        m_PropagationTargets[i]->position = m_PropagationPositions[i];
+        m_PropagationTargets[i]->rotation = m_PropagationRotations[i];
     }
-    
-    firstSyncFrame = false;
 }
 
 void SectorPhysicsSystem::TransferEntityToSector(entt::registry& registry, entt::entity entity, entt::entity newSector) {
@@ -308,6 +493,7 @@ void SectorPhysicsSystem::TransferEntityToSector(entt::registry& registry, entt:
     inSector->sector = newSector;
     inSector->needsSync = true;
     inSector->isInitialized = true;
+    inSector->interpolatePose = false;
     
     DebugManager::GetInstance().Log("SectorPhysicsSystem", "Entity transferred to new sector");
 }
@@ -429,8 +615,6 @@ void SectorPhysicsSystem::PrintPhysicsDebugInfo(entt::registry& registry) {
 }
 
 void SectorPhysicsSystem::StabilizeSpacecraft(entt::registry& registry) {
-    const float PLANET_RADIUS = 64.0f;  // 星球半径
-    const float GROUND_THRESHOLD = 1.0f; // 距离地面阈值
     const float VELOCITY_THRESHOLD = 0.5f;  // 速度阈值
     const float ANGULAR_VELOCITY_THRESHOLD = 0.3f;  // 角速度阈值
     
@@ -443,20 +627,15 @@ void SectorPhysicsSystem::StabilizeSpacecraft(entt::registry& registry) {
         
         // 只处理IDLE状态的飞船
         if (spacecraft.currentState != SpacecraftComponent::State::IDLE) continue;
+        if (inSector.hibernating) continue;
         if (!rigidBody.physxActor) continue;
         
         auto* dynamicActor = rigidBody.physxActor->is<physx::PxRigidDynamic>();
         if (!dynamicActor) continue;
         
-        // 计算到原点的距离
-        float dist = std::sqrt(
-            inSector.localPosition.x * inSector.localPosition.x +
-            inSector.localPosition.y * inSector.localPosition.y +
-            inSector.localPosition.z * inSector.localPosition.z
-        );
-        
-        // 计算到地面的距离
-        float groundDist = dist - PLANET_RADIUS;
+        // 接地：OnPhysicsEvent 按 ContactBegin / ContactEnd 记录的地面接触，只认当前扇区的地面
+        const bool touchingGround = spacecraft.groundContact != entt::null &&
+                                    spacecraft.groundContact == inSector.sector;
         
         // 获取当前速度
         physx::PxVec3 linearVel = dynamicActor->getLinearVelocity();
@@ -464,8 +643,8 @@ void SectorPhysicsSystem::StabilizeSpacecraft(entt::registry& registry) {
         float speed = linearVel.magnitude();
         float angularSpeed = angularVel.magnitude();
         
-        // 如果飞船接近地面且速度低，让它稳定下来
-        if (groundDist < GROUND_THRESHOLD) {
+        // 如果飞船接触地面且速度低，让它稳定下来
+        if (touchingGround) {
             // 强制降低角速度
             if (angularSpeed > ANGULAR_VELOCITY_THRESHOLD) {
                 dynamicActor->setAngularVelocity(angularVel * 0.8f);  // 快速衰减
@@ -477,14 +656,43 @@ void SectorPhysicsSystem::StabilizeSpacecraft(entt::registry& registry) {
                 dynamicActor->setLinearVelocity(physx::PxVec3(0.0f));
                 dynamicActor->setAngularVelocity(physx::PxVec3(0.0f));
                 
-                // 让飞船进入sleep状态
+                // 让飞船进入sleep状态（isGrounded 由下一步上报的 Sleep 事件设置）
                 if (!dynamicActor->isSleeping()) {
                     dynamicActor->putToSleep();
-                    spacecraft.isGrounded = true;
                 }
             }
-        } else {
-            spacecraft.isGrounded = false;
+        }
+    }
+}
+
+void SectorPhysicsSystem::OnPhysicsEvent(entt::registry& registry, const PhysicsEvent& event) {
+    if (event.type == PhysicsEvent::Type::Sleep) {
+        auto* spacecraft = registry.try_get<SpacecraftComponent>(event.entity);
+        auto* inSector = registry.try_get<InSectorComponent>(event.entity);
+        if (spacecraft && inSector) {
+            spacecraft->isGrounded = spacecraft->groundContact != entt::null &&
+                                     spacecraft->groundContact == inSector->sector;
+        }
+        return;
+    }
+    
+    // 接触对两边的实体各处理一次：只关心与扇区地面（天体）的接触
+    const bool began = event.type == PhysicsEvent::Type::ContactBegin;
+    const entt::entity sides[2] = { event.entity, event.other };
+    for (int side = 0; side < 2; side++) {
+        const entt::entity self = sides[side];
+        const entt::entity ground = sides[1 - side];
+        if (self == entt::null || ground == entt::null) continue;
+        if (!registry.valid(self) || !registry.valid(ground)) continue;
+        if (!registry.all_of<SectorComponent>(ground)) continue;
+        
+        if (auto* spacecraft = registry.try_get<SpacecraftComponent>(self)) {
+            if (began) {
+                spacecraft->groundContact = ground;
+            } else if (spacecraft->groundContact == ground) {
+                spacecraft->groundContact = entt::null;
+                spacecraft->isGrounded = false;
+            }
         }
     }
 }
@@ -550,10 +758,136 @@ void SectorPhysicsSystem::UpdateSectorCollisions(entt::registry& registry) {
         SetSectorCollisionEnabled(registry, targetSector, true);
     }
     
+    // MBP 宽相位区域覆盖新激活扇区的范围（PhysX 坐标以扇区中心为原点）
+    if (newSectorComp) {
+        PhysXManager::GetInstance().SetBroadPhaseRegions(PhysXManager::GetInstance().GetScene(),
+                                                         newSectorComp->influenceRadius * kExitHysteresis);
+    }
+    
     // 更新当前激活的扇区
     m_ActiveCollisionSector = targetSector;
 }
 
+void SectorPhysicsSystem::UpdateSectorScenes(entt::registry& registry) {
+    auto& physxManager = PhysXManager::GetInstance();
+    
+    // 1. 懒创建扇区场景；地面碰撞体移入自己的场景并常开
+    auto sectorView = registry.view<SectorComponent>();
+    for (auto sectorEntity : sectorView) {
+        auto& sector = sectorView.get<SectorComponent>(sectorEntity);
+        sector.occupantCount = 0;
+        sector.awakeOccupantCount = 0;
+        if (sector.physxScene) continue;
+        
+        sector.physxScene = physxManager.CreateSectorScene();
+        if (!sector.physxScene) continue;
+        physxManager.SetBroadPhaseRegions(sector.physxScene, sector.influenceRadius * kExitHysteresis);
+        if (sector.physxGround) {
+            if (physx::PxScene* oldScene = sector.physxGround->getScene()) {
+                oldScene->removeActor(*sector.physxGround);
+            }
+            sector.physxScene->addActor(*sector.physxGround);
+            SetSectorCollisionEnabled(registry, sectorEntity, true);
+        }
+    }
+    
+    // 2. 刚体/角色控制器跟随所在扇区换场景，同时统计每个扇区的占用情况
+    auto view = registry.view<InSectorComponent>();
+    for (auto entity : view) {
+        auto& inSector = view.get<InSectorComponent>(entity);
+        if (inSector.sector == entt::null) continue;
+        auto* sector = registry.try_get<SectorComponent>(inSector.sector);
+        if (!sector || !sector->physxScene) continue;
+        
+        if (auto* rigidBody = registry.try_get<RigidBodyComponent>(entity); rigidBody && rigidBody->physxActor) {
+            physx::PxRigidActor* actor = rigidBody->physxActor;
+            if (actor->getScene() != sector->physxScene) {
+                // [来源: SectorPhysicsSystem] actor 换到新扇区的场景（位姿/速度保留）
+                if (physx::PxScene* oldScene = actor->getScene()) {
+                    oldScene->removeActor(*actor);
+                }
+                sector->physxScene->addActor(*actor);
+                if (auto* dynamicActor = actor->is<physx::PxRigidDynamic>(); dynamicActor && !rigidBody->isKinematic) {
+                    dynamicActor->wakeUp();
+                }
+            }
+            if (auto* dynamicActor = actor->is<physx::PxRigidDynamic>()) {
+                sector->occupantCount++;
+                if (!rigidBody->isKinematic && !dynamicActor->isSleeping()) {
+                    sector->awakeOccupantCount++;
+                }
+            }
+        }
+        
+        if (auto* character = registry.try_get<CharacterControllerComponent>(entity); character && character->pxController) {
+            if (character->pxController->getScene() != sector->physxScene) {
+                RecreateControllerInScene(entity, character->pxController, sector->physxScene, inSector.localPosition);
+            }
+            // 角色每步都要 move，所在扇区总是全速模拟
+            sector->occupantCount++;
+            sector->awakeOccupantCount++;
+        }
+    }
+    
+    // 3. 有活动物体的扇区全速模拟；全部睡眠的低频模拟；没有物体的冻结
+    const float fixedStep = physxManager.GetFixedTimeStep();
+    for (auto sectorEntity : sectorView) {
+        auto& sector = sectorView.get<SectorComponent>(sectorEntity);
+        if (!sector.physxScene || sector.hibernating) continue;
+        
+        if (sector.awakeOccupantCount > 0) {
+            sector.idleStepCounter = 0;
+            physxManager.ScheduleSectorScene(sector.physxScene, fixedStep);
+        } else if (sector.occupantCount > 0 && m_IdleSectorStepInterval > 0) {
+            if (++sector.idleStepCounter >= m_IdleSectorStepInterval) {
+                sector.idleStepCounter = 0;
+                physxManager.ScheduleSectorScene(sector.physxScene, fixedStep * static_cast<float>(m_IdleSectorStepInterval));
+            }
+        }
+    }
+}
+
+/**
+ * CCT 不能在场景之间移动：按原参数在新场景的控制器管理器里重建
+ */
+void SectorPhysicsSystem::RecreateControllerInScene(entt::entity entity, physx::PxController*& controller,
+                                                    physx::PxScene* scene, const DirectX::XMFLOAT3& localPosition) {
+    physx::PxControllerManager* manager = PhysXManager::GetInstance().GetControllerManager(scene);
+    if (!manager || controller->getType() != physx::PxControllerShapeType::eCAPSULE) return;
+    
+    auto* capsule = static_cast<physx::PxCapsuleController*>(controller);
+    physx::PxCapsuleControllerDesc desc;
+    desc.height = capsule->getHeight();
+    desc.radius = capsule->getRadius();
+    desc.climbingMode = capsule->getClimbingMode();
+    desc.slopeLimit = capsule->getSlopeLimit();
+    desc.stepOffset = capsule->getStepOffset();
+    desc.contactOffset = capsule->getContactOffset();
+    desc.upDirection = capsule->getUpDirection();
+    desc.nonWalkableMode = capsule->getNonWalkableMode();
+    desc.userData = capsule->getUserData();
+    desc.reportCallback = CharacterControllerBatch::GetHitReport();
+    desc.position = physx::PxExtendedVec3(localPosition.x, localPosition.y, localPosition.z);
+    
+    physx::PxShape* shape = nullptr;
+    if (capsule->getActor()->getShapes(&shape, 1) == 1) {
+        physx::PxMaterial* material = nullptr;
+        if (shape->getMaterials(&material, 1) == 1) desc.material = material;
+    }
+    if (!desc.material) desc.material = PhysXManager::GetInstance().GetDefaultMaterial();
+    
+    physx::PxController* newController = manager->createController(desc);
+    if (!newController) {
+        DebugManager::GetInstance().Log("SectorPhysics", "Failed to recreate character controller in sector scene");
+        return;
+    }
+    controller->release();
+    controller = newController;
+    
+    DebugManager::GetInstance().Log("SectorPhysics", "Entity " + std::to_string(static_cast<uint32_t>(entity)) +
+                                    " character controller moved to sector scene");
+}
+
 void SectorPhysicsSystem::SetSectorCollisionEnabled(entt::registry& registry, entt::entity sector, bool enabled) {
     auto* sectorComp = registry.try_get<SectorComponent>(sector);
     if (!sectorComp) return;
@@ -575,43 +909,39 @@ void SectorPhysicsSystem::SetSectorCollisionEnabled(entt::registry& registry, en
 
 void SectorPhysicsSystem::CheckAndSwitchSectors(entt::registry& registry) {
     // 检查所有带 InSectorComponent 的实体，根据世界坐标判断是否需要切换扇区
-    auto view = registry.view<InSectorComponent, TransformComponent>();
-    auto sectorView = registry.view<SectorComponent>();
+    auto view = ComponentGroups::SectorResidents(registry);
     
-    // 滞后系数：进入新扇区需要深入一定距离，退出当前扇区需要超出边界
-    constexpr float ENTER_HYSTERESIS = 0.92f;  // 进入阈值：需要深入到 influenceRadius * 0.92
-    constexpr float EXIT_HYSTERESIS = 1.08f;   // 退出阈值：需要超出 influenceRadius * 1.08
+    // 每个固定步调用一次
+    const float deltaTime = PhysXManager::GetInstance().GetFixedTimeStep();
     
-    // deltaTime 估计（用于冷却时间）
-    constexpr float deltaTime = 1.0f / 60.0f;
+    if (m_SectorIndex.GetSectorCount() == 0) {
+        RebuildSectorIndex(registry);
+    }
     
     for (auto entity : view) {
         auto& inSector = view.get<InSectorComponent>(entity);
         auto& transform = view.get<TransformComponent>(entity);
+        if (inSector.hibernating) continue;
         
         // 更新冷却时间
+        bool cooldownExpired = false;
         if (inSector.switchCooldown > 0.0f) {
             inSector.switchCooldown -= deltaTime;
             if (inSector.switchCooldown > 0.0f) {
                 continue;  // 还在冷却中，跳过
             }
+            cooldownExpired = true;
         }
+        inSector.timeSinceSectorQuery += deltaTime;
         
-        // 从 PhysX 获取实际位置
+        // 动态刚体的局部位置已由 SyncDynamicFromPhysX 按活跃 actor 回读，睡眠的刚体位置不变
         DirectX::XMFLOAT3 actualLocalPos = inSector.localPosition;
-        auto* rigidBody = registry.try_get<RigidBodyComponent>(entity);
-        if (rigidBody && rigidBody->physxActor) {
-            auto* dynamicActor = rigidBody->physxActor->is<physx::PxRigidDynamic>();
-            if (dynamicActor) {
-                physx::PxTransform pose = dynamicActor->getGlobalPose();
-                actualLocalPos = { pose.p.x, pose.p.y, pose.p.z };
-            }
-        }
         
         // 计算世界坐标
         DirectX::XMFLOAT3 worldPos = transform.position;
+        const SectorComponent* currentSector = nullptr;
         if (inSector.sector != entt::null) {
-            auto* currentSector = registry.try_get<SectorComponent>(inSector.sector);
+            currentSector = registry.try_get<SectorComponent>(inSector.sector);
             if (currentSector) {
                 worldPos = LocalToWorld(actualLocalPos, 
                                         currentSector->worldPosition, 
@@ -619,9 +949,22 @@ void SectorPhysicsSystem::CheckAndSwitchSectors(entt::registry& registry) {
             }
         }
         
+        // 时间相关性：位置变化不大且未到查询间隔时沿用当前扇区
+        if (inSector.hasSectorQuery && currentSector && !cooldownExpired &&
+            inSector.timeSinceSectorQuery < kSectorRequeryInterval) {
+            const float dx = worldPos.x - inSector.lastSectorQueryPosition.x;
+            const float dy = worldPos.y - inSector.lastSectorQueryPosition.y;
+            const float dz = worldPos.z - inSector.lastSectorQueryPosition.z;
+            const float requeryDistance = currentSector->influenceRadius * kSectorRequeryFraction;
+            if (dx * dx + dy * dy + dz * dz < requeryDistance * requeryDistance) continue;
+        }
+        inSector.lastSectorQueryPosition = worldPos;
+        inSector.timeSinceSectorQuery = 0.0f;
+        inSector.hasSectorQuery = true;
+        
         // 找到当前实体应该在的最佳扇区（带滞后机制）
         entt::entity bestSector = FindBestSectorForEntity(registry, worldPos, inSector.sector, 
-                                                           ENTER_HYSTERESIS, EXIT_HYSTERESIS);
+                                                           kEnterHysteresis, kExitHysteresis);
         
         // 如果找不到合适的扇区，保持当前扇区
         if (bestSector == entt::null) continue;
@@ -669,23 +1012,13 @@ entt::entity SectorPhysicsSystem::FindBestSectorForEntity(entt::registry& regist
     int bestPriority = -999999;
     float bestDistance = FLT_MAX;
     
-    auto sectorView = registry.view<SectorComponent>();
-    
-    for (auto sectorEntity : sectorView) {
-        auto& sector = sectorView.get<SectorComponent>(sectorEntity);
-        if (!sector.isActive) continue;
-        
-        // 计算实体到扇区中心的距离
-        float dx = worldPos.x - sector.worldPosition.x;
-        float dy = worldPos.y - sector.worldPosition.y;
-        float dz = worldPos.z - sector.worldPosition.z;
-        float distance = std::sqrt(dx*dx + dy*dy + dz*dz);
-        
+    // 空间索引按最大滞后系数建包围球，只返回可能包含该点的扇区
+    m_SectorIndex.Query(worldPos, [&](const SectorSpatialIndex::Item& sector, float distance) {
         // 滞后机制：
         // - 对于当前扇区：使用宽松的退出阈值（更难离开）
         // - 对于其他扇区：使用严格的进入阈值（更难进入）
         float threshold;
-        if (sectorEntity == currentSector) {
+        if (sector.sector == currentSector) {
             threshold = sector.influenceRadius * exitHysteresis;  // 退出阈值更大
         } else {
             threshold = sector.influenceRadius * enterHysteresis; // 进入阈值更小
@@ -699,16 +1032,143 @@ entt::entity SectorPhysicsSystem::FindBestSectorForEntity(entt::registry& regist
                 (sector.priority == bestPriority && distance < bestDistance)) {
                 bestPriority = sector.priority;
                 bestDistance = distance;
-                bestSector = sectorEntity;
+                bestSector = sector.sector;
             }
         }
-    }
+    });
     
     return bestSector;
 }
 
+void SectorPhysicsSystem::UpdateTimeWarp(entt::registry& registry) {
+    m_TimeWarp = TimeManager::GetInstance().GetTimeWarp();
+    const bool onRails = m_TimeWarp > m_MaxSubsteppedWarp;
+    if (onRails == m_OnRails) return;
+    m_OnRails = onRails;
+    
+    // 进入：所有扇区休眠（保存速度）；退出：全部唤醒，随后 UpdateHibernation 再按距离休眠远处扇区
+    auto sectorView = registry.view<SectorComponent>();
+    for (auto sectorEntity : sectorView) {
+        if (sectorView.get<SectorComponent>(sectorEntity).hibernating != onRails) {
+            SetSectorHibernating(registry, sectorEntity, onRails);
+        }
+    }
+    
+    DebugManager::GetInstance().Log("SectorPhysics", onRails
+        ? "Time warp x" + std::to_string(static_cast<int>(m_TimeWarp)) + ": on rails, PhysX suspended"
+        : std::string("Time warp: PhysX resumed"));
+}
+
+void SectorPhysicsSystem::UpdateHibernation(entt::registry& registry) {
+    m_SyncHibernatedThisFrame = (++m_HibernatedSyncCounter >= m_HibernatedSyncInterval);
+    if (m_SyncHibernatedThisFrame) m_HibernatedSyncCounter = 0;
+    
+    // 轨道模式：所有扇区都休眠，玩家也在其中，所以每帧都要更新世界坐标
+    if (m_OnRails) {
+        m_SyncHibernatedThisFrame = true;
+        return;
+    }
+    
+    // 关注点：玩家和驾驶中的飞船（世界坐标）
+    m_HibernationFocus.clear();
+    auto playerView = registry.view<PlayerComponent, TransformComponent>();
+    for (auto entity : playerView) {
+        m_HibernationFocus.push_back(playerView.get<TransformComponent>(entity).position);
+    }
+    auto spacecraftView = registry.view<SpacecraftComponent, TransformComponent>();
+    for (auto entity : spacecraftView) {
+        if (spacecraftView.get<SpacecraftComponent>(entity).currentState == SpacecraftComponent::State::PILOTED) {
+            m_HibernationFocus.push_back(spacecraftView.get<TransformComponent>(entity).position);
+        }
+    }
+    if (m_HibernationFocus.empty()) return;   // 没有玩家时不休眠任何扇区
+    
+    auto sectorView = registry.view<SectorComponent>();
+    for (auto sectorEntity : sectorView) {
+        auto& sector = sectorView.get<SectorComponent>(sectorEntity);
+        
+        float nearestSq = FLT_MAX;
+        for (const auto& focus : m_HibernationFocus) {
+            const float dx = focus.x - sector.worldPosition.x;
+            const float dy = focus.y - sector.worldPosition.y;
+            const float dz = focus.z - sector.worldPosition.z;
+            nearestSq = (std::min)(nearestSq, dx * dx + dy * dy + dz * dz);
+        }
+        
+        // 滞后：靠近到 scale 倍半径以内唤醒，远离到 1.25 倍之外才休眠
+        const float wakeDistance = sector.influenceRadius * m_HibernationRadiusScale;
+        const float sleepDistance = wakeDistance * 1.25f;
+        if (sector.hibernating && nearestSq < wakeDistance * wakeDistance) {
+            SetSectorHibernating(registry, sectorEntity, false);
+        } else if (!sector.hibernating && nearestSq > sleepDistance * sleepDistance) {
+            SetSectorHibernating(registry, sectorEntity, true);
+        }
+    }
+}
+
+void SectorPhysicsSystem::SetSectorHibernating(entt::registry& registry, entt::entity sectorEntity, bool hibernating) {
+    auto& sector = registry.get<SectorComponent>(sectorEntity);
+    sector.hibernating = hibernating;
+    sector.idleStepCounter = 0;
+    
+    uint32_t bodyCount = 0;
+    auto view = registry.view<InSectorComponent>();
+    for (auto entity : view) {
+        auto& inSector = view.get<InSectorComponent>(entity);
+        if (inSector.sector != sectorEntity || inSector.hibernating == hibernating) continue;
+        if (ApplyHibernation(registry, entity, inSector, hibernating)) bodyCount++;
+    }
+    
+    std::cout << "[SectorPhysics] " << sector.name << (hibernating ? " hibernating" : " woke up")
+              << " (" << bodyCount << " bodies)" << std::endl;
+}
+
+bool SectorPhysicsSystem::ApplyHibernation(entt::registry& registry, entt::entity entity,
+                                           InSectorComponent& inSector, bool hibernating) {
+    if (inSector.hibernating == hibernating) return false;
+    inSector.hibernating = hibernating;
+    inSector.interpolatePose = false;
+    
+    auto* rigidBody = registry.try_get<RigidBodyComponent>(entity);
+    if (!rigidBody || !rigidBody->physxActor) return false;
+    auto* dynamicActor = rigidBody->physxActor->is<physx::PxRigidDynamic>();
+    if (!dynamicActor) return false;
+    
+    const bool kinematic = (dynamicActor->getRigidBodyFlags() & physx::PxRigidBodyFlag::eKINEMATIC);
+    if (hibernating) {
+        // [来源: SectorPhysicsSystem] 休眠：保存速度和睡眠状态后禁用模拟（位姿不变）
+        if (!kinematic) {
+            inSector.hibernatedLinearVelocity = dynamicActor->getLinearVelocity();
+            inSector.hibernatedAngularVelocity = dynamicActor->getAngularVelocity();
+            inSector.hibernatedAsleep = dynamicActor->getScene() ? dynamicActor->isSleeping() : false;
+        }
+        dynamicActor->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, true);
+    } else {
+        // [来源: SectorPhysicsSystem] 唤醒：恢复模拟，速度和睡眠状态与休眠前完全一致
+        dynamicActor->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, false);
+        if (!kinematic) {
+            dynamicActor->setLinearVelocity(inSector.hibernatedLinearVelocity, false);
+            dynamicActor->setAngularVelocity(inSector.hibernatedAngularVelocity, false);
+            if (dynamicActor->getScene()) {
+                if (inSector.hibernatedAsleep) {
+                    dynamicActor->putToSleep();
+                } else {
+                    dynamicActor->wakeUp();
+                }
+            }
+        }
+        inSector.needsSync = true;
+    }
+    return true;
+}
+
+void SectorPhysicsSystem::RebuildSectorIndex(entt::registry& registry) {
+    m_SectorIndex.Build(registry, (std::max)(kEnterHysteresis, kExitHysteresis));
+}
+
 void SectorPhysicsSystem::TransferPhysXActorToSector(entt::registry& registry, entt::entity entity,
                                                       entt::entity oldSector, entt::entity newSector) {
+    PROFILE_SCOPE("TransferPhysXActorToSector");
     auto* inSector = registry.try_get<InSectorComponent>(entity);
     auto* transform = registry.try_get<TransformComponent>(entity);
     auto* rigidBody = registry.try_get<RigidBodyComponent>(entity);
@@ -722,15 +1182,11 @@ void SectorPhysicsSystem::TransferPhysXActorToSector(entt::registry& registry, e
     // 获取旧扇区信息
     auto* oldSectorComp = (oldSector != entt::null) ? registry.try_get<SectorComponent>(oldSector) : nullptr;
     
-    // 从 PhysX 获取实际位置（而不是可能过时的 inSector->localPosition）
+    // 从休眠扇区转出：先恢复模拟和保存的速度，下面按 actor 的实际速度换算
+    ApplyHibernation(registry, entity, *inSector, false);
+    
+    // inSector->localPosition 与 PhysX 一致（活跃 actor 每步回读）
     DirectX::XMFLOAT3 actualLocalPos = inSector->localPosition;
-    if (rigidBody && rigidBody->physxActor) {
-        auto* dynamicActor = rigidBody->physxActor->is<physx::PxRigidDynamic>();
-        if (dynamicActor) {
-            physx::PxTransform pose = dynamicActor->getGlobalPose();
-            actualLocalPos = { pose.p.x, pose.p.y, pose.p.z };
-        }
-    }
     
     // 计算正确的世界坐标
     DirectX::XMFLOAT3 worldPos;
@@ -747,8 +1203,15 @@ void SectorPhysicsSystem::TransferPhysXActorToSector(entt::registry& registry, e
                                                   newSectorComp->worldPosition,
                                                   newSectorComp->worldRotation);
     
-    // 更新 InSectorComponent 的局部坐标
+    // 更新 InSectorComponent 的局部坐标（旧扇区坐标系下的上一步位姿不能再用于插值）
     inSector->localPosition = newLocalPos;
+    inSector->interpolatePose = false;
+    
+    // 旧场景的接触在 actor 移除时上报（actor 不可解引用，得不到实体），地面接触在这里清除
+    if (auto* spacecraft = registry.try_get<SpacecraftComponent>(entity)) {
+        spacecraft->groundContact = entt::null;
+        spacecraft->isGrounded = false;
+    }
     
     // 如果有 PhysX 刚体，更新其位置
     if (rigidBody && rigidBody->physxActor) {
@@ -832,6 +1295,11 @@ void SectorPhysicsSystem::TransferPhysXActorToSector(entt::registry& registry, e
             std::cout << "[SectorPhysics] Sector transfer complete (simple velocity)" << std::endl;
         }
     }
+    
+    // 转入休眠中的扇区：立即进入休眠（否则要等到该扇区下一次状态切换）
+    if (newSectorComp->hibernating) {
+        ApplyHibernation(registry, entity, *inSector, true);
+    }
 }
 
 void SectorPhysicsSystem::PrintCurrentSectorInfo(entt::registry& registry) {
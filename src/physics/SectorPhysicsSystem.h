@@ -12,15 +12,23 @@
 #pragma once
 #include "../core/ECS.h"
 #include "../scene/Scene.h"
+#include "GravityKernel.h"
+#include "SectorSpatialIndex.h"
 #include <DirectXMath.h>
 #include <memory>
+#include <vector>
 
 namespace outer_wilds {
 
+struct PhysicsEvent;
+struct TransformComponent;
+namespace components { struct InSectorComponent; }
+
+
 class SectorPhysicsSystem : public System {
 public:
     SectorPhysicsSystem() = default;
-    ~SectorPhysicsSystem() override = default;
+    ~SectorPhysicsSystem() override;
 
     void Initialize() override;
     void Initialize(std::shared_ptr<Scene> scene);
@@ -42,15 +50,81 @@ public:
      */
     void PostPhysicsUpdate(float deltaTime, entt::registry& registry);
     
+    /**
+     * 渲染插值（每帧在所有固定步之后调用一次）
+     * - 扇区内实体的局部位姿转到世界坐标写入 TransformComponent
+     * - PhysX dynamic 刚体在最近两步的局部位姿之间按 alpha 插值
+     */
+    void InterpolateTransforms(float alpha, entt::registry& registry);
+    
+    /**
+     * 重建扇区空间索引（每帧在 OrbitSystem 移动星球之后调用一次）
+     */
+    void RebuildSectorIndex(entt::registry& registry);
+    
+    /**
+     * 扇区休眠（每帧在 RebuildSectorIndex 之后调用一次）
+     * - 玩家和驾驶中的飞船都在 radiusScale 个 influenceRadius 之外时，扇区内刚体禁用模拟，
+     *   跳过重力/扇区切换/坐标同步，世界坐标每 syncInterval 帧更新一次
+     * - 有人靠近（radiusScale 以内）时按保存的速度和睡眠状态恢复；离开要超出 radiusScale * 1.25 才休眠
+     */
+    void UpdateHibernation(entt::registry& registry);
+    
+    /**
+     * 时间加速（每帧在 UpdateHibernation 之前调用一次，读取 TimeManager::GetTimeWarp）
+     * - 倍率 <= maxSubsteppedWarp：物理按加速后的时间推进（固定步数受 PhysXManager 上限约束）
+     * - 更高倍率："轨道模式"，所有扇区按休眠处理（速度/睡眠状态保存），PhysX 不再步进，
+     *   实体在扇区局部坐标中原地不动，随星球解析推进；退出时原样恢复
+     */
+    void UpdateTimeWarp(entt::registry& registry);
+    float GetTimeWarp() const { return m_TimeWarp; }
+    bool IsOnRails() const { return m_OnRails; }
+    void SetMaxSubsteppedWarp(float warp) { m_MaxSubsteppedWarp = warp; }
+    void SetHibernationRadiusScale(float scale) { m_HibernationRadiusScale = scale; }
+    void SetHibernatedSyncInterval(uint32_t frames) { m_HibernatedSyncInterval = frames > 0 ? frames : 1; }
+    
+    /**
+     * 叠加重力模式（GravityAffectedComponent::Mode::Summed）的 Barnes–Hut 参数
+     * - threshold: 活跃重力源数量达到此值时改用八叉树近似，否则精确求和
+     * - theta: 开角，节点尺寸/距离小于它时整个节点当作一个点源（0 = 精确）
+     */
+    void SetBarnesHutThreshold(uint32_t sourceCount) { m_BarnesHutThreshold = sourceCount; }
+    void SetBarnesHutTheta(float theta) { m_BarnesHutTheta = theta > 0.0f ? theta : 0.0f; }
+    
+    /**
+     * 扇区独立场景模式下，有刚体但全部睡眠的扇区每隔多少步模拟一次（0 = 冻结）；
+     * 没有任何刚体/角色的扇区总是冻结
+     */
+    void SetIdleSectorStepInterval(uint32_t steps) { m_IdleSectorStepInterval = steps; }
+    
     /**
      * 将实体转移到新扇区
      */
     void TransferEntityToSector(entt::registry& registry, entt::entity entity, entt::entity newSector);
-
-private:
-    // 计算实体受到的重力
+    
+    /**
+     * 计算实体受到的重力（收集为 SoA，GravityKernel 4 路 SIMD 计算后写回 GravityAffectedComponent）
+     * PrePhysicsUpdate 的第一步；只写组件，不访问 PhysX
+     */
     void CalculateGravity(entt::registry& registry);
     
+    /**
+     * 同步扇区内实体的世界坐标（当扇区/星球移动时调用）
+     */
+    void SyncSectorEntities(entt::registry& registry);
+    
+    /**
+     * 为单个实体找到最佳扇区（带滞后机制防止边界振荡），只访问空间索引中包含该点的扇区
+     * - currentSector: 当前扇区（用于滞后计算）
+     * - enterHysteresis: 进入新扇区的阈值系数（如0.92表示需要深入到influenceRadius*0.92才进入）
+     * - exitHysteresis: 退出当前扇区的阈值系数（如1.08表示需要超出influenceRadius*1.08才退出）
+     * 需要先 RebuildSectorIndex
+     */
+    entt::entity FindBestSectorForEntity(entt::registry& registry, const DirectX::XMFLOAT3& worldPos,
+                                          entt::entity currentSector = entt::null, 
+                                          float enterHysteresis = 1.0f, float exitHysteresis = 1.0f);
+
+private:    
     // 应用重力到 PhysX actor
     void ApplyGravityForces(entt::registry& registry);
     
@@ -73,14 +147,18 @@ private:
     // 每30秒打印当前扇区信息
     void PrintCurrentSectorInfo(entt::registry& registry);
     
-    // 飞船稳定化：当飞船接近地面且速度低时让它sleep
+    // 飞船稳定化：当飞船接触地面且速度低时让它sleep
     void StabilizeSpacecraft(entt::registry& registry);
     
+    // 接触 / 睡眠事件：飞船的地面接触与接地状态（StandingOnComponent 由 CharacterControllerBatch 的 CCT 碰撞回报更新）
+    void OnPhysicsEvent(entt::registry& registry, const PhysicsEvent& event);
+    
     // 应用扇区切换的渐进式速度补偿
     void ApplyVelocityCompensation(float deltaTime, entt::registry& registry);
     
-    // 同步扇区内实体的世界坐标（当扇区/星球移动时调用）
-    void SyncSectorEntities(entt::registry& registry);
+    // 扇区局部 → 世界的批量传播：按扇区分组到连续数组，每个扇区的变换只构建一次
+    // （SyncSectorEntities / InterpolateTransforms 共用；interpolate 时按 alpha 插值上一步位姿）
+    void PropagateSectorTransforms(entt::registry& registry, bool interpolate, float alpha, bool includeHibernated);
     
     // 世界坐标转局部坐标
     DirectX::XMFLOAT3 WorldToLocal(
@@ -99,25 +177,87 @@ private:
     void UpdateSectorCollisions(entt::registry& registry);
     void SetSectorCollisionEnabled(entt::registry& registry, entt::entity sector, bool enabled);
     
+    // 扇区独立场景：创建场景、actor/CCT 跟随扇区换场景、安排本步要模拟的场景
+    void UpdateSectorScenes(entt::registry& registry);
+    void RecreateControllerInScene(entt::entity entity, physx::PxController*& controller,
+                                   physx::PxScene* scene, const DirectX::XMFLOAT3& localPosition);
+    
     // 检测并执行扇区切换（基于世界坐标距离、优先级和滞后机制）
     void CheckAndSwitchSectors(entt::registry& registry);
     
-    // 为单个实体找到最佳扇区（带滞后机制防止边界振荡）
-    // currentSector: 当前扇区（用于滞后计算）
-    // enterHysteresis: 进入新扇区的阈值系数（如0.92表示需要深入到influenceRadius*0.92才进入）
-    // exitHysteresis: 退出当前扇区的阈值系数（如1.08表示需要超出influenceRadius*1.08才退出）
-    entt::entity FindBestSectorForEntity(entt::registry& registry, const DirectX::XMFLOAT3& worldPos,
-                                          entt::entity currentSector = entt::null, 
-                                          float enterHysteresis = 1.0f, float exitHysteresis = 1.0f);
-    
     // 将实体的 PhysX Actor 转移到新扇区
     void TransferPhysXActorToSector(entt::registry& registry, entt::entity entity, 
                                      entt::entity oldSector, entt::entity newSector);
 
     std::shared_ptr<Scene> m_Scene;
+    uint32_t m_PhysicsEventSubscription = 0;
     
     // 当前激活的碰撞体扇区（用于追踪切换）
     entt::entity m_ActiveCollisionSector = entt::null;
+
+    // 批量重力计算的 SoA 缓冲（帧间复用，避免每步分配）
+    struct GravityTarget {
+        entt::entity entity;
+        entt::entity source;   // 扇区内批次：有效的扇区重力源；叠加批次：结果要转入的扇区坐标系；否则 null
+    };
+    GravityBatchSoA m_SectorGravityBatch;
+    GravityBatchSoA m_FreeGravityBatch;
+    GravityBatchSoA m_SummedGravityBatch;
+    GravitySourceSoA m_GravitySources;
+    std::vector<entt::entity> m_GravitySourceEntities;
+    std::vector<GravityTarget> m_SectorGravityTargets;
+    std::vector<GravityTarget> m_FreeGravityTargets;
+    std::vector<GravityTarget> m_SummedGravityTargets;
+
+    uint32_t m_IdleSectorStepInterval = 4;
+    
+    // 扇区休眠
+    void SetSectorHibernating(entt::registry& registry, entt::entity sector, bool hibernating);
+    // 单个实体进入 / 退出休眠（保存或恢复速度与睡眠状态）；返回是否作用到了 dynamic actor
+    static bool ApplyHibernation(entt::registry& registry, entt::entity entity,
+                                 components::InSectorComponent& inSector, bool hibernating);
+    float m_HibernationRadiusScale = 3.0f;
+    uint32_t m_HibernatedSyncInterval = 15;
+    uint32_t m_HibernatedSyncCounter = 0;
+    bool m_SyncHibernatedThisFrame = true;
+    std::vector<DirectX::XMFLOAT3> m_HibernationFocus;
+    
+    // 时间加速
+    float m_TimeWarp = 1.0f;
+    float m_MaxSubsteppedWarp = 4.0f;
+    bool m_OnRails = false;
+    
+    // 扇区影响球 BVH（FindBestSectorForEntity 使用）
+    SectorSpatialIndex m_SectorIndex;
+    
+    // 叠加模式：源数量达到阈值后改用 Barnes–Hut
+    GravityOctree m_GravityOctree;
+    uint32_t m_BarnesHutThreshold = 64;
+    float m_BarnesHutTheta = 0.5f;
+
+    // 上一步回读过的活跃刚体（已排序），用于检测刚入睡的刚体
+    std::vector<entt::entity> m_AwakeEntities;
+    std::vector<entt::entity> m_AwakeScratch;
+
+    // 扇区变换批量传播的缓冲（帧间复用）：居民按扇区计数排序后连续存放，局部位姿原地变换成世界位姿
+    struct PropagationSector {
+        entt::entity entity;
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT4 rotation;
+        uint32_t begin = 0;
+        uint32_t count = 0;
+    };
+    struct PropagationResident {
+        const components::InSectorComponent* inSector;
+        TransformComponent* transform;
+        uint32_t sector;        // m_PropagationSectors 下标
+    };
+    std::vector<PropagationSector> m_PropagationSectors;
+    std::vector<uint32_t> m_PropagationSectorSlots;     // 扇区实体下标 → m_PropagationSectors 下标（用完复位）
+    std::vector<PropagationResident> m_PropagationResidents;
+    std::vector<TransformComponent*> m_PropagationTargets;
+    std::vector<DirectX::XMFLOAT3> m_PropagationPositions;
+    std::vector<DirectX::XMFLOAT4> m_PropagationRotations;
 };
 
 } // namespace outer_wilds
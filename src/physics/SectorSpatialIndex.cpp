@@ -0,0 +1,85 @@
+#include "SectorSpatialIndex.h"
+#include "components/SectorComponent.h"
+#include <algorithm>
+#include <cfloat>
+
+namespace outer_wilds {
+
+namespace {
+    constexpr uint32_t kLeafSize = 2;
+}
+
+void SectorSpatialIndex::Build(entt::registry& registry, float radiusScale) {
+    m_RadiusScale = radiusScale;
+    m_Items.clear();
+    m_Nodes.clear();
+
+    auto view = registry.view<components::SectorComponent>();
+    for (auto entity : view) {
+        const auto& sector = view.get<components::SectorComponent>(entity);
+        if (!sector.isActive) continue;
+        m_Items.push_back({ entity, sector.worldPosition, sector.influenceRadius, sector.priority });
+    }
+    if (m_Items.empty()) return;
+
+    m_Nodes.reserve(m_Items.size() * 2);
+    m_Nodes.emplace_back();
+    BuildNode(0, 0, static_cast<uint32_t>(m_Items.size()));
+}
+
+void SectorSpatialIndex::BuildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end) {
+    float boundsMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float boundsMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    float centerMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float centerMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (uint32_t i = begin; i < end; i++) {
+        const Item& item = m_Items[i];
+        const float c[3] = { item.center.x, item.center.y, item.center.z };
+        const float r = item.influenceRadius * m_RadiusScale;
+        for (int axis = 0; axis < 3; axis++) {
+            boundsMin[axis] = (std::min)(boundsMin[axis], c[axis] - r);
+            boundsMax[axis] = (std::max)(boundsMax[axis], c[axis] + r);
+            centerMin[axis] = (std::min)(centerMin[axis], c[axis]);
+            centerMax[axis] = (std::max)(centerMax[axis], c[axis]);
+        }
+    }
+
+    {
+        Node& node = m_Nodes[nodeIndex];
+        std::copy(boundsMin, boundsMin + 3, node.min);
+        std::copy(boundsMax, boundsMax + 3, node.max);
+        if (end - begin <= kLeafSize) {
+            node.first = begin;
+            node.count = end - begin;
+            return;
+        }
+    }
+
+    // 按中心分布最长的轴做中位数划分
+    int axis = 0;
+    float extent = centerMax[0] - centerMin[0];
+    for (int a = 1; a < 3; a++) {
+        if (centerMax[a] - centerMin[a] > extent) {
+            extent = centerMax[a] - centerMin[a];
+            axis = a;
+        }
+    }
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(m_Items.begin() + begin, m_Items.begin() + mid, m_Items.begin() + end,
+        [axis](const Item& a, const Item& b) {
+            const float ca = axis == 0 ? a.center.x : (axis == 1 ? a.center.y : a.center.z);
+            const float cb = axis == 0 ? b.center.x : (axis == 1 ? b.center.y : b.center.z);
+            return ca < cb;
+        });
+
+    const uint32_t left = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.emplace_back();
+    m_Nodes.emplace_back();
+    m_Nodes[nodeIndex].first = left;
+    m_Nodes[nodeIndex].count = 0;
+
+    BuildNode(left, begin, mid);
+    BuildNode(left + 1, mid, end);
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,87 @@
+/**
+ * SectorSpatialIndex.h
+ *
+ * 扇区影响球的 BVH（每帧在 OrbitSystem 移动星球之后重建一次）
+ *
+ * 扇区数量很少但查询很多（每个 InSectorComponent 实体每个物理步一次），
+ * 重建只是对几十个球排序；查询只访问包含查询点的叶子。
+ */
+
+#pragma once
+#include <DirectXMath.h>
+#include <entt/entt.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace outer_wilds {
+
+class SectorSpatialIndex {
+public:
+    struct Item {
+        entt::entity sector = entt::null;
+        DirectX::XMFLOAT3 center = { 0.0f, 0.0f, 0.0f };
+        float influenceRadius = 0.0f;
+        int priority = 0;
+    };
+
+    /**
+     * @brief 收集所有激活的扇区并重建 BVH
+     * @param radiusScale 包围球按 influenceRadius * radiusScale 计算（传入最大的滞后系数）
+     */
+    void Build(entt::registry& registry, float radiusScale);
+
+    /**
+     * @brief 对包围球包含 point 的每个扇区调用 fn(const Item&, float distance)
+     */
+    template<typename Fn>
+    void Query(const DirectX::XMFLOAT3& point, Fn&& fn) const {
+        if (m_Nodes.empty()) return;
+        uint32_t stack[64];
+        uint32_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = m_Nodes[stack[--top]];
+            if (point.x < node.min[0] || point.x > node.max[0] ||
+                point.y < node.min[1] || point.y > node.max[1] ||
+                point.z < node.min[2] || point.z > node.max[2]) {
+                continue;
+            }
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                    const Item& item = m_Items[i];
+                    const float dx = point.x - item.center.x;
+                    const float dy = point.y - item.center.y;
+                    const float dz = point.z - item.center.z;
+                    const float distSq = dx * dx + dy * dy + dz * dz;
+                    const float reach = item.influenceRadius * m_RadiusScale;
+                    if (distSq <= reach * reach) {
+                        fn(item, std::sqrt(distSq));
+                    }
+                }
+                continue;
+            }
+            if (top + 2 > 64) continue;   // 深度受限于 Build 的中位数划分，实际不会发生
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+
+    uint32_t GetSectorCount() const { return static_cast<uint32_t>(m_Items.size()); }
+
+private:
+    struct Node {
+        float min[3];
+        float max[3];
+        uint32_t first = 0;   // 叶子：m_Items 起点；内部节点：左子节点（右子节点紧随其后）
+        uint32_t count = 0;   // 0 = 内部节点
+    };
+
+    void BuildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end);
+
+    std::vector<Item> m_Items;
+    std::vector<Node> m_Nodes;
+    float m_RadiusScale = 1.0f;
+};
+
+} // namespace outer_wilds
@@ -1,6 +1,7 @@
 #pragma once
 #include <DirectXMath.h>
 #include <entt/entt.hpp>
+#include <cstdint>
 
 using namespace DirectX;
 
@@ -21,6 +22,13 @@ namespace components {
 struct GravityAffectedComponent {
     // === 配置 ===
     
+    /** 重力计算模式
+     *  Nearest: 在扇区内指向扇区原点，扇区外取影响范围内最近的重力源（玩家/飞船，开销最低）
+     *  Summed:  所有重力源叠加（小行星带、碎片场）；重力源很多时用 Barnes–Hut 近似
+     */
+    enum class Mode : uint8_t { Nearest, Summed };
+    Mode mode = Mode::Nearest;
+    
     /** 是否受重力影响 */
     bool affectedByGravity = true;
     
@@ -33,7 +41,7 @@ struct GravityAffectedComponent {
     
     // === 运行时状态（由GravitySystem更新）===
     
-    /** 当前影响此实体的重力源（星球）*/
+    /** 当前影响此实体的重力源（星球）；Summed 模式下为贡献最大的源 */
     entt::entity currentGravitySource = entt::null;
     
     /** 当前重力方向（归一化向量，指向星球中心）*/
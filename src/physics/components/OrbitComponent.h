@@ -3,15 +3,16 @@
  * 
  * 轨道组件 - 定义天体的公转轨道
  * 
- * 使用简化的圆形轨道模型：
- * - 围绕指定中心点公转
- * - 固定轨道半径和周期
+ * 开普勒椭圆轨道（解析求值）：
+ * - 围绕指定中心点/父天体公转，位置只取决于模拟时间（不积分，不漂移）
+ * - 半长轴、周期、偏心率、近心点幅角、倾角
  * - 可选自转
  */
 
 #pragma once
 #include <DirectXMath.h>
 #include <entt/entt.hpp>
+#include "../FloatingOrigin.h"
 
 namespace outer_wilds {
 namespace components {
@@ -24,23 +25,29 @@ struct OrbitComponent {
     // 公转参数
     // ========================================
     
-    // 轨道中心（世界坐标）
+    // 轨道中心（双精度世界坐标）
     // 对于行星：围绕恒星
     // 对于卫星：围绕行星
-    DirectX::XMFLOAT3 orbitCenter = { 0.0f, 0.0f, 0.0f };
+    WorldPosition orbitCenter;
     
     // 轨道中心实体（如果有的话，会自动跟随该实体）
     entt::entity orbitParent = entt::null;
     
-    // 轨道半径（米）
+    // 轨道半长轴（米；圆轨道即半径）
     float orbitRadius = 200.0f;
     
     // 公转周期（秒）
     float orbitPeriod = 120.0f;
     
-    // 当前轨道角度（弧度，0 = +X方向）
+    // 历元（模拟时间 t = 0）的平近点角（弧度，0 = 近心点；圆轨道且近心点幅角为 0 时即 +X方向）
     float orbitAngle = 0.0f;
     
+    // 偏心率（0 = 圆，必须 < 1）
+    float eccentricity = 0.0f;
+    
+    // 近心点幅角（弧度，在轨道平面内从 +X 量起）
+    float argumentOfPeriapsis = 0.0f;
+    
     // 轨道平面法线（默认Y轴，即水平面公转）
     DirectX::XMFLOAT3 orbitNormal = { 0.0f, 1.0f, 0.0f };
     
@@ -50,6 +57,12 @@ struct OrbitComponent {
     // 是否启用公转
     bool orbitEnabled = true;
     
+    // 当前轨道位置（双精度世界坐标，OrbitSystem 写入；子天体以它为轨道中心）
+    WorldPosition absolutePosition;
+    
+    // 当前世界速度（米/秒，含父天体速度，OrbitSystem 写入）
+    DirectX::XMFLOAT3 worldVelocity = { 0.0f, 0.0f, 0.0f };
+    
     // ========================================
     // 自转参数
     // ========================================
@@ -57,7 +70,7 @@ struct OrbitComponent {
     // 自转周期（秒，0 = 不自转）
     float rotationPeriod = 0.0f;
     
-    // 当前自转角度（弧度）
+    // 历元的自转角度（弧度）
     float rotationAngle = 0.0f;
     
     // 自转轴（局部坐标系）
@@ -82,7 +95,7 @@ struct OrbitComponent {
         return DirectX::XM_2PI / rotationPeriod;
     }
     
-    // 获取公转线速度（米/秒）
+    // 获取平均公转线速度（米/秒；圆轨道时为精确值）
     float GetOrbitalLinearVelocity() const {
         return GetOrbitalAngularVelocity() * orbitRadius;
     }
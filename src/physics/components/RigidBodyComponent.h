@@ -2,6 +2,7 @@
 #include "../../core/ECS.h"
 #include <DirectXMath.h>
 #include <PxPhysicsAPI.h>
+#include <cstdint>
 
 namespace outer_wilds {
 
@@ -24,8 +25,21 @@ struct RigidBodyComponent : public Component {
     bool freezeRotationY = false;
     bool freezeRotationZ = false;
     
-    // PhysX actor handle
+    // PhysX actor handle（actor->userData 必须用 ToActorUserData 设为所属实体，活跃 actor 回读靠它找实体）
     physx::PxRigidActor* physxActor = nullptr;
 };
 
+/**
+ * @brief 实体 <-> PxActor::userData（偏移 1，使实体 0 不会被当作空指针）
+ */
+inline void* ToActorUserData(entt::entity entity) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(entt::to_integral(entity)) + 1);
+}
+
+inline entt::entity FromActorUserData(const void* userData) {
+    if (!userData) return entt::null;
+    using Integral = entt::id_type;
+    return static_cast<entt::entity>(static_cast<Integral>(reinterpret_cast<uintptr_t>(userData) - 1));
+}
+
 } // namespace outer_wilds
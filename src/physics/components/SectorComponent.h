@@ -10,6 +10,8 @@
 #include <DirectXMath.h>
 #include <entt/entt.hpp>
 #include <PxPhysicsAPI.h>
+#include "../FloatingOrigin.h"
+#include <cstdint>
 #include <string>
 
 namespace outer_wilds {
@@ -38,7 +40,10 @@ struct SectorComponent {
     // 父扇区（用于嵌套扇区，如月球的父扇区是地球）
     entt::entity parentSector = entt::null;
     
-    // 世界坐标（扇区在世界中的位置）
+    // 双精度世界坐标（权威值，由 OrbitSystem / SolarSystemBuilder 写入）
+    WorldPosition absolutePosition;
+    
+    // 相对浮动原点的单精度坐标（= absolutePosition - FloatingOrigin，渲染/坐标转换使用）
     DirectX::XMFLOAT3 worldPosition = { 0.0f, 0.0f, 0.0f };
     DirectX::XMFLOAT4 worldRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
     
@@ -47,6 +52,15 @@ struct SectorComponent {
     
     // PhysX 地面碰撞体（在扇区原点）
     physx::PxRigidStatic* physxGround = nullptr;
+    
+    // 扇区独立场景模式（PhysXManager::SetPerSectorScenes）：本扇区自己的 PxScene，由 SectorPhysicsSystem 创建
+    physx::PxScene* physxScene = nullptr;
+    uint32_t occupantCount = 0;             // 场景内的动态刚体/角色数（每步统计）
+    uint32_t awakeOccupantCount = 0;        // 其中未睡眠的
+    uint32_t idleStepCounter = 0;           // 低频模拟计数
+    
+    // 休眠：玩家/驾驶中的飞船都远离时，扇区内刚体停止模拟，世界坐标低频更新
+    bool hibernating = false;
 };
 
 /**
@@ -62,6 +76,19 @@ struct InSectorComponent {
     DirectX::XMFLOAT3 localPosition = { 0.0f, 0.0f, 0.0f };
     DirectX::XMFLOAT4 localRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
     
+    // 固定步长插值：上一个物理步的局部位姿（local* 为最近一步）。
+    // 只有 PhysX dynamic 刚体由 SyncDynamicFromPhysX 设置；扇区切换时清除（两个位姿不在同一坐标系）
+    DirectX::XMFLOAT3 previousLocalPosition = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4 previousLocalRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    bool interpolatePose = false;
+    
+    // 所在扇区休眠时的状态（SectorPhysicsSystem::UpdateHibernation 维护）
+    // 刚体被禁用模拟，速度和睡眠状态保存在这里，唤醒时原样恢复
+    bool hibernating = false;
+    physx::PxVec3 hibernatedLinearVelocity = physx::PxVec3(0.0f);
+    physx::PxVec3 hibernatedAngularVelocity = physx::PxVec3(0.0f);
+    bool hibernatedAsleep = false;
+    
     // 状态
     bool isInitialized = false;             // 是否已初始化
     bool needsSync = true;                  // 是否需要同步到 PhysX
@@ -79,6 +106,12 @@ struct InSectorComponent {
     // 切换冷却时间（切换后多久不能再次切换）
     float switchCooldown = 0.0f;
     
+    // 扇区查询的时间相关性：只有移动超过当前扇区 influenceRadius 的一小部分、
+    // 距上次查询超过固定间隔或冷却刚结束时才重新查询空间索引
+    DirectX::XMFLOAT3 lastSectorQueryPosition = { 0.0f, 0.0f, 0.0f };   // 世界坐标
+    float timeSinceSectorQuery = 0.0f;
+    bool hasSectorQuery = false;
+    
     // 冷却时间常量（秒）
     static constexpr float SWITCH_COOLDOWN_DURATION = 1.0f;
     
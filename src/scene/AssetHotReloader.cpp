@@ -0,0 +1,180 @@
+#include "AssetHotReloader.h"
+#include "AssetStreamer.h"
+#include "SceneAssetLoader.h"
+#include "../graphics/ShaderCompileService.h"
+#include "../graphics/resources/ResourceCache.h"
+#include "../graphics/resources/TextureLoader.h"
+#include "../core/DebugManager.h"
+#include <d3d11.h>
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+namespace outer_wilds {
+
+using namespace resources;
+
+namespace {
+    std::string GetExtension(const std::string& path) {
+        const size_t dot = path.find_last_of('.');
+        const size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return "";
+        std::string extension = path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension;
+    }
+
+    std::string ReplaceExtension(const std::string& path, const std::string& extension) {
+        return path.substr(0, path.find_last_of('.') + 1) + extension;
+    }
+
+    bool IsTextureExtension(const std::string& extension) {
+        return extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "tga" ||
+               extension == "bmp" || extension == "dds" || extension == "hdr";
+    }
+
+    bool IsModelExtension(const std::string& extension) {
+        return extension == "obj" || extension == "fbx" || extension == "gltf" || extension == "glb" ||
+               extension == "dae" || extension == "blend" || extension == "3ds";
+    }
+}
+
+bool AssetHotReloader::Start(ID3D11Device* device, const std::vector<std::string>& directories) {
+    m_Device = device;
+    if (!m_Watcher.Start(directories)) {
+        DebugManager::GetInstance().Log("HotReload", "No asset directories to watch; hot reload disabled");
+        return false;
+    }
+    return true;
+}
+
+void AssetHotReloader::Stop() {
+    m_Watcher.Stop();
+}
+
+void AssetHotReloader::Update() {
+    if (!m_Watcher.IsRunning() || !m_Device) return;
+
+    for (const auto& path : m_Watcher.PollChanges()) {
+        const std::string extension = GetExtension(path);
+        if (extension == "hlsl" || extension == "hlsli" || extension == "fxh") {
+            ReloadShader(path, extension);
+        } else if (IsTextureExtension(extension)) {
+            ReloadTexture(path);
+        } else if (IsModelExtension(extension)) {
+            ReloadModel(path);
+        } else if (extension == "mtl") {
+            ReloadModel(ReplaceExtension(path, "obj"));    // OBJ 的材质颜色烘进了顶点
+        } else if (extension == "bin") {
+            ReloadModel(ReplaceExtension(path, "gltf"));   // glTF 的外部缓冲
+        }
+    }
+}
+
+void AssetHotReloader::ReloadShader(const std::string& path, const std::string& extension) {
+    // shaders/textured.hlsl → "textured"；include 文件可能被任意着色器引用
+    std::string name;
+    if (extension == "hlsl") {
+        const size_t slash = path.find_last_of("/\\");
+        name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+        name = name.substr(0, name.find_last_of('.'));
+    }
+    const uint32_t queued = ShaderCompileService::GetInstance().Reload(name);
+    if (queued == 0) {
+        m_Stats.ignoredChanges++;
+        return;
+    }
+    m_Stats.shaderReloads += queued;
+}
+
+void AssetHotReloader::ReloadTexture(const std::string& path) {
+    auto targets = ResourceCache::GetInstance().FindTexturesBySource(path);
+    if (targets.empty()) {
+        m_Stats.ignoredChanges++;
+        return;
+    }
+
+    for (auto& target : targets) {
+        ID3D11Device* device = m_Device;
+        AssetStreamer::GetInstance().Submit([this, device, target]() -> AssetStreamer::ApplyFn {
+            // 加载线程：GenerateMips 等立即上下文工作由 TextureLoader 排队，ApplyCompleted 时执行
+            ID3D11ShaderResourceView* srv = nullptr;
+            if (!TextureLoader::LoadFromFile(device, target.path, &srv, true, target.usage)) {
+                return [this, target](entt::registry&) {
+                    m_Stats.failedReloads++;
+                    DebugManager::GetInstance().Log("HotReload", "Texture reload failed, keeping previous: " + target.path);
+                };
+            }
+            return [this, target, srv](entt::registry& registry) {
+                const auto materials = ResourceCache::GetInstance().ReplaceTexture(target.key, srv);
+                const uint32_t entities = SceneAssetLoader::RefreshMaterials(registry, materials);
+                m_Stats.textureReloads++;
+                DebugManager::GetInstance().Log("HotReload", "Reloaded texture " + target.path + " (" +
+                    std::to_string(materials.size()) + " materials, " + std::to_string(entities) + " entities)");
+            };
+        });
+    }
+}
+
+void AssetHotReloader::ReloadModel(const std::string& path) {
+    auto targets = ResourceCache::GetInstance().FindModelsBySource(path);
+    if (targets.empty()) {
+        m_Stats.ignoredChanges++;
+        return;
+    }
+
+    for (auto& target : targets) {
+        ID3D11Device* device = m_Device;
+        AssetStreamer::GetInstance().Submit([this, device, target]() -> AssetStreamer::ApplyFn {
+            auto onFailure = [this, target](entt::registry&) {
+                m_Stats.failedReloads++;
+                DebugManager::GetInstance().Log("HotReload", "Model reload failed, keeping previous: " + target.key);
+            };
+
+            // 加载线程：重新导入（源文件变了，MeshCache 的键随之变化）并上传 GPU 缓冲
+            if (target.load) {
+                auto model = std::make_shared<LoadedModel>();
+                if (!target.load(*model) || !model->mesh) return onFailure;
+                ResourceCache::EnsureGPUBuffers(device, *model->mesh);
+
+                return [this, device, target, model](entt::registry& registry) {
+                    auto previous = ResourceCache::GetInstance().ReplaceModel(target.key, model);
+                    if (!previous) return;
+                    const uint32_t entities = SceneAssetLoader::ReplaceMeshes(registry, device,
+                                                                              { previous->mesh }, { model->mesh });
+                    m_Stats.modelReloads++;
+                    DebugManager::GetInstance().Log("HotReload", "Reloaded model " + target.key + " (" +
+                                                    std::to_string(entities) + " entities)");
+                };
+            }
+
+            auto model = std::make_shared<MultiMaterialModel>();
+            if (!target.loadMulti || !target.loadMulti(*model) || model->subMeshes.empty()) return onFailure;
+            for (auto& subMesh : model->subMeshes) {
+                ResourceCache::EnsureGPUBuffers(device, *subMesh.mesh);
+            }
+
+            return [this, device, target, model](entt::registry& registry) {
+                auto previous = ResourceCache::GetInstance().ReplaceMultiMaterialModel(target.key, model);
+                if (!previous) return;
+                // 子网格按材质顺序一一对应；数量变化时多出来的子网格要重新加载场景才会出现
+                if (previous->subMeshes.size() != model->subMeshes.size()) {
+                    DebugManager::GetInstance().Log("HotReload", "Sub-mesh count changed (" +
+                        std::to_string(previous->subMeshes.size()) + " -> " + std::to_string(model->subMeshes.size()) +
+                        "), only matching sub-meshes are replaced: " + target.key);
+                }
+                std::vector<std::shared_ptr<Mesh>> oldMeshes;
+                std::vector<std::shared_ptr<Mesh>> newMeshes;
+                for (const auto& subMesh : previous->subMeshes) oldMeshes.push_back(subMesh.mesh);
+                for (const auto& subMesh : model->subMeshes) newMeshes.push_back(subMesh.mesh);
+                const uint32_t entities = SceneAssetLoader::ReplaceMeshes(registry, device, oldMeshes, newMeshes);
+                m_Stats.modelReloads++;
+                DebugManager::GetInstance().Log("HotReload", "Reloaded model " + target.key + " (" +
+                                                std::to_string(entities) + " entities)");
+            };
+        });
+    }
+}
+
+} // namespace outer_wilds
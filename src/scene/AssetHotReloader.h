@@ -0,0 +1,70 @@
+#pragma once
+#include "../core/FileWatcher.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ID3D11Device;
+
+namespace outer_wilds {
+
+/**
+ * @brief 资源热重载：监视 shaders/ 和 assets/，只重新加载变化的文件
+ *
+ * - .hlsl：ShaderCompileService::Reload 在编译线程上重新编译该文件的全部变体，成功后替换
+ *   （编译失败保留旧版本）；.hlsli 等 include 文件重新编译全部着色器
+ * - 纹理：在 AssetStreamer 加载线程上重新解码，主线程上 ResourceCache::ReplaceTexture
+ *   换进共享材质的槽位
+ * - 模型（.mtl / .bin 归到同名的 .obj / .gltf）：用缓存保存的加载函数重新导入，
+ *   主线程上替换缓存条目，SceneAssetLoader::ReplaceMeshes 把实体指向新 Mesh
+ *
+ * 被改动的组件都经过 registry.patch，RenderQueue 只重建受影响的批次，不重建世界。
+ * 只替换经 ResourceCache 共享的资源：渲染器自己持有的着色器（天空盒、阴影、替身）、
+ * 材质私有的纹理和物理碰撞体不在热重载范围内。
+ */
+class AssetHotReloader {
+public:
+    struct Stats {
+        uint32_t shaderReloads = 0;    // 排队重新编译的着色器变体
+        uint32_t textureReloads = 0;   // 已替换的纹理条目
+        uint32_t modelReloads = 0;     // 已替换的模型条目
+        uint32_t failedReloads = 0;
+        uint32_t ignoredChanges = 0;   // 没有被缓存引用的文件
+    };
+
+    static AssetHotReloader& GetInstance() {
+        static AssetHotReloader instance;
+        return instance;
+    }
+
+    /**
+     * @param device 重新创建 GPU 资源用
+     * @return 至少有一个目录在监视中时为 true
+     */
+    bool Start(ID3D11Device* device, const std::vector<std::string>& directories = { "shaders", "assets" });
+    void Stop();
+    bool IsRunning() const { return m_Watcher.IsRunning(); }
+
+    /**
+     * @brief 分派已稳定的文件变更（主线程每帧，在 AssetStreamer::ApplyCompleted 之前调用）
+     */
+    void Update();
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    AssetHotReloader() = default;
+    ~AssetHotReloader() = default;
+    AssetHotReloader(const AssetHotReloader&) = delete;
+    AssetHotReloader& operator=(const AssetHotReloader&) = delete;
+
+    void ReloadShader(const std::string& path, const std::string& extension);
+    void ReloadTexture(const std::string& path);
+    void ReloadModel(const std::string& path);
+
+    FileWatcher m_Watcher;
+    ID3D11Device* m_Device = nullptr;
+    Stats m_Stats;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,118 @@
+#include "AssetStreamer.h"
+#include "../graphics/resources/TextureLoader.h"
+#include "../core/DebugManager.h"
+
+namespace outer_wilds {
+
+bool AssetStreamer::Initialize(uint32_t threadCount) {
+    if (m_Initialized) return true;
+    if (threadCount == 0) threadCount = 1;
+
+    m_Running = true;
+    m_Threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        m_Threads.emplace_back(&AssetStreamer::LoaderMain, this);
+    }
+
+    m_Initialized = true;
+    DebugManager::GetInstance().Log("AssetStreamer", "Started " + std::to_string(threadCount) + " loader threads");
+    return true;
+}
+
+void AssetStreamer::Shutdown() {
+    if (!m_Initialized) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Running = false;
+        m_Requests.clear();
+    }
+    m_QueueCondition.notify_all();
+    for (auto& thread : m_Threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_Threads.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(m_CompletedMutex);
+        m_CompletedApplies.clear();
+    }
+    // 已创建的纹理仍在等待 mip 上传：执行掉，避免残留在队列里的 COM 引用
+    resources::TextureLoader::FlushDeferredWork();
+    m_Pending = 0;
+    m_Initialized = false;
+}
+
+uint32_t AssetStreamer::Submit(WorkFn work) {
+    if (!m_Initialized) Initialize();
+
+    Request request;
+    request.id = m_NextId.fetch_add(1, std::memory_order_relaxed);
+    request.work = std::move(work);
+    const uint32_t id = request.id;
+
+    m_Pending.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_QueueMutex);
+        m_Requests.push_back(std::move(request));
+    }
+    m_QueueCondition.notify_one();
+    return id;
+}
+
+uint32_t AssetStreamer::ApplyCompleted(entt::registry& registry) {
+    std::vector<ApplyFn> applies;
+    {
+        std::lock_guard<std::mutex> lock(m_CompletedMutex);
+        if (m_CompletedApplies.empty()) return 0;
+        applies.swap(m_CompletedApplies);
+    }
+
+    // 先完成立即上下文上的纹理工作，ApplyFn 挂上去的 SRV 在本帧渲染前就是完整的
+    resources::TextureLoader::FlushDeferredWork();
+
+    for (auto& apply : applies) {
+        if (apply) apply(registry);
+    }
+
+    const uint32_t count = static_cast<uint32_t>(applies.size());
+    m_Completed += count;
+    m_Pending.fetch_sub(count, std::memory_order_acq_rel);
+    return count;
+}
+
+void AssetStreamer::WaitAll(entt::registry& registry) {
+    while (GetPendingCount() > 0) {
+        {
+            std::unique_lock<std::mutex> lock(m_CompletedMutex);
+            m_CompletedCondition.wait(lock, [this]() { return !m_CompletedApplies.empty(); });
+        }
+        ApplyCompleted(registry);
+    }
+}
+
+void AssetStreamer::LoaderMain() {
+    // 本线程创建的纹理不触碰立即上下文
+    resources::TextureLoader::SetDeferImmediateContextWork(true);
+
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_QueueMutex);
+            m_QueueCondition.wait(lock, [this]() { return !m_Running || !m_Requests.empty(); });
+            if (!m_Running) return;
+            request = std::move(m_Requests.front());
+            m_Requests.pop_front();
+        }
+
+        ApplyFn apply = request.work ? request.work() : ApplyFn{};
+        {
+            // 失败的请求也要放进完成队列（空 ApplyFn），保证 Pending 计数归零
+            std::lock_guard<std::mutex> lock(m_CompletedMutex);
+            m_CompletedApplies.push_back(std::move(apply));
+        }
+        m_CompletedCondition.notify_all();
+    }
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,107 @@
+#pragma once
+#include <entt/entt.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 异步资源加载：文件 IO / 解码 / GPU 资源创建在加载线程上，ECS 修改在主线程上
+ *
+ * 三个阶段：
+ * 1. 加载线程执行 WorkFn：导入模型、创建 Mesh 缓冲和纹理（ID3D11Device 是自由线程的）。
+ *    立即上下文不是线程安全的：需要立即上下文的纹理工作（GenerateMips）由 TextureLoader 排队
+ * 2. 主线程 ApplyCompleted：先执行排队的立即上下文工作，再按完成顺序调用 WorkFn 返回的 ApplyFn
+ * 3. ApplyFn 把结果挂到实体上（调用方负责检查实体是否仍然有效）
+ *
+ * 使用独立的加载线程而不是 JobSystem：一次导入可能耗时数百毫秒，
+ * 放进作业队列会被主线程的 JobSystem::Wait 捡到而卡住整帧。
+ *
+ * @code
+ * streamer.Submit([=]() -> AssetStreamer::ApplyFn {
+ *     auto model = LoadSomething();                    // 加载线程
+ *     return [=](entt::registry& registry) { ... };    // 主线程
+ * });
+ * @endcode
+ */
+class AssetStreamer {
+public:
+    using ApplyFn = std::function<void(entt::registry&)>;
+    using WorkFn = std::function<ApplyFn()>;
+
+    static AssetStreamer& GetInstance() {
+        static AssetStreamer instance;
+        return instance;
+    }
+
+    /**
+     * @param threadCount 加载线程数（磁盘 IO 为主，不需要很多）
+     */
+    bool Initialize(uint32_t threadCount = 2);
+
+    /**
+     * @brief 丢弃尚未开始的请求，等待进行中的请求结束（结果不再应用）
+     */
+    void Shutdown();
+    bool IsInitialized() const { return m_Initialized; }
+
+    /**
+     * @brief 提交加载请求；未初始化时首次调用会自动初始化
+     * @return 请求 ID（从 1 开始，0 保留为无效）
+     */
+    uint32_t Submit(WorkFn work);
+
+    /**
+     * @brief 应用已完成的请求（主线程，每帧在游戏系统之前调用）
+     * @return 本次应用的请求数
+     */
+    uint32_t ApplyCompleted(entt::registry& registry);
+
+    /**
+     * @brief 阻塞直到所有已提交的请求完成并应用（加载界面 / 关卡切换）
+     */
+    void WaitAll(entt::registry& registry);
+
+    /** @brief 已提交但尚未应用的请求数 */
+    uint32_t GetPendingCount() const { return m_Pending.load(std::memory_order_acquire); }
+
+    /** @brief 统计：累计完成应用的请求数 */
+    uint32_t GetCompletedCount() const { return m_Completed; }
+
+private:
+    struct Request {
+        uint32_t id = 0;
+        WorkFn work;
+    };
+
+    AssetStreamer() = default;
+    ~AssetStreamer() { Shutdown(); }
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+    void LoaderMain();
+
+    bool m_Initialized = false;
+    std::vector<std::thread> m_Threads;
+    std::atomic<bool> m_Running{ false };
+
+    std::mutex m_QueueMutex;
+    std::condition_variable m_QueueCondition;
+    std::deque<Request> m_Requests;
+
+    std::mutex m_CompletedMutex;
+    std::condition_variable m_CompletedCondition;
+    std::vector<ApplyFn> m_CompletedApplies;
+
+    std::atomic<uint32_t> m_NextId{ 1 };
+    std::atomic<uint32_t> m_Pending{ 0 };
+    uint32_t m_Completed = 0;
+};
+
+} // namespace outer_wilds
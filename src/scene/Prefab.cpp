@@ -0,0 +1,408 @@
+#include "Prefab.h"
+#include "components/PrefabInstanceComponent.h"
+#include "../physics/CoordinateSystem.h"
+#include "../physics/PhysXManager.h"
+#include "../physics/PhysicsEvents.h"
+#include "../physics/components/GravityAffectedComponent.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include "../core/DebugManager.h"
+#include "../core/Profiler.h"
+#include <algorithm>
+
+namespace outer_wilds {
+
+using components::MeshComponent;
+using components::BoundsComponent;
+using components::RenderPriorityComponent;
+using components::InSectorComponent;
+using components::SectorComponent;
+using components::GravityAffectedComponent;
+using components::PrefabInstanceComponent;
+
+// ============================================
+// Prefab
+// ============================================
+
+std::shared_ptr<Prefab> Prefab::Load(ID3D11Device* device, const PrefabDesc& desc) {
+    // 在临时 registry 里走一遍完整的加载路径，只留下模板组件（不触发正式 registry 的 RenderQueue 信号）
+    entt::registry scratch;
+    const entt::entity source = SceneAssetLoader::LoadModelAsEntityWithOptions(
+        scratch, nullptr, device, desc.modelPath, desc.texturePath,
+        DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), desc.scale, desc.loading);
+    if (source == entt::null) {
+        DebugManager::GetInstance().Log("Prefab", "Failed to load prefab model: " + desc.modelPath);
+        return nullptr;
+    }
+    const auto* mesh = scratch.try_get<MeshComponent>(source);
+    if (!mesh || !mesh->mesh) {
+        DebugManager::GetInstance().Log("Prefab", "Prefab model has no single mesh: " + desc.modelPath);
+        return nullptr;
+    }
+
+    std::shared_ptr<Prefab> prefab(new Prefab());
+    prefab->m_Mesh = *mesh;
+    if (const auto* bounds = scratch.try_get<BoundsComponent>(source)) prefab->m_Bounds = *bounds;
+    if (const auto* priority = scratch.try_get<RenderPriorityComponent>(source)) prefab->m_Priority = *priority;
+    prefab->m_Scale = desc.scale;
+    prefab->m_Collider = desc.collider;
+    prefab->CreateCollider(desc.collider);
+
+    if (desc.loading.verbose) {
+        DebugManager::GetInstance().Log("Prefab", "Loaded prefab from " + desc.modelPath +
+                                        (prefab->HasCollider() ? " (shared collider)" : ""));
+    }
+    return prefab;
+}
+
+std::shared_ptr<Prefab> Prefab::Create(const std::shared_ptr<resources::Mesh>& mesh,
+                                       const std::shared_ptr<resources::Material>& material,
+                                       const DirectX::BoundingSphere& localBounds,
+                                       const DirectX::XMFLOAT3& scale,
+                                       const PrefabColliderDesc& collider) {
+    if (!mesh) return nullptr;
+
+    std::shared_ptr<Prefab> prefab(new Prefab());
+    prefab->m_Mesh = MeshComponent(mesh, material);
+    prefab->m_Bounds.SetSphere(localBounds);
+    // 与 SceneAssetLoader 加载的实体相同的排序键 / 通道
+    prefab->m_Priority.sortKey = 1000;
+    prefab->m_Priority.renderPass = 0;
+    prefab->m_Scale = scale;
+    prefab->m_Collider = collider;
+    prefab->CreateCollider(collider);
+    return prefab;
+}
+
+Prefab::~Prefab() {
+    // 仍 attach 在 actor 上的形状由 actor 持有引用，这里只释放模板自己的引用
+    if (m_Shape) m_Shape->release();
+    if (m_Material) m_Material->release();
+    m_Shape = nullptr;
+    m_Material = nullptr;
+}
+
+bool Prefab::CreateCollider(const PrefabColliderDesc& collider) {
+    if (collider.shape == PrefabColliderDesc::Shape::None) return false;
+
+    physx::PxPhysics* physics = PhysXManager::GetInstance().GetPhysics();
+    if (!physics) return false;
+
+    m_Material = physics->createMaterial(collider.staticFriction, collider.dynamicFriction, collider.restitution);
+    if (!m_Material) return false;
+
+    // 非独占形状：所有实例 attach 同一个 PxShape（几何体、材质和过滤数据只存一份）
+    if (collider.shape == PrefabColliderDesc::Shape::Sphere) {
+        m_Shape = physics->createShape(physx::PxSphereGeometry(collider.sphereRadius), *m_Material, false);
+    } else {
+        const DirectX::XMFLOAT3& h = collider.boxHalfExtents;
+        m_Shape = physics->createShape(physx::PxBoxGeometry(h.x, h.y, h.z), *m_Material, false);
+    }
+    if (!m_Shape) {
+        DebugManager::GetInstance().Log("Prefab", "Failed to create shared prefab shape");
+        return false;
+    }
+
+    // 共享形状 attach 之后不能再修改过滤数据：上报标志在这里一次写好（同 EnableContactReports）
+    const uint32_t shapeFlags = collider.reportFlags & (kReportContacts | kReportImpacts);
+    if (shapeFlags) {
+        physx::PxFilterData filterData = m_Shape->getSimulationFilterData();
+        filterData.word2 |= shapeFlags;
+        m_Shape->setSimulationFilterData(filterData);
+    }
+    return true;
+}
+
+// ============================================
+// PrefabPool
+// ============================================
+
+PrefabPool::PrefabPool(std::shared_ptr<Prefab> prefab)
+    : m_Prefab(std::move(prefab)) {
+}
+
+PrefabPool::~PrefabPool() {
+    if (m_Stats.live > 0) {
+        DebugManager::GetInstance().Log("Prefab", "PrefabPool destroyed with " + std::to_string(m_Stats.live) +
+                                        " live instances (call Clear before destruction)");
+    }
+    ReleasePooledActors();
+}
+
+size_t PrefabPool::Spawn(entt::registry& registry, const PrefabSpawnBatch& batch, entt::entity* outEntities) {
+    PROFILE_SCOPE("PrefabPool::Spawn");
+    if (!m_Prefab || !batch.positions || batch.count == 0) return 0;
+    const size_t count = batch.count;
+
+    const SectorComponent* sector = nullptr;
+    if (batch.sector != entt::null) {
+        sector = registry.valid(batch.sector) ? registry.try_get<SectorComponent>(batch.sector) : nullptr;
+        if (!sector) {
+            DebugManager::GetInstance().Log("Prefab", "Spawn target is not a sector entity");
+            return 0;
+        }
+    }
+    const bool simulated = sector && m_Prefab->HasCollider();
+    size_t spawned = count;
+
+    // === 位姿：扇区局部 → 世界，整批换算 ===
+    const DirectX::XMFLOAT4* localRotations = batch.rotations;
+    if (!localRotations) {
+        m_DefaultRotations.assign(count, DirectX::XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+        localRotations = m_DefaultRotations.data();
+    }
+    m_WorldPositions.resize(count);
+    m_WorldRotations.resize(count);
+    if (sector) {
+        CoordinateSystem::SectorLocalToWorld(sector->worldPosition, sector->worldRotation,
+                                             batch.positions, localRotations,
+                                             m_WorldPositions.data(), m_WorldRotations.data(), count);
+    } else {
+        std::copy(batch.positions, batch.positions + count, m_WorldPositions.begin());
+        std::copy(localRotations, localRotations + count, m_WorldRotations.begin());
+    }
+
+    // === 实体与组件：每种组件一次整段插入 ===
+    m_Entities.resize(count);
+    registry.create(m_Entities.begin(), m_Entities.end());
+    const auto first = m_Entities.begin();
+    const auto last = m_Entities.end();
+
+    m_Transforms.assign(count, TransformComponent{});
+    for (size_t i = 0; i < count; i++) {
+        m_Transforms[i].position = m_WorldPositions[i];
+        m_Transforms[i].rotation = m_WorldRotations[i];
+        m_Transforms[i].scale = m_Prefab->GetScale();
+    }
+    registry.insert<TransformComponent>(first, last, m_Transforms.begin());
+    registry.insert<MeshComponent>(first, last, m_Prefab->GetMesh());
+    registry.insert<BoundsComponent>(first, last, m_Prefab->GetBounds());
+    registry.insert<RenderPriorityComponent>(first, last, m_Prefab->GetRenderPriority());
+
+    PrefabInstanceComponent instance;
+    instance.pool = this;
+    instance.generation = ++m_Generation;
+    registry.insert<PrefabInstanceComponent>(first, last, instance);
+
+    // 生成在休眠中的扇区：实例直接以休眠状态加入（速度保存在 InSectorComponent，唤醒时恢复）
+    const bool hibernating = simulated && sector->hibernating;
+    if (sector) {
+        m_InSector.assign(count, InSectorComponent{});
+        for (size_t i = 0; i < count; i++) {
+            m_InSector[i].sector = batch.sector;
+            m_InSector[i].localPosition = batch.positions[i];
+            m_InSector[i].localRotation = localRotations[i];
+            m_InSector[i].isInitialized = true;
+            if (hibernating) {
+                const DirectX::XMFLOAT3 v = batch.linearVelocities ? batch.linearVelocities[i] : DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+                const DirectX::XMFLOAT3 w = batch.angularVelocities ? batch.angularVelocities[i] : DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+                m_InSector[i].hibernating = true;
+                m_InSector[i].hibernatedLinearVelocity = physx::PxVec3(v.x, v.y, v.z);
+                m_InSector[i].hibernatedAngularVelocity = physx::PxVec3(w.x, w.y, w.z);
+            }
+        }
+        registry.insert<InSectorComponent>(first, last, m_InSector.begin());
+    }
+
+    if (simulated) {
+        const PrefabColliderDesc& collider = m_Prefab->GetCollider();
+        if (collider.useGravity) {
+            GravityAffectedComponent gravity;
+            gravity.affectedByGravity = true;
+            gravity.currentGravitySource = batch.sector;
+            registry.insert<GravityAffectedComponent>(first, last, gravity);
+        }
+
+        RigidBodyComponent rigidBody;
+        rigidBody.mass = collider.mass;
+        rigidBody.drag = collider.linearDamping;
+        rigidBody.angularDrag = collider.angularDamping;
+        rigidBody.useGravity = collider.useGravity;
+        registry.insert<RigidBodyComponent>(first, last, rigidBody);
+
+        // === actor：先从池里取，不够再新建；整批加入扇区所在的场景 ===
+        auto& rigidBodies = registry.storage<RigidBodyComponent>();
+        m_SceneActors.clear();
+        for (size_t i = 0; i < count; i++) {
+            physx::PxRigidDynamic* actor = AcquireActor();
+            if (!actor) break;
+
+            const DirectX::XMFLOAT3& p = batch.positions[i];
+            const DirectX::XMFLOAT4& q = localRotations[i];
+            actor->setGlobalPose(physx::PxTransform(physx::PxVec3(p.x, p.y, p.z), physx::PxQuat(q.x, q.y, q.z, q.w)));
+            const DirectX::XMFLOAT3 v = batch.linearVelocities ? batch.linearVelocities[i] : DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+            const DirectX::XMFLOAT3 w = batch.angularVelocities ? batch.angularVelocities[i] : DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+            actor->setLinearVelocity(physx::PxVec3(v.x, v.y, v.z));
+            actor->setAngularVelocity(physx::PxVec3(w.x, w.y, w.z));
+            actor->userData = ToActorUserData(m_Entities[i]);
+            if (hibernating) actor->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, true);
+
+            rigidBodies.get(m_Entities[i]).physxActor = actor;
+            m_SceneActors.push_back(actor);
+        }
+
+        physx::PxScene* scene = sector->physxScene ? sector->physxScene : PhysXManager::GetInstance().GetScene();
+        if (scene && !m_SceneActors.empty()) {
+            scene->addActors(m_SceneActors.data(), static_cast<physx::PxU32>(m_SceneActors.size()));
+            // 禁用模拟的 actor 不能 wakeUp（扇区唤醒时由 SectorPhysicsSystem 恢复速度并唤醒）
+            if (!hibernating) {
+                for (physx::PxActor* actor : m_SceneActors) {
+                    static_cast<physx::PxRigidDynamic*>(actor)->wakeUp();
+                }
+            }
+        }
+        // actor 创建中途失败：没拿到 actor 的实体整段销毁，不留下 physxActor 为空的刚体
+        spawned = m_SceneActors.size();
+        if (spawned < count) {
+            DebugManager::GetInstance().Log("Prefab", "Failed to create PhysX actors for " +
+                                            std::to_string(count - spawned) + " prefab instances");
+            registry.destroy(m_Entities.begin() + spawned, m_Entities.end());
+        }
+    }
+
+    if (outEntities) std::copy(first, first + spawned, outEntities);
+
+    m_Stats.live += static_cast<uint32_t>(spawned);
+    m_Stats.peakLive = (std::max)(m_Stats.peakLive, m_Stats.live);
+    m_Stats.totalSpawned += spawned;
+    return spawned;
+}
+
+size_t PrefabPool::Despawn(entt::registry& registry, const entt::entity* entities, size_t count) {
+    PROFILE_SCOPE("PrefabPool::Despawn");
+    if (!entities || count == 0) return 0;
+
+    m_Entities.clear();
+    m_RemovedActors.clear();
+    for (size_t i = 0; i < count; i++) {
+        const entt::entity entity = entities[i];
+        if (!registry.valid(entity)) continue;
+        const auto* instance = registry.try_get<PrefabInstanceComponent>(entity);
+        if (!instance || instance->pool != this) continue;
+
+        m_Entities.push_back(entity);
+        if (auto* rigidBody = registry.try_get<RigidBodyComponent>(entity)) {
+            if (rigidBody->physxActor) {
+                m_RemovedActors.emplace_back(rigidBody->physxActor->getScene(), rigidBody->physxActor);
+                rigidBody->physxActor = nullptr;
+            }
+        }
+    }
+    if (m_Entities.empty()) return 0;
+
+    // 实例可能已被 SectorPhysicsSystem 转移到不同扇区的场景：按场景分段批量移除
+    std::sort(m_RemovedActors.begin(), m_RemovedActors.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t begin = 0; begin < m_RemovedActors.size();) {
+        physx::PxScene* scene = m_RemovedActors[begin].first;
+        size_t end = begin;
+        m_SceneActors.clear();
+        while (end < m_RemovedActors.size() && m_RemovedActors[end].first == scene) {
+            m_SceneActors.push_back(m_RemovedActors[end].second);
+            end++;
+        }
+        if (scene) {
+            // 唤醒失去接触的物体（落在碎片上的东西）
+            scene->removeActors(m_SceneActors.data(), static_cast<physx::PxU32>(m_SceneActors.size()), true);
+        }
+        begin = end;
+    }
+
+    for (const auto& removed : m_RemovedActors) {
+        auto* actor = static_cast<physx::PxRigidDynamic*>(removed.second);
+        actor->userData = nullptr;
+        actor->setActorFlag(physx::PxActorFlag::eDISABLE_SIMULATION, false);   // 休眠扇区里禁用的
+        actor->setLinearVelocity(physx::PxVec3(0.0f));
+        actor->setAngularVelocity(physx::PxVec3(0.0f));
+        m_FreeActors.push_back(actor);
+    }
+
+    registry.destroy(m_Entities.begin(), m_Entities.end());
+
+    const uint32_t despawned = static_cast<uint32_t>(m_Entities.size());
+    m_Stats.live -= (std::min)(m_Stats.live, despawned);
+    m_Stats.totalDespawned += despawned;
+    return despawned;
+}
+
+size_t PrefabPool::DespawnAll(entt::registry& registry) {
+    std::vector<entt::entity> live;
+    live.reserve(m_Stats.live);
+    for (auto [entity, instance] : registry.view<PrefabInstanceComponent>().each()) {
+        if (instance.pool == this) live.push_back(entity);
+    }
+    return Despawn(registry, live.data(), live.size());
+}
+
+void PrefabPool::Prewarm(size_t actorCount) {
+    if (!m_Prefab || !m_Prefab->HasCollider()) return;
+    m_FreeActors.reserve(m_FreeActors.size() + actorCount);
+    for (size_t i = 0; i < actorCount; i++) {
+        physx::PxRigidDynamic* actor = CreateActor();
+        if (!actor) break;
+        m_FreeActors.push_back(actor);
+    }
+}
+
+void PrefabPool::Clear(entt::registry& registry) {
+    DespawnAll(registry);
+    ReleasePooledActors();
+}
+
+PrefabPool::Stats PrefabPool::GetStats() const {
+    Stats stats = m_Stats;
+    stats.pooledActors = static_cast<uint32_t>(m_FreeActors.size());
+    return stats;
+}
+
+physx::PxRigidDynamic* PrefabPool::AcquireActor() {
+    if (!m_FreeActors.empty()) {
+        physx::PxRigidDynamic* actor = m_FreeActors.back();
+        m_FreeActors.pop_back();
+        return actor;
+    }
+    return CreateActor();
+}
+
+physx::PxRigidDynamic* PrefabPool::CreateActor() {
+    physx::PxPhysics* physics = PhysXManager::GetInstance().GetPhysics();
+    physx::PxShape* shape = m_Prefab ? m_Prefab->GetShape() : nullptr;
+    if (!physics || !shape) return nullptr;
+
+    physx::PxRigidDynamic* actor = physics->createRigidDynamic(physx::PxTransform(physx::PxIdentity));
+    if (!actor) return nullptr;
+    actor->attachShape(*shape);
+
+    const PrefabColliderDesc& collider = m_Prefab->GetCollider();
+    if (!m_HasMassProperties) {
+        physx::PxRigidBodyExt::setMassAndUpdateInertia(*actor, collider.mass);
+        m_InertiaTensor = actor->getMassSpaceInertiaTensor();
+        m_CenterOfMass = actor->getCMassLocalPose();
+        m_HasMassProperties = true;
+    } else {
+        // 所有实例形状相同：直接复制第一个 actor 算出的质量属性
+        actor->setMass(collider.mass);
+        actor->setMassSpaceInertiaTensor(m_InertiaTensor);
+        actor->setCMassLocalPose(m_CenterOfMass);
+    }
+    actor->setLinearDamping(collider.linearDamping);
+    actor->setAngularDamping(collider.angularDamping);
+
+    if (collider.reportFlags & kReportImpacts) {
+        actor->setContactReportThreshold(collider.impactForceThreshold);
+    }
+    if (collider.reportFlags & kReportSleep) {
+        actor->setActorFlag(physx::PxActorFlag::eSEND_SLEEP_NOTIFIES, true);
+    }
+
+    m_Stats.createdActors++;
+    return actor;
+}
+
+void PrefabPool::ReleasePooledActors() {
+    for (physx::PxRigidDynamic* actor : m_FreeActors) {
+        actor->release();
+    }
+    m_FreeActors.clear();
+}
+
+} // namespace outer_wilds
@@ -0,0 +1,204 @@
+/**
+ * Prefab.h
+ *
+ * 预制体：加载一次的实体模板 + 成批实例化 / 回收（碎片、弹壳、散落物）
+ *
+ * - Prefab 持有实例共享的数据：MeshComponent（网格 / 材质句柄）、BoundsComponent、RenderPriorityComponent、
+ *   缩放和碰撞体描述。碰撞体是一个共享（非独占）PxShape，所有实例的 actor attach 同一个形状
+ * - PrefabPool::Spawn 一次生成 N 个实例：EnTT 的 create(first, last) + insert<T>(first, last, ...) 逐组件整段插入，
+ *   世界位姿用 CoordinateSystem::SectorLocalToWorld 批量换算，actor 用 PxScene::addActors 一次加入场景
+ * - Despawn 把 actor 移出场景放回池里（保留形状、质量和惯量），下次 Spawn 只重设位姿和速度；
+ *   实体 id 由 EnTT 自己的空闲链表回收（destroy 后 create 复用下标、版本号递增，旧句柄自动失效），
+ *   各组件存储池不收缩，再次插入不分配
+ *
+ * 线程：Spawn / Despawn / Clear 修改 registry 结构并访问 PhysX，只能在主线程、PhysX 访问安全的时机调用
+ * （PhysicsEventQueue 的监听者里，或与其他创建 actor 的代码相同的位置）。
+ * 生命周期：Prefab 和 PrefabPool 必须在 PhysXManager::Shutdown 之前释放；池析构前先 Clear(registry)。
+ */
+
+#pragma once
+#include "../graphics/components/MeshComponent.h"
+#include "../graphics/components/BoundsComponent.h"
+#include "../graphics/components/RenderPriorityComponent.h"
+#include "../physics/components/SectorComponent.h"
+#include "SceneAssetLoader.h"
+#include "components/TransformComponent.h"
+#include <PxPhysicsAPI.h>
+#include <entt/entt.hpp>
+#include <DirectXCollision.h>
+#include <DirectXMath.h>
+#include <d3d11.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * @brief 预制体的碰撞体描述（尺寸是世界尺度，不乘模板的 scale；与 PhysicsOptions 一致）
+ */
+struct PrefabColliderDesc {
+    enum class Shape { None, Sphere, Box };
+    Shape shape = Shape::None;
+    float sphereRadius = 0.5f;
+    DirectX::XMFLOAT3 boxHalfExtents = { 0.5f, 0.5f, 0.5f };
+
+    float mass = 1.0f;
+    float linearDamping = 0.05f;
+    float angularDamping = 0.05f;
+    float staticFriction = 0.5f;
+    float dynamicFriction = 0.5f;
+    float restitution = 0.2f;
+    bool useGravity = true;             // 同时添加 GravityAffectedComponent
+
+    uint32_t reportFlags = 0;           // PhysicsReportFlags（写进共享形状 / actor 标志）
+    float impactForceThreshold = 0.0f;  // kReportImpacts 的 contactReportThreshold（N）
+};
+
+/**
+ * @brief 从模型文件创建预制体的参数
+ */
+struct PrefabDesc {
+    std::string modelPath;
+    std::string texturePath;
+    DirectX::XMFLOAT3 scale = { 1.0f, 1.0f, 1.0f };
+    ModelLoadingOptions loading;
+    PrefabColliderDesc collider;
+};
+
+class Prefab {
+public:
+    /**
+     * @brief 通过 SceneAssetLoader 加载模型（ResourceCache 共享网格 / 材质）并抽出模板组件
+     *
+     * 只支持单网格模型（LoadModelAsEntityWithOptions 产生 MeshComponent 的格式）。PhysX 未初始化时没有碰撞体。
+     * @return 失败时为 nullptr
+     */
+    static std::shared_ptr<Prefab> Load(ID3D11Device* device, const PrefabDesc& desc);
+
+    /**
+     * @brief 用已有的网格 / 材质创建预制体（程序生成的碎片等）
+     * @param localBounds 网格空间的包围球
+     */
+    static std::shared_ptr<Prefab> Create(const std::shared_ptr<resources::Mesh>& mesh,
+                                          const std::shared_ptr<resources::Material>& material,
+                                          const DirectX::BoundingSphere& localBounds,
+                                          const DirectX::XMFLOAT3& scale,
+                                          const PrefabColliderDesc& collider);
+
+    ~Prefab();
+
+    const components::MeshComponent& GetMesh() const { return m_Mesh; }
+    const components::BoundsComponent& GetBounds() const { return m_Bounds; }
+    const components::RenderPriorityComponent& GetRenderPriority() const { return m_Priority; }
+    const DirectX::XMFLOAT3& GetScale() const { return m_Scale; }
+    const PrefabColliderDesc& GetCollider() const { return m_Collider; }
+
+    /** @brief 实例共享的形状（没有碰撞体或 PhysX 未初始化时为 nullptr） */
+    physx::PxShape* GetShape() const { return m_Shape; }
+    bool HasCollider() const { return m_Shape != nullptr; }
+
+private:
+    Prefab() = default;
+    Prefab(const Prefab&) = delete;
+    Prefab& operator=(const Prefab&) = delete;
+
+    bool CreateCollider(const PrefabColliderDesc& collider);
+
+    components::MeshComponent m_Mesh;
+    components::BoundsComponent m_Bounds;
+    components::RenderPriorityComponent m_Priority;
+    DirectX::XMFLOAT3 m_Scale = { 1.0f, 1.0f, 1.0f };
+    PrefabColliderDesc m_Collider;
+
+    physx::PxShape* m_Shape = nullptr;
+    physx::PxMaterial* m_Material = nullptr;
+};
+
+/**
+ * @brief 一批实例的位姿（数组都有 count 个元素；可选数组为 nullptr 时取默认值）
+ *
+ * sector 为扇区实体时位置 / 旋转是扇区局部坐标，实例带 InSectorComponent 并参与物理；
+ * sector 为 null 时是世界坐标，实例只渲染（没有 actor）。
+ */
+struct PrefabSpawnBatch {
+    entt::entity sector = entt::null;
+    const DirectX::XMFLOAT3* positions = nullptr;
+    const DirectX::XMFLOAT4* rotations = nullptr;           // 默认单位旋转
+    const DirectX::XMFLOAT3* linearVelocities = nullptr;    // 扇区局部（默认静止）
+    const DirectX::XMFLOAT3* angularVelocities = nullptr;
+    size_t count = 0;
+};
+
+class PrefabPool {
+public:
+    struct Stats {
+        uint32_t live = 0;              // 当前存活的实例
+        uint32_t peakLive = 0;
+        uint32_t pooledActors = 0;      // 池中等待复用的 actor
+        uint32_t createdActors = 0;     // 累计新建的 actor（复用命中时不增加）
+        uint64_t totalSpawned = 0;
+        uint64_t totalDespawned = 0;
+    };
+
+    explicit PrefabPool(std::shared_ptr<Prefab> prefab);
+    ~PrefabPool();
+
+    /**
+     * @brief 生成一批实例
+     * @param outEntities 可选，接收生成的实体（与 batch 的顺序一致，至多 count 个）
+     * @return 生成的实例数（失败时为 0；actor 创建中途失败时只保留前面拿到 actor 的实例）
+     */
+    size_t Spawn(entt::registry& registry, const PrefabSpawnBatch& batch, entt::entity* outEntities = nullptr);
+
+    /**
+     * @brief 回收实例：actor 移出场景放回池中，实体整段销毁（不属于本池的实体被忽略）
+     * @return 回收的实例数
+     */
+    size_t Despawn(entt::registry& registry, const entt::entity* entities, size_t count);
+
+    /** @brief 回收本池的全部存活实例 */
+    size_t DespawnAll(entt::registry& registry);
+
+    /** @brief 预先创建 actor（关卡加载时调用，避免首次爆炸时集中创建） */
+    void Prewarm(size_t actorCount);
+
+    /** @brief DespawnAll 并释放池中的 actor */
+    void Clear(entt::registry& registry);
+
+    const std::shared_ptr<Prefab>& GetPrefab() const { return m_Prefab; }
+    Stats GetStats() const;
+
+private:
+    PrefabPool(const PrefabPool&) = delete;
+    PrefabPool& operator=(const PrefabPool&) = delete;
+
+    physx::PxRigidDynamic* AcquireActor();
+    physx::PxRigidDynamic* CreateActor();
+    void ReleasePooledActors();
+
+    std::shared_ptr<Prefab> m_Prefab;
+    std::vector<physx::PxRigidDynamic*> m_FreeActors;
+
+    // 共享形状的质量属性（第一个 actor 计算一次，之后直接复制）
+    bool m_HasMassProperties = false;
+    physx::PxVec3 m_InertiaTensor = physx::PxVec3(1.0f);
+    physx::PxTransform m_CenterOfMass = physx::PxTransform(physx::PxIdentity);
+
+    // 批处理临时缓冲（保留容量，稳态下不分配）
+    std::vector<entt::entity> m_Entities;
+    std::vector<DirectX::XMFLOAT4> m_DefaultRotations;
+    std::vector<DirectX::XMFLOAT3> m_WorldPositions;
+    std::vector<DirectX::XMFLOAT4> m_WorldRotations;
+    std::vector<TransformComponent> m_Transforms;
+    std::vector<components::InSectorComponent> m_InSector;
+    std::vector<physx::PxActor*> m_SceneActors;
+    std::vector<std::pair<physx::PxScene*, physx::PxActor*>> m_RemovedActors;
+
+    uint32_t m_Generation = 0;
+    Stats m_Stats;
+};
+
+} // namespace outer_wilds
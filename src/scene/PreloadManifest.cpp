@@ -0,0 +1,109 @@
+#include "PreloadManifest.h"
+#include "../core/DebugManager.h"
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace outer_wilds {
+
+namespace {
+
+std::mutex g_RecordMutex;
+std::atomic<bool> g_Recording{ false };
+PreloadManifest g_Recorded;
+
+std::string MakeEntryKey(PreloadManifest::Kind kind, resources::TextureUsage usage, const std::string& path) {
+    return std::to_string(static_cast<uint32_t>(kind)) + "\t" +
+           std::to_string(static_cast<uint32_t>(usage)) + "\t" + path;
+}
+
+} // namespace
+
+void PreloadManifest::Add(Kind kind, const std::string& path, resources::TextureUsage usage) {
+    if (path.empty()) return;
+    if (!m_Keys.insert(MakeEntryKey(kind, usage, path)).second) return;
+
+    Entry entry;
+    entry.kind = kind;
+    entry.usage = usage;
+    entry.path = path;
+    m_Entries.push_back(std::move(entry));
+}
+
+bool PreloadManifest::Load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    m_Entries.clear();
+    m_Keys.clear();
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        const size_t kindEnd = line.find('\t');
+        const size_t usageEnd = kindEnd == std::string::npos ? std::string::npos : line.find('\t', kindEnd + 1);
+        if (usageEnd == std::string::npos) continue;
+
+        const uint32_t kind = static_cast<uint32_t>(std::strtoul(line.c_str(), nullptr, 10));
+        const uint32_t usage = static_cast<uint32_t>(std::strtoul(line.c_str() + kindEnd + 1, nullptr, 10));
+        if (kind > static_cast<uint32_t>(Kind::MergedMultiModel) ||
+            usage > static_cast<uint32_t>(resources::TextureUsage::Mask)) {
+            continue;
+        }
+        Add(static_cast<Kind>(kind), line.substr(usageEnd + 1), static_cast<resources::TextureUsage>(usage));
+    }
+
+    DebugManager::GetInstance().Log("PreloadManifest",
+        "Loaded " + std::to_string(m_Entries.size()) + " entries from " + path);
+    return true;
+}
+
+bool PreloadManifest::Save(const std::string& path) const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            DebugManager::GetInstance().Log("PreloadManifest", "Failed to write manifest: " + tempPath);
+            return false;
+        }
+        for (const auto& entry : m_Entries) {
+            file << static_cast<uint32_t>(entry.kind) << '\t'
+                 << static_cast<uint32_t>(entry.usage) << '\t' << entry.path << '\n';
+        }
+        if (!file) return false;
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        DebugManager::GetInstance().Log("PreloadManifest", "Failed to replace manifest: " + path);
+        return false;
+    }
+    return true;
+}
+
+void PreloadManifest::BeginRecording() {
+    std::lock_guard<std::mutex> lock(g_RecordMutex);
+    g_Recorded = PreloadManifest();
+    g_Recording = true;
+}
+
+PreloadManifest PreloadManifest::EndRecording() {
+    std::lock_guard<std::mutex> lock(g_RecordMutex);
+    g_Recording = false;
+    PreloadManifest recorded = std::move(g_Recorded);
+    g_Recorded = PreloadManifest();
+    return recorded;
+}
+
+void PreloadManifest::Record(Kind kind, const std::string& path, resources::TextureUsage usage) {
+    if (!g_Recording.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> lock(g_RecordMutex);
+    if (g_Recording) g_Recorded.Add(kind, path, usage);
+}
+
+} // namespace outer_wilds
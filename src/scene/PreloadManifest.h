@@ -0,0 +1,73 @@
+/**
+ * PreloadManifest.h
+ *
+ * 启动预加载清单：场景构建需要的全部资源（模型、多材质模型、LOD 链、纹理）
+ *
+ * - 生成：场景构建期间录制 SceneAssetLoader 的资源获取（BeginRecording / EndRecording），
+ *   构建结束后写到 cache/preload_manifest.txt
+ * - 使用：下次启动时读入，由 ScenePreloader 在加载线程上并行获取，欢迎界面显示进度；
+ *   之后的场景构建全部命中 ResourceCache
+ *
+ * 文件格式：每行 "<kind>\t<usage>\t<path>"（kind / usage 为枚举的整数值）。
+ * 清单过期（资源被删除或改名）只会让对应条目预加载失败，场景构建仍照常进行。
+ */
+
+#pragma once
+#include "../graphics/resources/TextureCooker.h"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace outer_wilds {
+
+class PreloadManifest {
+public:
+    static constexpr const char* kDefaultPath = "cache/preload_manifest.txt";
+
+    enum class Kind : uint32_t {
+        Model,              // 单网格模型（默认加载选项）
+        MultiModel,         // 多材质模型
+        ModelLODChain,      // 单网格模型的 LOD 链
+        MultiModelLODChain, // 多材质模型各子网格的 LOD 链
+        Texture,            // 纹理文件（路径 + 用途）
+        MergedMultiModel    // 静态合并的多材质模型（含各子网格的 LOD 链）
+    };
+
+    struct Entry {
+        Kind kind = Kind::Model;
+        resources::TextureUsage usage = resources::TextureUsage::Color;
+        std::string path;
+    };
+
+    /** @brief 添加条目（重复的条目忽略） */
+    void Add(Kind kind, const std::string& path,
+             resources::TextureUsage usage = resources::TextureUsage::Color);
+
+    const std::vector<Entry>& GetEntries() const { return m_Entries; }
+    bool IsEmpty() const { return m_Entries.empty(); }
+
+    /** @brief 读取清单文件（替换当前内容）；文件不存在时返回 false */
+    bool Load(const std::string& path);
+
+    /** @brief 写入清单文件（先写临时文件再重命名） */
+    bool Save(const std::string& path) const;
+
+    /**
+     * @brief 录制：开始记录之后的 Record 调用（任意线程）
+     */
+    static void BeginRecording();
+
+    /** @brief 录制：结束并返回记录下的清单 */
+    static PreloadManifest EndRecording();
+
+    /** @brief 录制：由 SceneAssetLoader 在获取资源时调用；未在录制时直接返回 */
+    static void Record(Kind kind, const std::string& path,
+                       resources::TextureUsage usage = resources::TextureUsage::Color);
+
+private:
+    std::vector<Entry> m_Entries;
+    std::unordered_set<std::string> m_Keys;
+};
+
+} // namespace outer_wilds
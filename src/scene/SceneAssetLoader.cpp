@@ -15,18 +15,27 @@
 #include "SceneAssetLoader.h"
 #include "Scene.h"
 #include "components/TransformComponent.h"
-#include "components/ChildEntityComponent.h"
+#include "components/HierarchyComponent.h"
+#include "TransformSystem.h"
+#include "AssetStreamer.h"
+#include "components/StreamingAssetComponent.h"
 #include "../graphics/components/MeshComponent.h"
+#include "../graphics/components/BoundsComponent.h"
 #include "../graphics/components/RenderableComponent.h"
 #include "../graphics/components/RenderPriorityComponent.h"
 #include "../graphics/resources/OBJLoader.h"
 #include "../graphics/resources/AssimpLoader.h"
 #include "../graphics/resources/TextureLoader.h"
+#include "../graphics/resources/MeshSimplifier.h"
+#include "../graphics/resources/ResourceCache.h"
+#include "../graphics/resources/TextureArrayAtlas.h"
 #include "../core/DebugManager.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <iterator>
 
 namespace outer_wilds {
 
@@ -42,6 +51,108 @@ static std::string GetFileExtension(const std::string& filePath) {
     return ext;
 }
 
+// 辅助函数：挂载包围体组件（优先复用加载器已计算的 ModelBounds，否则从顶点计算）
+static BoundsComponent& AttachBounds(entt::registry& registry, entt::entity entity,
+                                     const Mesh& mesh, const ModelBounds* knownBounds = nullptr) {
+    DirectX::BoundingSphere sphere;
+    if (knownBounds && knownBounds->radius > 0.0f) {
+        sphere = BoundsComponent::SphereFromMinMax(knownBounds->min, knownBounds->max);
+    } else {
+        sphere = BoundsComponent::SphereFromMesh(mesh);
+    }
+    auto& bounds = registry.emplace_or_replace<BoundsComponent>(entity);
+    bounds.SetSphere(sphere);
+    return bounds;
+}
+
+static bool IsAssimpFormat(const std::string& ext) {
+    return ext == "fbx" || ext == "gltf" || ext == "glb" || ext == "dae" || ext == "blend" || ext == "3ds";
+}
+
+// 辅助函数：按路径 + 选项共享的单网格模型（Assimp 或 OBJ；OBJ 的 bounds 保持无效）
+static std::shared_ptr<const LoadedModel> AcquireModel(const std::string& path,
+                                                       const ModelLoadOptions& options = {}) {
+    const bool assimp = IsAssimpFormat(GetFileExtension(path));
+    // OBJLoader 只受 optimizeMeshes 影响
+    ModelLoadOptions keyOptions = options;
+    if (!assimp) {
+        keyOptions.skipBoundsCalculation = false;
+        keyOptions.fastLoad = false;
+    }
+    // 默认选项的获取进入启动预加载清单（PreloadAsset 以默认选项重放）
+    const std::string key = ResourceCache::MakeModelKey(path, keyOptions);
+    if (key == ResourceCache::MakeModelKey(path, {})) {
+        PreloadManifest::Record(PreloadManifest::Kind::Model, path);
+    }
+    // 按值捕获：缓存保留加载函数用于热重载
+    return ResourceCache::GetInstance().AcquireModel(key,
+        [path, options, assimp](LoadedModel& model) {
+            if (assimp) {
+                return AssimpLoader::LoadFromFile(path, model, options);
+            }
+            model.mesh = std::make_shared<Mesh>();
+            return OBJLoader::LoadFromFile(path, *model.mesh, options.optimizeMeshes);
+        });
+}
+
+static std::shared_ptr<const MultiMaterialModel> AcquireMultiMaterialModel(const std::string& path,
+                                                                          bool staticMerge = false) {
+    PreloadManifest::Record(staticMerge ? PreloadManifest::Kind::MergedMultiModel : PreloadManifest::Kind::MultiModel, path);
+    ModelLoadOptions options;
+    options.staticMerge = staticMerge;
+    return ResourceCache::GetInstance().AcquireMultiMaterialModel(
+        ResourceCache::MakeModelKey(path, {}) + (staticMerge ? "|multi-merged" : "|multi"),
+        [path, options](MultiMaterialModel& model) { return AssimpLoader::LoadMultiMaterialModel(path, model, options); });
+}
+
+// 辅助函数：没有纹理时的共享灰色材质
+static std::shared_ptr<Material> AcquireDefaultGrayMaterial() {
+    return ResourceCache::GetInstance().AcquireMaterial("default-gray", []() {
+        auto material = std::make_shared<Material>();
+        material->albedo = DirectX::XMFLOAT4(0.7f, 0.7f, 0.7f, 1.0f);
+        return material;
+    });
+}
+
+// 辅助函数：内嵌纹理内容的缓存键（FNV-1a 64）
+static std::string MakeEmbeddedKey(const std::vector<EmbeddedTexture>& embeddedTextures) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+    };
+    for (const auto& texture : embeddedTextures) {
+        const uint64_t size = texture.data.size();
+        mix(&size, sizeof(size));
+        mix(texture.data.data(), texture.data.size());
+    }
+    char key[32];
+    snprintf(key, sizeof(key), "embedded:%016llx", static_cast<unsigned long long>(hash));
+    return key;
+}
+
+// 辅助函数：内嵌贴图槽位的用途决定烘焙格式（法线 BC5，金属度/粗糙度只采样 .r 用 BC4）
+static TextureUsage EmbeddedSlotUsage(size_t index) {
+    if (index == LoadedModel::NORMAL) return TextureUsage::Normal;
+    if (index == LoadedModel::METALLIC || index == LoadedModel::ROUGHNESS) return TextureUsage::Mask;
+    return TextureUsage::Color;
+}
+
+// 辅助函数：收集一组内嵌贴图中材质会用到的槽位（供 ResourceCache::PrefetchEmbeddedTextures 并行解码）
+static void CollectEmbeddedTextures(const std::vector<EmbeddedTexture>& embeddedTextures,
+                                    std::vector<std::pair<const EmbeddedTexture*, TextureUsage>>& out) {
+    const size_t slots[] = { LoadedModel::ALBEDO, LoadedModel::NORMAL, LoadedModel::METALLIC,
+                             LoadedModel::ROUGHNESS, LoadedModel::EMISSIVE };
+    for (size_t slot : slots) {
+        if (slot < embeddedTextures.size() && !embeddedTextures[slot].data.empty()) {
+            out.emplace_back(&embeddedTextures[slot], EmbeddedSlotUsage(slot));
+        }
+    }
+}
+
 entt::entity SceneAssetLoader::LoadModelAsEntity(
     entt::registry& registry,
     std::shared_ptr<Scene> scene,
@@ -52,46 +163,25 @@ entt::entity SceneAssetLoader::LoadModelAsEntity(
     const DirectX::XMFLOAT3& scale,
     const PhysicsOptions* physicsOpts  // 【忽略】物理选项不再使用
 ) {
-    std::string ext = GetFileExtension(objPath);
-    std::shared_ptr<Mesh> mesh = nullptr;
-    std::vector<std::string> fbxTexturePaths;
-    std::vector<EmbeddedTexture> embeddedTextures;  // For GLB embedded textures
-    
     // ============================================
-    // 根据文件格式加载 Mesh
+    // 根据文件格式加载 Mesh（ResourceCache 共享：同一模型只导入、上传一次）
     // ============================================
-    if (ext == "fbx" || ext == "gltf" || ext == "glb" || ext == "dae" || ext == "blend" || ext == "3ds") {
-        // Use AssimpLoader for FBX, GLTF, GLB and other formats
-        LoadedModel model;
-        if (!AssimpLoader::LoadFromFile(objPath, model)) {
-            DebugManager::GetInstance().Log("SceneAssetLoader", "Assimp loading failed: " + objPath);
-            return entt::null;
-        }
-        mesh = model.mesh;
-        fbxTexturePaths = model.texturePaths;
-        embeddedTextures = model.embeddedTextures;  // Store embedded textures
-        
-        DebugManager::GetInstance().Log("SceneAssetLoader", 
-            "Loaded mesh (Assimp) with " + std::to_string(mesh->GetVertices().size()) + " vertices" +
-            ", embedded textures: " + std::to_string(embeddedTextures.size()));
-    } else {
-        // Use OBJLoader for OBJ files
-        mesh = std::make_shared<Mesh>();
-        if (!OBJLoader::LoadFromFile(objPath, *mesh)) {
-            DebugManager::GetInstance().Log("SceneAssetLoader", "OBJ loading failed: " + objPath);
-            return entt::null;
-        }
-        DebugManager::GetInstance().Log("SceneAssetLoader", 
-            "Loaded mesh (OBJ) with " + std::to_string(mesh->GetVertices().size()) + " vertices");
-    }
-    
-    if (!mesh) {
+    auto model = AcquireModel(objPath);
+    if (!model) {
         DebugManager::GetInstance().Log("SceneAssetLoader", "Failed to load mesh: " + objPath);
         return entt::null;
     }
+    std::shared_ptr<Mesh> mesh = model->mesh;
+    const std::vector<std::string>& fbxTexturePaths = model->texturePaths;
+    const std::vector<EmbeddedTexture>& embeddedTextures = model->embeddedTextures;  // For GLB embedded textures
+    const ModelBounds& modelBounds = model->bounds;  // Assimp 计算的包围盒（OBJ 路径为空）
+
+    DebugManager::GetInstance().Log("SceneAssetLoader", 
+        "Loaded mesh with " + std::to_string(mesh->GetVertexCount()) + " vertices" +
+        ", embedded textures: " + std::to_string(embeddedTextures.size()));
 
     // Create mesh GPU buffers
-    mesh->CreateGPUBuffers(device);
+    ResourceCache::EnsureGPUBuffers(device, *mesh);
 
     // ============================================
     // 材质和纹理处理 - 支持GLB嵌入式纹理
@@ -170,6 +260,7 @@ entt::entity SceneAssetLoader::LoadModelAsEntity(
 
     // Add Mesh component
     registry.emplace<MeshComponent>(entity, mesh, material);
+    AttachBounds(registry, entity, *mesh, &modelBounds);
 
     // Add Render Priority component
     auto& priority = registry.emplace<RenderPriorityComponent>(entity);
@@ -191,55 +282,38 @@ entt::entity SceneAssetLoader::LoadModelAsEntity(
     return entity;
 }
 
-// ========================================
-// 带加载选项的版本（跳过包围盒计算等）
-// ========================================
-entt::entity SceneAssetLoader::LoadModelAsEntityWithOptions(
-    entt::registry& registry,
-    std::shared_ptr<Scene> scene,
-    ID3D11Device* device,
-    const std::string& objPath,
-    const std::string& texturePath,
-    const DirectX::XMFLOAT3& position,
-    const DirectX::XMFLOAT3& scale,
-    const ModelLoadingOptions& options
-) {
-    std::string ext = GetFileExtension(objPath);
-    std::shared_ptr<Mesh> mesh = nullptr;
-    std::vector<std::string> fbxTexturePaths;
-    std::vector<EmbeddedTexture> embeddedTextures;
-    
-    // 设置 Assimp 加载选项
+// 辅助函数：LoadModelAsEntityWithOptions 同步 / 异步两条路径共用的资源准备
+// （导入、GPU 缓冲、材质；不碰 registry，可在加载线程上执行）
+struct ModelResources {
+    std::shared_ptr<const LoadedModel> model;
+    std::shared_ptr<Mesh> mesh;
+    std::shared_ptr<Material> material;
+};
+
+static bool LoadModelResources(ID3D11Device* device, const std::string& objPath, const std::string& texturePath,
+                               const ModelLoadingOptions& options, ModelResources& out) {
+    // 设置 Assimp 加载选项（OBJ 只受 optimizeMeshes 影响）
     resources::ModelLoadOptions assimpOptions;
     assimpOptions.skipBoundsCalculation = options.skipBoundsCalculation;
     assimpOptions.verbose = options.verbose;
     assimpOptions.fastLoad = options.fastLoad;  // 传递快速加载选项
-    
-    if (ext == "fbx" || ext == "gltf" || ext == "glb" || ext == "dae" || ext == "blend" || ext == "3ds") {
-        LoadedModel model;
-        if (!AssimpLoader::LoadFromFile(objPath, model, assimpOptions)) {
-            DebugManager::GetInstance().Log("SceneAssetLoader", "Assimp loading failed: " + objPath);
-            return entt::null;
-        }
-        mesh = model.mesh;
-        fbxTexturePaths = model.texturePaths;
-        embeddedTextures = model.embeddedTextures;
-        
-        if (options.verbose) {
-            DebugManager::GetInstance().Log("SceneAssetLoader", 
-                "Loaded mesh with options: " + std::to_string(mesh->GetVertices().size()) + " vertices" +
-                (options.skipBoundsCalculation ? " (bounds skipped)" : ""));
-        }
-    } else {
-        // OBJ 加载不支持选项，回退到标准加载
-        return LoadModelAsEntity(registry, scene, device, objPath, texturePath, position, scale, nullptr);
+
+    auto model = AcquireModel(objPath, assimpOptions);
+    if (!model) {
+        DebugManager::GetInstance().Log("SceneAssetLoader", "Model loading failed: " + objPath);
+        return false;
     }
-    
-    if (!mesh) {
-        return entt::null;
+    std::shared_ptr<Mesh> mesh = model->mesh;
+    const std::vector<std::string>& fbxTexturePaths = model->texturePaths;
+    const std::vector<EmbeddedTexture>& embeddedTextures = model->embeddedTextures;
+
+    if (options.verbose) {
+        DebugManager::GetInstance().Log("SceneAssetLoader", 
+            "Loaded mesh with options: " + std::to_string(mesh->GetVertexCount()) + " vertices" +
+            (options.skipBoundsCalculation ? " (bounds skipped)" : ""));
     }
 
-    mesh->CreateGPUBuffers(device);
+    ResourceCache::EnsureGPUBuffers(device, *mesh);
 
     // 纹理和材质处理
     // 【修复】优先使用传入的纹理路径，而非嵌入式纹理
@@ -248,7 +322,7 @@ entt::entity SceneAssetLoader::LoadModelAsEntityWithOptions(
     
     // 1. 优先使用传入的纹理路径
     if (!texturePath.empty()) {
-        material = CreateMaterialResource(device, texturePath);
+        material = SceneAssetLoader::CreateMaterialResource(device, texturePath);
         if (material && options.verbose) {
             DebugManager::GetInstance().Log("SceneAssetLoader", 
                 "Using provided texture: " + texturePath);
@@ -265,7 +339,7 @@ entt::entity SceneAssetLoader::LoadModelAsEntityWithOptions(
                                    !embeddedTextures[LoadedModel::EMISSIVE].data.empty();
         
         if (hasEmbeddedAlbedo || hasEmbeddedEmissive) {
-            material = CreateMaterialFromEmbedded(device, embeddedTextures);
+            material = SceneAssetLoader::CreateMaterialFromEmbedded(device, embeddedTextures, options.packTextureArrays);
         }
     }
     
@@ -273,13 +347,54 @@ entt::entity SceneAssetLoader::LoadModelAsEntityWithOptions(
     if (!material && !fbxTexturePaths.empty() && 
         !fbxTexturePaths[LoadedModel::ALBEDO].empty() &&
         fbxTexturePaths[LoadedModel::ALBEDO][0] != '*') {
-        material = CreateMaterialResource(device, fbxTexturePaths[LoadedModel::ALBEDO]);
+        material = SceneAssetLoader::CreateMaterialResource(device, fbxTexturePaths[LoadedModel::ALBEDO]);
+    }
+
+    // 4. OBJ：同名 MTL 文件（只有异步路径会把 OBJ 交到这里）
+    if (!material && !IsAssimpFormat(GetFileExtension(objPath))) {
+        std::string mtlTexturePath = SceneAssetLoader::ParseMTLFile(objPath.substr(0, objPath.find_last_of('.')) + ".mtl");
+        if (!mtlTexturePath.empty()) {
+            if (mtlTexturePath.find("textures/") == 0) {
+                mtlTexturePath = "Texture/" + mtlTexturePath.substr(9);
+            }
+            material = SceneAssetLoader::CreateMaterialResource(device, modelDir + mtlTexturePath);
+        }
     }
     
     if (!material) {
-        material = std::make_shared<Material>();
-        material->albedo = DirectX::XMFLOAT4(0.7f, 0.7f, 0.7f, 1.0f);
+        material = AcquireDefaultGrayMaterial();
+    }
+
+    out.model = std::move(model);
+    out.mesh = std::move(mesh);
+    out.material = std::move(material);
+    return true;
+}
+
+// ========================================
+// 带加载选项的版本（跳过包围盒计算等）
+// ========================================
+entt::entity SceneAssetLoader::LoadModelAsEntityWithOptions(
+    entt::registry& registry,
+    std::shared_ptr<Scene> scene,
+    ID3D11Device* device,
+    const std::string& objPath,
+    const std::string& texturePath,
+    const DirectX::XMFLOAT3& position,
+    const DirectX::XMFLOAT3& scale,
+    const ModelLoadingOptions& options
+) {
+    // OBJ 加载不支持选项，回退到标准加载
+    if (!IsAssimpFormat(GetFileExtension(objPath))) {
+        return LoadModelAsEntity(registry, scene, device, objPath, texturePath, position, scale, nullptr);
+    }
+
+    ModelResources assets;
+    if (!LoadModelResources(device, objPath, texturePath, options, assets)) {
+        return entt::null;
     }
+    std::shared_ptr<Mesh> mesh = assets.mesh;
+    std::shared_ptr<Material> material = assets.material;
 
     entt::entity entity = registry.create();
 
@@ -289,6 +404,7 @@ entt::entity SceneAssetLoader::LoadModelAsEntityWithOptions(
     transform.rotation = DirectX::XMFLOAT4(0, 0, 0, 1);
 
     registry.emplace<MeshComponent>(entity, mesh, material);
+    AttachBounds(registry, entity, *mesh, &assets.model->bounds);
 
     auto& priority = registry.emplace<RenderPriorityComponent>(entity);
     priority.sortKey = 1000;
@@ -302,6 +418,104 @@ entt::entity SceneAssetLoader::LoadModelAsEntityWithOptions(
     return entity;
 }
 
+// 辅助函数：异步加载期间的共享占位网格（单位八面体）
+static std::shared_ptr<Mesh> AcquirePlaceholderMesh(ID3D11Device* device) {
+    static std::shared_ptr<Mesh> s_Placeholder = [device]() {
+        const DirectX::XMFLOAT3 axes[6] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+        std::vector<Vertex> vertices(6);
+        for (int i = 0; i < 6; i++) {
+            vertices[i].position = axes[i];
+            vertices[i].normal = axes[i];
+            vertices[i].texCoord = DirectX::XMFLOAT2(0.5f, 0.5f);
+            vertices[i].tangent = DirectX::XMFLOAT3(axes[i].y + axes[i].z, axes[i].x, 0.0f);
+        }
+        const std::vector<uint32_t> indices = {
+            0, 2, 4,  2, 1, 4,  1, 3, 4,  3, 0, 4,
+            2, 0, 5,  1, 2, 5,  3, 1, 5,  0, 3, 5,
+        };
+        auto mesh = std::make_shared<Mesh>();
+        mesh->SetVertices(vertices);
+        mesh->SetIndices(indices);
+        mesh->CreateGPUBuffers(device);
+        return mesh;
+    }();
+    return s_Placeholder;
+}
+
+ModelLoadHandle SceneAssetLoader::LoadModelAsEntityAsync(
+    entt::registry& registry,
+    std::shared_ptr<Scene> scene,
+    ID3D11Device* device,
+    const std::string& objPath,
+    const std::string& texturePath,
+    const DirectX::XMFLOAT3& position,
+    const DirectX::XMFLOAT3& scale,
+    const ModelLoadingOptions& options
+) {
+    (void)scene;
+
+    entt::entity entity = registry.create();
+
+    auto& transform = registry.emplace<TransformComponent>(entity);
+    transform.position = position;
+    transform.scale = scale;
+    transform.rotation = DirectX::XMFLOAT4(0, 0, 0, 1);
+
+    // 占位符：没有 BoundsComponent，始终参与渲染，直到真实网格换上
+    registry.emplace<MeshComponent>(entity, AcquirePlaceholderMesh(device), AcquireDefaultGrayMaterial());
+
+    auto& priority = registry.emplace<RenderPriorityComponent>(entity);
+    priority.sortKey = 1000;
+    priority.renderPass = 0;
+
+    auto promise = std::make_shared<std::promise<bool>>();
+    ModelLoadHandle handle;
+    handle.entity = entity;
+    handle.ready = promise->get_future().share();
+
+    const uint32_t requestId = AssetStreamer::GetInstance().Submit(
+        [device, objPath, texturePath, options, entity, promise]() -> AssetStreamer::ApplyFn {
+            // 加载线程：不访问 registry
+            auto assets = std::make_shared<ModelResources>();
+            const bool loaded = LoadModelResources(device, objPath, texturePath, options, *assets);
+
+            return [loaded, assets, entity, promise, objPath, verbose = options.verbose](entt::registry& registry) {
+                // entt::entity 带版本号：实体销毁后 ID 被复用也不会 valid
+                if (!registry.valid(entity) || !registry.all_of<StreamingAssetComponent>(entity)) {
+                    promise->set_value(false);
+                    return;
+                }
+                if (!loaded) {
+                    registry.remove<StreamingAssetComponent>(entity);
+                    promise->set_value(false);
+                    return;
+                }
+
+                // patch 触发 on_update：RenderQueue 的保留模式缓存据此重建批次
+                if (registry.all_of<MeshComponent>(entity)) {
+                    registry.patch<MeshComponent>(entity, [&](MeshComponent& meshComponent) {
+                        meshComponent.mesh = assets->mesh;
+                        meshComponent.material = assets->material;
+                    });
+                } else {
+                    registry.emplace<MeshComponent>(entity, assets->mesh, assets->material);
+                }
+                AttachBounds(registry, entity, *assets->mesh, &assets->model->bounds);
+                registry.remove<StreamingAssetComponent>(entity);
+
+                if (verbose) {
+                    DebugManager::GetInstance().Log("SceneAssetLoader", "Streamed entity from " + objPath);
+                }
+                promise->set_value(true);
+            };
+        });
+
+    // ApplyFn 只在主线程的 ApplyCompleted 中执行，Submit 之后再挂标记不会错过
+    registry.emplace<StreamingAssetComponent>(entity).requestId = requestId;
+    handle.requestId = requestId;
+    return handle;
+}
+
 int SceneAssetLoader::LoadSceneFromFile(
     entt::registry& registry,
     std::shared_ptr<Scene> scene,
@@ -320,70 +534,59 @@ int SceneAssetLoader::LoadSceneFromFile(
 }
 
 std::shared_ptr<Mesh> SceneAssetLoader::LoadMeshResource(const std::string& objPath) {
-    std::string ext = GetFileExtension(objPath);
-    
-    if (ext == "fbx" || ext == "gltf" || ext == "glb" || ext == "dae" || ext == "blend" || ext == "3ds") {
-        LoadedModel model;
-        if (!AssimpLoader::LoadFromFile(objPath, model)) {
-            DebugManager::GetInstance().Log("SceneAssetLoader", "Assimp loading failed: " + objPath);
-            return nullptr;
-        }
-        
-        DebugManager::GetInstance().Log("SceneAssetLoader", 
-            "Loaded mesh (Assimp) with " + std::to_string(model.mesh->GetVertices().size()) + " vertices");
-        
-        return model.mesh;
-    }
-    
-    auto mesh = std::make_shared<Mesh>();
-    
-    if (!OBJLoader::LoadFromFile(objPath, *mesh)) {
-        DebugManager::GetInstance().Log("SceneAssetLoader", "OBJ loading failed: " + objPath);
+    auto model = AcquireModel(objPath);
+    if (!model) {
+        DebugManager::GetInstance().Log("SceneAssetLoader", "Mesh loading failed: " + objPath);
         return nullptr;
     }
 
     DebugManager::GetInstance().Log("SceneAssetLoader", 
-        "Loaded mesh with " + std::to_string(mesh->GetVertices().size()) + " vertices");
+        "Loaded mesh with " + std::to_string(model->mesh->GetVertexCount()) + " vertices");
 
-    return mesh;
+    return model->mesh;
 }
 
 std::shared_ptr<Material> SceneAssetLoader::CreateMaterialResource(
     ID3D11Device* device,
     const std::string& texturePath
 ) {
-    auto material = std::make_shared<Material>();
-    
-    // Set default PBR values
-    material->albedo = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-    material->metallic = 0.0f;
-    material->roughness = 0.5f;
-    material->ao = 1.0f;
-    material->isTransparent = false;
+    PreloadManifest::Record(PreloadManifest::Kind::Texture, texturePath, TextureUsage::Color);
+    // 同一纹理的材质只创建一次（共享材质，调用方不要修改）
+    return ResourceCache::GetInstance().AcquireMaterial("albedo:" + texturePath, [&]() {
+        auto material = std::make_shared<Material>();
+    
+        // Set default PBR values
+        material->albedo = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        material->metallic = 0.0f;
+        material->roughness = 0.5f;
+        material->ao = 1.0f;
+        material->isTransparent = false;
 
-    // Load texture if provided
-    if (!texturePath.empty()) {
-        material->albedoTexture = texturePath;
+        // Load texture if provided
+        if (!texturePath.empty()) {
+            material->albedoTexture = texturePath;
         
-        ID3D11ShaderResourceView* textureSRV = nullptr;
-        if (TextureLoader::LoadFromFile(device, texturePath, &textureSRV)) {
-            material->albedoTextureSRV = textureSRV;
-            material->shaderProgram = textureSRV;
+            ID3D11ShaderResourceView* textureSRV =
+                ResourceCache::GetInstance().AcquireTexture(device, texturePath, TextureUsage::Color);
+            if (textureSRV) {
+                material->albedoTextureSRV = textureSRV;
+                material->shaderProgram = textureSRV;
             
-            DebugManager::GetInstance().Log("SceneAssetLoader", 
-                "Texture loaded successfully: " + texturePath);
+                DebugManager::GetInstance().Log("SceneAssetLoader", 
+                    "Texture loaded successfully: " + texturePath);
+            } else {
+                DebugManager::GetInstance().Log("SceneAssetLoader", 
+                    "Failed to load texture: " + texturePath);
+                material->albedoTextureSRV = nullptr;
+                material->shaderProgram = nullptr;
+            }
         } else {
-            DebugManager::GetInstance().Log("SceneAssetLoader", 
-                "Failed to load texture: " + texturePath);
             material->albedoTextureSRV = nullptr;
             material->shaderProgram = nullptr;
         }
-    } else {
-        material->albedoTextureSRV = nullptr;
-        material->shaderProgram = nullptr;
-    }
 
-    return material;
+        return material;
+    });
 }
 
 std::shared_ptr<Material> SceneAssetLoader::CreatePBRMaterial(
@@ -393,109 +596,131 @@ std::shared_ptr<Material> SceneAssetLoader::CreatePBRMaterial(
     const std::string& metallicPath,
     const std::string& roughnessPath
 ) {
-    auto material = std::make_shared<Material>();
-    
-    material->albedo = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-    material->metallic = 0.0f;
-    material->roughness = 0.5f;
-    material->ao = 1.0f;
-    material->isTransparent = false;
-    
-    // Helper lambda to load texture
-    auto loadTexture = [&](const std::string& path, void** outSRV, std::string& outPath) -> bool {
-        if (path.empty()) return false;
+    PreloadManifest::Record(PreloadManifest::Kind::Texture, albedoPath, TextureUsage::Color);
+    PreloadManifest::Record(PreloadManifest::Kind::Texture, normalPath, TextureUsage::Normal);
+    PreloadManifest::Record(PreloadManifest::Kind::Texture, metallicPath, TextureUsage::Mask);
+    PreloadManifest::Record(PreloadManifest::Kind::Texture, roughnessPath, TextureUsage::Mask);
+    // 同一组纹理的材质只创建一次；纹理 SRV 由 ResourceCache 共享
+    return ResourceCache::GetInstance().AcquireMaterial("pbr:" + albedoPath + "|" + normalPath + "|" + metallicPath + "|" + roughnessPath, [&]() {
+        auto material = std::make_shared<Material>();
+    
+        material->albedo = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        material->metallic = 0.0f;
+        material->roughness = 0.5f;
+        material->ao = 1.0f;
+        material->isTransparent = false;
+    
+        // Helper lambda to load texture
+        auto loadTexture = [&](const std::string& path, void** outSRV, std::string& outPath,
+                               TextureUsage usage) -> bool {
+            if (path.empty()) return false;
         
-        outPath = path;
-        ID3D11ShaderResourceView* srv = nullptr;
-        if (TextureLoader::LoadFromFile(device, path, &srv)) {
+            outPath = path;
+            ID3D11ShaderResourceView* srv = ResourceCache::GetInstance().AcquireTexture(device, path, usage);
             *outSRV = srv;
-            return true;
-        }
-        return false;
-    };
+            return srv != nullptr;
+        };
     
-    loadTexture(albedoPath, &material->albedoTextureSRV, material->albedoTexture);
-    loadTexture(normalPath, &material->normalTextureSRV, material->normalTexture);
-    loadTexture(metallicPath, &material->metallicTextureSRV, material->metallicTexture);
-    loadTexture(roughnessPath, &material->roughnessTextureSRV, material->roughnessTexture);
+        loadTexture(albedoPath, &material->albedoTextureSRV, material->albedoTexture, TextureUsage::Color);
+        loadTexture(normalPath, &material->normalTextureSRV, material->normalTexture, TextureUsage::Normal);
+        loadTexture(metallicPath, &material->metallicTextureSRV, material->metallicTexture, TextureUsage::Mask);
+        loadTexture(roughnessPath, &material->roughnessTextureSRV, material->roughnessTexture, TextureUsage::Mask);
     
-    material->shaderProgram = material->albedoTextureSRV;
+        material->shaderProgram = material->albedoTextureSRV;
+        material->CreateGPUBuffer(device);
     
-    return material;
+        return material;
+    });
 }
 
 std::shared_ptr<Material> SceneAssetLoader::CreateMaterialFromEmbedded(
     ID3D11Device* device,
-    const std::vector<EmbeddedTexture>& embeddedTextures
+    const std::vector<EmbeddedTexture>& embeddedTextures,
+    bool packTextureArrays
 ) {
-    auto material = std::make_shared<Material>();
-    
-    material->albedo = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-    material->metallic = 0.0f;
-    material->roughness = 0.5f;
-    material->ao = 1.0f;
-    material->isTransparent = false;
+    // 按内嵌纹理内容去重（同一 GLB 的多个实例、共用贴图的子网格共享一个材质）；打包与否是不同的材质
+    const std::string key = MakeEmbeddedKey(embeddedTextures) + (packTextureArrays ? "|array" : "");
+    return ResourceCache::GetInstance().AcquireMaterial(key, [&]() {
+        auto material = std::make_shared<Material>();
+    
+        material->albedo = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        material->metallic = 0.0f;
+        material->roughness = 0.5f;
+        material->ao = 1.0f;
+        material->isTransparent = false;
+    
+        std::cout << "[SceneAssetLoader] CreateMaterialFromEmbedded called with " 
+                  << embeddedTextures.size() << " texture slots" << std::endl;
+
+        // 本材质的贴图并行解码（多材质加载器已为整个模型预取时全部命中）
+        std::vector<std::pair<const EmbeddedTexture*, TextureUsage>> prefetch;
+        CollectEmbeddedTextures(embeddedTextures, prefetch);
+        ResourceCache::GetInstance().PrefetchEmbeddedTextures(device, prefetch);
+    
+        // Helper lambda to load embedded texture（SRV 归 ResourceCache 所有，按内容共享）
+        auto loadEmbeddedTexture = [&](size_t index, void** outSRV, std::string& outPath) -> bool {
+            if (index >= embeddedTextures.size() || embeddedTextures[index].data.empty()) {
+                return false;
+            }
+        
+            const auto& tex = embeddedTextures[index];
+            ID3D11ShaderResourceView* srv =
+                ResourceCache::GetInstance().AcquireEmbeddedTexture(device, tex, EmbeddedSlotUsage(index));
+            if (srv) {
+                *outSRV = srv;
+                outPath = "[embedded:" + std::to_string(index) + "]";
+                std::cout << "[SceneAssetLoader] Successfully created SRV for slot " << index << std::endl;
+                return true;
+            }
+            std::cout << "[SceneAssetLoader] Failed to create SRV for slot " << index << std::endl;
+            return false;
+        };
     
-    std::cout << "[SceneAssetLoader] CreateMaterialFromEmbedded called with " 
-              << embeddedTextures.size() << " texture slots" << std::endl;
+        // Load PBR textures from embedded data
+        loadEmbeddedTexture(LoadedModel::ALBEDO, &material->albedoTextureSRV, material->albedoTexture);
+        loadEmbeddedTexture(LoadedModel::NORMAL, &material->normalTextureSRV, material->normalTexture);
+        loadEmbeddedTexture(LoadedModel::METALLIC, &material->metallicTextureSRV, material->metallicTexture);
+        loadEmbeddedTexture(LoadedModel::ROUGHNESS, &material->roughnessTextureSRV, material->roughnessTexture);
+        loadEmbeddedTexture(LoadedModel::EMISSIVE, &material->emissiveTextureSRV, material->emissiveTexture);
     
-    // Helper lambda to load embedded texture
-    auto loadEmbeddedTexture = [&](size_t index, void** outSRV, std::string& outPath) -> bool {
-        if (index >= embeddedTextures.size() || embeddedTextures[index].data.empty()) {
-            return false;
+        // Check if we have emissive texture - set emissive flag and strength
+        if (material->emissiveTextureSRV) {
+            material->isEmissive = true;
+            material->emissiveStrength = 0.8f;  // 降低emissive强度到0.8，减少过亮导致的视觉问题
+            material->emissiveColor = { 1.0f, 1.0f, 1.0f };
+            std::cout << "[SceneAssetLoader] Emissive texture found! Setting isEmissive=true, strength=0.8" << std::endl;
         }
+    
+        // Check if we got at least an albedo texture
+        if (!material->albedoTextureSRV) {
+            std::cout << "[SceneAssetLoader] Warning: No albedo texture loaded" << std::endl;
         
-        const auto& tex = embeddedTextures[index];
-        ID3D11ShaderResourceView* srv = nullptr;
-        
-        std::cout << "[SceneAssetLoader] Loading embedded texture slot " << index 
-                  << " (size=" << tex.data.size() << " bytes)" << std::endl;
-        
-        if (AssimpLoader::CreateTextureFromEmbedded(device, tex, &srv)) {
-            *outSRV = srv;
-            outPath = "[embedded:" + std::to_string(index) + "]";
-            std::cout << "[SceneAssetLoader] Successfully created SRV for slot " << index << std::endl;
-            return true;
+            // 如果有 emissive 但没有 albedo，把 emissive 也设置为 albedo（显示颜色）
+            if (material->emissiveTextureSRV) {
+                material->albedoTextureSRV = material->emissiveTextureSRV;
+                material->albedoTexture = material->emissiveTexture;
+                std::cout << "[SceneAssetLoader] Using emissive texture as albedo fallback" << std::endl;
+            }
         }
-        std::cout << "[SceneAssetLoader] Failed to create SRV for slot " << index << std::endl;
-        return false;
-    };
-    
-    // Load PBR textures from embedded data
-    loadEmbeddedTexture(LoadedModel::ALBEDO, &material->albedoTextureSRV, material->albedoTexture);
-    loadEmbeddedTexture(LoadedModel::NORMAL, &material->normalTextureSRV, material->normalTexture);
-    loadEmbeddedTexture(LoadedModel::METALLIC, &material->metallicTextureSRV, material->metallicTexture);
-    loadEmbeddedTexture(LoadedModel::ROUGHNESS, &material->roughnessTextureSRV, material->roughnessTexture);
-    loadEmbeddedTexture(LoadedModel::EMISSIVE, &material->emissiveTextureSRV, material->emissiveTexture);
-    
-    // Check if we have emissive texture - set emissive flag and strength
-    if (material->emissiveTextureSRV) {
-        material->isEmissive = true;
-        material->emissiveStrength = 0.8f;  // 降低emissive强度到0.8，减少过亮导致的视觉问题
-        material->emissiveColor = { 1.0f, 1.0f, 1.0f };
-        std::cout << "[SceneAssetLoader] Emissive texture found! Setting isEmissive=true, strength=0.8" << std::endl;
-    }
     
-    // Check if we got at least an albedo texture
-    if (!material->albedoTextureSRV) {
-        std::cout << "[SceneAssetLoader] Warning: No albedo texture loaded" << std::endl;
-        
-        // 如果有 emissive 但没有 albedo，把 emissive 也设置为 albedo（显示颜色）
-        if (material->emissiveTextureSRV) {
-            material->albedoTextureSRV = material->emissiveTextureSRV;
-            material->albedoTexture = material->emissiveTexture;
-            std::cout << "[SceneAssetLoader] Using emissive texture as albedo fallback" << std::endl;
+        material->shaderProgram = material->albedoTextureSRV;
+
+        // 同尺寸 / 格式的贴图复制进共享数组（不适合时保持独立贴图），层下标随 MaterialBuffer 一起创建
+        if (packTextureArrays) {
+            const bool packed = resources::TextureArrayAtlas::GetInstance().Pack(device, *material);
+            std::cout << "[SceneAssetLoader] Texture array packing: " << (packed ? "packed" : "kept separate") << std::endl;
         }
-    }
     
-    material->shaderProgram = material->albedoTextureSRV;
+        std::cout << "[SceneAssetLoader] Created material: albedo=" 
+                  << (material->albedoTextureSRV ? "yes" : "no")
+                  << ", emissive=" << (material->emissiveTextureSRV ? "yes" : "no")
+                  << ", isEmissive=" << (material->isEmissive ? "true" : "false") << std::endl;
     
-    std::cout << "[SceneAssetLoader] Created material: albedo=" 
-              << (material->albedoTextureSRV ? "yes" : "no")
-              << ", emissive=" << (material->emissiveTextureSRV ? "yes" : "no")
-              << ", isEmissive=" << (material->isEmissive ? "true" : "false") << std::endl;
+        // 发光参数已确定，创建 MaterialBuffer（之后修改参数时由 RenderQueue 重新上传）
+        material->CreateGPUBuffer(device);
     
-    return material;
+        return material;
+    });
 }
 
 std::string SceneAssetLoader::ParseMTLFile(const std::string& mtlPath) {
@@ -523,6 +748,116 @@ std::string SceneAssetLoader::ParseMTLFile(const std::string& mtlPath) {
 // Multi-Material Model Loading
 // ============================================================================
 
+// 辅助函数：纹理目录（为空时取模型所在目录），保证以分隔符结尾
+static std::string ResolveTextureDir(const std::string& modelPath, const std::string& textureDir) {
+    std::string texDir = textureDir;
+    if (texDir.empty()) {
+        texDir = modelPath.substr(0, modelPath.find_last_of("/\\") + 1);
+    }
+    if (!texDir.empty() && texDir.back() != '/' && texDir.back() != '\\') {
+        texDir += "\\";
+    }
+    return texDir;
+}
+
+// 辅助函数：按材质名在纹理目录中匹配反照率贴图（目前只有 SciFiTrooper 的贴图命名规则）；未匹配返回空
+static std::string MatchTextureByMaterialName(const std::string& modelPath, const std::string& texDir,
+                                              const std::string& materialName) {
+    if (modelPath.find("SciFiTrooperManV3") == std::string::npos) return "";
+    std::string matNameLower = materialName;
+    std::transform(matNameLower.begin(), matNameLower.end(), matNameLower.begin(), ::tolower);
+    if (matNameLower.find("02") != std::string::npos) return texDir + "T_SciFiTrooperV3_bottom_a.png";
+    if (matNameLower.find("03") != std::string::npos) return texDir + "T_SciFiTrooperV3_top_a.png";
+    return "";
+}
+
+// 辅助函数：所有子网格写入一个 MultiMeshComponent（材质优先使用内嵌纹理，其次纹理目录中按材质名匹配，
+// 最后是模型引用的外部纹理），包围体整体 + 子网格单独剔除
+static MultiMeshComponent& EmplaceMultiMesh(entt::registry& registry, entt::entity entity,
+                                            ID3D11Device* device, const MultiMaterialModel& model,
+                                            const std::string& modelPath, const std::string& textureDir,
+                                            bool packTextureArrays = false) {
+    const std::string texDir = ResolveTextureDir(modelPath, textureDir);
+    auto& multiMesh = registry.emplace<MultiMeshComponent>(entity);
+    std::vector<DirectX::BoundingSphere> subMeshBounds;
+    
+    std::cout << "[SceneAssetLoader] Processing " << model.subMeshes.size() 
+              << " sub-meshes for multi-material model" << std::endl;
+
+    // 整个模型的内嵌贴图一次并行解码（各材质共用的贴图只解码一次）
+    {
+        std::vector<std::pair<const EmbeddedTexture*, TextureUsage>> prefetch;
+        for (const auto& subMesh : model.subMeshes) {
+            CollectEmbeddedTextures(subMesh.embeddedTextures, prefetch);
+        }
+        ResourceCache::GetInstance().PrefetchEmbeddedTextures(device, prefetch);
+    }
+    
+    for (size_t i = 0; i < model.subMeshes.size(); i++) {
+        const auto& subMesh = model.subMeshes[i];
+        
+        // 创建 GPU 缓冲
+        ResourceCache::EnsureGPUBuffers(device, *subMesh.mesh);
+        
+        // 创建材质（优先使用嵌入纹理）
+        std::shared_ptr<Material> material = nullptr;
+        
+        // 检查嵌入纹理
+        if (!subMesh.embeddedTextures.empty()) {
+            bool hasAlbedo = subMesh.embeddedTextures.size() > LoadedModel::ALBEDO &&
+                            !subMesh.embeddedTextures[LoadedModel::ALBEDO].data.empty();
+            bool hasEmissive = subMesh.embeddedTextures.size() > LoadedModel::EMISSIVE &&
+                              !subMesh.embeddedTextures[LoadedModel::EMISSIVE].data.empty();
+            
+            if (hasAlbedo || hasEmissive) {
+                material = CreateMaterialFromEmbedded(device, subMesh.embeddedTextures, packTextureArrays);
+                std::cout << "[SceneAssetLoader] SubMesh " << i << " (" << subMesh.materialName 
+                          << "): using embedded texture" << std::endl;
+            }
+        }
+        
+        // 没有嵌入纹理：纹理目录中按材质名匹配
+        if (!material) {
+            const std::string matched = MatchTextureByMaterialName(modelPath, texDir, subMesh.materialName);
+            if (!matched.empty()) {
+                material = CreateMaterialResource(device, matched);
+                std::cout << "[SceneAssetLoader] SubMesh " << i << " (" << subMesh.materialName
+                          << "): matched texture " << matched << std::endl;
+            }
+        }
+        
+        // 仍然没有材质，尝试外部纹理
+        if (!material && !subMesh.texturePaths.empty() && !subMesh.texturePaths[0].empty()) {
+            if (subMesh.texturePaths[0][0] != '*') {  // 不是嵌入纹理引用
+                material = CreateMaterialResource(device, subMesh.texturePaths[0]);
+                std::cout << "[SceneAssetLoader] SubMesh " << i << " (" << subMesh.materialName 
+                          << "): using external texture " << subMesh.texturePaths[0] << std::endl;
+            }
+        }
+        
+        // 如果还是没有材质，创建默认材质
+        if (!material) {
+            material = AcquireDefaultGrayMaterial();
+            std::cout << "[SceneAssetLoader] SubMesh " << i << " (" << subMesh.materialName 
+                      << "): using default gray material" << std::endl;
+        }
+        
+        // 添加到多 mesh 组件
+        multiMesh.meshes.push_back(subMesh.mesh);
+        multiMesh.materials.push_back(material);
+        multiMesh.lods.push_back(ResourceCache::GetInstance().AcquireLODChain(subMesh.mesh,
+            [&]() { return GenerateLODChain(device, *subMesh.mesh); }));
+        subMeshBounds.push_back(BoundsComponent::SphereFromMesh(*subMesh.mesh));
+    }
+    
+    // 包围体：整体使用 model.bounds，子 mesh 单独剔除
+    auto& bounds = registry.emplace_or_replace<BoundsComponent>(entity);
+    bounds.SetSphere(BoundsComponent::SphereFromMinMax(model.bounds.min, model.bounds.max));
+    bounds.subMeshBounds = std::move(subMeshBounds);
+    
+    return multiMesh;
+}
+
 entt::entity SceneAssetLoader::LoadMultiMaterialModelAsEntities(
     entt::registry& registry,
     std::shared_ptr<Scene> scene,
@@ -530,57 +865,59 @@ entt::entity SceneAssetLoader::LoadMultiMaterialModelAsEntities(
     const std::string& modelPath,
     const std::string& textureDir,
     const DirectX::XMFLOAT3& position,
-    const DirectX::XMFLOAT3& scale
+    const DirectX::XMFLOAT3& scale,
+    bool staticMerge,
+    bool packTextureArrays
 ) {
     DebugManager::GetInstance().Log("SceneAssetLoader", "Loading multi-material model: " + modelPath);
     
-    // Load multi-material model
-    MultiMaterialModel model;
-    if (!AssimpLoader::LoadMultiMaterialModel(modelPath, model)) {
+    // Load multi-material model（共享；空模型不会进入缓存）
+    auto sharedModel = AcquireMultiMaterialModel(modelPath, staticMerge);
+    if (!sharedModel) {
         DebugManager::GetInstance().Log("SceneAssetLoader", "Failed to load multi-material model: " + modelPath);
         return entt::null;
     }
+    const MultiMaterialModel& model = *sharedModel;
     
-    if (model.subMeshes.empty()) {
-        DebugManager::GetInstance().Log("SceneAssetLoader", "No sub-meshes found in model");
-        return entt::null;
+    if (staticMerge) {
+        // 静态合并：每种材质一个模型空间子网格，整体一个 MultiMeshComponent 实体
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<TransformComponent>(entity);
+        transform.position = position;
+        transform.scale = scale;
+        transform.rotation = DirectX::XMFLOAT4(0, 0, 0, 1);
+        auto& priority = registry.emplace<RenderPriorityComponent>(entity);
+        priority.sortKey = 1000;
+        priority.renderPass = 0;
+        
+        const auto& multiMesh = EmplaceMultiMesh(registry, entity, device, model, modelPath, textureDir,
+                                                 packTextureArrays);
+        DebugManager::GetInstance().Log("SceneAssetLoader",
+            "Multi-material model loaded (static merge): " + std::to_string(multiMesh.meshes.size()) + " sub-meshes");
+        return entity;
     }
     
     // Determine texture directory
-    std::string texDir = textureDir;
-    if (texDir.empty()) {
-        texDir = modelPath.substr(0, modelPath.find_last_of("/\\") + 1);
-    }
-    if (!texDir.empty() && texDir.back() != '/' && texDir.back() != '\\') {
-        texDir += "\\";
-    }
-    
-    bool isSciFiTrooper = modelPath.find("SciFiTrooperManV3") != std::string::npos;
-    std::cout << "[SceneAssetLoader] isSciFiTrooper=" << isSciFiTrooper << ", texDir=" << texDir << std::endl;
-    
-    // Create main entity from FIRST submesh (this is the entity that will receive components)
-    entt::entity mainEntity = entt::null;
+    const std::string texDir = ResolveTextureDir(modelPath, textureDir);
+    std::cout << "[SceneAssetLoader] texDir=" << texDir << std::endl;
+    
+    // 每个子网格一个实体：先解析材质，再一次性批量创建实体、整段写入组件
+    std::vector<MeshComponent> meshComponents;
+    std::vector<BoundsComponent> boundsComponents;
+    meshComponents.reserve(model.subMeshes.size());
+    boundsComponents.reserve(model.subMeshes.size());
     int subMeshIndex = 0;
     
-    for (auto& subMesh : model.subMeshes) {
+    for (const auto& subMesh : model.subMeshes) {
         std::cout << "[SceneAssetLoader] Processing subMesh " << subMeshIndex 
                   << ": " << subMesh.materialName << std::endl;
         
         // Create GPU buffers for mesh
-        subMesh.mesh->CreateGPUBuffers(device);
+        ResourceCache::EnsureGPUBuffers(device, *subMesh.mesh);
         
         // Find texture for this material
-        std::string albedoPath = "";
-        
-        if (isSciFiTrooper) {
-            std::string matNameLower = subMesh.materialName;
-            std::transform(matNameLower.begin(), matNameLower.end(), matNameLower.begin(), ::tolower);
-            
-            if (matNameLower.find("02") != std::string::npos) {
-                albedoPath = texDir + "T_SciFiTrooperV3_bottom_a.png";
-            } else if (matNameLower.find("03") != std::string::npos) {
-                albedoPath = texDir + "T_SciFiTrooperV3_top_a.png";
-            }
+        std::string albedoPath = MatchTextureByMaterialName(modelPath, texDir, subMesh.materialName);
+        if (!albedoPath.empty()) {
             std::cout << "[SceneAssetLoader] Matched texture: " << albedoPath << std::endl;
         }
         
@@ -593,40 +930,45 @@ entt::entity SceneAssetLoader::LoadMultiMaterialModelAsEntities(
         // Create material
         auto material = CreateMaterialResource(device, albedoPath);
         if (!material) {
-            material = std::make_shared<Material>();
-            material->albedo = DirectX::XMFLOAT4(0.7f, 0.7f, 0.7f, 1.0f);
+            material = AcquireDefaultGrayMaterial();
         }
         
-        // Create entity
-        entt::entity entity = registry.create();
-        
-        auto& transform = registry.emplace<TransformComponent>(entity);
-        transform.position = position;
-        transform.scale = scale;
-        // Initial rotation will be set by PlayerSystem based on gravity and look direction
-        transform.rotation = DirectX::XMFLOAT4(0, 0, 0, 1);
-        
-        registry.emplace<MeshComponent>(entity, subMesh.mesh, material);
-        
-        auto& priority = registry.emplace<RenderPriorityComponent>(entity);
-        priority.sortKey = 1000;
-        priority.renderPass = 0;
-        
-        if (mainEntity == entt::null) {
-            // First submesh becomes the main entity
-            mainEntity = entity;
-            std::cout << "[SceneAssetLoader] Created MAIN entity " << static_cast<uint32_t>(entity) << std::endl;
-        } else {
-            // Subsequent submeshes become child entities
-            auto& childComp = registry.emplace<ChildEntityComponent>(entity);
-            childComp.parent = mainEntity;
-            std::cout << "[SceneAssetLoader] Created CHILD entity " << static_cast<uint32_t>(entity) 
-                      << " -> parent " << static_cast<uint32_t>(mainEntity) << std::endl;
-        }
+        meshComponents.emplace_back(subMesh.mesh, material);
+        boundsComponents.emplace_back().SetSphere(BoundsComponent::SphereFromMesh(*subMesh.mesh));
         
         subMeshIndex++;
     }
     
+    std::vector<entt::entity> entities(meshComponents.size());
+    registry.create(entities.begin(), entities.end());
+    
+    TransformComponent transform;
+    transform.position = position;
+    transform.scale = scale;
+    // Initial rotation will be set by PlayerSystem based on gravity and look direction
+    transform.rotation = DirectX::XMFLOAT4(0, 0, 0, 1);
+    
+    RenderPriorityComponent priority;
+    priority.sortKey = 1000;
+    priority.renderPass = 0;
+    
+    registry.insert<TransformComponent>(entities.begin(), entities.end(), transform);
+    registry.insert<MeshComponent>(entities.begin(), entities.end(), meshComponents.begin());
+    registry.insert<BoundsComponent>(entities.begin(), entities.end(), boundsComponents.begin());
+    registry.insert<RenderPriorityComponent>(entities.begin(), entities.end(), priority);
+    
+    // First submesh becomes the main entity
+    entt::entity mainEntity = entities.front();
+    std::cout << "[SceneAssetLoader] Created MAIN entity " << static_cast<uint32_t>(mainEntity) << std::endl;
+    
+    // Subsequent submeshes become child entities. 子网格顶点与主实体同在模型空间，
+    // 局部变换为单位变换；Transform 由 TransformSystem 从主实体推导
+    for (size_t i = 1; i < entities.size(); i++) {
+        TransformSystem::Attach(registry, entities[i], mainEntity);
+        std::cout << "[SceneAssetLoader] Created CHILD entity " << static_cast<uint32_t>(entities[i]) 
+                  << " -> parent " << static_cast<uint32_t>(mainEntity) << std::endl;
+    }
+    
     DebugManager::GetInstance().Log("SceneAssetLoader", 
         "Multi-material model loaded: " + std::to_string(model.subMeshes.size()) + " submeshes");
     
@@ -643,28 +985,17 @@ bool SceneAssetLoader::GetModelBounds(
 ) {
     std::string ext = GetFileExtension(modelPath);
     
-    if (ext == "fbx" || ext == "gltf" || ext == "glb" || ext == "dae" || ext == "blend" || ext == "3ds") {
-        LoadedModel model;
-        if (AssimpLoader::LoadFromFile(modelPath, model)) {
-            outBounds = model.bounds;
+    // 与随后的 LoadModelAsEntity 共享同一次导入
+    if (IsAssimpFormat(ext)) {
+        if (auto model = AcquireModel(modelPath)) {
+            outBounds = model->bounds;
             return true;
         }
     } else if (ext == "obj") {
         // OBJ文件需要手动计算边界
-        auto mesh = std::make_shared<Mesh>();
-        if (OBJLoader::LoadFromFile(modelPath, *mesh)) {
-            const auto& vertices = mesh->GetVertices();
-            outBounds.min = { FLT_MAX, FLT_MAX, FLT_MAX };
-            outBounds.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-            
-            for (const auto& v : vertices) {
-                if (v.position.x < outBounds.min.x) outBounds.min.x = v.position.x;
-                if (v.position.y < outBounds.min.y) outBounds.min.y = v.position.y;
-                if (v.position.z < outBounds.min.z) outBounds.min.z = v.position.z;
-                if (v.position.x > outBounds.max.x) outBounds.max.x = v.position.x;
-                if (v.position.y > outBounds.max.y) outBounds.max.y = v.position.y;
-                if (v.position.z > outBounds.max.z) outBounds.max.z = v.position.z;
-            }
+        if (auto model = AcquireModel(modelPath)) {
+            // CPU 顶点可能已释放（ReleaseCPUMeshData），Mesh 保留了包围盒
+            model->mesh->GetLocalBounds(outBounds.min, outBounds.max);
             
             outBounds.size.x = outBounds.max.x - outBounds.min.x;
             outBounds.size.y = outBounds.max.y - outBounds.min.y;
@@ -749,6 +1080,14 @@ entt::entity SceneAssetLoader::LoadModelWithRadius(
         registry, scene, device, modelPath, texturePath, position, scale, nullptr
     );
     
+    // 按半径加载的都是星球/卫星等大模型：生成 LOD 链
+    PreloadManifest::Record(PreloadManifest::Kind::ModelLODChain, modelPath);
+    if (auto* meshComp = registry.try_get<MeshComponent>(entity); meshComp && meshComp->mesh) {
+        const auto& mesh = meshComp->mesh;
+        meshComp->lod = ResourceCache::GetInstance().AcquireLODChain(mesh,
+            [&]() { return GenerateLODChain(device, *mesh); });
+    }
+    
     // 5. 输出实际半径
     if (outActualRadius) {
         *outActualRadius = targetRadius;
@@ -765,7 +1104,9 @@ entt::entity SceneAssetLoader::LoadMultiMaterialModelWithRadius(
     const std::string& textureDir,
     const DirectX::XMFLOAT3& position,
     float targetRadius,
-    float* outActualRadius
+    float* outActualRadius,
+    bool packTextureArrays,
+    bool staticMerge
 ) {
     // 1. 获取模型边界
     resources::ModelBounds bounds;
@@ -795,18 +1136,16 @@ entt::entity SceneAssetLoader::LoadMultiMaterialModelWithRadius(
               << ", target_radius=" << targetRadius
               << ", scale=" << scaleFactor << std::endl;
     
-    // 4. 使用多材质加载器加载模型
-    MultiMaterialModel model;
-    if (!AssimpLoader::LoadMultiMaterialModel(modelPath, model)) {
+    // 4. 使用多材质加载器加载模型（共享；空模型不会进入缓存）
+    auto sharedModel = AcquireMultiMaterialModel(modelPath, staticMerge);
+    if (!sharedModel) {
         DebugManager::GetInstance().Log("SceneAssetLoader", 
             "Failed to load multi-material model: " + modelPath);
         return entt::null;
     }
-    
-    if (model.subMeshes.empty()) {
-        DebugManager::GetInstance().Log("SceneAssetLoader", "No sub-meshes found");
-        return entt::null;
-    }
+    const MultiMaterialModel& model = *sharedModel;
+    // MergedMultiModel 的预加载已包含各子网格的 LOD 链
+    if (!staticMerge) PreloadManifest::Record(PreloadManifest::Kind::MultiModelLODChain, modelPath);
     
     DirectX::XMFLOAT3 scale = { scaleFactor, scaleFactor, scaleFactor };
     
@@ -818,57 +1157,8 @@ entt::entity SceneAssetLoader::LoadMultiMaterialModelWithRadius(
     mainTransform.scale = scale;
     mainTransform.rotation = DirectX::XMFLOAT4(0, 0, 0, 1);
     
-    // 为每个子 mesh 创建材质并添加到渲染列表
-    // 使用 MultiMeshComponent 来存储多个 mesh
-    auto& multiMesh = registry.emplace<MultiMeshComponent>(mainEntity);
-    
-    std::cout << "[SceneAssetLoader] Processing " << model.subMeshes.size() 
-              << " sub-meshes for multi-material model" << std::endl;
-    
-    for (size_t i = 0; i < model.subMeshes.size(); i++) {
-        auto& subMesh = model.subMeshes[i];
-        
-        // 创建 GPU 缓冲
-        subMesh.mesh->CreateGPUBuffers(device);
-        
-        // 创建材质（优先使用嵌入纹理）
-        std::shared_ptr<Material> material = nullptr;
-        
-        // 检查嵌入纹理
-        if (!subMesh.embeddedTextures.empty()) {
-            bool hasAlbedo = subMesh.embeddedTextures.size() > LoadedModel::ALBEDO &&
-                            !subMesh.embeddedTextures[LoadedModel::ALBEDO].data.empty();
-            bool hasEmissive = subMesh.embeddedTextures.size() > LoadedModel::EMISSIVE &&
-                              !subMesh.embeddedTextures[LoadedModel::EMISSIVE].data.empty();
-            
-            if (hasAlbedo || hasEmissive) {
-                material = CreateMaterialFromEmbedded(device, subMesh.embeddedTextures);
-                std::cout << "[SceneAssetLoader] SubMesh " << i << " (" << subMesh.materialName 
-                          << "): using embedded texture" << std::endl;
-            }
-        }
-        
-        // 如果没有嵌入纹理，尝试外部纹理
-        if (!material && !subMesh.texturePaths.empty() && !subMesh.texturePaths[0].empty()) {
-            if (subMesh.texturePaths[0][0] != '*') {  // 不是嵌入纹理引用
-                material = CreateMaterialResource(device, subMesh.texturePaths[0]);
-                std::cout << "[SceneAssetLoader] SubMesh " << i << " (" << subMesh.materialName 
-                          << "): using external texture " << subMesh.texturePaths[0] << std::endl;
-            }
-        }
-        
-        // 如果还是没有材质，创建默认材质
-        if (!material) {
-            material = std::make_shared<Material>();
-            material->albedo = DirectX::XMFLOAT4(0.7f, 0.7f, 0.7f, 1.0f);
-            std::cout << "[SceneAssetLoader] SubMesh " << i << " (" << subMesh.materialName 
-                      << "): using default gray material" << std::endl;
-        }
-        
-        // 添加到多 mesh 组件
-        multiMesh.meshes.push_back(subMesh.mesh);
-        multiMesh.materials.push_back(material);
-    }
+    auto& multiMesh = EmplaceMultiMesh(registry, mainEntity, device, model, modelPath, textureDir,
+                                       packTextureArrays);
     
     std::cout << "[SceneAssetLoader] Created multi-material entity with " 
               << multiMesh.meshes.size() << " sub-meshes" << std::endl;
@@ -881,4 +1171,169 @@ entt::entity SceneAssetLoader::LoadMultiMaterialModelWithRadius(
     return mainEntity;
 }
 
+MeshLODChain SceneAssetLoader::GenerateLODChain(ID3D11Device* device, const Mesh& mesh) {
+    // 目标三角形比例与切换阈值（投影半径占半个视口高度的比例）
+    static constexpr float kLODRatios[] = { 0.5f, 0.25f, 0.1f };
+    static constexpr float kLODScreenRadii[] = { 0.25f, 0.1f, 0.04f };
+
+    MeshLODChain chain;
+    if (!device || !mesh.HasCPUData() || mesh.GetIndexCount() / 3 < kLODMinTriangles) {
+        return chain;
+    }
+
+    const Mesh* previous = &mesh;
+    for (size_t i = 0; i < std::size(kLODRatios); i++) {
+        // 始终从 LOD 0 简化，避免误差逐级累积
+        auto level = MeshSimplifier::GenerateLOD(mesh, kLODRatios[i]);
+        if (!level || level->GetIndexCount() >= previous->GetIndexCount()) {
+            break;
+        }
+        level->CreateGPUBuffers(device);
+        if (!level->vertexBuffer) {
+            break;
+        }
+        chain.levels.push_back(level);
+        chain.screenRadii.push_back(kLODScreenRadii[i]);
+        previous = level.get();
+    }
+
+    DebugManager::GetInstance().Log("SceneAssetLoader",
+        "Generated " + std::to_string(chain.levels.size()) + " LOD levels for mesh with " +
+        std::to_string(mesh.GetIndexCount() / 3) + " triangles");
+    return chain;
+}
+
+bool SceneAssetLoader::PreloadAsset(ID3D11Device* device, const PreloadManifest::Entry& entry) {
+    auto& cache = ResourceCache::GetInstance();
+    std::vector<std::pair<const EmbeddedTexture*, TextureUsage>> prefetch;
+
+    switch (entry.kind) {
+        case PreloadManifest::Kind::Model:
+        case PreloadManifest::Kind::ModelLODChain: {
+            auto model = AcquireModel(entry.path);
+            if (!model) return false;
+            const auto& mesh = model->mesh;
+            ResourceCache::EnsureGPUBuffers(device, *mesh);
+            CollectEmbeddedTextures(model->embeddedTextures, prefetch);
+            cache.PrefetchEmbeddedTextures(device, prefetch);
+            if (entry.kind == PreloadManifest::Kind::ModelLODChain) {
+                cache.AcquireLODChain(mesh, [&]() { return GenerateLODChain(device, *mesh); });
+            }
+            return true;
+        }
+
+        case PreloadManifest::Kind::MultiModel:
+        case PreloadManifest::Kind::MultiModelLODChain:
+        case PreloadManifest::Kind::MergedMultiModel: {
+            const bool merged = entry.kind == PreloadManifest::Kind::MergedMultiModel;
+            auto model = AcquireMultiMaterialModel(entry.path, merged);
+            if (!model) return false;
+            for (const auto& subMesh : model->subMeshes) {
+                ResourceCache::EnsureGPUBuffers(device, *subMesh.mesh);
+                CollectEmbeddedTextures(subMesh.embeddedTextures, prefetch);
+            }
+            cache.PrefetchEmbeddedTextures(device, prefetch);
+            if (entry.kind == PreloadManifest::Kind::MultiModelLODChain || merged) {
+                for (const auto& subMesh : model->subMeshes) {
+                    const auto& mesh = subMesh.mesh;
+                    cache.AcquireLODChain(mesh, [&]() { return GenerateLODChain(device, *mesh); });
+                }
+            }
+            return true;
+        }
+
+        case PreloadManifest::Kind::Texture:
+            return cache.AcquireTexture(device, entry.path, entry.usage) != nullptr;
+    }
+    return false;
+}
+
+uint32_t SceneAssetLoader::ReplaceMeshes(entt::registry& registry, ID3D11Device* device,
+                                         const std::vector<std::shared_ptr<Mesh>>& oldMeshes,
+                                         const std::vector<std::shared_ptr<Mesh>>& newMeshes) {
+    const size_t count = (std::min)(oldMeshes.size(), newMeshes.size());
+    auto findReplacement = [&](const std::shared_ptr<Mesh>& mesh) -> const std::shared_ptr<Mesh>* {
+        for (size_t i = 0; i < count; i++) {
+            if (mesh && mesh == oldMeshes[i]) return &newMeshes[i];
+        }
+        return nullptr;
+    };
+    auto regenerateLOD = [device](const std::shared_ptr<Mesh>& mesh) {
+        return ResourceCache::GetInstance().AcquireLODChain(mesh, [&]() { return GenerateLODChain(device, *mesh); });
+    };
+
+    // 先收集再修改：patch 会触发 RenderQueue 的 on_update 监听
+    std::vector<entt::entity> singles;
+    for (auto entity : registry.view<MeshComponent>()) {
+        if (findReplacement(registry.get<MeshComponent>(entity).mesh)) singles.push_back(entity);
+    }
+    std::vector<entt::entity> multis;
+    for (auto entity : registry.view<MultiMeshComponent>()) {
+        const auto& meshes = registry.get<MultiMeshComponent>(entity).meshes;
+        if (std::any_of(meshes.begin(), meshes.end(), [&](const auto& mesh) { return findReplacement(mesh); })) {
+            multis.push_back(entity);
+        }
+    }
+
+    for (auto entity : singles) {
+        registry.patch<MeshComponent>(entity, [&](MeshComponent& meshComp) {
+            const bool hadLOD = meshComp.lod.GetLevelCount() > 0;
+            meshComp.mesh = *findReplacement(meshComp.mesh);
+            meshComp.lod = hadLOD ? regenerateLOD(meshComp.mesh) : MeshLODChain{};
+        });
+        AttachBounds(registry, entity, *registry.get<MeshComponent>(entity).mesh);
+    }
+
+    for (auto entity : multis) {
+        registry.patch<MultiMeshComponent>(entity, [&](MultiMeshComponent& multiMesh) {
+            for (size_t i = 0; i < multiMesh.meshes.size(); i++) {
+                const auto* replacement = findReplacement(multiMesh.meshes[i]);
+                if (!replacement) continue;
+                multiMesh.meshes[i] = *replacement;
+                if (i < multiMesh.lods.size()) {
+                    const bool hadLOD = multiMesh.lods[i].GetLevelCount() > 0;
+                    multiMesh.lods[i] = hadLOD ? regenerateLOD(*replacement) : MeshLODChain{};
+                }
+            }
+        });
+        if (registry.all_of<BoundsComponent>(entity)) {
+            const auto& meshes = registry.get<MultiMeshComponent>(entity).meshes;
+            registry.patch<BoundsComponent>(entity, [&](BoundsComponent& b) {
+                b.subMeshBounds.resize(meshes.size());
+                DirectX::BoundingSphere merged;
+                for (size_t i = 0; i < meshes.size(); i++) {
+                    b.subMeshBounds[i] = BoundsComponent::SphereFromMesh(*meshes[i]);
+                    if (i == 0) merged = b.subMeshBounds[i];
+                    else DirectX::BoundingSphere::CreateMerged(merged, merged, b.subMeshBounds[i]);
+                }
+                if (!meshes.empty()) b.SetSphere(merged);
+            });
+        }
+    }
+
+    return static_cast<uint32_t>(singles.size() + multis.size());
+}
+
+uint32_t SceneAssetLoader::RefreshMaterials(entt::registry& registry,
+                                            const std::vector<const Material*>& materials) {
+    if (materials.empty()) return 0;
+    auto uses = [&materials](const std::shared_ptr<Material>& material) {
+        return material && std::find(materials.begin(), materials.end(), material.get()) != materials.end();
+    };
+
+    std::vector<entt::entity> singles;
+    for (auto entity : registry.view<MeshComponent>()) {
+        if (uses(registry.get<MeshComponent>(entity).material)) singles.push_back(entity);
+    }
+    std::vector<entt::entity> multis;
+    for (auto entity : registry.view<MultiMeshComponent>()) {
+        const auto& entityMaterials = registry.get<MultiMeshComponent>(entity).materials;
+        if (std::any_of(entityMaterials.begin(), entityMaterials.end(), uses)) multis.push_back(entity);
+    }
+
+    for (auto entity : singles) registry.patch<MeshComponent>(entity);
+    for (auto entity : multis) registry.patch<MultiMeshComponent>(entity);
+    return static_cast<uint32_t>(singles.size() + multis.size());
+}
+
 } // namespace outer_wilds
@@ -1,7 +1,10 @@
 #pragma once
+#include "PreloadManifest.h"
 #include <entt/entt.hpp>
 #include <DirectXMath.h>
 #include <string>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <vector>
 #include <d3d11.h>
@@ -16,6 +19,9 @@ namespace resources {
     struct EmbeddedTexture;  // For GLB embedded textures
     struct ModelBounds;      // For model bounds info
 }
+namespace components {
+    struct MeshLODChain;
+}
 
 // Physics configuration for loaded models
 struct PhysicsOptions {
@@ -49,6 +55,23 @@ struct ModelLoadingOptions {
     bool verbose = true;                  // Print loading messages
     bool fastLoad = false;                // Skip tangent/normal generation (2-5x faster)
     bool flipUpAxis = false;              // Flip model up axis (rotate 180 degrees around forward axis)
+    bool packTextureArrays = false;       // Pack embedded textures into shared Texture2DArrays (TextureArrayAtlas)
+};
+
+/**
+ * Handle returned by SceneAssetLoader::LoadModelAsEntityAsync
+ *
+ * entity 立即可用（Transform + 占位网格）；ready 在主线程应用加载结果后就绪，
+ * 值为 false 表示加载失败（实体保留占位网格）或实体在完成前已被销毁
+ */
+struct ModelLoadHandle {
+    entt::entity entity = entt::null;
+    uint32_t requestId = 0;
+    std::shared_future<bool> ready;
+
+    bool IsReady() const {
+        return ready.valid() && ready.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
 };
 
 /**
@@ -67,7 +90,10 @@ struct ModelLoadingOptions {
  * - LoadModelAsEntity(): Load single OBJ model as one entity
  * - LoadModelWithMaterials(): Load OBJ with MTL material file
  * - LoadMultiMaterialModelAsEntities(): Load FBX/GLTF with multiple materials as child entities
- * - CreatePrefabEntity(): Create reusable entity templates
+ * - Prefab / PrefabPool (Prefab.h): Load a model once as a template, spawn / recycle instances in bulk
+ *
+ * 所有入口经过 resources::ResourceCache：同一路径 + 选项的模型只导入一次，
+ * Mesh / Material / 纹理 SRV / LOD 链在实体之间共享（不要修改返回的共享资源）
  */
 class SceneAssetLoader {
 public:
@@ -174,6 +200,27 @@ public:
         const ModelLoadingOptions& options
     );
 
+    /**
+     * Asynchronous variant of LoadModelAsEntityWithOptions
+     *
+     * 立即创建实体（Transform、占位网格 + 默认灰色材质、RenderPriority、StreamingAssetComponent），
+     * 导入 / 纹理解码 / GPU 缓冲在 AssetStreamer 的加载线程上进行，
+     * 完成后由 AssetStreamer::ApplyCompleted（主线程，Engine::Update 中）换上真实网格、材质和包围体。
+     * 支持所有格式（OBJ 走 MTL 纹理查找）。
+     *
+     * 调用方可以马上给实体添加固定尺寸的碰撞体等组件；依赖网格数据的设置应等 handle.ready。
+     */
+    static ModelLoadHandle LoadModelAsEntityAsync(
+        entt::registry& registry,
+        std::shared_ptr<Scene> scene,
+        ID3D11Device* device,
+        const std::string& objPath,
+        const std::string& texturePath,
+        const DirectX::XMFLOAT3& position,
+        const DirectX::XMFLOAT3& scale,
+        const ModelLoadingOptions& options
+    );
+
     /**
      * Load a multi-material model (FBX, GLTF, etc.) as multiple child entities
      * Each material gets its own entity with correct texture mapping
@@ -184,6 +231,10 @@ public:
      * @param textureDir Directory containing textures (will auto-match by material name)
      * @param position World position
      * @param scale Scale factor
+     * @param staticMerge Bake node transforms and merge submeshes with identical materials at load time;
+     *        the result is a single MultiMeshComponent entity (one draw per material, no child entities)
+     * @param packTextureArrays Pack embedded textures of equal size/format into shared Texture2DArrays
+     *        (materials of one array draw with a single SRV binding)
      * @return Parent entity ID (children are attached via TransformComponent.parent)
      */
     static entt::entity LoadMultiMaterialModelAsEntities(
@@ -193,7 +244,9 @@ public:
         const std::string& modelPath,
         const std::string& textureDir = "",
         const DirectX::XMFLOAT3& position = {0, 0, 0},
-        const DirectX::XMFLOAT3& scale = {1, 1, 1}
+        const DirectX::XMFLOAT3& scale = {1, 1, 1},
+        bool staticMerge = false,
+        bool packTextureArrays = false
     );
 
     /**
@@ -235,6 +288,8 @@ public:
      * @param position World position
      * @param targetRadius Target radius in meters
      * @param outActualRadius Output: actual radius after scaling (optional)
+     * @param packTextureArrays Pack embedded textures into shared Texture2DArrays (see LoadMultiMaterialModelAsEntities)
+     * @param staticMerge Bake node transforms and merge submeshes with identical materials (see LoadMultiMaterialModelAsEntities)
      * @return Main entity ID (all sub-meshes share same transform)
      */
     static entt::entity LoadMultiMaterialModelWithRadius(
@@ -245,7 +300,9 @@ public:
         const std::string& textureDir,
         const DirectX::XMFLOAT3& position,
         float targetRadius,
-        float* outActualRadius = nullptr
+        float* outActualRadius = nullptr,
+        bool packTextureArrays = false,
+        bool staticMerge = false
     );
 
     /**
@@ -284,11 +341,62 @@ public:
      * Create material from embedded textures (for GLB/GLTF formats)
      * @param device D3D11 device
      * @param embeddedTextures Vector of embedded texture data
+     * @param packTextureArrays Copy the textures into resources::TextureArrayAtlas when they all fit
+     *        (cached separately from the unpacked material)
      * @return Shared pointer to material, or nullptr on failure
      */
     static std::shared_ptr<resources::Material> CreateMaterialFromEmbedded(
         ID3D11Device* device,
-        const std::vector<resources::EmbeddedTexture>& embeddedTextures
+        const std::vector<resources::EmbeddedTexture>& embeddedTextures,
+        bool packTextureArrays = false
+    );
+
+    /**
+     * Generate a discrete LOD chain for a dense mesh (planets, moons, large models)
+     * Levels keep ~50% / 25% / 10% of the triangles; meshes below kLODMinTriangles get no chain
+     * @param device D3D11 device (GPU buffers are created for every generated level)
+     * @param mesh Source mesh (LOD 0)
+     */
+    static components::MeshLODChain GenerateLODChain(
+        ID3D11Device* device,
+        const resources::Mesh& mesh
+    );
+
+    static constexpr size_t kLODMinTriangles = 4096;
+
+    /**
+     * Hot reload: point every live MeshComponent / MultiMeshComponent that uses oldMeshes[i] at newMeshes[i]
+     * Entities that had an LOD chain get one generated for the new mesh; bounds are recomputed.
+     * Components are patched, so the RenderQueue rebuilds their batches on the next collect.
+     * @return Number of entities updated
+     */
+    static uint32_t ReplaceMeshes(
+        entt::registry& registry,
+        ID3D11Device* device,
+        const std::vector<std::shared_ptr<resources::Mesh>>& oldMeshes,
+        const std::vector<std::shared_ptr<resources::Mesh>>& newMeshes
+    );
+
+    /**
+     * Hot reload: re-patch every entity that renders with one of the given materials
+     * (their texture slots were swapped in place), so the RenderQueue picks up the new SRVs
+     * @return Number of entities updated
+     */
+    static uint32_t RefreshMaterials(
+        entt::registry& registry,
+        const std::vector<const resources::Material*>& materials
+    );
+
+    /**
+     * Startup preload: fetch one manifest entry into the ResourceCache (import, GPU buffers,
+     * embedded texture decode, LOD chain, or texture SRV) without touching any registry.
+     * Safe on AssetStreamer loader threads; the later scene build hits the cache.
+     * Entries for the same model path must run sequentially (see ScenePreloader).
+     * @return false if the asset failed to load
+     */
+    static bool PreloadAsset(
+        ID3D11Device* device,
+        const PreloadManifest::Entry& entry
     );
 
     /**
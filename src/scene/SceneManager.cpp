@@ -1,4 +1,5 @@
 #include "SceneManager.h"
+#include "../graphics/CameraService.h"
 
 namespace outer_wilds {
 
@@ -27,6 +28,10 @@ std::shared_ptr<Scene> SceneManager::CreateScene(const std::string& name) {
 
 void SceneManager::SetActiveScene(const std::string& name) {
     if (m_Scenes.find(name) != m_Scenes.end()) {
+        if (m_ActiveSceneName != name) {
+            // 活动相机句柄属于旧场景的注册表
+            CameraService::GetInstance().Reset();
+        }
         m_ActiveSceneName = name;
     }
 }
@@ -0,0 +1,91 @@
+#include "ScenePreloader.h"
+#include "AssetStreamer.h"
+#include "SceneAssetLoader.h"
+#include "../core/DebugManager.h"
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace outer_wilds {
+
+namespace {
+
+struct PreloadGroup {
+    std::vector<PreloadManifest::Entry> entries;
+    uint64_t weight = 0;
+};
+
+uint64_t SourceWeight(const std::string& path) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return ec ? 1 : std::max<uint64_t>(size, 1);
+}
+
+} // namespace
+
+uint32_t ScenePreloader::Start(ID3D11Device* device, const PreloadManifest& manifest) {
+    m_TotalRequests = 0;
+    m_CompletedRequests = 0;
+    m_TotalWeight = 0;
+    m_CompletedWeight = 0;
+    m_Failed = 0;
+    if (!device || manifest.IsEmpty()) return 0;
+
+    // 按源文件分组（保持清单中的顺序：模型条目在它的 LOD 链条目之前）
+    std::vector<PreloadGroup> groups;
+    std::unordered_map<std::string, size_t> modelGroups;
+    for (const auto& entry : manifest.GetEntries()) {
+        if (entry.kind == PreloadManifest::Kind::Texture) {
+            groups.emplace_back().entries.push_back(entry);
+            groups.back().weight = SourceWeight(entry.path);
+            continue;
+        }
+        auto [it, inserted] = modelGroups.try_emplace(entry.path, groups.size());
+        if (inserted) {
+            groups.emplace_back().weight = SourceWeight(entry.path);
+        }
+        groups[it->second].entries.push_back(entry);
+    }
+    std::stable_sort(groups.begin(), groups.end(),
+        [](const PreloadGroup& a, const PreloadGroup& b) { return a.weight > b.weight; });
+
+    auto& streamer = AssetStreamer::GetInstance();
+    const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    streamer.Initialize(std::max(2u, hardwareThreads / 2));
+
+    m_TotalRequests = static_cast<uint32_t>(groups.size());
+    for (const auto& group : groups) {
+        m_TotalWeight += group.weight;
+    }
+
+    for (auto& group : groups) {
+        const uint64_t weight = group.weight;
+        streamer.Submit([this, device, weight, entries = std::move(group.entries)]() -> AssetStreamer::ApplyFn {
+            for (const auto& entry : entries) {
+                if (!SceneAssetLoader::PreloadAsset(device, entry)) {
+                    m_Failed.fetch_add(1, std::memory_order_relaxed);
+                    DebugManager::GetInstance().Log("ScenePreloader", "Failed to preload: " + entry.path);
+                }
+            }
+            return [this, weight](entt::registry&) {
+                m_CompletedRequests++;
+                m_CompletedWeight += weight;
+            };
+        });
+    }
+
+    DebugManager::GetInstance().Log("ScenePreloader",
+        "Preloading " + std::to_string(manifest.GetEntries().size()) + " assets in " +
+        std::to_string(m_TotalRequests) + " requests");
+    return m_TotalRequests;
+}
+
+float ScenePreloader::GetProgress() const {
+    if (m_TotalWeight == 0) return 1.0f;
+    return static_cast<float>(static_cast<double>(m_CompletedWeight) / static_cast<double>(m_TotalWeight));
+}
+
+} // namespace outer_wilds
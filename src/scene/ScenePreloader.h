@@ -0,0 +1,55 @@
+#pragma once
+#include "PreloadManifest.h"
+#include <atomic>
+#include <cstdint>
+#include <d3d11.h>
+
+namespace outer_wilds {
+
+/**
+ * @brief 启动预加载：把 PreloadManifest 的条目提交到 AssetStreamer 的加载线程并行获取
+ *
+ * - 条目按源文件分组：同一模型路径的条目（单网格 / 多材质 / LOD 链）在同一个请求里顺序执行
+ *   （ResourceCache 的工厂在锁外运行，并发获取同一键会重复导入）；纹理各自一个请求
+ * - 大文件先提交，避免最后只剩一个长任务在跑
+ * - 进度按源文件字节数加权，在 ApplyFn（主线程，排队的立即上下文纹理工作执行之后）中累计：
+ *   IsComplete() 为 true 时预取的资源全部可用
+ *
+ * 主线程在欢迎界面循环中调用 AssetStreamer::ApplyCompleted 推进进度。
+ */
+class ScenePreloader {
+public:
+    static ScenePreloader& GetInstance() {
+        static ScenePreloader instance;
+        return instance;
+    }
+
+    /**
+     * @brief 提交清单中的全部条目（加载线程数按 CPU 核数提高到至少 2）
+     * @return 提交的请求数；0 表示清单为空
+     */
+    uint32_t Start(ID3D11Device* device, const PreloadManifest& manifest);
+
+    bool IsComplete() const { return m_CompletedRequests >= m_TotalRequests; }
+
+    /** @brief 0..1，清单为空时为 1 */
+    float GetProgress() const;
+
+    uint32_t GetTotalRequests() const { return m_TotalRequests; }
+    uint32_t GetCompletedRequests() const { return m_CompletedRequests; }
+    /** @brief 加载失败的条目数（清单过期等，场景构建时会再尝试一次） */
+    uint32_t GetFailedCount() const { return m_Failed.load(std::memory_order_relaxed); }
+
+private:
+    ScenePreloader() = default;
+    ScenePreloader(const ScenePreloader&) = delete;
+    ScenePreloader& operator=(const ScenePreloader&) = delete;
+
+    uint32_t m_TotalRequests = 0;
+    uint32_t m_CompletedRequests = 0;    // 主线程
+    uint64_t m_TotalWeight = 0;
+    uint64_t m_CompletedWeight = 0;      // 主线程
+    std::atomic<uint32_t> m_Failed{ 0 };
+};
+
+} // namespace outer_wilds
@@ -2,22 +2,39 @@
  * SolarSystemBuilder.h
  * 
  * 太阳系构建器 - 使用配置创建整个太阳系
+ *
+ * 两步构建：先为每个天体创建渲染实体（启动预加载之后全部命中 ResourceCache），
+ * 再把轨道 / 替身 / 扇区 / 重力组件按类型一次批量写入（registry.insert），
+ * 扇区地面碰撞体共用一个材质、一次 addActors 加入场景。
+ * 有星环的行星另挂一个碎石环子实体（GpuInstancedComponent，GPU 剔除 + 一次间接绘制）。
  */
 
 #pragma once
 #include "SolarSystemConfig.h"
 #include "SceneAssetLoader.h"
 #include "Scene.h"
+#include "TransformSystem.h"
 #include "components/TransformComponent.h"
 #include "../physics/components/OrbitComponent.h"
 #include "../physics/components/SectorComponent.h"
 #include "../physics/components/GravitySourceComponent.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include "../graphics/components/ImpostorComponent.h"
+#include "../graphics/components/AtmosphereComponent.h"
+#include "../graphics/components/PlanetTerrainComponent.h"
+#include "../graphics/components/GpuInstancedComponent.h"
+#include "../graphics/resources/TerrainGenerator.h"
 #include "../physics/PhysXManager.h"
+#include "../physics/FloatingOrigin.h"
 #include <entt/entt.hpp>
 #include <map>
+#include <string>
+#include <vector>
+#include <cmath>
 #include <iostream>
 #include <algorithm>
 #include <cctype>
+#include <random>
 
 namespace outer_wilds {
 
@@ -60,73 +77,243 @@ public:
         const std::string& assetsBasePath
     ) {
         SolarSystemEntities result;
-        auto& physxManager = PhysXManager::GetInstance();
-        auto* pxPhysics = physxManager.GetPhysics();
-        auto* pxScene = physxManager.GetScene();
-
+        std::vector<BodySetup> bodies;
+        bodies.reserve(9);
         
+        // 1. 渲染实体（可着陆天体另挂 PlanetTerrainComponent，近处由分块地形替换原网格）
         // 创建太阳
-        result.sun = CreateSun(registry, scene, device, assetsBasePath);
-        if (result.sun != entt::null) {
-            result.byName["Sun"] = result.sun;
+        if (DescribeSun(registry, scene, device, assetsBasePath, bodies)) {
+            result.sun = bodies.back().entity;
         }
         
         // 创建行星
-        result.mercury = CreatePlanet(registry, scene, device, assetsBasePath, 
-                                      SolarSystemConfig::GetMercuryConfig(), pxPhysics, pxScene);
-        if (result.mercury != entt::null) result.byName["Mercury"] = result.mercury;
-        
-        result.venus = CreatePlanet(registry, scene, device, assetsBasePath,
-                                    SolarSystemConfig::GetVenusConfig(), pxPhysics, pxScene);
-        if (result.venus != entt::null) result.byName["Venus"] = result.venus;
+        const std::pair<PlanetConfig, entt::entity*> planets[] = {
+            { SolarSystemConfig::GetMercuryConfig(), &result.mercury },
+            { SolarSystemConfig::GetVenusConfig(), &result.venus },
+            { SolarSystemConfig::GetEarthConfig(), &result.earth },
+            { SolarSystemConfig::GetMarsConfig(), &result.mars },
+            { SolarSystemConfig::GetJupiterConfig(), &result.jupiter },
+            { SolarSystemConfig::GetSaturnConfig(), &result.saturn },
+            { SolarSystemConfig::GetNeptuneConfig(), &result.neptune },
+        };
+        for (const auto& planet : planets) {
+            if (DescribePlanet(registry, scene, device, assetsBasePath, planet.first, bodies)) {
+                *planet.second = bodies.back().entity;
+            }
+        }
         
-        result.earth = CreatePlanet(registry, scene, device, assetsBasePath,
-                                    SolarSystemConfig::GetEarthConfig(), pxPhysics, pxScene);
-        if (result.earth != entt::null) result.byName["Earth"] = result.earth;
+        // 创建月球（围绕地球）
+        if (result.earth != entt::null &&
+            DescribeMoon(registry, scene, device, assetsBasePath, SolarSystemConfig::GetMoonConfig(), result.earth, bodies)) {
+            result.moon = bodies.back().entity;
+        }
         
-        result.mars = CreatePlanet(registry, scene, device, assetsBasePath,
-                                   SolarSystemConfig::GetMarsConfig(), pxPhysics, pxScene);
-        if (result.mars != entt::null) result.byName["Mars"] = result.mars;
+        // 2. 玩法组件与碰撞体
+        auto& physxManager = PhysXManager::GetInstance();
+        AttachBodies(registry, bodies, physxManager.GetPhysics(), physxManager.GetScene());
         
-        result.jupiter = CreatePlanet(registry, scene, device, assetsBasePath,
-                                      SolarSystemConfig::GetJupiterConfig(), pxPhysics, pxScene);
-        if (result.jupiter != entt::null) result.byName["Jupiter"] = result.jupiter;
+        for (const auto& body : bodies) {
+            result.byName[body.name] = body.entity;
+        }
         
-        result.saturn = CreatePlanet(registry, scene, device, assetsBasePath,
-                                     SolarSystemConfig::GetSaturnConfig(), pxPhysics, pxScene);
-        if (result.saturn != entt::null) result.byName["Saturn"] = result.saturn;
+        return result;
+    }
+    
+private:
+    static constexpr uint32_t kRingRockCount = 3000;
+    static constexpr float kRingInnerRadius = 1.4f;     // 行星半径的倍数
+    static constexpr float kRingOuterRadius = 2.3f;
+    static constexpr float kRingThickness = 0.01f;
+
+    /**
+     * 一个天体的玩法组件：渲染实体创建后先填好，最后由 AttachBodies 按组件类型批量写入
+     */
+    struct BodySetup {
+        std::string name;
+        entt::entity entity = entt::null;
+        components::OrbitComponent orbit;
+        components::ImpostorComponent impostor;
+        bool hasSector = false;
+        components::SectorComponent sector;
+        bool hasGravity = false;
+        components::GravitySourceComponent gravity;
+        bool hasAtmosphere = false;
+        components::AtmosphereComponent atmosphere;
+        bool hasTerrain = false;
+        components::PlanetTerrainComponent terrain;
+        float colliderRadius = 0.0f;   // > 0 时在扇区原点创建球形地面碰撞体
+    };
+    
+    /**
+     * 批量挂载：每种组件一次 registry.insert；碰撞体一次 addActors
+     */
+    static void AttachBodies(
+        entt::registry& registry,
+        std::vector<BodySetup>& bodies,
+        physx::PxPhysics* pxPhysics,
+        physx::PxScene* pxScene
+    ) {
+        if (bodies.empty()) return;
         
-        result.neptune = CreatePlanet(registry, scene, device, assetsBasePath,
-                                      SolarSystemConfig::GetNeptuneConfig(), pxPhysics, pxScene);
-        if (result.neptune != entt::null) result.byName["Neptune"] = result.neptune;
+        // 扇区地面碰撞体
+        // 【重要】PhysX 碰撞体必须在扇区原点 (0,0,0)！
+        // SectorPhysicsSystem 使用 InSectorComponent.localPosition（相对于扇区原点）计算物理
+        // 扇区的 worldPosition 由 OrbitSystem 更新，用于坐标转换
+        if (pxPhysics && pxScene) {
+            physx::PxMaterial* material = nullptr;
+            std::vector<physx::PxActor*> actors;
+            for (auto& body : bodies) {
+                if (!body.hasSector || body.colliderRadius <= 0.0f) continue;
+                if (!material) material = pxPhysics->createMaterial(0.5f, 0.5f, 0.3f);
+                
+                physx::PxTransform pose(physx::PxVec3(0.0f, 0.0f, 0.0f));
+                physx::PxRigidStatic* actor = pxPhysics->createRigidStatic(pose);
+                physx::PxShape* shape = physx::PxRigidActorExt::createExclusiveShape(
+                    *actor,
+                    physx::PxSphereGeometry(body.colliderRadius),
+                    *material
+                );
+                // 默认禁用，由 SectorPhysicsSystem 在进入该扇区时启用
+                shape->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, false);
+                shape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
+                
+                // 接触事件里按 userData 找到天体（扇区实体）
+                actor->userData = ToActorUserData(body.entity);
+                body.sector.physxGround = actor;
+                actors.push_back(actor);
+                
+                std::cout << "[" << body.name << "] Created sector with radius=" << body.colliderRadius 
+                          << ", influenceRadius=" << body.sector.influenceRadius << ", priority=" << body.sector.priority << std::endl;
+            }
+            if (!actors.empty()) {
+                pxScene->addActors(actors.data(), static_cast<physx::PxU32>(actors.size()));
+            }
+        }
         
-        // 创建月球（围绕地球）
-        if (result.earth != entt::null) {
-            result.moon = CreateMoon(registry, scene, device, assetsBasePath,
-                                     SolarSystemConfig::GetMoonConfig(), result.earth);
-            if (result.moon != entt::null) result.byName["Moon"] = result.moon;
+        std::vector<entt::entity> entities;
+        std::vector<components::OrbitComponent> orbits;
+        std::vector<components::ImpostorComponent> impostors;
+        std::vector<entt::entity> sectorEntities;
+        std::vector<components::SectorComponent> sectors;
+        std::vector<entt::entity> gravityEntities;
+        std::vector<components::GravitySourceComponent> gravities;
+        std::vector<entt::entity> atmosphereEntities;
+        std::vector<components::AtmosphereComponent> atmospheres;
+        std::vector<entt::entity> terrainEntities;
+        std::vector<components::PlanetTerrainComponent> terrains;
+        entities.reserve(bodies.size());
+        orbits.reserve(bodies.size());
+        impostors.reserve(bodies.size());
+        
+        for (auto& body : bodies) {
+            entities.push_back(body.entity);
+            orbits.push_back(body.orbit);
+            impostors.push_back(body.impostor);
+            if (body.hasSector) {
+                sectorEntities.push_back(body.entity);
+                sectors.push_back(std::move(body.sector));
+            }
+            if (body.hasGravity) {
+                gravityEntities.push_back(body.entity);
+                gravities.push_back(body.gravity);
+            }
+            if (body.hasAtmosphere) {
+                atmosphereEntities.push_back(body.entity);
+                atmospheres.push_back(body.atmosphere);
+            }
+            if (body.hasTerrain) {
+                terrainEntities.push_back(body.entity);
+                terrains.push_back(std::move(body.terrain));
+            }
         }
-
         
-        return result;
+        registry.insert<components::OrbitComponent>(entities.begin(), entities.end(), orbits.begin());
+        registry.insert<components::ImpostorComponent>(entities.begin(), entities.end(), impostors.begin());
+        registry.insert<components::SectorComponent>(sectorEntities.begin(), sectorEntities.end(), sectors.begin());
+        registry.insert<components::GravitySourceComponent>(gravityEntities.begin(), gravityEntities.end(), gravities.begin());
+        registry.insert<components::AtmosphereComponent>(atmosphereEntities.begin(), atmosphereEntities.end(), atmospheres.begin());
+        registry.insert<components::PlanetTerrainComponent>(terrainEntities.begin(), terrainEntities.end(), terrains.begin());
     }
     
-private:
     /**
-     * 创建太阳
+     * 星环碎石带：行星的子实体，实例矩阵在以米为单位的行星局部空间（子实体缩放抵消行星的模型缩放）
+     *
+     * 环面垂直于自转轴：自转是绕该轴的旋转，环随行星转动但始终留在同一平面内
+     */
+    static void AttachRingField(entt::registry& registry, ID3D11Device* device, entt::entity planet,
+                                const PlanetConfig& config) {
+        const auto* planetTransform = registry.try_get<TransformComponent>(planet);
+        if (!planetTransform || planetTransform->scale.x <= 0.0f) return;
+
+        auto rock = std::make_shared<resources::Mesh>();
+        resources::TerrainGenerator::CreateSphere(*rock, 1.0f, 4, 6);
+        if (device) rock->CreateGPUBuffers(device);
+
+        using namespace DirectX;
+        const XMVECTOR axis = XMVector3Normalize(XMVectorSet(std::sin(config.axialTilt), std::cos(config.axialTilt), 0.0f, 0.0f));
+        const XMVECTOR tangent = XMVector3Normalize(XMVector3Cross(axis, XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f)));
+        const XMVECTOR bitangent = XMVector3Cross(axis, tangent);
+
+        // 固定种子：每次启动的星环相同
+        std::mt19937 rng(0x5a7u);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        components::GpuInstancedComponent field;
+        field.mesh = rock;
+        field.material = SceneAssetLoader::CreateMaterialResource(device, "");
+        field.instances.reserve(kRingRockCount);
+        for (uint32_t i = 0; i < kRingRockCount; i++) {
+            const float radius = config.radius * (kRingInnerRadius + (kRingOuterRadius - kRingInnerRadius) * unit(rng));
+            const float angle = XM_2PI * unit(rng);
+            const float height = config.radius * kRingThickness * (unit(rng) * 2.0f - 1.0f);
+            const XMVECTOR position = XMVectorAdd(XMVectorAdd(XMVectorScale(tangent, radius * std::cos(angle)),
+                                                              XMVectorScale(bitangent, radius * std::sin(angle))),
+                                                  XMVectorScale(axis, height));
+            // 压扁的随机朝向小球（0.3 ~ 1.2 米）
+            const float size = 0.3f + 0.9f * unit(rng);
+            const XMMATRIX scale = XMMatrixScaling(size, size * (0.5f + 0.5f * unit(rng)), size * (0.6f + 0.4f * unit(rng)));
+            const XMMATRIX rotation = XMMatrixRotationRollPitchYaw(XM_2PI * unit(rng), XM_2PI * unit(rng), XM_2PI * unit(rng));
+            XMFLOAT4X4 local;
+            XMStoreFloat4x4(&local, scale * rotation * XMMatrixTranslationFromVector(position));
+            field.instances.push_back(local);
+        }
+        field.version = 1;
+
+        const float inverseScale = 1.0f / planetTransform->scale.x;
+        entt::entity ring = registry.create();
+        registry.emplace<TransformComponent>(ring);
+        registry.emplace<components::GpuInstancedComponent>(ring, std::move(field));
+        TransformSystem::Attach(registry, ring, planet, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f },
+                                { inverseScale, inverseScale, inverseScale });
+
+        std::cout << "[" << config.name << "] Ring field: " << kRingRockCount << " GPU-instanced rocks" << std::endl;
+    }
+
+    /**
+     * 可着陆天体的分块 LOD 地形：半径换算到模型空间（PlanetTerrainComponent 的距离都是模型空间单位）
+     *
+     * 不设高度函数：地面碰撞体是半径为 worldRadius 的光滑球，地形起伏会和碰撞面错开
+     */
+    static void DescribeTerrain(entt::registry& registry, BodySetup& body, float worldRadius) {
+        const auto* transform = registry.try_get<TransformComponent>(body.entity);
+        if (!transform || transform->scale.x <= 0.0f) return;
+        body.hasTerrain = true;
+        body.terrain.radius = worldRadius / transform->scale.x;
+    }
+
+    /**
+     * 太阳
      * 太阳作为整个太阳系的"默认扇区"，优先级最低
      */
-    static entt::entity CreateSun(
+    static bool DescribeSun(
         entt::registry& registry,
         std::shared_ptr<Scene> scene,
         ID3D11Device* device,
-        const std::string& basePath
+        const std::string& basePath,
+        std::vector<BodySetup>& bodies
     ) {
         auto config = SolarSystemConfig::GetSunConfig();
         std::string modelPath = basePath + "/" + config.modelPath;
         
-
-        
         float actualRadius = 0.0f;
         auto entity = SceneAssetLoader::LoadModelWithRadius(
             registry, scene, device,
@@ -137,64 +324,64 @@ private:
             &actualRadius
         );
         
-        if (entity != entt::null) {
-            // 添加自转
-            auto& orbit = registry.emplace<components::OrbitComponent>(entity);
-            orbit.orbitEnabled = false;           // 太阳不公转
-            orbit.rotationEnabled = true;         // 但会自转
-            orbit.rotationPeriod = config.rotationPeriod;
-            orbit.rotationAxis = { 0.0f, 1.0f, 0.0f };
-            
-            // 获取 PhysX 引擎
-            auto& physxManager = PhysXManager::GetInstance();
-            auto* pxPhysics = physxManager.GetPhysics();
-            auto* pxScene = physxManager.GetScene();
-            
-            // 太阳作为默认"太空"扇区
-            auto& sector = registry.emplace<components::SectorComponent>(entity);
-            sector.name = "Sun (Space)";
-            sector.worldPosition = { 0.0f, 0.0f, 0.0f };
-            sector.worldRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
-            sector.planetRadius = config.radius;
-            // 太阳扇区覆盖整个太阳系（海王星轨道 32 * 250 = 8000m，再加一些余量）
-            sector.influenceRadius = 15000.0f;
-            sector.priority = -100;  // 最低优先级，只有不在任何行星扇区时才使用
-            sector.isActive = true;
-            
-            // 太阳不需要碰撞体（不能着陆）
-            sector.physxGround = nullptr;
-            
-            std::cout << "[Sun] Created as default space sector, influenceRadius=" << sector.influenceRadius 
-                      << ", priority=" << sector.priority << std::endl;
-
-        } else {
+        if (entity == entt::null) {
             std::cout << "[Sun] FAILED to load model: " << modelPath << std::endl;
+            return false;
         }
         
-        return entity;
+        BodySetup& body = bodies.emplace_back();
+        body.name = "Sun";
+        body.entity = entity;
+        
+        // 添加自转
+        body.orbit.orbitEnabled = false;           // 太阳不公转
+        body.orbit.rotationEnabled = true;         // 但会自转
+        body.orbit.rotationPeriod = config.rotationPeriod;
+        body.orbit.rotationAxis = { 0.0f, 1.0f, 0.0f };
+        
+        // 远处以替身绘制
+        body.impostor.radius = config.radius;
+        
+        // 太阳作为默认"太空"扇区
+        body.hasSector = true;
+        auto& sector = body.sector;
+        sector.name = "Sun (Space)";
+        sector.absolutePosition = FloatingOrigin::GetInstance().ToAbsolute({ 0.0f, 0.0f, 0.0f });
+        sector.worldPosition = { 0.0f, 0.0f, 0.0f };
+        sector.worldRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        sector.planetRadius = config.radius;
+        // 太阳扇区覆盖整个太阳系（海王星轨道 32 * 250 = 8000m，再加一些余量）
+        sector.influenceRadius = 15000.0f;
+        sector.priority = -100;  // 最低优先级，只有不在任何行星扇区时才使用
+        sector.isActive = true;
+        
+        // 太阳不需要碰撞体（不能着陆）
+        sector.physxGround = nullptr;
+        
+        std::cout << "[Sun] Created as default space sector, influenceRadius=" << sector.influenceRadius 
+                  << ", priority=" << sector.priority << std::endl;
+        return true;
     }
     
     /**
-     * 创建行星
+     * 行星
      */
-    static entt::entity CreatePlanet(
+    static bool DescribePlanet(
         entt::registry& registry,
         std::shared_ptr<Scene> scene,
         ID3D11Device* device,
         const std::string& basePath,
         const PlanetConfig& config,
-        physx::PxPhysics* pxPhysics,
-        physx::PxScene* pxScene
+        std::vector<BodySetup>& bodies
     ) {
         if (config.modelPath.empty()) {
             std::cout << "[" << config.name << "] Skipped (no model)" << std::endl;
-            return entt::null;
+            return false;
         }
         
         std::string modelPath = basePath + "/" + config.modelPath;
         std::string texturePath = config.texturePath.empty() ? "" : basePath + "/" + config.texturePath;
         
-        
         // 计算初始位置（基于轨道半径和初始角度）
         float x = config.orbitRadius * std::cos(config.initialAngle);
         float z = config.orbitRadius * std::sin(config.initialAngle);
@@ -207,7 +394,7 @@ private:
         float actualRadius = 0.0f;
         entt::entity entity = entt::null;
         
-        // GLB/GLTF 使用多材质加载器
+        // GLB/GLTF 使用多材质加载器（内嵌贴图打包进共享纹理数组；静态模型烘焙节点变换、按材质合并子网格）
         if (ext == "glb" || ext == "gltf") {
             entity = SceneAssetLoader::LoadMultiMaterialModelWithRadius(
                 registry, scene, device,
@@ -215,7 +402,9 @@ private:
                 texturePath,
                 position,
                 config.radius,
-                &actualRadius
+                &actualRadius,
+                true,   // packTextureArrays
+                true    // staticMerge
             );
         } else {
             // OBJ/FBX 等使用普通加载器
@@ -231,22 +420,27 @@ private:
         
         if (entity == entt::null) {
             std::cout << "[" << config.name << "] FAILED to load model: " << modelPath << std::endl;
-            return entt::null;
+            return false;
         }
         
-        // 验证 TransformComponent 的位置
-        auto* transform = registry.try_get<TransformComponent>(entity);
-        if (transform) {
+        if (config.hasRings) {
+            AttachRingField(registry, device, entity, config);
         }
         
-        // 添加轨道组件
-        auto& orbit = registry.emplace<components::OrbitComponent>(entity);
+        BodySetup& body = bodies.emplace_back();
+        body.name = config.name;
+        body.entity = entity;
+        
+        // 轨道
+        auto& orbit = body.orbit;
         orbit.orbitCenter = { 0.0f, 0.0f, 0.0f };      // 围绕太阳
         orbit.orbitRadius = config.orbitRadius;
         orbit.orbitPeriod = config.orbitPeriod;
         orbit.orbitAngle = config.initialAngle;
         orbit.orbitNormal = { 0.0f, 1.0f, 0.0f };
         orbit.orbitInclination = config.orbitInclination;
+        orbit.eccentricity = config.eccentricity;
+        orbit.argumentOfPeriapsis = config.argumentOfPeriapsis;
         orbit.orbitEnabled = true;
         orbit.rotationEnabled = config.rotationPeriod > 0;
         orbit.rotationPeriod = config.rotationPeriod;
@@ -256,11 +450,23 @@ private:
             0.0f 
         };
         
+        // 远处以替身绘制
+        body.impostor.radius = config.radius;
+        
+        // 大气散射（发光天体没有大气外壳）
+        if (config.atmosphereHeight > 0.0f && !config.isEmissive) {
+            body.hasAtmosphere = true;
+            body.atmosphere.planetRadius = config.radius;
+            body.atmosphere.atmosphereHeight = config.atmosphereHeight;
+        }
+        
         // 如果是重力源，添加相关组件
         if (config.isGravitySource) {
             // SectorComponent
-            auto& sector = registry.emplace<components::SectorComponent>(entity);
+            body.hasSector = true;
+            auto& sector = body.sector;
             sector.name = config.name;
+            sector.absolutePosition = FloatingOrigin::GetInstance().ToAbsolute(position);
             sector.worldPosition = position;
             sector.worldRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
             sector.planetRadius = config.radius;
@@ -271,7 +477,8 @@ private:
             sector.isActive = true;
             
             // GravitySourceComponent
-            auto& gravity = registry.emplace<components::GravitySourceComponent>(entity);
+            body.hasGravity = true;
+            auto& gravity = body.gravity;
             gravity.radius = config.radius;
             gravity.surfaceGravity = config.surfaceGravity;
             // 重力影响范围也要足够大
@@ -280,64 +487,45 @@ private:
             gravity.useRealisticGravity = false;
             
             // 如果需要碰撞体
-            // 【重要】PhysX 碰撞体必须在扇区原点 (0,0,0)！
-            // SectorPhysicsSystem 使用 InSectorComponent.localPosition（相对于扇区原点）计算物理
-            // 扇区的 worldPosition 由 OrbitSystem 更新，用于坐标转换
-            if (config.hasCollision && pxPhysics && pxScene) {
-                physx::PxMaterial* material = pxPhysics->createMaterial(0.5f, 0.5f, 0.3f);
-                // 【关键修复】碰撞体在原点，而不是世界位置！
-                physx::PxTransform pose(physx::PxVec3(0.0f, 0.0f, 0.0f));
-                physx::PxRigidStatic* actor = pxPhysics->createRigidStatic(pose);
-                
-                physx::PxShape* shape = physx::PxRigidActorExt::createExclusiveShape(
-                    *actor,
-                    physx::PxSphereGeometry(config.radius),
-                    *material
-                );
-                shape->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, false);  // 默认禁用
-                shape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);   // 默认禁用，由 SectorPhysicsSystem 启用当前扇区
-                
-                pxScene->addActor(*actor);
-                sector.physxGround = actor;
-                
-                std::cout << "[" << config.name << "] Created sector with radius=" << config.radius 
-                          << ", influenceRadius=" << sector.influenceRadius << ", priority=" << sector.priority << std::endl;
+            if (config.hasCollision) {
+                body.colliderRadius = config.radius;
+                DescribeTerrain(registry, body, config.radius);
             }
         }
         
-
-        
-        return entity;
+        return true;
     }
     
     /**
-     * 创建卫星（围绕行星公转）
+     * 卫星（围绕行星公转）
      * 卫星也有自己的扇区、重力和碰撞体
      */
-    static entt::entity CreateMoon(
+    static bool DescribeMoon(
         entt::registry& registry,
         std::shared_ptr<Scene> scene,
         ID3D11Device* device,
         const std::string& basePath,
         const MoonConfig& config,
-        entt::entity parentPlanet
+        entt::entity parentPlanet,
+        std::vector<BodySetup>& bodies
     ) {
         std::string modelPath = basePath + "/" + config.modelPath;
         std::string texturePath = config.texturePath.empty() ? "" : basePath + "/" + config.texturePath;
         
         std::cout << "\n=== Creating " << config.name << " (orbiting " << config.parentPlanet << ") ===" << std::endl;
         
-        // 获取父行星位置
+        // 获取父行星位置（父行星的渲染实体已在本次构建中创建）
         auto* parentTransform = registry.try_get<TransformComponent>(parentPlanet);
         if (!parentTransform) {
-            return entt::null;
+            return false;
         }
+        const DirectX::XMFLOAT3 parentPosition = parentTransform->position;
         
         // 初始位置（在父行星旁边）
         DirectX::XMFLOAT3 position = {
-            parentTransform->position.x + config.orbitRadius,
-            parentTransform->position.y,
-            parentTransform->position.z
+            parentPosition.x + config.orbitRadius,
+            parentPosition.y,
+            parentPosition.z
         };
         
         float actualRadius = 0.0f;
@@ -351,14 +539,17 @@ private:
         );
         
         if (entity == entt::null) {
-            
-            return entt::null;
+            return false;
         }
         
-        // 添加轨道组件（围绕父行星）
-        auto& orbit = registry.emplace<components::OrbitComponent>(entity);
+        BodySetup& body = bodies.emplace_back();
+        body.name = config.name;
+        body.entity = entity;
+        
+        // 轨道（围绕父行星）
+        auto& orbit = body.orbit;
         orbit.orbitParent = parentPlanet;             // 【关键】围绕父行星
-        orbit.orbitCenter = parentTransform->position;
+        orbit.orbitCenter = FloatingOrigin::GetInstance().ToAbsolute(parentPosition);
         orbit.orbitRadius = config.orbitRadius;
         orbit.orbitPeriod = config.orbitPeriod;
         orbit.orbitAngle = 0.0f;
@@ -368,14 +559,14 @@ private:
         orbit.rotationEnabled = true;                 // 潮汐锁定
         orbit.rotationPeriod = config.rotationPeriod;
         
-        // 获取 PhysX 引擎
-        auto& physxManager = PhysXManager::GetInstance();
-        auto* pxPhysics = physxManager.GetPhysics();
-        auto* pxScene = physxManager.GetScene();
+        // 远处以替身绘制
+        body.impostor.radius = config.radius;
         
-        // 添加 SectorComponent（月球有自己的扇区）
-        auto& sector = registry.emplace<components::SectorComponent>(entity);
+        // SectorComponent（月球有自己的扇区）
+        body.hasSector = true;
+        auto& sector = body.sector;
         sector.name = config.name;
+        sector.absolutePosition = FloatingOrigin::GetInstance().ToAbsolute(position);
         sector.worldPosition = position;
         sector.worldRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
         sector.planetRadius = config.radius;
@@ -386,40 +577,21 @@ private:
         sector.parentSector = parentPlanet;
         sector.isActive = true;
         
-        // 添加 GravitySourceComponent
+        // GravitySourceComponent
         const float MOON_SURFACE_GRAVITY = 1.62f;  // 月球表面重力
-        auto& gravity = registry.emplace<components::GravitySourceComponent>(entity);
+        body.hasGravity = true;
+        auto& gravity = body.gravity;
         gravity.radius = config.radius;
         gravity.surfaceGravity = MOON_SURFACE_GRAVITY;
         gravity.atmosphereHeight = config.radius * 0.5f;  // 月球重力影响范围
         gravity.isActive = true;
         gravity.useRealisticGravity = false;
         
-        // 创建 PhysX 碰撞体
-        if (pxPhysics && pxScene) {
-            physx::PxMaterial* material = pxPhysics->createMaterial(0.5f, 0.5f, 0.3f);
-            // 碰撞体在扇区原点
-            physx::PxTransform pose(physx::PxVec3(0.0f, 0.0f, 0.0f));
-            physx::PxRigidStatic* actor = pxPhysics->createRigidStatic(pose);
-            
-            physx::PxShape* shape = physx::PxRigidActorExt::createExclusiveShape(
-                *actor,
-                physx::PxSphereGeometry(config.radius),
-                *material
-            );
-            // 默认禁用，由 SectorPhysicsSystem 在切换到月球扇区时启用
-            shape->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, false);
-            shape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
-            
-            pxScene->addActor(*actor);
-            sector.physxGround = actor;
-            
-            std::cout << "[" << config.name << "] Created sector with radius=" << config.radius 
-                      << ", influenceRadius=" << sector.influenceRadius << ", priority=" << sector.priority << std::endl;
-        }
-
+        // PhysX 碰撞体（扇区原点）
+        body.colliderRadius = config.radius;
+        DescribeTerrain(registry, body, config.radius);
         
-        return entity;
+        return true;
     }
 };
 
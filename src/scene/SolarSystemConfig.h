@@ -49,6 +49,10 @@ struct PlanetConfig {
     // 物理属性
     bool isGravitySource;       // 是否是重力源
     bool hasCollision;          // 是否有碰撞体
+    
+    // 椭圆轨道（可省略，默认圆轨道）
+    float eccentricity = 0.0f;          // 偏心率
+    float argumentOfPeriapsis = 0.0f;   // 近心点幅角（弧度）
 };
 
 /**
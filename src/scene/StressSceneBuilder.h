@@ -0,0 +1,354 @@
+/**
+ * StressSceneBuilder.h
+ *
+ * 压力测试场景构建器 - 按参数程序化生成大规模场景（配合 --headless 测扩展曲线）
+ *
+ * 生成内容（全部确定性，只取决于 seed）：
+ * - K 个扇区（星球），分成若干条 orbitParent 链，每条链深度 D（子天体围绕父天体公转）
+ * - 每个扇区 N 个受重力影响的 PhysX 动态球体，部分生成在影响半径之外，落向星球时触发扇区切换
+ * - M 个共享同一网格/材质的小行星（可实例化），在环带上各自公转
+ *
+ * 扇区放在海王星轨道之外、太阳扇区之内，与 SolarSystemBuilder 的手工场景共存。
+ */
+
+#pragma once
+#include "Scene.h"
+#include "SceneAssetLoader.h"
+#include "components/TransformComponent.h"
+#include "../graphics/components/MeshComponent.h"
+#include "../graphics/components/BoundsComponent.h"
+#include "../graphics/components/RenderPriorityComponent.h"
+#include "../graphics/components/ImpostorComponent.h"
+#include "../graphics/resources/TerrainGenerator.h"
+#include "../physics/components/OrbitComponent.h"
+#include "../physics/components/SectorComponent.h"
+#include "../physics/components/GravitySourceComponent.h"
+#include "../physics/components/GravityAffectedComponent.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include "../physics/PhysXManager.h"
+#include "../physics/FloatingOrigin.h"
+#include <entt/entt.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace outer_wilds {
+
+/**
+ * 压力场景参数（命令行：--stress-sectors K --stress-bodies N --stress-asteroids M --stress-depth D）
+ */
+struct StressSceneConfig {
+    uint32_t sectorCount = 16;          // K
+    uint32_t bodiesPerSector = 32;      // N
+    uint32_t asteroidCount = 2000;      // M
+    uint32_t orbitChainDepth = 3;       // D（1 = 所有扇区直接绕太阳）
+    uint32_t seed = 1;
+
+    float rootPlanetRadius = 40.0f;     // 链根星球半径；每深一级缩小为 childRadiusScale 倍
+    float childRadiusScale = 0.6f;
+    float innerOrbitRadius = 9000.0f;   // 链根的轨道半径范围（海王星 8000m 之外，太阳扇区 15000m 之内）
+    float outerOrbitRadius = 13000.0f;
+    float asteroidBeltInner = 8500.0f;
+    float asteroidBeltOuter = 14000.0f;
+    float bodyRadius = 0.5f;
+
+    bool IsEnabled() const { return sectorCount > 0 || asteroidCount > 0; }
+};
+
+/**
+ * 压力场景构建结果
+ */
+struct StressSceneEntities {
+    std::vector<entt::entity> sectors;
+    std::vector<entt::entity> bodies;
+    std::vector<entt::entity> asteroids;
+};
+
+class StressSceneBuilder {
+public:
+    static StressSceneEntities Build(
+        entt::registry& registry,
+        ID3D11Device* device,
+        const StressSceneConfig& config
+    ) {
+        StressSceneEntities result;
+        std::mt19937 rng(config.seed);
+        auto& physxManager = PhysXManager::GetInstance();
+        auto* pxPhysics = physxManager.GetPhysics();
+        auto* pxScene = physxManager.GetScene();
+
+        // 所有实体共享三份网格和一份材质（同网格同材质的批次可以实例化）
+        auto planetMesh = CreateSharedSphere(device, 32, 48);
+        auto bodyMesh = CreateSharedSphere(device, 8, 12);
+        auto asteroidMesh = CreateSharedSphere(device, 6, 8);
+        auto material = SceneAssetLoader::CreateMaterialResource(device, "");
+        physx::PxMaterial* groundMaterial = pxPhysics ? pxPhysics->createMaterial(0.5f, 0.5f, 0.3f) : nullptr;
+        physx::PxMaterial* bodyMaterial = pxPhysics ? pxPhysics->createMaterial(0.6f, 0.6f, 0.1f) : nullptr;
+
+        // === 1. 扇区：orbitParent 链 ===
+        const uint32_t depth = std::max(1u, config.orbitChainDepth);
+        const uint32_t chainCount = (config.sectorCount + depth - 1) / depth;
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        for (uint32_t chain = 0; chain < chainCount; chain++) {
+            entt::entity parent = entt::null;
+            float parentRadius = 0.0f;
+            for (uint32_t level = 0; level < depth && result.sectors.size() < config.sectorCount; level++) {
+                const float radius = config.rootPlanetRadius * std::pow(config.childRadiusScale, static_cast<float>(level));
+                SectorParams fields;
+                fields.name = "Stress " + std::to_string(chain) + "." + std::to_string(level);
+                fields.radius = radius;
+                fields.level = level;
+                if (parent == entt::null) {
+                    fields.orbitRadius = config.innerOrbitRadius +
+                        (config.outerOrbitRadius - config.innerOrbitRadius) * unit(rng);
+                    fields.orbitPeriod = 600.0f + 600.0f * unit(rng);
+                } else {
+                    // 子天体轨道在父天体影响半径之外，扇区不重叠
+                    fields.orbitRadius = parentRadius * 4.0f + radius * 3.0f;
+                    fields.orbitPeriod = 60.0f + 120.0f * unit(rng);
+                }
+                fields.initialAngle = DirectX::XM_2PI * unit(rng);
+
+                entt::entity sector = CreateSector(registry, fields, parent, planetMesh, material,
+                                                   pxPhysics, pxScene, groundMaterial);
+                result.sectors.push_back(sector);
+                parent = sector;
+                parentRadius = radius;
+            }
+        }
+
+        // === 2. 每个扇区的动态刚体 ===
+        for (entt::entity sector : result.sectors) {
+            for (uint32_t i = 0; i < config.bodiesPerSector; i++) {
+                entt::entity body = CreateBody(registry, sector, config, rng, bodyMesh, material,
+                                               pxPhysics, pxScene, bodyMaterial);
+                if (body != entt::null) result.bodies.push_back(body);
+            }
+        }
+
+        // === 3. 共享网格的小行星环 ===
+        result.asteroids.reserve(config.asteroidCount);
+        for (uint32_t i = 0; i < config.asteroidCount; i++) {
+            result.asteroids.push_back(CreateAsteroid(registry, config, rng, asteroidMesh, material));
+        }
+
+        std::cout << "[StressScene] Created " << result.sectors.size() << " sectors (" << chainCount
+                  << " chains, depth " << depth << "), " << result.bodies.size() << " dynamic bodies, "
+                  << result.asteroids.size() << " asteroids (seed " << config.seed << ")" << std::endl;
+        return result;
+    }
+
+private:
+    struct SectorParams {
+        std::string name;
+        float radius = 1.0f;
+        float orbitRadius = 0.0f;
+        float orbitPeriod = 1.0f;
+        float initialAngle = 0.0f;
+        uint32_t level = 0;
+    };
+
+    static std::shared_ptr<resources::Mesh> CreateSharedSphere(ID3D11Device* device, int stacks, int slices) {
+        auto mesh = std::make_shared<resources::Mesh>();
+        resources::TerrainGenerator::CreateSphere(*mesh, 1.0f, stacks, slices);
+        if (device) {
+            mesh->CreateGPUBuffers(device);
+        }
+        return mesh;
+    }
+
+    static void AttachRenderable(entt::registry& registry, entt::entity entity,
+                                 const std::shared_ptr<resources::Mesh>& mesh,
+                                 const std::shared_ptr<resources::Material>& material) {
+        registry.emplace<components::MeshComponent>(entity, mesh, material);
+        registry.emplace<components::BoundsComponent>(entity).SetSphere(
+            DirectX::BoundingSphere(DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f), 1.0f));
+        auto& priority = registry.emplace<components::RenderPriorityComponent>(entity);
+        priority.sortKey = 1000;
+        priority.renderPass = 0;  // Opaque
+    }
+
+    /**
+     * 创建扇区星球（结构与 SolarSystemBuilder::CreatePlanet / CreateMoon 相同）
+     */
+    static entt::entity CreateSector(
+        entt::registry& registry,
+        const SectorParams& params,
+        entt::entity parent,
+        const std::shared_ptr<resources::Mesh>& mesh,
+        const std::shared_ptr<resources::Material>& material,
+        physx::PxPhysics* pxPhysics,
+        physx::PxScene* pxScene,
+        physx::PxMaterial* groundMaterial
+    ) {
+        // 初始位置：父天体（或原点）加上轨道偏移，OrbitSystem 第一帧就会改写
+        DirectX::XMFLOAT3 center = { 0.0f, 0.0f, 0.0f };
+        if (parent != entt::null) {
+            center = registry.get<TransformComponent>(parent).position;
+        }
+        DirectX::XMFLOAT3 position = {
+            center.x + params.orbitRadius * std::cos(params.initialAngle),
+            center.y,
+            center.z + params.orbitRadius * std::sin(params.initialAngle)
+        };
+
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<TransformComponent>(entity);
+        transform.position = position;
+        transform.scale = { params.radius, params.radius, params.radius };
+        transform.rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        AttachRenderable(registry, entity, mesh, material);
+        registry.emplace<components::ImpostorComponent>(entity).radius = params.radius;
+
+        auto& orbit = registry.emplace<components::OrbitComponent>(entity);
+        orbit.orbitParent = parent;
+        orbit.orbitCenter = FloatingOrigin::GetInstance().ToAbsolute(center);
+        orbit.orbitRadius = params.orbitRadius;
+        orbit.orbitPeriod = params.orbitPeriod;
+        orbit.orbitAngle = params.initialAngle;
+        orbit.orbitNormal = { 0.0f, 1.0f, 0.0f };
+        orbit.orbitInclination = parent == entt::null ? 0.0f : 0.1f;
+        orbit.orbitEnabled = true;
+        orbit.rotationEnabled = true;
+        orbit.rotationPeriod = 120.0f;
+
+        auto& sector = registry.emplace<components::SectorComponent>(entity);
+        sector.name = params.name;
+        sector.absolutePosition = FloatingOrigin::GetInstance().ToAbsolute(position);
+        sector.worldPosition = position;
+        sector.worldRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        sector.planetRadius = params.radius;
+        sector.influenceRadius = params.radius * 3.0f;
+        // 链上越深优先级越高（同月球相对地球）
+        sector.priority = static_cast<int>(params.level) * 10;
+        sector.parentSector = parent;
+        sector.isActive = true;
+
+        auto& gravity = registry.emplace<components::GravitySourceComponent>(entity);
+        gravity.radius = params.radius;
+        gravity.surfaceGravity = 9.8f;
+        gravity.atmosphereHeight = params.radius * 2.0f;
+        gravity.isActive = true;
+        gravity.useRealisticGravity = false;
+
+        // 碰撞体在扇区原点，默认禁用，由 SectorPhysicsSystem 在切换扇区时启用
+        if (pxPhysics && pxScene && groundMaterial) {
+            physx::PxRigidStatic* actor = pxPhysics->createRigidStatic(physx::PxTransform(physx::PxVec3(0.0f)));
+            physx::PxShape* shape = physx::PxRigidActorExt::createExclusiveShape(
+                *actor, physx::PxSphereGeometry(params.radius), *groundMaterial);
+            shape->setFlag(physx::PxShapeFlag::eSCENE_QUERY_SHAPE, false);
+            shape->setFlag(physx::PxShapeFlag::eSIMULATION_SHAPE, false);
+            pxScene->addActor(*actor);
+            sector.physxGround = actor;
+        }
+        return entity;
+    }
+
+    /**
+     * 扇区内受重力的动态球体：约 1/4 生成在影响半径之外（先属于太空扇区再落入），其余在地表上方
+     */
+    static entt::entity CreateBody(
+        entt::registry& registry,
+        entt::entity sectorEntity,
+        const StressSceneConfig& config,
+        std::mt19937& rng,
+        const std::shared_ptr<resources::Mesh>& mesh,
+        const std::shared_ptr<resources::Material>& material,
+        physx::PxPhysics* pxPhysics,
+        physx::PxScene* pxScene,
+        physx::PxMaterial* bodyMaterial
+    ) {
+        if (!pxPhysics || !pxScene || !bodyMaterial) return entt::null;
+
+        const auto& sector = registry.get<components::SectorComponent>(sectorEntity);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+
+        // 均匀随机方向
+        DirectX::XMFLOAT3 direction = { normal(rng), normal(rng), normal(rng) };
+        DirectX::XMStoreFloat3(&direction, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&direction)));
+        const float altitude = unit(rng) < 0.25f
+            ? sector.influenceRadius * (1.05f + 0.2f * unit(rng))
+            : sector.planetRadius * (1.1f + 0.8f * unit(rng));
+        const DirectX::XMFLOAT3 local = { direction.x * altitude, direction.y * altitude, direction.z * altitude };
+
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<TransformComponent>(entity);
+        transform.position = { sector.worldPosition.x + local.x, sector.worldPosition.y + local.y,
+                               sector.worldPosition.z + local.z };
+        transform.scale = { config.bodyRadius, config.bodyRadius, config.bodyRadius };
+        transform.rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        AttachRenderable(registry, entity, mesh, material);
+
+        auto& inSector = registry.emplace<components::InSectorComponent>(entity);
+        inSector.sector = sectorEntity;
+        inSector.localPosition = local;
+        inSector.isInitialized = true;
+
+        auto& gravityAffected = registry.emplace<components::GravityAffectedComponent>(entity);
+        gravityAffected.affectedByGravity = true;
+        gravityAffected.currentGravitySource = sectorEntity;
+        gravityAffected.currentGravityDir = { -direction.x, -direction.y, -direction.z };
+        gravityAffected.currentGravityStrength = 9.8f;
+
+        auto& rigidBody = registry.emplace<RigidBodyComponent>(entity);
+        rigidBody.mass = 10.0f;
+        rigidBody.drag = 0.05f;
+        rigidBody.useGravity = true;
+
+        // [来源: StressSceneBuilder 场景初始化] PhysX 使用扇区局部坐标
+        physx::PxRigidDynamic* actor = pxPhysics->createRigidDynamic(
+            physx::PxTransform(physx::PxVec3(local.x, local.y, local.z)));
+        physx::PxRigidActorExt::createExclusiveShape(*actor, physx::PxSphereGeometry(config.bodyRadius), *bodyMaterial);
+        physx::PxRigidBodyExt::updateMassAndInertia(*actor, 1.0f);
+        actor->setMass(rigidBody.mass);
+        actor->setLinearDamping(rigidBody.drag);
+        actor->userData = ToActorUserData(entity);
+        pxScene->addActor(*actor);
+        rigidBody.physxActor = actor;
+        return entity;
+    }
+
+    /**
+     * 小行星：只渲染、不参与物理，各自在环带上公转（OrbitSystem 负担随 M 增长）
+     */
+    static entt::entity CreateAsteroid(
+        entt::registry& registry,
+        const StressSceneConfig& config,
+        std::mt19937& rng,
+        const std::shared_ptr<resources::Mesh>& mesh,
+        const std::shared_ptr<resources::Material>& material
+    ) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float orbitRadius = config.asteroidBeltInner + (config.asteroidBeltOuter - config.asteroidBeltInner) * unit(rng);
+        const float angle = DirectX::XM_2PI * unit(rng);
+        const float size = 0.5f + 4.0f * unit(rng) * unit(rng);
+
+        entt::entity entity = registry.create();
+        auto& transform = registry.emplace<TransformComponent>(entity);
+        transform.position = { orbitRadius * std::cos(angle), 0.0f, orbitRadius * std::sin(angle) };
+        transform.scale = { size, size * (0.6f + 0.4f * unit(rng)), size };
+        transform.rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        AttachRenderable(registry, entity, mesh, material);
+
+        auto& orbit = registry.emplace<components::OrbitComponent>(entity);
+        orbit.orbitCenter = FloatingOrigin::GetInstance().ToAbsolute({ 0.0f, 0.0f, 0.0f });
+        orbit.orbitRadius = orbitRadius;
+        orbit.orbitPeriod = 900.0f + 900.0f * unit(rng);
+        orbit.orbitAngle = angle;
+        orbit.orbitInclination = 0.05f * (unit(rng) - 0.5f);
+        orbit.eccentricity = 0.05f * unit(rng);
+        orbit.orbitEnabled = true;
+        orbit.rotationEnabled = true;
+        orbit.rotationPeriod = 20.0f + 60.0f * unit(rng);
+        DirectX::XMFLOAT3 axis = { unit(rng) - 0.5f, 1.0f, unit(rng) - 0.5f };
+        DirectX::XMStoreFloat3(&orbit.rotationAxis, DirectX::XMVector3Normalize(DirectX::XMLoadFloat3(&axis)));
+        return entity;
+    }
+};
+
+} // namespace outer_wilds
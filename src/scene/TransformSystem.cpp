@@ -0,0 +1,167 @@
+#include "TransformSystem.h"
+#include "components/TransformComponent.h"
+#include "components/HierarchyComponent.h"
+
+namespace outer_wilds {
+
+using components::HierarchyComponent;
+
+uint32_t TransformSystem::s_StructureVersion = 0;
+
+void TransformSystem::Update(float deltaTime, entt::registry& registry) {
+    (void)deltaTime;
+    UpdateWorldMatrices(registry);
+}
+
+void TransformSystem::DeclareAccess(SystemAccess& access) const {
+    access.Write<TransformComponent, HierarchyComponent>();
+}
+
+uint32_t TransformSystem::UpdateWorldMatrices(entt::registry& registry) {
+    PropagateHierarchy(registry);
+
+    m_Generation++;
+    uint32_t updated = 0;
+    auto view = registry.view<TransformComponent>();
+    for (auto entity : view) {
+        if (view.get<TransformComponent>(entity).RefreshWorldMatrix(m_Generation)) {
+            updated++;
+        }
+    }
+    m_LastUpdatedCount = updated;
+    return updated;
+}
+
+void TransformSystem::PropagateHierarchy(entt::registry& registry) {
+    // 结构变化后按 depth 重排存储池：之后的遍历顺序保证父实体的 Transform 已是本帧结果
+    if (m_SortedStructureVersion != s_StructureVersion) {
+        registry.sort<HierarchyComponent>([](const HierarchyComponent& a, const HierarchyComponent& b) {
+            return a.depth < b.depth;
+        });
+        m_SortedStructureVersion = s_StructureVersion;
+    }
+
+    auto view = registry.view<HierarchyComponent>();
+    for (auto entity : view) {
+        const auto& hierarchy = view.get<HierarchyComponent>(entity);
+        if (hierarchy.parent == entt::null) continue;
+
+        const auto* parentTransform = registry.try_get<TransformComponent>(hierarchy.parent);
+        auto* transform = registry.try_get<TransformComponent>(entity);
+        if (!parentTransform || !transform) continue;
+
+        // world = S_local * R_local * T_local * S_parent * R_parent * T_parent（非均匀缩放下忽略切变）
+        const DirectX::XMVECTOR parentRotation = DirectX::XMLoadFloat4(&parentTransform->rotation);
+        const DirectX::XMVECTOR parentScale = DirectX::XMLoadFloat3(&parentTransform->scale);
+        const DirectX::XMVECTOR offset = DirectX::XMVector3Rotate(
+            DirectX::XMVectorMultiply(DirectX::XMLoadFloat3(&hierarchy.localPosition), parentScale), parentRotation);
+        DirectX::XMStoreFloat3(&transform->position,
+            DirectX::XMVectorAdd(DirectX::XMLoadFloat3(&parentTransform->position), offset));
+        DirectX::XMStoreFloat4(&transform->rotation,
+            DirectX::XMQuaternionMultiply(DirectX::XMLoadFloat4(&hierarchy.localRotation), parentRotation));
+        DirectX::XMStoreFloat3(&transform->scale,
+            DirectX::XMVectorMultiply(DirectX::XMLoadFloat3(&hierarchy.localScale), parentScale));
+    }
+}
+
+void TransformSystem::Attach(entt::registry& registry, entt::entity child, entt::entity parent,
+                             const DirectX::XMFLOAT3& localPosition, const DirectX::XMFLOAT4& localRotation,
+                             const DirectX::XMFLOAT3& localScale) {
+    if (child == parent || !registry.valid(child) || !registry.valid(parent)) return;
+    for (const auto* ancestor = registry.try_get<HierarchyComponent>(parent); ancestor && ancestor->parent != entt::null;
+         ancestor = registry.try_get<HierarchyComponent>(ancestor->parent)) {
+        if (ancestor->parent == child) return;   // 会形成环
+    }
+
+    // connect 会先断开同一个监听者，重复调用不会重复登记
+    registry.on_destroy<HierarchyComponent>().connect<&TransformSystem::OnHierarchyDestroyed>();
+
+    if (!registry.try_get<HierarchyComponent>(parent)) registry.emplace<HierarchyComponent>(parent);
+    if (!registry.try_get<HierarchyComponent>(child)) registry.emplace<HierarchyComponent>(child);
+    Unlink(registry, child);
+
+    auto& parentNode = registry.get<HierarchyComponent>(parent);
+    auto& childNode = registry.get<HierarchyComponent>(child);
+
+    // 插到子链表头部
+    childNode.parent = parent;
+    childNode.prevSibling = entt::null;
+    childNode.nextSibling = parentNode.firstChild;
+    if (parentNode.firstChild != entt::null) {
+        registry.get<HierarchyComponent>(parentNode.firstChild).prevSibling = child;
+    }
+    parentNode.firstChild = child;
+    parentNode.childCount++;
+
+    childNode.localPosition = localPosition;
+    childNode.localRotation = localRotation;
+    childNode.localScale = localScale;
+    SetSubtreeDepth(registry, child, parentNode.depth + 1);
+    s_StructureVersion++;
+}
+
+void TransformSystem::Detach(entt::registry& registry, entt::entity child) {
+    if (!registry.valid(child) || !registry.try_get<HierarchyComponent>(child)) return;
+    Unlink(registry, child);
+    SetSubtreeDepth(registry, child, 0);
+    s_StructureVersion++;
+}
+
+void TransformSystem::Unlink(entt::registry& registry, entt::entity child) {
+    auto& node = registry.get<HierarchyComponent>(child);
+    if (node.parent == entt::null) return;
+
+    // try_get：registry.clear() 时同一链表上的其他节点可能已先被移除
+    auto* parentNode = registry.valid(node.parent) ? registry.try_get<HierarchyComponent>(node.parent) : nullptr;
+    auto* prevNode = node.prevSibling != entt::null ? registry.try_get<HierarchyComponent>(node.prevSibling) : nullptr;
+    auto* nextNode = node.nextSibling != entt::null ? registry.try_get<HierarchyComponent>(node.nextSibling) : nullptr;
+    if (prevNode) {
+        prevNode->nextSibling = node.nextSibling;
+    } else if (parentNode && parentNode->firstChild == child) {
+        parentNode->firstChild = node.nextSibling;
+    }
+    if (nextNode) {
+        nextNode->prevSibling = node.prevSibling;
+    }
+    if (parentNode && parentNode->childCount > 0) {
+        parentNode->childCount--;
+    }
+
+    node.parent = entt::null;
+    node.prevSibling = entt::null;
+    node.nextSibling = entt::null;
+}
+
+void TransformSystem::SetSubtreeDepth(entt::registry& registry, entt::entity root, uint32_t depth) {
+    auto& node = registry.get<HierarchyComponent>(root);
+    node.depth = depth;
+    for (entt::entity child = node.firstChild; child != entt::null;) {
+        auto* childNode = registry.try_get<HierarchyComponent>(child);
+        if (!childNode) break;
+        SetSubtreeDepth(registry, child, depth + 1);
+        child = childNode->nextSibling;
+    }
+}
+
+void TransformSystem::OnHierarchyDestroyed(entt::registry& registry, entt::entity entity) {
+    Unlink(registry, entity);
+
+    // 子实体保留当前世界 Transform，成为根
+    auto& node = registry.get<HierarchyComponent>(entity);
+    entt::entity child = node.firstChild;
+    while (child != entt::null) {
+        auto* childNode = registry.try_get<HierarchyComponent>(child);
+        if (!childNode) break;
+        const entt::entity next = childNode->nextSibling;
+        childNode->parent = entt::null;
+        childNode->prevSibling = entt::null;
+        childNode->nextSibling = entt::null;
+        SetSubtreeDepth(registry, child, 0);
+        child = next;
+    }
+    node.firstChild = entt::null;
+    node.childCount = 0;
+    s_StructureVersion++;
+}
+
+} // namespace outer_wilds
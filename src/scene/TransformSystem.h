@@ -0,0 +1,67 @@
+/**
+ * TransformSystem.h
+ *
+ * 变换系统 - 变换层级传播 + 维护 TransformComponent 缓存的世界矩阵
+ *
+ * 每帧在物理插值之后、渲染之前由 Engine 调用一次（不参与 GameSystems 调度）：
+ * 1. 层级：HierarchyComponent 存储池按 depth 排序（只在结构变化后重排），顺序遍历即可保证
+ *    父实体先于子实体；子实体的 Transform = 局部变换 ∘ 父实体 Transform
+ * 2. 矩阵：顺序遍历 TransformComponent 的紧凑存储池，只有 TRS 与上次缓存不同的实体才重算矩阵，
+ *    重算的实体 version 记为本次的代数，RenderQueue 据此只刷新移动过的批次和包围球
+ *
+ * 星球表面的静态物体相对扇区不动，但扇区随轨道运动时它们的世界 TRS 也会变化，照常重算。
+ */
+
+#pragma once
+#include "../core/ECS.h"
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace outer_wilds {
+
+class TransformSystem : public System {
+public:
+    TransformSystem() = default;
+    ~TransformSystem() override = default;
+
+    void Update(float deltaTime, entt::registry& registry) override;
+
+    void DeclareAccess(SystemAccess& access) const override;
+
+    /** @brief 传播层级并刷新所有过期的世界矩阵，返回重算的矩阵数量 */
+    uint32_t UpdateWorldMatrices(entt::registry& registry);
+
+    uint32_t GetGeneration() const { return m_Generation; }
+    uint32_t GetLastUpdatedCount() const { return m_LastUpdatedCount; }
+
+    /**
+     * @brief 把 child 挂到 parent 下（已有父实体时先断开），子树的 depth 随之更新
+     *
+     * 两个实体都会获得 HierarchyComponent；child 的 Transform 从下一次 UpdateWorldMatrices 起由父实体推导。
+     * parent 不能是 child 自身或其后代。
+     */
+    static void Attach(entt::registry& registry, entt::entity child, entt::entity parent,
+                       const DirectX::XMFLOAT3& localPosition = { 0.0f, 0.0f, 0.0f },
+                       const DirectX::XMFLOAT4& localRotation = { 0.0f, 0.0f, 0.0f, 1.0f },
+                       const DirectX::XMFLOAT3& localScale = { 1.0f, 1.0f, 1.0f });
+
+    /** @brief 断开 child 与父实体的链接；child 保留当前世界 Transform，成为根 */
+    static void Detach(entt::registry& registry, entt::entity child);
+
+private:
+    // HierarchyComponent 销毁时从父链表摘除，子实体变为根
+    static void OnHierarchyDestroyed(entt::registry& registry, entt::entity entity);
+    static void Unlink(entt::registry& registry, entt::entity child);
+    static void SetSubtreeDepth(entt::registry& registry, entt::entity root, uint32_t depth);
+
+    void PropagateHierarchy(entt::registry& registry);
+
+    // 层级结构每次变化 +1（所有 registry 共用，只用于判断是否需要重排）
+    static uint32_t s_StructureVersion;
+
+    uint32_t m_SortedStructureVersion = 0;
+    uint32_t m_Generation = 0;        // 每次刷新 +1（从 1 开始，0 表示从未刷新）
+    uint32_t m_LastUpdatedCount = 0;
+};
+
+} // namespace outer_wilds
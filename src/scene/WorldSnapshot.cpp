@@ -0,0 +1,483 @@
+#include "WorldSnapshot.h"
+#include "AssetStreamer.h"
+#include "components/TransformComponent.h"
+#include "../physics/OrbitSystem.h"
+#include "../physics/FloatingOrigin.h"
+#include "../physics/components/SectorComponent.h"
+#include "../physics/components/OrbitComponent.h"
+#include "../physics/components/RigidBodyComponent.h"
+#include "../gameplay/components/SpacecraftComponent.h"
+#include "../gameplay/components/CharacterControllerComponent.h"
+#include "../input/InputManager.h"
+#include "../core/DebugManager.h"
+#include "../core/Profiler.h"
+#include <PxPhysicsAPI.h>
+#include <windows.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace outer_wilds {
+
+using components::SectorComponent;
+using components::InSectorComponent;
+using components::OrbitComponent;
+using components::SpacecraftComponent;
+using components::CharacterControllerComponent;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using EntityInteger = std::underlying_type_t<entt::entity>;
+
+    float ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    }
+
+    // === 快照字段：存档和读档共用同一份列表（顺序即文件格式，改动须提升 kVersion）===
+
+    template<typename Archive>
+    void Fields(Archive& ar, TransformComponent& c) {
+        ar.Field(c.position);
+        ar.Field(c.rotation);
+        ar.Field(c.scale);
+    }
+
+    template<typename Archive>
+    void Fields(Archive& ar, SectorComponent& c) {
+        ar.Field(c.absolutePosition);
+        ar.Field(c.worldRotation);
+        ar.Field(c.worldVelocity);
+    }
+
+    template<typename Archive>
+    void Fields(Archive& ar, OrbitComponent& c) {
+        ar.Field(c.orbitAngle);
+        ar.Field(c.rotationAngle);
+        ar.Field(c.orbitEnabled);
+        ar.Field(c.rotationEnabled);
+    }
+
+    template<typename Archive>
+    void Fields(Archive& ar, InSectorComponent& c) {
+        ar.Field(c.sector);
+        ar.Field(c.localPosition);
+        ar.Field(c.localRotation);
+    }
+
+    template<typename Archive>
+    void Fields(Archive& ar, RigidBodyComponent& c) {
+        ar.Field(c.velocity);           // 存档前由 Capture 从 actor 回读
+        ar.Field(c.angularVelocity);
+    }
+
+    template<typename Archive>
+    void Fields(Archive& ar, SpacecraftComponent& c) {
+        ar.Field(c.currentSpeed);
+        ar.Field(c.currentAngularVelocity);
+        ar.Field(c.isGrounded);
+        ar.Field(c.groundContact);
+    }
+
+    template<typename Archive>
+    void Fields(Archive& ar, CharacterControllerComponent& c) {
+        ar.Field(c.velocity);
+        ar.Field(c.isGrounded);
+        ar.Field(c.groundNormal);
+        ar.Field(c.localUp);
+        ar.Field(c.localForward);
+        ar.Field(c.localRight);
+        ar.Field(c.cameraYaw);
+        ar.Field(c.cameraPitch);
+    }
+
+    /**
+     * @brief entt::snapshot 的输出归档：实体 / 长度原样写入，组件只写 Fields 列出的状态字段
+     */
+    class SnapshotWriter {
+    public:
+        explicit SnapshotWriter(std::vector<uint8_t>& buffer) : m_Buffer(buffer) {}
+
+        void operator()(entt::entity entity) { Field(entity); }
+        void operator()(EntityInteger value) { Field(value); }
+        template<typename Type>
+        void operator()(const Type& component) { Fields(*this, const_cast<Type&>(component)); }   // Field 只读
+
+        template<typename Value>
+        void Field(const Value& value) {
+            static_assert(std::is_trivially_copyable_v<Value>, "snapshot fields must be trivially copyable");
+            const size_t offset = m_Buffer.size();
+            m_Buffer.resize(offset + sizeof(Value));
+            std::memcpy(m_Buffer.data() + offset, &value, sizeof(Value));
+        }
+
+    private:
+        std::vector<uint8_t>& m_Buffer;
+    };
+
+    /**
+     * @brief entt::snapshot_loader 的输入归档（越界后置失败标志，之后读出的都是 0）
+     */
+    class SnapshotReader {
+    public:
+        SnapshotReader(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+
+        void operator()(entt::entity& entity) { Field(entity); }
+        void operator()(EntityInteger& value) { Field(value); }
+        template<typename Type>
+        void operator()(Type& component) { Fields(*this, component); }
+
+        template<typename Value>
+        void Field(Value& value) {
+            static_assert(std::is_trivially_copyable_v<Value>, "snapshot fields must be trivially copyable");
+            if (m_Failed || m_Offset + sizeof(Value) > m_Size) {
+                m_Failed = true;
+                std::memset(&value, 0, sizeof(Value));
+                return;
+            }
+            std::memcpy(&value, m_Data + m_Offset, sizeof(Value));
+            m_Offset += sizeof(Value);
+        }
+
+        bool Failed() const { return m_Failed; }
+        bool AtEnd() const { return m_Offset == m_Size; }
+
+    private:
+        const uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+        size_t m_Offset = 0;
+        bool m_Failed = false;
+    };
+
+    /**
+     * @brief 把快照 registry 中 Type 的每个实例交给 apply（当前世界里存在且有该组件的实体）
+     * @return 覆盖的实例数；skipped 累加找不到对应实体的实例数
+     */
+    template<typename Type, typename Apply>
+    uint32_t RestorePool(entt::registry& saved, entt::registry& registry, uint32_t& skipped, Apply&& apply) {
+        uint32_t restored = 0;
+        auto& live = registry.storage<Type>();
+        for (auto [entity, value] : saved.view<Type>().each()) {
+            if (!registry.valid(entity) || !live.contains(entity)) {
+                skipped++;
+                continue;
+            }
+            apply(entity, value, live.get(entity));
+            restored++;
+        }
+        return restored;
+    }
+
+    bool WriteFileAtomic(const std::string& path, const std::vector<uint8_t>& data) {
+        const std::filesystem::path target(path);
+        std::error_code error;
+        if (target.has_parent_path()) {
+            std::filesystem::create_directories(target.parent_path(), error);
+        }
+
+        // 先写临时文件再替换：写到一半崩溃不会损坏上一个存档
+        const std::filesystem::path temporary = target.string() + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file) return false;
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!file.good()) return false;
+        }
+        std::filesystem::rename(temporary, target, error);
+        return !error;
+    }
+}
+
+bool WorldSnapshot::RequestSave(const std::string& path) {
+    if (m_Busy || m_SaveRequested) return false;
+    m_SavePath = path;
+    m_SaveRequested = true;
+    return true;
+}
+
+bool WorldSnapshot::RequestLoad(const std::string& path) {
+    if (m_Busy || m_SaveRequested) return false;
+    m_Busy = true;
+
+    AssetStreamer::GetInstance().Submit([this, path]() -> AssetStreamer::ApplyFn {
+        // 加载线程：读文件 + 反序列化进独立的 registry
+        const auto start = Clock::now();
+        auto loaded = std::make_shared<LoadedSnapshot>();
+        uint64_t bytes = 0;
+        const bool ok = ReadSnapshot(path, *loaded, bytes);
+        const float decodeMs = ElapsedMs(start);
+
+        return [this, loaded, ok, bytes, decodeMs, path](entt::registry&) {
+            if (!ok) {
+                DebugManager::GetInstance().Log("WorldSnapshot", "Failed to load snapshot: " + path);
+                m_Busy = false;
+                return;
+            }
+            m_Stats.decodeMs = decodeMs;
+            m_Stats.bytes = bytes;
+            m_PendingLoad = loaded;     // 下一次 Update（帧开头）应用
+        };
+    });
+    return true;
+}
+
+void WorldSnapshot::Update(entt::registry& registry, OrbitSystem* orbits) {
+    const InputManager& input = InputManager::GetInstance();
+    if (input.IsKeyPressed(VK_F5)) {
+        RequestSave();
+    }
+    if (input.IsKeyPressed(VK_F9)) {
+        RequestLoad();
+    }
+
+    if (m_PendingLoad) {
+        std::shared_ptr<LoadedSnapshot> snapshot = std::move(m_PendingLoad);
+        Apply(registry, orbits, *snapshot);
+        m_Busy = false;
+    }
+
+    if (m_SaveRequested) {
+        m_SaveRequested = false;
+        Capture(registry, orbits, m_SavePath);
+    }
+}
+
+WorldSnapshot::Stats WorldSnapshot::GetStats() const {
+    Stats stats = m_Stats;
+    stats.busy = m_Busy || m_SaveRequested;
+    return stats;
+}
+
+void WorldSnapshot::Capture(entt::registry& registry, OrbitSystem* orbits, const std::string& path) {
+    PROFILE_SCOPE("WorldSnapshot::Capture");
+    const auto start = Clock::now();
+
+    // 刚体速度回读到组件（模拟没有在进行，读 actor 安全；休眠扇区里的 actor 取保存的速度）
+    for (auto [entity, rigidBody] : registry.view<RigidBodyComponent>().each()) {
+        auto* dynamicActor = rigidBody.physxActor ? rigidBody.physxActor->is<physx::PxRigidDynamic>() : nullptr;
+        if (!dynamicActor) continue;
+        physx::PxVec3 linear = dynamicActor->getLinearVelocity();
+        physx::PxVec3 angular = dynamicActor->getAngularVelocity();
+        if (const auto* inSector = registry.try_get<InSectorComponent>(entity); inSector && inSector->hibernating) {
+            linear = inSector->hibernatedLinearVelocity;
+            angular = inSector->hibernatedAngularVelocity;
+        }
+        rigidBody.velocity = { linear.x, linear.y, linear.z };
+        rigidBody.angularVelocity = { angular.x, angular.y, angular.z };
+    }
+
+    FileHeader header;
+    header.simulationTime = orbits ? orbits->GetSimulationTime() : 0.0;
+    const WorldPosition& origin = FloatingOrigin::GetInstance().GetOrigin();
+    header.originX = origin.x;
+    header.originY = origin.y;
+    header.originZ = origin.z;
+
+    std::vector<uint8_t>& buffer = m_CaptureBuffer;
+    buffer.clear();
+    buffer.resize(sizeof(FileHeader));
+    SnapshotWriter writer(buffer);
+    entt::snapshot{ registry }
+        .get<entt::entity>(writer)
+        .get<TransformComponent>(writer)
+        .get<SectorComponent>(writer)
+        .get<OrbitComponent>(writer)
+        .get<InSectorComponent>(writer)
+        .get<RigidBodyComponent>(writer)
+        .get<SpacecraftComponent>(writer)
+        .get<CharacterControllerComponent>(writer);
+    header.payloadBytes = buffer.size() - sizeof(FileHeader);
+    std::memcpy(buffer.data(), &header, sizeof(FileHeader));
+
+    // 缓冲交给加载线程写文件；下一次按这次的大小预留，序列化时不再逐步扩容
+    auto blob = std::make_shared<std::vector<uint8_t>>(std::move(buffer));
+    m_CaptureBuffer = std::vector<uint8_t>();
+    m_CaptureBuffer.reserve(blob->size());
+
+    m_Stats.captureMs = ElapsedMs(start);
+    m_Stats.bytes = blob->size();
+    m_Busy = true;
+
+    AssetStreamer::GetInstance().Submit([this, blob, path]() -> AssetStreamer::ApplyFn {
+        const auto writeStart = Clock::now();
+        const bool ok = WriteFileAtomic(path, *blob);
+        const float writeMs = ElapsedMs(writeStart);
+
+        return [this, ok, writeMs, path](entt::registry&) {
+            m_Busy = false;
+            if (!ok) {
+                DebugManager::GetInstance().Log("WorldSnapshot", "Failed to write snapshot: " + path);
+                return;
+            }
+            m_Stats.writeMs = writeMs;
+            m_Stats.saves++;
+            DebugManager::GetInstance().Log("WorldSnapshot", "Saved " + path + " (" + std::to_string(m_Stats.bytes) +
+                                            " bytes, capture " + std::to_string(m_Stats.captureMs) + " ms)");
+        };
+    });
+}
+
+bool WorldSnapshot::ReadSnapshot(const std::string& path, LoadedSnapshot& out, uint64_t& outBytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    const std::streamsize size = file.tellg();
+    if (size < static_cast<std::streamsize>(sizeof(FileHeader))) return false;
+
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), size)) return false;
+
+    std::memcpy(&out.header, data.data(), sizeof(FileHeader));
+    if (out.header.magic != kMagic || out.header.version != kVersion ||
+        out.header.payloadBytes != data.size() - sizeof(FileHeader)) {
+        return false;
+    }
+
+    SnapshotReader reader(data.data() + sizeof(FileHeader), static_cast<size_t>(out.header.payloadBytes));
+    entt::snapshot_loader{ out.registry }
+        .get<entt::entity>(reader)
+        .get<TransformComponent>(reader)
+        .get<SectorComponent>(reader)
+        .get<OrbitComponent>(reader)
+        .get<InSectorComponent>(reader)
+        .get<RigidBodyComponent>(reader)
+        .get<SpacecraftComponent>(reader)
+        .get<CharacterControllerComponent>(reader)
+        .orphans();
+
+    outBytes = data.size();
+    return !reader.Failed() && reader.AtEnd();
+}
+
+void WorldSnapshot::Apply(entt::registry& registry, OrbitSystem* orbits, LoadedSnapshot& snapshot) {
+    PROFILE_SCOPE("WorldSnapshot::Apply");
+    const auto start = Clock::now();
+    entt::registry& saved = snapshot.registry;
+    const FileHeader& header = snapshot.header;
+
+    // 轨道是模拟时间的纯函数：恢复时间后 OrbitSystem 本帧重新求出所有星球位置
+    if (orbits) {
+        orbits->SetSimulationTime(header.simulationTime);
+    }
+
+    // 单精度世界坐标相对存档时的原点，换算到当前原点
+    auto& floatingOrigin = FloatingOrigin::GetInstance();
+    const DirectX::XMFLOAT3 originShift =
+        (WorldPosition(header.originX, header.originY, header.originZ) - floatingOrigin.GetOrigin()).ToFloat3();
+
+    uint32_t skipped = 0;
+    const uint32_t restored = RestorePool<TransformComponent>(saved, registry, skipped,
+        [&](entt::entity, const TransformComponent& from, TransformComponent& to) {
+            to.position = { from.position.x + originShift.x, from.position.y + originShift.y,
+                            from.position.z + originShift.z };
+            to.rotation = from.rotation;
+            to.scale = from.scale;
+        });
+
+    uint32_t ignored = 0;   // 只按 Transform 统计跳过的实体
+    RestorePool<SectorComponent>(saved, registry, ignored,
+        [&](entt::entity, const SectorComponent& from, SectorComponent& to) {
+            to.absolutePosition = from.absolutePosition;
+            to.worldPosition = floatingOrigin.ToRelative(from.absolutePosition);
+            to.worldRotation = from.worldRotation;
+            to.worldVelocity = from.worldVelocity;
+        });
+
+    RestorePool<OrbitComponent>(saved, registry, ignored,
+        [&](entt::entity, const OrbitComponent& from, OrbitComponent& to) {
+            to.orbitAngle = from.orbitAngle;
+            to.rotationAngle = from.rotationAngle;
+            to.orbitEnabled = from.orbitEnabled;
+            to.rotationEnabled = from.rotationEnabled;
+        });
+
+    RestorePool<InSectorComponent>(saved, registry, ignored,
+        [&](entt::entity, const InSectorComponent& from, InSectorComponent& to) {
+            to.sector = from.sector;
+            to.localPosition = from.localPosition;
+            to.localRotation = from.localRotation;
+            // 上一步位姿属于读档之前，不能用于插值
+            to.previousLocalPosition = from.localPosition;
+            to.previousLocalRotation = from.localRotation;
+            to.interpolatePose = false;
+            to.isInitialized = true;
+            to.needsSync = true;
+        });
+
+    RestorePool<RigidBodyComponent>(saved, registry, ignored,
+        [&](entt::entity, const RigidBodyComponent& from, RigidBodyComponent& to) {
+            to.velocity = from.velocity;
+            to.angularVelocity = from.angularVelocity;
+        });
+
+    RestorePool<SpacecraftComponent>(saved, registry, ignored,
+        [&](entt::entity, const SpacecraftComponent& from, SpacecraftComponent& to) {
+            to.currentSpeed = from.currentSpeed;
+            to.currentAngularVelocity = from.currentAngularVelocity;
+            to.isGrounded = from.isGrounded;
+            to.groundContact = from.groundContact;
+        });
+
+    RestorePool<CharacterControllerComponent>(saved, registry, ignored,
+        [&](entt::entity, const CharacterControllerComponent& from, CharacterControllerComponent& to) {
+            to.velocity = from.velocity;
+            to.isGrounded = from.isGrounded;
+            to.wasGrounded = from.isGrounded;
+            to.groundNormal = from.groundNormal;
+            to.localUp = from.localUp;
+            to.localForward = from.localForward;
+            to.localRight = from.localRight;
+            to.cameraYaw = from.cameraYaw;
+            to.cameraPitch = from.cameraPitch;
+        });
+
+    // [来源: WorldSnapshot] 扇区内的 actor / 角色控制器瞬移到恢复后的局部位姿（PhysX 使用扇区局部坐标）
+    for (auto entity : saved.view<InSectorComponent>()) {
+        if (!registry.valid(entity)) continue;
+        auto* liveInSector = registry.try_get<InSectorComponent>(entity);
+        if (!liveInSector) continue;
+        InSectorComponent& inSector = *liveInSector;
+        const physx::PxTransform pose(
+            physx::PxVec3(inSector.localPosition.x, inSector.localPosition.y, inSector.localPosition.z),
+            physx::PxQuat(inSector.localRotation.x, inSector.localRotation.y, inSector.localRotation.z,
+                          inSector.localRotation.w).getNormalized());
+
+        if (auto* rigidBody = registry.try_get<RigidBodyComponent>(entity); rigidBody && rigidBody->physxActor) {
+            rigidBody->physxActor->setGlobalPose(pose);
+            auto* dynamicActor = rigidBody->physxActor->is<physx::PxRigidDynamic>();
+            const bool kinematic = dynamicActor &&
+                (dynamicActor->getRigidBodyFlags() & physx::PxRigidBodyFlag::eKINEMATIC);
+            if (dynamicActor && !kinematic) {
+                const physx::PxVec3 linear(rigidBody->velocity.x, rigidBody->velocity.y, rigidBody->velocity.z);
+                const physx::PxVec3 angular(rigidBody->angularVelocity.x, rigidBody->angularVelocity.y,
+                                            rigidBody->angularVelocity.z);
+                if (inSector.hibernating) {
+                    // 禁用模拟的 actor 不能设置速度：唤醒扇区时由 SectorPhysicsSystem 恢复
+                    inSector.hibernatedLinearVelocity = linear;
+                    inSector.hibernatedAngularVelocity = angular;
+                    inSector.hibernatedAsleep = false;
+                } else {
+                    dynamicActor->setLinearVelocity(linear);
+                    dynamicActor->setAngularVelocity(angular);
+                    dynamicActor->wakeUp();
+                }
+            }
+        }
+
+        if (auto* character = registry.try_get<CharacterControllerComponent>(entity); character && character->pxController) {
+            character->pxController->setPosition(physx::PxExtendedVec3(
+                inSector.localPosition.x, inSector.localPosition.y, inSector.localPosition.z));
+        }
+    }
+
+    m_Stats.applyMs = ElapsedMs(start);
+    m_Stats.restoredEntities = restored;
+    m_Stats.skippedEntities = skipped;
+    m_Stats.loads++;
+    DebugManager::GetInstance().Log("WorldSnapshot", "Loaded snapshot: " + std::to_string(restored) +
+                                    " entities restored, " + std::to_string(skipped) + " skipped, apply " +
+                                    std::to_string(m_Stats.applyMs) + " ms");
+}
+
+} // namespace outer_wilds
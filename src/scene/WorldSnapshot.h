@@ -0,0 +1,106 @@
+/**
+ * WorldSnapshot.h
+ *
+ * 世界快照：快速存档 / 读档（entt::snapshot 二进制格式）
+ *
+ * - 只保存数据组件的状态字段：TransformComponent、SectorComponent / OrbitComponent 的运行时状态、
+ *   InSectorComponent 的扇区和局部位姿、刚体速度、飞船和角色控制器的运动状态。
+ *   网格 / 材质 / PhysX 句柄 / 配置参数不进快照：读档恢复到由同一套搭建代码
+ *   （SolarSystemBuilder、main.cpp）建出的世界上，按实体 id（含版本号）一一对应
+ * - 存档：主线程在帧开头（PhysX 访问窗口内）把组件序列化进内存缓冲，这是唯一在帧内的开销；
+ *   写文件交给 AssetStreamer 的加载线程
+ * - 读档：读文件和 entt::snapshot_loader 反序列化都在加载线程上进行（进临时 registry），
+ *   主线程在下一帧开头整体应用：组件按类型逐池覆盖，actor / 角色控制器瞬移到保存的局部位姿并恢复速度。
+ *   扇区变了的实体只改 InSectorComponent，扇区独立场景模式下 actor 由 SectorPhysicsSystem 换场景
+ * - 快照里有、当前世界没有的实体（已销毁 / 运行时生成的碎片）跳过并计数；
+ *   驾驶关系（上下船）不在快照中，读档保持当前的驾驶状态
+ *
+ * Engine::Update 在 PhysicsEventQueue::Dispatch 之后调用 Update（F5 快速存档，F9 快速读档）。
+ * 除加载线程上的任务外，所有接口和状态都只在主线程上使用（AssetStreamer 的 ApplyFn 也在主线程执行）。
+ */
+
+#pragma once
+#include <entt/entt.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace outer_wilds {
+
+class OrbitSystem;
+
+class WorldSnapshot {
+public:
+    static constexpr const char* kQuickSavePath = "saves/quicksave.owsnap";
+
+    struct Stats {
+        float captureMs = 0.0f;         // 最近一次存档在主线程上的序列化耗时
+        float writeMs = 0.0f;           // 加载线程写文件耗时
+        float decodeMs = 0.0f;          // 最近一次读档在加载线程上的读文件 + 反序列化耗时
+        float applyMs = 0.0f;           // 主线程应用耗时
+        uint64_t bytes = 0;             // 最近一次存 / 读的快照大小
+        uint32_t restoredEntities = 0;  // 最近一次读档覆盖的实体数
+        uint32_t skippedEntities = 0;   // 快照里有、当前世界没有的实体
+        uint32_t saves = 0;
+        uint32_t loads = 0;
+        bool busy = false;              // 有写入 / 读取在进行中
+    };
+
+    static WorldSnapshot& GetInstance() {
+        static WorldSnapshot instance;
+        return instance;
+    }
+
+    /** @brief 请求在下一次 Update 时存档（同时只能有一个存 / 读在进行，忙时返回 false） */
+    bool RequestSave(const std::string& path = kQuickSavePath);
+
+    /** @brief 请求读档：加载线程读文件并反序列化，完成后的下一次 Update 应用 */
+    bool RequestLoad(const std::string& path = kQuickSavePath);
+
+    /**
+     * @brief 处理快捷键和挂起的请求（主线程，帧开头 PhysX 访问窗口内）
+     * @param orbits 用于保存 / 恢复轨道模拟时间（可为 nullptr）
+     */
+    void Update(entt::registry& registry, OrbitSystem* orbits);
+
+    Stats GetStats() const;
+
+private:
+    WorldSnapshot() = default;
+    WorldSnapshot(const WorldSnapshot&) = delete;
+    WorldSnapshot& operator=(const WorldSnapshot&) = delete;
+
+    static constexpr uint32_t kMagic = 0x4e53574f;   // "OWSN"
+    static constexpr uint32_t kVersion = 1;
+
+    struct FileHeader {
+        uint32_t magic = kMagic;
+        uint32_t version = kVersion;
+        uint64_t payloadBytes = 0;
+        double simulationTime = 0.0;
+        double originX = 0.0;           // 存档时的浮动原点（Transform 位置相对它）
+        double originY = 0.0;
+        double originZ = 0.0;
+    };
+
+    /** @brief 加载线程反序列化完成、等待主线程应用的快照 */
+    struct LoadedSnapshot {
+        FileHeader header;
+        entt::registry registry;
+    };
+
+    void Capture(entt::registry& registry, OrbitSystem* orbits, const std::string& path);
+    void Apply(entt::registry& registry, OrbitSystem* orbits, LoadedSnapshot& snapshot);
+    static bool ReadSnapshot(const std::string& path, LoadedSnapshot& out, uint64_t& outBytes);
+
+    std::string m_SavePath;
+    bool m_SaveRequested = false;
+    bool m_Busy = false;
+    std::vector<uint8_t> m_CaptureBuffer;       // 按上一次存档的大小预留
+
+    std::shared_ptr<LoadedSnapshot> m_PendingLoad;
+    Stats m_Stats;
+};
+
+} // namespace outer_wilds
@@ -0,0 +1,34 @@
+#pragma once
+#include <entt/entt.hpp>
+#include <DirectXMath.h>
+#include <cstdint>
+
+namespace outer_wilds {
+namespace components {
+
+/**
+ * @brief 变换层级（父 / 首子 / 兄弟链表 + 相对父实体的局部变换）
+ *
+ * - 只能通过 TransformSystem::Attach / Detach 修改链接（同时维护 depth 和排序标记）
+ * - 子实体的 TransformComponent 由 TransformSystem 每帧按 depth 顺序从父实体推导，
+ *   其他系统不应直接写子实体的 Transform（会在渲染前被覆盖）
+ * - 根实体（parent == null）只是持有子链表，Transform 照常由所属系统写入
+ *
+ * 用例：多材质模型的每个子网格、星球地形补丁
+ */
+struct HierarchyComponent {
+    entt::entity parent = entt::null;
+    entt::entity firstChild = entt::null;
+    entt::entity prevSibling = entt::null;
+    entt::entity nextSibling = entt::null;
+    uint32_t childCount = 0;
+    uint32_t depth = 0;                 // 根为 0；存储池按它排序，父实体总在子实体之前
+
+    // 相对父实体的局部变换（world = local * parentWorld）
+    DirectX::XMFLOAT3 localPosition = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4 localRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    DirectX::XMFLOAT3 localScale = { 1.0f, 1.0f, 1.0f };
+};
+
+} // namespace components
+} // namespace outer_wilds
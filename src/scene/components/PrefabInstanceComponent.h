@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+namespace outer_wilds {
+
+class PrefabPool;
+
+namespace components {
+
+/**
+ * @brief 由 PrefabPool::Spawn 创建的实体（Despawn / Clear 据此确认实体属于哪个池）
+ *
+ * 实体的 PhysX actor 属于池：应通过 PrefabPool::Despawn 回收，不要直接 destroy 实体（actor 会泄漏在场景里）
+ */
+struct PrefabInstanceComponent {
+    PrefabPool* pool = nullptr;
+    uint32_t generation = 0;            // 第几次 Spawn 批次（调试用）
+};
+
+} // namespace components
+} // namespace outer_wilds
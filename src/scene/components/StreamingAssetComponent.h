@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+
+namespace outer_wilds {
+namespace components {
+
+/**
+ * @brief 标记：实体的 MeshComponent 还是占位符，真正的资源正在 AssetStreamer 上加载
+ *
+ * - SceneAssetLoader::LoadModelAsEntityAsync 创建实体时挂载，加载结果应用后移除
+ * - requestId 对应 AssetStreamer::Submit 的返回值（调试 / 与 ModelLoadHandle 对应）
+ * - 需要真实网格数据的系统（凸包碰撞、按包围盒缩放）应跳过带此组件的实体
+ */
+struct StreamingAssetComponent {
+    uint32_t requestId = 0;
+};
+
+} // namespace components
+} // namespace outer_wilds
@@ -14,4 +14,22 @@ DirectX::XMMATRIX TransformComponent::GetWorldMatrix() const {
     return scaling * rotationMatrix * translation;
 }
 
-} // namespace outer_wilds
\ No newline at end of file
+bool TransformComponent::RefreshWorldMatrix(uint32_t generation) {
+    if (m_HasCachedMatrix &&
+        position.x == m_CachedPosition.x && position.y == m_CachedPosition.y && position.z == m_CachedPosition.z &&
+        rotation.x == m_CachedRotation.x && rotation.y == m_CachedRotation.y &&
+        rotation.z == m_CachedRotation.z && rotation.w == m_CachedRotation.w &&
+        scale.x == m_CachedScale.x && scale.y == m_CachedScale.y && scale.z == m_CachedScale.z) {
+        return false;
+    }
+
+    DirectX::XMStoreFloat4x4(&worldMatrix, GetWorldMatrix());
+    m_CachedPosition = position;
+    m_CachedRotation = rotation;
+    m_CachedScale = scale;
+    m_HasCachedMatrix = true;
+    version = generation;
+    return true;
+}
+
+} // namespace outer_wilds
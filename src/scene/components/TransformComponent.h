@@ -1,6 +1,7 @@
 #pragma once
 #include "../../core/ECS.h"
 #include <DirectXMath.h>
+#include <cstdint>
 
 namespace outer_wilds {
 
@@ -9,7 +10,35 @@ struct TransformComponent : public Component {
     DirectX::XMFLOAT4 rotation = { 0.0f, 0.0f, 0.0f, 1.0f }; // Quaternion
     DirectX::XMFLOAT3 scale = { 1.0f, 1.0f, 1.0f };
     
+    // === 缓存的世界矩阵（TransformSystem 每帧渲染前刷新，只重算 TRS 变化过的实体）===
+    DirectX::XMFLOAT4X4 worldMatrix = { 1.0f, 0.0f, 0.0f, 0.0f,
+                                        0.0f, 1.0f, 0.0f, 0.0f,
+                                        0.0f, 0.0f, 1.0f, 0.0f,
+                                        0.0f, 0.0f, 0.0f, 1.0f };
+    // worldMatrix 最后一次重算时 TransformSystem 的代数；消费者（RenderQueue）比较它判断派生数据是否过期
+    uint32_t version = 0;
+    
+    /** @brief 由当前 TRS 现算（S * R * T），不依赖缓存 */
     DirectX::XMMATRIX GetWorldMatrix() const;
+    
+    /** @brief 上一次 TransformSystem 刷新的世界矩阵（本帧刷新之后写入的 TRS 不会反映出来） */
+    DirectX::XMMATRIX GetCachedWorldMatrix() const { return DirectX::XMLoadFloat4x4(&worldMatrix); }
+    
+    /** @brief 强制下一次刷新时重算（TRS 之外的原因需要通知消费者时使用） */
+    void MarkDirty() { m_HasCachedMatrix = false; }
+    
+    /**
+     * @brief TRS 与上次缓存时不同则重算 worldMatrix 并把 version 设为 generation
+     * @return 是否重算
+     */
+    bool RefreshWorldMatrix(uint32_t generation);
+
+private:
+    // 计算 worldMatrix 时的 TRS（按值比较检测变化：各系统直接写字段，没有统一的写入入口）
+    DirectX::XMFLOAT3 m_CachedPosition = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT4 m_CachedRotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    DirectX::XMFLOAT3 m_CachedScale = { 1.0f, 1.0f, 1.0f };
+    bool m_HasCachedMatrix = false;
 };
 
 } // namespace outer_wilds
@@ -1,15 +1,56 @@
 #include "UISystem.h"
+#include "../graphics/GpuMemory.h"
+#include "../graphics/GpuProfiler.h"
+#include "../graphics/RenderQueue.h"
+#include "../graphics/resources/MeshCache.h"
+#include "../graphics/resources/TextureStreamer.h"
+#include "../graphics/resources/ResourceCache.h"
+#include "../graphics/resources/TextureArrayAtlas.h"
+#include "../core/FrameAllocator.h"
+#include "../core/Profiler.h"
+#include "../core/FlightRecorder.h"
+#include "../core/TimeManager.h"
+#include "../input/InputManager.h"
+#include "../physics/PhysXManager.h"
+#include "../physics/PhysicsEvents.h"
+#include "../physics/components/SectorComponent.h"
+#include "../scene/AssetStreamer.h"
+#include "../scene/WorldSnapshot.h"
 #include <imgui.h>
 #include <imgui_impl_win32.h>
 #include <imgui_impl_dx11.h>
 #include <iostream>
 #include <Windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
 namespace outer_wilds {
 
+namespace {
+
+// ImGui 的分配记到 MemoryCategory::UI（16 字节头保存大小，与 malloc 的对齐一致）
+void* ImGuiTrackedAlloc(size_t size, void*) {
+    char* raw = static_cast<char*>(malloc(size + 16));
+    if (!raw) return nullptr;
+    *reinterpret_cast<size_t*>(raw) = size;
+    MemoryTracker::RecordAlloc(MemoryCategory::UI, size);
+    return raw + 16;
+}
+
+void ImGuiTrackedFree(void* ptr, void*) {
+    if (!ptr) return;
+    char* raw = static_cast<char*>(ptr) - 16;
+    MemoryTracker::RecordFree(MemoryCategory::UI, *reinterpret_cast<size_t*>(raw));
+    free(raw);
+}
+
+} // namespace
+
 UISystem::UISystem() {
 }
 
@@ -24,6 +65,7 @@ bool UISystem::Initialize(ID3D11Device* device, ID3D11DeviceContext* context, HW
 
     // 初始化ImGui上下文
     IMGUI_CHECKVERSION();
+    ImGui::SetAllocatorFunctions(&ImGuiTrackedAlloc, &ImGuiTrackedFree);
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
@@ -49,11 +91,46 @@ bool UISystem::Initialize(ID3D11Device* device, ID3D11DeviceContext* context, HW
     return true;
 }
 
+void UISystem::DeclareAccess(SystemAccess& access) const {
+    // 性能面板的扇区统计和组件池统计（池大小 / 组成员只在创建/销毁实体时变化）；F3/F4 和欢迎界面读取输入
+    access.Read<components::InSectorComponent, components::SectorComponent, components::GravityAffectedComponent,
+                RigidBodyComponent>()
+          .ReadResource(SystemAccess::kEntities)
+          .ReadResource(SystemAccess::kInput);
+}
+
 void UISystem::Update(float deltaTime, entt::registry& registry) {
     if (!m_ImGuiInitialized) return;
 
-    // 更新欢迎界面状态
-    if (m_WelcomeScreenState != WelcomeScreenState::Hidden) {
+    const InputManager& input = InputManager::GetInstance();
+
+    // F3：GPU 计时叠加层（边沿触发）
+    if (input.IsKeyPressed(VK_F3)) {
+        m_ShowGpuTimings = !m_ShowGpuTimings;
+    }
+
+    // F4：性能面板
+    if (input.IsKeyPressed(VK_F4)) {
+        m_ShowPerformance = !m_ShowPerformance;
+        m_PerfRefreshTimer = kPerfRefreshInterval;
+    }
+
+    // 帧时间始终记录（打开面板时曲线已有历史）；其余统计只在面板可见时按间隔刷新
+    m_FrameTimes[m_FrameTimeCursor] = deltaTime * 1000.0f;
+    m_FrameTimeCursor = (m_FrameTimeCursor + 1) % kFrameHistory;
+    m_FrameTimeCount = (std::min)(m_FrameTimeCount + 1, kFrameHistory);
+
+    if (m_ShowPerformance) {
+        m_PerfRefreshTimer += deltaTime;
+        if (m_PerfRefreshTimer >= kPerfRefreshInterval) {
+            m_PerfRefreshTimer = 0.0f;
+            RefreshPerformanceStats(registry);
+        }
+    }
+
+    // 更新欢迎界面状态（纹理还在加载线程上时，淡入等到纹理就绪再开始）
+    if (m_WelcomeScreenState != WelcomeScreenState::Hidden &&
+        (m_WelcomeTexture || m_WelcomeScreenState != WelcomeScreenState::FadeIn)) {
         m_WelcomeTimer += deltaTime;
 
         switch (m_WelcomeScreenState) {
@@ -67,34 +144,24 @@ void UISystem::Update(float deltaTime, entt::registry& registry) {
                 break;
 
             case WelcomeScreenState::Display:
-                // 如果等待按键，检查是否有按键按下
+                // 如果等待按键，检查是否有按键按下（加载完成之前不响应）
+                if (m_WaitingForKeyPress && m_Loading) {
+                    break;
+                }
                 if (m_WaitingForKeyPress) {
-                    bool anyKeyPressed = false;
-                    
-                    // 使用Windows原生API检测按键 - 更可靠
-                    // 检查常用按键
-                    if (GetAsyncKeyState(VK_SPACE) & 0x8000 ||
-                        GetAsyncKeyState(VK_RETURN) & 0x8000 ||
-                        GetAsyncKeyState(VK_ESCAPE) & 0x8000 ||
-                        GetAsyncKeyState(VK_LBUTTON) & 0x8000 ||
-                        GetAsyncKeyState(VK_RBUTTON) & 0x8000) {
-                        anyKeyPressed = true;
-                    }
+                    // 按下或本帧内按过（帧间的快速点按也算）
+                    auto keyDown = [&input](int key) { return input.IsKeyHeld(key) || input.IsKeyPressed(key); };
+                    bool anyKeyPressed = keyDown(VK_SPACE) || keyDown(VK_RETURN) || keyDown(VK_ESCAPE) ||
+                                         keyDown(VK_LBUTTON) || keyDown(VK_RBUTTON);
                     
                     // 检查字母键
-                    for (int key = 'A'; key <= 'Z'; key++) {
-                        if (GetAsyncKeyState(key) & 0x8000) {
-                            anyKeyPressed = true;
-                            break;
-                        }
+                    for (int key = 'A'; key <= 'Z' && !anyKeyPressed; key++) {
+                        anyKeyPressed = keyDown(key);
                     }
                     
                     // 检查数字键
-                    for (int key = '0'; key <= '9'; key++) {
-                        if (GetAsyncKeyState(key) & 0x8000) {
-                            anyKeyPressed = true;
-                            break;
-                        }
+                    for (int key = '0'; key <= '9' && !anyKeyPressed; key++) {
+                        anyKeyPressed = keyDown(key);
                     }
                     
                     if (anyKeyPressed) {
@@ -116,10 +183,8 @@ void UISystem::Update(float deltaTime, entt::registry& registry) {
                     m_WelcomeScreenState = WelcomeScreenState::Hidden;
                     
                     // 清理纹理
-                    if (m_WelcomeTexture) {
-                        m_WelcomeTexture->Release();
-                        m_WelcomeTexture = nullptr;
-                    }
+                    ReleaseWelcomeTexture();
+                    ReleaseOverlayCache();
                 }
                 break;
 
@@ -132,6 +197,41 @@ void UISystem::Update(float deltaTime, entt::registry& registry) {
 void UISystem::Render() {
     if (!m_ImGuiInitialized) return;
 
+    const bool welcomeVisible = m_WelcomeScreenState != WelcomeScreenState::Hidden && m_WelcomeTexture;
+    const bool panelsVisible = (m_ShowGpuTimings && m_GpuProfiler) || m_ShowPerformance;
+
+    // 没有可见的 UI（游戏中的常态）：整帧跳过 ImGui
+    if (m_SkipHiddenFrames && !welcomeVisible && !panelsVisible) {
+        m_ImGuiFrameActive = false;
+        m_FrameStats.skippedFrames++;
+        return;
+    }
+
+    // 完全不透明、内容没有变化的欢迎界面：直接拷贝上次的画面
+    OverlaySignature signature;
+    const bool staticOverlay = welcomeVisible && !panelsVisible &&
+                               m_WelcomeScreenState == WelcomeScreenState::Display && m_WelcomeAlpha >= 1.0f;
+    if (staticOverlay) {
+        signature.texture = m_WelcomeTexture;
+        signature.loading = m_Loading;
+        signature.prompt = m_WaitingForKeyPress && !m_Loading;
+        signature.progress = m_LoadingProgress;
+        signature.label = m_LoadingLabel;
+        if (PresentCachedOverlay(signature)) {
+            m_ImGuiFrameActive = false;
+            m_FrameStats.cachedFrames++;
+            return;
+        }
+    } else {
+        m_OverlayCacheValid = false;
+    }
+
+    if (!m_ImGuiFrameActive) {
+        // 跳过期间 ImGui 没有收到按键消息：丢弃它记住的按下状态，避免按键卡住
+        ImGui::GetIO().ClearInputKeys();
+        m_ImGuiFrameActive = true;
+    }
+
     // 开始新的ImGui帧
     ImGui_ImplDX11_NewFrame();
     ImGui_ImplWin32_NewFrame();
@@ -142,9 +242,374 @@ void UISystem::Render() {
         RenderWelcomeScreen();
     }
 
+    if (m_ShowGpuTimings && m_GpuProfiler) {
+        RenderGpuTimings();
+    }
+
+    if (m_ShowPerformance) {
+        RenderPerformancePanel();
+    }
+
     // 结束ImGui帧并渲染
     ImGui::Render();
     ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+    m_FrameStats.imguiFrames++;
+
+    if (staticOverlay) {
+        StoreOverlayCache(signature);
+    }
+}
+
+ID3D11Texture2D* UISystem::GetBoundRenderTarget() const {
+    ID3D11RenderTargetView* rtv = nullptr;
+    m_Context->OMGetRenderTargets(1, &rtv, nullptr);
+    if (!rtv) return nullptr;
+    ID3D11Resource* resource = nullptr;
+    rtv->GetResource(&resource);
+    rtv->Release();
+    if (!resource) return nullptr;
+    ID3D11Texture2D* texture = nullptr;
+    resource->QueryInterface(__uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&texture));
+    resource->Release();
+    return texture;
+}
+
+bool UISystem::PresentCachedOverlay(const OverlaySignature& signature) {
+    if (!m_OverlayCacheValid || !m_OverlayCache || !(signature == m_OverlaySignature)) return false;
+
+    ID3D11Texture2D* target = GetBoundRenderTarget();
+    if (!target) return false;
+
+    // 窗口尺寸 / 格式变化时缓存失效（CopyResource 要求两者完全一致）
+    D3D11_TEXTURE2D_DESC targetDesc;
+    D3D11_TEXTURE2D_DESC cacheDesc;
+    target->GetDesc(&targetDesc);
+    m_OverlayCache->GetDesc(&cacheDesc);
+    const bool compatible = targetDesc.Width == cacheDesc.Width && targetDesc.Height == cacheDesc.Height &&
+                            targetDesc.Format == cacheDesc.Format &&
+                            targetDesc.SampleDesc.Count == cacheDesc.SampleDesc.Count;
+    if (compatible) {
+        m_Context->CopyResource(target, m_OverlayCache);
+    } else {
+        m_OverlayCacheValid = false;
+    }
+    target->Release();
+    return compatible;
+}
+
+void UISystem::StoreOverlayCache(const OverlaySignature& signature) {
+    ID3D11Texture2D* target = GetBoundRenderTarget();
+    if (!target) return;
+
+    D3D11_TEXTURE2D_DESC desc;
+    target->GetDesc(&desc);
+    if (m_OverlayCache) {
+        D3D11_TEXTURE2D_DESC cacheDesc;
+        m_OverlayCache->GetDesc(&cacheDesc);
+        if (cacheDesc.Width != desc.Width || cacheDesc.Height != desc.Height || cacheDesc.Format != desc.Format ||
+            cacheDesc.SampleDesc.Count != desc.SampleDesc.Count) {
+            ReleaseOverlayCache();
+        }
+    }
+    if (!m_OverlayCache) {
+        // 只作为 CopyResource 的源 / 目标，不需要任何绑定
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = 0;
+        desc.CPUAccessFlags = 0;
+        desc.MiscFlags = 0;
+        if (FAILED(m_Device->CreateTexture2D(&desc, nullptr, &m_OverlayCache))) {
+            m_OverlayCache = nullptr;
+            target->Release();
+            return;
+        }
+        GpuMemory::Track(m_OverlayCache);
+    }
+
+    m_Context->CopyResource(m_OverlayCache, target);
+    target->Release();
+    m_OverlaySignature = signature;
+    m_OverlayCacheValid = true;
+}
+
+void UISystem::ReleaseOverlayCache() {
+    if (m_OverlayCache) {
+        m_OverlayCache->Release();
+        m_OverlayCache = nullptr;
+    }
+    m_OverlayCacheValid = false;
+}
+
+void UISystem::RenderGpuTimings() {
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.6f);
+    if (ImGui::Begin("GPU Timings", &m_ShowGpuTimings,
+                     ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing)) {
+        if (!m_GpuProfiler->IsInitialized()) {
+            ImGui::TextUnformatted("GPU profiler unavailable");
+        } else {
+            ImGui::Text("Frame %llu: %.3f ms", static_cast<unsigned long long>(m_GpuProfiler->GetResolvedFrame()),
+                        m_GpuProfiler->GetFrameTime());
+            ImGui::Separator();
+            for (const auto& timing : m_GpuProfiler->GetTimings()) {
+                ImGui::Text("%-12s %7.3f ms  (avg %7.3f)", timing.name, timing.milliseconds, timing.averageMs);
+            }
+            ImGui::Separator();
+            if (m_GpuProfiler->IsCsvLogging()) {
+                if (ImGui::Button("Stop CSV log")) m_GpuProfiler->StopCsvLog();
+            } else if (ImGui::Button("Start CSV log (gpu_timings.csv)")) {
+                m_GpuProfiler->StartCsvLog("gpu_timings.csv");
+            }
+        }
+    }
+    ImGui::End();
+}
+
+/**
+ * @brief 刷新帧时间分位数和扇区实体数（kPerfRefreshInterval 一次，不在每帧排序/遍历）
+ */
+void UISystem::RefreshPerformanceStats(entt::registry& registry) {
+    float sorted[kFrameHistory];
+    std::memcpy(sorted, m_FrameTimes, sizeof(float) * m_FrameTimeCount);
+    std::sort(sorted, sorted + m_FrameTimeCount);
+    auto percentile = [&](float p) {
+        if (m_FrameTimeCount == 0) return 0.0f;
+        uint32_t index = static_cast<uint32_t>(p * static_cast<float>(m_FrameTimeCount - 1) + 0.5f);
+        return sorted[index];
+    };
+    m_FrameTimeP50 = percentile(0.50f);
+    m_FrameTimeP95 = percentile(0.95f);
+    m_FrameTimeP99 = percentile(0.99f);
+
+    // 不调用 registry.valid：指向不存在扇区的实体在最后归入 "(no sector)"
+    FrameUnorderedMap<entt::entity, uint32_t> counts;
+    uint32_t totalInSector = 0;
+    auto inSectorView = registry.view<components::InSectorComponent>();
+    for (auto entity : inSectorView) {
+        counts[inSectorView.get<components::InSectorComponent>(entity).sector]++;
+        totalInSector++;
+    }
+
+    m_SectorCounts.clear();
+    uint32_t assigned = 0;
+    auto sectorView = registry.view<components::SectorComponent>();
+    for (auto entity : sectorView) {
+        SectorEntityCount entry;
+        entry.name = sectorView.get<components::SectorComponent>(entity).name;
+        auto it = counts.find(entity);
+        entry.count = it != counts.end() ? it->second : 0;
+        assigned += entry.count;
+        m_SectorCounts.push_back(std::move(entry));
+    }
+    m_UnsectoredCount = totalInSector - assigned;
+
+    ComponentGroups::GatherPoolStats(registry, m_PoolStats);
+
+    m_MemorySnapshot = MemoryTracker::GetSnapshot();
+    m_MemoryPeaks.Sample(m_MemorySnapshot);
+}
+
+void UISystem::RenderPerformancePanel() {
+    ImGui::SetNextWindowPos(ImVec2(10.0f, 220.0f), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowBgAlpha(0.6f);
+    if (!ImGui::Begin("Performance", &m_ShowPerformance,
+                      ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing)) {
+        ImGui::End();
+        return;
+    }
+
+    // === 帧时间曲线（环形缓冲区，values_offset 指向最旧的样本）===
+    const float latest = m_FrameTimes[(m_FrameTimeCursor + kFrameHistory - 1) % kFrameHistory];
+    const float graphMax = (std::max)(33.4f, m_FrameTimeP99 * 1.25f);
+    ImGui::Text("Frame %.2f ms (%.0f FPS)  p50 %.2f  p95 %.2f  p99 %.2f", latest,
+                latest > 0.0f ? 1000.0f / latest : 0.0f, m_FrameTimeP50, m_FrameTimeP95, m_FrameTimeP99);
+    ImGui::PlotLines("##FrameTimes", m_FrameTimes, static_cast<int>(kFrameHistory),
+                     static_cast<int>(m_FrameTimeCursor), nullptr, 0.0f, graphMax, ImVec2(360.0f, 80.0f));
+    {
+        const ImVec2 graphMin = ImGui::GetItemRectMin();
+        const ImVec2 graphMaxPos = ImGui::GetItemRectMax();
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        auto drawLine = [&](float ms, ImU32 color) {
+            float t = 1.0f - ms / graphMax;
+            float y = graphMin.y + (graphMaxPos.y - graphMin.y) * (std::min)((std::max)(t, 0.0f), 1.0f);
+            drawList->AddLine(ImVec2(graphMin.x, y), ImVec2(graphMaxPos.x, y), color);
+        };
+        drawLine(m_FrameTimeP50, IM_COL32(80, 220, 80, 200));
+        drawLine(m_FrameTimeP95, IM_COL32(230, 200, 60, 200));
+        drawLine(m_FrameTimeP99, IM_COL32(230, 70, 70, 200));
+    }
+    if (m_GpuProfiler && m_GpuProfiler->IsInitialized()) {
+        ImGui::Text("GPU %.3f ms (frame %llu)", m_GpuProfiler->GetFrameTime(),
+                    static_cast<unsigned long long>(m_GpuProfiler->GetResolvedFrame()));
+    }
+
+    // === 各系统 CPU 耗时（上一帧的 Profiler 调用树，主线程前三层）===
+    if (ImGui::CollapsingHeader("CPU", ImGuiTreeNodeFlags_DefaultOpen)) {
+#if defined(OW_PROFILER) && OW_PROFILER
+        const Profiler::FrameData& frame = Profiler::GetInstance().GetLastFrame();
+        ImGui::Text("Frame %llu: %.3f ms", static_cast<unsigned long long>(frame.frameIndex),
+                    static_cast<double>(frame.durationNs) * 1e-6);
+        for (const auto& node : frame.nodes) {
+            if (node.threadIndex != 0 || node.depth > 2) continue;
+            // typeid 名称形如 "class outer_wilds::PlayerSystem"，只显示最后一段
+            const char* name = node.name ? node.name : "?";
+            if (const char* last = std::strrchr(name, ':')) name = last + 1;
+            ImGui::Text("%*s%-24s %7.3f ms", static_cast<int>(node.depth * 2), "", name,
+                        static_cast<double>(node.durationNs) * 1e-6);
+        }
+        if (Profiler::GetInstance().IsCapturing()) {
+            ImGui::TextUnformatted("Capturing trace...");
+        } else if (ImGui::Button("Capture 120 frames (cpu_trace.json)")) {
+            Profiler::GetInstance().StartCapture(120, "cpu_trace.json");
+        }
+#else
+        ImGui::TextUnformatted("CPU profiler compiled out (OW_ENABLE_PROFILER=OFF)");
+#endif
+
+        auto& recorder = FlightRecorder::GetInstance();
+        const auto flight = recorder.GetStats();
+        ImGui::Text("Flight recorder %u frames  p%.0f %.2f ms  spikes %u  dumps %u%s", flight.recordedFrames,
+                    recorder.GetSettings().percentile, flight.percentileMs, flight.triggers, flight.dumps,
+                    flight.dumpPending ? "  (pending)" : "");
+        if (!flight.lastDumpPath.empty()) {
+            ImGui::Text("Last spike %.1f ms -> %s", flight.lastSpikeMs, flight.lastDumpPath.c_str());
+        }
+        if (ImGui::Button("Dump flight recorder")) recorder.RequestDump();
+    }
+
+    // === 渲染统计 ===
+    if (m_RenderStats && ImGui::CollapsingHeader("Render", ImGuiTreeNodeFlags_DefaultOpen)) {
+        const RenderStats& stats = *m_RenderStats;
+        ImGui::Text("Batches %u  Draw calls %u (instanced %u, %u instances)", stats.totalBatches, stats.drawCalls,
+                    stats.instancedDrawCalls, stats.instancesDrawn);
+        ImGui::Text("Pre-pass draws %u  Command lists %u  Geometry binds %u", stats.depthPrePassDrawCalls,
+                    stats.commandLists, stats.geometryBinds);
+        ImGui::Text("Switches: shader %u  texture %u  material %u", stats.shaderSwitches, stats.textureSwitches,
+                    stats.materialSwitches);
+        ImGui::Text("Visible %u  Frustum culled %u  Occluded %u", stats.visibleObjects, stats.culledObjects,
+                    stats.occludedObjects);
+        ImGui::Text("Reduced LOD %u  Impostors %u", stats.reducedLODObjects, stats.impostorObjects);
+    }
+
+    // === 时间加速 ===
+    if (ImGui::CollapsingHeader("Time")) {
+        auto& timeManager = TimeManager::GetInstance();
+        static const float kWarpSteps[] = { 1.0f, 2.0f, 4.0f, 10.0f, 100.0f, 1000.0f };
+        ImGui::Text("Time warp x%.0f", timeManager.GetTimeWarp());
+        for (float warp : kWarpSteps) {
+            char label[16];
+            std::snprintf(label, sizeof(label), "x%.0f", warp);
+            ImGui::SameLine();
+            if (ImGui::Button(label)) timeManager.SetTimeWarp(warp);
+        }
+    }
+
+    // === PhysX ===
+    if (ImGui::CollapsingHeader("PhysX", ImGuiTreeNodeFlags_DefaultOpen)) {
+        auto& physxManager = PhysXManager::GetInstance();
+        bool pipelined = physxManager.IsPipelined();
+        if (ImGui::Checkbox("Overlap simulation with rendering", &pipelined)) {
+            physxManager.SetPipelined(pipelined);
+        }
+        // 流水线模式下此时 simulate 仍在进行，不能直接读场景统计：用帧开头访问窗口内取得的快照
+        const auto& simStats = FlightRecorder::GetInstance().GetLatestPhysicsStats();
+        if (simStats.scenes > 0) {
+            ImGui::Text("Scenes %u  Active dynamic %u / kinematic %u", simStats.scenes, simStats.activeDynamicBodies,
+                        simStats.activeKinematicBodies);
+            ImGui::Text("Static %u  Dynamic %u  Kinematic %u", simStats.staticBodies, simStats.dynamicBodies,
+                        simStats.kinematicBodies);
+            ImGui::Text("Active constraints %u  Axis solver constraints %u", simStats.activeConstraints,
+                        simStats.axisSolverConstraints);
+            ImGui::Text("Broadphase adds %u  removes %u", simStats.broadPhaseAdds, simStats.broadPhaseRemoves);
+            ImGui::Text("Pairs: discrete contacts %u  new %u  lost %u", simStats.contactPairs,
+                        simStats.newPairs, simStats.lostPairs);
+        } else {
+            ImGui::TextUnformatted("No PhysX scene");
+        }
+        const auto events = PhysicsEventQueue::GetInstance().GetStats();
+        ImGui::Text("Events %u/frame  Dropped %u (total %llu)  Listeners %u", events.frameEvents,
+                    events.frameDropped, static_cast<unsigned long long>(events.totalDropped), events.listeners);
+    }
+
+    // === ECS 组件池（owning group 覆盖率 / get 组件访问连续性）===
+    if (ImGui::CollapsingHeader("ECS Pools")) {
+        ImGui::TextUnformatted("Pool                          size   capacity  grouped  locality");
+        for (const auto& pool : m_PoolStats) {
+            ImGui::Text("%-28s %6u %10u %8u %8.0f%%", pool.name, pool.size, pool.capacity, pool.grouped,
+                        pool.getLocality * 100.0f);
+        }
+    }
+
+    // === 共享资源（ResourceCache 去重 / MeshCache 磁盘命中）===
+    if (ImGui::CollapsingHeader("Resources")) {
+        const auto stats = resources::ResourceCache::GetInstance().GetStats();
+        ImGui::Text("Models %u  Materials %u  Textures %u  LOD chains %u",
+                    stats.models, stats.materials, stats.textures, stats.lodChains);
+        ImGui::Text("Hits %u  Misses %u  Evicted %u", stats.hits, stats.misses, stats.evictions);
+        const auto& meshCache = resources::MeshCache::GetInstance();
+        ImGui::Text("Mesh cache: %u disk hits, %u written", meshCache.GetDiskHitCount(), meshCache.GetWriteCount());
+
+        const auto streaming = resources::TextureStreamer::GetInstance().GetStats();
+        constexpr double kMB = 1024.0 * 1024.0;
+        ImGui::Text("Streamed textures %u  Full res %u  Loading %u",
+                    streaming.streamedTextures, streaming.fullResolution, streaming.pendingLoads);
+        ImGui::Text("Texture VRAM %.1f / %.1f MB (all full res: %.1f MB)",
+                    streaming.residentBytes / kMB, streaming.budgetBytes / kMB, streaming.fullResidencyBytes / kMB);
+        ImGui::Text("Stream-ins %u  Evictions %u  Over budget %u",
+                    streaming.streamIns, streaming.evictions, streaming.budgetRejections);
+
+        const auto atlas = resources::TextureArrayAtlas::GetInstance().GetStats();
+        ImGui::Text("Texture arrays %u  Slices %u / %u  Packed materials %u  (%.1f MB)",
+                    atlas.arrays, atlas.usedSlices, atlas.sliceCapacity, atlas.packedMaterials,
+                    atlas.reservedBytes / kMB);
+
+        const auto snapshot = WorldSnapshot::GetInstance().GetStats();
+        ImGui::Text("Snapshot (F5/F9) %.1f KB  capture %.2f ms  write %.1f ms  decode %.1f ms  apply %.2f ms%s",
+                    snapshot.bytes / 1024.0, snapshot.captureMs, snapshot.writeMs, snapshot.decodeMs,
+                    snapshot.applyMs, snapshot.busy ? "  (busy)" : "");
+        ImGui::Text("Saves %u  Loads %u  Restored %u  Skipped %u", snapshot.saves, snapshot.loads,
+                    snapshot.restoredEntities, snapshot.skippedEntities);
+    }
+
+    // === 分子系统内存（当前 / 面板打开期间的峰值）===
+    if (ImGui::CollapsingHeader("Memory")) {
+        constexpr double kMB = 1024.0 * 1024.0;
+        const auto& current = m_MemorySnapshot;
+        const auto& peak = m_MemoryPeaks.peak;
+        if (!MemoryTracker::IsHeapTrackingEnabled()) {
+            ImGui::TextDisabled("Heap tracking disabled (OW_ENABLE_MEMORY_TRACKING=OFF)");
+        }
+        ImGui::Text("CPU %.1f MB (peak %.1f)  GPU %.1f MB (peak %.1f)",
+                    current.TotalCpuBytes() / kMB, m_MemoryPeaks.peakCpuTotal / kMB,
+                    current.TotalGpuBytes() / kMB, m_MemoryPeaks.peakGpuTotal / kMB);
+        for (size_t i = 0; i < static_cast<size_t>(MemoryCategory::Count); i++) {
+            ImGui::Text("  %-10s %8.2f MB  peak %8.2f MB  %8lld allocs",
+                        MemoryTracker::GetCategoryName(static_cast<MemoryCategory>(i)),
+                        current.cpu[i].bytes / kMB, peak.cpu[i].bytes / kMB,
+                        static_cast<long long>(current.cpu[i].allocations));
+        }
+        const auto frameArenas = FrameAllocator::GetInstance().GetStats();
+        ImGui::Text("Frame arenas: %.1f KB used  %.1f KB peak  %.1f KB reserved  (%u threads)",
+                    frameArenas.usedBytes / 1024.0, frameArenas.peakBytes / 1024.0,
+                    frameArenas.capacity / 1024.0, frameArenas.threads);
+        for (size_t i = 0; i < static_cast<size_t>(GpuMemoryKind::Count); i++) {
+            ImGui::Text("  GPU %-6s %8.2f MB  peak %8.2f MB  %8lld resources",
+                        MemoryTracker::GetGpuKindName(static_cast<GpuMemoryKind>(i)),
+                        current.gpu[i].bytes / kMB, peak.gpu[i].bytes / kMB,
+                        static_cast<long long>(current.gpu[i].allocations));
+        }
+    }
+
+    // === 扇区实体数 ===
+    if (ImGui::CollapsingHeader("Sectors")) {
+        for (const auto& sector : m_SectorCounts) {
+            ImGui::Text("%-20s %6u", sector.name.c_str(), sector.count);
+        }
+        if (m_UnsectoredCount > 0) {
+            ImGui::Text("%-20s %6u", "(no sector)", m_UnsectoredCount);
+        }
+    }
+
+    ImGui::End();
 }
 
 void UISystem::RenderWelcomeScreen() {
@@ -192,8 +657,20 @@ void UISystem::RenderWelcomeScreen() {
         ImVec2(1, 1)
     );
 
+    // 加载中：图片下方显示进度条
+    if (m_Loading) {
+        const float barWidth = displayWidth;
+        ImGui::SetCursorPos(ImVec2(posX, windowHeight - 110));
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 1.0f, m_WelcomeAlpha));
+        ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.15f, 0.15f, 0.15f, m_WelcomeAlpha));
+        ImGui::PushStyleColor(ImGuiCol_PlotHistogram, ImVec4(0.85f, 0.55f, 0.2f, m_WelcomeAlpha));
+        ImGui::ProgressBar(m_LoadingProgress, ImVec2(barWidth, 6.0f), "");
+        ImGui::SetCursorPos(ImVec2(posX, windowHeight - 95));
+        ImGui::Text("%s", m_LoadingLabel.c_str());
+        ImGui::PopStyleColor(3);
+    }
     // 如果等待按键，显示提示文字
-    if (m_WaitingForKeyPress && m_WelcomeScreenState == WelcomeScreenState::Display) {
+    else if (m_WaitingForKeyPress && m_WelcomeScreenState == WelcomeScreenState::Display) {
         ImGui::SetCursorPos(ImVec2(windowWidth * 0.5f - 150, windowHeight - 100));
         ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 1.0f, m_WelcomeAlpha));
         ImGui::Text("Press any key to continue...");
@@ -207,11 +684,8 @@ void UISystem::RenderWelcomeScreen() {
 }
 
 void UISystem::ShowWelcomeScreen(const std::string& imagePath, float displayDuration) {
-    // 加载纹理
-    if (!LoadTextureFromFile(imagePath, &m_WelcomeTexture, &m_WelcomeImageWidth, &m_WelcomeImageHeight)) {
-        std::cerr << "Failed to load welcome screen image: " << imagePath << std::endl;
-        return;
-    }
+    // 纹理在加载线程上解码，就绪之前保持黑屏
+    LoadWelcomeTextureAsync(imagePath);
 
     m_WelcomeDisplayDuration = displayDuration;
     m_WelcomeTimer = 0.0f;
@@ -224,11 +698,8 @@ void UISystem::ShowWelcomeScreen(const std::string& imagePath, float displayDura
 }
 
 void UISystem::ShowWelcomeScreenWithKeyWait(const std::string& imagePath) {
-    // 加载纹理
-    if (!LoadTextureFromFile(imagePath, &m_WelcomeTexture, &m_WelcomeImageWidth, &m_WelcomeImageHeight)) {
-        std::cerr << "Failed to load welcome screen image: " << imagePath << std::endl;
-        return;
-    }
+    // 纹理在加载线程上解码，就绪之前保持黑屏
+    LoadWelcomeTextureAsync(imagePath);
 
     m_WelcomeTimer = 0.0f;
     m_WelcomeAlpha = 0.0f;
@@ -239,6 +710,18 @@ void UISystem::ShowWelcomeScreenWithKeyWait(const std::string& imagePath) {
     std::cout << "Welcome screen started with key wait: " << imagePath << std::endl;
 }
 
+void UISystem::SetLoadingProgress(float progress, const std::string& label) {
+    m_Loading = true;
+    m_LoadingProgress = progress < 0.0f ? 0.0f : (progress > 1.0f ? 1.0f : progress);
+    m_LoadingLabel = label;
+}
+
+void UISystem::FinishLoading() {
+    m_Loading = false;
+    m_LoadingProgress = 1.0f;
+    m_LoadingLabel.clear();
+}
+
 void UISystem::HideWelcomeScreen() {
     if (m_WelcomeScreenState != WelcomeScreenState::Hidden) {
         m_WelcomeTimer = 0.0f;
@@ -246,6 +729,45 @@ void UISystem::HideWelcomeScreen() {
     }
 }
 
+void UISystem::LoadWelcomeTextureAsync(const std::string& imagePath) {
+    ReleaseWelcomeTexture();
+    const uint32_t generation = ++m_WelcomeLoadGeneration;
+
+    AssetStreamer::GetInstance().Submit([this, imagePath, generation]() -> AssetStreamer::ApplyFn {
+        // 加载线程：stb_image 解码 + CreateTexture2D（设备是自由线程的，不需要立即上下文）
+        ID3D11ShaderResourceView* view = nullptr;
+        int width = 0;
+        int height = 0;
+        const bool loaded = LoadTextureFromFile(imagePath, &view, &width, &height);
+        // 结果没有被应用（被新的请求取代 / 关闭时丢弃）时由 shared_ptr 释放
+        std::shared_ptr<ID3D11ShaderResourceView> texture(view, [](ID3D11ShaderResourceView* srv) {
+            if (srv) srv->Release();
+        });
+
+        return [this, imagePath, generation, loaded, texture, width, height](entt::registry&) {
+            if (generation != m_WelcomeLoadGeneration || m_WelcomeScreenState == WelcomeScreenState::Hidden) return;
+            if (!loaded || !texture) {
+                std::cerr << "Failed to load welcome screen image: " << imagePath << std::endl;
+                m_WelcomeScreenState = WelcomeScreenState::Hidden;
+                return;
+            }
+            m_WelcomeTexture = texture.get();
+            m_WelcomeTexture->AddRef();
+            m_WelcomeImageWidth = width;
+            m_WelcomeImageHeight = height;
+            m_WelcomeTimer = 0.0f;  // 淡入从纹理就绪时开始
+        };
+    });
+}
+
+void UISystem::ReleaseWelcomeTexture() {
+    if (m_WelcomeTexture) {
+        m_WelcomeTexture->Release();
+        m_WelcomeTexture = nullptr;
+    }
+    m_OverlayCacheValid = false;
+}
+
 bool UISystem::LoadTextureFromFile(const std::string& filename, ID3D11ShaderResourceView** outSRV, int* outWidth, int* outHeight) {
     // 使用stb_image加载图片
     int width, height, channels;
@@ -274,6 +796,7 @@ bool UISystem::LoadTextureFromFile(const std::string& filename, ID3D11ShaderReso
 
     ID3D11Texture2D* texture = nullptr;
     HRESULT hr = m_Device->CreateTexture2D(&texDesc, &initData, &texture);
+    GpuMemory::Track(texture);
     
     stbi_image_free(imageData); // 释放stb_image的内存
 
@@ -305,10 +828,8 @@ bool UISystem::LoadTextureFromFile(const std::string& filename, ID3D11ShaderReso
 }
 
 void UISystem::Shutdown() {
-    if (m_WelcomeTexture) {
-        m_WelcomeTexture->Release();
-        m_WelcomeTexture = nullptr;
-    }
+    ReleaseWelcomeTexture();
+    ReleaseOverlayCache();
 
     if (m_ImGuiInitialized) {
         ImGui_ImplDX11_Shutdown();
@@ -1,11 +1,18 @@
 #pragma once
 #include "../core/ECS.h"
+#include "../core/ComponentGroups.h"
+#include "../core/MemoryTracker.h"
 #include <d3d11.h>
 #include <string>
 #include <memory>
+#include <vector>
+#include <cstdint>
 
 namespace outer_wilds {
 
+class GpuProfiler;
+struct RenderStats;
+
 // UI组件 - 标记实体有UI元素
 struct UIComponent {
     bool visible = true;
@@ -26,6 +33,7 @@ public:
 
     bool Initialize(ID3D11Device* device, ID3D11DeviceContext* context, HWND hwnd);
     void Update(float deltaTime, entt::registry& registry) override;
+    void DeclareAccess(SystemAccess& access) const override;
     void Render();
     void Shutdown();
 
@@ -37,9 +45,67 @@ public:
     bool IsWaitingForKeyPress() const { return m_WaitingForKeyPress; }
     bool WasKeyPressed() const { return m_KeyPressed; }
 
+    // 欢迎界面上的加载进度条：加载期间不响应按键，FinishLoading 后显示"按任意键"
+    void SetLoadingProgress(float progress, const std::string& label);
+    void FinishLoading();
+    bool IsLoading() const { return m_Loading; }
+
+    // GPU 分段计时叠加层（F3 切换）
+    void SetGpuProfiler(GpuProfiler* profiler) { m_GpuProfiler = profiler; }
+    void SetShowGpuTimings(bool show) { m_ShowGpuTimings = show; }
+    bool IsShowingGpuTimings() const { return m_ShowGpuTimings; }
+
+    // 性能面板（F4 切换）：帧时间曲线与分位线、各系统 CPU 耗时、RenderStats、PhysX 统计、扇区实体数
+    void SetRenderStats(const RenderStats* stats) { m_RenderStats = stats; }
+    void SetShowPerformance(bool show) { m_ShowPerformance = show; }
+    bool IsShowingPerformance() const { return m_ShowPerformance; }
+
+    /**
+     * @brief 没有可见 UI 时跳过整个 ImGui 帧（NewFrame / Render / RenderDrawData），默认启用
+     *
+     * 跳过期间 WindowProc 不再把消息交给 ImGui（AcceptsImGuiInput），恢复时清掉残留的按键状态
+     */
+    void SetSkipHiddenFrames(bool skip) { m_SkipHiddenFrames = skip; }
+    bool IsSkippingHiddenFrames() const { return m_SkipHiddenFrames; }
+    bool AcceptsImGuiInput() const { return m_ImGuiInitialized && m_ImGuiFrameActive; }
+
+    struct UIFrameStats {
+        uint32_t imguiFrames = 0;   // 完整执行的 ImGui 帧
+        uint32_t skippedFrames = 0; // 没有可见 UI，整帧跳过
+        uint32_t cachedFrames = 0;  // 静态叠加层从缓存拷贝
+    };
+    const UIFrameStats& GetFrameStats() const { return m_FrameStats; }
+
 private:
+    /**
+     * @brief 静态叠加层（不透明欢迎界面）的内容标识：全部相同时缓存的画面仍然有效
+     */
+    struct OverlaySignature {
+        ID3D11ShaderResourceView* texture = nullptr;
+        bool loading = false;
+        bool prompt = false;
+        float progress = 0.0f;
+        std::string label;
+
+        bool operator==(const OverlaySignature& other) const {
+            return texture == other.texture && loading == other.loading && prompt == other.prompt &&
+                   progress == other.progress && label == other.label;
+        }
+    };
+
     void RenderWelcomeScreen();
+    void RenderGpuTimings();
+    void RenderPerformancePanel();
+    void RefreshPerformanceStats(entt::registry& registry);
     bool LoadTextureFromFile(const std::string& filename, ID3D11ShaderResourceView** outSRV, int* outWidth, int* outHeight);
+    /** @brief 在 AssetStreamer 加载线程上解码欢迎图片并创建纹理，主线程应用时开始淡入 */
+    void LoadWelcomeTextureAsync(const std::string& imagePath);
+    void ReleaseWelcomeTexture();
+    /** @brief 当前绑定的渲染目标纹理（AddRef 过，调用方 Release） */
+    ID3D11Texture2D* GetBoundRenderTarget() const;
+    bool PresentCachedOverlay(const OverlaySignature& signature);
+    void StoreOverlayCache(const OverlaySignature& signature);
+    void ReleaseOverlayCache();
 
     ID3D11Device* m_Device = nullptr;
     ID3D11DeviceContext* m_Context = nullptr;
@@ -56,6 +122,47 @@ private:
     float m_FadeDuration = 1.0f; // 淡入淡出持续时间
     bool m_WaitingForKeyPress = false;
     bool m_KeyPressed = false;
+    bool m_Loading = false;
+    float m_LoadingProgress = 0.0f;
+    std::string m_LoadingLabel;
+    uint32_t m_WelcomeLoadGeneration = 0;   // 重复 ShowWelcomeScreen 时丢弃旧的加载结果
+
+    // 静态叠加层缓存：渲染目标的一份拷贝，内容标识不变时整帧不跑 ImGui
+    ID3D11Texture2D* m_OverlayCache = nullptr;
+    OverlaySignature m_OverlaySignature;
+    bool m_OverlayCacheValid = false;
+
+    bool m_SkipHiddenFrames = true;
+    bool m_ImGuiFrameActive = false;
+    UIFrameStats m_FrameStats;
+
+    // GPU 计时叠加层
+    GpuProfiler* m_GpuProfiler = nullptr;
+    bool m_ShowGpuTimings = false;
+
+    // 性能面板：帧时间环形缓冲区每帧写入；分位数与扇区统计按 kPerfRefreshInterval 刷新
+    static constexpr uint32_t kFrameHistory = 240;
+    static constexpr float kPerfRefreshInterval = 0.25f;
+
+    struct SectorEntityCount {
+        std::string name;
+        uint32_t count = 0;
+    };
+
+    const RenderStats* m_RenderStats = nullptr;
+    bool m_ShowPerformance = false;
+    float m_FrameTimes[kFrameHistory] = {};
+    uint32_t m_FrameTimeCursor = 0;
+    uint32_t m_FrameTimeCount = 0;
+    float m_FrameTimeP50 = 0.0f;
+    float m_FrameTimeP95 = 0.0f;
+    float m_FrameTimeP99 = 0.0f;
+    float m_PerfRefreshTimer = kPerfRefreshInterval;
+    std::vector<SectorEntityCount> m_SectorCounts;
+    uint32_t m_UnsectoredCount = 0;
+    std::vector<ComponentGroups::PoolStats> m_PoolStats;
+    MemoryTracker::Snapshot m_MemorySnapshot;
+    MemoryTracker::PeakTracker m_MemoryPeaks;     // 面板刷新时采样
 
     bool m_ImGuiInitialized = false;
 };